@@ -29,6 +29,7 @@
 * 4.1   sk   11/10/15 Used UINTPTR instead of u32 for Baseaddress CR# 867425.
 *                     Changed the prototype of XBram_CfgInitialize API.
 * 4.9   sd   07/07/23 Added SDT support.
+* 4.10  qm   10/14/26 Cleared the burst handler in XBram_CfgInitialize.
 *</pre>
 *
 *****************************************************************************/
@@ -118,6 +119,9 @@ int XBram_CfgInitialize(XBram *InstancePtr,
 	InstancePtr->Config.IntId = Config->IntId;
 	InstancePtr->Config.IntrParent = Config->IntrParent;
 #endif
+	InstancePtr->BurstHandler = NULL;
+	InstancePtr->BurstRef = NULL;
+	InstancePtr->BurstThreshold = 0U;
 
 
 	/*
@@ -49,6 +49,17 @@
 *     system with address translation, the provided virtual memory base address
 *     replaces the physical address present in the configuration structure.
 *
+* <b>Burst Copies</b>
+*
+* XBram_BurstWrite() and XBram_BurstRead() copy between a buffer and the
+* memory of the controller with load and store multiples of eight words,
+* which the AXI interconnect issues as INCR bursts of eight beats instead of
+* the single beats of XBram_WriteReg() and XBram_ReadReg(). The bursts only
+* form when the layer above maps the memory as normal non-cacheable or as
+* device memory; strongly ordered memory still takes one beat at a time.
+* A handler set with XBram_SetBurstHandler() takes the copies of at least
+* its threshold, typically to start a DMA transfer.
+*
 * @note
 *
 * This API utilizes 32 bit I/O to the BRAM registers. With less
@@ -103,6 +114,8 @@
 * 		     redefinition warnings when multiple lmb_bram_if_cntlr
 * 		     instances are present.
 * 4.9   sd  07/07/23 Added SDT support.
+* 4.10  qm  10/14/26 Added the burst copies of xbram_burst.c and the
+*		     handler that takes the large ones.
 * </pre>
 *****************************************************************************/
 #ifndef XBRAM_H		/* prevent circular inclusions */
@@ -167,6 +180,14 @@ typedef struct {
 #endif
 } XBram_Config;
 
+/**
+ * Copies Bytes from SrcAddr to DstAddr, one of which is in the memory of
+ * the controller, and returns XST_SUCCESS once they are copied. Any other
+ * status makes the driver copy them itself.
+ */
+typedef int (*XBram_BurstHandler)(void *CallBackRef, UINTPTR DstAddr,
+				  UINTPTR SrcAddr, u32 Bytes);
+
 /**
  * The XBram driver instance data. The user is required to
  * allocate a variable of this type for every BRAM device in the
@@ -176,6 +197,9 @@ typedef struct {
 typedef struct {
 	XBram_Config  Config;		/* BRAM config structure */
 	u32 IsReady;			/* Device is initialized and ready */
+	XBram_BurstHandler BurstHandler; /* Takes the large copies */
+	void *BurstRef;			/* Passed to BurstHandler */
+	u32 BurstThreshold;		/* Bytes from which it is called */
 } XBram;
 
 /***************** Macros (Inline Functions) Definitions ********************/
@@ -198,6 +222,16 @@ XBram_Config *XBram_LookupConfig(UINTPTR BaseAddress);
 int XBram_CfgInitialize(XBram *InstancePtr, XBram_Config *Config,
 			UINTPTR EffectiveAddr);
 
+/*
+ * Functions implemented in xbram_burst.c
+ */
+int XBram_BurstWrite(XBram *InstancePtr, u32 Offset, const void *SrcPtr,
+		     u32 Bytes);
+int XBram_BurstRead(XBram *InstancePtr, u32 Offset, void *DstPtr,
+		    u32 Bytes);
+void XBram_SetBurstHandler(XBram *InstancePtr, XBram_BurstHandler FuncPtr,
+			   void *CallBackRef, u32 Threshold);
+
 /*
  * Functions implemented in xbram_selftest.c
  */
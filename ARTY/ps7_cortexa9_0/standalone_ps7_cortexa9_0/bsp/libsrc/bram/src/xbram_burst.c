@@ -0,0 +1,292 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+
+/**
+* @file xbram_burst.c
+* @addtogroup bram Overview
+* @{
+*
+* The burst copies to and from the memory of the BRAM controller.
+* See xbram.h for more information about the driver.
+*
+* @note
+*
+* A block of eight words is moved with one ldm and one stm of eight
+* registers on ARM. A buffer that is not word aligned goes through a block
+* on the stack, the memory of the controller is always accessed with
+* aligned words.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 4.10  qm   10/14/26 First release
+*</pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xbram.h"
+#include "xstatus.h"
+
+/************************** Constant Definitions ****************************/
+
+#define XBRAM_BURST_WORDS	8U	/* Words of an ldm/stm block */
+#define XBRAM_BURST_BYTES	(XBRAM_BURST_WORDS * 4U)
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Variable Definitions ****************************/
+
+
+/************************** Function Prototypes *****************************/
+
+static int XBram_BurstCheck(XBram *InstancePtr, u32 Offset, u32 Bytes);
+static void XBram_BurstBlock(u32 **DstPtr, const u32 **SrcPtr);
+
+
+/****************************************************************************/
+/**
+* Copy a buffer to the memory of the controller in bursts.
+*
+* @param	InstancePtr is a pointer to an XBram instance.
+* @param	Offset is the first byte written, from MemBaseAddress, a
+*		multiple of 4.
+* @param	SrcPtr is the buffer, of any alignment.
+* @param	Bytes is the number of bytes, a multiple of 4.
+*
+* @return
+* 		- XST_SUCCESS if the bytes are written.
+* 		- XST_INVALID_PARAM if they are not aligned or do not fit
+*		  the memory.
+*
+* @note		Copies of BurstThreshold bytes or more go to the burst
+*		handler first, when one is set.
+*
+*****************************************************************************/
+int XBram_BurstWrite(XBram *InstancePtr, u32 Offset, const void *SrcPtr,
+		     u32 Bytes)
+{
+	UINTPTR DstAddr;
+	u32 *Dst32;
+	const u8 *Src8 = (const u8 *)SrcPtr;
+	const u32 *Src32;
+	u32 Block[XBRAM_BURST_WORDS];
+	u32 Word;
+	int Status;
+
+	Xil_AssertNonvoid(SrcPtr != NULL);
+
+	Status = XBram_BurstCheck(InstancePtr, Offset, Bytes);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	DstAddr = InstancePtr->Config.MemBaseAddress + Offset;
+	if ((InstancePtr->BurstHandler != NULL) &&
+	    (Bytes >= InstancePtr->BurstThreshold) &&
+	    (InstancePtr->BurstHandler(InstancePtr->BurstRef, DstAddr,
+				       (UINTPTR)SrcPtr, Bytes) ==
+	     XST_SUCCESS)) {
+		return XST_SUCCESS;
+	}
+
+	Dst32 = (u32 *)DstAddr;
+	while (Bytes >= XBRAM_BURST_BYTES) {
+		if (((UINTPTR)Src8 & 3U) == 0U) {
+			Src32 = (const u32 *)Src8;
+		} else {
+			(void)memcpy(Block, Src8, XBRAM_BURST_BYTES);
+			Src32 = Block;
+		}
+		XBram_BurstBlock(&Dst32, &Src32);
+		Src8 += XBRAM_BURST_BYTES;
+		Bytes -= XBRAM_BURST_BYTES;
+	}
+
+	while (Bytes > 0U) {
+		(void)memcpy(&Word, Src8, sizeof(Word));
+		XBram_Out32((UINTPTR)Dst32, Word);
+		Dst32++;
+		Src8 += 4;
+		Bytes -= 4U;
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+* Copy the memory of the controller to a buffer in bursts.
+*
+* @param	InstancePtr is a pointer to an XBram instance.
+* @param	Offset is the first byte read, from MemBaseAddress, a
+*		multiple of 4.
+* @param	DstPtr is the buffer, of any alignment.
+* @param	Bytes is the number of bytes, a multiple of 4.
+*
+* @return
+* 		- XST_SUCCESS if the bytes are read.
+* 		- XST_INVALID_PARAM if they are not aligned or do not fit
+*		  the memory.
+*
+* @note		Copies of BurstThreshold bytes or more go to the burst
+*		handler first, when one is set.
+*
+*****************************************************************************/
+int XBram_BurstRead(XBram *InstancePtr, u32 Offset, void *DstPtr,
+		    u32 Bytes)
+{
+	UINTPTR SrcAddr;
+	const u32 *Src32;
+	u8 *Dst8 = (u8 *)DstPtr;
+	u32 *Dst32;
+	u32 Block[XBRAM_BURST_WORDS];
+	u32 Word;
+	int Status;
+
+	Xil_AssertNonvoid(DstPtr != NULL);
+
+	Status = XBram_BurstCheck(InstancePtr, Offset, Bytes);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	SrcAddr = InstancePtr->Config.MemBaseAddress + Offset;
+	if ((InstancePtr->BurstHandler != NULL) &&
+	    (Bytes >= InstancePtr->BurstThreshold) &&
+	    (InstancePtr->BurstHandler(InstancePtr->BurstRef, (UINTPTR)DstPtr,
+				       SrcAddr, Bytes) == XST_SUCCESS)) {
+		return XST_SUCCESS;
+	}
+
+	Src32 = (const u32 *)SrcAddr;
+	while (Bytes >= XBRAM_BURST_BYTES) {
+		if (((UINTPTR)Dst8 & 3U) == 0U) {
+			Dst32 = (u32 *)Dst8;
+			XBram_BurstBlock(&Dst32, &Src32);
+		} else {
+			Dst32 = Block;
+			XBram_BurstBlock(&Dst32, &Src32);
+			(void)memcpy(Dst8, Block, XBRAM_BURST_BYTES);
+		}
+		Dst8 += XBRAM_BURST_BYTES;
+		Bytes -= XBRAM_BURST_BYTES;
+	}
+
+	while (Bytes > 0U) {
+		Word = XBram_In32((UINTPTR)Src32);
+		(void)memcpy(Dst8, &Word, sizeof(Word));
+		Src32++;
+		Dst8 += 4;
+		Bytes -= 4U;
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+* Set the handler that takes the burst copies of Threshold bytes or more,
+* such as a DMA transfer, or clear it.
+*
+* @param	InstancePtr is a pointer to an XBram instance.
+* @param	FuncPtr is the handler, or NULL for none.
+* @param	CallBackRef is passed to the handler.
+* @param	Threshold is the smallest copy given to the handler.
+*
+* @return	None.
+*
+* @note		The handler is called in the context of the copy and must
+*		have finished with the buffer when it returns.
+*
+*****************************************************************************/
+void XBram_SetBurstHandler(XBram *InstancePtr, XBram_BurstHandler FuncPtr,
+			   void *CallBackRef, u32 Threshold)
+{
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	InstancePtr->BurstHandler = FuncPtr;
+	InstancePtr->BurstRef = CallBackRef;
+	InstancePtr->BurstThreshold = Threshold;
+}
+
+/****************************************************************************/
+/**
+* Check that a copy is aligned and fits the memory of the controller.
+*
+* @param	InstancePtr is a pointer to an XBram instance.
+* @param	Offset is the first byte, from MemBaseAddress.
+* @param	Bytes is the number of bytes.
+*
+* @return	XST_SUCCESS or XST_INVALID_PARAM.
+*
+* @note		None.
+*
+*****************************************************************************/
+static int XBram_BurstCheck(XBram *InstancePtr, u32 Offset, u32 Bytes)
+{
+	UINTPTR Size;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	Size = InstancePtr->Config.MemHighAddress -
+	       InstancePtr->Config.MemBaseAddress + 1U;
+	if (((Offset & 3U) != 0U) || ((Bytes & 3U) != 0U) ||
+	    (Offset > Size) || (Bytes > (Size - Offset))) {
+		return XST_INVALID_PARAM;
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+* Copy one block of eight aligned words and move both pointers past it.
+*
+* @param	DstPtr points to the destination pointer.
+* @param	SrcPtr points to the source pointer.
+*
+* @return	None.
+*
+* @note		r7 and r11 are left out of the register list, either may be
+*		the frame pointer.
+*
+*****************************************************************************/
+static void XBram_BurstBlock(u32 **DstPtr, const u32 **SrcPtr)
+{
+#if defined (__GNUC__) && defined (__arm__)
+	u32 *Dst = *DstPtr;
+	const u32 *Src = *SrcPtr;
+
+	__asm__ __volatile__(
+		"ldmia	%1!, {r3-r6, r8-r10, r12}\n\t"
+		"stmia	%0!, {r3-r6, r8-r10, r12}"
+		: "+r" (Dst), "+r" (Src)
+		:
+		: "r3", "r4", "r5", "r6", "r8", "r9", "r10", "r12",
+		  "memory");
+
+	*DstPtr = Dst;
+	*SrcPtr = Src;
+#else
+	u32 Index;
+
+	for (Index = 0U; Index < XBRAM_BURST_WORDS; Index++) {
+		(*DstPtr)[Index] = (*SrcPtr)[Index];
+	}
+	*DstPtr += XBRAM_BURST_WORDS;
+	*SrcPtr += XBRAM_BURST_WORDS;
+#endif
+}
+
+/** @} */
@@ -33,6 +33,9 @@
 * 1.9   ht     07/05/23 Added support for system device-tree flow.
 * 1.10  mus    10/06/23 Fix compilation error for Microblaze RISC-V processor.
 * 1.10  ml     11/15/23 Fix compilation errors reported with -std=c2x compiler flag
+* 1.11  qm     10/14/26 Added XCoresightPs_DccSendWord() and
+*                       XCoresightPs_DccIsTransmitFull() for the word log of
+*                       xcoresightpsdcc_log.c, which now has outbyte().
 * </pre>
 *
 ******************************************************************************/
@@ -95,6 +98,65 @@ void XCoresightPs_DccSendByte(u32 BaseAddress, u8 Data)
 
 }
 
+/****************************************************************************/
+/**
+*
+* This functions sends a 32-bit word using the DCC, the whole of the transmit
+* register. It is blocking in that it waits for the transmitter to become
+* non-full before it writes the word.
+*
+* @param	BaseAddress is a dummy parameter to match the function proto
+*		of functions for other stdio devices.
+* @param	Data is the word to send
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void XCoresightPs_DccSendWord(u32 BaseAddress, u32 Data)
+{
+	(void) BaseAddress;
+	while (XCoresightPs_DccGetStatus() & XCORESIGHTPS_DCC_STATUS_TX) {
+		dsb();
+	}
+#ifdef __aarch64__
+	__asm volatile ("msr dbgdtrtx_el0, %0" : : "r" ((u64)Data));
+#elif defined (__GNUC__) || defined (__ICCARM__)
+	__asm volatile("mcr p14, 0, %0, c0, c5, 0"
+			     : : "r" (Data));
+#else
+	{
+		volatile register u32 Reg __asm("cp14:0:c0:c5:0");
+		Reg = Data;
+	}
+#endif
+	isb();
+}
+
+/****************************************************************************/
+/**
+*
+* This functions tells whether the transmit register of the DCC still holds
+* a word the debugger has not read.
+*
+* @param	BaseAddress is a dummy parameter to match the function proto
+*		of functions for other stdio devices.
+*
+* @return	1 if a send would wait, 0 otherwise.
+*
+* @note		No debugger reading the DCC leaves the register full for
+*		good after the first word.
+*
+******************************************************************************/
+u32 XCoresightPs_DccIsTransmitFull(u32 BaseAddress)
+{
+	(void) BaseAddress;
+
+	return ((XCoresightPs_DccGetStatus() & XCORESIGHTPS_DCC_STATUS_TX) != 0U) ?
+	       1U : 0U;
+}
+
 /****************************************************************************/
 /**
 *
@@ -165,16 +227,5 @@ static INLINE u32 XCoresightPs_DccGetStatus(void)
 	return Status;
 }
 
-#ifdef XPAR_STDIN_IS_CORESIGHTPS_DCC
-void outbyte(char c)
-{
-	XCoresightPs_DccSendByte(STDOUT_BASEADDRESS, c);
-}
-
-char inbyte(void)
-{
-	return XCoresightPs_DccRecvByte(STDIN_BASEADDRESS);
-}
-#endif
 #endif
 /** @} */
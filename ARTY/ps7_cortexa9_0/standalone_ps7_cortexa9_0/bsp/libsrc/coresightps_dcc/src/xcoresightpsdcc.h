@@ -19,6 +19,27 @@
 * ARM target in XSDB console before running the jtag terminal command. Using the
 * coresight driver component, the output stream can be directed to a log file.
 *
+* <b>Word Log</b>
+*
+* XCoresightPs_DccSendByte() takes a whole DCC transfer, and so one debugger
+* poll, per byte, and spins until the debugger has read the previous one.
+* The log of xcoresightpsdcc_log.c packs four bytes per write of the 32-bit
+* transmit register instead: bytes are added to a RAM ring attached with
+* XCoresightPs_DccLogSetBuffer(), and whole words are moved into the
+* register only when it is free, by every write to the log and by
+* XCoresightPs_DccLogDrain() from the idle loop or a timer interrupt. When
+* the ring is full the new bytes are dropped and counted, so the CPU never
+* waits for a debugger that is slow or not there at all.
+*
+* The bytes of a word go lowest first. A line break, a flush and a block of
+* XCoresightPs_DccLogWrite() complete the word in progress with NUL bytes,
+* which the host side drops. With XPAR_STDIN_IS_CORESIGHTPS_DCC defined
+* outbyte(), and so xil_printf(), writes to the log once a ring is attached
+* and falls back to XCoresightPs_DccSendByte() otherwise, for the byte wide
+* jtagterminal of XSDB.
+*
+* Each CPU has its own DCC; the log is that of the CPU that writes to it.
+*
 * @note 	None.
 *
 *
@@ -35,6 +56,7 @@
 *                       fixes the CR#953056.
 * 1.5   sne    01/19/19 Fixed MISRA-C Violations CR#1025101.
 * 1.10  mus    10/06/23 Fix compilation error for Microblaze RISC-V processor.
+* 1.11  qm     10/14/26 Added the buffered word log of xcoresightpsdcc_log.c.
 *
 * </pre>
 *
@@ -54,6 +76,18 @@ extern "C" {
 void XCoresightPs_DccSendByte(u32 BaseAddress, u8 Data);
 
 u8 XCoresightPs_DccRecvByte(u32 BaseAddress);
+
+void XCoresightPs_DccSendWord(u32 BaseAddress, u32 Data);
+
+u32 XCoresightPs_DccIsTransmitFull(u32 BaseAddress);
+
+/* Word log, xcoresightpsdcc_log.c */
+void XCoresightPs_DccLogSetBuffer(u32 *BufferPtr, u32 NumWords);
+void XCoresightPs_DccLogPutByte(u8 Data);
+u32 XCoresightPs_DccLogWrite(const u8 *DataPtr, u32 NumBytes);
+u32 XCoresightPs_DccLogDrain(void);
+void XCoresightPs_DccLogFlush(void);
+u32 XCoresightPs_DccLogDropped(void);
 #endif
 
 #ifdef __cplusplus
@@ -0,0 +1,331 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file xcoresightpsdcc_log.c
+* @addtogroup coresightps_dcc Overview
+* @{
+*
+* The buffered word log over the DCC, and outbyte() and inbyte() when the
+* DCC is the standard input and output. See xcoresightpsdcc.h for more
+* information.
+*
+* @note
+*
+* The ring is a power of two number of words. Head and Tail are free running
+* byte counts; Tail only moves by whole words, so that a word never wraps
+* and is read from the ring with one load. Both are changed with the
+* interrupts masked, so that output from any context can be mixed.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date		Changes
+* ----- -----  -------- -----------------------------------------------
+* 1.11  qm     10/14/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#if defined (__MICROBLAZE__) || defined (__riscv)
+#warning "The driver is supported only for ARM architecture"
+#else
+
+#include "xil_types.h"
+#include "xil_assert.h"
+#include "xpseudo_asm.h"
+#include "bspconfig.h"
+#include "xcoresightpsdcc.h"
+
+/************************** Constant Definitions *****************************/
+
+/* I and F bits, at the same place in the CPSR and in DAIF */
+#define XCORESIGHTPS_DCC_IRQ_FIQ_MASK	0xC0U
+
+/************************** Variable Definitions *****************************/
+
+static struct {
+	u8 *BufferPtr;		/* NULL when no ring is attached */
+	u32 Mask;		/* Size of the ring in bytes minus one */
+	volatile u32 Head;	/* Next byte to be written */
+	volatile u32 Tail;	/* Next byte to be sent, a multiple of 4 */
+	u32 Dropped;		/* Bytes lost on a full ring */
+} XCoresightPs_DccLog;
+
+/*****************************************************************************/
+/*
+*
+* Moves whole words from the ring into the transmit register for as long as
+* the debugger has read the previous one. The caller masks the interrupts.
+*
+* @return	The number of bytes left in the ring.
+*
+******************************************************************************/
+static u32 XCoresightPs_DccLogPush(void)
+{
+	u32 Tail = XCoresightPs_DccLog.Tail;
+
+	while (((XCoresightPs_DccLog.Head - Tail) >= 4U) &&
+	       (XCoresightPs_DccIsTransmitFull(0U) == 0U)) {
+		XCoresightPs_DccSendWord(0U, *(u32 *)(void *)
+					 &XCoresightPs_DccLog.BufferPtr[Tail &
+						XCoresightPs_DccLog.Mask]);
+		Tail += 4U;
+	}
+	XCoresightPs_DccLog.Tail = Tail;
+
+	return XCoresightPs_DccLog.Head - Tail;
+}
+
+/*****************************************************************************/
+/*
+*
+* Completes the word in progress with NUL bytes. It always fits, the ring
+* being whole words and Tail a word boundary. The caller masks the
+* interrupts.
+*
+* @return	None.
+*
+******************************************************************************/
+static void XCoresightPs_DccLogPad(void)
+{
+	u32 Head = XCoresightPs_DccLog.Head;
+
+	while ((Head & 3U) != 0U) {
+		XCoresightPs_DccLog.BufferPtr[Head & XCoresightPs_DccLog.Mask] =
+			0U;
+		Head++;
+	}
+	XCoresightPs_DccLog.Head = Head;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function attaches a RAM ring to the word log, or detaches it with a
+* NULL buffer, after which the log sends with XCoresightPs_DccSendByte().
+* What is left in the previous ring is dropped, a flush would wait for a
+* debugger that may not be there.
+*
+* @param	BufferPtr is the storage of the ring, or NULL.
+* @param	NumWords is the size of the storage in words, a power of two.
+*
+* @return	None.
+*
+* @note		The storage must stay valid until the ring is detached.
+*
+******************************************************************************/
+void XCoresightPs_DccLogSetBuffer(u32 *BufferPtr, u32 NumWords)
+{
+	u32 Cpsr;
+
+	Xil_AssertVoid((BufferPtr == NULL) ||
+		       ((NumWords != 0U) && ((NumWords & (NumWords - 1U)) == 0U)));
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XCORESIGHTPS_DCC_IRQ_FIQ_MASK);
+	XCoresightPs_DccLog.BufferPtr = NULL;
+	XCoresightPs_DccLog.Head = 0U;
+	XCoresightPs_DccLog.Tail = 0U;
+	XCoresightPs_DccLog.Dropped = 0U;
+	if (BufferPtr != NULL) {
+		XCoresightPs_DccLog.Mask = (NumWords * 4U) - 1U;
+		XCoresightPs_DccLog.BufferPtr = (u8 *)BufferPtr;
+	}
+	mtcpsr(Cpsr);
+}
+
+/*****************************************************************************/
+/**
+*
+* This function adds a byte to the log and sends what it can without
+* waiting. A line break completes the word in progress, so that each line
+* reaches the debugger as soon as the transmit register is free.
+*
+* @param	Data is the byte.
+*
+* @return	None.
+*
+* @note		The byte is dropped and counted when the ring is full.
+*
+******************************************************************************/
+void XCoresightPs_DccLogPutByte(u8 Data)
+{
+	u32 Cpsr;
+	u32 Head;
+
+	if (XCoresightPs_DccLog.BufferPtr == NULL) {
+		XCoresightPs_DccSendByte(0U, Data);
+		return;
+	}
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XCORESIGHTPS_DCC_IRQ_FIQ_MASK);
+	Head = XCoresightPs_DccLog.Head;
+	if ((Head - XCoresightPs_DccLog.Tail) > XCoresightPs_DccLog.Mask) {
+		(void)XCoresightPs_DccLogPush();
+	}
+	if ((Head - XCoresightPs_DccLog.Tail) <= XCoresightPs_DccLog.Mask) {
+		XCoresightPs_DccLog.BufferPtr[Head & XCoresightPs_DccLog.Mask] =
+			Data;
+		XCoresightPs_DccLog.Head = Head + 1U;
+		if (Data == (u8)'\n') {
+			XCoresightPs_DccLogPad();
+		}
+	} else {
+		XCoresightPs_DccLog.Dropped++;
+	}
+	(void)XCoresightPs_DccLogPush();
+	mtcpsr(Cpsr);
+}
+
+/*****************************************************************************/
+/**
+*
+* This function adds a block of bytes to the log as a whole, so that it is
+* never split by output from another context or cut short by a full ring,
+* and completes its last word.
+*
+* @param	DataPtr points to the bytes.
+* @param	NumBytes is the number of bytes.
+*
+* @return	NumBytes once the block is buffered or sent, 0 if the ring has
+*		no room for the whole block. Nothing is dropped in that case
+*		and the caller may retry after XCoresightPs_DccLogDrain().
+*
+* @note		Without a ring the block is sent with
+*		XCoresightPs_DccSendByte().
+*
+******************************************************************************/
+u32 XCoresightPs_DccLogWrite(const u8 *DataPtr, u32 NumBytes)
+{
+	u32 Cpsr;
+	u32 Head;
+	u32 Index;
+
+	Xil_AssertNonvoid((DataPtr != NULL) || (NumBytes == 0U));
+
+	if (XCoresightPs_DccLog.BufferPtr == NULL) {
+		for (Index = 0U; Index < NumBytes; Index++) {
+			XCoresightPs_DccSendByte(0U, DataPtr[Index]);
+		}
+		return NumBytes;
+	}
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XCORESIGHTPS_DCC_IRQ_FIQ_MASK);
+	Head = XCoresightPs_DccLog.Head;
+	if ((XCoresightPs_DccLog.Mask + 1U -
+	     (Head - XCoresightPs_DccLog.Tail)) < NumBytes) {
+		(void)XCoresightPs_DccLogPush();
+	}
+	if ((XCoresightPs_DccLog.Mask + 1U -
+	     (Head - XCoresightPs_DccLog.Tail)) < NumBytes) {
+		NumBytes = 0U;
+	}
+	for (Index = 0U; Index < NumBytes; Index++) {
+		XCoresightPs_DccLog.BufferPtr[(Head + Index) &
+					      XCoresightPs_DccLog.Mask] =
+			DataPtr[Index];
+	}
+	XCoresightPs_DccLog.Head = Head + NumBytes;
+	XCoresightPs_DccLogPad();
+	(void)XCoresightPs_DccLogPush();
+	mtcpsr(Cpsr);
+
+	return NumBytes;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function moves whole words of the log into the transmit register for
+* as long as the debugger keeps up, without waiting. It is meant for the
+* idle loop and for a periodic interrupt handler.
+*
+* @return	The number of bytes still buffered.
+*
+* @note		The word in progress stays in the ring until it is completed.
+*
+******************************************************************************/
+u32 XCoresightPs_DccLogDrain(void)
+{
+	u32 Cpsr;
+	u32 Left;
+
+	if (XCoresightPs_DccLog.BufferPtr == NULL) {
+		return 0U;
+	}
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XCORESIGHTPS_DCC_IRQ_FIQ_MASK);
+	Left = XCoresightPs_DccLogPush();
+	mtcpsr(Cpsr);
+
+	return Left;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function completes the word in progress and sends all of the log. It
+* polls the DCC only, so it can be used with the interrupts masked, from an
+* exception handler or before a reset.
+*
+* @return	None.
+*
+* @note		It waits for the debugger to read every word, for good when
+*		no debugger is connected.
+*
+******************************************************************************/
+void XCoresightPs_DccLogFlush(void)
+{
+	u32 Cpsr;
+
+	if (XCoresightPs_DccLog.BufferPtr == NULL) {
+		return;
+	}
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XCORESIGHTPS_DCC_IRQ_FIQ_MASK);
+	XCoresightPs_DccLogPad();
+	mtcpsr(Cpsr);
+
+	while (XCoresightPs_DccLogDrain() != 0U) {
+		dsb();
+	}
+}
+
+/*****************************************************************************/
+/**
+*
+* This function returns the number of bytes dropped because the ring was
+* full.
+*
+* @return	The number of dropped bytes since the ring was attached.
+*
+* @note		None.
+*
+******************************************************************************/
+u32 XCoresightPs_DccLogDropped(void)
+{
+	return XCoresightPs_DccLog.Dropped;
+}
+
+#ifdef XPAR_STDIN_IS_CORESIGHTPS_DCC
+void outbyte(char c)
+{
+	XCoresightPs_DccLogPutByte((u8)c);
+}
+
+char inbyte(void)
+{
+	return XCoresightPs_DccRecvByte(STDIN_BASEADDRESS);
+}
+#endif
+#endif
+/** @} */
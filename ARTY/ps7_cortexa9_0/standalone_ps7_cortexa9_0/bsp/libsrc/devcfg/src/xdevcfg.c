@@ -57,6 +57,7 @@
 *			XDCFG_IXR_D_P_DONE_MASK) !=
 *			XDCFG_IXR_D_P_DONE_MASK);
 * 3.8  Nava 06/21/23 Added support for system device-tree flow.
+* 3.9   qm  10/14/26 Yield in the DMA done wait of XDcfg_PcapReadback.
 *
 * </pre>
 *
@@ -65,6 +66,7 @@
 /***************************** Include Files *********************************/
 
 #include "xdevcfg.h"
+#include "xil_yield.h"
 
 /************************** Constant Definitions *****************************/
 
@@ -707,7 +709,9 @@ static u32 XDcfg_PcapReadback(XDcfg *InstancePtr, u32 SourcePtr,
 	while ((XDcfg_ReadReg(InstancePtr->Config.BaseAddr,
 			      XDCFG_INT_STS_OFFSET) &
 		XDCFG_IXR_D_P_DONE_MASK) !=
-	       XDCFG_IXR_D_P_DONE_MASK);
+	       XDCFG_IXR_D_P_DONE_MASK) {
+		Xil_Yield();
+	}
 	/*
 	 * Enable the previously stored Interrupts .
 	 */
@@ -24,6 +24,7 @@
 *		     set the mask instead of oring it with the
 *		     value read from the interrupt status register
 * 3.8  Nava 06/21/23 Added support for system device-tree flow.
+* 3.9  qm   10/14/26 Added the PCAP trace point of xil_trace.h.
 * </pre>
 *
 ******************************************************************************/
@@ -31,6 +32,7 @@
 /***************************** Include Files *********************************/
 
 #include "xdevcfg.h"
+#include "xil_trace.h"
 
 /************************** Constant Definitions *****************************/
 
@@ -235,6 +237,7 @@ void XDcfg_InterruptHandler(XDcfg *InstancePtr)
 	 */
 	IntrStatusReg = XDcfg_ReadReg(InstancePtr->Config.BaseAddr,
 				      XDCFG_INT_STS_OFFSET);
+	XIL_TRACE_EVENT(XIL_TRACE_ID_PCAP, IntrStatusReg, 0U);
 
 	/*
 	 * Write the status back to clear the interrupts so that no
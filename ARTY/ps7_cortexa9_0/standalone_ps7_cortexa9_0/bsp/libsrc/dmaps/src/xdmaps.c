@@ -48,6 +48,28 @@
 * 2.5 hk      08/16/19   Add a memory barrier before DMASEV as per specification.
 * 2.6 hk      02/14/20   Correct boundary check for Channel.
 * 2.7 aj      12/07/23   Fixed changes to support system device tree flow
+* 2.10 qm     10/14/26   Skip the cache maintenance of buffers in the DMA
+*                         arena of xil_dmaarena.h.
+*                         Added XDmaPs_GenSgDmaProg() to run a scatter-gather
+*                         list as one DMA program.
+*                         Cache the generated programs per channel and only
+*                         patch SAR and DAR for a transfer of a known shape.
+*                         Added per channel submission queues chained by the
+*                         done ISR.
+*                         Added the burst table of XDmaPs_SetBurst().
+*                         Wait for the posted writes of the CPU, such as
+*                         those to the device windows of xil_devwindow.h,
+*                         before the DMAGO.
+*                         Built with XIL_SMP_DRIVER_LOCKS, lock the queue of
+*                         each channel and the device wide registers, so
+*                         that both CPUs may submit commands. The done
+*                         handlers are called without the locks held.
+*                         Trace the done ISR with xil_trace.h.
+*                         Added the peripheral mode transfers paced by the
+*                         PL peripheral request interfaces, see the
+*                         PeriphMode of XDmaPs_Cmd.
+*                         Added the coalescing of the done interrupts, see
+*                         XDmaPs_SetCoalesce() and XDmaPs_DoneISR().
 *
 * </pre>
 *
@@ -61,6 +83,10 @@
 #include "xdmaps.h"
 #include "xil_io.h"
 #include "xil_cache.h"
+#include "xil_dmaarena.h"
+#include "xil_trace.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
 
 #include "xil_printf.h"
 
@@ -77,6 +103,29 @@
 
 /***************** Macros (Inline Functions) Definitions ********************/
 
+/*
+ * Locks of XIL_SMP_DRIVER_LOCKS. A channel lock is taken with the IRQ
+ * already masked, by XDmaPs_Submit() and the done ISR. The device lock
+ * masks the IRQ itself and is the innermost lock.
+ */
+#if defined (XIL_SMP_DRIVER_LOCKS)
+#define XDmaPs_LockChan(ChanData)	Xil_TicketLockAcquire(&(ChanData)->Lock)
+#define XDmaPs_UnlockChan(ChanData)	Xil_TicketLockRelease(&(ChanData)->Lock)
+#define XDmaPs_LockDev(InstPtr)	Xil_TicketLockIrqSave(&(InstPtr)->DevLock)
+#define XDmaPs_UnlockDev(InstPtr, Cpsr) \
+	Xil_TicketLockIrqRestore(&(InstPtr)->DevLock, (Cpsr))
+#else
+#define XDmaPs_LockChan(ChanData)
+#define XDmaPs_UnlockChan(ChanData)
+#define XDmaPs_LockDev(InstPtr)		0U
+#define XDmaPs_UnlockDev(InstPtr, Cpsr)	((void)(Cpsr))
+#endif
+
+/*
+ * Event the programs of the driver signal for a channel
+ */
+#define XDmaPs_DoneEvent(InstPtr, Channel) \
+	((InstPtr)->CoalesceEvery ? XDMAPS_COALESCE_EVENT : (Channel))
 
 /************************** Function Prototypes *****************************/
 static int XDmaPs_Exec_DMAKILL(u32 BaseAddr,
@@ -89,8 +138,22 @@ static int XDmaPs_Exec_DMAGO(u32 BaseAddr, unsigned int Channel, u32 DmaProg);
 
 static void XDmaPs_DoneISR_n(XDmaPs *InstPtr, unsigned Channel);
 static void *XDmaPs_BufPool_Allocate(XDmaPs_ProgBuf *Pool);
-static int XDmaPs_BuildDmaProg(unsigned Channel, XDmaPs_Cmd *Cmd,
-			       unsigned CacheLength);
+static int XDmaPs_BuildDmaProg(unsigned Channel, unsigned Event,
+			       XDmaPs_Cmd *Cmd, unsigned CacheLength);
+static int XDmaPs_BuildSegment(unsigned Channel, char *DmaProgStart,
+			       char *DmaProgBuf, XDmaPs_ChanCtrl *ChanCtrl,
+			       XDmaPs_BD *BD, unsigned CacheLength);
+static int XDmaPs_BuildPeriphSegment(char *DmaProgBuf, XDmaPs_Cmd *Cmd);
+static int XDmaPs_CheckBD(XDmaPs_ChanCtrl *ChanCtrl, XDmaPs_BD *BD);
+static int XDmaPs_CheckPeriph(XDmaPs_Cmd *Cmd);
+static void XDmaPs_SyncBD(XDmaPs_ChanCtrl *ChanCtrl, XDmaPs_BD *BD);
+static int XDmaPs_SgPending(XDmaPs *InstPtr, unsigned Channel,
+			    XDmaPs_Cmd *DmaCmd);
+static void *XDmaPs_ProgCacheGet(XDmaPs *InstPtr, unsigned int Channel,
+				 XDmaPs_Cmd *Cmd);
+static void XDmaPs_StartQueued(XDmaPs *InstPtr, unsigned int Channel);
+static int XDmaPs_StartBatch(XDmaPs *InstPtr, unsigned int Channel);
+static void XDmaPs_Retire(XDmaPs *InstPtr, unsigned int Channel);
 
 static void XDmaPs_Print_DmaProgBuf(char *Buf, int Length);
 
@@ -98,6 +161,17 @@ static void XDmaPs_Print_DmaProgBuf(char *Buf, int Length);
 
 /************************** Variable Definitions ****************************/
 
+/*
+ * Burst shapes used until the measured ones of a benchmark are set with
+ * XDmaPs_SetBurstTable(): the widest bursts of the 64-bit DMAC between the
+ * DDR and the low OCM, and 4 beats of 4 bytes, the 32-bit width of the PL
+ * slaves, for anything else.
+ */
+static const XDmaPs_BurstRule XDmaPs_DefaultBurstTable[] = {
+	{0x00000000U, 0x3FFFFFFFU, 0x00000000U, 0x3FFFFFFFU, 8, 16},
+	{0x00000000U, 0xFFFFFFFFU, 0x00000000U, 0xFFFFFFFFU, 4, 4}
+};
+
 /****************************************************************************/
 /**
 *
@@ -168,8 +242,17 @@ int XDmaPs_CfgInitialize(XDmaPs *InstPtr,
 
 	InstPtr->CacheLength = CacheLength;
 
+	InstPtr->BurstTable = XDmaPs_DefaultBurstTable;
+	InstPtr->NumBurstRules = sizeof(XDmaPs_DefaultBurstTable) /
+				 sizeof(XDmaPs_DefaultBurstTable[0]);
+	InstPtr->CoalesceEvery = 0;
+
+	/* the channel locks, if any, are unlocked at 0 */
 	memset(InstPtr->Chans, 0,
 	       sizeof(XDmaPs_ChannelData[XDMAPS_CHANNELS_PER_DEV]));
+#if defined (XIL_SMP_DRIVER_LOCKS)
+	Xil_TicketLockInit(&InstPtr->DevLock);
+#endif
 
 	for (Channel = 0; Channel < XDMAPS_CHANNELS_PER_DEV; Channel++) {
 		ChanData = InstPtr->Chans + Channel;
@@ -201,8 +284,12 @@ int XDmaPs_CfgInitialize(XDmaPs *InstPtr,
 int XDmaPs_ResetManager(XDmaPs *InstPtr)
 {
 	int Status;
+	u32 Cpsr;
+
+	Cpsr = XDmaPs_LockDev(InstPtr);
 	Status = XDmaPs_Exec_DMAKILL(InstPtr->Config.BaseAddress,
 				     0, 0);
+	XDmaPs_UnlockDev(InstPtr, Cpsr);
 
 	return Status;
 }
@@ -223,8 +310,12 @@ int XDmaPs_ResetManager(XDmaPs *InstPtr)
 int XDmaPs_ResetChannel(XDmaPs *InstPtr, unsigned int Channel)
 {
 	int Status;
+	u32 Cpsr;
+
+	Cpsr = XDmaPs_LockDev(InstPtr);
 	Status = XDmaPs_Exec_DMAKILL(InstPtr->Config.BaseAddress,
 				     Channel, 1);
+	XDmaPs_UnlockDev(InstPtr, Cpsr);
 
 	return Status;
 
@@ -258,8 +349,12 @@ void XDmaPs_FaultISR(XDmaPs *InstPtr)
 
 	unsigned Chan;
 	unsigned DevId;
+	u32 Cpsr;
 
 	XDmaPs_Cmd *DmaCmd;
+	XDmaPs_Cmd *Failed[XDMAPS_QUEUE_DEPTH];
+	unsigned NumFailed;
+	unsigned Index;
 
 	Fsm = XDmaPs_ReadReg(BaseAddr, XDMAPS_FSM_OFFSET) & 0x01;
 	Fsc = XDmaPs_ReadReg(BaseAddr, XDMAPS_FSC_OFFSET) & 0xFF;
@@ -283,7 +378,9 @@ void XDmaPs_FaultISR(XDmaPs *InstPtr)
 
 		/* kill the DMA manager thread */
 		/* Should we disable interrupt?*/
+		Cpsr = XDmaPs_LockDev(InstPtr);
 		XDmaPs_Exec_DMAKILL(BaseAddr, 0, 0);
+		XDmaPs_UnlockDev(InstPtr, Cpsr);
 	}
 
 	/*
@@ -301,7 +398,9 @@ void XDmaPs_FaultISR(XDmaPs *InstPtr)
 
 			/* kill the channel thread */
 			/* Should we disable interrupt? */
+			Cpsr = XDmaPs_LockDev(InstPtr);
 			XDmaPs_Exec_DMAKILL(BaseAddr, Chan, 1);
+			XDmaPs_UnlockDev(InstPtr, Cpsr);
 
 			/*
 			 * get the fault type and fault Pc and invoke the
@@ -309,8 +408,56 @@ void XDmaPs_FaultISR(XDmaPs *InstPtr)
 			 */
 			ChanData = InstPtr->Chans + Chan;
 
+			XDmaPs_LockChan(ChanData);
 			DmaCmd = ChanData->DmaCmdToHw;
 
+			if (ChanData->BatchCount) {
+				/*
+				 * the commands of the batch before the fault
+				 * are done, the others fail
+				 */
+				NumFailed = 0;
+				while (ChanData->BatchRetired <
+				       ChanData->BatchCount) {
+					Index = ChanData->BatchRetired++;
+					DmaCmd = ChanData->Batch[Index];
+					if ((Pc - (u32)ChanData->BatchProg) >=
+					    ChanData->BatchDone[Index]) {
+						DmaCmd->DmaStatus = 0;
+					} else {
+						DmaCmd->DmaStatus = -1;
+						DmaCmd->ChanFaultType =
+							FaultType;
+						DmaCmd->ChanFaultPCAddr = Pc;
+					}
+					Failed[NumFailed++] = DmaCmd;
+				}
+				ChanData->BatchCount = 0;
+				ChanData->DmaCmdFromHw = DmaCmd;
+				ChanData->DmaCmdToHw = NULL;
+				XDmaPs_UnlockChan(ChanData);
+
+				for (Index = 0; Index < NumFailed; Index++) {
+					DmaCmd = Failed[Index];
+					if (DmaCmd->DmaStatus == 0) {
+						if (ChanData->DoneHandler)
+							ChanData->DoneHandler(
+								Chan, DmaCmd,
+								ChanData->
+								DoneRef);
+					} else if (InstPtr->FaultHandler) {
+						InstPtr->FaultHandler(Chan,
+							DmaCmd,
+							InstPtr->FaultRef);
+					}
+				}
+
+				XDmaPs_LockChan(ChanData);
+				XDmaPs_StartQueued(InstPtr, Chan);
+				XDmaPs_UnlockChan(ChanData);
+				continue;
+			}
+
 			/* Should we check DmaCmd is not null */
 			DmaCmd->DmaStatus = -1;
 			DmaCmd->ChanFaultType = FaultType;
@@ -325,12 +472,17 @@ void XDmaPs_FaultISR(XDmaPs *InstPtr)
 							    DmaProgBuf);
 				DmaCmd->GeneratedDmaProg = NULL;
 			}
+			XDmaPs_UnlockChan(ChanData);
 
 			if (InstPtr->FaultHandler)
 				InstPtr->FaultHandler(Chan,
 						      DmaCmd,
 						      InstPtr->FaultRef);
 
+			/* carry on with the queue of the channel */
+			XDmaPs_LockChan(ChanData);
+			XDmaPs_StartQueued(InstPtr, Chan);
+			XDmaPs_UnlockChan(ChanData);
 		}
 	}
 
@@ -747,6 +899,126 @@ int XDmaPs_Instr_DMAWMB(char *DmaProg)
 	return 1;
 }
 
+/****************************************************************************/
+/**
+*
+* Construction function for DMAWFP instruction. This function fills the
+* program buffer with the constructed instruction.
+*
+* @param	DmaProg is the DMA program buffer, it's the starting address
+*		for the instruction being constructed
+* @param	Periph is the peripheral request interface to wait for.
+* @param	Burst is 1 to wait for a burst request, 0 for a single one.
+*
+* @return 	The number of bytes for this instruction which is 2.
+*
+* @note		None.
+*
+*****************************************************************************/
+static INLINE int XDmaPs_Instr_DMAWFP(char *DmaProg, unsigned int Periph,
+				      unsigned int Burst)
+{
+	/*
+	 * DMAWFP encoding
+	 * 15 4 3 2 1  10 9 8 7 6 5 4 3 2 1  0
+	 * |periph[4:0]| 0 0 0 0 0 1 1 0 0 bs p
+	 *
+	 * Note: the request type is given by bs, so p is 0.
+	 */
+	*DmaProg = (u8)(0x30 | ((Burst & 1) << 1));
+	*(DmaProg + 1) = (u8)(Periph << 3);
+
+	return 2;
+}
+
+/****************************************************************************/
+/**
+*
+* Construction function for DMALDP instruction. This function fills the
+* program buffer with the constructed instruction.
+*
+* @param	DmaProg is the DMA program buffer, it's the starting address
+*		for the instruction being constructed
+* @param	Periph is the peripheral request interface to acknowledge.
+* @param	Burst is 1 for a burst request, 0 for a single one.
+*
+* @return 	The number of bytes for this instruction which is 2.
+*
+* @note		None.
+*
+*****************************************************************************/
+static INLINE int XDmaPs_Instr_DMALDP(char *DmaProg, unsigned int Periph,
+				      unsigned int Burst)
+{
+	/*
+	 * DMALDP encoding
+	 * 15 4 3 2 1  10 9 8 7 6 5 4 3 2 1  0
+	 * |periph[4:0]| 0 0 0 0 0 1 0 0 1 bs 1
+	 */
+	*DmaProg = (u8)(0x25 | ((Burst & 1) << 1));
+	*(DmaProg + 1) = (u8)(Periph << 3);
+
+	return 2;
+}
+
+/****************************************************************************/
+/**
+*
+* Construction function for DMASTP instruction. This function fills the
+* program buffer with the constructed instruction.
+*
+* @param	DmaProg is the DMA program buffer, it's the starting address
+*		for the instruction being constructed
+* @param	Periph is the peripheral request interface to acknowledge.
+* @param	Burst is 1 for a burst request, 0 for a single one.
+*
+* @return 	The number of bytes for this instruction which is 2.
+*
+* @note		None.
+*
+*****************************************************************************/
+static INLINE int XDmaPs_Instr_DMASTP(char *DmaProg, unsigned int Periph,
+				      unsigned int Burst)
+{
+	/*
+	 * DMASTP encoding
+	 * 15 4 3 2 1  10 9 8 7 6 5 4 3 2 1  0
+	 * |periph[4:0]| 0 0 0 0 0 1 0 1 0 bs 1
+	 */
+	*DmaProg = (u8)(0x29 | ((Burst & 1) << 1));
+	*(DmaProg + 1) = (u8)(Periph << 3);
+
+	return 2;
+}
+
+/****************************************************************************/
+/**
+*
+* Construction function for DMAFLUSHP instruction. This function fills the
+* program buffer with the constructed instruction.
+*
+* @param	DmaProg is the DMA program buffer, it's the starting address
+*		for the instruction being constructed
+* @param	Periph is the peripheral request interface to flush.
+*
+* @return 	The number of bytes for this instruction which is 2.
+*
+* @note		None.
+*
+*****************************************************************************/
+static INLINE int XDmaPs_Instr_DMAFLUSHP(char *DmaProg, unsigned int Periph)
+{
+	/*
+	 * DMAFLUSHP encoding
+	 * 15 4 3 2 1  10 9 8 7 6 5 4 3 2 1 0
+	 * |periph[4:0]| 0 0 0 0 0 1 1 0 1 0 1
+	 */
+	*DmaProg = 0x35;
+	*(DmaProg + 1) = (u8)(Periph << 3);
+
+	return 2;
+}
+
 /****************************************************************************/
 /**
 *
@@ -1074,8 +1346,11 @@ int XDmaPs_ConstructNestedLoop(char *DmaProgStart,
 * Construct the DMA program based on the descriptions of the DMA transfer.
 * The function handles memory to memory DMA transfers.
 * It also handles unalgined head and small amount of residue tail.
+* A command with a PeriphMode is paced by its peripheral request interface
+* instead, see XDmaPs_BuildPeriphSegment().
 *
 * @param	Channel DMA channel number
+* @param	Event is the event the program signals once done.
 * @param	Cmd is the DMA command.
 * @param	CacheLength is the icache line length, in terms of bytes.
 *		If it's zero, the performance enhancement feature will be
@@ -1086,22 +1361,77 @@ int XDmaPs_ConstructNestedLoop(char *DmaProgStart,
 * @note		None.
 *
 *****************************************************************************/
-static int XDmaPs_BuildDmaProg(unsigned Channel, XDmaPs_Cmd *Cmd,
-			       unsigned CacheLength)
+static int XDmaPs_BuildDmaProg(unsigned Channel, unsigned Event,
+			       XDmaPs_Cmd *Cmd, unsigned CacheLength)
+{
+	char *DmaProgBuf = (char *)Cmd->GeneratedDmaProg;
+	char *DmaProgStart = DmaProgBuf;
+	int SegmentBytes;
+	int DmaProgBytes;
+
+	if (Cmd->PeriphMode != XDMAPS_PERIPH_NONE) {
+		SegmentBytes = XDmaPs_BuildPeriphSegment(DmaProgBuf, Cmd);
+	} else {
+		SegmentBytes = XDmaPs_BuildSegment(Channel, DmaProgStart,
+						   DmaProgBuf, &Cmd->ChanCtrl,
+						   &Cmd->BD, CacheLength);
+	}
+	if (SegmentBytes == 0) {
+		return 0;
+	}
+	DmaProgBuf += SegmentBytes;
+
+	/* Add a memory barrier before DMASSEV as recommended by spec */
+	DmaProgBuf += XDmaPs_Instr_DMAWMB(DmaProgBuf);
+	DmaProgBuf += XDmaPs_Instr_DMASEV(DmaProgBuf, Event);
+	DmaProgBuf += XDmaPs_Instr_DMAEND(DmaProgBuf);
+
+	DmaProgBytes = DmaProgBuf - DmaProgStart;
+
+	Xil_DCacheFlushRange((u32)DmaProgStart, DmaProgBytes);
+
+	return DmaProgBytes;
+
+}
+
+/****************************************************************************/
+/**
+*
+* Construct the part of a DMA program that moves one block: the DMAMOVs of
+* SAR and DAR, the unaligned head, the burst loops and the tail. The
+* caller adds the DMASEV and the DMAEND.
+*
+* @param	Channel DMA channel number
+* @param	DmaProgStart is the very start address of the DMA program.
+*		This is used to calculate whether the loop is in a cache line.
+* @param	DmaProgBuf is where the instructions are written.
+* @param	ChanCtrl is the channel control of the transfer.
+* @param	BD is the block to be moved.
+* @param	CacheLength is the icache line length, in terms of bytes.
+*		If it's zero, the performance enhancement feature will be
+*		turned off.
+*
+* @returns	The number of bytes written, 0 if the block does not fit in
+*		a 2-level loop. At most XDMAPS_SG_SEG_MAX_PROG_LEN bytes are
+*		written.
+*
+* @note		None.
+*
+*****************************************************************************/
+static int XDmaPs_BuildSegment(unsigned Channel, char *DmaProgStart,
+			       char *DmaProgBuf, XDmaPs_ChanCtrl *ChanCtrl,
+			       XDmaPs_BD *BD, unsigned CacheLength)
 {
 	/*
 	 * unpack arguments
 	 */
-	char *DmaProgBuf = (char *)Cmd->GeneratedDmaProg;
-	unsigned DevChan = Channel;
-	unsigned long DmaLength = Cmd->BD.Length;
-	u32 SrcAddr = Cmd->BD.SrcAddr;
-
-	unsigned SrcInc = Cmd->ChanCtrl.SrcInc;
-	u32 DstAddr = Cmd->BD.DstAddr;
-	unsigned DstInc = Cmd->ChanCtrl.DstInc;
+	char *DmaProgSegStart = DmaProgBuf;
+	unsigned long DmaLength = BD->Length;
+	u32 SrcAddr = BD->SrcAddr;
 
-	char *DmaProgStart = DmaProgBuf;
+	unsigned SrcInc = ChanCtrl->SrcInc;
+	u32 DstAddr = BD->DstAddr;
+	unsigned DstInc = ChanCtrl->DstInc;
 
 	unsigned int BurstBytes;
 	unsigned int LoopCount;
@@ -1109,7 +1439,6 @@ static int XDmaPs_BuildDmaProg(unsigned Channel, XDmaPs_Cmd *Cmd,
 	unsigned int LoopResidue = 0;
 	unsigned int TailBytes;
 	unsigned int TailWords;
-	int DmaProgBytes;
 	u32 CCRValue;
 	unsigned int Unaligned;
 	unsigned int UnalignedCount;
@@ -1119,7 +1448,6 @@ static int XDmaPs_BuildDmaProg(unsigned Channel, XDmaPs_Cmd *Cmd,
 	unsigned int SrcUnaligned = 0;
 	unsigned int DstUnaligned = 0;
 
-	XDmaPs_ChanCtrl *ChanCtrl;
 	XDmaPs_ChanCtrl WordChanCtrl;
 	static XDmaPs_ChanCtrl Mem2MemByteCC;
 
@@ -1135,8 +1463,6 @@ static int XDmaPs_BuildDmaProg(unsigned Channel, XDmaPs_Cmd *Cmd,
 	Mem2MemByteCC.SrcBurstSize = 1;
 	Mem2MemByteCC.SrcInc = 1;
 
-	ChanCtrl = &Cmd->ChanCtrl;
-
 	/* insert DMAMOV for SAR and DAR */
 	DmaProgBuf += XDmaPs_Instr_DMAMOV(DmaProgBuf,
 					  XDMAPS_MOV_SAR,
@@ -1304,19 +1630,146 @@ static int XDmaPs_BuildDmaProg(unsigned Channel, XDmaPs_Cmd *Cmd,
 		}
 	}
 
-	/* Add a memory barrier before DMASSEV as recommended by spec */
-	DmaProgBuf += XDmaPs_Instr_DMAWMB(DmaProgBuf);
-	DmaProgBuf += XDmaPs_Instr_DMASEV(DmaProgBuf, DevChan);
-	DmaProgBuf += XDmaPs_Instr_DMAEND(DmaProgBuf);
+	return DmaProgBuf - DmaProgSegStart;
+}
 
-	DmaProgBytes = DmaProgBuf - DmaProgStart;
 
-	Xil_DCacheFlushRange((u32)DmaProgStart, DmaProgBytes);
+/****************************************************************************/
+/**
+*
+* Construct a loop of transfers paced by a peripheral request interface.
+* Each iteration waits for a request of the peripheral, moves one burst, or
+* one beat for single requests, acknowledges the request on the peripheral
+* side of the transfer and flushes the interface, so that the next
+* iteration waits for a new request. It uses loop counter 1 for the outer
+* loop and loop counter 0 for the inner one.
+*
+* @param	DmaProgLoopStart The starting address of the loop (DMALP).
+* @param	LoopCountOuter The outer loop count, 1 for a single loop.
+* @param	LoopCountInner The inner loop count.
+* @param	Cmd is the DMA command, of the direction and peripheral.
+* @param	Burst is 1 for burst requests, 0 for single requests.
+*
+* @return	The number of bytes the loop has.
+*
+* @note		The body is not aligned on the icache lines: the peripheral
+*		paces it, not its fetch.
+*
+*****************************************************************************/
+static int XDmaPs_ConstructPeriphLoop(char *DmaProgLoopStart,
+				      unsigned int LoopCountOuter,
+				      unsigned int LoopCountInner,
+				      XDmaPs_Cmd *Cmd, unsigned int Burst)
+{
+	char *DmaProgBuf = DmaProgLoopStart;
+	char *OuterLoopBody = NULL;
+	char *InnerLoopBody;
+	unsigned int Periph = Cmd->Periph;
+
+	if (LoopCountOuter > 1) {
+		DmaProgBuf += XDmaPs_Instr_DMALP(DmaProgBuf, 1,
+						 LoopCountOuter);
+		OuterLoopBody = DmaProgBuf;
+	}
+	DmaProgBuf += XDmaPs_Instr_DMALP(DmaProgBuf, 0, LoopCountInner);
+	InnerLoopBody = DmaProgBuf;
 
-	return DmaProgBytes;
+	DmaProgBuf += XDmaPs_Instr_DMAWFP(DmaProgBuf, Periph, Burst);
+	if (Cmd->PeriphMode == XDMAPS_PERIPH_TO_MEM) {
+		DmaProgBuf += XDmaPs_Instr_DMALD(DmaProgBuf);
+		DmaProgBuf += XDmaPs_Instr_DMASTP(DmaProgBuf, Periph, Burst);
+	} else {
+		DmaProgBuf += XDmaPs_Instr_DMALDP(DmaProgBuf, Periph, Burst);
+		DmaProgBuf += XDmaPs_Instr_DMAST(DmaProgBuf);
+	}
+	DmaProgBuf += XDmaPs_Instr_DMAFLUSHP(DmaProgBuf, Periph);
 
+	DmaProgBuf += XDmaPs_Instr_DMALPEND(DmaProgBuf, InnerLoopBody, 0);
+	if (OuterLoopBody != NULL) {
+		DmaProgBuf += XDmaPs_Instr_DMALPEND(DmaProgBuf,
+						    OuterLoopBody, 1);
+	}
+
+	return DmaProgBuf - DmaProgLoopStart;
 }
 
+/****************************************************************************/
+/**
+*
+* Construct the part of a DMA program that moves the block of a command
+* with a PeriphMode, paced by the requests of its peripheral: the DMAMOVs
+* of SAR and DAR, a flush of the peripheral interface, the whole bursts
+* on burst requests and the beats left on single requests. The caller adds
+* the DMASEV and the DMAEND.
+*
+* @param	DmaProgBuf is where the instructions are written.
+* @param	Cmd is the DMA command, checked by XDmaPs_CheckPeriph().
+*
+* @returns	The number of bytes written, 0 if the bursts do not fit in a
+*		2-level loop. It is at most 70 bytes, well within a program
+*		buffer.
+*
+* @note		None.
+*
+*****************************************************************************/
+static int XDmaPs_BuildPeriphSegment(char *DmaProgBuf, XDmaPs_Cmd *Cmd)
+{
+	char *DmaProgSegStart = DmaProgBuf;
+	XDmaPs_ChanCtrl *ChanCtrl = &Cmd->ChanCtrl;
+	XDmaPs_ChanCtrl BeatChanCtrl;
+	unsigned int BurstBytes;
+	unsigned int BeatBytes;
+	unsigned int Bursts;
+	unsigned int Beats;
+
+	BurstBytes = ChanCtrl->SrcBurstSize * ChanCtrl->SrcBurstLen;
+	BeatBytes = ChanCtrl->SrcInc ? ChanCtrl->SrcBurstSize :
+		    ChanCtrl->DstBurstSize;
+	Bursts = Cmd->BD.Length / BurstBytes;
+	Beats = (Cmd->BD.Length % BurstBytes) / BeatBytes;
+
+	if (Bursts > (256 * 256)) {
+		return 0;
+	}
+
+	DmaProgBuf += XDmaPs_Instr_DMAMOV(DmaProgBuf, XDMAPS_MOV_SAR,
+					  Cmd->BD.SrcAddr);
+	DmaProgBuf += XDmaPs_Instr_DMAMOV(DmaProgBuf, XDMAPS_MOV_DAR,
+					  Cmd->BD.DstAddr);
+
+	/* forget the requests made before the transfer */
+	DmaProgBuf += XDmaPs_Instr_DMAFLUSHP(DmaProgBuf, Cmd->Periph);
+
+	if (Bursts > 0) {
+		DmaProgBuf += XDmaPs_Instr_DMAMOV(DmaProgBuf, XDMAPS_MOV_CCR,
+						  XDmaPs_ToCCRValue(ChanCtrl));
+		if (Bursts >= 256) {
+			DmaProgBuf += XDmaPs_ConstructPeriphLoop(DmaProgBuf,
+								 Bursts / 256,
+								 256, Cmd, 1);
+			Bursts %= 256;
+		}
+		if (Bursts > 0) {
+			DmaProgBuf += XDmaPs_ConstructPeriphLoop(DmaProgBuf, 1,
+								 Bursts, Cmd,
+								 1);
+		}
+	}
+
+	if (Beats > 0) {
+		BeatChanCtrl = *ChanCtrl;
+		BeatChanCtrl.SrcBurstSize = BeatBytes;
+		BeatChanCtrl.SrcBurstLen = 1;
+		BeatChanCtrl.DstBurstSize = BeatBytes;
+		BeatChanCtrl.DstBurstLen = 1;
+		DmaProgBuf += XDmaPs_Instr_DMAMOV(DmaProgBuf, XDMAPS_MOV_CCR,
+						  XDmaPs_ToCCRValue(&BeatChanCtrl));
+		DmaProgBuf += XDmaPs_ConstructPeriphLoop(DmaProgBuf, 1, Beats,
+							 Cmd, 0);
+	}
+
+	return DmaProgBuf - DmaProgSegStart;
+}
 
 /****************************************************************************/
 /**
@@ -1358,14 +1811,11 @@ int XDmaPs_GenDmaProg(XDmaPs *InstPtr, unsigned int Channel, XDmaPs_Cmd *Cmd)
 	}
 
 
-	/*
-	 * unaligned fixed address is not supported
-	 */
-	if (!ChanCtrl->SrcInc && Cmd->BD.SrcAddr % ChanCtrl->SrcBurstSize) {
+	if (XDmaPs_CheckBD(ChanCtrl, &Cmd->BD) != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
 
-	if (!ChanCtrl->DstInc && Cmd->BD.DstAddr % ChanCtrl->DstBurstSize) {
+	if (XDmaPs_CheckPeriph(Cmd) != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
 
@@ -1375,8 +1825,9 @@ int XDmaPs_GenDmaProg(XDmaPs *InstPtr, unsigned int Channel, XDmaPs_Cmd *Cmd)
 	}
 
 	Cmd->GeneratedDmaProg = Buf;
-	ProgLen = XDmaPs_BuildDmaProg(Channel, Cmd,
-				      InstPtr->CacheLength);
+	ProgLen = XDmaPs_BuildDmaProg(Channel,
+				      XDmaPs_DoneEvent(InstPtr, Channel),
+				      Cmd, InstPtr->CacheLength);
 	Cmd->GeneratedDmaProgLength = ProgLen;
 
 
@@ -1398,45 +1849,236 @@ int XDmaPs_GenDmaProg(XDmaPs *InstPtr, unsigned int Channel, XDmaPs_Cmd *Cmd)
 
 /****************************************************************************/
 /**
- * Free the DMA program buffer that is pointed by the GeneratedDmaProg field
- * of the command.
- *
- * @param	InstPtr is then DMA instance.
- * @param	Channel is the DMA channel number.
- * @param	Cmd is the DMA command.
- *
- * @return	XST_SUCCESS on success.
- * 		XST_FAILURE if there is any error.
- *
- * @note	None.
- *
- ****************************************************************************/
-int XDmaPs_FreeDmaProg(XDmaPs *InstPtr, unsigned int Channel, XDmaPs_Cmd *Cmd)
+*
+* Generate one DMA program for a scatter-gather list, so that the segments
+* are moved with one XDmaPs_Start() and one done interrupt. Every segment
+* uses the channel control of the command. The program is written to a
+* buffer of the caller, sized with XDMAPS_SG_PROG_LEN(), and is set as the
+* user program of the command. The list must stay valid until the command
+* is done, XDmaPs_Start() does the cache maintenance of every segment.
+*
+* The program signals the done interrupt after the last segment and after
+* every segment flagged with XDMAPS_SG_EVENT. The done handler is called
+* with the DmaStatus of the command set to XST_DEVICE_BUSY for the flagged
+* segments and to 0 once the whole list is moved. Flagged segments that
+* complete before the interrupt is handled share one call.
+*
+* @param	InstPtr is then DMA instance.
+* @param	Channel is the DMA channel number.
+* @param	Cmd is the DMA command. Its BD is not used.
+* @param	SgList is the list of segments.
+* @param	SgLength is the number of segments in SgList.
+* @param	ProgBuf is the buffer the program is written to.
+* @param	ProgBufLen is the size of ProgBuf in bytes.
+*
+* @return	- XST_SUCCESS on success.
+*		- XST_BUFFER_TOO_SMALL if the program does not fit in ProgBuf.
+* 		- XST_FAILURE if a segment cannot be moved with the channel
+*		  control of the command, or if the command has a
+*		  PeriphMode.
+*
+* @note		None.
+*
+*****************************************************************************/
+int XDmaPs_GenSgDmaProg(XDmaPs *InstPtr, unsigned int Channel,
+			XDmaPs_Cmd *Cmd, XDmaPs_SgSeg *SgList,
+			unsigned int SgLength, void *ProgBuf,
+			int ProgBufLen)
 {
-
-	void *Buf;
-	XDmaPs_ChannelData *ChanData;
+	char *DmaProgStart = (char *)ProgBuf;
+	char *DmaProgBuf = DmaProgStart;
+	XDmaPs_ChanCtrl *ChanCtrl;
+	unsigned int Events = 0;
+	unsigned int Index;
+	int SegmentBytes;
+	int DmaProgBytes;
 
 	Xil_AssertNonvoid(InstPtr != NULL);
 	Xil_AssertNonvoid(Cmd != NULL);
+	Xil_AssertNonvoid(SgList != NULL);
+	Xil_AssertNonvoid(SgLength != 0);
+	Xil_AssertNonvoid(ProgBuf != NULL);
 
-	if (Channel > XDMAPS_CHANNELS_PER_DEV) {
+	if (Channel >= XDMAPS_CHANNELS_PER_DEV) {
 		return XST_FAILURE;
 	}
 
-	Buf = (void *)Cmd->GeneratedDmaProg;
-	ChanData = InstPtr->Chans + Channel;
+	ChanCtrl = &Cmd->ChanCtrl;
 
-	if (Buf) {
-		XDmaPs_BufPool_Free(ChanData->ProgBufPool, Buf);
-		Cmd->GeneratedDmaProg = 0;
-		Cmd->GeneratedDmaProgLength = 0;
+	if (ChanCtrl->SrcBurstSize * ChanCtrl->SrcBurstLen
+	    != ChanCtrl->DstBurstSize * ChanCtrl->DstBurstLen) {
+		return XST_FAILURE;
+	}
+
+	/* the segments are moved memory to memory */
+	if (Cmd->PeriphMode != XDMAPS_PERIPH_NONE) {
+		return XST_FAILURE;
+	}
+
+	for (Index = 0; Index < SgLength; Index++) {
+		if (XDmaPs_CheckBD(ChanCtrl, &SgList[Index].BD)
+		    != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+	}
+
+	for (Index = 0; Index < SgLength; Index++) {
+		/* room for the worst case segment and the DMAEND */
+		if ((ProgBufLen - (DmaProgBuf - DmaProgStart)) <
+		    (XDMAPS_SG_SEG_MAX_PROG_LEN + 1)) {
+			return XST_BUFFER_TOO_SMALL;
+		}
+
+		SegmentBytes = XDmaPs_BuildSegment(Channel, DmaProgStart,
+						   DmaProgBuf,
+						   ChanCtrl,
+						   &SgList[Index].BD,
+						   InstPtr->CacheLength);
+		if (SegmentBytes == 0) {
+			return XST_FAILURE;
+		}
+		DmaProgBuf += SegmentBytes;
+
+		if ((Index == SgLength - 1) ||
+		    (SgList[Index].Flags & XDMAPS_SG_EVENT)) {
+			/* the segment must be written before the event */
+			DmaProgBuf += XDmaPs_Instr_DMAWMB(DmaProgBuf);
+			DmaProgBuf += XDmaPs_Instr_DMASEV(DmaProgBuf,
+							  Channel);
+			Events++;
+		}
 	}
+	DmaProgBuf += XDmaPs_Instr_DMAEND(DmaProgBuf);
+
+	DmaProgBytes = DmaProgBuf - DmaProgStart;
+	Xil_DCacheFlushRange((u32)DmaProgStart, DmaProgBytes);
+
+	Cmd->UserDmaProg = ProgBuf;
+	Cmd->UserDmaProgLength = DmaProgBytes;
+	Cmd->SgList = SgList;
+	Cmd->SgLength = SgLength;
+	Cmd->SgEvents = Events;
+	Cmd->SgEventsDone = 0;
 
 	return XST_SUCCESS;
 }
 
-
+/****************************************************************************/
+/**
+*
+* Checks that a block can be moved with a channel control. An unaligned
+* fixed address is not supported.
+*
+* @param	ChanCtrl is the channel control.
+* @param	BD is the block.
+*
+* @return	XST_SUCCESS if the block can be moved, XST_FAILURE otherwise.
+*
+* @note		None.
+*
+*****************************************************************************/
+static int XDmaPs_CheckBD(XDmaPs_ChanCtrl *ChanCtrl, XDmaPs_BD *BD)
+{
+	if (!ChanCtrl->SrcInc && BD->SrcAddr % ChanCtrl->SrcBurstSize) {
+		return XST_FAILURE;
+	}
+
+	if (!ChanCtrl->DstInc && BD->DstAddr % ChanCtrl->DstBurstSize) {
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Checks that the block of a command can be paced by its peripheral: the
+* request interface exists, both addresses are aligned on their beats and
+* the length is a whole number of beats, since every beat is moved on a
+* request, and the bursts fit a 2-level loop.
+*
+* @param	Cmd is the DMA command.
+*
+* @return	XST_SUCCESS if the block can be moved, or if the command has
+*		no PeriphMode, XST_FAILURE otherwise.
+*
+* @note		None.
+*
+*****************************************************************************/
+static int XDmaPs_CheckPeriph(XDmaPs_Cmd *Cmd)
+{
+	XDmaPs_ChanCtrl *ChanCtrl = &Cmd->ChanCtrl;
+	unsigned int BeatBytes;
+
+	if (Cmd->PeriphMode == XDMAPS_PERIPH_NONE) {
+		return XST_SUCCESS;
+	}
+
+	if ((Cmd->PeriphMode != XDMAPS_PERIPH_TO_MEM &&
+	     Cmd->PeriphMode != XDMAPS_MEM_TO_PERIPH) ||
+	    Cmd->Periph >= XDMAPS_NUM_PERIPH) {
+		return XST_FAILURE;
+	}
+
+	BeatBytes = ChanCtrl->SrcInc ? ChanCtrl->SrcBurstSize :
+		    ChanCtrl->DstBurstSize;
+	if ((Cmd->BD.SrcAddr % ChanCtrl->SrcBurstSize) ||
+	    (Cmd->BD.DstAddr % ChanCtrl->DstBurstSize) ||
+	    (Cmd->BD.Length % BeatBytes)) {
+		return XST_FAILURE;
+	}
+
+	if (Cmd->BD.Length / (ChanCtrl->SrcBurstSize * ChanCtrl->SrcBurstLen)
+	    > (256 * 256)) {
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+
+/****************************************************************************/
+/**
+ * Free the DMA program buffer that is pointed by the GeneratedDmaProg field
+ * of the command.
+ *
+ * @param	InstPtr is then DMA instance.
+ * @param	Channel is the DMA channel number.
+ * @param	Cmd is the DMA command.
+ *
+ * @return	XST_SUCCESS on success.
+ * 		XST_FAILURE if there is any error.
+ *
+ * @note	None.
+ *
+ ****************************************************************************/
+int XDmaPs_FreeDmaProg(XDmaPs *InstPtr, unsigned int Channel, XDmaPs_Cmd *Cmd)
+{
+
+	void *Buf;
+	XDmaPs_ChannelData *ChanData;
+
+	Xil_AssertNonvoid(InstPtr != NULL);
+	Xil_AssertNonvoid(Cmd != NULL);
+
+	if (Channel > XDMAPS_CHANNELS_PER_DEV) {
+		return XST_FAILURE;
+	}
+
+	Buf = (void *)Cmd->GeneratedDmaProg;
+	ChanData = InstPtr->Chans + Channel;
+
+	if (Buf) {
+		XDmaPs_BufPool_Free(ChanData->ProgBufPool, Buf);
+		Cmd->GeneratedDmaProg = 0;
+		Cmd->GeneratedDmaProgLength = 0;
+	}
+
+	return XST_SUCCESS;
+}
+
+
 /****************************************************************************/
 /**
 *
@@ -1468,6 +2110,9 @@ int XDmaPs_Start(XDmaPs *InstPtr, unsigned int Channel,
 	int Status;
 	u32 DmaProg = 0;
 	u32 Inten;
+	unsigned int Index;
+	unsigned int Event;
+	u32 Cpsr;
 
 	Xil_AssertNonvoid(InstPtr != NULL);
 	Xil_AssertNonvoid(Cmd != NULL);
@@ -1479,10 +2124,24 @@ int XDmaPs_Start(XDmaPs *InstPtr, unsigned int Channel,
 		return XST_DEVICE_BUSY;
 	}
 
+	/* a user program signals the event of its channel */
+	Event = Cmd->UserDmaProg ? Channel : XDmaPs_DoneEvent(InstPtr, Channel);
+	if (Cmd->UserDmaProg && InstPtr->CoalesceEvery &&
+	    (Channel == XDMAPS_COALESCE_EVENT)) {
+		return XST_FAILURE;
+	}
+
 	if (!Cmd->UserDmaProg && !Cmd->GeneratedDmaProg) {
-		Status = XDmaPs_GenDmaProg(InstPtr, Channel, Cmd);
-		if (Status) {
-			return XST_FAILURE;
+		if (!HoldDmaProg) {
+			/* a program released when done may come from the cache */
+			Cmd->GeneratedDmaProg =
+				XDmaPs_ProgCacheGet(InstPtr, Channel, Cmd);
+		}
+		if (!Cmd->GeneratedDmaProg) {
+			Status = XDmaPs_GenDmaProg(InstPtr, Channel, Cmd);
+			if (Status) {
+				return XST_FAILURE;
+			}
 		}
 	}
 
@@ -1496,27 +2155,33 @@ int XDmaPs_Start(XDmaPs *InstPtr, unsigned int Channel,
 
 	if (DmaProg) {
 		/* enable the interrupt */
+		Cpsr = XDmaPs_LockDev(InstPtr);
 		Inten = XDmaPs_ReadReg(InstPtr->Config.BaseAddress,
 				       XDMAPS_INTEN_OFFSET);
-		Inten |= 0x01 << Channel; /* set the correpsonding bit */
+		Inten |= 0x01 << Event; /* set the correpsonding bit */
 		XDmaPs_WriteReg(InstPtr->Config.BaseAddress,
 				XDMAPS_INTEN_OFFSET,
 				Inten);
 		Inten = XDmaPs_ReadReg(InstPtr->Config.BaseAddress,
 				       XDMAPS_INTEN_OFFSET);
+		XDmaPs_UnlockDev(InstPtr, Cpsr);
 
 		InstPtr->Chans[Channel].DmaCmdToHw = Cmd;
 
-		if (Cmd->ChanCtrl.SrcInc) {
-			Xil_DCacheFlushRange(Cmd->BD.SrcAddr, Cmd->BD.Length);
-		}
-		if (Cmd->ChanCtrl.DstInc) {
-			Xil_DCacheInvalidateRange(Cmd->BD.DstAddr,
-						  Cmd->BD.Length);
+		if (Cmd->SgList) {
+			Cmd->SgEventsDone = 0;
+			for (Index = 0; Index < Cmd->SgLength; Index++) {
+				XDmaPs_SyncBD(&Cmd->ChanCtrl,
+					      &Cmd->SgList[Index].BD);
+			}
+		} else {
+			XDmaPs_SyncBD(&Cmd->ChanCtrl, &Cmd->BD);
 		}
 
+		Cpsr = XDmaPs_LockDev(InstPtr);
 		Status = XDmaPs_Exec_DMAGO(InstPtr->Config.BaseAddress,
 					   Channel, DmaProg);
+		XDmaPs_UnlockDev(InstPtr, Cpsr);
 	} else {
 		InstPtr->Chans[Channel].DmaCmdToHw = NULL;
 		Status = XST_FAILURE;
@@ -1525,6 +2190,142 @@ int XDmaPs_Start(XDmaPs *InstPtr, unsigned int Channel,
 	return Status;
 }
 
+/****************************************************************************/
+/**
+*
+* Looks up the program cache of a channel for the shape of a command. On a
+* hit the SAR and DAR immediates of the cached program are patched with the
+* addresses of the command, on a miss the program is generated into the
+* least recently filled entry.
+*
+* @param	InstPtr is then DMA instance.
+* @param	Channel is the DMA channel number.
+* @param	Cmd is the DMA command.
+*
+* @return	The program, also set in the GeneratedDmaProg field of the
+*		command, or NULL if the command cannot be cached.
+*
+* @note		The channel must be idle, since the program it ran last may
+*		be patched.
+*
+*****************************************************************************/
+static void *XDmaPs_ProgCacheGet(XDmaPs *InstPtr, unsigned int Channel,
+				 XDmaPs_Cmd *Cmd)
+{
+	XDmaPs_ChannelData *ChanData;
+	XDmaPs_ChanCtrl *ChanCtrl = &Cmd->ChanCtrl;
+	XDmaPs_ProgCacheEntry *Entry;
+	u32 CCRValue;
+	u32 SrcUnaligned = 0;
+	u32 DstUnaligned = 0;
+	unsigned int Index;
+	int ProgLen;
+
+	if (Channel >= XDMAPS_CHANNELS_PER_DEV) {
+		return NULL;
+	}
+
+	if (ChanCtrl->SrcBurstSize * ChanCtrl->SrcBurstLen
+	    != ChanCtrl->DstBurstSize * ChanCtrl->DstBurstLen) {
+		return NULL;
+	}
+
+	if (XDmaPs_CheckBD(ChanCtrl, &Cmd->BD) != XST_SUCCESS) {
+		return NULL;
+	}
+
+	if (XDmaPs_CheckPeriph(Cmd) != XST_SUCCESS) {
+		return NULL;
+	}
+
+	ChanData = InstPtr->Chans + Channel;
+	CCRValue = XDmaPs_ToCCRValue(ChanCtrl);
+	if (ChanCtrl->SrcInc) {
+		SrcUnaligned = Cmd->BD.SrcAddr % ChanCtrl->SrcBurstSize;
+	}
+	if (ChanCtrl->DstInc) {
+		DstUnaligned = Cmd->BD.DstAddr % ChanCtrl->DstBurstSize;
+	}
+
+	for (Index = 0; Index < XDMAPS_PROG_CACHE_ENTRIES; Index++) {
+		Entry = &ChanData->ProgCache[Index];
+		if ((Entry->Len > 0) && (Entry->CCRValue == CCRValue) &&
+		    (Entry->Length == Cmd->BD.Length) &&
+		    (Entry->SrcUnaligned == SrcUnaligned) &&
+		    (Entry->DstUnaligned == DstUnaligned) &&
+		    (Entry->PeriphMode == Cmd->PeriphMode) &&
+		    (Entry->Periph == Cmd->Periph)) {
+			/* DMAMOV SAR, then DMAMOV DAR, 6 bytes each */
+			XDmaPs_Memcpy4(Entry->Buf + 2,
+				       (char *)&Cmd->BD.SrcAddr);
+			XDmaPs_Memcpy4(Entry->Buf + 8,
+				       (char *)&Cmd->BD.DstAddr);
+			Xil_DCacheFlushRange((u32)Entry->Buf, 12);
+
+			Cmd->GeneratedDmaProg = Entry->Buf;
+			Cmd->GeneratedDmaProgLength = Entry->Len;
+			return Entry->Buf;
+		}
+	}
+
+	Entry = &ChanData->ProgCache[ChanData->ProgCacheNext];
+	ChanData->ProgCacheNext = (ChanData->ProgCacheNext + 1) %
+				  XDMAPS_PROG_CACHE_ENTRIES;
+
+	Entry->Len = 0;
+	Cmd->GeneratedDmaProg = Entry->Buf;
+	ProgLen = XDmaPs_BuildDmaProg(Channel,
+				      XDmaPs_DoneEvent(InstPtr, Channel),
+				      Cmd, InstPtr->CacheLength);
+	if (ProgLen <= 0) {
+		Cmd->GeneratedDmaProg = NULL;
+		Cmd->GeneratedDmaProgLength = 0;
+		return NULL;
+	}
+
+	Entry->Len = ProgLen;
+	Entry->CCRValue = CCRValue;
+	Entry->Length = Cmd->BD.Length;
+	Entry->SrcUnaligned = SrcUnaligned;
+	Entry->DstUnaligned = DstUnaligned;
+	Entry->PeriphMode = Cmd->PeriphMode;
+	Entry->Periph = Cmd->Periph;
+	Cmd->GeneratedDmaProgLength = ProgLen;
+
+#ifdef XDMAPS_DEBUG
+	XDmaPs_Print_DmaProg(Cmd);
+#endif
+
+	return Entry->Buf;
+}
+
+/****************************************************************************/
+/**
+*
+* Does the cache maintenance of a block before it is moved: the source is
+* flushed and the destination invalidated.
+*
+* @param	ChanCtrl is the channel control of the transfer.
+* @param	BD is the block.
+*
+* @return	None.
+*
+* @note		Buffers in the non-cacheable DMA arena are coherent and need
+*		no maintenance.
+*
+*****************************************************************************/
+static void XDmaPs_SyncBD(XDmaPs_ChanCtrl *ChanCtrl, XDmaPs_BD *BD)
+{
+	if ((ChanCtrl->SrcInc) &&
+	    (Xil_DmaArenaContains(BD->SrcAddr, BD->Length) == 0U)) {
+		Xil_DCacheFlushRange(BD->SrcAddr, BD->Length);
+	}
+	if ((ChanCtrl->DstInc) &&
+	    (Xil_DmaArenaContains(BD->DstAddr, BD->Length) == 0U)) {
+		Xil_DCacheInvalidateRange(BD->DstAddr, BD->Length);
+	}
+}
+
 /****************************************************************************/
 /**
 *
@@ -1553,6 +2354,468 @@ int XDmaPs_IsActive(XDmaPs *InstPtr, unsigned int Channel)
 
 
 
+/****************************************************************************/
+/**
+*
+* Set the burst table of an instance, the rules XDmaPs_SetBurst() picks the
+* burst shape of a transfer from. A benchmark measuring the memory regions
+* of the system typically builds it.
+*
+* @param	InstPtr is the DMA instance.
+* @param	Table is the table, kept by reference. NULL restores the
+*		default table.
+* @param	NumRules is the number of rules in Table.
+*
+* @return	None.
+*
+* @note		The rules are matched in order, so the table should end with
+*		a rule covering the whole address space.
+*
+*****************************************************************************/
+void XDmaPs_SetBurstTable(XDmaPs *InstPtr, const XDmaPs_BurstRule *Table,
+			  unsigned int NumRules)
+{
+	Xil_AssertVoid(InstPtr != NULL);
+
+	if ((Table == NULL) || (NumRules == 0)) {
+		InstPtr->BurstTable = XDmaPs_DefaultBurstTable;
+		InstPtr->NumBurstRules = sizeof(XDmaPs_DefaultBurstTable) /
+					 sizeof(XDmaPs_DefaultBurstTable[0]);
+	} else {
+		InstPtr->BurstTable = Table;
+		InstPtr->NumBurstRules = NumRules;
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Set the burst size and length of a channel control from the first rule of
+* the burst table that covers the source and destination addresses. The
+* other fields of the channel control are left alone.
+*
+* @param	InstPtr is the DMA instance.
+* @param	ChanCtrl is the channel control to be set.
+* @param	SrcAddr is the source address of the transfer.
+* @param	DstAddr is the destination address of the transfer.
+*
+* @return	None.
+*
+* @note		Without a matching rule the shape is left unchanged.
+*
+*****************************************************************************/
+void XDmaPs_SetBurst(XDmaPs *InstPtr, XDmaPs_ChanCtrl *ChanCtrl,
+		     u32 SrcAddr, u32 DstAddr)
+{
+	const XDmaPs_BurstRule *Rule;
+	unsigned int Index;
+
+	Xil_AssertVoid(InstPtr != NULL);
+	Xil_AssertVoid(ChanCtrl != NULL);
+
+	for (Index = 0; Index < InstPtr->NumBurstRules; Index++) {
+		Rule = &InstPtr->BurstTable[Index];
+		if ((SrcAddr >= Rule->SrcBase) && (SrcAddr <= Rule->SrcHigh) &&
+		    (DstAddr >= Rule->DstBase) && (DstAddr <= Rule->DstHigh)) {
+			ChanCtrl->SrcBurstSize = Rule->BurstSize;
+			ChanCtrl->SrcBurstLen = Rule->BurstLen;
+			ChanCtrl->DstBurstSize = Rule->BurstSize;
+			ChanCtrl->DstBurstLen = Rule->BurstLen;
+			return;
+		}
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Submit a DMA command to a channel. The command is started at once if the
+* channel is idle, otherwise it is queued and started by the done interrupt
+* of the command ahead of it, so that the channel runs back to back. The
+* done handler of the channel is called for every command. The commands
+* are started without holding their DMA program.
+*
+* @param	InstPtr is then DMA instance.
+* @param	Channel is the DMA channel number.
+* @param	Cmd is the DMA command. It must stay valid until it is done.
+*
+* @return
+*		- XST_SUCCESS if the command is started or queued
+*		- XST_DEVICE_BUSY if the queue of the channel is full
+*		- XST_FAILURE if the command cannot be started
+*
+* @note		A queued command has its DmaStatus set to XST_DEVICE_BUSY.
+*		It may be called from the done handler.
+*
+*****************************************************************************/
+int XDmaPs_Submit(XDmaPs *InstPtr, unsigned int Channel, XDmaPs_Cmd *Cmd)
+{
+	XDmaPs_ChannelData *ChanData;
+	int Status = XST_SUCCESS;
+	u32 Cpsr;
+
+	Xil_AssertNonvoid(InstPtr != NULL);
+	Xil_AssertNonvoid(Cmd != NULL);
+
+	if (Channel >= XDMAPS_CHANNELS_PER_DEV) {
+		return XST_FAILURE;
+	}
+
+	ChanData = InstPtr->Chans + Channel;
+
+	/* the done ISR takes commands from the queue */
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	XDmaPs_LockChan(ChanData);
+
+	if ((ChanData->DmaCmdToHw == NULL) && (ChanData->QueueCount == 0)) {
+		Status = XDmaPs_Start(InstPtr, Channel, Cmd, 0);
+	} else if (ChanData->QueueCount == XDMAPS_QUEUE_DEPTH) {
+		Status = XST_DEVICE_BUSY;
+	} else {
+		Cmd->DmaStatus = XST_DEVICE_BUSY;
+		ChanData->Queue[(ChanData->QueueHead + ChanData->QueueCount) %
+				XDMAPS_QUEUE_DEPTH] = Cmd;
+		ChanData->QueueCount++;
+	}
+
+	XDmaPs_UnlockChan(ChanData);
+	mtcpsr(Cpsr);
+
+	return Status;
+}
+
+/****************************************************************************/
+/**
+*
+* Submit a DMA command to the least loaded channel of a set, see
+* XDmaPs_Submit().
+*
+* @param	InstPtr is then DMA instance.
+* @param	ChannelMask is the set of channels the command may run on,
+*		built with XDMAPS_CHANNEL_MASK() or XDMAPS_ALL_CHANNELS_MASK.
+* @param	Cmd is the DMA command.
+* @param	ChannelPtr returns the channel chosen, it may be NULL.
+*
+* @return	The status of XDmaPs_Submit(), or XST_FAILURE if the set is
+*		empty.
+*
+* @note		Every channel of the set needs a done handler.
+*
+*****************************************************************************/
+int XDmaPs_SubmitAny(XDmaPs *InstPtr, u32 ChannelMask, XDmaPs_Cmd *Cmd,
+		     unsigned int *ChannelPtr)
+{
+	int Channel;
+
+	Xil_AssertNonvoid(InstPtr != NULL);
+	Xil_AssertNonvoid(Cmd != NULL);
+
+	Channel = XDmaPs_PickChannel(InstPtr, ChannelMask);
+	if (Channel < 0) {
+		return XST_FAILURE;
+	}
+
+	if (ChannelPtr) {
+		*ChannelPtr = (unsigned int)Channel;
+	}
+
+	return XDmaPs_Submit(InstPtr, (unsigned int)Channel, Cmd);
+}
+
+/****************************************************************************/
+/**
+*
+* Get the load of a channel: the commands queued plus the one executed.
+*
+* @param	InstPtr is the DMA instance.
+* @param	Channel is the DMA channel number.
+*
+* @return	The number of commands submitted and not done yet.
+*
+* @note		None.
+*
+*****************************************************************************/
+unsigned int XDmaPs_GetLoad(XDmaPs *InstPtr, unsigned int Channel)
+{
+	XDmaPs_ChannelData *ChanData;
+
+	Xil_AssertNonvoid(InstPtr != NULL);
+
+	if (Channel >= XDMAPS_CHANNELS_PER_DEV) {
+		return 0;
+	}
+
+	ChanData = InstPtr->Chans + Channel;
+
+	if (ChanData->BatchCount) {
+		return ChanData->QueueCount + ChanData->BatchCount -
+		       ChanData->BatchRetired;
+	}
+
+	return ChanData->QueueCount + (ChanData->DmaCmdToHw != NULL);
+}
+
+/****************************************************************************/
+/**
+*
+* Pick the least loaded channel of a set. Ties go to the lowest channel.
+*
+* @param	InstPtr is the DMA instance.
+* @param	ChannelMask is the set of channels to choose from.
+*
+* @return	The channel number, or -1 if the set is empty.
+*
+* @note		None.
+*
+*****************************************************************************/
+int XDmaPs_PickChannel(XDmaPs *InstPtr, u32 ChannelMask)
+{
+	unsigned int Channel;
+	unsigned int Load;
+	unsigned int BestLoad = 0;
+	int Best = -1;
+
+	Xil_AssertNonvoid(InstPtr != NULL);
+
+	for (Channel = 0; Channel < XDMAPS_CHANNELS_PER_DEV; Channel++) {
+		if (!(ChannelMask & XDMAPS_CHANNEL_MASK(Channel))) {
+			continue;
+		}
+		Load = XDmaPs_GetLoad(InstPtr, Channel);
+		if ((Best < 0) || (Load < BestLoad)) {
+			Best = (int)Channel;
+			BestLoad = Load;
+		}
+	}
+
+	return Best;
+}
+
+/****************************************************************************/
+/**
+*
+* Coalesce the done interrupts of the channels. The programs the driver
+* builds then all signal XDMAPS_COALESCE_EVENT, whose interrupt is handled
+* by XDmaPs_DoneISR() for every channel, XDmaPs_DoneISR_0() calling it:
+* completions close together take one interrupt. The commands waiting in
+* the submission queue of an idle channel are also moved by one batch
+* program, as many as fit in XDMAPS_BATCH_PROG_LEN bytes, which signals
+* the event after every CmdsPerEvent commands and after the last one. The
+* done handler is still called once per command, in order.
+*
+* User programs, the scatter-gather ones included, keep signalling the
+* event of their channel and its XDmaPs_DoneISR_n(); they cannot run on
+* channel XDMAPS_COALESCE_EVENT while completions are coalesced.
+*
+* @param	InstPtr is the DMA instance.
+* @param	CmdsPerEvent is the number of commands of a batch per event,
+*		0 to turn the coalescing off.
+*
+* @return	- XST_SUCCESS if the coalescing is set.
+*		- XST_DEVICE_BUSY if a channel is executing a command.
+*
+* @note		The cached programs are dropped, since they signal the
+*		event they were built for; programs held by the caller must
+*		be generated again.
+*
+*****************************************************************************/
+int XDmaPs_SetCoalesce(XDmaPs *InstPtr, unsigned int CmdsPerEvent)
+{
+	XDmaPs_ChannelData *ChanData;
+	unsigned int Channel;
+	unsigned int Index;
+
+	Xil_AssertNonvoid(InstPtr != NULL);
+
+	for (Channel = 0; Channel < XDMAPS_CHANNELS_PER_DEV; Channel++) {
+		if (InstPtr->Chans[Channel].DmaCmdToHw != NULL) {
+			return XST_DEVICE_BUSY;
+		}
+	}
+
+	for (Channel = 0; Channel < XDMAPS_CHANNELS_PER_DEV; Channel++) {
+		ChanData = InstPtr->Chans + Channel;
+		for (Index = 0; Index < XDMAPS_PROG_CACHE_ENTRIES; Index++) {
+			ChanData->ProgCache[Index].Len = 0;
+		}
+	}
+	InstPtr->CoalesceEvery = CmdsPerEvent;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Start the next queued command of an idle channel. A command that fails to
+* start is handed to the done handler with its DmaStatus set to
+* XST_FAILURE, and the next one is tried. While completions are coalesced
+* the queued commands are started as a batch, see XDmaPs_StartBatch().
+*
+* @param	InstPtr is the DMA instance.
+* @param	Channel is the DMA channel number.
+*
+* @return	None.
+*
+* @note		It is called with interrupts masked, and the lock of the
+*		channel held, which is dropped around the done handler.
+*
+*****************************************************************************/
+static void XDmaPs_StartQueued(XDmaPs *InstPtr, unsigned int Channel)
+{
+	XDmaPs_ChannelData *ChanData = InstPtr->Chans + Channel;
+	XDmaPs_Cmd *Cmd;
+
+	while ((ChanData->DmaCmdToHw == NULL) && (ChanData->QueueCount > 0)) {
+		if (InstPtr->CoalesceEvery && (ChanData->QueueCount > 1) &&
+		    (XDmaPs_StartBatch(InstPtr, Channel) == XST_SUCCESS)) {
+			break;
+		}
+
+		Cmd = ChanData->Queue[ChanData->QueueHead];
+		ChanData->QueueHead = (ChanData->QueueHead + 1) %
+				      XDMAPS_QUEUE_DEPTH;
+		ChanData->QueueCount--;
+
+		if (XDmaPs_Start(InstPtr, Channel, Cmd, 0) != XST_SUCCESS) {
+			Cmd->DmaStatus = XST_FAILURE;
+			XDmaPs_UnlockChan(ChanData);
+			if (ChanData->DoneHandler)
+				ChanData->DoneHandler(Channel, Cmd,
+						      ChanData->DoneRef);
+			XDmaPs_LockChan(ChanData);
+		}
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Start the commands at the head of the queue of an idle channel as one
+* batch program, built in the batch buffer of the channel: the segment of
+* each command, a DMAWMB and a DMASEV of XDMAPS_COALESCE_EVENT after every
+* CoalesceEvery commands and after the last one. The batch stops at the
+* first command that has a program of its own, a scatter-gather list or a
+* block that cannot be moved, or once a worst case segment no longer fits.
+*
+* @param	InstPtr is the DMA instance.
+* @param	Channel is the DMA channel number.
+*
+* @return	- XST_SUCCESS if a batch of two commands or more is started.
+*		- XST_FAILURE otherwise, the queue being left as it was.
+*
+* @note		It is called with interrupts masked, and the lock of the
+*		channel held.
+*
+*****************************************************************************/
+static int XDmaPs_StartBatch(XDmaPs *InstPtr, unsigned int Channel)
+{
+	XDmaPs_ChannelData *ChanData = InstPtr->Chans + Channel;
+	char *DmaProgStart = ChanData->BatchProg;
+	char *DmaProgBuf = DmaProgStart;
+	XDmaPs_Cmd *Cmd;
+	unsigned int Count = 0;
+	unsigned int Signalled = 0;
+	unsigned int Index;
+	int SegmentBytes;
+	int Status;
+	u32 Inten;
+	u32 Cpsr;
+
+	while (Count < ChanData->QueueCount) {
+		Cmd = ChanData->Queue[(ChanData->QueueHead + Count) %
+				      XDMAPS_QUEUE_DEPTH];
+		if (Cmd->UserDmaProg || Cmd->GeneratedDmaProg ||
+		    Cmd->SgList ||
+		    (XDmaPs_CheckBD(&Cmd->ChanCtrl, &Cmd->BD) !=
+		     XST_SUCCESS) ||
+		    (XDmaPs_CheckPeriph(Cmd) != XST_SUCCESS)) {
+			break;
+		}
+
+		/* room for the worst case segment, its event and the DMAEND */
+		if ((XDMAPS_BATCH_PROG_LEN - (DmaProgBuf - DmaProgStart)) <
+		    (XDMAPS_SG_SEG_MAX_PROG_LEN + 4)) {
+			break;
+		}
+
+		if (Cmd->PeriphMode != XDMAPS_PERIPH_NONE) {
+			SegmentBytes = XDmaPs_BuildPeriphSegment(DmaProgBuf,
+								 Cmd);
+		} else {
+			SegmentBytes = XDmaPs_BuildSegment(Channel,
+				DmaProgStart, DmaProgBuf, &Cmd->ChanCtrl,
+				&Cmd->BD, InstPtr->CacheLength);
+		}
+		if (SegmentBytes == 0) {
+			break;
+		}
+		DmaProgBuf += SegmentBytes;
+		ChanData->Batch[Count++] = Cmd;
+
+		if ((Count - Signalled) == InstPtr->CoalesceEvery) {
+			DmaProgBuf += XDmaPs_Instr_DMAWMB(DmaProgBuf);
+			DmaProgBuf += XDmaPs_Instr_DMASEV(DmaProgBuf,
+						XDMAPS_COALESCE_EVENT);
+			for (Index = Signalled; Index < Count; Index++) {
+				ChanData->BatchDone[Index] =
+					DmaProgBuf - DmaProgStart;
+			}
+			Signalled = Count;
+		}
+	}
+
+	if (Count < 2) {
+		return XST_FAILURE;
+	}
+
+	if (Signalled < Count) {
+		DmaProgBuf += XDmaPs_Instr_DMAWMB(DmaProgBuf);
+		DmaProgBuf += XDmaPs_Instr_DMASEV(DmaProgBuf,
+						  XDMAPS_COALESCE_EVENT);
+		for (Index = Signalled; Index < Count; Index++) {
+			ChanData->BatchDone[Index] = DmaProgBuf - DmaProgStart;
+		}
+	}
+	DmaProgBuf += XDmaPs_Instr_DMAEND(DmaProgBuf);
+	Xil_DCacheFlushRange((u32)DmaProgStart, DmaProgBuf - DmaProgStart);
+
+	for (Index = 0; Index < Count; Index++) {
+		Cmd = ChanData->Batch[Index];
+		Cmd->DmaStatus = XST_DEVICE_BUSY;
+		XDmaPs_SyncBD(&Cmd->ChanCtrl, &Cmd->BD);
+	}
+
+	Cpsr = XDmaPs_LockDev(InstPtr);
+	Inten = XDmaPs_ReadReg(InstPtr->Config.BaseAddress,
+			       XDMAPS_INTEN_OFFSET);
+	XDmaPs_WriteReg(InstPtr->Config.BaseAddress, XDMAPS_INTEN_OFFSET,
+			Inten | (0x01 << XDMAPS_COALESCE_EVENT));
+	XDmaPs_UnlockDev(InstPtr, Cpsr);
+
+	ChanData->HoldDmaProg = 0;
+	ChanData->BatchCount = Count;
+	ChanData->BatchRetired = 0;
+	ChanData->DmaCmdToHw = ChanData->Batch[0];
+
+	Cpsr = XDmaPs_LockDev(InstPtr);
+	Status = XDmaPs_Exec_DMAGO(InstPtr->Config.BaseAddress, Channel,
+				   (u32)DmaProgStart);
+	XDmaPs_UnlockDev(InstPtr, Cpsr);
+	if (Status != XST_SUCCESS) {
+		ChanData->BatchCount = 0;
+		ChanData->DmaCmdToHw = NULL;
+		return XST_FAILURE;
+	}
+
+	ChanData->QueueHead = (ChanData->QueueHead + Count) %
+			      XDMAPS_QUEUE_DEPTH;
+	ChanData->QueueCount -= Count;
+
+	return XST_SUCCESS;
+}
+
 /****************************************************************************/
 /**
 *
@@ -1582,6 +2845,37 @@ static void *XDmaPs_BufPool_Allocate(XDmaPs_ProgBuf *Pool)
 
 }
 
+/*****************************************************************************/
+/**
+*
+* Done interrupt service routine of all the channels while completions are
+* coalesced, see XDmaPs_SetCoalesce(), for the interrupt of
+* XDMAPS_COALESCE_EVENT. A command is retired once its channel has stopped
+* or has gone past the DMASEV that follows it, as told by the program
+* counter of the channel, so that the completions of any number of
+* channels and commands are handled by one interrupt.
+*
+* @param	InstPtr is the DMA instance.
+*
+* @return	None.
+*
+* @note		XDmaPs_DoneISR_0() calls it while completions are
+*		coalesced, so the handler connected to the GIC is the same.
+*
+******************************************************************************/
+void XDmaPs_DoneISR(XDmaPs *InstPtr)
+{
+	unsigned int Channel;
+
+	/* an event signalled from now on raises the interrupt again */
+	XDmaPs_WriteReg(InstPtr->Config.BaseAddress, XDMAPS_INTCLR_OFFSET,
+			1 << XDMAPS_COALESCE_EVENT);
+
+	for (Channel = 0; Channel < XDMAPS_CHANNELS_PER_DEV; Channel++) {
+		XDmaPs_Retire(InstPtr, Channel);
+	}
+}
+
 /*****************************************************************************/
 /**
 *
@@ -1598,6 +2892,11 @@ static void *XDmaPs_BufPool_Allocate(XDmaPs_ProgBuf *Pool)
 ******************************************************************************/
 void XDmaPs_DoneISR_0(XDmaPs *InstPtr)
 {
+	if (InstPtr->CoalesceEvery) {
+		XDmaPs_DoneISR(InstPtr);
+		return;
+	}
+
 	XDmaPs_DoneISR_n(InstPtr, 0);
 }
 
@@ -1878,6 +3177,12 @@ static int XDmaPs_Exec_DMAGO(u32 BaseAddr, unsigned int Channel, u32 DmaProg)
 		return -1;
 	}
 
+	/*
+	 * The writes of the CPU to the source buffers are complete before
+	 * the channel starts, device memory writes being posted
+	 */
+	dsb();
+
 	/* run the command in DbgInst0 and DbgInst1 */
 	XDmaPs_WriteReg(BaseAddr, XDMAPS_DBGCMD_OFFSET, 0);
 
@@ -1919,8 +3224,24 @@ static void XDmaPs_DoneISR_n(XDmaPs *InstPtr, unsigned Channel)
 			XDMAPS_INTSTATUS_OFFSET);*/
 
 
+	XDmaPs_LockChan(ChanData);
 	DmaCmd = ChanData->DmaCmdToHw;
-	if (DmaCmd) {
+	if (!DmaCmd) {
+		XDmaPs_UnlockChan(ChanData);
+	} else {
+		if (DmaCmd->SgList &&
+		    XDmaPs_SgPending(InstPtr, Channel, DmaCmd)) {
+			/* a flagged segment, the list is still running */
+			DmaCmd->DmaStatus = XST_DEVICE_BUSY;
+			XDmaPs_UnlockChan(ChanData);
+			XIL_TRACE_EVENT(XIL_TRACE_ID_DMA_DONE, Channel,
+					DmaCmd->DmaStatus);
+			if (ChanData->DoneHandler)
+				ChanData->DoneHandler(Channel, DmaCmd,
+						      ChanData->DoneRef);
+			return;
+		}
+
 		if (!ChanData->HoldDmaProg) {
 			DmaProgBuf = (void *)DmaCmd->GeneratedDmaProg;
 			if (DmaProgBuf)
@@ -1933,6 +3254,11 @@ static void XDmaPs_DoneISR_n(XDmaPs *InstPtr, unsigned Channel)
 		ChanData->DmaCmdToHw = NULL;
 		ChanData->DmaCmdFromHw = DmaCmd;
 
+		/* keep the channel busy before handling the finished command */
+		XDmaPs_StartQueued(InstPtr, Channel);
+		XDmaPs_UnlockChan(ChanData);
+		XIL_TRACE_EVENT(XIL_TRACE_ID_DMA_DONE, Channel, 0U);
+
 		if (ChanData->DoneHandler)
 			ChanData->DoneHandler(Channel, DmaCmd,
 					      ChanData->DoneRef);
@@ -1941,6 +3267,124 @@ static void XDmaPs_DoneISR_n(XDmaPs *InstPtr, unsigned Channel)
 }
 
 
+/****************************************************************************/
+/**
+*
+* Counts an event of a scatter-gather program and tells whether more are to
+* come. Events that are signalled before the interrupt is handled merge
+* into one, so the program is also known to be done once the channel has
+* stopped.
+*
+* @param	InstPtr is the DMA instance.
+* @param	Channel is the DMA channel numer.
+* @param	DmaCmd is the command being executed.
+*
+* @return	1 if the program is still running, 0 if it is done.
+*
+* @note		None.
+*
+*****************************************************************************/
+static int XDmaPs_SgPending(XDmaPs *InstPtr, unsigned Channel,
+			    XDmaPs_Cmd *DmaCmd)
+{
+	DmaCmd->SgEventsDone++;
+	if (DmaCmd->SgEventsDone >= DmaCmd->SgEvents) {
+		return 0;
+	}
+
+	return (XDmaPs_ReadReg(InstPtr->Config.BaseAddress,
+			       XDmaPs_CSn_OFFSET(Channel)) &
+		XDMAPS_DS_DMA_STATUS) != XDMAPS_DS_DMA_STATUS_STOPPED;
+}
+
+/****************************************************************************/
+/**
+*
+* Retires the commands of a channel that are done, for XDmaPs_DoneISR(),
+* starts the queued ones and calls the done handler for each command
+* retired.
+*
+* @param	InstPtr is the DMA instance.
+* @param	Channel is the DMA channel numer.
+*
+* @return	None.
+*
+* @note		A user or scatter-gather program is retired by the done ISR
+*		of its channel.
+*
+*****************************************************************************/
+static void XDmaPs_Retire(XDmaPs *InstPtr, unsigned int Channel)
+{
+	XDmaPs_ChannelData *ChanData = InstPtr->Chans + Channel;
+	XDmaPs_Cmd *Done[XDMAPS_QUEUE_DEPTH];
+	unsigned int NumDone = 0;
+	unsigned int Index;
+	XDmaPs_Cmd *DmaCmd;
+	void *DmaProgBuf;
+	u32 Stopped;
+	u32 Pc;
+
+	XDmaPs_LockChan(ChanData);
+	DmaCmd = ChanData->DmaCmdToHw;
+	if (!DmaCmd || ((DmaCmd->UserDmaProg || DmaCmd->SgList) &&
+			!ChanData->BatchCount)) {
+		XDmaPs_UnlockChan(ChanData);
+		return;
+	}
+
+	Stopped = (XDmaPs_ReadReg(InstPtr->Config.BaseAddress,
+				  XDmaPs_CSn_OFFSET(Channel)) &
+		   XDMAPS_DS_DMA_STATUS) == XDMAPS_DS_DMA_STATUS_STOPPED;
+	Pc = XDmaPs_ReadReg(InstPtr->Config.BaseAddress,
+			    XDmaPs_CPCn_OFFSET(Channel));
+
+	if (ChanData->BatchCount) {
+		Pc -= (u32)ChanData->BatchProg;
+		while ((ChanData->BatchRetired < ChanData->BatchCount) &&
+		       (Stopped ||
+			(Pc >= ChanData->BatchDone[ChanData->BatchRetired]))) {
+			DmaCmd = ChanData->Batch[ChanData->BatchRetired++];
+			DmaCmd->DmaStatus = 0;
+			Done[NumDone++] = DmaCmd;
+		}
+		if (ChanData->BatchRetired == ChanData->BatchCount) {
+			ChanData->BatchCount = 0;
+			ChanData->DmaCmdToHw = NULL;
+		} else {
+			ChanData->DmaCmdToHw =
+				ChanData->Batch[ChanData->BatchRetired];
+		}
+	} else if (Stopped ||
+		   ((Pc - (u32)DmaCmd->GeneratedDmaProg) >=
+		    (u32)(DmaCmd->GeneratedDmaProgLength - 1))) {
+		/* at the DMAEND, past the DMASEV */
+		if (!ChanData->HoldDmaProg) {
+			DmaProgBuf = (void *)DmaCmd->GeneratedDmaProg;
+			if (DmaProgBuf)
+				XDmaPs_BufPool_Free(ChanData->ProgBufPool,
+						    DmaProgBuf);
+			DmaCmd->GeneratedDmaProg = NULL;
+		}
+		DmaCmd->DmaStatus = 0;
+		ChanData->DmaCmdToHw = NULL;
+		Done[NumDone++] = DmaCmd;
+	}
+
+	if (NumDone) {
+		ChanData->DmaCmdFromHw = Done[NumDone - 1];
+		/* keep the channel busy while the commands are handled */
+		XDmaPs_StartQueued(InstPtr, Channel);
+	}
+	XDmaPs_UnlockChan(ChanData);
+
+	for (Index = 0; Index < NumDone; Index++) {
+		XIL_TRACE_EVENT(XIL_TRACE_ID_DMA_DONE, Channel, 0U);
+		if (ChanData->DoneHandler)
+			ChanData->DoneHandler(Channel, Done[Index],
+					      ChanData->DoneRef);
+	}
+}
+
 /****************************************************************************/
 /**
 * Prints the content of the buffer in bytes
@@ -62,6 +62,24 @@
 * 2.8	sk     05/18/21 Modify all inline functions declarations from extern inline
 *			to static inline to avoid the linkage conflict for IAR compiler.
 * 2.9   aj     11/07/23 Added support for system device tree
+* 2.10  qm     10/14/26 Added scatter-gather lists run as one DMA program,
+*			see XDmaPs_GenSgDmaProg().
+*			Added a per channel cache of generated programs, see
+*			XDMAPS_PROG_CACHE_ENTRIES.
+*			Added per channel submission queues, see
+*			XDmaPs_Submit().
+*			Added the burst table picking the burst shape per
+*			memory region, see XDmaPs_SetBurst().
+*			Added the optional channel and device locks of
+*			XIL_SMP_DRIVER_LOCKS.
+*			Added the transfers paced by the peripheral request
+*			interfaces of the PL, see the PeriphMode of
+*			XDmaPs_Cmd.
+*			Added the coalescing of the done interrupts of the
+*			channels, see XDmaPs_SetCoalesce().
+*			Grouped the instance and channel members by their
+*			use, with the cache line aligned layout of
+*			XIL_DRIVER_HOT_LAYOUT.
 * </pre>
 *
 *****************************************************************************/
@@ -81,9 +99,33 @@ extern "C" {
 #include "xstatus.h"
 
 #include "xdmaps_hw.h"
+#if defined (XIL_SMP_DRIVER_LOCKS) || defined (XIL_DRIVER_HOT_LAYOUT)
+#include "xil_atomic.h"
+#endif
+#ifndef XIL_HOT_GROUP_BEGIN	/* Plain members, see xil_atomic.h */
+#define XIL_HOT_GROUP_BEGIN
+#define XIL_HOT_GROUP_END
+#endif
 
 /************************** Constant Definitions ****************************/
 
+/** @name Scatter-gather segment flags
+ * @{
+ */
+#define XDMAPS_SG_EVENT		0x1U	/**< Call the done handler once the
+					  *  segment is moved. The last
+					  *  segment always does. */
+/* @} */
+
+/**
+ * Worst case program bytes per scatter-gather segment, for an icache line
+ * of up to 32 bytes. A program of N segments needs
+ * XDMAPS_SG_PROG_LEN(N) bytes.
+ */
+#define XDMAPS_SG_SEG_MAX_PROG_LEN	225
+#define XDMAPS_SG_PROG_LEN(NumSegs)	\
+	(((NumSegs) * XDMAPS_SG_SEG_MAX_PROG_LEN) + 1)
+
 /**************************** Type Definitions ******************************/
 
 /**
@@ -133,6 +175,13 @@ typedef struct {
 	unsigned int Length;	/**< Number of bytes for the block */
 } XDmaPs_BD;
 
+/** Scatter-gather segment structure.
+ */
+typedef struct {
+	XDmaPs_BD BD;		/**< Block of the segment */
+	u32 Flags;		/**< XDMAPS_SG_* flags */
+} XDmaPs_SgSeg;
+
 /**
  * A DMA command consisits of a channel control struct, a block descriptor,
  * a user defined program, a pointer pointing to generated DMA program, and
@@ -176,8 +225,40 @@ typedef struct {
 				 */
 	u32 ChanFaultPCAddr;	/**< Channel fault PC address
 				 */
+	XDmaPs_SgSeg *SgList;	/**< Segments of the program built by
+				 *   XDmaPs_GenSgDmaProg(), NULL when
+				 *   the command moves BD only
+				 */
+	unsigned int SgLength;	/**< Number of segments in SgList
+				 */
+	unsigned int SgEvents;	/**< Number of events the program
+				 *   signals
+				 */
+	unsigned int SgEventsDone; /**< Number of events handled
+				    */
+	unsigned int PeriphMode; /**< XDMAPS_PERIPH_NONE for a memory
+				  *   to memory transfer, the direction
+				  *   of a transfer paced by Periph
+				  *   otherwise
+				  */
+	unsigned int Periph;	/**< Peripheral request interface,
+				 *   0 to XDMAPS_NUM_PERIPH - 1
+				 */
 } XDmaPs_Cmd;
 
+/**
+ * A rule of the burst table: the burst shape of the transfers from a source
+ * range to a destination range. See XDmaPs_SetBurst().
+ */
+typedef struct {
+	u32 SrcBase;		/**< First byte of the source range */
+	u32 SrcHigh;		/**< Last byte of the source range */
+	u32 DstBase;		/**< First byte of the destination range */
+	u32 DstHigh;		/**< Last byte of the destination range */
+	unsigned int BurstSize;	/**< Bytes per beat, both sides */
+	unsigned int BurstLen;	/**< Beats per burst, both sides */
+} XDmaPs_BurstRule;
+
 /**
  * It's the done handler a user can set for a channel
  */
@@ -195,6 +276,69 @@ typedef void (*XDmaPsFaultHandler) (unsigned int Channel,
 #define XDMAPS_MAX_CHAN_BUFS	2
 #define XDMAPS_CHAN_BUF_LEN	128
 
+/** @name Peripheral modes
+ * The PeriphMode of a command. In a peripheral mode the channel waits with
+ * DMAWFP for a request of the PL on the Periph interface before each burst,
+ * loads or stores it with DMALDP or DMASTP on the side of the peripheral,
+ * which acknowledges the request, and flushes the interface with DMAFLUSHP.
+ * The peripheral requests bursts of SrcBurstLen beats, and single beats
+ * for the rest of the block, which must be a whole number of beats of the
+ * incrementing side; both addresses must be aligned on their beats. The
+ * channel waits as long as the PL does not request, XDmaPs_ResetChannel()
+ * stops it. The request interfaces are secure, as set by TZ_DMA_PERIPH_NS.
+ * Peripheral commands cannot have a scatter-gather list.
+ * @{
+ */
+#define XDMAPS_PERIPH_NONE	0	/**< Memory to memory */
+#define XDMAPS_PERIPH_TO_MEM	1	/**< From the PL, e.g. a FIFO */
+#define XDMAPS_MEM_TO_PERIPH	2	/**< To the PL */
+/* @} */
+
+#define XDMAPS_NUM_PERIPH	4	/**< Request interfaces of the PL */
+
+/**
+ * Number of generated programs cached per channel. XDmaPs_Start() keeps
+ * the programs it generates for commands started without HoldDmaProg,
+ * keyed on the shape of the transfer: the channel control register value,
+ * the length and the misalignment of the addresses. A command of a known
+ * shape only has the DMAMOV immediates of SAR and DAR patched.
+ */
+#ifndef XDMAPS_PROG_CACHE_ENTRIES
+#define XDMAPS_PROG_CACHE_ENTRIES	2
+#endif
+
+/**
+ * Number of commands that can wait in the submission queue of a channel,
+ * behind the one being executed. See XDmaPs_Submit().
+ */
+#ifndef XDMAPS_QUEUE_DEPTH
+#define XDMAPS_QUEUE_DEPTH	8
+#endif
+
+/**
+ * Event signalled by all the programs the driver builds while the done
+ * interrupts are coalesced, see XDmaPs_SetCoalesce().
+ */
+#define XDMAPS_COALESCE_EVENT	0
+
+/**
+ * Size of the program of a channel moving a batch of queued commands while
+ * the done interrupts are coalesced, a worst case segment taking
+ * XDMAPS_SG_SEG_MAX_PROG_LEN bytes.
+ */
+#ifndef XDMAPS_BATCH_PROG_LEN
+#define XDMAPS_BATCH_PROG_LEN	512
+#endif
+
+/** @name Channel affinity masks
+ * Sets of channels XDmaPs_PickChannel() and XDmaPs_SubmitAny() choose from.
+ * @{
+ */
+#define XDMAPS_CHANNEL_MASK(Channel)	(1U << (Channel))
+#define XDMAPS_ALL_CHANNELS_MASK	\
+	((1U << XDMAPS_CHANNELS_PER_DEV) - 1U)
+/* @} */
+
 /**
  * The XDmaPs_ProgBuf is the struct for a DMA program buffer.
  */
@@ -207,15 +351,30 @@ typedef struct {
 					  *  buffer is allocated or not */
 } XDmaPs_ProgBuf;
 
+/**
+ * The XDmaPs_ProgCacheEntry is the struct for a cached DMA program.
+ */
+typedef struct {
+	char Buf[XDMAPS_CHAN_BUF_LEN];  /**< The program, starting with the
+					  *  DMAMOVs of SAR and DAR */
+	int Len;			/**< The length of the program in
+					  *  bytes, 0 if the entry is free */
+	u32 CCRValue;			/**< Channel control of the transfer */
+	unsigned int Length;		/**< Number of bytes moved */
+	u32 SrcUnaligned;		/**< Source address modulo the source
+					  *  burst size */
+	u32 DstUnaligned;		/**< Destination address modulo the
+					  *  destination burst size */
+	unsigned int PeriphMode;	/**< Peripheral mode of the transfer */
+	unsigned int Periph;		/**< Its request interface */
+} XDmaPs_ProgCacheEntry;
+
 /**
  * The XDmaPs_ChannelData is a struct to book keep individual channel of
  * the DMAC.
  */
 typedef struct {
-	unsigned DevId;		 	/**< Device id indicating which DMAC */
-	unsigned ChanId; 		/**< Channel number of the DMAC */
-	XDmaPs_ProgBuf ProgBufPool[XDMAPS_MAX_CHAN_BUFS]; /**< A pool of
-							      program buffers*/
+	XIL_HOT_GROUP_BEGIN	/* Done interrupt handler */
 	XDmaPsDoneHandler DoneHandler; 	/**< Done interrupt handler */
 	void *DoneRef;			/**< Done interrupt callback data */
 	XDmaPs_Cmd *DmaCmdToHw; 	/**< DMA command being executed */
@@ -225,7 +384,32 @@ typedef struct {
 	int HoldDmaProg;		/**< A tag indicating whether to hold the
 					  *  DMA program after the DMA is done.
 					  */
+	XDmaPs_Cmd *Queue[XDMAPS_QUEUE_DEPTH]; /**< Commands waiting for the
+						 *  channel */
+	unsigned QueueHead;		/**< Oldest command of the queue */
+	unsigned QueueCount;		/**< Number of commands queued */
+	XDmaPs_Cmd *Batch[XDMAPS_QUEUE_DEPTH]; /**< Commands of the batch */
+	unsigned BatchDone[XDMAPS_QUEUE_DEPTH]; /**< Offset past the DMASEV
+						  *  of each command */
+	unsigned BatchCount;		/**< Commands in the batch, 0 if the
+					  *  channel is not running one */
+	unsigned BatchRetired;		/**< Commands of the batch done */
+#if defined (XIL_SMP_DRIVER_LOCKS)
+	Xil_TicketLock Lock;		/**< Command and queue of the channel,
+					  *  between the CPUs */
+#endif
+	XIL_HOT_GROUP_END
 
+	XIL_HOT_GROUP_BEGIN	/* Programs */
+	unsigned DevId;		 	/**< Device id indicating which DMAC */
+	unsigned ChanId; 		/**< Channel number of the DMAC */
+	XDmaPs_ProgBuf ProgBufPool[XDMAPS_MAX_CHAN_BUFS]; /**< A pool of
+							      program buffers*/
+	XDmaPs_ProgCacheEntry ProgCache[XDMAPS_PROG_CACHE_ENTRIES];
+					/**< Programs of recent transfers */
+	unsigned ProgCacheNext;		/**< Entry replaced on the next miss */
+	char BatchProg[XDMAPS_BATCH_PROG_LEN]; /**< Program of the batch */
+	XIL_HOT_GROUP_END
 } XDmaPs_ChannelData;
 
 /**
@@ -234,15 +418,27 @@ typedef struct {
  * instance.
  */
 typedef struct {
+	XIL_HOT_GROUP_BEGIN	/* Interrupt handlers */
 	XDmaPs_Config Config;	/**< Configuration data structure */
 	int IsReady;		/**< Device is Ready */
-	int CacheLength;	/**< icache length */
 	XDmaPsFaultHandler FaultHandler; /**< fault interrupt handler */
 	void *FaultRef;	/**< fault call back data */
+	unsigned int CoalesceEvery;	/**< Commands of a batch per done
+					  *  event, 0 if not coalescing */
+#if defined (XIL_SMP_DRIVER_LOCKS)
+	Xil_TicketLock DevLock;	/**< Debug instruction interface and
+				  *  INTEN, shared by the channels */
+#endif
+	XIL_HOT_GROUP_END
 	XDmaPs_ChannelData Chans[XDMAPS_CHANNELS_PER_DEV];
 	/**<
 	 * channel data
 	 */
+	XIL_HOT_GROUP_BEGIN	/* Configuration */
+	int CacheLength;	/**< icache length */
+	const XDmaPs_BurstRule *BurstTable; /**< Burst shape per region */
+	unsigned int NumBurstRules;	/**< Rules in BurstTable */
+	XIL_HOT_GROUP_END
 } XDmaPs;
 
 /*
@@ -257,11 +453,25 @@ int XDmaPs_Start(XDmaPs *InstPtr, unsigned int Channel,
 		 int HoldDmaProg);
 
 int XDmaPs_IsActive(XDmaPs *InstPtr, unsigned int Channel);
+int XDmaPs_Submit(XDmaPs *InstPtr, unsigned int Channel, XDmaPs_Cmd *Cmd);
+int XDmaPs_SubmitAny(XDmaPs *InstPtr, u32 ChannelMask, XDmaPs_Cmd *Cmd,
+		     unsigned int *ChannelPtr);
+unsigned int XDmaPs_GetLoad(XDmaPs *InstPtr, unsigned int Channel);
+int XDmaPs_PickChannel(XDmaPs *InstPtr, u32 ChannelMask);
+int XDmaPs_SetCoalesce(XDmaPs *InstPtr, unsigned int CmdsPerEvent);
 int XDmaPs_GenDmaProg(XDmaPs *InstPtr, unsigned int Channel,
 		      XDmaPs_Cmd *Cmd);
 int XDmaPs_FreeDmaProg(XDmaPs *InstPtr, unsigned int Channel,
 		       XDmaPs_Cmd *Cmd);
+int XDmaPs_GenSgDmaProg(XDmaPs *InstPtr, unsigned int Channel,
+			XDmaPs_Cmd *Cmd, XDmaPs_SgSeg *SgList,
+			unsigned int SgLength, void *ProgBuf,
+			int ProgBufLen);
 void XDmaPs_Print_DmaProg(XDmaPs_Cmd *Cmd);
+void XDmaPs_SetBurstTable(XDmaPs *InstPtr, const XDmaPs_BurstRule *Table,
+			  unsigned int NumRules);
+void XDmaPs_SetBurst(XDmaPs *InstPtr, XDmaPs_ChanCtrl *ChanCtrl,
+		     u32 SrcAddr, u32 DstAddr);
 
 
 int XDmaPs_ResetManager(XDmaPs *InstPtr);
@@ -298,6 +508,13 @@ static INLINE int XDmaPs_Instr_DMAMOV(char *DmaProg, unsigned Rd, u32 Imm);
 static INLINE int XDmaPs_Instr_DMANOP(char *DmaProg);
 static INLINE int XDmaPs_Instr_DMASEV(char *DmaProg, unsigned int EventNumber);
 static INLINE int XDmaPs_Instr_DMAST(char *DmaProg);
+static INLINE int XDmaPs_Instr_DMAWFP(char *DmaProg, unsigned int Periph,
+				      unsigned int Burst);
+static INLINE int XDmaPs_Instr_DMALDP(char *DmaProg, unsigned int Periph,
+				      unsigned int Burst);
+static INLINE int XDmaPs_Instr_DMASTP(char *DmaProg, unsigned int Periph,
+				      unsigned int Burst);
+static INLINE int XDmaPs_Instr_DMAFLUSHP(char *DmaProg, unsigned int Periph);
 static INLINE unsigned XDmaPs_ToEndianSwapSizeBits(unsigned int EndianSwapSize);
 static INLINE unsigned XDmaPs_ToBurstSizeBits(unsigned BurstSize);
 #endif
@@ -307,6 +524,7 @@ static INLINE unsigned XDmaPs_ToBurstSizeBits(unsigned BurstSize);
  * We need this done ISR mainly because the driver needs to release the
  * DMA program buffer. This is the one that connects the GIC
  */
+void XDmaPs_DoneISR(XDmaPs *InstPtr);
 void XDmaPs_DoneISR_0(XDmaPs *InstPtr);
 void XDmaPs_DoneISR_1(XDmaPs *InstPtr);
 void XDmaPs_DoneISR_2(XDmaPs *InstPtr);
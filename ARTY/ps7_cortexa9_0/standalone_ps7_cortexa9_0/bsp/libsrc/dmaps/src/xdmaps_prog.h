@@ -0,0 +1,220 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file xdmaps_prog.h
+* @addtogroup dmaps Overview
+* @{
+* @details
+*
+* This file contains DMA programs of a fixed shape built at compile time.
+* XDmaPs_GenDmaProg() assembles a program at run time for any command, one
+* instruction at a time; for the transfers of an application whose burst
+* shape and length are known when it is built, the same program is an
+* initializer of a byte array instead, and a transfer only patches the
+* source and destination immediates of it.
+*
+* XDMAPS_PROG_LOOP() is the program of Count bursts, XDMAPS_PROG_NESTED()
+* that of Outer times Inner bursts, up to 256 times 256. Both move SAR, DAR
+* and CCR first, like the generated programs, then loop on DMALD and DMAST,
+* then signal the event of the channel after a write barrier:
+*
+* @code
+*	static u8 XDMAPS_PROG_ALIGN Prog[XDMAPS_PROG_LOOP_LEN] = {
+*		XDMAPS_PROG_LOOP(XDMAPS_PROG_CCR(8, 16, 1, 1), 32, Channel)
+*	};
+*	Cmd.BD.SrcAddr = Src;		// 32 bursts of 128 bytes
+*	Cmd.BD.DstAddr = Dst;
+*	Cmd.BD.Length = 4096;
+*	XDmaPs_ProgBind(&Cmd, Prog, sizeof(Prog));
+*	XDmaPs_Start(&Dma, Channel, &Cmd, 0);
+* @endcode
+*
+* The macros are constant expressions, so the array may equally be a
+* constexpr std::array or the member of a template in C++. The ChanCtrl of
+* the command must describe the CCR of the program and its BD the transfer,
+* since XDmaPs_Start() does the cache maintenance of the buffers from them.
+* The length is not checked against the shape: a program moves exactly its
+* bursts, whatever the BD says.
+*
+* The arrays must be writable, for the patch, and aligned with
+* XDMAPS_PROG_ALIGN so that a program sits in one cache line of the CPU
+* and of the DMAC instruction cache.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 2.10  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef XDMAPS_PROG_H		/* prevent circular inclusions */
+#define XDMAPS_PROG_H		/* by using protection macros */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xdmaps.h"
+#include "xil_cache.h"
+
+/************************** Constant Definitions ****************************/
+
+/** @name Program lengths and immediate offsets
+ * @{
+ */
+#define XDMAPS_PROG_LOOP_LEN	28U	/**< Bytes of XDMAPS_PROG_LOOP() */
+#define XDMAPS_PROG_NESTED_LEN	32U	/**< Bytes of XDMAPS_PROG_NESTED() */
+#define XDMAPS_PROG_SAR_OFFSET	2U	/**< Immediate of DMAMOV SAR */
+#define XDMAPS_PROG_DAR_OFFSET	8U	/**< Immediate of DMAMOV DAR */
+/* @} */
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/** Places a program in a single cache line */
+#define XDMAPS_PROG_ALIGN	__attribute__((aligned(32)))
+
+/** @name Instructions, as comma separated bytes
+ * @{
+ */
+#define XDMAPS_PROG_IMM(Imm) \
+	(u8)((Imm) & 0xFFU), (u8)(((Imm) >> 8U) & 0xFFU), \
+	(u8)(((Imm) >> 16U) & 0xFFU), (u8)(((Imm) >> 24U) & 0xFFU)
+#define XDMAPS_PROG_DMAMOV(Rd, Imm)	0xBCU, (u8)((Rd) & 0x7U), \
+					XDMAPS_PROG_IMM(Imm)
+#define XDMAPS_PROG_DMALP(Lc, Iter)	(u8)(0x20U | (((Lc) & 1U) << 1U)), \
+					(u8)((Iter) - 1U)
+#define XDMAPS_PROG_DMALPEND(Lc, Jump)	(u8)(0x38U | (((Lc) & 1U) << 2U)), \
+					(u8)(Jump)
+#define XDMAPS_PROG_DMALD		0x04U
+#define XDMAPS_PROG_DMAST		0x08U
+#define XDMAPS_PROG_DMAWMB		0x13U
+#define XDMAPS_PROG_DMASEV(Event)	0x34U, (u8)(((Event) & 0x1FU) << 3U)
+#define XDMAPS_PROG_DMAEND		0x00U
+/* @} */
+
+/** Register numbers of DMAMOV */
+#define XDMAPS_PROG_SAR		0x0U
+#define XDMAPS_PROG_CCR_REG	0x1U
+#define XDMAPS_PROG_DAR		0x2U
+
+/**
+ * Encoding of a burst size of 1 to 128 bytes in the CCR, as
+ * XDmaPs_ToBurstSizeBits() does it.
+ */
+#define XDMAPS_PROG_SIZE_BITS(Size) \
+	(((Size) >= 128U) ? 7U : ((Size) >= 64U) ? 6U : ((Size) >= 32U) ? 5U : \
+	 ((Size) >= 16U) ? 4U : ((Size) >= 8U) ? 3U : ((Size) >= 4U) ? 2U : \
+	 ((Size) >= 2U) ? 1U : 0U)
+
+/**
+ * CCR of bursts of Len beats of Size bytes on both sides, with the cache
+ * and protection controls 0 and no endian swap, as XDmaPs_ToCCRValue()
+ * encodes a ChanCtrl with these fields.
+ */
+#define XDMAPS_PROG_CCR(Size, Len, SrcInc, DstInc) \
+	((((u32)(Len) - 1U) & 0xFU) << 18U | \
+	 (u32)XDMAPS_PROG_SIZE_BITS(Size) << 15U | \
+	 ((u32)(DstInc) & 1U) << 14U | \
+	 (((u32)(Len) - 1U) & 0xFU) << 4U | \
+	 (u32)XDMAPS_PROG_SIZE_BITS(Size) << 1U | \
+	 ((u32)(SrcInc) & 1U))
+
+/**
+ * Program of Count bursts, 1 to 256, with CCR Ccr, signalling Event. The
+ * addresses are 0 until patched.
+ */
+#define XDMAPS_PROG_LOOP(Ccr, Count, Event) \
+	XDMAPS_PROG_DMAMOV(XDMAPS_PROG_SAR, 0U), \
+	XDMAPS_PROG_DMAMOV(XDMAPS_PROG_DAR, 0U), \
+	XDMAPS_PROG_DMAMOV(XDMAPS_PROG_CCR_REG, Ccr), \
+	XDMAPS_PROG_DMALP(0U, Count), \
+	XDMAPS_PROG_DMALD, XDMAPS_PROG_DMAST, \
+	XDMAPS_PROG_DMALPEND(0U, 2U), \
+	XDMAPS_PROG_DMAWMB, XDMAPS_PROG_DMASEV(Event), XDMAPS_PROG_DMAEND
+
+/**
+ * Program of Outer times Inner bursts, each 1 to 256, with CCR Ccr,
+ * signalling Event. The outer loop jumps back over the inner DMALP, the
+ * two transfers and the inner DMALPEND.
+ */
+#define XDMAPS_PROG_NESTED(Ccr, Outer, Inner, Event) \
+	XDMAPS_PROG_DMAMOV(XDMAPS_PROG_SAR, 0U), \
+	XDMAPS_PROG_DMAMOV(XDMAPS_PROG_DAR, 0U), \
+	XDMAPS_PROG_DMAMOV(XDMAPS_PROG_CCR_REG, Ccr), \
+	XDMAPS_PROG_DMALP(1U, Outer), \
+	XDMAPS_PROG_DMALP(0U, Inner), \
+	XDMAPS_PROG_DMALD, XDMAPS_PROG_DMAST, \
+	XDMAPS_PROG_DMALPEND(0U, 2U), \
+	XDMAPS_PROG_DMALPEND(1U, 6U), \
+	XDMAPS_PROG_DMAWMB, XDMAPS_PROG_DMASEV(Event), XDMAPS_PROG_DMAEND
+
+/**
+ * Checks at compile time that the loop counts fit DMALP, which counts 1 to
+ * 256. Use it next to the array of the program.
+ */
+#ifdef __cplusplus
+#define XDMAPS_PROG_CHECK(Count) \
+	static_assert(((Count) >= 1U) && ((Count) <= 256U), \
+		      "DMALP counts 1 to 256 iterations")
+#else
+#define XDMAPS_PROG_CHECK(Count) \
+	_Static_assert(((Count) >= 1U) && ((Count) <= 256U), \
+		       "DMALP counts 1 to 256 iterations")
+#endif
+
+/**************************** Type Definitions ******************************/
+
+/************************** Function Prototypes *****************************/
+
+/****************************************************************************/
+/**
+*
+* Patches a fixed program with the addresses of a command and sets it as the
+* user program of the command.
+*
+* @param	Cmd is the command, whose BD gives the addresses.
+* @param	Prog is the program, built with XDMAPS_PROG_LOOP() or
+*		XDMAPS_PROG_NESTED() and aligned with XDMAPS_PROG_ALIGN.
+* @param	ProgLen is the length of the program.
+*
+* @return	None.
+*
+* @note		The program must not be running: bound to two commands, the
+*		second patch changes the first.
+*
+*****************************************************************************/
+static inline void XDmaPs_ProgBind(XDmaPs_Cmd *Cmd, u8 *Prog, u32 ProgLen)
+{
+	u32 Src = Cmd->BD.SrcAddr;
+	u32 Dst = Cmd->BD.DstAddr;
+	u8 Imm[2][4] = {
+		{ XDMAPS_PROG_IMM(Src) },
+		{ XDMAPS_PROG_IMM(Dst) },
+	};
+	u32 Index;
+
+	for (Index = 0U; Index < 4U; Index++) {
+		Prog[XDMAPS_PROG_SAR_OFFSET + Index] = Imm[0][Index];
+		Prog[XDMAPS_PROG_DAR_OFFSET + Index] = Imm[1][Index];
+	}
+	Xil_DCacheFlushRange((UINTPTR)Prog, ProgLen);
+
+	Cmd->UserDmaProg = Prog;
+	Cmd->UserDmaProgLength = (int)ProgLen;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of protection macro */
+/** @} */
@@ -180,6 +180,10 @@
 *                     and XScuGic_UnmapAllInterruptsFromCpu APIs to skip
 *                     Un-mapping of interrupts in case of GICv3.
 * 5.5   ml   12/20/24 Fixed GCC warnings
+* 5.6   qm   10/14/26 XScuGic_CfgInitialize leaves nesting off.
+*                     Added XScuGic_SetFiq() and XScuGic_ClearFiq().
+*                     XScuGic_CfgInitialize leaves the statistics off.
+*                     Added XScuGic_FastInitialize() for the Cortex-A9.
 * </pre>
 *
 ******************************************************************************/
@@ -207,6 +211,11 @@ static u32 CpuId; /**< CPU Core identifier */
 /************************** Function Prototypes ******************************/
 
 static void StubHandler(void *CallBackRef);
+static void HandlerTableInit(XScuGic *InstancePtr);
+#if !defined (GICv3)
+static void ApplyDelta(const XScuGic *InstancePtr,
+		       const XScuGic_Delta *DeltaPtr, u32 Count);
+#endif
 
 /*****************************************************************************/
 /**
@@ -440,7 +449,6 @@ s32  XScuGic_CfgInitialize(XScuGic *InstancePtr,
 			   XScuGic_Config *ConfigPtr,
 			   u32 EffectiveAddr)
 {
-	u32 Int_Id;
 	(void) EffectiveAddr;
 
 	/*
@@ -472,24 +480,7 @@ s32  XScuGic_CfgInitialize(XScuGic *InstancePtr,
 #endif
 
 
-		for (Int_Id = 0U; Int_Id < XSCUGIC_MAX_NUM_INTR_INPUTS;
-		     Int_Id++) {
-			/*
-			* Initialize the handler to point to a stub to handle an
-			* interrupt which has not been connected to a handler
-			* Only initialize it if the handler is 0 which means it
-			* was not initialized statically by the tools/user. Set
-			* the callback reference to this instance so that
-			* unhandled interrupts can be tracked.
-			*/
-			if ((InstancePtr->Config->HandlerTable[Int_Id].Handler
-			     == (Xil_InterruptHandler)NULL)) {
-				InstancePtr->Config->HandlerTable[Int_Id].Handler
-					= (Xil_InterruptHandler)StubHandler;
-			}
-			InstancePtr->Config->HandlerTable[Int_Id].CallBackRef =
-				InstancePtr;
-		}
+		HandlerTableInit(InstancePtr);
 #if defined (GICv3)
 		u32 Waker_State;
 
@@ -521,6 +512,10 @@ s32  XScuGic_CfgInitialize(XScuGic *InstancePtr,
 		XScuGic_set_priority_filter(0xff);
 #else
 		CPUInitialize(InstancePtr);
+#endif
+		InstancePtr->NestPriority = XSCUGIC_NEST_NONE;
+#if defined (XSCUGIC_STATS)
+		InstancePtr->StatsPtr = NULL;
 #endif
 		InstancePtr->IsReady = XIL_COMPONENT_IS_READY;
 	}
@@ -528,6 +523,167 @@ s32  XScuGic_CfgInitialize(XScuGic *InstancePtr,
 	return XST_SUCCESS;
 }
 
+#if !defined (GICv3)
+/*****************************************************************************/
+/**
+*
+* Initializes an instance like XScuGic_CfgInitialize(), but leaves a
+* distributor that is already enabled, by the FSBL, the other CPU or a
+* previous run of the application, as it is, and only programs the
+* interrupts of a delta table: the priority, the trigger type and the CPU
+* targets of each, read first and written only where they differ, and the
+* interrupt disabled until it is enabled again. The CPU interface is only
+* written if its priority mask and control differ from the setup of
+* XScuGic_CfgInitialize(). This skips the stop of the distributor and the
+* rewrite of every priority, target and config word, and a single barrier
+* ends the writes.
+*
+* If the distributor is disabled, the full initialization of
+* XScuGic_CfgInitialize() is done and the table applied over it, so that
+* the interrupts of the table end in the same state either way.
+*
+* @param	InstancePtr Pointer to the XScuGic instance.
+* @param	ConfigPtr Pointer to a config table for the particular
+*		device this driver is associated with.
+* @param	DeltaPtr Pointer to the delta table, the interrupts the
+*		application uses.
+* @param	Count Number of entries of the table.
+*
+* @return
+*		- XST_SUCCESS if initialization was successful
+*
+* @note		Interrupts not in the table keep the priority, trigger type,
+*		targets and enable they had, so that the table is to list
+*		every interrupt this CPU takes.
+*
+******************************************************************************/
+s32  XScuGic_FastInitialize(XScuGic *InstancePtr, XScuGic_Config *ConfigPtr,
+			    const XScuGic_Delta *DeltaPtr, u32 Count)
+{
+	u32 RegValue;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(ConfigPtr != NULL);
+	Xil_AssertNonvoid((DeltaPtr != NULL) || (Count == 0U));
+
+	if (InstancePtr->IsReady == XIL_COMPONENT_IS_READY) {
+		return XST_SUCCESS;
+	}
+
+	RegValue = XScuGic_ReadReg(ConfigPtr->DistBaseAddress,
+				   XSCUGIC_DIST_EN_OFFSET);
+	if ((RegValue & XSCUGIC_EN_INT_MASK) == 0U) {
+		(void)XScuGic_CfgInitialize(InstancePtr, ConfigPtr, 0U);
+		ApplyDelta(InstancePtr, DeltaPtr, Count);
+		dsb();
+		return XST_SUCCESS;
+	}
+
+	CpuId = (u32) XGetCoreId();
+	InstancePtr->IsReady = 0U;
+	InstancePtr->Config = ConfigPtr;
+	HandlerTableInit(InstancePtr);
+
+	ApplyDelta(InstancePtr, DeltaPtr, Count);
+
+	if (XScuGic_CPUReadReg(InstancePtr, XSCUGIC_CPU_PRIOR_OFFSET) !=
+	    0xF0U) {
+		XScuGic_CPUWriteReg(InstancePtr, XSCUGIC_CPU_PRIOR_OFFSET,
+				    0xF0U);
+	}
+	if (XScuGic_CPUReadReg(InstancePtr, XSCUGIC_CONTROL_OFFSET) !=
+	    0x07U) {
+		XScuGic_CPUWriteReg(InstancePtr, XSCUGIC_CONTROL_OFFSET, 0x07U);
+	}
+	dsb();
+
+	InstancePtr->NestPriority = XSCUGIC_NEST_NONE;
+#if defined (XSCUGIC_STATS)
+	InstancePtr->StatsPtr = NULL;
+#endif
+	InstancePtr->IsReady = XIL_COMPONENT_IS_READY;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* Programs the interrupts of a delta table, writing only the distributor
+* words that change, and disables them.
+*
+* @param	InstancePtr Pointer to the XScuGic instance.
+* @param	DeltaPtr Pointer to the delta table.
+* @param	Count Number of entries of the table.
+*
+* @return	None.
+*
+******************************************************************************/
+static void ApplyDelta(const XScuGic *InstancePtr,
+		       const XScuGic_Delta *DeltaPtr, u32 Count)
+{
+	const XScuGic_Delta *EntryPtr;
+	u32 Index;
+	u32 Int_Id;
+	u32 Shift;
+	u32 Old;
+	u32 New;
+
+	XIL_SPINLOCK();
+
+	for (Index = 0U; Index < Count; Index++) {
+		EntryPtr = &DeltaPtr[Index];
+		Int_Id = EntryPtr->IntId;
+		Xil_AssertVoid(Int_Id < XSCUGIC_MAX_NUM_INTR_INPUTS);
+
+		Shift = (Int_Id % 4U) * 8U;
+		Old = XScuGic_DistReadReg(InstancePtr,
+					  XSCUGIC_PRIORITY_OFFSET_CALC(Int_Id));
+		New = Old & ~((u32)XSCUGIC_PRIORITY_MASK << Shift);
+		New |= ((u32)EntryPtr->Priority &
+			(u32)XSCUGIC_INTR_PRIO_MASK) << Shift;
+		if (New != Old) {
+			XScuGic_DistWriteReg(InstancePtr,
+					     XSCUGIC_PRIORITY_OFFSET_CALC(Int_Id),
+					     New);
+		}
+
+		Shift = (Int_Id % 16U) * 2U;
+		Old = XScuGic_DistReadReg(InstancePtr,
+					  XSCUGIC_INT_CFG_OFFSET_CALC(Int_Id));
+		New = Old & ~((u32)XSCUGIC_INT_CFG_MASK << Shift);
+		New |= ((u32)EntryPtr->Trigger &
+			(u32)XSCUGIC_INT_CFG_MASK) << Shift;
+		if (New != Old) {
+			XScuGic_DistWriteReg(InstancePtr,
+					     XSCUGIC_INT_CFG_OFFSET_CALC(Int_Id),
+					     New);
+		}
+
+		/* The targets of the SGIs and PPIs are read only */
+		if (Int_Id >= XSCUGIC_SPI_INT_ID_START) {
+			Shift = (Int_Id % 4U) * 8U;
+			Old = XScuGic_DistReadReg(InstancePtr,
+					XSCUGIC_SPI_TARGET_OFFSET_CALC(Int_Id));
+			New = Old & ~((u32)0xFFU << Shift);
+			New |= (u32)EntryPtr->CpuMask << Shift;
+			if (New != Old) {
+				XScuGic_DistWriteReg(InstancePtr,
+					XSCUGIC_SPI_TARGET_OFFSET_CALC(Int_Id),
+					New);
+			}
+		}
+
+		XScuGic_DistWriteReg(InstancePtr,
+				     XSCUGIC_EN_DIS_OFFSET_CALC(
+					     XSCUGIC_DISABLE_OFFSET, Int_Id),
+				     (u32)0x1U << (Int_Id % 32U));
+	}
+
+	XIL_SPINUNLOCK();
+}
+#endif
+
 /*****************************************************************************/
 /**
 *
@@ -925,6 +1081,35 @@ static void StubHandler(void *CallBackRef)
 	((XScuGic *)((void *)CallBackRef))->UnhandledInterrupts++;
 }
 
+/*****************************************************************************/
+/**
+*
+* Initializes the handler table of an instance. An interrupt which has not
+* been connected to a handler points to a stub, if its handler is 0 which
+* means it was not initialized statically by the tools/user. The callback
+* reference is set to the instance so that unhandled interrupts can be
+* tracked.
+*
+* @param	InstancePtr Pointer to the XScuGic instance.
+*
+* @return	None.
+*
+******************************************************************************/
+static void HandlerTableInit(XScuGic *InstancePtr)
+{
+	u32 Int_Id;
+
+	for (Int_Id = 0U; Int_Id < XSCUGIC_MAX_NUM_INTR_INPUTS; Int_Id++) {
+		if ((InstancePtr->Config->HandlerTable[Int_Id].Handler
+		     == (Xil_InterruptHandler)NULL)) {
+			InstancePtr->Config->HandlerTable[Int_Id].Handler
+				= (Xil_InterruptHandler)StubHandler;
+		}
+		InstancePtr->Config->HandlerTable[Int_Id].CallBackRef =
+			InstancePtr;
+	}
+}
+
 /****************************************************************************/
 /**
 * Sets the interrupt priority and trigger type for the specificd IRQ source.
@@ -1109,6 +1294,92 @@ void XScuGic_GetPriorityTriggerType(XScuGic *InstancePtr, u32 Int_Id,
 	 */
 	*Trigger = (u8)(RegValue & XSCUGIC_INT_CFG_MASK);
 }
+
+#if !defined (GICv3)
+/****************************************************************************/
+/**
+* Routes one interrupt to the FIQ of the CPU, through the group 0 of the
+* distributor. All the other interrupts are moved to group 1 and stay on the
+* IRQ, and the CPU interface signals group 0 on nFIQ.
+*
+* The interrupt gets the highest priority, so that the GIC signals it while
+* an IRQ is being handled. The FIQ handler takes the interrupt without
+* acknowledging it, see Xil_ExceptionRegisterFiqFast(), so its entry in the
+* handler table must stay connected: when the IRQ handler acknowledges the
+* interrupt first, that entry runs instead.
+*
+* @param	InstancePtr Pointer to the instance to be worked on.
+* @param	Int_Id Interrupt to route to the FIQ.
+*
+* @return	None.
+*
+* @note		The groups are set in the distributor, for all the CPUs.
+*
+*****************************************************************************/
+void XScuGic_SetFiq(XScuGic *InstancePtr, u32 Int_Id)
+{
+	u32 Index;
+	u32 RegValue;
+	u8 Priority;
+	u8 Trigger;
+
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+	Xil_AssertVoid(Int_Id < XSCUGIC_MAX_NUM_INTR_INPUTS);
+
+	XScuGic_GetPriorityTriggerType(InstancePtr, Int_Id, &Priority, &Trigger);
+	XScuGic_SetPriorityTriggerType(InstancePtr, Int_Id, 0U, Trigger);
+
+	XIL_SPINLOCK();
+	for (Index = 0U; Index < XSCUGIC_MAX_NUM_INTR_INPUTS; Index += 32U) {
+		RegValue = 0xFFFFFFFFU;
+		if ((Int_Id / 32U) == (Index / 32U)) {
+			RegValue &= ~((u32)0x1U << (Int_Id % 32U));
+		}
+		XScuGic_DistWriteReg(InstancePtr,
+				     XSCUGIC_SECURITY_TARGET_OFFSET_CALC(Index),
+				     RegValue);
+	}
+	XIL_SPINUNLOCK();
+
+	RegValue = XScuGic_CPUReadReg(InstancePtr, XSCUGIC_CONTROL_OFFSET);
+	XScuGic_CPUWriteReg(InstancePtr, XSCUGIC_CONTROL_OFFSET,
+			    RegValue | XSCUGIC_CNTR_FIQEN_MASK);
+}
+
+/****************************************************************************/
+/**
+* Moves all the interrupts back to group 0 on the IRQ, undoing
+* XScuGic_SetFiq(). The priority of the interrupt that was routed to the FIQ
+* is left as it is.
+*
+* @param	InstancePtr Pointer to the instance to be worked on.
+*
+* @return	None.
+*
+*****************************************************************************/
+void XScuGic_ClearFiq(XScuGic *InstancePtr)
+{
+	u32 Index;
+	u32 RegValue;
+
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	RegValue = XScuGic_CPUReadReg(InstancePtr, XSCUGIC_CONTROL_OFFSET);
+	XScuGic_CPUWriteReg(InstancePtr, XSCUGIC_CONTROL_OFFSET,
+			    RegValue & ~XSCUGIC_CNTR_FIQEN_MASK);
+
+	XIL_SPINLOCK();
+	for (Index = 0U; Index < XSCUGIC_MAX_NUM_INTR_INPUTS; Index += 32U) {
+		XScuGic_DistWriteReg(InstancePtr,
+				     XSCUGIC_SECURITY_TARGET_OFFSET_CALC(Index),
+				     0x0U);
+	}
+	XIL_SPINUNLOCK();
+}
+#endif
+
 /****************************************************************************/
 /**
 * Sets the target CPU for the interrupt of a peripheral.
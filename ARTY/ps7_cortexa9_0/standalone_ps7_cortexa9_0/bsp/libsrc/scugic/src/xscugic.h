@@ -148,6 +148,17 @@
 * 5.2   adk  04/14/23 Added support for system device-tree flow.
 * 5.5   ml   01/08/25 Update datatype of distributor and cpu base address in
 *                     scugic config structure.
+* 5.6   qm   10/14/26 Added XScuGic_SetNestPriority() and the NestPriority
+*                     member of the XScuGic instance, for the nested
+*                     dispatch of XScuGic_InterruptHandler(), and
+*                     XSCUGIC_TAIL_CHAIN_MAX.
+*                     Added XScuGic_SetFiq() and XScuGic_ClearFiq().
+*                     Added the optional per interrupt statistics of the
+*                     Cortex-A9, see xscugic_stats.c.
+*                     Added XScuGic_FastInitialize() and its delta table
+*                     of XScuGic_Delta entries, for the Cortex-A9.
+*                     Laid the XScuGic instance out on a cache line of its
+*                     own with XIL_DRIVER_HOT_LAYOUT.
 * </pre>
 *
 ******************************************************************************/
@@ -167,6 +178,13 @@ extern "C" {
 #include "xscugic_hw.h"
 #include "xil_exception.h"
 #include "xil_spinlock.h"
+#if defined (XIL_DRIVER_HOT_LAYOUT)
+#include "xil_atomic.h"
+#endif
+#ifndef XIL_HOT_GROUP_BEGIN	/* Plain members, see xil_atomic.h */
+#define XIL_HOT_GROUP_BEGIN
+#define XIL_HOT_GROUP_END
+#endif
 
 /************************** Constant Definitions *****************************/
 
@@ -182,6 +200,25 @@ extern "C" {
 #define ARMA9 /**< ARMA9 macro to identify cortexA9 */
 #endif
 
+/**
+ * NestPriority of an instance that runs no handler nested, above the
+ * lowest priority XSCUGIC_MAX_INTR_PRIO_VAL.
+ */
+#define XSCUGIC_NEST_NONE	0xFFU
+
+/**
+ * Interrupts XScuGic_InterruptHandler() acknowledges in one exception. The
+ * interrupts pending at the end of a handler are taken without leaving the
+ * exception, up to this count.
+ */
+#ifndef XSCUGIC_TAIL_CHAIN_MAX
+#define XSCUGIC_TAIL_CHAIN_MAX	8U
+#endif
+
+#if defined (ARMA9) && defined (__GNUC__)
+#define XSCUGIC_STATS /**< Per interrupt statistics, in PMU cycles */
+#endif
+
 /**
  * @name GICD_CTLR Register information
  * GICD_CTLR Status Register
@@ -239,19 +276,67 @@ typedef struct
 				 Vector table of interrupt handlers */
 } XScuGic_Config;
 
+#if defined (XSCUGIC_STATS)
+/**
+ * Statistics of one interrupt ID, in CPU cycles of the PMU cycle counter.
+ * The latency is the time from the entry of XScuGic_InterruptHandler() to
+ * the call of the handler, which includes the handlers tail chained before
+ * it in the same exception.
+ */
+typedef struct {
+	u32 Count;		/**< Handler calls */
+	u32 MaxCycles;		/**< Longest handler call */
+	u64 TotalCycles;	/**< Cycles of all the handler calls */
+	u32 MaxLatency;		/**< Longest latency */
+	u64 TotalLatency;	/**< Latency of all the handler calls */
+} XScuGic_IntStats;
+
+/**
+ * Optional statistics of an instance, see XScuGic_EnableStats().
+ */
+typedef struct {
+	u32 Entries;		/**< Calls of XScuGic_InterruptHandler() */
+	u32 Spurious;		/**< Calls with no interrupt pending */
+	XScuGic_IntStats Int[XSCUGIC_MAX_NUM_INTR_INPUTS]; /**< Per ID */
+} XScuGic_Stats;
+#endif
+
+#if !defined (GICv3)
+/**
+ * An interrupt of the delta table of XScuGic_FastInitialize(), as the
+ * application uses it.
+ */
+typedef struct {
+	u16 IntId;		/**< Interrupt ID */
+	u8 Priority;		/**< 0 highest to 0xF8 lowest, in steps of 8 */
+	u8 Trigger;		/**< 0b01 level high, 0b11 rising edge */
+	u8 CpuMask;		/**< Targets of an SPI, bit 0 for CPU0 */
+} XScuGic_Delta;
+#endif
+
 /**
  * The XScuGic driver instance data. The user is required to allocate a
  * variable of this type for every intc device in the system. A pointer
  * to a variable of this type is then passed to the driver API functions.
+ * All of it is read by XScuGic_InterruptHandler(); with XIL_DRIVER_HOT_LAYOUT
+ * it takes a cache line of its own.
  */
 typedef struct
 {
+	XIL_HOT_GROUP_BEGIN
 	XScuGic_Config *Config;  /**< Configuration table entry */
 #if defined (GICv3)
 	UINTPTR RedistBaseAddr;
 #endif
 	u32 IsReady;		 /**< Device is initialized and ready */
 	u32 UnhandledInterrupts; /**< Intc Statistics */
+	u8 NestPriority;	 /**< Handlers of this priority value and above
+				      run with IRQs enabled, see
+				      XScuGic_SetNestPriority() */
+#if defined (XSCUGIC_STATS)
+	XScuGic_Stats *StatsPtr; /**< Optional statistics, NULL if disabled */
+#endif
+	XIL_HOT_GROUP_END
 } XScuGic;
 
 /************************** Variable Definitions *****************************/
@@ -610,6 +695,10 @@ void XScuGic_Disable(XScuGic *InstancePtr, u32 Int_Id);
 
 s32  XScuGic_CfgInitialize(XScuGic *InstancePtr, XScuGic_Config *ConfigPtr,
 							u32 EffectiveAddr);
+#if !defined (GICv3)
+s32  XScuGic_FastInitialize(XScuGic *InstancePtr, XScuGic_Config *ConfigPtr,
+			    const XScuGic_Delta *DeltaPtr, u32 Count);
+#endif
 
 s32  XScuGic_SoftwareIntr(XScuGic *InstancePtr, u32 Int_Id, u32 Cpu_Identifier);
 
@@ -617,6 +706,10 @@ void XScuGic_GetPriorityTriggerType(XScuGic *InstancePtr, u32 Int_Id,
 					u8 *Priority, u8 *Trigger);
 void XScuGic_SetPriorityTriggerType(XScuGic *InstancePtr, u32 Int_Id,
 					u8 Priority, u8 Trigger);
+#if !defined (GICv3)
+void XScuGic_SetFiq(XScuGic *InstancePtr, u32 Int_Id);
+void XScuGic_ClearFiq(XScuGic *InstancePtr);
+#endif
 void XScuGic_InterruptMaptoCpu(XScuGic *InstancePtr, u8 Cpu_Identifier, u32 Int_Id);
 void XScuGic_InterruptUnmapFromCpu(XScuGic *InstancePtr, u8 Cpu_Identifier, u32 Int_Id);
 void XScuGic_UnmapAllInterruptsFromCpu(XScuGic *InstancePtr, u8 Cpu_Identifier);
@@ -645,6 +738,18 @@ XScuGic_Config *XScuGic_LookupConfig(UINTPTR BaseAddr);
  * Interrupt functions in xscugic_intr.c
  */
 void XScuGic_InterruptHandler(XScuGic *InstancePtr);
+void XScuGic_SetNestPriority(XScuGic *InstancePtr, u8 Priority);
+
+#if defined (XSCUGIC_STATS)
+/*
+ * Statistics functions in xscugic_stats.c
+ */
+void XScuGic_EnableStats(XScuGic *InstancePtr, XScuGic_Stats *StatsPtr);
+void XScuGic_DisableStats(XScuGic *InstancePtr);
+void XScuGic_GetIntStats(XScuGic *InstancePtr, u32 Int_Id,
+			 XScuGic_IntStats *SnapshotPtr);
+void XScuGic_DumpStats(XScuGic *InstancePtr);
+#endif
 
 /*
  * Self-test functions in xscugic_selftest.c
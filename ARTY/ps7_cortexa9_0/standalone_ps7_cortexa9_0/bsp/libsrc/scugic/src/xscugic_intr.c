@@ -41,6 +41,15 @@
 *                     reported by coverity tool. It fixes CR#1006344.
 * 3.10  mus  07/17/18 Updated file to fix the various coding style issues
 *                     reported by checkpatch. It fixes CR#1006344.
+* 5.6   qm   10/14/26 Placed XScuGic_InterruptHandler in the interrupt hot
+*                     path of xil_hotpath.h.
+* 5.6   qm   10/14/26 XScuGic_InterruptHandler takes the interrupts pending
+*                     at the end of a handler in the same exception, and runs
+*                     handlers from NestPriority with IRQs enabled. Added
+*                     XScuGic_SetNestPriority.
+* 5.6   qm   10/14/26 XScuGic_InterruptHandler updates the optional
+*                     statistics of xscugic_stats.c.
+* 5.6   qm   10/14/26 Trace each handler call with xil_trace.h.
 *
 * </pre>
 *
@@ -60,6 +69,11 @@
 #include "xil_types.h"
 #include "xil_assert.h"
 #include "xscugic.h"
+#include "xil_hotpath.h"
+#include "xil_trace.h"
+#if defined (XSCUGIC_STATS)
+#include "xpm_counter.h"
+#endif
 
 /************************** Constant Definitions *****************************/
 
@@ -69,6 +83,14 @@
 
 /************************** Function Prototypes ******************************/
 
+#if defined (ARMA9) && defined (__GNUC__) && !defined (GICv3)
+static void XScuGic_CallNested(Xil_InterruptHandler Handler, void *CallBackRef);
+#endif
+#if defined (XSCUGIC_STATS)
+static void XScuGic_StatsUpdate(XScuGic_Stats *StatsPtr, u32 InterruptID,
+				u32 EntryCycles, u32 StartCycles);
+#endif
+
 /************************** Variable Definitions *****************************/
 
 /*****************************************************************************/
@@ -80,6 +102,19 @@
 * the Interrupt Type information to determine when to acknowledge the interrupt.
 * Highest priority interrupts are serviced first.
 *
+* The interrupts that become pending while a handler runs are taken before
+* the handler returns, up to XSCUGIC_TAIL_CHAIN_MAX interrupts, without the
+* exit and the entry of the exception in between.
+*
+* On the Cortex-A9, the handlers of interrupts of a priority value from the
+* NestPriority of the instance and above run with IRQs enabled, see
+* XScuGic_SetNestPriority(). The GIC only signals the interrupts of a higher
+* priority than the running one, so that these preempt the handler and the
+* others wait for its end of interrupt.
+*
+* When statistics are enabled with XScuGic_EnableStats(), each handler call
+* is counted and timed with the PMU cycle counter.
+*
 * This function assumes that an interrupt vector table has been previously
 * initialized.  It does not verify that entries in the table are valid before
 * calling an interrupt handler.
@@ -91,6 +126,7 @@
 *
 *
 ******************************************************************************/
+XIL_HOTPATH_TEXT
 void XScuGic_InterruptHandler(XScuGic *InstancePtr)
 {
 
@@ -99,65 +135,220 @@ void XScuGic_InterruptHandler(XScuGic *InstancePtr)
 	    u32 IntIDFull;
 #endif
 	    XScuGic_VectorTableEntry *TablePtr;
+	    u32 Count;
+#if defined (XSCUGIC_STATS)
+	    XScuGic_Stats *StatsPtr;
+	    u32 EntryCycles = 0U;
+	    u32 StartCycles = 0U;
+#endif
 
 	    /* Assert that the pointer to the instance is valid
 	     */
 	    Xil_AssertVoid(InstancePtr != NULL);
 
-	    /*
-	     * Read the int_ack register to identify the highest priority
-	     * interrupt ID and make sure it is valid. Reading Int_Ack will
-	     * clear the interrupt in the GIC.
-	     */
+#if defined (XSCUGIC_STATS)
+	    StatsPtr = InstancePtr->StatsPtr;
+	    if (StatsPtr != NULL) {
+		EntryCycles = Xpm_ReadCycleCounterVal();
+		StatsPtr->Entries++;
+	    }
+#endif
+
+	    for (Count = 0U; Count < XSCUGIC_TAIL_CHAIN_MAX; Count++) {
+		/*
+		 * Read the int_ack register to identify the highest priority
+		 * interrupt ID and make sure it is valid. Reading Int_Ack will
+		 * clear the interrupt in the GIC.
+		 */
 #if defined (GICv3)
-	    InterruptID = XScuGic_get_IntID();
+		InterruptID = XScuGic_get_IntID();
 #else
-	    IntIDFull = XScuGic_CPUReadReg(InstancePtr, XSCUGIC_INT_ACK_OFFSET);
-	    InterruptID = IntIDFull & XSCUGIC_ACK_INTID_MASK;
+		IntIDFull = XScuGic_CPUReadReg(InstancePtr, XSCUGIC_INT_ACK_OFFSET);
+		InterruptID = IntIDFull & XSCUGIC_ACK_INTID_MASK;
 #endif
-	    if (XSCUGIC_MAX_NUM_INTR_INPUTS <= InterruptID) {
-		goto IntrExit;
-	    }
-
-	    /*
-	     * If the interrupt is shared, do some locking here if
-	     * there are multiple processors.
-	     */
-	    /*
-	     * If pre-eption is required:
-	     * Re-enable pre-emption by setting the CPSR I bit for non-secure ,
-	     * interrupts or the F bit for secure interrupts
-	     */
+		if (XSCUGIC_MAX_NUM_INTR_INPUTS <= InterruptID) {
+			/*
+			 * Spurious, nothing more is pending
+			 */
+			if (Count == 0U) {
+#if defined (XSCUGIC_STATS)
+				if (StatsPtr != NULL) {
+					StatsPtr->Spurious++;
+				}
+#endif
+#if defined (GICv3)
+				XScuGic_ack_Int(InterruptID);
+#else
+				XScuGic_CPUWriteReg(InstancePtr,
+						    XSCUGIC_EOI_OFFSET, IntIDFull);
+#endif
+			}
+			break;
+		}
 
-	    /*
-	     * If we need to change security domains, issue a SMC
+		/*
+		 * If we need to change security domains, issue a SMC
 		 * instruction here.
-	     */
+		 */
 
-	    /*
-	     * Execute the ISR. Jump into the Interrupt service routine
-	     * based on the IRQSource. A software trigger is cleared by
-	     *.the ACK.
-	     */
-	    TablePtr = &(InstancePtr->Config->HandlerTable[InterruptID]);
-		if (TablePtr != NULL) {
+		/*
+		 * Execute the ISR. Jump into the Interrupt service routine
+		 * based on the IRQSource. A software trigger is cleared by
+		 *.the ACK.
+		 */
+		TablePtr = &(InstancePtr->Config->HandlerTable[InterruptID]);
+		XIL_TRACE_EVENT(XIL_TRACE_ID_IRQ | XIL_TRACE_BEGIN, InterruptID,
+				0U);
+#if defined (XSCUGIC_STATS)
+		if (StatsPtr != NULL) {
+			StartCycles = Xpm_ReadCycleCounterVal();
+		}
+#endif
+#if defined (ARMA9) && defined (__GNUC__) && !defined (GICv3)
+		/*
+		 * The running priority is the one of the acknowledged
+		 * interrupt
+		 */
+		if ((InstancePtr->NestPriority != XSCUGIC_NEST_NONE) &&
+		    ((XScuGic_CPUReadReg(InstancePtr, XSCUGIC_RUN_PRIOR_OFFSET) &
+		      XSCUGIC_RUN_PRIORITY_MASK) >=
+		     (u32)InstancePtr->NestPriority)) {
+			XScuGic_CallNested(TablePtr->Handler,
+					   TablePtr->CallBackRef);
+		} else
+#endif
+		{
 			TablePtr->Handler(TablePtr->CallBackRef);
 		}
+		XIL_TRACE_EVENT(XIL_TRACE_ID_IRQ | XIL_TRACE_END, InterruptID, 0U);
+#if defined (XSCUGIC_STATS)
+		if (StatsPtr != NULL) {
+			XScuGic_StatsUpdate(StatsPtr, InterruptID,
+					    EntryCycles, StartCycles);
+		}
+#endif
 
-IntrExit:
-	    /*
-	     * Write to the EOI register, we are all done here.
-	     * Let this function return, the boot code will restore the stack.
-	     */
+		/*
+		 * Write to the EOI register, we are all done with this one.
+		 */
 #if defined (GICv3)
-	   XScuGic_ack_Int(InterruptID);
-
+		XScuGic_ack_Int(InterruptID);
 #else
-	    XScuGic_CPUWriteReg(InstancePtr, XSCUGIC_EOI_OFFSET, IntIDFull);
+		XScuGic_CPUWriteReg(InstancePtr, XSCUGIC_EOI_OFFSET, IntIDFull);
 #endif
+	    }
+
 	    /*
-	     * Return from the interrupt. Change security domains
-	     * could happen here.
+	     * Return from the interrupt, the boot code will restore the stack.
+	     * Change security domains could happen here.
 	     */
 }
+
+/*****************************************************************************/
+/**
+* This function sets the priority from which XScuGic_InterruptHandler() runs
+* the handlers with IRQs enabled, so that interrupts of a higher priority
+* preempt them. Slow handlers are given a high priority value, the ones
+* whose latency must be bounded, as the UART, a low value below Priority.
+*
+* The priorities are the ones of XScuGic_SetPriorityTriggerType(), in steps
+* of 8 from 0, the highest, to XSCUGIC_MAX_INTR_PRIO_VAL.
+*
+* @param	InstancePtr Pointer to the XScuGic instance.
+* @param	Priority is the lowest priority value run nested, or
+*		XSCUGIC_NEST_NONE to run every handler with IRQs disabled.
+*
+* @return	None.
+*
+* @note		Only the Cortex-A9 nests, elsewhere the value is ignored. A
+*		nested handler runs in system mode on the stack of the
+*		interrupted code, which must have room for it. It must clear
+*		the source of its interrupt before it returns, as for any
+*		level interrupt.
+*
+******************************************************************************/
+void XScuGic_SetNestPriority(XScuGic *InstancePtr, u8 Priority)
+{
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	InstancePtr->NestPriority = Priority;
+}
+
+#if defined (XSCUGIC_STATS)
+/*****************************************************************************/
+/**
+* This function adds a handler call to the statistics of its interrupt ID.
+* The cycle counter is 32 bits, the unsigned differences stay right across
+* its wrap.
+*
+* @param	StatsPtr is the statistics block of the instance.
+* @param	InterruptID is the interrupt that was handled.
+* @param	EntryCycles is the cycle count at the entry of the handler.
+* @param	StartCycles is the cycle count at the call of the handler.
+*
+* @return	None.
+*
+******************************************************************************/
+XIL_HOTPATH_TEXT
+static void XScuGic_StatsUpdate(XScuGic_Stats *StatsPtr, u32 InterruptID,
+				u32 EntryCycles, u32 StartCycles)
+{
+	XScuGic_IntStats *IntPtr = &StatsPtr->Int[InterruptID];
+	u32 Cycles = Xpm_ReadCycleCounterVal() - StartCycles;
+	u32 Latency = StartCycles - EntryCycles;
+
+	IntPtr->Count++;
+	IntPtr->TotalCycles += Cycles;
+	if (Cycles > IntPtr->MaxCycles) {
+		IntPtr->MaxCycles = Cycles;
+	}
+	IntPtr->TotalLatency += Latency;
+	if (Latency > IntPtr->MaxLatency) {
+		IntPtr->MaxLatency = Latency;
+	}
+}
+#endif
+
+#if defined (ARMA9) && defined (__GNUC__) && !defined (GICv3)
+/*****************************************************************************/
+/**
+* This function calls an interrupt handler with IRQs enabled. The LR and the
+* SPSR of the IRQ mode, which a nested interrupt overwrites, are saved on the
+* IRQ stack, and the handler runs in system mode on the 8 byte aligned stack
+* of the interrupted code.
+*
+* @param	Handler is the interrupt handler, in r0.
+* @param	CallBackRef is its argument, in r1.
+*
+* @return	None.
+*
+******************************************************************************/
+XIL_HOTPATH_TEXT __attribute__((naked))
+static void XScuGic_CallNested(Xil_InterruptHandler Handler __attribute__((unused)),
+			       void *CallBackRef __attribute__((unused)))
+{
+	__asm__ __volatile__ (
+		"mrs	r2, spsr\n"
+		"push	{r2, lr}\n"		/* IRQ mode SPSR and LR */
+		"cps	#0x1F\n"		/* system mode */
+		"mov	r2, sp\n"
+		"mov	r3, sp\n"
+		"bic	r3, r3, #7\n"
+		"mov	sp, r3\n"
+		"push	{r2, lr}\n"		/* system mode SP and LR */
+		"mov	r2, r0\n"
+		"mov	r0, r1\n"
+		"cpsie	i\n"
+		"blx	r2\n"
+		"cpsid	i\n"
+		"pop	{r2, lr}\n"
+		"mov	sp, r2\n"
+		"cps	#0x12\n"		/* back to IRQ mode */
+		"pop	{r2, lr}\n"
+		"msr	spsr_cxsf, r2\n"
+		"bx	lr\n"
+	);
+}
+#endif
 /** @} */
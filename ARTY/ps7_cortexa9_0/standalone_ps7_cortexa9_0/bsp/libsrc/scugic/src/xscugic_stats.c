@@ -0,0 +1,200 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file xscugic_stats.c
+* @addtogroup scugic_api SCUGIC APIs
+* @{
+*
+* The xscugic_stats.c file contains the optional interrupt statistics of the
+* driver on the Cortex-A9. Once a statistics block has been attached with
+* XScuGic_EnableStats(), XScuGic_InterruptHandler() counts the calls of each
+* interrupt ID and times them with the PMU cycle counter: the total and the
+* longest handler run, and the latency from the entry of the interrupt
+* handler to the call of the handler. The GIC keeps no time of when an
+* interrupt became pending, so the latency left before the exception entry
+* is not seen, the one of the interrupts taken after others in the same
+* exception is.
+*
+* XScuGic_DumpStats() prints the interrupts seen so far, which shows the
+* handlers that take the most of the CPU or delay the others.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------------
+* 5.6   qm   10/14/26 First release
+*
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <string.h>
+#include "xil_types.h"
+#include "xil_assert.h"
+#include "xil_printf.h"
+#include "xscugic.h"
+
+#if defined (XSCUGIC_STATS)
+#include "xpm_counter.h"
+
+/************************** Constant Definitions *****************************/
+
+#define XSCUGIC_PMCR_E		0x00000001U /**< Enables the counters */
+#define XSCUGIC_PMCR_D		0x00000008U /**< Counts every 64th cycle */
+#define XSCUGIC_PMCNTEN_C	0x80000000U /**< Enables the cycle counter */
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+
+/************************** Variable Definitions *****************************/
+
+/*****************************************************************************/
+/**
+* This function attaches a statistics block to the instance and clears it,
+* and starts the PMU cycle counter at the CPU clock. From then on
+* XScuGic_InterruptHandler() updates the block.
+*
+* @param	InstancePtr Pointer to the XScuGic instance.
+* @param	StatsPtr is the statistics block, it must stay valid until
+*		XScuGic_DisableStats() is called.
+*
+* @return	None.
+*
+* @note		The other PMU counters are left as they are. Code that
+*		resets the cycle counter while the statistics are enabled
+*		spoils the handler call running at that time.
+*
+******************************************************************************/
+void XScuGic_EnableStats(XScuGic *InstancePtr, XScuGic_Stats *StatsPtr)
+{
+	u32 RegValue;
+
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(StatsPtr != NULL);
+	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	(void)memset((void *)StatsPtr, 0, sizeof(XScuGic_Stats));
+
+	RegValue = mfcp(XREG_CP15_PERF_MONITOR_CTRL);
+	RegValue = (RegValue | XSCUGIC_PMCR_E) & ~XSCUGIC_PMCR_D;
+	mtcp(XREG_CP15_PERF_MONITOR_CTRL, RegValue);
+	mtcp(XREG_CP15_COUNT_ENABLE_SET, XSCUGIC_PMCNTEN_C);
+	isb();
+
+	InstancePtr->StatsPtr = StatsPtr;
+}
+
+/*****************************************************************************/
+/**
+* This function detaches the statistics block from the instance. The block
+* keeps the values it had at that time, and the cycle counter keeps running.
+*
+* @param	InstancePtr Pointer to the XScuGic instance.
+*
+* @return	None.
+*
+******************************************************************************/
+void XScuGic_DisableStats(XScuGic *InstancePtr)
+{
+	Xil_AssertVoid(InstancePtr != NULL);
+
+	InstancePtr->StatsPtr = NULL;
+}
+
+/*****************************************************************************/
+/**
+* This function takes a consistent snapshot of the statistics of one
+* interrupt ID. The IRQ and the FIQ are masked while the entry is copied, so
+* that the interrupt handler cannot update it halfway through.
+*
+* @param	InstancePtr Pointer to the XScuGic instance.
+* @param	Int_Id Interrupt ID.
+* @param	SnapshotPtr is where the snapshot is stored. It is cleared when
+*		no statistics block is attached.
+*
+* @return	None.
+*
+******************************************************************************/
+void XScuGic_GetIntStats(XScuGic *InstancePtr, u32 Int_Id,
+			 XScuGic_IntStats *SnapshotPtr)
+{
+	XScuGic_Stats *StatsPtr;
+	u32 Cpsr;
+
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(Int_Id < XSCUGIC_MAX_NUM_INTR_INPUTS);
+	Xil_AssertVoid(SnapshotPtr != NULL);
+
+	StatsPtr = InstancePtr->StatsPtr;
+	if (StatsPtr == NULL) {
+		(void)memset((void *)SnapshotPtr, 0, sizeof(XScuGic_IntStats));
+		return;
+	}
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	*SnapshotPtr = StatsPtr->Int[Int_Id];
+	mtcpsr(Cpsr);
+}
+
+/*****************************************************************************/
+/**
+* This function prints the statistics of the interrupt IDs that were handled
+* since XScuGic_EnableStats(), one line each, in CPU cycles: the calls, the
+* average and the longest handler run, and the average and the longest
+* latency. The share of the CPU an interrupt takes is its total cycles over
+* the cycles elapsed.
+*
+* @param	InstancePtr Pointer to the XScuGic instance.
+*
+* @return	None.
+*
+* @note		The lines are printed with xil_printf(), from the caller
+*		context. Do not call this function from a handler.
+*
+******************************************************************************/
+void XScuGic_DumpStats(XScuGic *InstancePtr)
+{
+	XScuGic_IntStats Snapshot;
+	u32 Int_Id;
+
+	Xil_AssertVoid(InstancePtr != NULL);
+
+	if (InstancePtr->StatsPtr == NULL) {
+		xil_printf("GIC statistics not enabled\r\n");
+		return;
+	}
+
+	xil_printf("GIC entries %u spurious %u\r\n",
+		   InstancePtr->StatsPtr->Entries,
+		   InstancePtr->StatsPtr->Spurious);
+	xil_printf("  ID     calls   avg cyc   max cyc   avg lat   max lat"
+		   "     total cyc\r\n");
+
+	for (Int_Id = 0U; Int_Id < XSCUGIC_MAX_NUM_INTR_INPUTS; Int_Id++) {
+		XScuGic_GetIntStats(InstancePtr, Int_Id, &Snapshot);
+		if (Snapshot.Count == 0U) {
+			continue;
+		}
+		xil_printf("%4u %9u %9u %9u %9u %9u %08x%08x\r\n", Int_Id,
+			   Snapshot.Count,
+			   (u32)(Snapshot.TotalCycles / Snapshot.Count),
+			   Snapshot.MaxCycles,
+			   (u32)(Snapshot.TotalLatency / Snapshot.Count),
+			   Snapshot.MaxLatency,
+			   (u32)(Snapshot.TotalCycles >> 32),
+			   (u32)Snapshot.TotalCycles);
+	}
+}
+#endif
+/** @} */
@@ -24,6 +24,7 @@
 * 8.0   mus      02/24/22 Added macro mfcpnotoken and mtcpnotoken.
 * 8.1   asa      02/13/23 Create macros to read ESR, FAR and ELR registers.
 * 9.1   ml       11/15/23 Fix compilation errors reported with -std=c2x compiler flag
+* 9.3   qm       10/14/26 Added the ldrex, strex and clrex macros for aarch32.
 * </pre>
 *
 ******************************************************************************/
@@ -192,6 +193,28 @@ extern "C" {
 		rval;\
 	})
 
+/* Exclusive load of a word, opens the exclusive monitor */
+#define ldrex(adr)	({u32 rval; \
+		__asm__ __volatile__(\
+				     "ldrex	%0,[%1]"\
+				     : "=r" (rval) : "r" (adr) : "memory"\
+				    );\
+		rval;\
+	})
+
+/* Exclusive store of a word, gives 0 if it was done, 1 if not */
+#define strex(adr, val)	({u32 rval; \
+		__asm__ __volatile__(\
+				     "strex	%0,%2,[%1]"\
+				     : "=&r" (rval) : "r" (adr), "r" (val)\
+				     : "memory"\
+				    );\
+		rval;\
+	})
+
+/* Clears the exclusive monitor */
+#define clrex()	__asm__ __volatile__ ("clrex" : : : "memory")
+
 #endif
 
 #define ldrb(adr)	({u8 rval; \
@@ -48,6 +48,9 @@
 * 9.0  ml        03/03/23 Add description to fix doxygen warnings.
 * 9.0  ml	 14/04/23 Add comment to default case in switch statement to fix
 *                         misra-c violation.
+* 9.3  qm        10/14/26 Added Xil_ExceptionRegisterFiqFast().
+*      qm        10/14/26 Added XExc_FpuLazyFrame.
+*      qm        10/14/26 XExc_FpuLazyFrame has an entry per CPU.
 * </pre>
 *
 *****************************************************************************/
@@ -115,6 +118,18 @@ u32 DataAbortAddr;       /* Address of instruction causing data abort */
 u32 PrefetchAbortAddr;   /* Address of instruction causing prefetch abort */
 u32 UndefinedExceptionAddr;   /* Address of instruction causing Undefined
 							     exception */
+
+/*
+ * Fast FIQ handler, taken by the FIQ vector of the Cortex-A9 instead of the
+ * handler of XExc_VectorTable when it is set
+ */
+Xil_FiqFastHandler XExc_FiqFastHandler;
+
+/*
+ * Lazy VFP/NEON frame of the IRQ being handled on the Cortex-A9, 0 outside
+ * of IRQ handlers, indexed by the CPU ID of MPIDR, see asm_vectors.S
+ */
+UINTPTR XExc_FpuLazyFrame[4];
 #endif
 
 /*****************************************************************************/
@@ -246,6 +261,32 @@ void Xil_ExceptionRemoveHandler(u32 Exception_id)
 				       NULL);
 }
 
+#if !defined (__aarch64__)
+/*****************************************************************************/
+/**
+*
+* @brief	Registers the fast FIQ handler. The FIQ vector of the Cortex-A9
+*		branches to it in FIQ mode, without saving the registers of the
+*		compiled code and the floating point context, and without the
+*		dispatch through XExc_VectorTable. Registering NULL restores the
+*		handler of XIL_EXCEPTION_ID_FIQ_INT.
+*
+* @param	Handler is the handler, defined with XIL_FIQ_FAST_HANDLER, or
+*		NULL.
+*
+* @return	None.
+*
+* @note		The FIQ vector of the other processors ignores it. FIQs should
+*		be masked while the handler is changed.
+*
+****************************************************************************/
+void Xil_ExceptionRegisterFiqFast(Xil_FiqFastHandler Handler)
+{
+	XExc_FiqFastHandler = Handler;
+	dsb();
+}
+#endif
+
 #if defined (__aarch64__)
 /*****************************************************************************/
 /**
@@ -59,6 +59,8 @@
 *                         status reporting for ARMv7.
 *						  Updated Sync and SError fault status reporting
 *						  for ARMv8.
+* 9.3  qm        10/14/26 Added the fast FIQ handler of the Cortex-A9,
+*                         Xil_ExceptionRegisterFiqFast().
 * </pre>
 *
 ******************************************************************************/
@@ -251,6 +253,27 @@ typedef struct {
 
 extern XExc_VectorTableEntry XExc_VectorTable[];
 
+#if !defined (__aarch64__)
+/**
+ * A fast FIQ handler, entered straight from the FIQ vector in FIQ mode.
+ * It returns from the exception itself, so it must be defined with
+ * XIL_FIQ_FAST_HANDLER.
+ */
+typedef void (*Xil_FiqFastHandler)(void);
+
+extern Xil_FiqFastHandler XExc_FiqFastHandler;
+
+#if defined (__GNUC__)
+/**
+ * Attribute of a fast FIQ handler. The compiler saves only the registers
+ * the handler uses, r8 to r12 being banked in FIQ mode, and returns with
+ * subs pc, lr, #4. The floating point registers are not saved, the handler
+ * and its callees must not use them.
+ */
+#define XIL_FIQ_FAST_HANDLER	__attribute__((interrupt("FIQ")))
+#endif
+#endif
+
 /**
 *@endcond
 */
@@ -522,6 +545,10 @@ extern void Xil_GetExceptionRegisterHandler(u32 Exception_id,
 
 extern void Xil_ExceptionInit(void);
 
+#if !defined (__aarch64__)
+extern void Xil_ExceptionRegisterFiqFast(Xil_FiqFastHandler Handler);
+#endif
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
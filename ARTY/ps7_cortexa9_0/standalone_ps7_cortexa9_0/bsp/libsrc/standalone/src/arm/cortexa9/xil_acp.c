@@ -0,0 +1,158 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_acp.c
+*
+* This file provides the region of buffers kept coherent with the masters
+* of the ACP. Refer to xil_acp.h for more details.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+#include "xil_io.h"
+#include "xstatus.h"
+#include "xil_mmu.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xparameters_ps.h"
+#include "xil_acp.h"
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/**************************** Type Definitions *******************************/
+
+/**
+ * The mapped region.
+ */
+typedef struct {
+	UINTPTR BaseAddr;	/**< First byte of the region */
+	UINTPTR EndAddr;	/**< Last byte of the region */
+	u32 IsReady;		/**< The region is mapped */
+} Xil_AcpRegion;
+
+/************************** Constant Definitions *****************************/
+
+#define XIL_ACP_SCU_CTRL_OFFSET	0x00U		/**< SCU control register */
+#define XIL_ACP_SCU_ENABLE	0x00000001U	/**< SCU enable bit */
+#define XIL_ACP_ACTLR_SMP	0x00000040U	/**< SMP bit of the ACTLR */
+#define XIL_ACP_MAX_ADDR	0xFFFFFFFFU
+
+/************************** Variable Definitions *****************************/
+
+static Xil_AcpRegion AcpRegion;
+
+/************************** Function Prototypes ******************************/
+
+/*****************************************************************************/
+/**
+* @brief	Maps a region reserved by the linker script as the buffers
+*			shared with the ACP masters.
+*
+* @param	BaseAddr is the start of the region, on a 1 MB boundary.
+* @param	Size is the size of the region, a multiple of 1 MB.
+*
+* @return
+*		- XST_SUCCESS if the region is mapped.
+*		- XST_INVALID_PARAM if the region is not made of whole MMU
+*		  sections.
+*		- XST_NOT_ENABLED if the SCU or the SMP bit of this CPU is
+*		  off, the ACP is not coherent with its caches then.
+*
+* @note		Xil_SetTlbAttributesRange() flushes the whole Data cache,
+*			so the region is meant to be mapped once at startup.
+*
+******************************************************************************/
+s32 Xil_AcpInitialize(UINTPTR BaseAddr, u32 Size)
+{
+	if ((Size == 0U) ||
+	    ((BaseAddr & (XIL_ACP_SECTION_SIZE - 1U)) != 0U) ||
+	    ((Size & (XIL_ACP_SECTION_SIZE - 1U)) != 0U) ||
+	    ((Size - 1U) > (XIL_ACP_MAX_ADDR - BaseAddr))) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	AcpRegion.IsReady = 0U;
+	if (Xil_AcpIsCoherent() == 0U) {
+		return (s32)XST_NOT_ENABLED;
+	}
+
+	Xil_SetTlbAttributesRange((INTPTR)BaseAddr, Size, XIL_ACP_ATTRIB);
+
+	AcpRegion.BaseAddr = BaseAddr;
+	AcpRegion.EndAddr = BaseAddr + (Size - 1U);
+	AcpRegion.IsReady = 1U;
+
+	return (s32)XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Tells whether a buffer lies in the ACP region, in which case it
+*			needs no cache maintenance for an ACP master.
+*
+* @param	Addr is the start of the buffer.
+* @param	Len is the length of the buffer in bytes.
+*
+* @return	1 if the whole buffer is in the region, 0 otherwise.
+*
+* @note		A buffer in the region still needs the cache maintenance
+*			for the masters that do not go through the ACP.
+*
+******************************************************************************/
+u32 Xil_AcpContains(UINTPTR Addr, u32 Len)
+{
+	u32 Status = 0U;
+
+	if ((AcpRegion.IsReady != 0U) && (Addr >= AcpRegion.BaseAddr) &&
+	    (Addr <= AcpRegion.EndAddr) &&
+	    ((Len == 0U) || ((Len - 1U) <= (AcpRegion.EndAddr - Addr)))) {
+		Status = 1U;
+	}
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Tells whether the caches of this CPU are kept coherent with
+*			the ACP, that is the SCU is enabled and the SMP bit of the
+*			ACTLR is set.
+*
+* @return	1 if they are, 0 otherwise.
+*
+******************************************************************************/
+u32 Xil_AcpIsCoherent(void)
+{
+	u32 Actlr;
+	u32 Status = 0U;
+
+#ifdef __GNUC__
+	Actlr = mfcp(XREG_CP15_AUX_CONTROL);
+#elif defined (__ICCARM__)
+	mfcp(XREG_CP15_AUX_CONTROL, Actlr);
+#else
+	{ volatile register u32 Reg __asm(XREG_CP15_AUX_CONTROL);
+	  Actlr = Reg; }
+#endif
+
+	if (((Xil_In32(XPS_SCU_PERIPH_BASE + XIL_ACP_SCU_CTRL_OFFSET) &
+	      XIL_ACP_SCU_ENABLE) != 0U) &&
+	    ((Actlr & XIL_ACP_ACTLR_SMP) != 0U)) {
+		Status = 1U;
+	}
+
+	return Status;
+}
@@ -0,0 +1,96 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_acp.h
+*
+* @addtogroup a9_acp_apis Cortex A9 ACP Coherent Buffer Functions
+*
+* The Accelerator Coherency Port lets a master in the PL read and write the
+* memory of the PS through the SCU, which snoops the L1 data caches of the
+* CPUs and looks up the L2. A buffer shared with such a master is kept
+* cacheable by the CPUs and needs no cache flush or invalidation around a
+* transfer, unlike one in the DMA arena of xil_dmaarena.h that is never
+* cached at all. Small, frequent transfers gain the most: they skip the
+* cache maintenance and the CPUs work on the buffer at cache speed.
+*
+* An access through the ACP is coherent when:
+*
+* - The buffer is mapped normal, write-back cacheable and shareable,
+*   XIL_ACP_ATTRIB, the DDR default of the translation table.
+* - The SCU is enabled and the CPUs sharing the buffer have the SMP bit of
+*   the ACTLR set, as the boot code does.
+* - The PL master drives ARCACHE and AWCACHE with XIL_ACP_AXCACHE and bit 0
+*   of ARUSER and AWUSER set, XIL_ACP_AXUSER. Other values go around the
+*   L1 caches and are not coherent, whatever the mapping.
+*
+* The ACP takes the addresses of the CPUs, DDR and the high OCM, so a
+* pointer is handed to the PL master as it is.
+*
+* The region is reserved by the linker script and mapped once with
+* Xil_AcpInitialize(), which also checks the SCU and the SMP bit. Since the
+* MMU maps memory in 1 MB sections, the region must start and end on a 1 MB
+* boundary. Xil_AcpContains() tells whether a buffer is in it. The region
+* is coherent for ACP masters only: the PL330 of the PS and the other
+* masters of the central interconnect and the HP ports do not go through
+* the SCU, and still need the cache maintenance on a buffer there.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/**
+*@cond nocomments
+*/
+
+#ifndef XIL_ACP_H
+#define XIL_ACP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+#include "xil_mmu.h"
+
+/************************** Constant Definitions *****************************/
+
+#define XIL_ACP_SECTION_SIZE	0x100000U	/* MMU section */
+#define XIL_ACP_ALIGN		32U	/* Cache line */
+
+/* Normal write-back write-allocate cacheable, shareable */
+#define XIL_ACP_ATTRIB		NORM_WB_CACHE
+
+/* AxCACHE of a coherent access: write-back, read and write allocate */
+#define XIL_ACP_AXCACHE		0xFU
+/* AxUSER of a coherent access: bit 0 marks it shared */
+#define XIL_ACP_AXUSER		0x1U
+
+/**
+*@endcond
+*/
+
+/************************** Function Prototypes ******************************/
+
+s32 Xil_AcpInitialize(UINTPTR BaseAddr, u32 Size);
+u32 Xil_AcpContains(UINTPTR Addr, u32 Len);
+u32 Xil_AcpIsCoherent(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* XIL_ACP_H */
+/**
+* @} End of "addtogroup a9_acp_apis".
+*/
@@ -0,0 +1,530 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_atomic.h
+*
+* @addtogroup a9_atomic_apis Cortex A9 Atomic and Locking Primitives
+*
+* Header only primitives for code shared by the two Cortex-A9 CPUs, built
+* on the LDREX/STREX macros of xpseudo_asm.h:
+*
+* - Atomic operations on a word, Xil_AtomicAdd() and the others. Each one is
+*   a full barrier, the accesses before it are seen before it and those
+*   after it after it. Xil_AtomicLoadAcquire() and Xil_AtomicStoreRelease()
+*   only order one side.
+* - Ticket spinlocks, Xil_TicketLock, taken in the order they are asked
+*   for so that neither CPU starves. A waiting CPU sleeps in WFE until the
+*   holder releases the lock with SEV. The IrqSave variants also mask the
+*   IRQ of the calling CPU, which a lock shared with an interrupt handler
+*   needs, or the handler spins on the lock its own CPU holds.
+* - Sequence locks, Xil_SeqLock, for data read much more often than
+*   written: readers take no lock and retry when a writer ran meanwhile.
+*   A writer preempted by a reader of its own CPU would make the reader spin
+*   forever, so a writer shared with an interrupt handler writes with the
+*   IRQ masked.
+* - Per CPU data, XIL_PERCPU(), one cache line aligned copy per CPU, and
+*   Xil_CpuId().
+* - Groups of members of a driver instance, between XIL_HOT_GROUP_BEGIN
+*   and XIL_HOT_GROUP_END, that start on a cache line of their own when the
+*   BSP is built with XIL_DRIVER_HOT_LAYOUT. The XScuGic, XUartPs and
+*   XDmaPs instances keep what their interrupt handlers touch in the first
+*   groups and their configuration after, so that the handlers miss on as
+*   few lines as they can, and neither CPU writes a line that holds hot
+*   state of an instance the other one uses. The instances are then cache
+*   line aligned and their size a multiple of a line. Without the flag the
+*   groups are plain members.
+*
+* The exclusive accesses only work on normal memory, and between the CPUs
+* on normal cacheable memory with the SMP bit of the ACTLR set, as the boot
+* code does; a lock is never placed in the DMA arena or a device window.
+* Without USE_AMP both CPUs run the same application and share these
+* primitives; with USE_AMP the shared memory is to be mapped as
+* normal write-back cacheable and shareable on both sides.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+*       qm   10/14/26 Added XIL_HOT_GROUP_BEGIN and XIL_HOT_GROUP_END.
+* </pre>
+*
+******************************************************************************/
+
+/**
+*@cond nocomments
+*/
+
+#ifndef XIL_ATOMIC_H
+#define XIL_ATOMIC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+#include "xil_io.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+
+/************************** Constant Definitions *****************************/
+
+#define XIL_NUM_CPUS		2U	/* Cortex-A9 CPUs of the Zynq-7000 */
+#define XIL_ATOMIC_CACHE_LINE	32U	/* Bytes of an L1 cache line */
+
+/* Halves of a ticket lock word */
+#define XIL_TICKET_NEXT_INC	0x00010000U
+#define XIL_TICKET_OWNER_MASK	0x0000FFFFU
+#define XIL_TICKET_NEXT_SHIFT	16U
+
+/**************************** Type Definitions *******************************/
+
+/**
+ * A ticket spinlock, 0 when unlocked. The low half is the ticket being
+ * served, the high half the next ticket to give.
+ */
+typedef struct {
+	volatile u32 Ticket;
+} Xil_TicketLock;
+
+/**
+ * A sequence lock. The count is odd while a writer runs.
+ */
+typedef struct {
+	volatile u32 Seq;
+	Xil_TicketLock Lock;	/* Serializes the writers */
+} Xil_SeqLock;
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+#define Xil_Wfe()	__asm__ __volatile__ ("wfe" : : : "memory")
+#define Xil_Sev()	__asm__ __volatile__ ("sev" : : : "memory")
+
+/* Defines per CPU data, a copy of Type per CPU in its own cache line */
+#define XIL_PERCPU(Type, Name) \
+	struct __attribute__((aligned(XIL_ATOMIC_CACHE_LINE))) { \
+		Type Val; \
+	} Name[XIL_NUM_CPUS]
+
+/* Copy of per CPU data of the calling CPU, and of a given CPU */
+#define XIL_PERCPU_THIS(Name)		(&(Name)[Xil_CpuId()].Val)
+#define XIL_PERCPU_OF(Name, Cpu)	(&(Name)[(Cpu)].Val)
+
+/* Group of the members of a driver instance, on its own cache lines */
+#if defined (XIL_DRIVER_HOT_LAYOUT)
+#define XIL_HOT_GROUP_BEGIN \
+	struct __attribute__((aligned(XIL_ATOMIC_CACHE_LINE))) {
+#define XIL_HOT_GROUP_END	};
+#else
+#define XIL_HOT_GROUP_BEGIN
+#define XIL_HOT_GROUP_END
+#endif
+
+/**
+*@endcond
+*/
+
+/*****************************************************************************/
+/**
+* @brief	Gives the number of the calling CPU.
+*
+* @return	0 or 1.
+*
+******************************************************************************/
+static INLINE u32 Xil_CpuId(void)
+{
+	return mfcp(XREG_CP15_MULTI_PROC_AFFINITY) & 0x1U;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Reads a word, the accesses after it seen after it.
+*
+* @param	Ptr is the word.
+*
+* @return	Its value.
+*
+******************************************************************************/
+static INLINE u32 Xil_AtomicLoadAcquire(volatile u32 *Ptr)
+{
+	u32 Val = *Ptr;
+
+	dmb();
+	return Val;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Writes a word, the accesses before it seen before it.
+*
+* @param	Ptr is the word.
+* @param	Val is the value to write.
+*
+* @return	None.
+*
+******************************************************************************/
+static INLINE void Xil_AtomicStoreRelease(volatile u32 *Ptr, u32 Val)
+{
+	dmb();
+	*Ptr = Val;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Adds to a word.
+*
+* @param	Ptr is the word.
+* @param	Val is the value to add.
+*
+* @return	The new value of the word.
+*
+******************************************************************************/
+static INLINE u32 Xil_AtomicAdd(volatile u32 *Ptr, u32 Val)
+{
+	u32 New;
+
+	dmb();
+	do {
+		New = ldrex(Ptr) + Val;
+	} while (strex(Ptr, New) != 0U);
+	dmb();
+
+	return New;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Subtracts from a word.
+*
+* @param	Ptr is the word.
+* @param	Val is the value to subtract.
+*
+* @return	The new value of the word.
+*
+******************************************************************************/
+static INLINE u32 Xil_AtomicSub(volatile u32 *Ptr, u32 Val)
+{
+	return Xil_AtomicAdd(Ptr, (u32)0U - Val);
+}
+
+/*****************************************************************************/
+/**
+* @brief	Sets the bits of a mask in a word.
+*
+* @param	Ptr is the word.
+* @param	Mask is the bits to set.
+*
+* @return	The value of the word before.
+*
+******************************************************************************/
+static INLINE u32 Xil_AtomicOr(volatile u32 *Ptr, u32 Mask)
+{
+	u32 Old;
+
+	dmb();
+	do {
+		Old = ldrex(Ptr);
+	} while (strex(Ptr, Old | Mask) != 0U);
+	dmb();
+
+	return Old;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Clears the bits outside a mask in a word.
+*
+* @param	Ptr is the word.
+* @param	Mask is the bits to keep.
+*
+* @return	The value of the word before.
+*
+******************************************************************************/
+static INLINE u32 Xil_AtomicAnd(volatile u32 *Ptr, u32 Mask)
+{
+	u32 Old;
+
+	dmb();
+	do {
+		Old = ldrex(Ptr);
+	} while (strex(Ptr, Old & Mask) != 0U);
+	dmb();
+
+	return Old;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Writes a word and gives what it held.
+*
+* @param	Ptr is the word.
+* @param	Val is the value to write.
+*
+* @return	The value of the word before.
+*
+******************************************************************************/
+static INLINE u32 Xil_AtomicSwap(volatile u32 *Ptr, u32 Val)
+{
+	u32 Old;
+
+	dmb();
+	do {
+		Old = ldrex(Ptr);
+	} while (strex(Ptr, Val) != 0U);
+	dmb();
+
+	return Old;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Writes a word if it holds an expected value.
+*
+* @param	Ptr is the word.
+* @param	Expected is the value it must hold.
+* @param	Desired is the value to write.
+*
+* @return	The value of the word before, Expected if it was written.
+*
+******************************************************************************/
+static INLINE u32 Xil_AtomicCas(volatile u32 *Ptr, u32 Expected, u32 Desired)
+{
+	u32 Old;
+
+	dmb();
+	do {
+		Old = ldrex(Ptr);
+		if (Old != Expected) {
+			clrex();
+			break;
+		}
+	} while (strex(Ptr, Desired) != 0U);
+	dmb();
+
+	return Old;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Initializes a ticket lock, unlocked.
+*
+* @param	LockPtr is the lock.
+*
+* @return	None.
+*
+******************************************************************************/
+static INLINE void Xil_TicketLockInit(Xil_TicketLock *LockPtr)
+{
+	LockPtr->Ticket = 0U;
+	dmb();
+}
+
+/*****************************************************************************/
+/**
+* @brief	Takes a ticket lock, waiting for the CPUs ahead.
+*
+* @param	LockPtr is the lock.
+*
+* @return	None.
+*
+******************************************************************************/
+static INLINE void Xil_TicketLockAcquire(Xil_TicketLock *LockPtr)
+{
+	u32 Old;
+	u32 Ticket;
+
+	do {
+		Old = ldrex(&LockPtr->Ticket);
+	} while (strex(&LockPtr->Ticket, Old + XIL_TICKET_NEXT_INC) != 0U);
+
+	Ticket = Old >> XIL_TICKET_NEXT_SHIFT;
+	while ((LockPtr->Ticket & XIL_TICKET_OWNER_MASK) != Ticket) {
+		Xil_Wfe();
+	}
+	dmb();
+}
+
+/*****************************************************************************/
+/**
+* @brief	Takes a ticket lock if it is free.
+*
+* @param	LockPtr is the lock.
+*
+* @return	1 if the lock was taken, 0 if it is held.
+*
+******************************************************************************/
+static INLINE u32 Xil_TicketLockTry(Xil_TicketLock *LockPtr)
+{
+	u32 Old;
+
+	do {
+		Old = ldrex(&LockPtr->Ticket);
+		if ((Old >> XIL_TICKET_NEXT_SHIFT) !=
+		    (Old & XIL_TICKET_OWNER_MASK)) {
+			clrex();
+			return 0U;
+		}
+	} while (strex(&LockPtr->Ticket, Old + XIL_TICKET_NEXT_INC) != 0U);
+	dmb();
+
+	return 1U;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Releases a ticket lock to the next CPU waiting.
+*
+* @param	LockPtr is the lock.
+*
+* @return	None.
+*
+* @note		The ticket being served is a halfword only the holder
+*		writes; the store also fails the STREX of a CPU taking a
+*		ticket at the same time, which retries.
+*
+******************************************************************************/
+static INLINE void Xil_TicketLockRelease(Xil_TicketLock *LockPtr)
+{
+	volatile u16 *OwnerPtr = (volatile u16 *)(void *)&LockPtr->Ticket;
+
+	dmb();
+	*OwnerPtr = (u16)(*OwnerPtr + 1U);
+	dsb();
+	Xil_Sev();
+}
+
+/*****************************************************************************/
+/**
+* @brief	Masks the IRQ of the calling CPU and takes a ticket lock.
+*
+* @param	LockPtr is the lock.
+*
+* @return	The CPSR to give to Xil_TicketLockIrqRestore().
+*
+******************************************************************************/
+static INLINE u32 Xil_TicketLockIrqSave(Xil_TicketLock *LockPtr)
+{
+	u32 Cpsr = mfcpsr();
+
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+	Xil_TicketLockAcquire(LockPtr);
+
+	return Cpsr;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Releases a ticket lock and restores the IRQ mask.
+*
+* @param	LockPtr is the lock.
+* @param	Cpsr is what Xil_TicketLockIrqSave() gave.
+*
+* @return	None.
+*
+******************************************************************************/
+static INLINE void Xil_TicketLockIrqRestore(Xil_TicketLock *LockPtr, u32 Cpsr)
+{
+	Xil_TicketLockRelease(LockPtr);
+	mtcpsr(Cpsr);
+}
+
+/*****************************************************************************/
+/**
+* @brief	Initializes a sequence lock.
+*
+* @param	LockPtr is the lock.
+*
+* @return	None.
+*
+******************************************************************************/
+static INLINE void Xil_SeqLockInit(Xil_SeqLock *LockPtr)
+{
+	LockPtr->Seq = 0U;
+	Xil_TicketLockInit(&LockPtr->Lock);
+}
+
+/*****************************************************************************/
+/**
+* @brief	Starts a write of the data of a sequence lock.
+*
+* @param	LockPtr is the lock.
+*
+* @return	None.
+*
+******************************************************************************/
+static INLINE void Xil_SeqLockWriteBegin(Xil_SeqLock *LockPtr)
+{
+	Xil_TicketLockAcquire(&LockPtr->Lock);
+	LockPtr->Seq++;
+	dmb();
+}
+
+/*****************************************************************************/
+/**
+* @brief	Ends a write of the data of a sequence lock.
+*
+* @param	LockPtr is the lock.
+*
+* @return	None.
+*
+******************************************************************************/
+static INLINE void Xil_SeqLockWriteEnd(Xil_SeqLock *LockPtr)
+{
+	dmb();
+	LockPtr->Seq++;
+	Xil_TicketLockRelease(&LockPtr->Lock);
+}
+
+/*****************************************************************************/
+/**
+* @brief	Starts a read of the data of a sequence lock, waiting for a
+*		running write.
+*
+* @param	LockPtr is the lock.
+*
+* @return	The count to give to Xil_SeqLockReadRetry().
+*
+******************************************************************************/
+static INLINE u32 Xil_SeqLockReadBegin(const Xil_SeqLock *LockPtr)
+{
+	u32 Seq;
+
+	do {
+		Seq = LockPtr->Seq;
+	} while ((Seq & 0x1U) != 0U);
+	dmb();
+
+	return Seq;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Tells whether a read of the data of a sequence lock is to be
+*		done again.
+*
+* @param	LockPtr is the lock.
+* @param	Seq is what Xil_SeqLockReadBegin() gave.
+*
+* @return	1 if a write ran during the read, 0 if the read is good.
+*
+******************************************************************************/
+static INLINE u32 Xil_SeqLockReadRetry(const Xil_SeqLock *LockPtr, u32 Seq)
+{
+	dmb();
+	return (LockPtr->Seq != Seq) ? 1U : 0U;
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* XIL_ATOMIC_H */
+/**
+* @} End of "addtogroup a9_atomic_apis".
+*/
@@ -0,0 +1,561 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_blockpool.c
+*
+* This file contains the block pool allocator. Refer to xil_blockpool.h for
+* more details.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+* @note
+*
+* The free stack of a class is the one of xil_dmaarena.c: the head holds
+* the index of the top block plus one in its lower half and a tag in its
+* upper half, and each free block holds the index plus one of the block
+* under it. A dmb before a push and after a pop orders the contents of a
+* block with its moves between the CPUs.
+*
+* The counters and the caches of a CPU are only touched by that CPU, with
+* the IRQ masked, on a cache line of their own.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+#include "xil_assert.h"
+#include "xstatus.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xil_blockpool.h"
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/**************************** Type Definitions *******************************/
+
+/**
+ * The part of a class each CPU keeps for itself.
+ */
+typedef struct {
+	u32 Allocs;
+	u32 Frees;
+	u32 Failures;
+#if (XIL_BLOCKPOOL_CACHE_SIZE > 0U)
+	u32 Count;		/**< Blocks in the cache */
+	void *Block[XIL_BLOCKPOOL_CACHE_SIZE];
+#endif
+} __attribute__((aligned(XIL_BLOCKPOOL_ALIGN))) Xil_BlockPoolCpu;
+
+/**
+ * A size class.
+ */
+typedef struct {
+	UINTPTR BaseAddr;	/**< First block */
+	UINTPTR EndAddr;	/**< First byte after the last block */
+	u32 BlockSize;		/**< Bytes per block, cache line multiple */
+	u32 NumBlocks;
+	volatile u32 Head;	/**< Tag and top of the free stack */
+	volatile u32 Out;	/**< Blocks out of the free stack */
+	volatile u32 HighWater;	/**< Most blocks out of the free stack */
+	Xil_BlockPoolCpu Cpu[XIL_BLOCKPOOL_NUM_CPUS];
+} Xil_BlockPoolClass;
+
+/************************** Constant Definitions *****************************/
+
+#define XIL_BLOCKPOOL_INDEX_MASK	0x0000FFFFU	/**< Top of a head */
+#define XIL_BLOCKPOOL_TAG_MASK		0xFFFF0000U	/**< Tag of a head */
+#define XIL_BLOCKPOOL_TAG_INC		0x00010000U	/**< Tag step */
+
+/************************** Variable Definitions *****************************/
+
+static struct {
+	UINTPTR NextAddr;	/**< First byte not given to a class */
+	UINTPTR EndAddr;	/**< First byte after the region */
+	u32 NumClasses;
+	Xil_BlockPoolClass Class[XIL_BLOCKPOOL_MAX_CLASSES];
+} BlockPool;
+
+/************************** Function Prototypes ******************************/
+
+static u32 Xil_BlockPoolSwap(volatile u32 *Addr, u32 Old, u32 New);
+static void Xil_BlockPoolAdd(volatile u32 *Addr, u32 Value);
+static void *Xil_BlockPoolPop(Xil_BlockPoolClass *ClassPtr);
+static void Xil_BlockPoolPush(Xil_BlockPoolClass *ClassPtr, void *BlockPtr);
+static void *Xil_BlockPoolTake(Xil_BlockPoolClass *ClassPtr,
+			       Xil_BlockPoolCpu *CpuPtr);
+static void Xil_BlockPoolGive(Xil_BlockPoolClass *ClassPtr,
+			      Xil_BlockPoolCpu *CpuPtr, void *BlockPtr);
+
+/*****************************************************************************/
+/**
+* @brief	Gives the allocator the region its classes are carved from.
+*
+* @param	BaseAddr is the start of the region, in cacheable memory.
+* @param	Size is the size of the region in bytes.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM if the region is empty.
+*
+* @note		The classes added before are lost. Call it once at startup,
+*		before the other CPU is started.
+*
+******************************************************************************/
+s32 Xil_BlockPoolInitialize(UINTPTR BaseAddr, u32 Size)
+{
+	UINTPTR Start;
+
+	Start = (BaseAddr + (XIL_BLOCKPOOL_ALIGN - 1U)) &
+		~(UINTPTR)(XIL_BLOCKPOOL_ALIGN - 1U);
+	if ((Size == 0U) || ((Start - BaseAddr) >= Size)) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	BlockPool.NextAddr = Start;
+	BlockPool.EndAddr = BaseAddr + Size;
+	BlockPool.NumClasses = 0U;
+
+	return (s32)XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Carves a size class out of the region, all its blocks free.
+*
+* @param	BlockSize is the size of a block in bytes, rounded up to a
+*			multiple of the cache line size. It must be larger than
+*			the blocks of the classes added before.
+* @param	NumBlocks is the number of blocks, up to
+*			XIL_BLOCKPOOL_MAX_BLOCKS.
+*
+* @return
+*		- XST_SUCCESS if the class was added.
+*		- XST_NOT_ENABLED if there is no region.
+*		- XST_INVALID_PARAM if a size is zero, out of range or not
+*		  larger than the last class.
+*		- XST_BUFFER_TOO_SMALL if the region has no room left, or
+*		  XIL_BLOCKPOOL_MAX_CLASSES classes exist.
+*
+******************************************************************************/
+s32 Xil_BlockPoolAddClass(u32 BlockSize, u32 NumBlocks)
+{
+	Xil_BlockPoolClass *ClassPtr;
+	UINTPTR BlockAddr;
+	u32 Size;
+	u32 Index;
+
+	if (BlockPool.NextAddr == 0U) {
+		return (s32)XST_NOT_ENABLED;
+	}
+	if ((BlockSize == 0U) || (NumBlocks == 0U) ||
+	    (NumBlocks > XIL_BLOCKPOOL_MAX_BLOCKS) ||
+	    (BlockSize > (0xFFFFFFFFU - (XIL_BLOCKPOOL_ALIGN - 1U)))) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	Size = (BlockSize + (XIL_BLOCKPOOL_ALIGN - 1U)) &
+	       ~(XIL_BLOCKPOOL_ALIGN - 1U);
+	if ((BlockPool.NumClasses != 0U) &&
+	    (Size <= BlockPool.Class[BlockPool.NumClasses - 1U].BlockSize)) {
+		return (s32)XST_INVALID_PARAM;
+	}
+	if ((BlockPool.NumClasses == XIL_BLOCKPOOL_MAX_CLASSES) ||
+	    (Size > ((BlockPool.EndAddr - BlockPool.NextAddr) / NumBlocks))) {
+		return (s32)XST_BUFFER_TOO_SMALL;
+	}
+
+	ClassPtr = &BlockPool.Class[BlockPool.NumClasses];
+	ClassPtr->BaseAddr = BlockPool.NextAddr;
+	ClassPtr->EndAddr = BlockPool.NextAddr + (Size * NumBlocks);
+	ClassPtr->BlockSize = Size;
+	ClassPtr->NumBlocks = NumBlocks;
+	ClassPtr->Out = 0U;
+	ClassPtr->HighWater = 0U;
+	for (Index = 0U; Index < XIL_BLOCKPOOL_NUM_CPUS; Index++) {
+		ClassPtr->Cpu[Index].Allocs = 0U;
+		ClassPtr->Cpu[Index].Frees = 0U;
+		ClassPtr->Cpu[Index].Failures = 0U;
+#if (XIL_BLOCKPOOL_CACHE_SIZE > 0U)
+		ClassPtr->Cpu[Index].Count = 0U;
+#endif
+	}
+
+	/* Chain the blocks in address order, the first one on top */
+	for (Index = 0U; Index < NumBlocks; Index++) {
+		BlockAddr = ClassPtr->BaseAddr + (Index * Size);
+		*(volatile u32 *)BlockAddr = (Index + 2U <= NumBlocks) ?
+					     (Index + 2U) : 0U;
+	}
+	ClassPtr->Head = 1U;
+	dmb();
+
+	BlockPool.NextAddr = ClassPtr->EndAddr;
+	BlockPool.NumClasses++;
+
+	return (s32)XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Returns the number of size classes.
+*
+* @return	The number of classes added.
+*
+******************************************************************************/
+u32 Xil_BlockPoolNumClasses(void)
+{
+	return BlockPool.NumClasses;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Allocates a block. It may be called from both CPUs and from
+*			interrupt handlers.
+*
+* @param	Size is the number of bytes needed.
+*
+* @return	A cache line aligned block of at least Size bytes, or NULL if
+*			no class that fits has a free block.
+*
+* @note		The failure is counted to the smallest class that fits.
+*
+******************************************************************************/
+void *Xil_BlockPoolAlloc(u32 Size)
+{
+	Xil_BlockPoolClass *ClassPtr;
+	Xil_BlockPoolCpu *CpuPtr;
+	void *BlockPtr = NULL;
+	u32 Cpu = mfcp(XREG_CP15_MULTI_PROC_AFFINITY) & 0x1U;
+	u32 First;
+	u32 Class;
+	u32 Cpsr;
+
+	for (First = 0U; First < BlockPool.NumClasses; First++) {
+		if (BlockPool.Class[First].BlockSize >= Size) {
+			break;
+		}
+	}
+	if (First == BlockPool.NumClasses) {
+		return NULL;
+	}
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+
+	for (Class = First; Class < BlockPool.NumClasses; Class++) {
+		ClassPtr = &BlockPool.Class[Class];
+		CpuPtr = &ClassPtr->Cpu[Cpu];
+		BlockPtr = Xil_BlockPoolTake(ClassPtr, CpuPtr);
+		if (BlockPtr != NULL) {
+			CpuPtr->Allocs++;
+			break;
+		}
+	}
+	if (BlockPtr == NULL) {
+		BlockPool.Class[First].Cpu[Cpu].Failures++;
+	}
+
+	mtcpsr(Cpsr);
+
+	return BlockPtr;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Frees a block. It may be called from both CPUs and from
+*			interrupt handlers, on either CPU whichever allocated it.
+*
+* @param	BlockPtr is the block, as given by Xil_BlockPoolAlloc().
+*
+* @return	None.
+*
+******************************************************************************/
+void Xil_BlockPoolFree(void *BlockPtr)
+{
+	Xil_BlockPoolClass *ClassPtr = NULL;
+	u32 Cpu = mfcp(XREG_CP15_MULTI_PROC_AFFINITY) & 0x1U;
+	u32 Class;
+	u32 Cpsr;
+
+	for (Class = 0U; Class < BlockPool.NumClasses; Class++) {
+		if (((UINTPTR)BlockPtr >= BlockPool.Class[Class].BaseAddr) &&
+		    ((UINTPTR)BlockPtr < BlockPool.Class[Class].EndAddr)) {
+			ClassPtr = &BlockPool.Class[Class];
+			break;
+		}
+	}
+	Xil_AssertVoid(ClassPtr != NULL);
+	Xil_AssertVoid((((UINTPTR)BlockPtr - ClassPtr->BaseAddr) %
+			ClassPtr->BlockSize) == 0U);
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+	Xil_BlockPoolGive(ClassPtr, &ClassPtr->Cpu[Cpu], BlockPtr);
+	ClassPtr->Cpu[Cpu].Frees++;
+	mtcpsr(Cpsr);
+}
+
+/*****************************************************************************/
+/**
+* @brief	Gives the use of a size class.
+*
+* @param	Class is the class, 0 for the smallest.
+* @param	StatsPtr is where the use is returned.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM if there is no such class.
+*
+* @note		The counters of the two CPUs are read one after the other, the
+*		values are consistent only while the class is idle.
+*
+******************************************************************************/
+s32 Xil_BlockPoolGetStats(u32 Class, Xil_BlockPoolStats *StatsPtr)
+{
+	const Xil_BlockPoolClass *ClassPtr;
+	u32 Index;
+
+	Xil_AssertNonvoid(StatsPtr != NULL);
+
+	if (Class >= BlockPool.NumClasses) {
+		return (s32)XST_INVALID_PARAM;
+	}
+	ClassPtr = &BlockPool.Class[Class];
+
+	StatsPtr->BlockSize = ClassPtr->BlockSize;
+	StatsPtr->NumBlocks = ClassPtr->NumBlocks;
+	StatsPtr->HighWater = ClassPtr->HighWater;
+	StatsPtr->Cached = 0U;
+	StatsPtr->Allocs = 0U;
+	StatsPtr->Frees = 0U;
+	StatsPtr->Failures = 0U;
+	for (Index = 0U; Index < XIL_BLOCKPOOL_NUM_CPUS; Index++) {
+#if (XIL_BLOCKPOOL_CACHE_SIZE > 0U)
+		StatsPtr->Cached += ClassPtr->Cpu[Index].Count;
+#endif
+		StatsPtr->Allocs += ClassPtr->Cpu[Index].Allocs;
+		StatsPtr->Frees += ClassPtr->Cpu[Index].Frees;
+		StatsPtr->Failures += ClassPtr->Cpu[Index].Failures;
+	}
+	StatsPtr->InUse = ClassPtr->Out - StatsPtr->Cached;
+
+	return (s32)XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* Replaces a word if it still holds the expected value, with LDREX/STREX.
+* The monitor is cleared when the value does not match.
+*
+* @param	Addr is the word.
+* @param	Old is the expected value.
+* @param	New is the new value.
+*
+* @return	1 if the word was replaced, 0 otherwise.
+*
+******************************************************************************/
+static u32 Xil_BlockPoolSwap(volatile u32 *Addr, u32 Old, u32 New)
+{
+	if (ldrex(Addr) != Old) {
+		clrex();
+		return 0U;
+	}
+
+	return (strex(Addr, New) == 0U) ? 1U : 0U;
+}
+
+/*****************************************************************************/
+/**
+*
+* Adds to a counter shared by the CPUs, a negative value being given in
+* two's complement.
+*
+* @param	Addr is the counter.
+* @param	Value is added to it.
+*
+* @return	None.
+*
+******************************************************************************/
+static void Xil_BlockPoolAdd(volatile u32 *Addr, u32 Value)
+{
+	u32 Old;
+
+	do {
+		Old = ldrex(Addr);
+	} while (strex(Addr, Old + Value) != 0U);
+}
+
+/*****************************************************************************/
+/**
+*
+* Takes the top block of the free stack of a class.
+*
+* @param	ClassPtr is the class.
+*
+* @return	The block, or NULL if the stack is empty.
+*
+******************************************************************************/
+static void *Xil_BlockPoolPop(Xil_BlockPoolClass *ClassPtr)
+{
+	UINTPTR BlockAddr;
+	u32 Head;
+	u32 Next;
+
+	do {
+		Head = ClassPtr->Head;
+		if ((Head & XIL_BLOCKPOOL_INDEX_MASK) == 0U) {
+			return NULL;
+		}
+		BlockAddr = ClassPtr->BaseAddr +
+			    (((Head & XIL_BLOCKPOOL_INDEX_MASK) - 1U) *
+			     ClassPtr->BlockSize);
+		/* Stale if the block was taken meanwhile, the tag tells */
+		Next = *(volatile u32 *)BlockAddr;
+	} while (Xil_BlockPoolSwap(&ClassPtr->Head, Head,
+				   ((Head + XIL_BLOCKPOOL_TAG_INC) &
+				    XIL_BLOCKPOOL_TAG_MASK) |
+				   (Next & XIL_BLOCKPOOL_INDEX_MASK)) == 0U);
+	dmb();
+
+	return (void *)BlockAddr;
+}
+
+/*****************************************************************************/
+/**
+*
+* Puts a block on top of the free stack of its class.
+*
+* @param	ClassPtr is the class.
+* @param	BlockPtr is the block.
+*
+* @return	None.
+*
+******************************************************************************/
+static void Xil_BlockPoolPush(Xil_BlockPoolClass *ClassPtr, void *BlockPtr)
+{
+	u32 Index = (u32)(((UINTPTR)BlockPtr - ClassPtr->BaseAddr) /
+			  ClassPtr->BlockSize);
+	u32 Head;
+
+	dmb();
+	do {
+		Head = ClassPtr->Head;
+		*(volatile u32 *)BlockPtr = Head & XIL_BLOCKPOOL_INDEX_MASK;
+		dmb();
+	} while (Xil_BlockPoolSwap(&ClassPtr->Head, Head,
+				   ((Head + XIL_BLOCKPOOL_TAG_INC) &
+				    XIL_BLOCKPOOL_TAG_MASK) |
+				   (Index + 1U)) == 0U);
+}
+
+/*****************************************************************************/
+/**
+*
+* Takes a free block of a class for the calling CPU, from its cache or from
+* the free stack. Called with the IRQ masked.
+*
+* @param	ClassPtr is the class.
+* @param	CpuPtr is the part of the class of the calling CPU.
+*
+* @return	The block, or NULL if the class has none free.
+*
+******************************************************************************/
+static void *Xil_BlockPoolTake(Xil_BlockPoolClass *ClassPtr,
+			       Xil_BlockPoolCpu *CpuPtr)
+{
+	void *BlockPtr;
+	u32 Out;
+	u32 HighWater;
+	u32 Taken = 0U;
+
+#if (XIL_BLOCKPOOL_CACHE_SIZE > 0U)
+	if (CpuPtr->Count != 0U) {
+		CpuPtr->Count--;
+		return CpuPtr->Block[CpuPtr->Count];
+	}
+
+	/* Refill half the cache, the block returned included */
+	while (Taken < (XIL_BLOCKPOOL_CACHE_SIZE / 2U)) {
+		BlockPtr = Xil_BlockPoolPop(ClassPtr);
+		if (BlockPtr == NULL) {
+			break;
+		}
+		CpuPtr->Block[Taken] = BlockPtr;
+		Taken++;
+	}
+	if (Taken == 0U) {
+		return NULL;
+	}
+	CpuPtr->Count = Taken - 1U;
+	BlockPtr = CpuPtr->Block[Taken - 1U];
+#else
+	(void)CpuPtr;
+
+	BlockPtr = Xil_BlockPoolPop(ClassPtr);
+	if (BlockPtr == NULL) {
+		return NULL;
+	}
+	Taken = 1U;
+#endif
+
+	Xil_BlockPoolAdd(&ClassPtr->Out, Taken);
+	Out = ClassPtr->Out;
+	do {
+		HighWater = ClassPtr->HighWater;
+	} while ((Out > HighWater) &&
+		 (Xil_BlockPoolSwap(&ClassPtr->HighWater, HighWater, Out) == 0U));
+
+	return BlockPtr;
+}
+
+/*****************************************************************************/
+/**
+*
+* Gives a block back, to the cache of the calling CPU or to the free
+* stack. Called with the IRQ masked.
+*
+* @param	ClassPtr is the class.
+* @param	CpuPtr is the part of the class of the calling CPU.
+* @param	BlockPtr is the block.
+*
+* @return	None.
+*
+******************************************************************************/
+static void Xil_BlockPoolGive(Xil_BlockPoolClass *ClassPtr,
+			      Xil_BlockPoolCpu *CpuPtr, void *BlockPtr)
+{
+#if (XIL_BLOCKPOOL_CACHE_SIZE > 0U)
+	u32 Index;
+
+	if (CpuPtr->Count == XIL_BLOCKPOOL_CACHE_SIZE) {
+		/* Drain the older half */
+		for (Index = 0U; Index < (XIL_BLOCKPOOL_CACHE_SIZE / 2U);
+		     Index++) {
+			Xil_BlockPoolPush(ClassPtr, CpuPtr->Block[Index]);
+		}
+		for (Index = 0U; Index < (XIL_BLOCKPOOL_CACHE_SIZE / 2U);
+		     Index++) {
+			CpuPtr->Block[Index] =
+				CpuPtr->Block[Index +
+					      (XIL_BLOCKPOOL_CACHE_SIZE / 2U)];
+		}
+		CpuPtr->Count = XIL_BLOCKPOOL_CACHE_SIZE / 2U;
+		Xil_BlockPoolAdd(&ClassPtr->Out,
+				 0U - (XIL_BLOCKPOOL_CACHE_SIZE / 2U));
+	}
+	CpuPtr->Block[CpuPtr->Count] = BlockPtr;
+	CpuPtr->Count++;
+#else
+	(void)CpuPtr;
+
+	Xil_BlockPoolPush(ClassPtr, BlockPtr);
+	Xil_BlockPoolAdd(&ClassPtr->Out, 0xFFFFFFFFU);
+#endif
+}
@@ -0,0 +1,110 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_blockpool.h
+*
+* @addtogroup a9_blockpool_apis Cortex A9 Block Pool Allocator Functions
+*
+* Constant time allocation of fixed size blocks, for the packet and frame
+* buffers of the hot paths, in place of malloc().
+*
+* The allocator is given a region reserved by the linker script with
+* Xil_BlockPoolInitialize(), and up to XIL_BLOCKPOOL_MAX_CLASSES size
+* classes are carved out of it at startup with Xil_BlockPoolAddClass(), in
+* increasing block size. Xil_BlockPoolAlloc() takes a block from the
+* smallest class that fits the size, or from a larger class when that one
+* is empty, and Xil_BlockPoolFree() gives it back to its class, found from
+* the address. Blocks are cache line aligned and never split or merged, so
+* the region does not fragment.
+*
+* Each class keeps its free blocks in a lock-free stack built on
+* LDREX/STREX, with a tag against reuse between the load and the store, so
+* that both CPUs and their interrupt handlers can allocate and free. The
+* region must be in cacheable memory, for the exclusive accesses to be kept
+* coherent across the CPUs by the SCU: the default DDR mapping of the BSP.
+*
+* With XIL_BLOCKPOOL_CACHE_SIZE defined to a non zero even number, each CPU
+* also keeps up to that many free blocks per class in a cache of its own,
+* taken from and given back to the shared stack half a cache at a time, so
+* that most allocations do not touch the shared lines at all.
+*
+* Xil_BlockPoolGetStats() gives the use of a class: the blocks out of the
+* shared stack now and at most, the allocations, frees and failures.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/**
+*@cond nocomments
+*/
+
+#ifndef XIL_BLOCKPOOL_H
+#define XIL_BLOCKPOOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+#define XIL_BLOCKPOOL_MAX_CLASSES	8U	/* Size classes */
+#define XIL_BLOCKPOOL_ALIGN		32U	/* Cache line */
+#define XIL_BLOCKPOOL_MAX_BLOCKS	0xFFFEU	/* Blocks of a class */
+#define XIL_BLOCKPOOL_NUM_CPUS		2U
+
+/* Free blocks cached per CPU and class, 0 for no cache */
+#ifndef XIL_BLOCKPOOL_CACHE_SIZE
+#define XIL_BLOCKPOOL_CACHE_SIZE	0U
+#endif
+
+/**************************** Type Definitions *******************************/
+
+/**
+ * Use of a size class.
+ */
+typedef struct {
+	u32 BlockSize;		/* Bytes per block */
+	u32 NumBlocks;		/* Blocks of the class */
+	u32 InUse;		/* Blocks allocated now */
+	u32 Cached;		/* Free blocks held in the CPU caches */
+	u32 HighWater;		/* Most blocks out of the shared stack */
+	u32 Allocs;		/* Blocks allocated, both CPUs */
+	u32 Frees;		/* Blocks freed, both CPUs */
+	u32 Failures;		/* Allocations that found no block */
+} Xil_BlockPoolStats;
+
+/**
+*@endcond
+*/
+
+/************************** Function Prototypes ******************************/
+
+s32 Xil_BlockPoolInitialize(UINTPTR BaseAddr, u32 Size);
+s32 Xil_BlockPoolAddClass(u32 BlockSize, u32 NumBlocks);
+u32 Xil_BlockPoolNumClasses(void);
+void *Xil_BlockPoolAlloc(u32 Size);
+void Xil_BlockPoolFree(void *BlockPtr);
+s32 Xil_BlockPoolGetStats(u32 Class, Xil_BlockPoolStats *StatsPtr);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* XIL_BLOCKPOOL_H */
+/**
+* @} End of "addtogroup a9_blockpool_apis".
+*/
@@ -28,6 +28,9 @@
 *		      APIs.
 * 6.8   aru  09/06/18 Removed compilation warnings for ARMCC toolchain.
 * 9.0   ml   03/03/23 Updated function prototypes.
+* 9.3   qm   10/14/26 Added the range maintenance thresholds.
+*       qm   10/14/26 Added Xil_DCacheSetSmp(). Removed the invalidate
+*                     threshold.
 * </pre>
 *
 ******************************************************************************/
@@ -41,6 +44,23 @@
 
 #include "xil_types.h"
 
+/**
+ * Ranges of this many bytes and more are flushed from the L1 Data cache by
+ * set/way, which takes about as long as a line walk over the cache size,
+ * unless Xil_DCacheSetSmp() tells that the other CPU runs.
+ */
+#ifndef XIL_L1_DCACHE_RANGE_THRESHOLD
+#define XIL_L1_DCACHE_RANGE_THRESHOLD	0x8000U
+#endif
+
+/**
+ * Ranges of this many bytes and more are flushed from the L2 cache by the
+ * PL310 background clean and invalidate by way.
+ */
+#ifndef XIL_L2_CACHE_RANGE_THRESHOLD
+#define XIL_L2_CACHE_RANGE_THRESHOLD	0x80000U
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -91,6 +111,7 @@ void Xil_DCacheInvalidate(void);
 void Xil_DCacheInvalidateRange(INTPTR adr, u32 len);
 void Xil_DCacheFlush(void);
 void Xil_DCacheFlushRange(INTPTR adr, u32 len);
+void Xil_DCacheSetSmp(u32 Smp);
 
 void Xil_ICacheEnable(void);
 void Xil_ICacheDisable(void);
@@ -0,0 +1,164 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_devwindow.c
+*
+* This file provides the device register windows. Refer to xil_devwindow.h
+* for more details.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+* @note
+*
+* Only sections mapped as strongly ordered or device memory are remapped,
+* so that a wrong address cannot turn DDR or OCM into device memory.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xil_mmu.h"
+#include "xparameters.h"
+#include "xil_devwindow.h"
+
+/************************** Constant Definitions *****************************/
+
+#define XIL_DEVWINDOW_ATTR_MASK		0x000FFFFFU	/* Section attributes */
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+
+static s32 Xil_DevWindowSet(UINTPTR BaseAddr, u32 Size, u32 Attrib);
+
+/************************** Variable Definitions *****************************/
+
+/* Translation table of the BSP, one word per section */
+extern u32 MMUTable[];
+
+/*****************************************************************************/
+/**
+* @brief	Maps the sections of a peripheral as device memory.
+*
+* @param	BaseAddr is the start of the peripheral window.
+* @param	Size is its size in bytes. Every section it touches is
+*			mapped.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM if a section is not mapped
+*			as a peripheral.
+*
+* @note		The whole D-cache is flushed, as for any mapping change.
+*
+******************************************************************************/
+s32 Xil_DevWindowMap(UINTPTR BaseAddr, u32 Size)
+{
+	return Xil_DevWindowSet(BaseAddr, Size, DEVICE_MEMORY);
+}
+
+/*****************************************************************************/
+/**
+* @brief	Maps the sections of a peripheral back to strongly ordered.
+*
+* @param	BaseAddr is the start of the peripheral window.
+* @param	Size is its size in bytes.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM if a section is not mapped
+*			as a peripheral.
+*
+******************************************************************************/
+s32 Xil_DevWindowRestore(UINTPTR BaseAddr, u32 Size)
+{
+	return Xil_DevWindowSet(BaseAddr, Size, STRONG_ORDERED);
+}
+
+/*****************************************************************************/
+/**
+* @brief	Maps the AXI BRAM controllers of the design as device memory.
+*
+* @return	The number of windows mapped.
+*
+******************************************************************************/
+u32 Xil_DevWindowMapDefaults(void)
+{
+	u32 Count = 0U;
+
+#if defined (XPAR_XBRAM_0_BASEADDR)
+	if (Xil_DevWindowMap(XPAR_XBRAM_0_BASEADDR,
+			     (XPAR_XBRAM_0_HIGHADDR - XPAR_XBRAM_0_BASEADDR) +
+			     1U) == XST_SUCCESS) {
+		Count++;
+	}
+#endif
+#if defined (XPAR_XBRAM_1_BASEADDR)
+	if (Xil_DevWindowMap(XPAR_XBRAM_1_BASEADDR,
+			     (XPAR_XBRAM_1_HIGHADDR - XPAR_XBRAM_1_BASEADDR) +
+			     1U) == XST_SUCCESS) {
+		Count++;
+	}
+#endif
+
+	return Count;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Checks that the sections of a window are mapped as a peripheral
+*			and maps them with an attribute.
+*
+* @param	BaseAddr is the start of the window.
+* @param	Size is its size in bytes.
+* @param	Attrib is DEVICE_MEMORY or STRONG_ORDERED.
+*
+* @return	XST_SUCCESS or XST_INVALID_PARAM.
+*
+******************************************************************************/
+static s32 Xil_DevWindowSet(UINTPTR BaseAddr, u32 Size, u32 Attrib)
+{
+	u32 Section;
+	u32 Last;
+	u32 Attr;
+
+	if ((Size == 0U) || ((Size - 1U) > (0xFFFFFFFFU - (u32)BaseAddr))) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	Last = ((u32)BaseAddr + (Size - 1U)) / XIL_DEVWINDOW_SECTION_SIZE;
+	for (Section = (u32)BaseAddr / XIL_DEVWINDOW_SECTION_SIZE;
+	     Section <= Last; Section++) {
+		Attr = MMUTable[Section] & XIL_DEVWINDOW_ATTR_MASK;
+		if ((Attr != STRONG_ORDERED) && (Attr != DEVICE_MEMORY)) {
+			return (s32)XST_INVALID_PARAM;
+		}
+	}
+
+	Xil_SetTlbAttributesRange((INTPTR)BaseAddr, Size, Attrib);
+
+	return (s32)XST_SUCCESS;
+}
+
+#if defined (XIL_DEVICE_WINDOWS)
+/*****************************************************************************/
+/**
+* @brief	Maps the default device windows at startup.
+*
+* @return	None.
+*
+******************************************************************************/
+void __attribute__ ((constructor)) Xil_DevWindowInit(void)
+{
+	(void)Xil_DevWindowMapDefaults();
+}
+#endif
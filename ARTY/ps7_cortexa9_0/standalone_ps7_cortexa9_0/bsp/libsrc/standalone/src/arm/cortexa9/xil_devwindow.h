@@ -0,0 +1,85 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_devwindow.h
+*
+* @addtogroup a9_devwindow_apis Cortex A9 Device Register Window Functions
+*
+* The translation table maps the PL, 0x40000000 to 0xBFFFFFFF, as strongly
+* ordered: every Xil_Out32() to an AXI peripheral waits for its write
+* response before the next access. A device window is the 1 MB sections of
+* a peripheral remapped as device memory, whose writes are posted in the
+* store buffer, so that a burst of FIFO or BRAM writes goes out back to
+* back. The PS peripherals, the UARTs included, are device memory already.
+*
+* Device accesses to the same peripheral stay in program order, which is
+* all most drivers rely on. Ordering against another peripheral or another
+* master is not kept: Xil_DevWindowSync() is to be called between writes
+* to a window and telling anyone else about them, such as starting a DMA
+* that reads the BRAM. A read back of the last register written also
+* waits for the write, as DfxMgr_DecoupleWrite() does. Device memory takes
+* no unaligned accesses and no exclusive accesses, so a window holding
+* data, such as a BRAM arena, is only accessed with aligned loads and
+* stores, as Xil_MemCpy() does.
+*
+* Xil_DevWindowMap() maps a window and Xil_DevWindowRestore() maps it back
+* to strongly ordered. Xil_DevWindowMapDefaults() maps the windows of the
+* AXI BRAM controllers of the design; building the BSP with
+* XIL_DEVICE_WINDOWS defined maps them at startup.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/**
+*@cond nocomments
+*/
+
+#ifndef XIL_DEVWINDOW_H
+#define XIL_DEVWINDOW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+#include "xpseudo_asm.h"
+
+/************************** Constant Definitions *****************************/
+
+#define XIL_DEVWINDOW_SECTION_SIZE	0x100000U	/* MMU section */
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/* Waits for the writes posted to the device windows */
+#define Xil_DevWindowSync()	dsb()
+
+/**
+*@endcond
+*/
+
+/************************** Function Prototypes ******************************/
+
+s32 Xil_DevWindowMap(UINTPTR BaseAddr, u32 Size);
+s32 Xil_DevWindowRestore(UINTPTR BaseAddr, u32 Size);
+u32 Xil_DevWindowMapDefaults(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* XIL_DEVWINDOW_H */
+/**
+* @} End of "addtogroup a9_devwindow_apis".
+*/
@@ -0,0 +1,224 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_dmabuf.c
+*
+* This file tracks the cache state of the DMA buffers so that their cache
+* maintenance is done once per transition and only over the lines touched.
+* Refer to xil_dmabuf.h for more details.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+#include "xil_assert.h"
+#include "xstatus.h"
+#include "xil_cache.h"
+#include "xil_dmaarena.h"
+#include "xil_dmabuf.h"
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+#define XIL_DMABUF_DOWN(x)	((x) & ~(XIL_DMABUF_LINE - 1U))
+#define XIL_DMABUF_UP(x)	XIL_DMABUF_DOWN((x) + XIL_DMABUF_LINE - 1U)
+
+/************************** Function Prototypes ******************************/
+
+static void Xil_DmaBufClean(Xil_DmaBuf *BufPtr);
+
+/*****************************************************************************/
+/**
+* @brief	Describes a DMA buffer, all of it dirty.
+*
+* @param	BufPtr is the buffer descriptor to set up.
+* @param	Addr is the start of the buffer, on a cache line.
+* @param	Size is the size of the buffer, a multiple of a cache line.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM if the buffer is empty or
+*			not made of whole cache lines.
+*
+******************************************************************************/
+s32 Xil_DmaBufInit(Xil_DmaBuf *BufPtr, UINTPTR Addr, u32 Size)
+{
+	Xil_AssertNonvoid(BufPtr != NULL);
+
+	if ((Size == 0U) || ((Addr & (XIL_DMABUF_LINE - 1U)) != 0U) ||
+	    ((Size & (XIL_DMABUF_LINE - 1U)) != 0U)) {
+		return XST_INVALID_PARAM;
+	}
+
+	BufPtr->Addr = Addr;
+	BufPtr->Size = Size;
+	BufPtr->State = XIL_DMABUF_CPU_DIRTY;
+	BufPtr->DirtyStart = 0U;
+	BufPtr->DirtyEnd = Size;
+	BufPtr->Coherent = Xil_DmaArenaContains(Addr, Size);
+	BufPtr->Stats.Flushes = 0U;
+	BufPtr->Stats.Invalidates = 0U;
+	BufPtr->Stats.Skipped = 0U;
+	BufPtr->Stats.Bytes = 0U;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Notes bytes the CPU wrote into a buffer it owns.
+*
+* @param	BufPtr is the buffer.
+* @param	Offset is the offset of the first byte written.
+* @param	Len is the number of bytes written.
+*
+* @return	XST_SUCCESS, XST_INVALID_PARAM if the bytes are not all in
+*			the buffer, or XST_DEVICE_BUSY if a master owns it.
+*
+******************************************************************************/
+s32 Xil_DmaBufCpuWrite(Xil_DmaBuf *BufPtr, u32 Offset, u32 Len)
+{
+	u32 Start;
+	u32 End;
+
+	Xil_AssertNonvoid(BufPtr != NULL);
+
+	if ((Offset > BufPtr->Size) || (Len > (BufPtr->Size - Offset))) {
+		return XST_INVALID_PARAM;
+	}
+	if (BufPtr->State == XIL_DMABUF_DEVICE) {
+		return XST_DEVICE_BUSY;
+	}
+	if (Len == 0U) {
+		return XST_SUCCESS;
+	}
+
+	Start = XIL_DMABUF_DOWN(Offset);
+	End = XIL_DMABUF_UP(Offset + Len);
+
+	if (BufPtr->State == XIL_DMABUF_CLEAN) {
+		BufPtr->DirtyStart = Start;
+		BufPtr->DirtyEnd = End;
+		BufPtr->State = XIL_DMABUF_CPU_DIRTY;
+	} else {
+		if (Start < BufPtr->DirtyStart) {
+			BufPtr->DirtyStart = Start;
+		}
+		if (End > BufPtr->DirtyEnd) {
+			BufPtr->DirtyEnd = End;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Hands a buffer to a master, cleaning its dirty lines if any.
+*
+* @param	BufPtr is the buffer.
+* @param	Dir is XIL_DMABUF_TO_DEVICE when the master reads it, the
+*			buffer staying the CPU's, or XIL_DMABUF_FROM_DEVICE when
+*			it writes it, the buffer becoming the master's.
+*
+* @return	XST_SUCCESS, or XST_DEVICE_BUSY if a master owns it already.
+*
+******************************************************************************/
+s32 Xil_DmaBufToDevice(Xil_DmaBuf *BufPtr, u32 Dir)
+{
+	Xil_AssertNonvoid(BufPtr != NULL);
+	Xil_AssertNonvoid((Dir == XIL_DMABUF_TO_DEVICE) ||
+			  (Dir == XIL_DMABUF_FROM_DEVICE));
+
+	if (BufPtr->State == XIL_DMABUF_DEVICE) {
+		return XST_DEVICE_BUSY;
+	}
+
+	if (BufPtr->State == XIL_DMABUF_CPU_DIRTY) {
+		Xil_DmaBufClean(BufPtr);
+	} else {
+		BufPtr->Stats.Skipped++;
+	}
+
+	if (Dir == XIL_DMABUF_FROM_DEVICE) {
+		BufPtr->State = XIL_DMABUF_DEVICE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Takes a buffer back from a master that wrote into it, and
+*		invalidates the lines written.
+*
+* @param	BufPtr is the buffer.
+* @param	Offset is the offset of the first byte the master wrote.
+* @param	Len is the number of bytes it wrote, 0 for none.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM if the bytes are not all in
+*			the buffer or no master owns it.
+*
+* @note		Lines the CPU may have fetched speculatively while the master
+*		owned the buffer are dropped over the range written, so that
+*		the CPU reads what the master wrote.
+*
+******************************************************************************/
+s32 Xil_DmaBufFromDevice(Xil_DmaBuf *BufPtr, u32 Offset, u32 Len)
+{
+	u32 Start;
+	u32 End;
+
+	Xil_AssertNonvoid(BufPtr != NULL);
+
+	if ((BufPtr->State != XIL_DMABUF_DEVICE) || (Offset > BufPtr->Size) ||
+	    (Len > (BufPtr->Size - Offset))) {
+		return XST_INVALID_PARAM;
+	}
+
+	BufPtr->State = XIL_DMABUF_CLEAN;
+
+	if ((Len == 0U) || (BufPtr->Coherent != 0U)) {
+		BufPtr->Stats.Skipped++;
+		return XST_SUCCESS;
+	}
+
+	/* The buffer is made of whole lines, so are the rounded bytes */
+	Start = XIL_DMABUF_DOWN(Offset);
+	End = XIL_DMABUF_UP(Offset + Len);
+	Xil_DCacheInvalidateRange((INTPTR)(BufPtr->Addr + Start), End - Start);
+	BufPtr->Stats.Invalidates++;
+	BufPtr->Stats.Bytes += End - Start;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/*
+* Cleans the dirty range of a buffer and marks it clean.
+*
+******************************************************************************/
+static void Xil_DmaBufClean(Xil_DmaBuf *BufPtr)
+{
+	u32 Len = BufPtr->DirtyEnd - BufPtr->DirtyStart;
+
+	BufPtr->State = XIL_DMABUF_CLEAN;
+
+	if (BufPtr->Coherent != 0U) {
+		BufPtr->Stats.Skipped++;
+		return;
+	}
+
+	Xil_DCacheFlushRange((INTPTR)(BufPtr->Addr + BufPtr->DirtyStart), Len);
+	BufPtr->Stats.Flushes++;
+	BufPtr->Stats.Bytes += Len;
+}
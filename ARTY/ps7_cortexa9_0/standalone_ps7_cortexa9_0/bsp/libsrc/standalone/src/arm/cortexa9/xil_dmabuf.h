@@ -0,0 +1,123 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_dmabuf.h
+*
+* @addtogroup a9_dmabuf_apis Cortex A9 DMA Buffer Cache State Functions
+*
+* A Xil_DmaBuf describes a cacheable buffer handed back and forth between
+* the CPU and a DMA master, and keeps the state of its lines in the Data
+* caches, so that the cache is only cleaned or invalidated when the state
+* really changes, and only over the lines the CPU or the master touched:
+*
+*	- XIL_DMABUF_CPU_DIRTY: the CPU wrote the lines from DirtyStart up to
+*	  DirtyEnd, which may be dirty in the caches. Xil_DmaBufCpuWrite()
+*	  widens the range over the bytes the CPU writes.
+*	- XIL_DMABUF_CLEAN: the caches hold nothing the memory does not, a
+*	  master may read the buffer as it is.
+*	- XIL_DMABUF_DEVICE: a master owns the buffer to write into it; the
+*	  CPU must not touch it until Xil_DmaBufFromDevice() gives it back.
+*
+* Xil_DmaBufToDevice() hands the buffer to a master. For a read by the
+* master, XIL_DMABUF_TO_DEVICE, it cleans the dirty range if any and
+* leaves the buffer clean: the same buffer sent again, or a header written
+* again in a sent buffer, costs nothing or a line or two instead of the
+* whole buffer. For a write by the master, XIL_DMABUF_FROM_DEVICE, the
+* dirty range is cleaned too, that no dirty line is evicted over what the
+* master writes, and the buffer becomes the master's. Xil_DmaBufFromDevice()
+* takes it back and invalidates the bytes the master wrote, not the whole
+* buffer.
+*
+* A buffer in the DMA arena of xil_dmaarena.h, not cached, goes through the
+* same states with no cache maintenance at all, so that a driver does not
+* need to know where its buffers are.
+*
+* The buffer must start and end on a cache line. A Xil_DmaBuf is owned by
+* one context at a time, the CPU or the completion of the master, and is
+* not locked.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/**
+*@cond nocomments
+*/
+
+#ifndef XIL_DMABUF_H
+#define XIL_DMABUF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+#define XIL_DMABUF_LINE		32U	/* Cache line */
+
+/* States */
+#define XIL_DMABUF_CLEAN	0U
+#define XIL_DMABUF_CPU_DIRTY	1U
+#define XIL_DMABUF_DEVICE	2U
+
+/* Directions of Xil_DmaBufToDevice() */
+#define XIL_DMABUF_TO_DEVICE	0U	/* The master reads the buffer */
+#define XIL_DMABUF_FROM_DEVICE	1U	/* The master writes the buffer */
+
+/**************************** Type Definitions *******************************/
+
+/**
+ * Counts of a buffer.
+ */
+typedef struct {
+	u32 Flushes;		/* Cleans done */
+	u32 Invalidates;	/* Invalidations done */
+	u32 Skipped;		/* Transitions with nothing to do */
+	u64 Bytes;		/* Cleaned or invalidated */
+} Xil_DmaBufStats;
+
+/**
+ * A DMA buffer and the state of its lines.
+ */
+typedef struct {
+	UINTPTR Addr;		/* First byte, on a cache line */
+	u32 Size;		/* Bytes, a cache line multiple */
+	u32 State;		/* XIL_DMABUF_* state */
+	u32 DirtyStart;		/* Dirty lines, offsets on cache lines */
+	u32 DirtyEnd;
+	u32 Coherent;		/* In the DMA arena, never maintained */
+	Xil_DmaBufStats Stats;
+} Xil_DmaBuf;
+
+/**
+*@endcond
+*/
+
+/************************** Function Prototypes ******************************/
+
+s32 Xil_DmaBufInit(Xil_DmaBuf *BufPtr, UINTPTR Addr, u32 Size);
+s32 Xil_DmaBufCpuWrite(Xil_DmaBuf *BufPtr, u32 Offset, u32 Len);
+s32 Xil_DmaBufToDevice(Xil_DmaBuf *BufPtr, u32 Dir);
+s32 Xil_DmaBufFromDevice(Xil_DmaBuf *BufPtr, u32 Offset, u32 Len);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* XIL_DMABUF_H */
+/**
+* @} End of "addtogroup a9_dmabuf_apis".
+*/
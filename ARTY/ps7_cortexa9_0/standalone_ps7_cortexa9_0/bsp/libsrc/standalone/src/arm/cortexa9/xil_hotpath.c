@@ -0,0 +1,450 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_hotpath.c
+*
+* This file places the interrupt hot path in the OCM or locks it into the
+* L2 cache, and loads the fast sections and the overlays of the low OCM.
+* Refer to xil_hotpath.h for more details.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+*       qm   10/14/26 Added the fast sections of the low OCM and the
+*                     overlays.
+*       qm   10/14/26 Added Xil_OcmRemapHigh() and Xil_OcmLowBase().
+*       qm   10/14/26 VBAR is set to the OCM vector table of
+*                     XIL_OCM_VECTORS once the OCM is loaded.
+* </pre>
+*
+* @note
+*
+* The section symbols are weak, so that a linker script without the .ocm,
+* .l2_lock, .ocm_fast or overlay sections leaves nothing to do, and one
+* without __ocm_high leaves the OCM where it is. So is _ocm_vector_table, of
+* asm_vectors.S built with XIL_OCM_VECTORS.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xil_io.h"
+#include "xil_mem.h"
+#include "xil_cache.h"
+#include "xpseudo_asm.h"
+#include "xparameters.h"
+#include "xreg_cortexa9.h"
+#include "xl2cc.h"
+#include "xil_errata.h"
+#include "xil_misc_psreset_api.h"
+#include "xil_hotpath.h"
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/**************************** Type Definitions *******************************/
+
+/************************** Constant Definitions *****************************/
+
+#define IRQ_FIQ_MASK 0xC0U	/**< Mask IRQ and FIQ interrupts in cpsr */
+#define XIL_HOTPATH_CACHELINE	32U
+#define XIL_HOTPATH_ALL_WAYS	0xFFU
+/* One D and one I lockdown register per master, 8 bytes apart */
+#define XIL_HOTPATH_NUM_LCKDWN	8U
+#define XIL_HOTPATH_LCKDWN_STEP	8U
+
+#define XIL_OCM_SLCR_LOCK_ADDR	(XSLCR_BASEADDR + 0x00000004U)
+#define XIL_OCM_SLCR_LOCK_CODE	0x0000767BU
+/* SCU address filtering start, below it the CPUs reach the OCM, not DDR */
+#define XIL_OCM_SCU_FILTER_START (XPS_SCU_PERIPH_BASE + 0x00000040U)
+#define XIL_OCM_BANK0_HIGH	0x00000001U	/* RAM_HI bit of bank 0 */
+
+/************************** Variable Definitions *****************************/
+
+#ifdef __GNUC__
+extern u8 __ocm_start[] __attribute__((weak));
+extern u8 __ocm_end[] __attribute__((weak));
+extern u8 __ocm_load_start[] __attribute__((weak));
+/* Set to 1 by a linker script that links the OCM sections at 0xFFFC0000 */
+extern u8 __ocm_high[] __attribute__((weak));
+/* Vector table in the .ocm section, asm_vectors.S */
+extern u8 _ocm_vector_table[] __attribute__((weak));
+extern u8 __l2_lock_start[] __attribute__((weak));
+extern u8 __l2_lock_end[] __attribute__((weak));
+extern u8 __ocm_fast_start[] __attribute__((weak));
+extern u8 __ocm_fast_end[] __attribute__((weak));
+extern u8 __ocm_fast_load_start[] __attribute__((weak));
+extern u8 __ocm_fast_bss_start[] __attribute__((weak));
+extern u8 __ocm_fast_bss_end[] __attribute__((weak));
+extern u8 __overlay_window[] __attribute__((weak));
+/* Load images of the overlays, defined by the OVERLAY of the linker script */
+extern u8 __load_start_ovl0[] __attribute__((weak));
+extern u8 __load_stop_ovl0[] __attribute__((weak));
+extern u8 __load_start_ovl1[] __attribute__((weak));
+extern u8 __load_stop_ovl1[] __attribute__((weak));
+extern u8 __load_start_ovl2[] __attribute__((weak));
+extern u8 __load_stop_ovl2[] __attribute__((weak));
+extern u8 __load_start_ovl3[] __attribute__((weak));
+extern u8 __load_stop_ovl3[] __attribute__((weak));
+
+static u8 *const Xil_OverlayImage[XIL_OVERLAY_MAX][2] = {
+	{ __load_start_ovl0, __load_stop_ovl0 },
+	{ __load_start_ovl1, __load_stop_ovl1 },
+	{ __load_start_ovl2, __load_stop_ovl2 },
+	{ __load_start_ovl3, __load_stop_ovl3 }
+};
+#endif
+
+/* Overlay in the window, XIL_OVERLAY_NONE until the first load */
+static u32 Xil_OverlayLoaded = XIL_OVERLAY_NONE;
+
+/************************** Function Prototypes ******************************/
+
+/*****************************************************************************/
+/**
+* @brief	Copies the .ocm section from its load address in DDR into the
+*			OCM, or locks the .l2_lock section into way
+*			XIL_HOTPATH_L2_WAY of the L2 cache, then copies the
+*			.ocm_fast section into the low OCM and clears the
+*			.ocm_fast_bss section. It is called by the startup code
+*			with the caches enabled, before main(). An image linked
+*			with all the OCM high has the OCM remapped first, with
+*			Xil_OcmRemapHigh(). The vectors of an image with the OCM
+*			vector table are taken from the OCM once it is loaded.
+*
+* @return	None.
+*
+******************************************************************************/
+void Xil_HotPathInitialize(void)
+{
+#ifdef __GNUC__
+	u32 Len = (u32)(__ocm_end - __ocm_start);
+
+	if ((UINTPTR)__ocm_high != 0U) {
+		Xil_OcmRemapHigh();
+	}
+
+	if (Len != 0U) {
+		Xil_MemCpy(__ocm_start, __ocm_load_start, Len);
+		/* Make the copied code visible to instruction fetches */
+		Xil_DCacheFlushRange((INTPTR)__ocm_start, Len);
+		Xil_ICacheInvalidateRange((INTPTR)__ocm_start, Len);
+		if ((UINTPTR)_ocm_vector_table != 0U) {
+			mtcp(XREG_CP15_VEC_BASE_ADDR,
+			     (UINTPTR)_ocm_vector_table);
+			isb();
+		}
+	}
+
+	Len = (u32)(__l2_lock_end - __l2_lock_start);
+	if (Len != 0U) {
+		(void)Xil_HotPathL2Lock((UINTPTR)__l2_lock_start, Len,
+					XIL_HOTPATH_L2_WAY);
+	}
+
+	Len = (u32)(__ocm_fast_end - __ocm_fast_start);
+	if (Len != 0U) {
+		Xil_MemCpy(__ocm_fast_start, __ocm_fast_load_start, Len);
+		Xil_DCacheFlushRange((INTPTR)__ocm_fast_start, Len);
+		Xil_ICacheInvalidateRange((INTPTR)__ocm_fast_start, Len);
+	}
+
+	Len = (u32)(__ocm_fast_bss_end - __ocm_fast_bss_start);
+	if (Len != 0U) {
+		Xil_MemSet(__ocm_fast_bss_start, 0U, Len);
+	}
+#endif
+}
+
+/*****************************************************************************/
+/**
+* @brief	Maps the three low OCM banks at 0xFFFC0000, below the fourth,
+*			so that the OCM is one block of 256 KB at the top of the
+*			address space, and moves the start of the SCU address
+*			filtering to 0, so that the CPUs reach the DDR from address
+*			0 on instead of the OCM.
+*
+* @return	None.
+*
+* @note		Nothing may be running from or using the low OCM, and CPU1
+*			must still be in the boot ROM or running from DDR. The first
+*			512 KB of DDR, now at address 0, are reached by the CPUs
+*			only, not by the DMA masters or the PL. The lines the caches
+*			hold of the low OCM are invalidated.
+*
+******************************************************************************/
+void Xil_OcmRemapHigh(void)
+{
+	u32 RegVal;
+
+	dsb();
+
+	Xil_Out32(XSLCR_UNLOCK_ADDR, XSLCR_UNLOCK_CODE);
+	RegVal = Xil_In32(XSLCR_OCM_CFG_ADDR);
+	Xil_Out32(XSLCR_OCM_CFG_ADDR, RegVal | XSLCR_OCM_CFG_HIADDR_MASK);
+	Xil_Out32(XIL_OCM_SLCR_LOCK_ADDR, XIL_OCM_SLCR_LOCK_CODE);
+
+	Xil_Out32(XIL_OCM_SCU_FILTER_START, 0x00000000U);
+	dsb();
+	isb();
+
+	/* The first MB is DDR now, nothing cached of it may be kept */
+	Xil_DCacheInvalidateRange((INTPTR)XIL_OCM_LOW_BASEADDR,
+				  XIL_OCM_LOW_SIZE);
+}
+
+/*****************************************************************************/
+/**
+* @brief	Returns where the three low OCM banks are mapped.
+*
+* @return	XIL_OCM_HIGH_BASEADDR once Xil_OcmRemapHigh() has run, or
+*			the boot ROM or the FSBL left them high, XIL_OCM_LOW_BASEADDR
+*			otherwise.
+*
+******************************************************************************/
+UINTPTR Xil_OcmLowBase(void)
+{
+	if ((Xil_In32(XSLCR_OCM_CFG_ADDR) & XIL_OCM_BANK0_HIGH) != 0U) {
+		return (UINTPTR)XIL_OCM_HIGH_BASEADDR;
+	}
+
+	return (UINTPTR)XIL_OCM_LOW_BASEADDR;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Copies an overlay from its load address in DDR into the
+*			overlay window, replacing the one loaded before.
+*
+* @param	Id is the overlay, below XIL_OVERLAY_MAX.
+*
+* @return
+*		- XST_SUCCESS if the overlay is loaded, or was already.
+*		- XST_INVALID_PARAM if the overlay is out of range.
+*
+* @note		No function of the overlay replaced may be running, or be
+*			called meanwhile from an interrupt handler. An empty
+*			overlay is loaded without copying anything.
+*
+******************************************************************************/
+s32 Xil_OverlayLoad(u32 Id)
+{
+#ifdef __GNUC__
+	u32 Len;
+#endif
+
+	if (Id >= XIL_OVERLAY_MAX) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	if (Id == Xil_OverlayLoaded) {
+		return (s32)XST_SUCCESS;
+	}
+
+#ifdef __GNUC__
+	Len = (u32)(Xil_OverlayImage[Id][1] - Xil_OverlayImage[Id][0]);
+	if (Len != 0U) {
+		Xil_MemCpy(__overlay_window, Xil_OverlayImage[Id][0], Len);
+		Xil_DCacheFlushRange((INTPTR)__overlay_window, Len);
+		Xil_ICacheInvalidateRange((INTPTR)__overlay_window, Len);
+		/* The predictions may still be those of the overlay replaced */
+		mtcp(XREG_CP15_INVAL_BRANCH_ARRAY, 0U);
+		dsb();
+		isb();
+	}
+#endif
+
+	Xil_OverlayLoaded = Id;
+
+	return (s32)XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Returns the overlay in the overlay window.
+*
+* @return	The overlay loaded last by Xil_OverlayLoad(), or
+*			XIL_OVERLAY_NONE.
+*
+******************************************************************************/
+u32 Xil_OverlayCurrent(void)
+{
+	return Xil_OverlayLoaded;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Loads an address range into one way of the L2 cache and locks
+*			the way, so that the range keeps hitting in L2. The way is
+*			emptied first and no other line is allocated into it
+*			afterwards.
+*
+* @param	Addr is the start of the range.
+* @param	Len is the length of the range in bytes, up to the way size.
+* @param	Way is the way to be used, below XIL_HOTPATH_L2_NUM_WAYS.
+*
+* @return
+*		- XST_SUCCESS if the range is locked.
+*		- XST_INVALID_PARAM if the way is out of range or the range
+*		  larger than a way.
+*		- XST_NOT_ENABLED if the L2 cache is disabled or left to the
+*		  other CPU.
+*
+* @note		The loads that fill the way may bring in a few unrelated
+*			lines, such as stack lines evicted from L1 meanwhile.
+*
+******************************************************************************/
+s32 Xil_HotPathL2Lock(UINTPTR Addr, u32 Len, u32 Way)
+{
+#ifndef USE_AMP
+	u32 SavedD[XIL_HOTPATH_NUM_LCKDWN];
+	u32 SavedI[XIL_HOTPATH_NUM_LCKDWN];
+	u32 WayMask = (u32)1U << Way;
+	u32 WaySize;
+	u32 Field;
+	u32 NumLines;
+	u32 Offset;
+	u32 Index;
+	u32 currmask;
+	UINTPTR LineAddr;
+
+	if (Way >= XIL_HOTPATH_L2_NUM_WAYS) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	if ((Xil_In32(XPS_L2CC_BASEADDR + XPS_L2CC_CNTRL_OFFSET) &
+	     XPS_L2CC_ENABLE_MASK) == 0U) {
+		return (s32)XST_NOT_ENABLED;
+	}
+
+	/* 16 KB for the encodings 0 and 1, doubling up to 512 KB */
+	Field = (Xil_In32(XPS_L2CC_BASEADDR + XPS_L2CC_AUX_CNTRL_OFFSET) &
+		 XPS_L2CC_AUX_WAY_SIZE_MASK) >> 17U;
+	if (Field == 0U) {
+		Field = 1U;
+	} else if (Field > 6U) {
+		Field = 6U;
+	}
+	WaySize = (u32)0x2000U << Field;
+	if ((Len == 0U) ||
+	    (Len > (WaySize - (u32)(Addr & (XIL_HOTPATH_CACHELINE - 1U))))) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	currmask = mfcpsr();
+	mtcpsr(currmask | IRQ_FIQ_MASK);
+
+	/* Drop the range from L1 and from the other ways */
+	Xil_DCacheFlushRange((INTPTR)Addr, Len);
+
+	/* Empty the way */
+#ifdef CONFIG_PL310_ERRATA_588369
+	Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_DEBUG_CTRL_OFFSET, 0x3U);
+#endif
+	Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_CACHE_INV_CLN_WAY_OFFSET,
+		  WayMask);
+	while ((Xil_In32(XPS_L2CC_BASEADDR + XPS_L2CC_CACHE_INV_CLN_WAY_OFFSET) &
+		WayMask) != 0U) {
+		;
+	}
+	Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_CACHE_SYNC_OFFSET, 0x0U);
+#ifdef CONFIG_PL310_ERRATA_588369
+	Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_DEBUG_CTRL_OFFSET, 0x0U);
+#endif
+
+	/*
+	 * Data fills may only go to the way, instruction fetches may not, so
+	 * that the code of this loop stays out of it.
+	 */
+	for (Index = 0U; Index < XIL_HOTPATH_NUM_LCKDWN; Index++) {
+		Offset = Index * XIL_HOTPATH_LCKDWN_STEP;
+		SavedD[Index] = Xil_In32(XPS_L2CC_BASEADDR + Offset +
+					 XPS_L2CC_CACHE_DLCKDWN_0_WAY_OFFSET);
+		SavedI[Index] = Xil_In32(XPS_L2CC_BASEADDR + Offset +
+					 XPS_L2CC_CACHE_ILCKDWN_0_WAY_OFFSET);
+		Xil_Out32(XPS_L2CC_BASEADDR + Offset +
+			  XPS_L2CC_CACHE_DLCKDWN_0_WAY_OFFSET,
+			  XIL_HOTPATH_ALL_WAYS & ~WayMask);
+		Xil_Out32(XPS_L2CC_BASEADDR + Offset +
+			  XPS_L2CC_CACHE_ILCKDWN_0_WAY_OFFSET,
+			  SavedI[Index] | WayMask);
+	}
+	dsb();
+
+	LineAddr = Addr & ~(UINTPTR)(XIL_HOTPATH_CACHELINE - 1U);
+	NumLines = ((u32)(Addr - LineAddr) + Len +
+		    (XIL_HOTPATH_CACHELINE - 1U)) / XIL_HOTPATH_CACHELINE;
+	for (Index = 0U; Index < NumLines; Index++) {
+		(void)Xil_In32(LineAddr);
+		LineAddr += XIL_HOTPATH_CACHELINE;
+	}
+	dsb();
+
+	/* Lock the way for everybody */
+	for (Index = 0U; Index < XIL_HOTPATH_NUM_LCKDWN; Index++) {
+		Offset = Index * XIL_HOTPATH_LCKDWN_STEP;
+		Xil_Out32(XPS_L2CC_BASEADDR + Offset +
+			  XPS_L2CC_CACHE_DLCKDWN_0_WAY_OFFSET,
+			  SavedD[Index] | WayMask);
+		Xil_Out32(XPS_L2CC_BASEADDR + Offset +
+			  XPS_L2CC_CACHE_ILCKDWN_0_WAY_OFFSET,
+			  SavedI[Index] | WayMask);
+	}
+	Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_CACHE_SYNC_OFFSET, 0x0U);
+	dsb();
+
+	mtcpsr(currmask);
+
+	return (s32)XST_SUCCESS;
+#else
+	(void)Addr;
+	(void)Len;
+	(void)Way;
+
+	return (s32)XST_NOT_ENABLED;
+#endif
+}
+
+/*****************************************************************************/
+/**
+* @brief	Unlocks a way of the L2 cache locked by Xil_HotPathL2Lock().
+*			Its lines stay in the cache until they are replaced.
+*
+* @param	Way is the way to be unlocked.
+*
+* @return	None.
+*
+******************************************************************************/
+void Xil_HotPathL2Unlock(u32 Way)
+{
+#ifndef USE_AMP
+	u32 WayMask = (u32)1U << Way;
+	u32 Offset;
+	u32 Index;
+
+	if (Way >= XIL_HOTPATH_L2_NUM_WAYS) {
+		return;
+	}
+
+	for (Index = 0U; Index < XIL_HOTPATH_NUM_LCKDWN; Index++) {
+		Offset = (Index * XIL_HOTPATH_LCKDWN_STEP) +
+			 XPS_L2CC_CACHE_DLCKDWN_0_WAY_OFFSET;
+		Xil_Out32(XPS_L2CC_BASEADDR + Offset,
+			  Xil_In32(XPS_L2CC_BASEADDR + Offset) & ~WayMask);
+		Offset = (Index * XIL_HOTPATH_LCKDWN_STEP) +
+			 XPS_L2CC_CACHE_ILCKDWN_0_WAY_OFFSET;
+		Xil_Out32(XPS_L2CC_BASEADDR + Offset,
+			  Xil_In32(XPS_L2CC_BASEADDR + Offset) & ~WayMask);
+	}
+	Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_CACHE_SYNC_OFFSET, 0x0U);
+#else
+	(void)Way;
+#endif
+}
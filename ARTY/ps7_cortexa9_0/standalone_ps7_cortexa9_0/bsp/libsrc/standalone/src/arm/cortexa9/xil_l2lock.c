@@ -0,0 +1,146 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_l2lock.c
+*
+* L2 way partitioning by master. Refer to xil_l2lock.h for how the ways are
+* given to the masters.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+* @note
+*
+* The PL310 takes a write of the lockdown registers at any time; the new
+* ways apply from the next allocation. The barriers keep the accesses before
+* the call on the old ways and those after it on the new ones.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+#include "xil_io.h"
+#include "xstatus.h"
+#include "xpseudo_asm.h"
+#include "xparameters_ps.h"
+#include "xl2cc.h"
+#include "xil_l2lock.h"
+
+/************************** Constant Definitions *****************************/
+
+/* The data and instruction registers of a master are 8 bytes apart */
+#define XIL_L2_LOCK_STRIDE		8U
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+#define XIL_L2_DLOCK_ADDR(Master)	(XPS_L2CC_BASEADDR + \
+		XPS_L2CC_CACHE_DLCKDWN_0_WAY_OFFSET + \
+		((Master) * XIL_L2_LOCK_STRIDE))
+#define XIL_L2_ILOCK_ADDR(Master)	(XPS_L2CC_BASEADDR + \
+		XPS_L2CC_CACHE_ILCKDWN_0_WAY_OFFSET + \
+		((Master) * XIL_L2_LOCK_STRIDE))
+
+/************************** Function Prototypes ******************************/
+
+/************************** Variable Definitions *****************************/
+
+/*****************************************************************************/
+/**
+*
+* @brief	Gives the number of ways of the L2.
+*
+* @return	8 or 16, from the associativity of the Auxiliary Control
+*		Register.
+*
+******************************************************************************/
+u32 Xil_L2LockNumWays(void)
+{
+	u32 Aux = Xil_In32(XPS_L2CC_BASEADDR + XPS_L2CC_AUX_CNTRL_OFFSET);
+
+	return ((Aux & XPS_L2CC_AUX_ASSOC_MASK) != 0U) ? 16U : 8U;
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Sets the ways a master allocates into, locking the others for
+*		it.
+*
+* @param	Master is the master, XIL_L2_MASTER_CPU0 or XIL_L2_MASTER_CPU1
+*		for the CPUs.
+* @param	DataWays is the mask of the ways of its data misses, bit n
+*		for way n.
+* @param	InstrWays is the mask of the ways of its instruction misses.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM for an unknown master, a
+*		mask with no way or a way the L2 does not have.
+*
+******************************************************************************/
+s32 Xil_L2LockSetMaster(u32 Master, u32 DataWays, u32 InstrWays)
+{
+	u32 AllWays = (1U << Xil_L2LockNumWays()) - 1U;
+
+	if ((Master >= XIL_L2_NUM_MASTERS) ||
+	    (DataWays == 0U) || ((DataWays & ~AllWays) != 0U) ||
+	    (InstrWays == 0U) || ((InstrWays & ~AllWays) != 0U)) {
+		return XST_INVALID_PARAM;
+	}
+
+	dsb();
+	Xil_Out32(XIL_L2_DLOCK_ADDR(Master), ~DataWays & AllWays);
+	Xil_Out32(XIL_L2_ILOCK_ADDR(Master), ~InstrWays & AllWays);
+	dsb();
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Reads the ways a master allocates into.
+*
+* @param	Master is the master, below XIL_L2_NUM_MASTERS.
+* @param	DataWaysPtr receives the mask of its data ways.
+* @param	InstrWaysPtr receives the mask of its instruction ways.
+*
+* @return	None.
+*
+******************************************************************************/
+void Xil_L2LockGetMaster(u32 Master, u32 *DataWaysPtr, u32 *InstrWaysPtr)
+{
+	u32 AllWays = (1U << Xil_L2LockNumWays()) - 1U;
+
+	*DataWaysPtr = ~Xil_In32(XIL_L2_DLOCK_ADDR(Master)) & AllWays;
+	*InstrWaysPtr = ~Xil_In32(XIL_L2_ILOCK_ADDR(Master)) & AllWays;
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Gives all the ways back to all the masters, as after reset.
+*
+* @return	None.
+*
+******************************************************************************/
+void Xil_L2LockClear(void)
+{
+	u32 Master;
+
+	dsb();
+	for (Master = 0U; Master < XIL_L2_NUM_MASTERS; Master++) {
+		Xil_Out32(XIL_L2_DLOCK_ADDR(Master), 0U);
+		Xil_Out32(XIL_L2_ILOCK_ADDR(Master), 0U);
+	}
+	dsb();
+}
@@ -0,0 +1,79 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_l2lock.h
+*
+* @addtogroup a9_l2lock_apis Cortex A9 L2 Way Lockdown Functions
+*
+* Partitions the ways of the PL310 between the masters of the L2, with the
+* lockdown by master registers.
+*
+* The PL310 keeps a data and an instruction lockdown register per master,
+* the CPUs being masters 0 and 1. A way locked for a master is not
+* allocated into on its misses: Xil_L2LockSetMaster() takes the ways a
+* master may allocate into, and locks the others. Lookups still hit in all
+* the ways, so the data shared by the CPUs stays coherent whichever way it
+* sits in; only where new lines go changes. Giving the two CPUs disjoint
+* ways keeps a core that streams through memory from evicting the working
+* set of the other, at the cost of the L2 size each of them sees.
+*
+* Lines already in the ways of another master stay until they are evicted
+* from there. The L2 has 8 ways of 64 KB on the Zynq-7000, so a way is
+* 1/8 of the 512 KB.
+*
+* The lockdown registers are secure registers of the PL310. With USE_AMP
+* the CPU that owns the L2 programs them for both.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/**
+*@cond nocomments
+*/
+
+#ifndef XIL_L2LOCK_H
+#define XIL_L2LOCK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+#define XIL_L2_NUM_MASTERS	8U	/* Lockdown register pairs */
+#define XIL_L2_MASTER_CPU0	0U
+#define XIL_L2_MASTER_CPU1	1U
+
+/**
+*@endcond
+*/
+
+/************************** Function Prototypes ******************************/
+
+u32 Xil_L2LockNumWays(void);
+s32 Xil_L2LockSetMaster(u32 Master, u32 DataWays, u32 InstrWays);
+void Xil_L2LockGetMaster(u32 Master, u32 *DataWaysPtr, u32 *InstrWaysPtr);
+void Xil_L2LockClear(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* XIL_L2LOCK_H */
+/**
+* @} End of "addtogroup a9_l2lock_apis".
+*/
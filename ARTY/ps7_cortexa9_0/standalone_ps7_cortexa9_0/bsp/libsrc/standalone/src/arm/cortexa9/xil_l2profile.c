@@ -0,0 +1,309 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_l2profile.c
+*
+* This file contains the L2 performance profiles. Refer to xil_l2profile.h
+* for more details.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+* @note
+*
+* The prefetch enables of the Auxiliary Control Register are also in the
+* Prefetch Control Register, which is written with the L2 enabled; only the
+* early BRESP and full line of zero bits need the L2 disabled. Full line of
+* zero is turned on in the PL310 before the ACTLR and off in the reverse
+* order, so that the A9 never sends the command to a PL310 that does not
+* take it.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <string.h>
+#include "xil_types.h"
+#include "xil_io.h"
+#include "xstatus.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xparameters_ps.h"
+#include "xl2cc.h"
+#include "xil_cache_l.h"
+#include "xil_l2profile.h"
+
+/************************** Constant Definitions *****************************/
+
+/* PL310 Prefetch Control Register */
+#define XIL_L2_PREFETCH_CTRL_OFFSET	0x0F60U
+#define XIL_L2_PF_DOUBLE_LINEFILL	0x40000000U
+#define XIL_L2_PF_INSTR			0x20000000U
+#define XIL_L2_PF_DATA			0x10000000U
+#define XIL_L2_PF_INCR_DOUBLE		0x00800000U
+#define XIL_L2_PF_OFFSET_MASK		0x0000001FU
+#define XIL_L2_PF_MASK			(XIL_L2_PF_DOUBLE_LINEFILL | \
+					 XIL_L2_PF_INSTR | XIL_L2_PF_DATA | \
+					 XIL_L2_PF_INCR_DOUBLE | \
+					 XIL_L2_PF_OFFSET_MASK)
+
+/* PL310 Auxiliary Control Register */
+#define XIL_L2_AUX_EARLY_BRESP		0x40000000U
+#define XIL_L2_AUX_FULL_LINE_ZERO	0x00000001U
+#define XIL_L2_AUX_STATIC_MASK		(XIL_L2_AUX_EARLY_BRESP | \
+					 XIL_L2_AUX_FULL_LINE_ZERO)
+
+/* Cortex-A9 ACTLR */
+#define XIL_L2_ACTLR_FULL_LINE_ZERO	0x00000008U
+#define XIL_L2_ACTLR_L1_PREFETCH	0x00000004U
+#define XIL_L2_ACTLR_PREFETCH_HINT	0x00000002U
+#define XIL_L2_ACTLR_MASK		(XIL_L2_ACTLR_FULL_LINE_ZERO | \
+					 XIL_L2_ACTLR_L1_PREFETCH | \
+					 XIL_L2_ACTLR_PREFETCH_HINT)
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+
+/************************** Variable Definitions *****************************/
+
+static const Xil_L2Profile Xil_L2Profiles[XIL_L2_NUM_PROFILES] = {
+	{
+		"boot",
+		XIL_L2_DATA_PREFETCH | XIL_L2_INSTR_PREFETCH |
+		XIL_L2_EARLY_BRESP,
+		0U
+	},
+	{
+		"off",
+		0U,
+		0U
+	},
+	{
+		"stream",
+		XIL_L2_DATA_PREFETCH | XIL_L2_INSTR_PREFETCH |
+		XIL_L2_DOUBLE_LINEFILL | XIL_L2_EARLY_BRESP |
+		XIL_L2_FULL_LINE_ZERO | XIL_L2_L1_PREFETCH |
+		XIL_L2_PREFETCH_HINT,
+		7U
+	},
+	{
+		"random",
+		XIL_L2_INSTR_PREFETCH | XIL_L2_EARLY_BRESP |
+		XIL_L2_FULL_LINE_ZERO,
+		0U
+	},
+};
+
+/*****************************************************************************/
+/**
+*
+* @brief	Gives a profile of xil_l2profile.h.
+*
+* @param	Index is one of the XIL_L2_PROFILE_* values.
+*
+* @return	The profile, or NULL past the last one.
+*
+******************************************************************************/
+const Xil_L2Profile *Xil_L2ProfileGet(u32 Index)
+{
+	return (Index < XIL_L2_NUM_PROFILES) ? &Xil_L2Profiles[Index] : NULL;
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Finds a profile of xil_l2profile.h by name.
+*
+* @param	Name is the name, as "stream".
+*
+* @return	The profile, or NULL if there is none of that name.
+*
+******************************************************************************/
+const Xil_L2Profile *Xil_L2ProfileFind(const char *Name)
+{
+	u32 Index;
+
+	for (Index = 0U; Index < XIL_L2_NUM_PROFILES; Index++) {
+		if (strcmp(Xil_L2Profiles[Index].Name, Name) == 0) {
+			return &Xil_L2Profiles[Index];
+		}
+	}
+
+	return NULL;
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Applies a profile to the L2 and to the ACTLR of the calling
+*		CPU.
+*
+* @param	ProfilePtr is the profile, one of xil_l2profile.h, one read
+*		by Xil_L2ProfileRead() or one of the caller's.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM for an unsupported prefetch
+*		offset.
+*
+******************************************************************************/
+s32 Xil_L2ProfileApply(const Xil_L2Profile *ProfilePtr)
+{
+	u32 Flags = ProfilePtr->Flags;
+	u32 Offset = ProfilePtr->PrefetchOffset;
+	u32 Cpsr;
+	u32 Actlr;
+	u32 NewActlr;
+#ifndef USE_AMP
+	u32 Aux;
+	u32 NewAux;
+	u32 Control;
+	u32 Prefetch;
+#endif
+
+	if ((Offset > 7U) && (Offset != 15U) && (Offset != 23U) &&
+	    (Offset != 31U)) {
+		return XST_INVALID_PARAM;
+	}
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+
+	Actlr = mfcp(XREG_CP15_AUX_CONTROL);
+	NewActlr = Actlr & ~XIL_L2_ACTLR_MASK;
+	if ((Flags & XIL_L2_L1_PREFETCH) != 0U) {
+		NewActlr |= XIL_L2_ACTLR_L1_PREFETCH;
+	}
+	if ((Flags & XIL_L2_PREFETCH_HINT) != 0U) {
+		NewActlr |= XIL_L2_ACTLR_PREFETCH_HINT;
+	}
+
+#ifndef USE_AMP
+	Aux = Xil_In32(XPS_L2CC_BASEADDR + XPS_L2CC_AUX_CNTRL_OFFSET);
+	NewAux = Aux & ~XIL_L2_AUX_STATIC_MASK;
+	if ((Flags & XIL_L2_EARLY_BRESP) != 0U) {
+		NewAux |= XIL_L2_AUX_EARLY_BRESP;
+	}
+	if ((Flags & XIL_L2_FULL_LINE_ZERO) != 0U) {
+		NewAux |= XIL_L2_AUX_FULL_LINE_ZERO;
+	}
+
+	if (((Aux ^ NewAux) & XIL_L2_AUX_STATIC_MASK) != 0U) {
+		/* The A9 stops sending full lines of zeros first */
+		mtcp(XREG_CP15_AUX_CONTROL,
+		     Actlr & ~XIL_L2_ACTLR_FULL_LINE_ZERO);
+		isb();
+
+		Control = Xil_In32(XPS_L2CC_BASEADDR + XPS_L2CC_CNTRL_OFFSET);
+		if ((Control & 0x1U) != 0U) {
+			Xil_L2CacheFlush();
+			Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_CNTRL_OFFSET,
+				  Control & ~0x1U);
+			dsb();
+		}
+		Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_AUX_CNTRL_OFFSET,
+			  NewAux);
+		Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_CNTRL_OFFSET, Control);
+		dsb();
+	}
+
+	Prefetch = Xil_In32(XPS_L2CC_BASEADDR + XIL_L2_PREFETCH_CTRL_OFFSET) &
+		   ~XIL_L2_PF_MASK;
+	Prefetch |= Offset;
+	if ((Flags & XIL_L2_DATA_PREFETCH) != 0U) {
+		Prefetch |= XIL_L2_PF_DATA;
+	}
+	if ((Flags & XIL_L2_INSTR_PREFETCH) != 0U) {
+		Prefetch |= XIL_L2_PF_INSTR;
+	}
+	if ((Flags & XIL_L2_DOUBLE_LINEFILL) != 0U) {
+		Prefetch |= XIL_L2_PF_DOUBLE_LINEFILL | XIL_L2_PF_INCR_DOUBLE;
+	}
+	Xil_Out32(XPS_L2CC_BASEADDR + XIL_L2_PREFETCH_CTRL_OFFSET, Prefetch);
+	dsb();
+#endif
+
+	/* Full lines of zeros only go to a PL310 that takes them */
+	if (((Flags & XIL_L2_FULL_LINE_ZERO) != 0U) &&
+	    ((Xil_In32(XPS_L2CC_BASEADDR + XPS_L2CC_AUX_CNTRL_OFFSET) &
+	      XIL_L2_AUX_FULL_LINE_ZERO) != 0U)) {
+		NewActlr |= XIL_L2_ACTLR_FULL_LINE_ZERO;
+	}
+	mtcp(XREG_CP15_AUX_CONTROL, NewActlr);
+	isb();
+
+	mtcpsr(Cpsr);
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Reads the settings in force on the calling CPU, to be applied
+*		again later.
+*
+* @param	ProfilePtr is where the settings are returned, named
+*		"current".
+*
+* @return	None.
+*
+******************************************************************************/
+void Xil_L2ProfileRead(Xil_L2Profile *ProfilePtr)
+{
+	u32 Actlr = mfcp(XREG_CP15_AUX_CONTROL);
+	u32 Aux = Xil_In32(XPS_L2CC_BASEADDR + XPS_L2CC_AUX_CNTRL_OFFSET);
+	u32 Prefetch = Xil_In32(XPS_L2CC_BASEADDR +
+				XIL_L2_PREFETCH_CTRL_OFFSET);
+	u32 Flags = 0U;
+
+	if ((Prefetch & XIL_L2_PF_DATA) != 0U) {
+		Flags |= XIL_L2_DATA_PREFETCH;
+	}
+	if ((Prefetch & XIL_L2_PF_INSTR) != 0U) {
+		Flags |= XIL_L2_INSTR_PREFETCH;
+	}
+	if ((Prefetch & XIL_L2_PF_DOUBLE_LINEFILL) != 0U) {
+		Flags |= XIL_L2_DOUBLE_LINEFILL;
+	}
+	if ((Aux & XIL_L2_AUX_EARLY_BRESP) != 0U) {
+		Flags |= XIL_L2_EARLY_BRESP;
+	}
+	if ((Aux & XIL_L2_AUX_FULL_LINE_ZERO) != 0U) {
+		Flags |= XIL_L2_FULL_LINE_ZERO;
+	}
+	if ((Actlr & XIL_L2_ACTLR_L1_PREFETCH) != 0U) {
+		Flags |= XIL_L2_L1_PREFETCH;
+	}
+	if ((Actlr & XIL_L2_ACTLR_PREFETCH_HINT) != 0U) {
+		Flags |= XIL_L2_PREFETCH_HINT;
+	}
+
+	ProfilePtr->Name = "current";
+	ProfilePtr->Flags = Flags;
+	ProfilePtr->PrefetchOffset = Prefetch & XIL_L2_PF_OFFSET_MASK;
+}
+
+#if defined (XIL_L2_PROFILE)
+/*****************************************************************************/
+/**
+*
+* @brief	Applies the profile of XIL_L2_PROFILE at startup.
+*
+* @return	None.
+*
+******************************************************************************/
+void __attribute__ ((constructor)) Xil_L2ProfileInit(void)
+{
+	(void)Xil_L2ProfileApply(&Xil_L2Profiles[XIL_L2_PROFILE]);
+}
+#endif
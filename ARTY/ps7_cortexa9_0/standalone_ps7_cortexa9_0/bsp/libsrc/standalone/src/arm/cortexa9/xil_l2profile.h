@@ -0,0 +1,119 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_l2profile.h
+*
+* @addtogroup a9_l2profile_apis Cortex A9 L2 Performance Profile Functions
+*
+* Named settings of the PL310 prefetch and write features, together with
+* their Cortex-A9 ACTLR counterparts, in place of the single setting
+* Xil_L2CacheEnable() and the boot code program.
+*
+* A profile selects, with the XIL_L2_* flags:
+*
+* - L2 data and instruction prefetch, with the prefetch offset in lines,
+*   and double linefills, which fetch 64 bytes per miss.
+* - Early BRESP, the write response of the PL310 given before DDR answers.
+* - Full line of zero writes, a whole line of zeros sent by the A9 as a
+*   single command, set in the PL310 then in the ACTLR.
+* - The A9 L1 data prefetch and the L2 prefetch hints, in the ACTLR.
+*
+* The profiles of Xil_L2ProfileGet():
+*
+* - "boot": what the BSP programs at boot, L2 prefetch of the next line and
+*   early BRESP.
+* - "off": nothing, the baseline of the benchmark.
+* - "stream": everything, with a prefetch offset of 7 lines and double
+*   linefills, for sequential moves such as frame copies and the bridge
+*   buffers, where region_bench.h shows the DDR read and copy bandwidth
+*   highest.
+* - "random": instruction prefetch, early BRESP and full line of zero
+*   only, for pointer heavy data, where data prefetch takes DDR bandwidth
+*   for lines never used.
+*
+* Build the BSP with XIL_L2_PROFILE defined to the index of a profile, as
+* XIL_L2_PROFILE_STREAM, to apply it at startup; Xil_L2ProfileApply()
+* switches at run time. The ACTLR is per CPU: a profile applies to the
+* calling CPU, and the other CPU applies it too for its ACTLR part. The
+* early BRESP and full line of zero settings are only written with the L2
+* disabled, so changing them cleans and invalidates the L2 and disables it
+* for the time of the write; the other CPU and the DMA masters must be
+* idle then. With USE_AMP the L2 belongs to the other CPU and only the
+* ACTLR part is applied.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/**
+*@cond nocomments
+*/
+
+#ifndef XIL_L2PROFILE_H
+#define XIL_L2PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+/* Features of a profile */
+#define XIL_L2_DATA_PREFETCH	0x01U	/* PL310 data prefetch */
+#define XIL_L2_INSTR_PREFETCH	0x02U	/* PL310 instruction prefetch */
+#define XIL_L2_DOUBLE_LINEFILL	0x04U	/* PL310 64 byte linefills */
+#define XIL_L2_EARLY_BRESP	0x08U	/* PL310 early write response */
+#define XIL_L2_FULL_LINE_ZERO	0x10U	/* PL310 and ACTLR */
+#define XIL_L2_L1_PREFETCH	0x20U	/* ACTLR L1 data prefetch */
+#define XIL_L2_PREFETCH_HINT	0x40U	/* ACTLR L2 prefetch hints */
+
+/* Profiles of Xil_L2ProfileGet() */
+#define XIL_L2_PROFILE_BOOT	0U
+#define XIL_L2_PROFILE_OFF	1U
+#define XIL_L2_PROFILE_STREAM	2U
+#define XIL_L2_PROFILE_RANDOM	3U
+#define XIL_L2_NUM_PROFILES	4U
+
+/**************************** Type Definitions *******************************/
+
+/**
+ * A profile.
+ */
+typedef struct {
+	const char *Name;
+	u32 Flags;		/* XIL_L2_* features */
+	u32 PrefetchOffset;	/* Lines ahead, 0 to 7, 15, 23 or 31 */
+} Xil_L2Profile;
+
+/**
+*@endcond
+*/
+
+/************************** Function Prototypes ******************************/
+
+const Xil_L2Profile *Xil_L2ProfileGet(u32 Index);
+const Xil_L2Profile *Xil_L2ProfileFind(const char *Name);
+s32 Xil_L2ProfileApply(const Xil_L2Profile *ProfilePtr);
+void Xil_L2ProfileRead(Xil_L2Profile *ProfilePtr);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* XIL_L2PROFILE_H */
+/**
+* @} End of "addtogroup a9_l2profile_apis".
+*/
@@ -33,11 +33,21 @@
 * 6.8   aru  09/06/18 Removed compilation warnings for ARMCC toolchain.
 *                     It fixes CR#1008309.
 * 9.0   ml   03/03/23 Add description to fix doxygen warnings.
+* 9.3   qm   10/14/26 Added Xil_SetTlbAttributesRange, which maps a range of
+*                     sections and supersections with a single D-cache flush
+*                     and TLB invalidation, Xil_MmuPromoteSupersections and
+*                     Xil_MmuDdrSupersections. Xil_SetTlbAttributes and
+*                     Xil_MemMap go through it.
 * </pre>
 *
 * @note
 *
-* None.
+* A supersection is 16 entries of the translation table, on a 16 MB
+* boundary, all holding the same descriptor; it takes a single TLB entry
+* for the 16 MB. Its domain field is the extended base address, kept at 0,
+* which is why its descriptors are in domain 0 (manager, as all the domains
+* set by the boot code). A section written inside a supersection first
+* splits it back into 16 sections of its attributes.
 *
 ******************************************************************************/
 
@@ -48,6 +58,12 @@
 #include "xil_types.h"
 #include "xil_mmu.h"
 #include "xil_errata.h"
+#include "xreg_cortexa9.h"
+#ifndef SDT
+#include "xparameters.h"
+#else
+#include "xmem_config.h"
+#endif
 
 /***************** Macros (Inline Functions) Definitions *********************/
 
@@ -59,6 +75,13 @@
                                                    *   covers a 1MB region */
 #define	ARM_AR_MEM_TTB_SECT_SIZE_MASK	(~(ARM_AR_MEM_TTB_SECT_SIZE-1UL))
 /**< Mask off lower bits of addr */
+#define	ARM_AR_MEM_TTB_ENTRIES		4096U /**< Sections of the table */
+#define	ARM_AR_MEM_TTB_SUPER_ENTRIES	16U /**< Sections of a supersection */
+#define	ARM_AR_MEM_TTB_TYPE_MASK	0x3U /**< Descriptor type */
+#define	ARM_AR_MEM_TTB_TYPE_SECTION	0x2U /**< Section or supersection */
+#define	ARM_AR_MEM_TTB_ATTR_MASK	0x000FFFFFU /**< Section attributes */
+#define	ARM_AR_MEM_TTB_DOMAIN_MASK	0x000001E0U /**< Section domain */
+#define	ARM_AR_MEM_TTB_SUPER_BASE_MASK	0xFF000000U /**< Supersection base */
 
 /************************** Variable Definitions *****************************/
 
@@ -66,6 +89,8 @@ extern u32 MMUTable;
 
 /************************** Function Prototypes ******************************/
 
+static void Xil_MmuSplitSupersection(u32 *TablePtr, u32 Section);
+
 /*****************************************************************************/
 /**
 * @brief	This function sets the memory attributes for a section covering 1MB
@@ -85,14 +110,67 @@ extern u32 MMUTable;
 ******************************************************************************/
 void Xil_SetTlbAttributes(INTPTR Addr, u32 attrib)
 {
-	u32 *ptr;
-	u32 section;
-
-	section = Addr / 0x100000U;
-	ptr = &MMUTable;
-	ptr += section;
-	if(ptr != NULL) {
-		*ptr = (Addr & 0xFFF00000U) | attrib;
+	Xil_SetTlbAttributesRange(Addr, 1U, attrib);
+}
+
+/*****************************************************************************/
+/**
+* @brief	This function sets the memory attributes of all the sections
+*			covering a range of memory in the translation table, with
+*			a single D-cache flush and TLB invalidation.
+*
+* @param	Addr  32-bit start address of the range.
+* @param	Size  Size of the range in bytes. Every section it touches
+*			is set.
+* @param	attrib  Attribute for the range, as for Xil_SetTlbAttributes.
+*			With SUPERSECTION added, the 16 MB aligned parts of the
+*			range are mapped as supersections and the rest as
+*			sections.
+*
+* @return	None.
+*
+* @note		The D-cache flush being the cost of an attribute change, a
+*			range is much faster set at once than section by section.
+*
+******************************************************************************/
+void Xil_SetTlbAttributesRange(INTPTR Addr, u32 Size, u32 attrib)
+{
+	u32 *TablePtr = &MMUTable;
+	u32 Section;
+	u32 Last;
+	u32 Index;
+	u32 Attr;
+
+	if (Size == 0U) {
+		return;
+	}
+
+	Section = (u32)Addr / ARM_AR_MEM_TTB_SECT_SIZE;
+	Last = (u32)((((u64)(u32)Addr) + Size - 1U) / ARM_AR_MEM_TTB_SECT_SIZE);
+	if (Last >= ARM_AR_MEM_TTB_ENTRIES) {
+		Last = ARM_AR_MEM_TTB_ENTRIES - 1U;
+	}
+	Attr = attrib & ~(u32)SUPERSECTION;
+
+	while (Section <= Last) {
+		if (((attrib & (u32)SUPERSECTION) != 0U) &&
+		    ((Section % ARM_AR_MEM_TTB_SUPER_ENTRIES) == 0U) &&
+		    ((Last - Section) >= (ARM_AR_MEM_TTB_SUPER_ENTRIES - 1U))) {
+			for (Index = 0U; Index < ARM_AR_MEM_TTB_SUPER_ENTRIES;
+			     Index++) {
+				TablePtr[Section + Index] =
+					((Section * ARM_AR_MEM_TTB_SECT_SIZE) &
+					 ARM_AR_MEM_TTB_SUPER_BASE_MASK) |
+					(Attr & ~ARM_AR_MEM_TTB_DOMAIN_MASK) |
+					(u32)SUPERSECTION;
+			}
+			Section += ARM_AR_MEM_TTB_SUPER_ENTRIES;
+		} else {
+			Xil_MmuSplitSupersection(TablePtr, Section);
+			TablePtr[Section] = (Section * ARM_AR_MEM_TTB_SECT_SIZE) |
+					    Attr;
+			Section++;
+		}
 	}
 
 	Xil_DCacheFlush();
@@ -185,24 +263,151 @@ void Xil_DisableMMU(void)
 ******************************************************************************/
 void* Xil_MemMap(UINTPTR PhysAddr, size_t size, u32 flags)
 {
-   u32 Sectionoffset;
-   u32 Ttbaddr;
-
    if (!flags)
        return (void*)PhysAddr;
 
    /* Ensure alignment on a section boundary */
    PhysAddr &= ARM_AR_MEM_TTB_SECT_SIZE_MASK;
 
-   /* Loop through entire region of memory (one MMU section at a time).
-      Each section requires a TTB entry. */
-   for (Sectionoffset = 0; Sectionoffset < size;
-		Sectionoffset += ARM_AR_MEM_TTB_SECT_SIZE) {
-       /* Calculate translation table entry for this memory section */
-       Ttbaddr = (PhysAddr + Sectionoffset);
-
-       /* Write translation table entry value to entry address */
-       Xil_SetTlbAttributes(Ttbaddr, flags);
+   /* Write the TTB entries of all the sections of the region at once */
+   if (size > 0U) {
+       Xil_SetTlbAttributesRange((INTPTR)PhysAddr, (u32)size, flags);
    }
    return (void*)PhysAddr;
 }
+
+/*****************************************************************************/
+/**
+* @brief	Maps as supersections the 16 MB aligned parts of a range whose
+*			16 sections are flat mapped with the same attributes, so
+*			that a large working set takes a sixteenth of the TLB
+*			entries. The attributes do not change.
+*
+* @param	Addr  32-bit start address of the range.
+* @param	Size  Size of the range in bytes.
+*
+* @return	The number of supersections made.
+*
+* @note		A 16 MB part holding a section of other attributes, such as
+*			the DMA arena, stays in sections. Sections set later inside
+*			a supersection split it again.
+*
+******************************************************************************/
+u32 Xil_MmuPromoteSupersections(INTPTR Addr, u32 Size)
+{
+	u32 *TablePtr = &MMUTable;
+	u64 First;
+	u32 Section;
+	u32 End;
+	u32 Index;
+	u32 Entry;
+	u32 Count = 0U;
+	u32 Cpsr;
+
+	/* Whole 16 MB parts of the range only */
+	First = ((u64)(u32)Addr + (ARM_AR_MEM_TTB_SUPER_ENTRIES *
+				   ARM_AR_MEM_TTB_SECT_SIZE) - 1U) /
+		ARM_AR_MEM_TTB_SECT_SIZE;
+	Section = (u32)First & ~(ARM_AR_MEM_TTB_SUPER_ENTRIES - 1U);
+	End = (u32)(((u64)(u32)Addr + Size) / ARM_AR_MEM_TTB_SECT_SIZE);
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+
+	for (; (Section + ARM_AR_MEM_TTB_SUPER_ENTRIES) <= End;
+	     Section += ARM_AR_MEM_TTB_SUPER_ENTRIES) {
+		Entry = TablePtr[Section];
+		if (((Entry & ARM_AR_MEM_TTB_TYPE_MASK) !=
+		     ARM_AR_MEM_TTB_TYPE_SECTION) ||
+		    ((Entry & (u32)SUPERSECTION) != 0U)) {
+			continue;
+		}
+		for (Index = 0U; Index < ARM_AR_MEM_TTB_SUPER_ENTRIES; Index++) {
+			if (TablePtr[Section + Index] !=
+			    (((Section + Index) * ARM_AR_MEM_TTB_SECT_SIZE) |
+			     (Entry & ARM_AR_MEM_TTB_ATTR_MASK))) {
+				break;
+			}
+		}
+		if (Index < ARM_AR_MEM_TTB_SUPER_ENTRIES) {
+			continue;
+		}
+		for (Index = 0U; Index < ARM_AR_MEM_TTB_SUPER_ENTRIES; Index++) {
+			TablePtr[Section + Index] =
+				(Entry & ARM_AR_MEM_TTB_SUPER_BASE_MASK) |
+				(Entry & ARM_AR_MEM_TTB_ATTR_MASK &
+				 ~ARM_AR_MEM_TTB_DOMAIN_MASK) |
+				(u32)SUPERSECTION;
+		}
+		Count++;
+	}
+
+	if (Count != 0U) {
+		/* Same addresses and attributes, only the table walk changes */
+		Xil_DCacheFlushRange((INTPTR)TablePtr,
+				     ARM_AR_MEM_TTB_ENTRIES * sizeof(u32));
+		mtcp(XREG_CP15_INVAL_UTLB_UNLOCKED, 0U);
+		mtcp(XREG_CP15_INVAL_BRANCH_ARRAY, 0U);
+		dsb();
+		isb();
+	}
+
+	mtcpsr(Cpsr);
+
+	return Count;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Maps the DDR as supersections wherever its mapping allows it,
+*			with Xil_MmuPromoteSupersections.
+*
+* @return	The number of supersections made, 0 without DDR.
+*
+* @note		Meant to be called once the DDR ranges of other attributes,
+*			such as the DMA arena, are mapped.
+*
+******************************************************************************/
+u32 Xil_MmuDdrSupersections(void)
+{
+	/* The first section, below the DDR base, is mapped as DDR too */
+#if defined (XPAR_PS7_DDR_0_S_AXI_HIGHADDR)
+	return Xil_MmuPromoteSupersections(0,
+				(u32)XPAR_PS7_DDR_0_S_AXI_HIGHADDR + 1U);
+#elif defined (XPAR_PS7_DDR_0_HIGHADDRESS)
+	return Xil_MmuPromoteSupersections(0,
+				(u32)XPAR_PS7_DDR_0_HIGHADDRESS + 1U);
+#else
+	return 0U;
+#endif
+}
+
+/*****************************************************************************/
+/**
+* @brief	Splits the supersection holding a section back into sections
+*			of its attributes, in domain 0.
+*
+* @param	TablePtr  The translation table.
+* @param	Section  Index of the section.
+*
+* @return	None.
+*
+******************************************************************************/
+static void Xil_MmuSplitSupersection(u32 *TablePtr, u32 Section)
+{
+	u32 First = Section & ~(ARM_AR_MEM_TTB_SUPER_ENTRIES - 1U);
+	u32 Entry = TablePtr[Section];
+	u32 Index;
+
+	if (((Entry & ARM_AR_MEM_TTB_TYPE_MASK) != ARM_AR_MEM_TTB_TYPE_SECTION) ||
+	    ((Entry & (u32)SUPERSECTION) == 0U)) {
+		return;
+	}
+
+	for (Index = First; Index < (First + ARM_AR_MEM_TTB_SUPER_ENTRIES);
+	     Index++) {
+		TablePtr[Index] = (Index * ARM_AR_MEM_TTB_SECT_SIZE) |
+				  (Entry & ARM_AR_MEM_TTB_ATTR_MASK &
+				   ~(u32)SUPERSECTION);
+	}
+}
@@ -24,6 +24,8 @@
 *					  u32 which resolves issue of CR#805869
 * 5.4	pkp	 23/11/15 Added attribute definitions for Xil_SetTlbAttributes API
 * 6.8   aru  09/06/18 Removed compilation warnings for ARMCC toolchain.
+* 9.3   qm   10/14/26 Added Xil_SetTlbAttributesRange, supersections and
+*                     Xil_MmuDdrSupersections.
 * </pre>
 *
 *
@@ -69,6 +71,9 @@ extern "C" {
 /* Execution type */
 #define EXECUTE_NEVER ((0x1 << 4) | (0x1 << 0))
 
+/* 16 MB supersection, for Xil_SetTlbAttributesRange */
+#define SUPERSECTION (0x1 << 18)
+
 /**
 *@endcond
 */
@@ -78,6 +83,9 @@ extern "C" {
 /************************** Function Prototypes ******************************/
 
 void Xil_SetTlbAttributes(INTPTR Addr, u32 attrib);
+void Xil_SetTlbAttributesRange(INTPTR Addr, u32 Size, u32 attrib);
+u32 Xil_MmuPromoteSupersections(INTPTR Addr, u32 Size);
+u32 Xil_MmuDdrSupersections(void);
 void Xil_EnableMMU(void);
 void Xil_DisableMMU(void);
 void* Xil_MemMap(UINTPTR PhysAddr, size_t size, u32 flags);
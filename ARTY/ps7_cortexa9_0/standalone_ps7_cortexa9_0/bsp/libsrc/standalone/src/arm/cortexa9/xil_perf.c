@@ -0,0 +1,627 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_perf.c
+*
+* This file contains the scoped performance counters. Refer to xil_perf.h
+* for more details.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+* @note
+*
+* A PMU counter is extended by the count of its overflows, kept per CPU and
+* raised by the PMU interrupt. A read with the IRQ masked takes the counter,
+* then the overflow flag: a flag still set means an overflow the handler
+* has not seen yet, and the counter is read again with one more overflow.
+*
+* The PL310 counters stop at their maximum instead of wrapping. The L2CC
+* interrupt on the overflow of either one stops them, adds them to their
+* bases and restarts them from zero, losing the events of the few cycles
+* in between. The bases are read against a sequence count, odd while the
+* handler runs, as it may run on the other CPU.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <string.h>
+#include "bspconfig.h"
+#include "xil_types.h"
+#include "xil_io.h"
+#include "xstatus.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xparameters_ps.h"
+#include "xl2cc.h"
+#include "xil_printf.h"
+#include "xil_perf.h"
+#if defined (XIL_INTERRUPT)
+#include "xinterrupt_wrap.h"
+#endif
+
+/************************** Constant Definitions *****************************/
+
+/* The overflow interrupts need the GIC */
+#if defined (XIL_INTERRUPT) && defined (XPAR_SCUGIC)
+#define XIL_PERF_OVERFLOW_IRQ
+#endif
+
+#define XIL_PERF_NUM_CPUS	2U
+#define XIL_PERF_PRIORITY	0x10U	/* Above the default handlers */
+#define XIL_PERF_TRIGGER_LEVEL	0x1U	/* Active high level */
+
+#define XIL_PERF_PMCR_E		0x00000001U	/* Enable all counters */
+#define XIL_PERF_PMCR_D		0x00000008U	/* Cycles by 64 */
+#define XIL_PERF_PMU_CYCLE_BIT	0x80000000U	/* Cycle counter flag */
+#define XIL_PERF_PMU_EVENT_BITS	0x0000003FU	/* Event counter flags */
+
+#define XIL_PERF_L2_ENABLE	0x1U	/* Event Counter Control */
+#define XIL_PERF_L2_RESET	0x6U
+#define XIL_PERF_L2_IRQ_OVERFLOW 0x2U	/* Event Counter Configuration */
+#define XIL_PERF_L2_EVENT_SHIFT	2U
+#define XIL_PERF_L2_ECNTR	0x1U	/* Event counter interrupt */
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+#define XIL_PERF_CPU_ID()	(mfcp(XREG_CP15_MULTI_PROC_AFFINITY) & 0x1U)
+
+/* L2 counters, 1 then 0 in the register map */
+#define XIL_PERF_L2_VAL(Index) \
+	(XPS_L2CC_BASEADDR + (((Index) == 0U) ? \
+	 XPS_L2CC_EVNT_CNT0_VAL_OFFSET : XPS_L2CC_EVNT_CNT1_VAL_OFFSET))
+#define XIL_PERF_L2_CFG(Index) \
+	(XPS_L2CC_BASEADDR + (((Index) == 0U) ? \
+	 XPS_L2CC_EVNT_CNT0_CTRL_OFFSET : XPS_L2CC_EVNT_CNT1_CTRL_OFFSET))
+
+/************************** Function Prototypes ******************************/
+
+static u32 Xil_PerfPmuRead(u32 Index);
+static void Xil_PerfList(Xil_PerfSite *SitePtr);
+#if defined (XIL_PERF_OVERFLOW_IRQ)
+static s32 Xil_PerfConnect(u32 IntId, Xil_InterruptHandler Handler,
+			   u32 Cpu);
+static void Xil_PerfPmuHandler(void *CallBackRef);
+static void Xil_PerfL2Handler(void *CallBackRef);
+#endif
+
+/************************** Variable Definitions *****************************/
+
+static const Xil_PerfEventSet Xil_PerfEventSets[] = {
+	{
+		"cache",
+		{ XPM_EVENT_DATA_CACHEACCESS, XPM_EVENT_DATA_CACHEREFILL,
+		  XPM_EVENT_INSRFETCH_CACHEREFILL, XPM_EVENT_DATA_TLBREFILL,
+		  XPM_EVENT_DATASTALL, XPM_EVENT_WRITESTALL },
+		{ XL2CC_DRREQ, XL2CC_DRHIT }
+	},
+	{
+		"branch",
+		{ XPM_EVENT_SW_CHANGEPC, XPM_EVENT_BRANCHMISS,
+		  XPM_EVENT_BRANCHPREDICT, XPM_EVENT_PREDICTFUNCRET,
+		  XPM_EVENT_INSTRRENAME, XPM_EVENT_NODISPATCH },
+		{ XL2CC_IRREQ, XL2CC_IRHIT }
+	},
+	{
+		"stall",
+		{ XPM_EVENT_INSTRSTALL, XPM_EVENT_DATASTALL,
+		  XPM_EVENT_INSTRTLBSTALL, XPM_EVENT_DATATLBSTALL,
+		  XPM_EVENT_DMB_STALL, XPM_EVENT_INSTRRENAME },
+		{ XL2CC_DWREQ, XL2CC_DWHIT }
+	},
+	{
+		"coherency",
+		{ XPM_EVENT_COHERLINEMISS, XPM_EVENT_COHERLINEHIT,
+		  XPM_EVENT_DATAEVICT, XPM_EVENT_STREXPASS,
+		  XPM_EVENT_STREXFAIL, XPM_EVENT_DATASTALL },
+		{ XL2CC_CO, XL2CC_WA }
+	},
+};
+
+#define XIL_PERF_NUM_SETS \
+	(sizeof(Xil_PerfEventSets) / sizeof(Xil_PerfEventSets[0]))
+
+/* Event set of each CPU */
+static const Xil_PerfEventSet *Xil_PerfSet[XIL_PERF_NUM_CPUS];
+
+/* Overflows of the cycle and PMU counters of each CPU */
+static volatile u32 Xil_PerfPmuHigh[XIL_PERF_NUM_CPUS][1U +
+							XIL_PERF_PMU_EVENTS];
+
+/* Counts of the L2 counters before their last restart */
+static volatile u64 Xil_PerfL2Base[XIL_PERF_L2_EVENTS];
+static volatile u32 Xil_PerfL2Seq;
+
+/* Sites measured */
+static Xil_PerfSite *volatile Xil_PerfSites;
+
+#if defined (XIL_PERF_OVERFLOW_IRQ)
+static u32 Xil_PerfL2Connected;
+#endif
+
+/*****************************************************************************/
+/**
+*
+* @brief	Enables the PMU of the calling CPU and the L2 event counters,
+*		connects their overflow interrupts and selects the first
+*		event set, "cache".
+*
+* @return
+*		- XST_SUCCESS if the counters are ready.
+*		- XST_FAILURE if an overflow interrupt could not be
+*		connected, the GIC not being set up yet. The counters are
+*		then limited to 32 bits.
+*
+* @note		Call it on each CPU that measures, after the GIC is set up.
+*
+******************************************************************************/
+s32 Xil_PerfInitialize(void)
+{
+	u32 Cpu = XIL_PERF_CPU_ID();
+	u32 Index;
+	u32 Reg;
+	s32 Status = XST_SUCCESS;
+
+	for (Index = 0U; Index <= XIL_PERF_PMU_EVENTS; Index++) {
+		Xil_PerfPmuHigh[Cpu][Index] = 0U;
+	}
+
+	/* The counters keep their values, the cycles are not reset */
+	Reg = mfcp(XREG_CP15_PERF_MONITOR_CTRL);
+	Reg = (Reg | XIL_PERF_PMCR_E) & ~XIL_PERF_PMCR_D;
+	mtcp(XREG_CP15_PERF_MONITOR_CTRL, Reg);
+	mtcp(XREG_CP15_COUNT_ENABLE_SET,
+	     XIL_PERF_PMU_CYCLE_BIT | XIL_PERF_PMU_EVENT_BITS);
+	mtcp(XREG_CP15_V_FLAG_STATUS,
+	     XIL_PERF_PMU_CYCLE_BIT | XIL_PERF_PMU_EVENT_BITS);
+
+#if defined (XIL_PERF_OVERFLOW_IRQ)
+	if (Xil_PerfConnect(XPS_PMU0_INT_ID + Cpu, Xil_PerfPmuHandler,
+			    Cpu) == XST_SUCCESS) {
+		mtcp(XREG_CP15_INTR_ENABLE_SET,
+		     XIL_PERF_PMU_CYCLE_BIT | XIL_PERF_PMU_EVENT_BITS);
+	} else {
+		Status = XST_FAILURE;
+	}
+
+	if (Xil_PerfL2Connected == 0U) {
+		if (Xil_PerfConnect(XPS_L2CC_INT_ID, Xil_PerfL2Handler,
+				    Cpu) == XST_SUCCESS) {
+			Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_IAR_OFFSET,
+				  XIL_PERF_L2_ECNTR);
+			Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_IER_OFFSET,
+				  Xil_In32(XPS_L2CC_BASEADDR +
+					   XPS_L2CC_IER_OFFSET) |
+				  XIL_PERF_L2_ECNTR);
+			Xil_PerfL2Connected = 1U;
+		} else {
+			Status = XST_FAILURE;
+		}
+	}
+#endif
+
+	(void)Xil_PerfSelectSet(&Xil_PerfEventSets[0]);
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Selects one of the event sets of xil_perf.h.
+*
+* @param	Name is the name of the set, as "cache".
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM if there is no such set.
+*
+******************************************************************************/
+s32 Xil_PerfSelect(const char *Name)
+{
+	u32 Index;
+
+	for (Index = 0U; Index < XIL_PERF_NUM_SETS; Index++) {
+		if (strcmp(Xil_PerfEventSets[Index].Name, Name) == 0) {
+			return Xil_PerfSelectSet(&Xil_PerfEventSets[Index]);
+		}
+	}
+
+	return XST_INVALID_PARAM;
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Programs the PMU of the calling CPU and the L2 counters with
+*		an event set. The counts go on from their values, so a scope
+*		running across the change mixes the events.
+*
+* @param	SetPtr is the set, kept by the caller while selected.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM without a set.
+*
+******************************************************************************/
+s32 Xil_PerfSelectSet(const Xil_PerfEventSet *SetPtr)
+{
+	u32 Cpu = XIL_PERF_CPU_ID();
+	u32 Index;
+	u8 Event;
+
+	if (SetPtr == NULL) {
+		return XST_INVALID_PARAM;
+	}
+
+	for (Index = 0U; Index < XIL_PERF_PMU_EVENTS; Index++) {
+		Event = SetPtr->Pmu[Index];
+		mtcp(XREG_CP15_EVENT_CNTR_SEL, Index);
+		isb();
+		/* Software increments are never made, so they never count */
+		mtcp(XREG_CP15_EVENT_TYPE_SEL, (Event == XIL_PERF_NO_EVENT) ?
+		     XPM_EVENT_SOFTINCR : (u32)Event);
+	}
+
+	/* The configuration is only written with the counters stopped */
+	Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_EVNT_CNTRL_OFFSET, 0U);
+	for (Index = 0U; Index < XIL_PERF_L2_EVENTS; Index++) {
+		Event = SetPtr->L2[Index];
+		Xil_Out32(XIL_PERF_L2_CFG(Index),
+			  (Event == XIL_PERF_NO_EVENT) ? 0U :
+			  (((u32)Event << XIL_PERF_L2_EVENT_SHIFT) |
+			   XIL_PERF_L2_IRQ_OVERFLOW));
+	}
+	Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_EVNT_CNTRL_OFFSET,
+		  XIL_PERF_L2_ENABLE);
+
+	Xil_PerfSet[Cpu] = SetPtr;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Gives the event set of the calling CPU.
+*
+* @return	The set, NULL before Xil_PerfInitialize().
+*
+******************************************************************************/
+const Xil_PerfEventSet *Xil_PerfGetSet(void)
+{
+	return Xil_PerfSet[XIL_PERF_CPU_ID()];
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Reads the counters of the calling CPU and of the L2.
+*
+* @param	SamplePtr is where the counts are returned.
+*
+* @return	None.
+*
+******************************************************************************/
+void Xil_PerfRead(Xil_PerfSample *SamplePtr)
+{
+	u32 Cpu = XIL_PERF_CPU_ID();
+	u32 Cpsr = mfcpsr();
+	u32 Index;
+	u32 Low;
+	u32 High;
+	u32 Flags;
+	u32 Seq;
+
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+
+	for (Index = 0U; Index <= XIL_PERF_PMU_EVENTS; Index++) {
+		Low = Xil_PerfPmuRead(Index);
+		High = Xil_PerfPmuHigh[Cpu][Index];
+		Flags = mfcp(XREG_CP15_V_FLAG_STATUS);
+		if ((Flags & ((Index == XIL_PERF_CYCLES) ?
+			      XIL_PERF_PMU_CYCLE_BIT :
+			      (1U << (Index - XIL_PERF_PMU_FIRST)))) != 0U) {
+			Low = Xil_PerfPmuRead(Index);
+			High++;
+		}
+		SamplePtr->Count[Index] = ((u64)High << 32U) | Low;
+	}
+
+	do {
+		Seq = Xil_PerfL2Seq;
+		dmb();
+		for (Index = 0U; Index < XIL_PERF_L2_EVENTS; Index++) {
+			SamplePtr->Count[XIL_PERF_L2_FIRST + Index] =
+				Xil_PerfL2Base[Index] +
+				Xil_In32(XIL_PERF_L2_VAL(Index));
+		}
+		dmb();
+	} while (((Seq & 0x1U) != 0U) || (Seq != Xil_PerfL2Seq));
+
+	mtcpsr(Cpsr);
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Starts a measurement at a site.
+*
+* @param	SitePtr is the site.
+*
+* @return	The scope, to be given to Xil_PerfEnd().
+*
+******************************************************************************/
+Xil_PerfScope Xil_PerfBegin(Xil_PerfSite *SitePtr)
+{
+	Xil_PerfScope Scope;
+
+	Scope.Site = SitePtr;
+	Xil_PerfRead(&Scope.Start);
+
+	return Scope;
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Ends a measurement and adds its counts to its site.
+*
+* @param	ScopePtr is the scope of Xil_PerfBegin().
+*
+* @return	None.
+*
+* @note		The totals of a site start again when the event set changes.
+*
+******************************************************************************/
+void Xil_PerfEnd(Xil_PerfScope *ScopePtr)
+{
+	Xil_PerfSite *SitePtr = ScopePtr->Site;
+	const Xil_PerfEventSet *SetPtr = Xil_PerfGetSet();
+	Xil_PerfSample End;
+	u64 Delta;
+	u32 Index;
+
+	Xil_PerfRead(&End);
+
+	if (SitePtr->Set != SetPtr) {
+		SitePtr->Set = SetPtr;
+		SitePtr->Calls = 0U;
+		SitePtr->MaxCycles = 0U;
+		for (Index = 0U; Index < XIL_PERF_NUM_COUNTS; Index++) {
+			SitePtr->Total[Index] = 0U;
+		}
+	}
+
+	for (Index = 0U; Index < XIL_PERF_NUM_COUNTS; Index++) {
+		Delta = End.Count[Index] - ScopePtr->Start.Count[Index];
+#if !defined (XIL_PERF_OVERFLOW_IRQ)
+		Delta &= 0xFFFFFFFFU;
+#endif
+		SitePtr->Total[Index] += Delta;
+		if ((Index == XIL_PERF_CYCLES) && (Delta > SitePtr->MaxCycles)) {
+			SitePtr->MaxCycles = Delta;
+		}
+	}
+	SitePtr->Calls++;
+
+	if (SitePtr->Listed == 0U) {
+		Xil_PerfList(SitePtr);
+	}
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Clears the counts of all the sites measured.
+*
+* @return	None.
+*
+* @note		No measurement may be running.
+*
+******************************************************************************/
+void Xil_PerfResetSites(void)
+{
+	Xil_PerfSite *SitePtr;
+
+	for (SitePtr = Xil_PerfSites; SitePtr != NULL;
+	     SitePtr = SitePtr->Next) {
+		/* Cleared by the next end */
+		SitePtr->Set = NULL;
+	}
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Prints the sites measured, with xil_printf(): per site the
+*		calls, the longest call in cycles and the average of each
+*		count per call, under the events of its set.
+*
+* @return	None.
+*
+******************************************************************************/
+void Xil_PerfReport(void)
+{
+	const Xil_PerfSite *SitePtr;
+	const Xil_PerfEventSet *SetPtr;
+	u32 Index;
+
+	for (SitePtr = Xil_PerfSites; SitePtr != NULL;
+	     SitePtr = SitePtr->Next) {
+		SetPtr = SitePtr->Set;
+		if ((SetPtr == NULL) || (SitePtr->Calls == 0U)) {
+			continue;
+		}
+		xil_printf("%s [%s] calls %u max %u cycles\r\n  avg cyc",
+			   SitePtr->Name, SetPtr->Name, SitePtr->Calls,
+			   (u32)SitePtr->MaxCycles);
+		for (Index = 0U; Index < XIL_PERF_PMU_EVENTS; Index++) {
+			xil_printf(" pmu:%02x", SetPtr->Pmu[Index]);
+		}
+		for (Index = 0U; Index < XIL_PERF_L2_EVENTS; Index++) {
+			xil_printf(" l2:%x", SetPtr->L2[Index]);
+		}
+		xil_printf("\r\n     ");
+		for (Index = 0U; Index < XIL_PERF_NUM_COUNTS; Index++) {
+			xil_printf(" %u", (u32)(SitePtr->Total[Index] /
+						SitePtr->Calls));
+		}
+		xil_printf("\r\n");
+	}
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Reads the cycle counter or a PMU event counter.
+*
+* @param	Index is XIL_PERF_CYCLES, or XIL_PERF_PMU_FIRST and up.
+*
+* @return	The count.
+*
+******************************************************************************/
+static u32 Xil_PerfPmuRead(u32 Index)
+{
+	if (Index == XIL_PERF_CYCLES) {
+		return mfcp(XREG_CP15_PERF_CYCLE_COUNTER);
+	}
+
+	mtcp(XREG_CP15_EVENT_CNTR_SEL, Index - XIL_PERF_PMU_FIRST);
+	isb();
+
+	return mfcp(XREG_CP15_PERF_MONITOR_COUNT);
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Adds a site to the list of the report, once.
+*
+* @param	SitePtr is the site.
+*
+* @return	None.
+*
+******************************************************************************/
+static void Xil_PerfList(Xil_PerfSite *SitePtr)
+{
+	Xil_PerfSite *Head;
+
+	do {
+		if (ldrex(&SitePtr->Listed) != 0U) {
+			clrex();
+			return;
+		}
+	} while (strex(&SitePtr->Listed, 1U) != 0U);
+
+	do {
+		Head = (Xil_PerfSite *)(UINTPTR)
+		       ldrex((volatile u32 *)&Xil_PerfSites);
+		SitePtr->Next = Head;
+		dmb();
+	} while (strex((volatile u32 *)&Xil_PerfSites,
+		       (u32)(UINTPTR)SitePtr) != 0U);
+}
+
+#if defined (XIL_PERF_OVERFLOW_IRQ)
+/*****************************************************************************/
+/**
+*
+* @brief	Connects an overflow interrupt, routed to a CPU.
+*
+* @param	IntId is the interrupt ID.
+* @param	Handler is its handler.
+* @param	Cpu is the CPU to take it.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if the GIC is not set up.
+*
+******************************************************************************/
+static s32 Xil_PerfConnect(u32 IntId, Xil_InterruptHandler Handler, u32 Cpu)
+{
+	XScuGic *GicPtr = XGetScuGicInstance();
+
+	if ((GicPtr == NULL) ||
+	    (XScuGic_Connect(GicPtr, IntId, Handler, NULL) != XST_SUCCESS)) {
+		return XST_FAILURE;
+	}
+
+	XScuGic_SetPriorityTriggerType(GicPtr, IntId, XIL_PERF_PRIORITY,
+				       XIL_PERF_TRIGGER_LEVEL);
+	XScuGic_InterruptMaptoCpu(GicPtr, (u8)Cpu, IntId);
+	XScuGic_Enable(GicPtr, IntId);
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Counts the overflows of the PMU counters of the CPU.
+*
+* @param	CallBackRef is unused.
+*
+* @return	None.
+*
+******************************************************************************/
+static void Xil_PerfPmuHandler(void *CallBackRef)
+{
+	u32 Cpu = XIL_PERF_CPU_ID();
+	u32 Flags = mfcp(XREG_CP15_V_FLAG_STATUS);
+	u32 Index;
+
+	(void)CallBackRef;
+	mtcp(XREG_CP15_V_FLAG_STATUS, Flags);
+
+	if ((Flags & XIL_PERF_PMU_CYCLE_BIT) != 0U) {
+		Xil_PerfPmuHigh[Cpu][XIL_PERF_CYCLES]++;
+	}
+	for (Index = 0U; Index < XIL_PERF_PMU_EVENTS; Index++) {
+		if ((Flags & (1U << Index)) != 0U) {
+			Xil_PerfPmuHigh[Cpu][XIL_PERF_PMU_FIRST + Index]++;
+		}
+	}
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Moves the L2 counters into their bases when one of them
+*		stops at its maximum.
+*
+* @param	CallBackRef is unused.
+*
+* @return	None.
+*
+******************************************************************************/
+static void Xil_PerfL2Handler(void *CallBackRef)
+{
+	u32 Index;
+
+	(void)CallBackRef;
+	if ((Xil_In32(XPS_L2CC_BASEADDR + XPS_L2CC_IPR_OFFSET) &
+	     XIL_PERF_L2_ECNTR) == 0U) {
+		return;
+	}
+
+	Xil_PerfL2Seq++;
+	dmb();
+	Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_EVNT_CNTRL_OFFSET, 0U);
+	for (Index = 0U; Index < XIL_PERF_L2_EVENTS; Index++) {
+		Xil_PerfL2Base[Index] += Xil_In32(XIL_PERF_L2_VAL(Index));
+	}
+	Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_EVNT_CNTRL_OFFSET,
+		  XIL_PERF_L2_RESET);
+	Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_EVNT_CNTRL_OFFSET,
+		  XIL_PERF_L2_ENABLE);
+	Xil_Out32(XPS_L2CC_BASEADDR + XPS_L2CC_IAR_OFFSET, XIL_PERF_L2_ECNTR);
+	dmb();
+	Xil_PerfL2Seq++;
+}
+#endif
@@ -0,0 +1,159 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_perf.h
+*
+* @addtogroup a9_perf_apis Cortex A9 Performance Counter Functions
+*
+* Scoped measurements with the Cortex-A9 PMU and the PL310 event counters,
+* for tuning data layouts and hot loops.
+*
+* An event set names up to six PMU events (XPM_EVENT_*) and two L2 events
+* (XL2CC_*); the cycle counter is always counted. Xil_PerfSelect() programs
+* the set by name, from the sets below, or Xil_PerfSelectSet() a set of the
+* caller's:
+*
+* - "cache": L1 data accesses and refills, L1 instruction refills, data
+*   TLB refills, linefill and write stalls; L2 data read requests and hits.
+* - "branch": PC changes, mispredicted and predictable branches, predicted
+*   returns, instructions renamed, issue stalls; L2 instruction requests
+*   and hits.
+* - "stall": instruction, data, TLB and DMB stalls, renamed instructions;
+*   L2 data write requests and hits.
+* - "coherency": coherent line misses and hits, data evictions, STREX
+*   passes and failures, data linefill stalls; L2 castouts and write
+*   allocations.
+*
+* A site, a static Xil_PerfSite, accumulates the counts between
+* Xil_PerfBegin() and Xil_PerfEnd() over all its calls; XIL_PERF_SCOPE()
+* declares one and measures the rest of the enclosing block. The sites are
+* listed by Xil_PerfReport() once measured. Scopes nest and are cheap
+* enough for loops of some hundred cycles: a begin or an end reads the nine
+* counters, about 150 cycles with the two uncached L2 reads.
+*
+* The counters are extended to 64 bits by their overflow interrupts, the
+* PMU interrupt of each CPU and the L2CC interrupt, when the BSP is built
+* with interrupts; otherwise a scope is limited to 2^32 counts of each
+* event. The cycle counter keeps counting as XTimestamp_Cycles() expects.
+*
+* The PMU is per CPU: call Xil_PerfInitialize() and Xil_PerfSelect() on
+* each CPU that measures, and use a site from a single CPU. The L2 counters
+* count for the whole L2, both CPUs and the ACP, and the last selection on
+* either CPU programs them. The Xpm_* functions of xpm_counter.h
+* reprogram the same counters and are not to be used along with these.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/**
+*@cond nocomments
+*/
+
+#ifndef XIL_PERF_H
+#define XIL_PERF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+#include "xpm_counter.h"
+#include "xl2cc_counter.h"
+
+/************************** Constant Definitions *****************************/
+
+#define XIL_PERF_PMU_EVENTS	6U	/* PMU event counters */
+#define XIL_PERF_L2_EVENTS	2U	/* PL310 event counters */
+/* Counts of a sample: the cycles, then the PMU and the L2 events */
+#define XIL_PERF_NUM_COUNTS	(1U + XIL_PERF_PMU_EVENTS + \
+				 XIL_PERF_L2_EVENTS)
+#define XIL_PERF_CYCLES		0U	/* Index of the cycles */
+#define XIL_PERF_PMU_FIRST	1U	/* Index of the first PMU event */
+#define XIL_PERF_L2_FIRST	(1U + XIL_PERF_PMU_EVENTS)
+#define XIL_PERF_NO_EVENT	0xFFU	/* Unused counter of a set */
+
+/**************************** Type Definitions *******************************/
+
+/**
+ * A named set of events.
+ */
+typedef struct {
+	const char *Name;
+	u8 Pmu[XIL_PERF_PMU_EVENTS];	/* XPM_EVENT_* or XIL_PERF_NO_EVENT */
+	u8 L2[XIL_PERF_L2_EVENTS];	/* XL2CC_* or XIL_PERF_NO_EVENT */
+} Xil_PerfEventSet;
+
+/**
+ * The counters at a point in time.
+ */
+typedef struct {
+	u64 Count[XIL_PERF_NUM_COUNTS];
+} Xil_PerfSample;
+
+/**
+ * A call site, static, with the counts of all its calls.
+ */
+typedef struct Xil_PerfSite {
+	const char *Name;
+	struct Xil_PerfSite *Next;	/* Sites measured, for the report */
+	volatile u32 Listed;
+	const Xil_PerfEventSet *Set;	/* Events the totals were taken with */
+	u32 Calls;
+	u64 Total[XIL_PERF_NUM_COUNTS];
+	u64 MaxCycles;			/* Longest call */
+} Xil_PerfSite;
+
+/**
+ * A measurement running at a site.
+ */
+typedef struct {
+	Xil_PerfSite *Site;
+	Xil_PerfSample Start;
+} Xil_PerfScope;
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/* Measures the rest of the enclosing block, at a site named Label */
+#define XIL_PERF_SCOPE(Label) \
+	static Xil_PerfSite XilPerfSite_##Label = { #Label, NULL, 0U, NULL, \
+						    0U, { 0U }, 0U }; \
+	Xil_PerfScope XilPerfScope_##Label \
+	__attribute__((cleanup(Xil_PerfEnd))) = \
+	Xil_PerfBegin(&XilPerfSite_##Label)
+
+/**
+*@endcond
+*/
+
+/************************** Function Prototypes ******************************/
+
+s32 Xil_PerfInitialize(void);
+s32 Xil_PerfSelect(const char *Name);
+s32 Xil_PerfSelectSet(const Xil_PerfEventSet *SetPtr);
+const Xil_PerfEventSet *Xil_PerfGetSet(void);
+void Xil_PerfRead(Xil_PerfSample *SamplePtr);
+Xil_PerfScope Xil_PerfBegin(Xil_PerfSite *SitePtr);
+void Xil_PerfEnd(Xil_PerfScope *ScopePtr);
+void Xil_PerfResetSites(void);
+void Xil_PerfReport(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* XIL_PERF_H */
+/**
+* @} End of "addtogroup a9_perf_apis".
+*/
@@ -0,0 +1,489 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_ring.c
+*
+* This file contains the lock-free rings. Refer to xil_ring.h for more
+* details.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+* @note
+*
+* A producer reads the tail, then writes the elements after a barrier, so
+* that it does not overwrite an element the consumer is still reading, and
+* writes the head after another. The consumer reads the head, the elements
+* after a barrier, and frees them with the tail after another. Only the
+* producers write the head and the claim, only the consumer the tail.
+*
+* A multiple producer moves the claim past its elements with LDREX/STREX
+* and, once they are written, waits until the head reaches them, that is
+* until the producers that claimed before it published, then moves the
+* head past them. The single producer has no claim: its elements are
+* claimed when the head moves.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+#include "xil_assert.h"
+#include "xstatus.h"
+#include "xil_mem.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xil_ring.h"
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/* Address of the element of a free running index */
+#define XIL_RING_ELEM(RingPtr, Pos) \
+	((RingPtr)->Data + (((Pos) & (RingPtr)->Mask) * (RingPtr)->ElemSize))
+
+/**************************** Type Definitions *******************************/
+
+/************************** Constant Definitions *****************************/
+
+/************************** Variable Definitions *****************************/
+
+/************************** Function Prototypes ******************************/
+
+static void Xil_RingBarrier(const Xil_Ring *RingPtr);
+static u32 Xil_RingClaim(Xil_Ring *RingPtr, u32 Count, u32 Contiguous,
+			 Xil_RingSpan *SpanPtr);
+static void Xil_RingPublish(Xil_Ring *RingPtr, const Xil_RingSpan *SpanPtr,
+			    u32 Count);
+static void Xil_RingCopy(Xil_Ring *RingPtr, u32 Pos, void *DstPtr,
+			 const void *SrcPtr, u32 Count, u32 ToRing);
+
+/*****************************************************************************/
+/**
+* @brief	Sets up an empty ring over its store.
+*
+* @param	RingPtr is the ring, cache line aligned.
+* @param	DataPtr is the store, NumElems * ElemSize bytes, preferably
+*			cache line aligned.
+* @param	NumElems is the number of elements, a power of two.
+* @param	ElemSize is the size of an element in bytes.
+* @param	Flags is 0, the same as XIL_RING_SMP, or XIL_RING_LOCAL,
+*			ored with XIL_RING_MP for multiple producers.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM if a size is not valid.
+*
+* @note		Call it before the producers and the consumer use the ring.
+*
+******************************************************************************/
+s32 Xil_RingInitialize(Xil_Ring *RingPtr, void *DataPtr, u32 NumElems,
+		       u32 ElemSize, u32 Flags)
+{
+	Xil_AssertNonvoid(RingPtr != NULL);
+
+	if ((DataPtr == NULL) || (NumElems == 0U) ||
+	    ((NumElems & (NumElems - 1U)) != 0U) || (ElemSize == 0U) ||
+	    (NumElems > (0x80000000U / ElemSize)) ||
+	    ((Flags & ~(XIL_RING_LOCAL | XIL_RING_MP)) != 0U)) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	RingPtr->Data = (u8 *)DataPtr;
+	RingPtr->Mask = NumElems - 1U;
+	RingPtr->ElemSize = ElemSize;
+	RingPtr->Flags = Flags;
+	RingPtr->Head = 0U;
+	RingPtr->Claim = 0U;
+	RingPtr->Tail = 0U;
+	dmb();
+
+	return (s32)XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Gives free elements to write in place, up to the end of the
+*		store. They are published by Xil_RingCommit().
+*
+* @param	RingPtr is the ring.
+* @param	Count is the number of elements wanted.
+* @param	SpanPtr is where the span is stored.
+*
+* @return	The number of elements of the span, 0 if the ring is full.
+*
+* @note		With XIL_RING_MP the IRQ of the calling CPU is masked from
+*		a span of at least one element until Xil_RingCommit().
+*
+******************************************************************************/
+u32 Xil_RingReserve(Xil_Ring *RingPtr, u32 Count, Xil_RingSpan *SpanPtr)
+{
+	Xil_AssertNonvoid(RingPtr != NULL);
+	Xil_AssertNonvoid(SpanPtr != NULL);
+
+	if (Xil_RingClaim(RingPtr, Count, 1U, SpanPtr) != 0U) {
+		SpanPtr->Ptr = XIL_RING_ELEM(RingPtr, SpanPtr->Pos);
+	}
+
+	return SpanPtr->Count;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Publishes the elements written in a span of Xil_RingReserve().
+*
+* @param	RingPtr is the ring.
+* @param	SpanPtr is the span.
+* @param	Count is the number of elements written, from the start of
+*			the span. With XIL_RING_MP it must be the whole span.
+*
+* @return	None.
+*
+******************************************************************************/
+void Xil_RingCommit(Xil_Ring *RingPtr, const Xil_RingSpan *SpanPtr,
+		    u32 Count)
+{
+	Xil_AssertVoid(RingPtr != NULL);
+	Xil_AssertVoid(SpanPtr != NULL);
+	Xil_AssertVoid(Count <= SpanPtr->Count);
+	Xil_AssertVoid(((RingPtr->Flags & XIL_RING_MP) == 0U) ||
+		       (Count == SpanPtr->Count));
+
+	if (SpanPtr->Count != 0U) {
+		Xil_RingPublish(RingPtr, SpanPtr, Count);
+	}
+}
+
+/*****************************************************************************/
+/**
+* @brief	Gives published elements to read in place, up to the end of
+*		the store. They stay in the ring until Xil_RingConsume().
+*
+* @param	RingPtr is the ring.
+* @param	Count is the number of elements wanted.
+* @param	SpanPtr is where the span is stored.
+*
+* @return	The number of elements of the span, 0 if the ring is empty.
+*
+******************************************************************************/
+u32 Xil_RingPeek(Xil_Ring *RingPtr, u32 Count, Xil_RingSpan *SpanPtr)
+{
+	u32 Tail;
+	u32 Avail;
+	u32 Room;
+
+	Xil_AssertNonvoid(RingPtr != NULL);
+	Xil_AssertNonvoid(SpanPtr != NULL);
+
+	Tail = RingPtr->Tail;
+	Avail = RingPtr->Head - Tail;
+	Room = (RingPtr->Mask + 1U) - (Tail & RingPtr->Mask);
+
+	/* The elements are read after the head */
+	Xil_RingBarrier(RingPtr);
+
+	if (Avail > Room) {
+		Avail = Room;
+	}
+	if (Avail > Count) {
+		Avail = Count;
+	}
+
+	SpanPtr->Ptr = XIL_RING_ELEM(RingPtr, Tail);
+	SpanPtr->Count = Avail;
+	SpanPtr->Pos = Tail;
+
+	return Avail;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Frees the oldest elements, read in place or skipped.
+*
+* @param	RingPtr is the ring.
+* @param	Count is the number of elements, at most Xil_RingCount().
+*
+* @return	None.
+*
+******************************************************************************/
+void Xil_RingConsume(Xil_Ring *RingPtr, u32 Count)
+{
+	u32 Tail;
+
+	Xil_AssertVoid(RingPtr != NULL);
+
+	Tail = RingPtr->Tail;
+	Xil_AssertVoid(Count <= (RingPtr->Head - Tail));
+
+	/* The elements are read before they are given back */
+	Xil_RingBarrier(RingPtr);
+	RingPtr->Tail = Tail + Count;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Copies elements into the ring, as many as fit.
+*
+* @param	RingPtr is the ring.
+* @param	DataPtr is the elements.
+* @param	Count is the number of elements.
+*
+* @return	The number of elements written, from the start of DataPtr.
+*
+* @note		The elements of one call are contiguous in the ring, also
+*		with XIL_RING_MP.
+*
+******************************************************************************/
+u32 Xil_RingWrite(Xil_Ring *RingPtr, const void *DataPtr, u32 Count)
+{
+	Xil_RingSpan Span;
+
+	Xil_AssertNonvoid(RingPtr != NULL);
+	Xil_AssertNonvoid((DataPtr != NULL) || (Count == 0U));
+
+	if (Xil_RingClaim(RingPtr, Count, 0U, &Span) != 0U) {
+		Xil_RingCopy(RingPtr, Span.Pos, NULL, DataPtr, Span.Count, 1U);
+		Xil_RingPublish(RingPtr, &Span, Span.Count);
+	}
+
+	return Span.Count;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Copies the oldest elements out of the ring and frees them.
+*
+* @param	RingPtr is the ring.
+* @param	BufferPtr is where the elements are copied.
+* @param	Count is the room of BufferPtr in elements.
+*
+* @return	The number of elements read, 0 if the ring is empty.
+*
+******************************************************************************/
+u32 Xil_RingRead(Xil_Ring *RingPtr, void *BufferPtr, u32 Count)
+{
+	u32 Tail;
+	u32 Avail;
+
+	Xil_AssertNonvoid(RingPtr != NULL);
+	Xil_AssertNonvoid((BufferPtr != NULL) || (Count == 0U));
+
+	Tail = RingPtr->Tail;
+	Avail = RingPtr->Head - Tail;
+	if (Avail > Count) {
+		Avail = Count;
+	}
+	if (Avail == 0U) {
+		return 0U;
+	}
+
+	/* The elements are read after the head */
+	Xil_RingBarrier(RingPtr);
+	Xil_RingCopy(RingPtr, Tail, BufferPtr, NULL, Avail, 0U);
+
+	/* And before they are given back */
+	Xil_RingBarrier(RingPtr);
+	RingPtr->Tail = Tail + Avail;
+
+	return Avail;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Gives the number of published elements. The other side may
+*		change it right after: it is a lower bound for the consumer
+*		and an upper bound for a producer.
+*
+* @param	RingPtr is the ring.
+*
+* @return	The number of elements.
+*
+******************************************************************************/
+u32 Xil_RingCount(const Xil_Ring *RingPtr)
+{
+	Xil_AssertNonvoid(RingPtr != NULL);
+
+	return RingPtr->Head - RingPtr->Tail;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Gives the number of free elements, those claimed by multiple
+*		producers not included. It is a lower bound for the single
+*		producer and an upper bound for the consumer.
+*
+* @param	RingPtr is the ring.
+*
+* @return	The number of elements.
+*
+******************************************************************************/
+u32 Xil_RingFree(const Xil_Ring *RingPtr)
+{
+	u32 Head;
+
+	Xil_AssertNonvoid(RingPtr != NULL);
+
+	Head = ((RingPtr->Flags & XIL_RING_MP) != 0U) ? RingPtr->Claim :
+	       RingPtr->Head;
+
+	return (RingPtr->Mask + 1U) - (Head - RingPtr->Tail);
+}
+
+/*****************************************************************************/
+/**
+* @brief	Orders the accesses to the elements with those to the
+*		indices, as the flags of the ring ask.
+*
+* @param	RingPtr is the ring.
+*
+* @return	None.
+*
+******************************************************************************/
+static void Xil_RingBarrier(const Xil_Ring *RingPtr)
+{
+	if ((RingPtr->Flags & XIL_RING_LOCAL) != 0U) {
+		__asm__ __volatile__ ("" : : : "memory");
+	} else {
+		dmb();
+	}
+}
+
+/*****************************************************************************/
+/**
+* @brief	Claims free elements for a producer.
+*
+* @param	RingPtr is the ring.
+* @param	Count is the number of elements wanted.
+* @param	Contiguous stops the claim at the end of the store.
+* @param	SpanPtr is where the position, the count and, with
+*			XIL_RING_MP, the CPSR to restore are stored.
+*
+* @return	The number of elements claimed. With XIL_RING_MP the IRQ is
+*		left masked when it is not 0.
+*
+******************************************************************************/
+static u32 Xil_RingClaim(Xil_Ring *RingPtr, u32 Count, u32 Contiguous,
+			 Xil_RingSpan *SpanPtr)
+{
+	u32 Size = RingPtr->Mask + 1U;
+	u32 Cpsr = 0U;
+	u32 Pos;
+	u32 Free;
+	u32 Room;
+
+	if ((RingPtr->Flags & XIL_RING_MP) != 0U) {
+		Cpsr = mfcpsr();
+		mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+	}
+
+	do {
+		Pos = ((RingPtr->Flags & XIL_RING_MP) != 0U) ?
+		      ldrex(&RingPtr->Claim) : RingPtr->Head;
+		Free = Size - (Pos - RingPtr->Tail);
+		Room = Size - (Pos & RingPtr->Mask);
+		if ((Contiguous != 0U) && (Free > Room)) {
+			Free = Room;
+		}
+		if (Free > Count) {
+			Free = Count;
+		}
+		if ((RingPtr->Flags & XIL_RING_MP) == 0U) {
+			break;
+		}
+		if (Free == 0U) {
+			clrex();
+			break;
+		}
+	} while (strex(&RingPtr->Claim, Pos + Free) != 0U);
+
+	if ((Free == 0U) && ((RingPtr->Flags & XIL_RING_MP) != 0U)) {
+		mtcpsr(Cpsr);
+	}
+
+	/* The consumer is done with the elements before the tail moved */
+	Xil_RingBarrier(RingPtr);
+
+	SpanPtr->Ptr = NULL;
+	SpanPtr->Count = Free;
+	SpanPtr->Pos = Pos;
+	SpanPtr->Cpsr = Cpsr;
+
+	return Free;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Publishes the elements of a claim, in claim order between
+*		multiple producers.
+*
+* @param	RingPtr is the ring.
+* @param	SpanPtr is the claim.
+* @param	Count is the number of elements to publish.
+*
+* @return	None.
+*
+******************************************************************************/
+static void Xil_RingPublish(Xil_Ring *RingPtr, const Xil_RingSpan *SpanPtr,
+			    u32 Count)
+{
+	/* The producers before this one run with their IRQ masked too */
+	while (RingPtr->Head != SpanPtr->Pos) {
+		;
+	}
+
+	/* The elements are seen before the head */
+	Xil_RingBarrier(RingPtr);
+	RingPtr->Head = SpanPtr->Pos + Count;
+
+	if ((RingPtr->Flags & XIL_RING_MP) != 0U) {
+		mtcpsr(SpanPtr->Cpsr);
+	}
+}
+
+/*****************************************************************************/
+/**
+* @brief	Copies elements between the store and a buffer, in two parts
+*		when they wrap.
+*
+* @param	RingPtr is the ring.
+* @param	Pos is the free running index of the first element.
+* @param	DstPtr is the buffer read into, when ToRing is 0.
+* @param	SrcPtr is the buffer written from, when ToRing is 1.
+* @param	Count is the number of elements.
+* @param	ToRing is the direction.
+*
+* @return	None.
+*
+******************************************************************************/
+static void Xil_RingCopy(Xil_Ring *RingPtr, u32 Pos, void *DstPtr,
+			 const void *SrcPtr, u32 Count, u32 ToRing)
+{
+	u32 First = (RingPtr->Mask + 1U) - (Pos & RingPtr->Mask);
+	u32 Bytes;
+	u32 FirstBytes;
+	u8 *ElemPtr = XIL_RING_ELEM(RingPtr, Pos);
+
+	if (First > Count) {
+		First = Count;
+	}
+	Bytes = Count * RingPtr->ElemSize;
+	FirstBytes = First * RingPtr->ElemSize;
+
+	if (ToRing != 0U) {
+		Xil_MemCpy(ElemPtr, SrcPtr, FirstBytes);
+		Xil_MemCpy(RingPtr->Data, (const u8 *)SrcPtr + FirstBytes,
+			   Bytes - FirstBytes);
+	} else {
+		Xil_MemCpy(DstPtr, ElemPtr, FirstBytes);
+		Xil_MemCpy((u8 *)DstPtr + FirstBytes, RingPtr->Data,
+			   Bytes - FirstBytes);
+	}
+}
+/**
+* @} End of "addtogroup a9_ring_apis".
+*/
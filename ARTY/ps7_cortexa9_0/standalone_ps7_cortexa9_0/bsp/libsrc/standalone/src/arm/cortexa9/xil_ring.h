@@ -0,0 +1,135 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_ring.h
+*
+* @addtogroup a9_ring_apis Cortex A9 Lock-Free Ring Buffer Functions
+*
+* Lock-free rings of fixed size elements, the primitive under the UART,
+* log and trace rings and the queues between the CPUs.
+*
+* A ring is a power-of-two number of elements of any size in a store of the
+* caller. The head and the tail are free running element counts, masked to
+* index the store, each on a cache line of its own: the producers only
+* write the head, the consumer only the tail. There is a single consumer.
+* With XIL_RING_MP any number of producers, on either CPU, threads or
+* handlers, share the ring; without it there is a single producer and no
+* atomic operation at all.
+*
+* The elements are moved either copied, with Xil_RingWrite() and
+* Xil_RingRead(), or in place, as contiguous spans of the store:
+*
+* - Xil_RingReserve() gives the free elements up to the end of the store,
+*   Xil_RingCommit() publishes those written;
+* - Xil_RingPeek() gives the published elements up to the end of the
+*   store, Xil_RingConsume() frees those used.
+*
+* A DMA or a copy loop may then work on a span directly. A bulk operation
+* that wraps takes two spans.
+*
+* The barriers between the elements and the indices are chosen per ring:
+*
+* - XIL_RING_SMP, the default, orders them with dmb, for rings between the
+*   two CPUs, SMP or AMP, in memory both see coherently through the SCU.
+* - XIL_RING_LOCAL only stops the compiler from reordering them, for rings
+*   between the threads and the handlers of one CPU, which sees its own
+*   accesses in order. It saves a dmb per operation.
+*
+* A multiple producer claims its span with LDREX/STREX on a claim index
+* and publishes in claim order, waiting for the producers that claimed
+* before it. It holds the IRQ of its CPU masked from Xil_RingReserve() to
+* Xil_RingCommit(), so that a handler never waits for the thread it
+* interrupted, and must commit all it reserved. The exclusive accesses
+* need the ring in normal cacheable memory, see xil_atomic.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/**
+*@cond nocomments
+*/
+
+#ifndef XIL_RING_H
+#define XIL_RING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+#define XIL_RING_LINE		32U	/* Bytes of an L1 cache line */
+
+/* Flags of Xil_RingInitialize() */
+#define XIL_RING_SMP		0x0U	/* dmb, between the CPUs */
+#define XIL_RING_LOCAL		0x1U	/* Compiler barrier, one CPU */
+#define XIL_RING_MP		0x2U	/* Multiple producers */
+
+/**************************** Type Definitions *******************************/
+
+/**
+ * A ring. Head - Tail is the number of published elements.
+ */
+typedef struct {
+	volatile u32 Head;	/* Published, by the producers */
+	volatile u32 Claim;	/* Claimed by the producers, XIL_RING_MP */
+	u8 HeadPad[XIL_RING_LINE - 8U];
+	volatile u32 Tail;	/* Consumed, by the consumer */
+	u8 TailPad[XIL_RING_LINE - 4U];
+	u8 *Data;		/* Store of the elements */
+	u32 Mask;		/* Number of elements less one */
+	u32 ElemSize;		/* Bytes of an element */
+	u32 Flags;		/* XIL_RING_* */
+} __attribute__((aligned(XIL_RING_LINE))) Xil_Ring;
+
+/**
+ * A contiguous span of the store, given by Xil_RingReserve() or
+ * Xil_RingPeek().
+ */
+typedef struct {
+	void *Ptr;		/* First element */
+	u32 Count;		/* Number of elements */
+	u32 Pos;		/* Free running index of the first element */
+	u32 Cpsr;		/* Of the producer, XIL_RING_MP */
+} Xil_RingSpan;
+
+/**
+*@endcond
+*/
+
+/************************** Function Prototypes ******************************/
+
+s32 Xil_RingInitialize(Xil_Ring *RingPtr, void *DataPtr, u32 NumElems,
+		       u32 ElemSize, u32 Flags);
+u32 Xil_RingReserve(Xil_Ring *RingPtr, u32 Count, Xil_RingSpan *SpanPtr);
+void Xil_RingCommit(Xil_Ring *RingPtr, const Xil_RingSpan *SpanPtr,
+		    u32 Count);
+u32 Xil_RingPeek(Xil_Ring *RingPtr, u32 Count, Xil_RingSpan *SpanPtr);
+void Xil_RingConsume(Xil_Ring *RingPtr, u32 Count);
+u32 Xil_RingWrite(Xil_Ring *RingPtr, const void *DataPtr, u32 Count);
+u32 Xil_RingRead(Xil_Ring *RingPtr, void *BufferPtr, u32 Count);
+u32 Xil_RingCount(const Xil_Ring *RingPtr);
+u32 Xil_RingFree(const Xil_Ring *RingPtr);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* XIL_RING_H */
+/**
+* @} End of "addtogroup a9_ring_apis".
+*/
@@ -0,0 +1,769 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_tlsf.c
+*
+* This file contains the TLSF heaps. Refer to xil_tlsf.h for more details.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+* @note
+*
+* The blocks of a heap follow each other in memory, each an 8 byte header
+* then its payload, and end with a sentinel header of an empty payload that
+* is never free. The size of a header is that of its payload, a multiple of
+* 8, with two flags in its low bits: the block is free, the block below is
+* free. The word before the size points to the block below, and is only
+* kept up to date while that block is free, for the merge of a free.
+*
+* A free block is in the list of its class, Free[Fl][Sl], linked through
+* its payload, which is why a payload is at least 8 bytes. Payload sizes
+* under 128 bytes are all in first level 0, by steps of 8; from 128 the
+* first level is the power of two below the size and the second level its
+* next XIL_TLSF_SL_LOG2 bits. An allocation searches from the class above
+* the one of its size, rounded up, so that any block found fits.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stddef.h>
+#include "xil_types.h"
+#include "xil_assert.h"
+#include "xstatus.h"
+#include "xil_mem.h"
+#include "xtime_l.h"
+#include "xil_tlsf.h"
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/* Payload of a block and block of a payload */
+#define XIL_TLSF_PAYLOAD(BlockPtr)	((void *)((u8 *)(BlockPtr) + \
+					 XIL_TLSF_HDR_SIZE))
+#define XIL_TLSF_BLOCK(Ptr)		((Xil_TlsfBlock *)(void *) \
+					 ((u8 *)(Ptr) - XIL_TLSF_HDR_SIZE))
+
+/* Block above a block */
+#define XIL_TLSF_NEXT(BlockPtr)		((Xil_TlsfBlock *)(void *) \
+					 ((u8 *)(BlockPtr) + XIL_TLSF_HDR_SIZE + \
+					  XIL_TLSF_SIZE(BlockPtr)))
+
+#define XIL_TLSF_SIZE(BlockPtr)		((BlockPtr)->Size & ~XIL_TLSF_FLAGS)
+
+/**************************** Type Definitions *******************************/
+
+/************************** Constant Definitions *****************************/
+
+/* PrevPhys and Size, then the free list links */
+#define XIL_TLSF_HDR_SIZE	((u32)offsetof(Xil_TlsfBlock, NextFree))
+#define XIL_TLSF_MIN_PAYLOAD	((u32)sizeof(Xil_TlsfBlock) - XIL_TLSF_HDR_SIZE)
+#define XIL_TLSF_MIN_BLOCK	(XIL_TLSF_HDR_SIZE + XIL_TLSF_MIN_PAYLOAD)
+#define XIL_TLSF_SMALL		(1U << XIL_TLSF_FL_SHIFT)
+#define XIL_TLSF_MAX_PAYLOAD	((1U << XIL_TLSF_FL_MAX_LOG2) - \
+				 XIL_TLSF_ALIGN)
+
+/* Flags of the size of a header */
+#define XIL_TLSF_FREE		0x1U
+#define XIL_TLSF_PREV_FREE	0x2U
+#define XIL_TLSF_FLAGS		(XIL_TLSF_FREE | XIL_TLSF_PREV_FREE)
+
+/************************** Variable Definitions *****************************/
+
+/************************** Function Prototypes ******************************/
+
+static u32 Xil_TlsfFls(u32 Value);
+static void Xil_TlsfMapping(u32 Size, u32 *FlPtr, u32 *SlPtr);
+static void Xil_TlsfInsert(Xil_Tlsf *TlsfPtr, Xil_TlsfBlock *BlockPtr);
+static void Xil_TlsfRemove(Xil_Tlsf *TlsfPtr, Xil_TlsfBlock *BlockPtr);
+static Xil_TlsfBlock *Xil_TlsfFind(Xil_Tlsf *TlsfPtr, u32 Size);
+static void Xil_TlsfSplit(Xil_Tlsf *TlsfPtr, Xil_TlsfBlock *BlockPtr,
+			  u32 Size);
+static void Xil_TlsfMarkUsed(Xil_Tlsf *TlsfPtr, Xil_TlsfBlock *BlockPtr);
+static void Xil_TlsfMarkFree(Xil_TlsfBlock *BlockPtr);
+static Xil_TlsfBlock *Xil_TlsfMerge(Xil_Tlsf *TlsfPtr,
+				    Xil_TlsfBlock *BlockPtr);
+static u32 Xil_TlsfAdjust(u32 Size);
+static u32 Xil_TlsfTicks(void);
+
+/*****************************************************************************/
+/**
+* @brief	Sets up a heap over a memory, one free block.
+*
+* @param	TlsfPtr is the heap, in normal cacheable memory.
+* @param	MemPtr is the memory of the blocks.
+* @param	Size is its size in bytes, under 1 GB.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM if the memory is too small
+*		or too large.
+*
+* @note		The blocks allocated before, if any, are lost.
+*
+******************************************************************************/
+s32 Xil_TlsfInitialize(Xil_Tlsf *TlsfPtr, void *MemPtr, u32 Size)
+{
+	UINTPTR Start;
+	UINTPTR End;
+	Xil_TlsfBlock *BlockPtr;
+	Xil_TlsfBlock *SentinelPtr;
+	u32 Fl;
+
+	Xil_AssertNonvoid(TlsfPtr != NULL);
+
+	Start = ((UINTPTR)MemPtr + (XIL_TLSF_ALIGN - 1U)) &
+		~(UINTPTR)(XIL_TLSF_ALIGN - 1U);
+	End = ((UINTPTR)MemPtr + Size) & ~(UINTPTR)(XIL_TLSF_ALIGN - 1U);
+	if ((MemPtr == NULL) || (Size >= (1U << XIL_TLSF_FL_MAX_LOG2)) ||
+	    (End < Start) ||
+	    ((End - Start) < (XIL_TLSF_MIN_BLOCK + XIL_TLSF_HDR_SIZE))) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	Xil_TicketLockInit(&TlsfPtr->Lock);
+	TlsfPtr->FlBitmap = 0U;
+	for (Fl = 0U; Fl < XIL_TLSF_FL_COUNT; Fl++) {
+		TlsfPtr->SlBitmap[Fl] = 0U;
+	}
+	Xil_MemSet(TlsfPtr->Free, 0U, sizeof(TlsfPtr->Free));
+	TlsfPtr->BaseAddr = Start;
+	TlsfPtr->Size = (u32)(End - Start);
+	TlsfPtr->Used = 0U;
+	TlsfPtr->HighWater = 0U;
+	TlsfPtr->Allocs = 0U;
+	TlsfPtr->Frees = 0U;
+	TlsfPtr->Failures = 0U;
+	TlsfPtr->MaxAllocTicks = 0U;
+	TlsfPtr->MaxFreeTicks = 0U;
+
+	/* One free block and the sentinel */
+	BlockPtr = (Xil_TlsfBlock *)Start;
+	BlockPtr->PrevPhys = NULL;
+	BlockPtr->Size = (TlsfPtr->Size - (2U * XIL_TLSF_HDR_SIZE)) |
+			 XIL_TLSF_FREE;
+	SentinelPtr = XIL_TLSF_NEXT(BlockPtr);
+	SentinelPtr->PrevPhys = BlockPtr;
+	SentinelPtr->Size = XIL_TLSF_PREV_FREE;
+	Xil_TlsfInsert(TlsfPtr, BlockPtr);
+	dmb();
+
+	return (s32)XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Allocates a block, in bounded time.
+*
+* @param	TlsfPtr is the heap.
+* @param	Size is the number of bytes wanted, 0 giving the smallest
+*			block.
+*
+* @return	The 8 byte aligned block, or NULL if no free block is large
+*		enough.
+*
+******************************************************************************/
+void *Xil_TlsfAlloc(Xil_Tlsf *TlsfPtr, u32 Size)
+{
+	Xil_TlsfBlock *BlockPtr = NULL;
+	u32 Adjusted;
+	u32 Start;
+	u32 Ticks;
+	u32 Cpsr;
+
+	Xil_AssertNonvoid(TlsfPtr != NULL);
+
+	Adjusted = Xil_TlsfAdjust(Size);
+
+	Cpsr = Xil_TicketLockIrqSave(&TlsfPtr->Lock);
+	Start = Xil_TlsfTicks();
+
+	if (Adjusted != 0U) {
+		BlockPtr = Xil_TlsfFind(TlsfPtr, Adjusted);
+	}
+	if (BlockPtr != NULL) {
+		Xil_TlsfSplit(TlsfPtr, BlockPtr, Adjusted);
+		Xil_TlsfMarkUsed(TlsfPtr, BlockPtr);
+		TlsfPtr->Allocs++;
+	} else {
+		TlsfPtr->Failures++;
+	}
+
+	Ticks = Xil_TlsfTicks() - Start;
+	if (Ticks > TlsfPtr->MaxAllocTicks) {
+		TlsfPtr->MaxAllocTicks = Ticks;
+	}
+	Xil_TicketLockIrqRestore(&TlsfPtr->Lock, Cpsr);
+
+	return (BlockPtr != NULL) ? XIL_TLSF_PAYLOAD(BlockPtr) : NULL;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Allocates a block aligned beyond 8 bytes, in bounded time.
+*
+* @param	TlsfPtr is the heap.
+* @param	Align is the alignment, a power of two.
+* @param	Size is the number of bytes wanted.
+*
+* @return	The aligned block, or NULL if no free block is large enough.
+*
+* @note		The search asks for Size + Align + 16 bytes, the gap below
+*		the aligned payload going back to the heap as a free block.
+*
+******************************************************************************/
+void *Xil_TlsfAllocAligned(Xil_Tlsf *TlsfPtr, u32 Align, u32 Size)
+{
+	Xil_TlsfBlock *BlockPtr = NULL;
+	Xil_TlsfBlock *AlignedPtr;
+	UINTPTR Payload;
+	UINTPTR Aligned;
+	u32 Adjusted;
+	u32 Gap;
+	u32 Start;
+	u32 Ticks;
+	u32 Cpsr;
+
+	Xil_AssertNonvoid(TlsfPtr != NULL);
+	Xil_AssertNonvoid((Align != 0U) && ((Align & (Align - 1U)) == 0U));
+
+	if (Align <= XIL_TLSF_ALIGN) {
+		return Xil_TlsfAlloc(TlsfPtr, Size);
+	}
+
+	Adjusted = Xil_TlsfAdjust(Size);
+	if ((Adjusted == 0U) ||
+	    (Align > (XIL_TLSF_MAX_PAYLOAD - Adjusted - XIL_TLSF_MIN_BLOCK))) {
+		Adjusted = 0U;
+	}
+
+	Cpsr = Xil_TicketLockIrqSave(&TlsfPtr->Lock);
+	Start = Xil_TlsfTicks();
+
+	if (Adjusted != 0U) {
+		BlockPtr = Xil_TlsfFind(TlsfPtr, Adjusted + Align +
+					XIL_TLSF_MIN_BLOCK);
+	}
+	if (BlockPtr != NULL) {
+		/* A gap below the payload must hold a free block */
+		Payload = (UINTPTR)XIL_TLSF_PAYLOAD(BlockPtr);
+		if ((Payload & (Align - 1U)) != 0U) {
+			Aligned = (Payload + XIL_TLSF_MIN_BLOCK + (Align - 1U)) &
+				  ~(UINTPTR)(Align - 1U);
+		} else {
+			Aligned = Payload;
+		}
+		Gap = (u32)(Aligned - Payload);
+		if (Gap != 0U) {
+			AlignedPtr = XIL_TLSF_BLOCK(Aligned);
+			AlignedPtr->PrevPhys = BlockPtr;
+			AlignedPtr->Size = (XIL_TLSF_SIZE(BlockPtr) - Gap) |
+					   XIL_TLSF_FREE | XIL_TLSF_PREV_FREE;
+			XIL_TLSF_NEXT(AlignedPtr)->PrevPhys = AlignedPtr;
+			BlockPtr->Size = (Gap - XIL_TLSF_HDR_SIZE) |
+					 (BlockPtr->Size & XIL_TLSF_FLAGS);
+			Xil_TlsfInsert(TlsfPtr, BlockPtr);
+			BlockPtr = AlignedPtr;
+		}
+		Xil_TlsfSplit(TlsfPtr, BlockPtr, Adjusted);
+		Xil_TlsfMarkUsed(TlsfPtr, BlockPtr);
+		TlsfPtr->Allocs++;
+	} else {
+		TlsfPtr->Failures++;
+	}
+
+	Ticks = Xil_TlsfTicks() - Start;
+	if (Ticks > TlsfPtr->MaxAllocTicks) {
+		TlsfPtr->MaxAllocTicks = Ticks;
+	}
+	Xil_TicketLockIrqRestore(&TlsfPtr->Lock, Cpsr);
+
+	return (BlockPtr != NULL) ? XIL_TLSF_PAYLOAD(BlockPtr) : NULL;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Resizes a block, in place when it shrinks or the block above
+*		is free and large enough, else by a new block and a copy.
+*
+* @param	TlsfPtr is the heap.
+* @param	Ptr is the block, NULL for a new one.
+* @param	Size is its new size in bytes, 0 to free it.
+*
+* @return	The block, or NULL if it could not grow, in which case Ptr is
+*		left as it was, or if it was freed.
+*
+******************************************************************************/
+void *Xil_TlsfRealloc(Xil_Tlsf *TlsfPtr, void *Ptr, u32 Size)
+{
+	Xil_TlsfBlock *BlockPtr;
+	Xil_TlsfBlock *NextPtr;
+	void *NewPtr = NULL;
+	u32 Adjusted;
+	u32 Current;
+	u32 Cpsr;
+
+	Xil_AssertNonvoid(TlsfPtr != NULL);
+
+	if (Ptr == NULL) {
+		return Xil_TlsfAlloc(TlsfPtr, Size);
+	}
+	if (Size == 0U) {
+		Xil_TlsfFree(TlsfPtr, Ptr);
+		return NULL;
+	}
+
+	Adjusted = Xil_TlsfAdjust(Size);
+	if (Adjusted == 0U) {
+		return NULL;
+	}
+	BlockPtr = XIL_TLSF_BLOCK(Ptr);
+
+	Cpsr = Xil_TicketLockIrqSave(&TlsfPtr->Lock);
+	Current = XIL_TLSF_SIZE(BlockPtr);
+	NextPtr = XIL_TLSF_NEXT(BlockPtr);
+	if ((Adjusted > Current) && ((NextPtr->Size & XIL_TLSF_FREE) != 0U) &&
+	    ((Current + XIL_TLSF_HDR_SIZE + XIL_TLSF_SIZE(NextPtr)) >=
+	     Adjusted)) {
+		/* Take the free block above */
+		Xil_TlsfRemove(TlsfPtr, NextPtr);
+		BlockPtr->Size += XIL_TLSF_HDR_SIZE + XIL_TLSF_SIZE(NextPtr);
+		XIL_TLSF_NEXT(BlockPtr)->Size &= ~XIL_TLSF_PREV_FREE;
+	}
+	if (XIL_TLSF_SIZE(BlockPtr) >= Adjusted) {
+		Xil_TlsfSplit(TlsfPtr, BlockPtr, Adjusted);
+		TlsfPtr->Used = (TlsfPtr->Used - Current) +
+				XIL_TLSF_SIZE(BlockPtr);
+		if (TlsfPtr->Used > TlsfPtr->HighWater) {
+			TlsfPtr->HighWater = TlsfPtr->Used;
+		}
+		NewPtr = Ptr;
+	}
+	Xil_TicketLockIrqRestore(&TlsfPtr->Lock, Cpsr);
+
+	if (NewPtr == NULL) {
+		NewPtr = Xil_TlsfAlloc(TlsfPtr, Size);
+		if (NewPtr != NULL) {
+			Xil_MemCpy(NewPtr, Ptr, Current);
+			Xil_TlsfFree(TlsfPtr, Ptr);
+		}
+	}
+
+	return NewPtr;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Frees a block, in bounded time.
+*
+* @param	TlsfPtr is the heap the block is from.
+* @param	Ptr is the block, NULL for none.
+*
+* @return	None.
+*
+******************************************************************************/
+void Xil_TlsfFree(Xil_Tlsf *TlsfPtr, void *Ptr)
+{
+	Xil_TlsfBlock *BlockPtr;
+	u32 Start;
+	u32 Ticks;
+	u32 Cpsr;
+
+	Xil_AssertVoid(TlsfPtr != NULL);
+
+	if (Ptr == NULL) {
+		return;
+	}
+	BlockPtr = XIL_TLSF_BLOCK(Ptr);
+	Xil_AssertVoid((BlockPtr->Size & XIL_TLSF_FREE) == 0U);
+
+	Cpsr = Xil_TicketLockIrqSave(&TlsfPtr->Lock);
+	Start = Xil_TlsfTicks();
+
+	TlsfPtr->Used -= XIL_TLSF_SIZE(BlockPtr);
+	TlsfPtr->Frees++;
+	Xil_TlsfMarkFree(BlockPtr);
+	BlockPtr = Xil_TlsfMerge(TlsfPtr, BlockPtr);
+	Xil_TlsfInsert(TlsfPtr, BlockPtr);
+
+	Ticks = Xil_TlsfTicks() - Start;
+	if (Ticks > TlsfPtr->MaxFreeTicks) {
+		TlsfPtr->MaxFreeTicks = Ticks;
+	}
+	Xil_TicketLockIrqRestore(&TlsfPtr->Lock, Cpsr);
+}
+
+/*****************************************************************************/
+/**
+* @brief	Gives the bytes a block can hold, its size rounded up.
+*
+* @param	Ptr is the block, NULL for none.
+*
+* @return	The size of its payload, 0 for NULL.
+*
+******************************************************************************/
+u32 Xil_TlsfUsableSize(const void *Ptr)
+{
+	if (Ptr == NULL) {
+		return 0U;
+	}
+
+	return XIL_TLSF_SIZE(XIL_TLSF_BLOCK(Ptr));
+}
+
+/*****************************************************************************/
+/**
+* @brief	Gives the use of a heap, walking its blocks for the free ones.
+*
+* @param	TlsfPtr is the heap.
+* @param	StatsPtr is where the use is stored.
+*
+* @return	None.
+*
+* @note		The walk holds the lock of the heap, with the IRQ masked,
+*		for a time that grows with the number of blocks.
+*
+******************************************************************************/
+void Xil_TlsfGetStats(Xil_Tlsf *TlsfPtr, Xil_TlsfStats *StatsPtr)
+{
+	Xil_TlsfBlock *BlockPtr;
+	u32 Size;
+	u32 Cpsr;
+
+	Xil_AssertVoid(TlsfPtr != NULL);
+	Xil_AssertVoid(StatsPtr != NULL);
+
+	Xil_MemSet(StatsPtr, 0U, sizeof(Xil_TlsfStats));
+
+	Cpsr = Xil_TicketLockIrqSave(&TlsfPtr->Lock);
+	BlockPtr = (Xil_TlsfBlock *)TlsfPtr->BaseAddr;
+	while (XIL_TLSF_SIZE(BlockPtr) != 0U) {
+		Size = XIL_TLSF_SIZE(BlockPtr);
+		if ((BlockPtr->Size & XIL_TLSF_FREE) != 0U) {
+			StatsPtr->FreeBytes += Size;
+			StatsPtr->FreeBlocks++;
+			if (Size > StatsPtr->LargestFree) {
+				StatsPtr->LargestFree = Size;
+			}
+		}
+		BlockPtr = XIL_TLSF_NEXT(BlockPtr);
+	}
+	StatsPtr->Size = TlsfPtr->Size;
+	StatsPtr->Used = TlsfPtr->Used;
+	StatsPtr->HighWater = TlsfPtr->HighWater;
+	StatsPtr->Allocs = TlsfPtr->Allocs;
+	StatsPtr->Frees = TlsfPtr->Frees;
+	StatsPtr->Failures = TlsfPtr->Failures;
+	StatsPtr->MaxAllocTicks = TlsfPtr->MaxAllocTicks;
+	StatsPtr->MaxFreeTicks = TlsfPtr->MaxFreeTicks;
+	Xil_TicketLockIrqRestore(&TlsfPtr->Lock, Cpsr);
+
+	if (StatsPtr->FreeBytes != 0U) {
+		StatsPtr->Fragmentation = 1000U -
+			(u32)(((u64)StatsPtr->LargestFree * 1000U) /
+			      StatsPtr->FreeBytes);
+	}
+}
+
+/*****************************************************************************/
+/**
+* @brief	Gives the position of the highest bit set.
+*
+* @param	Value is not 0.
+*
+* @return	0 to 31.
+*
+******************************************************************************/
+static u32 Xil_TlsfFls(u32 Value)
+{
+	return 31U - (u32)__builtin_clz(Value);
+}
+
+/*****************************************************************************/
+/**
+* @brief	Gives the class of a payload size.
+*
+* @param	Size is the payload size, a multiple of 8.
+* @param	FlPtr is where the first level is stored.
+* @param	SlPtr is where the second level is stored.
+*
+* @return	None.
+*
+******************************************************************************/
+static void Xil_TlsfMapping(u32 Size, u32 *FlPtr, u32 *SlPtr)
+{
+	u32 Fl;
+
+	if (Size < XIL_TLSF_SMALL) {
+		*FlPtr = 0U;
+		*SlPtr = Size / (XIL_TLSF_SMALL / XIL_TLSF_SL_COUNT);
+	} else {
+		Fl = Xil_TlsfFls(Size);
+		*SlPtr = (Size >> (Fl - XIL_TLSF_SL_LOG2)) ^ XIL_TLSF_SL_COUNT;
+		*FlPtr = Fl - (XIL_TLSF_FL_SHIFT - 1U);
+	}
+}
+
+/*****************************************************************************/
+/**
+* @brief	Puts a free block at the head of the list of its class.
+*
+* @param	TlsfPtr is the heap.
+* @param	BlockPtr is the block.
+*
+* @return	None.
+*
+******************************************************************************/
+static void Xil_TlsfInsert(Xil_Tlsf *TlsfPtr, Xil_TlsfBlock *BlockPtr)
+{
+	Xil_TlsfBlock *HeadPtr;
+	u32 Fl;
+	u32 Sl;
+
+	Xil_TlsfMapping(XIL_TLSF_SIZE(BlockPtr), &Fl, &Sl);
+	HeadPtr = TlsfPtr->Free[Fl][Sl];
+	BlockPtr->NextFree = HeadPtr;
+	BlockPtr->PrevFree = NULL;
+	if (HeadPtr != NULL) {
+		HeadPtr->PrevFree = BlockPtr;
+	}
+	TlsfPtr->Free[Fl][Sl] = BlockPtr;
+	TlsfPtr->FlBitmap |= (1U << Fl);
+	TlsfPtr->SlBitmap[Fl] |= (1U << Sl);
+}
+
+/*****************************************************************************/
+/**
+* @brief	Takes a free block out of the list of its class.
+*
+* @param	TlsfPtr is the heap.
+* @param	BlockPtr is the block.
+*
+* @return	None.
+*
+******************************************************************************/
+static void Xil_TlsfRemove(Xil_Tlsf *TlsfPtr, Xil_TlsfBlock *BlockPtr)
+{
+	u32 Fl;
+	u32 Sl;
+
+	Xil_TlsfMapping(XIL_TLSF_SIZE(BlockPtr), &Fl, &Sl);
+	if (BlockPtr->NextFree != NULL) {
+		BlockPtr->NextFree->PrevFree = BlockPtr->PrevFree;
+	}
+	if (BlockPtr->PrevFree != NULL) {
+		BlockPtr->PrevFree->NextFree = BlockPtr->NextFree;
+	} else {
+		TlsfPtr->Free[Fl][Sl] = BlockPtr->NextFree;
+		if (BlockPtr->NextFree == NULL) {
+			TlsfPtr->SlBitmap[Fl] &= ~(1U << Sl);
+			if (TlsfPtr->SlBitmap[Fl] == 0U) {
+				TlsfPtr->FlBitmap &= ~(1U << Fl);
+			}
+		}
+	}
+}
+
+/*****************************************************************************/
+/**
+* @brief	Takes a free block of at least a size, from the first list
+*		at or above the class of the size rounded up.
+*
+* @param	TlsfPtr is the heap.
+* @param	Size is the payload size, a multiple of 8.
+*
+* @return	The block, out of its list, or NULL.
+*
+******************************************************************************/
+static Xil_TlsfBlock *Xil_TlsfFind(Xil_Tlsf *TlsfPtr, u32 Size)
+{
+	Xil_TlsfBlock *BlockPtr;
+	u32 Fl;
+	u32 Sl;
+	u32 Map;
+
+	/* Any block of the class found is then large enough */
+	if (Size >= XIL_TLSF_SMALL) {
+		Size += (1U << (Xil_TlsfFls(Size) - XIL_TLSF_SL_LOG2)) - 1U;
+	}
+	Xil_TlsfMapping(Size, &Fl, &Sl);
+	if (Fl >= XIL_TLSF_FL_COUNT) {
+		return NULL;
+	}
+
+	Map = TlsfPtr->SlBitmap[Fl] & (0xFFFFFFFFU << Sl);
+	if (Map == 0U) {
+		Map = (Fl + 1U < 32U) ?
+		      (TlsfPtr->FlBitmap & (0xFFFFFFFFU << (Fl + 1U))) : 0U;
+		if (Map == 0U) {
+			return NULL;
+		}
+		Fl = (u32)__builtin_ctz(Map);
+		Map = TlsfPtr->SlBitmap[Fl];
+	}
+	Sl = (u32)__builtin_ctz(Map);
+
+	BlockPtr = TlsfPtr->Free[Fl][Sl];
+	Xil_TlsfRemove(TlsfPtr, BlockPtr);
+
+	return BlockPtr;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Gives the end of a block above a size back to the heap, when
+*		it holds a block of its own.
+*
+* @param	TlsfPtr is the heap.
+* @param	BlockPtr is the block, out of the free lists, to be used.
+* @param	Size is the payload size to keep, a multiple of 8.
+*
+* @return	None.
+*
+******************************************************************************/
+static void Xil_TlsfSplit(Xil_Tlsf *TlsfPtr, Xil_TlsfBlock *BlockPtr,
+			  u32 Size)
+{
+	Xil_TlsfBlock *RestPtr;
+	Xil_TlsfBlock *NextPtr;
+	u32 Current = XIL_TLSF_SIZE(BlockPtr);
+
+	if (Current < (Size + XIL_TLSF_MIN_BLOCK)) {
+		return;
+	}
+
+	BlockPtr->Size = Size | (BlockPtr->Size & XIL_TLSF_FLAGS);
+	RestPtr = XIL_TLSF_NEXT(BlockPtr);
+	RestPtr->Size = (Current - Size - XIL_TLSF_HDR_SIZE) | XIL_TLSF_FREE;
+
+	/* The rest may sit below a free block, after a realloc() */
+	RestPtr = Xil_TlsfMerge(TlsfPtr, RestPtr);
+	NextPtr = XIL_TLSF_NEXT(RestPtr);
+	NextPtr->PrevPhys = RestPtr;
+	NextPtr->Size |= XIL_TLSF_PREV_FREE;
+	Xil_TlsfInsert(TlsfPtr, RestPtr);
+}
+
+/*****************************************************************************/
+/**
+* @brief	Marks a block allocated and accounts it.
+*
+* @param	TlsfPtr is the heap.
+* @param	BlockPtr is the block, out of the free lists.
+*
+* @return	None.
+*
+******************************************************************************/
+static void Xil_TlsfMarkUsed(Xil_Tlsf *TlsfPtr, Xil_TlsfBlock *BlockPtr)
+{
+	BlockPtr->Size &= ~XIL_TLSF_FREE;
+	XIL_TLSF_NEXT(BlockPtr)->Size &= ~XIL_TLSF_PREV_FREE;
+
+	TlsfPtr->Used += XIL_TLSF_SIZE(BlockPtr);
+	if (TlsfPtr->Used > TlsfPtr->HighWater) {
+		TlsfPtr->HighWater = TlsfPtr->Used;
+	}
+}
+
+/*****************************************************************************/
+/**
+* @brief	Marks a block free, for the block above.
+*
+* @param	BlockPtr is the block.
+*
+* @return	None.
+*
+******************************************************************************/
+static void Xil_TlsfMarkFree(Xil_TlsfBlock *BlockPtr)
+{
+	Xil_TlsfBlock *NextPtr = XIL_TLSF_NEXT(BlockPtr);
+
+	BlockPtr->Size |= XIL_TLSF_FREE;
+	NextPtr->Size |= XIL_TLSF_PREV_FREE;
+	NextPtr->PrevPhys = BlockPtr;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Merges a free block, out of the lists, with the free blocks
+*		below and above it.
+*
+* @param	TlsfPtr is the heap.
+* @param	BlockPtr is the block.
+*
+* @return	The merged block, out of the lists.
+*
+******************************************************************************/
+static Xil_TlsfBlock *Xil_TlsfMerge(Xil_Tlsf *TlsfPtr,
+				    Xil_TlsfBlock *BlockPtr)
+{
+	Xil_TlsfBlock *PrevPtr;
+	Xil_TlsfBlock *NextPtr;
+
+	if ((BlockPtr->Size & XIL_TLSF_PREV_FREE) != 0U) {
+		PrevPtr = BlockPtr->PrevPhys;
+		Xil_TlsfRemove(TlsfPtr, PrevPtr);
+		PrevPtr->Size += XIL_TLSF_HDR_SIZE + XIL_TLSF_SIZE(BlockPtr);
+		BlockPtr = PrevPtr;
+	}
+
+	NextPtr = XIL_TLSF_NEXT(BlockPtr);
+	if ((NextPtr->Size & XIL_TLSF_FREE) != 0U) {
+		Xil_TlsfRemove(TlsfPtr, NextPtr);
+		BlockPtr->Size += XIL_TLSF_HDR_SIZE + XIL_TLSF_SIZE(NextPtr);
+	}
+	XIL_TLSF_NEXT(BlockPtr)->PrevPhys = BlockPtr;
+
+	return BlockPtr;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Gives the payload size of a request.
+*
+* @param	Size is the number of bytes asked for.
+*
+* @return	The size rounded up to 8, at least 8, or 0 if it is too
+*		large for any block.
+*
+******************************************************************************/
+static u32 Xil_TlsfAdjust(u32 Size)
+{
+	if (Size > XIL_TLSF_MAX_PAYLOAD) {
+		return 0U;
+	}
+	if (Size < XIL_TLSF_MIN_PAYLOAD) {
+		return XIL_TLSF_MIN_PAYLOAD;
+	}
+
+	return (Size + (XIL_TLSF_ALIGN - 1U)) & ~(XIL_TLSF_ALIGN - 1U);
+}
+
+/*****************************************************************************/
+/**
+* @brief	Reads the low word of the global timer, for the latencies.
+*
+* @return	The count, or 0 without XIL_TLSF_LATENCY.
+*
+******************************************************************************/
+static u32 Xil_TlsfTicks(void)
+{
+#if (XIL_TLSF_LATENCY != 0U)
+	XTime Now;
+
+	XTime_GetTime(&Now);
+
+	return (u32)Now;
+#else
+	return 0U;
+#endif
+}
+/**
+* @} End of "addtogroup a9_tlsf_apis".
+*/
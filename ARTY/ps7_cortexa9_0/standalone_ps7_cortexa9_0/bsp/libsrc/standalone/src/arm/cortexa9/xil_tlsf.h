@@ -0,0 +1,154 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_tlsf.h
+*
+* @addtogroup a9_tlsf_apis Cortex A9 TLSF Heap Functions
+*
+* Two-level segregated fit heaps: allocation of variable size blocks in
+* bounded time, for the frame reassembly and decompression windows that the
+* fixed blocks of xil_blockpool.h do not fit.
+*
+* A heap is set up over any memory with Xil_TlsfInitialize(), several heaps
+* may coexist, for instance one per arena of the region allocator of the
+* application. Its free blocks are kept in lists by size class: a first
+* level per power of two and XIL_TLSF_SL_COUNT second level classes
+* splitting each, with a bitmap of the lists that are not empty at each
+* level. Xil_TlsfAlloc() finds the first list large enough with two bit
+* scans, splits the block it takes and keeps the rest; Xil_TlsfFree()
+* merges the block with its free neighbours at once. Both are O(1), with no
+* search of a list, whatever the state of the heap. The price is a request
+* rounded up to the next class boundary, at most 1/XIL_TLSF_SL_COUNT more,
+* in the search.
+*
+* Blocks are 8 byte aligned with an 8 byte header, Xil_TlsfAllocAligned()
+* gives larger alignments. Each heap has a ticket lock of xil_atomic.h
+* taken with the IRQ masked, so that both CPUs and the interrupt handlers
+* may use it; the lock and the heap must be in normal cacheable memory.
+*
+* Xil_TlsfGetStats() gives the use of a heap: bytes in use now and at most,
+* the counts of the operations and the longest Xil_TlsfAlloc() and
+* Xil_TlsfFree(), in global timer counts, with XIL_TLSF_LATENCY. Its walk
+* of the heap for the free blocks, the largest one and the fragmentation
+* is not bounded, it is a diagnostic.
+*
+* With XIL_TLSF_MALLOC defined when building the BSP, the standalone option
+* standalone_tlsf_malloc, malloc() and the other functions of the C library
+* heap are served by a heap over the _heap_start to _heap_end of the linker
+* script instead of the allocator of newlib over _sbrk().
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/**
+*@cond nocomments
+*/
+
+#ifndef XIL_TLSF_H
+#define XIL_TLSF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+#include "xil_atomic.h"
+
+/************************** Constant Definitions *****************************/
+
+#define XIL_TLSF_ALIGN		8U	/* Alignment of every block */
+#define XIL_TLSF_SL_LOG2	4U	/* Second level classes, log2 */
+#define XIL_TLSF_SL_COUNT	(1U << XIL_TLSF_SL_LOG2)
+#define XIL_TLSF_FL_MAX_LOG2	30U	/* Largest block, log2 */
+#define XIL_TLSF_FL_SHIFT	(XIL_TLSF_SL_LOG2 + 3U)
+#define XIL_TLSF_FL_COUNT	(XIL_TLSF_FL_MAX_LOG2 - XIL_TLSF_FL_SHIFT + 1U)
+
+/* Times the operations with the global timer */
+#ifndef XIL_TLSF_LATENCY
+#define XIL_TLSF_LATENCY	1U
+#endif
+
+/**************************** Type Definitions *******************************/
+
+/**
+ * Header of a block, before its payload. The free list links are in the
+ * payload of a free block.
+ */
+typedef struct Xil_TlsfBlock {
+	struct Xil_TlsfBlock *PrevPhys;	/* Block below, when it is free */
+	u32 Size;			/* Of the payload, and flags */
+	struct Xil_TlsfBlock *NextFree;
+	struct Xil_TlsfBlock *PrevFree;
+} Xil_TlsfBlock;
+
+/**
+ * A heap.
+ */
+typedef struct {
+	Xil_TicketLock Lock;
+	u32 FlBitmap;			/* First levels with free blocks */
+	u32 SlBitmap[XIL_TLSF_FL_COUNT];
+	Xil_TlsfBlock *Free[XIL_TLSF_FL_COUNT][XIL_TLSF_SL_COUNT];
+	UINTPTR BaseAddr;		/* First block */
+	u32 Size;			/* Bytes of the blocks */
+	u32 Used;			/* Payload bytes allocated */
+	u32 HighWater;
+	u32 Allocs;
+	u32 Frees;
+	u32 Failures;
+	u32 MaxAllocTicks;
+	u32 MaxFreeTicks;
+} Xil_Tlsf;
+
+/**
+ * Use of a heap.
+ */
+typedef struct {
+	u32 Size;		/* Bytes of the blocks, headers included */
+	u32 Used;		/* Payload bytes allocated now */
+	u32 HighWater;		/* Most payload bytes allocated */
+	u32 FreeBytes;		/* Payload bytes of the free blocks */
+	u32 FreeBlocks;
+	u32 LargestFree;	/* Largest payload that fits now */
+	u32 Fragmentation;	/* 1000 - 1000 * LargestFree / FreeBytes */
+	u32 Allocs;
+	u32 Frees;
+	u32 Failures;		/* Allocations that found no block */
+	u32 MaxAllocTicks;	/* Longest allocation */
+	u32 MaxFreeTicks;	/* Longest free */
+} Xil_TlsfStats;
+
+/**
+*@endcond
+*/
+
+/************************** Function Prototypes ******************************/
+
+s32 Xil_TlsfInitialize(Xil_Tlsf *TlsfPtr, void *MemPtr, u32 Size);
+void *Xil_TlsfAlloc(Xil_Tlsf *TlsfPtr, u32 Size);
+void *Xil_TlsfAllocAligned(Xil_Tlsf *TlsfPtr, u32 Align, u32 Size);
+void *Xil_TlsfRealloc(Xil_Tlsf *TlsfPtr, void *Ptr, u32 Size);
+void Xil_TlsfFree(Xil_Tlsf *TlsfPtr, void *Ptr);
+u32 Xil_TlsfUsableSize(const void *Ptr);
+void Xil_TlsfGetStats(Xil_Tlsf *TlsfPtr, Xil_TlsfStats *StatsPtr);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* XIL_TLSF_H */
+/**
+* @} End of "addtogroup a9_tlsf_apis".
+*/
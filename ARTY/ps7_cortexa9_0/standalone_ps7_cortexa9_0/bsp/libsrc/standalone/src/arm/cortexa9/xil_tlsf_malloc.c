@@ -0,0 +1,295 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_tlsf_malloc.c
+*
+* This file contains the C library heap over a TLSF heap of xil_tlsf.h, with
+* XIL_TLSF_MALLOC defined. The heap takes the whole of _heap_start to
+* _heap_end and is set up at the first call.
+*
+* Both malloc() and _malloc_r() are defined, so that the reentrant calls of
+* newlib itself, for the stdio buffers, come here too and the allocator of
+* newlib over _sbrk() is never linked in.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+******************************************************************************/
+
+#ifdef XIL_TLSF_MALLOC
+
+/***************************** Include Files *********************************/
+
+#include <errno.h>
+#include <reent.h>
+#include <stddef.h>
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xil_mem.h"
+#include "xil_atomic.h"
+#include "xil_tlsf.h"
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/**************************** Type Definitions *******************************/
+
+/************************** Constant Definitions *****************************/
+
+/* States of the heap */
+#define XIL_TLSF_MALLOC_NONE	0U
+#define XIL_TLSF_MALLOC_INIT	1U
+#define XIL_TLSF_MALLOC_READY	2U
+#define XIL_TLSF_MALLOC_FAILED	3U
+
+/************************** Variable Definitions *****************************/
+
+extern u8 _heap_start[];
+extern u8 _heap_end[];
+
+static Xil_Tlsf Xil_TlsfMallocHeap;
+static volatile u32 Xil_TlsfMallocState = XIL_TLSF_MALLOC_NONE;
+
+/************************** Function Prototypes ******************************/
+
+static Xil_Tlsf *Xil_TlsfMallocGet(void);
+
+void *_malloc_r(struct _reent *Reent, size_t Size);
+void _free_r(struct _reent *Reent, void *Ptr);
+void *_realloc_r(struct _reent *Reent, void *Ptr, size_t Size);
+void *_calloc_r(struct _reent *Reent, size_t Count, size_t Size);
+void *_memalign_r(struct _reent *Reent, size_t Align, size_t Size);
+size_t _malloc_usable_size_r(struct _reent *Reent, void *Ptr);
+void *memalign(size_t Align, size_t Size);
+size_t malloc_usable_size(void *Ptr);
+
+/*****************************************************************************/
+/**
+* @brief	Allocates a block of the C library heap.
+*
+* @param	Reent is the reentrancy structure of the caller.
+* @param	Size is the number of bytes wanted.
+*
+* @return	The 8 byte aligned block, or NULL with errno set to ENOMEM.
+*
+******************************************************************************/
+void *_malloc_r(struct _reent *Reent, size_t Size)
+{
+	Xil_Tlsf *TlsfPtr = Xil_TlsfMallocGet();
+	void *Ptr = NULL;
+
+	if ((TlsfPtr != NULL) && (Size <= 0xFFFFFFFFU)) {
+		Ptr = Xil_TlsfAlloc(TlsfPtr, (u32)Size);
+	}
+	if (Ptr == NULL) {
+		Reent->_errno = ENOMEM;
+	}
+
+	return Ptr;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Frees a block of the C library heap.
+*
+* @param	Reent is the reentrancy structure of the caller.
+* @param	Ptr is the block, NULL for none.
+*
+* @return	None.
+*
+******************************************************************************/
+void _free_r(struct _reent *Reent, void *Ptr)
+{
+	(void)Reent;
+
+	if (Ptr != NULL) {
+		Xil_TlsfFree(&Xil_TlsfMallocHeap, Ptr);
+	}
+}
+
+/*****************************************************************************/
+/**
+* @brief	Resizes a block of the C library heap.
+*
+* @param	Reent is the reentrancy structure of the caller.
+* @param	Ptr is the block, NULL for a new one.
+* @param	Size is its new size in bytes, 0 to free it.
+*
+* @return	The block, or NULL with errno set to ENOMEM and Ptr left as
+*		it was, or NULL if it was freed.
+*
+******************************************************************************/
+void *_realloc_r(struct _reent *Reent, void *Ptr, size_t Size)
+{
+	void *NewPtr;
+
+	if (Ptr == NULL) {
+		return _malloc_r(Reent, Size);
+	}
+	if (Size == 0U) {
+		Xil_TlsfFree(&Xil_TlsfMallocHeap, Ptr);
+		return NULL;
+	}
+
+	NewPtr = Xil_TlsfRealloc(&Xil_TlsfMallocHeap, Ptr, (u32)Size);
+	if (NewPtr == NULL) {
+		Reent->_errno = ENOMEM;
+	}
+
+	return NewPtr;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Allocates a zeroed array of the C library heap.
+*
+* @param	Reent is the reentrancy structure of the caller.
+* @param	Count is the number of elements.
+* @param	Size is the size of an element.
+*
+* @return	The block, or NULL with errno set to ENOMEM.
+*
+******************************************************************************/
+void *_calloc_r(struct _reent *Reent, size_t Count, size_t Size)
+{
+	void *Ptr;
+	u64 Total = (u64)Count * Size;
+
+	if (Total > 0xFFFFFFFFU) {
+		Reent->_errno = ENOMEM;
+		return NULL;
+	}
+
+	Ptr = _malloc_r(Reent, (size_t)Total);
+	if (Ptr != NULL) {
+		Xil_MemSet(Ptr, 0U, (u32)Total);
+	}
+
+	return Ptr;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Allocates an aligned block of the C library heap.
+*
+* @param	Reent is the reentrancy structure of the caller.
+* @param	Align is the alignment, a power of two.
+* @param	Size is the number of bytes wanted.
+*
+* @return	The block, or NULL with errno set to ENOMEM or EINVAL.
+*
+******************************************************************************/
+void *_memalign_r(struct _reent *Reent, size_t Align, size_t Size)
+{
+	Xil_Tlsf *TlsfPtr = Xil_TlsfMallocGet();
+	void *Ptr = NULL;
+
+	if ((Align == 0U) || ((Align & (Align - 1U)) != 0U)) {
+		Reent->_errno = EINVAL;
+		return NULL;
+	}
+
+	if (TlsfPtr != NULL) {
+		Ptr = Xil_TlsfAllocAligned(TlsfPtr, (u32)Align, (u32)Size);
+	}
+	if (Ptr == NULL) {
+		Reent->_errno = ENOMEM;
+	}
+
+	return Ptr;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Gives the bytes a block of the C library heap can hold.
+*
+* @param	Reent is the reentrancy structure of the caller.
+* @param	Ptr is the block, NULL for none.
+*
+* @return	The size of the block, 0 for NULL.
+*
+******************************************************************************/
+size_t _malloc_usable_size_r(struct _reent *Reent, void *Ptr)
+{
+	(void)Reent;
+
+	return Xil_TlsfUsableSize(Ptr);
+}
+
+/*****************************************************************************/
+/**
+* @brief	The entries of the C library, over the reentrant ones.
+*
+******************************************************************************/
+void *malloc(size_t Size)
+{
+	return _malloc_r(_REENT, Size);
+}
+
+void free(void *Ptr)
+{
+	_free_r(_REENT, Ptr);
+}
+
+void *realloc(void *Ptr, size_t Size)
+{
+	return _realloc_r(_REENT, Ptr, Size);
+}
+
+void *calloc(size_t Count, size_t Size)
+{
+	return _calloc_r(_REENT, Count, Size);
+}
+
+void *memalign(size_t Align, size_t Size)
+{
+	return _memalign_r(_REENT, Align, Size);
+}
+
+size_t malloc_usable_size(void *Ptr)
+{
+	return _malloc_usable_size_r(_REENT, Ptr);
+}
+
+/*****************************************************************************/
+/**
+* @brief	Gives the heap, set up over _heap_start to _heap_end at the
+*		first call. The CPU that loses the race to set it up waits
+*		for the other.
+*
+* @return	The heap, or NULL if the linker script gives no heap.
+*
+******************************************************************************/
+static Xil_Tlsf *Xil_TlsfMallocGet(void)
+{
+	u32 State = Xil_AtomicLoadAcquire(&Xil_TlsfMallocState);
+
+	if (State == XIL_TLSF_MALLOC_NONE) {
+		if (Xil_AtomicCas(&Xil_TlsfMallocState, XIL_TLSF_MALLOC_NONE,
+				  XIL_TLSF_MALLOC_INIT) == XIL_TLSF_MALLOC_NONE) {
+			if (Xil_TlsfInitialize(&Xil_TlsfMallocHeap, _heap_start,
+					       (u32)(_heap_end - _heap_start)) ==
+			    (s32)XST_SUCCESS) {
+				State = XIL_TLSF_MALLOC_READY;
+			} else {
+				State = XIL_TLSF_MALLOC_FAILED;
+			}
+			Xil_AtomicStoreRelease(&Xil_TlsfMallocState, State);
+		}
+	}
+	while ((State == XIL_TLSF_MALLOC_NONE) ||
+	       (State == XIL_TLSF_MALLOC_INIT)) {
+		State = Xil_AtomicLoadAcquire(&Xil_TlsfMallocState);
+	}
+
+	return (State == XIL_TLSF_MALLOC_READY) ? &Xil_TlsfMallocHeap : NULL;
+}
+
+#endif /* XIL_TLSF_MALLOC */
@@ -0,0 +1,121 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_trace.c
+*
+* This file holds the trace buffer and its control. Refer to xil_trace.h
+* for more details.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+#include "xil_printf.h"
+#include "xil_hotpath.h"
+#include "xtime_l.h"
+#include "xil_trace.h"
+
+/************************** Variable Definitions *****************************/
+
+/* Cleared before main(), Enabled is 0 until Xil_TraceStart() */
+XIL_FAST_BSS Xil_TraceBuffer Xil_TraceBuf;
+
+/*****************************************************************************/
+/**
+*
+* Empties the trace and starts recording.
+*
+* @return	None.
+*
+* @note		Call it from one CPU while no event is being recorded.
+*
+******************************************************************************/
+void Xil_TraceStart(void)
+{
+	u32 Cpu;
+
+	Xil_TraceBuf.Enabled = 0U;
+	dmb();
+
+	Xil_TraceBuf.Magic = XIL_TRACE_MAGIC;
+	Xil_TraceBuf.NumRecords = XIL_TRACE_RECORDS;
+	Xil_TraceBuf.TimerHz = COUNTS_PER_SECOND;
+	for (Cpu = 0U; Cpu < XIL_NUM_CPUS; Cpu++) {
+		Xil_TraceBuf.Cpu[Cpu].Index = 0U;
+	}
+
+	dmb();
+	Xil_TraceBuf.Enabled = 1U;
+}
+
+/*****************************************************************************/
+/**
+*
+* Stops recording, the trace keeps its events to be read out.
+*
+* @return	None.
+*
+******************************************************************************/
+void Xil_TraceStop(void)
+{
+	Xil_TraceBuf.Enabled = 0U;
+	dmb();
+}
+
+/*****************************************************************************/
+/**
+*
+* Stops recording and prints the trace on the standard output: a line
+* "XTRC <cpus> <records> <timer Hz>", then for each CPU a line
+* "CPU <cpu> <index>" followed by its records from the oldest, one per
+* line as four hexadecimal words, and "END".
+*
+* @return	None.
+*
+* @note		The printing itself is not traced. The trace is left
+*		stopped, Xil_TraceStart() starts a new one.
+*
+******************************************************************************/
+void Xil_TraceDump(void)
+{
+	const Xil_TraceRecord *RecordPtr;
+	u32 Cpu;
+	u32 Index;
+	u32 First;
+	u32 Slot;
+
+	Xil_TraceStop();
+
+	xil_printf("XTRC %u %u %u\r\n", XIL_NUM_CPUS, XIL_TRACE_RECORDS,
+		   Xil_TraceBuf.TimerHz);
+
+	for (Cpu = 0U; Cpu < XIL_NUM_CPUS; Cpu++) {
+		Index = Xil_TraceBuf.Cpu[Cpu].Index;
+		xil_printf("CPU %u %u\r\n", Cpu, Index);
+
+		First = (Index > XIL_TRACE_RECORDS) ?
+			(Index - XIL_TRACE_RECORDS) : 0U;
+		for (Slot = First; Slot != Index; Slot++) {
+			RecordPtr = &Xil_TraceBuf.Record[Cpu][Slot &
+					(XIL_TRACE_RECORDS - 1U)];
+			xil_printf("%08x %04x%04x %08x %08x\r\n",
+				   RecordPtr->Time, (u32)RecordPtr->Cpu,
+				   (u32)RecordPtr->Id, RecordPtr->Arg0,
+				   RecordPtr->Arg1);
+		}
+	}
+
+	xil_printf("END\r\n");
+}
@@ -0,0 +1,200 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_trace.h
+*
+* @addtogroup a9_trace_apis Cortex A9 Event Trace
+*
+* A trace of the last events of each CPU, to see what led to a latency
+* spike in the field.
+*
+* An event is a 16 byte record: the lower word of the global timer, the
+* event ID, the CPU and two arguments. Each CPU has its own ring of
+* XIL_TRACE_RECORDS records in Xil_TraceBuf, in the low OCM, and its own
+* index into it. An event takes the next slot of its CPU with an exclusive
+* increment of the index, so that the events of an interrupt taken in the
+* middle of another one are kept too, and nothing is shared between the
+* CPUs: tracing takes no lock and costs a few tens of cycles. The rings
+* wrap, only the last events are kept.
+*
+* The trace points are compiled in when XIL_TRACE is defined, otherwise
+* XIL_TRACE_EVENT() is empty. They are:
+* - XIL_TRACE_ID_IRQ, around each handler called by the XScuGic dispatcher,
+*   with the interrupt ID.
+* - XIL_TRACE_ID_UART, around the XUartPs interrupt handler, with the base
+*   address of the UART and the interrupt status.
+* - XIL_TRACE_ID_DMA_DONE, when a PL330 channel completes, with the channel
+*   and the status of the command.
+* - XIL_TRACE_ID_PCAP, at each devcfg interrupt, with its status.
+* - XIL_TRACE_ID_TASK, around each run of a task of the coroutine scheduler
+*   of the application, with the index and the address of the task.
+* The application adds its own from XIL_TRACE_ID_USER.
+*
+* Events are only recorded between Xil_TraceStart() and Xil_TraceStop().
+* The trace is read out in one of two ways:
+* - Over JTAG, with the CPUs stopped: XSCT reads Xil_TraceBuf as it is,
+*   "mrd -bin -file trace.bin &Xil_TraceBuf <words>", its size being
+*   sizeof(Xil_TraceBuffer) / 4 words.
+* - Over the standard output, the debug UART, with Xil_TraceDump(), which
+*   prints the records as lines of hexadecimal words.
+* tools/trace_export.py turns either into the JSON trace event format read
+* by Perfetto and chrome://tracing.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/**
+*@cond nocomments
+*/
+
+#ifndef XIL_TRACE_H
+#define XIL_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+#include "xil_io.h"
+#include "xil_atomic.h"
+#include "xpseudo_asm.h"
+#include "xparameters_ps.h"
+
+/************************** Constant Definitions *****************************/
+
+#ifndef XIL_TRACE_RECORDS
+#define XIL_TRACE_RECORDS	256U	/* Records per CPU, a power of 2 */
+#endif
+
+#define XIL_TRACE_MAGIC		0x43525458U	/* "XTRC" */
+
+/* Lower word of the global timer, GTIMER_COUNTER_LOWER_OFFSET of xtime_l.h */
+#define XIL_TRACE_TIMER		(XPAR_GLOBAL_TMR_BASEADDR + 0x00U)
+
+/* Phase of an event, in the upper bits of its ID */
+#define XIL_TRACE_INSTANT	0x0000U
+#define XIL_TRACE_BEGIN		0x4000U
+#define XIL_TRACE_END		0x8000U
+#define XIL_TRACE_PHASE_MASK	0xC000U
+
+/* Events of the BSP */
+#define XIL_TRACE_ID_IRQ	0x0001U	/* Arg0: interrupt ID */
+#define XIL_TRACE_ID_UART	0x0002U	/* Arg0: base address, Arg1: ISR */
+#define XIL_TRACE_ID_DMA_DONE	0x0003U	/* Arg0: channel, Arg1: status */
+#define XIL_TRACE_ID_PCAP	0x0004U	/* Arg0: interrupt status */
+#define XIL_TRACE_ID_TASK	0x0005U	/* Arg0: task index, Arg1: task */
+#define XIL_TRACE_ID_USER	0x0100U	/* First event of the application */
+
+/**************************** Type Definitions *******************************/
+
+/**
+ * An event.
+ */
+typedef struct {
+	u32 Time;	/* Lower word of the global timer */
+	u16 Id;		/* XIL_TRACE_ID_* with its phase */
+	u16 Cpu;
+	u32 Arg0;
+	u32 Arg1;
+} Xil_TraceRecord;
+
+/**
+ * The trace, as read by the host: a header of 32 bytes, the indexes of the
+ * CPUs in a cache line each, then the rings of the CPUs one after the other.
+ */
+typedef struct {
+	u32 Magic;		/* XIL_TRACE_MAGIC once started */
+	u32 NumRecords;		/* XIL_TRACE_RECORDS */
+	u32 TimerHz;		/* Rate of the Time of the records */
+	volatile u32 Enabled;
+	u32 Reserved[4];
+	struct __attribute__((aligned(XIL_ATOMIC_CACHE_LINE))) {
+		volatile u32 Index;	/* Events recorded, slot of the next */
+		u32 Reserved[7];
+	} Cpu[XIL_NUM_CPUS];
+	Xil_TraceRecord Record[XIL_NUM_CPUS][XIL_TRACE_RECORDS];
+} Xil_TraceBuffer;
+
+/************************** Variable Definitions *****************************/
+
+extern Xil_TraceBuffer Xil_TraceBuf;
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+#if defined (XIL_TRACE)
+#define XIL_TRACE_EVENT(Id, Arg0, Arg1) \
+	Xil_TraceEvent((Id), (u32)(Arg0), (u32)(Arg1))
+#else
+#define XIL_TRACE_EVENT(Id, Arg0, Arg1)	((void)0)
+#endif
+
+/**
+*@endcond
+*/
+
+/*****************************************************************************/
+/**
+* @brief	Records an event of the calling CPU, if the trace is started.
+*
+* @param	Id is the event ID with its phase, XIL_TRACE_BEGIN,
+*		XIL_TRACE_END or XIL_TRACE_INSTANT.
+* @param	Arg0 is the first argument of the event.
+* @param	Arg1 is the second argument of the event.
+*
+* @return	None.
+*
+* @note		Use XIL_TRACE_EVENT(), which is empty without XIL_TRACE.
+*
+******************************************************************************/
+static INLINE void Xil_TraceEvent(u32 Id, u32 Arg0, u32 Arg1)
+{
+	Xil_TraceRecord *RecordPtr;
+	volatile u32 *IndexPtr;
+	u32 Cpu;
+	u32 Slot;
+
+	if (Xil_TraceBuf.Enabled == 0U) {
+		return;
+	}
+
+	/* Only this CPU writes its index, an interrupt may come in between */
+	Cpu = Xil_CpuId();
+	IndexPtr = &Xil_TraceBuf.Cpu[Cpu].Index;
+	do {
+		Slot = ldrex(IndexPtr);
+	} while (strex(IndexPtr, Slot + 1U) != 0U);
+
+	RecordPtr = &Xil_TraceBuf.Record[Cpu][Slot & (XIL_TRACE_RECORDS - 1U)];
+	RecordPtr->Time = Xil_In32(XIL_TRACE_TIMER);
+	RecordPtr->Id = (u16)Id;
+	RecordPtr->Cpu = (u16)Cpu;
+	RecordPtr->Arg0 = Arg0;
+	RecordPtr->Arg1 = Arg1;
+}
+
+/************************** Function Prototypes ******************************/
+
+void Xil_TraceStart(void);
+void Xil_TraceStop(void);
+void Xil_TraceDump(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* XIL_TRACE_H */
+/**
+* @} End of "addtogroup a9_trace_apis".
+*/
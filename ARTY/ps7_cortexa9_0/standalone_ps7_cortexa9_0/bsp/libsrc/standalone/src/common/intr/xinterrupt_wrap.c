@@ -27,16 +27,23 @@
 * 		      transformation.
 * 9.2   ml   19/09/24 Fix compilation warnings by typecasting and adding
 *                     conditional compilation checks.
+* 9.3   qm   14/10/26 Added XGetScuGicInstance().
+*       qm   14/10/26 GIC instance in the OCM with XIL_DRIVER_HOT_LAYOUT.
 * </pre>
 *
 ******************************************************************************/
 
 #include "xinterrupt_wrap.h"
+#if defined (XIL_DRIVER_HOT_LAYOUT)
+#include "xil_hotpath.h"
+#else
+#define XIL_HOT_INSTANCE
+#endif
 
 #ifdef XIL_INTERRUPT
 
 #if defined (XPAR_SCUGIC) /* available in xscugic.h */
-static XScuGic XScuGicInstance;
+static XScuGic XScuGicInstance XIL_HOT_INSTANCE;
 static int ScuGicInitialized;
 #endif
 
@@ -597,4 +604,28 @@ s32 XTriggerSoftwareIntr(u32 IntrId, UINTPTR IntcParent, u32 Cpu_Id)
 
 }
 
+#if defined (XPAR_SCUGIC)
+/*****************************************************************************/
+/**
+*
+* @brief    Returns the GIC instance of the wrapper, for the XScuGic calls
+*           the wrapper has no function for, as the CPU targets or the
+*           statistics.
+*
+* @return   Pointer to the instance, or NULL if the GIC is not initialized
+*           yet.
+*
+* @note     None.
+*
+******************************************************************************/
+XScuGic *XGetScuGicInstance(void)
+{
+	if (XScuGicInstance.IsReady != XIL_COMPONENT_IS_READY) {
+		return NULL;
+	}
+
+	return &XScuGicInstance;
+}
+#endif
+
 #endif
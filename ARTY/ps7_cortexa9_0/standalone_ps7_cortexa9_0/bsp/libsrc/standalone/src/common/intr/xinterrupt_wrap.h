@@ -24,6 +24,7 @@
 * 9.2   ml   05/08/24 Add Support for connecting fast interrupt for intc.
 * 9.2   ml   09/20/24 Added conditional compilation checks to avoid unused
 * 		      declarations.
+* 9.3   qm   10/14/26 Added XGetScuGicInstance().
 * </pre>
 *
 ******************************************************************************/
@@ -129,6 +130,9 @@ extern int XSetupInterruptSystem(void *DriverInstance, void *IntrHandler, u32 In
 extern s32 XGetEncodedIntrId(u32 LegacyIntrId, u32 TriggerType, u8 IntrType, u8 IntcType,
 			     u32 *IntrId);
 extern s32 XTriggerSoftwareIntr(u32 IntrId, UINTPTR IntcParent, u32 Cpu_Id);
+#if defined (XPAR_SCUGIC)
+extern XScuGic *XGetScuGicInstance(void);
+#endif
 #endif
 
 #ifdef __cplusplus
@@ -34,6 +34,8 @@
 *                         when -Werror=conversion compiler flag is enabled
 * 7.5   mus      05/17/21 Update the functions with comments. It fixes CR#1067739.
 * 9.0   ml       03/03/23 Add description and remove comments to fix doxygen warnings.
+* 9.3   qm       10/14/26 With XIL_IO_SIM defined the accesses go to the register
+*                         simulation of xil_iosim.h, for host builds.
 * </pre>
 ******************************************************************************/
 
@@ -50,7 +52,9 @@ extern "C" {
 #include "xil_printf.h"
 #include "xstatus.h"
 
-#if defined (__MICROBLAZE__)
+#if defined (XIL_IO_SIM)
+#include "xil_iosim.h"
+#elif defined (__MICROBLAZE__)
 #include "mb_interface.h"
 #else
 #include "xpseudo_asm.h"
@@ -62,7 +66,11 @@ extern u32 XStl_RegUpdate(u32 RegAddr, u32 RegVal);
 #endif
 
 /***************** Macros (Inline Functions) Definitions *********************/
-#if defined __GNUC__
+#if defined (XIL_IO_SIM)
+# define SYNCHRONIZE_IO /**< Data Memory Barrier */
+# define INST_SYNC /**< Instruction Synchronization Barrier */
+# define DATA_SYNC /**<  Data Synchronization Barrier  */
+#elif defined __GNUC__
 #if defined (__MICROBLAZE__)
 #  define INST_SYNC		mbar(0) /**< Instruction Synchronization Barrier */
 #  define DATA_SYNC		mbar(1) /**<  Data Synchronization Barrier  */
@@ -100,7 +108,11 @@ extern u32 XStl_RegUpdate(u32 RegAddr, u32 RegVal);
 ******************************************************************************/
 static INLINE u8 Xil_In8(UINTPTR Addr)
 {
+#if defined (XIL_IO_SIM)
+	return (u8)XilIoSim_Read(Addr, 8U);
+#else
 	return *(volatile u8 *) Addr;
+#endif
 }
 
 /*****************************************************************************/
@@ -117,7 +129,11 @@ static INLINE u8 Xil_In8(UINTPTR Addr)
 ******************************************************************************/
 static INLINE u16 Xil_In16(UINTPTR Addr)
 {
+#if defined (XIL_IO_SIM)
+	return (u16)XilIoSim_Read(Addr, 16U);
+#else
 	return *(volatile u16 *) Addr;
+#endif
 }
 
 /*****************************************************************************/
@@ -134,7 +150,11 @@ static INLINE u16 Xil_In16(UINTPTR Addr)
 ******************************************************************************/
 static INLINE u32 Xil_In32(UINTPTR Addr)
 {
+#if defined (XIL_IO_SIM)
+	return (u32)XilIoSim_Read(Addr, 32U);
+#else
 	return *(volatile u32 *) Addr;
+#endif
 }
 
 /*****************************************************************************/
@@ -151,7 +171,11 @@ static INLINE u32 Xil_In32(UINTPTR Addr)
 ******************************************************************************/
 static INLINE u64 Xil_In64(UINTPTR Addr)
 {
+#if defined (XIL_IO_SIM)
+	return (u64)XilIoSim_Read(Addr, 64U);
+#else
 	return *(volatile u64 *) Addr;
+#endif
 }
 
 /*****************************************************************************/
@@ -170,8 +194,12 @@ static INLINE u64 Xil_In64(UINTPTR Addr)
 static INLINE void Xil_Out8(UINTPTR Addr, u8 Value)
 {
 	/* write 8 bit value to specified address */
+#if defined (XIL_IO_SIM)
+	XilIoSim_Write(Addr, 8U, Value);
+#else
 	volatile u8 *LocalAddr = (volatile u8 *)Addr;
 	*LocalAddr = Value;
+#endif
 }
 
 /*****************************************************************************/
@@ -189,8 +217,12 @@ static INLINE void Xil_Out8(UINTPTR Addr, u8 Value)
 static INLINE void Xil_Out16(UINTPTR Addr, u16 Value)
 {
 	/* write 16 bit value to specified address */
+#if defined (XIL_IO_SIM)
+	XilIoSim_Write(Addr, 16U, Value);
+#else
 	volatile u16 *LocalAddr = (volatile u16 *)Addr;
 	*LocalAddr = Value;
+#endif
 }
 
 /*****************************************************************************/
@@ -209,7 +241,9 @@ static INLINE void Xil_Out16(UINTPTR Addr, u16 Value)
 static INLINE void Xil_Out32(UINTPTR Addr, u32 Value)
 {
 	/* write 32 bit value to specified address */
-#ifndef ENABLE_SAFETY
+#if defined (XIL_IO_SIM)
+	XilIoSim_Write(Addr, 32U, Value);
+#elif !defined (ENABLE_SAFETY)
 	volatile u32 *LocalAddr = (volatile u32 *)Addr;
 	*LocalAddr = Value;
 #else
@@ -232,8 +266,12 @@ static INLINE void Xil_Out32(UINTPTR Addr, u32 Value)
 static INLINE void Xil_Out64(UINTPTR Addr, u64 Value)
 {
 	/* write 64 bit value to specified address */
+#if defined (XIL_IO_SIM)
+	XilIoSim_Write(Addr, 64U, Value);
+#else
 	volatile u64 *LocalAddr = (volatile u64 *)Addr;
 	*LocalAddr = Value;
+#endif
 }
 
 /*****************************************************************************/
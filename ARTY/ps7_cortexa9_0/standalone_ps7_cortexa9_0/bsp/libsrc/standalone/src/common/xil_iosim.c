@@ -0,0 +1,493 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_iosim.c
+*
+* This file holds the address map and the device models of the register
+* simulation. Refer to xil_iosim.h for more details. It is empty unless
+* XIL_IO_SIM is defined.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+
+#if defined (XIL_IO_SIM)
+#include <string.h>
+#include "xil_iosim.h"
+
+/************************** Constant Definitions *****************************/
+
+/* PS UART registers, by offset / 4, and their bits, as in xuartps_hw.h */
+#define UART_CR		0x00U
+#define UART_MR		0x01U
+#define UART_IER	0x02U
+#define UART_IDR	0x03U
+#define UART_IMR	0x04U
+#define UART_ISR	0x05U
+#define UART_BAUDGEN	0x06U
+#define UART_RXTOUT	0x07U
+#define UART_RXWM	0x08U
+#define UART_SR		0x0BU
+#define UART_FIFO	0x0CU
+#define UART_BAUDDIV	0x0DU
+#define UART_TXWM	0x11U
+
+#define UART_CR_RXRST	0x00000001U
+#define UART_CR_TXRST	0x00000002U
+#define UART_MR_CHMODE	0x00000300U
+#define UART_MR_L_LOOP	0x00000200U
+
+#define UART_IXR_RXOVR	0x00000001U
+#define UART_IXR_RXEMPTY 0x00000002U
+#define UART_IXR_RXFULL	0x00000004U
+#define UART_IXR_TXEMPTY 0x00000008U
+#define UART_IXR_OVER	0x00000020U
+#define UART_IXR_TOUT	0x00000100U
+
+#define UART_SR_RXOVR	0x00000001U
+#define UART_SR_RXEMPTY	0x00000002U
+#define UART_SR_RXFULL	0x00000004U
+#define UART_SR_TXEMPTY	0x00000008U
+
+/************************** Function Prototypes ******************************/
+
+static u64 XilIoSim_MemoryRead(void *CtxPtr, UINTPTR Offset, u32 Width);
+static void XilIoSim_MemoryWrite(void *CtxPtr, UINTPTR Offset, u32 Width,
+				 u64 Value);
+static u64 XilIoSim_UartRead(void *CtxPtr, UINTPTR Offset, u32 Width);
+static void XilIoSim_UartWrite(void *CtxPtr, UINTPTR Offset, u32 Width,
+			       u64 Value);
+static u32 XilIoSim_UartPush(XilIoSim_Uart *UartPtr, u8 Data);
+static void XilIoSim_UartLevels(XilIoSim_Uart *UartPtr);
+
+/************************** Variable Definitions *****************************/
+
+XilIoSim_Region XilIoSim_Regions[XILIOSIM_MAX_REGIONS];
+u32 XilIoSim_Unmapped = 0U;
+
+/*****************************************************************************/
+/**
+*
+* Empties the address map and clears the unmapped access count.
+*
+* @return	None.
+*
+******************************************************************************/
+void XilIoSim_Reset(void)
+{
+	(void)memset(XilIoSim_Regions, 0, sizeof(XilIoSim_Regions));
+	XilIoSim_Unmapped = 0U;
+}
+
+/*****************************************************************************/
+/**
+*
+* Adds a device model to the address map.
+*
+* @param	Base is the first address of the region.
+* @param	Size is the size of the region in bytes.
+* @param	Read is the read handler, called with the offset in the region.
+* @param	Write is the write handler, called the same way.
+* @param	CtxPtr is passed to the handlers.
+*
+* @return	The region, or NULL if the table is full or Size is 0.
+*
+* @note		Regions must not overlap, the first one found serves the
+*		access.
+*
+******************************************************************************/
+XilIoSim_Region *XilIoSim_Map(UINTPTR Base, UINTPTR Size,
+			      XilIoSim_ReadFn Read, XilIoSim_WriteFn Write,
+			      void *CtxPtr)
+{
+	XilIoSim_Region *RegionPtr;
+	u32 Index;
+
+	if (Size == 0U) {
+		return NULL;
+	}
+
+	for (Index = 0U; Index < XILIOSIM_MAX_REGIONS; Index++) {
+		RegionPtr = &XilIoSim_Regions[Index];
+		if (RegionPtr->Size == 0U) {
+			RegionPtr->Base = Base;
+			RegionPtr->Size = Size;
+			RegionPtr->Read = Read;
+			RegionPtr->Write = Write;
+			RegionPtr->CtxPtr = CtxPtr;
+			RegionPtr->Reads = 0U;
+			RegionPtr->Writes = 0U;
+			return RegionPtr;
+		}
+	}
+
+	return NULL;
+}
+
+/*****************************************************************************/
+/**
+*
+* Maps a store of the caller as memory, little endian.
+*
+* @param	Base is the first address of the region.
+* @param	StorePtr is the store, Size bytes.
+* @param	Size is the size of the region in bytes.
+*
+* @return	The region, or NULL if the table is full.
+*
+******************************************************************************/
+XilIoSim_Region *XilIoSim_MapMemory(UINTPTR Base, u8 *StorePtr,
+				    UINTPTR Size)
+{
+	return XilIoSim_Map(Base, Size, &XilIoSim_MemoryRead,
+			    &XilIoSim_MemoryWrite, StorePtr);
+}
+
+/*****************************************************************************/
+/**
+*
+* Maps a PS UART model in its reset state.
+*
+* @param	UartPtr is the model.
+* @param	Base is the base address of the UART, as in its configuration.
+* @param	TxBufPtr collects the bytes written to the TX FIFO outside of
+*		local loopback, NULL to drop them.
+* @param	TxSize is the size of TxBufPtr. The bytes past it are dropped.
+*
+* @return	The region, or NULL if the table is full.
+*
+******************************************************************************/
+XilIoSim_Region *XilIoSim_MapUart(XilIoSim_Uart *UartPtr, UINTPTR Base,
+				  u8 *TxBufPtr, u32 TxSize)
+{
+	(void)memset(UartPtr, 0, sizeof(XilIoSim_Uart));
+	UartPtr->Reg[UART_CR] = 0x00000128U;
+	UartPtr->Reg[UART_BAUDGEN] = 0x0000028BU;
+	UartPtr->Reg[UART_RXWM] = 0x00000020U;
+	UartPtr->Reg[UART_BAUDDIV] = 0x0000000FU;
+	UartPtr->Reg[UART_TXWM] = 0x00000020U;
+	UartPtr->TxBufPtr = TxBufPtr;
+	UartPtr->TxSize = (TxBufPtr != NULL) ? TxSize : 0U;
+	UartPtr->Pending = UART_IXR_RXEMPTY | UART_IXR_TXEMPTY;
+
+	return XilIoSim_Map(Base, XILIOSIM_UART_SIZE, &XilIoSim_UartRead,
+			    &XilIoSim_UartWrite, UartPtr);
+}
+
+/*****************************************************************************/
+/**
+*
+* Receives bytes from the line into the RX FIFO of a UART model. The line
+* is then idle, which raises the RX timeout if it is enabled and bytes are
+* waiting.
+*
+* @param	UartPtr is the model.
+* @param	DataPtr is the bytes received.
+* @param	NumBytes is the number of bytes.
+*
+* @return	The number of bytes that fitted, those past a full FIFO are
+*		lost and raise an overrun.
+*
+******************************************************************************/
+u32 XilIoSim_UartFeed(XilIoSim_Uart *UartPtr, const u8 *DataPtr,
+		      u32 NumBytes)
+{
+	u32 Count = 0U;
+	u32 Index;
+
+	for (Index = 0U; Index < NumBytes; Index++) {
+		Count += XilIoSim_UartPush(UartPtr, DataPtr[Index]);
+	}
+
+	if ((UartPtr->RxCount != 0U) && (UartPtr->Reg[UART_RXTOUT] != 0U)) {
+		UartPtr->Pending |= UART_IXR_TOUT;
+	}
+
+	return Count;
+}
+
+/*****************************************************************************/
+/**
+*
+* Returns the interrupts of a UART model that are pending and enabled, the
+* host calls the interrupt handler of the driver while there are some.
+*
+* @param	UartPtr is the model.
+*
+* @return	The ISR bits enabled in IMR.
+*
+******************************************************************************/
+u32 XilIoSim_UartPending(const XilIoSim_Uart *UartPtr)
+{
+	return UartPtr->Pending & UartPtr->Reg[UART_IMR];
+}
+
+/*****************************************************************************/
+/**
+*
+* Reads a register through the address map, called by the Xil_In*()
+* functions.
+*
+* @param	Addr is the address.
+* @param	Width is the access width in bits, 8, 16, 32 or 64.
+*
+* @return	The value, 0 outside every region.
+*
+******************************************************************************/
+u64 XilIoSim_Read(UINTPTR Addr, u32 Width)
+{
+	XilIoSim_Region *RegionPtr;
+	u32 Index;
+
+	for (Index = 0U; Index < XILIOSIM_MAX_REGIONS; Index++) {
+		RegionPtr = &XilIoSim_Regions[Index];
+		if ((RegionPtr->Size != 0U) && (Addr >= RegionPtr->Base) &&
+		    ((Addr - RegionPtr->Base) < RegionPtr->Size)) {
+			RegionPtr->Reads++;
+			return RegionPtr->Read(RegionPtr->CtxPtr,
+					       Addr - RegionPtr->Base, Width);
+		}
+	}
+
+	XilIoSim_Unmapped++;
+	return 0U;
+}
+
+/*****************************************************************************/
+/**
+*
+* Writes a register through the address map, called by the Xil_Out*()
+* functions.
+*
+* @param	Addr is the address.
+* @param	Width is the access width in bits, 8, 16, 32 or 64.
+* @param	Value is the value written.
+*
+* @return	None.
+*
+* @note		A write outside every region is counted and ignored.
+*
+******************************************************************************/
+void XilIoSim_Write(UINTPTR Addr, u32 Width, u64 Value)
+{
+	XilIoSim_Region *RegionPtr;
+	u32 Index;
+
+	for (Index = 0U; Index < XILIOSIM_MAX_REGIONS; Index++) {
+		RegionPtr = &XilIoSim_Regions[Index];
+		if ((RegionPtr->Size != 0U) && (Addr >= RegionPtr->Base) &&
+		    ((Addr - RegionPtr->Base) < RegionPtr->Size)) {
+			RegionPtr->Writes++;
+			RegionPtr->Write(RegionPtr->CtxPtr,
+					 Addr - RegionPtr->Base, Width, Value);
+			return;
+		}
+	}
+
+	XilIoSim_Unmapped++;
+}
+
+/*****************************************************************************/
+/*
+*
+* Read handler of a memory region.
+*
+******************************************************************************/
+static u64 XilIoSim_MemoryRead(void *CtxPtr, UINTPTR Offset, u32 Width)
+{
+	u64 Value = 0U;
+
+	(void)memcpy(&Value, (u8 *)CtxPtr + Offset, Width / 8U);
+
+	return Value;
+}
+
+/*****************************************************************************/
+/*
+*
+* Write handler of a memory region.
+*
+******************************************************************************/
+static void XilIoSim_MemoryWrite(void *CtxPtr, UINTPTR Offset, u32 Width,
+				 u64 Value)
+{
+	(void)memcpy((u8 *)CtxPtr + Offset, &Value, Width / 8U);
+}
+
+/*****************************************************************************/
+/*
+*
+* Read handler of a UART model. The FIFO register pops the RX FIFO, the
+* status register is computed from the fill of the FIFOs.
+*
+******************************************************************************/
+static u64 XilIoSim_UartRead(void *CtxPtr, UINTPTR Offset, u32 Width)
+{
+	XilIoSim_Uart *UartPtr = (XilIoSim_Uart *)CtxPtr;
+	u32 Reg = (u32)(Offset >> 2);
+	u32 Value;
+
+	(void)Width;
+
+	if (Reg >= XILIOSIM_UART_REGS) {
+		return 0U;
+	}
+
+	switch (Reg) {
+	case UART_FIFO:
+		if (UartPtr->RxCount == 0U) {
+			return 0U;
+		}
+		Value = UartPtr->RxFifo[UartPtr->RxHead];
+		UartPtr->RxHead = (UartPtr->RxHead + 1U) % XILIOSIM_UART_FIFO;
+		UartPtr->RxCount--;
+		XilIoSim_UartLevels(UartPtr);
+		return Value;
+
+	case UART_SR:
+		Value = UART_SR_TXEMPTY;
+		if (UartPtr->RxCount == 0U) {
+			Value |= UART_SR_RXEMPTY;
+		}
+		if (UartPtr->RxCount == XILIOSIM_UART_FIFO) {
+			Value |= UART_SR_RXFULL;
+		}
+		if ((UartPtr->Reg[UART_RXWM] != 0U) &&
+		    (UartPtr->RxCount >= UartPtr->Reg[UART_RXWM])) {
+			Value |= UART_SR_RXOVR;
+		}
+		return Value;
+
+	case UART_ISR:
+		return UartPtr->Pending;
+
+	default:
+		return UartPtr->Reg[Reg];
+	}
+}
+
+/*****************************************************************************/
+/*
+*
+* Write handler of a UART model. A byte written to the FIFO register is
+* sent at once, into the RX FIFO in local loopback mode, the interrupt
+* status register clears the bits written as 1.
+*
+******************************************************************************/
+static void XilIoSim_UartWrite(void *CtxPtr, UINTPTR Offset, u32 Width,
+			       u64 Value)
+{
+	XilIoSim_Uart *UartPtr = (XilIoSim_Uart *)CtxPtr;
+	u32 Reg = (u32)(Offset >> 2);
+	u32 Data = (u32)Value;
+
+	(void)Width;
+
+	if (Reg >= XILIOSIM_UART_REGS) {
+		return;
+	}
+
+	switch (Reg) {
+	case UART_CR:
+		if ((Data & UART_CR_RXRST) != 0U) {
+			UartPtr->RxHead = 0U;
+			UartPtr->RxCount = 0U;
+			XilIoSim_UartLevels(UartPtr);
+		}
+		UartPtr->Reg[UART_CR] = Data & ~(UART_CR_RXRST | UART_CR_TXRST);
+		break;
+
+	case UART_IER:
+		UartPtr->Reg[UART_IMR] |= Data;
+		break;
+
+	case UART_IDR:
+		UartPtr->Reg[UART_IMR] &= ~Data;
+		break;
+
+	case UART_ISR:
+		UartPtr->Pending &= ~Data;
+		XilIoSim_UartLevels(UartPtr);
+		break;
+
+	case UART_FIFO:
+		if ((UartPtr->Reg[UART_MR] & UART_MR_CHMODE) ==
+		    UART_MR_L_LOOP) {
+			(void)XilIoSim_UartPush(UartPtr, (u8)Data);
+		} else if (UartPtr->TxCount < UartPtr->TxSize) {
+			UartPtr->TxBufPtr[UartPtr->TxCount] = (u8)Data;
+			UartPtr->TxCount++;
+		}
+		UartPtr->Pending |= UART_IXR_TXEMPTY;
+		break;
+
+	case UART_IMR:
+	case UART_SR:
+		break;
+
+	default:
+		UartPtr->Reg[Reg] = Data;
+		break;
+	}
+}
+
+/*****************************************************************************/
+/*
+*
+* Puts a received byte into the RX FIFO of a UART model.
+*
+* @return	1 if it fitted, 0 if it was lost to an overrun.
+*
+******************************************************************************/
+static u32 XilIoSim_UartPush(XilIoSim_Uart *UartPtr, u8 Data)
+{
+	if (UartPtr->RxCount == XILIOSIM_UART_FIFO) {
+		UartPtr->Pending |= UART_IXR_OVER;
+		return 0U;
+	}
+
+	UartPtr->RxFifo[(UartPtr->RxHead + UartPtr->RxCount) %
+			XILIOSIM_UART_FIFO] = Data;
+	UartPtr->RxCount++;
+	XilIoSim_UartLevels(UartPtr);
+
+	return 1U;
+}
+
+/*****************************************************************************/
+/*
+*
+* Raises the interrupts following the fill of the RX FIFO, as the hardware
+* does when the fill crosses a level. The RX empty and full interrupts stay
+* raised until cleared.
+*
+******************************************************************************/
+static void XilIoSim_UartLevels(XilIoSim_Uart *UartPtr)
+{
+	if (UartPtr->RxCount == 0U) {
+		UartPtr->Pending |= UART_IXR_RXEMPTY;
+		UartPtr->Pending &= ~UART_IXR_TOUT;
+	}
+	if (UartPtr->RxCount == XILIOSIM_UART_FIFO) {
+		UartPtr->Pending |= UART_IXR_RXFULL;
+	}
+	if ((UartPtr->Reg[UART_RXWM] != 0U) &&
+	    (UartPtr->RxCount >= UartPtr->Reg[UART_RXWM])) {
+		UartPtr->Pending |= UART_IXR_RXOVR;
+	}
+}
+
+#endif /* XIL_IO_SIM */
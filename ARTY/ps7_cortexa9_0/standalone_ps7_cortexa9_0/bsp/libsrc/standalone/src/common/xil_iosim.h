@@ -0,0 +1,150 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_iosim.h
+*
+* @addtogroup common_iosim_apis Register Simulation
+*
+* Register level simulation of the memory mapped I/O, so that the drivers
+* and the code above them build and run on a host, to measure and check
+* their algorithms (framing, hashing, header parsing, chunk scheduling)
+* without the hardware.
+*
+* With XIL_IO_SIM defined, Xil_In8() to Xil_Out64() of xil_io.h call
+* XilIoSim_Read() and XilIoSim_Write() instead of dereferencing the
+* address, and the barriers are empty. The address is looked up in a table
+* of regions set up by the host program with XilIoSim_Map(), each a device
+* model with a read and a write handler, or with one of the models below:
+*
+* - XilIoSim_MapMemory(): a store of the caller read and written as
+*   memory, for register files and for the backing store of a flash device
+*   read through the register interface.
+* - XilIoSim_MapUart(): the registers of the PS UART, with a 64 byte RX
+*   FIFO filled by XilIoSim_UartFeed() and the bytes written to the TX FIFO
+*   collected in a buffer of the caller, or looped back into the RX FIFO in
+*   local loopback mode. The TX FIFO is empty again at once, as if the line
+*   were infinitely fast.
+*
+* An access outside every region reads 0 and is counted in
+* XilIoSim_Unmapped, each region counts its own reads and writes, so the
+* register traffic of an operation can be measured exactly. Interrupts are
+* not simulated: the host calls the interrupt handler of the driver when
+* the pending bits of the model say so.
+*
+* Only the register accesses go through the simulation. Memory the code
+* reaches through plain pointers, a linear flash window or a DMA buffer,
+* must be host memory. The PL330 is therefore not modelled: its programs
+* act on memory.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/**
+*@cond nocomments
+*/
+
+#ifndef XIL_IOSIM_H
+#define XIL_IOSIM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+#ifndef XILIOSIM_MAX_REGIONS
+#define XILIOSIM_MAX_REGIONS	16U	/**< Regions of the table */
+#endif
+
+#define XILIOSIM_UART_SIZE	0x1000U	/**< Register space of a PS UART */
+#define XILIOSIM_UART_REGS	0x13U	/**< Registers up to RXBS */
+#define XILIOSIM_UART_FIFO	64U	/**< Depth of the RX FIFO */
+
+/**************************** Type Definitions *******************************/
+
+/**
+ * Read handler of a region: returns the Width bit value at Offset.
+ */
+typedef u64 (*XilIoSim_ReadFn)(void *CtxPtr, UINTPTR Offset, u32 Width);
+
+/**
+ * Write handler of a region: writes the Width bit Value at Offset.
+ */
+typedef void (*XilIoSim_WriteFn)(void *CtxPtr, UINTPTR Offset, u32 Width,
+				 u64 Value);
+
+/**
+ * A region of the address map.
+ */
+typedef struct {
+	UINTPTR Base;
+	UINTPTR Size;		/**< Bytes, 0 if the entry is free */
+	XilIoSim_ReadFn Read;
+	XilIoSim_WriteFn Write;
+	void *CtxPtr;		/**< Passed to the handlers */
+	u32 Reads;		/**< Accesses served */
+	u32 Writes;
+} XilIoSim_Region;
+
+/**
+ * A PS UART model, see XilIoSim_MapUart().
+ */
+typedef struct {
+	u32 Reg[XILIOSIM_UART_REGS];	/**< By offset / 4 */
+	u8 RxFifo[XILIOSIM_UART_FIFO];
+	u32 RxHead;			/**< Oldest byte of RxFifo */
+	u32 RxCount;
+	u8 *TxBufPtr;			/**< Bytes sent, NULL to drop them */
+	u32 TxSize;
+	u32 TxCount;			/**< Bytes in TxBufPtr */
+	u32 Pending;			/**< Raw interrupt status, ISR */
+} XilIoSim_Uart;
+
+/************************** Variable Definitions *****************************/
+
+extern XilIoSim_Region XilIoSim_Regions[XILIOSIM_MAX_REGIONS];
+extern u32 XilIoSim_Unmapped;
+
+/************************** Function Prototypes ******************************/
+
+/**
+*@endcond
+*/
+
+void XilIoSim_Reset(void);
+XilIoSim_Region *XilIoSim_Map(UINTPTR Base, UINTPTR Size,
+			      XilIoSim_ReadFn Read, XilIoSim_WriteFn Write,
+			      void *CtxPtr);
+XilIoSim_Region *XilIoSim_MapMemory(UINTPTR Base, u8 *StorePtr,
+				    UINTPTR Size);
+XilIoSim_Region *XilIoSim_MapUart(XilIoSim_Uart *UartPtr, UINTPTR Base,
+				  u8 *TxBufPtr, u32 TxSize);
+u32 XilIoSim_UartFeed(XilIoSim_Uart *UartPtr, const u8 *DataPtr,
+		      u32 NumBytes);
+u32 XilIoSim_UartPending(const XilIoSim_Uart *UartPtr);
+
+u64 XilIoSim_Read(UINTPTR Addr, u32 Width);
+void XilIoSim_Write(UINTPTR Addr, u32 Width, u64 Value);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* XIL_IOSIM_H */
+/**
+* @} End of "addtogroup common_iosim_apis".
+*/
@@ -8,8 +8,8 @@
 /**
 * @file xil_mem.c
 *
-* This file contains xil mem copy function to use in case of word aligned
-* data copies.
+* This file contains xil mem copy, set, compare and sum functions to use in
+* case of word aligned data.
 *
 * <pre>
 * MODIFICATION HISTORY:
@@ -22,6 +22,10 @@
 * 			  violations.
 * 7.7	sk	 01/10/22 Include xil_mem.h header file to fix Xil_MemCpy
 * 			  prototype misra_c_2012_rule_8_4 violation.
+* 9.3   qm       10/14/26 The Cortex-A9 uses the NEON version of
+* 			  arm/cortexa9/gcc/xil_memcpy.S.
+* 9.3   qm       10/14/26 Added Xil_MemSet, Xil_MemCompare and Xil_MemSum32,
+* 			  in NEON in arm/cortexa9/gcc/xil_memops.S.
 *
 * </pre>
 *
@@ -33,6 +37,7 @@
 #include "xil_mem.h"
 
 /***************** Inline Functions Definitions ********************/
+#if !(defined (__GNUC__) && defined (__ARM_ARCH_7A__))
 /*****************************************************************************/
 /**
 * @brief       This  function copies memory from once location to other.
@@ -68,3 +73,112 @@ void Xil_MemCpy(void* dst, const void* src, u32 cnt)
 		cnt -= 1U;
 	}
 }
+
+/*****************************************************************************/
+/**
+* @brief       This function fills memory with a byte value, a word at a time
+*              once the destination is word aligned.
+*
+* @param       dst: pointer pointing to destination memory
+*
+* @param       val: byte value to be written
+*
+* @param       cnt: 32 bit length of bytes to be written
+*
+*****************************************************************************/
+void Xil_MemSet(void* dst, u8 val, u32 cnt)
+{
+	u8 *d = (u8 *)dst;
+	u32 w = (u32)val * 0x01010101U;
+
+	while (((((UINTPTR)d) & (sizeof (u32) - 1U)) != 0U) && (cnt > 0U)) {
+		*d = val;
+		d += 1U;
+		cnt -= 1U;
+	}
+	while (cnt >= sizeof (u32)) {
+		*(u32 *)(void *)d = w;
+		d += sizeof (u32);
+		cnt -= sizeof (u32);
+	}
+	while (cnt > 0U) {
+		*d = val;
+		d += 1U;
+		cnt -= 1U;
+	}
+}
+
+/*****************************************************************************/
+/**
+* @brief       This function compares two memory regions, a word at a time
+*              when both are aligned alike.
+*
+* @param       buf1: pointer pointing to first memory region
+*
+* @param       buf2: pointer pointing to second memory region
+*
+* @param       cnt: 32 bit length of bytes to be compared
+*
+* @return      0 if the regions are equal, 1 if the first differing byte is
+*              greater in buf1, -1 if it is smaller.
+*
+*****************************************************************************/
+s32 Xil_MemCompare(const void* buf1, const void* buf2, u32 cnt)
+{
+	const u8 *b1 = (const u8 *)buf1;
+	const u8 *b2 = (const u8 *)buf2;
+	s32 RetVal = 0;
+
+	if (((((UINTPTR)b1) ^ ((UINTPTR)b2)) & (sizeof (u32) - 1U)) == 0U) {
+		while (((((UINTPTR)b1) & (sizeof (u32) - 1U)) != 0U) &&
+		       (cnt > 0U) && (*b1 == *b2)) {
+			b1 += 1U;
+			b2 += 1U;
+			cnt -= 1U;
+		}
+		/* Skip the equal words, the bytes loop finds the difference */
+		while ((cnt >= sizeof (u32)) &&
+		       (*(const u32 *)(const void *)b1 ==
+			*(const u32 *)(const void *)b2)) {
+			b1 += sizeof (u32);
+			b2 += sizeof (u32);
+			cnt -= sizeof (u32);
+		}
+	}
+	while ((cnt > 0U) && (*b1 == *b2)) {
+		b1 += 1U;
+		b2 += 1U;
+		cnt -= 1U;
+	}
+	if (cnt > 0U) {
+		RetVal = (*b1 > *b2) ? 1 : -1;
+	}
+
+	return RetVal;
+}
+
+/*****************************************************************************/
+/**
+* @brief       This function adds up words, modulo 2^32, as in the Zynq boot
+*              header checksum.
+*
+* @param       src: word aligned pointer to the words
+*
+* @param       cnt: number of words
+*
+* @return      The sum of the words.
+*
+*****************************************************************************/
+u32 Xil_MemSum32(const u32* src, u32 cnt)
+{
+	u32 Sum = 0U;
+
+	while (cnt > 0U) {
+		Sum += *src;
+		src += 1U;
+		cnt -= 1U;
+	}
+
+	return Sum;
+}
+#endif
@@ -24,6 +24,7 @@
 * 6.1   nsk      11/07/16 First release.
 * 7.0   mus      01/07/19 Add cpp extern macro
 * 9.0   ml       03/03/23 Add description to fix doxygen warnings.
+* 9.3   qm       10/14/26 Added Xil_MemSet, Xil_MemCompare and Xil_MemSum32.
 * </pre>
 *
 *****************************************************************************/
@@ -34,9 +35,16 @@
 extern "C" {
 #endif
 
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
 /************************** Function Prototypes *****************************/
 
 void Xil_MemCpy(void* dst, const void* src, u32 cnt);
+void Xil_MemSet(void* dst, u8 val, u32 cnt);
+s32 Xil_MemCompare(const void* buf1, const void* buf2, u32 cnt);
+u32 Xil_MemSum32(const u32* src, u32 cnt);
 
 #ifdef __cplusplus
 }
@@ -26,6 +26,19 @@ static s32 getnum( charptr *linep);
 
 /**************************** Type Definitions *******************************/
 
+/*
+ * Where the formatted characters go: a buffer on the stack of xil_vprintf()
+ * given to outbytes() each time it fills, or the memory of xil_vsnprintf(),
+ * where what does not fit is only counted.
+ */
+typedef struct out_s {
+	char8 *buf;  /**< buffer */
+	u32 pos;     /**< characters in the buffer */
+	u32 size;    /**< capacity of the buffer */
+	u32 total;   /**< characters formatted */
+	s32 console; /**< flush the buffer to outbytes() when full */
+} out_t;
+
 typedef struct params_s {
 	s32 len;  /**< length */
 	s32 num1; /**< number 1 */
@@ -34,8 +47,11 @@ typedef struct params_s {
 	s32 do_padding; /**< do padding */
 	s32 left_flag;  /**< left flag */
 	s32 unsigned_flag; /**< unsigned flag */
+	out_t *out; /**< output */
 } params_t;
 
+static void format(const char8 *ctrl1, va_list argp, out_t *out);
+
 /***************** Macros (Inline Functions) Definitions *********************/
 
 #if (defined(__MICROBLAZE__)) && (!defined(__arch64__))
@@ -46,6 +62,30 @@ typedef struct params_s {
 #define SUPPORT_64BIT_PRINT
 #endif
 
+#if defined(STDOUT_BASEADDRESS) || defined(VERSAL_PLM) || defined(SDT) || defined(SPARTANUP_PLM)
+#define HAS_OUTPUT
+#endif
+
+/************************** Constant Definitions *****************************/
+
+/* Stack buffer of xil_vprintf(), flushed to outbytes() when full */
+#define OUT_BUF_SIZE	64U
+
+/* Decimal digits of 0 to 99, two per entry */
+static const char8 digit_pairs[201] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+static const char8 hex_digits[] = "0123456789ABCDEF";
+
 /*---------------------------------------------------*/
 /* The purpose of this routine is to output data the */
 /* same as the standard printf function without the  */
@@ -56,6 +96,69 @@ typedef struct params_s {
 
 
 
+/*****************************************************************************/
+/**
+* This routine hands the buffered characters to outbytes().
+*
+******************************************************************************/
+static void flush(out_t *out)
+{
+	if ((out->console != 0) && (out->pos != 0U)) {
+#if defined(HAS_OUTPUT)
+		outbytes(out->buf, out->pos);
+#endif
+		out->pos = 0U;
+	}
+}
+
+/*****************************************************************************/
+/**
+* This routine puts a character into the output buffer.
+*
+******************************************************************************/
+static inline void outc(out_t *out, char8 c)
+{
+	if (out->pos == out->size) {
+		if (out->console == 0) {
+			out->total++;
+			return;
+		}
+		flush(out);
+	}
+	out->buf[out->pos] = c;
+	out->pos++;
+	out->total++;
+}
+
+/*****************************************************************************/
+/**
+* This routine puts a run of characters into the output buffer.
+*
+******************************************************************************/
+static void outmem(out_t *out, const char8 *src, u32 n)
+{
+	u32 chunk;
+
+	while (n != 0U) {
+		if (out->pos == out->size) {
+			if (out->console == 0) {
+				out->total += n;
+				return;
+			}
+			flush(out);
+		}
+		chunk = out->size - out->pos;
+		if (chunk > n) {
+			chunk = n;
+		}
+		(void)memcpy(&out->buf[out->pos], src, chunk);
+		out->pos += chunk;
+		out->total += chunk;
+		src += chunk;
+		n -= chunk;
+	}
+}
+
 /*****************************************************************************/
 /**
 * This routine puts pad characters into the output buffer.
@@ -68,9 +171,7 @@ static void padding( const s32 l_flag, const struct params_s *par)
 	if ((par->do_padding != 0) && (l_flag != 0) && (par->len < par->num1)) {
 		i = (par->len);
 		for (; i < (par->num1); i++) {
-#if defined(STDOUT_BASEADDRESS) || defined(VERSAL_PLM) || defined(SDT) || defined(SPARTANUP_PLM)
-			outbyte( par->pad_character);
-#endif
+			outc(par->out, par->pad_character);
 		}
 	}
 }
@@ -83,20 +184,18 @@ static void padding( const s32 l_flag, const struct params_s *par)
 *******************************************************************************/
 static void outs(const charptr lp, struct params_s *par)
 {
-	charptr LocalPtr;
-	LocalPtr = lp;
+	u32 n;
+
 	/* pad on left if needed                         */
-	if (LocalPtr != NULL) {
-		par->len = (s32)strlen( LocalPtr);
+	if (lp != NULL) {
+		n = (u32)strlen(lp);
+		par->len = (s32)n;
 		padding( !(par->left_flag), par);
 		/* Move string to the buffer                     */
-		while (((*LocalPtr) != (char8)0) && ((par->num2) != 0)) {
-			(par->num2)--;
-#if defined(STDOUT_BASEADDRESS) || defined(VERSAL_PLM) || defined(SDT) || defined(SPARTANUP_PLM)
-			outbyte(*LocalPtr);
-#endif
-			LocalPtr += 1;
+		if (n > (u32)par->num2) {
+			n = (u32)par->num2;
 		}
+		outmem(par->out, lp, n);
 	}
 
 	/* Pad on right if needed                        */
@@ -104,6 +203,84 @@ static void outs(const charptr lp, struct params_s *par)
 	padding( par->left_flag, par);
 }
 
+/*****************************************************************************/
+/**
+*
+* This routine writes the decimal digits of a number, backwards from the
+* end of a buffer, two at a time from the pair table. The divisions by 100
+* are by a constant, which the compiler turns into a multiply by its
+* reciprocal.
+*
+* @return	The number of digits.
+*
+******************************************************************************/
+static u32 dec32(char8 *end, u32 num)
+{
+	char8 *p = end;
+	u32 q;
+	u32 r;
+
+	while (num >= 100U) {
+		q = num / 100U;
+		r = (num - (q * 100U)) * 2U;
+		p -= 2;
+		p[0] = digit_pairs[r];
+		p[1] = digit_pairs[r + 1U];
+		num = q;
+	}
+	if (num >= 10U) {
+		p -= 2;
+		p[0] = digit_pairs[num * 2U];
+		p[1] = digit_pairs[(num * 2U) + 1U];
+	} else {
+		p -= 1;
+		p[0] = (char8)('0' + num);
+	}
+
+	return (u32)(end - p);
+}
+
+/*****************************************************************************/
+/**
+*
+* This routine writes the hexadecimal digits of a number backwards from the
+* end of a buffer.
+*
+* @return	The number of digits.
+*
+******************************************************************************/
+static u32 hex64(char8 *end, u64 num)
+{
+	char8 *p = end;
+
+	do {
+		p -= 1;
+		p[0] = hex_digits[num & 0xFU];
+		num >>= 4;
+	} while (num != 0U);
+
+	return (u32)(end - p);
+}
+
+/*****************************************************************************/
+/**
+*
+* This routine moves the digits of a number to the output buffer, with
+* its sign, as directed by the padding and positioning flags.
+*
+******************************************************************************/
+static void outdigits(const char8 *digits, u32 n, s32 negative,
+		      struct params_s *par)
+{
+	par->len = (s32)n + negative;
+	padding( !(par->left_flag), par);
+	if (negative != 0) {
+		outc(par->out, '-');
+	}
+	outmem(par->out, digits, n);
+	padding( par->left_flag, par);
+}
+
 /*****************************************************************************/
 /**
 *
@@ -114,103 +291,70 @@ static void outs(const charptr lp, struct params_s *par)
 static void outnum( const s32 n, const s32 base, struct params_s *par)
 {
 	s32 negative;
-	s32 i;
-	char8 outbuf[32];
-	const char8 digits[] = "0123456789ABCDEF";
+	char8 outbuf[12];
 	u32 num;
-	for (i = 0; i < 32; i++) {
-		outbuf[i] = '0';
-	}
+	u32 len;
 
 	/* Check if number is negative                   */
 	if ((par->unsigned_flag == 0) && (base == 10) && (n < 0L)) {
 		negative = 1;
-		num = (-(n));
+		num = (u32)(-(n));
 	} else {
-		num = n;
+		num = (u32)n;
 		negative = 0;
 	}
 
-	/* Build number (backwards) in outbuf            */
-	i = 0;
-	do {
-		outbuf[i] = digits[(num % (u32)base)];
-		i++;
-		num /= base;
-	} while (num > 0U);
-
-	if (negative != 0) {
-		outbuf[i] = '-';
-		i++;
+	if (base == 10) {
+		len = dec32(&outbuf[sizeof(outbuf)], num);
+	} else {
+		len = hex64(&outbuf[sizeof(outbuf)], num);
 	}
 
-	outbuf[i] = '\0';
-	i--;
-
-	/* Move the converted number to the buffer and   */
-	/* add in the padding where needed.              */
-	par->len = (s32)strlen(outbuf);
-	padding( !(par->left_flag), par);
-	while (&outbuf[i] >= outbuf) {
-#if defined(STDOUT_BASEADDRESS) || defined(VERSAL_PLM) || defined(SDT) || defined(SPARTANUP_PLM)
-		outbyte( outbuf[i] );
-#endif
-		i--;
-	}
-	padding( par->left_flag, par);
+	outdigits(&outbuf[sizeof(outbuf) - len], len, negative, par);
 }
 /*---------------------------------------------------*/
 /*                                                   */
 /* This routine moves a 64-bit number to the output  */
 /* buffer as directed by the padding and positioning */
-/* flags. 											 */
+/* flags. Above 32 bits the number is cut in chunks  */
+/* of nine digits, one 64-bit division per chunk.    */
 /*                                                   */
 #if defined (SUPPORT_64BIT_PRINT)
 static void outnum1( const s64 n, const s32 base, params_t *par)
 {
 	s32 negative;
-	s32 i;
-	char8 outbuf[64];
-	const char8 digits[] = "0123456789ABCDEF";
+	char8 outbuf[24];
+	char8 *end = &outbuf[sizeof(outbuf)];
 	u64 num;
-	for (i = 0; i < 64; i++) {
-		outbuf[i] = '0';
-	}
+	u64 q;
+	u32 len = 0U;
+	u32 chunk;
 
 	/* Check if number is negative                   */
 	if ((par->unsigned_flag == 0) && (base == 10) && (n < 0L)) {
 		negative = 1;
-		num = (-(n));
+		num = (u64)(-(n));
 	} else {
-		num = (n);
+		num = (u64)(n);
 		negative = 0;
 	}
 
-	/* Build number (backwards) in outbuf            */
-	i = 0;
-	do {
-		outbuf[i] = digits[(num % base)];
-		i++;
-		num /= base;
-	} while (num > 0);
-
-	if (negative != 0) {
-		outbuf[i] = '-';
-		i++;
+	if (base == 10) {
+		while (num > 0xFFFFFFFFU) {
+			q = num / 1000000000U;
+			chunk = dec32(end - len, (u32)(num - (q * 1000000000U)));
+			for (; chunk < 9U; chunk++) {
+				*(end - len - chunk - 1U) = '0';
+			}
+			len += 9U;
+			num = q;
+		}
+		len += dec32(end - len, (u32)num);
+	} else {
+		len = hex64(end, num);
 	}
 
-	outbuf[i] = '\0';
-	i--;
-
-	/* Move the converted number to the buffer and   */
-	/* add in the padding where needed.              */
-	par->len = (s32)strlen(outbuf);
-	padding( !(par->left_flag), par);
-	while (&outbuf[i] >= outbuf) {
-		outbyte( outbuf[i] );
-		i--;
-	}
-	padding( par->left_flag, par);
+	outdigits(end - len, len, negative, par);
 }
 #endif
 
@@ -274,9 +418,88 @@ void xil_printf( const char8 *ctrl1, ...)
 
 /*****************************************************************************/
 /**
-* This routine is equivalent to vprintf routine
+* This routine is equivalent to vprintf routine. The characters are
+* formatted into a buffer on the stack, which goes to outbytes() each time
+* it fills and at the end.
 ******************************************************************************/
 void xil_vprintf(const char8 *ctrl1, va_list argp)
+{
+	char8 buf[OUT_BUF_SIZE];
+	out_t out;
+
+	out.buf = buf;
+	out.pos = 0U;
+	out.size = OUT_BUF_SIZE;
+	out.total = 0U;
+	out.console = 1;
+
+	format(ctrl1, argp, &out);
+	flush(&out);
+}
+
+/*****************************************************************************/
+/**
+* This routine formats like xil_printf into memory, as snprintf does: at
+* most size - 1 characters and a terminating null are written.
+*
+* @return	The number of characters the whole output has, without the
+*		null, even when it did not fit.
+*
+******************************************************************************/
+s32 xil_vsnprintf(char8 *buf, u32 size, const char8 *ctrl1, va_list argp)
+{
+	out_t out;
+
+	out.buf = buf;
+	out.pos = 0U;
+	out.size = (size != 0U) ? (size - 1U) : 0U;
+	out.total = 0U;
+	out.console = 0;
+
+	format(ctrl1, argp, &out);
+	if (size != 0U) {
+		buf[out.pos] = (char8)0;
+	}
+
+	return (s32)out.total;
+}
+
+/*****************************************************************************/
+/**
+* This routine is equivalent to snprintf routine, with the formats of
+* xil_printf.
+******************************************************************************/
+s32 xil_snprintf(char8 *buf, u32 size, const char8 *ctrl1, ...)
+{
+	va_list argp;
+	s32 len;
+
+	va_start(argp, ctrl1);
+	len = xil_vsnprintf(buf, size, ctrl1, argp);
+	va_end(argp);
+
+	return len;
+}
+
+/*****************************************************************************/
+/**
+* This routine sends a run of characters to the standard output. Drivers
+* of the standard output replace it to take the whole run at once.
+******************************************************************************/
+__attribute__((weak)) void outbytes(const char8 *buf, u32 len)
+{
+	u32 i;
+
+	for (i = 0U; i < len; i++) {
+		outbyte(buf[i]);
+	}
+}
+
+/*****************************************************************************/
+/**
+* This routine formats the control string and its arguments to an output.
+******************************************************************************/
+static void format(const char8 *ctrl1, va_list argp, out_t *out)
 {
 	s32 Check;
 #if defined (SUPPORT_64BIT_PRINT)
@@ -288,17 +511,21 @@ void xil_vprintf(const char8 *ctrl1, va_list argp)
 
 	u8 ch;
 	char8 *ctrl = (char8 *)ctrl1;
+	const char8 *run;
 	const char *string;
 
+	par.out = out;
+
 	while ((ctrl != NULL) && (*ctrl != (char8)0)) {
 
 		/* move format string chars to buffer until a  */
 		/* format control is found.                    */
 		if (*ctrl != '%') {
-#if defined(STDOUT_BASEADDRESS) || defined(VERSAL_PLM) || defined(SDT) || defined(SPARTANUP_PLM)
-			outbyte(*ctrl);
-#endif
-			ctrl += 1;
+			run = ctrl;
+			while ((*ctrl != (char8)0) && (*ctrl != '%')) {
+				ctrl += 1;
+			}
+			outmem(out, run, (u32)(ctrl - run));
 			continue;
 		}
 
@@ -335,9 +562,7 @@ try_next:
 
 		switch (tolower(ch)) {
 			case '%':
-#if defined(STDOUT_BASEADDRESS) || defined(VERSAL_PLM) || defined(SDT) || defined(SPARTANUP_PLM)
-				outbyte( '%');
-#endif
+				outc(out, '%');
 				Check = 1;
 				break;
 
@@ -351,7 +576,7 @@ try_next:
 					width = va_arg(argp, u32);
 					string = va_arg(argp, const char *);
 					for (index = 0; index < width && string[index] != '\0' ; index++) {
-						outbyte(string[index]);
+						outc(out, string[index]);
 					}
 					ctrl += 2;
 				} else {
@@ -418,9 +643,7 @@ try_next:
 				break;
 
 			case 'c':
-#if defined(STDOUT_BASEADDRESS) || defined(VERSAL_PLM) || defined(SDT) || defined(SPARTANUP_PLM)
-				outbyte( (char8)va_arg( argp, s32));
-#endif
+				outc(out, (char8)va_arg( argp, s32));
 				Check = 1;
 				break;
 
@@ -428,30 +651,20 @@ try_next:
 				ctrl += 1;
 				switch (*ctrl) {
 					case 'a':
-#if defined(STDOUT_BASEADDRESS) || defined(VERSAL_PLM) || defined(SDT) || defined(SPARTANUP_PLM)
-						outbyte( ((char8)0x07));
-#endif
+						outc(out, ((char8)0x07));
 						break;
 					case 'h':
-#if defined(STDOUT_BASEADDRESS) || defined(VERSAL_PLM) || defined(SDT) || defined(SPARTANUP_PLM)
-						outbyte( ((char8)0x08));
-#endif
+						outc(out, ((char8)0x08));
 						break;
 					case 'r':
-#if defined(STDOUT_BASEADDRESS) || defined(VERSAL_PLM) || defined(SDT) || defined(SPARTANUP_PLM)
-						outbyte( ((char8)0x0D));
-#endif
+						outc(out, ((char8)0x0D));
 						break;
 					case 'n':
-#if defined(STDOUT_BASEADDRESS) || defined(VERSAL_PLM) || defined(SDT) || defined(SPARTANUP_PLM)
-						outbyte( ((char8)0x0D));
-						outbyte( ((char8)0x0A));
-#endif
+						outc(out, ((char8)0x0D));
+						outc(out, ((char8)0x0A));
 						break;
 					default:
-#if defined(STDOUT_BASEADDRESS) || defined(VERSAL_PLM) || defined(SDT) || defined(SPARTANUP_PLM)
-						outbyte( *ctrl);
-#endif
+						outc(out, *ctrl);
 						break;
 				}
 				Check = 0;
@@ -46,8 +46,12 @@ typedef s32 (*func_ptr)(int c);
 void xil_printf( const char8 *ctrl1, ...);
 /**< This routine is equivalent to vprintf routine */
 void xil_vprintf(const char8 *ctrl1, va_list argp);
+/**< Formats into memory, like snprintf */
+s32 xil_snprintf(char8 *buf, u32 size, const char8 *ctrl1, ...);
+s32 xil_vsnprintf(char8 *buf, u32 size, const char8 *ctrl1, va_list argp);
 void print( const char8 *ptr);
 extern void outbyte (char c); /**< To send byte */
+extern void outbytes (const char8 *buf, u32 len); /**< To send bytes */
 extern char inbyte(void); /**< To receive byte */
 
 #ifdef __cplusplus
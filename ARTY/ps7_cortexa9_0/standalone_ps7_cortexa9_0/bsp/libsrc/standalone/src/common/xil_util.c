@@ -94,6 +94,7 @@
 *       pre      08/16/24 Added Xil_MemCpy64 function
 *       pre      08/29/24 Fixed compilation warning
 *       kpt      10/17/24 Move API's used in secure libs to xil_sutil.c
+* 9.3   qm       10/14/26 Xil_MemCmp compares with Xil_MemCompare
 *
 * </pre>
 *
@@ -101,6 +102,7 @@
 
 /****************************** Include Files *********************************/
 #include "xil_util.h"
+#include "xil_mem.h"
 #include "sleep.h"
 #ifdef SDT
 #include "bspconfig.h"
@@ -553,32 +555,14 @@ s32 Xil_MemCmp(const void *Buf1Ptr, const void *Buf2Ptr, u32 Len)
 	volatile int RetVal = 1;
 	const u8 *Buf1 = Buf1Ptr;
 	const u8 *Buf2 = Buf2Ptr;
-	u32 Size = Len;
 
 	/* Assert validates the input arguments */
 	if ((Buf1 == NULL) || (Buf2 == NULL) || (Len == 0x0U)) {
 		goto END;
 	}
 
-	/* Loop and compare */
-	while (Size != 0U) {
-		if (*Buf1 > *Buf2) {
-			RetVal = 1;
-			goto END;
-		} else if (*Buf1 < *Buf2) {
-			RetVal = -1;
-			goto END;
-		} else {
-			Buf1++;
-			Buf2++;
-			Size--;
-		}
-	}
-
-	/* Make sure size is zero to know the whole of data is compared */
-	if (Size == 0U) {
-		RetVal = 0;
-	}
+	/* Compare a word or a NEON register at a time */
+	RetVal = Xil_MemCompare(Buf1, Buf2, Len);
 
 END:
 	return RetVal;
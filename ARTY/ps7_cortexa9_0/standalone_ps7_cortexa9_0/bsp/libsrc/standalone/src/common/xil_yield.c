@@ -0,0 +1,51 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_yield.c
+*
+* This file holds the handlers of the yield points. Refer to xil_yield.h
+* for more details.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+#include "xil_yield.h"
+
+/************************** Variable Definitions *****************************/
+
+Xil_YieldHandler Xil_YieldHandlerPtr = NULL;
+Xil_SleepHandler Xil_SleepHandlerPtr = NULL;
+
+/*****************************************************************************/
+/**
+*
+* Sets the handlers of the yield points, or removes them with NULL.
+*
+* @param	YieldHandler is called by Xil_Yield().
+* @param	SleepHandler is called by Xil_YieldSleep().
+*
+* @return	None.
+*
+* @note		Set them from the main loop, not while a task waits in one of
+*		the loops.
+*
+******************************************************************************/
+void Xil_SetYieldHandler(Xil_YieldHandler YieldHandler,
+			 Xil_SleepHandler SleepHandler)
+{
+	Xil_YieldHandlerPtr = YieldHandler;
+	Xil_SleepHandlerPtr = SleepHandler;
+}
@@ -0,0 +1,116 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_yield.h
+*
+* @addtogroup common_yield_apis Yield Points
+*
+* Hooks through which the busy wait loops of the BSP hand the CPU to a
+* cooperative scheduler of the application.
+*
+* With no handler set, Xil_Yield() does nothing and Xil_YieldSleep()
+* returns 0, so that the loops busy wait as before. A scheduler sets its
+* handlers with Xil_SetYieldHandler(): the yield handler is called on each
+* turn of a wait loop, such as those of XUartPs_WaitTransmitDone() and the
+* devcfg driver, and the sleep handler by the sleep(), msleep() and
+* usleep() of xiltimer, in place of the busy delay.
+*
+* The handlers are also called from the loops run in interrupt handlers;
+* they must then return at once, with the sleep handler returning 0.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/**
+*@cond nocomments
+*/
+
+#ifndef XIL_YIELD_H
+#define XIL_YIELD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+
+/**************************** Type Definitions *******************************/
+
+/**
+ * Gives the CPU to other tasks for a while.
+ */
+typedef void (*Xil_YieldHandler)(void);
+
+/**
+ * Sleeps for a number of microseconds. Returns 1 once slept, 0 if the
+ * caller must busy wait instead.
+ */
+typedef u32 (*Xil_SleepHandler)(u64 Us);
+
+/************************** Variable Definitions *****************************/
+
+extern Xil_YieldHandler Xil_YieldHandlerPtr;
+extern Xil_SleepHandler Xil_SleepHandlerPtr;
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/**
+*@endcond
+*/
+
+/*****************************************************************************/
+/**
+*
+* Yield point of a busy wait loop.
+*
+* @return	None.
+*
+******************************************************************************/
+static inline void Xil_Yield(void)
+{
+	if (Xil_YieldHandlerPtr != NULL) {
+		Xil_YieldHandlerPtr();
+	}
+}
+
+/*****************************************************************************/
+/**
+*
+* Sleeps through the sleep handler.
+*
+* @param	Us is the time to sleep, in microseconds.
+*
+* @return	1 once slept, 0 if there is no sleep handler or if it
+*		declined.
+*
+******************************************************************************/
+static inline u32 Xil_YieldSleep(u64 Us)
+{
+	return (Xil_SleepHandlerPtr != NULL) ? Xil_SleepHandlerPtr(Us) : 0U;
+}
+
+/************************** Function Prototypes ******************************/
+
+void Xil_SetYieldHandler(Xil_YieldHandler YieldHandler,
+			 Xil_SleepHandler SleepHandler);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* XIL_YIELD_H */
+/**
+* @} End of "addtogroup common_yield_apis".
+*/
@@ -98,6 +98,14 @@ endif()
 
 if(("${CMAKE_SYSTEM_PROCESSOR}" STREQUAL "cortexa9"))
     set(XPAR_PS_INCLUDE "#include \"xparameters_ps.h\"")
+    option(standalone_tlsf_malloc "Serve malloc() and free() from the TLSF heap of xil_tlsf.h over the heap of the linker script, with bounded allocation times" OFF)
+    if(standalone_tlsf_malloc)
+        ADD_DEFINITIONS(-DXIL_TLSF_MALLOC)
+    endif()
+    option(standalone_pc_sample "Leave the PC interrupted by each IRQ in TPIDRPRW, for the PC sampling profiler of the application" OFF)
+    if(standalone_pc_sample)
+        set(XIL_PC_SAMPLE " ")
+    endif()
 endif()
 
 
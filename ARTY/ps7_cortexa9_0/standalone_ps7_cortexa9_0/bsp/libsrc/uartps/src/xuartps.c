@@ -27,6 +27,26 @@
 * 3.5	NK     09/26/17 Fix the RX Buffer Overflow issue.
 * 3.7   aru    08/17/18 Resolved MISRA-C mandatory violations.(CR#1007755)
 * 3.9   sd     02/06/20 Added clock support
+* 3.14  qm     10/14/26 Initialize the ring buffer and adaptive coalescing
+*			state.
+*			Drain the bytes known to be in the RX FIFO without
+*			polling the status register per byte.
+*			Fill the TX FIFO by computed free space in TX trigger
+*			level mode.
+*			Refill on TX empty only in TX trigger level mode.
+*			Count the bytes moved in the optional statistics.
+*			Take the baud divisors from a table when possible,
+*			search the next CD value as well and skip CD
+*			values that do not fit the register.
+*			Place XUartPs_SendBuffer and XUartPs_ReceiveBuffer
+*			in the interrupt hot path of xil_hotpath.h.
+*			Hold the optional TX and RX locks in XUartPs_Send
+*			and XUartPs_Recv.
+*			Initialize the optional RX timestamps and stamp
+*			the bytes XUartPs_Recv receives itself.
+*			Added XUartPs_SendV, the TX FIFO is filled across
+*			the segments of the send.
+*			Initialize the XON/XOFF flow control state.
 * </pre>
 *
 *****************************************************************************/
@@ -36,15 +56,23 @@
 #include "xstatus.h"
 #include "xuartps.h"
 #include "xil_io.h"
+#include "xil_hotpath.h"
 
 /************************** Constant Definitions ****************************/
 
-/* The following constant defines the amount of error that is allowed for
- * a specified baud rate. This error is the difference between the actual
- * baud rate that will be generated using the specified clock and the
- * desired baud rate.
+/*
+ * Interrupts XUartPs_Recv() stops and restores. With the locks of
+ * XIL_SMP_DRIVER_LOCKS the TX interrupts are left to the send side, which
+ * may run on the other CPU at the same time.
  */
-#define XUARTPS_MAX_BAUD_ERROR_RATE		 3U	/* max % error allowed */
+#if defined (XIL_SMP_DRIVER_LOCKS)
+#define XUARTPS_RECV_IXR_MASK	(XUARTPS_IXR_MASK & \
+				 ~((u32)XUARTPS_IXR_TXEMPTY | \
+				   (u32)XUARTPS_IXR_TXFULL | \
+				   (u32)XUARTPS_IXR_TTRIG))
+#else
+#define XUARTPS_RECV_IXR_MASK	XUARTPS_IXR_MASK
+#endif
 
 /**************************** Type Definitions ******************************/
 
@@ -61,6 +89,23 @@ u32  XUartPs_SendBuffer(XUartPs *InstancePtr);
 
 u32  XUartPs_ReceiveBuffer(XUartPs *InstancePtr);
 
+static u32 XUartPs_ReceiveBurst(XUartPs *InstancePtr, u32 CsrRegister);
+
+static u32 XUartPs_SendBurst(XUartPs *InstancePtr);
+
+static u32 XUartPs_NextSendVec(XUartPs *InstancePtr);
+
+/* Internal function prototypes implemented in xuartps_baud.c */
+extern u32 XUartPs_FindBaudDivisors(u32 InputClk, u32 BaudRate,
+				    u32 *BrgrPtr, u32 *BaudDivPtr);
+extern u32 XUartPs_LookupBaudDivisors(XUartPs *InstancePtr, u32 InputClk,
+				      u32 BaudRate, u32 *BrgrPtr,
+				      u32 *BaudDivPtr);
+
+/* Internal function prototypes implemented in xuartps_stats.c */
+extern void XUartPs_StampRx(XUartPs *InstancePtr, u32 NumBytes,
+			    u32 LineIdle);
+
 /************************** Variable Definitions ****************************/
 
 /****************************************************************************/
@@ -135,6 +180,8 @@ s32 XUartPs_CfgInitialize(XUartPs *InstancePtr,
 	InstancePtr->SendBuffer.NextBytePtr = NULL;
 	InstancePtr->SendBuffer.RemainingBytes = 0U;
 	InstancePtr->SendBuffer.RequestedBytes = 0U;
+	InstancePtr->SendVecPtr = NULL;
+	InstancePtr->SendVecLeft = 0U;
 
 	InstancePtr->ReceiveBuffer.NextBytePtr = NULL;
 	InstancePtr->ReceiveBuffer.RemainingBytes = 0U;
@@ -145,6 +192,52 @@ s32 XUartPs_CfgInitialize(XUartPs *InstancePtr,
 
 	InstancePtr->is_rxbs_error = 0U;
 
+	/* Ring buffer mode is off until XUartPs_EnableRingMode() is called */
+	InstancePtr->RingMode = 0U;
+	InstancePtr->RxRingDropped = 0U;
+	InstancePtr->RingFlowControl = 0U;
+	InstancePtr->RxThrottled = 0U;
+	InstancePtr->TxBlocked = 0U;
+	InstancePtr->RingSoftFlowControl = 0U;
+	InstancePtr->RxXoff = 0U;
+	InstancePtr->TxCtrlChar = 0U;
+
+	/* No statistics until XUartPs_EnableStats() is called */
+	InstancePtr->StatsPtr = NULL;
+
+	/* No RX timestamps until XUartPs_EnableRxStamp() is called */
+	InstancePtr->RxStampEnabled = 0U;
+	InstancePtr->RxStampBaud = 0U;
+	InstancePtr->RxCharTicks = 0U;
+	InstancePtr->RxStamp = 0U;
+
+	/* No divisor table attached, the built-in one is used if it applies */
+	InstancePtr->BaudTablePtr = NULL;
+	InstancePtr->BaudTableSize = 0U;
+	InstancePtr->BaudTableClockHz = 0U;
+
+	/*
+	 * Adaptive interrupt coalescing is off until
+	 * XUartPs_EnableAdaptiveCoalescing() is called
+	 */
+	InstancePtr->Coalesce.IsEnabled = 0U;
+	InstancePtr->Coalesce.Active = XUARTPS_COALESCE_LOW_LATENCY;
+	InstancePtr->Coalesce.BurstBytes = 0U;
+	InstancePtr->Coalesce.SwitchBytes = XUARTPS_COALESCE_BURST_BYTES;
+	InstancePtr->Coalesce.Profile[XUARTPS_COALESCE_LOW_LATENCY].FifoThreshold =
+		1U;
+	InstancePtr->Coalesce.Profile[XUARTPS_COALESCE_LOW_LATENCY].RecvTimeout =
+		1U;
+	InstancePtr->Coalesce.Profile[XUARTPS_COALESCE_THROUGHPUT].FifoThreshold =
+		48U;
+	InstancePtr->Coalesce.Profile[XUARTPS_COALESCE_THROUGHPUT].RecvTimeout =
+		8U;
+
+#if defined (XIL_SMP_DRIVER_LOCKS)
+	Xil_TicketLockInit(&InstancePtr->TxLock);
+	Xil_TicketLockInit(&InstancePtr->RxLock);
+#endif
+
 	/* Flag that the driver instance is ready to use */
 	InstancePtr->IsReady = XIL_COMPONENT_IS_READY;
 
@@ -182,6 +275,10 @@ s32 XUartPs_CfgInitialize(XUartPs *InstancePtr,
 		/* Set the RX FIFO trigger at 8 data bytes. */
 		XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
 				   XUARTPS_RXWM_OFFSET, 0x08U);
+		InstancePtr->RxTriggerLevel = 0x08U;
+
+		/* The TX FIFO is refilled once empty by default */
+		InstancePtr->TxTriggerLevel = 0U;
 
 		/* Set the RX timeout to 1, which will be 4 character time */
 		XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
@@ -234,6 +331,7 @@ u32 XUartPs_Send(XUartPs *InstancePtr, u8 *BufferPtr,
 			   u32 NumBytes)
 {
 	u32 BytesSent;
+	u32 Cpsr;
 
 	/* Asserts validate the input arguments */
 	Xil_AssertNonvoid(InstancePtr != NULL);
@@ -243,6 +341,8 @@ u32 XUartPs_Send(XUartPs *InstancePtr, u8 *BufferPtr,
 #if defined  (XCLOCKING)
 	Xil_ClockEnable(InstancePtr->Config.RefClk);
 #endif
+	Cpsr = XUartPs_LockTx(InstancePtr);
+
 	/*
 	 * Disable the UART transmit interrupts to allow this call to stop a
 	 * previous operation that may be interrupt driven.
@@ -254,6 +354,7 @@ u32 XUartPs_Send(XUartPs *InstancePtr, u8 *BufferPtr,
 	InstancePtr->SendBuffer.RequestedBytes = NumBytes;
 	InstancePtr->SendBuffer.RemainingBytes = NumBytes;
 	InstancePtr->SendBuffer.NextBytePtr = BufferPtr;
+	InstancePtr->SendVecLeft = 0U;
 
 	/*
 	 * Transmit interrupts will be enabled in XUartPs_SendBuffer(), after
@@ -261,6 +362,75 @@ u32 XUartPs_Send(XUartPs *InstancePtr, u8 *BufferPtr,
 	 */
 	BytesSent = XUartPs_SendBuffer(InstancePtr);
 
+	XUartPs_UnlockTx(InstancePtr, Cpsr);
+
+	return BytesSent;
+}
+
+/****************************************************************************/
+/**
+*
+* This function sends a list of segments as one send, in either polled or
+* interrupt driven mode, as XUartPs_Send() sends a buffer. The TX FIFO is
+* filled across the segments, so that a frame whose header, payload and
+* CRC are in different places needs no staging copy. This function is
+* non-blocking.
+*
+* In interrupt mode, the interrupt handler continues the sending until the
+* last segment has been sent, then the handler is called with the
+* XUARTPS_EVENT_SENT_DATA event and the bytes of all the segments.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	VecPtr is a pointer to the list of segments.
+* @param	VecCount is the number of segments. A value of zero stops a
+*		previous send operation that is in progress in interrupt mode,
+*		as with XUartPs_Send().
+*
+* @return	The number of bytes actually sent, counted across the
+*		segments.
+*
+* @note		In interrupt mode the list and the segments are used until
+*		the send is done. In polled mode only what the TX FIFO takes
+*		is sent, and the caller continues from the returned count.
+*
+*****************************************************************************/
+u32 XUartPs_SendV(XUartPs *InstancePtr, const XUartPsIoVec *VecPtr,
+		  u32 VecCount)
+{
+	u32 BytesSent;
+	u32 NumBytes = 0U;
+	u32 Index;
+	u32 Cpsr;
+
+	/* Asserts validate the input arguments */
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid((VecPtr != NULL) || (VecCount == 0U));
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	for (Index = 0U; Index < VecCount; Index++) {
+		NumBytes += VecPtr[Index].NumBytes;
+	}
+
+#if defined  (XCLOCKING)
+	Xil_ClockEnable(InstancePtr->Config.RefClk);
+#endif
+	Cpsr = XUartPs_LockTx(InstancePtr);
+
+	/* Stop a previous operation that may be interrupt driven */
+	XUartPs_WriteReg(InstancePtr->Config.BaseAddress, XUARTPS_IDR_OFFSET,
+					  (XUARTPS_IXR_TXEMPTY | XUARTPS_IXR_TXFULL));
+
+	/* The first segment that is not empty goes into the send buffer */
+	InstancePtr->SendBuffer.RequestedBytes = NumBytes;
+	InstancePtr->SendBuffer.RemainingBytes = 0U;
+	InstancePtr->SendVecPtr = VecPtr;
+	InstancePtr->SendVecLeft = VecCount;
+	(void)XUartPs_NextSendVec(InstancePtr);
+
+	BytesSent = XUartPs_SendBuffer(InstancePtr);
+
+	XUartPs_UnlockTx(InstancePtr, Cpsr);
+
 	return BytesSent;
 }
 
@@ -300,6 +470,7 @@ u32 XUartPs_Recv(XUartPs *InstancePtr,
 {
 	u32 ReceivedCount;
 	u32 ImrRegister;
+	u32 Cpsr;
 
 	/* Assert validates the input arguments */
 	Xil_AssertNonvoid(InstancePtr != NULL);
@@ -309,6 +480,8 @@ u32 XUartPs_Recv(XUartPs *InstancePtr,
 #if defined  (XCLOCKING)
 	Xil_ClockEnable(InstancePtr->Config.RefClk);
 #endif
+	Cpsr = XUartPs_LockRx(InstancePtr);
+
 	/*
 	 * Disable all the interrupts.
 	 * This stops a previous operation that may be interrupt driven
@@ -316,7 +489,7 @@ u32 XUartPs_Recv(XUartPs *InstancePtr,
 	ImrRegister = XUartPs_ReadReg(InstancePtr->Config.BaseAddress,
 				  XUARTPS_IMR_OFFSET);
 	XUartPs_WriteReg(InstancePtr->Config.BaseAddress, XUARTPS_IDR_OFFSET,
-		XUARTPS_IXR_MASK);
+		XUARTPS_RECV_IXR_MASK);
 
 	/* Setup the buffer parameters */
 	InstancePtr->ReceiveBuffer.RequestedBytes = NumBytes;
@@ -324,11 +497,17 @@ u32 XUartPs_Recv(XUartPs *InstancePtr,
 	InstancePtr->ReceiveBuffer.NextBytePtr = BufferPtr;
 
 	/* Receive the data from the device */
+	InstancePtr->RxStamp = 0U;
 	ReceivedCount = XUartPs_ReceiveBuffer(InstancePtr);
+	if ((InstancePtr->RxStampEnabled != 0U) && (ReceivedCount != 0U)) {
+		XUartPs_StampRx(InstancePtr, ReceivedCount, FALSE);
+	}
 
 	/* Restore the interrupt state */
 	XUartPs_WriteReg(InstancePtr->Config.BaseAddress, XUARTPS_IER_OFFSET,
-		ImrRegister);
+		ImrRegister & XUARTPS_RECV_IXR_MASK);
+
+	XUartPs_UnlockRx(InstancePtr, Cpsr);
 
 	return ReceivedCount;
 }
@@ -354,6 +533,10 @@ u32 XUartPs_Recv(XUartPs *InstancePtr,
 * specified by the application, will be called to indicate the completion of
 * sending.
 *
+* The send buffer of XUartPs_SendV() moves to the next segment as soon as
+* one is written, so that its RemainingBytes is zero only once the last one
+* is.
+*
 * @param	InstancePtr is a pointer to the XUartPs instance
 *
 * @return	The number of bytes actually sent
@@ -361,32 +544,56 @@ u32 XUartPs_Recv(XUartPs *InstancePtr,
 * @note		None.
 *
 *****************************************************************************/
+XIL_HOTPATH_TEXT
 u32 XUartPs_SendBuffer(XUartPs *InstancePtr)
 {
 	u32 SentCount = 0U;
+	u32 Count;
 	u32 ImrRegister;
+	u32 TxIntrMask = (u32)XUARTPS_IXR_TXEMPTY;
 
-	/*
-	 * If the TX FIFO is full, send nothing.
-	 * Otherwise put bytes into the TX FIFO unil it is full, or all of the
-	 * data has been put into the FIFO.
-	 */
-	while ((!XUartPs_IsTransmitFull(InstancePtr->Config.BaseAddress)) &&
-		   (InstancePtr->SendBuffer.RemainingBytes > SentCount)) {
-
-		/* Fill the FIFO from the buffer */
-		XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
-				   XUARTPS_FIFO_OFFSET,
-				   ((u32)InstancePtr->SendBuffer.
-				   NextBytePtr[SentCount]));
+	if (InstancePtr->TxTriggerLevel != 0U) {
+		/*
+		 * TX trigger level mode, write as many bytes as the TX status
+		 * guarantees to fit, the next refill coming from TX empty
+		 */
+		SentCount = XUartPs_SendBurst(InstancePtr);
+	} else {
+		do {
+			Count = 0U;
+
+			/*
+			 * If the TX FIFO is full, send nothing.
+			 * Otherwise put bytes into the TX FIFO unil it is full,
+			 * or all of the data has been put into the FIFO.
+			 */
+			while ((!XUartPs_IsTransmitFull(InstancePtr->Config.BaseAddress)) &&
+				   (InstancePtr->SendBuffer.RemainingBytes > Count)) {
+
+				/* Fill the FIFO from the buffer */
+				XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
+						   XUARTPS_FIFO_OFFSET,
+						   ((u32)InstancePtr->SendBuffer.
+						   NextBytePtr[Count]));
+
+				/* Increment the send count. */
+				Count++;
+			}
 
-		/* Increment the send count. */
-		SentCount++;
+			/*
+			 * Update the buffer to reflect the bytes that were sent
+			 * from it
+			 */
+			InstancePtr->SendBuffer.NextBytePtr += Count;
+			InstancePtr->SendBuffer.RemainingBytes -= Count;
+			SentCount += Count;
+		} while ((InstancePtr->SendBuffer.RemainingBytes == 0U) &&
+			 (XUartPs_NextSendVec(InstancePtr) != 0U));
 	}
 
-	/* Update the buffer to reflect the bytes that were sent from it */
-	InstancePtr->SendBuffer.NextBytePtr += SentCount;
-	InstancePtr->SendBuffer.RemainingBytes -= SentCount;
+	if (InstancePtr->StatsPtr != NULL) {
+		InstancePtr->StatsPtr->BytesOut += SentCount;
+	}
 
 	/*
 	 * If interrupts are enabled as indicated by the receive interrupt, then
@@ -402,12 +609,125 @@ u32 XUartPs_SendBuffer(XUartPs *InstancePtr)
 
 		XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
 					   XUARTPS_IER_OFFSET,
-					   ImrRegister | (u32)XUARTPS_IXR_TXEMPTY);
+					   ImrRegister | TxIntrMask);
+	}
+
+	return SentCount;
+}
+
+/****************************************************************************/
+/*
+*
+* This function writes as many bytes of the send buffer into the TX FIFO as
+* the channel status guarantees to fit, without polling the FIFO full status
+* per byte. An empty FIFO takes XUARTPS_FIFO_DEPTH bytes. The TX trigger
+* status is set while the FIFO holds TxTriggerLevel bytes or more, so a FIFO
+* with the status clear takes at least XUARTPS_FIFO_DEPTH - TxTriggerLevel
+* bytes, and one with the status set gets nothing until TX empty. The send
+* buffer is updated, moving to the next segment of XUartPs_SendV() while
+* the FIFO has room.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance
+*
+* @return	The number of bytes written.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 XUartPs_SendBurst(XUartPs *InstancePtr)
+{
+	u32 BaseAddress = InstancePtr->Config.BaseAddress;
+	u8 *DataPtr;
+	u32 CsrRegister;
+	u32 Free;
+	u32 Length;
+	u32 Count;
+	u32 SentCount = 0U;
+
+	CsrRegister = XUartPs_ReadReg(BaseAddress, XUARTPS_SR_OFFSET);
+
+	if ((CsrRegister & XUARTPS_SR_TXEMPTY) != (u32)0) {
+		Free = XUARTPS_FIFO_DEPTH;
+	} else if ((CsrRegister & XUARTPS_SR_TTRIG) != (u32)0) {
+		/* At or above the trigger level, no room is guaranteed */
+		Free = 0U;
+	} else {
+		Free = XUARTPS_FIFO_DEPTH - (u32)InstancePtr->TxTriggerLevel;
+	}
+
+	while (Free != 0U) {
+		DataPtr = InstancePtr->SendBuffer.NextBytePtr;
+		Length = InstancePtr->SendBuffer.RemainingBytes;
+		if (Length > Free) {
+			Length = Free;
+		}
+		Count = 0U;
+
+		while ((Count + 4U) <= Length) {
+			XUartPs_WriteReg(BaseAddress, XUARTPS_FIFO_OFFSET,
+					 (u32)DataPtr[Count]);
+			XUartPs_WriteReg(BaseAddress, XUARTPS_FIFO_OFFSET,
+					 (u32)DataPtr[Count + 1U]);
+			XUartPs_WriteReg(BaseAddress, XUARTPS_FIFO_OFFSET,
+					 (u32)DataPtr[Count + 2U]);
+			XUartPs_WriteReg(BaseAddress, XUARTPS_FIFO_OFFSET,
+					 (u32)DataPtr[Count + 3U]);
+			Count += 4U;
+		}
+
+		while (Count < Length) {
+			XUartPs_WriteReg(BaseAddress, XUARTPS_FIFO_OFFSET,
+					 (u32)DataPtr[Count]);
+			Count++;
+		}
+
+		InstancePtr->SendBuffer.NextBytePtr += Length;
+		InstancePtr->SendBuffer.RemainingBytes -= Length;
+		SentCount += Length;
+		Free -= Length;
+
+		if ((InstancePtr->SendBuffer.RemainingBytes == 0U) &&
+		    (XUartPs_NextSendVec(InstancePtr) == 0U)) {
+			break;
+		}
 	}
 
 	return SentCount;
 }
 
+/****************************************************************************/
+/*
+*
+* This function moves the send buffer to the next segment of XUartPs_SendV()
+* that is not empty.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance
+*
+* @return	1 if the send buffer holds the next segment, 0 if there is none.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 XUartPs_NextSendVec(XUartPs *InstancePtr)
+{
+	const XUartPsIoVec *VecPtr;
+
+	while (InstancePtr->SendVecLeft != 0U) {
+		VecPtr = InstancePtr->SendVecPtr;
+		InstancePtr->SendVecPtr++;
+		InstancePtr->SendVecLeft--;
+		if (VecPtr->NumBytes != 0U) {
+			InstancePtr->SendBuffer.NextBytePtr =
+				(u8 *)VecPtr->BufferPtr;
+			InstancePtr->SendBuffer.RemainingBytes =
+				VecPtr->NumBytes;
+			return 1U;
+		}
+	}
+
+	return 0U;
+}
+
 /****************************************************************************/
 /*
 *
@@ -437,6 +757,7 @@ u32 XUartPs_SendBuffer(XUartPs *InstancePtr)
 * @note		None.
 *
 *****************************************************************************/
+XIL_HOTPATH_TEXT
 u32 XUartPs_ReceiveBuffer(XUartPs *InstancePtr)
 {
 	u32 CsrRegister;
@@ -451,6 +772,20 @@ u32 XUartPs_ReceiveBuffer(XUartPs *InstancePtr)
 	CsrRegister = XUartPs_ReadReg(InstancePtr->Config.BaseAddress,
 				XUARTPS_SR_OFFSET);
 
+	/*
+	 * Unless the byte status has to be checked for every byte, take the
+	 * bytes the status says are in the RX FIFO in one go, then poll the
+	 * status for the tail only
+	 */
+	if (InstancePtr->is_rxbs_error == 0U) {
+		ReceivedCount = XUartPs_ReceiveBurst(InstancePtr, CsrRegister);
+		if (ReceivedCount != 0U) {
+			CsrRegister = XUartPs_ReadReg(
+					InstancePtr->Config.BaseAddress,
+					XUARTPS_SR_OFFSET);
+		}
+	}
+
 	/*
 	 * Loop until there is no more data in RX FIFO or the specified
 	 * number of bytes has been received
@@ -495,9 +830,70 @@ u32 XUartPs_ReceiveBuffer(XUartPs *InstancePtr)
 	}
 	InstancePtr->ReceiveBuffer.RemainingBytes -= ReceivedCount;
 
+	if (InstancePtr->StatsPtr != NULL) {
+		InstancePtr->StatsPtr->BytesIn += ReceivedCount;
+	}
+
 	return ReceivedCount;
 }
 
+/****************************************************************************/
+/*
+*
+* This function reads the bytes that a channel status register value
+* guarantees to be in the RX FIFO, without reading the status register again.
+* A full RX FIFO holds XUARTPS_FIFO_DEPTH bytes and a FIFO at or above the
+* trigger level holds at least RxTriggerLevel bytes. The bytes are stored
+* from the start of the receive buffer, which is not updated.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance
+* @param	CsrRegister is the channel status register value.
+*
+* @return	The number of bytes read.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 XUartPs_ReceiveBurst(XUartPs *InstancePtr, u32 CsrRegister)
+{
+	u32 BaseAddress = InstancePtr->Config.BaseAddress;
+	u8 *DataPtr = InstancePtr->ReceiveBuffer.NextBytePtr;
+	u32 Known;
+	u32 Count = 0U;
+
+	if ((CsrRegister & XUARTPS_SR_RXFULL) != (u32)0) {
+		Known = XUARTPS_FIFO_DEPTH;
+	} else if ((CsrRegister & XUARTPS_SR_RXOVR) != (u32)0) {
+		Known = (u32)InstancePtr->RxTriggerLevel;
+	} else {
+		Known = 0U;
+	}
+
+	if (Known > InstancePtr->ReceiveBuffer.RemainingBytes) {
+		Known = InstancePtr->ReceiveBuffer.RemainingBytes;
+	}
+
+	while ((Count + 4U) <= Known) {
+		DataPtr[Count] = (u8)XUartPs_ReadReg(BaseAddress,
+					XUARTPS_FIFO_OFFSET);
+		DataPtr[Count + 1U] = (u8)XUartPs_ReadReg(BaseAddress,
+					XUARTPS_FIFO_OFFSET);
+		DataPtr[Count + 2U] = (u8)XUartPs_ReadReg(BaseAddress,
+					XUARTPS_FIFO_OFFSET);
+		DataPtr[Count + 3U] = (u8)XUartPs_ReadReg(BaseAddress,
+					XUARTPS_FIFO_OFFSET);
+		Count += 4U;
+	}
+
+	while (Count < Known) {
+		DataPtr[Count] = (u8)XUartPs_ReadReg(BaseAddress,
+					XUARTPS_FIFO_OFFSET);
+		Count++;
+	}
+
+	return Count;
+}
+
 /*****************************************************************************/
 /**
 *
@@ -519,13 +915,9 @@ u32 XUartPs_ReceiveBuffer(XUartPs *InstancePtr)
 *****************************************************************************/
 s32 XUartPs_SetBaudRate(XUartPs *InstancePtr, u32 BaudRate)
 {
-	u32 IterBAUDDIV;	/* Iterator for available baud divisor values */
-	u32 BRGR_Value;		/* Calculated value for baud rate generator */
-	u32 CalcBaudRate;	/* Calculated baud rate */
-	u32 BaudError;		/* Diff between calculated and requested baud rate */
 	u32 Best_BRGR = 0U;	/* Best value for baud rate generator */
-	u8 Best_BAUDDIV = 0U;	/* Best value for baud divisor */
-	u32 Best_Error = 0xFFFFFFFFU;
+	u32 Best_BAUDDIV = 0U;	/* Best value for baud divisor */
+	u32 Best_Error = 0U;
 	u32 PercentError;
 	u32 ModeReg;
 	u32 InputClk;
@@ -553,32 +945,13 @@ s32 XUartPs_SetBaudRate(XUartPs *InstancePtr, u32 BaudRate)
 	}
 
 	/*
-	 * Determine the Baud divider. It can be 4to 254.
-	 * Loop through all possible combinations
+	 * Use the precomputed divisors when a table covers this input clock
+	 * and rate, search all the combinations otherwise.
 	 */
-	for (IterBAUDDIV = 4; IterBAUDDIV < 255; IterBAUDDIV++) {
-
-		/* Calculate the value for BRGR register */
-		BRGR_Value = InputClk / (BaudRate * (IterBAUDDIV + 1));
-
-		/* Calculate the baud rate from the BRGR value */
-		CalcBaudRate = InputClk/ (BRGR_Value * (IterBAUDDIV + 1));
-
-		/* Avoid unsigned integer underflow */
-		if (BaudRate > CalcBaudRate) {
-			BaudError = BaudRate - CalcBaudRate;
-		}
-		else {
-			BaudError = CalcBaudRate - BaudRate;
-		}
-
-		/* Find the calculated baud rate closest to requested baud rate. */
-		if (Best_Error > BaudError) {
-
-			Best_BRGR = BRGR_Value;
-			Best_BAUDDIV = IterBAUDDIV;
-			Best_Error = BaudError;
-		}
+	if (XUartPs_LookupBaudDivisors(InstancePtr, InputClk, BaudRate,
+				       &Best_BRGR, &Best_BAUDDIV) == FALSE) {
+		Best_Error = XUartPs_FindBaudDivisors(InputClk, BaudRate,
+						      &Best_BRGR, &Best_BAUDDIV);
 	}
 
 	/* Make sure the best error is not too large. */
@@ -86,6 +86,139 @@
 * driver to allow data to be sent and received. They can be used in either
 * polled or interrupt mode.
 *
+* For hot paths where the per call checks of these functions matter,
+* xuartps_fast.h provides static inline polled send and receive functions
+* without asserts, interrupt mask handling or clock gating.
+*
+* XUartPs_SendV() sends a list of segments, e.g. the header, payload and
+* CRC of a frame, as one send without copying them together first: the
+* FIFO is filled across the segments and the sent event reports the bytes
+* of all of them. The segments and the list must stay until then.
+*
+* <b>Ring Buffer Mode</b>
+*
+* For sustained traffic the driver can be switched into ring buffer mode with
+* XUartPs_EnableRingMode(). The interrupt handler then drains the RX FIFO into
+* a power-of-two RX ring and refills the TX FIFO from a TX ring, while the
+* application uses XUartPs_RingRead() and XUartPs_RingWrite() which never
+* touch the FIFO registers. Each ring has a single producer and a single
+* consumer (the ISR on one side, the task on the other), so no locking is
+* required. XUartPs_Send() and XUartPs_Recv() must not be used while ring
+* buffer mode is enabled. XUartPs_RingPeek() and XUartPs_RingConsume() give
+* the consumer direct access to the RX ring instead of copying the data out.
+*
+* With XUartPs_EnableRingFlowControl() ring buffer mode also uses automatic
+* RTS/CTS flow control. Once the RX ring reaches its high-water mark the
+* interrupt handler stops draining the RX FIFO, so the FIFO fills up to the
+* flow delay level and the hardware deasserts RTS. XUartPs_RingRead() resumes
+* draining when the ring is down to its low-water mark. RTS therefore follows
+* the ring occupancy rather than the FIFO occupancy and no byte is dropped.
+* In the other direction the hardware holds the transmitter while CTS is
+* deasserted, and the modem status interrupt keeps XUartPs_RingTxBlocked()
+* up to date so the producer can hold back as well.
+*
+* Links without RTS and CTS use XUartPs_EnableRingSoftFlowControl() instead,
+* XON/XOFF flow control done by the interrupt handler itself. It writes an
+* XOFF to the TX FIFO as soon as it stores the RX ring up to its high-water
+* mark, and an XON from the TX empty interrupt once XUartPs_RingRead() has
+* taken the ring down to its low-water mark. An XOFF received stops the TX
+* ring from being sent at once, the bytes already in the TX FIFO aside, and
+* an XON resumes it. The XON and XOFF bytes received are not stored in the
+* RX ring, so the data must not contain them. The XOFF goes out after the
+* bytes already in the TX FIFO and the sender stops some characters later,
+* the high-water mark has to leave room for both.
+*
+* <b>DMA Assisted Mode</b>
+*
+* Bulk payloads can be moved by the PS DMA controller instead of the CPU, see
+* xuartps_dma.h.
+*
+* <b>TX Trigger Level Mode</b>
+*
+* By default the interrupt driven send polls the TX FIFO full status for
+* every byte it writes. With XUartPs_SetTxTriggerLevel() the number of bytes
+* that fit is computed from the TX status once per refill instead: a full
+* FIFO depth on the TX empty interrupt, and the room below the TX trigger
+* level for the first write of a send. The refills are still driven by the
+* TX empty interrupt, which also reports the end of the send. On Zynq-7000
+* the TX trigger status and interrupt are set while the TX FIFO holds at
+* least the trigger level (UG585, Uart_TTRIG), so the trigger interrupt
+* asserts as a refill fills the FIFO rather than as the FIFO drains, and is
+* not used.
+*
+* <b>Baud Rate Divisor Tables</b>
+*
+* XUartPs_SetBaudRate() takes the CD and BDIV values from a table sorted by
+* baud rate when one covers the current input clock, which avoids searching
+* all the divisors on every call. A built-in table covers the usual rates for
+* a 100 MHz reference clock. For other clocks, or other rates, a table can be
+* computed once with XUartPs_ComputeBaudTable() and attached with
+* XUartPs_SetBaudTable(). Rates without an entry are still searched.
+*
+* Some rates, such as 3 Mbaud, cannot be generated accurately from a 100 MHz
+* reference clock. On the Zynq-7000 XUartPs_SetBaudRateRefClk() also searches
+* the divisor of the UART reference clock in the SLCR and changes it when that
+* gives a lower error. The reference clock is shared by both UARTs.
+*
+* <b>Statistics</b>
+*
+* An optional XUartPsStats block can be attached with XUartPs_EnableStats().
+* The driver then counts the bytes received and sent, the interrupt handler
+* entries and the overrun, framing and parity errors, tracks the high-water
+* mark of the ring buffers and keeps a log2 histogram of the interrupt
+* service time measured with XTime_GetTime(). XUartPs_GetStats() returns a
+* consistent snapshot. Without a block attached the cost is one pointer test
+* per path.
+*
+* <b>RX Timestamps</b>
+*
+* With XUartPs_EnableRxStamp() the interrupt driven receive notes the
+* XTime_GetTime() of the first byte of each receive buffer, the buffer of
+* XUartPs_Recv(). The time is taken when the RX trigger or timeout
+* interrupt that brings the first bytes of the buffer is serviced, and
+* moved back by the time the bytes drained with it have spent in the RX
+* FIFO at the current baud rate, 10 bits a character, plus the RX timeout
+* for a timeout interrupt. It approximates the time the first byte was on
+* the line, within about a character time and the interrupt latency.
+* XUartPs_GetRxStamp() returns it, from the handler of
+* XUARTPS_EVENT_RECV_DATA or XUARTPS_EVENT_RECV_TOUT, so that it goes
+* along with the data of the buffer. The ring buffer mode is not stamped.
+*
+* <b>Buffered Standard Output</b>
+*
+* On its own outbyte() waits for room in the TX FIFO for every character, so
+* a line of xil_printf() output holds the caller for milliseconds at the
+* usual rates. XUartPs_StdoutSetBuffer() attaches a RAM log ring to the
+* standard output: outbyte() then copies into the ring and never waits.
+* XUartPs_StdoutDrain() sends the ring from the idle loop or an interrupt
+* handler, and XUartPs_StdoutFlush() sends it all by polling, for the error
+* and reset paths.
+* xil_printf() formats into a stack buffer and hands it over with
+* outbytes(), which passes the whole run to XUartPs_StdoutWrite().
+*
+* <b>Adaptive Interrupt Coalescing</b>
+*
+* A single RX trigger level and timeout either interrupts every few bytes
+* during bulk traffic or delays interactive input. With
+* XUartPs_EnableAdaptiveCoalescing() the interrupt handler switches the RX
+* trigger level and RX timeout at runtime between a low latency profile and a
+* high throughput profile. It moves to the throughput profile once a burst of
+* bytes has been received without the line going idle, and back to the low
+* latency profile when the line goes idle after a short burst. The profiles
+* are set with XUartPs_SetCoalesceProfile(). The RX timeout interrupt must be
+* enabled for the adaptation to work.
+*
+* <b>Sharing Between the CPUs</b>
+*
+* Built with XIL_SMP_DRIVER_LOCKS, an instance keeps a ticket lock of
+* xil_atomic.h for the send buffer and one for the receive buffer. The
+* lock of a direction is held, with the IRQ of the CPU masked, by
+* XUartPs_Send() and XUartPs_Recv() and by the interrupt handler around
+* its use of the buffer, so that one CPU may send while the other
+* receives, or takes the interrupt, without a global lock. The handler
+* callbacks are called without the locks held and may send or receive
+* again. The ring buffer mode stays single producer, single consumer.
+*
 * @note
 *
 * The default configuration for the UART after initialization is:
@@ -150,6 +283,34 @@
 * 3.9   sd     02/06/20 Added clock support
 * 3.12	gm     11/04/22 Added timeout support using Xil_WaitForEvent
 * 3.13	adk    14/04/23 Added support for system device-tree flow.
+* 3.14	qm     10/14/26 Added SPSC ring buffer mode for interrupt driven
+*			TX/RX, see xuartps_ring.c.
+*			Added PL330 DMA assisted bulk transfer mode, see
+*			xuartps_dma.h.
+*			Added adaptive RX interrupt coalescing.
+*			Drain the bytes known to be in the RX FIFO without
+*			polling the status register per byte.
+*			Added TX trigger level driven sending.
+*			The TX trigger level mode refills on TX empty, the
+*			TX trigger being set at or above its level.
+*			Added optional statistics, see xuartps_stats.c.
+*			Added the static inline fast path, see
+*			xuartps_fast.h.
+*			Added RTS/CTS flow control driven by the ring
+*			occupancy in ring buffer mode.
+*			Added baud rate divisor tables and the reference
+*			clock divisor search, see xuartps_baud.c.
+*			Added zero-copy access to the RX ring.
+*			Added the buffered standard output, see
+*			xuartps_hw.c.
+*			Added the FIQ fast path of ring buffer mode.
+*			Added the optional TX and RX locks of
+*			XIL_SMP_DRIVER_LOCKS.
+*			Added the optional RX timestamps.
+*			Added the scatter/gather send XUartPs_SendV().
+*			Added XON/XOFF flow control in ring buffer mode.
+*			Grouped the instance members by their use, with the
+*			cache line aligned layout of XIL_DRIVER_HOT_LAYOUT.
 *
 * </pre>
 *
@@ -173,6 +334,13 @@ extern "C" {
 #include "xil_clocking.h"
 #endif
 #include "xil_util.h"
+#if defined (XIL_SMP_DRIVER_LOCKS) || defined (XIL_DRIVER_HOT_LAYOUT)
+#include "xil_atomic.h"
+#endif
+#ifndef XIL_HOT_GROUP_BEGIN	/* Plain members, see xil_atomic.h */
+#define XIL_HOT_GROUP_BEGIN
+#define XIL_HOT_GROUP_END
+#endif
 
 /************************** Constant Definitions ****************************/
 
@@ -186,6 +354,13 @@ extern "C" {
 
 #define XUARTPS_DFT_BAUDRATE  115200U   /* Default baud rate */
 
+/* The following constant defines the amount of error that is allowed for
+ * a specified baud rate. This error is the difference between the actual
+ * baud rate that will be generated using the specified clock and the
+ * desired baud rate.
+ */
+#define XUARTPS_MAX_BAUD_ERROR_RATE		 3U	/* max % error allowed */
+
 /** @name Configuration options
  * @{
  */
@@ -223,6 +398,31 @@ extern "C" {
 
 /* @} */
 
+/** @name Interrupt coalescing profiles
+ *
+ * The RX trigger level and RX timeout profiles used by the adaptive interrupt
+ * coalescing mode.
+ *
+ * @{
+ */
+#define XUARTPS_COALESCE_LOW_LATENCY	0U	/**< Interactive traffic */
+#define XUARTPS_COALESCE_THROUGHPUT	1U	/**< Bulk traffic */
+#define XUARTPS_COALESCE_NUM_PROFILES	2U
+
+#define XUARTPS_COALESCE_BURST_BYTES	64U	/**< Default bytes received
+						  *  without idle line before
+						  *  the throughput profile is
+						  *  used */
+/* @} */
+
+#define XUARTPS_RING_FLOWDEL	56U	/**< RX FIFO level that deasserts RTS
+					  *  in ring flow control mode */
+
+#define XUARTPS_XON		0x11U	/**< DC1, resumes the sender */
+#define XUARTPS_XOFF		0x13U	/**< DC3, stops the sender */
+
+#define XUARTPS_STATS_HIST_BINS	16U	/**< Bins of the ISR time histogram */
+
 /** @name Data format values
  *
  * These constants specify the data format that the driver supports.
@@ -300,6 +500,81 @@ typedef struct {
 	u32 RemainingBytes;
 } XUartPsBuffer;
 
+/**
+ * A segment of the list sent by XUartPs_SendV().
+ */
+typedef struct {
+	const u8 *BufferPtr;	/**< Start of the segment */
+	u32 NumBytes;		/**< Bytes of the segment, may be zero */
+} XUartPsIoVec;
+
+/**
+ * Single producer, single consumer ring used by the ring buffer mode. Head and
+ * Tail are free running counters, the buffer index is obtained by masking
+ * them with Mask (Size - 1), so Size must be a power of two.
+ */
+typedef struct {
+	u8 *BufferPtr;		/**< Ring storage, Size bytes */
+	u32 Mask;		/**< Size - 1 */
+	volatile u32 Head;	/**< Producer counter */
+	volatile u32 Tail;	/**< Consumer counter */
+} XUartPsRing;
+
+/**
+ * Data waiting in the RX ring, see XUartPs_RingPeek(). The second segment is
+ * used when the data wraps around the end of the ring storage.
+ */
+typedef struct {
+	u8 *DataPtr[2];		/**< Start of each segment */
+	u32 Length[2];		/**< Bytes in each segment */
+} XUartPsRingSpan;
+
+/**
+ * RX trigger level and RX timeout of one interrupt coalescing profile.
+ */
+typedef struct {
+	u8 FifoThreshold;	/**< RX FIFO trigger level */
+	u8 RecvTimeout;		/**< RX timeout, must not be 0 */
+} XUartPsCoalesceProfile;
+
+/**
+ * State of the adaptive interrupt coalescing mode.
+ */
+typedef struct {
+	u32 IsEnabled;		/**< Adaptive coalescing is enabled */
+	u32 Active;		/**< XUARTPS_COALESCE_* profile in use */
+	u32 BurstBytes;		/**< Bytes received since the line was idle */
+	u32 SwitchBytes;	/**< Burst length that selects throughput */
+	XUartPsCoalesceProfile Profile[XUARTPS_COALESCE_NUM_PROFILES];
+} XUartPsCoalesce;
+
+/**
+ * Optional statistics of a driver instance, see XUartPs_EnableStats().
+ */
+typedef struct {
+	u64 BytesIn;		/**< Bytes read from the RX FIFO */
+	u64 BytesOut;		/**< Bytes written to the TX FIFO */
+	u32 IsrEntries;		/**< Interrupt handler entries */
+	u32 OverrunErrors;	/**< RX overrun interrupts */
+	u32 FramingErrors;	/**< RX framing error interrupts */
+	u32 ParityErrors;	/**< RX parity error interrupts */
+	u32 RxRingHighWater;	/**< Most bytes held by the RX ring */
+	u32 TxRingHighWater;	/**< Most bytes held by the TX ring */
+	u32 IsrTimeMax;		/**< Longest ISR service, in XTime ticks */
+	u32 IsrTimeHist[XUARTPS_STATS_HIST_BINS]; /**< Bin N counts services
+						    *  of 2^N to 2^(N+1) - 1
+						    *  XTime ticks */
+} XUartPsStats;
+
+/**
+ * Baud rate divisors for one baud rate, see XUartPs_SetBaudTable().
+ */
+typedef struct {
+	u32 BaudRate;	/**< In bps */
+	u16 Brgr;	/**< CD value, 0 if the rate cannot be generated */
+	u8 BaudDiv;	/**< BDIV value */
+} XUartPsBaudEntry;
+
 /**
  * Keep track of data format setting of a device.
  */
@@ -333,25 +608,90 @@ typedef void (*XUartPs_Handler) (void *CallBackRef, u32 Event,
  * The XUartPs driver instance data structure. A pointer to an instance data
  * structure is passed around by functions to refer to a specific driver
  * instance.
+ *
+ * The members the interrupt handler touches come first, those of the ring
+ * buffer mode next and the configuration last. With XIL_DRIVER_HOT_LAYOUT
+ * each of the three groups starts on a cache line.
  */
 typedef struct {
+	XIL_HOT_GROUP_BEGIN	/* Interrupt handler */
 	XUartPs_Config Config;	/* Configuration data structure */
-	u32 InputClockHz;	/* Input clock frequency */
 	u32 IsReady;		/* Device is initialized and ready */
-	u32 BaudRate;		/* Current baud rate */
+	XUartPsStats *StatsPtr;	/* Optional statistics, NULL if disabled */
+	u32 RingMode;		/* Ring buffer mode is enabled */
 
+	XUartPs_Handler Handler;
+	void *CallBackRef;	/* Callback reference for event handler */
 	XUartPsBuffer SendBuffer;
 	XUartPsBuffer ReceiveBuffer;
+	const XUartPsIoVec *SendVecPtr;	/* Next segment of XUartPs_SendV() */
+	u32 SendVecLeft;	/* Segments after the one in SendBuffer */
 
-	XUartPs_Handler Handler;
-	void *CallBackRef;	/* Callback reference for event handler */
 	u32 Platform;
 	u8 is_rxbs_error;
+	u8 RxTriggerLevel;	/* RX FIFO trigger level last written */
+	u8 TxTriggerLevel;	/* TX FIFO trigger level, 0 if not used */
+
+	u32 RxStampEnabled;	/* RX timestamps are taken */
+	u32 RxStampBaud;	/* Baud rate RxCharTicks is for */
+	u32 RxCharTicks;	/* XTime ticks of a character */
+	u64 RxStamp;		/* XTime of the first byte of the buffer */
+
+	XUartPsCoalesce Coalesce;	/* Adaptive interrupt coalescing */
+
+#if defined (XIL_SMP_DRIVER_LOCKS)
+	Xil_TicketLock TxLock;	/* Send buffer, between the CPUs */
+	Xil_TicketLock RxLock;	/* Receive buffer, between the CPUs */
+#endif
+	XIL_HOT_GROUP_END
+
+	XIL_HOT_GROUP_BEGIN	/* Ring buffer mode */
+	XUartPsRing RxRing;	/* Filled by the ISR, drained by the task */
+	XUartPsRing TxRing;	/* Filled by the task, drained by the ISR */
+	volatile u32 RxRingDropped;	/* Bytes lost because RxRing was full */
+	u32 RingFlowControl;	/* RTS/CTS flow control in ring mode */
+	u32 RxHighWater;	/* RX ring level that throttles the sender */
+	u32 RxLowWater;		/* RX ring level that releases the sender */
+	volatile u32 RxThrottled;	/* RX FIFO is left to fill up */
+	volatile u32 TxBlocked;	/* CTS deasserted or XOFF received */
+	u32 RingSoftFlowControl;	/* XON/XOFF flow control in ring mode */
+	volatile u32 RxXoff;	/* XOFF sent, XON not sent yet */
+	volatile u32 TxCtrlChar;	/* XON or XOFF to send, 0 if none */
+	XIL_HOT_GROUP_END
+
+	XIL_HOT_GROUP_BEGIN	/* Configuration */
+	u32 InputClockHz;	/* Input clock frequency */
+	u32 BaudRate;		/* Current baud rate */
+
+	const XUartPsBaudEntry *BaudTablePtr;	/* Divisors, NULL if none */
+	u32 BaudTableSize;	/* Number of entries of BaudTablePtr */
+	u32 BaudTableClockHz;	/* Input clock BaudTablePtr is for */
+	XIL_HOT_GROUP_END
 } XUartPs;
 
 
 /***************** Macros (Inline Functions) Definitions ********************/
 
+/*
+ * Locks of the send and receive buffers, see Sharing Between the CPUs.
+ * They give and take the CPSR of the IRQ mask.
+ */
+#if defined (XIL_SMP_DRIVER_LOCKS)
+#define XUartPs_LockTx(InstancePtr) \
+	Xil_TicketLockIrqSave(&(InstancePtr)->TxLock)
+#define XUartPs_UnlockTx(InstancePtr, Cpsr) \
+	Xil_TicketLockIrqRestore(&(InstancePtr)->TxLock, (Cpsr))
+#define XUartPs_LockRx(InstancePtr) \
+	Xil_TicketLockIrqSave(&(InstancePtr)->RxLock)
+#define XUartPs_UnlockRx(InstancePtr, Cpsr) \
+	Xil_TicketLockIrqRestore(&(InstancePtr)->RxLock, (Cpsr))
+#else
+#define XUartPs_LockTx(InstancePtr)		0U
+#define XUartPs_UnlockTx(InstancePtr, Cpsr)	((void)(Cpsr))
+#define XUartPs_LockRx(InstancePtr)		0U
+#define XUartPs_UnlockRx(InstancePtr, Cpsr)	((void)(Cpsr))
+#endif
+
 /****************************************************************************/
 /**
 * Get the UART Channel Status Register.
@@ -468,6 +808,9 @@ s32 XUartPs_CfgInitialize(XUartPs *InstancePtr,
 u32 XUartPs_Send(XUartPs *InstancePtr,u8 *BufferPtr,
 			   u32 NumBytes);
 
+u32 XUartPs_SendV(XUartPs *InstancePtr, const XUartPsIoVec *VecPtr,
+		  u32 VecCount);
+
 u32 XUartPs_Recv(XUartPs *InstancePtr,u8 *BufferPtr,
 			   u32 NumBytes);
 
@@ -502,6 +845,19 @@ s32 XUartPs_SetDataFormat(XUartPs *InstancePtr, XUartPsFormat * FormatPtr);
 
 void XUartPs_GetDataFormat(XUartPs *InstancePtr, XUartPsFormat * FormatPtr);
 
+void XUartPs_SetCoalesceProfile(XUartPs *InstancePtr, u32 Profile,
+				u8 FifoThreshold, u8 RecvTimeout);
+
+void XUartPs_EnableAdaptiveCoalescing(XUartPs *InstancePtr, u32 SwitchBytes);
+
+void XUartPs_DisableAdaptiveCoalescing(XUartPs *InstancePtr);
+
+u32 XUartPs_GetCoalesceProfile(XUartPs *InstancePtr);
+
+void XUartPs_SetTxTriggerLevel(XUartPs *InstancePtr, u8 TriggerLevel);
+
+u8 XUartPs_GetTxTriggerLevel(XUartPs *InstancePtr);
+
 /* interrupt functions in xuartps_intr.c */
 u32 XUartPs_GetInterruptMask(XUartPs *InstancePtr);
 
@@ -512,6 +868,66 @@ void XUartPs_InterruptHandler(XUartPs *InstancePtr);
 void XUartPs_SetHandler(XUartPs *InstancePtr, XUartPs_Handler FuncPtr,
 			 void *CallBackRef);
 
+/* ring buffer mode functions in xuartps_ring.c */
+s32 XUartPs_EnableRingMode(XUartPs *InstancePtr, u8 *RxBufPtr, u32 RxSize,
+			   u8 *TxBufPtr, u32 TxSize);
+
+void XUartPs_DisableRingMode(XUartPs *InstancePtr);
+
+u32 XUartPs_RingRead(XUartPs *InstancePtr, u8 *BufferPtr, u32 NumBytes);
+
+u32 XUartPs_RingWrite(XUartPs *InstancePtr, const u8 *BufferPtr,
+		      u32 NumBytes);
+
+u32 XUartPs_RingRxCount(XUartPs *InstancePtr);
+
+u32 XUartPs_RingPeek(XUartPs *InstancePtr, XUartPsRingSpan *SpanPtr);
+
+void XUartPs_RingConsume(XUartPs *InstancePtr, u32 NumBytes);
+
+u32 XUartPs_RingTxFree(XUartPs *InstancePtr);
+
+s32 XUartPs_EnableRingFlowControl(XUartPs *InstancePtr, u32 HighWater,
+				  u32 LowWater);
+
+void XUartPs_DisableRingFlowControl(XUartPs *InstancePtr);
+
+s32 XUartPs_EnableRingSoftFlowControl(XUartPs *InstancePtr, u32 HighWater,
+				      u32 LowWater);
+
+void XUartPs_DisableRingSoftFlowControl(XUartPs *InstancePtr);
+
+u32 XUartPs_RingTxBlocked(XUartPs *InstancePtr);
+
+#if defined (__GNUC__) && !defined (__aarch64__)
+s32 XUartPs_EnableRingFiq(XUartPs *InstancePtr);
+
+void XUartPs_DisableRingFiq(XUartPs *InstancePtr);
+#endif
+
+/* statistics functions in xuartps_stats.c */
+void XUartPs_EnableStats(XUartPs *InstancePtr, XUartPsStats *StatsPtr);
+
+void XUartPs_DisableStats(XUartPs *InstancePtr);
+
+s32 XUartPs_GetStats(XUartPs *InstancePtr, XUartPsStats *SnapshotPtr);
+
+void XUartPs_EnableRxStamp(XUartPs *InstancePtr);
+
+void XUartPs_DisableRxStamp(XUartPs *InstancePtr);
+
+u64 XUartPs_GetRxStamp(XUartPs *InstancePtr);
+
+/* baud rate table functions in xuartps_baud.c */
+u32 XUartPs_ComputeBaudTable(u32 InputClockHz, const u32 *RatesPtr,
+			     u32 NumRates, XUartPsBaudEntry *TablePtr);
+
+void XUartPs_SetBaudTable(XUartPs *InstancePtr, u32 InputClockHz,
+			  const XUartPsBaudEntry *TablePtr, u32 NumEntries);
+
+s32 XUartPs_SetBaudRateRefClk(XUartPs *InstancePtr, u32 BaudRate,
+			      u32 SourceClockHz);
+
 /* self-test functions in xuartps_selftest.c */
 s32 XUartPs_SelfTest(XUartPs *InstancePtr);
 
@@ -0,0 +1,377 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file xuartps_baud.c
+* @addtogroup uartps Overview
+* @{
+*
+* This file contains the baud rate divisor tables of the XUartPs driver.
+* XUartPs_SetBaudRate() looks the requested rate up in the table attached to
+* the instance, then in the built-in table for a 100 MHz reference clock, and
+* only searches the divisors when neither has an entry for the rate and the
+* input clock. Refer to the header file xuartps.h for more detailed
+* information.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- -----------------------------------------------
+* 3.14  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xuartps.h"
+#include "xil_io.h"
+
+/************************** Constant Definitions ****************************/
+
+#define XUARTPS_BAUDDIV_MIN	4U	/* Smallest valid BDIV value */
+#define XUARTPS_BAUDDIV_MAX	254U	/* Largest valid BDIV value */
+#define XUARTPS_BRGR_MAX	0xFFFFU	/* Largest valid CD value */
+
+/* Reference clock of the built-in table */
+#define XUARTPS_BAUD_TABLE_CLK_HZ	100000000U
+
+/*
+ * Zynq-7000 SLCR registers used to change the UART reference clock divisor,
+ * the divisor is shared by both UARTs
+ */
+#define XUARTPS_SLCR_LOCK_ADDR		0xF8000004U
+#define XUARTPS_SLCR_UNLOCK_ADDR	0xF8000008U
+#define XUARTPS_SLCR_UART_CLK_CTRL	0xF8000154U
+#define XUARTPS_SLCR_LOCK_CODE		0x0000767BU
+#define XUARTPS_SLCR_UNLOCK_CODE	0x0000DF0DU
+#define XUARTPS_UART_CLK_DIV_MASK	0x00003F00U
+#define XUARTPS_UART_CLK_DIV_SHIFT	8U
+#define XUARTPS_UART_CLK_DIV_MAX	63U
+
+/* Highest UART reference clock supported by the Zynq-7000 */
+#define XUARTPS_MAX_REF_CLK_HZ		100000000U
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+u32 XUartPs_FindBaudDivisors(u32 InputClk, u32 BaudRate, u32 *BrgrPtr,
+			     u32 *BaudDivPtr);
+u32 XUartPs_LookupBaudDivisors(XUartPs *InstancePtr, u32 InputClk,
+			       u32 BaudRate, u32 *BrgrPtr, u32 *BaudDivPtr);
+
+/************************** Variable Definitions ****************************/
+
+/*
+ * Divisors for a 100 MHz reference clock, produced by the search of
+ * XUartPs_FindBaudDivisors(). Sorted by baud rate.
+ */
+static const XUartPsBaudEntry XUartPs_BaudTable100MHz[] = {
+	{    1200U, 16666U,   4U },
+	{    2400U,  8333U,   4U },
+	{    4800U,  4166U,   4U },
+	{    9600U,  1736U,   5U },
+	{   19200U,   868U,   5U },
+	{   38400U,   434U,   5U },
+	{   57600U,   248U,   6U },
+	{  115200U,   124U,   6U },
+	{  230400U,    62U,   6U },
+	{  460800U,    31U,   6U },
+	{  500000U,    40U,   4U },
+	{  576000U,    29U,   5U },
+	{  921600U,     1U, 108U },
+	{ 1000000U,    20U,   4U },
+	{ 1152000U,     3U,  28U },
+	{ 1500000U,     1U,  66U },
+	{ 2000000U,    10U,   4U },
+	{ 2500000U,     8U,   4U },
+	{ 3000000U,     3U,  10U },
+	{ 3500000U,     1U,  28U },
+	{ 4000000U,     5U,   4U }
+};
+
+#define XUARTPS_BAUD_TABLE_100MHZ_SIZE \
+	(sizeof(XUartPs_BaudTable100MHz) / sizeof(XUartPs_BaudTable100MHz[0]))
+
+/****************************************************************************/
+/**
+*
+* This function fills a baud rate divisor table for an input clock, so that
+* rates used at runtime can later be set without searching the divisors.
+* Entries for rates that cannot be generated within the allowed error get a
+* CD value of 0 and are ignored by the lookup.
+*
+* @param	InputClockHz is the UART input clock the table is for.
+* @param	RatesPtr is the list of baud rates, sorted in ascending order.
+* @param	NumRates is the number of baud rates.
+* @param	TablePtr is the table to fill, NumRates entries.
+*
+* @return	The number of rates that can be generated.
+*
+* @note		Attach the table with XUartPs_SetBaudTable().
+*
+*****************************************************************************/
+u32 XUartPs_ComputeBaudTable(u32 InputClockHz, const u32 *RatesPtr,
+			     u32 NumRates, XUartPsBaudEntry *TablePtr)
+{
+	u32 Index;
+	u32 Brgr;
+	u32 BaudDiv;
+	u32 Error;
+	u32 Usable = 0U;
+
+	Xil_AssertNonvoid(RatesPtr != NULL);
+	Xil_AssertNonvoid(TablePtr != NULL);
+
+	for (Index = 0U; Index < NumRates; Index++) {
+		Error = XUartPs_FindBaudDivisors(InputClockHz, RatesPtr[Index],
+						 &Brgr, &BaudDiv);
+
+		TablePtr[Index].BaudRate = RatesPtr[Index];
+		if ((RatesPtr[Index] != 0U) &&
+		    (((Error * 100U) / RatesPtr[Index]) <=
+		     XUARTPS_MAX_BAUD_ERROR_RATE)) {
+			TablePtr[Index].Brgr = (u16)Brgr;
+			TablePtr[Index].BaudDiv = (u8)BaudDiv;
+			Usable++;
+		} else {
+			TablePtr[Index].Brgr = 0U;
+			TablePtr[Index].BaudDiv = 0U;
+		}
+	}
+
+	return Usable;
+}
+
+/****************************************************************************/
+/**
+*
+* This function attaches a baud rate divisor table to the instance. The table
+* is only used while the input clock of the UART is InputClockHz.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	InputClockHz is the input clock the table was computed for.
+* @param	TablePtr is the table sorted by baud rate, NULL to detach.
+* @param	NumEntries is the number of entries of the table.
+*
+* @return	None.
+*
+* @note		The table must stay valid while it is attached.
+*
+*****************************************************************************/
+void XUartPs_SetBaudTable(XUartPs *InstancePtr, u32 InputClockHz,
+			  const XUartPsBaudEntry *TablePtr, u32 NumEntries)
+{
+	Xil_AssertVoid(InstancePtr != NULL);
+
+	InstancePtr->BaudTableClockHz = InputClockHz;
+	InstancePtr->BaudTablePtr = TablePtr;
+	InstancePtr->BaudTableSize = (TablePtr != NULL) ? NumEntries : 0U;
+}
+
+/****************************************************************************/
+/**
+*
+* This function sets the baud rate, first changing the divisor of the UART
+* reference clock in the SLCR when that gives a lower error than the current
+* reference clock. This makes rates such as 3 Mbaud usable that the current
+* reference clock only reaches with an error of about 1%.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	BaudRate is the baud rate to be set.
+* @param	SourceClockHz is the frequency of the PLL the UART reference
+*		clock is derived from, usually the IO PLL.
+*
+* @return
+*		- XST_SUCCESS if everything configured as expected
+*		- XST_UART_BAUD_ERROR if the requested rate is not available
+*		  because there was too much error
+*		- XST_NO_FEATURE if the platform is not a Zynq-7000
+*
+* @note		The reference clock is shared by both UARTs, the other UART
+*		must be set to its baud rate again after the change.
+*
+*****************************************************************************/
+s32 XUartPs_SetBaudRateRefClk(XUartPs *InstancePtr, u32 BaudRate,
+			      u32 SourceClockHz)
+{
+	u32 Divisor;
+	u32 RefClk;
+	u32 Brgr;
+	u32 BaudDiv;
+	u32 Error;
+	u32 BestError;
+	u32 BestDivisor = 0U;
+	u32 ClkCtrl;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+	Xil_AssertNonvoid(BaudRate <= (u32)XUARTPS_MAX_RATE);
+	Xil_AssertNonvoid(BaudRate >= (u32)XUARTPS_MIN_RATE);
+
+	if (InstancePtr->Platform != (u32)XPLAT_ZYNQ) {
+		return (s32)XST_NO_FEATURE;
+	}
+
+	/* The current reference clock wins ties */
+	BestError = XUartPs_FindBaudDivisors(InstancePtr->Config.InputClockHz,
+					     BaudRate, &Brgr, &BaudDiv);
+
+	for (Divisor = 1U; Divisor <= XUARTPS_UART_CLK_DIV_MAX; Divisor++) {
+		RefClk = SourceClockHz / Divisor;
+		if (RefClk > XUARTPS_MAX_REF_CLK_HZ) {
+			continue;
+		}
+
+		Error = XUartPs_FindBaudDivisors(RefClk, BaudRate, &Brgr,
+						 &BaudDiv);
+		if (Error < BestError) {
+			BestError = Error;
+			BestDivisor = Divisor;
+		}
+	}
+
+	if (BestDivisor != 0U) {
+		XUartPs_DisableUart(InstancePtr);
+
+		Xil_Out32(XUARTPS_SLCR_UNLOCK_ADDR, XUARTPS_SLCR_UNLOCK_CODE);
+		ClkCtrl = Xil_In32(XUARTPS_SLCR_UART_CLK_CTRL);
+		ClkCtrl &= ~XUARTPS_UART_CLK_DIV_MASK;
+		ClkCtrl |= BestDivisor << XUARTPS_UART_CLK_DIV_SHIFT;
+		Xil_Out32(XUARTPS_SLCR_UART_CLK_CTRL, ClkCtrl);
+		Xil_Out32(XUARTPS_SLCR_LOCK_ADDR, XUARTPS_SLCR_LOCK_CODE);
+
+		InstancePtr->Config.InputClockHz = SourceClockHz / BestDivisor;
+	}
+
+	return XUartPs_SetBaudRate(InstancePtr, BaudRate);
+}
+
+/****************************************************************************/
+/*
+*
+* This function searches the CD (BRGR) and BDIV values that generate the baud
+* rate closest to the requested one. For every BDIV both the CD value below
+* and above the exact quotient are tried, and CD values that do not fit the
+* register are skipped.
+*
+* @param	InputClk is the UART input clock, after the divide by 8.
+* @param	BaudRate is the requested baud rate.
+* @param	BrgrPtr is where the best CD value is stored.
+* @param	BaudDivPtr is where the best BDIV value is stored.
+*
+* @return	The difference between the generated and the requested baud
+*		rate, 0xFFFFFFFF if the rate cannot be generated at all.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 XUartPs_FindBaudDivisors(u32 InputClk, u32 BaudRate, u32 *BrgrPtr,
+			     u32 *BaudDivPtr)
+{
+	u32 IterBAUDDIV;
+	u32 Brgr;
+	u32 Step;
+	u32 CalcBaudRate;
+	u32 BaudError;
+	u32 BestError = 0xFFFFFFFFU;
+
+	*BrgrPtr = 0U;
+	*BaudDivPtr = 0U;
+
+	for (IterBAUDDIV = XUARTPS_BAUDDIV_MIN;
+	     IterBAUDDIV <= XUARTPS_BAUDDIV_MAX; IterBAUDDIV++) {
+		Brgr = InputClk / (BaudRate * (IterBAUDDIV + 1U));
+
+		for (Step = 0U; Step < 2U; Step++) {
+			if ((Brgr != 0U) && (Brgr <= XUARTPS_BRGR_MAX)) {
+				CalcBaudRate = InputClk / (Brgr * (IterBAUDDIV + 1U));
+
+				if (BaudRate > CalcBaudRate) {
+					BaudError = BaudRate - CalcBaudRate;
+				} else {
+					BaudError = CalcBaudRate - BaudRate;
+				}
+
+				if (BestError > BaudError) {
+					*BrgrPtr = Brgr;
+					*BaudDivPtr = IterBAUDDIV;
+					BestError = BaudError;
+				}
+			}
+			Brgr++;
+		}
+	}
+
+	return BestError;
+}
+
+/****************************************************************************/
+/*
+*
+* This function looks the divisors for a baud rate up in the table attached
+* to the instance and in the built-in table, whichever matches the input
+* clock.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	InputClk is the UART input clock, after the divide by 8.
+* @param	BaudRate is the requested baud rate.
+* @param	BrgrPtr is where the CD value is stored.
+* @param	BaudDivPtr is where the BDIV value is stored.
+*
+* @return	TRUE if an entry was found, FALSE otherwise.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 XUartPs_LookupBaudDivisors(XUartPs *InstancePtr, u32 InputClk,
+			       u32 BaudRate, u32 *BrgrPtr, u32 *BaudDivPtr)
+{
+	const XUartPsBaudEntry *TablePtr;
+	u32 Size;
+	u32 Low;
+	u32 High;
+	u32 Mid;
+
+	if ((InstancePtr->BaudTablePtr != NULL) &&
+	    (InstancePtr->BaudTableClockHz == InputClk)) {
+		TablePtr = InstancePtr->BaudTablePtr;
+		Size = InstancePtr->BaudTableSize;
+	} else if (InputClk == XUARTPS_BAUD_TABLE_CLK_HZ) {
+		TablePtr = XUartPs_BaudTable100MHz;
+		Size = (u32)XUARTPS_BAUD_TABLE_100MHZ_SIZE;
+	} else {
+		return FALSE;
+	}
+
+	/* Binary search, the tables are sorted by baud rate */
+	Low = 0U;
+	High = Size;
+	while (Low < High) {
+		Mid = Low + ((High - Low) / 2U);
+		if (TablePtr[Mid].BaudRate < BaudRate) {
+			Low = Mid + 1U;
+		} else {
+			High = Mid;
+		}
+	}
+
+	/* A CD value of 0 marks a rate that cannot be generated */
+	if ((Low >= Size) || (TablePtr[Low].BaudRate != BaudRate) ||
+	    (TablePtr[Low].Brgr == 0U)) {
+		return FALSE;
+	}
+
+	*BrgrPtr = (u32)TablePtr[Low].Brgr;
+	*BaudDivPtr = (u32)TablePtr[Low].BaudDiv;
+
+	return TRUE;
+}
+/** @} */
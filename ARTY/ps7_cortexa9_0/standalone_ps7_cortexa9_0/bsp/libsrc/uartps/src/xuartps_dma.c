@@ -0,0 +1,832 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file xuartps_dma.c
+* @addtogroup uartps Overview
+* @{
+*
+* This file contains the DMA assisted bulk transfer mode of the XUartPs
+* driver. Refer to the header file xuartps_dma.h for more detailed
+* information.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- -----------------------------------------------
+* 3.14  qm     10/14/26 First release
+*       qm     10/14/26 Receive buffers in the DMA arena are not flushed.
+*       qm     10/14/26 Added the idle line terminated frame receive.
+*       qm     10/14/26 A receive timeout seen during a DMA burst is
+*			handled by the done handler of the burst.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+
+#include "xuartps_dma.h"
+#include "xil_io.h"
+#include "xil_cache.h"
+#include "xil_dmaarena.h"
+
+/************************** Constant Definitions ****************************/
+
+/* RX interrupts used while a DMA receive is in progress */
+#define XUARTPS_DMA_RX_IXR	((u32)XUARTPS_IXR_RXOVR | (u32)XUARTPS_IXR_TOUT | \
+				 (u32)XUARTPS_IXR_OVER | (u32)XUARTPS_IXR_FRAMING | \
+				 (u32)XUARTPS_IXR_PARITY)
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static s32 XUartPs_DmaStartTx(XUartPs_Dma *InstancePtr);
+static s32 XUartPs_DmaStartRx(XUartPs_Dma *InstancePtr);
+static void XUartPs_DmaTxDone(unsigned int Channel, XDmaPs_Cmd *DmaCmd,
+			      void *CallbackRef);
+static void XUartPs_DmaRxDone(unsigned int Channel, XDmaPs_Cmd *DmaCmd,
+			      void *CallbackRef);
+static void XUartPs_DmaRxTimeout(XUartPs_Dma *InstancePtr);
+static u32 XUartPs_DmaRxDrain(XUartPs_Dma *InstancePtr);
+static void XUartPs_DmaFrameArm(XUartPs_Dma *InstancePtr, u32 Index);
+static void XUartPs_DmaFrameEnd(XUartPs_Dma *InstancePtr);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* Initializes the DMA assisted transfer state of a UART. Both the UART and
+* the DMA controller instances must already be initialized.
+*
+* @param	InstancePtr is a pointer to the XUartPs_Dma instance.
+* @param	UartPtr is a pointer to the XUartPs instance.
+* @param	DmaPtr is a pointer to the XDmaPs instance.
+* @param	TxChannel is the DMA channel reserved for sending.
+* @param	RxChannel is the DMA channel reserved for receiving.
+*
+* @return
+*		- XST_SUCCESS if the instance was initialized.
+*		- XST_INVALID_PARAM if the channels are out of range or equal.
+*
+* @note		The done handlers of both DMA channels are taken over.
+*
+*****************************************************************************/
+s32 XUartPs_DmaInitialize(XUartPs_Dma *InstancePtr, XUartPs *UartPtr,
+			  XDmaPs *DmaPtr, u32 TxChannel, u32 RxChannel)
+{
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(UartPtr != NULL);
+	Xil_AssertNonvoid(DmaPtr != NULL);
+	Xil_AssertNonvoid(UartPtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	if ((TxChannel >= (u32)XDMAPS_CHANNELS_PER_DEV) ||
+	    (RxChannel >= (u32)XDMAPS_CHANNELS_PER_DEV) ||
+	    (TxChannel == RxChannel)) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	(void)memset(InstancePtr, 0, sizeof(XUartPs_Dma));
+	InstancePtr->UartPtr = UartPtr;
+	InstancePtr->DmaPtr = DmaPtr;
+	InstancePtr->TxChannel = TxChannel;
+	InstancePtr->RxChannel = RxChannel;
+
+	(void)XDmaPs_SetDoneHandler(DmaPtr, TxChannel, XUartPs_DmaTxDone,
+				    InstancePtr);
+	(void)XDmaPs_SetDoneHandler(DmaPtr, RxChannel, XUartPs_DmaRxDone,
+				    InstancePtr);
+
+	/* The interrupts are armed per transfer */
+	XUartPs_WriteReg(UartPtr->Config.BaseAddress, XUARTPS_IDR_OFFSET,
+			 XUARTPS_IXR_MASK);
+
+	return (s32)XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Sets the handler called when a DMA assisted transfer completes. The events
+* passed are XUARTPS_EVENT_SENT_DATA, XUARTPS_EVENT_RECV_DATA,
+* XUARTPS_EVENT_RECV_TOUT and XUARTPS_EVENT_RECV_ERROR, with the number of
+* bytes transferred as event data.
+*
+* @param	InstancePtr is a pointer to the XUartPs_Dma instance.
+* @param	FuncPtr is the pointer to the callback function.
+* @param	CallBackRef is passed back when the callback is invoked.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XUartPs_DmaSetHandler(XUartPs_Dma *InstancePtr, XUartPs_Handler FuncPtr,
+			   void *CallBackRef)
+{
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(FuncPtr != NULL);
+
+	InstancePtr->Handler = FuncPtr;
+	InstancePtr->CallBackRef = CallBackRef;
+}
+
+/****************************************************************************/
+/**
+*
+* Starts sending a buffer with the DMA controller. The function returns
+* immediately, the handler is called with XUARTPS_EVENT_SENT_DATA once the
+* whole buffer has been moved into the TX FIFO.
+*
+* @param	InstancePtr is a pointer to the XUartPs_Dma instance.
+* @param	BufferPtr is the data to be sent.
+* @param	NumBytes is the number of bytes to be sent.
+*
+* @return
+*		- XST_SUCCESS if the transfer was started.
+*		- XST_DEVICE_BUSY if a send is already in progress.
+*		- XST_FAILURE if the DMA program could not be started.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 XUartPs_DmaSend(XUartPs_Dma *InstancePtr, u8 *BufferPtr, u32 NumBytes)
+{
+	u32 BaseAddress;
+	s32 Status = (s32)XST_SUCCESS;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(BufferPtr != NULL);
+	Xil_AssertNonvoid(NumBytes != 0U);
+	Xil_AssertNonvoid(InstancePtr->Handler != NULL);
+
+	if ((InstancePtr->SendBuffer.RemainingBytes != 0U) ||
+	    (InstancePtr->TxBurst != 0U)) {
+		return (s32)XST_DEVICE_BUSY;
+	}
+
+	BaseAddress = InstancePtr->UartPtr->Config.BaseAddress;
+
+	InstancePtr->SendBuffer.NextBytePtr = BufferPtr;
+	InstancePtr->SendBuffer.RequestedBytes = NumBytes;
+	InstancePtr->SendBuffer.RemainingBytes = NumBytes;
+
+	/*
+	 * An empty FIFO can take the first burst right away, otherwise the
+	 * TX empty interrupt starts it.
+	 */
+	if (XUartPs_IsTransmitFifoEmpty(BaseAddress)) {
+		Status = XUartPs_DmaStartTx(InstancePtr);
+	} else {
+		XUartPs_WriteReg(BaseAddress, XUARTPS_IER_OFFSET,
+				 XUARTPS_IXR_TXEMPTY);
+	}
+
+	return Status;
+}
+
+/****************************************************************************/
+/**
+*
+* Starts receiving into a buffer with the DMA controller. The RX FIFO
+* trigger level is set to XUARTPS_DMA_RX_TRIGGER and every trigger interrupt
+* moves that many bytes with one DMA burst. Bytes left in the FIFO when the
+* line goes idle are picked up by the CPU on the receive timeout.
+*
+* @param	InstancePtr is a pointer to the XUartPs_Dma instance.
+* @param	BufferPtr is the buffer to receive into, preferably cache line
+*		aligned.
+* @param	NumBytes is the number of bytes to be received.
+*
+* @return
+*		- XST_SUCCESS if the receive was started.
+*		- XST_DEVICE_BUSY if a receive is already in progress.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 XUartPs_DmaRecv(XUartPs_Dma *InstancePtr, u8 *BufferPtr, u32 NumBytes)
+{
+	u32 BaseAddress;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(BufferPtr != NULL);
+	Xil_AssertNonvoid(NumBytes != 0U);
+	Xil_AssertNonvoid(InstancePtr->Handler != NULL);
+
+	if ((InstancePtr->ReceiveBuffer.RemainingBytes != 0U) ||
+	    (InstancePtr->RxBurst != 0U) || (InstancePtr->FrameMode != 0U)) {
+		return (s32)XST_DEVICE_BUSY;
+	}
+
+	BaseAddress = InstancePtr->UartPtr->Config.BaseAddress;
+
+	InstancePtr->ReceiveBuffer.NextBytePtr = BufferPtr;
+	InstancePtr->ReceiveBuffer.RequestedBytes = NumBytes;
+	InstancePtr->ReceiveBuffer.RemainingBytes = NumBytes;
+	InstancePtr->TimeoutPending = 0U;
+
+	XUartPs_WriteReg(BaseAddress, XUARTPS_RXWM_OFFSET,
+			 XUARTPS_DMA_RX_TRIGGER);
+	XUartPs_WriteReg(BaseAddress, XUARTPS_IER_OFFSET, XUARTPS_DMA_RX_IXR);
+
+	return (s32)XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Starts receiving idle line terminated frames into two ping-pong buffers,
+* see Idle Line Frames. Reception runs until XUartPs_DmaStopFrames().
+*
+* @param	InstancePtr is a pointer to the XUartPs_Dma instance.
+* @param	Buf0Ptr is the first frame buffer, preferably cache line
+*		aligned.
+* @param	Buf1Ptr is the second frame buffer, likewise.
+* @param	Size is the number of bytes of each buffer, the longest frame
+*		passed on whole.
+* @param	FuncPtr is called with each frame.
+* @param	CallBackRef is passed back to FuncPtr.
+*
+* @return
+*		- XST_SUCCESS if the reception was started.
+*		- XST_DEVICE_BUSY if a receive is already in progress.
+*
+* @note		The frame handler is called from the UART and DMA
+*		interrupts, and from XUartPs_DmaFrameDone() when it resumes a
+*		paused reception.
+*
+*****************************************************************************/
+s32 XUartPs_DmaRecvFrames(XUartPs_Dma *InstancePtr, u8 *Buf0Ptr,
+			  u8 *Buf1Ptr, u32 Size,
+			  XUartPs_DmaFrameHandler FuncPtr, void *CallBackRef)
+{
+	u32 BaseAddress;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(Buf0Ptr != NULL);
+	Xil_AssertNonvoid(Buf1Ptr != NULL);
+	Xil_AssertNonvoid(Size != 0U);
+	Xil_AssertNonvoid(FuncPtr != NULL);
+
+	if ((InstancePtr->ReceiveBuffer.RemainingBytes != 0U) ||
+	    (InstancePtr->RxBurst != 0U) || (InstancePtr->FrameMode != 0U)) {
+		return (s32)XST_DEVICE_BUSY;
+	}
+
+	BaseAddress = InstancePtr->UartPtr->Config.BaseAddress;
+
+	InstancePtr->FrameBuf[0] = Buf0Ptr;
+	InstancePtr->FrameBuf[1] = Buf1Ptr;
+	InstancePtr->FrameSize = Size;
+	InstancePtr->FrameOwned[0] = 0U;
+	InstancePtr->FrameOwned[1] = 0U;
+	InstancePtr->FrameStalled = 0U;
+	InstancePtr->TimeoutPending = 0U;
+	InstancePtr->FrameHandler = FuncPtr;
+	InstancePtr->FrameRef = CallBackRef;
+	InstancePtr->FrameMode = 1U;
+	XUartPs_DmaFrameArm(InstancePtr, 0U);
+
+	XUartPs_WriteReg(BaseAddress, XUARTPS_RXWM_OFFSET,
+			 XUARTPS_DMA_RX_TRIGGER);
+	XUartPs_WriteReg(BaseAddress, XUARTPS_IER_OFFSET, XUARTPS_DMA_RX_IXR);
+
+	return (s32)XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Gives a frame back to the reception of XUartPs_DmaRecvFrames(). A paused
+* reception resumes into it, starting with the bytes waiting in the RX FIFO.
+*
+* @param	InstancePtr is a pointer to the XUartPs_Dma instance.
+* @param	FramePtr is the frame passed to the frame handler.
+*
+* @return	None.
+*
+* @note		It may be called from the frame handler. The UART interrupt
+*		must be taken by the calling CPU.
+*
+*****************************************************************************/
+void XUartPs_DmaFrameDone(XUartPs_Dma *InstancePtr, u8 *FramePtr)
+{
+	u32 Index;
+
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid((FramePtr == InstancePtr->FrameBuf[0]) ||
+		       (FramePtr == InstancePtr->FrameBuf[1]));
+
+	Index = (FramePtr == InstancePtr->FrameBuf[1]) ? 1U : 0U;
+	InstancePtr->FrameOwned[Index] = 0U;
+
+	/* The RX interrupts are off while paused, nothing races with this */
+	if ((InstancePtr->FrameMode == 0U) ||
+	    (InstancePtr->FrameStalled == 0U)) {
+		return;
+	}
+
+	InstancePtr->FrameStalled = 0U;
+	XUartPs_DmaFrameArm(InstancePtr, Index);
+
+	/* The line went idle while paused, the tail is in the FIFO */
+	if (InstancePtr->TimeoutPending != 0U) {
+		InstancePtr->TimeoutPending = 0U;
+		XUartPs_DmaRxTimeout(InstancePtr);
+	}
+
+	if (InstancePtr->FrameStalled == 0U) {
+		XUartPs_WriteReg(InstancePtr->UartPtr->Config.BaseAddress,
+				 XUARTPS_IER_OFFSET, XUARTPS_DMA_RX_IXR);
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Stops the reception of XUartPs_DmaRecvFrames(). The bytes of the frame in
+* progress are dropped.
+*
+* @param	InstancePtr is a pointer to the XUartPs_Dma instance.
+*
+* @return
+*		- XST_SUCCESS if the reception stopped.
+*		- XST_DEVICE_BUSY if a DMA burst is in flight, try again.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 XUartPs_DmaStopFrames(XUartPs_Dma *InstancePtr)
+{
+	Xil_AssertNonvoid(InstancePtr != NULL);
+
+	if (InstancePtr->RxBurst != 0U) {
+		return (s32)XST_DEVICE_BUSY;
+	}
+
+	XUartPs_WriteReg(InstancePtr->UartPtr->Config.BaseAddress,
+			 XUARTPS_IDR_OFFSET, XUARTPS_DMA_RX_IXR);
+	InstancePtr->FrameMode = 0U;
+	InstancePtr->FrameStalled = 0U;
+	InstancePtr->TimeoutPending = 0U;
+	InstancePtr->ReceiveBuffer.RemainingBytes = 0U;
+
+	return (s32)XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* This function is the UART interrupt handler for the DMA assisted mode. It
+* must be connected to the UART interrupt instead of
+* XUartPs_InterruptHandler().
+*
+* @param	InstancePtr is a pointer to the XUartPs_Dma instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XUartPs_DmaInterruptHandler(XUartPs_Dma *InstancePtr)
+{
+	u32 BaseAddress;
+	u32 IsrStatus;
+
+	Xil_AssertVoid(InstancePtr != NULL);
+
+	BaseAddress = InstancePtr->UartPtr->Config.BaseAddress;
+
+	IsrStatus = XUartPs_ReadReg(BaseAddress, XUARTPS_IMR_OFFSET);
+	IsrStatus &= XUartPs_ReadReg(BaseAddress, XUARTPS_ISR_OFFSET);
+
+	if ((IsrStatus & (u32)XUARTPS_IXR_TXEMPTY) != (u32)0) {
+		/* Re-armed by the DMA done handler when more data is left */
+		XUartPs_WriteReg(BaseAddress, XUARTPS_IDR_OFFSET,
+				 XUARTPS_IXR_TXEMPTY);
+		if ((InstancePtr->SendBuffer.RemainingBytes != 0U) &&
+		    (InstancePtr->TxBurst == 0U)) {
+			(void)XUartPs_DmaStartTx(InstancePtr);
+		}
+	}
+
+	if ((IsrStatus & (u32)XUARTPS_IXR_RXOVR) != (u32)0) {
+		/* Re-armed by the DMA done handler when more data is wanted */
+		XUartPs_WriteReg(BaseAddress, XUARTPS_IDR_OFFSET,
+				 XUARTPS_IXR_RXOVR);
+		if ((InstancePtr->ReceiveBuffer.RemainingBytes == 0U) ||
+		    (InstancePtr->RxBurst != 0U)) {
+			/* Nothing wanted, or the done handler re-arms it */
+		} else if ((XUartPs_ReadReg(BaseAddress, XUARTPS_SR_OFFSET) &
+			    (u32)XUARTPS_SR_RXOVR) != (u32)0) {
+			(void)XUartPs_DmaStartRx(InstancePtr);
+		} else {
+			/*
+			 * Raised while the last burst read the FIFO down,
+			 * cleared below and wait for the next trigger.
+			 */
+			XUartPs_WriteReg(BaseAddress, XUARTPS_IER_OFFSET,
+					 XUARTPS_IXR_RXOVR);
+		}
+	}
+
+	if ((IsrStatus & (u32)XUARTPS_IXR_TOUT) != (u32)0) {
+		XUartPs_DmaRxTimeout(InstancePtr);
+	}
+
+	if (((IsrStatus & ((u32)XUARTPS_IXR_OVER | (u32)XUARTPS_IXR_FRAMING |
+			  (u32)XUARTPS_IXR_PARITY)) != (u32)0) &&
+	    (InstancePtr->Handler != NULL)) {
+		InstancePtr->Handler(InstancePtr->CallBackRef,
+				     XUARTPS_EVENT_RECV_ERROR,
+				     InstancePtr->ReceiveBuffer.RequestedBytes -
+				     InstancePtr->ReceiveBuffer.RemainingBytes);
+	}
+
+	XUartPs_WriteReg(BaseAddress, XUARTPS_ISR_OFFSET, IsrStatus);
+}
+
+/****************************************************************************/
+/*
+*
+* Starts one TX burst of up to a FIFO depth of data. Must only be called
+* while the TX FIFO is empty.
+*
+* @param	InstancePtr is a pointer to the XUartPs_Dma instance.
+*
+* @return	The status returned by XDmaPs_Start().
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 XUartPs_DmaStartTx(XUartPs_Dma *InstancePtr)
+{
+	XDmaPs_Cmd *CmdPtr = &InstancePtr->TxCmd;
+	u32 Length = InstancePtr->SendBuffer.RemainingBytes;
+	s32 Status;
+
+	if (Length > XUARTPS_FIFO_DEPTH) {
+		Length = XUARTPS_FIFO_DEPTH;
+	}
+
+	(void)memset(CmdPtr, 0, sizeof(XDmaPs_Cmd));
+	CmdPtr->ChanCtrl.SrcBurstSize = 1U;
+	CmdPtr->ChanCtrl.SrcBurstLen = 1U;
+	CmdPtr->ChanCtrl.SrcInc = 1U;
+	CmdPtr->ChanCtrl.DstBurstSize = 1U;
+	CmdPtr->ChanCtrl.DstBurstLen = 1U;
+	CmdPtr->ChanCtrl.DstInc = 0U;
+	CmdPtr->BD.SrcAddr = (u32)InstancePtr->SendBuffer.NextBytePtr;
+	CmdPtr->BD.DstAddr = InstancePtr->UartPtr->Config.BaseAddress +
+			     (u32)XUARTPS_FIFO_OFFSET;
+	CmdPtr->BD.Length = Length;
+
+	InstancePtr->TxBurst = Length;
+	Status = XDmaPs_Start(InstancePtr->DmaPtr, InstancePtr->TxChannel,
+			      CmdPtr, 0);
+	if (Status != XST_SUCCESS) {
+		InstancePtr->TxBurst = 0U;
+	}
+
+	return Status;
+}
+
+/****************************************************************************/
+/*
+*
+* Starts one RX burst. Called on the RX trigger interrupt, so at least
+* XUARTPS_DMA_RX_TRIGGER bytes are known to be in the FIFO.
+*
+* @param	InstancePtr is a pointer to the XUartPs_Dma instance.
+*
+* @return	The status returned by XDmaPs_Start().
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 XUartPs_DmaStartRx(XUartPs_Dma *InstancePtr)
+{
+	XDmaPs_Cmd *CmdPtr = &InstancePtr->RxCmd;
+	u32 Length = InstancePtr->ReceiveBuffer.RemainingBytes;
+	s32 Status;
+
+	if (Length > XUARTPS_DMA_RX_TRIGGER) {
+		Length = XUARTPS_DMA_RX_TRIGGER;
+	}
+
+	(void)memset(CmdPtr, 0, sizeof(XDmaPs_Cmd));
+	CmdPtr->ChanCtrl.SrcBurstSize = 1U;
+	CmdPtr->ChanCtrl.SrcBurstLen = 1U;
+	CmdPtr->ChanCtrl.SrcInc = 0U;
+	CmdPtr->ChanCtrl.DstBurstSize = 1U;
+	CmdPtr->ChanCtrl.DstBurstLen = 1U;
+	CmdPtr->ChanCtrl.DstInc = 1U;
+	CmdPtr->BD.SrcAddr = InstancePtr->UartPtr->Config.BaseAddress +
+			     (u32)XUARTPS_FIFO_OFFSET;
+	CmdPtr->BD.DstAddr = (u32)InstancePtr->ReceiveBuffer.NextBytePtr;
+	CmdPtr->BD.Length = Length;
+
+	InstancePtr->RxBurst = Length;
+	Status = XDmaPs_Start(InstancePtr->DmaPtr, InstancePtr->RxChannel,
+			      CmdPtr, 0);
+	if (Status != XST_SUCCESS) {
+		InstancePtr->RxBurst = 0U;
+	}
+
+	return Status;
+}
+
+/****************************************************************************/
+/*
+*
+* DMA done handler of the TX channel. Accounts the finished burst and either
+* completes the send or waits for the FIFO to drain before the next burst.
+*
+* @param	Channel is the DMA channel number.
+* @param	DmaCmd is the finished command.
+* @param	CallbackRef is the XUartPs_Dma instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void XUartPs_DmaTxDone(unsigned int Channel, XDmaPs_Cmd *DmaCmd,
+			      void *CallbackRef)
+{
+	XUartPs_Dma *InstancePtr = (XUartPs_Dma *)CallbackRef;
+	u32 Burst = InstancePtr->TxBurst;
+
+	(void)Channel;
+	(void)DmaCmd;
+
+	InstancePtr->SendBuffer.NextBytePtr += Burst;
+	InstancePtr->SendBuffer.RemainingBytes -= Burst;
+	InstancePtr->TxBurst = 0U;
+
+	if (InstancePtr->SendBuffer.RemainingBytes == 0U) {
+		InstancePtr->Handler(InstancePtr->CallBackRef,
+				     XUARTPS_EVENT_SENT_DATA,
+				     InstancePtr->SendBuffer.RequestedBytes);
+	} else {
+		XUartPs_WriteReg(InstancePtr->UartPtr->Config.BaseAddress,
+				 XUARTPS_IER_OFFSET, XUARTPS_IXR_TXEMPTY);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* DMA done handler of the RX channel. Accounts the finished burst and either
+* completes the receive or re-arms the RX trigger interrupt.
+*
+* @param	Channel is the DMA channel number.
+* @param	DmaCmd is the finished command.
+* @param	CallbackRef is the XUartPs_Dma instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void XUartPs_DmaRxDone(unsigned int Channel, XDmaPs_Cmd *DmaCmd,
+			      void *CallbackRef)
+{
+	XUartPs_Dma *InstancePtr = (XUartPs_Dma *)CallbackRef;
+	u32 BaseAddress = InstancePtr->UartPtr->Config.BaseAddress;
+	u32 Burst = InstancePtr->RxBurst;
+
+	(void)Channel;
+	(void)DmaCmd;
+
+	InstancePtr->ReceiveBuffer.NextBytePtr += Burst;
+	InstancePtr->ReceiveBuffer.RemainingBytes -= Burst;
+	InstancePtr->RxBurst = 0U;
+
+	if (InstancePtr->FrameMode != 0U) {
+		/* A full buffer is a frame, the frame goes on in the next */
+		if (InstancePtr->ReceiveBuffer.RemainingBytes == 0U) {
+			XUartPs_DmaFrameEnd(InstancePtr);
+		}
+		/* The line went idle during the burst, the tail ends it */
+		if ((InstancePtr->TimeoutPending != 0U) &&
+		    (InstancePtr->FrameStalled == 0U)) {
+			InstancePtr->TimeoutPending = 0U;
+			XUartPs_DmaRxTimeout(InstancePtr);
+		}
+		if (InstancePtr->FrameStalled == 0U) {
+			XUartPs_WriteReg(BaseAddress, XUARTPS_IER_OFFSET,
+					 XUARTPS_IXR_RXOVR);
+		}
+		return;
+	}
+
+	if (InstancePtr->ReceiveBuffer.RemainingBytes == 0U) {
+		InstancePtr->TimeoutPending = 0U;
+		XUartPs_WriteReg(BaseAddress, XUARTPS_IDR_OFFSET,
+				 XUARTPS_DMA_RX_IXR);
+		InstancePtr->Handler(InstancePtr->CallBackRef,
+				     XUARTPS_EVENT_RECV_DATA,
+				     InstancePtr->ReceiveBuffer.RequestedBytes);
+		return;
+	}
+
+	/*
+	 * The line went idle during the burst, the timeout does not fire
+	 * again and the tail is below the trigger, read it now
+	 */
+	if (InstancePtr->TimeoutPending != 0U) {
+		InstancePtr->TimeoutPending = 0U;
+		XUartPs_DmaRxTimeout(InstancePtr);
+	}
+	if (InstancePtr->ReceiveBuffer.RemainingBytes != 0U) {
+		XUartPs_WriteReg(BaseAddress, XUARTPS_IER_OFFSET,
+				 XUARTPS_IXR_RXOVR);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Handles the receive timeout. The bytes below the trigger level are read
+* by the CPU, unless a DMA burst is still in flight, in which case the
+* timeout is latched in TimeoutPending and the done handler of the burst
+* calls this function again. In frame mode the line going idle ends the
+* frame.
+*
+* @param	InstancePtr is a pointer to the XUartPs_Dma instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void XUartPs_DmaRxTimeout(XUartPs_Dma *InstancePtr)
+{
+	u32 BaseAddress = InstancePtr->UartPtr->Config.BaseAddress;
+	XUartPsBuffer *BufPtr = &InstancePtr->ReceiveBuffer;
+	u32 Event;
+
+	if (InstancePtr->FrameMode != 0U) {
+		if ((InstancePtr->RxBurst != 0U) ||
+		    (InstancePtr->FrameStalled != 0U)) {
+			InstancePtr->TimeoutPending = 1U;
+			return;
+		}
+
+		/* Until the FIFO is empty, a frame per full buffer */
+		for (;;) {
+			(void)XUartPs_DmaRxDrain(InstancePtr);
+			XUartPs_DmaFrameEnd(InstancePtr);
+			if (InstancePtr->FrameStalled != 0U) {
+				InstancePtr->TimeoutPending = 1U;
+				break;
+			}
+			if (!XUartPs_IsReceiveData(BaseAddress)) {
+				break;
+			}
+		}
+		return;
+	}
+
+	if (BufPtr->RemainingBytes == 0U) {
+		return;
+	}
+	if (InstancePtr->RxBurst != 0U) {
+		InstancePtr->TimeoutPending = 1U;
+		return;
+	}
+
+	(void)XUartPs_DmaRxDrain(InstancePtr);
+
+	if (BufPtr->RemainingBytes == 0U) {
+		XUartPs_WriteReg(BaseAddress, XUARTPS_IDR_OFFSET,
+				 XUARTPS_DMA_RX_IXR);
+		Event = XUARTPS_EVENT_RECV_DATA;
+	} else {
+		Event = XUARTPS_EVENT_RECV_TOUT;
+	}
+
+	InstancePtr->Handler(InstancePtr->CallBackRef, Event,
+			     BufPtr->RequestedBytes - BufPtr->RemainingBytes);
+}
+
+/****************************************************************************/
+/*
+*
+* Reads the bytes of the RX FIFO into the receive buffer with the CPU, up to
+* the end of the buffer.
+*
+* @param	InstancePtr is a pointer to the XUartPs_Dma instance, with no
+*		DMA burst in flight.
+*
+* @return	The number of bytes read.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 XUartPs_DmaRxDrain(XUartPs_Dma *InstancePtr)
+{
+	u32 BaseAddress = InstancePtr->UartPtr->Config.BaseAddress;
+	XUartPsBuffer *BufPtr = &InstancePtr->ReceiveBuffer;
+	u8 *StartPtr = BufPtr->NextBytePtr;
+	u32 Count = 0U;
+
+	while ((Count < BufPtr->RemainingBytes) &&
+	       (XUartPs_IsReceiveData(BaseAddress))) {
+		StartPtr[Count] = (u8)XUartPs_ReadReg(BaseAddress,
+						      XUARTPS_FIFO_OFFSET);
+		Count++;
+	}
+
+	/*
+	 * Later DMA bursts invalidate the destination range, push the bytes
+	 * written by the CPU out so they are not lost. A buffer in the DMA
+	 * arena is not cached.
+	 */
+	if ((Count != 0U) &&
+	    (Xil_DmaArenaContains((UINTPTR)StartPtr, Count) == 0U)) {
+		Xil_DCacheFlushRange((INTPTR)StartPtr, Count);
+	}
+
+	BufPtr->NextBytePtr += Count;
+	BufPtr->RemainingBytes -= Count;
+
+	return Count;
+}
+
+/****************************************************************************/
+/*
+*
+* Selects the frame buffer reception goes into.
+*
+* @param	InstancePtr is a pointer to the XUartPs_Dma instance.
+* @param	Index is the buffer, 0 or 1.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void XUartPs_DmaFrameArm(XUartPs_Dma *InstancePtr, u32 Index)
+{
+	InstancePtr->FrameIndex = Index;
+	InstancePtr->ReceiveBuffer.NextBytePtr = InstancePtr->FrameBuf[Index];
+	InstancePtr->ReceiveBuffer.RequestedBytes = InstancePtr->FrameSize;
+	InstancePtr->ReceiveBuffer.RemainingBytes = InstancePtr->FrameSize;
+}
+
+/****************************************************************************/
+/*
+*
+* Passes the bytes of the current frame buffer to the frame handler and
+* moves reception to the other buffer, or pauses it if the application
+* still holds that one.
+*
+* @param	InstancePtr is a pointer to the XUartPs_Dma instance, with no
+*		DMA burst in flight.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void XUartPs_DmaFrameEnd(XUartPs_Dma *InstancePtr)
+{
+	XUartPsBuffer *BufPtr = &InstancePtr->ReceiveBuffer;
+	u32 Index = InstancePtr->FrameIndex;
+	u32 Count = BufPtr->RequestedBytes - BufPtr->RemainingBytes;
+	u32 Next = Index ^ 1U;
+
+	if (Count == 0U) {
+		return;
+	}
+
+	InstancePtr->FrameOwned[Index] = 1U;
+	InstancePtr->Frames++;
+
+	if (InstancePtr->FrameOwned[Next] == 0U) {
+		XUartPs_DmaFrameArm(InstancePtr, Next);
+	} else {
+		/* The bytes wait in the RX FIFO until a buffer is free */
+		XUartPs_WriteReg(InstancePtr->UartPtr->Config.BaseAddress,
+				 XUARTPS_IDR_OFFSET, XUARTPS_DMA_RX_IXR);
+		BufPtr->RemainingBytes = 0U;
+		InstancePtr->FrameStalled = 1U;
+		InstancePtr->FrameStalls++;
+	}
+
+	InstancePtr->FrameHandler(InstancePtr->FrameRef,
+				  InstancePtr->FrameBuf[Index], Count);
+}
+/** @} */
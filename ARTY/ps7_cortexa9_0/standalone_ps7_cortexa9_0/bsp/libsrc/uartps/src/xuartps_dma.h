@@ -0,0 +1,143 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file xuartps_dma.h
+* @addtogroup uartps Overview
+* @{
+* @details
+*
+* This file contains the DMA assisted bulk transfer mode of the XUartPs
+* driver, built on top of the PS DMA controller (PL330) driver XDmaPs.
+*
+* The Zynq-7000 PS UARTs are not connected to the PL330 peripheral request
+* interface, so the DMA cannot pace itself against the FIFOs. Instead the
+* UART interrupts pace the DMA: every TX empty interrupt starts one DMA
+* burst of up to a FIFO depth of data into the TX FIFO, and every RX trigger
+* interrupt starts one DMA burst of exactly the trigger level worth of data
+* out of the RX FIFO. The CPU only starts one DMA program per FIFO's worth of
+* data instead of accessing the FIFO register for every character, and the
+* application gets a single completion callback per buffer.
+*
+* The application connects XUartPs_DmaInterruptHandler() to the UART
+* interrupt instead of XUartPs_InterruptHandler(), and the XDmaPs done and
+* fault interrupts as usual. Receive buffers should be cache line aligned
+* since the DMA driver invalidates the destination range. Buffers taken from
+* the DMA arena of xil_dmaarena.h need no cache maintenance at all, which
+* the DMA driver and this mode skip for them.
+*
+* <b>Idle Line Frames</b>
+*
+* XUartPs_DmaRecvFrames() receives variable length messages by DMA with no
+* per byte interrupt. The trigger bursts fill one of two ping-pong buffers,
+* and the receive timeout, the line idle for the RX timeout, ends the frame:
+* once a burst in flight has landed, the bytes below the trigger level are
+* read by the CPU and the buffer is passed to the frame handler as a whole
+* frame, while reception goes on into the other buffer. A frame that fills
+* its buffer before the line goes idle is passed on full and continues in
+* the next buffer. The handler owns a frame until XUartPs_DmaFrameDone();
+* if neither buffer is free, reception pauses, the bytes wait in the RX
+* FIFO, and it resumes on XUartPs_DmaFrameDone().
+*
+* Since the DMA moves exactly the bytes known to be in the FIFO, no DMA
+* transfer is ever cut short at the end of a frame, and the frame length is
+* the count of the bursts and of the tail.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 3.14  qm     10/14/26 First release
+*       qm     10/14/26 Buffers in the DMA arena are not flushed.
+*       qm     10/14/26 Added the idle line terminated frame receive.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef XUARTPS_DMA_H		/* prevent circular inclusions */
+#define XUARTPS_DMA_H		/* by using protection macros */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xuartps.h"
+#include "xdmaps.h"
+
+/************************** Constant Definitions ****************************/
+
+#define XUARTPS_DMA_RX_TRIGGER	32U	/**< RX FIFO level per DMA burst */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Called from the interrupt with a frame of XUartPs_DmaRecvFrames(), which
+ * the application owns until it calls XUartPs_DmaFrameDone().
+ */
+typedef void (*XUartPs_DmaFrameHandler)(void *CallBackRef, u8 *FramePtr,
+					u32 NumBytes);
+
+/**
+ * The DMA assisted transfer state of one UART. It refers to an initialized
+ * XUartPs and XDmaPs instance and owns one DMA channel per direction.
+ */
+typedef struct {
+	XUartPs *UartPtr;	/**< UART instance */
+	XDmaPs *DmaPtr;		/**< DMA controller instance */
+	u32 TxChannel;		/**< DMA channel used for sending */
+	u32 RxChannel;		/**< DMA channel used for receiving */
+	XDmaPs_Cmd TxCmd;	/**< Command of the TX burst in flight */
+	XDmaPs_Cmd RxCmd;	/**< Command of the RX burst in flight */
+	XUartPsBuffer SendBuffer;	/**< Buffer being sent */
+	XUartPsBuffer ReceiveBuffer;	/**< Buffer being received */
+	volatile u32 TxBurst;	/**< Bytes in the TX burst in flight */
+	volatile u32 RxBurst;	/**< Bytes in the RX burst in flight */
+	XUartPs_Handler Handler;	/**< Completion handler */
+	void *CallBackRef;	/**< Callback reference for the handler */
+	u32 FrameMode;		/**< XUartPs_DmaRecvFrames() is running */
+	u8 *FrameBuf[2];	/**< Ping-pong frame buffers */
+	u32 FrameSize;		/**< Bytes of each */
+	u32 FrameIndex;		/**< Buffer being received into */
+	volatile u32 FrameOwned[2];	/**< Held by the application */
+	volatile u32 FrameStalled;	/**< No free buffer, RX paused */
+	u32 TimeoutPending;	/**< Idle seen while a burst was in flight */
+	XUartPs_DmaFrameHandler FrameHandler;
+	void *FrameRef;		/**< Callback reference for FrameHandler */
+	u32 Frames;		/**< Frames passed to the handler */
+	u32 FrameStalls;	/**< Times reception paused */
+} XUartPs_Dma;
+
+/************************** Function Prototypes *****************************/
+
+s32 XUartPs_DmaInitialize(XUartPs_Dma *InstancePtr, XUartPs *UartPtr,
+			  XDmaPs *DmaPtr, u32 TxChannel, u32 RxChannel);
+
+void XUartPs_DmaSetHandler(XUartPs_Dma *InstancePtr, XUartPs_Handler FuncPtr,
+			   void *CallBackRef);
+
+s32 XUartPs_DmaSend(XUartPs_Dma *InstancePtr, u8 *BufferPtr, u32 NumBytes);
+
+s32 XUartPs_DmaRecv(XUartPs_Dma *InstancePtr, u8 *BufferPtr, u32 NumBytes);
+
+s32 XUartPs_DmaRecvFrames(XUartPs_Dma *InstancePtr, u8 *Buf0Ptr,
+			  u8 *Buf1Ptr, u32 Size,
+			  XUartPs_DmaFrameHandler FuncPtr, void *CallBackRef);
+
+void XUartPs_DmaFrameDone(XUartPs_Dma *InstancePtr, u8 *FramePtr);
+
+s32 XUartPs_DmaStopFrames(XUartPs_Dma *InstancePtr);
+
+void XUartPs_DmaInterruptHandler(XUartPs_Dma *InstancePtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of protection macro */
+/** @} */
@@ -0,0 +1,163 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file xuartps_fast.h
+* @addtogroup uartps Overview
+* @{
+* @details
+*
+* This header contains the fast path of the XUartPs driver: static inline
+* polled send and receive functions that work on a base address only. When
+* they are called with a constant base address from xparameters.h, such as
+* XPAR_UART0_BASEADDR, every register access resolves to a single load or
+* store and a byte costs a handful of instructions.
+*
+* Unlike XUartPs_Send() and XUartPs_Recv() these functions have no asserts,
+* do not touch the interrupt mask and do not enable the reference clock.
+* The device must have been set up with XUartPs_CfgInitialize(), and with
+* XCLOCKING the clock must be enabled by the caller beforehand. They must not
+* be mixed with an interrupt driven transfer in the same direction.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 3.14  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef XUARTPS_FAST_H		/* prevent circular inclusions */
+#define XUARTPS_FAST_H		/* by using protection macros */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xil_io.h"
+#include "xuartps_hw.h"
+
+/************************** Function Prototypes *****************************/
+
+/****************************************************************************/
+/**
+*
+* Puts as many bytes as fit into the TX FIFO without waiting.
+*
+* @param	BaseAddress is the base address of the device.
+* @param	BufferPtr is the data to be sent.
+* @param	NumBytes is the number of bytes to be sent.
+*
+* @return	The number of bytes written to the TX FIFO.
+*
+* @note		None.
+*
+*****************************************************************************/
+static INLINE u32 XUartPs_FastSend(UINTPTR BaseAddress, const u8 *BufferPtr,
+				   u32 NumBytes)
+{
+	u32 Count = 0U;
+
+	while ((Count < NumBytes) &&
+	       ((Xil_In32(BaseAddress + XUARTPS_SR_OFFSET) &
+		 XUARTPS_SR_TXFULL) == (u32)0)) {
+		Xil_Out32(BaseAddress + XUARTPS_FIFO_OFFSET,
+			  (u32)BufferPtr[Count]);
+		Count++;
+	}
+
+	return Count;
+}
+
+/****************************************************************************/
+/**
+*
+* Takes as many bytes as are available out of the RX FIFO without waiting.
+*
+* @param	BaseAddress is the base address of the device.
+* @param	BufferPtr is where the received data is stored.
+* @param	NumBytes is the size of the buffer.
+*
+* @return	The number of bytes read from the RX FIFO.
+*
+* @note		None.
+*
+*****************************************************************************/
+static INLINE u32 XUartPs_FastRecv(UINTPTR BaseAddress, u8 *BufferPtr,
+				   u32 NumBytes)
+{
+	u32 Count = 0U;
+
+	while ((Count < NumBytes) &&
+	       ((Xil_In32(BaseAddress + XUARTPS_SR_OFFSET) &
+		 XUARTPS_SR_RXEMPTY) == (u32)0)) {
+		BufferPtr[Count] =
+			(u8)Xil_In32(BaseAddress + XUARTPS_FIFO_OFFSET);
+		Count++;
+	}
+
+	return Count;
+}
+
+/****************************************************************************/
+/**
+*
+* Sends one byte if the TX FIFO has room.
+*
+* @param	BaseAddress is the base address of the device.
+* @param	Data is the byte to be sent.
+*
+* @return	1 if the byte was written to the TX FIFO, 0 if it was full.
+*
+* @note		None.
+*
+*****************************************************************************/
+static INLINE u32 XUartPs_FastPutByte(UINTPTR BaseAddress, u8 Data)
+{
+	if ((Xil_In32(BaseAddress + XUARTPS_SR_OFFSET) &
+	     XUARTPS_SR_TXFULL) != (u32)0) {
+		return 0U;
+	}
+
+	Xil_Out32(BaseAddress + XUARTPS_FIFO_OFFSET, (u32)Data);
+	return 1U;
+}
+
+/****************************************************************************/
+/**
+*
+* Receives one byte if the RX FIFO holds one.
+*
+* @param	BaseAddress is the base address of the device.
+* @param	DataPtr is where the byte is stored.
+*
+* @return	1 if a byte was read, 0 if the RX FIFO was empty.
+*
+* @note		None.
+*
+*****************************************************************************/
+static INLINE u32 XUartPs_FastGetByte(UINTPTR BaseAddress, u8 *DataPtr)
+{
+	if ((Xil_In32(BaseAddress + XUARTPS_SR_OFFSET) &
+	     XUARTPS_SR_RXEMPTY) != (u32)0) {
+		return 0U;
+	}
+
+	*DataPtr = (u8)Xil_In32(BaseAddress + XUARTPS_FIFO_OFFSET);
+	return 1U;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of protection macro */
+/** @} */
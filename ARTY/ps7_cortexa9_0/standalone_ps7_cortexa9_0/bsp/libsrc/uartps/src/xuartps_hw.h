@@ -34,6 +34,9 @@
 *			modem control register.
 * 4.0   sd     02/02/24 Added macros for transmission FIFO empty check
 *                       and transmission active state check
+* 3.14  qm     10/14/26 Added XUARTPS_FIFO_DEPTH.
+*			Added the buffered standard output functions.
+*			Added XUartPs_StdoutWrite().
 *
 * </pre>
 *
@@ -229,6 +232,8 @@ extern "C" {
 #define XUARTPS_TXWM_RESET_VAL	0x00000020U  /**< Reset value */
 /* @} */
 
+#define XUARTPS_FIFO_DEPTH	64U	/**< TX and RX FIFO depth in bytes */
+
 /** @name Modem Control Register
  *
  * This register (MODEMCR) controls the interface with the modem or data set,
@@ -451,6 +456,15 @@ void XUartPs_ResetHw(u32 BaseAddress);
 
 void XUartPs_WaitTransmitDone(u32 BaseAddress);
 
+#if defined (SDT) && defined (XPAR_STDIN_IS_UARTPS)
+/* buffered standard output functions in xuartps_hw.c */
+void XUartPs_StdoutSetBuffer(u8 *BufferPtr, u32 Size);
+u32 XUartPs_StdoutWrite(const u8 *DataPtr, u32 NumBytes);
+u32 XUartPs_StdoutDrain(void);
+void XUartPs_StdoutFlush(void);
+u32 XUartPs_StdoutDropped(void);
+#endif
+
 /************************** Variable Definitions *****************************/
 
 #ifdef __cplusplus
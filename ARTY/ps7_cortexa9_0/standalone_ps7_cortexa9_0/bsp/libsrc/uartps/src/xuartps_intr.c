@@ -22,6 +22,23 @@
 * 3.00  kvn    02/13/15 Modified code for MISRA-C:2012 compliance.
 * 3.1	kvn    04/10/15 Modified code for latest RTL changes.
 * 3.7   aru    08/17/18 Resolved MISRA-C mandatory violations.(CR#1007755)
+* 3.14  qm     10/14/26 Dispatch RX/TX interrupts to the ring buffer mode.
+*			Adapt the RX coalescing profile in the receive data
+*			and receive timeout handlers.
+*			Handle the TX trigger interrupt of the TX trigger
+*			level mode.
+*			Refill from TX empty only, the TX trigger interrupt
+*			asserting at or above its level.
+*			Update the optional statistics.
+*			Track CTS for the ring buffer flow control.
+*			Place the interrupt handlers in the interrupt hot
+*			path of xil_hotpath.h.
+*			Hold the optional TX and RX locks around the send
+*			and receive buffers, the callbacks called without
+*			them.
+*			Stamp the first bytes of a receive buffer for the
+*			optional RX timestamps.
+*			Trace the interrupt handler with xil_trace.h.
 * </pre>
 *
 *****************************************************************************/
@@ -29,6 +46,9 @@
 /***************************** Include Files ********************************/
 
 #include "xuartps.h"
+#include "xtime_l.h"
+#include "xil_hotpath.h"
+#include "xil_trace.h"
 
 /************************** Constant Definitions ****************************/
 
@@ -49,6 +69,20 @@ static void ModemHandler(XUartPs *InstancePtr);
 extern u32 XUartPs_ReceiveBuffer(XUartPs *InstancePtr);
 extern u32 XUartPs_SendBuffer(XUartPs *InstancePtr);
 
+/* Internal function prototypes implemented in xuartps_ring.c */
+extern void XUartPs_RingReceive(XUartPs *InstancePtr);
+extern void XUartPs_RingSend(XUartPs *InstancePtr);
+
+/* Internal function prototypes implemented in xuartps_stats.c */
+extern void XUartPs_StatsIsr(XUartPs *InstancePtr, u32 IsrStatus,
+			     XTime StartTime);
+extern void XUartPs_StampRx(XUartPs *InstancePtr, u32 NumBytes,
+			    u32 LineIdle);
+
+/* Internal function prototypes implemented in xuartps_options.c */
+extern void XUartPs_CoalesceUpdate(XUartPs *InstancePtr, u32 NumBytes,
+				    u32 LineIdle);
+
 /************************** Variable Definitions ****************************/
 
 typedef void (*Handler)(XUartPs *InstancePtr);
@@ -157,13 +191,19 @@ void XUartPs_SetHandler(XUartPs *InstancePtr, XUartPs_Handler FuncPtr,
 * @note		None.
 *
 ******************************************************************************/
+XIL_HOTPATH_TEXT
 void XUartPs_InterruptHandler(XUartPs *InstancePtr)
 {
 	u32 IsrStatus;
+	XTime StartTime = 0U;
 
 	Xil_AssertVoid(InstancePtr != NULL);
 	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
 
+	if (InstancePtr->StatsPtr != NULL) {
+		XTime_GetTime(&StartTime);
+	}
+
 	/*
 	 * Read the interrupt ID register to determine which
 	 * interrupt is active
@@ -173,30 +213,49 @@ void XUartPs_InterruptHandler(XUartPs *InstancePtr)
 
 	IsrStatus &= XUartPs_ReadReg(InstancePtr->Config.BaseAddress,
 				   XUARTPS_ISR_OFFSET);
+	XIL_TRACE_EVENT(XIL_TRACE_ID_UART | XIL_TRACE_BEGIN,
+			InstancePtr->Config.BaseAddress, IsrStatus);
 
-	/* Dispatch an appropriate handler. */
-	if((IsrStatus & ((u32)XUARTPS_IXR_RXOVR | (u32)XUARTPS_IXR_RXEMPTY |
-			(u32)XUARTPS_IXR_RXFULL)) != (u32)0) {
-		/* Received data interrupt */
-		ReceiveDataHandler(InstancePtr);
-	}
-
-	if((IsrStatus & ((u32)XUARTPS_IXR_TXEMPTY | (u32)XUARTPS_IXR_TXFULL))
-									 != (u32)0) {
-		/* Transmit data interrupt */
-		SendDataHandler(InstancePtr, IsrStatus);
-	}
-
-	/* XUARTPS_IXR_RBRK is applicable only for Zynq Ultrascale+ MP */
-	if ((IsrStatus & ((u32)XUARTPS_IXR_OVER | (u32)XUARTPS_IXR_FRAMING |
-			(u32)XUARTPS_IXR_PARITY | (u32)XUARTPS_IXR_RBRK)) != (u32)0) {
-		/* Received Error Status interrupt */
-		ReceiveErrorHandler(InstancePtr, IsrStatus);
-	}
-
-	if((IsrStatus & ((u32)XUARTPS_IXR_TOUT)) != (u32)0) {
-		/* Received Timeout interrupt */
-		ReceiveTimeoutHandler(InstancePtr);
+	if (InstancePtr->RingMode != 0U) {
+		/*
+		 * Ring buffer mode, every RX source just drains the FIFO into
+		 * the RX ring and TX empty refills the FIFO from the TX ring.
+		 */
+		if ((IsrStatus & ((u32)XUARTPS_IXR_RXOVR | (u32)XUARTPS_IXR_RXFULL |
+				(u32)XUARTPS_IXR_TOUT | (u32)XUARTPS_IXR_OVER |
+				(u32)XUARTPS_IXR_FRAMING | (u32)XUARTPS_IXR_PARITY |
+				(u32)XUARTPS_IXR_RBRK)) != (u32)0) {
+			XUartPs_RingReceive(InstancePtr);
+		}
+
+		if ((IsrStatus & (u32)XUARTPS_IXR_TXEMPTY) != (u32)0) {
+			XUartPs_RingSend(InstancePtr);
+		}
+	} else {
+		/* Dispatch an appropriate handler. */
+		if((IsrStatus & ((u32)XUARTPS_IXR_RXOVR | (u32)XUARTPS_IXR_RXEMPTY |
+				(u32)XUARTPS_IXR_RXFULL)) != (u32)0) {
+			/* Received data interrupt */
+			ReceiveDataHandler(InstancePtr);
+		}
+
+		if((IsrStatus & ((u32)XUARTPS_IXR_TXEMPTY | (u32)XUARTPS_IXR_TXFULL))
+										 != (u32)0) {
+			/* Transmit data interrupt */
+			SendDataHandler(InstancePtr, IsrStatus);
+		}
+
+		/* XUARTPS_IXR_RBRK is applicable only for Zynq Ultrascale+ MP */
+		if ((IsrStatus & ((u32)XUARTPS_IXR_OVER | (u32)XUARTPS_IXR_FRAMING |
+				(u32)XUARTPS_IXR_PARITY | (u32)XUARTPS_IXR_RBRK)) != (u32)0) {
+			/* Received Error Status interrupt */
+			ReceiveErrorHandler(InstancePtr, IsrStatus);
+		}
+
+		if((IsrStatus & ((u32)XUARTPS_IXR_TOUT)) != (u32)0) {
+			/* Received Timeout interrupt */
+			ReceiveTimeoutHandler(InstancePtr);
+		}
 	}
 
 	if((IsrStatus & ((u32)XUARTPS_IXR_DMS)) != (u32)0) {
@@ -208,6 +267,12 @@ void XUartPs_InterruptHandler(XUartPs *InstancePtr)
 	XUartPs_WriteReg(InstancePtr->Config.BaseAddress, XUARTPS_ISR_OFFSET,
 		IsrStatus);
 
+	if (InstancePtr->StatsPtr != NULL) {
+		XUartPs_StatsIsr(InstancePtr, IsrStatus, StartTime);
+	}
+	XIL_TRACE_EVENT(XIL_TRACE_ID_UART | XIL_TRACE_END,
+			InstancePtr->Config.BaseAddress, IsrStatus);
+
 }
 
 /****************************************************************************/
@@ -223,10 +288,12 @@ void XUartPs_InterruptHandler(XUartPs *InstancePtr)
 * @note		None.
 *
 *****************************************************************************/
+XIL_HOTPATH_TEXT
 static void ReceiveErrorHandler(XUartPs *InstancePtr, u32 IsrStatus)
 {
 	u32 EventData;
 	u32 Event;
+	u32 Cpsr;
 
 	InstancePtr->is_rxbs_error = 0;
 
@@ -241,12 +308,14 @@ static void ReceiveErrorHandler(XUartPs *InstancePtr, u32 IsrStatus)
 	 * clear the interrupt.
 	 */
 
+	Cpsr = XUartPs_LockRx(InstancePtr);
 	(void)XUartPs_ReceiveBuffer(InstancePtr);
+	EventData = InstancePtr->ReceiveBuffer.RequestedBytes -
+		InstancePtr->ReceiveBuffer.RemainingBytes;
+	XUartPs_UnlockRx(InstancePtr, Cpsr);
 
 	if (!(InstancePtr->is_rxbs_error)) {
 		Event = XUARTPS_EVENT_RECV_ERROR;
-		EventData = InstancePtr->ReceiveBuffer.RequestedBytes -
-			InstancePtr->ReceiveBuffer.RemainingBytes;
 
 		/*
 		 * Call the application handler to indicate that there is a receive
@@ -274,17 +343,36 @@ static void ReceiveErrorHandler(XUartPs *InstancePtr, u32 IsrStatus)
 * @note		None.
 *
 *****************************************************************************/
+XIL_HOTPATH_TEXT
 static void ReceiveTimeoutHandler(XUartPs *InstancePtr)
 {
 	u32 Event;
+	u32 NumBytes = 0U;
+	u32 Remaining;
+	u32 Received;
+	u32 Cpsr;
 
 	/*
 	 * If there are bytes still to be received in the specified buffer
 	 * go ahead and receive them. Removing bytes from the RX FIFO will
 	 * clear the interrupt.
 	 */
+	Cpsr = XUartPs_LockRx(InstancePtr);
 	if (InstancePtr->ReceiveBuffer.RemainingBytes != (u32)0) {
-		(void)XUartPs_ReceiveBuffer(InstancePtr);
+		NumBytes = XUartPs_ReceiveBuffer(InstancePtr);
+	}
+	Remaining = InstancePtr->ReceiveBuffer.RemainingBytes;
+	Received = InstancePtr->ReceiveBuffer.RequestedBytes - Remaining;
+	XUartPs_UnlockRx(InstancePtr, Cpsr);
+
+	if ((InstancePtr->RxStampEnabled != 0U) && (NumBytes != 0U) &&
+	    (InstancePtr->RxStamp == 0U)) {
+		XUartPs_StampRx(InstancePtr, NumBytes, TRUE);
+	}
+
+	/* The line went idle, the burst being received has ended */
+	if (InstancePtr->Coalesce.IsEnabled != 0U) {
+		XUartPs_CoalesceUpdate(InstancePtr, NumBytes, TRUE);
 	}
 
 	/*
@@ -294,7 +382,7 @@ static void ReceiveTimeoutHandler(XUartPs *InstancePtr)
 	 * don't rely on previous test of remaining bytes since receive
 	 * function updates it
 	 */
-	if (InstancePtr->ReceiveBuffer.RemainingBytes != (u32)0) {
+	if (Remaining != (u32)0) {
 		Event = XUARTPS_EVENT_RECV_TOUT;
 	} else {
 		Event = XUARTPS_EVENT_RECV_DATA;
@@ -304,9 +392,7 @@ static void ReceiveTimeoutHandler(XUartPs *InstancePtr)
 	 * Call the application handler to indicate that there is a receive
 	 * timeout or data event
 	 */
-	InstancePtr->Handler(InstancePtr->CallBackRef, Event,
-				 InstancePtr->ReceiveBuffer.RequestedBytes -
-				 InstancePtr->ReceiveBuffer.RemainingBytes);
+	InstancePtr->Handler(InstancePtr->CallBackRef, Event, Received);
 
 }
 /****************************************************************************/
@@ -321,15 +407,35 @@ static void ReceiveTimeoutHandler(XUartPs *InstancePtr)
 * @note		None.
 *
 *****************************************************************************/
+XIL_HOTPATH_TEXT
 static void ReceiveDataHandler(XUartPs *InstancePtr)
 {
+	u32 NumBytes = 0U;
+	u32 Remaining;
+	u32 Received;
+	u32 Cpsr;
+
 	/*
 	 * If there are bytes still to be received in the specified buffer
 	 * go ahead and receive them. Removing bytes from the RX FIFO will
 	 * clear the interrupt.
 	 */
+	Cpsr = XUartPs_LockRx(InstancePtr);
 	 if (InstancePtr->ReceiveBuffer.RemainingBytes != (u32)0) {
-		(void)XUartPs_ReceiveBuffer(InstancePtr);
+		NumBytes = XUartPs_ReceiveBuffer(InstancePtr);
+	}
+	Remaining = InstancePtr->ReceiveBuffer.RemainingBytes;
+	Received = InstancePtr->ReceiveBuffer.RequestedBytes - Remaining;
+	XUartPs_UnlockRx(InstancePtr, Cpsr);
+
+	/* The first bytes of the buffer, stamp it */
+	if ((InstancePtr->RxStampEnabled != 0U) && (NumBytes != 0U) &&
+	    (InstancePtr->RxStamp == 0U)) {
+		XUartPs_StampRx(InstancePtr, NumBytes, FALSE);
+	}
+
+	if (InstancePtr->Coalesce.IsEnabled != 0U) {
+		XUartPs_CoalesceUpdate(InstancePtr, NumBytes, FALSE);
 	}
 
 	 /* If the last byte of a message was received then call the application
@@ -337,11 +443,9 @@ static void ReceiveDataHandler(XUartPs *InstancePtr)
 	 * the number of bytes to receive because the call to receive the buffer
 	 * updates the bytes ramained
 	 */
-	if (InstancePtr->ReceiveBuffer.RemainingBytes == (u32)0) {
+	if (Remaining == (u32)0) {
 		InstancePtr->Handler(InstancePtr->CallBackRef,
-				XUARTPS_EVENT_RECV_DATA,
-				(InstancePtr->ReceiveBuffer.RequestedBytes -
-				InstancePtr->ReceiveBuffer.RemainingBytes));
+				XUARTPS_EVENT_RECV_DATA, Received);
 	}
 
 }
@@ -360,8 +464,14 @@ static void ReceiveDataHandler(XUartPs *InstancePtr)
 * @note		None.
 *
 *****************************************************************************/
+XIL_HOTPATH_TEXT
 static void SendDataHandler(XUartPs *InstancePtr, u32 IsrStatus)
 {
+	u32 Sent = 0U;
+	u32 IsDone = 0U;
+	u32 Cpsr;
+
+	Cpsr = XUartPs_LockTx(InstancePtr);
 
 	/*
 	 * If there are not bytes to be sent from the specified buffer then disable
@@ -371,13 +481,12 @@ static void SendDataHandler(XUartPs *InstancePtr, u32 IsrStatus)
 	if (InstancePtr->SendBuffer.RemainingBytes == (u32)0) {
 		XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
 				XUARTPS_IDR_OFFSET,
-				((u32)XUARTPS_IXR_TXEMPTY | (u32)XUARTPS_IXR_TXFULL));
+				((u32)XUARTPS_IXR_TXEMPTY | (u32)XUARTPS_IXR_TXFULL |
+				 (u32)XUARTPS_IXR_TTRIG));
 
-		/* Call the application handler to indicate the sending is done */
-		InstancePtr->Handler(InstancePtr->CallBackRef,
-					XUARTPS_EVENT_SENT_DATA,
-					InstancePtr->SendBuffer.RequestedBytes -
-					InstancePtr->SendBuffer.RemainingBytes);
+		IsDone = 1U;
+		Sent = InstancePtr->SendBuffer.RequestedBytes -
+			InstancePtr->SendBuffer.RemainingBytes;
 	}
 
 	/* If TX FIFO is empty, send more. */
@@ -388,6 +497,14 @@ static void SendDataHandler(XUartPs *InstancePtr, u32 IsrStatus)
 		/* Else with dummy entry for MISRA-C Compliance.*/
 		;
 	}
+
+	XUartPs_UnlockTx(InstancePtr, Cpsr);
+
+	/* Call the application handler to indicate the sending is done */
+	if (IsDone != 0U) {
+		InstancePtr->Handler(InstancePtr->CallBackRef,
+					XUARTPS_EVENT_SENT_DATA, Sent);
+	}
 }
 
 /****************************************************************************/
@@ -403,6 +520,7 @@ static void SendDataHandler(XUartPs *InstancePtr, u32 IsrStatus)
 * @note		None.
 *
 *****************************************************************************/
+XIL_HOTPATH_TEXT
 static void ModemHandler(XUartPs *InstancePtr)
 {
 	u32 MsrRegister;
@@ -414,6 +532,12 @@ static void ModemHandler(XUartPs *InstancePtr)
 	MsrRegister = XUartPs_ReadReg(InstancePtr->Config.BaseAddress,
 			  XUARTPS_MODEMSR_OFFSET);
 
+	/* Let the ring producer know whether the receiver accepts data */
+	if (InstancePtr->RingFlowControl != 0U) {
+		InstancePtr->TxBlocked =
+			((MsrRegister & XUARTPS_MODEMSR_CTS) == (u32)0) ? 1U : 0U;
+	}
+
 	/*
 	 * Call the application handler to indicate the modem status changed,
 	 * passing the modem status and the event data in the call
@@ -23,6 +23,14 @@
 *			value was not being written to the register.
 * 3.00  kvn    02/13/15 Modified code for MISRA-C:2012 compliance.
 * 3.2   rk     07/20/16 Modified the logic for transmission break bit set
+* 3.14  qm     10/14/26 Added adaptive RX interrupt coalescing.
+*			Cache the RX FIFO trigger level in the instance.
+*			Added XUartPs_SetTxTriggerLevel() and
+*			XUartPs_GetTxTriggerLevel().
+*			The TX trigger level mode keeps the TX trigger
+*			interrupt disabled.
+*			Fixed the inverted range assert in
+*			XUartPs_SetFlowDelay().
 *
 * </pre>
 *
@@ -38,6 +46,13 @@
 
 /***************** Macros (Inline Functions) Definitions ********************/
 
+/************************** Function Prototypes *****************************/
+
+static void XUartPs_ApplyCoalesceProfile(XUartPs *InstancePtr, u32 Profile);
+
+void XUartPs_CoalesceUpdate(XUartPs *InstancePtr, u32 NumBytes,
+			     u32 LineIdle);
+
 /************************** Variable Definitions ****************************/
 /*
  * The following data type is a map from an option to the offset in the
@@ -260,6 +275,79 @@ void XUartPs_SetFifoThreshold(XUartPs *InstancePtr, u8 TriggerLevel)
 	XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
 			   XUARTPS_RXWM_OFFSET, RtrigRegister);
 
+	/* Remembered for the burst drain of the RX FIFO */
+	InstancePtr->RxTriggerLevel = TriggerLevel;
+}
+
+/****************************************************************************/
+/**
+*
+* This function sets the TX FIFO trigger level and enables the TX trigger
+* level mode of the interrupt driven send. In that mode each refill writes
+* the number of bytes the TX status guarantees to fit without polling the
+* FIFO full status per byte: the FIFO depth on TX empty, and the room below
+* the trigger level when a send starts on a FIFO that is not empty.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	TriggerLevel is the TX FIFO fill level of the trigger, 1 to 63.
+*		0 disables the TX trigger level mode, the FIFO is then only
+*		refilled when it is empty.
+*
+* @return	None.
+*
+* @note		The TX trigger status and interrupt are set while the TX FIFO
+*		holds at least TriggerLevel bytes (UG585, Uart_TTRIG), so the
+*		interrupt asserts as the FIFO fills rather than as it drains.
+*		It is kept disabled, the refills come from TX empty. A lower
+*		level lets a send started on a busy FIFO write more bytes at
+*		once.
+*
+*****************************************************************************/
+void XUartPs_SetTxTriggerLevel(XUartPs *InstancePtr, u8 TriggerLevel)
+{
+	u32 TtrigRegister;
+
+	/* Assert validates the input arguments */
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(TriggerLevel <= (u8)XUARTPS_TXWM_MASK);
+	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	if (TriggerLevel != (u8)0) {
+		TtrigRegister = ((u32)TriggerLevel) & (u32)XUARTPS_TXWM_MASK;
+	} else {
+		TtrigRegister = (u32)XUARTPS_TXWM_RESET_VAL;
+	}
+
+	/* The refill is driven by the TX empty interrupt only */
+	XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
+			   XUARTPS_IDR_OFFSET, (u32)XUARTPS_IXR_TTRIG);
+
+	XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
+			   XUARTPS_TXWM_OFFSET, TtrigRegister);
+
+	InstancePtr->TxTriggerLevel = TriggerLevel;
+}
+
+/****************************************************************************/
+/**
+*
+* This function gets the TX FIFO trigger level of the TX trigger level mode.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	The TX FIFO trigger level, 0 if the TX trigger level mode is
+*		disabled.
+*
+* @note		None.
+*
+*****************************************************************************/
+u8 XUartPs_GetTxTriggerLevel(XUartPs *InstancePtr)
+{
+	/* Assert validates the input arguments */
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	return InstancePtr->TxTriggerLevel;
 }
 
 /****************************************************************************/
@@ -514,7 +602,7 @@ void XUartPs_SetFlowDelay(XUartPs *InstancePtr, u8 FlowDelayValue)
 
 	/* Assert validates the input arguments */
 	Xil_AssertVoid(InstancePtr != NULL);
-	Xil_AssertVoid(FlowDelayValue > (u8)XUARTPS_FLOWDEL_MASK);
+	Xil_AssertVoid(FlowDelayValue <= (u8)XUARTPS_FLOWDEL_MASK);
 	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
 
 	/*
@@ -739,4 +827,191 @@ void XUartPs_GetDataFormat(XUartPs *InstancePtr, XUartPsFormat * FormatPtr)
 		(u32)((ModeRegister & (u32)XUARTPS_MR_PARITY_MASK) >>
 		XUARTPS_MR_PARITY_SHIFT);
 }
+
+/****************************************************************************/
+/**
+*
+* This function sets the RX trigger level and RX timeout of one of the
+* profiles used by the adaptive interrupt coalescing mode. If the profile is
+* the one in use while adaptive coalescing is enabled, the new values are
+* written to the device right away.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	Profile is XUARTPS_COALESCE_LOW_LATENCY or
+*		XUARTPS_COALESCE_THROUGHPUT.
+* @param	FifoThreshold is the RX FIFO trigger level of the profile.
+* @param	RecvTimeout is the RX timeout of the profile, see
+*		XUartPs_SetRecvTimeout(). It must not be 0 since the idle line
+*		detection relies on the timeout.
+*
+* @return	None.
+*
+* @note		The defaults are a trigger level of 1 with a timeout of 1 for
+*		the low latency profile and a trigger level of 48 with a timeout
+*		of 8 for the throughput profile.
+*
+*****************************************************************************/
+void XUartPs_SetCoalesceProfile(XUartPs *InstancePtr, u32 Profile,
+				u8 FifoThreshold, u8 RecvTimeout)
+{
+	/* Assert validates the input arguments */
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+	Xil_AssertVoid(Profile < XUARTPS_COALESCE_NUM_PROFILES);
+	Xil_AssertVoid(FifoThreshold <= (u8)XUARTPS_RXWM_MASK);
+	Xil_AssertVoid(RecvTimeout != (u8)0);
+
+	InstancePtr->Coalesce.Profile[Profile].FifoThreshold = FifoThreshold;
+	InstancePtr->Coalesce.Profile[Profile].RecvTimeout = RecvTimeout;
+
+	if ((InstancePtr->Coalesce.IsEnabled != 0U) &&
+	    (InstancePtr->Coalesce.Active == Profile)) {
+		XUartPs_ApplyCoalesceProfile(InstancePtr, Profile);
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* This function enables the adaptive interrupt coalescing mode. The low
+* latency profile is programmed right away, the interrupt handler then
+* selects the throughput profile once SwitchBytes have been received without
+* the line going idle, and goes back to the low latency profile when the line
+* goes idle after less than SwitchBytes.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	SwitchBytes is the burst length that selects the throughput
+*		profile, XUARTPS_COALESCE_BURST_BYTES is a reasonable value.
+*
+* @return	None.
+*
+* @note		The adaptation is done by the receive data and receive timeout
+*		handlers of XUartPs_InterruptHandler(), so the RX trigger and
+*		RX timeout interrupts must both be enabled. It does not apply to
+*		ring buffer mode.
+*
+*****************************************************************************/
+void XUartPs_EnableAdaptiveCoalescing(XUartPs *InstancePtr, u32 SwitchBytes)
+{
+	/* Assert validates the input arguments */
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+	Xil_AssertVoid(SwitchBytes != 0U);
+
+	InstancePtr->Coalesce.SwitchBytes = SwitchBytes;
+	InstancePtr->Coalesce.BurstBytes = 0U;
+	XUartPs_ApplyCoalesceProfile(InstancePtr, XUARTPS_COALESCE_LOW_LATENCY);
+	InstancePtr->Coalesce.IsEnabled = 1U;
+}
+
+/****************************************************************************/
+/**
+*
+* This function disables the adaptive interrupt coalescing mode. The RX
+* trigger level and RX timeout of the profile in use are left in the device.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XUartPs_DisableAdaptiveCoalescing(XUartPs *InstancePtr)
+{
+	/* Assert validates the input arguments */
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	InstancePtr->Coalesce.IsEnabled = 0U;
+}
+
+/****************************************************************************/
+/**
+*
+* This function gets the interrupt coalescing profile in use.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	XUARTPS_COALESCE_LOW_LATENCY or XUARTPS_COALESCE_THROUGHPUT.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 XUartPs_GetCoalesceProfile(XUartPs *InstancePtr)
+{
+	/* Assert validates the input arguments */
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	return InstancePtr->Coalesce.Active;
+}
+
+/****************************************************************************/
+/*
+*
+* This function writes the RX trigger level and RX timeout of a profile to the
+* device and makes it the profile in use.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	Profile is the XUARTPS_COALESCE_* profile to use.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void XUartPs_ApplyCoalesceProfile(XUartPs *InstancePtr, u32 Profile)
+{
+	XUartPsCoalesceProfile *ProfilePtr;
+
+	ProfilePtr = &InstancePtr->Coalesce.Profile[Profile];
+
+	XUartPs_SetFifoThreshold(InstancePtr, ProfilePtr->FifoThreshold);
+	XUartPs_SetRecvTimeout(InstancePtr, ProfilePtr->RecvTimeout);
+
+	InstancePtr->Coalesce.Active = Profile;
+}
+
+/****************************************************************************/
+/*
+*
+* This function is called by the interrupt handler after received data has
+* been taken out of the RX FIFO, it selects the coalescing profile from the
+* length of the burst being received.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	NumBytes is the number of bytes just taken out of the FIFO.
+* @param	LineIdle is TRUE when called for a receive timeout, meaning
+*		the burst has ended.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XUartPs_CoalesceUpdate(XUartPs *InstancePtr, u32 NumBytes, u32 LineIdle)
+{
+	XUartPsCoalesce *CoalescePtr = &InstancePtr->Coalesce;
+
+	CoalescePtr->BurstBytes += NumBytes;
+
+	if (LineIdle != FALSE) {
+		/* A short burst, go back to answering every byte quickly */
+		if ((CoalescePtr->Active == XUARTPS_COALESCE_THROUGHPUT) &&
+		    (CoalescePtr->BurstBytes < CoalescePtr->SwitchBytes)) {
+			XUartPs_ApplyCoalesceProfile(InstancePtr,
+					XUARTPS_COALESCE_LOW_LATENCY);
+		}
+		CoalescePtr->BurstBytes = 0U;
+	} else if ((CoalescePtr->Active == XUARTPS_COALESCE_LOW_LATENCY) &&
+		   (CoalescePtr->BurstBytes >= CoalescePtr->SwitchBytes)) {
+		/* Sustained traffic, take one interrupt per FIFO trigger */
+		XUartPs_ApplyCoalesceProfile(InstancePtr,
+				XUARTPS_COALESCE_THROUGHPUT);
+	} else {
+		/* Else with dummy entry for MISRA-C Compliance.*/
+		;
+	}
+}
 /** @} */
@@ -0,0 +1,953 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file xuartps_ring.c
+* @addtogroup uartps Overview
+* @{
+*
+* This file contains the ring buffer mode of the XUartPs driver. In this mode
+* the interrupt handler moves data between the FIFOs and two single producer,
+* single consumer rings, so the application never has to service the FIFOs
+* in time. Refer to the header file xuartps.h for more detailed information.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- -----------------------------------------------
+* 3.14  qm     10/14/26 First release
+*			Count the bytes moved and the ring high-water marks
+*			in the optional statistics.
+*			Added RTS/CTS flow control driven by the ring
+*			occupancy.
+*			Added zero-copy access to the RX ring.
+*			Place the ring handlers in the interrupt hot path of
+*			xil_hotpath.h.
+*			Added the FIQ fast path of ring buffer mode.
+*			Added XON/XOFF flow control driven by the ring
+*			occupancy, in the ring handlers.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xuartps.h"
+#include "xil_io.h"
+#include "xpseudo_asm.h"
+#include "xil_hotpath.h"
+#include "xil_exception.h"
+
+/************************** Constant Definitions ****************************/
+
+/*
+ * Interrupts serviced in ring buffer mode. TX empty is only enabled while the
+ * TX ring holds data.
+ */
+#define XUARTPS_RING_RX_IXR	((u32)XUARTPS_IXR_RXOVR | (u32)XUARTPS_IXR_RXFULL | \
+				 (u32)XUARTPS_IXR_TOUT | (u32)XUARTPS_IXR_OVER | \
+				 (u32)XUARTPS_IXR_FRAMING | (u32)XUARTPS_IXR_PARITY)
+
+/* RX data interrupts masked while the sender is throttled */
+#define XUARTPS_RING_RX_DATA_IXR	((u32)XUARTPS_IXR_RXOVR | \
+					 (u32)XUARTPS_IXR_RXFULL | \
+					 (u32)XUARTPS_IXR_TOUT)
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/* Number of bytes held in a ring */
+#define XUartPs_RingUsed(RingPtr)	((RingPtr)->Head - (RingPtr)->Tail)
+
+/* Total capacity of a ring */
+#define XUartPs_RingSize(RingPtr)	((RingPtr)->Mask + 1U)
+
+/************************** Function Prototypes *****************************/
+
+void XUartPs_RingReceive(XUartPs *InstancePtr);
+void XUartPs_RingSend(XUartPs *InstancePtr);
+static void XUartPs_RingRxRelease(XUartPs *InstancePtr, u32 Tail);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* This function switches the driver into ring buffer mode. The RX interrupts
+* are enabled so that the interrupt handler drains the RX FIFO into the RX
+* ring, and XUartPs_RingWrite() arms the TX empty interrupt whenever it
+* queues data in the TX ring.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	RxBufPtr is the storage for the RX ring.
+* @param	RxSize is the size of the RX ring in bytes, a power of two.
+* @param	TxBufPtr is the storage for the TX ring.
+* @param	TxSize is the size of the TX ring in bytes, a power of two.
+*
+* @return
+*		- XST_SUCCESS if ring buffer mode was enabled.
+*		- XST_INVALID_PARAM if a ring size is not a power of two.
+*
+* @note		XUartPs_InterruptHandler() must be connected to the interrupt
+*		controller by the application. The rings must stay valid until
+*		XUartPs_DisableRingMode() is called.
+*
+*****************************************************************************/
+s32 XUartPs_EnableRingMode(XUartPs *InstancePtr, u8 *RxBufPtr, u32 RxSize,
+			   u8 *TxBufPtr, u32 TxSize)
+{
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(RxBufPtr != NULL);
+	Xil_AssertNonvoid(TxBufPtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	if ((RxSize == 0U) || ((RxSize & (RxSize - 1U)) != 0U) ||
+	    (TxSize == 0U) || ((TxSize & (TxSize - 1U)) != 0U)) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	/* Stop any interrupt driven transfer before taking over the FIFOs */
+	XUartPs_WriteReg(InstancePtr->Config.BaseAddress, XUARTPS_IDR_OFFSET,
+			 XUARTPS_IXR_MASK);
+
+	InstancePtr->SendBuffer.RemainingBytes = 0U;
+	InstancePtr->ReceiveBuffer.RemainingBytes = 0U;
+
+	InstancePtr->RxRing.BufferPtr = RxBufPtr;
+	InstancePtr->RxRing.Mask = RxSize - 1U;
+	InstancePtr->RxRing.Head = 0U;
+	InstancePtr->RxRing.Tail = 0U;
+
+	InstancePtr->TxRing.BufferPtr = TxBufPtr;
+	InstancePtr->TxRing.Mask = TxSize - 1U;
+	InstancePtr->TxRing.Head = 0U;
+	InstancePtr->TxRing.Tail = 0U;
+
+	InstancePtr->RxRingDropped = 0U;
+	InstancePtr->RingFlowControl = 0U;
+	InstancePtr->RxThrottled = 0U;
+	InstancePtr->TxBlocked = 0U;
+	InstancePtr->RingSoftFlowControl = 0U;
+	InstancePtr->RxXoff = 0U;
+	InstancePtr->TxCtrlChar = 0U;
+	InstancePtr->RingMode = 1U;
+
+	XUartPs_WriteReg(InstancePtr->Config.BaseAddress, XUARTPS_ISR_OFFSET,
+			 XUARTPS_IXR_MASK);
+	XUartPs_WriteReg(InstancePtr->Config.BaseAddress, XUARTPS_IER_OFFSET,
+			 XUARTPS_RING_RX_IXR);
+
+	return (s32)XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* This function leaves ring buffer mode and disables all interrupts. Data
+* still queued in the rings is discarded.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XUartPs_DisableRingMode(XUartPs *InstancePtr)
+{
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	if (InstancePtr->RingFlowControl != 0U) {
+		XUartPs_DisableRingFlowControl(InstancePtr);
+	}
+
+	XUartPs_WriteReg(InstancePtr->Config.BaseAddress, XUARTPS_IDR_OFFSET,
+			 XUARTPS_IXR_MASK);
+
+	InstancePtr->RingSoftFlowControl = 0U;
+	InstancePtr->RxXoff = 0U;
+	InstancePtr->TxCtrlChar = 0U;
+	InstancePtr->TxBlocked = 0U;
+	InstancePtr->RingMode = 0U;
+}
+
+/****************************************************************************/
+/**
+*
+* This function copies up to NumBytes received bytes out of the RX ring. It
+* never accesses the RX FIFO and never blocks. With ring flow control, RTS/CTS
+* or XON/XOFF, it releases a throttled sender once the ring is down to its
+* low-water mark.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	BufferPtr is the buffer the data is copied to.
+* @param	NumBytes is the size of the buffer.
+*
+* @return	The number of bytes copied.
+*
+* @note		Only one task may read from the RX ring.
+*
+*****************************************************************************/
+u32 XUartPs_RingRead(XUartPs *InstancePtr, u8 *BufferPtr, u32 NumBytes)
+{
+	XUartPsRing *RingPtr;
+	u32 Tail;
+	u32 Count;
+	u32 Index;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(BufferPtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->RingMode != 0U);
+
+	RingPtr = &InstancePtr->RxRing;
+	Tail = RingPtr->Tail;
+	Count = RingPtr->Head - Tail;
+	if (Count > NumBytes) {
+		Count = NumBytes;
+	}
+
+	/* Make sure the data is read after the ISR published Head */
+	dmb();
+
+	for (Index = 0U; Index < Count; Index++) {
+		BufferPtr[Index] = RingPtr->BufferPtr[(Tail + Index) &
+						      RingPtr->Mask];
+	}
+
+	XUartPs_RingRxRelease(InstancePtr, Tail + Count);
+
+	return Count;
+}
+
+/****************************************************************************/
+/**
+*
+* This function gives direct access to the data waiting in the RX ring, as
+* up to two contiguous segments since the data may wrap around the end of the
+* ring storage. The data stays in the ring until XUartPs_RingConsume() is
+* called, and the caller may modify it in place until then, for instance to
+* decode it.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	SpanPtr is where the segments are stored. DataPtr[1] is only
+*		valid when Length[1] is not 0.
+*
+* @return	The number of bytes waiting, Length[0] + Length[1].
+*
+* @note		Only one task may read from the RX ring. More data may arrive
+*		after the call, calling it again returns the same bytes
+*		followed by the new ones, at the same addresses.
+*
+*****************************************************************************/
+u32 XUartPs_RingPeek(XUartPs *InstancePtr, XUartPsRingSpan *SpanPtr)
+{
+	XUartPsRing *RingPtr;
+	u32 Tail;
+	u32 Count;
+	u32 Index;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(SpanPtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->RingMode != 0U);
+
+	RingPtr = &InstancePtr->RxRing;
+	Tail = RingPtr->Tail;
+	Count = RingPtr->Head - Tail;
+
+	/* Make sure the data is read after the ISR published Head */
+	dmb();
+
+	Index = Tail & RingPtr->Mask;
+	SpanPtr->DataPtr[0] = &RingPtr->BufferPtr[Index];
+	SpanPtr->DataPtr[1] = RingPtr->BufferPtr;
+	if (Count > (XUartPs_RingSize(RingPtr) - Index)) {
+		SpanPtr->Length[0] = XUartPs_RingSize(RingPtr) - Index;
+		SpanPtr->Length[1] = Count - SpanPtr->Length[0];
+	} else {
+		SpanPtr->Length[0] = Count;
+		SpanPtr->Length[1] = 0U;
+	}
+
+	return Count;
+}
+
+/****************************************************************************/
+/**
+*
+* This function releases bytes returned by XUartPs_RingPeek() so that the
+* interrupt handler can store new data in their place.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	NumBytes is the number of bytes to release, at most the number
+*		returned by the last XUartPs_RingPeek().
+*
+* @return	None.
+*
+* @note		Only one task may read from the RX ring.
+*
+*****************************************************************************/
+void XUartPs_RingConsume(XUartPs *InstancePtr, u32 NumBytes)
+{
+	XUartPsRing *RingPtr;
+
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(InstancePtr->RingMode != 0U);
+
+	RingPtr = &InstancePtr->RxRing;
+	Xil_AssertVoid(NumBytes <= XUartPs_RingUsed(RingPtr));
+
+	XUartPs_RingRxRelease(InstancePtr, RingPtr->Tail + NumBytes);
+}
+
+/****************************************************************************/
+/**
+*
+* This function queues up to NumBytes bytes in the TX ring and arms the TX
+* empty interrupt so that the interrupt handler starts moving them into the
+* TX FIFO. It never blocks.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	BufferPtr is the data to be sent.
+* @param	NumBytes is the number of bytes to be sent.
+*
+* @return	The number of bytes queued, which is less than NumBytes when
+*		the TX ring does not have enough room.
+*
+* @note		Only one task may write to the TX ring.
+*
+*****************************************************************************/
+u32 XUartPs_RingWrite(XUartPs *InstancePtr, const u8 *BufferPtr,
+		      u32 NumBytes)
+{
+	XUartPsRing *RingPtr;
+	u32 Head;
+	u32 Count;
+	u32 Index;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(BufferPtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->RingMode != 0U);
+
+	RingPtr = &InstancePtr->TxRing;
+	Head = RingPtr->Head;
+	Count = XUartPs_RingSize(RingPtr) - (Head - RingPtr->Tail);
+	if (Count > NumBytes) {
+		Count = NumBytes;
+	}
+
+	if (Count != 0U) {
+		for (Index = 0U; Index < Count; Index++) {
+			RingPtr->BufferPtr[(Head + Index) & RingPtr->Mask] =
+				BufferPtr[Index];
+		}
+
+		/* Publish the data before the ISR can see the new Head */
+		dmb();
+		RingPtr->Head = Head + Count;
+
+		if ((InstancePtr->StatsPtr != NULL) &&
+		    ((Head + Count - RingPtr->Tail) >
+		     InstancePtr->StatsPtr->TxRingHighWater)) {
+			InstancePtr->StatsPtr->TxRingHighWater =
+				Head + Count - RingPtr->Tail;
+		}
+
+		XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
+				 XUARTPS_IER_OFFSET, XUARTPS_IXR_TXEMPTY);
+	}
+
+	return Count;
+}
+
+/****************************************************************************/
+/**
+*
+* This function returns the number of bytes waiting in the RX ring.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	The number of bytes that XUartPs_RingRead() can return.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 XUartPs_RingRxCount(XUartPs *InstancePtr)
+{
+	Xil_AssertNonvoid(InstancePtr != NULL);
+
+	return XUartPs_RingUsed(&InstancePtr->RxRing);
+}
+
+/****************************************************************************/
+/**
+*
+* This function returns the free space in the TX ring.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	The number of bytes that XUartPs_RingWrite() can accept.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 XUartPs_RingTxFree(XUartPs *InstancePtr)
+{
+	Xil_AssertNonvoid(InstancePtr != NULL);
+
+	return XUartPs_RingSize(&InstancePtr->TxRing) -
+		XUartPs_RingUsed(&InstancePtr->TxRing);
+}
+
+/****************************************************************************/
+/*
+*
+* This function moves the consumer counter of the RX ring to Tail, after the
+* data up to it has been taken out, and resumes draining the RX FIFO once the
+* ring has room again. The RX timeout is restarted so that an RX FIFO left
+* full while the sender was throttled raises an interrupt even though no
+* further byte comes. After an XOFF the TX empty interrupt is armed for the
+* interrupt handler to send the XON.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	Tail is the new consumer counter.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void XUartPs_RingRxRelease(XUartPs *InstancePtr, u32 Tail)
+{
+	XUartPsRing *RingPtr = &InstancePtr->RxRing;
+
+	/* Release the slots only once the data has been taken out */
+	dmb();
+	RingPtr->Tail = Tail;
+
+	if ((InstancePtr->RxThrottled != 0U) &&
+	    (XUartPs_RingUsed(RingPtr) <= InstancePtr->RxLowWater)) {
+		InstancePtr->RxThrottled = 0U;
+		XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
+				 XUARTPS_IER_OFFSET, XUARTPS_RING_RX_DATA_IXR);
+		XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
+				 XUARTPS_CR_OFFSET,
+				 XUartPs_ReadReg(InstancePtr->Config.BaseAddress,
+						 XUARTPS_CR_OFFSET) |
+				 XUARTPS_CR_TORST);
+	}
+
+	if ((InstancePtr->RxXoff != 0U) &&
+	    (XUartPs_RingUsed(RingPtr) <= InstancePtr->RxLowWater)) {
+		XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
+				 XUARTPS_IER_OFFSET, XUARTPS_IXR_TXEMPTY);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* This function drains the RX FIFO into the RX ring. It is called from the
+* interrupt handler for RX trigger, RX full, timeout and error interrupts.
+* Bytes that do not fit into the ring are still read from the FIFO so the
+* interrupt is cleared, and they are counted in RxRingDropped. With XON/XOFF
+* flow control it takes the XON and XOFF bytes out of the data, to resume or
+* stop the TX ring, and sends an XOFF at the high-water mark.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+XIL_HOTPATH_TEXT
+void XUartPs_RingReceive(XUartPs *InstancePtr)
+{
+	XUartPsRing *RingPtr = &InstancePtr->RxRing;
+	u32 BaseAddress = InstancePtr->Config.BaseAddress;
+	u32 Head = RingPtr->Head;
+	u32 Start = Head;
+	u32 Size = XUartPs_RingSize(RingPtr);
+	u32 Dropped = 0U;
+	u32 SoftFlow = InstancePtr->RingSoftFlowControl;
+	u32 TxCtrl = 0U;
+	u8 Data;
+
+	while ((XUartPs_ReadReg(BaseAddress, XUARTPS_SR_OFFSET) &
+		XUARTPS_SR_RXEMPTY) == (u32)0) {
+		if (((Head - RingPtr->Tail) >= Size) &&
+		    (InstancePtr->RingFlowControl != 0U)) {
+			/* Leave the data in the FIFO, RTS holds the sender */
+			break;
+		}
+		Data = (u8)XUartPs_ReadReg(BaseAddress, XUARTPS_FIFO_OFFSET);
+		if ((SoftFlow != 0U) &&
+		    ((Data == (u8)XUARTPS_XON) || (Data == (u8)XUARTPS_XOFF))) {
+			/* The last one received tells whether to send */
+			TxCtrl = Data;
+		} else if ((Head - RingPtr->Tail) < Size) {
+			RingPtr->BufferPtr[Head & RingPtr->Mask] = Data;
+			Head++;
+		} else {
+			Dropped++;
+		}
+	}
+
+	/* Publish the data before the task can see the new Head */
+	dmb();
+	RingPtr->Head = Head;
+
+	/*
+	 * Stop draining the RX FIFO at the high-water mark, the FIFO then
+	 * fills up to the flow delay level and the hardware deasserts RTS
+	 */
+	if ((InstancePtr->RingFlowControl != 0U) &&
+	    ((Head - RingPtr->Tail) >= InstancePtr->RxHighWater)) {
+		InstancePtr->RxThrottled = 1U;
+		XUartPs_WriteReg(BaseAddress, XUARTPS_IDR_OFFSET,
+				 XUARTPS_RING_RX_DATA_IXR);
+	}
+
+	if (SoftFlow != 0U) {
+		if (TxCtrl == XUARTPS_XOFF) {
+			InstancePtr->TxBlocked = 1U;
+		} else if (TxCtrl == XUARTPS_XON) {
+			InstancePtr->TxBlocked = 0U;
+			XUartPs_WriteReg(BaseAddress, XUARTPS_IER_OFFSET,
+					 XUARTPS_IXR_TXEMPTY);
+		} else {
+			/* Else with dummy entry for MISRA-C Compliance.*/
+			;
+		}
+
+		/* Stop the sender at once, ahead of the TX ring */
+		if ((InstancePtr->RxXoff == 0U) &&
+		    ((Head - RingPtr->Tail) >= InstancePtr->RxHighWater)) {
+			InstancePtr->RxXoff = 1U;
+			if ((InstancePtr->TxCtrlChar == 0U) &&
+			    (!XUartPs_IsTransmitFull(BaseAddress))) {
+				XUartPs_WriteReg(BaseAddress,
+						 XUARTPS_FIFO_OFFSET,
+						 XUARTPS_XOFF);
+			} else {
+				/* In place of an XON not sent yet */
+				InstancePtr->TxCtrlChar = XUARTPS_XOFF;
+				XUartPs_WriteReg(BaseAddress,
+						 XUARTPS_IER_OFFSET,
+						 XUARTPS_IXR_TXEMPTY);
+			}
+		}
+	}
+
+	if (Dropped != 0U) {
+		InstancePtr->RxRingDropped += Dropped;
+	}
+
+	if (InstancePtr->StatsPtr != NULL) {
+		InstancePtr->StatsPtr->BytesIn += Head - Start + Dropped;
+		if ((Head - RingPtr->Tail) >
+		    InstancePtr->StatsPtr->RxRingHighWater) {
+			InstancePtr->StatsPtr->RxRingHighWater =
+				Head - RingPtr->Tail;
+		}
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* This function refills the TX FIFO from the TX ring. It is called from the
+* interrupt handler for the TX empty interrupt, which is disabled again once
+* the ring has been drained. With XON/XOFF flow control it sends the XON once
+* the RX ring is down to its low-water mark and any XON or XOFF left over
+* first, and sends nothing from the ring after an XOFF was received.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+XIL_HOTPATH_TEXT
+void XUartPs_RingSend(XUartPs *InstancePtr)
+{
+	XUartPsRing *RingPtr = &InstancePtr->TxRing;
+	u32 BaseAddress = InstancePtr->Config.BaseAddress;
+	u32 Tail = RingPtr->Tail;
+	u32 Head = RingPtr->Head;
+	u32 Blocked = 0U;
+
+	/* Make sure the data is read after the task published Head */
+	dmb();
+
+	if (InstancePtr->RingSoftFlowControl != 0U) {
+		if ((InstancePtr->RxXoff != 0U) &&
+		    (XUartPs_RingUsed(&InstancePtr->RxRing) <=
+		     InstancePtr->RxLowWater)) {
+			InstancePtr->RxXoff = 0U;
+			InstancePtr->TxCtrlChar = XUARTPS_XON;
+		}
+		Blocked = InstancePtr->TxBlocked;
+	}
+
+	if ((InstancePtr->TxCtrlChar != 0U) &&
+	    (!XUartPs_IsTransmitFull(BaseAddress))) {
+		XUartPs_WriteReg(BaseAddress, XUARTPS_FIFO_OFFSET,
+				 InstancePtr->TxCtrlChar);
+		InstancePtr->TxCtrlChar = 0U;
+	}
+
+	while ((Blocked == 0U) && (Tail != Head) &&
+	       (!XUartPs_IsTransmitFull(BaseAddress))) {
+		XUartPs_WriteReg(BaseAddress, XUARTPS_FIFO_OFFSET,
+				 (u32)RingPtr->BufferPtr[Tail & RingPtr->Mask]);
+		Tail++;
+	}
+
+	dmb();
+	if (InstancePtr->StatsPtr != NULL) {
+		InstancePtr->StatsPtr->BytesOut += Tail - RingPtr->Tail;
+	}
+	RingPtr->Tail = Tail;
+
+	if (((Tail == Head) || (Blocked != 0U)) &&
+	    (InstancePtr->TxCtrlChar == 0U)) {
+		XUartPs_WriteReg(BaseAddress, XUARTPS_IDR_OFFSET,
+				 XUARTPS_IXR_TXEMPTY);
+
+		/*
+		 * XUartPs_RingWrite() may have queued data after Head was
+		 * sampled, or XUartPs_RingRead() made room for an XON,
+		 * re-arm the interrupt so that neither is stranded.
+		 */
+		dsb();
+		if (((Blocked == 0U) && (RingPtr->Head != Tail)) ||
+		    ((InstancePtr->RxXoff != 0U) &&
+		     (XUartPs_RingUsed(&InstancePtr->RxRing) <=
+		      InstancePtr->RxLowWater))) {
+			XUartPs_WriteReg(BaseAddress, XUARTPS_IER_OFFSET,
+					 XUARTPS_IXR_TXEMPTY);
+		}
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* This function enables RTS/CTS flow control in ring buffer mode. The
+* hardware flow control mode is turned on with the RTS flow delay at
+* XUARTPS_RING_FLOWDEL, and the interrupt handler stops draining the RX FIFO
+* while the RX ring is at or above HighWater, which makes the hardware
+* deassert RTS. XUartPs_RingRead() resumes draining once the ring holds
+* LowWater bytes or less. The modem status interrupt is enabled to track CTS
+* for XUartPs_RingTxBlocked().
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	HighWater is the RX ring level that throttles the sender, at
+*		most the RX ring size.
+* @param	LowWater is the RX ring level that releases the sender, less
+*		than HighWater.
+*
+* @return
+*		- XST_SUCCESS if flow control was enabled.
+*		- XST_NOT_ENABLED if ring buffer mode is not enabled.
+*		- XST_INVALID_PARAM if the water marks are not valid.
+*		- XST_DEVICE_BUSY if XON/XOFF flow control is enabled.
+*
+* @note		The RTS and CTS signals must be routed to the UART and the
+*		RX timeout must not be disabled, it is used to resume
+*		draining a full RX FIFO.
+*
+*****************************************************************************/
+s32 XUartPs_EnableRingFlowControl(XUartPs *InstancePtr, u32 HighWater,
+				  u32 LowWater)
+{
+	u32 ModemCr;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	if (InstancePtr->RingMode == 0U) {
+		return (s32)XST_NOT_ENABLED;
+	}
+
+	if (InstancePtr->RingSoftFlowControl != 0U) {
+		return (s32)XST_DEVICE_BUSY;
+	}
+
+	if ((HighWater == 0U) || (LowWater >= HighWater) ||
+	    (HighWater > XUartPs_RingSize(&InstancePtr->RxRing))) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	InstancePtr->RxHighWater = HighWater;
+	InstancePtr->RxLowWater = LowWater;
+	InstancePtr->RxThrottled = 0U;
+	InstancePtr->TxBlocked = ((XUartPs_ReadReg(
+			InstancePtr->Config.BaseAddress,
+			XUARTPS_MODEMSR_OFFSET) & XUARTPS_MODEMSR_CTS) ==
+			(u32)0) ? 1U : 0U;
+
+	XUartPs_SetFlowDelay(InstancePtr, (u8)XUARTPS_RING_FLOWDEL);
+
+	ModemCr = XUartPs_ReadReg(InstancePtr->Config.BaseAddress,
+				  XUARTPS_MODEMCR_OFFSET);
+	XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
+			 XUARTPS_MODEMCR_OFFSET,
+			 ModemCr | XUARTPS_MODEMCR_FCM | XUARTPS_MODEMCR_RTS);
+
+	InstancePtr->RingFlowControl = 1U;
+
+	XUartPs_WriteReg(InstancePtr->Config.BaseAddress, XUARTPS_IER_OFFSET,
+			 XUARTPS_IXR_DMS);
+
+	return (s32)XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* This function disables the RTS/CTS flow control of ring buffer mode. The
+* RX FIFO is drained again and bytes that do not fit into the RX ring are
+* dropped as without flow control.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XUartPs_DisableRingFlowControl(XUartPs *InstancePtr)
+{
+	u32 ModemCr;
+
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	XUartPs_WriteReg(InstancePtr->Config.BaseAddress, XUARTPS_IDR_OFFSET,
+			 XUARTPS_IXR_DMS);
+
+	ModemCr = XUartPs_ReadReg(InstancePtr->Config.BaseAddress,
+				  XUARTPS_MODEMCR_OFFSET);
+	XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
+			 XUARTPS_MODEMCR_OFFSET, ModemCr & ~XUARTPS_MODEMCR_FCM);
+
+	InstancePtr->RingFlowControl = 0U;
+	InstancePtr->TxBlocked = 0U;
+
+	if ((InstancePtr->RingMode != 0U) && (InstancePtr->RxThrottled != 0U)) {
+		InstancePtr->RxThrottled = 0U;
+		XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
+				 XUARTPS_IER_OFFSET, XUARTPS_RING_RX_DATA_IXR);
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* This function enables XON/XOFF flow control in ring buffer mode, for links
+* without RTS and CTS. The interrupt handler sends an XOFF once the RX ring
+* holds HighWater bytes or more, and an XON once XUartPs_RingRead() has taken
+* it down to LowWater bytes or less. The XON and XOFF bytes received are not
+* stored in the RX ring, they resume and stop the sending of the TX ring.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	HighWater is the RX ring level that stops the sender, at most
+*		the RX ring size less what the sender still sends after the
+*		XOFF, bytes left in the RX ring beyond it being dropped.
+* @param	LowWater is the RX ring level that resumes the sender, less
+*		than HighWater.
+*
+* @return
+*		- XST_SUCCESS if flow control was enabled.
+*		- XST_NOT_ENABLED if ring buffer mode is not enabled.
+*		- XST_INVALID_PARAM if the water marks are not valid.
+*		- XST_DEVICE_BUSY if RTS/CTS flow control is enabled.
+*
+* @note		The data in both directions must not contain the XON and
+*		XOFF bytes, XUARTPS_XON and XUARTPS_XOFF.
+*
+*****************************************************************************/
+s32 XUartPs_EnableRingSoftFlowControl(XUartPs *InstancePtr, u32 HighWater,
+				      u32 LowWater)
+{
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	if (InstancePtr->RingMode == 0U) {
+		return (s32)XST_NOT_ENABLED;
+	}
+
+	if (InstancePtr->RingFlowControl != 0U) {
+		return (s32)XST_DEVICE_BUSY;
+	}
+
+	if ((HighWater == 0U) || (LowWater >= HighWater) ||
+	    (HighWater > XUartPs_RingSize(&InstancePtr->RxRing))) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	InstancePtr->RxHighWater = HighWater;
+	InstancePtr->RxLowWater = LowWater;
+	InstancePtr->RxXoff = 0U;
+	InstancePtr->TxCtrlChar = 0U;
+	InstancePtr->TxBlocked = 0U;
+	InstancePtr->RingSoftFlowControl = 1U;
+
+	return (s32)XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* This function disables the XON/XOFF flow control of ring buffer mode. A
+* sender stopped by an XOFF is sent an XON, and the TX ring is sent again
+* even if the other end sent an XOFF.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XUartPs_DisableRingSoftFlowControl(XUartPs *InstancePtr)
+{
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	if (InstancePtr->RingSoftFlowControl == 0U) {
+		return;
+	}
+
+	InstancePtr->RingSoftFlowControl = 0U;
+	InstancePtr->TxBlocked = 0U;
+
+	if (InstancePtr->RxXoff != 0U) {
+		InstancePtr->RxXoff = 0U;
+		InstancePtr->TxCtrlChar = XUARTPS_XON;
+	}
+
+	if (InstancePtr->RingMode != 0U) {
+		XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
+				 XUARTPS_IER_OFFSET, XUARTPS_IXR_TXEMPTY);
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* This function tells the TX ring producer whether the receiver on the other
+* end holds off the data, with CTS or an XOFF. The TX ring still accepts
+* data, it is sent once CTS is asserted again or an XON is received.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	1 if CTS is deasserted and RTS/CTS flow control is enabled,
+*		or an XOFF was received last and XON/XOFF flow control is
+*		enabled, 0 otherwise.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 XUartPs_RingTxBlocked(XUartPs *InstancePtr)
+{
+	Xil_AssertNonvoid(InstancePtr != NULL);
+
+	return InstancePtr->TxBlocked;
+}
+
+#if defined (__GNUC__) && !defined (__aarch64__)
+/* Instance serviced from the FIQ */
+static XUartPs *XUartPs_FiqInstancePtr;
+
+/*
+ * FIQ handler of ring buffer mode. The interrupt is not acknowledged at the
+ * GIC, the level of the UART line drops once its ISR is cleared.
+ */
+XIL_HOTPATH_TEXT XIL_FIQ_FAST_HANDLER
+static void XUartPs_RingFiqHandler(void)
+{
+	XUartPs_InterruptHandler(XUartPs_FiqInstancePtr);
+
+	/* The ISR write reaches the UART before the FIQ is unmasked */
+	dsb();
+}
+
+/****************************************************************************/
+/**
+*
+* This function services the UART from the FIQ in ring buffer mode. The
+* handler drains the RX FIFO into the RX ring and refills the TX FIFO with
+* no register save beyond the FIQ banked ones, no dispatch through the
+* interrupt controller and no acknowledge, so the RX FIFO is emptied within
+* a few hundred cycles of the interrupt, even while an IRQ is handled.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return
+*		- XST_SUCCESS if the FIQ handler was registered.
+*		- XST_NOT_ENABLED if ring buffer mode is not enabled.
+*		- XST_DEVICE_BUSY if another instance is serviced from the FIQ.
+*
+* @note		The UART interrupt must also be routed to the FIQ with
+*		XScuGic_SetFiq(), and XUartPs_InterruptHandler() stay connected
+*		to it in the interrupt controller. Only one instance can be
+*		serviced from the FIQ.
+*
+*****************************************************************************/
+s32 XUartPs_EnableRingFiq(XUartPs *InstancePtr)
+{
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	if (InstancePtr->RingMode == 0U) {
+		return (s32)XST_NOT_ENABLED;
+	}
+	if ((XUartPs_FiqInstancePtr != NULL) &&
+	    (XUartPs_FiqInstancePtr != InstancePtr)) {
+		return (s32)XST_DEVICE_BUSY;
+	}
+
+	XUartPs_FiqInstancePtr = InstancePtr;
+	Xil_ExceptionRegisterFiqFast(XUartPs_RingFiqHandler);
+	Xil_ExceptionEnableMask(XIL_EXCEPTION_FIQ);
+
+	return (s32)XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* This function stops servicing the UART from the FIQ. The interrupt is
+* handled through the IRQ again once XScuGic_ClearFiq() is called.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XUartPs_DisableRingFiq(XUartPs *InstancePtr)
+{
+	Xil_AssertVoid(InstancePtr != NULL);
+
+	if (XUartPs_FiqInstancePtr != InstancePtr) {
+		return;
+	}
+
+	Xil_ExceptionDisableMask(XIL_EXCEPTION_FIQ);
+	Xil_ExceptionRegisterFiqFast(NULL);
+	XUartPs_FiqInstancePtr = NULL;
+}
+#endif
+/** @} */
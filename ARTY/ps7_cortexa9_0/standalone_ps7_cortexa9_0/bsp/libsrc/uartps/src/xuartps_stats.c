@@ -0,0 +1,306 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file xuartps_stats.c
+* @addtogroup uartps Overview
+* @{
+*
+* This file contains the optional statistics of the XUartPs driver. Once a
+* statistics block has been attached with XUartPs_EnableStats(), the driver
+* counts the bytes moved, the interrupt handler entries and the receive
+* errors, tracks the high-water mark of the ring buffers and keeps a log2
+* histogram of the interrupt service time. It also keeps the optional RX
+* timestamps of XUartPs_EnableRxStamp(). Refer to the header file xuartps.h
+* for more detailed information.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- -----------------------------------------------
+* 3.14  qm     10/14/26 First release
+*       qm     10/14/26 Added the optional RX timestamps.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xuartps.h"
+#include "xil_io.h"
+#include "xtime_l.h"
+
+/************************** Constant Definitions ****************************/
+
+#define XUARTPS_STAMP_CHAR_BITS	10U	/* Start, 8 data and stop bits */
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+void XUartPs_StatsIsr(XUartPs *InstancePtr, u32 IsrStatus, XTime StartTime);
+void XUartPs_StampRx(XUartPs *InstancePtr, u32 NumBytes, u32 LineIdle);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* This function attaches a statistics block to the driver instance and clears
+* it. From then on the driver updates the block from the send, receive and
+* interrupt paths.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	StatsPtr is the statistics block, it must stay valid until
+*		XUartPs_DisableStats() is called.
+*
+* @return	None.
+*
+* @note		The counters are updated from the interrupt handler, read them
+*		with XUartPs_GetStats() rather than directly.
+*
+*****************************************************************************/
+void XUartPs_EnableStats(XUartPs *InstancePtr, XUartPsStats *StatsPtr)
+{
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(StatsPtr != NULL);
+	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	(void)memset((void *)StatsPtr, 0, sizeof(XUartPsStats));
+	InstancePtr->StatsPtr = StatsPtr;
+}
+
+/****************************************************************************/
+/**
+*
+* This function detaches the statistics block from the driver instance. The
+* block keeps the values it had at that time.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XUartPs_DisableStats(XUartPs *InstancePtr)
+{
+	Xil_AssertVoid(InstancePtr != NULL);
+
+	InstancePtr->StatsPtr = NULL;
+}
+
+/****************************************************************************/
+/**
+*
+* This function takes a consistent snapshot of the statistics. The UART
+* interrupts are masked while the block is copied so that the interrupt
+* handler cannot update it halfway through.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	SnapshotPtr is where the snapshot is stored.
+*
+* @return
+*		- XST_SUCCESS if the snapshot was taken.
+*		- XST_NOT_ENABLED if no statistics block is attached.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 XUartPs_GetStats(XUartPs *InstancePtr, XUartPsStats *SnapshotPtr)
+{
+	u32 ImrRegister;
+
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(SnapshotPtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	if (InstancePtr->StatsPtr == NULL) {
+		return (s32)XST_NOT_ENABLED;
+	}
+
+	/* Disable all the interrupts while the block is copied */
+	ImrRegister = XUartPs_ReadReg(InstancePtr->Config.BaseAddress,
+				      XUARTPS_IMR_OFFSET);
+	XUartPs_WriteReg(InstancePtr->Config.BaseAddress, XUARTPS_IDR_OFFSET,
+			 XUARTPS_IXR_MASK);
+
+	*SnapshotPtr = *InstancePtr->StatsPtr;
+
+	/* Restore the interrupt state */
+	XUartPs_WriteReg(InstancePtr->Config.BaseAddress, XUARTPS_IER_OFFSET,
+			 ImrRegister);
+
+	return (s32)XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* This function enables the RX timestamps of the interrupt driven receive.
+* From then on the first byte of each receive buffer is stamped, refer to
+* XUartPs_GetRxStamp().
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XUartPs_EnableRxStamp(XUartPs *InstancePtr)
+{
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	InstancePtr->RxStamp = 0U;
+	InstancePtr->RxStampBaud = 0U;
+	InstancePtr->RxStampEnabled = 1U;
+}
+
+/****************************************************************************/
+/**
+*
+* This function disables the RX timestamps. The last stamp is kept.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XUartPs_DisableRxStamp(XUartPs *InstancePtr)
+{
+	Xil_AssertVoid(InstancePtr != NULL);
+
+	InstancePtr->RxStampEnabled = 0U;
+}
+
+/****************************************************************************/
+/**
+*
+* This function returns the timestamp of the first byte of the receive
+* buffer, the XTime_GetTime() at which the byte was about complete on the
+* line. It is meant to be called from the handler of
+* XUARTPS_EVENT_RECV_DATA or XUARTPS_EVENT_RECV_TOUT, or before the next
+* XUartPs_Recv(), the stamp being that of the buffer being received.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	The XTime of the first byte, 0 if the timestamps are disabled
+*		or no byte of the buffer has been received yet.
+*
+* @note		None.
+*
+*****************************************************************************/
+u64 XUartPs_GetRxStamp(XUartPs *InstancePtr)
+{
+	Xil_AssertNonvoid(InstancePtr != NULL);
+
+	return InstancePtr->RxStamp;
+}
+
+/****************************************************************************/
+/*
+*
+* This function is called by the receive data and receive timeout handlers
+* when RX timestamps are enabled. When the bytes just drained are the first
+* ones of the receive buffer, the time is stamped, moved back by the time
+* the bytes spent in the RX FIFO: one character time for each byte drained
+* after the first, and the RX timeout, 4 bit times per unit, when the line
+* has gone idle. The character time is computed again when the baud rate
+* has changed.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	NumBytes is the number of bytes drained, the receive buffer
+*		held no byte before them.
+* @param	LineIdle is TRUE for the receive timeout interrupt.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XUartPs_StampRx(XUartPs *InstancePtr, u32 NumBytes, u32 LineIdle)
+{
+	XTime Now;
+	XTime Age;
+
+	XTime_GetTime(&Now);
+
+	if (InstancePtr->RxStampBaud != InstancePtr->BaudRate) {
+		InstancePtr->RxStampBaud = InstancePtr->BaudRate;
+		InstancePtr->RxCharTicks = (u32)(((u64)COUNTS_PER_SECOND *
+					 XUARTPS_STAMP_CHAR_BITS) /
+					 InstancePtr->BaudRate);
+	}
+
+	Age = (XTime)(NumBytes - 1U) * InstancePtr->RxCharTicks;
+	if (LineIdle != FALSE) {
+		Age += ((XTime)(XUartPs_ReadReg(InstancePtr->Config.BaseAddress,
+						XUARTPS_RXTOUT_OFFSET) &
+				XUARTPS_RXTOUT_MASK) * 4U *
+			InstancePtr->RxCharTicks) / XUARTPS_STAMP_CHAR_BITS;
+	}
+
+	InstancePtr->RxStamp = (Age < Now) ? (u64)(Now - Age) : 0U;
+}
+
+/****************************************************************************/
+/*
+*
+* This function is called at the end of the interrupt handler when statistics
+* are enabled. It counts the entry and the receive errors and adds the
+* service time to the histogram, bin N counting services that took from 2^N
+* to 2^(N+1) - 1 timer ticks, the last bin also taking everything longer.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	IsrStatus is the interrupt status that was serviced.
+* @param	StartTime is the time the interrupt handler was entered.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XUartPs_StatsIsr(XUartPs *InstancePtr, u32 IsrStatus, XTime StartTime)
+{
+	XUartPsStats *StatsPtr = InstancePtr->StatsPtr;
+	XTime EndTime;
+	XTime Ticks;
+	u32 Bin = 0U;
+
+	StatsPtr->IsrEntries++;
+
+	if ((IsrStatus & (u32)XUARTPS_IXR_OVER) != (u32)0) {
+		StatsPtr->OverrunErrors++;
+	}
+	if ((IsrStatus & (u32)XUARTPS_IXR_FRAMING) != (u32)0) {
+		StatsPtr->FramingErrors++;
+	}
+	if ((IsrStatus & (u32)XUARTPS_IXR_PARITY) != (u32)0) {
+		StatsPtr->ParityErrors++;
+	}
+
+	XTime_GetTime(&EndTime);
+	Ticks = EndTime - StartTime;
+
+	if (Ticks > (XTime)StatsPtr->IsrTimeMax) {
+		StatsPtr->IsrTimeMax = (u32)Ticks;
+	}
+
+	while ((Ticks > (XTime)1) && (Bin < (XUARTPS_STATS_HIST_BINS - 1U))) {
+		Ticks >>= 1;
+		Bin++;
+	}
+	StatsPtr->IsrTimeHist[Bin]++;
+}
+/** @} */
@@ -91,6 +91,24 @@
 * device in interrupt mode.
 *
 *
+* <b> Streaming </b>
+*
+* XAdcPs_GetAdcData() reads one status register per call and waits for the
+* round trip of its command through the PS-XADC serial interface, twice.
+* The functions in xadcps_stream.c instead run the channel sequencer in the
+* continuous mode and queue the reads of all the enabled channels to the
+* command FIFO in one batch. The data FIFO threshold interrupt drains the
+* answers in one go, and every pass through the channels is stored with the
+* global timer count of its start as an XAdcPs_StreamBlock in a ring
+* provided by the caller. The PS-XADC interface has no DMA request, so the
+* FIFO is the widest path to the samples.
+*
+* XAdcPs_StreamIntrHandler() must be connected to the XADC interrupt, and
+* no other function of the driver may be called while the stream runs. The
+* blocks are read with XAdcPs_StreamRead(), from a thread or from the other
+* CPU.
+*
+*
 * <b> Virtual Memory </b>
 *
 * This driver supports Virtual Memory. The RTOS is responsible for calculating
@@ -159,6 +177,10 @@
 *       aad    12/17/20 Added missing function declarations and removed
 *			functions with no definitions.
 * 2.7   cog    07/24/23 Added support for SDT flow
+* 2.8   qm     10/14/26 Added the continuous sequencer stream of
+*			xadcps_stream.c and XADCPS_CFG_DFIFOTH_SHIFT.
+*       qm     10/14/26 Timestamp of XAdcPs_StreamBlock as a u64, xtime_l.h
+*			clashing with the COUNTS_PER_SECOND of xiltimer.h.
 *
 *
 * </pre>
@@ -296,6 +318,15 @@ extern "C" {
 #define XADCPS_PD_MODE_XADC		2U  /**< Power Down ADC A and ADC B */
 /*@}*/
 
+/**
+ * @name Streaming
+ * @{
+ */
+#define XADCPS_STREAM_MAX_CHANNELS	26U /**< Channels with data in the
+					      *  sequencer */
+#define XADCPS_FIFO_DEPTH		15U /**< Words of each FIFO */
+/*@}*/
+
 /**************************** Type Definitions ******************************/
 
 /**
@@ -323,6 +354,48 @@ typedef struct {
 
 } XAdcPs;
 
+/**
+ * One pass of the stream through the enabled channels. Data[i] is the
+ * status register of XAdcPs_Stream.Channel[i].
+ */
+typedef struct {
+	u64 Timestamp;		/**< Global timer count when the pass started */
+	u32 Sequence;		/**< Number of the pass */
+	u16 Data[XADCPS_STREAM_MAX_CHANNELS]; /**< Raw ADC data */
+} XAdcPs_StreamBlock;
+
+/**
+ * Called from XAdcPs_StreamIntrHandler() after each block is stored.
+ */
+typedef void (*XAdcPs_StreamHandler)(void *CallBackRef,
+				     const XAdcPs_StreamBlock *BlockPtr);
+
+/**
+ * The stream of a XADC device. The ring is written by the interrupt handler
+ * and read by XAdcPs_StreamRead(), one of each.
+ */
+typedef struct {
+	XAdcPs *InstancePtr;
+	u8 Channel[XADCPS_STREAM_MAX_CHANNELS]; /**< XADCPS_CH_* of each
+						  *  sample of a block */
+	u32 NumChannels;
+	XAdcPs_StreamBlock *Ring;	/**< Blocks provided by the caller */
+	u32 NumBlocks;
+	volatile u32 Head;	/**< Blocks stored by the handler */
+	volatile u32 Tail;	/**< Blocks read by XAdcPs_StreamRead() */
+	u32 Overruns;		/**< Blocks lost to a full ring */
+	XAdcPs_StreamBlock Scan;	/**< Block being acquired */
+	u32 Next;		/**< First sample of the batch in flight */
+	u32 Queued;		/**< Reads in the batch */
+	u32 Received;		/**< Words of the batch drained */
+	u32 Sequence;
+	u32 SavedMode;		/**< Sequencer mode before the stream */
+	u32 SavedChEnables;	/**< Sequencer channels before the stream */
+	volatile u32 Running;
+	XAdcPs_StreamHandler Handler;
+	void *CallBackRef;
+} XAdcPs_Stream;
+
 /***************** Macros (Inline Functions) Definitions ********************/
 
 /****************************************************************************/
@@ -573,6 +646,19 @@ u32 XAdcPs_IntrGetEnabled(XAdcPs *InstancePtr);
 u32 XAdcPs_IntrGetStatus(XAdcPs *InstancePtr);
 void XAdcPs_IntrClear(XAdcPs *InstancePtr, u32 Mask);
 
+/**
+ * Functions in xadcps_stream.c
+ */
+int XAdcPs_StreamInitialize(XAdcPs_Stream *StreamPtr, XAdcPs *InstancePtr,
+			    XAdcPs_StreamBlock *RingPtr, u32 NumBlocks);
+void XAdcPs_StreamSetHandler(XAdcPs_Stream *StreamPtr,
+			     XAdcPs_StreamHandler FuncPtr, void *CallBackRef);
+int XAdcPs_StreamStart(XAdcPs_Stream *StreamPtr, u32 ChEnableMask);
+void XAdcPs_StreamStop(XAdcPs_Stream *StreamPtr);
+u32 XAdcPs_StreamRead(XAdcPs_Stream *StreamPtr, XAdcPs_StreamBlock *BlockPtr,
+		      u32 MaxBlocks);
+void XAdcPs_StreamIntrHandler(void *CallBackRef);
+
 
 #ifdef __cplusplus
 }
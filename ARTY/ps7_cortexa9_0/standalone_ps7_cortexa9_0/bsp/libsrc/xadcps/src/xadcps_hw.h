@@ -78,6 +78,7 @@ extern "C" {
 #define XADCPS_CFG_ENABLE_MASK	 0x80000000U /**< Enable access from PS mask */
 #define XADCPS_CFG_CFIFOTH_MASK  0x00F00000U /**< Command FIFO Threshold mask */
 #define XADCPS_CFG_DFIFOTH_MASK  0x000F0000U /**< Data FIFO Threshold mask */
+#define XADCPS_CFG_DFIFOTH_SHIFT 16U	     /**< Data FIFO Threshold shift */
 #define XADCPS_CFG_WEDGE_MASK	 0x00002000U /**< Write Edge Mask */
 #define XADCPS_CFG_REDGE_MASK	 0x00001000U /**< Read Edge Mask */
 #define XADCPS_CFG_TCKRATE_MASK  0x00000300U /**< Clock freq control */
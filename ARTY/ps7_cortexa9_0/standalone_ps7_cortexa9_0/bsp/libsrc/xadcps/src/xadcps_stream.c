@@ -0,0 +1,480 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file xadcps_stream.c
+* @addtogroup Overview
+* @{
+*
+* This file contains the continuous acquisition of the channels enabled in
+* the sequencer.
+*
+* Each command written to the command FIFO shifts one word into the data
+* FIFO, and the word of a read command is the answer of the command before
+* it. A batch is therefore the reads of up to XADCPS_FIFO_DEPTH - 1
+* channels followed by a no-op, and its first word is dropped. The data FIFO
+* threshold is set to the number of reads, so the interrupt comes once the
+* batch has been answered; when more channels are enabled than a batch
+* holds, a pass takes several batches.
+*
+* In the continuous mode the sequencer keeps the status registers up to
+* date by itself, and a block holds their values at the time of the reads.
+* Passes follow each other as fast as the interface allows, which is a few
+* microseconds per channel at the default TCK rate.
+*
+* Refer to xadcps.h header file and device specification for more information.
+*
+* <pre>
+*
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- -----  -------- -----------------------------------------------------
+* 2.8   qm     10/14/26 First release
+*
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xadcps.h"
+#include "xil_atomic.h"
+#include "xtime_l.h"
+
+/************************** Constant Definitions *****************************/
+
+#define XADCPS_STREAM_BATCH	(XADCPS_FIFO_DEPTH - 1U) /**< Reads of a batch,
+							   *  with its no-op */
+#define XADCPS_JTAG_CMD_NOP	0x00000000U /**< No operation */
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+
+static void XAdcPs_StreamFlush(XAdcPs *InstancePtr);
+static void XAdcPs_StreamSetThreshold(XAdcPs *InstancePtr, u32 Threshold);
+static void XAdcPs_StreamQueue(XAdcPs_Stream *StreamPtr);
+
+/************************** Variable Definitions *****************************/
+
+
+/****************************************************************************/
+/**
+*
+* This function initializes a stream of the XADC device over a ring of
+* blocks provided by the caller.
+*
+* @param	StreamPtr is a pointer to the stream.
+* @param	InstancePtr is a pointer to the XAdcPs instance.
+* @param	RingPtr points to NumBlocks blocks.
+* @param	NumBlocks is the number of blocks of the ring.
+*
+* @return
+*		- XST_SUCCESS if successful.
+*		- XST_INVALID_PARAM if the ring is empty.
+*
+* @note		None.
+*
+*****************************************************************************/
+int XAdcPs_StreamInitialize(XAdcPs_Stream *StreamPtr, XAdcPs *InstancePtr,
+			    XAdcPs_StreamBlock *RingPtr, u32 NumBlocks)
+{
+	/*
+	 * Assert the arguments.
+	 */
+	Xil_AssertNonvoid(StreamPtr != NULL);
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	if ((RingPtr == NULL) || (NumBlocks == 0U)) {
+		return XST_INVALID_PARAM;
+	}
+
+	StreamPtr->InstancePtr = InstancePtr;
+	StreamPtr->NumChannels = 0U;
+	StreamPtr->Ring = RingPtr;
+	StreamPtr->NumBlocks = NumBlocks;
+	StreamPtr->Head = 0U;
+	StreamPtr->Tail = 0U;
+	StreamPtr->Overruns = 0U;
+	StreamPtr->Next = 0U;
+	StreamPtr->Queued = 0U;
+	StreamPtr->Received = 0U;
+	StreamPtr->Sequence = 0U;
+	StreamPtr->Running = 0U;
+	StreamPtr->Handler = NULL;
+	StreamPtr->CallBackRef = NULL;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* This function sets the handler called after each block is stored. The
+* handler runs in the interrupt and gets the block in the ring.
+*
+* @param	StreamPtr is a pointer to the stream.
+* @param	FuncPtr is the handler, or NULL for none.
+* @param	CallBackRef is passed to the handler.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XAdcPs_StreamSetHandler(XAdcPs_Stream *StreamPtr,
+			     XAdcPs_StreamHandler FuncPtr, void *CallBackRef)
+{
+	Xil_AssertVoid(StreamPtr != NULL);
+
+	StreamPtr->Handler = FuncPtr;
+	StreamPtr->CallBackRef = CallBackRef;
+}
+
+/****************************************************************************/
+/**
+*
+* This function starts the stream. The channels are enabled in the sequencer,
+* the sequencer is set to the continuous mode and the first batch of reads
+* is queued.
+*
+* @param	StreamPtr is a pointer to the stream.
+* @param	ChEnableMask is the channels to acquire, formed by OR'ing the
+*		XADCPS_SEQ_CH_* bits of xadcps_hw.h. XADCPS_SEQ_CH_CALIB is
+*		given to the sequencer but has no data in the blocks.
+*
+* @return
+*		- XST_SUCCESS if the stream runs.
+*		- XST_DEVICE_BUSY if it already runs.
+*		- XST_INVALID_PARAM if no channel with data is enabled.
+*
+* @note		The interrupt of the device must be connected to
+*		XAdcPs_StreamIntrHandler() with StreamPtr.
+*
+*****************************************************************************/
+int XAdcPs_StreamStart(XAdcPs_Stream *StreamPtr, u32 ChEnableMask)
+{
+	XAdcPs *InstancePtr;
+	u32 Mask;
+	u32 Bit;
+	u32 Count = 0U;
+
+	Xil_AssertNonvoid(StreamPtr != NULL);
+	Xil_AssertNonvoid(StreamPtr->InstancePtr != NULL);
+
+	InstancePtr = StreamPtr->InstancePtr;
+	if (StreamPtr->Running != 0U) {
+		return XST_DEVICE_BUSY;
+	}
+
+	Mask = ChEnableMask & (XADCPS_SEQ00_CH_VALID_MASK |
+			       (XADCPS_SEQ01_CH_VALID_MASK <<
+				XADCPS_SEQ_CH_AUX_SHIFT));
+
+	/*
+	 * Turn the sequencer bits into the channel numbers of the status
+	 * registers: bits 8 to 14 are the channels 0 to 6, bits 5 to 7 the
+	 * PS supplies 13 to 15 and the high half the auxiliary channels.
+	 */
+	for (Bit = 0U; Bit < 32U; Bit++) {
+		if ((Mask & ((u32)1U << Bit)) == 0U) {
+			continue;
+		}
+		if ((Bit >= 8U) && (Bit <= 14U)) {
+			StreamPtr->Channel[Count] = (u8)(Bit - 8U);
+		} else if ((Bit >= 5U) && (Bit <= 7U)) {
+			StreamPtr->Channel[Count] = (u8)(Bit + 8U);
+		} else if (Bit >= XADCPS_SEQ_CH_AUX_SHIFT) {
+			StreamPtr->Channel[Count] = (u8)Bit;
+		} else {
+			continue;
+		}
+		Count++;
+	}
+	if (Count == 0U) {
+		return XST_INVALID_PARAM;
+	}
+	StreamPtr->NumChannels = Count;
+
+	/*
+	 * The channel enables are only written in the safe mode.
+	 */
+	StreamPtr->SavedMode = XAdcPs_GetSequencerMode(InstancePtr);
+	StreamPtr->SavedChEnables = XAdcPs_GetSeqChEnables(InstancePtr);
+	XAdcPs_SetSequencerMode(InstancePtr, XADCPS_SEQ_MODE_SAFE);
+	(void)XAdcPs_SetSeqChEnables(InstancePtr, Mask);
+	XAdcPs_SetSequencerMode(InstancePtr, XADCPS_SEQ_MODE_CONTINPASS);
+
+	XAdcPs_StreamFlush(InstancePtr);
+	XAdcPs_IntrClear(InstancePtr, XADCPS_INTX_DFIFO_GTH_MASK);
+
+	StreamPtr->Next = 0U;
+	StreamPtr->Running = 1U;
+	XAdcPs_StreamQueue(StreamPtr);
+	XAdcPs_IntrEnable(InstancePtr, XADCPS_INTX_DFIFO_GTH_MASK);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* This function stops the stream and gives the sequencer back its mode and
+* channels. The blocks already stored stay in the ring.
+*
+* @param	StreamPtr is a pointer to the stream.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XAdcPs_StreamStop(XAdcPs_Stream *StreamPtr)
+{
+	XAdcPs *InstancePtr;
+
+	Xil_AssertVoid(StreamPtr != NULL);
+
+	if (StreamPtr->Running == 0U) {
+		return;
+	}
+	InstancePtr = StreamPtr->InstancePtr;
+
+	StreamPtr->Running = 0U;
+	XAdcPs_IntrDisable(InstancePtr, XADCPS_INTX_DFIFO_GTH_MASK);
+
+	/*
+	 * Drop the batch in flight, so that the FIFOs are in step again for
+	 * the register accesses of the driver.
+	 */
+	XAdcPs_StreamFlush(InstancePtr);
+	XAdcPs_IntrClear(InstancePtr, XADCPS_INTX_DFIFO_GTH_MASK);
+	StreamPtr->Next = 0U;
+
+	XAdcPs_SetSequencerMode(InstancePtr, XADCPS_SEQ_MODE_SAFE);
+	(void)XAdcPs_SetSeqChEnables(InstancePtr, StreamPtr->SavedChEnables);
+	XAdcPs_SetSequencerMode(InstancePtr, (u8)StreamPtr->SavedMode);
+}
+
+/****************************************************************************/
+/**
+*
+* This function copies the oldest blocks of the ring out and frees them.
+*
+* @param	StreamPtr is a pointer to the stream.
+* @param	BlockPtr points to room for MaxBlocks blocks.
+* @param	MaxBlocks is the most blocks to read.
+*
+* @return	The number of blocks read.
+*
+* @note		It may run on the other CPU than the interrupt handler.
+*
+*****************************************************************************/
+u32 XAdcPs_StreamRead(XAdcPs_Stream *StreamPtr, XAdcPs_StreamBlock *BlockPtr,
+		      u32 MaxBlocks)
+{
+	u32 Head;
+	u32 Tail;
+	u32 Count = 0U;
+
+	Xil_AssertNonvoid(StreamPtr != NULL);
+	Xil_AssertNonvoid(BlockPtr != NULL);
+
+	Head = Xil_AtomicLoadAcquire(&StreamPtr->Head);
+	Tail = StreamPtr->Tail;
+	while ((Tail != Head) && (Count < MaxBlocks)) {
+		BlockPtr[Count] = StreamPtr->Ring[Tail % StreamPtr->NumBlocks];
+		Tail++;
+		Count++;
+	}
+	Xil_AtomicStoreRelease(&StreamPtr->Tail, Tail);
+
+	return Count;
+}
+
+/****************************************************************************/
+/**
+*
+* This function is the interrupt handler of the stream. It drains the data
+* FIFO, stores the block when a pass through the channels is complete and
+* queues the next batch.
+*
+* @param	CallBackRef is a pointer to the stream.
+*
+* @return	None.
+*
+* @note		Other interrupts of the device are left pending for the
+*		handler of the application.
+*
+*****************************************************************************/
+void XAdcPs_StreamIntrHandler(void *CallBackRef)
+{
+	XAdcPs_Stream *StreamPtr = (XAdcPs_Stream *)CallBackRef;
+	XAdcPs *InstancePtr;
+	XAdcPs_StreamBlock *SlotPtr = NULL;
+	u32 Level;
+	u32 Word;
+	u32 Head;
+
+	Xil_AssertVoid(StreamPtr != NULL);
+	InstancePtr = StreamPtr->InstancePtr;
+
+	if ((XAdcPs_IntrGetStatus(InstancePtr) &
+	     XADCPS_INTX_DFIFO_GTH_MASK) == 0U) {
+		return;
+	}
+
+	Level = (XAdcPs_ReadReg(InstancePtr->Config.BaseAddress,
+				XADCPS_MSTS_OFFSET) &
+		 XADCPS_MSTS_DFIFO_LVL_MASK) >> 12U;
+	while ((Level > 0U) && (StreamPtr->Received <= StreamPtr->Queued)) {
+		Word = XAdcPs_ReadFifo(InstancePtr);
+		/*
+		 * The first word answers the no-op before the batch.
+		 */
+		if (StreamPtr->Received > 0U) {
+			StreamPtr->Scan.Data[StreamPtr->Next +
+					     StreamPtr->Received - 1U] =
+				(u16)Word;
+		}
+		StreamPtr->Received++;
+		Level--;
+	}
+	XAdcPs_IntrClear(InstancePtr, XADCPS_INTX_DFIFO_GTH_MASK);
+
+	if (StreamPtr->Received <= StreamPtr->Queued) {
+		/*
+		 * Come back when the rest of the batch is in.
+		 */
+		XAdcPs_StreamSetThreshold(InstancePtr, StreamPtr->Queued -
+					  StreamPtr->Received);
+		return;
+	}
+
+	StreamPtr->Next += StreamPtr->Queued;
+	if (StreamPtr->Next == StreamPtr->NumChannels) {
+		StreamPtr->Next = 0U;
+		Head = StreamPtr->Head;
+		if ((Head - Xil_AtomicLoadAcquire(&StreamPtr->Tail)) <
+		    StreamPtr->NumBlocks) {
+			SlotPtr = &StreamPtr->Ring[Head % StreamPtr->NumBlocks];
+			*SlotPtr = StreamPtr->Scan;
+			Xil_AtomicStoreRelease(&StreamPtr->Head, Head + 1U);
+		} else {
+			StreamPtr->Overruns++;
+		}
+	}
+
+	if (StreamPtr->Running != 0U) {
+		XAdcPs_StreamQueue(StreamPtr);
+	}
+
+	if ((SlotPtr != NULL) && (StreamPtr->Handler != NULL)) {
+		StreamPtr->Handler(StreamPtr->CallBackRef, SlotPtr);
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* This function flushes the command and data FIFOs.
+*
+* @param	InstancePtr is a pointer to the XAdcPs instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void XAdcPs_StreamFlush(XAdcPs *InstancePtr)
+{
+	u32 RegValue;
+
+	RegValue = XAdcPs_GetMiscCtrlRegister(InstancePtr);
+	XAdcPs_SetMiscCtrlRegister(InstancePtr,
+				   RegValue | XADCPS_MCTL_FLUSH_MASK);
+	XAdcPs_SetMiscCtrlRegister(InstancePtr,
+				   RegValue & ~XADCPS_MCTL_FLUSH_MASK);
+}
+
+/****************************************************************************/
+/**
+*
+* This function sets the level above which the data FIFO interrupts.
+*
+* @param	InstancePtr is a pointer to the XAdcPs instance.
+* @param	Threshold is the level, 0 to 15.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void XAdcPs_StreamSetThreshold(XAdcPs *InstancePtr, u32 Threshold)
+{
+	u32 RegValue;
+
+	RegValue = XAdcPs_ReadReg(InstancePtr->Config.BaseAddress,
+				  XADCPS_CFG_OFFSET);
+	RegValue &= ~XADCPS_CFG_DFIFOTH_MASK;
+	RegValue |= (Threshold << XADCPS_CFG_DFIFOTH_SHIFT) &
+		    XADCPS_CFG_DFIFOTH_MASK;
+	XAdcPs_WriteReg(InstancePtr->Config.BaseAddress, XADCPS_CFG_OFFSET,
+			RegValue);
+}
+
+/****************************************************************************/
+/**
+*
+* This function queues the next batch of reads of the stream and its no-op.
+*
+* @param	StreamPtr is a pointer to the stream.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void XAdcPs_StreamQueue(XAdcPs_Stream *StreamPtr)
+{
+	XAdcPs *InstancePtr = StreamPtr->InstancePtr;
+	u32 Queued;
+	u32 Index;
+
+	if (StreamPtr->Next == 0U) {
+		XTime_GetTime(&StreamPtr->Scan.Timestamp);
+		StreamPtr->Scan.Sequence = StreamPtr->Sequence;
+		StreamPtr->Sequence++;
+	}
+
+	Queued = StreamPtr->NumChannels - StreamPtr->Next;
+	if (Queued > XADCPS_STREAM_BATCH) {
+		Queued = XADCPS_STREAM_BATCH;
+	}
+	StreamPtr->Queued = Queued;
+	StreamPtr->Received = 0U;
+
+	/*
+	 * The batch answers with one word more than it has reads.
+	 */
+	XAdcPs_StreamSetThreshold(InstancePtr, Queued);
+
+	for (Index = 0U; Index < Queued; Index++) {
+		XAdcPs_WriteFifo(InstancePtr,
+				 XADCPS_JTAG_CMD_READ_MASK |
+				 (((XADCPS_TEMP_OFFSET +
+				    (u32)StreamPtr->Channel[StreamPtr->Next +
+							    Index]) <<
+				   XADCPS_JTAG_ADDR_SHIFT) &
+				  XADCPS_JTAG_ADDR_MASK));
+	}
+	XAdcPs_WriteFifo(InstancePtr, XADCPS_JTAG_CMD_NOP);
+}
+/** @} */
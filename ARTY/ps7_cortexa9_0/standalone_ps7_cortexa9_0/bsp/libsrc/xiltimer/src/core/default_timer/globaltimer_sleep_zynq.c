@@ -14,6 +14,20 @@
  * This file contains the definitions for sleep implementation using
  * global timer.
  *
+ * A delay of XGTIMER_WFI_MIN_US or more sleeps in WFI: the comparator of
+ * the global timer, banked per CPU, is set to the end of the delay less
+ * the wake up time and its interrupt, ID 27, ends the sleep. The rest is
+ * spun on the counter, as are the short delays. The WFI is only used from
+ * the main loop with the IRQ enabled and once the GIC of xinterrupt_wrap
+ * is initialized, not in interrupt handlers, nested ones included.
+ *
+ * The global timer is clocked at half the CPU clock. When the CPU clock is
+ * divided by an integer factor at run time, XTime_SetScale() is told the
+ * factor and XTime_GetTime() multiplies the counts since the change by it,
+ * so that the time keeps counting COUNTS_PER_SECOND per second, at a lower
+ * resolution, and no user of COUNTS_PER_SECOND has to convert by the clock
+ * of the moment.
+ *
  * <pre>
  * MODIFICATION HISTORY:
  *
@@ -21,6 +35,10 @@
  * ----- ---- -------- -------------------------------------------------------
  * 1.0  adk	 24/11/21 Initial release.
  * 1.1	adk      08/08/22 Added doxygen tags.
+ * 1.2  qm       14/10/26 Sleep in WFI until a comparator interrupt of the
+ *                        global timer when the GIC is set up, spinning for
+ *                        short delays and the end of long ones.
+ *      qm       14/10/26 Added XTime_SetScale() for a divided CPU clock.
  *</pre>
  *
  *@note
@@ -32,6 +50,14 @@
 #ifdef SDT
 #include "xcortexa9_config.h"
 #endif
+#ifdef XIL_INTERRUPT
+#include "xinterrupt_wrap.h"
+#if defined (XPAR_SCUGIC)
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#define XGTIMER_WFI
+#endif
+#endif
 
 /**************************** Type Definitions *******************************/
 /************************** Constant Definitions *****************************/
@@ -39,11 +65,46 @@
 #define GTIMER_COUNTER_LOWER_OFFSET	0x00U
 #define GTIMER_COUNTER_UPPER_OFFSET	0x04U
 #define GTIMER_CONTROL_OFFSET	0x08U
+#define GTIMER_INTR_STS_OFFSET	0x0CU
+#define GTIMER_COMPARE_LOWER_OFFSET	0x10U
+#define GTIMER_COMPARE_UPPER_OFFSET	0x14U
+#define GTIMER_CONTROL_COMP_EN	0x2U	/* Comparator enable */
+#define GTIMER_CONTROL_IRQ_EN	0x4U	/* Comparator interrupt enable */
+#define GTIMER_INTR_ID		27U	/* Global timer PPI */
+
+/* Shorter delays are spun */
+#ifndef XGTIMER_WFI_MIN_US
+#define XGTIMER_WFI_MIN_US	20U
+#endif
+/* From the comparator interrupt back to the sleep loop */
+#ifndef XGTIMER_WAKE_US
+#define XGTIMER_WAKE_US		2U
+#endif
 
 /************************** Function Prototypes ******************************/
 static void XGlobalTimer_Start(XTimer *InstancePtr);
 static void XGlobalTimer_ModifyInterval(XTimer *InstancePtr, u32 delay,
 					XTimer_DelayType DelayType);
+#ifdef XGTIMER_WFI
+static void XGlobalTimer_WfiSleep(XTime tWake);
+static void XGlobalTimer_CompareHandler(void *CallBackRef);
+#endif
+static XTime XGlobalTimer_ReadCount(void);
+
+/************************** Variable Definitions *****************************/
+#ifdef XGTIMER_WFI
+/* Comparator interrupt connected, per CPU */
+static u8 XGlobalTimer_WfiReady[2];
+#endif
+
+/*
+ * Time base of XTime_GetTime(): the time and the count of the last change
+ * of the scale, and the scale. Seq is odd while they are written.
+ */
+static volatile u32 XGlobalTimer_Seq;
+static XTime XGlobalTimer_Origin;
+static XTime XGlobalTimer_CountOrigin;
+static u32 XGlobalTimer_Scale = 1U;
 
 /****************************************************************************/
 /**
@@ -122,12 +183,110 @@ static void XGlobalTimer_ModifyInterval(XTimer *InstancePtr, u32 delay,
 
 	XTime_GetTime(&tCur);
 	tEnd = tCur + (((XTime) delay) * (TimerCountsPersec / DelayType));
+#ifdef XGTIMER_WFI
+	if ((tEnd - tCur) >= ((XTime)XGTIMER_WFI_MIN_US *
+			      (TimerCountsPersec / 1000000U))) {
+		XGlobalTimer_WfiSleep(tEnd - ((XTime)XGTIMER_WAKE_US *
+				      (TimerCountsPersec / 1000000U)));
+	}
+#endif
         do {
 		XTime_GetTime(&tCur);
         } while (tCur < tEnd);
 
 }
 
+#ifdef XGTIMER_WFI
+/*****************************************************************************/
+/**
+ * This function sleeps in WFI until a time, from the main loop only.
+ *
+ * @param  tWake is the time of the global timer to wake up at
+ *
+ * @return	None, at once if the WFI cannot be used
+ *
+ ****************************************************************************/
+static void XGlobalTimer_WfiSleep(XTime tWake)
+{
+	XScuGic *GicPtr = XGetScuGicInstance();
+	u32 Cpu = mfcp(XREG_CP15_MULTI_PROC_AFFINITY) & 0x1U;
+	u32 Cpsr = mfcpsr();
+	u32 Control;
+	XTime tCur;
+	XTime tCount;
+
+	/* Not with the IRQ masked, in a handler or before the GIC is up */
+	if ((GicPtr == NULL) || ((Cpsr & XREG_CPSR_IRQ_ENABLE) != 0U) ||
+	    ((XScuGic_CPUReadReg(GicPtr, XSCUGIC_RUN_PRIOR_OFFSET) &
+	      XSCUGIC_RUN_PRIORITY_MASK) != XSCUGIC_RUN_PRIORITY_MASK)) {
+		return;
+	}
+
+	if (XGlobalTimer_WfiReady[Cpu] == 0U) {
+		if (XScuGic_Connect(GicPtr, GTIMER_INTR_ID,
+				    XGlobalTimer_CompareHandler,
+				    NULL) != XST_SUCCESS) {
+			return;
+		}
+		XScuGic_Enable(GicPtr, GTIMER_INTR_ID);
+		XGlobalTimer_WfiReady[Cpu] = 1U;
+	}
+
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+	/* The comparator counts unscaled, from the last change of the scale */
+	tCount = XGlobalTimer_CountOrigin +
+		 ((tWake - XGlobalTimer_Origin) / XGlobalTimer_Scale);
+	Xil_Out32(GLOBAL_TMR_BASEADDR + GTIMER_COMPARE_LOWER_OFFSET,
+		  (u32)tCount);
+	Xil_Out32(GLOBAL_TMR_BASEADDR + GTIMER_COMPARE_UPPER_OFFSET,
+		  (u32)(tCount >> 32U));
+	Control = Xil_In32(GLOBAL_TMR_BASEADDR + GTIMER_CONTROL_OFFSET);
+	Xil_Out32(GLOBAL_TMR_BASEADDR + GTIMER_CONTROL_OFFSET,
+		  Control | GTIMER_CONTROL_COMP_EN | GTIMER_CONTROL_IRQ_EN);
+
+	/*
+	 * The IRQ is masked from the look at the time to the WFI, so that an
+	 * interrupt in between is pending at the WFI and ends it at once. It
+	 * is taken when the IRQ is unmasked. Other interrupts end the WFI
+	 * too, it is entered again until the time.
+	 */
+	while (1) {
+		XTime_GetTime(&tCur);
+		if (tCur >= tWake) {
+			break;
+		}
+		__asm__ __volatile__ ("wfi" : : : "memory");
+		mtcpsr(Cpsr);
+		mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+	}
+
+	XGlobalTimer_CompareHandler(NULL);
+	mtcpsr(Cpsr);
+}
+
+/*****************************************************************************/
+/**
+ * This function is the handler of the comparator interrupt, it turns the
+ * comparator off
+ *
+ * @param  CallBackRef is not used
+ *
+ * @return	None
+ *
+ ****************************************************************************/
+static void XGlobalTimer_CompareHandler(void *CallBackRef)
+{
+	u32 Control;
+
+	(void) CallBackRef;
+
+	Control = Xil_In32(GLOBAL_TMR_BASEADDR + GTIMER_CONTROL_OFFSET);
+	Xil_Out32(GLOBAL_TMR_BASEADDR + GTIMER_CONTROL_OFFSET,
+		  Control & ~(GTIMER_CONTROL_COMP_EN | GTIMER_CONTROL_IRQ_EN));
+	Xil_Out32(GLOBAL_TMR_BASEADDR + GTIMER_INTR_STS_OFFSET, 0x1U);
+}
+#endif
+
 /****************************************************************************/
 /**
  * Get the time from the Global Timer counter.
@@ -141,6 +300,29 @@ static void XGlobalTimer_ModifyInterval(XTimer *InstancePtr, u32 delay,
  *
  ****************************************************************************/
 void XTime_GetTime(XTime *Xtime_Global)
+{
+	XTime Count;
+	u32 Seq;
+
+	do {
+		Seq = XGlobalTimer_Seq;
+		__asm__ __volatile__ ("dmb" : : : "memory");
+		Count = XGlobalTimer_ReadCount();
+		*Xtime_Global = XGlobalTimer_Origin +
+				((Count - XGlobalTimer_CountOrigin) *
+				 XGlobalTimer_Scale);
+		__asm__ __volatile__ ("dmb" : : : "memory");
+	} while (((Seq & 1U) != 0U) || (Seq != XGlobalTimer_Seq));
+}
+
+/****************************************************************************/
+/**
+ * Read the Global Timer counter, unscaled.
+ *
+ * @return	The 64-bit count.
+ *
+ ****************************************************************************/
+static XTime XGlobalTimer_ReadCount(void)
 {
 	u32 low;
 	u32 high;
@@ -152,7 +334,55 @@ void XTime_GetTime(XTime *Xtime_Global)
 		low = Xil_In32(GLOBAL_TMR_BASEADDR + GTIMER_COUNTER_LOWER_OFFSET);
 	} while(Xil_In32(GLOBAL_TMR_BASEADDR + GTIMER_COUNTER_UPPER_OFFSET) != high);
 
-	*Xtime_Global = (((XTime) high) << 32U) | (XTime) low;
+	return (((XTime) high) << 32U) | (XTime) low;
+}
+
+/****************************************************************************/
+/**
+ * Set the factor the CPU clock is divided by, relative to the clock of
+ * XPAR_CPU_CORE_CLOCK_FREQ_HZ. XTime_GetTime() goes on from the current
+ * time, multiplying the counts from now on by Scale.
+ *
+ * @param	Scale is the factor, 1 for the clock of xparameters.h.
+ *
+ * @return	None.
+ *
+ * @note	Call it with the IRQ masked, right after the change of the
+ *		clock, on one CPU. Times read across the change are off by
+ *		the few counts in between.
+ *
+ ****************************************************************************/
+void XTime_SetScale(u32 Scale)
+{
+	XTime Now;
+	XTime Count;
+
+	if (Scale == 0U) {
+		return;
+	}
+
+	XTime_GetTime(&Now);
+	Count = XGlobalTimer_ReadCount();
+
+	XGlobalTimer_Seq++;
+	__asm__ __volatile__ ("dmb" : : : "memory");
+	XGlobalTimer_Origin = Now;
+	XGlobalTimer_CountOrigin = Count;
+	XGlobalTimer_Scale = Scale;
+	__asm__ __volatile__ ("dmb" : : : "memory");
+	XGlobalTimer_Seq++;
+}
+
+/****************************************************************************/
+/**
+ * Get the factor of XTime_SetScale().
+ *
+ * @return	The factor, 1 unless the CPU clock is divided.
+ *
+ ****************************************************************************/
+u32 XTime_GetScale(void)
+{
+	return XGlobalTimer_Scale;
 }
 
 #endif /* XTIMER_IS_DEFAULT_TIMER */
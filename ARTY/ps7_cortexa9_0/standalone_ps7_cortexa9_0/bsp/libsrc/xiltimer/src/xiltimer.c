@@ -28,12 +28,15 @@
 *  1.3  gm	 21/07/23 Added Timer Release Callback function.
 *  2.0  ml       28/03/24 added description and removed comments to
 *                         fix doxygen warnings.
+*  2.1  qm       14/10/26 Hand the delays to the sleep handler of xil_yield.h
+*                         when one is set.
 * </pre>
 ******************************************************************************/
 
 /***************************** Include Files *********************************/
 #include "xil_io.h"
 #include "sleep.h"
+#include "xil_yield.h"
 #include "xiltimer.h"
 
 /****************************  Constant Definitions  *************************/
@@ -101,6 +104,11 @@ void usleep(unsigned long useconds) {
 void XilTimer_Sleep(unsigned long delay, XTimer_DelayType DelayType) {
 	XTimer *InstancePtr;
 
+	/* A cooperative scheduler runs other tasks meanwhile */
+	if (Xil_YieldSleep(((u64)delay * 1000000U) / (u32)DelayType) != 0U) {
+		return;
+	}
+
 	InstancePtr = &TimerInst;
 	if (InstancePtr->XTimer_ModifyInterval)
 		InstancePtr->XTimer_ModifyInterval(InstancePtr, delay,
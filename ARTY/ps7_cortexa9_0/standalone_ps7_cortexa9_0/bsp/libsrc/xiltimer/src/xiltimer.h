@@ -28,6 +28,7 @@
 *  1.4  ht      09/12/23 Added code for versioning of library.
 *  1.4  mus     15/02/24 Added correct APIs to set/get MB V frequency.
 *  2.0  ml      28/03/24 Added description to fix doxygen warnings.
+*  2.1  qm      14/10/26 Added XTime_SetScale() and XTime_GetScale().
 * </pre>
 ******************************************************************************/
 #ifndef XILTIMER_H
@@ -175,6 +176,13 @@ u32 XilTickTimer_Init(XTimer *InstancePtr);
  * Get the time
  */
 void XTime_GetTime(XTime *Xtime_Global);
+#if defined (__ARM_ARCH_7A__) && defined (XTIMER_IS_DEFAULT_TIMER)
+/**
+ * Scale of the time for a divided CPU clock, see globaltimer_sleep_zynq.c
+ */
+void XTime_SetScale(u32 Scale);
+u32 XTime_GetScale(void);
+#endif
 void XTimer_SetInterval(unsigned long delay);
 void XTimer_SetHandler(XTimer_TickHandler FuncPtr, void *CallBackRef,
 		       u8 Priority);
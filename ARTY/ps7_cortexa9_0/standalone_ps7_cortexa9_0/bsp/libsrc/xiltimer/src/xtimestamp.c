@@ -0,0 +1,143 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file xtimestamp.c
+* @addtogroup xiltimer_api XilTimer APIs
+*
+* This file contains the conversion factors of the timestamps. Refer to
+* xtimestamp.h for more details.
+* @{
+* @details
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who      Date     Changes
+* ----- -------- -------- -----------------------------------------------
+*  2.1  qm       14/10/26 First release.
+*       qm       14/10/26 Added XTimestamp_SetScale().
+* </pre>
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "xtimestamp.h"
+
+/****************************  Constant Definitions  *************************/
+/* PMCR enable and PMCNTENSET cycle counter bits */
+#define XTIMESTAMP_PMCR_E	0x1U
+#define XTIMESTAMP_PMCR_D	0x8U
+#define XTIMESTAMP_PMCNTEN_C	0x80000000U
+
+/* The CPU is clocked at twice the global timer */
+#define XTIMESTAMP_CPU_HZ	((u64)COUNTS_PER_SECOND * 2U)
+
+XTimestamp_Factor XTimestamp_Ns;
+XTimestamp_Factor XTimestamp_Us;
+XTimestamp_Factor XTimestamp_UsToCounts;
+XTimestamp_Factor XTimestamp_CycleNs;
+
+/****************************************************************************/
+/**
+*
+* This API works out a factor converting From units into To units, with
+* the largest shift up to 32 that keeps the multiplier in 32 bits.
+*
+* @param            FactorPtr is the factor
+* @param            To is the number of To units in a period
+* @param            From is the number of From units in the same period
+*
+* @return           none
+*
+* @note             Ratios above 2^32 are not supported.
+*
+*****************************************************************************/
+void XTimestamp_SetFactor(XTimestamp_Factor *FactorPtr, u64 To, u64 From)
+{
+	u64 Mult;
+	u32 Shift;
+
+	for (Shift = 32U; Shift > 0U; Shift--) {
+		/* To and From are below 2^32, To << 32 does not overflow */
+		Mult = ((To << Shift) + (From / 2U)) / From;
+		if (Mult <= 0xFFFFFFFFU) {
+			break;
+		}
+	}
+
+	FactorPtr->Mult = (u32)Mult;
+	FactorPtr->Shift = Shift;
+}
+
+/****************************************************************************/
+/**
+*
+* This API works out the conversion factors from COUNTS_PER_SECOND. It is
+* called before main().
+*
+* @return           none
+*
+*****************************************************************************/
+void __attribute__ ((constructor)) XTimestamp_Init(void)
+{
+	XTimestamp_SetScale(1U);
+}
+
+/****************************************************************************/
+/**
+*
+* This API works out the conversion factors again for a CPU clock divided
+* by Scale, relative to the clock of COUNTS_PER_SECOND, which divides the
+* global timer and the cycle counter alike.
+*
+* @param            Scale is the factor, 1 for the clock of xparameters.h
+*
+* @return           none
+*
+* @note             Intervals measured across the change are not converted
+*                   correctly.
+*
+*****************************************************************************/
+void XTimestamp_SetScale(u32 Scale)
+{
+	u64 Counts;
+
+	if (Scale == 0U) {
+		return;
+	}
+
+	Counts = (u64)COUNTS_PER_SECOND / Scale;
+	XTimestamp_SetFactor(&XTimestamp_Ns, 1000000000U, Counts);
+	XTimestamp_SetFactor(&XTimestamp_Us, 1000000U, Counts);
+	XTimestamp_SetFactor(&XTimestamp_UsToCounts, Counts, 1000000U);
+	XTimestamp_SetFactor(&XTimestamp_CycleNs, 1000000000U,
+			     XTIMESTAMP_CPU_HZ / Scale);
+}
+
+/****************************************************************************/
+/**
+*
+* This API starts the PMU cycle counter of the calling CPU, counting every
+* cycle. The event counters are left alone.
+*
+* @return           none
+*
+* @note             Call it on each CPU that reads XTimestamp_Cycles().
+*
+*****************************************************************************/
+void XTimestamp_EnableCycles(void)
+{
+	u32 Reg;
+
+	__asm__ __volatile__ ("mrc p15, 0, %0, c9, c12, 0" : "=r" (Reg));
+	Reg = (Reg | XTIMESTAMP_PMCR_E) & ~XTIMESTAMP_PMCR_D;
+	__asm__ __volatile__ ("mcr p15, 0, %0, c9, c12, 0" : : "r" (Reg));
+	__asm__ __volatile__ ("mcr p15, 0, %0, c9, c12, 1" : :
+			      "r" (XTIMESTAMP_PMCNTEN_C));
+}
+/**
+* @} End of "addtogroup xiltimer_api".
+*/
@@ -0,0 +1,222 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xtimestamp.h
+* @addtogroup xiltimer_api XilTimer APIs
+* @{
+* @details
+*
+* Cheap timestamps for instrumentation on the Cortex-A9.
+*
+* XTimestamp_Now() reads the 64-bit global timer inline, with the same
+* retry on a carry as XTime_GetTime(), and XTimestamp_Now32() its low word
+* only, for intervals under the 12 s the low word wraps in. The global timer
+* is a single counter in the SCU, so timestamps taken on CPU0 and CPU1 are
+* on the same time base and can be compared or subtracted directly.
+*
+* XTimestamp_ToNs(), XTimestamp_ToUs() and XTimestamp_FromUs() convert
+* with a multiply and a shift by factors worked out from COUNTS_PER_SECOND
+* before main(), instead of a 64-bit division.
+*
+* XTimestamp_Cycles() reads the PMU cycle counter of the calling CPU, one
+* count per CPU clock, after XTimestamp_EnableCycles() on that CPU. It is
+* the cheapest clock but is per CPU and 32 bits wide, wrapping in 6 s;
+* XTimestamp_CyclesToNs() converts its intervals.
+*
+* When the CPU clock is divided at run time, XTimestamp_SetScale() works out
+* the factors again. The counts of XTimestamp_Now() are then fewer per
+* second, unlike the scaled time of XTime_GetTime(), so the two are not
+* compared after the change.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -------------------------------------------------------
+*  2.1  qm   14/10/26 First release.
+*       qm   14/10/26 Added XTimestamp_SetScale().
+* </pre>
+*
+******************************************************************************/
+
+#ifndef XTIMESTAMP_H
+#define XTIMESTAMP_H
+
+#include "xil_types.h"
+#include "xil_io.h"
+#include "xiltimer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************** Constant Definitions *****************************/
+
+#define XTIMESTAMP_GTIMER_BASEADDR	0xF8F00200U
+#define XTIMESTAMP_GTIMER_LOWER		0x00U
+#define XTIMESTAMP_GTIMER_UPPER		0x04U
+
+/**************************** Type Definitions *******************************/
+
+/**
+ * Converts a count as (Count * Mult) >> Shift.
+ */
+typedef struct {
+	u32 Mult;
+	u32 Shift;
+} XTimestamp_Factor;
+
+/************************** Variable Definitions *****************************/
+
+extern XTimestamp_Factor XTimestamp_Ns;		/**< Global timer to ns */
+extern XTimestamp_Factor XTimestamp_Us;		/**< Global timer to us */
+extern XTimestamp_Factor XTimestamp_UsToCounts;	/**< us to global timer */
+extern XTimestamp_Factor XTimestamp_CycleNs;	/**< CPU cycles to ns */
+
+/****************** Macros (Inline Functions) Definitions *********************/
+
+/*****************************************************************************/
+/**
+*
+* @brief	Scales a 64-bit count by a factor, without overflow for any
+*		count whose result fits 64 bits.
+*
+* @param	Count is the count.
+* @param	FactorPtr is the factor.
+*
+* @return	(Count * Mult) >> Shift
+*
+******************************************************************************/
+static __attribute__((always_inline)) INLINE
+u64 XTimestamp_Scale(u64 Count, const XTimestamp_Factor *FactorPtr)
+{
+	u64 High = (Count >> 32U) * FactorPtr->Mult;
+	u64 Low = (Count & 0xFFFFFFFFU) * FactorPtr->Mult;
+
+	return (High << (32U - FactorPtr->Shift)) + (Low >> FactorPtr->Shift);
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Reads the global timer.
+*
+* @return	The 64-bit count, COUNTS_PER_SECOND per second.
+*
+******************************************************************************/
+static __attribute__((always_inline)) INLINE
+u64 XTimestamp_Now(void)
+{
+	u32 High;
+	u32 Low;
+
+	do {
+		High = Xil_In32(XTIMESTAMP_GTIMER_BASEADDR +
+				XTIMESTAMP_GTIMER_UPPER);
+		Low = Xil_In32(XTIMESTAMP_GTIMER_BASEADDR +
+			       XTIMESTAMP_GTIMER_LOWER);
+	} while (Xil_In32(XTIMESTAMP_GTIMER_BASEADDR +
+			  XTIMESTAMP_GTIMER_UPPER) != High);
+
+	return ((u64)High << 32U) | Low;
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Reads the low word of the global timer, a single access.
+*
+* @return	The low 32 bits of the count.
+*
+******************************************************************************/
+static __attribute__((always_inline)) INLINE
+u32 XTimestamp_Now32(void)
+{
+	return Xil_In32(XTIMESTAMP_GTIMER_BASEADDR + XTIMESTAMP_GTIMER_LOWER);
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Reads the PMU cycle counter of the calling CPU.
+*
+* @return	The cycle count, 0 unless XTimestamp_EnableCycles() was
+*		called on this CPU.
+*
+******************************************************************************/
+static __attribute__((always_inline)) INLINE
+u32 XTimestamp_Cycles(void)
+{
+	u32 Cycles;
+
+	__asm__ __volatile__ ("mrc p15, 0, %0, c9, c13, 0" : "=r" (Cycles));
+
+	return Cycles;
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Converts global timer counts to nanoseconds.
+*
+******************************************************************************/
+static __attribute__((always_inline)) INLINE
+u64 XTimestamp_ToNs(u64 Counts)
+{
+	return XTimestamp_Scale(Counts, &XTimestamp_Ns);
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Converts global timer counts to microseconds.
+*
+******************************************************************************/
+static __attribute__((always_inline)) INLINE
+u64 XTimestamp_ToUs(u64 Counts)
+{
+	return XTimestamp_Scale(Counts, &XTimestamp_Us);
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Converts microseconds to global timer counts.
+*
+******************************************************************************/
+static __attribute__((always_inline)) INLINE
+u64 XTimestamp_FromUs(u64 Us)
+{
+	return XTimestamp_Scale(Us, &XTimestamp_UsToCounts);
+}
+
+/*****************************************************************************/
+/**
+*
+* @brief	Converts CPU cycles to nanoseconds.
+*
+******************************************************************************/
+static __attribute__((always_inline)) INLINE
+u64 XTimestamp_CyclesToNs(u32 Cycles)
+{
+	return XTimestamp_Scale(Cycles, &XTimestamp_CycleNs);
+}
+
+/************************** Function Prototypes ******************************/
+
+void XTimestamp_Init(void);
+void XTimestamp_SetScale(u32 Scale);
+void XTimestamp_EnableCycles(void);
+void XTimestamp_SetFactor(XTimestamp_Factor *FactorPtr, u64 To, u64 From);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XTIMESTAMP_H */
+/**
+* @} End of "addtogroup xiltimer_api".
+*/
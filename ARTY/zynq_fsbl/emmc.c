@@ -0,0 +1,309 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file emmc.c
+*
+* Contains the raw eMMC boot path of FSBL_EMMC_RAW, refer to emmc.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "xparameters.h"
+#include "fsbl.h"
+
+#if defined(FSBL_EMMC_RAW) && (defined(XPAR_PS7_SD_0_S_AXI_BASEADDR) || \
+	defined(XPAR_XSDPS_0_BASEADDR))
+
+#ifndef XPAR_PS7_SD_0_S_AXI_BASEADDR
+#define XPAR_PS7_SD_0_S_AXI_BASEADDR XPAR_XSDPS_0_BASEADDR
+#endif
+
+#include <string.h>
+#include "xstatus.h"
+#include "xsdps.h"
+#include "emmc.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * PARTITION_CONFIG byte of the EXT_CSD, and the CMD6 argument that writes
+ * it: access mode 3, write byte
+ */
+#define EMMC_EXT_CSD_PART_CONFIG	179U
+#define EMMC_PART_ACCESS_MASK		0x07U
+#define EMMC_SWITCH_WRITE_BYTE		0x03000000U
+#define EMMC_SWITCH_ARG(Index, Value)	(EMMC_SWITCH_WRITE_BYTE | \
+					((u32)(Index) << 16) | \
+					((u32)(Value) << 8))
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+
+static u32 EmmcSelectPartition(u8 Partition);
+static u32 EmmcReadBlocks(u32 Block, u32 Count, u8 *BufferPtr);
+
+/************************** Variable Definitions *****************************/
+
+extern u32 FlashReadBaseAddress;
+
+static XSdPs EmmcInstance;
+
+/*
+ * Block of the ends of unaligned reads, and the EXT_CSD
+ */
+static u8 EmmcBlock[EMMC_BLOCK_SIZE] __attribute__ ((aligned(32)));
+
+/* Partition selected by InitEmmc, that ReleaseEmmc switches back from */
+static u8 EmmcPartition;
+
+/******************************************************************************/
+/**
+*
+* This function initializes the controller and the eMMC, and selects the
+* partition that holds the boot image.
+*
+* @param	None
+*
+* @return
+*		- XST_SUCCESS if the eMMC initializes correctly
+*		- XST_FAILURE if the controller or the eMMC fails to initialize,
+*		  or the partition cannot be selected
+*
+* @note		None.
+*
+****************************************************************************/
+u32 InitEmmc(void)
+{
+	XSdPs_Config *ConfigPtr;
+	s32 Status;
+	u8 HostCtrl;
+	u32 Width;
+
+#ifndef SDT
+	ConfigPtr = XSdPs_LookupConfig(XPAR_XSDPS_0_DEVICE_ID);
+#else
+	ConfigPtr = XSdPs_LookupConfig(XPAR_PS7_SD_0_S_AXI_BASEADDR);
+#endif
+	if (ConfigPtr == NULL) {
+		fsbl_printf(DEBUG_GENERAL,"eMMC: No controller\r\n");
+		return XST_FAILURE;
+	}
+
+	EmmcInstance.IsReady = 0U;
+	Status = XSdPs_CfgInitialize(&EmmcInstance, ConfigPtr,
+			ConfigPtr->BaseAddress);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL,"eMMC: Controller init failed\r\n");
+		return XST_FAILURE;
+	}
+
+	/*
+	 * Identifies the device and switches it to the widest bus and the
+	 * fastest timing the host supports
+	 */
+	Status = XSdPs_CardInitialize(&EmmcInstance);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL,"eMMC: Device init failed\r\n");
+		return XST_FAILURE;
+	}
+
+	HostCtrl = XSdPs_ReadReg8(ConfigPtr->BaseAddress,
+			XSDPS_HOST_CTRL1_OFFSET);
+	if ((HostCtrl & XSDPS_HC_EXT_BUS_WIDTH) != 0U) {
+		Width = 8U;
+	} else if ((HostCtrl & XSDPS_HC_WIDTH_MASK) != 0U) {
+		Width = 4U;
+	} else {
+		Width = 1U;
+	}
+	fsbl_printf(DEBUG_INFO,"eMMC: %lu bit bus, %lu kHz%s\n\r", Width,
+			EmmcInstance.BusSpeed / 1000U,
+			((HostCtrl & XSDPS_HC_SPEED_MASK) != 0U) ?
+			", high speed" : "");
+
+	EmmcPartition = 0U;
+	if (EmmcSelectPartition((u8)FSBL_EMMC_PARTITION) != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL,"eMMC: Unable to select partition %d\r\n",
+				FSBL_EMMC_PARTITION);
+		return XST_FAILURE;
+	}
+	EmmcPartition = (u8)FSBL_EMMC_PARTITION;
+
+	fsbl_printf(DEBUG_INFO,"eMMC: Image at block %d of partition %d\r\n",
+			FSBL_EMMC_BLOCK, FSBL_EMMC_PARTITION);
+
+	FlashReadBaseAddress = XPAR_PS7_SD_0_S_AXI_BASEADDR;
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function provides the eMMC interface for the Simplified header
+* functionality.
+*
+* @param	SourceAddress is the byte offset in the boot image
+* @param	DestinationAddress is address in OCM or DDR data space
+* @param	LengthBytes is the number of bytes to move
+*
+* @return
+*		- XST_SUCCESS if the read completes correctly
+*		- XST_FAILURE if the read fails to complete correctly
+*
+* @note		The whole blocks of a word aligned destination are read into
+*		it, the rest through EmmcBlock.
+*
+****************************************************************************/
+u32 EmmcAccess(u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
+{
+	u8 *DestPtr = (u8 *)DestinationAddress;
+	u32 Block = FSBL_EMMC_BLOCK + (SourceAddress / EMMC_BLOCK_SIZE);
+	u32 Offset = SourceAddress % EMMC_BLOCK_SIZE;
+	u32 Count;
+	u32 Len;
+
+	while (LengthBytes > 0U) {
+		if ((Offset != 0U) || (LengthBytes < EMMC_BLOCK_SIZE) ||
+		    (((UINTPTR)DestPtr & 0x3U) != 0U)) {
+			/*
+			 * Part of a block, or an unaligned destination
+			 */
+			if (EmmcReadBlocks(Block, 1U, EmmcBlock) != XST_SUCCESS) {
+				return XST_FAILURE;
+			}
+			Len = EMMC_BLOCK_SIZE - Offset;
+			if (Len > LengthBytes) {
+				Len = LengthBytes;
+			}
+			memcpy(DestPtr, &EmmcBlock[Offset], Len);
+			Offset = 0U;
+			Block++;
+		} else {
+			Count = LengthBytes / EMMC_BLOCK_SIZE;
+			if (Count > EMMC_MAX_READ_BLKS) {
+				Count = EMMC_MAX_READ_BLKS;
+			}
+			if (EmmcReadBlocks(Block, Count, DestPtr) != XST_SUCCESS) {
+				return XST_FAILURE;
+			}
+			Len = Count * EMMC_BLOCK_SIZE;
+			Block += Count;
+		}
+
+		DestPtr += Len;
+		LengthBytes -= Len;
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function switches the eMMC back to its user area.
+*
+* @param	None
+*
+* @return	None.
+*
+* @note		None.
+*
+****************************************************************************/
+void ReleaseEmmc(void)
+{
+	if (EmmcPartition != 0U) {
+		(void)EmmcSelectPartition(0U);
+		EmmcPartition = 0U;
+	}
+}
+
+/******************************************************************************/
+/**
+*
+* This function selects the partition the reads go to, keeping the boot
+* enable bits of the PARTITION_CONFIG byte.
+*
+* @param	Partition is 0 for the user area, 1 or 2 for a boot partition
+*
+* @return	XST_SUCCESS, or XST_FAILURE if the EXT_CSD cannot be read or
+*		written
+*
+* @note		The partition already selected is not switched again.
+*
+****************************************************************************/
+static u32 EmmcSelectPartition(u8 Partition)
+{
+	u8 Config;
+
+	if (XSdPs_Get_Mmc_ExtCsd(&EmmcInstance, EmmcBlock) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Config = EmmcBlock[EMMC_EXT_CSD_PART_CONFIG];
+	if ((Config & EMMC_PART_ACCESS_MASK) == Partition) {
+		return XST_SUCCESS;
+	}
+
+	Config = (Config & (u8)~EMMC_PART_ACCESS_MASK) | Partition;
+	if (XSdPs_Set_Mmc_ExtCsd(&EmmcInstance,
+			EMMC_SWITCH_ARG(EMMC_EXT_CSD_PART_CONFIG, Config)) !=
+			XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function reads whole blocks, byte addressed on a standard capacity
+* device.
+*
+* @param	Block is the first block
+* @param	Count is the number of blocks, EMMC_MAX_READ_BLKS at most
+* @param	BufferPtr is the word aligned destination
+*
+* @return	XST_SUCCESS, or XST_FAILURE if the read fails
+*
+* @note		None.
+*
+****************************************************************************/
+static u32 EmmcReadBlocks(u32 Block, u32 Count, u8 *BufferPtr)
+{
+	u32 Address = Block;
+	s32 Status;
+
+	if (EmmcInstance.HCS == 0U) {
+		Address = Block * EMMC_BLOCK_SIZE;
+	}
+
+	Status = XSdPs_ReadPolled(&EmmcInstance, Address, Count, BufferPtr);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL,"eMMC: Read of %lu blocks at %lu "
+				"failed\r\n", Count, Block);
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+#endif
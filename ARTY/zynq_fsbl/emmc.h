@@ -0,0 +1,86 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file emmc.h
+*
+* This file contains the raw eMMC boot path of FSBL_EMMC_RAW.
+*
+* With MMC_SUPPORT the boot image is read from BOOT.BIN on a FAT volume of
+* the MMC, through FatFs. With FSBL_EMMC_RAW too, the boot image is read
+* from the eMMC by block address instead, with no file system: it starts at
+* block FSBL_EMMC_BLOCK of the partition FSBL_EMMC_PARTITION, the user area
+* (0) or the boot partition 1 or 2, and the source addresses of the image
+* mover are byte offsets from there, as in the file. The reads go straight
+* to their destination in multi-block ADMA2 transfers of up to
+* EMMC_MAX_READ_BLKS blocks; only the blocks at the ends of a read that is
+* not on a block, or a destination that is not word aligned, go through a
+* block in OCM.
+*
+* The bus width and speed are the widest and fastest the host and the
+* device share, negotiated by XSdPs_CardInitialize(): an 8 bit bus where
+* the controller has one, and the high speed timing of the device, 52 MHz.
+* InitEmmc() prints them.
+*
+* ReleaseEmmc() switches the device back to the user area before the
+* handoff.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef ___EMMC_H___
+#define ___EMMC_H___
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Where the boot image starts
+ */
+#ifndef FSBL_EMMC_PARTITION
+#define FSBL_EMMC_PARTITION	0	/* User area, 1 and 2 boot partitions */
+#endif
+#ifndef FSBL_EMMC_BLOCK
+#define FSBL_EMMC_BLOCK		0
+#endif
+
+#define EMMC_BLOCK_SIZE		512
+#define EMMC_MAX_READ_BLKS	4096	/* 32 ADMA2 descriptors of 64 KB */
+
+/************************** Function Prototypes ******************************/
+
+#if defined(FSBL_EMMC_RAW) && (defined(XPAR_PS7_SD_0_S_AXI_BASEADDR) || \
+	defined(XPAR_XSDPS_0_BASEADDR))
+u32 InitEmmc(void);
+
+u32 EmmcAccess(u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes);
+
+void ReleaseEmmc(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ___EMMC_H___ */
@@ -295,6 +295,216 @@
 * Note : Changing the default behaviour is not recommended from
 * Security perspective.
 *
+* FSBL_PCAP_INTR
+* The PCAP transfers complete on the devcfg interrupt through the GIC,
+* instead of polling the devcfg registers. PcapLoadPartitionStart() then
+* lets FSBL do other work while a bitstream is loaded.
+* By default this flag is unset/undefined.
+*
+* FSBL_QSPI_TUNE
+* In linear mode, FSBL calibrates the QSPI clock prescaler, the feedback
+* clock and the dummy bytes of the read command against the boot header and
+* keeps the fastest setting that reads it back intact, see QspiTune(). The
+* setting is kept in the reboot status register, so that soft resets only
+* check it again.
+* By default this flag is unset/undefined.
+*
+* FSBL_CPU1_WORKER
+* FSBL wakes CPU1 to calculate the checksum of each plain PS partition while
+* CPU0 moves the next partition, see fsbl_cpu1.h. CPU1 is sent back to the
+* Boot ROM wait loop before handoff. Single core devices and signed or
+* encrypted partitions are checked on CPU0 as before.
+* By default this flag is unset/undefined.
+*
+* FSBL_IMAGE_INDEX
+* On fallback, FSBL checks the images listed in the image index the
+* application keeps in a reserved flash sector before it searches the flash,
+* see fsbl_image_index.h. FSBL_IMAGE_INDEX_OFFSET sets the flash offset of
+* the index, the last 64 KB of the boot device by default.
+* By default this flag is unset/undefined.
+*
+* FSBL_TIMELINE
+* FSBL records the start and the end of each boot stage with a global timer
+* timestamp, in a record the application can read from the high OCM after
+* handoff, see fsbl_timeline.h. With FSBL_TIMELINE_UART it is also written
+* in binary to the UART before handoff.
+* By default this flag is unset/undefined.
+*
+* FSBL_NOR_PAGE
+* FSBL reads the page size of the NOR flash from its CFI query table and
+* switches the SMC to asynchronous page mode reads of that size, see
+* NorPageMode(). The boot header is read back at the new setting, and the
+* boot setting is restored if it differs.
+* By default this flag is unset/undefined.
+*
+* FSBL_MD5_BENCH
+* FSBL times the MD5 checksum of partitions on MD5_BENCH_LENGTH bytes of DDR
+* after the DDR check, for the in place and the copying versions of
+* MD5Update, and prints the results at the DEBUG_GENERAL level.
+* By default this flag is unset/undefined.
+*
+* FSBL_LZ4
+* Partitions with the ATTRIBUTE_COMPRESSED_MASK bit set in their attributes
+* hold an LZ4 frame, which FSBL decompresses while it reads the partition
+* from the boot device. PS partitions are decompressed to the load address.
+* Bitstreams are decompressed to the DDR temporary location and streamed to
+* the PCAP block by block, and are best compressed with 64 KB blocks
+* (lz4 -B4) so that the PCAP takes a block while the next one is decoded.
+* The partition checksum is calculated on the compressed partition, as
+* bootgen does. Compressed partitions cannot be encrypted or signed. Without
+* the flag, a compressed partition fails the boot.
+* By default this flag is unset/undefined.
+*
+* FSBL_PL_FAST
+* Fast load of trusted bitstreams. A bitstream that is neither encrypted nor
+* signed is checked only by the PL against the CRC it carries, the partition
+* checksum is not calculated. The end of the load is polled quietly with a
+* sleep doubling up to PCAP_POLL_MAX_DELAY_US, or waited for by interrupt
+* with FSBL_PCAP_INTR. The level shifter setup and the PL power check of
+* FabricInit() are done for the first bitstream only.
+* By default this flag is unset/undefined.
+*
+* FSBL_EARLY_FLASH
+* ps7_init returns without waiting for the DDR controller to initialize the
+* DRAM, see DDRDeferInitPoll(). The PCAP, the watchdog and the boot device
+* are set up from OCM while the DRAM comes up, and the DDR is waited for and
+* tested just before the boot image is loaded. The boot of SD cards gains
+* most, their initialization taking the longest.
+* By default this flag is unset/undefined.
+*
+* FSBL_DCACHE
+* FSBL keeps the L1 and L2 data caches enabled, with the MMU table of the
+* BSP, instead of disabling them at start. The copies, checksums and header
+* reads run cached. The buffers of the PCAP and the DMA are flushed and
+* invalidated around each transfer, see FSBL_DCACHE_FLUSH(), and the cache
+* is cleaned and disabled before the handoff. The CPU1 checksum offload of
+* FSBL_CPU1_WORKER is not used, CPU1 running uncached.
+* By default this flag is unset/undefined.
+*
+* FSBL_DDR_TEST
+* After the sanity check of DDRInitCheck(), the DDR is tested at
+* FSBL_DDR_TEST_BLOCKS places with a NEON March C- while the PS DMA fills and
+* copies, see fsbl_ddr_test.h. The failing words and data bits are printed
+* and the boot falls back as for DDR_INIT_FAIL. The 1 MB of the default
+* blocks takes a few milliseconds.
+* By default this flag is unset/undefined.
+*
+* FSBL_WARM_BOOT
+* After a watchdog or software reset, the plain PS partitions that are still
+* in DDR as the previous boot loaded and validated them are used as they
+* are, instead of being read and checksummed again, see fsbl_warm.h. The
+* DDR test of FSBL_DDR_TEST is not run on such a reset.
+* By default this flag is unset/undefined.
+*
+* FSBL_PS7_PACK
+* ps7_init and ps7_post_config are replayed from the packed tables that the
+* build makes of ps7_init.c with tools/ps7_pack.py, see ps7_pack.h. Runs of
+* consecutive registers share one address, full mask writes skip their
+* read, and the tables take about a quarter less OCM. python3 must be found
+* by CMake.
+* By default this flag is unset/undefined.
+*
+* FSBL_HANDOFF_CACHED
+* With FSBL_DCACHE, the handoff to the application leaves the MMU, the L1
+* and L2 caches and the branch predictor enabled, the data cache cleaned to
+* memory but still holding the partitions just loaded, and passes "FSBC" in
+* r1. The boot.S of the application BSP then keeps them as they are instead
+* of invalidating and setting them up again, switching to its own
+* translation table with the MMU on, and its first accesses hit in the
+* caches. The JTAG handoff is not changed.
+* By default this flag is unset/undefined.
+*
+* FSBL_AES_STREAM
+* An encrypted PS partition without checksum or signature, on a non-linear
+* boot device, is decrypted by the PCAP in chunks of PCAP_STREAM_CHUNK_WORDS
+* while the next chunk is read, see PcapStreamDecrypt(), instead of being
+* read whole and then decrypted. Partitions with a checksum or a signature
+* are still validated before they are decrypted.
+* By default this flag is unset/undefined.
+*
+* FSBL_AUTH_BATCH
+* With RSA_SUPPORT, once the image header is authenticated the certificates
+* of all signed partitions are read and their SPKs authenticated in one pass,
+* see AuthenticateSpk(), before any partition is loaded. A bad SPK falls
+* back at once instead of after the partitions ahead of it are loaded, and
+* each partition then only has its own signature checked.
+* By default this flag is unset/undefined.
+*
+* FSBL_PANIC
+* On a failed boot, ErrorLockdown() writes the registers, the stacks and the
+* boot timeline to a reserved, erased region of the QSPI flash with page
+* programs before the fallback, see fsbl_panic.h. The first dump is kept
+* until the region is erased again from the host.
+* By default this flag is unset/undefined.
+*
+* FSBL_MD5_BATCH
+* The checksums of plain PS partitions that were not hashed as they were
+* moved are calculated MD5_LANES at a time with the NEON multi-buffer MD5 of
+* md5x4(), once that many are staged in DDR, before a partition is moved
+* over one of them, and at the end of the image, see ChecksumBatchAdd().
+* Their checksums are read from the image header cache when it holds them.
+* With FSBL_CPU1_WORKER, the partitions CPU1 does not take are batched.
+* By default this flag is unset/undefined.
+*
+* FSBL_QSPI_XIP
+* On a linear QSPI boot, a plain PS partition whose load address is in the
+* linear QSPI window, at the window address of the partition itself, is
+* not copied: the application executes it in place, cacheable, see
+* XipPartitionCheck(). Only its checksum, if any, is calculated, reading
+* it through the window. The application links its cold code there with
+* _QSPI_XIP, the rest of the image is loaded to DDR as before. Without the
+* flag, a partition loaded in the window fails the boot.
+* By default this flag is unset/undefined.
+*
+* FSBL_DEFERRED
+* On a linear boot device, a plain PS partition with the
+* ATTRIBUTE_DEFERRED_MASK bit set in its attributes is not loaded: it is
+* listed in a handoff table in the high OCM, for the application to load it
+* in the background once it runs, see fsbl_deferred.h. The partition does
+* not give the handoff address. Without the flag, the bit is ignored and
+* the partition is loaded at boot.
+* By default this flag is unset/undefined.
+*
+* FSBL_MANIFEST
+* A PS partition loaded at FSBL_MANIFEST_ADDR, first after FSBL and signed
+* or checksummed, is the boot manifest of tools/boot_manifest.py: the
+* SHA-256 of each chunk of the plain PS partitions after it, under a root
+* that its signature or checksum covers, see fsbl_manifest.h. These
+* partitions are read chunk by chunk and each chunk checked as soon as it
+* lands, on CPU1 with FSBL_CPU1_WORKER or CPU0, while the next is read, a
+* bad chunk failing the boot at once. Their MD5 checksums are not used.
+* By default this flag is unset/undefined.
+*
+* FSBL_RESUME
+* After a system reset of an application suspended to RAM, with the
+* FSBL_RESUME_MASK bit of the reboot status register set, and once the DDR
+* is up, FSBL checks the resume record left in the high OCM and the sum of
+* the state it points to in DDR, and jumps to its resume vector instead of
+* loading the boot image, see fsbl_resume.h. Without a valid record the
+* boot goes on as a cold boot. The PL is not configured on a resume.
+* By default this flag is unset/undefined.
+*
+* FSBL_EMMC_RAW
+* With MMC_SUPPORT, the boot image is read from the eMMC by block address,
+* from block FSBL_EMMC_BLOCK of the partition FSBL_EMMC_PARTITION, instead
+* of from BOOT.BIN on a FAT volume, in multi-block reads on the widest bus
+* and the fastest timing the controller and the device share, see emmc.h.
+* By default this flag is unset/undefined.
+*
+* FSBL_PROFILE_QSPI, FSBL_PROFILE_SD, FSBL_PROFILE_NAND, FSBL_PROFILE_NOR,
+* FSBL_PROFILE_JTAG
+* Footprint profiles. When one or more of them are set, FSBL is built for
+* those boot devices only: the drivers of the others are left out of the
+* build, see CMakeLists.txt, and their boot modes fall back as a device
+* missing from the design. FSBL_PROFILE_JTAG alone keeps none of them. The
+* OCM left free goes to the buffers of the devices kept: the image header
+* cache is IMAGE_HEADER_CACHE_SIZE 16 KB instead of 4 KB, the cluster link
+* map of SD has SD_CLMT_SIZE 512 items instead of 64 and the bad block map
+* of NAND NAND_MAX_BAD_BLOCKS 1024 blocks instead of 256. Each of these can
+* still be set on its own.
+* By default these flags are unset/undefined, all the devices of the design
+* are built in.
+*
 *******************************************************************************/
 #ifndef XIL_FSBL_H
 #define XIL_FSBL_H
@@ -311,6 +521,9 @@ extern "C" {
 #include "pcap.h"
 #include "fsbl_debug.h"
 #include "ps7_init.h"
+#ifdef FSBL_DCACHE
+#include "xil_cache.h"
+#endif
 #ifdef FSBL_PERF
 #ifndef SDT
 #include "xtime_l.h"
@@ -320,6 +533,35 @@ extern "C" {
 #include <stdio.h>
 #endif
 
+/*
+ * Footprint profile, the devices not in it are taken out of the design
+ */
+#if defined(FSBL_PROFILE_QSPI) || defined(FSBL_PROFILE_SD) || \
+	defined(FSBL_PROFILE_NAND) || defined(FSBL_PROFILE_NOR) || \
+	defined(FSBL_PROFILE_JTAG)
+#define FSBL_PROFILE
+#ifndef FSBL_PROFILE_QSPI
+#undef XPAR_PS7_QSPI_LINEAR_0_S_AXI_BASEADDR
+#undef XPAR_PS7_QSPI_LINEAR_0_BASEADDRESS
+#endif
+#ifndef FSBL_PROFILE_SD
+#undef XPAR_PS7_SD_0_S_AXI_BASEADDR
+#undef XPAR_XSDPS_0_BASEADDR
+#endif
+#ifndef FSBL_PROFILE_NAND
+#undef XPAR_PS7_NAND_0_BASEADDR
+#undef XPAR_XNANDPS_0_FLASHBASE
+#endif
+#endif
+
+/*
+ * NOR has no instance in the design, it is built in unless a profile
+ * leaves it out
+ */
+#if !defined(FSBL_PROFILE) || defined(FSBL_PROFILE_NOR)
+#define FSBL_NOR_BOOT
+#endif
+
 
 /************************** Constant Definitions *****************************/
 /*
@@ -437,6 +679,7 @@ extern "C" {
 
 #define RESET_REASON_SRST		0x00000020 /**< Reason for reset is SRST */
 #define RESET_REASON_SWDT		0x00000001 /**< Reason for reset is SWDT */
+#define RESET_REASON_POR		0x00000040 /**< Reason for reset is POR */
 
 /*
  * Golden image offset
@@ -481,6 +724,36 @@ extern "C" {
  */
 #define DDR_TEST_PATTERN	0xAA55AA55
 #define DDR_TEST_OFFSET		0x100000
+/*
+ * DDR controller operating mode, polled by FSBL_EARLY_FLASH
+ */
+#define DDRC_MODE_STS_REG	0xF8006054
+#define DDRC_MODE_STS_MASK	0x7
+#define DDR_INIT_POLL_COUNT	100000000
+
+/*
+ * Data cache maintenance of the buffers the PCAP and the DMA share with
+ * the CPU, with FSBL_DCACHE. Only DDR and OCM below FSBL_DCACHE_MEM_END are
+ * written by the CPU, the flash windows need none.
+ */
+#define FSBL_DCACHE_MEM_END	0x40000000
+#ifdef FSBL_DCACHE
+#define FSBL_DCACHE_FLUSH(Addr, Len)					\
+	do {								\
+		if ((u32)(Addr) < FSBL_DCACHE_MEM_END) {		\
+			Xil_DCacheFlushRange((INTPTR)(Addr), (Len));	\
+		}							\
+	} while (0)
+#define FSBL_DCACHE_INVALIDATE(Addr, Len)				\
+	do {								\
+		if ((u32)(Addr) < FSBL_DCACHE_MEM_END) {		\
+			Xil_DCacheInvalidateRange((INTPTR)(Addr), (Len)); \
+		}							\
+	} while (0)
+#else
+#define FSBL_DCACHE_FLUSH(Addr, Len)
+#define FSBL_DCACHE_INVALIDATE(Addr, Len)
+#endif
 /*
  *
  */
@@ -516,10 +789,15 @@ extern "C" {
 /* Reboot status register defines:
  * 0xF0000000 for FSBL fallback mask to notify Boot Rom
  * 0x60000000 for FSBL to mark that FSBL has not handoff yet
+ * 0x0F000000 for the QSPI read setting of FSBL_QSPI_TUNE
+ * 0x00008000 for the suspend to RAM of the application, FSBL_RESUME
  * 0x00FFFFFF for user application to use across soft reset
  */
 #define FSBL_FAIL_MASK		0xF0000000
 #define FSBL_IN_MASK		0x60000000
+#define QSPI_TUNE_MASK		0x0F000000
+#define QSPI_TUNE_SHIFT		24
+#define FSBL_RESUME_MASK	0x00008000
 
 /* The address that holds the base address for the image Boot ROM found */
 #define BASEADDR_HOLDER		0xFFFFFFF8
@@ -546,6 +824,7 @@ void FsblMeasurePerfTime (XTime tCur, XTime tEnd);
 #endif
 void GetSiliconVersion(void);
 void FsblHandoffExit(u32 FsblStartAddr);
+void FsblHandoffCachedExit(u32 FsblStartAddr);
 void FsblHandoffJtagExit();
 void FsblPrintArray (u8 *Buf, u32 Len, char *Str);
 /************************** Variable Definitions *****************************/
@@ -0,0 +1,431 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_bootdev.c
+*
+* Contains the boot device layer of fsbl_bootdev.h.
+*
+* The queue is a ring of FSBL_BOOTDEV_MAX_DEPTH requests, in the order they
+* are submitted. Only the oldest one is on the DMA, the channel takes one
+* command at a time; the next one is started as soon as it is found done,
+* by any call of the layer.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+#include "fsbl_bootdev.h"
+#include "fsbl_dma.h"
+#include "qspi.h"
+#include "nor.h"
+#include "nand.h"
+#include "sd.h"
+#include "emmc.h"
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+#include "xwdtps.h"
+#endif
+
+/************************** Constant Definitions *****************************/
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32 SourceAddress;
+	u32 DestinationAddress;
+	u32 LengthBytes;
+} FsblBootDevRequest;
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+
+static void FsblBootDevSet(const char *Name, ImageMoverType Read,
+		u32 ChunkSize, u32 Depth, u32 Align);
+static u32 FsblBootDevReap(u32 Block);
+
+/************************** Variable Definitions *****************************/
+
+extern u32 FlashReadBaseAddress;
+extern u8 LinearBootDeviceFlag;
+extern ImageMoverType MoveImage;
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+extern XWdtPs Watchdog;	/* Instance of WatchDog Timer	*/
+#endif
+
+static FsblBootDevConfig BootDev;
+static FsblBootDevRequest BootDevQueue[FSBL_BOOTDEV_MAX_DEPTH];
+static u32 BootDevHead;
+static u32 BootDevCount;
+static u8 BootDevStarted;	/* The oldest request is on the DMA */
+static u32 BootDevStatus = XST_SUCCESS;	/* First failure since the last wait */
+
+/******************************************************************************
+*
+* This function selects the device of the boot mode with its tunables and
+* points MoveImage at FsblBootDevRead().
+*
+* @param	BootMode is the boot mode, QSPI_MODE, NAND_FLASH_MODE,
+*		NOR_FLASH_MODE, SD_MODE or MMC_MODE
+*
+* @return
+*		- XST_SUCCESS if the device is selected
+*		- XST_FAILURE if the boot mode has no device in this build
+*
+* @note		Call it once the device is initialized, with
+*		LinearBootDeviceFlag set for a linear QSPI.
+*
+******************************************************************************/
+u32 FsblBootDevSelect(u32 BootMode)
+{
+	switch (BootMode) {
+#if defined(XPAR_PS7_QSPI_LINEAR_0_S_AXI_BASEADDR) || defined(XPAR_PS7_QSPI_LINEAR_0_BASEADDRESS)
+	case QSPI_MODE:
+		FsblBootDevSet("QSPI", QspiAccess, FSBL_BOOTDEV_QSPI_CHUNK,
+				FSBL_BOOTDEV_QSPI_DEPTH, FSBL_BOOTDEV_QSPI_ALIGN);
+		break;
+#endif
+#if defined(XPAR_PS7_NAND_0_BASEADDR) || defined(XPAR_XNANDPS_0_FLASHBASE)
+	case NAND_FLASH_MODE:
+		FsblBootDevSet("NAND", NandAccess, FSBL_BOOTDEV_NAND_CHUNK,
+				FSBL_BOOTDEV_NAND_DEPTH, FSBL_BOOTDEV_NAND_ALIGN);
+		break;
+#endif
+#ifdef FSBL_NOR_BOOT
+	case NOR_FLASH_MODE:
+		FsblBootDevSet("NOR", NorAccess, FSBL_BOOTDEV_NOR_CHUNK,
+				FSBL_BOOTDEV_NOR_DEPTH, FSBL_BOOTDEV_NOR_ALIGN);
+		break;
+#endif
+#if defined(XPAR_PS7_SD_0_S_AXI_BASEADDR) || defined(XPAR_XSDPS_0_BASEADDR)
+#ifdef FSBL_EMMC_RAW
+	case MMC_MODE:
+		FsblBootDevSet("eMMC", EmmcAccess, FSBL_BOOTDEV_EMMC_CHUNK,
+				FSBL_BOOTDEV_EMMC_DEPTH, FSBL_BOOTDEV_EMMC_ALIGN);
+		break;
+	case SD_MODE:
+#else
+	case SD_MODE:
+	case MMC_MODE:
+#endif
+		FsblBootDevSet("SD", SDAccess, FSBL_BOOTDEV_SD_CHUNK,
+				FSBL_BOOTDEV_SD_DEPTH, FSBL_BOOTDEV_SD_ALIGN);
+		break;
+#endif
+	default:
+		return XST_FAILURE;
+	}
+
+	MoveImage = FsblBootDevRead;
+
+	fsbl_printf(DEBUG_INFO, "Boot device %s: chunk 0x%lx depth %lu "
+			"align 0x%lx\r\n", BootDev.Name, BootDev.ChunkSize,
+			BootDev.Depth, BootDev.Align);
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************
+*
+* This function returns the selected device and its tunables, as clamped by
+* FsblBootDevSelect().
+*
+* @param	None
+*
+* @return	The device, with a NULL Read before the selection
+*
+* @note		None
+*
+******************************************************************************/
+const FsblBootDevConfig *FsblBootDevGetConfig(void)
+{
+	return &BootDev;
+}
+
+/******************************************************************************
+*
+* This function queues a read of the boot device. It is split in chunks of
+* the chunk size, the chunks after the first starting on the alignment of
+* the device. A chunk of the window of a linear device, word aligned at
+* both ends, goes to the DMA as soon as the chunks before it are done; the
+* others are read here, once the queue is empty so that the reads land in
+* order.
+*
+* @param	SourceAddress is the offset in the boot device
+* @param	DestinationAddress is the address to read to
+* @param	LengthBytes is the length in bytes
+*
+* @return
+*		- XST_SUCCESS if the read is queued or done
+*		- XST_FAILURE if no device is selected, or a read already
+*		  failed
+*
+* @note		The destination must not be used before FsblBootDevWait().
+*		A failure is also reported by it.
+*
+******************************************************************************/
+u32 FsblBootDevSubmit(u32 SourceAddress, u32 DestinationAddress,
+		u32 LengthBytes)
+{
+#ifdef FSBL_DMA
+	FsblBootDevRequest *Request;
+#endif
+	u32 Length;
+	u32 Status;
+
+	if (BootDev.Read == NULL) {
+		return XST_FAILURE;
+	}
+
+	while (LengthBytes > 0) {
+		if (BootDevStatus != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		Length = LengthBytes;
+		if ((BootDev.ChunkSize != 0) && (Length > BootDev.ChunkSize)) {
+			/*
+			 * End the chunk on the alignment
+			 */
+			Length = BootDev.ChunkSize -
+					(SourceAddress & (BootDev.Align - 1));
+		}
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+		/*
+		 * Prevent WDT reset
+		 */
+		XWdtPs_RestartWdt(&Watchdog);
+#endif
+
+#ifdef FSBL_DMA
+		if ((LinearBootDeviceFlag == 1) && (Length <= FSBL_DMA_CHUNK_SIZE) &&
+				(((SourceAddress + FlashReadBaseAddress) |
+				DestinationAddress | Length) & 0x3) == 0) {
+			/*
+			 * Room in the queue, completing the oldest request if
+			 * it is full
+			 */
+			while (BootDevCount >= BootDev.Depth) {
+				(void)FsblBootDevReap(1);
+				if (BootDevStatus != XST_SUCCESS) {
+					return XST_FAILURE;
+				}
+			}
+
+			Request = &BootDevQueue[(BootDevHead + BootDevCount) %
+						FSBL_BOOTDEV_MAX_DEPTH];
+			Request->SourceAddress = SourceAddress;
+			Request->DestinationAddress = DestinationAddress;
+			Request->LengthBytes = Length;
+			BootDevCount++;
+
+			(void)FsblBootDevReap(0);
+		} else
+#endif
+		{
+			Status = FsblBootDevWait();
+			if (Status == XST_SUCCESS) {
+				Status = BootDev.Read(SourceAddress,
+						DestinationAddress, Length);
+			}
+			if (Status != XST_SUCCESS) {
+				BootDevStatus = XST_FAILURE;
+				return XST_FAILURE;
+			}
+		}
+
+		SourceAddress += Length;
+		DestinationAddress += Length;
+		LengthBytes -= Length;
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************
+*
+* This function waits for all the queued reads.
+*
+* @param	None
+*
+* @return
+*		- XST_SUCCESS if all the reads since the last wait completed
+*		- XST_FAILURE if one failed
+*
+* @note		The failure is cleared, the next read starts afresh.
+*
+******************************************************************************/
+u32 FsblBootDevWait(void)
+{
+	u32 Status;
+
+	while (BootDevCount > 0) {
+		(void)FsblBootDevReap(1);
+	}
+
+	Status = BootDevStatus;
+	BootDevStatus = XST_SUCCESS;
+
+	return Status;
+}
+
+/******************************************************************************
+*
+* This function is the MoveImage of the selected device, a read submitted
+* and waited for.
+*
+* @param	SourceAddress is the offset in the boot device
+* @param	DestinationAddress is the address to read to
+* @param	LengthBytes is the length in bytes
+*
+* @return
+*		- XST_SUCCESS if the read completes
+*		- XST_FAILURE otherwise
+*
+* @note		Same interface as MoveImage.
+*
+******************************************************************************/
+u32 FsblBootDevRead(u32 SourceAddress, u32 DestinationAddress,
+		u32 LengthBytes)
+{
+	u32 Status;
+
+	Status = FsblBootDevSubmit(SourceAddress, DestinationAddress,
+			LengthBytes);
+	if (Status != XST_SUCCESS) {
+		(void)FsblBootDevWait();
+		return XST_FAILURE;
+	}
+
+	return FsblBootDevWait();
+}
+
+/******************************************************************************
+*
+* This function sets the selected device, with the depth between 1 and
+* FSBL_BOOTDEV_MAX_DEPTH and the alignment a power of two that divides the
+* chunk size, 1 otherwise.
+*
+* @param	Name names the device in the messages
+* @param	Read is the blocking read of the device
+* @param	ChunkSize is the most bytes per request, 0 for no limit
+* @param	Depth is the most requests in flight
+* @param	Align is the chunk boundary in the device
+*
+* @return	None
+*
+* @note		None
+*
+******************************************************************************/
+static void FsblBootDevSet(const char *Name, ImageMoverType Read,
+		u32 ChunkSize, u32 Depth, u32 Align)
+{
+	if (Depth < 1) {
+		Depth = 1;
+	} else if (Depth > FSBL_BOOTDEV_MAX_DEPTH) {
+		Depth = FSBL_BOOTDEV_MAX_DEPTH;
+	}
+
+	if ((Align == 0) || ((Align & (Align - 1)) != 0) ||
+			((ChunkSize % Align) != 0)) {
+		Align = 1;
+	}
+
+	BootDev.Name = Name;
+	BootDev.Read = Read;
+	BootDev.ChunkSize = ChunkSize;
+	BootDev.Depth = Depth;
+	BootDev.Align = Align;
+}
+
+/******************************************************************************
+*
+* This function moves the queue along: it completes the oldest request if
+* the DMA is done with it, or reads it with the CPU if the DMA fails, and
+* starts the DMA on the next one.
+*
+* @param	Block is 1 to wait for the oldest request to complete, 0 to
+*		only check it
+*
+* @return	The number of requests still queued
+*
+* @note		A failed read is kept in BootDevStatus and drops the
+*		requests after it.
+*
+******************************************************************************/
+static u32 FsblBootDevReap(u32 Block)
+{
+#ifdef FSBL_DMA
+	FsblBootDevRequest *Request;
+	u32 Status;
+
+	while (BootDevCount > 0) {
+		Request = &BootDevQueue[BootDevHead];
+
+		if (BootDevStarted == 0) {
+			Status = FsblDmaStart(Request->SourceAddress +
+					FlashReadBaseAddress,
+					Request->DestinationAddress,
+					Request->LengthBytes, 0);
+			if (Status == XST_SUCCESS) {
+				BootDevStarted = 1;
+			}
+		}
+
+		if (BootDevStarted == 1) {
+			Status = (Block == 1) ? FsblDmaWait() : FsblDmaPoll();
+			if (Status == XST_DEVICE_BUSY) {
+				break;
+			}
+			BootDevStarted = 0;
+		} else {
+			Status = XST_FAILURE;
+		}
+
+		if (Status == XST_SUCCESS) {
+			FSBL_DCACHE_INVALIDATE(Request->DestinationAddress,
+					Request->LengthBytes);
+		} else {
+			/*
+			 * The CPU copy of the device, which tries the DMA
+			 * again first
+			 */
+			fsbl_printf(DEBUG_INFO, "%s DMA read failed\r\n",
+					BootDev.Name);
+			Status = BootDev.Read(Request->SourceAddress,
+					Request->DestinationAddress,
+					Request->LengthBytes);
+			if (Status != XST_SUCCESS) {
+				BootDevStatus = XST_FAILURE;
+				BootDevCount = 0;
+				break;
+			}
+		}
+
+		BootDevHead = (BootDevHead + 1) % FSBL_BOOTDEV_MAX_DEPTH;
+		BootDevCount--;
+		Block = 0;
+	}
+#else
+	(void)Block;
+#endif
+
+	return BootDevCount;
+}
@@ -0,0 +1,161 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_bootdev.h
+*
+* This file contains the boot device layer, one interface to the QSPI, NAND,
+* NOR and SD reads of the image mover.
+*
+* The device of the boot mode is selected with FsblBootDevSelect(), which
+* points MoveImage at FsblBootDevRead(). Each device has three tunables:
+*
+* - the chunk size, the most bytes one request reads, so that a long read
+*   is split for the watchdog and the pipelined movers get even pieces,
+* - the depth, the most requests in flight, and
+* - the alignment, the device offset the chunks after the first start on,
+*   a multiple of the page or sector so that no page or sector is read
+*   twice at a seam.
+*
+* They are set with FSBL_BOOTDEV_<DEVICE>_CHUNK, _DEPTH and _ALIGN, e.g.
+* -DFSBL_BOOTDEV_SD_CHUNK=0x100000 in USER_COMPILE_DEFINITIONS.
+*
+* Requests are queued with FsblBootDevSubmit() and completed in order with
+* FsblBootDevWait(). The reads of the QSPI and NOR window of a linear boot
+* device are done by the PS DMA, up to the depth started one after the other
+* as the previous ones complete, while the CPU does other work. The NAND, SD
+* and I/O mode QSPI drivers are polled, so their requests complete in
+* FsblBootDevSubmit() and their depth is always 1.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef ___FSBL_BOOTDEV_H___
+#define ___FSBL_BOOTDEV_H___
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+#include "image_mover.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Most requests in flight, for all devices
+ */
+#define FSBL_BOOTDEV_MAX_DEPTH	4
+
+/*
+ * Linear QSPI, also the I/O mode. 0 as chunk size does not split the reads.
+ */
+#ifndef FSBL_BOOTDEV_QSPI_CHUNK
+#define FSBL_BOOTDEV_QSPI_CHUNK	0x100000
+#endif
+#ifndef FSBL_BOOTDEV_QSPI_DEPTH
+#define FSBL_BOOTDEV_QSPI_DEPTH	2
+#endif
+#ifndef FSBL_BOOTDEV_QSPI_ALIGN
+#define FSBL_BOOTDEV_QSPI_ALIGN	4
+#endif
+
+/*
+ * NAND, the chunks on 2 KB pages
+ */
+#ifndef FSBL_BOOTDEV_NAND_CHUNK
+#define FSBL_BOOTDEV_NAND_CHUNK	0x20000
+#endif
+#ifndef FSBL_BOOTDEV_NAND_DEPTH
+#define FSBL_BOOTDEV_NAND_DEPTH	1
+#endif
+#ifndef FSBL_BOOTDEV_NAND_ALIGN
+#define FSBL_BOOTDEV_NAND_ALIGN	0x800
+#endif
+
+/*
+ * NOR
+ */
+#ifndef FSBL_BOOTDEV_NOR_CHUNK
+#define FSBL_BOOTDEV_NOR_CHUNK	0x100000
+#endif
+#ifndef FSBL_BOOTDEV_NOR_DEPTH
+#define FSBL_BOOTDEV_NOR_DEPTH	2
+#endif
+#ifndef FSBL_BOOTDEV_NOR_ALIGN
+#define FSBL_BOOTDEV_NOR_ALIGN	4
+#endif
+
+/*
+ * SD and MMC, the chunks on sectors so that FatFs reads them straight into
+ * the destination
+ */
+#ifndef FSBL_BOOTDEV_SD_CHUNK
+#define FSBL_BOOTDEV_SD_CHUNK	0x40000
+#endif
+#ifndef FSBL_BOOTDEV_SD_DEPTH
+#define FSBL_BOOTDEV_SD_DEPTH	1
+#endif
+#ifndef FSBL_BOOTDEV_SD_ALIGN
+#define FSBL_BOOTDEV_SD_ALIGN	0x200
+#endif
+
+/*
+ * Raw eMMC of FSBL_EMMC_RAW, the chunks on blocks and large enough for the
+ * multi-block reads of EmmcAccess
+ */
+#ifndef FSBL_BOOTDEV_EMMC_CHUNK
+#define FSBL_BOOTDEV_EMMC_CHUNK	0x200000
+#endif
+#ifndef FSBL_BOOTDEV_EMMC_DEPTH
+#define FSBL_BOOTDEV_EMMC_DEPTH	1
+#endif
+#ifndef FSBL_BOOTDEV_EMMC_ALIGN
+#define FSBL_BOOTDEV_EMMC_ALIGN	0x200
+#endif
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	const char *Name;
+	ImageMoverType Read;	/* Blocking read of the device */
+	u32 ChunkSize;		/* Most bytes per request, 0 for no limit */
+	u32 Depth;		/* Most requests in flight */
+	u32 Align;		/* Chunk boundary in the device, a power of two */
+} FsblBootDevConfig;
+
+/************************** Function Prototypes ******************************/
+
+u32 FsblBootDevSelect(u32 BootMode);
+
+const FsblBootDevConfig *FsblBootDevGetConfig(void);
+
+u32 FsblBootDevSubmit(u32 SourceAddress, u32 DestinationAddress,
+		u32 LengthBytes);
+
+u32 FsblBootDevWait(void);
+
+u32 FsblBootDevRead(u32 SourceAddress, u32 DestinationAddress,
+		u32 LengthBytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ___FSBL_BOOTDEV_H___ */
@@ -0,0 +1,313 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_cpu1.c
+*
+* Contains the CPU1 worker of FSBL_CPU1_WORKER, see fsbl_cpu1.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+#include "fsbl_cpu1.h"
+
+#ifdef FSBL_CPU1_WORKER
+#include "xpseudo_asm.h"
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+#include "xwdtps.h"
+#endif
+
+/************************** Constant Definitions *****************************/
+
+#define CPU1_WAKE_ADDR_REG		0xFFFFFFF0	/* Read by the Boot ROM */
+#define EFUSE_STATUS_CPU1_DISABLE_MASK	0x80		/* Single core device */
+#define CPU1_TIMEOUT			1000000		/* Polls */
+
+/*
+ * States of the mailbox
+ */
+#define CPU1_STATE_STOPPED	0	/* In the Boot ROM wait loop */
+#define CPU1_STATE_IDLE		1	/* Waiting for a job */
+#define CPU1_STATE_JOB		2	/* Job posted or running */
+#define CPU1_STATE_DONE		3	/* Result ready */
+#define CPU1_STATE_EXIT		4	/* Asked to stop */
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	volatile u32 State;	/* CPU1_STATE_* */
+	FsblCpu1Func Func;	/* Job */
+	u32 Arg[3];		/* Arguments of the job */
+	volatile u32 Result;	/* Status of the job */
+} FsblCpu1Mailbox;
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+#define sev()	__asm__ __volatile__ ("sev" : : : "memory")
+#define wfe()	__asm__ __volatile__ ("wfe" : : : "memory")
+
+/************************** Function Prototypes ******************************/
+
+extern void FsblCpu1Entry(void);
+void FsblCpu1Loop(void);
+
+/************************** Variable Definitions *****************************/
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+extern XWdtPs Watchdog;	/* Instance of WatchDog Timer	*/
+#endif
+
+static FsblCpu1Mailbox Cpu1Mailbox;
+static u8 Cpu1Running;
+
+/******************************************************************************/
+/**
+*
+* This function is the loop CPU1 runs, called by FsblCpu1Entry. It runs the
+* jobs posted in the mailbox until it is asked to stop.
+*
+* @param	None
+*
+* @return	None
+*
+* @note		Runs on CPU1.
+*
+****************************************************************************/
+void FsblCpu1Loop(void)
+{
+	FsblCpu1Mailbox *Mailbox = &Cpu1Mailbox;
+	u32 State;
+
+	Mailbox->State = CPU1_STATE_IDLE;
+	dsb();
+	sev();
+
+	while (1) {
+		State = Mailbox->State;
+		if (State == CPU1_STATE_EXIT) {
+			break;
+		}
+
+		if (State != CPU1_STATE_JOB) {
+			wfe();
+			continue;
+		}
+
+		Mailbox->Result = Mailbox->Func(Mailbox->Arg[0],
+				Mailbox->Arg[1], Mailbox->Arg[2]);
+		dsb();
+		Mailbox->State = CPU1_STATE_DONE;
+		dsb();
+		sev();
+	}
+
+	Mailbox->State = CPU1_STATE_STOPPED;
+	dsb();
+	sev();
+}
+
+/******************************************************************************/
+/**
+*
+* This function wakes CPU1 out of the Boot ROM wait loop and waits for it to
+* be ready for jobs.
+*
+* @param	None
+*
+* @return
+*		- XST_SUCCESS if CPU1 is ready
+*		- XST_FAILURE if the device has one core or CPU1 does not answer
+*
+* @note		The wake address is cleared again once CPU1 has left the Boot
+*		ROM wait loop, for the application to use.
+*
+****************************************************************************/
+u32 FsblCpu1Start(void)
+{
+	u32 Count;
+
+	if (Cpu1Running == 1) {
+		return XST_SUCCESS;
+	}
+
+	if ((Xil_In32(EFUSE_STATUS_REG) & EFUSE_STATUS_CPU1_DISABLE_MASK) != 0) {
+		return XST_FAILURE;
+	}
+
+	Cpu1Mailbox.State = CPU1_STATE_STOPPED;
+	Xil_Out32(CPU1_WAKE_ADDR_REG, (u32)FsblCpu1Entry);
+	dsb();
+	sev();
+
+	for (Count = 0; Count < CPU1_TIMEOUT; Count++) {
+		if (Cpu1Mailbox.State == CPU1_STATE_IDLE) {
+			break;
+		}
+	}
+
+	Xil_Out32(CPU1_WAKE_ADDR_REG, 0);
+	dsb();
+
+	if (Cpu1Mailbox.State != CPU1_STATE_IDLE) {
+		fsbl_printf(DEBUG_INFO, "CPU1 worker did not start\r\n");
+		return XST_FAILURE;
+	}
+
+	Cpu1Running = 1;
+	fsbl_printf(DEBUG_INFO, "CPU1 worker started\r\n");
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function posts a job to CPU1.
+*
+* @param	Func is the job
+* @param	Arg0 to Arg2 are its arguments
+*
+* @return
+*		- XST_SUCCESS if the job is posted
+*		- XST_DEVICE_BUSY if the previous job is not waited for
+*		- XST_FAILURE if CPU1 is not started
+*
+* @note		None
+*
+****************************************************************************/
+u32 FsblCpu1Post(FsblCpu1Func Func, u32 Arg0, u32 Arg1, u32 Arg2)
+{
+	FsblCpu1Mailbox *Mailbox = &Cpu1Mailbox;
+
+	if (Cpu1Running == 0) {
+		return XST_FAILURE;
+	}
+
+	if (Mailbox->State != CPU1_STATE_IDLE) {
+		return XST_DEVICE_BUSY;
+	}
+
+	Mailbox->Func = Func;
+	Mailbox->Arg[0] = Arg0;
+	Mailbox->Arg[1] = Arg1;
+	Mailbox->Arg[2] = Arg2;
+	dsb();
+	Mailbox->State = CPU1_STATE_JOB;
+	dsb();
+	sev();
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function tells whether CPU1 is still running the posted job.
+*
+* @param	None
+*
+* @return	1 if the job is running, 0 otherwise
+*
+* @note		None
+*
+****************************************************************************/
+u32 FsblCpu1Busy(void)
+{
+	return (Cpu1Mailbox.State == CPU1_STATE_JOB) ? 1 : 0;
+}
+
+/******************************************************************************/
+/**
+*
+* This function waits for the posted job and takes its result, CPU1 is then
+* ready for the next job.
+*
+* @param	None
+*
+* @return	Status returned by the job, XST_SUCCESS if there is none
+*
+* @note		The watchdog is restarted while waiting.
+*
+****************************************************************************/
+u32 FsblCpu1Wait(void)
+{
+	FsblCpu1Mailbox *Mailbox = &Cpu1Mailbox;
+	u32 Result;
+
+	if (Cpu1Running == 0) {
+		return XST_SUCCESS;
+	}
+
+	while (Mailbox->State == CPU1_STATE_JOB) {
+#ifdef XPAR_XWDTPS_0_BASEADDR
+		/*
+		 * Prevent WDT reset
+		 */
+		XWdtPs_RestartWdt(&Watchdog);
+#endif
+	}
+
+	if (Mailbox->State != CPU1_STATE_DONE) {
+		return XST_SUCCESS;
+	}
+
+	Result = Mailbox->Result;
+	Mailbox->State = CPU1_STATE_IDLE;
+	dsb();
+
+	return Result;
+}
+
+/******************************************************************************/
+/**
+*
+* This function waits for the posted job and sends CPU1 back to the Boot ROM
+* wait loop.
+*
+* @param	None
+*
+* @return	None
+*
+* @note		Called before handoff, the result of a job still running is
+*		dropped.
+*
+****************************************************************************/
+void FsblCpu1Stop(void)
+{
+	u32 Count;
+
+	if (Cpu1Running == 0) {
+		return;
+	}
+
+	(void)FsblCpu1Wait();
+
+	Cpu1Mailbox.State = CPU1_STATE_EXIT;
+	dsb();
+	sev();
+
+	for (Count = 0; Count < CPU1_TIMEOUT; Count++) {
+		if (Cpu1Mailbox.State == CPU1_STATE_STOPPED) {
+			break;
+		}
+	}
+
+	Cpu1Running = 0;
+}
+#endif
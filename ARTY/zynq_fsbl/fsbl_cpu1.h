@@ -0,0 +1,75 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_cpu1.h
+*
+* This file contains the CPU1 worker of FSBL_CPU1_WORKER.
+*
+* FsblCpu1Start() wakes CPU1 out of the Boot ROM wait loop into a loop that
+* runs one job at a time for CPU0, FsblCpu1Post() hands it a job and
+* FsblCpu1Wait() waits for its result. FsblCpu1Stop() sends CPU1 back to the
+* Boot ROM wait loop before handoff, where the application finds it as if
+* FSBL had never used it.
+*
+* CPU1 runs with the MMU table of FSBL and the data cache off. Jobs may only
+* touch memory that CPU0 does not cache while they run, FSBL runs with its
+* data cache off outside of the RSA authentication. A job must not use the
+* boot device, the drivers are not shared.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef ___FSBL_CPU1_H___
+#define ___FSBL_CPU1_H___
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+/**************************** Type Definitions *******************************/
+
+/*
+ * A job, run on CPU1 with its three arguments, returns an XST_* status
+ */
+typedef u32 (*FsblCpu1Func)(u32 Arg0, u32 Arg1, u32 Arg2);
+
+/************************** Function Prototypes ******************************/
+
+#ifdef FSBL_CPU1_WORKER
+u32 FsblCpu1Start(void);
+
+u32 FsblCpu1Post(FsblCpu1Func Func, u32 Arg0, u32 Arg1, u32 Arg2);
+
+u32 FsblCpu1Busy(void);
+
+u32 FsblCpu1Wait(void);
+
+void FsblCpu1Stop(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ___FSBL_CPU1_H___ */
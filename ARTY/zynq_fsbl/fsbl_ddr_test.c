@@ -0,0 +1,479 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_ddr_test.c
+*
+* Contains the DDR test of FSBL_DDR_TEST, see fsbl_ddr_test.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+#include "fsbl_ddr_test.h"
+
+#ifdef FSBL_DDR_TEST
+#include "xil_cache.h"
+#include "fsbl_dma.h"
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+#include "xwdtps.h"
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FSBL_DDR_TEST_NEON
+#endif
+
+/************************** Constant Definitions *****************************/
+
+#define FSBL_DDR_TEST_LINE		64	/* Bytes per step of a pass */
+#define FSBL_DDR_TEST_HALF		(FSBL_DDR_TEST_BLOCK_SIZE / 2)
+
+/*
+ * Passes, as printed in the reports
+ */
+#define FSBL_DDR_PASS_MARCH_R0		0
+#define FSBL_DDR_PASS_MARCH_R1		1
+#define FSBL_DDR_PASS_MARCH_R2		2
+#define FSBL_DDR_PASS_DMA_FILL		3
+#define FSBL_DDR_PASS_DMA_COPY		4
+#define FSBL_DDR_PASS_ALIAS		5
+
+/**************************** Type Definitions *******************************/
+
+/*
+ * Data of a pass, the word at Addr is ((Addr + Offset) & Mask) ^ Xor
+ */
+typedef struct {
+	u32 Offset;
+	u32 Mask;
+	u32 Xor;
+} FsblDdrPattern;
+
+/************************** Function Prototypes ******************************/
+
+static u32 FsblDdrTestCheckLine(u32 Addr, const FsblDdrPattern *Pattern);
+static void FsblDdrTestWriteLine(u32 Addr, const FsblDdrPattern *Pattern);
+static void FsblDdrTestReport(u32 Addr, const FsblDdrPattern *Pattern,
+		u32 Pass);
+static void FsblDdrTestPass(u32 Addr, u32 Length, u32 Pass,
+		const FsblDdrPattern *Read, const FsblDdrPattern *Write, u32 Down);
+static void FsblDdrTestMarch(u32 Addr, u32 Length);
+#ifdef FSBL_DMA
+static u32 FsblDdrTestDma(u32 Addr, u32 Background);
+#endif
+
+/************************** Variable Definitions *****************************/
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+extern XWdtPs Watchdog;	/* Instance of WatchDog Timer	*/
+#endif
+
+static const char *FsblDdrPassName[] = {
+	"march up r(A) w(~A)",
+	"march down r(~A) w(A)",
+	"march up r(A)",
+	"DMA fill",
+	"DMA copy",
+	"address lines",
+};
+
+static const FsblDdrPattern FsblDdrAddress = { 0, 0xFFFFFFFF, 0 };
+static const FsblDdrPattern FsblDdrAddressInv = { 0, 0xFFFFFFFF, 0xFFFFFFFF };
+
+#ifdef FSBL_DMA
+static const u32 FsblDdrBackground[4] = {
+	0x00000000, 0xFFFFFFFF, 0xAAAAAAAA, 0x55555555
+};
+
+/*
+ * Source of the DMA fill, in OCM
+ */
+static u32 FsblDdrFillWord;
+#endif
+
+static u32 FsblDdrFailures;
+static u32 FsblDdrFailedBits;
+
+/*****************************************************************************/
+/**
+*
+* This function tests the blocks of the DDR, see fsbl_ddr_test.h.
+*
+* @param	None.
+*
+* @return
+*		- XST_SUCCESS if every word read back as written
+*		- XST_FAILURE on a failing word, a DMA fault, or a DDR too
+*		  small for the blocks
+*
+* @note		The content of the blocks is lost.
+*
+******************************************************************************/
+u32 FsblDdrTest(void)
+{
+	u32 Stride;
+	u32 Block;
+	u32 Addr;
+	u32 Status;
+
+	Stride = ((DDR_END_ADDR - DDR_START_ADDR) / FSBL_DDR_TEST_BLOCKS) &
+			~(FSBL_DDR_TEST_BLOCK_SIZE - 1);
+	if (Stride < FSBL_DDR_TEST_BLOCK_SIZE) {
+		fsbl_printf(DEBUG_GENERAL,"DDR_TEST_FAIL : DDR too small\r\n");
+		return XST_FAILURE;
+	}
+
+	FsblDdrFailures = 0;
+	FsblDdrFailedBits = 0;
+#ifdef FSBL_DMA
+	FsblDmaInit();
+#endif
+
+	for (Block = 0; Block < FSBL_DDR_TEST_BLOCKS; Block++) {
+		Addr = DDR_START_ADDR + (Block * Stride);
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+		if (Watchdog.IsReady == XIL_COMPONENT_IS_READY) {
+			XWdtPs_RestartWdt(&Watchdog);
+		}
+#endif
+
+		Status = XST_FAILURE;
+#ifdef FSBL_DMA
+		FsblDdrFillWord = FsblDdrBackground[Block & 3];
+		Status = FsblDmaStart((u32)&FsblDdrFillWord,
+				Addr + FSBL_DDR_TEST_HALF, FSBL_DDR_TEST_HALF, 1);
+#endif
+		if (Status == XST_SUCCESS) {
+#ifdef FSBL_DMA
+			FsblDdrTestMarch(Addr, FSBL_DDR_TEST_HALF);
+			Status = FsblDdrTestDma(Addr, FsblDdrFillWord);
+			if (Status != XST_SUCCESS) {
+				fsbl_printf(DEBUG_GENERAL,
+					"DDR_TEST_FAIL : DMA fault at 0x%.8lx\r\n",
+					Addr);
+				return XST_FAILURE;
+			}
+#endif
+		} else {
+			FsblDdrTestMarch(Addr, FSBL_DDR_TEST_BLOCK_SIZE);
+		}
+	}
+
+	/*
+	 * A high address line stuck or shorted makes a later block
+	 * overwrite an earlier one
+	 */
+	for (Block = 0; Block < FSBL_DDR_TEST_BLOCKS; Block++) {
+		Addr = DDR_START_ADDR + (Block * Stride);
+		if (FsblDdrTestCheckLine(Addr, &FsblDdrAddress) != 0) {
+			FsblDdrTestReport(Addr, &FsblDdrAddress,
+					FSBL_DDR_PASS_ALIAS);
+		}
+	}
+
+	if (FsblDdrFailures != 0) {
+		fsbl_printf(DEBUG_GENERAL,
+			"DDR_TEST_FAIL : %lu words, data bits 0x%.8lx\r\n",
+			FsblDdrFailures, FsblDdrFailedBits);
+		return XST_FAILURE;
+	}
+
+	fsbl_printf(DEBUG_INFO,"DDR test passed, %d blocks of 0x%x bytes\r\n",
+			FSBL_DDR_TEST_BLOCKS, FSBL_DDR_TEST_BLOCK_SIZE);
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function runs the March C- on a range, with the address and its
+* complement as data.
+*
+* @param	Addr is the start of the range, 64 byte aligned
+* @param	Length is the length in bytes, a multiple of 64
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void FsblDdrTestMarch(u32 Addr, u32 Length)
+{
+	FsblDdrTestPass(Addr, Length, FSBL_DDR_PASS_MARCH_R0, NULL,
+			&FsblDdrAddress, 0);
+	FsblDdrTestPass(Addr, Length, FSBL_DDR_PASS_MARCH_R0, &FsblDdrAddress,
+			&FsblDdrAddressInv, 0);
+	FsblDdrTestPass(Addr, Length, FSBL_DDR_PASS_MARCH_R1,
+			&FsblDdrAddressInv, &FsblDdrAddress, 1);
+	FsblDdrTestPass(Addr, Length, FSBL_DDR_PASS_MARCH_R2, &FsblDdrAddress,
+			NULL, 0);
+}
+
+#ifdef FSBL_DMA
+/*****************************************************************************/
+/**
+*
+* This function checks the DMA fill of the upper half of a block, then
+* copies the lower half over it with the DMA and checks the copy.
+*
+* @param	Addr is the address of the block, its fill started
+* @param	Background is the word of the fill
+*
+* @return
+*		- XST_SUCCESS if both DMA commands completed, whatever the
+*		  data read back
+*		- XST_FAILURE if one faulted or could not be started
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 FsblDdrTestDma(u32 Addr, u32 Background)
+{
+	FsblDdrPattern Fill = { 0, 0, Background };
+	FsblDdrPattern Copy = { 0U - FSBL_DDR_TEST_HALF, 0xFFFFFFFF, 0 };
+	u32 Upper = Addr + FSBL_DDR_TEST_HALF;
+	u32 Status;
+
+	Status = FsblDmaWait();
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	/*
+	 * Lines the CPU may have fetched during the march
+	 */
+	FSBL_DCACHE_INVALIDATE(Upper, FSBL_DDR_TEST_HALF);
+	FsblDdrTestPass(Upper, FSBL_DDR_TEST_HALF, FSBL_DDR_PASS_DMA_FILL,
+			&Fill, NULL, 0);
+
+	Status = FsblDmaStart(Addr, Upper, FSBL_DDR_TEST_HALF, 0);
+	if (Status == XST_SUCCESS) {
+		Status = FsblDmaWait();
+	}
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	FsblDdrTestPass(Upper, FSBL_DDR_TEST_HALF, FSBL_DDR_PASS_DMA_COPY,
+			&Copy, NULL, 0);
+
+	return XST_SUCCESS;
+}
+#endif
+
+/*****************************************************************************/
+/**
+*
+* This function runs one pass over a range, line by line, checking each
+* line against Read and then writing Write to it.
+*
+* @param	Addr is the start of the range, 64 byte aligned
+* @param	Length is the length in bytes, a multiple of 64
+* @param	Pass is the pass for the reports
+* @param	Read is the data to check, NULL for none
+* @param	Write is the data to write, NULL for none
+* @param	Down is 1 to go from the top of the range down
+*
+* @return	None.
+*
+* @note		The range is flushed to the DRAM at the end with
+*		FSBL_DCACHE.
+*
+******************************************************************************/
+static void FsblDdrTestPass(u32 Addr, u32 Length, u32 Pass,
+		const FsblDdrPattern *Read, const FsblDdrPattern *Write, u32 Down)
+{
+	u32 Line;
+	u32 LineAddr;
+
+	for (Line = 0; Line < Length; Line += FSBL_DDR_TEST_LINE) {
+		LineAddr = (Down != 0) ?
+				(Addr + Length - FSBL_DDR_TEST_LINE - Line) :
+				(Addr + Line);
+		if ((Read != NULL) &&
+				(FsblDdrTestCheckLine(LineAddr, Read) != 0)) {
+			FsblDdrTestReport(LineAddr, Read, Pass);
+		}
+		if (Write != NULL) {
+			FsblDdrTestWriteLine(LineAddr, Write);
+		}
+	}
+
+	FSBL_DCACHE_FLUSH(Addr, Length);
+}
+
+#ifdef FSBL_DDR_TEST_NEON
+/*****************************************************************************/
+/**
+*
+* This function returns the data of a pattern for four words.
+*
+* @param	Addr is the address of the first word
+* @param	Pattern is the pattern
+*
+* @return	The four words.
+*
+* @note		None.
+*
+******************************************************************************/
+static inline uint32x4_t FsblDdrTestVector(u32 Addr,
+		const FsblDdrPattern *Pattern)
+{
+	static const u32 Steps[4] = { 0, 4, 8, 12 };
+	uint32x4_t Words;
+
+	Words = vaddq_u32(vdupq_n_u32(Addr + Pattern->Offset),
+			vld1q_u32(Steps));
+	Words = vandq_u32(Words, vdupq_n_u32(Pattern->Mask));
+
+	return veorq_u32(Words, vdupq_n_u32(Pattern->Xor));
+}
+#endif
+
+/*****************************************************************************/
+/**
+*
+* This function checks a line against a pattern, with four loads of 16
+* bytes and no branch.
+*
+* @param	Addr is the address of the line
+* @param	Pattern is the expected data
+*
+* @return	The OR of the differences of the words, 0 for a good line.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 FsblDdrTestCheckLine(u32 Addr, const FsblDdrPattern *Pattern)
+{
+#ifdef FSBL_DDR_TEST_NEON
+	const u32 *Ptr = (const u32 *)Addr;
+	uint32x4_t Diff;
+	uint32x2_t Half;
+
+	Diff = veorq_u32(vld1q_u32(Ptr), FsblDdrTestVector(Addr, Pattern));
+	Diff = vorrq_u32(Diff, veorq_u32(vld1q_u32(Ptr + 4),
+			FsblDdrTestVector(Addr + 16, Pattern)));
+	Diff = vorrq_u32(Diff, veorq_u32(vld1q_u32(Ptr + 8),
+			FsblDdrTestVector(Addr + 32, Pattern)));
+	Diff = vorrq_u32(Diff, veorq_u32(vld1q_u32(Ptr + 12),
+			FsblDdrTestVector(Addr + 48, Pattern)));
+	Half = vorr_u32(vget_low_u32(Diff), vget_high_u32(Diff));
+
+	return vget_lane_u32(Half, 0) | vget_lane_u32(Half, 1);
+#else
+	u32 Diff = 0;
+	u32 Offset;
+
+	for (Offset = 0; Offset < FSBL_DDR_TEST_LINE; Offset += 4) {
+		Diff |= Xil_In32(Addr + Offset) ^
+			(((Addr + Offset + Pattern->Offset) & Pattern->Mask) ^
+			Pattern->Xor);
+	}
+
+	return Diff;
+#endif
+}
+
+/*****************************************************************************/
+/**
+*
+* This function writes a pattern to a line.
+*
+* @param	Addr is the address of the line
+* @param	Pattern is the data
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void FsblDdrTestWriteLine(u32 Addr, const FsblDdrPattern *Pattern)
+{
+#ifdef FSBL_DDR_TEST_NEON
+	u32 *Ptr = (u32 *)Addr;
+
+	vst1q_u32(Ptr, FsblDdrTestVector(Addr, Pattern));
+	vst1q_u32(Ptr + 4, FsblDdrTestVector(Addr + 16, Pattern));
+	vst1q_u32(Ptr + 8, FsblDdrTestVector(Addr + 32, Pattern));
+	vst1q_u32(Ptr + 12, FsblDdrTestVector(Addr + 48, Pattern));
+#else
+	u32 Offset;
+
+	for (Offset = 0; Offset < FSBL_DDR_TEST_LINE; Offset += 4) {
+		Xil_Out32(Addr + Offset,
+			((Addr + Offset + Pattern->Offset) & Pattern->Mask) ^
+			Pattern->Xor);
+	}
+#endif
+}
+
+/*****************************************************************************/
+/**
+*
+* This function counts and prints the failing words of a line. The line is
+* read again word by word; a line that reads back good the second time is
+* counted once and printed as not repeated.
+*
+* @param	Addr is the address of the line
+* @param	Pattern is the expected data
+* @param	Pass is the pass that found the line bad
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void FsblDdrTestReport(u32 Addr, const FsblDdrPattern *Pattern,
+		u32 Pass)
+{
+	u32 Offset;
+	u32 Expected;
+	u32 ReadVal;
+	u32 Found = 0;
+
+	for (Offset = 0; Offset < FSBL_DDR_TEST_LINE; Offset += 4) {
+		Expected = ((Addr + Offset + Pattern->Offset) & Pattern->Mask) ^
+				Pattern->Xor;
+		ReadVal = Xil_In32(Addr + Offset);
+		if (ReadVal == Expected) {
+			continue;
+		}
+
+		Found++;
+		FsblDdrFailures++;
+		FsblDdrFailedBits |= ReadVal ^ Expected;
+		if (FsblDdrFailures <= FSBL_DDR_TEST_MAX_REPORTS) {
+			fsbl_printf(DEBUG_GENERAL,"DDR_TEST_FAIL : 0x%.8lx "
+				"expected 0x%.8lx read 0x%.8lx, %s\r\n",
+				Addr + Offset, Expected, ReadVal,
+				FsblDdrPassName[Pass]);
+		}
+	}
+
+	if (Found == 0) {
+		FsblDdrFailures++;
+		if (FsblDdrFailures <= FSBL_DDR_TEST_MAX_REPORTS) {
+			fsbl_printf(DEBUG_GENERAL,"DDR_TEST_FAIL : line 0x%.8lx, "
+				"%s, not repeated\r\n", Addr,
+				FsblDdrPassName[Pass]);
+		}
+	}
+}
+#endif
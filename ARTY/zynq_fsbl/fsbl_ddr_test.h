@@ -0,0 +1,91 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_ddr_test.h
+*
+* This file contains the DDR test of FSBL_DDR_TEST, run after the sanity
+* check of DDRInitCheck().
+*
+* The test covers FSBL_DDR_TEST_BLOCKS blocks of FSBL_DDR_TEST_BLOCK_SIZE
+* bytes, spread evenly over the DDR so that every bank and the high rows
+* are reached. In each block:
+*	- The PS DMA fills the upper half with a data background, one of
+*	  0x00000000, 0xFFFFFFFF, 0xAAAAAAAA and 0x55555555 from block to
+*	  block, while the CPU runs a March C- on the lower half with NEON
+*	  stores, the data being the address of each word and its
+*	  complement:
+*		up w(A), up r(A) w(~A), down r(~A) w(A), up r(A)
+*	- The CPU checks the fill, then the DMA copies the lower half over
+*	  the upper one and the CPU checks the copy.
+* The first line of each block is checked again at the end, for the high
+* address lines that alias blocks. Without the DMA driver both halves are
+* left to the CPU march.
+*
+* The march runs by lines of 64 bytes, the words of a line in ascending
+* order even in the down pass. With FSBL_DCACHE each pass is flushed to the
+* DRAM before the next one reads it.
+*
+* The first FSBL_DDR_TEST_MAX_REPORTS failing words are printed with their
+* address, the expected and read data and the pass, then the number of
+* failures and the data bits that failed, which point at a byte lane or a
+* DQ line.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef ___FSBL_DDR_TEST_H___
+#define ___FSBL_DDR_TEST_H___
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Tested blocks, a power of two number of bytes of at least 128 each
+ */
+#ifndef FSBL_DDR_TEST_BLOCKS
+#define FSBL_DDR_TEST_BLOCKS		16
+#endif
+#ifndef FSBL_DDR_TEST_BLOCK_SIZE
+#define FSBL_DDR_TEST_BLOCK_SIZE	0x10000
+#endif
+
+/*
+ * Failing words printed
+ */
+#ifndef FSBL_DDR_TEST_MAX_REPORTS
+#define FSBL_DDR_TEST_MAX_REPORTS	8
+#endif
+
+/************************** Function Prototypes ******************************/
+
+#ifdef FSBL_DDR_TEST
+u32 FsblDdrTest(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ___FSBL_DDR_TEST_H___ */
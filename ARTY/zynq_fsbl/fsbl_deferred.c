@@ -0,0 +1,128 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_deferred.c
+*
+* Contains the deferred partitions of FSBL_DEFERRED, see fsbl_deferred.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+#include "fsbl_deferred.h"
+
+#ifdef FSBL_DEFERRED
+#include <string.h>
+#include "xil_mem.h"
+
+/************************** Constant Definitions *****************************/
+
+#define FSBL_DEFERRED_TABLE_WORDS	((sizeof(FsblDeferredTable) / 4) - 1)
+
+/************************** Variable Definitions *****************************/
+
+extern u32 FlashReadBaseAddress;
+
+/*****************************************************************************/
+/**
+*
+* This function clears the table of the previous boot, which the OCM keeps
+* over a warm reset, so that a boot that loads no image, or does not get to
+* the handoff, leaves none.
+*
+* @param	None.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void FsblDeferredInit(void)
+{
+	memset((void *)FSBL_DEFERRED_ADDR, 0, sizeof(FsblDeferredTable));
+}
+
+/*****************************************************************************/
+/**
+*
+* This function adds a partition to the table instead of loading it.
+*
+* @param	PartitionNum is the number of the partition
+* @param	ImageStartAddress is the address of the boot image
+* @param	Header is the header of the partition
+*
+* @return
+*		- XST_SUCCESS if the partition is left to the application
+*		- XST_FAILURE if it must be loaded, the table being full or its
+*		checksum unreadable
+*
+* @note		The caller only adds plain PS partitions of linear boot
+*		devices.
+*
+******************************************************************************/
+u32 FsblDeferredAdd(u32 PartitionNum, u32 ImageStartAddress,
+		PartHeader *Header)
+{
+	FsblDeferredTable *Table = (FsblDeferredTable *)FSBL_DEFERRED_ADDR;
+	FsblDeferredEntry *Entry;
+
+	if (Table->Count >= FSBL_DEFERRED_MAX_ENTRIES) {
+		return XST_FAILURE;
+	}
+
+	Entry = &Table->Entry[Table->Count];
+	memset(Entry, 0, sizeof(FsblDeferredEntry));
+	if (Header->PartitionAttr & ATTRIBUTE_CHECKSUM_TYPE_MASK) {
+		if (GetPartitionChecksum(ImageStartAddress +
+				(Header->CheckSumOffset << WORD_LENGTH_SHIFT),
+				(u8 *)Entry->Checksum) != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+		Entry->Flags |= FSBL_DEFERRED_CHECKSUM;
+	}
+
+	Entry->PartitionNum = PartitionNum;
+	Entry->FlashAddr = FlashReadBaseAddress + ImageStartAddress +
+			(Header->PartitionStart << WORD_LENGTH_SHIFT);
+	Entry->LoadAddr = Header->LoadAddr;
+	Entry->Length = Header->PartitionWordLen << WORD_LENGTH_SHIFT;
+	Table->Count++;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function makes the table valid, once every partition is loaded.
+*
+* @param	None.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void FsblDeferredSeal(void)
+{
+	FsblDeferredTable *Table = (FsblDeferredTable *)FSBL_DEFERRED_ADDR;
+
+	Table->Magic = FSBL_DEFERRED_MAGIC;
+	Table->Checksum = Xil_MemSum32((u32 *)Table, FSBL_DEFERRED_TABLE_WORDS);
+}
+#endif
@@ -0,0 +1,113 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_deferred.h
+*
+* This file contains the deferred partitions of FSBL_DEFERRED.
+*
+* A plain PS partition with ATTRIBUTE_DEFERRED_MASK set in its attributes,
+* such as a large table the application only needs once it runs, is not
+* loaded on a linear boot device: it is listed in a handoff table at
+* FSBL_DEFERRED_ADDR in the high OCM, out of the FSBL and application
+* linker scripts, with the address of the partition in the memory window
+* of the boot device, its load address and length, and the MD5 checksum
+* the boot image holds for it. The application reads the table before it
+* uses the high OCM and loads the partitions itself, see deferred_part.h
+* of the application.
+*
+* The table is cleared at the start of each boot and valid once every
+* partition is loaded, with the checksum of its words. A partition that
+* does not fit in the table, or on a boot device without a memory window,
+* is loaded at boot as any other.
+*
+* The table is little endian:
+*	- Magic, FSBL_DEFERRED_MAGIC
+*	- Count, entries recorded
+*	- FSBL_DEFERRED_MAX_ENTRIES entries, FsblDeferredEntry
+*	- Checksum, Xil_MemSum32 of the words before it
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef ___FSBL_DEFERRED_H___
+#define ___FSBL_DEFERRED_H___
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+#include "image_mover.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Below the warm boot record, kept out of the FSBL and application linker
+ * scripts
+ */
+#define FSBL_DEFERRED_ADDR		0xFFFFF400
+#define FSBL_DEFERRED_SIZE		0x100
+
+#define FSBL_DEFERRED_MAGIC		0x31464446	/* "FDF1" */
+#define FSBL_DEFERRED_MAX_ENTRIES	6
+
+/*
+ * Flags of an entry
+ */
+#define FSBL_DEFERRED_CHECKSUM		0x1	/* Checksum holds the MD5 */
+
+/**************************** Type Definitions *******************************/
+
+/*
+ * A partition left in the boot device
+ */
+typedef struct {
+	u32 PartitionNum;
+	u32 FlashAddr;		/* In the memory window of the boot device */
+	u32 LoadAddr;
+	u32 Length;		/* Bytes */
+	u32 Flags;		/* FSBL_DEFERRED_* */
+	u32 Checksum[4];	/* MD5 in the boot device */
+} FsblDeferredEntry;
+
+/*
+ * The table, the checksum is Xil_MemSum32 of the words before it
+ */
+typedef struct {
+	u32 Magic;
+	u32 Count;
+	FsblDeferredEntry Entry[FSBL_DEFERRED_MAX_ENTRIES];
+	u32 Checksum;
+} FsblDeferredTable;
+
+/************************** Function Prototypes ******************************/
+
+#ifdef FSBL_DEFERRED
+void FsblDeferredInit(void);
+u32 FsblDeferredAdd(u32 PartitionNum, u32 ImageStartAddress,
+		PartHeader *Header);
+void FsblDeferredSeal(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ___FSBL_DEFERRED_H___ */
@@ -0,0 +1,285 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_dma.c
+*
+* Contains the PS DMA copy of the linear QSPI and NOR reads.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release, the DMA copy of qspi.c shared with
+*			 nor.c
+*			 Invalidate the destination with FSBL_DCACHE
+*			 FsblDmaStart() and FsblDmaWait() of the DDR test
+*			 FsblDmaPoll() of the boot device layer
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+#include "fsbl_dma.h"
+
+#ifdef FSBL_DMA
+#include <string.h>
+#include "xdmaps.h"
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+#include "xwdtps.h"
+#endif
+
+/************************** Constant Definitions *****************************/
+
+#ifndef SDT
+#define FSBL_DMA_DEVICE_ID	XPAR_XDMAPS_1_DEVICE_ID
+#else
+#define FSBL_DMA_DEVICE_ID	XPAR_XDMAPS_0_BASEADDR
+#endif
+#define FSBL_DMA_CHANNEL	0		/* Done by XDmaPs_DoneISR_0 */
+/*
+ * INCR16 bursts of words, the width of the linear QSPI port and of the AXI
+ * port of the SMC
+ */
+#define FSBL_DMA_BURST_SIZE	4
+#define FSBL_DMA_BURST_LEN	16
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+
+/************************** Variable Definitions *****************************/
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+extern XWdtPs Watchdog;	/* Instance of WatchDog Timer	*/
+#endif
+
+static XDmaPs FsblDma;
+static u8 FsblDmaReady;
+
+/******************************************************************************
+*
+* This function initializes the PS DMA used for the copies. On failure the
+* copies stay on the CPU.
+*
+* @param	None
+*
+* @return	None
+*
+* @note		The DMA is polled, no interrupt is connected.
+*
+******************************************************************************/
+void FsblDmaInit(void)
+{
+	XDmaPs_Config *DmaConfig;
+	int Status;
+
+	if (FsblDmaReady == 1) {
+		return;
+	}
+
+	DmaConfig = XDmaPs_LookupConfig(FSBL_DMA_DEVICE_ID);
+	if (DmaConfig == NULL) {
+		return;
+	}
+
+	Status = XDmaPs_CfgInitialize(&FsblDma, DmaConfig,
+					DmaConfig->BaseAddress);
+	if (Status != XST_SUCCESS) {
+		return;
+	}
+
+	FsblDmaReady = 1;
+}
+
+/******************************************************************************
+*
+* This function starts one DMA command and returns without waiting for it,
+* so that the CPU can work on other memory in the meantime.
+*
+* @param	SourceAddress is the address to read from
+* @param	DestinationAddress is the address to write to
+* @param	LengthBytes is the length in bytes, a multiple of 4 up to
+*		FSBL_DMA_CHUNK_SIZE
+* @param	SourceFixed is 1 to read the word at SourceAddress over and
+*		over, filling the destination with it, 0 to copy
+*
+* @return
+*		- XST_SUCCESS if the command is started
+*		- XST_FAILURE if the DMA is not initialized, the length is too
+*		  long or the command cannot be started
+*
+* @note		Finish the command with FsblDmaWait() before the next one.
+*		The source is flushed and the destination invalidated in the
+*		data cache with FSBL_DCACHE.
+*
+******************************************************************************/
+u32 FsblDmaStart(u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes,
+		u32 SourceFixed)
+{
+	XDmaPs_Cmd DmaCmd;
+	int Status;
+
+	if ((FsblDmaReady == 0) || (LengthBytes > FSBL_DMA_CHUNK_SIZE)) {
+		return XST_FAILURE;
+	}
+
+	FSBL_DCACHE_FLUSH(SourceAddress, (SourceFixed != 0) ? 4 : LengthBytes);
+	FSBL_DCACHE_INVALIDATE(DestinationAddress, LengthBytes);
+
+	memset(&DmaCmd, 0, sizeof(XDmaPs_Cmd));
+	DmaCmd.ChanCtrl.SrcBurstSize = FSBL_DMA_BURST_SIZE;
+	/*
+	 * Single beats from a fixed source, the MFIFO packs them into the
+	 * bursts of the destination
+	 */
+	DmaCmd.ChanCtrl.SrcBurstLen = (SourceFixed != 0) ? 1 : FSBL_DMA_BURST_LEN;
+	DmaCmd.ChanCtrl.SrcInc = (SourceFixed != 0) ? 0 : 1;
+	DmaCmd.ChanCtrl.DstBurstSize = FSBL_DMA_BURST_SIZE;
+	DmaCmd.ChanCtrl.DstBurstLen = FSBL_DMA_BURST_LEN;
+	DmaCmd.ChanCtrl.DstInc = 1;
+	DmaCmd.BD.SrcAddr = SourceAddress;
+	DmaCmd.BD.DstAddr = DestinationAddress;
+	DmaCmd.BD.Length = LengthBytes;
+
+	Status = XDmaPs_Start(&FsblDma, FSBL_DMA_CHANNEL, &DmaCmd, 0);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************
+*
+* This function checks once for the done event of the command of
+* FsblDmaStart(), and handles it with the driver's done handler of the
+* channel.
+*
+* @param	None
+*
+* @return
+*		- XST_SUCCESS if the command completed
+*		- XST_DEVICE_BUSY if it is still running
+*		- XST_FAILURE if it faulted
+*
+* @note		None.
+*
+******************************************************************************/
+u32 FsblDmaPoll(void)
+{
+	u32 BaseAddr = FsblDma.Config.BaseAddress;
+
+	if ((XDmaPs_ReadReg(BaseAddr, XDMAPS_INTSTATUS_OFFSET) &
+			(1U << FSBL_DMA_CHANNEL)) != 0U) {
+		XDmaPs_DoneISR_0(&FsblDma);
+		return XST_SUCCESS;
+	}
+
+	if ((XDmaPs_ReadReg(BaseAddr, XDMAPS_FSC_OFFSET) &
+			(1U << FSBL_DMA_CHANNEL)) != 0U) {
+		XDmaPs_FaultISR(&FsblDma);
+		return XST_FAILURE;
+	}
+
+	return XST_DEVICE_BUSY;
+}
+
+/******************************************************************************
+*
+* This function polls for the done event of the command of FsblDmaStart()
+* with FsblDmaPoll().
+*
+* @param	None
+*
+* @return
+*		- XST_SUCCESS if the command completed
+*		- XST_FAILURE if it faulted
+*
+* @note		None.
+*
+******************************************************************************/
+u32 FsblDmaWait(void)
+{
+	u32 Status;
+
+	do {
+		Status = FsblDmaPoll();
+	} while (Status == XST_DEVICE_BUSY);
+
+	return Status;
+}
+
+/******************************************************************************
+*
+* This function copies with the PS DMA, in commands of FSBL_DMA_CHUNK_SIZE
+* bytes. Each command is started with FsblDmaStart() and waited for with
+* FsblDmaWait().
+*
+* @param	SourceAddress is the address in the flash window
+* @param	DestinationAddress is the address in DDR or OCM
+* @param	LengthBytes is the length in bytes, a multiple of 4
+*
+* @return
+*		- XST_SUCCESS if the copy completes
+*		- XST_FAILURE if the DMA is not initialized, or a DMA command
+*		  cannot be started or faults
+*
+* @note		Both addresses must be word aligned. The destination is
+*		invalidated in the data cache before and after the copy with
+*		FSBL_DCACHE.
+*
+******************************************************************************/
+u32 FsblDmaCopy(u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
+{
+	u32 Length;
+	u32 Status;
+#ifdef FSBL_DCACHE
+	u32 CopyAddress = DestinationAddress;
+	u32 CopyLength = LengthBytes;
+#endif
+
+	if (FsblDmaReady == 0) {
+		return XST_FAILURE;
+	}
+
+	while (LengthBytes > 0) {
+		Length = (LengthBytes > FSBL_DMA_CHUNK_SIZE) ?
+				FSBL_DMA_CHUNK_SIZE : LengthBytes;
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+		/*
+		 * Prevent WDT reset
+		 */
+		XWdtPs_RestartWdt(&Watchdog);
+#endif
+
+		Status = FsblDmaStart(SourceAddress, DestinationAddress, Length, 0);
+		if (Status == XST_SUCCESS) {
+			Status = FsblDmaWait();
+		}
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		SourceAddress += Length;
+		DestinationAddress += Length;
+		LengthBytes -= Length;
+	}
+
+	FSBL_DCACHE_INVALIDATE(CopyAddress, CopyLength);
+
+	return XST_SUCCESS;
+}
+#endif
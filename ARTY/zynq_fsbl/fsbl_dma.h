@@ -0,0 +1,79 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_dma.h
+*
+* This file contains the PS DMA copy used by the boot devices that are read
+* through a memory window, the linear QSPI and the NOR flash.
+*
+* The copy is polled, no interrupt is connected. It is built when the BSP
+* has the PS DMA driver, FSBL_DMA is then defined.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release, the DMA copy of qspi.c shared with
+*			 nor.c
+*			 FsblDmaStart() and FsblDmaWait() of the DDR test
+*			 FsblDmaPoll() of the boot device layer
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef ___FSBL_DMA_H___
+#define ___FSBL_DMA_H___
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+
+#include "xparameters.h"
+#include "xil_types.h"
+
+#if defined(XPAR_XDMAPS_1_DEVICE_ID) || defined(XPAR_XDMAPS_0_BASEADDR)
+#define FSBL_DMA
+#endif
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Copies of this many bytes or more are worth the DMA
+ */
+#ifndef FSBL_DMA_THRESHOLD
+#define FSBL_DMA_THRESHOLD	0x10000
+#endif
+
+#define FSBL_DMA_CHUNK_SIZE	0x200000	/* Bytes per DMA command */
+
+/************************** Function Prototypes ******************************/
+
+#ifdef FSBL_DMA
+void FsblDmaInit(void);
+
+u32 FsblDmaCopy(u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes);
+
+u32 FsblDmaStart(u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes,
+		u32 SourceFixed);
+
+u32 FsblDmaWait(void);
+
+u32 FsblDmaPoll(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ___FSBL_DMA_H___ */
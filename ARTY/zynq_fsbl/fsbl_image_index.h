@@ -0,0 +1,68 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_image_index.h
+*
+* This file contains the layout of the boot image index of
+* FSBL_IMAGE_INDEX, shared with the application that writes it.
+*
+* The index lists the flash offsets of the boot images, so that the
+* multiboot fallback checks these first instead of searching the flash
+* 32 KB at a time. The application rewrites it whenever it adds or
+* replaces an image. It lives in its own flash sector, by default the last
+* 64 KB of the boot device, see FSBL_IMAGE_INDEX_OFFSET.
+*
+* The offsets are multiples of the 32 KB multiboot step. FSBL takes the
+* first image of the index, by offset, at or after the image the fallback
+* starts from that passes the ID and header checksum checks. If none does,
+* or the index is missing or corrupt, the flash is searched as before.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef ___FSBL_IMAGE_INDEX_H___
+#define ___FSBL_IMAGE_INDEX_H___
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+#define FSBL_IMAGE_INDEX_MAGIC		0x58444946	/* "FIDX" */
+#define FSBL_IMAGE_INDEX_MAX_IMAGES	16
+#define FSBL_IMAGE_INDEX_SECTOR_SIZE	0x10000
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32 Magic;		/* FSBL_IMAGE_INDEX_MAGIC */
+	u32 Count;		/* Images listed */
+	u32 Offset[FSBL_IMAGE_INDEX_MAX_IMAGES]; /* Flash offsets */
+	u32 Checksum;		/* Inverted sum of the words above */
+} FsblImageIndex;
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ___FSBL_IMAGE_INDEX_H___ */
@@ -0,0 +1,457 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_lz4.c
+*
+* Contains the LZ4 frame decoder of the compressed partitions.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include <string.h>
+#include "xstatus.h"
+#include "fsbl_lz4.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Frame descriptor
+ */
+#define LZ4_FLG_VERSION_MASK		0xC0
+#define LZ4_FLG_VERSION_01			0x40
+#define LZ4_FLG_BLOCK_CHECKSUM		0x10
+#define LZ4_FLG_CONTENT_SIZE		0x08
+#define LZ4_FLG_CONTENT_CHECKSUM	0x04
+#define LZ4_FLG_RESERVED			0x02
+#define LZ4_FLG_DICT_ID				0x01
+#define LZ4_BD_BLOCK_MAX_MASK		0x70
+#define LZ4_BD_BLOCK_MAX_SHIFT		4
+#define LZ4_BD_RESERVED				0x8F
+
+#define LZ4_BLOCK_UNCOMPRESSED		0x80000000
+#define LZ4_MIN_MATCH				4
+#define LZ4_RUN_MASK				0xF
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+
+static u32 Lz4Take(Lz4Stream *Stream, u8 *Dst, u32 Len);
+static u32 Lz4Byte(Lz4Stream *Stream, u32 *Byte);
+static u32 Lz4Word(Lz4Stream *Stream, u32 *Word);
+static u32 Lz4Length(Lz4Stream *Stream, u32 *Length, u32 *Left);
+static u32 Lz4DecodeBlock(Lz4Stream *Stream, u32 BlockLen, u8 *Dst,
+		u32 DstSize, u32 *Pos);
+
+/************************** Variable Definitions *****************************/
+
+/******************************************************************************
+*
+* This function decompresses an LZ4 frame
+*
+* @param	Stream Compressed stream, Next and Avail may be empty
+* @param	Dst Destination of the decompressed data
+* @param	DstSize Bytes available at Dst
+* @param	DstLen Returns the decompressed length
+*
+* @return
+*		- XST_SUCCESS if the frame is decompressed
+*		- XST_FAILURE if the frame is corrupt, does not fit DstSize,
+*		  or the stream ends early
+*
+* @note		The stream is left after the end of the frame. The flush
+*		function is not called for the end of the frame, the caller
+*		takes the last block when this function returns.
+*
+******************************************************************************/
+u32 Lz4Decompress(Lz4Stream *Stream, u8 *Dst, u32 DstSize, u32 *DstLen)
+{
+	u32 Status;
+	u32 Magic;
+	u32 Flags;
+	u32 Descriptor;
+	u32 BlockMax;
+	u32 ContentSize = 0;
+	u32 ContentSizeHigh;
+	u32 BlockLen;
+	u32 Skip;
+	u32 Pos = 0;
+
+	Status = Lz4Word(Stream, &Magic);
+	if ((Status != XST_SUCCESS) || (Magic != LZ4_FRAME_MAGIC)) {
+		return XST_FAILURE;
+	}
+
+	Status = Lz4Byte(Stream, &Flags);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	Status = Lz4Byte(Stream, &Descriptor);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	if (((Flags & LZ4_FLG_VERSION_MASK) != LZ4_FLG_VERSION_01) ||
+			(Flags & (LZ4_FLG_RESERVED | LZ4_FLG_DICT_ID)) ||
+			(Descriptor & LZ4_BD_RESERVED) ||
+			(Descriptor < (4 << LZ4_BD_BLOCK_MAX_SHIFT))) {
+		return XST_FAILURE;
+	}
+
+	/*
+	 * 64 KB, 256 KB, 1 MB or 4 MB
+	 */
+	BlockMax = 1U << (8 + (2 * ((Descriptor & LZ4_BD_BLOCK_MAX_MASK) >>
+					LZ4_BD_BLOCK_MAX_SHIFT)));
+
+	if (Flags & LZ4_FLG_CONTENT_SIZE) {
+		Status = Lz4Word(Stream, &ContentSize);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+		Status = Lz4Word(Stream, &ContentSizeHigh);
+		if ((Status != XST_SUCCESS) || (ContentSizeHigh != 0) ||
+				(ContentSize > DstSize)) {
+			return XST_FAILURE;
+		}
+	}
+
+	/*
+	 * Header checksum
+	 */
+	Status = Lz4Take(Stream, NULL, 1);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	for (;;) {
+		Status = Lz4Word(Stream, &BlockLen);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		/*
+		 * End mark
+		 */
+		if (BlockLen == 0) {
+			break;
+		}
+
+		if ((BlockLen & ~LZ4_BLOCK_UNCOMPRESSED) > BlockMax) {
+			return XST_FAILURE;
+		}
+
+		if (BlockLen & LZ4_BLOCK_UNCOMPRESSED) {
+			BlockLen &= ~LZ4_BLOCK_UNCOMPRESSED;
+			if (BlockLen > (DstSize - Pos)) {
+				return XST_FAILURE;
+			}
+			Status = Lz4Take(Stream, Dst + Pos, BlockLen);
+			Pos += BlockLen;
+		} else {
+			Status = Lz4DecodeBlock(Stream, BlockLen, Dst, DstSize, &Pos);
+		}
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		if (Flags & LZ4_FLG_BLOCK_CHECKSUM) {
+			Status = Lz4Take(Stream, NULL, 4);
+			if (Status != XST_SUCCESS) {
+				return XST_FAILURE;
+			}
+		}
+
+		if (Stream->Flush != NULL) {
+			Status = Stream->Flush(Stream, Pos);
+			if (Status != XST_SUCCESS) {
+				return XST_FAILURE;
+			}
+		}
+	}
+
+	if (Flags & LZ4_FLG_CONTENT_CHECKSUM) {
+		Status = Lz4Word(Stream, &Skip);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+	}
+
+	if ((Flags & LZ4_FLG_CONTENT_SIZE) && (Pos != ContentSize)) {
+		return XST_FAILURE;
+	}
+
+	*DstLen = Pos;
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************
+*
+* This function decodes the sequences of a compressed block
+*
+* @param	Stream Compressed stream, at the start of the block
+* @param	BlockLen Compressed length of the block
+* @param	Dst Start of the decompressed data, the history of the matches
+* @param	DstSize Bytes available at Dst
+* @param	Pos Offset of the block in Dst, returns the offset after it
+*
+* @return
+*		- XST_SUCCESS if the block is decoded
+*		- XST_FAILURE otherwise
+*
+* @note		None
+*
+******************************************************************************/
+static u32 Lz4DecodeBlock(Lz4Stream *Stream, u32 BlockLen, u8 *Dst,
+		u32 DstSize, u32 *Pos)
+{
+	u32 Status;
+	u32 Left = BlockLen;
+	u32 Token;
+	u32 Length;
+	u32 Offset;
+	u32 High;
+	u8 *Out;
+	u8 *Match;
+
+	for (;;) {
+		if (Left == 0) {
+			return XST_FAILURE;
+		}
+		Status = Lz4Byte(Stream, &Token);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+		Left--;
+
+		/*
+		 * Literals
+		 */
+		Length = Token >> 4;
+		if (Length == LZ4_RUN_MASK) {
+			Status = Lz4Length(Stream, &Length, &Left);
+			if (Status != XST_SUCCESS) {
+				return XST_FAILURE;
+			}
+		}
+		if ((Length > Left) || (Length > (DstSize - *Pos))) {
+			return XST_FAILURE;
+		}
+		Status = Lz4Take(Stream, Dst + *Pos, Length);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+		*Pos += Length;
+		Left -= Length;
+
+		/*
+		 * The last sequence has no match
+		 */
+		if (Left == 0) {
+			return XST_SUCCESS;
+		}
+
+		if (Left < 2) {
+			return XST_FAILURE;
+		}
+		Status = Lz4Byte(Stream, &Offset);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+		Status = Lz4Byte(Stream, &High);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+		Left -= 2;
+		Offset |= High << 8;
+		if ((Offset == 0) || (Offset > *Pos)) {
+			return XST_FAILURE;
+		}
+
+		/*
+		 * Match
+		 */
+		Length = Token & LZ4_RUN_MASK;
+		if (Length == LZ4_RUN_MASK) {
+			Status = Lz4Length(Stream, &Length, &Left);
+			if (Status != XST_SUCCESS) {
+				return XST_FAILURE;
+			}
+		}
+		Length += LZ4_MIN_MATCH;
+		if (Length > (DstSize - *Pos)) {
+			return XST_FAILURE;
+		}
+
+		Out = Dst + *Pos;
+		Match = Out - Offset;
+		*Pos += Length;
+		if (Offset >= Length) {
+			(void)memcpy(Out, Match, Length);
+		} else {
+			/*
+			 * Overlapping match, repeats the last Offset bytes
+			 */
+			while (Length != 0) {
+				*Out++ = *Match++;
+				Length--;
+			}
+		}
+	}
+}
+
+/******************************************************************************
+*
+* This function reads the extension bytes of a literal or match length
+*
+* @param	Stream Compressed stream
+* @param	Length Length of the token, returns the full length
+* @param	Left Bytes left in the block, updated
+*
+* @return
+*		- XST_SUCCESS if the length is read
+*		- XST_FAILURE if it runs past the block
+*
+* @note		None
+*
+******************************************************************************/
+static u32 Lz4Length(Lz4Stream *Stream, u32 *Length, u32 *Left)
+{
+	u32 Status;
+	u32 Byte;
+
+	do {
+		if (*Left == 0) {
+			return XST_FAILURE;
+		}
+		Status = Lz4Byte(Stream, &Byte);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+		(*Left)--;
+		*Length += Byte;
+	} while (Byte == 0xFF);
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************
+*
+* This function copies bytes of the compressed stream, refilling it as
+* needed
+*
+* @param	Stream Compressed stream
+* @param	Dst Destination, NULL to skip the bytes
+* @param	Len Number of bytes
+*
+* @return
+*		- XST_SUCCESS if the bytes are copied
+*		- XST_FAILURE if the stream ends early
+*
+* @note		None
+*
+******************************************************************************/
+static u32 Lz4Take(Lz4Stream *Stream, u8 *Dst, u32 Len)
+{
+	u32 Count;
+
+	while (Len != 0) {
+		if (Stream->Avail == 0) {
+			if (Stream->Refill(Stream) != XST_SUCCESS) {
+				return XST_FAILURE;
+			}
+			if (Stream->Avail == 0) {
+				return XST_FAILURE;
+			}
+		}
+
+		Count = (Len < Stream->Avail) ? Len : Stream->Avail;
+		if (Dst != NULL) {
+			(void)memcpy(Dst, Stream->Next, Count);
+			Dst += Count;
+		}
+		Stream->Next += Count;
+		Stream->Avail -= Count;
+		Len -= Count;
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************
+*
+* This function reads a byte of the compressed stream
+*
+* @param	Stream Compressed stream
+* @param	Byte Returns the byte
+*
+* @return
+*		- XST_SUCCESS if the byte is read
+*		- XST_FAILURE if the stream ends early
+*
+* @note		None
+*
+******************************************************************************/
+static u32 Lz4Byte(Lz4Stream *Stream, u32 *Byte)
+{
+	u8 Value;
+
+	if (Stream->Avail != 0) {
+		*Byte = *Stream->Next++;
+		Stream->Avail--;
+		return XST_SUCCESS;
+	}
+
+	if (Lz4Take(Stream, &Value, 1) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	*Byte = Value;
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************
+*
+* This function reads a little endian word of the compressed stream
+*
+* @param	Stream Compressed stream
+* @param	Word Returns the word
+*
+* @return
+*		- XST_SUCCESS if the word is read
+*		- XST_FAILURE if the stream ends early
+*
+* @note		None
+*
+******************************************************************************/
+static u32 Lz4Word(Lz4Stream *Stream, u32 *Word)
+{
+	u8 Bytes[4];
+
+	if (Lz4Take(Stream, Bytes, 4) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	*Word = (u32)Bytes[0] | ((u32)Bytes[1] << 8) |
+			((u32)Bytes[2] << 16) | ((u32)Bytes[3] << 24);
+
+	return XST_SUCCESS;
+}
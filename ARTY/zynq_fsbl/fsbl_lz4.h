@@ -0,0 +1,86 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_lz4.h
+*
+* This file contains the LZ4 frame decoder of the compressed partitions.
+*
+* The decoder pulls the compressed stream from the caller in chunks through
+* a refill function, so that a partition is decompressed as it is read from
+* the boot device, with no staging of the whole compressed image. The output
+* is written to contiguous memory, which is also the history the matches of
+* linked blocks refer to. An optional flush function is called after each
+* block, for the caller to pass the decompressed data on while the next
+* block is decoded.
+*
+* Frames of the lz4 command line tool are supported, with independent or
+* linked blocks, of any block size. The header, block and content checksums
+* are skipped, the partition checksum covers the compressed stream. Frames
+* with a dictionary are rejected.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef ___FSBL_LZ4_H___
+#define ___FSBL_LZ4_H___
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+#define LZ4_FRAME_MAGIC		0x184D2204
+
+/**************************** Type Definitions *******************************/
+
+struct StructLz4Stream;
+
+/*
+ * Loads the next chunk of the compressed stream, sets Next and Avail, and
+ * returns XST_SUCCESS, or XST_FAILURE at the end of the stream
+ */
+typedef u32 (*Lz4RefillType)(struct StructLz4Stream *Stream);
+
+/*
+ * Takes the data decompressed so far, Length bytes from the start of the
+ * destination, and returns XST_SUCCESS, or XST_FAILURE to stop
+ */
+typedef u32 (*Lz4FlushType)(struct StructLz4Stream *Stream, u32 Length);
+
+typedef struct StructLz4Stream {
+	const u8 *Next;		/* Next compressed byte */
+	u32 Avail;		/* Compressed bytes at Next */
+	Lz4RefillType Refill;	/* Loads the next chunk */
+	Lz4FlushType Flush;	/* Called after each block, may be NULL */
+	void *Ref;		/* Caller data of Refill and Flush */
+} Lz4Stream;
+
+/************************** Function Prototypes ******************************/
+
+u32 Lz4Decompress(Lz4Stream *Stream, u8 *Dst, u32 DstSize, u32 *DstLen);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ___FSBL_LZ4_H___ */
@@ -0,0 +1,370 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_manifest.c
+*
+* Contains the boot manifest of FSBL_MANIFEST, see fsbl_manifest.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+#include "fsbl_manifest.h"
+
+#ifdef FSBL_MANIFEST
+#include "fsbl_bootdev.h"
+#include "fsbl_cpu1.h"
+
+/************************** Function Prototypes ******************************/
+
+static u32 FsblManifestCheckChunk(u32 Addr, u32 Length, u32 Leaf);
+static u32 FsblManifestChunkLength(const FsblManifestEntry *Entry,
+		u32 Index);
+static u32 FsblManifestSame(const u8 *Digest, const u8 *Expected);
+
+/************************** Variable Definitions *****************************/
+
+/*
+ * Manifest checked by FsblManifestLoad(), NULL if none
+ */
+static const FsblManifestHeader *Manifest;
+static const FsblManifestEntry *ManifestEntries;
+static const u8 *ManifestLeaves;
+
+/*****************************************************************************/
+/**
+*
+* This function checks the hash tree of the manifest partition, once the
+* partition is validated, and keeps it for the partitions after it.
+*
+* @param	Addr is the address the manifest partition is loaded at
+* @param	Length is the length of the partition in bytes
+*
+* @return
+*		- XST_SUCCESS if the manifest is kept
+*		- XST_FAILURE if it is malformed, its roots do not match or a
+*		partition it lists would be loaded over it
+*
+* @note		No manifest is kept after a failure.
+*
+******************************************************************************/
+u32 FsblManifestLoad(u32 Addr, u32 Length)
+{
+	const FsblManifestHeader *Header = (const FsblManifestHeader *)Addr;
+	const FsblManifestEntry *Entries;
+	const FsblManifestEntry *Entry;
+	const u8 *Leaves;
+	u8 Digest[SHA256_DIGEST_BYTE_SIZE];
+	u32 ChunkSize;
+	u32 Size;
+	u32 Index;
+
+	Manifest = NULL;
+
+	if ((Length < sizeof(FsblManifestHeader)) ||
+			(Length > FSBL_MANIFEST_MAX_SIZE) ||
+			(Header->Magic != FSBL_MANIFEST_MAGIC) ||
+			(Header->ChunkShift < FSBL_MANIFEST_MIN_SHIFT) ||
+			(Header->ChunkShift > FSBL_MANIFEST_MAX_SHIFT) ||
+			(Header->Count == 0) ||
+			(Header->Count > FSBL_MANIFEST_MAX_ENTRIES) ||
+			(Header->LeafCount > FSBL_MANIFEST_MAX_LEAVES)) {
+		fsbl_printf(DEBUG_GENERAL, "Boot manifest malformed\r\n");
+		return XST_FAILURE;
+	}
+
+	Size = sizeof(FsblManifestHeader) +
+			(Header->Count * sizeof(FsblManifestEntry)) +
+			(Header->LeafCount * SHA256_DIGEST_BYTE_SIZE);
+	if (Size > Length) {
+		fsbl_printf(DEBUG_GENERAL, "Boot manifest truncated\r\n");
+		return XST_FAILURE;
+	}
+
+	Entries = (const FsblManifestEntry *)(Header + 1);
+	Leaves = (const u8 *)(Entries + Header->Count);
+	ChunkSize = 1U << Header->ChunkShift;
+
+	Sha256((const u8 *)Entries, Header->Count * sizeof(FsblManifestEntry),
+			Digest);
+	if (FsblManifestSame(Digest, Header->Root) == 0) {
+		fsbl_printf(DEBUG_GENERAL, "Boot manifest root mismatch\r\n");
+		return XST_FAILURE;
+	}
+
+	for (Index = 0; Index < Header->Count; Index++) {
+		Entry = &Entries[Index];
+		if ((Entry->Length == 0) ||
+				(Entry->Leaves != (((Entry->Length - 1) >>
+					Header->ChunkShift) + 1)) ||
+				(Entry->FirstLeaf > Header->LeafCount) ||
+				(Entry->Leaves > (Header->LeafCount -
+					Entry->FirstLeaf))) {
+			fsbl_printf(DEBUG_GENERAL, "Manifest entry %lu malformed\r\n",
+					Index);
+			return XST_FAILURE;
+		}
+
+		if ((Entry->LoadAddr < (Addr + Size)) &&
+				(Addr < (Entry->LoadAddr + Entry->Length))) {
+			fsbl_printf(DEBUG_GENERAL, "Manifest entry %lu overlaps it\r\n",
+					Index);
+			return XST_FAILURE;
+		}
+
+		Sha256(Leaves + (Entry->FirstLeaf * SHA256_DIGEST_BYTE_SIZE),
+				Entry->Leaves * SHA256_DIGEST_BYTE_SIZE,
+				Digest);
+		if (FsblManifestSame(Digest, Entry->Root) == 0) {
+			fsbl_printf(DEBUG_GENERAL,
+					"Manifest entry %lu root mismatch\r\n", Index);
+			return XST_FAILURE;
+		}
+	}
+
+	Manifest = Header;
+	ManifestEntries = Entries;
+	ManifestLeaves = Leaves;
+
+	fsbl_printf(DEBUG_INFO, "Manifest of %lu partitions, %lu KB chunks\r\n",
+			Header->Count, ChunkSize >> 10);
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function looks a partition up in the manifest.
+*
+* @param	LoadAddr is the load address of the partition
+* @param	Length is its image length in bytes
+*
+* @return	The number of its entry, FSBL_MANIFEST_NONE if the manifest
+*		does not list it or there is no manifest
+*
+* @note		None.
+*
+******************************************************************************/
+u32 FsblManifestFind(u32 LoadAddr, u32 Length)
+{
+	u32 Index;
+
+	if (Manifest == NULL) {
+		return FSBL_MANIFEST_NONE;
+	}
+
+	for (Index = 0; Index < Manifest->Count; Index++) {
+		if ((ManifestEntries[Index].LoadAddr == LoadAddr) &&
+				(ManifestEntries[Index].Length == Length)) {
+			return Index;
+		}
+	}
+
+	return FSBL_MANIFEST_NONE;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function moves a partition the manifest lists from the boot device
+* to its load address, one chunk at a time. Each chunk read is handed to
+* CPU1 if it is free, or else checked on CPU0, while the next chunk is
+* read: on a linear boot device the PS DMA reads it meanwhile, on the
+* others CPU0 reads it while CPU1 checks.
+*
+* @param	EntryNum is the entry of the partition, from FsblManifestFind()
+* @param	SourceAddr is the offset of the partition in the boot device
+* @param	LoadAddr is the load address of the partition
+*
+* @return
+*		- XST_SUCCESS if the partition is moved and all its chunks
+*		match their hashes
+*		- XST_FAILURE if a read fails or a chunk does not match, the
+*		move stopping there
+*
+* @note		The CPU1 worker must not be running another job.
+*
+******************************************************************************/
+u32 FsblManifestMove(u32 EntryNum, u32 SourceAddr, u32 LoadAddr)
+{
+	const FsblManifestEntry *Entry;
+	const u8 *Leaf;
+	u32 ChunkSize;
+	u32 Index;
+	u32 Offset;
+	u32 Hash;
+	u32 Local;
+	u32 Status;
+	u32 WaitStatus;
+#ifdef FSBL_CPU1_WORKER
+	u32 Cpu1Chunk = FSBL_MANIFEST_NONE;
+#endif
+
+	if ((Manifest == NULL) || (EntryNum >= Manifest->Count)) {
+		return XST_FAILURE;
+	}
+
+	Entry = &ManifestEntries[EntryNum];
+	Leaf = ManifestLeaves + (Entry->FirstLeaf * SHA256_DIGEST_BYTE_SIZE);
+	ChunkSize = 1U << Manifest->ChunkShift;
+
+	Status = FsblBootDevRead(SourceAddr, LoadAddr,
+			FsblManifestChunkLength(Entry, 0));
+
+	for (Index = 0; (Status == XST_SUCCESS) && (Index < Entry->Leaves);
+			Index++) {
+		/*
+		 * Chunk Index is in memory
+		 */
+		Offset = Index * ChunkSize;
+		Hash = (u32)(Leaf + (Index * SHA256_DIGEST_BYTE_SIZE));
+		Local = Index;
+#ifdef FSBL_CPU1_WORKER
+		if ((Cpu1Chunk != FSBL_MANIFEST_NONE) &&
+				(FsblCpu1Busy() == 0)) {
+			Status = FsblCpu1Wait();
+			if (Status != XST_SUCCESS) {
+				fsbl_printf(DEBUG_GENERAL,
+						"Chunk %lu fails its hash\r\n", Cpu1Chunk);
+				Cpu1Chunk = FSBL_MANIFEST_NONE;
+				break;
+			}
+			Cpu1Chunk = FSBL_MANIFEST_NONE;
+		}
+
+		if ((Cpu1Chunk == FSBL_MANIFEST_NONE) &&
+				(FsblCpu1Post(FsblManifestCheckChunk,
+					LoadAddr + Offset,
+					FsblManifestChunkLength(Entry, Index),
+					Hash) == XST_SUCCESS)) {
+			Cpu1Chunk = Index;
+			Local = FSBL_MANIFEST_NONE;
+		}
+#endif
+
+		/*
+		 * The next chunk is read while this one is checked
+		 */
+		if ((Index + 1) < Entry->Leaves) {
+			Status = FsblBootDevSubmit(SourceAddr + Offset + ChunkSize,
+					LoadAddr + Offset + ChunkSize,
+					FsblManifestChunkLength(Entry, Index + 1));
+		}
+
+		if ((Status == XST_SUCCESS) && (Local != FSBL_MANIFEST_NONE)) {
+			Status = FsblManifestCheckChunk(LoadAddr + Offset,
+					FsblManifestChunkLength(Entry, Index), Hash);
+			if (Status != XST_SUCCESS) {
+				fsbl_printf(DEBUG_GENERAL,
+						"Chunk %lu fails its hash\r\n", Index);
+			}
+		}
+
+		WaitStatus = FsblBootDevWait();
+		if (Status == XST_SUCCESS) {
+			Status = WaitStatus;
+		}
+	}
+
+#ifdef FSBL_CPU1_WORKER
+	if (Cpu1Chunk != FSBL_MANIFEST_NONE) {
+		WaitStatus = FsblCpu1Wait();
+		if ((WaitStatus != XST_SUCCESS) && (Status == XST_SUCCESS)) {
+			fsbl_printf(DEBUG_GENERAL,
+					"Chunk %lu fails its hash\r\n", Cpu1Chunk);
+			Status = XST_FAILURE;
+		}
+	}
+#endif
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function checks a chunk against its hash.
+*
+* @param	Addr is the address of the chunk
+* @param	Length is its length in bytes
+* @param	Leaf is the address of its hash in the manifest
+*
+* @return	XST_SUCCESS if they match, XST_FAILURE otherwise
+*
+* @note		Runs on CPU0 or on CPU1.
+*
+******************************************************************************/
+static u32 FsblManifestCheckChunk(u32 Addr, u32 Length, u32 Leaf)
+{
+	u8 Digest[SHA256_DIGEST_BYTE_SIZE];
+
+	Sha256((const u8 *)Addr, Length, Digest);
+
+	return FsblManifestSame(Digest, (const u8 *)Leaf) ?
+			XST_SUCCESS : XST_FAILURE;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function gives the length of a chunk of a partition, the last one
+* being short.
+*
+* @param	Entry is the entry of the partition
+* @param	Index is the chunk number
+*
+* @return	Length of the chunk in bytes
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 FsblManifestChunkLength(const FsblManifestEntry *Entry, u32 Index)
+{
+	u32 Offset = Index << Manifest->ChunkShift;
+	u32 ChunkSize = 1U << Manifest->ChunkShift;
+
+	return ((Entry->Length - Offset) < ChunkSize) ?
+			(Entry->Length - Offset) : ChunkSize;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function compares two SHA-256 digests.
+*
+* @param	Digest is the calculated digest
+* @param	Expected is the one of the manifest
+*
+* @return	1 if they are the same, 0 otherwise
+*
+* @note		All the bytes are compared, whatever the first difference.
+*
+******************************************************************************/
+static u32 FsblManifestSame(const u8 *Digest, const u8 *Expected)
+{
+	u32 Index;
+	u8 Difference = 0;
+
+	for (Index = 0; Index < SHA256_DIGEST_BYTE_SIZE; Index++) {
+		Difference |= Digest[Index] ^ Expected[Index];
+	}
+
+	return (Difference == 0) ? 1 : 0;
+}
+#endif
@@ -0,0 +1,124 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_manifest.h
+*
+* This file contains the boot manifest of FSBL_MANIFEST.
+*
+* The boot manifest is a PS partition of the boot image, made by
+* tools/boot_manifest.py, that holds a SHA-256 hash for each chunk of the
+* plain PS partitions after it. It is loaded at FSBL_MANIFEST_ADDR as the
+* first partition after FSBL and validated as any other partition, by its
+* RSA signature or its checksum, before FsblManifestLoad() checks its hash
+* tree: the root in its header is the hash of its entries, the root of each
+* entry the hash of the chunk hashes of its partition. The partition does
+* not give the handoff address.
+*
+* A plain PS partition the manifest lists is then moved by
+* FsblManifestMove() chunk by chunk through the boot device layer, each
+* chunk being checked against its hash as soon as it is read, on CPU1 with
+* FSBL_CPU1_WORKER when it is free and on CPU0 otherwise, while the next
+* chunk is read. The chunks are checked out of order, on both CPUs, and a
+* bad one stops the move at once instead of after the whole partition is
+* read. The MD5 checksum of the partition is not calculated.
+*
+* The manifest is little endian, in words:
+*	- FsblManifestHeader, with the magic FSBL_MANIFEST_MAGIC
+*	- Count entries, FsblManifestEntry, of the partitions in load order
+*	- LeafCount chunk hashes, the ones of each entry one after the other
+*
+* A partition is found in the manifest by its load address and length,
+* which do not change when the manifest is added to the image. The last
+* chunk of a partition may be short.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef ___FSBL_MANIFEST_H___
+#define ___FSBL_MANIFEST_H___
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+#include "sha256.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Most bytes of the manifest, at the end of the DDR unless set
+ */
+#define FSBL_MANIFEST_MAX_SIZE		0x40000
+#define FSBL_MANIFEST_MAX_LEAVES	\
+	(FSBL_MANIFEST_MAX_SIZE / SHA256_DIGEST_BYTE_SIZE)
+#ifndef FSBL_MANIFEST_ADDR
+#define FSBL_MANIFEST_ADDR		\
+	(DDR_END_ADDR + 1 - FSBL_MANIFEST_MAX_SIZE)
+#endif
+
+#define FSBL_MANIFEST_MAGIC		0x31464D46	/* "FMF1" */
+#define FSBL_MANIFEST_MAX_ENTRIES	14
+
+/*
+ * Chunks from 4 KB to 16 MB
+ */
+#define FSBL_MANIFEST_MIN_SHIFT		12
+#define FSBL_MANIFEST_MAX_SHIFT		24
+
+/*
+ * FsblManifestFind() of a partition the manifest does not list
+ */
+#define FSBL_MANIFEST_NONE		0xFFFFFFFF
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32 Magic;		/* FSBL_MANIFEST_MAGIC */
+	u32 ChunkShift;		/* Log2 of the chunk size */
+	u32 Count;		/* Entries */
+	u32 LeafCount;		/* Chunk hashes */
+	u8 Root[SHA256_DIGEST_BYTE_SIZE]; /* Hash of the entries */
+} FsblManifestHeader;
+
+/*
+ * A partition, its chunk hashes being the leaves FirstLeaf onwards
+ */
+typedef struct {
+	u32 LoadAddr;
+	u32 Length;		/* Bytes, the image length of the partition */
+	u32 FirstLeaf;
+	u32 Leaves;
+	u8 Root[SHA256_DIGEST_BYTE_SIZE]; /* Hash of its chunk hashes */
+} FsblManifestEntry;
+
+/************************** Function Prototypes ******************************/
+
+#ifdef FSBL_MANIFEST
+u32 FsblManifestLoad(u32 Addr, u32 Length);
+u32 FsblManifestFind(u32 LoadAddr, u32 Length);
+u32 FsblManifestMove(u32 EntryNum, u32 SourceAddr, u32 LoadAddr);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ___FSBL_MANIFEST_H___ */
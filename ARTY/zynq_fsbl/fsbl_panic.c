@@ -0,0 +1,415 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_panic.c
+*
+* Contains the panic dump of FSBL_PANIC, see fsbl_panic.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.6  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+#include "fsbl_panic.h"
+
+#ifdef FSBL_PANIC
+#if defined(XPAR_PS7_QSPI_LINEAR_0_S_AXI_BASEADDR) || \
+		defined(XPAR_PS7_QSPI_LINEAR_0_BASEADDRESS)
+#include "qspi.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "fsbl_timeline.h"
+#ifndef SDT
+#include "xtime_l.h"
+#else
+#include "xiltimer.h"
+#endif
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+#include "xwdtps.h"
+#endif
+
+/************************** Constant Definitions *****************************/
+
+#define FSBL_PANIC_MAX_BLOCKS		3
+#define FSBL_PANIC_VECTOR_FRAME		24	/* R0-R3, R12, LR of the vector */
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+
+static void FsblPanicRegs(FsblPanicHeader *Header, u32 Reason);
+static u32 FsblPanicStackTop(u32 Mode);
+static u32 FsblPanicErased(u32 Length);
+static u32 FsblPanicEmit(const void *DataPtr, u32 Length);
+
+/************************** Variable Definitions *****************************/
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+extern XWdtPs Watchdog;	/* Instance of WatchDog Timer	*/
+#endif
+
+/*
+ * Set by the exception vectors of the BSP
+ */
+extern u32 DataAbortAddr;
+extern u32 PrefetchAbortAddr;
+extern u32 UndefinedExceptionAddr;
+
+/*
+ * Tops of the stacks, from the linker script
+ */
+extern u8 _stack[];
+extern u8 __irq_stack[];
+extern u8 __supervisor_stack[];
+extern u8 __abort_stack[];
+extern u8 __fiq_stack[];
+extern u8 __undef_stack[];
+
+static FsblPanicHeader PanicHeader;
+static FsblPanicBlock PanicBlock[FSBL_PANIC_MAX_BLOCKS];
+
+/*
+ * Page being filled, its flash offset, and the sum of the words of the
+ * pages of the body
+ */
+static u32 PanicPage[FSBL_PANIC_PAGE_SIZE / 4];
+static u32 PanicPageFill;
+static u32 PanicAddress;
+static u32 PanicSum;
+
+/******************************************************************************/
+/**
+*
+* This function writes the panic dump of a failed boot to the reserved
+* region of the QSPI flash, if the region reads erased. It is called by
+* ErrorLockdown() before the fallback.
+*
+* @param	Reason is the status passed to ErrorLockdown()
+*
+* @return	None
+*
+* @note		Nothing is written if the QSPI flash is not the boot device
+*		or is not set up yet, the dump needs no other driver.
+*
+****************************************************************************/
+void FsblPanicDump(u32 Reason)
+{
+	u32 Mode;
+	u32 Top;
+	u32 Sp;
+	u32 Index;
+	u32 NumBlocks = 0;
+	u32 Length = FSBL_PANIC_PAGE_SIZE;
+	XTime Time;
+
+	XTime_GetTime(&Time);
+
+	PanicHeader.Magic = FSBL_PANIC_MAGIC;
+	PanicHeader.Version = FSBL_PANIC_VERSION;
+	PanicHeader.Source = FSBL_PANIC_SOURCE_FSBL;
+	PanicHeader.Reason = Reason;
+	PanicHeader.Time = Time;
+	FsblPanicRegs(&PanicHeader, Reason);
+
+	/*
+	 * The stack of the exception mode, then that of main(), from the stack
+	 * pointer up
+	 */
+	Mode = PanicHeader.Regs[FSBL_PANIC_REG_CPSR] & XREG_CPSR_MODE_BITS;
+	if (Mode != XREG_CPSR_SYSTEM_MODE) {
+		Sp = PanicHeader.Regs[FSBL_PANIC_REG_SP];
+		Top = FsblPanicStackTop(Mode);
+		if ((Top > Sp) && ((Top - Sp) <= 0x10000)) {
+			PanicBlock[NumBlocks].Tag = FSBL_PANIC_BLOCK_EXC_STACK;
+			PanicBlock[NumBlocks].Address = Sp & ~0x3;
+			PanicBlock[NumBlocks].Length = Top - (Sp & ~0x3);
+			NumBlocks++;
+		}
+	}
+
+	Sp = PanicHeader.Regs[FSBL_PANIC_REG_SYS_SP];
+	Top = (u32)_stack;
+	if ((Top > Sp) && ((Top - Sp) <= 0x10000)) {
+		PanicBlock[NumBlocks].Tag = FSBL_PANIC_BLOCK_SYS_STACK;
+		PanicBlock[NumBlocks].Address = Sp & ~0x3;
+		PanicBlock[NumBlocks].Length = Top - (Sp & ~0x3);
+		NumBlocks++;
+	}
+
+#ifdef FSBL_TIMELINE
+	PanicBlock[NumBlocks].Tag = FSBL_PANIC_BLOCK_TIMELINE;
+	PanicBlock[NumBlocks].Address = FSBL_TIMELINE_ADDR;
+	PanicBlock[NumBlocks].Length = FSBL_TIMELINE_SIZE;
+	NumBlocks++;
+#endif
+
+	for (Index = 0; Index < NumBlocks; Index++) {
+		if (PanicBlock[Index].Length > FSBL_PANIC_STACK_BYTES &&
+				PanicBlock[Index].Tag != FSBL_PANIC_BLOCK_TIMELINE) {
+			PanicBlock[Index].Length = FSBL_PANIC_STACK_BYTES;
+		}
+		if ((Length + sizeof(FsblPanicBlock) +
+				PanicBlock[Index].Length) > FSBL_PANIC_SIZE) {
+			break;
+		}
+		Length += sizeof(FsblPanicBlock) + PanicBlock[Index].Length;
+	}
+	NumBlocks = Index;
+
+	PanicHeader.NumBlocks = NumBlocks;
+	PanicHeader.Length = Length;
+
+	if (FsblPanicErased(Length) != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL, "Panic dump kept, region in use\r\n");
+		return;
+	}
+
+	/*
+	 * Body first, in whole pages
+	 */
+	PanicPageFill = 0;
+	PanicAddress = FSBL_PANIC_OFFSET + FSBL_PANIC_PAGE_SIZE;
+	PanicSum = 0;
+	for (Index = 0; Index < NumBlocks; Index++) {
+		if ((FsblPanicEmit(&PanicBlock[Index],
+				sizeof(FsblPanicBlock)) != XST_SUCCESS) ||
+				(FsblPanicEmit((const void *)PanicBlock[Index].Address,
+				PanicBlock[Index].Length) != XST_SUCCESS)) {
+			fsbl_printf(DEBUG_GENERAL, "Panic dump failed\r\n");
+			return;
+		}
+	}
+	if ((PanicPageFill != 0) && (FsblPanicEmit(NULL, 0) != XST_SUCCESS)) {
+		fsbl_printf(DEBUG_GENERAL, "Panic dump failed\r\n");
+		return;
+	}
+
+	/*
+	 * Then the header, which makes the dump valid
+	 */
+	PanicHeader.Checksum = PanicSum;
+	if (QspiProgram(FSBL_PANIC_OFFSET, (const u8 *)&PanicHeader,
+			sizeof(PanicHeader)) != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL, "Panic dump failed\r\n");
+		return;
+	}
+
+	fsbl_printf(DEBUG_GENERAL, "Panic dump of %lu bytes at 0x%08lx\r\n",
+			Length, (u32)FSBL_PANIC_OFFSET);
+}
+
+/******************************************************************************/
+/**
+*
+* This function takes the registers of the dump: the current mode, its
+* saved status, stack pointer and return address, the fault registers, the
+* stack pointer and link register of the system mode, in which main() runs,
+* and, in the abort and undefined modes, the registers the vector saved at
+* the top of the stack of the mode.
+*
+* @param	Header is the header that takes the registers
+* @param	Reason is the status passed to ErrorLockdown()
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+static void FsblPanicRegs(FsblPanicHeader *Header, u32 Reason)
+{
+	u32 *Regs = Header->Regs;
+	u32 *Frame;
+	u32 Mode;
+	u32 Saved;
+	u32 Index;
+
+	for (Index = 0; Index < FSBL_PANIC_NUM_REGS; Index++) {
+		Regs[Index] = 0;
+	}
+
+	Regs[FSBL_PANIC_REG_CPSR] = mfcpsr();
+	Mode = Regs[FSBL_PANIC_REG_CPSR] & XREG_CPSR_MODE_BITS;
+	if ((Mode != XREG_CPSR_SYSTEM_MODE) && (Mode != XREG_CPSR_USER_MODE)) {
+		__asm__ __volatile__("mrs %0, spsr" : "=r" (Regs[FSBL_PANIC_REG_SPSR]));
+	}
+	__asm__ __volatile__("mov %0, sp" : "=r" (Regs[FSBL_PANIC_REG_SP]));
+	Regs[FSBL_PANIC_REG_LR] = (u32)__builtin_return_address(0);
+
+	Regs[FSBL_PANIC_REG_DFSR] = mfcp(XREG_CP15_DATA_FAULT_STATUS);
+	Regs[FSBL_PANIC_REG_DFAR] = mfcp(XREG_CP15_DATA_FAULT_ADDRESS);
+	Regs[FSBL_PANIC_REG_IFSR] = mfcp(XREG_CP15_INST_FAULT_STATUS);
+	Regs[FSBL_PANIC_REG_IFAR] = mfcp(XREG_CP15_INST_FAULT_ADDRESS);
+
+	/*
+	 * Banked registers of the system mode, through a switch to the mode
+	 */
+	__asm__ __volatile__(
+		"mrs	%2, cpsr\n"
+		"cps	#0x1F\n"
+		"mov	%0, sp\n"
+		"mov	%1, lr\n"
+		"msr	cpsr_c, %2\n"
+		: "=&r" (Regs[FSBL_PANIC_REG_SYS_SP]),
+		  "=&r" (Regs[FSBL_PANIC_REG_SYS_LR]), "=&r" (Saved));
+
+	if (Reason == EXCEPTION_ID_DATA_ABORT_INT) {
+		Regs[FSBL_PANIC_REG_FAULT_PC] = DataAbortAddr;
+	} else if (Reason == EXCEPTION_ID_PREFETCH_ABORT_INT) {
+		Regs[FSBL_PANIC_REG_FAULT_PC] = PrefetchAbortAddr;
+	} else if (Reason == EXCEPTION_ID_UNDEFINED_INT) {
+		Regs[FSBL_PANIC_REG_FAULT_PC] = UndefinedExceptionAddr;
+	} else {
+		Regs[FSBL_PANIC_REG_FAULT_PC] = 0;
+	}
+
+	if ((Mode == XREG_CPSR_DATA_ABORT_MODE) ||
+			(Mode == XREG_CPSR_UNDEFINED_MODE)) {
+		Frame = (u32 *)(FsblPanicStackTop(Mode) - FSBL_PANIC_VECTOR_FRAME);
+		for (Index = 0; Index < 5; Index++) {
+			Regs[FSBL_PANIC_REG_R0 + Index] = Frame[Index];
+		}
+	}
+}
+
+/******************************************************************************/
+/**
+*
+* This function returns the top of the stack of a mode.
+*
+* @param	Mode is the mode bits of the CPSR
+*
+* @return	Top of the stack, 0 for an unknown mode
+*
+* @note		None
+*
+****************************************************************************/
+static u32 FsblPanicStackTop(u32 Mode)
+{
+	switch (Mode) {
+	case XREG_CPSR_IRQ_MODE:
+		return (u32)__irq_stack;
+	case XREG_CPSR_FIQ_MODE:
+		return (u32)__fiq_stack;
+	case XREG_CPSR_SVC_MODE:
+		return (u32)__supervisor_stack;
+	case XREG_CPSR_DATA_ABORT_MODE:
+		return (u32)__abort_stack;
+	case XREG_CPSR_UNDEFINED_MODE:
+		return (u32)__undef_stack;
+	case XREG_CPSR_SYSTEM_MODE:
+	case XREG_CPSR_USER_MODE:
+		return (u32)_stack;
+	default:
+		return 0;
+	}
+}
+
+/******************************************************************************/
+/**
+*
+* This function checks that the pages a dump of Length bytes takes read
+* erased.
+*
+* @param	Length is the length of the dump in bytes
+*
+* @return	XST_SUCCESS if they do, XST_FAILURE otherwise
+*
+* @note		PanicPage is used for the reads.
+*
+****************************************************************************/
+static u32 FsblPanicErased(u32 Length)
+{
+	u32 Offset;
+	u32 Index;
+
+	for (Offset = 0; Offset < Length; Offset += FSBL_PANIC_PAGE_SIZE) {
+		if (QspiAccess(FSBL_PANIC_OFFSET + Offset, (u32)PanicPage,
+				FSBL_PANIC_PAGE_SIZE) != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+		for (Index = 0; Index < (FSBL_PANIC_PAGE_SIZE / 4); Index++) {
+			if (PanicPage[Index] != 0xFFFFFFFF) {
+				return XST_FAILURE;
+			}
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function adds bytes to the body of the dump and programs each page
+* as it fills. Lengths are multiples of 4 bytes. A call with no bytes
+* programs what the page being filled holds.
+*
+* @param	DataPtr is the data to be added
+* @param	Length is the number of bytes
+*
+* @return	XST_SUCCESS if the pages are programmed, XST_FAILURE otherwise
+*
+* @note		None
+*
+****************************************************************************/
+static u32 FsblPanicEmit(const void *DataPtr, u32 Length)
+{
+	const u32 *Word = (const u32 *)DataPtr;
+	u32 Flush = (Length == 0) ? 1 : 0;
+
+	while ((Length > 0) || (Flush != 0)) {
+		if ((Length > 0) && (PanicPageFill < (FSBL_PANIC_PAGE_SIZE / 4))) {
+			PanicPage[PanicPageFill] = *Word++;
+			PanicSum += PanicPage[PanicPageFill];
+			PanicPageFill++;
+			Length -= 4;
+			if (PanicPageFill < (FSBL_PANIC_PAGE_SIZE / 4)) {
+				continue;
+			}
+		}
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+		if (Watchdog.IsReady == XIL_COMPONENT_IS_READY) {
+			XWdtPs_RestartWdt(&Watchdog);
+		}
+#endif
+		if (QspiProgram(PanicAddress, (const u8 *)PanicPage,
+				PanicPageFill * 4) != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		PanicAddress += FSBL_PANIC_PAGE_SIZE;
+		PanicPageFill = 0;
+		Flush = 0;
+	}
+
+	return XST_SUCCESS;
+}
+#else
+
+/*
+ * No QSPI flash in the design, nowhere to write the dump
+ */
+void FsblPanicDump(u32 Reason)
+{
+	(void)Reason;
+}
+#endif
+#endif /* FSBL_PANIC */
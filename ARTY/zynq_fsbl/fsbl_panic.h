@@ -0,0 +1,149 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_panic.h
+*
+* This file contains the panic dump of FSBL_PANIC.
+*
+* When the boot fails, ErrorLockdown() writes what is needed to tell why to
+* a reserved region of the QSPI flash before the fallback resets the PS:
+* the registers of the failing mode, the fault status and address registers,
+* the two stacks in use and the boot timeline of FSBL_TIMELINE. The region,
+* FSBL_PANIC_SIZE bytes at FSBL_PANIC_OFFSET, is left erased by the flash
+* programming tools and is only ever programmed, never erased, by FSBL:
+* page programs of 256 bytes, about half a millisecond each, so that the
+* few kilobytes of a dump are written in a few milliseconds, well before
+* the watchdog fires, and without the hundreds of milliseconds of a sector
+* erase. The body of the dump is programmed first and its header last, a
+* dump with a header is therefore complete.
+*
+* Only the first failure is kept: a region that does not read erased is
+* left as it is, until it is read out and erased again from the host with
+* the flash programming tools, so that a unit stuck in a boot loop keeps
+* the dump of the first failure.
+*
+* The dump has the layout of the panic dump of the application,
+* panic_dump.h, and is decoded by app_component/tools/panic_decode.py:
+* an FsblPanicHeader, padded to a page, then FsblPanicHeader.NumBlocks
+* blocks, each an FsblPanicBlock and its data padded to a word.
+*
+* Only single flash connections with the region in the first 16 MB are
+* handled, as for the read of the image index.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.6  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef ___FSBL_PANIC_H___
+#define ___FSBL_PANIC_H___
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Reserved region of the flash, the 64 KB sector below the image index of
+ * FSBL_IMAGE_INDEX by default
+ */
+#ifndef FSBL_PANIC_OFFSET
+#define FSBL_PANIC_OFFSET		0x00FE0000
+#endif
+#ifndef FSBL_PANIC_SIZE
+#define FSBL_PANIC_SIZE			0x00010000
+#endif
+
+/*
+ * Bytes of each stack that are dumped, from the stack pointer up
+ */
+#ifndef FSBL_PANIC_STACK_BYTES
+#define FSBL_PANIC_STACK_BYTES		0x800
+#endif
+
+#define FSBL_PANIC_MAGIC		0x43494E50	/* "PNIC" */
+#define FSBL_PANIC_VERSION		1
+#define FSBL_PANIC_PAGE_SIZE		256	/* Bytes of a page program */
+
+/*
+ * Source of a dump
+ */
+#define FSBL_PANIC_SOURCE_FSBL		1
+#define FSBL_PANIC_SOURCE_APP		2
+
+/*
+ * Registers of a dump, by index into FsblPanicHeader.Regs
+ */
+#define FSBL_PANIC_REG_CPSR		0	/* Mode of the dump */
+#define FSBL_PANIC_REG_SPSR		1	/* Mode that failed */
+#define FSBL_PANIC_REG_SP		2
+#define FSBL_PANIC_REG_LR		3
+#define FSBL_PANIC_REG_FAULT_PC		4	/* Instruction of the exception */
+#define FSBL_PANIC_REG_DFSR		5
+#define FSBL_PANIC_REG_DFAR		6
+#define FSBL_PANIC_REG_IFSR		7
+#define FSBL_PANIC_REG_IFAR		8
+#define FSBL_PANIC_REG_SYS_SP		9	/* System mode, main() */
+#define FSBL_PANIC_REG_SYS_LR		10
+#define FSBL_PANIC_REG_R0		11	/* R0-R3, R12 of the vector */
+#define FSBL_PANIC_NUM_REGS		16
+
+/*
+ * Blocks of a dump
+ */
+#define FSBL_PANIC_BLOCK_EXC_STACK	1	/* Stack of the exception mode */
+#define FSBL_PANIC_BLOCK_SYS_STACK	2	/* Stack of main() */
+#define FSBL_PANIC_BLOCK_TIMELINE	3	/* Record of fsbl_timeline.h */
+#define FSBL_PANIC_BLOCK_TRACE		4	/* Xil_TraceBuf of xil_trace.h */
+#define FSBL_PANIC_BLOCK_STATS		5	/* Counters of the application */
+#define FSBL_PANIC_BLOCK_USER		0x100	/* First of the application */
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32 Magic;		/* FSBL_PANIC_MAGIC */
+	u16 Version;		/* FSBL_PANIC_VERSION */
+	u16 Source;		/* FSBL_PANIC_SOURCE_* */
+	u32 Length;		/* Bytes of the dump with this header */
+	u32 Checksum;		/* Sum of the words of the blocks */
+	u32 Reason;		/* Status passed to ErrorLockdown() */
+	u32 NumBlocks;
+	u64 Time;		/* Global timer */
+	u32 Regs[FSBL_PANIC_NUM_REGS];
+} FsblPanicHeader;
+
+typedef struct {
+	u32 Tag;		/* FSBL_PANIC_BLOCK_* */
+	u32 Address;		/* Where the data was */
+	u32 Length;		/* Bytes of data that follow */
+} FsblPanicBlock;
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+
+void FsblPanicDump(u32 Reason);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ___FSBL_PANIC_H___ */
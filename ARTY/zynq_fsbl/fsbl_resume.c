@@ -0,0 +1,127 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_resume.c
+*
+* Contains the resume from a suspend to RAM of FSBL_RESUME, see
+* fsbl_resume.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+#include "fsbl_resume.h"
+
+#ifdef FSBL_RESUME
+#include <string.h>
+#include "xil_cache.h"
+#include "xil_mem.h"
+#include "fsbl_timeline.h"
+#ifdef STDOUT_BASEADDRESS
+#ifdef XPAR_XUARTPS_0_BASEADDR
+#include "xuartps_hw.h"
+#endif
+#endif
+
+/************************** Constant Definitions *****************************/
+
+#define FSBL_RESUME_RECORD_WORDS	((sizeof(FsblResumeRecord) / 4) - 1)
+
+/*****************************************************************************/
+/**
+*
+* This function takes the resume flag out of the reboot status register,
+* so that it is seen by one boot only.
+*
+* @param	None.
+*
+* @return	1 if the application suspended to RAM before the reset, 0
+*		otherwise
+*
+* @note		None.
+*
+******************************************************************************/
+u32 FsblResumeRequested(void)
+{
+	u32 RebootStatus = Xil_In32(REBOOT_STATUS_REG);
+
+	if ((RebootStatus & FSBL_RESUME_MASK) == 0) {
+		return 0;
+	}
+	Xil_Out32(REBOOT_STATUS_REG, RebootStatus & ~FSBL_RESUME_MASK);
+
+	return 1;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function resumes the application when the record and the saved
+* state it points to are valid, and returns for a cold boot otherwise. The
+* record is cleared either way.
+*
+* @param	None.
+*
+* @return	None, it does not return on a resume.
+*
+* @note		Call it once the DDR is up, before anything writes to it.
+*
+******************************************************************************/
+void FsblResume(void)
+{
+	FsblResumeRecord Record;
+	u32 Valid;
+
+	memcpy(&Record, (void *)FSBL_RESUME_ADDR, sizeof(FsblResumeRecord));
+	memset((void *)FSBL_RESUME_ADDR, 0, sizeof(FsblResumeRecord));
+
+	Valid = ((Record.Magic == FSBL_RESUME_MAGIC) &&
+		(Record.Checksum == Xil_MemSum32((u32 *)&Record,
+				FSBL_RESUME_RECORD_WORDS)) &&
+		((Record.ContextLen & 3) == 0) && (Record.ContextLen != 0) &&
+		(Record.Context >= DDR_START_ADDR) &&
+		(Record.Context <= DDR_END_ADDR) &&
+		(Record.ContextLen <= (DDR_END_ADDR - Record.Context + 1)) &&
+		(Record.Vector >= DDR_START_ADDR) &&
+		(Record.Vector <= DDR_END_ADDR)) ? 1 : 0;
+	if ((Valid == 0) || (Record.ContextSum != Xil_MemSum32(
+			(u32 *)Record.Context, Record.ContextLen / 4))) {
+		fsbl_printf(DEBUG_GENERAL,"RESUME_FAIL : cold boot\r\n");
+		return;
+	}
+
+	fsbl_printf(DEBUG_GENERAL,"RESUME 0x%08lx\r\n",
+			(unsigned long)Record.Vector);
+	ClearFSBLIn();
+
+#ifdef FSBL_TIMELINE
+	FsblTimelineClose();
+#endif
+#ifdef STDOUT_BASEADDRESS
+#ifdef XPAR_XUARTPS_0_BASEADDR
+	XUartPs_StdoutFlush();
+#endif
+#endif
+#ifdef FSBL_DCACHE
+	Xil_DCacheFlush();
+	Xil_DCacheDisable();
+#endif
+
+	FsblHandoffExit(Record.Vector);
+}
+#endif
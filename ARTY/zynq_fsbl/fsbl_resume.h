@@ -0,0 +1,87 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_resume.h
+*
+* This file contains the resume from a suspend to RAM of FSBL_RESUME.
+*
+* The application suspends to RAM, suspend.h of the application, with the
+* DDR in self-refresh, its state saved in DDR and a record of it at
+* FSBL_RESUME_ADDR in the high OCM, out of the FSBL and application linker
+* scripts, and with FSBL_RESUME_MASK set in the reboot status register,
+* which a system reset keeps. After such a reset, once ps7_init has taken
+* the DDR out of self-refresh and before the DDR check writes to it, FSBL
+* takes the flag and the record, clears both so that a resume that fails
+* is not tried again, and jumps to the resume vector of the record instead
+* of loading the boot image when the record and the sum of the saved state
+* are valid.
+*
+* The PL is not configured on a resume, the application loads its
+* bitstream again.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef ___FSBL_RESUME_H___
+#define ___FSBL_RESUME_H___
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Below the deferred partitions, kept out of the FSBL and application
+ * linker scripts
+ */
+#define FSBL_RESUME_ADDR		0xFFFFF300
+#define FSBL_RESUME_SIZE		0x100
+
+#define FSBL_RESUME_MAGIC		0x314D5352	/* "RSM1" */
+
+/**************************** Type Definitions *******************************/
+
+/*
+ * The record, the checksum is Xil_MemSum32 of the words before it
+ */
+typedef struct {
+	u32 Magic;
+	u32 Vector;		/* Resume vector of the application */
+	u32 Context;		/* Address of the saved state, in DDR */
+	u32 ContextLen;		/* Bytes, a multiple of 4 */
+	u32 ContextSum;		/* Xil_MemSum32 of the saved state */
+	u32 Checksum;
+} FsblResumeRecord;
+
+/************************** Function Prototypes ******************************/
+
+#ifdef FSBL_RESUME
+u32 FsblResumeRequested(void);
+void FsblResume(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ___FSBL_RESUME_H___ */
@@ -0,0 +1,162 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_timeline.c
+*
+* Contains the boot timeline of FSBL_TIMELINE, see fsbl_timeline.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+#include "fsbl_timeline.h"
+
+#ifdef FSBL_TIMELINE
+#include "xil_cache.h"
+#ifndef SDT
+#include "xtime_l.h"
+#else
+#include "xiltimer.h"
+#endif
+
+/************************** Constant Definitions *****************************/
+
+#define FSBL_GTIMER_BASEADDR		0xF8F00200
+#define FSBL_GTIMER_CONTROL_OFFSET	0x08
+#define FSBL_GTIMER_ENABLE_MASK		0x01
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+
+/************************** Variable Definitions *****************************/
+
+static FsblTimelineHeader *const TimelineHeader =
+		(FsblTimelineHeader *)FSBL_TIMELINE_ADDR;
+static FsblTimelineEntry *const TimelineEntry =
+		(FsblTimelineEntry *)(FSBL_TIMELINE_ADDR +
+				sizeof(FsblTimelineHeader));
+
+/******************************************************************************/
+/**
+*
+* This function empties the timeline record and starts the global timer if
+* the Boot ROM left it stopped. It is called first thing in main.
+*
+* @param	None
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+void FsblTimelineInit(void)
+{
+	u32 Control;
+
+	Control = Xil_In32(FSBL_GTIMER_BASEADDR + FSBL_GTIMER_CONTROL_OFFSET);
+	if ((Control & FSBL_GTIMER_ENABLE_MASK) == 0) {
+		Xil_Out32(FSBL_GTIMER_BASEADDR + FSBL_GTIMER_CONTROL_OFFSET,
+				Control | FSBL_GTIMER_ENABLE_MASK);
+	}
+
+	TimelineHeader->Magic = 0;
+	TimelineHeader->Count = 0;
+	TimelineHeader->Dropped = 0;
+	TimelineHeader->CountsPerSecond = COUNTS_PER_SECOND;
+	TimelineHeader->Checksum = 0;
+}
+
+/******************************************************************************/
+/**
+*
+* This function adds a mark to the timeline. Marks past the end of the
+* record are counted, not stored.
+*
+* @param	Stage is one of FSBL_STAGE_*, with FSBL_STAGE_END for the end
+* @param	Arg is the argument of the stage
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+void FsblTimelineMark(u32 Stage, u32 Arg)
+{
+	FsblTimelineEntry *Entry;
+	XTime Time;
+
+	XTime_GetTime(&Time);
+
+	if (TimelineHeader->Count >= FSBL_TIMELINE_MAX_ENTRIES) {
+		if (TimelineHeader->Dropped != 0xFFFF) {
+			TimelineHeader->Dropped++;
+		}
+		return;
+	}
+
+	Entry = &TimelineEntry[TimelineHeader->Count];
+	Entry->Stage = Stage;
+	Entry->Arg = Arg;
+	Entry->Time = Time;
+	TimelineHeader->Count++;
+}
+
+/******************************************************************************/
+/**
+*
+* This function seals the timeline before handoff: the magic word and the
+* checksum are set and the record is pushed out of the data cache. With
+* FSBL_TIMELINE_UART defined the record is then written to the UART, the
+* caller flushes the UART.
+*
+* @param	None
+*
+* @return	None
+*
+* @note		No marks may be added after this call.
+*
+****************************************************************************/
+void FsblTimelineClose(void)
+{
+	u32 *Word = (u32 *)FSBL_TIMELINE_ADDR;
+	u32 Length;
+	u32 Sum = 0;
+	u32 Index;
+
+	Length = sizeof(FsblTimelineHeader) +
+			(TimelineHeader->Count * sizeof(FsblTimelineEntry));
+
+	TimelineHeader->Magic = FSBL_TIMELINE_MAGIC;
+	TimelineHeader->Checksum = 0;
+	for (Index = 0; Index < (Length / 4); Index++) {
+		Sum += Word[Index];
+	}
+	TimelineHeader->Checksum = Sum;
+
+	Xil_DCacheFlushRange(FSBL_TIMELINE_ADDR, FSBL_TIMELINE_SIZE);
+
+#if defined(FSBL_TIMELINE_UART) && defined(STDOUT_BASEADDRESS)
+	for (Index = 0; Index < Length; Index++) {
+		outbyte(((u8 *)FSBL_TIMELINE_ADDR)[Index]);
+	}
+#endif
+}
+#endif
@@ -0,0 +1,127 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_timeline.h
+*
+* This file contains the boot timeline of FSBL_TIMELINE.
+*
+* Each boot stage marks its start and its end with a global timer
+* timestamp, in a record at FSBL_TIMELINE_ADDR in the high OCM. The record
+* is left there at handoff, so that the application can read it before it
+* uses the high OCM, and with FSBL_TIMELINE_UART it is also written as is to
+* the UART just before handoff. A host finds it in the serial output by its
+* magic word and checks it with the checksum of the header, as
+* app_component/tools/boot_regress.py does to compare the stages with a
+* baseline.
+*
+* The record is little endian:
+*	- Header, FsblTimelineHeader
+*	- Header.Count entries, FsblTimelineEntry
+*
+* Ticks are COUNTS_PER_SECOND, except before the end of ps7_init, which
+* runs with the clocks of the Boot ROM. The ps7_init stage is only
+* comparable from boot to boot of the same board.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef ___FSBL_TIMELINE_H___
+#define ___FSBL_TIMELINE_H___
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Top of the high OCM below the Boot ROM area, kept out of the FSBL and
+ * application linker scripts
+ */
+#define FSBL_TIMELINE_ADDR		0xFFFFF600
+#define FSBL_TIMELINE_SIZE		0x800
+
+#define FSBL_TIMELINE_MAGIC		0x314C5446	/* "FTL1" */
+#define FSBL_TIMELINE_MAX_ENTRIES	((FSBL_TIMELINE_SIZE - \
+					sizeof(FsblTimelineHeader)) / \
+					sizeof(FsblTimelineEntry))
+
+/*
+ * Stages, the argument is given for each
+ */
+#define FSBL_STAGE_PS7_INIT		0x01	/* 0 */
+#define FSBL_STAGE_DDR_INIT_CHECK	0x02	/* 0 */
+#define FSBL_STAGE_PCAP_INIT		0x03	/* 0 */
+#define FSBL_STAGE_FLASH_INIT		0x04	/* Boot mode */
+#define FSBL_STAGE_HEADER_READ		0x05	/* Image start address */
+#define FSBL_STAGE_PARTITION_HEADER	0x06	/* Partition number */
+#define FSBL_STAGE_PARTITION_MOVE	0x07	/* Partition number */
+#define FSBL_STAGE_CHECKSUM		0x08	/* Partition number */
+#define FSBL_STAGE_AUTHENTICATION	0x09	/* Partition number */
+#define FSBL_STAGE_DECRYPTION		0x0A	/* Partition number */
+#define FSBL_STAGE_PCAP			0x0B	/* Partition number */
+#define FSBL_STAGE_HANDOFF		0x0C	/* Handoff address */
+
+#define FSBL_STAGE_END			0x80000000	/* Set on end marks */
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32 Magic;		/* FSBL_TIMELINE_MAGIC */
+	u16 Count;		/* Entries recorded */
+	u16 Dropped;		/* Marks past the end of the record */
+	u32 CountsPerSecond;	/* Global timer ticks per second */
+	u32 Checksum;		/* Sum of the other words of the record */
+} FsblTimelineHeader;
+
+typedef struct {
+	u32 Stage;		/* FSBL_STAGE_*, with FSBL_STAGE_END */
+	u32 Arg;		/* Argument of the stage */
+	u64 Time;		/* Global timer */
+} FsblTimelineEntry;
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+#ifdef FSBL_TIMELINE
+#define FSBL_TIMELINE_BEGIN(Stage, Arg)	FsblTimelineMark((Stage), (Arg))
+#define FSBL_TIMELINE_END(Stage, Arg)	\
+		FsblTimelineMark((Stage) | FSBL_STAGE_END, (Arg))
+#else
+#define FSBL_TIMELINE_BEGIN(Stage, Arg)
+#define FSBL_TIMELINE_END(Stage, Arg)
+#endif
+
+/************************** Function Prototypes ******************************/
+
+#ifdef FSBL_TIMELINE
+void FsblTimelineInit(void);
+
+void FsblTimelineMark(u32 Stage, u32 Arg);
+
+void FsblTimelineClose(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ___FSBL_TIMELINE_H___ */
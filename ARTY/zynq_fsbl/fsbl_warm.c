@@ -0,0 +1,315 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_warm.c
+*
+* Contains the warm boot of FSBL_WARM_BOOT, see fsbl_warm.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+#include "fsbl_warm.h"
+
+#ifdef FSBL_WARM_BOOT
+#include <string.h>
+#include "xil_cache.h"
+#include "xil_mem.h"
+
+/************************** Constant Definitions *****************************/
+
+#define FSBL_WARM_HEADER_WORDS	(sizeof(PartHeader) / 4)
+#define FSBL_WARM_RECORD_WORDS	((sizeof(FsblWarmRecord) / 4) - 1)
+
+/************************** Function Prototypes ******************************/
+
+static void FsblWarmSum(u32 Addr, u32 Length, u32 *SumA, u32 *SumB);
+static FsblWarmEntry *FsblWarmFind(u32 PartitionNum);
+
+/************************** Variable Definitions *****************************/
+
+extern u32 Silicon_Version;
+
+/*
+ * Record of the previous boot, kept while the new one is written over it
+ */
+static FsblWarmRecord FsblWarmPrevious;
+static u8 FsblWarmReset;
+static u8 FsblWarmValid;
+
+/*****************************************************************************/
+/**
+*
+* This function takes the reason of the reset from the reboot status
+* register, before CheckWDTReset() clears it.
+*
+* @param	None.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void FsblWarmCheckReset(void)
+{
+	u32 ResetReason = GetResetReason();
+
+	FsblWarmReset = ((ResetReason != 0) &&
+			((ResetReason & RESET_REASON_POR) == 0)) ? 1 : 0;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function tells the warm resets from the power-on reset.
+*
+* @param	None.
+*
+* @return	1 after a watchdog or software reset, 0 after a power-on reset
+*
+* @note		None.
+*
+******************************************************************************/
+u32 FsblWarmIsReset(void)
+{
+	return FsblWarmReset;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function takes the record of the previous boot, if it is valid and
+* for the same image, and starts the record of this boot. The record in OCM
+* is invalid until FsblWarmSeal(), so that a boot that does not get to the
+* handoff leaves none.
+*
+* @param	ImageStartAddress is the address of the boot image
+*
+* @return	None.
+*
+* @note		Call it once the partition headers are read.
+*
+******************************************************************************/
+void FsblWarmInit(u32 ImageStartAddress)
+{
+	FsblWarmRecord *Record = (FsblWarmRecord *)FSBL_WARM_ADDR;
+
+	FsblWarmValid = 0;
+	if ((FsblWarmReset != 0) && (Silicon_Version != SILICON_VERSION_1) &&
+			(Record->Magic == FSBL_WARM_MAGIC) &&
+			(Record->ImageStartAddress == ImageStartAddress) &&
+			(Record->Count <= FSBL_WARM_MAX_ENTRIES) &&
+			(Record->Checksum == Xil_MemSum32((u32 *)Record,
+					FSBL_WARM_RECORD_WORDS))) {
+		memcpy(&FsblWarmPrevious, Record, sizeof(FsblWarmRecord));
+		FsblWarmValid = 1;
+		fsbl_printf(DEBUG_INFO, "Warm boot, %lu partitions recorded\r\n",
+				FsblWarmPrevious.Count);
+	}
+
+	memset(Record, 0, sizeof(FsblWarmRecord));
+	Record->ImageStartAddress = ImageStartAddress;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function tells whether a partition is still in DDR as the previous
+* boot loaded it. It is then added to the record of this boot.
+*
+* @param	PartitionNum is the number of the partition
+* @param	Header is its header
+* @param	ChecksumAddr is the address of its checksum in the boot device
+*
+* @return
+*		- XST_SUCCESS if the partition can be used as it is in DDR
+*		- XST_FAILURE if it must be loaded
+*
+* @note		The caller only asks for plain PS partitions with a checksum.
+*
+******************************************************************************/
+u32 FsblWarmReuse(u32 PartitionNum, PartHeader *Header, u32 ChecksumAddr)
+{
+	FsblWarmRecord *Record = (FsblWarmRecord *)FSBL_WARM_ADDR;
+	FsblWarmEntry *Entry;
+	u32 Checksum[4];
+	u32 SumA;
+	u32 SumB;
+
+	if (FsblWarmValid == 0) {
+		return XST_FAILURE;
+	}
+
+	Entry = FsblWarmFind(PartitionNum);
+	if ((Entry == NULL) ||
+			(Entry->HeaderSum != Xil_MemSum32((u32 *)Header,
+					FSBL_WARM_HEADER_WORDS)) ||
+			(Entry->LoadAddr != Header->LoadAddr) ||
+			(Entry->Length !=
+				(Header->PartitionWordLen << WORD_LENGTH_SHIFT))) {
+		return XST_FAILURE;
+	}
+
+	/*
+	 * An image written again with the same headers has new checksums
+	 */
+	if ((GetPartitionChecksum(ChecksumAddr, (u8 *)Checksum) != XST_SUCCESS) ||
+			(memcmp(Checksum, Entry->Checksum, sizeof(Checksum)) != 0)) {
+		return XST_FAILURE;
+	}
+
+	FsblWarmSum(Entry->LoadAddr, Entry->Length, &SumA, &SumB);
+	if ((SumA != Entry->SumA) || (SumB != Entry->SumB)) {
+		fsbl_printf(DEBUG_INFO, "Partition %lu changed in DDR\r\n",
+				PartitionNum);
+		return XST_FAILURE;
+	}
+
+	if (Record->Count < FSBL_WARM_MAX_ENTRIES) {
+		Record->Entry[Record->Count] = *Entry;
+		Record->Count++;
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function adds a partition, loaded and validated, to the record of
+* this boot.
+*
+* @param	PartitionNum is the number of the partition
+* @param	Header is its header
+* @param	ChecksumAddr is the address of its checksum in the boot device
+*
+* @return	None.
+*
+* @note		Partitions beyond FSBL_WARM_MAX_ENTRIES are not recorded.
+*
+******************************************************************************/
+void FsblWarmAdd(u32 PartitionNum, PartHeader *Header, u32 ChecksumAddr)
+{
+	FsblWarmRecord *Record = (FsblWarmRecord *)FSBL_WARM_ADDR;
+	FsblWarmEntry *Entry;
+
+	if (Record->Count >= FSBL_WARM_MAX_ENTRIES) {
+		return;
+	}
+
+	Entry = &Record->Entry[Record->Count];
+	if (GetPartitionChecksum(ChecksumAddr, (u8 *)Entry->Checksum) !=
+			XST_SUCCESS) {
+		return;
+	}
+
+	Entry->PartitionNum = PartitionNum;
+	Entry->HeaderSum = Xil_MemSum32((u32 *)Header, FSBL_WARM_HEADER_WORDS);
+	Entry->LoadAddr = Header->LoadAddr;
+	Entry->Length = Header->PartitionWordLen << WORD_LENGTH_SHIFT;
+	FsblWarmSum(Entry->LoadAddr, Entry->Length, &Entry->SumA, &Entry->SumB);
+	Record->Count++;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function makes the record of this boot valid, once every partition
+* is loaded.
+*
+* @param	None.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void FsblWarmSeal(void)
+{
+	FsblWarmRecord *Record = (FsblWarmRecord *)FSBL_WARM_ADDR;
+
+	Record->Magic = FSBL_WARM_MAGIC;
+	Record->Checksum = Xil_MemSum32((u32 *)Record, FSBL_WARM_RECORD_WORDS);
+}
+
+/*****************************************************************************/
+/**
+*
+* This function returns the entry of a partition in the previous record.
+*
+* @param	PartitionNum is the number of the partition
+*
+* @return	The entry, NULL if the partition is not recorded.
+*
+* @note		None.
+*
+******************************************************************************/
+static FsblWarmEntry *FsblWarmFind(u32 PartitionNum)
+{
+	u32 Index;
+
+	for (Index = 0; Index < FsblWarmPrevious.Count; Index++) {
+		if (FsblWarmPrevious.Entry[Index].PartitionNum == PartitionNum) {
+			return &FsblWarmPrevious.Entry[Index];
+		}
+	}
+
+	return NULL;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function takes a Fletcher sum of a partition in DDR: the sum of the
+* words and the sum of the running sums, which also sees words moved or
+* swapped. It runs with the data cache enabled, as the authentication
+* does.
+*
+* @param	Addr is the address of the partition
+* @param	Length is its length in bytes
+* @param	SumA is where the sum of the words is returned
+* @param	SumB is where the sum of the running sums is returned
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void FsblWarmSum(u32 Addr, u32 Length, u32 *SumA, u32 *SumB)
+{
+	const u32 *Ptr = (const u32 *)Addr;
+	u32 Count = Length >> WORD_LENGTH_SHIFT;
+	u32 A = 0;
+	u32 B = 0;
+
+#ifndef FSBL_DCACHE
+	Xil_DCacheEnable();
+#endif
+	while (Count-- != 0) {
+		A += *Ptr++;
+		B += A;
+	}
+#ifndef FSBL_DCACHE
+	Xil_DCacheFlush();
+	Xil_DCacheDisable();
+#endif
+
+	*SumA = A;
+	*SumB = B;
+}
+#endif
@@ -0,0 +1,112 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file fsbl_warm.h
+*
+* This file contains the warm boot of FSBL_WARM_BOOT.
+*
+* Each boot leaves a record of the PS partitions it loaded in the high OCM
+* at FSBL_WARM_ADDR, out of the FSBL and application linker scripts: for
+* each partition its header, the MD5 checksum the boot device holds for it
+* and a sum of its copy in DDR, taken once it is validated. After a reset
+* other than the power-on reset, from a watchdog or software reset, a
+* partition whose header and checksum in the boot device are those of the
+* record, and whose DDR copy still has the recorded sum, is not read from
+* the boot device nor checksummed again; only its sum is taken.
+*
+* The DDR keeps its content over such a reset for as long as the DRAM
+* holds it without refresh, until ps7_init is through, which is why every
+* partition is summed before it is reused. A partition the application
+* writes, such as its own data and bss, does not match and is loaded as at
+* power-on; the gain is for the partitions that stay as loaded, such as
+* data, tables and the code of the other CPU.
+*
+* Only plain partitions with a checksum are reused: signed, encrypted and
+* compressed ones and bitstreams, which a system reset clears from the PL,
+* are always loaded. The record goes with the next boot of another image
+* or of a changed one.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef ___FSBL_WARM_H___
+#define ___FSBL_WARM_H___
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+#include "image_mover.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Below the boot timeline, kept out of the FSBL and application linker
+ * scripts
+ */
+#define FSBL_WARM_ADDR			0xFFFFF500
+#define FSBL_WARM_SIZE			0x100
+
+#define FSBL_WARM_MAGIC			0x314D5246	/* "FRM1" */
+#define FSBL_WARM_MAX_ENTRIES		6
+
+/**************************** Type Definitions *******************************/
+
+/*
+ * A loaded partition
+ */
+typedef struct {
+	u32 PartitionNum;
+	u32 HeaderSum;		/* Xil_MemSum32 of the partition header */
+	u32 LoadAddr;
+	u32 Length;		/* Bytes */
+	u32 Checksum[4];	/* MD5 in the boot device */
+	u32 SumA;		/* Of the DDR copy, see FsblWarmSum() */
+	u32 SumB;
+} FsblWarmEntry;
+
+/*
+ * The record, the checksum is Xil_MemSum32 of the words before it
+ */
+typedef struct {
+	u32 Magic;
+	u32 ImageStartAddress;
+	u32 Count;
+	FsblWarmEntry Entry[FSBL_WARM_MAX_ENTRIES];
+	u32 Checksum;
+} FsblWarmRecord;
+
+/************************** Function Prototypes ******************************/
+
+#ifdef FSBL_WARM_BOOT
+void FsblWarmCheckReset(void);
+u32 FsblWarmIsReset(void);
+void FsblWarmInit(u32 ImageStartAddress);
+u32 FsblWarmReuse(u32 PartitionNum, PartHeader *Header, u32 ChecksumAddr);
+void FsblWarmAdd(u32 PartitionNum, PartHeader *Header, u32 ChecksumAddr);
+void FsblWarmSeal(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ___FSBL_WARM_H___ */
@@ -55,6 +55,36 @@
 *                       Deleted GetImageHeaderAndSignature() and added
 *                       GetNAuthImageHeader()
 * 21.2  ng  03/09/24   Fix format specifier for 32 bit variables
+* 21.3  qm  10/14/26   Stream plain PL partitions of non-linear boot
+*                      devices to the PCAP instead of staging them in DDR
+*                      Checksum partitions of linear boot devices while
+*                      the PCAP moves them
+*                      Hash signed partitions with the in-tree SHA-256, while
+*                      the PCAP moves them on linear boot devices
+*                      Boot timeline marks of FSBL_TIMELINE
+*                      Checksum PS partitions on CPU1 while the next one is
+*                      moved with FSBL_CPU1_WORKER
+*                      Header fields are read from the image header cache
+*                      Decompress LZ4 partitions as they are read from the
+*                      boot device with FSBL_LZ4
+*                      Stream LZ4 bitstreams to the PCAP as they are
+*                      decompressed
+*                      Plain bitstreams rely on their CRC with FSBL_PL_FAST
+*                      The data cache stays enabled with FSBL_DCACHE
+*                      Keep the partitions still in DDR on a warm boot with
+*                      FSBL_WARM_BOOT
+*                      Decrypt the encrypted PS partitions of non-linear
+*                      boot devices while they are read with FSBL_AES_STREAM
+*                      Authenticate the SPKs of all signed partitions in one
+*                      pass with FSBL_AUTH_BATCH
+*                      Checksum plain PS partitions MD5_LANES at a time with
+*                      FSBL_MD5_BATCH
+*                      Leave PS partitions loaded in the linear QSPI window
+*                      in place with FSBL_QSPI_XIP
+*                      Leave deferred PS partitions to the application
+*                      with FSBL_DEFERRED
+*                      Check the PS partitions of a boot manifest chunk by
+*                      chunk as they are moved with FSBL_MANIFEST
 *
 * </pre>
 *
@@ -71,6 +101,16 @@
 #include "pcap.h"
 #include "fsbl_hooks.h"
 #include "md5.h"
+#include "fsbl_timeline.h"
+#include "fsbl_cpu1.h"
+#include "fsbl_warm.h"
+#include "fsbl_deferred.h"
+#include "fsbl_manifest.h"
+#include "xil_mem.h"
+
+#ifdef FSBL_LZ4
+#include "fsbl_lz4.h"
+#endif
 
 #ifdef XPAR_XWDTPS_0_BASEADDR
 #include "xwdtps.h"
@@ -80,6 +120,7 @@
 #include "rsa.h"
 #include "xil_cache.h"
 #include "xilrsa.h"
+#include "sha256.h"
 #endif
 /************************** Constant Definitions *****************************/
 
@@ -87,14 +128,78 @@
 #define MAXIMUM_IMAGE_WORD_LEN 0x40000000
 #define MD5_CHECKSUM_SIZE   16
 
+/*
+ * Compressed partitions are read from the boot device in chunks of this
+ * many bytes
+ */
+#define LZ4_CHUNK_SIZE		0x2000
+
 /**************************** Type Definitions *******************************/
 
+/*
+ * Hashes of a partition calculated while it is moved
+ */
+typedef struct {
+	MD5Context Md5;		/* Checksum, if PartitionChecksumFlag */
+#ifdef RSA_SUPPORT
+	Sha256Context Sha;	/* Authentication hash */
+	u32 ShaLength;		/* Bytes covered by Sha, 0 if not signed */
+#endif
+} PartitionHashType;
+
+#ifdef FSBL_LZ4
+/*
+ * Compressed partition being moved
+ */
+typedef struct {
+	u32 Addr;		/* Next byte on the boot device */
+	u32 Left;		/* Bytes of the partition left to read */
+	MD5Context Md5;		/* Checksum of the compressed stream */
+	u32 Dst;		/* Decompressed data */
+	u32 Queued;		/* Bytes of a bitstream queued to the PCAP */
+	u32 Held;		/* End of the bytes held back from the PCAP */
+	u8 PcapBusy;		/* A chunk is in flight */
+} Lz4PartitionType;
+#endif
+
 /***************** Macros (Inline Functions) Definitions *********************/
 
 /************************** Function Prototypes ******************************/
 u32 ValidateParition(u32 StartAddr, u32 Length, u32 ChecksumOffset);
 u32 GetPartitionChecksum(u32 ChecksumOffset, u8 *Checksum);
 u32 CalcPartitionChecksum(u32 SourceAddr, u32 DataLength, u8 *Checksum);
+static u32 PcapDataTransferHashed(u32 SourceAddr, u32 LoadAddr,
+		u32 WordLen);
+static void PartitionHashUpdate(PartitionHashType *HashPtr, u32 LoadAddr,
+		u32 Offset, u32 Length);
+#ifdef RSA_SUPPORT
+static void CalcPartitionHash(u32 SourceAddr, u32 DataLength, u8 *Hash);
+#ifdef FSBL_AUTH_BATCH
+static u32 AuthenticateSpkBatch(u32 ImageBaseAddress, u32 FirstPartition);
+#endif
+#endif
+#ifdef FSBL_CPU1_WORKER
+static u32 Cpu1ChecksumPost(u32 PartitionNum, u32 StartAddr, u32 Length,
+		u32 ChecksumOffset);
+static u32 Cpu1ChecksumJob(u32 StartAddr, u32 Length, u32 Checksum);
+static u32 Cpu1ChecksumOverlaps(u32 StartAddr, u32 Length);
+static void Cpu1ChecksumCollect(void);
+#endif
+#ifdef FSBL_MD5_BATCH
+static u32 ChecksumBatchAdd(u32 PartitionNum, u32 StartAddr, u32 Length,
+		u32 ChecksumOffset);
+static u32 ChecksumBatchOverlaps(u32 StartAddr, u32 Length);
+static void ChecksumBatchFlush(void);
+#endif
+#ifdef FSBL_LZ4
+static u32 PartitionMoveCompressed(u32 SourceAddr, u32 LoadAddr,
+		u32 WordLen);
+static u32 Lz4Refill(Lz4Stream *Stream);
+static u32 Lz4PcapFlush(Lz4Stream *Stream, u32 Length);
+#endif
+#ifdef FSBL_QSPI_XIP
+static u32 XipPartitionCheck(u32 ImageBaseAddress, PartHeader *Header);
+#endif
 
 /************************** Variable Definitions *****************************/
 /*
@@ -107,6 +212,8 @@ u8 SignedPartitionFlag;
 u8 PartitionChecksumFlag;
 u8 BitstreamFlag;
 u8 ApplicationFlag;
+u8 CompressedPartitionFlag;
+u8 XipPartitionFlag;
 
 u32 ExecutionAddress;
 ImageMoverType MoveImage;
@@ -127,6 +234,68 @@ extern u32 FlashReadBaseAddress;
 extern u8 LinearBootDeviceFlag;
 extern XDcfg *DcfgInstPtr;
 
+/*
+ * MD5 checksum and SHA-256 hash of the partition last moved by
+ * PcapDataTransferHashed(), used by CalcPartitionChecksum() and
+ * CalcPartitionHash() instead of reading it again
+ */
+static u32 HashedPartitionAddr;
+static u32 HashedPartitionLength;
+static u8 HashedPartitionValid;
+static u8 HashedPartitionChecksum[MD5_CHECKSUM_SIZE];
+#ifdef RSA_SUPPORT
+static u32 HashedPartitionShaLength;
+static u8 HashedPartitionShaValid;
+static u8 HashedPartitionHash[SHA256_DIGEST_BYTE_SIZE];
+#endif
+
+/*
+ * Image header cache, the start of the image last loaded by
+ * ImageHeaderCacheLoad()
+ */
+static u32 HeaderCache[IMAGE_HEADER_CACHE_SIZE / 4];
+static u32 HeaderCacheAddr;
+static u32 HeaderCacheLength;
+
+#if defined(RSA_SUPPORT) && defined(FSBL_AUTH_BATCH)
+/*
+ * Certificate of a partition up to its signature
+ */
+static u32 SpkCertificate[RSA_SPK_CERT_SIZE / 4];
+#endif
+
+#ifdef FSBL_LZ4
+/*
+ * Chunk of the compressed partition being decompressed
+ */
+static u32 Lz4Chunk[LZ4_CHUNK_SIZE / 4];
+#endif
+
+#ifdef FSBL_CPU1_WORKER
+/*
+ * Checksum of a PS partition calculated on CPU1, while CPU0 moves the next
+ * partition
+ */
+static u8 Cpu1Ready;
+static u8 Cpu1ChecksumPending;
+static u32 Cpu1ChecksumPartition;
+static u32 Cpu1ChecksumAddr;
+static u32 Cpu1ChecksumLength;
+static u8 Cpu1ChecksumExpected[MD5_CHECKSUM_SIZE];
+static u8 Cpu1ChecksumCalculated[MD5_CHECKSUM_SIZE];
+#endif
+
+#ifdef FSBL_MD5_BATCH
+/*
+ * Plain PS partitions staged in DDR, whose checksums are calculated together
+ */
+static u32 ChecksumBatchCount;
+static u32 ChecksumBatchPartition[MD5_LANES];
+static u32 ChecksumBatchAddr[MD5_LANES];
+static u32 ChecksumBatchLength[MD5_LANES];
+static u8 ChecksumBatchExpected[MD5_LANES][MD5_CHECKSUM_SIZE];
+#endif
+
 /*****************************************************************************/
 /**
 *
@@ -165,6 +334,16 @@ u32 LoadBootImage(void)
 #endif
 #ifndef FORCE_USE_AES_EXCLUDE
 	u32 EncOnly;
+#endif
+#ifdef FSBL_WARM_BOOT
+	u8 WarmPartition;
+#endif
+#if defined(FSBL_CPU1_WORKER) || defined(FSBL_MD5_BATCH)
+	u8 PlainPartition;
+#endif
+#ifdef FSBL_MANIFEST
+	u8 ManifestPartition;
+	u32 ManifestEntry;
 #endif
 	/*
 	 * Resetting the Flags
@@ -214,7 +393,9 @@ u32 LoadBootImage(void)
 	/*
 	 * Get partitions header information
 	 */
+	FSBL_TIMELINE_BEGIN(FSBL_STAGE_HEADER_READ, ImageStartAddress);
 	Status = GetPartitionHeaderInfo(ImageStartAddress);
+	FSBL_TIMELINE_END(FSBL_STAGE_HEADER_READ, ImageStartAddress);
 	if (Status != XST_SUCCESS) {
 		fsbl_printf(DEBUG_GENERAL, "Partition Header Load Failed\r\n");
 		OutputStatus(GET_HEADER_INFO_FAIL);
@@ -252,6 +433,19 @@ u32 LoadBootImage(void)
 			}
 			fsbl_printf(DEBUG_GENERAL,
 				"Header authentication is Success\r\n");
+
+#ifdef FSBL_AUTH_BATCH
+#ifdef MMC_SUPPORT
+			Status = AuthenticateSpkBatch(ImageStartAddress, 0);
+#else
+			Status = AuthenticateSpkBatch(ImageStartAddress, 1);
+#endif
+			if (Status != XST_SUCCESS) {
+				fsbl_printf(DEBUG_GENERAL,"AUTHENTICATION_FAIL\r\n");
+				OutputStatus(AUTHENTICATION_FAIL);
+				FsblFallback();
+			}
+#endif
 #else
 			/*
 			 * In case user not enabled RSA authentication feature
@@ -263,6 +457,10 @@ u32 LoadBootImage(void)
 		}
 	}
 
+#ifdef FSBL_WARM_BOOT
+	FsblWarmInit(ImageStartAddress);
+#endif
+
 #ifdef MMC_SUPPORT
 	/*
 	 * In case of MMC support
@@ -277,6 +475,14 @@ u32 LoadBootImage(void)
 	PartitionNum = 1;
 #endif
 
+#if defined(FSBL_CPU1_WORKER) && !defined(FSBL_DCACHE)
+	/*
+	 * CPU1 runs uncached, it cannot share the partitions with a cached
+	 * CPU0
+	 */
+	Cpu1Ready = (FsblCpu1Start() == XST_SUCCESS) ? 1 : 0;
+#endif
+
 	while (PartitionNum < PartitionCount) {
 
 		fsbl_printf(DEBUG_INFO, "Partition Number: %lu\r\n", PartitionNum);
@@ -291,7 +497,9 @@ u32 LoadBootImage(void)
 		/*
 		 * Validate partition header
 		 */
+		FSBL_TIMELINE_BEGIN(FSBL_STAGE_PARTITION_HEADER, PartitionNum);
 		Status = ValidateHeader(HeaderPtr);
+		FSBL_TIMELINE_END(FSBL_STAGE_PARTITION_HEADER, PartitionNum);
 		if (Status != XST_SUCCESS) {
 			fsbl_printf(DEBUG_GENERAL, "INVALID_HEADER_FAIL\r\n");
 			OutputStatus(INVALID_HEADER_FAIL);
@@ -392,6 +600,63 @@ u32 LoadBootImage(void)
 			SignedPartitionFlag = 0;
 		}
 
+#ifdef FSBL_PL_FAST
+		/*
+		 * A plain bitstream is checked by the PL against its own CRC,
+		 * the partition checksum is not computed on top of it
+		 */
+		if (PLPartitionFlag && PartitionChecksumFlag &&
+				(EncryptedPartitionFlag == 0) &&
+				(SignedPartitionFlag == 0)) {
+			fsbl_printf(DEBUG_INFO, "Bitstream CRC only\r\n");
+			PartitionChecksumFlag = 0;
+		}
+#endif
+
+		/*
+		 * LZ4 compressed partition, neither encrypted nor signed
+		 */
+		if (PartitionAttr & ATTRIBUTE_COMPRESSED_MASK) {
+#ifdef FSBL_LZ4
+			fsbl_printf(DEBUG_INFO, "LZ4 Compressed\r\n");
+			if (EncryptedPartitionFlag || SignedPartitionFlag) {
+				fsbl_printf(DEBUG_GENERAL,
+						"Compressed partition must be plain\r\n");
+				OutputStatus(PARTITION_LOAD_FAIL);
+				FsblFallback();
+			}
+			CompressedPartitionFlag = 1;
+#else
+			fsbl_printf(DEBUG_GENERAL, "FSBL_LZ4 not enabled\r\n");
+			OutputStatus(PARTITION_LOAD_FAIL);
+			FsblFallback();
+#endif
+		} else {
+			CompressedPartitionFlag = 0;
+		}
+
+		/*
+		 * PS partition executed in place from the linear QSPI window,
+		 * where it already is
+		 */
+		XipPartitionFlag = 0;
+		if (PSPartitionFlag && (PartitionLoadAddr >= XIP_WINDOW_START) &&
+				(PartitionLoadAddr <= XIP_WINDOW_END)) {
+#ifdef FSBL_QSPI_XIP
+			Status = XipPartitionCheck(ImageStartAddress, HeaderPtr);
+			if (Status != XST_SUCCESS) {
+				fsbl_printf(DEBUG_GENERAL,
+						"INVALID_LOAD_ADDRESS_FAIL\r\n");
+				OutputStatus(INVALID_LOAD_ADDRESS_FAIL);
+				FsblFallback();
+			}
+			fsbl_printf(DEBUG_INFO, "Execute In Place\r\n");
+			XipPartitionFlag = 1;
+#else
+			fsbl_printf(DEBUG_GENERAL, "FSBL_QSPI_XIP not enabled\r\n");
+#endif
+		}
+
 		/*
 		 * Load address check
 		 * Loop will break when PS load address zero and partition is
@@ -410,13 +675,45 @@ u32 LoadBootImage(void)
 			}
 		}
 
-		if (PSPartitionFlag && (PartitionLoadAddr > DDR_END_ADDR)) {
+		if (PSPartitionFlag && (XipPartitionFlag == 0) &&
+				(PartitionLoadAddr > DDR_END_ADDR)) {
 			fsbl_printf(DEBUG_GENERAL,
 					"INVALID_LOAD_ADDRESS_FAIL\r\n");
 			OutputStatus(INVALID_LOAD_ADDRESS_FAIL);
 			FsblFallback();
 		}
 
+#ifdef FSBL_DEFERRED
+		/*
+		 * A plain PS partition of a linear boot device that the
+		 * application loads itself, once it runs
+		 */
+		if (PSPartitionFlag &&
+				(PartitionAttr & ATTRIBUTE_DEFERRED_MASK) &&
+				LinearBootDeviceFlag &&
+				(EncryptedPartitionFlag == 0) &&
+				(SignedPartitionFlag == 0) &&
+				(CompressedPartitionFlag == 0) &&
+				(XipPartitionFlag == 0) &&
+				(FsblDeferredAdd(PartitionNum, ImageStartAddress,
+					HeaderPtr) == XST_SUCCESS)) {
+			fsbl_printf(DEBUG_INFO, "Partition %lu deferred\r\n",
+					PartitionNum);
+			PartitionNum++;
+			continue;
+		}
+#endif
+
+#ifdef FSBL_MANIFEST
+		/*
+		 * The boot manifest, which does not give the handoff address
+		 */
+		ManifestPartition = (PSPartitionFlag &&
+				(PartitionLoadAddr == FSBL_MANIFEST_ADDR)) ? 1 : 0;
+		if (ManifestPartition) {
+			fsbl_printf(DEBUG_INFO, "Boot manifest\r\n");
+		} else
+#endif
         /*
          * Load execution address of first PS partition
          */
@@ -425,6 +722,46 @@ u32 LoadBootImage(void)
         	ExecAddress = PartitionExecAddr;
         }
 
+#ifdef FSBL_WARM_BOOT
+		/*
+		 * A plain PS partition may still be in DDR from the previous
+		 * boot
+		 */
+		WarmPartition = (PSPartitionFlag && PartitionChecksumFlag &&
+				(EncryptedPartitionFlag == 0) &&
+				(SignedPartitionFlag == 0) &&
+				(CompressedPartitionFlag == 0) &&
+				(XipPartitionFlag == 0)) ? 1 : 0;
+		if (WarmPartition && (FsblWarmReuse(PartitionNum, HeaderPtr,
+				ImageStartAddress + (PartitionChecksumOffset <<
+					WORD_LENGTH_SHIFT)) == XST_SUCCESS)) {
+			fsbl_printf(DEBUG_INFO, "Partition %lu kept in DDR\r\n",
+					PartitionNum);
+			PartitionNum++;
+			continue;
+		}
+#endif
+
+#ifdef FSBL_MANIFEST
+		/*
+		 * A plain PS partition the manifest lists is checked chunk by
+		 * chunk as it is moved, instead of by its checksum
+		 */
+		ManifestEntry = FSBL_MANIFEST_NONE;
+		if (PSPartitionFlag && (EncryptedPartitionFlag == 0) &&
+				(SignedPartitionFlag == 0) &&
+				(CompressedPartitionFlag == 0) &&
+				(XipPartitionFlag == 0)) {
+			ManifestEntry = FsblManifestFind(PartitionLoadAddr,
+					PartitionImageLength << WORD_LENGTH_SHIFT);
+		}
+		if (ManifestEntry != FSBL_MANIFEST_NONE) {
+			fsbl_printf(DEBUG_INFO, "Manifest entry %lu\r\n",
+					ManifestEntry);
+			PartitionChecksumFlag = 0;
+		}
+#endif
+
 		/*
 		 * FSBL user hook call before bitstream download
 		 */
@@ -438,13 +775,54 @@ u32 LoadBootImage(void)
 		}
 
 		/*
-		 * Move partitions from boot device
+		 * Move partitions from boot device, an XIP partition stays
+		 * where it is
 		 */
-		Status = PartitionMove(ImageStartAddress, HeaderPtr);
-		if (Status != XST_SUCCESS) {
-			fsbl_printf(DEBUG_GENERAL,"PARTITION_MOVE_FAIL\r\n");
-			OutputStatus(PARTITION_MOVE_FAIL);
-			FsblFallback();
+		if (XipPartitionFlag) {
+			fsbl_printf(DEBUG_INFO, "Partition %lu left in flash\r\n",
+					PartitionNum);
+		} else {
+#ifdef FSBL_CPU1_WORKER
+			/*
+			 * Do not move over the partition CPU1 is checking, the size of
+			 * a compressed partition is only known once it is moved
+			 */
+			if (CompressedPartitionFlag || Cpu1ChecksumOverlaps(PLPartitionFlag ? DDR_TEMP_START_ADDR :
+					PartitionLoadAddr,
+					PartitionTotalSize << WORD_LENGTH_SHIFT)) {
+				Cpu1ChecksumCollect();
+			}
+#endif
+#ifdef FSBL_MD5_BATCH
+			if (CompressedPartitionFlag || ChecksumBatchOverlaps(PLPartitionFlag ?
+					DDR_TEMP_START_ADDR : PartitionLoadAddr,
+					PartitionTotalSize << WORD_LENGTH_SHIFT)) {
+				ChecksumBatchFlush();
+			}
+#endif
+			FSBL_TIMELINE_BEGIN(FSBL_STAGE_PARTITION_MOVE, PartitionNum);
+#ifdef FSBL_MANIFEST
+			if (ManifestEntry != FSBL_MANIFEST_NONE) {
+#ifdef FSBL_CPU1_WORKER
+				/*
+				 * CPU1 checks chunks of this partition
+				 */
+				Cpu1ChecksumCollect();
+#endif
+				HashedPartitionValid = 0;
+				Status = FsblManifestMove(ManifestEntry,
+						ImageStartAddress +
+						(HeaderPtr->PartitionStart << WORD_LENGTH_SHIFT),
+						PartitionLoadAddr);
+			} else
+#endif
+			Status = PartitionMove(ImageStartAddress, HeaderPtr);
+			FSBL_TIMELINE_END(FSBL_STAGE_PARTITION_MOVE, PartitionNum);
+			if (Status != XST_SUCCESS) {
+				fsbl_printf(DEBUG_GENERAL,"PARTITION_MOVE_FAIL\r\n");
+				OutputStatus(PARTITION_MOVE_FAIL);
+				FsblFallback();
+			}
 		}
 
 		if ((SignedPartitionFlag) || (PartitionChecksumFlag)) {
@@ -458,14 +836,57 @@ u32 LoadBootImage(void)
 				PartitionStartAddr = PartitionLoadAddr;
 			}
 
+#if defined(FSBL_CPU1_WORKER) || defined(FSBL_MD5_BATCH)
+			PlainPartition = (PartitionChecksumFlag && PSPartitionFlag &&
+					(SignedPartitionFlag == 0) &&
+					(EncryptedPartitionFlag == 0) &&
+					(CompressedPartitionFlag == 0) &&
+					(XipPartitionFlag == 0)) ? 1 : 0;
+			Status = XST_FAILURE;
+#endif
+#ifdef FSBL_CPU1_WORKER
+			/*
+			 * The previous partition is checked before this one
+			 */
+			Cpu1ChecksumCollect();
+
+			/*
+			 * Plain PS partitions are checked on CPU1, CPU0 goes on with
+			 * the next partition
+			 */
+			if (PlainPartition) {
+				Status = Cpu1ChecksumPost(PartitionNum, PartitionStartAddr,
+						(PartitionTotalSize << WORD_LENGTH_SHIFT),
+						ImageStartAddress  +
+						(PartitionChecksumOffset << WORD_LENGTH_SHIFT));
+			}
+#endif
+#ifdef FSBL_MD5_BATCH
+			/*
+			 * Or with the next plain PS partitions, MD5_LANES at a time
+			 */
+			if ((Status != XST_SUCCESS) && PlainPartition) {
+				Status = ChecksumBatchAdd(PartitionNum, PartitionStartAddr,
+						(PartitionTotalSize << WORD_LENGTH_SHIFT),
+						ImageStartAddress  +
+						(PartitionChecksumOffset << WORD_LENGTH_SHIFT));
+			}
+#endif
+
+#if defined(FSBL_CPU1_WORKER) || defined(FSBL_MD5_BATCH)
+			if ((Status != XST_SUCCESS) && PartitionChecksumFlag) {
+#else
 			if (PartitionChecksumFlag) {
+#endif
 				/*
 				 * Validate the partition data with checksum
 				 */
+				FSBL_TIMELINE_BEGIN(FSBL_STAGE_CHECKSUM, PartitionNum);
 				Status = ValidateParition(PartitionStartAddr,
 						(PartitionTotalSize << WORD_LENGTH_SHIFT),
 						ImageStartAddress  +
 						(PartitionChecksumOffset << WORD_LENGTH_SHIFT));
+				FSBL_TIMELINE_END(FSBL_STAGE_CHECKSUM, PartitionNum);
 				if (Status != XST_SUCCESS) {
 					fsbl_printf(DEBUG_GENERAL,"PARTITION_CHECKSUM_FAIL\r\n");
 					OutputStatus(PARTITION_CHECKSUM_FAIL);
@@ -480,8 +901,12 @@ u32 LoadBootImage(void)
 			 */
 			if (SignedPartitionFlag == 1 ) {
 #ifdef RSA_SUPPORT
+				FSBL_TIMELINE_BEGIN(FSBL_STAGE_AUTHENTICATION,
+						PartitionNum);
+#ifndef FSBL_DCACHE
 				Xil_DCacheEnable();
-				sha_256((u8 *)PartitionStartAddr,
+#endif
+				CalcPartitionHash(PartitionStartAddr,
 						((PartitionTotalSize << WORD_LENGTH_SHIFT) -
 							RSA_PARTITION_SIGNATURE_SIZE),
 						Hash);
@@ -492,15 +917,21 @@ u32 LoadBootImage(void)
 							RSA_SIGNATURE_SIZE);
 				Status = AuthenticatePartition((u8*)Ac, Hash);
 				if (Status != XST_SUCCESS) {
+#ifndef FSBL_DCACHE
 					Xil_DCacheFlush();
 		        	Xil_DCacheDisable();
+#endif
 					fsbl_printf(DEBUG_GENERAL,"AUTHENTICATION_FAIL\r\n");
 					OutputStatus(AUTHENTICATION_FAIL);
 					FsblFallback();
 				}
 				fsbl_printf(DEBUG_INFO,"Authentication Done\r\n");
+#ifndef FSBL_DCACHE
 				Xil_DCacheFlush();
                 Xil_DCacheDisable();
+#endif
+				FSBL_TIMELINE_END(FSBL_STAGE_AUTHENTICATION,
+						PartitionNum);
 #else
 				/*
 				 * In case user not enabled RSA authentication feature
@@ -515,9 +946,11 @@ u32 LoadBootImage(void)
 			 * Decrypt PS partition
 			 */
 			if (EncryptedPartitionFlag && PSPartitionFlag) {
+				FSBL_TIMELINE_BEGIN(FSBL_STAGE_DECRYPTION, PartitionNum);
 				Status = DecryptPartition(PartitionStartAddr,
 						PartitionDataLength,
 						PartitionImageLength);
+				FSBL_TIMELINE_END(FSBL_STAGE_DECRYPTION, PartitionNum);
 				if (Status != XST_SUCCESS) {
 					fsbl_printf(DEBUG_GENERAL,"DECRYPTION_FAIL\r\n");
 					OutputStatus(DECRYPTION_FAIL);
@@ -526,14 +959,17 @@ u32 LoadBootImage(void)
 			}
 
 			/*
-			 * Load Signed PL partition in Fabric
+			 * Load Signed PL partition in Fabric, a compressed one is
+			 * already loaded
 			 */
-			if (PLPartitionFlag) {
+			if (PLPartitionFlag && (CompressedPartitionFlag == 0)) {
+				FSBL_TIMELINE_BEGIN(FSBL_STAGE_PCAP, PartitionNum);
 				Status = PcapLoadPartition((u32*)PartitionStartAddr,
 						(u32*)PartitionLoadAddr,
 						PartitionImageLength,
 						PartitionDataLength,
 						EncryptedPartitionFlag);
+				FSBL_TIMELINE_END(FSBL_STAGE_PCAP, PartitionNum);
 				if (Status != XST_SUCCESS) {
 					fsbl_printf(DEBUG_GENERAL,"BITSTREAM_DOWNLOAD_FAIL\r\n");
 					OutputStatus(BITSTREAM_DOWNLOAD_FAIL);
@@ -542,6 +978,42 @@ u32 LoadBootImage(void)
 			}
 		}
 
+#ifdef FSBL_MANIFEST
+		/*
+		 * Chunk hashes of the partitions after the manifest, trusted
+		 * once the manifest itself is validated
+		 */
+		if (ManifestPartition) {
+			/*
+			 * Its checksum may still be calculated on CPU1 or in
+			 * the batch
+			 */
+#ifdef FSBL_CPU1_WORKER
+			Cpu1ChecksumCollect();
+#endif
+#ifdef FSBL_MD5_BATCH
+			ChecksumBatchFlush();
+#endif
+			if ((PartitionChecksumFlag == 0) &&
+					(SignedPartitionFlag == 0)) {
+				fsbl_printf(DEBUG_GENERAL,
+						"Boot manifest not validated, ignored\r\n");
+			} else if (FsblManifestLoad(PartitionLoadAddr,
+					PartitionImageLength << WORD_LENGTH_SHIFT) !=
+					XST_SUCCESS) {
+				fsbl_printf(DEBUG_GENERAL,"PARTITION_CHECKSUM_FAIL\r\n");
+				OutputStatus(PARTITION_CHECKSUM_FAIL);
+				FsblFallback();
+			}
+		}
+#endif
+
+#ifdef FSBL_WARM_BOOT
+		if (WarmPartition) {
+			FsblWarmAdd(PartitionNum, HeaderPtr, ImageStartAddress +
+					(PartitionChecksumOffset << WORD_LENGTH_SHIFT));
+		}
+#endif
 
 		/*
 		 * FSBL user hook call after bitstream download
@@ -560,6 +1032,23 @@ u32 LoadBootImage(void)
 		PartitionNum++;
 	}
 
+#ifdef FSBL_MD5_BATCH
+	ChecksumBatchFlush();
+#endif
+
+#ifdef FSBL_CPU1_WORKER
+	Cpu1ChecksumCollect();
+	FsblCpu1Stop();
+#endif
+
+#ifdef FSBL_WARM_BOOT
+	FsblWarmSeal();
+#endif
+
+#ifdef FSBL_DEFERRED
+	FsblDeferredSeal();
+#endif
+
 	return ExecAddress;
 }
 
@@ -581,6 +1070,11 @@ u32 GetPartitionHeaderInfo(u32 ImageBaseAddress)
     u32 PartitionHeaderOffset;
     u32 Status;
 
+    /*
+     * Read all the headers in one move, the fields below come from memory.
+     * If the move fails, they are read one by one.
+     */
+    (void)ImageHeaderCacheLoad(ImageBaseAddress, IMAGE_HEADER_CACHE_SIZE);
 
     /*
      * Get the length of the FSBL from BootHeader
@@ -662,7 +1156,7 @@ u32 GetPartitionHeaderStartAddr(u32 ImageAddress, u32 *Offset)
 {
 	u32 Status;
 
-	Status = MoveImage(ImageAddress + IMAGE_PHDR_OFFSET, (u32)Offset, 4);
+	Status = ImageHeaderRead(ImageAddress + IMAGE_PHDR_OFFSET, (u32)Offset, 4);
 	if (Status != XST_SUCCESS) {
 		fsbl_printf(DEBUG_GENERAL,"Move Image failed\r\n");
 		return XST_FAILURE;
@@ -690,7 +1184,7 @@ u32 GetImageHeaderStartAddr(u32 ImageAddress, u32 *Offset)
 {
 	u32 Status;
 
-	Status = MoveImage(ImageAddress + IMAGE_HDR_OFFSET, (u32)Offset, 4);
+	Status = ImageHeaderRead(ImageAddress + IMAGE_HDR_OFFSET, (u32)Offset, 4);
 	if (Status != XST_SUCCESS) {
 		fsbl_printf(DEBUG_GENERAL,"Move Image failed\r\n");
 		return XST_FAILURE;
@@ -717,7 +1211,7 @@ u32 GetFsblLength(u32 ImageAddress, u32 *FsblLength)
 {
 	u32 Status;
 
-	Status = MoveImage(ImageAddress + IMAGE_TOT_BYTE_LEN_OFFSET,
+	Status = ImageHeaderRead(ImageAddress + IMAGE_TOT_BYTE_LEN_OFFSET,
 							(u32)FsblLength, 4);
 	if (Status != XST_SUCCESS) {
 		fsbl_printf(DEBUG_GENERAL,"Move Image failed reading FsblLength\r\n");
@@ -763,7 +1257,7 @@ u32 GetNAuthImageHeader(u32 ImageBaseAddress)
 	}
 	Size = IMAGE_HEADER_TABLE_SIZE + TOTAL_IMAGE_HEADER_SIZE;
 	/* Read image header table and all image headers */
-	Status = MoveImage(ImageBaseAddress + Offset, (u32)HdrTmpPtr,
+	Status = ImageHeaderRead(ImageBaseAddress + Offset, (u32)HdrTmpPtr,
 							Size);
 	if (Status != XST_SUCCESS) {
 		fsbl_printf(DEBUG_GENERAL,"Move IHT and IHs failed\r\n");
@@ -807,6 +1301,71 @@ u32 GetNAuthImageHeader(u32 ImageBaseAddress)
 
 	return XST_SUCCESS;
 }
+
+#ifdef FSBL_AUTH_BATCH
+/*****************************************************************************/
+/**
+*
+* This function reads the certificate of each signed partition owned by FSBL
+* and authenticates its SPK, so that a bad certificate is found before any
+* partition is loaded. The SPKs stay in the SPK cache of rsa.c for the
+* partition signatures.
+*
+* @param	ImageBaseAddress is the start address of the image
+* @param	FirstPartition is the first partition FSBL loads
+*
+* @return	- XST_SUCCESS if all SPKs are authenticated
+* 			- XST_FAILURE if one is not, or its certificate cannot be read
+*
+* @note		The partition headers are already authenticated.
+*
+****************************************************************************/
+static u32 AuthenticateSpkBatch(u32 ImageBaseAddress, u32 FirstPartition)
+{
+	PartHeader *HeaderPtr;
+	u32 PartitionNum;
+	u32 Length;
+	u32 Status;
+
+	for (PartitionNum = FirstPartition; PartitionNum < PartitionCount;
+			PartitionNum++) {
+		HeaderPtr = &PartitionHeader[PartitionNum];
+
+		if (((HeaderPtr->PartitionAttr & ATTRIBUTE_PARTITION_OWNER_MASK) !=
+				ATTRIBUTE_PARTITION_OWNER_FSBL) ||
+				((HeaderPtr->PartitionAttr &
+					ATTRIBUTE_RSA_PRESENT_MASK) == 0)) {
+			continue;
+		}
+
+		Length = HeaderPtr->PartitionWordLen << WORD_LENGTH_SHIFT;
+		if ((HeaderPtr->PartitionWordLen > MAXIMUM_IMAGE_WORD_LEN) ||
+				(Length < RSA_SIGNATURE_SIZE)) {
+			fsbl_printf(DEBUG_GENERAL,"Partition %lu has no certificate\r\n",
+					PartitionNum);
+			return XST_FAILURE;
+		}
+
+		Status = MoveImage(ImageBaseAddress +
+				(HeaderPtr->PartitionStart << WORD_LENGTH_SHIFT) +
+				Length - RSA_SIGNATURE_SIZE,
+				(u32)SpkCertificate, RSA_SPK_CERT_SIZE);
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL,"Move certificate failed\r\n");
+			return XST_FAILURE;
+		}
+
+		Status = AuthenticateSpk((u8 *)SpkCertificate);
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL,"Partition %lu SPK authentication "
+					"failed\r\n", PartitionNum);
+			return XST_FAILURE;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+#endif
 #endif
 /*****************************************************************************/
 /**
@@ -828,7 +1387,7 @@ u32 LoadPartitionsHeaderInfo(u32 PartHeaderOffset,  PartHeader *Header)
 {
 	u32 Status;
 
-	Status = MoveImage(PartHeaderOffset, (u32)Header, sizeof(PartHeader)*MAX_PARTITION_NUMBER);
+	Status = ImageHeaderRead(PartHeaderOffset, (u32)Header, sizeof(PartHeader)*MAX_PARTITION_NUMBER);
 	if (Status != XST_SUCCESS) {
 		fsbl_printf(DEBUG_GENERAL,"Move Image failed\r\n");
 		return XST_FAILURE;
@@ -1079,12 +1638,27 @@ u32 PartitionMove(u32 ImageBaseAddress, PartHeader *Header)
     u32 ImageWordLen;
     u32 DataWordLen;
 
+	HashedPartitionValid = 0;
+#ifdef RSA_SUPPORT
+	HashedPartitionShaValid = 0;
+#endif
+
 	SourceAddr = ImageBaseAddress;
 	SourceAddr += Header->PartitionStart<<WORD_LENGTH_SHIFT;
 	LoadAddr = Header->LoadAddr;
 	ImageWordLen = Header->ImageWordLen;
 	DataWordLen = Header->DataWordLen;
 
+#ifdef FSBL_LZ4
+	/*
+	 * Compressed partition decompressed as it is read
+	 */
+	if (CompressedPartitionFlag) {
+		return PartitionMoveCompressed(SourceAddr, LoadAddr,
+				Header->PartitionWordLen);
+	}
+#endif
+
 	/*
 	 * Add flash base address for linear boot devices
 	 */
@@ -1123,6 +1697,39 @@ u32 PartitionMove(u32 ImageBaseAddress, PartHeader *Header)
 	 * boot device
 	 */
 	if (!LinearBootDeviceFlag) {
+		/*
+		 * Plain PL partition streamed to the fabric from the boot
+		 * device, through a double buffer at the DDR temporary location
+		 */
+		if (PLPartitionFlag && (!EncryptedPartitionFlag) &&
+				(!(SignedPartitionFlag || PartitionChecksumFlag))) {
+			Status = PcapStreamPartition(SourceAddr, ImageWordLen,
+						(u32*)DDR_TEMP_START_ADDR);
+			if(Status != XST_SUCCESS) {
+				fsbl_printf(DEBUG_GENERAL, "PCAP Bitstream Download Failed\r\n");
+				return XST_FAILURE;
+			}
+			return XST_SUCCESS;
+		}
+
+#ifdef FSBL_AES_STREAM
+		/*
+		 * Encrypted PS partition decrypted in place as it is read,
+		 * a short one is read and then decrypted
+		 */
+		if (PSPartitionFlag && SecureTransferFlag) {
+			Status = PcapStreamDecrypt(SourceAddr, LoadAddr,
+						ImageWordLen, DataWordLen);
+			if (Status == XST_SUCCESS) {
+				return XST_SUCCESS;
+			}
+			if (Status != XST_INVALID_PARAM) {
+				fsbl_printf(DEBUG_GENERAL, "PCAP Data Transfer Failed\r\n");
+				return XST_FAILURE;
+			}
+		}
+#endif
+
 		/*
 		 * PL partition copied to DDR temporary location
 		 */
@@ -1158,13 +1765,21 @@ u32 PartitionMove(u32 ImageBaseAddress, PartHeader *Header)
 		}
 
 		/*
-		 * Data transfer using PCAP
+		 * Data transfer using PCAP, checksum and signed partitions
+		 * copied as is are hashed while the PCAP moves them
 		 */
-		Status = PcapDataTransfer((u32*)SourceAddr,
+		if (LinearBootDeviceFlag &&
+				(PartitionChecksumFlag || SignedPartitionFlag) &&
+				(!SecureTransferFlag)) {
+			Status = PcapDataTransferHashed(SourceAddr, LoadAddr,
+						ImageWordLen);
+		} else {
+			Status = PcapDataTransfer((u32*)SourceAddr,
 						(u32*)LoadAddr,
 						ImageWordLen,
 						DataWordLen,
 						SecureTransferFlag);
+		}
 		if(Status != XST_SUCCESS) {
 			fsbl_printf(DEBUG_GENERAL, "PCAP Data Transfer Failed\r\n");
 			return XST_FAILURE;
@@ -1196,41 +1811,452 @@ u32 PartitionMove(u32 ImageBaseAddress, PartHeader *Header)
 }
 
 
+#ifdef FSBL_QSPI_XIP
 /******************************************************************************/
 /**
 *
-* This function load the decrypts partition
+* This function checks that a PS partition loaded in the linear QSPI window
+* can execute in place: the boot device is the linear QSPI, the partition
+* is plain and its load address is the window address it is at, so that it
+* is already where it runs.
 *
-* @param	StartAddr Source start address
-* @param	DataLength Data length in words
-* @param	ImageLength Image length in words
+* @param	ImageBaseAddress Start address of the image in the flash
+* @param	Header Partition header of the partition
 *
 * @return
-*		- XST_SUCCESS if decryption successful
-*		- XST_FAILURE if decryption failed
+*		- XST_SUCCESS if the partition executes in place
+*		- XST_FAILURE otherwise
 *
-* @note		None
+* @note		The application maps the window cacheable and must not take
+*		the QSPI controller out of linear mode while it runs code or
+*		reads data of the partition.
 *
 *******************************************************************************/
-u32 DecryptPartition(u32 StartAddr, u32 DataLength, u32 ImageLength)
+static u32 XipPartitionCheck(u32 ImageBaseAddress, PartHeader *Header)
 {
-	u32 Status;
-	u8 SecureTransferFlag =1;
+	u32 WindowAddr;
+	u32 Length;
 
-	/*
-	 * Data transfer using PCAP
-	 */
-	Status = PcapDataTransfer((u32*)StartAddr,
-					(u32*)StartAddr,
-					ImageLength,
-					DataLength,
-					SecureTransferFlag);
-	if (Status != XST_SUCCESS) {
-		fsbl_printf(DEBUG_GENERAL,"PCAP Data Transfer failed \r\n");
+	if ((LinearBootDeviceFlag == 0) ||
+			(FlashReadBaseAddress != XPS_QSPI_LINEAR_BASEADDR)) {
+		fsbl_printf(DEBUG_GENERAL, "XIP needs a linear QSPI boot\r\n");
 		return XST_FAILURE;
 	}
 
-	return XST_SUCCESS;
+	if (EncryptedPartitionFlag || SignedPartitionFlag ||
+			CompressedPartitionFlag) {
+		fsbl_printf(DEBUG_GENERAL, "XIP partition must be plain\r\n");
+		return XST_FAILURE;
+	}
+
+	WindowAddr = FlashReadBaseAddress + ImageBaseAddress +
+			(Header->PartitionStart << WORD_LENGTH_SHIFT);
+	Length = Header->PartitionWordLen << WORD_LENGTH_SHIFT;
+	if ((Header->LoadAddr != WindowAddr) || (Length == 0) ||
+			(Length - 1 > XIP_WINDOW_END - WindowAddr)) {
+		fsbl_printf(DEBUG_GENERAL, "XIP load address 0x%08lx, "
+				"partition at 0x%08lx\r\n", Header->LoadAddr,
+				WindowAddr);
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+#endif
+
+/******************************************************************************/
+/**
+*
+* This function copies a partition using non-secure PCAP in chunks of
+* PCAP_STREAM_CHUNK_WORDS words, and hashes it while it is moved: each
+* chunk is hashed in DDR while the PCAP moves the next one. The MD5
+* checksum of checksum partitions is kept for CalcPartitionChecksum(), the
+* SHA-256 hash of signed partitions for CalcPartitionHash().
+*
+* @param	SourceAddr Source address of the partition
+* @param	LoadAddr Destination address of the partition
+* @param	WordLen Length of the partition in words
+*
+* @return
+*		- XST_SUCCESS if the transfer is successful
+*		- XST_FAILURE if the transfer fails
+*
+* @note		The D-cache is disabled, so that the data hashed is the data
+*		the PCAP wrote.
+*
+*******************************************************************************/
+static u32 PcapDataTransferHashed(u32 SourceAddr, u32 LoadAddr,
+		u32 WordLen)
+{
+	PartitionHashType PartitionHash;
+	u32 Status;
+	u32 Offset = 0;
+	u32 ChunkLen;
+	u32 NextLen;
+
+	MD5Init(&PartitionHash.Md5);
+#ifdef RSA_SUPPORT
+	Sha256Init(&PartitionHash.Sha);
+	PartitionHash.ShaLength = 0;
+	if (SignedPartitionFlag &&
+			((WordLen << WORD_LENGTH_SHIFT) >= RSA_PARTITION_SIGNATURE_SIZE)) {
+		/*
+		 * The partition signature is not part of the hash
+		 */
+		PartitionHash.ShaLength = (WordLen << WORD_LENGTH_SHIFT) -
+						RSA_PARTITION_SIGNATURE_SIZE;
+	}
+#endif
+
+	ChunkLen = (WordLen > PCAP_STREAM_CHUNK_WORDS) ?
+			PCAP_STREAM_CHUNK_WORDS : WordLen;
+
+	Status = PcapDataTransfer((u32*)SourceAddr, (u32*)LoadAddr,
+					ChunkLen, ChunkLen, 0);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	while ((Offset + ChunkLen) < WordLen) {
+		NextLen = WordLen - (Offset + ChunkLen);
+		if (NextLen > PCAP_STREAM_CHUNK_WORDS) {
+			NextLen = PCAP_STREAM_CHUNK_WORDS;
+		}
+
+		/*
+		 * Start the next chunk, and hash the one already in DDR
+		 * meanwhile
+		 */
+		Status = PcapDataTransferStart(
+				(u32*)(SourceAddr +
+					((Offset + ChunkLen) << WORD_LENGTH_SHIFT)),
+				(u32*)(LoadAddr +
+					((Offset + ChunkLen) << WORD_LENGTH_SHIFT)),
+				NextLen, NextLen, 0);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		PartitionHashUpdate(&PartitionHash, LoadAddr,
+				Offset << WORD_LENGTH_SHIFT,
+				ChunkLen << WORD_LENGTH_SHIFT);
+
+		Status = PcapDataTransferWait();
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		Offset += ChunkLen;
+		ChunkLen = NextLen;
+	}
+
+	PartitionHashUpdate(&PartitionHash, LoadAddr,
+			Offset << WORD_LENGTH_SHIFT, ChunkLen << WORD_LENGTH_SHIFT);
+
+	HashedPartitionAddr = LoadAddr;
+	HashedPartitionLength = WordLen << WORD_LENGTH_SHIFT;
+
+	if (PartitionChecksumFlag) {
+		MD5Final(&PartitionHash.Md5, HashedPartitionChecksum, 0);
+		HashedPartitionValid = 1;
+	}
+
+#ifdef RSA_SUPPORT
+	if (PartitionHash.ShaLength != 0) {
+		Sha256Final(&PartitionHash.Sha, HashedPartitionHash);
+		HashedPartitionShaLength = PartitionHash.ShaLength;
+		HashedPartitionShaValid = 1;
+	}
+#endif
+
+	return XST_SUCCESS;
+}
+
+
+/******************************************************************************/
+/**
+*
+* This function adds a chunk of a partition, already in DDR, to the hashes
+* it is calculated with
+*
+* @param	HashPtr Hashes of the partition
+* @param	LoadAddr Address of the partition
+* @param	Offset Offset of the chunk in the partition, in bytes
+* @param	Length Length of the chunk in bytes
+*
+* @return	None
+*
+* @note		None
+*
+*******************************************************************************/
+static void PartitionHashUpdate(PartitionHashType *HashPtr, u32 LoadAddr,
+		u32 Offset, u32 Length)
+{
+	if (PartitionChecksumFlag) {
+		MD5Update(&HashPtr->Md5, (u8*)(LoadAddr + Offset), Length, 0);
+	}
+
+#ifdef RSA_SUPPORT
+	if (Offset < HashPtr->ShaLength) {
+		if (Length > (HashPtr->ShaLength - Offset)) {
+			Length = HashPtr->ShaLength - Offset;
+		}
+		Sha256Update(&HashPtr->Sha, (u8*)(LoadAddr + Offset), Length);
+	}
+#endif
+}
+
+
+#ifdef FSBL_LZ4
+/******************************************************************************/
+/**
+*
+* This function decompresses an LZ4 partition while it is read from the
+* boot device, one chunk at a time through the OCM. A PS partition is
+* decompressed to its load address. A PL partition is decompressed to the
+* DDR temporary location and streamed to the PCAP, each block while the
+* next one is decoded. The MD5 checksum of checksum partitions is
+* calculated on the compressed stream as it is read, and kept for
+* CalcPartitionChecksum().
+*
+* @param	SourceAddr Offset of the partition on the boot device
+* @param	LoadAddr Destination address of the decompressed PS partition
+* @param	WordLen Length of the partition on the boot device in words
+*
+* @return
+*		- XST_SUCCESS if the partition is decompressed, and loaded in
+*		  the fabric for a PL partition
+*		- XST_FAILURE if the read fails, the frame is corrupt or the
+*		  PCAP fails
+*
+* @note		None
+*
+*******************************************************************************/
+static u32 PartitionMoveCompressed(u32 SourceAddr, u32 LoadAddr,
+		u32 WordLen)
+{
+	Lz4PartitionType Partition;
+	Lz4Stream Stream;
+	u32 Length;
+	u32 Status;
+
+	Partition.Addr = SourceAddr;
+	Partition.Left = WordLen << WORD_LENGTH_SHIFT;
+	MD5Init(&Partition.Md5);
+	Partition.Dst = PLPartitionFlag ? DDR_TEMP_START_ADDR : LoadAddr;
+	Partition.Queued = 0;
+	Partition.Held = 0;
+	Partition.PcapBusy = 0;
+
+	Stream.Next = NULL;
+	Stream.Avail = 0;
+	Stream.Refill = Lz4Refill;
+	Stream.Flush = NULL;
+	Stream.Ref = &Partition;
+
+	if (PLPartitionFlag) {
+		Stream.Flush = Lz4PcapFlush;
+		Status = PcapStreamBegin();
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL, "PCAP Bitstream Download Failed\r\n");
+			return XST_FAILURE;
+		}
+	}
+
+	Status = Lz4Decompress(&Stream, (u8*)Partition.Dst,
+			(DDR_END_ADDR - Partition.Dst) + 1, &Length);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL, "LZ4 Decompression Failed\r\n");
+		return XST_FAILURE;
+	}
+
+	fsbl_printf(DEBUG_INFO, "Decompressed Length: 0x%08x\r\n", Length);
+
+	if (PLPartitionFlag) {
+		/*
+		 * Last block, the bitstream is made of words
+		 */
+		if ((Length & 0x3) ||
+				(Length == Partition.Queued)) {
+			fsbl_printf(DEBUG_GENERAL, "Invalid Bitstream Length\r\n");
+			return XST_FAILURE;
+		}
+
+		if (Partition.PcapBusy) {
+			Status = PcapStreamChunkWait();
+			if (Status != XST_SUCCESS) {
+				return XST_FAILURE;
+			}
+		}
+
+		Status = PcapStreamChunk((u32*)(Partition.Dst + Partition.Queued),
+				(Length - Partition.Queued) >> WORD_LENGTH_SHIFT, 1);
+		if (Status == XST_SUCCESS) {
+			Status = PcapLoadPartitionWait();
+		}
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL, "PCAP Bitstream Download Failed\r\n");
+			return XST_FAILURE;
+		}
+	}
+
+	/*
+	 * The checksum covers the padding after the frame
+	 */
+	while (PartitionChecksumFlag && (Partition.Left != 0)) {
+		Status = Lz4Refill(&Stream);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+	}
+
+	if (PartitionChecksumFlag) {
+		MD5Final(&Partition.Md5, HashedPartitionChecksum, 0);
+		HashedPartitionAddr = Partition.Dst;
+		HashedPartitionLength = WordLen << WORD_LENGTH_SHIFT;
+		HashedPartitionValid = 1;
+	}
+
+	return XST_SUCCESS;
+}
+
+
+/******************************************************************************/
+/**
+*
+* This function passes the blocks of a compressed bitstream decoded so far
+* to the PCAP. The last block is held back until the next one is decoded,
+* as only the last chunk of the bitstream ends the transfer, and one chunk
+* is in flight at a time.
+*
+* @param	Stream Compressed stream, Ref is the Lz4PartitionType
+* @param	Length Bytes decompressed so far
+*
+* @return
+*		- XST_SUCCESS if the blocks are queued
+*		- XST_FAILURE if the PCAP fails
+*
+* @note		None
+*
+*******************************************************************************/
+static u32 Lz4PcapFlush(Lz4Stream *Stream, u32 Length)
+{
+	Lz4PartitionType *Partition = (Lz4PartitionType *)Stream->Ref;
+	u32 Status;
+
+	if (Partition->Held > Partition->Queued) {
+		if (Partition->PcapBusy) {
+			Status = PcapStreamChunkWait();
+			if (Status != XST_SUCCESS) {
+				return XST_FAILURE;
+			}
+		}
+
+		Status = PcapStreamChunk((u32*)(Partition->Dst + Partition->Queued),
+				(Partition->Held - Partition->Queued) >> WORD_LENGTH_SHIFT,
+				0);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+		Partition->PcapBusy = 1;
+		Partition->Queued = Partition->Held;
+	}
+
+	Partition->Held = Length & ~0x3;
+
+	return XST_SUCCESS;
+}
+
+
+/******************************************************************************/
+/**
+*
+* This function reads the next chunk of a compressed partition from the
+* boot device, for the LZ4 decoder
+*
+* @param	Stream Compressed stream, Ref is the Lz4PartitionType
+*
+* @return
+*		- XST_SUCCESS if the chunk is read
+*		- XST_FAILURE at the end of the partition or if the read fails
+*
+* @note		None
+*
+*******************************************************************************/
+static u32 Lz4Refill(Lz4Stream *Stream)
+{
+	Lz4PartitionType *Source = (Lz4PartitionType *)Stream->Ref;
+	u32 Length;
+	u32 Status;
+
+	if (Source->Left == 0) {
+		return XST_FAILURE;
+	}
+
+	Length = (Source->Left > LZ4_CHUNK_SIZE) ? LZ4_CHUNK_SIZE : Source->Left;
+
+#ifdef XPAR_XWDTPS_0_BASEADDR
+	/*
+	 * Prevent WDT reset
+	 */
+	XWdtPs_RestartWdt(&Watchdog);
+#endif
+
+	Status = MoveImage(Source->Addr, (u32)Lz4Chunk, Length);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL, "Move Image Failed\r\n");
+		return XST_FAILURE;
+	}
+
+	if (PartitionChecksumFlag) {
+		MD5Update(&Source->Md5, (u8*)Lz4Chunk, Length, 0);
+	}
+
+	Stream->Next = (const u8 *)Lz4Chunk;
+	Stream->Avail = Length;
+	Source->Addr += Length;
+	Source->Left -= Length;
+
+	return XST_SUCCESS;
+}
+#endif
+
+
+/******************************************************************************/
+/**
+*
+* This function load the decrypts partition
+*
+* @param	StartAddr Source start address
+* @param	DataLength Data length in words
+* @param	ImageLength Image length in words
+*
+* @return
+*		- XST_SUCCESS if decryption successful
+*		- XST_FAILURE if decryption failed
+*
+* @note		None
+*
+*******************************************************************************/
+u32 DecryptPartition(u32 StartAddr, u32 DataLength, u32 ImageLength)
+{
+	u32 Status;
+	u8 SecureTransferFlag =1;
+
+	/*
+	 * Data transfer using PCAP
+	 */
+	Status = PcapDataTransfer((u32*)StartAddr,
+					(u32*)StartAddr,
+					ImageLength,
+					DataLength,
+					SecureTransferFlag);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL,"PCAP Data Transfer failed \r\n");
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
 }
 
 /******************************************************************************/
@@ -1349,11 +2375,22 @@ u32 GetPartitionChecksum(u32 ChecksumOffset, u8 *Checksum)
 *		- XST_SUCCESS if Checksum calculate successful
 *		- XST_FAILURE if Checksum calculate failed
 *
-* @note		None
+* @note		The checksum calculated by PcapDataTransferHashed() while
+*		the partition was moved is used when it covers the same data.
 *
 *******************************************************************************/
 u32 CalcPartitionChecksum(u32 SourceAddr, u32 DataLength, u8 *Checksum)
 {
+	u32 Index;
+
+	if (HashedPartitionValid && (HashedPartitionAddr == SourceAddr) &&
+			(HashedPartitionLength == DataLength)) {
+		for (Index = 0; Index < MD5_CHECKSUM_SIZE; Index++) {
+			Checksum[Index] = HashedPartitionChecksum[Index];
+		}
+		return XST_SUCCESS;
+	}
+
 	/*
 	 * Calculate checksum using MD5 algorithm
 	 */
@@ -1362,3 +2399,421 @@ u32 CalcPartitionChecksum(u32 SourceAddr, u32 DataLength, u8 *Checksum)
     return XST_SUCCESS;
 }
 
+
+#ifdef RSA_SUPPORT
+/******************************************************************************/
+/**
+*
+* This function calculates the SHA-256 hash of a partition to authenticate
+*
+* @param 	Start address
+* @param 	Length of the data
+* @param 	Hash pointer
+*
+* @return	None
+*
+* @note		The hash calculated by PcapDataTransferHashed() while the
+*		partition was moved is used when it covers the same data.
+*
+*******************************************************************************/
+static void CalcPartitionHash(u32 SourceAddr, u32 DataLength, u8 *Hash)
+{
+	u32 Index;
+
+	if (HashedPartitionShaValid && (HashedPartitionAddr == SourceAddr) &&
+			(HashedPartitionShaLength == DataLength)) {
+		for (Index = 0; Index < SHA256_DIGEST_BYTE_SIZE; Index++) {
+			Hash[Index] = HashedPartitionHash[Index];
+		}
+		return;
+	}
+
+	Sha256((u8 *)SourceAddr, DataLength, Hash);
+}
+#endif
+
+#ifdef FSBL_CPU1_WORKER
+/******************************************************************************/
+/**
+*
+* This function reads the checksum of a partition from flash and posts its
+* calculation to CPU1. Cpu1ChecksumCollect() compares them.
+*
+* @param	PartitionNum is the partition number
+* @param	StartAddr is the start address of the partition data
+* @param	Length is the length of the partition data
+* @param	ChecksumOffset is the offset of the checksum in flash
+*
+* @return
+*		- XST_SUCCESS if the calculation is posted
+*		- XST_FAILURE if the partition is to be checked on CPU0
+*
+* @note		Partitions the PCAP already hashed while moving them are
+*		left to CPU0, their checksum is ready.
+*
+*******************************************************************************/
+static u32 Cpu1ChecksumPost(u32 PartitionNum, u32 StartAddr, u32 Length,
+		u32 ChecksumOffset)
+{
+	u32 Status;
+
+	if ((Cpu1Ready == 0) || (Cpu1ChecksumPending == 1)) {
+		return XST_FAILURE;
+	}
+
+	if (HashedPartitionValid && (HashedPartitionAddr == StartAddr) &&
+			(HashedPartitionLength == Length)) {
+		return XST_FAILURE;
+	}
+
+	/*
+	 * The boot device stays on CPU0
+	 */
+	Status = GetPartitionChecksum(ChecksumOffset, Cpu1ChecksumExpected);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	FSBL_TIMELINE_BEGIN(FSBL_STAGE_CHECKSUM, PartitionNum);
+	Status = FsblCpu1Post(Cpu1ChecksumJob, StartAddr, Length,
+			(u32)Cpu1ChecksumCalculated);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	fsbl_printf(DEBUG_INFO, "Partition checksum on CPU1\r\n");
+
+	Cpu1ChecksumPending = 1;
+	Cpu1ChecksumPartition = PartitionNum;
+	Cpu1ChecksumAddr = StartAddr;
+	Cpu1ChecksumLength = Length;
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function is the checksum job of CPU1.
+*
+* @param	StartAddr is the start address of the partition data
+* @param	Length is the length of the partition data
+* @param	Checksum is the address of the calculated checksum
+*
+* @return	XST_SUCCESS
+*
+* @note		Runs on CPU1.
+*
+*******************************************************************************/
+static u32 Cpu1ChecksumJob(u32 StartAddr, u32 Length, u32 Checksum)
+{
+	md5((u8 *)StartAddr, Length, (u8 *)Checksum, 0);
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function tells whether a range overlaps the partition CPU1 is
+* checking.
+*
+* @param	StartAddr is the start address of the range
+* @param	Length is the length of the range
+*
+* @return	1 if it overlaps, 0 otherwise
+*
+* @note		None
+*
+*******************************************************************************/
+static u32 Cpu1ChecksumOverlaps(u32 StartAddr, u32 Length)
+{
+	if (Cpu1ChecksumPending == 0) {
+		return 0;
+	}
+
+	if ((StartAddr < (Cpu1ChecksumAddr + Cpu1ChecksumLength)) &&
+			(Cpu1ChecksumAddr < (StartAddr + Length))) {
+		return 1;
+	}
+
+	return 0;
+}
+
+/******************************************************************************/
+/**
+*
+* This function waits for the checksum calculated on CPU1 and compares it
+* with the one read from flash, FSBL falls back if they differ.
+*
+* @param	None
+*
+* @return	None
+*
+* @note		Nothing is done if no checksum is pending.
+*
+*******************************************************************************/
+static void Cpu1ChecksumCollect(void)
+{
+	u32 Status;
+	u32 Index;
+
+	if (Cpu1ChecksumPending == 0) {
+		return;
+	}
+
+	Status = FsblCpu1Wait();
+	Cpu1ChecksumPending = 0;
+	FSBL_TIMELINE_END(FSBL_STAGE_CHECKSUM, Cpu1ChecksumPartition);
+
+	if (Status == XST_SUCCESS) {
+		for (Index = 0; Index < MD5_CHECKSUM_SIZE; Index++) {
+			if (Cpu1ChecksumExpected[Index] !=
+					Cpu1ChecksumCalculated[Index]) {
+				fsbl_printf(DEBUG_GENERAL, "Error: "
+						"Partition DataChecksum 0x%0x!= 0x%0x\r\n",
+						Cpu1ChecksumExpected[Index],
+						Cpu1ChecksumCalculated[Index]);
+				Status = XST_FAILURE;
+				break;
+			}
+		}
+	}
+
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL,"PARTITION_CHECKSUM_FAIL\r\n");
+		OutputStatus(PARTITION_CHECKSUM_FAIL);
+		FsblFallback();
+	}
+
+	fsbl_printf(DEBUG_INFO, "Partition %lu Validation Done\r\n",
+			Cpu1ChecksumPartition);
+}
+#endif
+
+#ifdef FSBL_MD5_BATCH
+/******************************************************************************/
+/**
+*
+* This function stages a plain PS partition for its checksum to be
+* calculated with the ones staged after it, the partitions being hashed
+* MD5_LANES at a time by md5x4(). The batch is checked as soon as it is
+* full.
+*
+* @param	PartitionNum is the partition number
+* @param	StartAddr is the start address of the partition data
+* @param	Length is the length of the partition data
+* @param	ChecksumOffset is the offset of the checksum in flash
+*
+* @return
+*		- XST_SUCCESS if the partition is staged
+*		- XST_FAILURE if the partition is to be checked at once
+*
+* @note		Partitions the PCAP already hashed while moving them are
+*		checked at once, their checksum is ready. The checksum is read
+*		from the image header cache when it holds it.
+*
+*******************************************************************************/
+static u32 ChecksumBatchAdd(u32 PartitionNum, u32 StartAddr, u32 Length,
+		u32 ChecksumOffset)
+{
+	u32 Status;
+
+	if (HashedPartitionValid && (HashedPartitionAddr == StartAddr) &&
+			(HashedPartitionLength == Length)) {
+		return XST_FAILURE;
+	}
+
+	Status = ImageHeaderRead(ChecksumOffset,
+			(u32)ChecksumBatchExpected[ChecksumBatchCount],
+			MD5_CHECKSUM_SIZE);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	fsbl_printf(DEBUG_INFO, "Partition checksum batched\r\n");
+
+	ChecksumBatchPartition[ChecksumBatchCount] = PartitionNum;
+	ChecksumBatchAddr[ChecksumBatchCount] = StartAddr;
+	ChecksumBatchLength[ChecksumBatchCount] = Length;
+	ChecksumBatchCount++;
+
+	if (ChecksumBatchCount == MD5_LANES) {
+		ChecksumBatchFlush();
+	}
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function tells whether a range overlaps a partition of the checksum
+* batch.
+*
+* @param	StartAddr is the start address of the range
+* @param	Length is the length of the range
+*
+* @return	1 if it overlaps, 0 otherwise
+*
+* @note		None
+*
+*******************************************************************************/
+static u32 ChecksumBatchOverlaps(u32 StartAddr, u32 Length)
+{
+	u32 Index;
+
+	for (Index = 0; Index < ChecksumBatchCount; Index++) {
+		if ((StartAddr < (ChecksumBatchAddr[Index] +
+					ChecksumBatchLength[Index])) &&
+				(ChecksumBatchAddr[Index] < (StartAddr + Length))) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/******************************************************************************/
+/**
+*
+* This function calculates the checksums of the partitions of the batch at
+* once and compares them with the ones read from flash, FSBL falls back if
+* one differs.
+*
+* @param	None
+*
+* @return	None
+*
+* @note		Nothing is done if the batch is empty.
+*
+*******************************************************************************/
+static void ChecksumBatchFlush(void)
+{
+	u8 *Data[MD5_LANES];
+	u8 Checksum[MD5_LANES][MD5_CHECKSUM_SIZE];
+	u32 Count;
+	u32 Lane;
+	u32 Index;
+
+	Count = ChecksumBatchCount;
+	if (Count == 0) {
+		return;
+	}
+
+	ChecksumBatchCount = 0;
+
+	for (Lane = 0; Lane < Count; Lane++) {
+		Data[Lane] = (u8 *)ChecksumBatchAddr[Lane];
+	}
+
+#ifdef	XPAR_XWDTPS_0_BASEADDR
+	/*
+	 * Prevent WDT reset
+	 */
+	XWdtPs_RestartWdt(&Watchdog);
+#endif
+
+	FSBL_TIMELINE_BEGIN(FSBL_STAGE_CHECKSUM, ChecksumBatchPartition[0]);
+	md5x4(Data, ChecksumBatchLength, Count, Checksum, 0);
+	FSBL_TIMELINE_END(FSBL_STAGE_CHECKSUM, ChecksumBatchPartition[0]);
+
+	for (Lane = 0; Lane < Count; Lane++) {
+		for (Index = 0; Index < MD5_CHECKSUM_SIZE; Index++) {
+			if (ChecksumBatchExpected[Lane][Index] !=
+					Checksum[Lane][Index]) {
+				fsbl_printf(DEBUG_GENERAL, "Error: "
+						"Partition %lu DataChecksum 0x%0x!= 0x%0x\r\n",
+						ChecksumBatchPartition[Lane],
+						ChecksumBatchExpected[Lane][Index],
+						Checksum[Lane][Index]);
+				fsbl_printf(DEBUG_GENERAL,"PARTITION_CHECKSUM_FAIL\r\n");
+				OutputStatus(PARTITION_CHECKSUM_FAIL);
+				FsblFallback();
+			}
+		}
+
+		fsbl_printf(DEBUG_INFO, "Partition %lu Validation Done\r\n",
+				ChecksumBatchPartition[Lane]);
+	}
+}
+#endif
+
+/******************************************************************************/
+/**
+*
+* This function reads the start of an image into the image header cache, in
+* one move from the boot device.
+*
+* @param	ImageAddress is the start address of the image
+* @param	Length is the number of bytes to read, at most
+*		IMAGE_HEADER_CACHE_SIZE
+*
+* @return
+*		- XST_SUCCESS if the cache holds the bytes
+*		- XST_FAILURE if the move fails, the cache is then empty
+*
+* @note		Nothing is read if the cache already holds the bytes.
+*
+*******************************************************************************/
+u32 ImageHeaderCacheLoad(u32 ImageAddress, u32 Length)
+{
+	u32 Status;
+
+	if (Length > IMAGE_HEADER_CACHE_SIZE) {
+		Length = IMAGE_HEADER_CACHE_SIZE;
+	}
+
+	if ((HeaderCacheLength != 0) && (HeaderCacheAddr == ImageAddress) &&
+			(HeaderCacheLength >= Length)) {
+		return XST_SUCCESS;
+	}
+
+	HeaderCacheLength = 0;
+
+	Status = MoveImage(ImageAddress, (u32)HeaderCache, Length);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO, "Image header cache load failed\r\n");
+		return XST_FAILURE;
+	}
+
+	HeaderCacheAddr = ImageAddress;
+	HeaderCacheLength = Length;
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function reads header bytes of the image, from the image header
+* cache when it holds them and from the boot device otherwise.
+*
+* @param	SourceAddress is the address of the bytes on the boot device
+* @param	DestinationAddress is the address to copy them to
+* @param	LengthBytes is the number of bytes
+*
+* @return
+*		- XST_SUCCESS if the bytes are read
+*		- XST_FAILURE if the move from the boot device fails
+*
+* @note		Same interface as MoveImage.
+*
+*******************************************************************************/
+u32 ImageHeaderRead(u32 SourceAddress, u32 DestinationAddress,
+		u32 LengthBytes)
+{
+	u32 Offset;
+
+	if ((HeaderCacheLength != 0) && (SourceAddress >= HeaderCacheAddr)) {
+		Offset = SourceAddress - HeaderCacheAddr;
+		if ((Offset <= HeaderCacheLength) &&
+				(LengthBytes <= (HeaderCacheLength - Offset))) {
+			Xil_MemCpy((void *)DestinationAddress,
+					(u8 *)HeaderCache + Offset, LengthBytes);
+			return XST_SUCCESS;
+		}
+	}
+
+	return MoveImage(SourceAddress, DestinationAddress, LengthBytes);
+}
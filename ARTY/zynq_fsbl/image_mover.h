@@ -22,6 +22,10 @@
 * 8.00a kc	01/16/13	Added defines for partition owner attribute
 * 9.0   vns	03/21/22	Deleted GetImageHeaderAndSignature() and added
 *				GetNAuthImageHeader()
+* 21.3  qm	10/14/26	Added the image header cache,
+*				ImageHeaderCacheLoad() and ImageHeaderRead()
+*       qm	10/14/26	Added the XIP window of FSBL_QSPI_XIP
+*       qm	10/14/26	Added the deferred attribute of FSBL_DEFERRED
 * </pre>
 *
 * @note
@@ -53,6 +57,23 @@ extern "C" {
 									 TOTAL_IMAGE_HEADER_SIZE + \
 									 TOTAL_PARTITION_HEADER_SIZE + 64)
 
+/*
+ * Image header cache, the boot header, image header table, image headers
+ * and partition headers of bootgen images are in the first 4 KB. The image
+ * search reads up to the header checksum only. tools/boot_pack.py keeps
+ * them there and aligns the partitions after them to the erase blocks and
+ * banks of the flash. A footprint profile of fsbl.h gives it 16 KB, for
+ * images with their headers further out.
+ */
+#ifndef IMAGE_HEADER_CACHE_SIZE
+#ifdef FSBL_PROFILE
+#define IMAGE_HEADER_CACHE_SIZE		0x4000
+#else
+#define IMAGE_HEADER_CACHE_SIZE		0x1000
+#endif
+#endif
+#define IMAGE_HEADER_SEARCH_SIZE	(IMAGE_CHECKSUM_OFFSET + 4)
+
 /* Partition Header defines */
 #define PARTITION_IMAGE_WORD_LEN_OFFSET	0x00	/* Word length of image */
 #define PARTITION_DATA_WORD_LEN_OFFSET	0x04	/* Word length of data */
@@ -73,9 +94,18 @@ extern "C" {
 #define ATTRIBUTE_CHECKSUM_TYPE_MASK	0x7000	/* Checksum Type */
 #define ATTRIBUTE_RSA_PRESENT_MASK		0x8000	/* RSA Signature Present */
 #define ATTRIBUTE_PARTITION_OWNER_MASK	0x30000	/* Partition Owner */
+#define ATTRIBUTE_COMPRESSED_MASK		0x1000000 /* LZ4 frame, FSBL_LZ4 */
+#define ATTRIBUTE_DEFERRED_MASK		0x2000000 /* Left, FSBL_DEFERRED */
 
 #define ATTRIBUTE_PARTITION_OWNER_FSBL	0x00000	/* FSBL Partition Owner */
 
+/*
+ * PS partitions loaded in the linear QSPI window execute in place, with
+ * FSBL_QSPI_XIP
+ */
+#define XIP_WINDOW_START	XPS_QSPI_LINEAR_BASEADDR
+#define XIP_WINDOW_END		(XPS_QSPI_LINEAR_BASEADDR + 0x1FFFFFF)
+
 
 /**************************** Type Definitions *******************************/
 typedef u32 (*ImageMoverType)( u32 SourceAddress,
@@ -122,6 +152,10 @@ void HeaderDump(PartHeader *Header);
 u32 GetPartitionCount(PartHeader *Header);
 u32 ValidateHeader(PartHeader *Header);
 u32 DecryptPartition(u32 StartAddr, u32 DataLength, u32 ImageLength);
+u32 GetPartitionChecksum(u32 ChecksumOffset, u8 *Checksum);
+u32 ImageHeaderCacheLoad(u32 ImageAddress, u32 Length);
+u32 ImageHeaderRead(u32 SourceAddress, u32 DestinationAddress,
+		u32 LengthBytes);
 
 /************************** Variable Definitions *****************************/
 
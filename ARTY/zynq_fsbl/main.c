@@ -87,6 +87,42 @@
 * 21.2   ng  07/25/23   Fixed DDR, WDT, NAND and QSPI addresses support in SDT
 * 21.3   ng  03/09/24   Fix format specifier for 32 bit variables
 * 21.4   ng  10/03/24   Fix change in macro name for QSPI linear flash
+* 21.5   qm  10/14/26   Buffer the debug output, flush it in OutputStatus
+*                       and before the JTAG handoff
+*                       memcpy_rom uses Xil_MemCpy
+*                       HeaderChecksum reads the header in one move and
+*                       sums it with Xil_MemSum32
+* 21.6   qm  10/14/26   Mask the PCAP interrupt of FSBL_PCAP_INTR before
+*                       the handoff
+*                       Run MD5Benchmark() after the DDR check with
+*                       FSBL_MD5_BENCH
+*                       Boot timeline of FSBL_TIMELINE
+*                       The image search reads the ID and the header
+*                       checksum of each image in one move
+*                       The image search takes the images of the image
+*                       index of FSBL_IMAGE_INDEX first, and probes the ID
+*                       from the memory window of linear boot devices
+*                       Set up the boot device while the DDR controller
+*                       initializes with FSBL_EARLY_FLASH
+*                       Keep the data cache enabled with FSBL_DCACHE
+*                       Replay the packed ps7_init tables with
+*                       FSBL_PS7_PACK
+*                       Test the DDR with FSBL_DDR_TEST
+*                       Warm boot of FSBL_WARM_BOOT
+*                       Read the boot device through the boot device
+*                       layer of fsbl_bootdev.h
+*                       Hand off with the caches enabled with
+*                       FSBL_HANDOFF_CACHED
+*                       Panic dump to the QSPI flash in ErrorLockdown with
+*                       FSBL_PANIC
+*                       Clear the deferred partition table with
+*                       FSBL_DEFERRED
+*                       Seal the boot timeline before the JTAG boot mode
+*                       handoff too
+*                       NOR boot mode only with FSBL_NOR_BOOT, set unless
+*                       a footprint profile leaves NOR out
+*                       Resume a suspend to RAM with FSBL_RESUME
+*                       Boot from the raw eMMC with FSBL_EMMC_RAW
 *
 * </pre>
 *
@@ -111,13 +147,30 @@
 #include "nand.h"
 #include "nor.h"
 #include "sd.h"
+#include "emmc.h"
 #include "pcap.h"
 #include "image_mover.h"
 #include "xparameters.h"
 #include "xil_cache.h"
 #include "xil_exception.h"
 #include "xstatus.h"
+#include "xil_mem.h"
 #include "fsbl_hooks.h"
+#include "md5.h"
+#include "fsbl_timeline.h"
+#include "fsbl_image_index.h"
+#ifdef FSBL_EARLY_FLASH
+#include "ps7_init.h"
+#endif
+#ifdef FSBL_PS7_PACK
+#include "ps7_pack.h"
+#endif
+#include "fsbl_ddr_test.h"
+#include "fsbl_warm.h"
+#include "fsbl_deferred.h"
+#include "fsbl_bootdev.h"
+#include "fsbl_panic.h"
+#include "fsbl_resume.h"
 #ifndef SDT
 #include "xtime_l.h"
 #else
@@ -152,6 +205,12 @@
 	#define WDT_CRV_SHIFT		12
 #endif
 
+#ifdef STDOUT_BASEADDRESS
+#ifdef XPAR_XUARTPS_0_BASEADDR
+	#define STDOUT_LOG_SIZE		2048
+#endif
+#endif
+
 /**************************** Type Definitions *******************************/
 
 /***************** Macros (Inline Functions) Definitions *********************/
@@ -159,6 +218,13 @@
 #ifdef XPAR_XWDTPS_0_BASEADDR
 XWdtPs Watchdog;		/* Instance of WatchDog Timer	*/
 #endif
+
+#ifdef STDOUT_BASEADDRESS
+#ifdef XPAR_XUARTPS_0_BASEADDR
+/* Log ring of the buffered fsbl_printf output */
+static u8 StdoutLogBuffer[STDOUT_LOG_SIZE];
+#endif
+#endif
 /************************** Function Prototypes ******************************/
 extern int ps7_init();
 extern char* getPS7MessageInfo(unsigned key);
@@ -184,8 +250,17 @@ void  CheckWDTReset(void);
 #endif
 
 u32 NextValidImageCheck(void);
+#ifdef FSBL_IMAGE_INDEX
+static u32 ImageIndexCheck(u32 ImageBaseAddr, u32 BootDevMaxSize,
+		u32 *MultiBootReg);
+#endif
 
 u32 DDRInitCheck(void);
+static void DDRCheck(void);
+#ifdef FSBL_EARLY_FLASH
+static void DDRDeferInitPoll(unsigned long *DdrInitData);
+static u32 DDRInitWait(void);
+#endif
 
 /************************** Variable Definitions *****************************/
 /*
@@ -212,6 +287,12 @@ extern u8 BitstreamFlag;
 #if defined(XPAR_PS7_QSPI_LINEAR_0_S_AXI_BASEADDR) || defined(XPAR_PS7_QSPI_LINEAR_0_BASEADDRESS)
 extern u32 QspiFlashSize;
 #endif
+#ifdef FSBL_EARLY_FLASH
+/* DDR tables of ps7_init, per silicon version */
+extern unsigned long ps7_ddr_init_data_1_0[];
+extern unsigned long ps7_ddr_init_data_2_0[];
+extern unsigned long ps7_ddr_init_data_3_0[];
+#endif
 /*****************************************************************************/
 /**
 *
@@ -233,10 +314,41 @@ int main(void)
 	u32 HandoffAddress = 0;
 	u32 Status = XST_SUCCESS;
 	u32 RegVal;
+
+#ifdef FSBL_TIMELINE
+	FsblTimelineInit();
+#endif
+#ifdef FSBL_WARM_BOOT
+	FsblWarmCheckReset();
+#endif
+#ifdef FSBL_DEFERRED
+	FsblDeferredInit();
+#endif
+#ifdef FSBL_EARLY_FLASH
+	/*
+	 * Let ps7_init return while the DDR controller initializes, the
+	 * boot device is set up from OCM in the meantime
+	 */
+#ifdef FSBL_PS7_PACK
+	Ps7Pack_DeferPoll(ps7_ddr_init_data_1_0_pack, DDRC_MODE_STS_REG);
+	Ps7Pack_DeferPoll(ps7_ddr_init_data_2_0_pack, DDRC_MODE_STS_REG);
+	Ps7Pack_DeferPoll(ps7_ddr_init_data_3_0_pack, DDRC_MODE_STS_REG);
+#else
+	DDRDeferInitPoll(ps7_ddr_init_data_1_0);
+	DDRDeferInitPoll(ps7_ddr_init_data_2_0);
+	DDRDeferInitPoll(ps7_ddr_init_data_3_0);
+#endif
+#endif
+
+	FSBL_TIMELINE_BEGIN(FSBL_STAGE_PS7_INIT, 0);
 	/*
 	 * PCW initialization for MIO,PLL,CLK and DDR
 	 */
+#ifdef FSBL_PS7_PACK
+	Status = Ps7Pack_Init();
+#else
 	Status = ps7_init();
+#endif
 	if (Status != FSBL_PS7_INIT_SUCCESS) {
 		fsbl_printf(DEBUG_GENERAL,"PS7_INIT_FAIL : %s\r\n",
 						getPS7MessageInfo(Status));
@@ -247,6 +359,17 @@ int main(void)
 		 */
 		FsblHookFallback();
 	}
+	FSBL_TIMELINE_END(FSBL_STAGE_PS7_INIT, 0);
+
+#ifdef STDOUT_BASEADDRESS
+#ifdef XPAR_XUARTPS_0_BASEADDR
+	/*
+	 * Buffer the debug output so that it does not hold up the boot,
+	 * OutputStatus flushes it on the way out
+	 */
+	XUartPs_StdoutSetBuffer(StdoutLogBuffer, STDOUT_LOG_SIZE);
+#endif
+#endif
 
 	/*
 	 * Unlock SLCR for SLCR register write
@@ -269,10 +392,18 @@ int main(void)
 	 */
 	Xil_DCacheFlush();
 
+#ifdef FSBL_DCACHE
+	/*
+	 * Run with the L1 and L2 data caches, the transfer buffers of the
+	 * PCAP and the DMA are flushed and invalidated around each transfer
+	 */
+	Xil_DCacheEnable();
+#else
 	/*
 	 * Disable Data Cache
 	 */
 	Xil_DCacheDisable();
+#endif
 
 	/*
 	 * Register the Exception handlers
@@ -289,25 +420,33 @@ int main(void)
 
 #if defined(XPAR_PS7_DDR_0_S_AXI_BASEADDR) || defined(XPAR_PS7_DDR_0_BASEADDRESS)
 
+#ifdef FSBL_RESUME
+	/*
+	 * Resume a suspend to RAM before the DDR check writes to the DDR,
+	 * or go on as a cold boot
+	 */
+	if (FsblResumeRequested() != 0) {
+#ifdef FSBL_EARLY_FLASH
+		if (DDRInitWait() == XST_SUCCESS)
+#endif
+		{
+			FsblResume();
+		}
+	}
+#endif
+
+#ifndef FSBL_EARLY_FLASH
     /*
      * DDR Read/write test 
      */
-	Status = DDRInitCheck();
-	if (Status == XST_FAILURE) {
-		fsbl_printf(DEBUG_GENERAL,"DDR_INIT_FAIL \r\n");
-		/* Error Handling here */
-		OutputStatus(DDR_INIT_FAIL);
-		/*
-		 * Calling FsblHookFallback instead of Fallback
-		 * since, devcfg driver is not yet initialized
-		 */
-		FsblHookFallback();
-	}
+	DDRCheck();
+#endif
 
 
 	/*
 	 * PCAP initialization
 	 */
+	FSBL_TIMELINE_BEGIN(FSBL_STAGE_PCAP_INIT, 0);
 	Status = InitPcap();
 	if (Status == XST_FAILURE) {
 		fsbl_printf(DEBUG_GENERAL,"PCAP_INIT_FAIL \n\r");
@@ -318,6 +457,7 @@ int main(void)
 		 */
 		FsblHookFallback();
 	}
+	FSBL_TIMELINE_END(FSBL_STAGE_PCAP_INIT, 0);
 
 	fsbl_printf(DEBUG_INFO,"Devcfg driver initialized \r\n");
 
@@ -376,6 +516,8 @@ int main(void)
 	BootModeRegister = Xil_In32(BOOT_MODE_REG);
 	BootModeRegister &= BOOT_MODES_MASK;
 
+	FSBL_TIMELINE_BEGIN(FSBL_STAGE_FLASH_INIT, BootModeRegister);
+
 	/*
 	 * QSPI BOOT MODE
 	 */
@@ -394,7 +536,7 @@ int main(void)
 	if (BootModeRegister == QSPI_MODE) {
 		fsbl_printf(DEBUG_GENERAL,"Boot mode is QSPI\n\r");
 		InitQspi();
-		MoveImage = QspiAccess;
+		FsblBootDevSelect(BootModeRegister);
 		fsbl_printf(DEBUG_INFO,"QSPI Init Done \r\n");
 	} else
 #endif
@@ -420,11 +562,12 @@ int main(void)
 			OutputStatus(NAND_INIT_FAIL);
 			FsblFallback();
 		}
-		MoveImage = NandAccess;
+		FsblBootDevSelect(BootModeRegister);
 		fsbl_printf(DEBUG_INFO,"NAND Init Done \r\n");
 	} else
 #endif
 
+#ifdef FSBL_NOR_BOOT
 	/*
 	 * NOR BOOT MODE
 	 */
@@ -437,8 +580,9 @@ int main(void)
 		 */
 		InitNor();
 		fsbl_printf(DEBUG_INFO,"NOR Init Done \r\n");
-		MoveImage = NorAccess;
+		FsblBootDevSelect(BootModeRegister);
 	} else
+#endif
 
 	/*
 	 * SD BOOT MODE
@@ -457,23 +601,30 @@ int main(void)
 			OutputStatus(SD_INIT_FAIL);
 			FsblFallback();
 		}
-		MoveImage = SDAccess;
+		FsblBootDevSelect(BootModeRegister);
 		fsbl_printf(DEBUG_INFO,"SD Init Done \r\n");
 	} else
 
 	if (BootModeRegister == MMC_MODE) {
 		fsbl_printf(DEBUG_GENERAL,"Booting Device is MMC\r\n");
 
+#ifdef FSBL_EMMC_RAW
+		/*
+		 * Raw eMMC, the boot image read by block address
+		 */
+		Status = InitEmmc();
+#else
 		/*
 		 * MMC initialization returns file open error or success
 		 */
 		Status = InitSD("BOOT.BIN");
+#endif
 		if (Status != XST_SUCCESS) {
 			fsbl_printf(DEBUG_GENERAL,"MMC_INIT_FAIL\r\n");
 			OutputStatus(SD_INIT_FAIL);
 			FsblFallback();
 		}
-		MoveImage = SDAccess;
+		FsblBootDevSelect(BootModeRegister);
 		fsbl_printf(DEBUG_INFO,"MMC Init Done \r\n");
 	} else
 
@@ -490,7 +641,11 @@ int main(void)
 		if(RegVal & XDCFG_IXR_PCFG_DONE_MASK)
 		{
 #ifdef PS7_POST_CONFIG
+#ifdef FSBL_PS7_PACK
+		Ps7Pack_PostConfig();
+#else
 		ps7_post_config();
+#endif
 		/*
 		 * Unlock SLCR for SLCR register write
 		 */
@@ -508,11 +663,29 @@ int main(void)
 		 */
 		ClearFSBLIn();
 
+#ifdef FSBL_TIMELINE
+		/*
+		 * Seal the boot timeline, the JTAG boot mode has no boot
+		 * device to read
+		 */
+		FSBL_TIMELINE_END(FSBL_STAGE_FLASH_INIT, BootModeRegister);
+		FsblTimelineClose();
+#endif
+
 		/*
 		 * SLCR lock
 		 */
 		SlcrLock();
 
+#ifdef STDOUT_BASEADDRESS
+#ifdef XPAR_XUARTPS_0_BASEADDR
+		XUartPs_StdoutFlush();
+#endif
+#endif
+#ifdef FSBL_DCACHE
+		Xil_DCacheFlush();
+		Xil_DCacheDisable();
+#endif
 		FsblHandoffJtagExit();
 	} else {
 		fsbl_printf(DEBUG_GENERAL,"ILLEGAL_BOOT_MODE \r\n");
@@ -536,6 +709,7 @@ int main(void)
 		OutputStatus(INVALID_FLASH_ADDRESS);
 		FsblFallback();
 	}
+	FSBL_TIMELINE_END(FSBL_STAGE_FLASH_INIT, BootModeRegister);
 
 	/*
 	 * NOR and QSPI (parallel) are linear boot devices
@@ -558,6 +732,13 @@ int main(void)
 	 */
 	SystemInitFlag = 1;
 
+#ifdef FSBL_EARLY_FLASH
+	/*
+	 * Wait for the DDR before the first partition is moved to it
+	 */
+	DDRCheck();
+#endif
+
 	/*
 	 * Load boot image
 	 */
@@ -574,6 +755,16 @@ int main(void)
 	FsblMeasurePerfTime(tCur,tEnd);
 #endif
 
+#if defined(FSBL_EMMC_RAW) && (defined(XPAR_PS7_SD_0_S_AXI_BASEADDR) || \
+	defined(XPAR_XSDPS_0_BASEADDR))
+	/*
+	 * Leave the eMMC on its user area for the application
+	 */
+	if (BootModeRegister == MMC_MODE) {
+		ReleaseEmmc();
+	}
+#endif
+
 	/*
 	 * FSBL handoff to valid handoff address or
 	 * exit in JTAG
@@ -723,6 +914,8 @@ void FsblHandoff(u32 FsblStartAddr)
 {
 	u32 Status;
 
+	FSBL_TIMELINE_BEGIN(FSBL_STAGE_HANDOFF, FsblStartAddr);
+
 	/*
 	 * Enable level shifter
 	 */
@@ -736,7 +929,11 @@ void FsblHandoff(u32 FsblStartAddr)
 		 */
 #ifndef NON_PS_INSTANTIATED_BITSTREAM
 #ifdef PS7_POST_CONFIG
+#ifdef FSBL_PS7_PACK
+		Ps7Pack_PostConfig();
+#else
 		ps7_post_config();
+#endif
 		/*
 		 * Unlock SLCR for SLCR register write
 		 */
@@ -772,6 +969,11 @@ void FsblHandoff(u32 FsblStartAddr)
 		FsblFallback();
 	}
 
+	/*
+	 * Leave the devcfg interrupt masked for the application
+	 */
+	PcapShutdownIntr();
+
 #ifdef XPAR_XWDTPS_0_BASEADDR
 	XWdtPs_Stop(&Watchdog);
 #endif
@@ -781,6 +983,31 @@ void FsblHandoff(u32 FsblStartAddr)
 	 */
 	ClearFSBLIn();
 
+#ifdef FSBL_TIMELINE
+	/*
+	 * Seal the boot timeline for the application
+	 */
+	FsblTimelineClose();
+#endif
+
+#ifdef FSBL_DCACHE
+#ifdef FSBL_HANDOFF_CACHED
+	/*
+	 * The application starts with the caches enabled, they are cleaned
+	 * by FsblHandoffCachedExit()
+	 */
+	if (FsblStartAddr == 0)
+#endif
+	{
+		/*
+		 * Write the partitions out of the data cache, the application
+		 * starts with it disabled
+		 */
+		Xil_DCacheFlush();
+		Xil_DCacheDisable();
+	}
+#endif
+
 	if(FsblStartAddr == 0) {
 		/*
 		 * SLCR lock
@@ -788,11 +1015,20 @@ void FsblHandoff(u32 FsblStartAddr)
 		SlcrLock();
 
 		fsbl_printf(DEBUG_INFO,"No Execution Address JTAG handoff \r\n");
+#ifdef STDOUT_BASEADDRESS
+#ifdef XPAR_XUARTPS_0_BASEADDR
+		XUartPs_StdoutFlush();
+#endif
+#endif
 		FsblHandoffJtagExit();
 	} else {
 		fsbl_printf(DEBUG_GENERAL,"SUCCESSFUL_HANDOFF\r\n");
 		OutputStatus(SUCCESSFUL_HANDOFF);
+#if defined(FSBL_DCACHE) && defined(FSBL_HANDOFF_CACHED)
+		FsblHandoffCachedExit(FsblStartAddr);
+#else
 		FsblHandoffExit(FsblStartAddr);
+#endif
 	}
 
 	OutputStatus(ILLEGAL_RETURN);
@@ -826,6 +1062,7 @@ void OutputStatus(u32 State)
 	 * serial output
 	 */
 #ifdef XPAR_XUARTPS_0_BASEADDR
+	XUartPs_StdoutFlush();
 	UartReg = Xil_In32(STDOUT_BASEADDRESS + XUARTPS_SR_OFFSET);
 	while ((UartReg & XUARTPS_SR_TXEMPTY) != XUARTPS_SR_TXEMPTY) {
 		UartReg = Xil_In32(STDOUT_BASEADDRESS + XUARTPS_SR_OFFSET);
@@ -856,6 +1093,13 @@ void ErrorLockdown(u32 State)
 	 */
 	OutputStatus(State);
 
+#ifdef FSBL_PANIC
+	/*
+	 * Keep what led to it for post-mortem
+	 */
+	FsblPanicDump(State);
+#endif
+
 	/*
 	 * Fall back
 	 */
@@ -876,14 +1120,10 @@ void ErrorLockdown(u32 State)
 ****************************************************************************/
 void *(memcpy_rom)(void * s1, const void * s2, u32 n)
 {
-	char *dst = (char *)s1;
-	const char *src = (char *)s2;
-
 	/*
-	 * Loop and copy
+	 * Burst copy, NEON on the Cortex-A9 (xil_memcpy.S)
 	 */
-	while (n-- != 0)
-		*dst++ = *src++;
+	Xil_MemCpy(s1, s2, n);
 	return s1;
 }
 /******************************************************************************/
@@ -1339,26 +1579,25 @@ void GetSiliconVersion(void)
 *******************************************************************************/
 u32 HeaderChecksum(u32 FlashOffsetAddress){
 	u32 Checksum = 0;
-	u32 Count;
+	u32 Header[IMAGE_HEADER_CHECKSUM_COUNT];
 	u32 TempValue = 0;
 
-	for (Count = 0; Count < IMAGE_HEADER_CHECKSUM_COUNT; Count++) {
-		/*
-		 * Read the word from the header
-		 */
-		MoveImage(FlashOffsetAddress + IMAGE_WIDTH_CHECK_OFFSET + (Count*4), (u32)&TempValue, 4);
+	/*
+	 * Read the checksummed words of the header in one move
+	 */
+	ImageHeaderRead(FlashOffsetAddress + IMAGE_WIDTH_CHECK_OFFSET, (u32)Header,
+			sizeof(Header));
 
-		/*
-		 * Update checksum
-		 */
-		Checksum += TempValue;
-	}
+	/*
+	 * Sum the words
+	 */
+	Checksum = Xil_MemSum32(Header, IMAGE_HEADER_CHECKSUM_COUNT);
 
 	/*
 	 * Invert checksum, last bit of error checking
 	 */
 	Checksum ^= 0xFFFFFFFF;
-	MoveImage(FlashOffsetAddress + IMAGE_CHECKSUM_OFFSET, (u32)&TempValue, 4);
+	ImageHeaderRead(FlashOffsetAddress + IMAGE_CHECKSUM_OFFSET, (u32)&TempValue, 4);
 
 	/*
 	 * Validate the checksum
@@ -1391,7 +1630,7 @@ u32 ImageCheckID(u32 FlashOffsetAddress){
 	/*
 	 * Read in the header info
 	 */
-	MoveImage(FlashOffsetAddress + IMAGE_IDENT_OFFSET, (u32)&ID, 4);
+	ImageHeaderRead(FlashOffsetAddress + IMAGE_IDENT_OFFSET, (u32)&ID, 4);
 
 	/*
 	 * Check the ID, make sure image is XLNX format
@@ -1453,6 +1692,20 @@ u32 NextValidImageCheck(void)
 	 */
 	ImageBaseAddr = (MultiBootReg & PCAP_MBOOT_REG_REBOOT_OFFSET_MASK)
 								* GOLDEN_IMAGE_OFFSET;
+
+#ifdef FSBL_IMAGE_INDEX
+	/*
+	 * Images listed in the image index first
+	 */
+	if (ImageIndexCheck(ImageBaseAddr, BootDevMaxSize,
+			&MultiBootReg) == XST_SUCCESS) {
+		XDcfg_WriteReg(DcfgInstPtr->Config.BaseAddr,
+				XDCFG_MULTIBOOT_ADDR_OFFSET,
+				MultiBootReg);
+
+		return XST_SUCCESS;
+	}
+#endif
 	
 	/*
 	 * Valid image search continue till end of the flash
@@ -1462,6 +1715,25 @@ u32 NextValidImageCheck(void)
 
 		fsbl_printf(DEBUG_INFO,".");
 
+		/*
+		 * The ID of linear boot devices is read from the memory
+		 * window, the other checks only run when it matches
+		 */
+		if ((LinearBootDeviceFlag == 1) &&
+				(Xil_In32(FlashReadBaseAddress + ImageBaseAddr +
+					IMAGE_IDENT_OFFSET) != IMAGE_IDENT)) {
+			MultiBootReg++;
+			ImageBaseAddr = (MultiBootReg &
+					PCAP_MBOOT_REG_REBOOT_OFFSET_MASK) *
+					GOLDEN_IMAGE_OFFSET;
+			continue;
+		}
+
+		/*
+		 * One move for the checks below
+		 */
+		(void)ImageHeaderCacheLoad(ImageBaseAddr, IMAGE_HEADER_SEARCH_SIZE);
+
 		/*
 		 * Valid image search using XLNX pattern at fixed offset
 		 * and header checksum
@@ -1496,6 +1768,233 @@ u32 NextValidImageCheck(void)
 	return XST_FAILURE;
 }
 
+#ifdef FSBL_IMAGE_INDEX
+/******************************************************************************
+*
+* This function looks for the next valid boot image in the image index, see
+* fsbl_image_index.h
+*
+* @param	ImageBaseAddr is the offset the search starts from
+* @param	BootDevMaxSize is the size of the boot device
+* @param	MultiBootReg is the multiboot register value, updated to the
+*		image found
+*
+* @return
+*		- XST_SUCCESS if a valid image is found
+*		- XST_FAILURE if the index is missing or lists no valid image
+*
+* @note		None
+*
+*******************************************************************************/
+static u32 ImageIndexCheck(u32 ImageBaseAddr, u32 BootDevMaxSize,
+		u32 *MultiBootReg)
+{
+	FsblImageIndex Index;
+	u32 IndexOffset;
+	u32 Checksum;
+	u32 Candidate;
+	u32 Tried = 0;
+	u32 Count;
+	u32 Entry;
+	u32 Status;
+
+#ifdef FSBL_IMAGE_INDEX_OFFSET
+	IndexOffset = FSBL_IMAGE_INDEX_OFFSET;
+#else
+	if (BootDevMaxSize < FSBL_IMAGE_INDEX_SECTOR_SIZE) {
+		return XST_FAILURE;
+	}
+	IndexOffset = BootDevMaxSize - FSBL_IMAGE_INDEX_SECTOR_SIZE;
+#endif
+
+	Status = MoveImage(IndexOffset, (u32)&Index, sizeof(Index));
+	if ((Status != XST_SUCCESS) || (Index.Magic != FSBL_IMAGE_INDEX_MAGIC) ||
+			(Index.Count > FSBL_IMAGE_INDEX_MAX_IMAGES)) {
+		return XST_FAILURE;
+	}
+
+	Checksum = Xil_MemSum32((u32 *)&Index, (sizeof(Index) / 4) - 1);
+	Checksum ^= 0xFFFFFFFF;
+	if (Checksum != Index.Checksum) {
+		fsbl_printf(DEBUG_INFO, "\r\nImage index checksum failed\r\n");
+		return XST_FAILURE;
+	}
+
+	/*
+	 * Candidates in the order of their offsets, Tried is the offset past
+	 * the last one checked
+	 */
+	for (Count = 0; Count < Index.Count; Count++) {
+		Candidate = 0xFFFFFFFF;
+		for (Entry = 0; Entry < Index.Count; Entry++) {
+			if ((Index.Offset[Entry] >= ImageBaseAddr) &&
+					(Index.Offset[Entry] >= Tried) &&
+					(Index.Offset[Entry] < Candidate) &&
+					(Index.Offset[Entry] < BootDevMaxSize) &&
+					((Index.Offset[Entry] % GOLDEN_IMAGE_OFFSET) == 0)) {
+				Candidate = Index.Offset[Entry];
+			}
+		}
+
+		if (Candidate == 0xFFFFFFFF) {
+			break;
+		}
+		Tried = Candidate + GOLDEN_IMAGE_OFFSET;
+
+		(void)ImageHeaderCacheLoad(Candidate, IMAGE_HEADER_SEARCH_SIZE);
+		if ((ImageCheckID(Candidate) == XST_SUCCESS) &&
+				(HeaderChecksum(Candidate) == XST_SUCCESS)) {
+			fsbl_printf(DEBUG_GENERAL, "\r\nImage found in the index, "
+					"offset: 0x%.8lx\r\n", Candidate);
+			*MultiBootReg = (*MultiBootReg &
+					~PCAP_MBOOT_REG_REBOOT_OFFSET_MASK) |
+					(Candidate / GOLDEN_IMAGE_OFFSET);
+			return XST_SUCCESS;
+		}
+	}
+
+	fsbl_printf(DEBUG_INFO, "\r\nNo valid image in the index\r\n");
+
+	return XST_FAILURE;
+}
+#endif
+
+/******************************************************************************/
+/**
+*
+* This function runs the DDR read/write test, and falls back if the DDR
+* does not work. With FSBL_EARLY_FLASH it first waits for the end of the
+* DDR controller initialization that ps7_init did not wait for.
+*
+* @param	None.
+*
+* @return	None.
+*
+* @note		The devcfg driver may not be initialized, so the fallback goes
+*		through FsblHookFallback.
+*
+****************************************************************************/
+static void DDRCheck(void)
+{
+	u32 Status;
+
+	FSBL_TIMELINE_BEGIN(FSBL_STAGE_DDR_INIT_CHECK, 0);
+#ifdef FSBL_EARLY_FLASH
+	Status = DDRInitWait();
+	if (Status == XST_FAILURE) {
+		fsbl_printf(DEBUG_GENERAL,"DDR_INIT_FAIL : timeout\r\n");
+		OutputStatus(DDR_INIT_FAIL);
+		FsblHookFallback();
+	}
+#endif
+	Status = DDRInitCheck();
+	if (Status == XST_FAILURE) {
+		fsbl_printf(DEBUG_GENERAL,"DDR_INIT_FAIL \r\n");
+		/* Error Handling here */
+		OutputStatus(DDR_INIT_FAIL);
+		/*
+		 * Calling FsblHookFallback instead of Fallback
+		 * since, devcfg driver is not yet initialized
+		 */
+		FsblHookFallback();
+	}
+#if defined(FSBL_DDR_TEST) && defined(FSBL_WARM_BOOT)
+	/*
+	 * The DDR of a warm boot is kept for the partitions it may still
+	 * hold
+	 */
+	if (FsblWarmIsReset() == 0) {
+		Status = FsblDdrTest();
+	}
+#elif defined(FSBL_DDR_TEST)
+	Status = FsblDdrTest();
+#endif
+#ifdef FSBL_DDR_TEST
+	if (Status == XST_FAILURE) {
+		OutputStatus(DDR_INIT_FAIL);
+		FsblHookFallback();
+	}
+#endif
+	FSBL_TIMELINE_END(FSBL_STAGE_DDR_INIT_CHECK, 0);
+
+#ifdef FSBL_MD5_BENCH
+	/*
+	 * Time the partition checksum on a DDR buffer
+	 */
+	MD5Benchmark((u8 *)DDR_TEMP_START_ADDR, MD5_BENCH_LENGTH);
+#endif
+}
+
+#ifdef FSBL_EARLY_FLASH
+/******************************************************************************/
+/**
+*
+* This function ends a DDR table of ps7_init before its last poll, on the
+* operating mode of the DDR controller, so that ps7_init returns once the
+* DDR controller is out of reset and the controller initializes the DRAM
+* while FSBL goes on. The table is left as it is if it does not end with
+* that poll.
+*
+* @param	DdrInitData is the DDR table to change
+*
+* @return	None.
+*
+* @note		The tables are data in OCM, a reset reloads them.
+*
+****************************************************************************/
+static void DDRDeferInitPoll(unsigned long *DdrInitData)
+{
+	unsigned long *Ptr = DdrInitData;
+	unsigned long *LastPoll = NULL;
+	unsigned long Opcode;
+
+	while ((Opcode = (Ptr[0] >> 4)) != OPCODE_EXIT) {
+		if (Opcode > OPCODE_MASKDELAY) {
+			return;
+		}
+		if ((Opcode == OPCODE_MASKPOLL) &&
+				(Ptr[1] == DDRC_MODE_STS_REG)) {
+			LastPoll = Ptr;
+		} else {
+			LastPoll = NULL;
+		}
+		Ptr += (Ptr[0] & 0xF) + 1;
+	}
+
+	if (LastPoll != NULL) {
+		LastPoll[0] = EMIT_EXIT();
+	}
+}
+
+/******************************************************************************/
+/**
+*
+* This function waits for the DDR controller to reach its normal operating
+* mode, the poll that DDRDeferInitPoll() took out of ps7_init.
+*
+* @param	None.
+*
+* @return
+*		- XST_SUCCESS if the DDR controller is up
+*		- XST_FAILURE if it is not within DDR_INIT_POLL_COUNT reads
+*
+* @note		None.
+*
+****************************************************************************/
+static u32 DDRInitWait(void)
+{
+	u32 Count;
+
+	for (Count = 0; Count < DDR_INIT_POLL_COUNT; Count++) {
+		if (Xil_In32(DDRC_MODE_STS_REG) & DDRC_MODE_STS_MASK) {
+			return XST_SUCCESS;
+		}
+	}
+
+	return XST_FAILURE;
+}
+#endif
+
 /******************************************************************************/
 /**
 *
@@ -1513,6 +2012,16 @@ u32 NextValidImageCheck(void)
 u32 DDRInitCheck(void)
 {
 	u32 ReadVal;
+#ifdef FSBL_WARM_BOOT
+	/*
+	 * The tested words may belong to a partition kept from the
+	 * previous boot
+	 */
+	u32 SavedVal[2];
+
+	SavedVal[0] = Xil_In32(DDR_START_ADDR);
+	SavedVal[1] = Xil_In32(DDR_START_ADDR + DDR_TEST_OFFSET);
+#endif
 
 	/*
 	 * Write and Read from the DDR location for sanity checks
@@ -1532,5 +2041,10 @@ u32 DDRInitCheck(void)
 		return XST_FAILURE;
 	}
 
+#ifdef FSBL_WARM_BOOT
+	Xil_Out32(DDR_START_ADDR, SavedVal[0]);
+	Xil_Out32(DDR_START_ADDR + DDR_TEST_OFFSET, SavedVal[1]);
+#endif
+
 	return XST_SUCCESS;
 }
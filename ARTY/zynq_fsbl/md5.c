@@ -67,6 +67,11 @@
 * Ver	Who	Date		Changes
 * ----- ---- -------- -------------------------------------------------------
 * 5.00a sgd	05/17/13 Initial release
+* 21.5  qm	10/14/26 MD5Memset and MD5Memcpy use Xil_MemSet and Xil_MemCpy
+*       qm	10/14/26 MD5Update transforms aligned input in place and swaps
+*			 the bytes of the words as it loads them
+*			 Added MD5Benchmark() of FSBL_MD5_BENCH
+*       qm	10/14/26 MD5Benchmark() also times md5x4() on four quarters
 *
 *
 * </pre>
@@ -77,6 +82,28 @@
 /****************************** Include Files *********************************/
 
 #include "md5.h"
+#include "xil_mem.h"
+#ifdef FSBL_MD5_BENCH
+#include "fsbl.h"
+#ifndef SDT
+#include "xtime_l.h"
+#else
+#include "xiltimer.h"
+#endif
+#endif
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Word i of the block being transformed, byte swapped when asked for. The
+ * swap is a single REV on ARMv7.
+ */
+#define MD5_IN( i ) \
+	( doByteSwap ? __builtin_bswap32( in[ i ] ) : in[ i ] )
+
+/************************** Function Prototypes ******************************/
+
+static void MD5TransformSwap( u32 *buffer, const u32 *in );
 
 /******************************************************************************/
 /**
@@ -96,10 +123,7 @@
 ****************************************************************************/
 inline void * MD5Memset( void *dest, int	ch, u32	count )
 {
-	register char *dst8 = (char*)dest;
-
-	while( count-- )
-		*dst8++ = ch;
+	Xil_MemSet( dest, (u8)ch, count );
 
 	return dest;
 }
@@ -127,8 +151,7 @@ inline void * MD5Memcpy( void *dest, const void *src,
 	register char * src8 = (char*)src;
 	
 	if( doByteSwap == FALSE ) {
-		while( count-- )
-			*dst8++ = *src8++;
+		Xil_MemCpy( dest, src, count );
 	} else {
 		count /= sizeof( u32 );
 		
@@ -154,6 +177,10 @@ inline void * MD5Memcpy( void *dest, const void *src,
 * reflect the addition of 16 longwords of new data. MD5Update blocks
 * the data and converts bytes into longwords for this routine.
 *
+* The rounds are fully unrolled. Only a, b, c and d live in registers, the
+* words of the block are loaded by each step that uses them, so that the
+* ARMv7 register file holds the state without spilling.
+*
 * Use binary integer part of the sine of integers (Radians) as constants.
 * Calculated as:
 *
@@ -162,18 +189,19 @@ inline void * MD5Memcpy( void *dest, const void *src,
 *
 * Following number is the per-round shift amount.
 *
-* @param	dest
+* @param	buffer is the MD5 state
 *
-* @param	ch
+* @param	in is the block, 16 words
 *
-* @param	count
+* @param	doByteSwap swaps the bytes of each word as it is loaded
 *
 * @return	None
 *
 * @note		None
 *
 ****************************************************************************/
-void MD5Transform( u32 *buffer, u32 *intermediate )
+static inline __attribute__((always_inline)) void MD5TransformBlock(
+		u32 *buffer, const u32 *in, const boolean doByteSwap )
 {
 	register u32 a, b, c, d;
 	
@@ -182,73 +210,73 @@ void MD5Transform( u32 *buffer, u32 *intermediate )
 	c = buffer[ 2 ];
 	d = buffer[ 3 ];
 
-	MD5_STEP( F1, a, b, c, d, intermediate[  0 ] + 0xd76aa478,  7 );
-	MD5_STEP( F1, d, a, b, c, intermediate[  1 ] + 0xe8c7b756, 12 );
-	MD5_STEP( F1, c, d, a, b, intermediate[  2 ] + 0x242070db, 17 );
-	MD5_STEP( F1, b, c, d, a, intermediate[  3 ] + 0xc1bdceee, 22 );
-	MD5_STEP( F1, a, b, c, d, intermediate[  4 ] + 0xf57c0faf,  7 );
-	MD5_STEP( F1, d, a, b, c, intermediate[  5 ] + 0x4787c62a, 12 );
-	MD5_STEP( F1, c, d, a, b, intermediate[  6 ] + 0xa8304613, 17 );
-	MD5_STEP( F1, b, c, d, a, intermediate[  7 ] + 0xfd469501, 22 );
-	MD5_STEP( F1, a, b, c, d, intermediate[  8 ] + 0x698098d8,  7 );
-	MD5_STEP( F1, d, a, b, c, intermediate[  9 ] + 0x8b44f7af, 12 );
-	MD5_STEP( F1, c, d, a, b, intermediate[ 10 ] + 0xffff5bb1, 17 );
-	MD5_STEP( F1, b, c, d, a, intermediate[ 11 ] + 0x895cd7be, 22 );
-	MD5_STEP( F1, a, b, c, d, intermediate[ 12 ] + 0x6b901122,  7 );
-	MD5_STEP( F1, d, a, b, c, intermediate[ 13 ] + 0xfd987193, 12 );
-	MD5_STEP( F1, c, d, a, b, intermediate[ 14 ] + 0xa679438e, 17 );
-	MD5_STEP( F1, b, c, d, a, intermediate[ 15 ] + 0x49b40821, 22 );
+	MD5_STEP( F1, a, b, c, d, MD5_IN( 0 ) + 0xd76aa478,  7 );
+	MD5_STEP( F1, d, a, b, c, MD5_IN( 1 ) + 0xe8c7b756, 12 );
+	MD5_STEP( F1, c, d, a, b, MD5_IN( 2 ) + 0x242070db, 17 );
+	MD5_STEP( F1, b, c, d, a, MD5_IN( 3 ) + 0xc1bdceee, 22 );
+	MD5_STEP( F1, a, b, c, d, MD5_IN( 4 ) + 0xf57c0faf,  7 );
+	MD5_STEP( F1, d, a, b, c, MD5_IN( 5 ) + 0x4787c62a, 12 );
+	MD5_STEP( F1, c, d, a, b, MD5_IN( 6 ) + 0xa8304613, 17 );
+	MD5_STEP( F1, b, c, d, a, MD5_IN( 7 ) + 0xfd469501, 22 );
+	MD5_STEP( F1, a, b, c, d, MD5_IN( 8 ) + 0x698098d8,  7 );
+	MD5_STEP( F1, d, a, b, c, MD5_IN( 9 ) + 0x8b44f7af, 12 );
+	MD5_STEP( F1, c, d, a, b, MD5_IN( 10 ) + 0xffff5bb1, 17 );
+	MD5_STEP( F1, b, c, d, a, MD5_IN( 11 ) + 0x895cd7be, 22 );
+	MD5_STEP( F1, a, b, c, d, MD5_IN( 12 ) + 0x6b901122,  7 );
+	MD5_STEP( F1, d, a, b, c, MD5_IN( 13 ) + 0xfd987193, 12 );
+	MD5_STEP( F1, c, d, a, b, MD5_IN( 14 ) + 0xa679438e, 17 );
+	MD5_STEP( F1, b, c, d, a, MD5_IN( 15 ) + 0x49b40821, 22 );
 	
-	MD5_STEP( F2, a, b, c, d, intermediate[  1 ] + 0xf61e2562,  5 );
-	MD5_STEP( F2, d, a, b, c, intermediate[  6 ] + 0xc040b340,  9 );
-	MD5_STEP( F2, c, d, a, b, intermediate[ 11 ] + 0x265e5a51, 14 );
-	MD5_STEP( F2, b, c, d, a, intermediate[  0 ] + 0xe9b6c7aa, 20 );
-	MD5_STEP( F2, a, b, c, d, intermediate[  5 ] + 0xd62f105d,  5 );
-	MD5_STEP( F2, d, a, b, c, intermediate[ 10 ] + 0x02441453,  9 );
-	MD5_STEP( F2, c, d, a, b, intermediate[ 15 ] + 0xd8a1e681, 14 );
-	MD5_STEP( F2, b, c, d, a, intermediate[  4 ] + 0xe7d3fbc8, 20 );
-	MD5_STEP( F2, a, b, c, d, intermediate[  9 ] + 0x21e1cde6,  5 );
-	MD5_STEP( F2, d, a, b, c, intermediate[ 14 ] + 0xc33707d6,  9 );
-	MD5_STEP( F2, c, d, a, b, intermediate[  3 ] + 0xf4d50d87, 14 );
-	MD5_STEP( F2, b, c, d, a, intermediate[  8 ] + 0x455a14ed, 20 );
-	MD5_STEP( F2, a, b, c, d, intermediate[ 13 ] + 0xa9e3e905,  5 );
-	MD5_STEP( F2, d, a, b, c, intermediate[  2 ] + 0xfcefa3f8,  9 );
-	MD5_STEP( F2, c, d, a, b, intermediate[  7 ] + 0x676f02d9, 14 );
-	MD5_STEP( F2, b, c, d, a, intermediate[ 12 ] + 0x8d2a4c8a, 20 );
+	MD5_STEP( F2, a, b, c, d, MD5_IN( 1 ) + 0xf61e2562,  5 );
+	MD5_STEP( F2, d, a, b, c, MD5_IN( 6 ) + 0xc040b340,  9 );
+	MD5_STEP( F2, c, d, a, b, MD5_IN( 11 ) + 0x265e5a51, 14 );
+	MD5_STEP( F2, b, c, d, a, MD5_IN( 0 ) + 0xe9b6c7aa, 20 );
+	MD5_STEP( F2, a, b, c, d, MD5_IN( 5 ) + 0xd62f105d,  5 );
+	MD5_STEP( F2, d, a, b, c, MD5_IN( 10 ) + 0x02441453,  9 );
+	MD5_STEP( F2, c, d, a, b, MD5_IN( 15 ) + 0xd8a1e681, 14 );
+	MD5_STEP( F2, b, c, d, a, MD5_IN( 4 ) + 0xe7d3fbc8, 20 );
+	MD5_STEP( F2, a, b, c, d, MD5_IN( 9 ) + 0x21e1cde6,  5 );
+	MD5_STEP( F2, d, a, b, c, MD5_IN( 14 ) + 0xc33707d6,  9 );
+	MD5_STEP( F2, c, d, a, b, MD5_IN( 3 ) + 0xf4d50d87, 14 );
+	MD5_STEP( F2, b, c, d, a, MD5_IN( 8 ) + 0x455a14ed, 20 );
+	MD5_STEP( F2, a, b, c, d, MD5_IN( 13 ) + 0xa9e3e905,  5 );
+	MD5_STEP( F2, d, a, b, c, MD5_IN( 2 ) + 0xfcefa3f8,  9 );
+	MD5_STEP( F2, c, d, a, b, MD5_IN( 7 ) + 0x676f02d9, 14 );
+	MD5_STEP( F2, b, c, d, a, MD5_IN( 12 ) + 0x8d2a4c8a, 20 );
 	
-	MD5_STEP( F3, a, b, c, d, intermediate[  5 ] + 0xfffa3942,  4 );
-	MD5_STEP( F3, d, a, b, c, intermediate[  8 ] + 0x8771f681, 11 );
-	MD5_STEP( F3, c, d, a, b, intermediate[ 11 ] + 0x6d9d6122, 16 );
-	MD5_STEP( F3, b, c, d, a, intermediate[ 14 ] + 0xfde5380c, 23 );
-	MD5_STEP( F3, a, b, c, d, intermediate[  1 ] + 0xa4beea44,  4 );
-	MD5_STEP( F3, d, a, b, c, intermediate[  4 ] + 0x4bdecfa9, 11 );
-	MD5_STEP( F3, c, d, a, b, intermediate[  7 ] + 0xf6bb4b60, 16 );
-	MD5_STEP( F3, b, c, d, a, intermediate[ 10 ] + 0xbebfbc70, 23 );
-	MD5_STEP( F3, a, b, c, d, intermediate[ 13 ] + 0x289b7ec6,  4 );
-	MD5_STEP( F3, d, a, b, c, intermediate[  0 ] + 0xeaa127fa, 11 );
-	MD5_STEP( F3, c, d, a, b, intermediate[  3 ] + 0xd4ef3085, 16 );
-	MD5_STEP( F3, b, c, d, a, intermediate[  6 ] + 0x04881d05, 23 );
-	MD5_STEP( F3, a, b, c, d, intermediate[  9 ] + 0xd9d4d039,  4 );
-	MD5_STEP( F3, d, a, b, c, intermediate[ 12 ] + 0xe6db99e5, 11 );
-	MD5_STEP( F3, c, d, a, b, intermediate[ 15 ] + 0x1fa27cf8, 16 );
-	MD5_STEP( F3, b, c, d, a, intermediate[  2 ] + 0xc4ac5665, 23 );
+	MD5_STEP( F3, a, b, c, d, MD5_IN( 5 ) + 0xfffa3942,  4 );
+	MD5_STEP( F3, d, a, b, c, MD5_IN( 8 ) + 0x8771f681, 11 );
+	MD5_STEP( F3, c, d, a, b, MD5_IN( 11 ) + 0x6d9d6122, 16 );
+	MD5_STEP( F3, b, c, d, a, MD5_IN( 14 ) + 0xfde5380c, 23 );
+	MD5_STEP( F3, a, b, c, d, MD5_IN( 1 ) + 0xa4beea44,  4 );
+	MD5_STEP( F3, d, a, b, c, MD5_IN( 4 ) + 0x4bdecfa9, 11 );
+	MD5_STEP( F3, c, d, a, b, MD5_IN( 7 ) + 0xf6bb4b60, 16 );
+	MD5_STEP( F3, b, c, d, a, MD5_IN( 10 ) + 0xbebfbc70, 23 );
+	MD5_STEP( F3, a, b, c, d, MD5_IN( 13 ) + 0x289b7ec6,  4 );
+	MD5_STEP( F3, d, a, b, c, MD5_IN( 0 ) + 0xeaa127fa, 11 );
+	MD5_STEP( F3, c, d, a, b, MD5_IN( 3 ) + 0xd4ef3085, 16 );
+	MD5_STEP( F3, b, c, d, a, MD5_IN( 6 ) + 0x04881d05, 23 );
+	MD5_STEP( F3, a, b, c, d, MD5_IN( 9 ) + 0xd9d4d039,  4 );
+	MD5_STEP( F3, d, a, b, c, MD5_IN( 12 ) + 0xe6db99e5, 11 );
+	MD5_STEP( F3, c, d, a, b, MD5_IN( 15 ) + 0x1fa27cf8, 16 );
+	MD5_STEP( F3, b, c, d, a, MD5_IN( 2 ) + 0xc4ac5665, 23 );
 	
-	MD5_STEP( F4, a, b, c, d, intermediate[  0 ] + 0xf4292244,  6 );
-	MD5_STEP( F4, d, a, b, c, intermediate[  7 ] + 0x432aff97, 10 );
-	MD5_STEP( F4, c, d, a, b, intermediate[ 14 ] + 0xab9423a7, 15 );
-	MD5_STEP( F4, b, c, d, a, intermediate[  5 ] + 0xfc93a039, 21 );
-	MD5_STEP( F4, a, b, c, d, intermediate[ 12 ] + 0x655b59c3,  6 );
-	MD5_STEP( F4, d, a, b, c, intermediate[  3 ] + 0x8f0ccc92, 10 );
-	MD5_STEP( F4, c, d, a, b, intermediate[ 10 ] + 0xffeff47d, 15 );
-	MD5_STEP( F4, b, c, d, a, intermediate[  1 ] + 0x85845dd1, 21 );
-	MD5_STEP( F4, a, b, c, d, intermediate[  8 ] + 0x6fa87e4f,  6 );
-	MD5_STEP( F4, d, a, b, c, intermediate[ 15 ] + 0xfe2ce6e0, 10 );
-	MD5_STEP( F4, c, d, a, b, intermediate[  6 ] + 0xa3014314, 15 );
-	MD5_STEP( F4, b, c, d, a, intermediate[ 13 ] + 0x4e0811a1, 21 );
-	MD5_STEP( F4, a, b, c, d, intermediate[  4 ] + 0xf7537e82,  6 );
-	MD5_STEP( F4, d, a, b, c, intermediate[ 11 ] + 0xbd3af235, 10 );
-	MD5_STEP( F4, c, d, a, b, intermediate[  2 ] + 0x2ad7d2bb, 15 );
-	MD5_STEP( F4, b, c, d, a, intermediate[  9 ] + 0xeb86d391, 21 );
+	MD5_STEP( F4, a, b, c, d, MD5_IN( 0 ) + 0xf4292244,  6 );
+	MD5_STEP( F4, d, a, b, c, MD5_IN( 7 ) + 0x432aff97, 10 );
+	MD5_STEP( F4, c, d, a, b, MD5_IN( 14 ) + 0xab9423a7, 15 );
+	MD5_STEP( F4, b, c, d, a, MD5_IN( 5 ) + 0xfc93a039, 21 );
+	MD5_STEP( F4, a, b, c, d, MD5_IN( 12 ) + 0x655b59c3,  6 );
+	MD5_STEP( F4, d, a, b, c, MD5_IN( 3 ) + 0x8f0ccc92, 10 );
+	MD5_STEP( F4, c, d, a, b, MD5_IN( 10 ) + 0xffeff47d, 15 );
+	MD5_STEP( F4, b, c, d, a, MD5_IN( 1 ) + 0x85845dd1, 21 );
+	MD5_STEP( F4, a, b, c, d, MD5_IN( 8 ) + 0x6fa87e4f,  6 );
+	MD5_STEP( F4, d, a, b, c, MD5_IN( 15 ) + 0xfe2ce6e0, 10 );
+	MD5_STEP( F4, c, d, a, b, MD5_IN( 6 ) + 0xa3014314, 15 );
+	MD5_STEP( F4, b, c, d, a, MD5_IN( 13 ) + 0x4e0811a1, 21 );
+	MD5_STEP( F4, a, b, c, d, MD5_IN( 4 ) + 0xf7537e82,  6 );
+	MD5_STEP( F4, d, a, b, c, MD5_IN( 11 ) + 0xbd3af235, 10 );
+	MD5_STEP( F4, c, d, a, b, MD5_IN( 2 ) + 0x2ad7d2bb, 15 );
+	MD5_STEP( F4, b, c, d, a, MD5_IN( 9 ) + 0xeb86d391, 21 );
 
 	buffer[ 0 ] += a;
 	buffer[ 1 ] += b;
@@ -257,6 +285,44 @@ void MD5Transform( u32 *buffer, u32 *intermediate )
 	
 }
 
+/******************************************************************************/
+/**
+*
+* This function transforms one block held in the context
+*
+* @param	buffer is the MD5 state
+*
+* @param	intermediate is the block, 16 words
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+void MD5Transform( u32 *buffer, u32 *intermediate )
+{
+	MD5TransformBlock( buffer, intermediate, FALSE );
+}
+
+/******************************************************************************/
+/**
+*
+* This function transforms one block of words to byte swap
+*
+* @param	buffer is the MD5 state
+*
+* @param	in is the block, 16 words
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+static void MD5TransformSwap( u32 *buffer, const u32 *in )
+{
+	MD5TransformBlock( buffer, in, TRUE );
+}
+
 /******************************************************************************/
 /**
 *
@@ -354,9 +420,24 @@ inline void MD5Update( MD5Context *context, u8 *buffer,
 	}
 		
 	/*
-	 * Process data in 64-byte, 512 bit, chunks
+	 * Process data in 64-byte, 512 bit, chunks, in place when the words
+	 * are aligned
 	 */
 
+	if( ( (UINTPTR)buffer & ( sizeof( u32 ) - 1U ) ) == 0U ) {
+		while( len >= MD5_SIGNATURE_BYTE_SIZE ) {
+			if( doByteSwap == FALSE ) {
+				MD5Transform( context->buffer, (u32 *)buffer );
+			} else {
+				MD5TransformSwap( context->buffer,
+						  (const u32 *)buffer );
+			}
+
+			buffer += MD5_SIGNATURE_BYTE_SIZE;
+			len    -= MD5_SIGNATURE_BYTE_SIZE;
+		}
+	}
+
 	while( len >= MD5_SIGNATURE_BYTE_SIZE ) {
 		MD5Memcpy( context->intermediate, buffer, MD5_SIGNATURE_BYTE_SIZE,
 				 doByteSwap );
@@ -482,3 +563,153 @@ void md5( u8 *input, u32 len, u8 *digest, boolean doByteSwap )
 	
 	MD5Final( &context, digest, doByteSwap );
 }
+
+#ifdef FSBL_MD5_BENCH
+/******************************************************************************/
+/**
+*
+* This function updates the context as MD5Update did before blocks were
+* transformed in place, copying each block into the context first. It is
+* the reference of MD5Benchmark().
+*
+* @param	context is the MD5 context
+*
+* @param	buffer is the data
+*
+* @param	len is the length of the data in bytes
+*
+* @param	doByteSwap swaps the bytes of each word
+*
+* @return	None
+*
+* @note		The context must be empty, as after MD5Init().
+*
+****************************************************************************/
+static void MD5UpdateCopied( MD5Context *context, u8 *buffer,
+		   u32 len, boolean doByteSwap )
+{
+	u32 temp;
+
+	while( len >= MD5_SIGNATURE_BYTE_SIZE ) {
+		temp = context->bits[ 0 ];
+		context->bits[ 0 ] = temp + ( MD5_SIGNATURE_BYTE_SIZE << 3 );
+		if( context->bits[ 0 ] < temp ) {
+			context->bits[ 1 ]++;
+		}
+
+		MD5Memcpy( context->intermediate, buffer, MD5_SIGNATURE_BYTE_SIZE,
+				 doByteSwap );
+
+		MD5Transform( context->buffer, (u32 *)context->intermediate );
+
+		buffer += MD5_SIGNATURE_BYTE_SIZE;
+		len    -= MD5_SIGNATURE_BYTE_SIZE;
+	}
+
+	MD5Update( context, buffer, len, doByteSwap );
+}
+
+/******************************************************************************/
+/**
+*
+* This function times the MD5 of a buffer, with and without byte swap, for
+* the copying reference and for MD5Update, and checks that both give the
+* same digest. The four quarters of the buffer are then hashed one after
+* the other by md5() and together by md5x4(). The results are printed in
+* MB/s.
+*
+* @param	Buffer is the data, word aligned, such as the 16 MB
+*		of MD5_BENCH_LENGTH at DDR_TEMP_START_ADDR
+*
+* @param	Length is the length of the data in bytes
+*
+* @return	None
+*
+* @note		The contents of the buffer are not changed. They are
+*		hashed as they are, with the D-cache as FSBL left it.
+*
+****************************************************************************/
+void MD5Benchmark( u8 *Buffer, u32 Length )
+{
+	MD5Context context;
+	u8 Reference[ 16 ];
+	u8 Digest[ 16 ];
+	XTime tStart;
+	XTime tEnd;
+	u64 RefTicks;
+	u64 Ticks;
+	u8 *Quarter[ MD5_LANES ];
+	u32 QuarterLength[ MD5_LANES ];
+	u8 References[ MD5_LANES ][ 16 ];
+	u8 Digests[ MD5_LANES ][ 16 ];
+	u32 Swap;
+	u32 Mismatch;
+	u32 Index;
+	u32 Lane;
+
+	for( Swap = 0; Swap < 2; Swap++ ) {
+		XTime_GetTime( &tStart );
+		MD5Init( &context );
+		MD5UpdateCopied( &context, Buffer, Length, (boolean)Swap );
+		MD5Final( &context, Reference, (boolean)Swap );
+		XTime_GetTime( &tEnd );
+		RefTicks = tEnd - tStart;
+
+		XTime_GetTime( &tStart );
+		MD5Init( &context );
+		MD5Update( &context, Buffer, Length, (boolean)Swap );
+		MD5Final( &context, Digest, (boolean)Swap );
+		XTime_GetTime( &tEnd );
+		Ticks = tEnd - tStart;
+
+		Mismatch = 0;
+		for( Index = 0; Index < 16; Index++ ) {
+			Mismatch |= Reference[ Index ] ^ Digest[ Index ];
+		}
+
+		fsbl_printf(DEBUG_GENERAL, "MD5 %lu bytes swap %lu: "
+			"copied %lu MB/s, in place %lu MB/s%s\r\n",
+			Length, Swap,
+			(u32)(((u64)Length * COUNTS_PER_SECOND) /
+				((RefTicks + 1U) << 20)),
+			(u32)(((u64)Length * COUNTS_PER_SECOND) /
+				((Ticks + 1U) << 20)),
+			(Mismatch == 0) ? "" : " MISMATCH");
+	}
+
+	for( Lane = 0; Lane < MD5_LANES; Lane++ ) {
+		QuarterLength[ Lane ] = ( Length / MD5_LANES ) & ~3U;
+		Quarter[ Lane ] = Buffer + ( Lane * QuarterLength[ Lane ] );
+	}
+
+	XTime_GetTime( &tStart );
+	for( Lane = 0; Lane < MD5_LANES; Lane++ ) {
+		md5( Quarter[ Lane ], QuarterLength[ Lane ],
+		     References[ Lane ], 0 );
+	}
+	XTime_GetTime( &tEnd );
+	RefTicks = tEnd - tStart;
+
+	XTime_GetTime( &tStart );
+	md5x4( Quarter, QuarterLength, MD5_LANES, Digests, 0 );
+	XTime_GetTime( &tEnd );
+	Ticks = tEnd - tStart;
+
+	Mismatch = 0;
+	for( Lane = 0; Lane < MD5_LANES; Lane++ ) {
+		for( Index = 0; Index < 16; Index++ ) {
+			Mismatch |= References[ Lane ][ Index ] ^
+					Digests[ Lane ][ Index ];
+		}
+	}
+
+	fsbl_printf(DEBUG_GENERAL, "MD5 4 x %lu bytes: "
+		"one by one %lu MB/s, md5x4 %lu MB/s%s\r\n",
+		QuarterLength[ 0 ],
+		(u32)(((u64)QuarterLength[ 0 ] * MD5_LANES * COUNTS_PER_SECOND) /
+			((RefTicks + 1U) << 20)),
+		(u32)(((u64)QuarterLength[ 0 ] * MD5_LANES * COUNTS_PER_SECOND) /
+			((Ticks + 1U) << 20)),
+		(Mismatch == 0) ? "" : " MISMATCH");
+}
+#endif
@@ -15,6 +15,8 @@
 * Ver	Who	Date		Changes
 * ----- ---- -------- -------------------------------------------------------
 * 5.00a sgd	05/17/13 Initial release
+* 21.5  qm	10/14/26 Added MD5Benchmark() of FSBL_MD5_BENCH
+*       qm	10/14/26 Added md5x4()
 *
 * </pre>
 *
@@ -37,6 +39,18 @@ extern "C" {
 
 #define MD5_SIGNATURE_BYTE_SIZE	64
 
+/*
+ * Buffers hashed at once by md5x4()
+ */
+#define MD5_LANES		4
+
+/*
+ * Buffer hashed by MD5Benchmark() from FSBL, FSBL_MD5_BENCH only
+ */
+#ifndef MD5_BENCH_LENGTH
+#define MD5_BENCH_LENGTH	0x1000000
+#endif
+
 /**************************** Type Definitions *******************************/
 
 typedef u8 boolean;
@@ -84,6 +98,13 @@ void MD5Final( MD5Context *context, u8 *digest, boolean doByteSwap );
 
 void md5( u8 *input, u32	len, u8 *digest, boolean doByteSwap );
 
+void md5x4( u8 * const input[], const u32 len[], u32 count,
+		u8 digest[][ 16 ], boolean doByteSwap );
+
+#ifdef FSBL_MD5_BENCH
+void MD5Benchmark( u8 *Buffer, u32 Length );
+#endif
+
 /************************** Variable Definitions *****************************/
 
 #ifdef __cplusplus
@@ -0,0 +1,334 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file md5x4.c
+*
+* Contains code to calculate the MD5 checksums of up to MD5_LANES buffers
+* at once, one buffer in each 32-bit lane of the NEON registers
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.5  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+/****************************** Include Files *********************************/
+
+#include "md5.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define MD5X4_NEON
+#endif
+
+#ifdef MD5X4_NEON
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/*
+ * The four core functions on four lanes, F1 and F2 are bit selects
+ */
+#define MD5X4_F1( x, y, z )	vbslq_u32( x, y, z )
+#define MD5X4_F2( x, y, z )	vbslq_u32( z, x, y )
+#define MD5X4_F3( x, y, z )	veorq_u32( veorq_u32( x, y ), z )
+#define MD5X4_F4( x, y, z )	veorq_u32( y, vornq_u32( x, z ) )
+
+/*
+ * MD5_STEP on four lanes, word i of the four blocks in W[ i ]
+ */
+#define MD5X4_STEP( f, w, x, y, z, i, k, s ) \
+	( w = vaddq_u32( w, vaddq_u32( f( x, y, z ), \
+			vaddq_u32( W[ i ], vdupq_n_u32( k ) ) ) ), \
+	  w = vsriq_n_u32( vshlq_n_u32( w, s ), w, 32 - ( s ) ), \
+	  w = vaddq_u32( w, x ) )
+
+/************************** Variable Definitions *****************************/
+
+/*
+ * Block hashed by the lanes without a buffer, the result is dropped
+ */
+static const u32 Md5x4Idle[ MD5_SIGNATURE_BYTE_SIZE / 4 ];
+
+/******************************************************************************/
+/**
+*
+* This function transforms one block of each lane. The blocks are loaded
+* four words at a time and transposed, so that W[ i ] holds word i of the
+* four blocks.
+*
+* @param	State is the MD5 state, word j of the four lanes in State[ j ]
+*
+* @param	In is the block of each lane, 16 words
+*
+* @param	doByteSwap swaps the bytes of each word as it is loaded
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+static void MD5x4Transform( uint32x4_t *State, const u32 * const In[],
+		boolean doByteSwap )
+{
+	uint32x4_t W[ 16 ];
+	uint32x4x2_t Lo;
+	uint32x4x2_t Hi;
+	uint32x4_t a, b, c, d;
+	u32 Index;
+
+	for( Index = 0; Index < 16; Index += 4 ) {
+		Lo = vtrnq_u32( vld1q_u32( &In[ 0 ][ Index ] ),
+				vld1q_u32( &In[ 1 ][ Index ] ) );
+		Hi = vtrnq_u32( vld1q_u32( &In[ 2 ][ Index ] ),
+				vld1q_u32( &In[ 3 ][ Index ] ) );
+
+		W[ Index ] = vcombine_u32( vget_low_u32( Lo.val[ 0 ] ),
+					   vget_low_u32( Hi.val[ 0 ] ) );
+		W[ Index + 1 ] = vcombine_u32( vget_low_u32( Lo.val[ 1 ] ),
+					       vget_low_u32( Hi.val[ 1 ] ) );
+		W[ Index + 2 ] = vcombine_u32( vget_high_u32( Lo.val[ 0 ] ),
+					       vget_high_u32( Hi.val[ 0 ] ) );
+		W[ Index + 3 ] = vcombine_u32( vget_high_u32( Lo.val[ 1 ] ),
+					       vget_high_u32( Hi.val[ 1 ] ) );
+	}
+
+	if( doByteSwap ) {
+		for( Index = 0; Index < 16; Index++ ) {
+			W[ Index ] = vreinterpretq_u32_u8( vrev32q_u8(
+					vreinterpretq_u8_u32( W[ Index ] ) ) );
+		}
+	}
+
+	a = State[ 0 ];
+	b = State[ 1 ];
+	c = State[ 2 ];
+	d = State[ 3 ];
+
+	MD5X4_STEP( MD5X4_F1, a, b, c, d, 0, 0xd76aa478,  7 );
+	MD5X4_STEP( MD5X4_F1, d, a, b, c, 1, 0xe8c7b756, 12 );
+	MD5X4_STEP( MD5X4_F1, c, d, a, b, 2, 0x242070db, 17 );
+	MD5X4_STEP( MD5X4_F1, b, c, d, a, 3, 0xc1bdceee, 22 );
+	MD5X4_STEP( MD5X4_F1, a, b, c, d, 4, 0xf57c0faf,  7 );
+	MD5X4_STEP( MD5X4_F1, d, a, b, c, 5, 0x4787c62a, 12 );
+	MD5X4_STEP( MD5X4_F1, c, d, a, b, 6, 0xa8304613, 17 );
+	MD5X4_STEP( MD5X4_F1, b, c, d, a, 7, 0xfd469501, 22 );
+	MD5X4_STEP( MD5X4_F1, a, b, c, d, 8, 0x698098d8,  7 );
+	MD5X4_STEP( MD5X4_F1, d, a, b, c, 9, 0x8b44f7af, 12 );
+	MD5X4_STEP( MD5X4_F1, c, d, a, b, 10, 0xffff5bb1, 17 );
+	MD5X4_STEP( MD5X4_F1, b, c, d, a, 11, 0x895cd7be, 22 );
+	MD5X4_STEP( MD5X4_F1, a, b, c, d, 12, 0x6b901122,  7 );
+	MD5X4_STEP( MD5X4_F1, d, a, b, c, 13, 0xfd987193, 12 );
+	MD5X4_STEP( MD5X4_F1, c, d, a, b, 14, 0xa679438e, 17 );
+	MD5X4_STEP( MD5X4_F1, b, c, d, a, 15, 0x49b40821, 22 );
+
+	MD5X4_STEP( MD5X4_F2, a, b, c, d, 1, 0xf61e2562,  5 );
+	MD5X4_STEP( MD5X4_F2, d, a, b, c, 6, 0xc040b340,  9 );
+	MD5X4_STEP( MD5X4_F2, c, d, a, b, 11, 0x265e5a51, 14 );
+	MD5X4_STEP( MD5X4_F2, b, c, d, a, 0, 0xe9b6c7aa, 20 );
+	MD5X4_STEP( MD5X4_F2, a, b, c, d, 5, 0xd62f105d,  5 );
+	MD5X4_STEP( MD5X4_F2, d, a, b, c, 10, 0x02441453,  9 );
+	MD5X4_STEP( MD5X4_F2, c, d, a, b, 15, 0xd8a1e681, 14 );
+	MD5X4_STEP( MD5X4_F2, b, c, d, a, 4, 0xe7d3fbc8, 20 );
+	MD5X4_STEP( MD5X4_F2, a, b, c, d, 9, 0x21e1cde6,  5 );
+	MD5X4_STEP( MD5X4_F2, d, a, b, c, 14, 0xc33707d6,  9 );
+	MD5X4_STEP( MD5X4_F2, c, d, a, b, 3, 0xf4d50d87, 14 );
+	MD5X4_STEP( MD5X4_F2, b, c, d, a, 8, 0x455a14ed, 20 );
+	MD5X4_STEP( MD5X4_F2, a, b, c, d, 13, 0xa9e3e905,  5 );
+	MD5X4_STEP( MD5X4_F2, d, a, b, c, 2, 0xfcefa3f8,  9 );
+	MD5X4_STEP( MD5X4_F2, c, d, a, b, 7, 0x676f02d9, 14 );
+	MD5X4_STEP( MD5X4_F2, b, c, d, a, 12, 0x8d2a4c8a, 20 );
+
+	MD5X4_STEP( MD5X4_F3, a, b, c, d, 5, 0xfffa3942,  4 );
+	MD5X4_STEP( MD5X4_F3, d, a, b, c, 8, 0x8771f681, 11 );
+	MD5X4_STEP( MD5X4_F3, c, d, a, b, 11, 0x6d9d6122, 16 );
+	MD5X4_STEP( MD5X4_F3, b, c, d, a, 14, 0xfde5380c, 23 );
+	MD5X4_STEP( MD5X4_F3, a, b, c, d, 1, 0xa4beea44,  4 );
+	MD5X4_STEP( MD5X4_F3, d, a, b, c, 4, 0x4bdecfa9, 11 );
+	MD5X4_STEP( MD5X4_F3, c, d, a, b, 7, 0xf6bb4b60, 16 );
+	MD5X4_STEP( MD5X4_F3, b, c, d, a, 10, 0xbebfbc70, 23 );
+	MD5X4_STEP( MD5X4_F3, a, b, c, d, 13, 0x289b7ec6,  4 );
+	MD5X4_STEP( MD5X4_F3, d, a, b, c, 0, 0xeaa127fa, 11 );
+	MD5X4_STEP( MD5X4_F3, c, d, a, b, 3, 0xd4ef3085, 16 );
+	MD5X4_STEP( MD5X4_F3, b, c, d, a, 6, 0x04881d05, 23 );
+	MD5X4_STEP( MD5X4_F3, a, b, c, d, 9, 0xd9d4d039,  4 );
+	MD5X4_STEP( MD5X4_F3, d, a, b, c, 12, 0xe6db99e5, 11 );
+	MD5X4_STEP( MD5X4_F3, c, d, a, b, 15, 0x1fa27cf8, 16 );
+	MD5X4_STEP( MD5X4_F3, b, c, d, a, 2, 0xc4ac5665, 23 );
+
+	MD5X4_STEP( MD5X4_F4, a, b, c, d, 0, 0xf4292244,  6 );
+	MD5X4_STEP( MD5X4_F4, d, a, b, c, 7, 0x432aff97, 10 );
+	MD5X4_STEP( MD5X4_F4, c, d, a, b, 14, 0xab9423a7, 15 );
+	MD5X4_STEP( MD5X4_F4, b, c, d, a, 5, 0xfc93a039, 21 );
+	MD5X4_STEP( MD5X4_F4, a, b, c, d, 12, 0x655b59c3,  6 );
+	MD5X4_STEP( MD5X4_F4, d, a, b, c, 3, 0x8f0ccc92, 10 );
+	MD5X4_STEP( MD5X4_F4, c, d, a, b, 10, 0xffeff47d, 15 );
+	MD5X4_STEP( MD5X4_F4, b, c, d, a, 1, 0x85845dd1, 21 );
+	MD5X4_STEP( MD5X4_F4, a, b, c, d, 8, 0x6fa87e4f,  6 );
+	MD5X4_STEP( MD5X4_F4, d, a, b, c, 15, 0xfe2ce6e0, 10 );
+	MD5X4_STEP( MD5X4_F4, c, d, a, b, 6, 0xa3014314, 15 );
+	MD5X4_STEP( MD5X4_F4, b, c, d, a, 13, 0x4e0811a1, 21 );
+	MD5X4_STEP( MD5X4_F4, a, b, c, d, 4, 0xf7537e82,  6 );
+	MD5X4_STEP( MD5X4_F4, d, a, b, c, 11, 0xbd3af235, 10 );
+	MD5X4_STEP( MD5X4_F4, c, d, a, b, 2, 0x2ad7d2bb, 15 );
+	MD5X4_STEP( MD5X4_F4, b, c, d, a, 9, 0xeb86d391, 21 );
+
+	State[ 0 ] = vaddq_u32( State[ 0 ], a );
+	State[ 1 ] = vaddq_u32( State[ 1 ], b );
+	State[ 2 ] = vaddq_u32( State[ 2 ], c );
+	State[ 3 ] = vaddq_u32( State[ 3 ], d );
+}
+#endif
+
+/******************************************************************************/
+/**
+*
+* This function calculates and stores in 'digest' the MD5 digests of up to
+* MD5_LANES buffers, as md5() does for each of them.
+*
+* The whole blocks of the buffers are transformed together, one buffer in
+* each lane, as long as two buffers have blocks left; a lane whose buffer
+* has none left hashes an idle block. The last blocks of the longest buffer
+* and the padding of each buffer are done by MD5Update() and MD5Final().
+* Buffers of about the same length therefore gain the most.
+*
+* @param	input is the start of each buffer, word aligned for its blocks
+*		to be transformed in the lanes
+*
+* @param	len is the length of each buffer in bytes
+*
+* @param	count is the number of buffers, at most MD5_LANES
+*
+* @param	digest is the 16 byte digest of each buffer
+*
+* @param	doByteSwap swaps the bytes of each word
+*
+* @return	None
+*
+* @note		Without NEON the buffers are hashed one after the other.
+*
+****************************************************************************/
+void md5x4( u8 * const input[], const u32 len[], u32 count,
+		u8 digest[][ 16 ], boolean doByteSwap )
+{
+	MD5Context context;
+	u32 Done[ MD5_LANES ];
+	u32 Lane;
+#ifdef MD5X4_NEON
+	uint32x4x4_t State;
+	u32 Words[ MD5_LANES ][ 4 ];
+	u32 Lanes[ MD5_LANES ][ 4 ];
+	const u32 *In[ MD5_LANES ];
+	u32 Left[ MD5_LANES ];
+	u32 Run;
+	u32 Busy;
+	u32 Index;
+#endif
+
+	if( count > MD5_LANES ) {
+		count = MD5_LANES;
+	}
+
+	for( Lane = 0; Lane < count; Lane++ ) {
+		Done[ Lane ] = 0;
+	}
+
+#ifdef MD5X4_NEON
+	MD5Init( &context );
+	for( Lane = 0; Lane < MD5_LANES; Lane++ ) {
+		for( Index = 0; Index < 4; Index++ ) {
+			Words[ Lane ][ Index ] = context.buffer[ Index ];
+		}
+
+		Left[ Lane ] = 0;
+		if( ( Lane < count ) &&
+				( ( (UINTPTR)input[ Lane ] &
+				    ( sizeof( u32 ) - 1U ) ) == 0U ) ) {
+			Left[ Lane ] = len[ Lane ] / MD5_SIGNATURE_BYTE_SIZE;
+		}
+	}
+
+	for( ;; ) {
+		/*
+		 * Transform as many blocks as the shortest busy lane has left
+		 */
+		Run = 0;
+		Busy = 0;
+		for( Lane = 0; Lane < MD5_LANES; Lane++ ) {
+			if( Left[ Lane ] != 0 ) {
+				Busy++;
+				if( ( Run == 0 ) || ( Left[ Lane ] < Run ) ) {
+					Run = Left[ Lane ];
+				}
+			}
+		}
+
+		if( Busy < 2 ) {
+			break;
+		}
+
+		for( Lane = 0; Lane < MD5_LANES; Lane++ ) {
+			In[ Lane ] = ( Left[ Lane ] != 0 ) ?
+				(const u32 *)( input[ Lane ] + ( Done[ Lane ] *
+					MD5_SIGNATURE_BYTE_SIZE ) ) : Md5x4Idle;
+		}
+
+		State = vld4q_u32( &Words[ 0 ][ 0 ] );
+		for( Index = 0; Index < Run; Index++ ) {
+			MD5x4Transform( State.val, In, doByteSwap );
+
+			for( Lane = 0; Lane < MD5_LANES; Lane++ ) {
+				if( Left[ Lane ] != 0 ) {
+					In[ Lane ] +=
+						MD5_SIGNATURE_BYTE_SIZE / 4;
+				}
+			}
+		}
+
+		/*
+		 * Keep the state of the busy lanes only
+		 */
+		vst4q_u32( &Lanes[ 0 ][ 0 ], State );
+		for( Lane = 0; Lane < MD5_LANES; Lane++ ) {
+			if( Left[ Lane ] != 0 ) {
+				for( Index = 0; Index < 4; Index++ ) {
+					Words[ Lane ][ Index ] =
+						Lanes[ Lane ][ Index ];
+				}
+				Left[ Lane ] -= Run;
+				Done[ Lane ] += Run;
+			}
+		}
+	}
+#endif
+
+	/*
+	 * The rest of each buffer from where the lanes got to
+	 */
+	for( Lane = 0; Lane < count; Lane++ ) {
+		MD5Init( &context );
+#ifdef MD5X4_NEON
+		for( Index = 0; Index < 4; Index++ ) {
+			context.buffer[ Index ] = Words[ Lane ][ Index ];
+		}
+		context.bits[ 0 ] = Done[ Lane ] << 9;
+		context.bits[ 1 ] = Done[ Lane ] >> 23;
+#endif
+
+		MD5Update( &context, input[ Lane ] +
+				( Done[ Lane ] * MD5_SIGNATURE_BYTE_SIZE ),
+				len[ Lane ] - ( Done[ Lane ] *
+					MD5_SIGNATURE_BYTE_SIZE ),
+				doByteSwap );
+
+		MD5Final( &context, digest[ Lane ], doByteSwap );
+	}
+}
@@ -12,6 +12,9 @@
 * Contains code for the NAND FLASH functionality. Bad Block management
 * is simple: skip the bad blocks and keep going.
 *
+* The bad blocks are listed once in InitNand, and each run of good blocks
+* is read with one XNandPs_Read call.
+*
 * <pre>
 * MODIFICATION HISTORY:
 *
@@ -22,6 +25,8 @@
 * 3.00a sgd	30/01/13 Code cleanup
 * 5.00a sgd	17/05/13 Support for Multi Boot
 * 21.2  ng  07/25/23 Add SDT support
+* 21.3  qm  10/14/26 Map the bad blocks once in InitNand and read runs of
+*                    good blocks in one call
 * </pre>
 *
 * @note
@@ -43,14 +48,26 @@
 	#define NAND_DEVICE		XPAR_XNANDPS_0_BASEADDR
 #endif
 
+/*
+ * Bad blocks the map holds, beyond the 2% of the largest parts, more with
+ * the NAND footprint profile
+ */
+#ifndef NAND_MAX_BAD_BLOCKS
+#ifdef FSBL_PROFILE_NAND
+#define NAND_MAX_BAD_BLOCKS	1024
+#else
+#define NAND_MAX_BAD_BLOCKS	256
+#endif
+#endif
+
 /**************************** Type Definitions *******************************/
 
 /***************** Macros (Inline Functions) Definitions *********************/
 
 /************************** Function Prototypes ******************************/
-static u32 XNandPs_CalculateLength(XNandPs *NandInstPtr,
-										u64 Offset,
-										u32 Length);
+static void NandBuildBadMap(void);
+static u32 NandIsBlockBad(u32 Block);
+static u32 NandGoodBlock(u32 GoodIndex);
 
 /************************** Variable Definitions *****************************/
 
@@ -60,6 +77,14 @@ extern u32 FlashOffsetAddress;
 XNandPs *NandInstPtr;
 XNandPs NandInstance; /* XNand Instance. */
 
+/*
+ * Bad blocks in increasing order, NandBadMapValid is cleared if they do
+ * not fit and the driver table is used instead
+ */
+static u32 NandBadBlock[NAND_MAX_BAD_BLOCKS];
+static u32 NandBadCount;
+static u32 NandBadMapValid;
+
 /******************************************************************************/
 /**
 *
@@ -116,6 +141,11 @@ u32 InitNand(void)
 		return XST_FAILURE;
 	}
 
+	/*
+	 * List the bad blocks once, instead of walking the table on each access
+	 */
+	NandBuildBadMap();
+
 	/*
 	 * set up the FLASH access pointers
 	 */
@@ -144,79 +174,65 @@ u32 InitNand(void)
 ****************************************************************************/
 u32 NandAccess(u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 {
-	u32 ActLen;
-	u32 BlockOffset;
-	u32 Block;
 	u32 Status;
 	u32 BytesLeft = LengthBytes;
 	u32 BlockSize = NandInstPtr->Geometry.BlockSize;
+	u32 NumBlocks = (u32)(NandInstPtr->Geometry.DeviceSize / BlockSize);
 	u8 *BufPtr = (u8 *)DestinationAddress;
+	u32 BlockOffset = SourceAddress & (BlockSize - 1);
+	u32 Block;
+	u32 NextBlock;
+	u32 RunLen;
 	u32 ReadLen;
-	u32 BlockReadLen;
-	u32 Offset;
-	u32 TmpAddress = 0 ;
-	u32 BlockCount = 0;
-	u32 BadBlocks = 0;
-
-	/*
-	 * First get bad blocks before the source address
-	 */
-	while (TmpAddress < SourceAddress) {
-		while (XNandPs_IsBlockBad(NandInstPtr, BlockCount) ==
-				XST_SUCCESS) {
-			BlockCount ++;
-			BadBlocks ++;
-		}
-
-		TmpAddress += BlockSize;
-		BlockCount ++;
-	}
-
-	Offset = SourceAddress + BadBlocks * BlockSize;
 
 	/*
-	 * Calculate the actual length including bad blocks
+	 * Physical block of the source address, past the bad blocks before it
 	 */
-	ActLen = XNandPs_CalculateLength(NandInstPtr, Offset, LengthBytes);
-
-	/*
-	 *  Check if the actual length cross flash size
-	 */
-	if (Offset + ActLen > NandInstPtr->Geometry.DeviceSize) {
-		return XST_FAILURE;
-	}
+	Block = NandGoodBlock(SourceAddress / BlockSize);
 
 	while (BytesLeft > 0) {
-		BlockOffset = Offset & (BlockSize - 1);
-		Block = (Offset & ~(BlockSize - 1))/BlockSize;
-		BlockReadLen = BlockSize - BlockOffset;
-
-		Status = XNandPs_IsBlockBad(NandInstPtr, Block);
-		if (Status == XST_SUCCESS) {
-			/* Move to next block */
-			Offset += BlockReadLen;
-			continue;
+		if (Block >= NumBlocks) {
+			return XST_FAILURE;
 		}
 
 		/*
-		 * Check if we cross block boundary
+		 * Extend the read over the good blocks that follow
 		 */
-		if (BytesLeft < BlockReadLen) {
+		RunLen = BlockSize - BlockOffset;
+		NextBlock = Block + 1;
+		while ((RunLen < BytesLeft) && (NextBlock < NumBlocks) &&
+				(NandIsBlockBad(NextBlock) != XST_SUCCESS)) {
+			RunLen += BlockSize;
+			NextBlock++;
+		}
+
+		if (BytesLeft < RunLen) {
 			ReadLen = BytesLeft;
 		} else {
-			ReadLen = BlockReadLen;
+			ReadLen = RunLen;
 		}
 
 		/*
 		 * Read from the NAND flash
 		 */
-		Status = XNandPs_Read(NandInstPtr, Offset, ReadLen, BufPtr, NULL);
+		Status = XNandPs_Read(NandInstPtr,
+				(u64)Block * BlockSize + BlockOffset,
+				ReadLen, BufPtr, NULL);
 		if (Status != XST_SUCCESS) {
 			return Status;
 		}
 		BytesLeft -= ReadLen;
-		Offset += ReadLen;
 		BufPtr += ReadLen;
+		BlockOffset = 0;
+
+		/*
+		 * Skip the bad blocks that end the run
+		 */
+		Block = NextBlock;
+		while ((Block < NumBlocks) &&
+				(NandIsBlockBad(Block) == XST_SUCCESS)) {
+			Block++;
+		}
 	}
 
 	return XST_SUCCESS;
@@ -225,50 +241,126 @@ u32 NandAccess(u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 /*****************************************************************************/
 /**
 *
-* This function returns the length including bad blocks from a given offset and
-* length.
+* This function lists the bad blocks of the flash, from the bad block table
+* of the driver.
+*
+* @param	None
 *
-* @param	NandInstPtr is the pointer to the XNandPs instance.
-* @param	Offset is the flash data address to read from.
-* @param	Length is number of bytes to read.
+* @return	None
+*
+* @note		NandBadMapValid is left cleared if there are more than
+*		NAND_MAX_BAD_BLOCKS bad blocks.
+*
+******************************************************************************/
+static void NandBuildBadMap(void)
+{
+	u32 BlockSize = NandInstPtr->Geometry.BlockSize;
+	u32 NumBlocks = (u32)(NandInstPtr->Geometry.DeviceSize / BlockSize);
+	u32 Block;
+
+	NandBadCount = 0;
+	NandBadMapValid = 0;
+
+	for (Block = 0; Block < NumBlocks; Block++) {
+		if (XNandPs_IsBlockBad(NandInstPtr, Block) == XST_SUCCESS) {
+			if (NandBadCount == NAND_MAX_BAD_BLOCKS) {
+				fsbl_printf(DEBUG_INFO,"InitNand: over %d bad blocks\r\n",
+						NAND_MAX_BAD_BLOCKS);
+				return;
+			}
+			NandBadBlock[NandBadCount] = Block;
+			NandBadCount++;
+		}
+	}
+
+	NandBadMapValid = 1;
+
+	fsbl_printf(DEBUG_INFO,"InitNand: %d bad blocks\r\n", NandBadCount);
+}
+
+/*****************************************************************************/
+/**
+*
+* This function tells whether a block is bad.
+*
+* @param	Block is the physical block
 *
 * @return
-*		- Return actual length including bad blocks.
+*		- XST_SUCCESS if the block is bad
+*		- XST_FAILURE if the block is good
+*
+* @note		Same return values as XNandPs_IsBlockBad.
+*
+******************************************************************************/
+static u32 NandIsBlockBad(u32 Block)
+{
+	u32 Low = 0;
+	u32 High = NandBadCount;
+	u32 Mid;
+
+	if (!NandBadMapValid) {
+		return XNandPs_IsBlockBad(NandInstPtr, Block);
+	}
+
+	while (Low < High) {
+		Mid = (Low + High) / 2;
+		if (NandBadBlock[Mid] == Block) {
+			return XST_SUCCESS;
+		}
+		if (NandBadBlock[Mid] < Block) {
+			Low = Mid + 1;
+		} else {
+			High = Mid;
+		}
+	}
+
+	return XST_FAILURE;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function returns the physical block of a good block, the bad blocks
+* not being counted in the addresses of the images.
+*
+* @param	GoodIndex is the number of good blocks before the block
+*
+* @return	Physical block, past the end of the flash if there are not
+*		enough good blocks
 *
 * @note		None.
 *
 ******************************************************************************/
-static u32 XNandPs_CalculateLength(XNandPs *NandInstPtr,
-									u64 Offset,
-									u32 Length)
+static u32 NandGoodBlock(u32 GoodIndex)
 {
 	u32 BlockSize = NandInstPtr->Geometry.BlockSize;
-	u32 CurBlockLen;
-	u32 CurBlock;
-	u32 Status;
-	u32 TempLen = 0;
-	u32 ActLen = 0;
-
-	while (TempLen < Length) {
-		CurBlockLen = BlockSize - (Offset & (BlockSize - 1));
-		CurBlock = (Offset & ~(BlockSize - 1))/BlockSize;
+	u32 NumBlocks = (u32)(NandInstPtr->Geometry.DeviceSize / BlockSize);
+	u32 Block = GoodIndex;
+	u32 Index;
 
+	if (NandBadMapValid) {
 		/*
-		 * Check if the block is bad
+		 * Each bad block at or before the block moves it by one
 		 */
-		Status = XNandPs_IsBlockBad(NandInstPtr, CurBlock);
-		if (Status != XST_SUCCESS) {
-			/* Good Block */
-			TempLen += CurBlockLen;
+		for (Index = 0; Index < NandBadCount; Index++) {
+			if (NandBadBlock[Index] > Block) {
+				break;
+			}
+			Block++;
 		}
-		ActLen += CurBlockLen;
-		Offset += CurBlockLen;
-		if (Offset >= NandInstPtr->Geometry.DeviceSize) {
-			break;
+		return Block;
+	}
+
+	for (Block = 0; Block < NumBlocks; Block++) {
+		if (XNandPs_IsBlockBad(NandInstPtr, Block) != XST_SUCCESS) {
+			if (GoodIndex == 0) {
+				break;
+			}
+			GoodIndex--;
 		}
 	}
 
-	return ActLen;
+	return Block;
 }
 
 #endif
@@ -18,6 +18,9 @@
 * 1.00a ecm	01/10/10 Initial release
 * 2.00a mb	25/05/12 mio init removed
 * 3.00a sgd	30/01/13 Code cleanup
+* 21.3  qm	10/14/26 Large word aligned copies by the PS DMA, CPU copies
+*			 of aligned spans with memcpy
+*			 Asynchronous page mode reads with FSBL_NOR_PAGE
 *
 * </pre>
 *
@@ -28,10 +31,49 @@
 /***************************** Include Files *********************************/
 #include "fsbl.h"
 #include "nor.h"
+#include "fsbl_dma.h"
 #include "xstatus.h"
+#include <string.h>
 
 /************************** Constant Definitions *****************************/
 
+#ifdef FSBL_NOR_PAGE
+/*
+ * PL353 SMC registers of the SRAM/NOR interface, chip select 0
+ */
+#define SMC_BASEADDR			0xE000E000
+#define SMC_DIRECT_CMD_OFFSET		0x010
+#define SMC_SET_CYCLES_OFFSET		0x014
+#define SMC_SET_OPMODE_OFFSET		0x018
+#define SMC_SRAM_CYCLES0_0_OFFSET	0x100
+#define SMC_OPMODE0_0_OFFSET		0x104
+
+#define SMC_DIRECT_CMD_UPDATE_REGS	0x00400000	/* Chip select 0 */
+#define SMC_CYCLES_MASK			0x001FFFFF
+#define SMC_CYCLES_T_RC_MASK		0x0000000F
+#define SMC_CYCLES_T_PC_MASK		0x0001C000
+#define SMC_CYCLES_T_PC_SHIFT		14
+#define SMC_OPMODE_MASK			0x0000FFFF
+#define SMC_OPMODE_RD_SYNC_MASK		0x00000004
+#define SMC_OPMODE_RD_BL_MASK		0x00000038
+#define SMC_OPMODE_RD_BL_SHIFT		3
+
+/*
+ * CFI query of an x8/x16 part in byte mode, the word offsets of the query
+ * table are doubled on the 8-bit bus
+ */
+#define NOR_CFI_QUERY_ADDR		0xAA
+#define NOR_CFI_QUERY_CMD		0x98
+#define NOR_RESET_CMD			0xF0
+#define NOR_CFI_ADDR(Offset)		((Offset) << 1)
+#define NOR_CFI_QRY_OFFSET		0x10
+#define NOR_CFI_PRI_OFFSET		0x15	/* Primary extended table */
+#define NOR_CFI_PRI_PAGE_MODE		0x0C	/* Page mode type */
+#define NOR_CFI_PAGE_MODE_MAX		0x04	/* 32 word pages */
+
+#define NOR_PAGE_CHECK_LENGTH		0x400	/* Bytes compared */
+#endif
+
 /**************************** Type Definitions *******************************/
 
 
@@ -39,10 +81,22 @@
 
 /************************** Function Prototypes ******************************/
 
+#ifdef FSBL_NOR_PAGE
+static u32 NorCfiPageBytes(void);
+static void NorPageMode(void);
+#endif
+
 /************************** Variable Definitions *****************************/
 
 extern u32 FlashReadBaseAddress;
 
+#ifdef FSBL_NOR_PAGE
+/*
+ * Boot header as read at the boot setting
+ */
+static u32 NorPageReference[NOR_PAGE_CHECK_LENGTH / 4];
+#endif
+
 /******************************************************************************/
 /******************************************************************************/
 /**
@@ -63,6 +117,14 @@ void InitNor(void)
 	 * Set up the base address for access
 	 */
 	FlashReadBaseAddress = XPS_NOR_BASEADDR;
+
+#ifdef FSBL_NOR_PAGE
+	NorPageMode();
+#endif
+
+#ifdef FSBL_DMA
+	FsblDmaInit();
+#endif
 }
 
 /******************************************************************************/
@@ -104,6 +166,29 @@ u32 NorAccess(u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 	SourceAddr = (u32 *)(SourceAddress + FlashReadBaseAddress);
 	DestAddr = (u32 *)(DestinationAddress);
 
+	if ((((u32)SourceAddr | (u32)DestAddr) & 0x3) == 0) {
+#ifdef FSBL_DMA
+		/*
+		 * Large copies by the DMA, the CPU copy is kept for the rest
+		 * and if the DMA fails
+		 */
+		if (LengthBytes >= FSBL_DMA_THRESHOLD) {
+			if (FsblDmaCopy((u32)SourceAddr, (u32)DestAddr,
+					LengthBytes) == XST_SUCCESS) {
+				return XST_SUCCESS;
+			}
+			fsbl_printf(DEBUG_INFO, "NOR DMA copy failed\r\n");
+		}
+#endif
+		/*
+		 * Multiple word loads and stores, which the SMC turns into
+		 * page reads
+		 */
+		memcpy(DestAddr, SourceAddr, LengthBytes);
+
+		return XST_SUCCESS;
+	}
+
 	/*
 	 * Word transfers, endianism isn't an issue
 	 */
@@ -116,3 +201,132 @@ u32 NorAccess(u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 	return XST_SUCCESS;
 }
 
+#ifdef FSBL_NOR_PAGE
+/******************************************************************************/
+/**
+*
+* This function reads the page size of the flash from the primary vendor
+* extended table of its CFI query, which AMD command set parts have.
+*
+* @param	None
+*
+* @return	Page size in bytes on the 8-bit bus, 0 if the part has no page
+*		mode or does not answer the query
+*
+* @note		The part is returned to read array mode.
+*
+****************************************************************************/
+static u32 NorCfiPageBytes(void)
+{
+	u32 Base = XPS_NOR_BASEADDR;
+	u32 Primary;
+	u32 PageMode = 0;
+
+	Xil_Out8(Base + NOR_CFI_QUERY_ADDR, NOR_CFI_QUERY_CMD);
+
+	if ((Xil_In8(Base + NOR_CFI_ADDR(NOR_CFI_QRY_OFFSET)) == 'Q') &&
+		(Xil_In8(Base + NOR_CFI_ADDR(NOR_CFI_QRY_OFFSET + 1)) == 'R') &&
+		(Xil_In8(Base + NOR_CFI_ADDR(NOR_CFI_QRY_OFFSET + 2)) == 'Y')) {
+
+		Primary = Xil_In8(Base + NOR_CFI_ADDR(NOR_CFI_PRI_OFFSET)) |
+			(Xil_In8(Base + NOR_CFI_ADDR(NOR_CFI_PRI_OFFSET + 1)) << 8);
+
+		if ((Primary != 0) && (Primary != 0xFFFF) &&
+			(Xil_In8(Base + NOR_CFI_ADDR(Primary)) == 'P')) {
+			PageMode = Xil_In8(Base +
+					NOR_CFI_ADDR(Primary + NOR_CFI_PRI_PAGE_MODE));
+		}
+	}
+
+	Xil_Out8(Base, NOR_RESET_CMD);
+
+	if ((PageMode == 0) || (PageMode > NOR_CFI_PAGE_MODE_MAX)) {
+		return 0;
+	}
+
+	/*
+	 * Types 1 to 4 are pages of 4 to 32 words, twice as many bytes
+	 */
+	return (2U << PageMode) << 1;
+}
+
+/******************************************************************************/
+/**
+*
+* This function switches the SMC to asynchronous page mode reads of the
+* page size of the flash. The read burst length is set to the page, and the
+* page access time to the read cycle time unless the boot setting has one.
+* The boot header is compared with its image at the boot setting, if it
+* differs the boot setting is restored.
+*
+* @param	None
+*
+* @return	None
+*
+* @note		Synchronous burst reads are left alone, since they need the
+*		configuration register of the flash to be written.
+*
+****************************************************************************/
+static void NorPageMode(void)
+{
+	u32 PageBytes;
+	u32 Cycles;
+	u32 Opmode;
+	u32 NewCycles;
+	u32 NewOpmode;
+	u32 ReadBurst;
+
+	Opmode = Xil_In32(SMC_BASEADDR + SMC_OPMODE0_0_OFFSET) & SMC_OPMODE_MASK;
+	if ((Opmode & SMC_OPMODE_RD_SYNC_MASK) != 0) {
+		return;
+	}
+
+	PageBytes = NorCfiPageBytes();
+	if (PageBytes == 0) {
+		fsbl_printf(DEBUG_INFO, "NOR has no page mode\r\n");
+		return;
+	}
+
+	/*
+	 * Read burst lengths 1 to 4 are 4 to 32 beats, larger pages are read
+	 * 32 beats at a time
+	 */
+	ReadBurst = 1;
+	while (((4U << ReadBurst) <= PageBytes) && (ReadBurst < 4)) {
+		ReadBurst++;
+	}
+
+	Cycles = Xil_In32(SMC_BASEADDR + SMC_SRAM_CYCLES0_0_OFFSET) &
+			SMC_CYCLES_MASK;
+
+	NewCycles = Cycles;
+	if ((Cycles & SMC_CYCLES_T_PC_MASK) == 0) {
+		NewCycles |= ((Cycles & SMC_CYCLES_T_RC_MASK) <<
+				SMC_CYCLES_T_PC_SHIFT) & SMC_CYCLES_T_PC_MASK;
+	}
+	NewOpmode = (Opmode & ~SMC_OPMODE_RD_BL_MASK) |
+			(ReadBurst << SMC_OPMODE_RD_BL_SHIFT);
+
+	memcpy(NorPageReference, (void *)XPS_NOR_BASEADDR,
+			NOR_PAGE_CHECK_LENGTH);
+
+	Xil_Out32(SMC_BASEADDR + SMC_SET_CYCLES_OFFSET, NewCycles);
+	Xil_Out32(SMC_BASEADDR + SMC_SET_OPMODE_OFFSET, NewOpmode);
+	Xil_Out32(SMC_BASEADDR + SMC_DIRECT_CMD_OFFSET,
+			SMC_DIRECT_CMD_UPDATE_REGS);
+
+	if (memcmp(NorPageReference, (void *)XPS_NOR_BASEADDR,
+			NOR_PAGE_CHECK_LENGTH) != 0) {
+		fsbl_printf(DEBUG_GENERAL, "NOR page mode read check failed\r\n");
+
+		Xil_Out32(SMC_BASEADDR + SMC_SET_CYCLES_OFFSET, Cycles);
+		Xil_Out32(SMC_BASEADDR + SMC_SET_OPMODE_OFFSET, Opmode);
+		Xil_Out32(SMC_BASEADDR + SMC_DIRECT_CMD_OFFSET,
+				SMC_DIRECT_CMD_UPDATE_REGS);
+		return;
+	}
+
+	fsbl_printf(DEBUG_INFO, "NOR page mode, %d byte pages\r\n", PageBytes);
+}
+#endif
+
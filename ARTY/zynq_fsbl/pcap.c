@@ -62,6 +62,25 @@
 * 											3.0 and later versions of silicon.
 * 21.1   ng  07/13/23   Add SDT support
 * 21.2   ng  03/09/24   Fix format specifier for 32 bit variables
+* 21.3   qm  10/14/26   Added PcapStreamPartition() to load a bitstream
+*                       from a non-linear boot device while it is read
+*                       Added the interrupt driven completion of
+*                       FSBL_PCAP_INTR and PcapLoadPartitionStart()
+*                       Added PcapDataTransferStart() to overlap the
+*                       partition checksum with the transfer
+*                       Split PcapStreamPartition() in PcapStreamBegin(),
+*                       PcapStreamChunk() and PcapStreamChunkWait(), for
+*                       the LZ4 bitstreams
+*                       FSBL_PL_FAST polls the PL load done quietly with a
+*                       backoff, and does the one time checks of
+*                       FabricInit() once
+*                       Flush and invalidate the transfer buffers with
+*                       FSBL_DCACHE
+*                       PcapStreamPartition() reads through the boot
+*                       device layer of fsbl_bootdev.h
+*                       Added PcapStreamDecrypt() to decrypt a PS partition
+*                       of a non-linear boot device while it is read, with
+*                       FSBL_AES_STREAM
 * </pre>
 *
 * @note
@@ -74,6 +93,7 @@
 #include "nand.h"		/* For NAND geometry information */
 #include "fsbl.h"
 #include "image_mover.h"	/* For MoveImage */
+#include "fsbl_bootdev.h"
 #include "xparameters.h"
 #include "xil_exception.h"
 #include "xdevcfg.h"
@@ -86,6 +106,9 @@
 #ifdef XPAR_XWDTPS_0_BASEADDR
 #include "xwdtps.h"
 #endif
+#ifdef FSBL_PCAP_INTR
+#include "xscugic.h"
+#endif
 /************************** Constant Definitions *****************************/
 /*
  * The following constants map to the XPAR parameters created in the
@@ -95,25 +118,69 @@
 
 #ifndef SDT
 #define DCFG_DEVICE_ID		XPAR_XDCFG_0_DEVICE_ID
+#define INTC_DEVICE_ID		XPAR_SCUGIC_SINGLE_DEVICE_ID
 #else
 #define DCFG_DEVICE_ID		XPAR_XDEVCFG_0_BASEADDR
+#define INTC_DEVICE_ID		XPAR_XSCUGIC_0_BASEADDR
 #endif
 
+#define DCFG_INTR_ID		XPAR_XDCFG_0_INTR
+
+/*
+ * Devcfg interrupts completing a transfer
+ */
+#define PCAP_INTR_MASK		(XDCFG_IXR_DMA_DONE_MASK | \
+					XDCFG_IXR_PCFG_DONE_MASK | \
+					FSBL_XDCFG_IXR_ERROR_FLAGS_MASK)
+
 /**************************** Type Definitions *******************************/
 
 /***************** Macros (Inline Functions) Definitions *********************/
 
 /************************** Function Prototypes ******************************/
 extern int XDcfgPollDone(u32 MaskValue, u32 MaxCount);
+static u32 PcapWaitChunkDone(void);
+#ifdef FSBL_AES_STREAM
+static u32 PcapDecryptChunk(u32 SourceAddr, u32 SourceLength,
+			u32 DestAddr, u32 DestLength, u32 LastChunk);
+#endif
+#if defined(FSBL_PL_FAST) && !defined(FSBL_PCAP_INTR)
+static u32 PcapPollBackoff(u32 MaskValue);
+#endif
+static u32 PcapIntrGetStatus(void);
+static void PcapIntrClear(u32 Mask);
+#ifdef FSBL_PCAP_INTR
+static int PcapSetupIntr(void);
+static void PcapIntrHandler(void *CallBackRef, u32 IntrStatus);
+#endif
 
 /************************** Variable Definitions *****************************/
 /* Devcfg driver instance */
 static XDcfg DcfgInstance;
 XDcfg *DcfgInstPtr;
 extern u32 Silicon_Version;
+extern ImageMoverType MoveImage;
 #ifdef XPAR_XWDTPS_0_BASEADDR
 extern XWdtPs Watchdog;	/* Instance of WatchDog Timer	*/
 #endif
+#ifdef FSBL_PCAP_INTR
+static XScuGic IntcInstance;
+/* Devcfg interrupt status taken and cleared by the interrupt handler */
+static volatile u32 PcapIntrStatus;
+#endif
+#ifdef FSBL_PERF
+/* Start of the PL partition load */
+static XTime PcapXferStart;
+#endif
+#ifdef FSBL_PL_FAST
+/* Level shifters and PL power checked by an earlier FabricInit() */
+static u8 FabricChecked;
+#endif
+#ifdef FSBL_DCACHE
+/* Destination of the running data transfer, invalidated at its end */
+static u32 PcapDestAddr;
+static u32 PcapDestLength;
+#endif
 
 /******************************************************************************/
 /**
@@ -138,7 +205,42 @@ u32 PcapDataTransfer(u32 *SourceDataPtr, u32 *DestinationDataPtr,
 				u32 SourceLength, u32 DestinationLength, u32 SecureTransfer)
 {
 	u32 Status;
-	u32 IntrStsReg;
+
+	Status = PcapDataTransferStart(SourceDataPtr, DestinationDataPtr,
+					SourceLength, DestinationLength, SecureTransfer);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	return PcapDataTransferWait();
+}
+
+/******************************************************************************/
+/**
+*
+* This function starts a data transfer using PCAP and returns without
+* waiting for it, which PcapDataTransferWait() completes. The CPU is free
+* for other work meanwhile, as long as it does not use the PCAP or the
+* destination of the transfer.
+*
+* @param 	SourceDataPtr is a pointer to where the data is read from
+* @param 	DestinationDataPtr is a pointer to where the data is written to
+* @param 	SourceLength is the length of the data to be moved in words
+* @param 	DestinationLength is the length of the data to be moved in words
+* @param 	SecureTransfer indicated the encryption key location, 0 for
+* 			non-encrypted
+*
+* @return
+*		- XST_SUCCESS if the transfer is started
+*		- XST_FAILURE if the transfer cannot be started
+*
+* @note		 None
+*
+****************************************************************************/
+u32 PcapDataTransferStart(u32 *SourceDataPtr, u32 *DestinationDataPtr,
+				u32 SourceLength, u32 DestinationLength, u32 SecureTransfer)
+{
+	u32 Status;
 	u32 PcapTransferType = XDCFG_CONCURRENT_NONSEC_READ_WRITE;
 
 	/*
@@ -149,8 +251,7 @@ u32 PcapDataTransfer(u32 *SourceDataPtr, u32 *DestinationDataPtr,
 	}
 
 #ifdef FSBL_PERF
-	XTime tXferCur = 0;
-	FsblGetGlobalTime(&tXferCur);
+	FsblGetGlobalTime(&PcapXferStart);
 #endif
 
 	/*
@@ -169,6 +270,17 @@ u32 PcapDataTransfer(u32 *SourceDataPtr, u32 *DestinationDataPtr,
 	XWdtPs_RestartWdt(&Watchdog);
 #endif
 
+	/*
+	 * Write the source out of the data cache, and drop the destination
+	 */
+	FSBL_DCACHE_FLUSH(SourceDataPtr, SourceLength << WORD_LENGTH_SHIFT);
+	FSBL_DCACHE_INVALIDATE(DestinationDataPtr,
+			DestinationLength << WORD_LENGTH_SHIFT);
+#ifdef FSBL_DCACHE
+	PcapDestAddr = (u32)DestinationDataPtr;
+	PcapDestLength = DestinationLength << WORD_LENGTH_SHIFT;
+#endif
+
 	/*
 	 * PCAP single DMA transfer setup
 	 */
@@ -192,6 +304,29 @@ u32 PcapDataTransfer(u32 *SourceDataPtr, u32 *DestinationDataPtr,
 	 */
 	PcapDumpRegisters();
 
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function waits for a data transfer started by PcapDataTransferStart(),
+* on the devcfg interrupt with FSBL_PCAP_INTR.
+*
+* @param 	None
+*
+* @return
+*		- XST_SUCCESS if the transfer is successful
+*		- XST_FAILURE if the transfer fails
+*
+* @note		 None
+*
+****************************************************************************/
+u32 PcapDataTransferWait(void)
+{
+	u32 Status;
+	u32 IntrStsReg;
+
 	/*
 	 * Poll for the DMA done
 	 */
@@ -202,11 +337,11 @@ u32 PcapDataTransfer(u32 *SourceDataPtr, u32 *DestinationDataPtr,
 	}
 
 	fsbl_printf(DEBUG_INFO,"DMA Done ! \n\r");
-		
+
 	/*
 	 * Check for errors
 	 */
-	IntrStsReg = XDcfg_IntrGetStatus(DcfgInstPtr);
+	IntrStsReg = PcapIntrGetStatus();
 	if (IntrStsReg & FSBL_XDCFG_IXR_ERROR_FLAGS_MASK) {
 		fsbl_printf(DEBUG_INFO,"Errors in PCAP \r\n");
 		return XST_FAILURE;
@@ -218,9 +353,14 @@ u32 PcapDataTransfer(u32 *SourceDataPtr, u32 *DestinationDataPtr,
 #ifdef FSBL_PERF
 	XTime tXferEnd = 0;
 	fsbl_printf(DEBUG_GENERAL,"Time taken is ");
-	FsblMeasurePerfTime(tXferCur,tXferEnd);
+	FsblMeasurePerfTime(PcapXferStart,tXferEnd);
 #endif
 
+	/*
+	 * Drop the lines of the destination fetched during the transfer
+	 */
+	FSBL_DCACHE_INVALIDATE(PcapDestAddr, PcapDestLength);
+
 	return XST_SUCCESS;
 }
 
@@ -248,7 +388,47 @@ u32 PcapLoadPartition(u32 *SourceDataPtr, u32 *DestinationDataPtr,
 		u32 SourceLength, u32 DestinationLength, u32 SecureTransfer)
 {
 	u32 Status;
-	u32 IntrStsReg;
+
+	/*
+	 * For Bitstream case destination address will be 0xFFFFFFFF
+	 */
+	(void)DestinationDataPtr;
+
+	Status = PcapLoadPartitionStart(SourceDataPtr, SourceLength,
+					DestinationLength, SecureTransfer);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	return PcapLoadPartitionWait();
+}
+
+/******************************************************************************/
+/**
+*
+* This function starts loading a PL partition using PCAP and returns
+* without waiting for the load, which PcapLoadPartitionWait() completes.
+* The CPU is free for other work meanwhile, as long as it does not use
+* the PCAP.
+*
+* @param 	SourceDataPtr is a pointer to where the data is read from
+* @param 	SourceLength is the length of the data to be moved in words
+* @param 	DestinationLength is the length of the data to be moved in words
+* @param 	SecureTransfer indicated the encryption key location, 0 for
+* 			non-encrypted
+*
+* @return
+*		- XST_SUCCESS if the transfer is started
+*		- XST_FAILURE if the transfer cannot be started
+*
+* @note		 None
+*
+****************************************************************************/
+u32 PcapLoadPartitionStart(u32 *SourceDataPtr, u32 SourceLength,
+		u32 DestinationLength, u32 SecureTransfer)
+{
+	u32 Status;
+	u32 *DestinationDataPtr;
 	u32 PcapTransferType = XDCFG_NON_SECURE_PCAP_WRITE;
 
 	/*
@@ -259,8 +439,7 @@ u32 PcapLoadPartition(u32 *SourceDataPtr, u32 *DestinationDataPtr,
 	}
 
 #ifdef FSBL_PERF
-	XTime tXferCur = 0;
-	FsblGetGlobalTime(&tXferCur);
+	FsblGetGlobalTime(&PcapXferStart);
 #endif
 
 	/*
@@ -294,70 +473,506 @@ u32 PcapLoadPartition(u32 *SourceDataPtr, u32 *DestinationDataPtr,
 #endif
 
 	/*
-	 * PCAP single DMA transfer setup
+	 * Write the bitstream out of the data cache
+	 */
+	FSBL_DCACHE_FLUSH(SourceDataPtr, SourceLength << WORD_LENGTH_SHIFT);
+
+	/*
+	 * PCAP single DMA transfer setup
+	 */
+	SourceDataPtr = (u32*)((u32)SourceDataPtr | PCAP_LAST_TRANSFER);
+	DestinationDataPtr = (u32*)((u32)DestinationDataPtr | PCAP_LAST_TRANSFER);
+
+	/*
+	 * Transfer using Device Configuration
+	 */
+	Status = XDcfg_Transfer(DcfgInstPtr, (u8 *)SourceDataPtr,
+					SourceLength,
+					(u8 *)DestinationDataPtr,
+					DestinationLength, PcapTransferType);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO,"Status of XDcfg_Transfer = %lu \r \n",Status);
+		return XST_FAILURE;
+	}
+
+
+	/*
+	 * Dump the PCAP registers
+	 */
+	PcapDumpRegisters();
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function waits for the load of a PL partition started by
+* PcapLoadPartitionStart(), on the devcfg interrupt with FSBL_PCAP_INTR.
+*
+* @param 	None
+*
+* @return
+*		- XST_SUCCESS if the load is successful
+*		- XST_FAILURE if the load fails
+*
+* @note		 None
+*
+****************************************************************************/
+u32 PcapLoadPartitionWait(void)
+{
+	u32 Status;
+	u32 IntrStsReg;
+
+#if defined(FSBL_PL_FAST) && !defined(FSBL_PCAP_INTR)
+	/*
+	 * Poll for the DMA done and the FPGA done at once, quietly
+	 */
+	Status = PcapPollBackoff(XDCFG_IXR_DMA_DONE_MASK |
+				XDCFG_IXR_PCFG_DONE_MASK);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO,"PCAP_FPGA_DONE_FAIL\r\n");
+		return XST_FAILURE;
+	}
+#else
+	/*
+	 * Poll for the DMA done
+	 */
+	Status = XDcfgPollDone(XDCFG_IXR_DMA_DONE_MASK, MAX_COUNT);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO,"PCAP_DMA_DONE_FAIL \r\n");
+		return XST_FAILURE;
+	}
+
+	fsbl_printf(DEBUG_INFO,"DMA Done ! \n\r");
+
+	/*
+	 * Poll for FPGA Done
+	 */
+	Status = XDcfgPollDone(XDCFG_IXR_PCFG_DONE_MASK, MAX_COUNT);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO,"PCAP_FPGA_DONE_FAIL\r\n");
+		return XST_FAILURE;
+	}
+#endif
+
+	fsbl_printf(DEBUG_INFO,"FPGA Done ! \n\r");
+	
+	/*
+	 * Check for errors
+	 */
+	IntrStsReg = PcapIntrGetStatus();
+	if (IntrStsReg & FSBL_XDCFG_IXR_ERROR_FLAGS_MASK) {
+		fsbl_printf(DEBUG_INFO,"Errors in PCAP \r\n");
+		return XST_FAILURE;
+	}
+
+	/*
+	 * For Performance measurement
+	 */
+#ifdef FSBL_PERF
+	XTime tXferEnd = 0;
+	fsbl_printf(DEBUG_GENERAL,"Time taken is ");
+	FsblMeasurePerfTime(PcapXferStart,tXferEnd);
+#endif
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function streams an unencrypted PL partition from a non-linear boot
+* device to the PCAP. The partition is read in chunks of
+* PCAP_STREAM_CHUNK_WORDS words into a double buffer, and each chunk is
+* queued to the PCAP while the next one is read from the boot device, so
+* that the load takes about as long as the slower of the two. The reads are
+* submitted to the boot device layer, which splits them on the tunables of
+* the device and completes them in the background where the device allows.
+*
+* @param 	SourceAddr is the offset of the partition in the boot device
+* @param 	SourceLength is the length of the partition in words
+* @param 	BufferPtr is the double buffer, 2 * PCAP_STREAM_CHUNK_WORDS
+* 			words of DDR
+*
+* @return
+*		- XST_SUCCESS if the bitstream is loaded
+*		- XST_FAILURE if the read or the transfer fails
+*
+* @note		The data cache is disabled in the FSBL, so the chunks need no
+*			flush before the PCAP reads them.
+*
+****************************************************************************/
+u32 PcapStreamPartition(u32 SourceAddr, u32 SourceLength, u32 *BufferPtr)
+{
+	u32 Status;
+	u32 *ChunkPtr[2];
+	u32 ChunkLength[2];
+	u32 Remaining = SourceLength;
+	u32 Current = 0;
+	u32 Next;
+
+	ChunkPtr[0] = BufferPtr;
+	ChunkPtr[1] = BufferPtr + PCAP_STREAM_CHUNK_WORDS;
+
+	Status = PcapStreamBegin();
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	/*
+	 * First chunk, read ahead of the pipeline
+	 */
+	ChunkLength[0] = (Remaining > PCAP_STREAM_CHUNK_WORDS) ?
+				PCAP_STREAM_CHUNK_WORDS : Remaining;
+	Status = FsblBootDevRead(SourceAddr, (u32)ChunkPtr[0],
+				ChunkLength[0] << WORD_LENGTH_SHIFT);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL, "Move Image Failed\r\n");
+		return XST_FAILURE;
+	}
+	SourceAddr += ChunkLength[0] << WORD_LENGTH_SHIFT;
+	Remaining -= ChunkLength[0];
+
+	while (1) {
+		Status = PcapStreamChunk(ChunkPtr[Current], ChunkLength[Current],
+					(Remaining == 0));
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		if (Remaining == 0) {
+			break;
+		}
+
+		/*
+		 * Read the next chunk while the PCAP takes this one
+		 */
+		Next = Current ^ 1;
+		ChunkLength[Next] = (Remaining > PCAP_STREAM_CHUNK_WORDS) ?
+					PCAP_STREAM_CHUNK_WORDS : Remaining;
+		Status = FsblBootDevSubmit(SourceAddr, (u32)ChunkPtr[Next],
+					ChunkLength[Next] << WORD_LENGTH_SHIFT);
+		if (FsblBootDevWait() != XST_SUCCESS) {
+			Status = XST_FAILURE;
+		}
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL, "Move Image Failed\r\n");
+			return XST_FAILURE;
+		}
+		SourceAddr += ChunkLength[Next] << WORD_LENGTH_SHIFT;
+		Remaining -= ChunkLength[Next];
+
+		/*
+		 * This buffer is refilled after the next chunk, so the PCAP
+		 * must be done with it
+		 */
+		Status = PcapStreamChunkWait();
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		Current = Next;
+	}
+
+	return PcapLoadPartitionWait();
+}
+
+#ifdef FSBL_AES_STREAM
+/******************************************************************************/
+/**
+*
+* This function decrypts an encrypted PS partition of a non-linear boot
+* device while it is read. The partition is read in place at its load
+* address, as for DecryptPartition(), but in chunks of
+* PCAP_STREAM_CHUNK_WORDS words, and each chunk is queued to the AES engine
+* of the PCAP while the next one is read from the boot device, so that the
+* load takes about as long as the slower of the two.
+*
+* The chunks are DMA commands of one overall transfer. The decrypted data
+* is shorter than the encrypted one by the header and the HMAC; the
+* destination of the first command is shorter by all of it, the others
+* write as many words as they read, so that no command waits on the source
+* of the next. The output never overtakes the input, so the decrypted data
+* only overwrites chunks already taken by the PCAP.
+*
+* @param 	SourceAddr is the offset of the partition in the boot device
+* @param 	LoadAddr is the load address of the partition
+* @param 	SourceLength is the encrypted length in words
+* @param 	DestinationLength is the decrypted length in words
+*
+* @return
+*		- XST_SUCCESS if the partition is decrypted
+*		- XST_INVALID_PARAM if it is not longer than a chunk, or its
+*		  header and HMAC do not fit in one, and it is left to
+*		  DecryptPartition()
+*		- XST_FAILURE if the read or the transfer fails
+*
+* @note		The fabric must be initialized, as for any secure transfer.
+*
+****************************************************************************/
+u32 PcapStreamDecrypt(u32 SourceAddr, u32 LoadAddr, u32 SourceLength,
+			u32 DestinationLength)
+{
+	u32 Status;
+	u32 Offset = 0;
+	u32 DestOffset = 0;
+	u32 ChunkLength;
+	u32 DestChunkLength;
+	u32 NextLength;
+
+	if ((SourceLength <= PCAP_STREAM_CHUNK_WORDS) ||
+			(DestinationLength >= SourceLength) ||
+			((SourceLength - DestinationLength) >=
+				PCAP_STREAM_CHUNK_WORDS)) {
+		return XST_INVALID_PARAM;
+	}
+
+	Status = ClearPcapStatus();
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO,"PCAP_CLEAR_STATUS_FAIL \r\n");
+		return XST_FAILURE;
+	}
+
+#ifdef FSBL_PERF
+	FsblGetGlobalTime(&PcapXferStart);
+#endif
+#ifdef FSBL_DCACHE
+	PcapDestAddr = LoadAddr;
+	PcapDestLength = DestinationLength << WORD_LENGTH_SHIFT;
+#endif
+
+	/*
+	 * First chunk, read ahead of the pipeline
+	 */
+	ChunkLength = PCAP_STREAM_CHUNK_WORDS;
+	Status = FsblBootDevRead(SourceAddr, LoadAddr,
+				ChunkLength << WORD_LENGTH_SHIFT);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL, "Move Image Failed\r\n");
+		return XST_FAILURE;
+	}
+	DestChunkLength = ChunkLength - (SourceLength - DestinationLength);
+
+	while (1) {
+		Status = PcapDecryptChunk(LoadAddr + (Offset << WORD_LENGTH_SHIFT),
+				ChunkLength,
+				LoadAddr + (DestOffset << WORD_LENGTH_SHIFT),
+				DestChunkLength,
+				((Offset + ChunkLength) == SourceLength));
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		Offset += ChunkLength;
+		DestOffset += DestChunkLength;
+		if (Offset == SourceLength) {
+			break;
+		}
+
+		/*
+		 * Read the next chunk behind the one the PCAP takes
+		 */
+		NextLength = SourceLength - Offset;
+		if (NextLength > PCAP_STREAM_CHUNK_WORDS) {
+			NextLength = PCAP_STREAM_CHUNK_WORDS;
+		}
+		Status = FsblBootDevSubmit(SourceAddr + (Offset << WORD_LENGTH_SHIFT),
+				LoadAddr + (Offset << WORD_LENGTH_SHIFT),
+				NextLength << WORD_LENGTH_SHIFT);
+		if (FsblBootDevWait() != XST_SUCCESS) {
+			Status = XST_FAILURE;
+		}
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL, "Move Image Failed\r\n");
+			return XST_FAILURE;
+		}
+
+		Status = PcapStreamChunkWait();
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		ChunkLength = NextLength;
+		DestChunkLength = NextLength;
+	}
+
+	return PcapDataTransferWait();
+}
+
+/******************************************************************************/
+/**
+*
+* This function queues a chunk of an encrypted partition to the AES engine
+* of the PCAP, as a command of a concurrent secure transfer.
+*
+* @param	SourceAddr is the address of the encrypted chunk
+* @param	SourceLength is its length in words
+* @param	DestAddr is where its decrypted data goes
+* @param	DestLength is the length of the decrypted data in words
+* @param	LastChunk is 1 for the last chunk of the partition
+*
+* @return
+*		- XST_SUCCESS if the chunk is queued
+*		- XST_FAILURE otherwise
+*
+* @note		The chunk is flushed from the data cache and its destination
+*		invalidated with FSBL_DCACHE.
+*
+****************************************************************************/
+static u32 PcapDecryptChunk(u32 SourceAddr, u32 SourceLength,
+			u32 DestAddr, u32 DestLength, u32 LastChunk)
+{
+	u32 Status;
+
+#ifdef	XPAR_XWDTPS_0_BASEADDR
+	/*
+	 * Prevent WDT reset
+	 */
+	XWdtPs_RestartWdt(&Watchdog);
+#endif
+
+	FSBL_DCACHE_FLUSH(SourceAddr, SourceLength << WORD_LENGTH_SHIFT);
+	FSBL_DCACHE_INVALIDATE(DestAddr, DestLength << WORD_LENGTH_SHIFT);
+
+	if (LastChunk) {
+		SourceAddr |= PCAP_LAST_TRANSFER;
+		DestAddr |= PCAP_LAST_TRANSFER;
+	}
+
+	Status = XDcfg_Transfer(DcfgInstPtr, (u8 *)SourceAddr, SourceLength,
+				(u8 *)DestAddr, DestLength,
+				XDCFG_CONCURRENT_SECURE_READ_WRITE);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO,"Status of XDcfg_Transfer = %lu \r \n",Status);
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+#endif
+
+/******************************************************************************/
+/**
+*
+* This function starts a bitstream load in chunks, each queued to the PCAP
+* with PcapStreamChunk(). The load ends with PcapLoadPartitionWait() after
+* the last chunk.
+*
+* @param	none
+*
+* @return
+*		- XST_SUCCESS if the PL is ready for the bitstream
+*		- XST_FAILURE otherwise
+*
+* @note		none
+*
+****************************************************************************/
+u32 PcapStreamBegin(void)
+{
+	u32 Status;
+
+#ifdef FSBL_PERF
+	FsblGetGlobalTime(&PcapXferStart);
+#endif
+
+	/*
+	 * Clear the PCAP status registers
+	 */
+	Status = ClearPcapStatus();
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO,"PCAP_CLEAR_STATUS_FAIL \r\n");
+		return XST_FAILURE;
+	}
+
+	/*
+	 * New Bitstream download initialization sequence
+	 */
+	return FabricInit();
+}
+
+/******************************************************************************/
+/**
+*
+* This function queues a chunk of a bitstream to the PCAP. One chunk is in
+* flight at a time, the previous one must be waited for with
+* PcapStreamChunkWait(), and the last one with PcapLoadPartitionWait().
+*
+* @param	ChunkPtr is the chunk, in DDR or OCM
+* @param	ChunkLength is the length of the chunk in words
+* @param	LastChunk is 1 for the last chunk of the bitstream
+*
+* @return
+*		- XST_SUCCESS if the chunk is queued
+*		- XST_FAILURE otherwise
+*
+* @note		The chunk is flushed from the data cache with FSBL_DCACHE,
+*			before the PCAP reads it.
+*
+****************************************************************************/
+u32 PcapStreamChunk(u32 *ChunkPtr, u32 ChunkLength, u32 LastChunk)
+{
+	u32 Status;
+	u32 TransferAddr;
+	u32 DestAddr;
+
+#ifdef	XPAR_XWDTPS_0_BASEADDR
+	/*
+	 * Prevent WDT reset
+	 */
+	XWdtPs_RestartWdt(&Watchdog);
+#endif
+
+	/*
+	 * For Bitstream case destination address will be 0xFFFFFFFF,
+	 * the last chunk is marked as the end of the transfer
 	 */
-	SourceDataPtr = (u32*)((u32)SourceDataPtr | PCAP_LAST_TRANSFER);
-	DestinationDataPtr = (u32*)((u32)DestinationDataPtr | PCAP_LAST_TRANSFER);
+	FSBL_DCACHE_FLUSH(ChunkPtr, ChunkLength << WORD_LENGTH_SHIFT);
 
-	/*
-	 * Transfer using Device Configuration
-	 */
-	Status = XDcfg_Transfer(DcfgInstPtr, (u8 *)SourceDataPtr,
-					SourceLength,
-					(u8 *)DestinationDataPtr,
-					DestinationLength, PcapTransferType);
+	TransferAddr = (u32)ChunkPtr;
+	DestAddr = XDCFG_DMA_INVALID_ADDRESS;
+	if (LastChunk) {
+		TransferAddr |= PCAP_LAST_TRANSFER;
+		DestAddr |= PCAP_LAST_TRANSFER;
+	}
+
+	Status = XDcfg_Transfer(DcfgInstPtr, (u8 *)TransferAddr,
+				ChunkLength, (u8 *)DestAddr,
+				ChunkLength,
+				XDCFG_NON_SECURE_PCAP_WRITE);
 	if (Status != XST_SUCCESS) {
 		fsbl_printf(DEBUG_INFO,"Status of XDcfg_Transfer = %lu \r \n",Status);
 		return XST_FAILURE;
 	}
 
+	return XST_SUCCESS;
+}
 
-	/*
-	 * Dump the PCAP registers
-	 */
-	PcapDumpRegisters();
-
+/******************************************************************************/
+/**
+*
+* This function waits for the PCAP to be done with a chunk queued with
+* PcapStreamChunk(), other than the last one.
+*
+* @param	none
+*
+* @return
+*		- XST_SUCCESS if the chunk is done
+*		- XST_FAILURE if the PCAP reports an error or times out
+*
+* @note		none
+*
+****************************************************************************/
+u32 PcapStreamChunkWait(void)
+{
+	u32 Status;
 
-	/*
-	 * Poll for the DMA done
-	 */
-	Status = XDcfgPollDone(XDCFG_IXR_DMA_DONE_MASK, MAX_COUNT);
+	Status = PcapWaitChunkDone();
 	if (Status != XST_SUCCESS) {
 		fsbl_printf(DEBUG_INFO,"PCAP_DMA_DONE_FAIL \r\n");
 		return XST_FAILURE;
 	}
 
-	fsbl_printf(DEBUG_INFO,"DMA Done ! \n\r");
-
-	/*
-	 * Poll for FPGA Done
-	 */
-	Status = XDcfgPollDone(XDCFG_IXR_PCFG_DONE_MASK, MAX_COUNT);
-	if (Status != XST_SUCCESS) {
-		fsbl_printf(DEBUG_INFO,"PCAP_FPGA_DONE_FAIL\r\n");
-		return XST_FAILURE;
-	}
-
-	fsbl_printf(DEBUG_INFO,"FPGA Done ! \n\r");
-	
-	/*
-	 * Check for errors
-	 */
-	IntrStsReg = XDcfg_IntrGetStatus(DcfgInstPtr);
-	if (IntrStsReg & FSBL_XDCFG_IXR_ERROR_FLAGS_MASK) {
-		fsbl_printf(DEBUG_INFO,"Errors in PCAP \r\n");
-		return XST_FAILURE;
-	}
-
-	/*
-	 * For Performance measurement
-	 */
-#ifdef FSBL_PERF
-	XTime tXferEnd = 0;
-	fsbl_printf(DEBUG_GENERAL,"Time taken is ");
-	FsblMeasurePerfTime(tXferCur,tXferEnd);
-#endif
-
 	return XST_SUCCESS;
 }
 
@@ -393,6 +1008,14 @@ int InitPcap(void)
 		return XST_FAILURE;
 	}
 
+#ifdef FSBL_PCAP_INTR
+	Status = PcapSetupIntr();
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO, "PCAP interrupt setup failed \n\r");
+		return XST_FAILURE;
+	}
+#endif
+
 	return XST_SUCCESS;
 }
 /******************************************************************************/
@@ -420,6 +1043,13 @@ u32 FabricInit(void)
 	XTime tEnd=0;
 
 
+#ifdef FSBL_PL_FAST
+	/*
+	 * The level shifters and the PL power are checked once, they stay
+	 * as they are across the loads
+	 */
+	if (!FabricChecked) {
+#endif
 	/*
 	 * Set Level Shifters DT618760 - PS to PL enabling
 	 */
@@ -427,12 +1057,6 @@ u32 FabricInit(void)
 	fsbl_printf(DEBUG_INFO,"Level Shifter Value = 0x%lx \r\n",
 				Xil_In32(PS_LVL_SHFTR_EN));
 
-	/*
-	 * Get DEVCFG controller settings
-	 */
-	PcapReg = XDcfg_ReadReg(DcfgInstPtr->Config.BaseAddr,
-				XDCFG_CTRL_OFFSET);
-
 	/*
 	 * Check the PL power status
 	 */
@@ -447,6 +1071,16 @@ u32 FabricInit(void)
 			return XST_FAILURE;
 		}
 	}
+#ifdef FSBL_PL_FAST
+		FabricChecked = 1;
+	}
+#endif
+
+	/*
+	 * Get DEVCFG controller settings
+	 */
+	PcapReg = XDcfg_ReadReg(DcfgInstPtr->Config.BaseAddr,
+				XDCFG_CTRL_OFFSET);
 
 
 	/*
@@ -620,12 +1254,12 @@ u32 ClearPcapStatus(void)
 	/*
 	 * Clear it all, so if Boot ROM comes back, it can proceed
 	 */
-	XDcfg_IntrClear(DcfgInstPtr, 0xFFFFFFFF);
+	PcapIntrClear(0xFFFFFFFF);
 
 	/*
 	 * Get PCAP Interrupt Status Register
 	 */
-	IntStatusReg = XDcfg_IntrGetStatus(DcfgInstPtr);
+	IntStatusReg = PcapIntrGetStatus();
 	if (IntStatusReg & FSBL_XDCFG_IXR_ERROR_FLAGS_MASK) {
 		fsbl_printf(DEBUG_INFO,"FATAL errors in PCAP %lx\r\n",
 				IntStatusReg);
@@ -657,7 +1291,7 @@ u32 ClearPcapStatus(void)
 	if ((StatusReg & XDCFG_STATUS_DMA_CMD_Q_E_MASK) !=
 			XDCFG_STATUS_DMA_CMD_Q_E_MASK) {
 
-		IntStatusReg = XDcfg_IntrGetStatus(DcfgInstPtr);
+		IntStatusReg = PcapIntrGetStatus();
 
 		if ((IntStatusReg & XDCFG_IXR_DMA_DONE_MASK) !=
 				XDCFG_IXR_DMA_DONE_MASK){
@@ -671,7 +1305,7 @@ u32 ClearPcapStatus(void)
 			/*
 			 * clear out the status
 			 */
-			XDcfg_IntrClear(DcfgInstPtr, XDCFG_IXR_DMA_DONE_MASK);
+			PcapIntrClear(XDCFG_IXR_DMA_DONE_MASK);
 		}
 	}
 
@@ -764,16 +1398,45 @@ void PcapDumpRegisters (void) {
 ****************************************************************************/
 int XDcfgPollDone(u32 MaskValue, u32 MaxCount)
 {
+#ifdef FSBL_PCAP_INTR
+	XTime tCur = 0;
+	XTime tEnd = 0;
+
+	/*
+	 * wait for the interrupt handler to see the DMA done
+	 */
+	(void)MaxCount;
+	XTime_GetTime(&tCur);
+	while ((PcapIntrStatus & MaskValue) != MaskValue) {
+		if (PcapIntrStatus & FSBL_XDCFG_IXR_ERROR_FLAGS_MASK) {
+			fsbl_printf(DEBUG_INFO,"FATAL errors in PCAP %lx\r\n",
+					PcapIntrStatus);
+			PcapDumpRegisters();
+			return XST_FAILURE;
+		}
+
+		XTime_GetTime(&tEnd);
+		if ((u64)tEnd > ((u64)tCur +
+				((u64)COUNTS_PER_MILLI_SECOND * PCAP_INTR_TIMEOUT_MS))) {
+			fsbl_printf(DEBUG_GENERAL,"PCAP transfer timed out \r\n");
+			return XST_FAILURE;
+		}
+	}
+
+	PcapIntrClear(MaskValue);
+
+	return XST_SUCCESS;
+#else
 	int Count = MaxCount;
 	u32 IntrStsReg = 0;
 
 	/*
 	 * poll for the DMA done
 	 */
-	IntrStsReg = XDcfg_IntrGetStatus(DcfgInstPtr);
+	IntrStsReg = PcapIntrGetStatus();
 	while ((IntrStsReg & MaskValue) !=
 				MaskValue) {
-		IntrStsReg = XDcfg_IntrGetStatus(DcfgInstPtr);
+		IntrStsReg = PcapIntrGetStatus();
 		Count -=1;
 
 		if (IntrStsReg & FSBL_XDCFG_IXR_ERROR_FLAGS_MASK) {
@@ -794,7 +1457,253 @@ int XDcfgPollDone(u32 MaskValue, u32 MaxCount)
 
 	fsbl_printf(DEBUG_GENERAL,"\n\r");
 
-	XDcfg_IntrClear(DcfgInstPtr, IntrStsReg & MaskValue);
+	PcapIntrClear(IntrStsReg & MaskValue);
+
+	return XST_SUCCESS;
+#endif
+}
+
+/******************************************************************************/
+/**
+*
+* This function polls for the DMA done of an intermediate transfer of
+* a streamed bitstream, without the progress output of XDcfgPollDone().
+*
+* @param	none
+*
+* @return
+*		- XST_SUCCESS if the DMA command is done
+*		- XST_FAILURE if the PCAP reports an error or times out
+*
+* @note		none
+*
+****************************************************************************/
+static u32 PcapWaitChunkDone(void)
+{
+	u32 Count = MAX_COUNT;
+	u32 IntrStsReg;
+
+	IntrStsReg = PcapIntrGetStatus();
+	while ((IntrStsReg & XDCFG_IXR_DMA_DONE_MASK) == 0) {
+		if (IntrStsReg & FSBL_XDCFG_IXR_ERROR_FLAGS_MASK) {
+			fsbl_printf(DEBUG_INFO,"FATAL errors in PCAP %lx\r\n",
+					IntrStsReg);
+			PcapDumpRegisters();
+			return XST_FAILURE;
+		}
+
+		Count -= 1;
+		if (!Count) {
+			fsbl_printf(DEBUG_GENERAL,"PCAP transfer timed out \r\n");
+			return XST_FAILURE;
+		}
+		IntrStsReg = PcapIntrGetStatus();
+	}
+
+	PcapIntrClear(XDCFG_IXR_DMA_DONE_MASK);
+
+	return XST_SUCCESS;
+}
+
+#if defined(FSBL_PL_FAST) && !defined(FSBL_PCAP_INTR)
+/******************************************************************************/
+/**
+*
+* This function polls for the end of a PL load without the progress output
+* of XDcfgPollDone(). The sleep between two polls doubles from 1 us up to
+* PCAP_POLL_MAX_DELAY_US, so that a load ending soon is seen at once and a
+* long one is not polled in a tight loop.
+*
+* @param	MaskValue is the interrupt status bits to wait for
+*
+* @return
+*		- XST_SUCCESS if all the bits are set
+*		- XST_FAILURE if the PCAP reports an error or does not end
+*		  within PCAP_INTR_TIMEOUT_MS
+*
+* @note		none
+*
+****************************************************************************/
+static u32 PcapPollBackoff(u32 MaskValue)
+{
+	u32 IntrStsReg;
+	u32 Delay = 1;
+	XTime tCur = 0;
+	XTime tEnd = 0;
+
+	XTime_GetTime(&tCur);
+	IntrStsReg = PcapIntrGetStatus();
+	while ((IntrStsReg & MaskValue) != MaskValue) {
+		if (IntrStsReg & FSBL_XDCFG_IXR_ERROR_FLAGS_MASK) {
+			fsbl_printf(DEBUG_INFO,"FATAL errors in PCAP %lx\r\n",
+					IntrStsReg);
+			PcapDumpRegisters();
+			return XST_FAILURE;
+		}
+
+		XTime_GetTime(&tEnd);
+		if ((u64)tEnd > ((u64)tCur +
+				((u64)COUNTS_PER_MILLI_SECOND * PCAP_INTR_TIMEOUT_MS))) {
+			fsbl_printf(DEBUG_GENERAL,"PCAP transfer timed out \r\n");
+			return XST_FAILURE;
+		}
+
+		usleep(Delay);
+		if (Delay < PCAP_POLL_MAX_DELAY_US) {
+			Delay <<= 1;
+		}
+		IntrStsReg = PcapIntrGetStatus();
+	}
+
+	PcapIntrClear(IntrStsReg & MaskValue);
+
+	return XST_SUCCESS;
+}
+#endif
+
+/******************************************************************************/
+/**
+*
+* This function reads the devcfg interrupt status, including the events
+* the interrupt handler has already taken with FSBL_PCAP_INTR.
+*
+* @param	none
+*
+* @return	The interrupt status
+*
+* @note		none
+*
+****************************************************************************/
+static u32 PcapIntrGetStatus(void)
+{
+#ifdef FSBL_PCAP_INTR
+	return XDcfg_IntrGetStatus(DcfgInstPtr) | PcapIntrStatus;
+#else
+	return XDcfg_IntrGetStatus(DcfgInstPtr);
+#endif
+}
+
+/******************************************************************************/
+/**
+*
+* This function clears devcfg interrupt events, in the register and in
+* the events taken by the interrupt handler with FSBL_PCAP_INTR.
+*
+* @param	Mask is the events to clear
+*
+* @return	none
+*
+* @note		none
+*
+****************************************************************************/
+static void PcapIntrClear(u32 Mask)
+{
+#ifdef FSBL_PCAP_INTR
+	Xil_ExceptionDisableMask(XIL_EXCEPTION_IRQ);
+	PcapIntrStatus &= ~Mask;
+	XDcfg_IntrClear(DcfgInstPtr, Mask);
+	Xil_ExceptionEnableMask(XIL_EXCEPTION_IRQ);
+#else
+	XDcfg_IntrClear(DcfgInstPtr, Mask);
+#endif
+}
+
+/******************************************************************************/
+/**
+*
+* This function masks the devcfg interrupt before the handoff, so that the
+* application starts with the interrupt controller as the boot ROM left it.
+*
+* @param	none
+*
+* @return	none
+*
+* @note		It does nothing without FSBL_PCAP_INTR.
+*
+****************************************************************************/
+void PcapShutdownIntr(void)
+{
+#ifdef FSBL_PCAP_INTR
+	Xil_ExceptionDisableMask(XIL_EXCEPTION_IRQ);
+	XDcfg_IntrDisable(DcfgInstPtr, PCAP_INTR_MASK);
+	XScuGic_Disable(&IntcInstance, DCFG_INTR_ID);
+	XScuGic_Disconnect(&IntcInstance, DCFG_INTR_ID);
+#endif
+}
+
+#ifdef FSBL_PCAP_INTR
+/******************************************************************************/
+/**
+*
+* This function connects the devcfg interrupt to the GIC and enables the
+* transfer completion events. The IRQ exception then goes to the GIC
+* handler instead of the FSBL lockdown.
+*
+* @param	none
+*
+* @return
+*		- XST_SUCCESS if the interrupt is set up
+*		- XST_FAILURE if the GIC cannot be initialized
+*
+* @note		none
+*
+****************************************************************************/
+static int PcapSetupIntr(void)
+{
+	XScuGic_Config *IntcConfigPtr;
+	int Status;
+
+	IntcConfigPtr = XScuGic_LookupConfig(INTC_DEVICE_ID);
+	if (IntcConfigPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	Status = XScuGic_CfgInitialize(&IntcInstance, IntcConfigPtr,
+					IntcConfigPtr->CpuBaseAddress);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_IRQ_INT,
+			(Xil_ExceptionHandler)XScuGic_InterruptHandler,
+			&IntcInstance);
+
+	XDcfg_SetHandler(DcfgInstPtr, (void *)PcapIntrHandler, DcfgInstPtr);
+
+	Status = XScuGic_Connect(&IntcInstance, DCFG_INTR_ID,
+			(Xil_InterruptHandler)XDcfg_InterruptHandler,
+			DcfgInstPtr);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	PcapIntrStatus = 0;
+	XDcfg_IntrClear(DcfgInstPtr, PCAP_INTR_MASK);
+	XDcfg_IntrEnable(DcfgInstPtr, PCAP_INTR_MASK);
+	XScuGic_Enable(&IntcInstance, DCFG_INTR_ID);
+	Xil_ExceptionEnableMask(XIL_EXCEPTION_IRQ);
 
 	return XST_SUCCESS;
 }
+
+/******************************************************************************/
+/**
+*
+* This function is the devcfg event handler. XDcfg_InterruptHandler() has
+* cleared the events in the register, they are kept for the waiters.
+*
+* @param	CallBackRef is the devcfg instance
+* @param	IntrStatus is the interrupt status
+*
+* @return	none
+*
+* @note		none
+*
+****************************************************************************/
+static void PcapIntrHandler(void *CallBackRef, u32 IntrStatus)
+{
+	(void)CallBackRef;
+
+	PcapIntrStatus |= IntrStatus;
+}
+#endif
@@ -24,6 +24,12 @@
 * 						the PL power before sequence starts and checking INIT_B
 * 						reset status twice in case of failure.
 * 21.2  ng 07/13/23  Add SDT support
+* 21.3  qm 10/14/26  Added PcapStreamPartition() and the interrupt driven
+*                    completion of FSBL_PCAP_INTR
+*                    Added PcapDataTransferStart()
+*                    Added PcapStreamBegin(), PcapStreamChunk() and
+*                    PcapStreamChunkWait()
+*                    Added PcapStreamDecrypt() of FSBL_AES_STREAM
 * </pre>
 *
 * @note
@@ -56,6 +62,18 @@ extern "C" {
 #define COUNTS_PER_MILLI_SECOND (COUNTS_PER_SECOND/1000)
 
 #define PCAP_LAST_TRANSFER 1
+/* Longest wait for a PCAP completion interrupt, FSBL_PCAP_INTR only */
+#define PCAP_INTR_TIMEOUT_MS 10000
+
+/*
+ * Longest sleep between two polls of the PCAP done, FSBL_PL_FAST only. The
+ * sleep doubles from 1 us up to it.
+ */
+#define PCAP_POLL_MAX_DELAY_US	16
+/* Bitstream chunk streamed from a non-linear boot device, in words */
+#ifndef PCAP_STREAM_CHUNK_WORDS
+#define PCAP_STREAM_CHUNK_WORDS 0x4000
+#endif
 #define MAX_COUNT 1000000000
 #define LVL_PL_PS 0x0000000F
 #define LVL_PS_PL 0x0000000A
@@ -77,8 +95,23 @@ u32 FabricInit(void);
 int XDcfgPollDone(u32 MaskValue, u32 MaxCount);
 u32 PcapLoadPartition(u32 *SourceData, u32 *DestinationData, u32 SourceLength,
 		 	u32 DestinationLength, u32 Flags);
+u32 PcapLoadPartitionStart(u32 *SourceData, u32 SourceLength,
+			u32 DestinationLength, u32 Flags);
+u32 PcapLoadPartitionWait(void);
+void PcapShutdownIntr(void);
 u32 PcapDataTransfer(u32 *SourceData, u32 *DestinationData, u32 SourceLength,
  			u32 DestinationLength, u32 Flags);
+u32 PcapDataTransferStart(u32 *SourceData, u32 *DestinationData,
+			u32 SourceLength, u32 DestinationLength, u32 Flags);
+u32 PcapDataTransferWait(void);
+u32 PcapStreamPartition(u32 SourceAddr, u32 SourceLength, u32 *BufferPtr);
+u32 PcapStreamBegin(void);
+u32 PcapStreamChunk(u32 *ChunkPtr, u32 ChunkLength, u32 LastChunk);
+u32 PcapStreamChunkWait(void);
+#ifdef FSBL_AES_STREAM
+u32 PcapStreamDecrypt(u32 SourceAddr, u32 LoadAddr, u32 SourceLength,
+			u32 DestinationLength);
+#endif
 /************************** Variable Definitions *****************************/
 #ifdef __cplusplus
 }
@@ -0,0 +1,247 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file ps7_pack.c
+*
+* Contains the replay of the packed ps7_init tables of FSBL_PS7_PACK, see
+* ps7_pack.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "fsbl.h"
+#include "ps7_init.h"
+#include "ps7_pack.h"
+
+#ifdef FSBL_PS7_PACK
+#include "xil_io.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Reads of a poll before PS7_INIT_TIMEOUT, PS7_MASK_POLL_TIME of ps7_init.c
+ */
+#define PS7_PACK_POLL_COUNT		100000000U
+
+/************************** Function Prototypes ******************************/
+
+extern unsigned long ps7GetSiliconVersion(void);
+
+/*****************************************************************************/
+/**
+*
+* This function replays a packed table, as ps7_config() does an EMIT_*
+* table.
+*
+* @param	Table is the packed table
+*
+* @return
+*		- PS7_INIT_SUCCESS when the table is done
+*		- PS7_INIT_TIMEOUT if a poll did not see its bits
+*		- PS7_INIT_CORRUPT for an unknown operation
+*
+* @note		None.
+*
+******************************************************************************/
+int Ps7Pack_Replay(const u32 *Table)
+{
+	const u32 *Ptr = Table;
+	u32 Header;
+	u32 Count;
+	u32 Addr;
+	u32 Mask;
+	u32 Value;
+	u32 Delay;
+	u32 Index;
+
+	for (;;) {
+		Header = *Ptr++;
+		Count = Header & PS7_PACK_COUNT_MASK;
+
+		switch (Header >> PS7_PACK_OP_SHIFT) {
+		case PS7_PACK_OP_EXIT:
+			return PS7_INIT_SUCCESS;
+
+		case PS7_PACK_OP_WRITE:
+			Addr = *Ptr++;
+			while (Count-- != 0U) {
+				Xil_Out32(Addr, *Ptr++);
+				Addr += 4U;
+			}
+			break;
+
+		case PS7_PACK_OP_MASKWRITE:
+			Addr = *Ptr++;
+			while (Count-- != 0U) {
+				Mask = Ptr[0];
+				Value = Ptr[1];
+				Ptr += 2;
+				Xil_Out32(Addr, (Xil_In32(Addr) & ~Mask) | Value);
+				Addr += 4U;
+			}
+			break;
+
+		case PS7_PACK_OP_MASKPOLL:
+			Addr = Ptr[0];
+			Mask = Ptr[1];
+			Ptr += 2;
+			for (Index = 0U; (Xil_In32(Addr) & Mask) == 0U; Index++) {
+				if (Index == PS7_PACK_POLL_COUNT) {
+					return PS7_INIT_TIMEOUT;
+				}
+			}
+			break;
+
+		case PS7_PACK_OP_MASKDELAY:
+			Addr = Ptr[0];
+			Delay = (u32)get_number_of_cycles_for_delay(Ptr[1]);
+			Ptr += 2;
+			perf_reset_and_start_timer();
+			while (Xil_In32(Addr) < Delay) {
+				;
+			}
+			break;
+
+		default:
+			return PS7_INIT_CORRUPT;
+		}
+	}
+}
+
+/*****************************************************************************/
+/**
+*
+* This function initializes the MIO, the PLLs, the clocks, the DDR and the
+* peripherals from the packed tables of the silicon version, as ps7_init()
+* does.
+*
+* @param	None.
+*
+* @return	PS7_INIT_SUCCESS, or the code of the table that failed
+*
+* @note		None.
+*
+******************************************************************************/
+int Ps7Pack_Init(void)
+{
+	unsigned long SiVer = ps7GetSiliconVersion();
+	u32 *Tables[5];
+	u32 Index;
+	int Status;
+
+	if (SiVer == PCW_SILICON_VERSION_1) {
+		Tables[0] = ps7_mio_init_data_1_0_pack;
+		Tables[1] = ps7_pll_init_data_1_0_pack;
+		Tables[2] = ps7_clock_init_data_1_0_pack;
+		Tables[3] = ps7_ddr_init_data_1_0_pack;
+		Tables[4] = ps7_peripherals_init_data_1_0_pack;
+	} else if (SiVer == PCW_SILICON_VERSION_2) {
+		Tables[0] = ps7_mio_init_data_2_0_pack;
+		Tables[1] = ps7_pll_init_data_2_0_pack;
+		Tables[2] = ps7_clock_init_data_2_0_pack;
+		Tables[3] = ps7_ddr_init_data_2_0_pack;
+		Tables[4] = ps7_peripherals_init_data_2_0_pack;
+	} else {
+		Tables[0] = ps7_mio_init_data_3_0_pack;
+		Tables[1] = ps7_pll_init_data_3_0_pack;
+		Tables[2] = ps7_clock_init_data_3_0_pack;
+		Tables[3] = ps7_ddr_init_data_3_0_pack;
+		Tables[4] = ps7_peripherals_init_data_3_0_pack;
+	}
+
+	for (Index = 0U; Index < 5U; Index++) {
+		Status = Ps7Pack_Replay(Tables[Index]);
+		if (Status != PS7_INIT_SUCCESS) {
+			return Status;
+		}
+	}
+
+	return PS7_INIT_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function replays the post configuration table of the silicon
+* version, as ps7_post_config() does.
+*
+* @param	None.
+*
+* @return	The code of Ps7Pack_Replay()
+*
+* @note		None.
+*
+******************************************************************************/
+int Ps7Pack_PostConfig(void)
+{
+	unsigned long SiVer = ps7GetSiliconVersion();
+
+	if (SiVer == PCW_SILICON_VERSION_1) {
+		return Ps7Pack_Replay(ps7_post_config_1_0_pack);
+	} else if (SiVer == PCW_SILICON_VERSION_2) {
+		return Ps7Pack_Replay(ps7_post_config_2_0_pack);
+	} else {
+		return Ps7Pack_Replay(ps7_post_config_3_0_pack);
+	}
+}
+
+/*****************************************************************************/
+/**
+*
+* This function ends a packed table before its last entry when that entry
+* is a poll of Addr, the packed form of DDRDeferInitPoll() of main.c.
+*
+* @param	Table is the packed table to change
+* @param	Addr is the address of the poll
+*
+* @return	None.
+*
+* @note		The tables are data in OCM, a reset reloads them.
+*
+******************************************************************************/
+void Ps7Pack_DeferPoll(u32 *Table, u32 Addr)
+{
+	u32 *Ptr = Table;
+	u32 *LastPoll = NULL;
+	u32 Op;
+	u32 Count;
+
+	while ((Op = (Ptr[0] >> PS7_PACK_OP_SHIFT)) != PS7_PACK_OP_EXIT) {
+		Count = Ptr[0] & PS7_PACK_COUNT_MASK;
+		if ((Op == PS7_PACK_OP_MASKPOLL) && (Ptr[1] == Addr)) {
+			LastPoll = Ptr;
+		} else {
+			LastPoll = NULL;
+		}
+
+		if (Op == PS7_PACK_OP_WRITE) {
+			Ptr += Count + 2U;
+		} else if (Op == PS7_PACK_OP_MASKWRITE) {
+			Ptr += (2U * Count) + 2U;
+		} else if (Op <= PS7_PACK_OP_MASKDELAY) {
+			Ptr += 3U;
+		} else {
+			return;
+		}
+	}
+
+	if (LastPoll != NULL) {
+		LastPoll[0] = PS7_PACK_EXIT(0U);
+	}
+}
+#endif
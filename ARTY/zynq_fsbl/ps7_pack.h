@@ -0,0 +1,116 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file ps7_pack.h
+*
+* This file contains the replay of the packed ps7_init tables of
+* FSBL_PS7_PACK.
+*
+* The build runs tools/ps7_pack.py on ps7_init.c and compiles the
+* ps7_init_pack.c it writes, which holds each table of ps7_init.c in a
+* packed form. An entry is a header word and its arguments:
+*	- PS7_PACK_WRITE(n), address, n values
+*	- PS7_PACK_MASKWRITE(n), address, n (mask, value) pairs
+*	- PS7_PACK_MASKPOLL(1), address, mask
+*	- PS7_PACK_MASKDELAY(1), timer address, delay in ms
+*	- PS7_PACK_EXIT(0)
+* The n values or pairs of a write go to n consecutive registers from the
+* address. The table keeps the accesses of ps7_init.c in their order, but
+* full mask and clear entries are plain writes, without the read of the
+* masked write, and a masked write repeating the one before it is dropped.
+*
+* Ps7Pack_Init() and Ps7Pack_PostConfig() do what ps7_init() and
+* ps7_post_config() do, with the same return codes and poll limits. The
+* tables are data in OCM, read through the caches the BSP enables.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef ___PS7_PACK_H___
+#define ___PS7_PACK_H___
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Operations, in the top byte of the header word
+ */
+#define PS7_PACK_OP_EXIT		0U
+#define PS7_PACK_OP_WRITE		1U
+#define PS7_PACK_OP_MASKWRITE		2U
+#define PS7_PACK_OP_MASKPOLL		3U
+#define PS7_PACK_OP_MASKDELAY		4U
+
+#define PS7_PACK_OP_SHIFT		24U
+#define PS7_PACK_COUNT_MASK		0x00FFFFFFU
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+#define PS7_PACK_HEADER(Op, Count)	(((Op) << PS7_PACK_OP_SHIFT) | (Count))
+
+#define PS7_PACK_EXIT(Count)		PS7_PACK_HEADER(PS7_PACK_OP_EXIT, (Count))
+#define PS7_PACK_WRITE(Count)		PS7_PACK_HEADER(PS7_PACK_OP_WRITE, (Count))
+#define PS7_PACK_MASKWRITE(Count)	PS7_PACK_HEADER(PS7_PACK_OP_MASKWRITE, (Count))
+#define PS7_PACK_MASKPOLL(Count)	PS7_PACK_HEADER(PS7_PACK_OP_MASKPOLL, (Count))
+#define PS7_PACK_MASKDELAY(Count)	PS7_PACK_HEADER(PS7_PACK_OP_MASKDELAY, (Count))
+
+/************************** Function Prototypes ******************************/
+
+int Ps7Pack_Replay(const u32 *Table);
+int Ps7Pack_Init(void);
+int Ps7Pack_PostConfig(void);
+void Ps7Pack_DeferPoll(u32 *Table, u32 Addr);
+
+/************************** Variable Definitions *****************************/
+
+/*
+ * Packed tables, per silicon version, in ps7_init_pack.c
+ */
+extern u32 ps7_mio_init_data_1_0_pack[];
+extern u32 ps7_pll_init_data_1_0_pack[];
+extern u32 ps7_clock_init_data_1_0_pack[];
+extern u32 ps7_ddr_init_data_1_0_pack[];
+extern u32 ps7_peripherals_init_data_1_0_pack[];
+extern u32 ps7_post_config_1_0_pack[];
+extern u32 ps7_mio_init_data_2_0_pack[];
+extern u32 ps7_pll_init_data_2_0_pack[];
+extern u32 ps7_clock_init_data_2_0_pack[];
+extern u32 ps7_ddr_init_data_2_0_pack[];
+extern u32 ps7_peripherals_init_data_2_0_pack[];
+extern u32 ps7_post_config_2_0_pack[];
+extern u32 ps7_mio_init_data_3_0_pack[];
+extern u32 ps7_pll_init_data_3_0_pack[];
+extern u32 ps7_clock_init_data_3_0_pack[];
+extern u32 ps7_ddr_init_data_3_0_pack[];
+extern u32 ps7_peripherals_init_data_3_0_pack[];
+extern u32 ps7_post_config_3_0_pack[];
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ___PS7_PACK_H___ */
@@ -41,6 +41,15 @@
 * 21.1  ng 07/13/23  Add SDT support
 * 21.2  ng 07/25/23  Updated QSPI address support in SDT flow
 * 21.4   ng  10/03/24   Fix change in macro name for QSPI linear flash
+* 21.5   qm  10/14/26   I/O mode reads past the first DATA_SIZE bytes go
+*                       straight to the destination, QSPI_STREAM_SIZE
+*                       bytes per read command
+*                       Linear mode copies of QSPI_DMA_THRESHOLD bytes and
+*                       more are moved by the PS DMA
+*                       Read timing calibration of the linear mode with
+*                       FSBL_QSPI_TUNE
+*                       The DMA copy moved to fsbl_dma.c, shared with nor.c
+*                       QspiProgram() for the panic dump of FSBL_PANIC
 * </pre>
 *
 * @note
@@ -51,11 +60,16 @@
 
 #include "qspi.h"
 #include "image_mover.h"
+#include "fsbl_dma.h"
 
 #if defined(XPAR_PS7_QSPI_LINEAR_0_S_AXI_BASEADDR) || defined(XPAR_PS7_QSPI_LINEAR_0_BASEADDRESS)
 #include "xqspips_hw.h"
 #include "xqspips.h"
 
+#ifdef XPAR_XWDTPS_0_BASEADDR
+#include "xwdtps.h"
+#endif
+
 /************************** Constant Definitions *****************************/
 
 /*
@@ -81,6 +95,8 @@
 #define READ_ID_CMD			0x9F
 
 #define WRITE_ENABLE_CMD	0x06
+#define PAGE_PROGRAM_CMD	0x02
+#define READ_STATUS_CMD		0x05
 #define BANK_REG_RD			0x16
 #define BANK_REG_WR			0x17
 /* Bank register is called Extended Address Reg in Micron */
@@ -99,6 +115,8 @@
 #define RD_ID_SIZE			4 /* Read ID command + 3 bytes ID response */
 #define BANK_SEL_SIZE		2 /* BRWR or EARWR command + 1 byte bank value */
 #define WRITE_ENABLE_CMD_SIZE	1 /* WE command */
+#define READ_STATUS_SIZE	2 /* RDSR command + 1 byte status */
+#define STATUS_WIP_MASK		0x01 /* Write in progress bit of the status */
 /*
  * The following constants specify the extra bytes which are sent to the
  * FLASH on the QSPI interface, that are not data, but control information
@@ -113,6 +131,37 @@
  */
 #define DATA_SIZE		4096
 
+/*
+ * Page program of QspiProgram(), and status reads before a page program is
+ * taken as failed, several times the longest page program time
+ */
+#define PROGRAM_PAGE_SIZE	256
+#define PROGRAM_STATUS_POLLS	100000
+
+/*
+ * Largest read command of the I/O mode reads that go straight to the
+ * destination, bounded so that the watchdog is served between them
+ */
+#ifndef QSPI_STREAM_SIZE
+#define QSPI_STREAM_SIZE	0x100000
+#endif
+
+/*
+ * Read timing calibration of the linear mode, see QspiTune(). A setting is
+ * the prescaler plus one, the feedback clock bit and the bit for two dummy
+ * bytes instead of one, as kept in QSPI_TUNE_MASK of the reboot status
+ */
+#ifdef FSBL_QSPI_TUNE
+#define QSPI_TUNE_LENGTH		0x400	/* Bytes compared per read */
+#define QSPI_TUNE_PASSES		4	/* Reads per setting */
+#define QSPI_TUNE_PRESCALER_MASK	0x3
+#define QSPI_TUNE_LPBK_MASK		0x4
+#define QSPI_TUNE_DUMMY_MASK		0x8
+#define QSPI_TUNE_BOOT_SETTING		(XQSPIPS_CLK_PRESCALE_8 + 1)
+#define LQSPI_CR_DUMMY_MASK		0x00000700
+#define LQSPI_CR_DUMMY_SHIFT		8
+#endif
+
 /*
  * The following defines are for dual flash interface.
  */
@@ -176,6 +225,13 @@
 
 /************************** Function Prototypes ******************************/
 
+static void FlashReadInPlace(u32 Address, u8 *BufferPtr, u32 ByteCount);
+static u32 QspiProgramPage(u32 Address, const u8 *DataPtr, u32 ByteCount);
+#ifdef FSBL_QSPI_TUNE
+static void QspiTune(u32 ConfigCmd);
+static u32 QspiTuneApply(u32 Setting, u32 ConfigCmd);
+#endif
+
 /************************** Variable Definitions *****************************/
 
 XQspiPs QspiInstance;
@@ -184,6 +240,9 @@ u32 QspiFlashSize;
 u32 QspiFlashMake;
 extern u32 FlashReadBaseAddress;
 extern u8 LinearBootDeviceFlag;
+#ifdef XPAR_XWDTPS_0_BASEADDR
+extern XWdtPs Watchdog;	/* Instance of WatchDog Timer	*/
+#endif
 
 /*
  * The following variables are used to read and write to the eeprom and they
@@ -192,6 +251,13 @@ extern u8 LinearBootDeviceFlag;
 u8 ReadBuffer[DATA_SIZE + DATA_OFFSET + DUMMY_SIZE];
 u8 WriteBuffer[DATA_OFFSET + DUMMY_SIZE];
 
+#ifdef FSBL_QSPI_TUNE
+/*
+ * Boot header as read at the boot setting
+ */
+static u32 QspiTuneReference[QSPI_TUNE_LENGTH / 4];
+#endif
+
 /******************************************************************************/
 /**
 *
@@ -427,6 +493,18 @@ u32 InitQspi(void)
 		XQspiPs_SetLqspiConfigReg(QspiInstancePtr, ConfigCmd);
 	}
 
+#ifdef FSBL_QSPI_TUNE
+	if (LinearBootDeviceFlag == 1) {
+		QspiTune(XQspiPs_GetLqspiConfigReg(QspiInstancePtr));
+	}
+#endif
+
+#ifdef FSBL_DMA
+	if (LinearBootDeviceFlag == 1) {
+		FsblDmaInit();
+	}
+#endif
+
 	return XST_SUCCESS;
 }
 
@@ -569,6 +647,45 @@ void FlashRead(u32 Address, u32 ByteCount)
 				ByteCount + OVERHEAD_SIZE);
 }
 
+/******************************************************************************
+*
+* This function reads from the serial FLASH straight into the destination,
+* without the copy through ReadBuffer. The command, address and dummy byte
+* are sent from, and their response received into, the DATA_OFFSET +
+* DUMMY_SIZE bytes before the destination, which are restored afterwards.
+*
+* @param	Address contains the address to read data from in the FLASH.
+* @param	BufferPtr is the destination, preceded by at least
+*		DATA_OFFSET + DUMMY_SIZE bytes of memory already read.
+* @param	ByteCount contains the number of bytes to read.
+*
+* @return	None.
+*
+* @note		The data shifted out while the data is read is the old
+*		content of the destination, which the FLASH ignores.
+*
+******************************************************************************/
+static void FlashReadInPlace(u32 Address, u8 *BufferPtr, u32 ByteCount)
+{
+	u8 *FramePtr = BufferPtr - (DATA_OFFSET + DUMMY_SIZE);
+	u8 Saved[DATA_OFFSET + DUMMY_SIZE];
+	u32 LqspiCrReg;
+
+	memcpy(Saved, FramePtr, sizeof(Saved));
+
+	LqspiCrReg = XQspiPs_GetLqspiConfigReg(QspiInstancePtr);
+	FramePtr[COMMAND_OFFSET]   = (u8) (LqspiCrReg & XQSPIPS_LQSPI_CR_INST_MASK);
+	FramePtr[ADDRESS_1_OFFSET] = (u8)((Address & 0xFF0000) >> 16);
+	FramePtr[ADDRESS_2_OFFSET] = (u8)((Address & 0xFF00) >> 8);
+	FramePtr[ADDRESS_3_OFFSET] = (u8)(Address & 0xFF);
+	FramePtr[DUMMY_OFFSET]     = 0x00;
+
+	XQspiPs_PolledTransfer(QspiInstancePtr, FramePtr, FramePtr,
+				ByteCount + DUMMY_SIZE + OVERHEAD_SIZE);
+
+	memcpy(FramePtr, Saved, sizeof(Saved));
+}
+
 /******************************************************************************/
 /**
 *
@@ -593,7 +710,9 @@ u32 QspiAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 	u32 BankSel = 0;
 	u32 LqspiCrReg;
 	u32 Status;
+	u32 MaxLength;
 	u8 BankSwitchFlag = 1;
+	u8 InPlaceFlag;
 
 	/*
 	 * Linear access check
@@ -606,6 +725,23 @@ u32 QspiAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 			LengthBytes += (4 - (LengthBytes & 0x00000003));
 		}
 
+#ifdef FSBL_DMA
+		/*
+		 * Large word aligned copies by the DMA, the CPU copy is kept
+		 * for the rest and if the DMA fails
+		 */
+		if ((LengthBytes >= FSBL_DMA_THRESHOLD) &&
+				(((SourceAddress | DestinationAddress) & 0x3) == 0)) {
+			Status = FsblDmaCopy(SourceAddress + FlashReadBaseAddress,
+					DestinationAddress, LengthBytes);
+			if (Status == XST_SUCCESS) {
+				return XST_SUCCESS;
+			}
+
+			fsbl_printf(DEBUG_INFO, "QSPI DMA copy failed\r\n");
+		}
+#endif
+
 		memcpy((void*)DestinationAddress,
 		      (const void*)(SourceAddress + FlashReadBaseAddress),
 		      (size_t)LengthBytes);
@@ -624,10 +760,20 @@ u32 QspiAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 
 		while(LengthBytes > 0) {
 			/*
-			 * Local of DATA_SIZE size used for read/write buffer
+			 * Once the first bytes are in, the reads go to the
+			 * destination, else through the local read buffer
 			 */
-			if(LengthBytes > DATA_SIZE) {
-				Length = DATA_SIZE;
+			if (((u32)BufferPtr - DestinationAddress) >=
+					(DATA_OFFSET + DUMMY_SIZE)) {
+				InPlaceFlag = 1;
+				MaxLength = QSPI_STREAM_SIZE;
+			} else {
+				InPlaceFlag = 0;
+				MaxLength = DATA_SIZE;
+			}
+
+			if(LengthBytes > MaxLength) {
+				Length = MaxLength;
 			} else {
 				Length = LengthBytes;
 			}
@@ -709,15 +855,29 @@ u32 QspiAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 				}
 			}
 
-			/*
-			 * Copying the image to local buffer
-			 */
-			FlashRead(SourceAddress, Length);
+			if (InPlaceFlag == 1) {
+#ifdef XPAR_XWDTPS_0_BASEADDR
+				/*
+				 * Prevent WDT reset
+				 */
+				XWdtPs_RestartWdt(&Watchdog);
+#endif
 
-			/*
-			 * Moving the data from local buffer to DDR destination address
-			 */
-			memcpy(BufferPtr, &ReadBuffer[DATA_OFFSET + DUMMY_SIZE], Length);
+				/*
+				 * Reading the image to the destination
+				 */
+				FlashReadInPlace(SourceAddress, BufferPtr, Length);
+			} else {
+				/*
+				 * Copying the image to local buffer
+				 */
+				FlashRead(SourceAddress, Length);
+
+				/*
+				 * Moving the data from local buffer to DDR destination address
+				 */
+				memcpy(BufferPtr, &ReadBuffer[DATA_OFFSET + DUMMY_SIZE], Length);
+			}
 
 			/*
 			 * Updated the variables
@@ -767,6 +927,143 @@ u32 QspiAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 
 
 
+#ifdef FSBL_QSPI_TUNE
+/******************************************************************************
+*
+* This function calibrates the linear mode reads. The boot header is read at
+* the boot setting, divisor 8 without the feedback clock, and must hold the
+* XLNX pattern. The setting kept in the reboot status register by an earlier
+* boot is checked against it first. Without one, or if it no longer reads
+* the header back, the divisors 2 and 4 are tried with one and two dummy
+* bytes, without and with the feedback clock, in that order, and the first
+* setting that reads the header back QSPI_TUNE_PASSES times is kept.
+*
+* @param	ConfigCmd is the linear configuration set by InitQspi
+*
+* @return	None
+*
+* @note		The feedback clock is needed above 40 MHz. A second dummy
+*		byte only reads back on flashes set up for that many dummy
+*		cycles. The reboot status register is kept across soft resets
+*		only, so a power on reset calibrates again.
+*
+******************************************************************************/
+static void QspiTune(u32 ConfigCmd)
+{
+	u32 Index;
+	u32 Setting;
+	u32 Prescaler;
+	u32 Dummy;
+	u32 Loopback;
+	u32 RebootStatus;
+	u32 Status;
+
+	for (Index = 0; Index < (QSPI_TUNE_LENGTH / 4); Index++) {
+		QspiTuneReference[Index] =
+			Xil_In32(FlashReadBaseAddress + (Index << 2));
+	}
+
+	if (QspiTuneReference[IMAGE_IDENT_OFFSET / 4] != IMAGE_IDENT) {
+		fsbl_printf(DEBUG_INFO, "QSPI tune: no boot header\r\n");
+		return;
+	}
+
+	RebootStatus = Xil_In32(REBOOT_STATUS_REG);
+	Setting = (RebootStatus & QSPI_TUNE_MASK) >> QSPI_TUNE_SHIFT;
+	if ((Setting != 0) &&
+			(QspiTuneApply(Setting, ConfigCmd) == XST_SUCCESS)) {
+		fsbl_printf(DEBUG_INFO, "QSPI tune: kept setting 0x%x\r\n",
+				Setting);
+		return;
+	}
+
+	Status = XST_FAILURE;
+	for (Prescaler = XQSPIPS_CLK_PRESCALE_2; (Status != XST_SUCCESS) &&
+			(Prescaler < XQSPIPS_CLK_PRESCALE_8); Prescaler++) {
+		for (Dummy = 0; (Status != XST_SUCCESS) &&
+				(Dummy <= QSPI_TUNE_DUMMY_MASK);
+				Dummy += QSPI_TUNE_DUMMY_MASK) {
+			for (Loopback = 0; (Status != XST_SUCCESS) &&
+					(Loopback <= QSPI_TUNE_LPBK_MASK);
+					Loopback += QSPI_TUNE_LPBK_MASK) {
+				Setting = (Prescaler + 1) | Dummy | Loopback;
+				Status = QspiTuneApply(Setting, ConfigCmd);
+			}
+		}
+	}
+
+	/*
+	 * The boot setting read the reference
+	 */
+	if (Status != XST_SUCCESS) {
+		Setting = QSPI_TUNE_BOOT_SETTING;
+		(void)QspiTuneApply(Setting, ConfigCmd);
+	}
+
+	fsbl_printf(DEBUG_INFO, "QSPI tune: setting 0x%x\r\n", Setting);
+
+	Xil_Out32(REBOOT_STATUS_REG, (RebootStatus & ~QSPI_TUNE_MASK) |
+			(Setting << QSPI_TUNE_SHIFT));
+}
+
+/******************************************************************************
+*
+* This function sets the linear mode reads to a calibration setting and
+* reads the boot header back QSPI_TUNE_PASSES times.
+*
+* @param	Setting is the calibration setting
+* @param	ConfigCmd is the linear configuration set by InitQspi
+*
+* @return
+*		- XST_SUCCESS if every read matches the reference
+*		- XST_FAILURE otherwise
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 QspiTuneApply(u32 Setting, u32 ConfigCmd)
+{
+	u32 BaseAddr = QspiInstancePtr->Config.BaseAddress;
+	u32 Pass;
+	u32 Index;
+
+	if ((Setting & QSPI_TUNE_PRESCALER_MASK) == 0) {
+		return XST_FAILURE;
+	}
+
+	ConfigCmd &= ~LQSPI_CR_DUMMY_MASK;
+	if ((Setting & QSPI_TUNE_DUMMY_MASK) != 0) {
+		ConfigCmd |= (2 << LQSPI_CR_DUMMY_SHIFT);
+	} else {
+		ConfigCmd |= (1 << LQSPI_CR_DUMMY_SHIFT);
+	}
+
+	XQspiPs_Disable(QspiInstancePtr);
+
+	XQspiPs_SetClkPrescaler(QspiInstancePtr,
+			(u8)((Setting & QSPI_TUNE_PRESCALER_MASK) - 1));
+
+	XQspiPs_WriteReg(BaseAddr, XQSPIPS_LPBK_DLY_ADJ_OFFSET,
+			((Setting & QSPI_TUNE_LPBK_MASK) != 0) ?
+			XQSPIPS_LPBK_DLY_ADJ_USE_LPBK_MASK : 0);
+
+	XQspiPs_SetLqspiConfigReg(QspiInstancePtr, ConfigCmd);
+
+	XQspiPs_Enable(QspiInstancePtr);
+
+	for (Pass = 0; Pass < QSPI_TUNE_PASSES; Pass++) {
+		for (Index = 0; Index < (QSPI_TUNE_LENGTH / 4); Index++) {
+			if (Xil_In32(FlashReadBaseAddress + (Index << 2)) !=
+					QspiTuneReference[Index]) {
+				return XST_FAILURE;
+			}
+		}
+	}
+
+	return XST_SUCCESS;
+}
+#endif
+
 /******************************************************************************
 *
 * This functions selects the current bank
@@ -867,5 +1164,138 @@ u32 SendBankSelect(u8 BankSel)
 
 	return XST_SUCCESS;
 }
-#endif
 
+/******************************************************************************
+*
+* This function programs erased flash with page programs in I/O mode, for
+* the panic dump of FSBL_PANIC. In linear mode the controller is switched
+* to I/O mode for the programs and back after them.
+*
+* @param	Address is the flash offset of the first byte
+* @param	DataPtr is the data to be programmed
+* @param	LengthBytes is the length of the data in bytes
+*
+* @return
+*		- XST_SUCCESS if the data is programmed
+*		- XST_FAILURE if the flash is not set up, not in a single flash
+*		  connection, the range is past the first 16 MB or a program
+*		  fails
+*
+* @note		The flash must read erased over the range, nothing is erased.
+*		Pages are programmed as the range covers them, a range from a
+*		page boundary takes the fewest page programs.
+*
+******************************************************************************/
+u32 QspiProgram(u32 Address, const u8 *DataPtr, u32 LengthBytes)
+{
+	u32 LqspiCrReg = 0;
+	u32 ByteCount;
+	u32 Status = XST_SUCCESS;
+
+	if ((QspiInstancePtr == NULL) ||
+			(QspiInstancePtr->IsReady != XIL_COMPONENT_IS_READY) ||
+			(QSPI_CONNECTION_MODE != SINGLE_FLASH_CONNECTION) ||
+			(Address >= FLASH_SIZE_16MB) ||
+			(LengthBytes > (FLASH_SIZE_16MB - Address))) {
+		return XST_FAILURE;
+	}
+
+	if (LinearBootDeviceFlag == 1) {
+		LqspiCrReg = XQspiPs_GetLqspiConfigReg(QspiInstancePtr);
+		XQspiPs_Disable(QspiInstancePtr);
+		XQspiPs_SetOptions(QspiInstancePtr, XQSPIPS_FORCE_SSELECT_OPTION |
+				XQSPIPS_HOLD_B_DRIVE_OPTION);
+		XQspiPs_SetSlaveSelect(QspiInstancePtr);
+		XQspiPs_Enable(QspiInstancePtr);
+	}
+
+	while (LengthBytes > 0) {
+		/*
+		 * Up to the end of the page of Address
+		 */
+		ByteCount = PROGRAM_PAGE_SIZE - (Address % PROGRAM_PAGE_SIZE);
+		if (ByteCount > LengthBytes) {
+			ByteCount = LengthBytes;
+		}
+
+		Status = QspiProgramPage(Address, DataPtr, ByteCount);
+		if (Status != XST_SUCCESS) {
+			break;
+		}
+
+		Address += ByteCount;
+		DataPtr += ByteCount;
+		LengthBytes -= ByteCount;
+	}
+
+	if (LinearBootDeviceFlag == 1) {
+		XQspiPs_Disable(QspiInstancePtr);
+		XQspiPs_SetOptions(QspiInstancePtr, XQSPIPS_LQSPI_MODE_OPTION |
+				XQSPIPS_HOLD_B_DRIVE_OPTION);
+		XQspiPs_SetLqspiConfigReg(QspiInstancePtr, LqspiCrReg);
+		XQspiPs_Enable(QspiInstancePtr);
+	}
+
+	return Status;
+}
+
+/******************************************************************************
+*
+* This function programs bytes of one page and waits for the program to end.
+* The frame is built in ReadBuffer, which holds a page and its command.
+*
+* @param	Address is the flash offset of the first byte
+* @param	DataPtr is the data to be programmed
+* @param	ByteCount is the number of bytes, within the page of Address
+*
+* @return
+*		- XST_SUCCESS if the page is programmed
+*		- XST_FAILURE if a transfer fails or the flash stays busy
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 QspiProgramPage(u32 Address, const u8 *DataPtr, u32 ByteCount)
+{
+	u32 Polls;
+	u32 Status;
+
+	WriteBuffer[COMMAND_OFFSET] = WRITE_ENABLE_CMD;
+	Status = XQspiPs_PolledTransfer(QspiInstancePtr, WriteBuffer, NULL,
+			WRITE_ENABLE_CMD_SIZE);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	ReadBuffer[COMMAND_OFFSET]   = PAGE_PROGRAM_CMD;
+	ReadBuffer[ADDRESS_1_OFFSET] = (u8)((Address & 0xFF0000) >> 16);
+	ReadBuffer[ADDRESS_2_OFFSET] = (u8)((Address & 0xFF00) >> 8);
+	ReadBuffer[ADDRESS_3_OFFSET] = (u8)(Address & 0xFF);
+	memcpy(&ReadBuffer[DATA_OFFSET], DataPtr, ByteCount);
+
+	Status = XQspiPs_PolledTransfer(QspiInstancePtr, ReadBuffer, NULL,
+			ByteCount + OVERHEAD_SIZE);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	/*
+	 * Wait for the write in progress bit to clear
+	 */
+	for (Polls = 0; Polls < PROGRAM_STATUS_POLLS; Polls++) {
+		WriteBuffer[COMMAND_OFFSET]   = READ_STATUS_CMD;
+		WriteBuffer[ADDRESS_1_OFFSET] = 0x00;
+		Status = XQspiPs_PolledTransfer(QspiInstancePtr, WriteBuffer,
+				WriteBuffer, READ_STATUS_SIZE);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		if ((WriteBuffer[1] & STATUS_WIP_MASK) == 0) {
+			return XST_SUCCESS;
+		}
+	}
+
+	return XST_FAILURE;
+}
+#endif
@@ -20,6 +20,7 @@
 * 5.00a sgd	05/17/13 Added Flash Size > 128Mbit support
 * 					 Dual Stack support
 * 6.00a bsv	09/04/20 Added support for 2Gb flash parts
+* 21.6  qm	10/14/26 Added QspiProgram() for FSBL_PANIC
 * </pre>
 *
 * @note
@@ -103,6 +104,7 @@ u32 QspiAccess( u32 SourceAddress,
 
 u32 FlashReadID(void);
 u32 SendBankSelect(u8 BankSel);
+u32 QspiProgram(u32 Address, const u8 *DataPtr, u32 LengthBytes);
 /************************** Variable Definitions *****************************/
 
 
@@ -31,6 +31,12 @@
 * 10.0  vns 03/18/22 Fixed CR#1125470 to authenticate the parition header buffer
 *                    which is being used instead of one from DDR. Modified
 *                    prototype of AuthenticatePartition() API
+* 21.3  qm  10/14/26 In-tree RSA-2048 public exponentiation with Montgomery
+*                    multiplication in place of xilrsa, the PPK and SPK
+*                    contexts kept across partitions and the SPK signature
+*                    checked once per SPK
+*                    AuthenticateSpk() for the SPKs of a boot image in one
+*                    pass, a cache of RSA_SPK_CACHE_SIZE SPKs
 * </pre>
 *
 * @note
@@ -41,7 +47,8 @@
 #ifdef RSA_SUPPORT
 #include "fsbl.h"
 #include "rsa.h"
-#include "xilrsa.h"
+#include "sha256.h"
+#include <string.h>
 
 #ifdef	XPAR_XWDTPS_0_BASEADDR
 #include "xwdtps.h"
@@ -49,8 +56,25 @@
 
 /************************** Constant Definitions *****************************/
 
+/*
+ * Words of a 2048 bit number
+ */
+#define RSA_WORDS		(RSA_SPK_MODULAR_SIZE / 4)
+
 /**************************** Type Definitions *******************************/
 
+/*
+ * Montgomery context of a public key, R = 2^2048. The numbers are little
+ * endian words, as the little endian bytes of the certificate are on the
+ * little endian CPU.
+ */
+typedef struct {
+	u32 Modulus[RSA_WORDS];
+	u32 ModularEx[RSA_WORDS];	/* R^2 mod N, the modulus extension */
+	u32 ModInv;			/* -1/N mod 2^32 */
+	u32 Exp;
+} RsaKey;
+
 
 /***************** Macros (Inline Functions) Definitions *********************/
 
@@ -68,6 +92,20 @@ static u8 *PpkModularEx;
 static u32	PpkExp;
 static u32 PpkAlreadySet=0;
 
+/*
+ * Contexts of the PPK and of the SPKs already authenticated by it. An SPK
+ * is identified by its hash and its signature is only checked the first
+ * time it is seen, the partitions of an image are signed with a few SPKs.
+ */
+static RsaKey PpkKey;
+static u32 PpkKeyValid=0;
+static struct {
+	RsaKey Key;
+	u8 Hash[32];
+} SpkCache[RSA_SPK_CACHE_SIZE];
+static u32 SpkCacheCount=0;
+static u32 SpkCacheNext=0;
+
 extern u32 FsblLength;
 
 void FsblPrintArray (u8 *Buf, u32 Len, char *Str)
@@ -87,6 +125,225 @@ void FsblPrintArray (u8 *Buf, u32 Len, char *Str)
 	return;
 }
 
+/*****************************************************************************/
+/**
+*
+* Multiplies two words and adds two more, Hi:Lo = A * B + Lo + Hi. The sum
+* cannot overflow 64 bits. It is the UMAAL instruction on ARMv6 and later.
+*
+******************************************************************************/
+static inline void RsaMulAdd(u32 *Lo, u32 *Hi, u32 A, u32 B)
+{
+#if defined(__arm__) && defined(__ARM_ARCH) && (__ARM_ARCH >= 6)
+	u32 L = *Lo;
+	u32 H = *Hi;
+
+	__asm__ ("umaal %0, %1, %2, %3" : "+r" (L), "+r" (H) : "r" (A), "r" (B));
+	*Lo = L;
+	*Hi = H;
+#else
+	u64 Sum = ((u64)A * B) + *Lo + *Hi;
+
+	*Lo = (u32)Sum;
+	*Hi = (u32)(Sum >> 32);
+#endif
+}
+
+/*****************************************************************************/
+/**
+*
+* Compares two numbers of RSA_WORDS words.
+*
+* @return	-1, 0 or 1 as A is less than, equal to or greater than B
+*
+******************************************************************************/
+static s32 RsaCompare(const u32 *A, const u32 *B)
+{
+	u32 Index = RSA_WORDS;
+
+	while (Index > 0U) {
+		Index--;
+		if (A[Index] != B[Index]) {
+			return (A[Index] > B[Index]) ? 1 : -1;
+		}
+	}
+
+	return 0;
+}
+
+/*****************************************************************************/
+/**
+*
+* Montgomery multiplication, Out = A * B / R mod N, with word level
+* interleaved reduction (CIOS). B and the result are less than N, A may be
+* any number below R. Out may be A or B.
+*
+* @param	Out is the product
+* @param	A is the first factor
+* @param	B is the second factor
+* @param	Key is the Montgomery context of N
+*
+* @return	None
+*
+******************************************************************************/
+static void RsaMontMul(u32 *Out, const u32 *A, const u32 *B,
+		const RsaKey *Key)
+{
+	u32 T[RSA_WORDS + 2];
+	const u32 *N = Key->Modulus;
+	u32 Carry;
+	u32 Lo;
+	u32 M;
+	u32 Top;
+	u32 Borrow;
+	u32 Index;
+	u32 Jndex;
+
+	memset(T, 0, sizeof(T));
+
+	for (Index = 0U; Index < RSA_WORDS; Index++) {
+		/*
+		 * T += A * B[Index]
+		 */
+		Carry = 0U;
+		for (Jndex = 0U; Jndex < RSA_WORDS; Jndex++) {
+			Lo = T[Jndex];
+			RsaMulAdd(&Lo, &Carry, A[Jndex], B[Index]);
+			T[Jndex] = Lo;
+		}
+		Top = T[RSA_WORDS] + Carry;
+		T[RSA_WORDS + 1U] = (Top < Carry) ? 1U : 0U;
+		T[RSA_WORDS] = Top;
+
+		/*
+		 * T = (T + M * N) / 2^32, M making the low word zero
+		 */
+		M = T[0] * Key->ModInv;
+		Lo = T[0];
+		Carry = 0U;
+		RsaMulAdd(&Lo, &Carry, M, N[0]);
+		for (Jndex = 1U; Jndex < RSA_WORDS; Jndex++) {
+			Lo = T[Jndex];
+			RsaMulAdd(&Lo, &Carry, M, N[Jndex]);
+			T[Jndex - 1U] = Lo;
+		}
+		Top = T[RSA_WORDS] + Carry;
+		T[RSA_WORDS - 1U] = Top;
+		T[RSA_WORDS] = T[RSA_WORDS + 1U] + ((Top < Carry) ? 1U : 0U);
+	}
+
+	/*
+	 * T is less than 2N, one subtraction reduces it
+	 */
+	if ((T[RSA_WORDS] != 0U) || (RsaCompare(T, N) >= 0)) {
+		Borrow = 0U;
+		for (Jndex = 0U; Jndex < RSA_WORDS; Jndex++) {
+			Lo = T[Jndex] - N[Jndex];
+			Top = (T[Jndex] < N[Jndex]) ? 1U : 0U;
+			Top += (Lo < Borrow) ? 1U : 0U;
+			Out[Jndex] = Lo - Borrow;
+			Borrow = Top;
+		}
+	} else {
+		memcpy(Out, T, RSA_WORDS * 4U);
+	}
+}
+
+/*****************************************************************************/
+/**
+*
+* Sets up the Montgomery context of a public key from the certificate
+*
+* @param	Key is the context
+* @param	Modular is the modulus, little endian
+* @param	ModularEx is the modulus extension R^2 mod N, little endian
+* @param	Exp is the public exponent
+*
+* @return
+*		- XST_SUCCESS if the key can be used
+*		- XST_FAILURE for an even modulus, a zero exponent or an
+*		  extension not reduced by the modulus
+*
+* @note		The bytes may be unaligned.
+*
+******************************************************************************/
+static u32 RsaSetKey(RsaKey *Key, const u8 *Modular, const u8 *ModularEx,
+		u32 Exp)
+{
+	u32 Inv;
+	u32 Index;
+
+	memcpy(Key->Modulus, Modular, RSA_WORDS * 4U);
+	memcpy(Key->ModularEx, ModularEx, RSA_WORDS * 4U);
+	Key->Exp = Exp;
+
+	if (((Key->Modulus[0] & 1U) == 0U) || (Exp == 0U) ||
+			(RsaCompare(Key->ModularEx, Key->Modulus) >= 0)) {
+		return XST_FAILURE;
+	}
+
+	/*
+	 * Newton iteration for 1/N mod 2^32, N is its own inverse mod 8 and
+	 * each step doubles the correct bits
+	 */
+	Inv = Key->Modulus[0];
+	for (Index = 0U; Index < 4U; Index++) {
+		Inv *= 2U - (Key->Modulus[0] * Inv);
+	}
+	Key->ModInv = 0U - Inv;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* RSA public operation, Out = In ^ Exp mod N, by left to right square and
+* multiply in the Montgomery domain
+*
+* @param	Key is the context of the key
+* @param	In is the signature, little endian and possibly unaligned
+* @param	Out is the result, little endian
+*
+* @return	None
+*
+******************************************************************************/
+static void RsaPubExp(const RsaKey *Key, const u8 *In, u8 *Out)
+{
+	u32 X[RSA_WORDS];
+	u32 Acc[RSA_WORDS];
+	u32 Bit;
+
+	memcpy(X, In, sizeof(X));
+
+	/*
+	 * Into the Montgomery domain, X * R mod N
+	 */
+	RsaMontMul(X, X, Key->ModularEx, Key);
+	memcpy(Acc, X, sizeof(Acc));
+
+	Bit = 31U;
+	while ((Key->Exp >> Bit) == 0U) {
+		Bit--;
+	}
+	while (Bit > 0U) {
+		Bit--;
+		RsaMontMul(Acc, Acc, Acc, Key);
+		if (((Key->Exp >> Bit) & 1U) != 0U) {
+			RsaMontMul(Acc, Acc, X, Key);
+		}
+	}
+
+	/*
+	 * Out of the Montgomery domain, multiplied by 1
+	 */
+	memset(X, 0, sizeof(X));
+	X[0] = 1U;
+	RsaMontMul(Acc, Acc, X, Key);
+
+	memcpy(Out, Acc, sizeof(Acc));
+}
+
 
 /*****************************************************************************/
 /**
@@ -161,20 +418,21 @@ void SetPpk(void )
 /*****************************************************************************/
 /**
 *
-* This function Authenticate Partition Signature
+* This function authenticates the SPK of a certificate with the PPK. An SPK
+* already authenticated is found by its hash in the SPK cache, otherwise its
+* context replaces the oldest one of the cache.
 *
-* @param	AC is the pointer to authentication certificate
-* @param	Hash is the pointer which holds the SHA2 digest of data
-*		to be authenticated.
+* @param	Ac is the pointer to authentication certificate
+* @param	KeyPtr is where the context of the SPK is returned
 *
 * @return
-*		- XST_SUCCESS if Authentication passed
-*		- XST_FAILURE if Authentication failed
+*		- XST_SUCCESS if the SPK is authenticated
+*		- XST_FAILURE if not
 *
-* @note		None
+* @note		Only the certificate up to the SPK signature is read.
 *
 ******************************************************************************/
-u32 AuthenticatePartition(u8 *Ac, u8* Hash)
+static u32 AuthenticateSpkKey(u8 *Ac, const RsaKey **KeyPtr)
 {
 	u8 DecryptSignature[256];
 	u8 HashSignature[32];
@@ -182,33 +440,18 @@ u32 AuthenticatePartition(u8 *Ac, u8* Hash)
 	u8 *SpkModularEx;
 	u32 SpkExp;
 	u8 *SignaturePtr;
+	Sha256Context ShaContext;
+	RsaKey Key;
 	u32 Status;
-
-#ifdef	XPAR_XWDTPS_0_BASEADDR
-	/*
-	 * Prevent WDT reset
-	 */
-	XWdtPs_RestartWdt(&Watchdog);
-#endif
+	u32 Index;
 
 	/*
-	 * Point to Authentication Certificate
+	 * Point to the SPK, beyond the authentication header, the magic word
+	 * and the PPK
 	 */
 	SignaturePtr = (u8 *)Ac;
-
-	/*
-	 * Increment the pointer by authentication Header size
-	 */
 	SignaturePtr += RSA_HEADER_SIZE;
-
-	/*
-	 * Increment the pointer by Magic word size
-	 */
 	SignaturePtr += RSA_MAGIC_WORD_SIZE;
-
-	/*
-	 * Increment the pointer beyond the PPK
-	 */
 	SignaturePtr += RSA_PPK_MODULAR_SIZE;
 	SignaturePtr += RSA_PPK_MODULAR_EXT_SIZE;
 	SignaturePtr += RSA_PPK_EXPO_SIZE;
@@ -216,11 +459,23 @@ u32 AuthenticatePartition(u8 *Ac, u8* Hash)
 	/*
 	 * Calculate Hash Signature
 	 */
-	sha_256((u8 *)SignaturePtr, (RSA_SPK_MODULAR_EXT_SIZE +
-				RSA_SPK_EXPO_SIZE + RSA_SPK_MODULAR_SIZE),
-				HashSignature);
+	Sha256Init(&ShaContext);
+	Sha256Update(&ShaContext, SignaturePtr, RSA_SPK_MODULAR_SIZE);
+	Sha256Update(&ShaContext, SignaturePtr + RSA_SPK_MODULAR_SIZE,
+			RSA_SPK_MODULAR_EXT_SIZE);
+	Sha256Update(&ShaContext, SignaturePtr + RSA_SPK_MODULAR_SIZE +
+			RSA_SPK_MODULAR_EXT_SIZE, RSA_SPK_EXPO_SIZE);
+	Sha256Final(&ShaContext, HashSignature);
 	FsblPrintArray(HashSignature, 32, "SPK Hash Calculated");
 
+	for (Index = 0U; Index < SpkCacheCount; Index++) {
+		if (memcmp(SpkCache[Index].Hash, HashSignature,
+				sizeof(HashSignature)) == 0) {
+			*KeyPtr = &SpkCache[Index].Key;
+			return XST_SUCCESS;
+		}
+	}
+
    	/*
    	 * Extract SPK signature
    	 */
@@ -231,34 +486,120 @@ u32 AuthenticatePartition(u8 *Ac, u8* Hash)
 	SpkExp = *((u32 *)SignaturePtr);
 	SignaturePtr += RSA_SPK_EXPO_SIZE;
 
+	if (PpkKeyValid == 0U) {
+		Status = RsaSetKey(&PpkKey, PpkModular, PpkModularEx, PpkExp);
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_INFO, "PPK not valid\r\n");
+			return XST_FAILURE;
+		}
+		PpkKeyValid = 1U;
+	}
+
 	/*
 	 * Decrypt SPK Signature
 	 */
-	rsa2048_pubexp((RSA_NUMBER)DecryptSignature,
-			(RSA_NUMBER)SignaturePtr,
-			(u32)PpkExp,
-			(RSA_NUMBER)PpkModular,
-			(RSA_NUMBER)PpkModularEx);
+	RsaPubExp(&PpkKey, SignaturePtr, DecryptSignature);
 	FsblPrintArray(DecryptSignature, RSA_SPK_SIGNATURE_SIZE,
 					"SPK Decrypted Hash");
 
-
 	Status = RecreatePaddingAndCheck(DecryptSignature, HashSignature);
 	if (Status != XST_SUCCESS) {
 		fsbl_printf(DEBUG_INFO, "Partition SPK Signature "
 				"Authentication failed\r\n");
 		return XST_FAILURE;
 	}
-	SignaturePtr += RSA_SPK_SIGNATURE_SIZE;
+
+	Status = RsaSetKey(&Key, SpkModular, SpkModularEx, SpkExp);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO, "SPK not valid\r\n");
+		return XST_FAILURE;
+	}
+
+	/*
+	 * Into the cache, SpkCacheNext cycles through the entries
+	 */
+	Index = SpkCacheNext;
+	SpkCacheNext = (SpkCacheNext + 1U) % RSA_SPK_CACHE_SIZE;
+	if (SpkCacheCount < RSA_SPK_CACHE_SIZE) {
+		SpkCacheCount++;
+	}
+	SpkCache[Index].Key = Key;
+	memcpy(SpkCache[Index].Hash, HashSignature, sizeof(HashSignature));
+
+	*KeyPtr = &SpkCache[Index].Key;
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function authenticates the SPK of a partition certificate ahead of the
+* partition, so that the SPKs of a boot image are all checked in one pass
+* and AuthenticatePartition() only checks the partition signature.
+*
+* @param	Ac is the pointer to authentication certificate, at least
+*		RSA_SPK_CERT_SIZE bytes
+*
+* @return
+*		- XST_SUCCESS if the SPK is authenticated
+*		- XST_FAILURE if not
+*
+* @note		None
+*
+******************************************************************************/
+u32 AuthenticateSpk(u8 *Ac)
+{
+	const RsaKey *Key;
+
+#ifdef	XPAR_XWDTPS_0_BASEADDR
+	/*
+	 * Prevent WDT reset
+	 */
+	XWdtPs_RestartWdt(&Watchdog);
+#endif
+
+	return AuthenticateSpkKey(Ac, &Key);
+}
+
+/*****************************************************************************/
+/**
+*
+* This function Authenticate Partition Signature
+*
+* @param	AC is the pointer to authentication certificate
+* @param	Hash is the pointer which holds the SHA2 digest of data
+*		to be authenticated.
+*
+* @return
+*		- XST_SUCCESS if Authentication passed
+*		- XST_FAILURE if Authentication failed
+*
+* @note		The SPK signature is only checked for an SPK not in the SPK
+*		cache.
+*
+******************************************************************************/
+u32 AuthenticatePartition(u8 *Ac, u8* Hash)
+{
+	u8 DecryptSignature[256];
+	const RsaKey *Key;
+	u32 Status;
+
+#ifdef	XPAR_XWDTPS_0_BASEADDR
+	/*
+	 * Prevent WDT reset
+	 */
+	XWdtPs_RestartWdt(&Watchdog);
+#endif
+
+	Status = AuthenticateSpkKey(Ac, &Key);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
 
 	/*
 	 * Decrypt Partition Signature
 	 */
-	rsa2048_pubexp((RSA_NUMBER)DecryptSignature,
-			(RSA_NUMBER)SignaturePtr,
-			(u32)SpkExp,
-			(RSA_NUMBER)SpkModular,
-			(RSA_NUMBER)SpkModularEx);
+	RsaPubExp(Key, Ac + RSA_SPK_CERT_SIZE, DecryptSignature);
 	FsblPrintArray(DecryptSignature, RSA_PARTITION_SIGNATURE_SIZE,
 					"Partition Decrypted Hash");
 
@@ -17,6 +17,7 @@
 * ----- ---- -------- -------------------------------------------------------
 * 4.00a sg	02/28/13 Initial release
 * 5.0   vns     03/18/22 Modified prototype of AuthenticatePartition() API
+* 21.3  qm      10/14/26 Added AuthenticateSpk() and the SPK cache
 *
 * </pre>
 *
@@ -44,8 +45,25 @@ extern "C" {
 #define RSA_HEADER_SIZE					4 		/* Signature header size in bytes */
 #define RSA_MAGIC_WORD_SIZE				60		/* Magic word size in bytes */
 
+/*
+ * Certificate bytes up to the partition signature
+ */
+#define RSA_SPK_CERT_SIZE	(RSA_HEADER_SIZE + RSA_MAGIC_WORD_SIZE + \
+				RSA_PPK_MODULAR_SIZE + RSA_PPK_MODULAR_EXT_SIZE + \
+				RSA_PPK_EXPO_SIZE + RSA_SPK_MODULAR_SIZE + \
+				RSA_SPK_MODULAR_EXT_SIZE + RSA_SPK_EXPO_SIZE + \
+				RSA_SPK_SIGNATURE_SIZE)
+
+/*
+ * SPKs whose context is kept once authenticated by the PPK
+ */
+#ifndef RSA_SPK_CACHE_SIZE
+#define RSA_SPK_CACHE_SIZE		4
+#endif
+
 void SetPpk(void );
 u32 AuthenticatePartition(u8 *Ac, u8 *Hash);
+u32 AuthenticateSpk(u8 *Ac);
 u32 RecreatePaddingAndCheck(u8 *signature, u8 *hash);
 
 #ifdef __cplusplus
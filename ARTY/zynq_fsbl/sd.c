@@ -18,6 +18,10 @@
 * 1.00a jz	04/28/11 Initial release
 * 7.00a kc  10/18/13 Integrated SD/MMC driver
 * 12.00a ssc 12/11/14 Fix for CR# 839182
+* 21.3  qm  10/14/26 Seek BOOT.BIN through a cluster link map table built
+*                    once in InitSD
+*                    Print the sector cache counts in ReleaseSD
+*                    Print the negotiated bus mode in InitSD
 *
 * </pre>
 *
@@ -38,10 +42,25 @@
 #include "xstatus.h"
 
 #include "ff.h"
+#include "diskio.h"
 #include "sd.h"
 
 /************************** Constant Definitions *****************************/
 
+/*
+ * Items of the cluster link map table of the boot file, the item count, two
+ * items per fragment of the file and the terminator
+ */
+#if FF_USE_FASTSEEK
+#ifndef SD_CLMT_SIZE
+#ifdef FSBL_PROFILE_SD
+#define SD_CLMT_SIZE	512
+#else
+#define SD_CLMT_SIZE	64
+#endif
+#endif
+#endif
+
 /**************************** Type Definitions *******************************/
 
 /***************** Macros (Inline Functions) Definitions *********************/
@@ -57,6 +76,9 @@ static FIL fil;		/* File object */
 static FATFS fatfs;
 static char buffer[32];
 static char *boot_file = buffer;
+#if FF_USE_FASTSEEK
+static DWORD ClusterTable[SD_CLMT_SIZE];
+#endif
 
 /******************************************************************************/
 /******************************************************************************/
@@ -78,6 +100,9 @@ u32 InitSD(const char *filename)
 
 	FRESULT rc;
 	TCHAR *path = "0:/"; /* Logical drive number is 0 */
+	DWORD Width;
+	DWORD Clock;
+	BYTE HighSpeed;
 
 	/* Register volume work area, initialize device */
 	rc = f_mount(&fatfs, path, 0);
@@ -97,6 +122,31 @@ u32 InitSD(const char *filename)
 		return XST_FAILURE;
 	}
 
+	/*
+	 * Bus mode negotiated when the card was initialized by f_open
+	 */
+	if (disk_sd_mode(0, &Width, &Clock, &HighSpeed) == RES_OK) {
+		fsbl_printf(DEBUG_INFO,"SD: %lu bit bus, %lu kHz%s\n\r",
+				(u32)Width, (u32)(Clock / 1000U),
+				(HighSpeed != 0U) ? ", high speed" : "");
+	}
+
+#if FF_USE_FASTSEEK
+	/*
+	 * Map the clusters of the file once, so that the seeks of SDAccess
+	 * do not follow the FAT chain. A file in too many fragments for the
+	 * table is seeked through the FAT.
+	 */
+	fil.cltbl = ClusterTable;
+	ClusterTable[0] = SD_CLMT_SIZE;
+	rc = f_lseek(&fil, CREATE_LINKMAP);
+	if (rc != FR_OK) {
+		fsbl_printf(DEBUG_INFO,"SD: No link map, %d items needed\n\r",
+				ClusterTable[0]);
+		fil.cltbl = NULL;
+	}
+#endif
+
 	return XST_SUCCESS;
 
 }
@@ -154,6 +204,14 @@ u32 SDAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 *
 ****************************************************************************/
 void ReleaseSD(void) {
+#ifdef FILE_SYSTEM_USE_CACHE
+	DWORD Hits;
+	DWORD Misses;
+
+	disk_cache_stats(&Hits, &Misses);
+	fsbl_printf(DEBUG_INFO,"SD: sector cache %d hits %d misses\n\r",
+			Hits, Misses);
+#endif
 
 	f_close(&fil);
 	return;
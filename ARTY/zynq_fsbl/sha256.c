@@ -0,0 +1,377 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file sha256.c
+*
+* Contains code to calculate the SHA-256 hash of authenticated partitions
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+/****************************** Include Files *********************************/
+
+#ifdef RSA_SUPPORT
+#include "sha256.h"
+#include "xil_mem.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SHA256_NEON
+#endif
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Round constants, the first 32 bits of the fractional parts of the cube
+ * roots of the first 64 primes
+ */
+static const u32 Sha256K[ 64 ] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+#define SHA256_ROR( x, n )	( ( (x) >> (n) ) | ( (x) << ( 32 - (n) ) ) )
+
+#define SHA256_CH( x, y, z )	( (z) ^ ( (x) & ( (y) ^ (z) ) ) )
+#define SHA256_MAJ( x, y, z )	( ( (x) & (y) ) | ( (z) & ( (x) | (y) ) ) )
+
+#define SHA256_S0( x )	( SHA256_ROR( x, 2 ) ^ SHA256_ROR( x, 13 ) ^ \
+			  SHA256_ROR( x, 22 ) )
+#define SHA256_S1( x )	( SHA256_ROR( x, 6 ) ^ SHA256_ROR( x, 11 ) ^ \
+			  SHA256_ROR( x, 25 ) )
+#define SHA256_s0( x )	( SHA256_ROR( x, 7 ) ^ SHA256_ROR( x, 18 ) ^ \
+			  ( (x) >> 3 ) )
+#define SHA256_s1( x )	( SHA256_ROR( x, 17 ) ^ SHA256_ROR( x, 19 ) ^ \
+			  ( (x) >> 10 ) )
+
+/*
+ * One round. The callers rotate the names of the working variables instead
+ * of moving their values.
+ */
+#define SHA256_ROUND( a, b, c, d, e, f, g, h, t ) \
+	do { \
+		T1 = h + SHA256_S1( e ) + SHA256_CH( e, f, g ) + \
+		     Sha256K[ t ] + W[ t ]; \
+		h = T1 + SHA256_S0( a ) + SHA256_MAJ( a, b, c ); \
+		d += T1; \
+	} while( 0 )
+
+#ifdef SHA256_NEON
+/*
+ * Rotations and schedule functions on two and four words
+ */
+#define SHA256_ROR_Q( x, n )	vsriq_n_u32( vshlq_n_u32( x, 32 - (n) ), x, n )
+#define SHA256_ROR_D( x, n )	vsri_n_u32( vshl_n_u32( x, 32 - (n) ), x, n )
+
+#define SHA256_s0_Q( x )	veorq_u32( veorq_u32( SHA256_ROR_Q( x, 7 ), \
+				  SHA256_ROR_Q( x, 18 ) ), vshrq_n_u32( x, 3 ) )
+#define SHA256_s1_D( x )	veor_u32( veor_u32( SHA256_ROR_D( x, 17 ), \
+				  SHA256_ROR_D( x, 19 ) ), vshr_n_u32( x, 10 ) )
+#endif
+
+/************************** Function Prototypes ******************************/
+
+static void Sha256Transform( u32 *State, const u8 *Data );
+
+/******************************************************************************/
+/**
+*
+* This function computes the message schedule of a block, four words at a
+* time with NEON. W[ t ] depends on W[ t - 2 ], so the s1 term of the two
+* upper words of each group is taken from the two lower words once they
+* are done.
+*
+* @param	Data is the block, in any alignment
+*
+* @param	W is the schedule, 64 words
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+#ifdef SHA256_NEON
+static inline void Sha256Schedule( const u8 *Data, u32 *W )
+{
+	uint32x4_t Sum;
+	uint32x2_t Lo;
+	uint32x2_t Hi;
+	u32 t;
+
+	for( t = 0; t < 16; t += 4 ) {
+		vst1q_u32( &W[ t ], vreinterpretq_u32_u8(
+				vrev32q_u8( vld1q_u8( &Data[ t * 4 ] ) ) ) );
+	}
+
+	for( t = 16; t < 64; t += 4 ) {
+		Sum = vaddq_u32( vld1q_u32( &W[ t - 16 ] ),
+				 vld1q_u32( &W[ t - 7 ] ) );
+		Sum = vaddq_u32( Sum, SHA256_s0_Q( vld1q_u32( &W[ t - 15 ] ) ) );
+
+		Lo = vadd_u32( vget_low_u32( Sum ),
+			       SHA256_s1_D( vld1_u32( &W[ t - 2 ] ) ) );
+		Hi = vadd_u32( vget_high_u32( Sum ), SHA256_s1_D( Lo ) );
+
+		vst1q_u32( &W[ t ], vcombine_u32( Lo, Hi ) );
+	}
+}
+#else
+static inline void Sha256Schedule( const u8 *Data, u32 *W )
+{
+	const u32 *In = (const u32 *)Data;
+	u32 t;
+
+	for( t = 0; t < 16; t++ ) {
+		W[ t ] = __builtin_bswap32( In[ t ] );
+	}
+
+	for( t = 16; t < 64; t++ ) {
+		W[ t ] = SHA256_s1( W[ t - 2 ] ) + W[ t - 7 ] +
+			 SHA256_s0( W[ t - 15 ] ) + W[ t - 16 ];
+	}
+}
+#endif
+
+/******************************************************************************/
+/**
+*
+* This function adds one block to the hash. The rounds are unrolled by
+* eight, the period of the rotation of the working variables.
+*
+* @param	State is the intermediate hash
+*
+* @param	Data is the block, word aligned unless built with NEON
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+static void Sha256Transform( u32 *State, const u8 *Data )
+{
+	u32 W[ 64 ];
+	u32 a, b, c, d, e, f, g, h;
+	u32 T1;
+	u32 t;
+
+	Sha256Schedule( Data, W );
+
+	a = State[ 0 ];
+	b = State[ 1 ];
+	c = State[ 2 ];
+	d = State[ 3 ];
+	e = State[ 4 ];
+	f = State[ 5 ];
+	g = State[ 6 ];
+	h = State[ 7 ];
+
+	for( t = 0; t < 64; t += 8 ) {
+		SHA256_ROUND( a, b, c, d, e, f, g, h, t );
+		SHA256_ROUND( h, a, b, c, d, e, f, g, t + 1 );
+		SHA256_ROUND( g, h, a, b, c, d, e, f, t + 2 );
+		SHA256_ROUND( f, g, h, a, b, c, d, e, t + 3 );
+		SHA256_ROUND( e, f, g, h, a, b, c, d, t + 4 );
+		SHA256_ROUND( d, e, f, g, h, a, b, c, t + 5 );
+		SHA256_ROUND( c, d, e, f, g, h, a, b, t + 6 );
+		SHA256_ROUND( b, c, d, e, f, g, h, a, t + 7 );
+	}
+
+	State[ 0 ] += a;
+	State[ 1 ] += b;
+	State[ 2 ] += c;
+	State[ 3 ] += d;
+	State[ 4 ] += e;
+	State[ 5 ] += f;
+	State[ 6 ] += g;
+	State[ 7 ] += h;
+}
+
+/******************************************************************************/
+/**
+*
+* This function starts a hash
+*
+* @param	Context is the SHA-256 context
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+void Sha256Init( Sha256Context *Context )
+{
+	Context->State[ 0 ] = 0x6a09e667;
+	Context->State[ 1 ] = 0xbb67ae85;
+	Context->State[ 2 ] = 0x3c6ef372;
+	Context->State[ 3 ] = 0xa54ff53a;
+	Context->State[ 4 ] = 0x510e527f;
+	Context->State[ 5 ] = 0x9b05688c;
+	Context->State[ 6 ] = 0x1f83d9ab;
+	Context->State[ 7 ] = 0x5be0cd19;
+
+	Context->Length = 0;
+}
+
+/******************************************************************************/
+/**
+*
+* This function adds data to a hash. Whole blocks are hashed in place, from
+* any alignment with NEON and from word aligned data otherwise.
+*
+* @param	Context is the SHA-256 context
+*
+* @param	Data is the data
+*
+* @param	Len is the length of the data in bytes
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+void Sha256Update( Sha256Context *Context, const u8 *Data, u32 Len )
+{
+	u32 Used;
+	u32 Fill;
+
+	Used = (u32)Context->Length & ( SHA256_BLOCK_BYTE_SIZE - 1 );
+	Context->Length += Len;
+
+	/*
+	 * Complete the partial block first
+	 */
+	if( Used != 0 ) {
+		Fill = SHA256_BLOCK_BYTE_SIZE - Used;
+		if( Len < Fill ) {
+			Xil_MemCpy( (u8 *)Context->Block + Used, Data, Len );
+			return;
+		}
+
+		Xil_MemCpy( (u8 *)Context->Block + Used, Data, Fill );
+		Sha256Transform( Context->State, (const u8 *)Context->Block );
+
+		Data += Fill;
+		Len  -= Fill;
+	}
+
+	while( Len >= SHA256_BLOCK_BYTE_SIZE ) {
+#ifndef SHA256_NEON
+		if( ( (UINTPTR)Data & ( sizeof( u32 ) - 1U ) ) != 0U ) {
+			Xil_MemCpy( Context->Block, Data, SHA256_BLOCK_BYTE_SIZE );
+			Sha256Transform( Context->State,
+					 (const u8 *)Context->Block );
+		} else
+#endif
+		{
+			Sha256Transform( Context->State, Data );
+		}
+
+		Data += SHA256_BLOCK_BYTE_SIZE;
+		Len  -= SHA256_BLOCK_BYTE_SIZE;
+	}
+
+	Xil_MemCpy( Context->Block, Data, Len );
+}
+
+/******************************************************************************/
+/**
+*
+* This function pads the data with a one bit, zeros and the length in bits,
+* and returns the hash
+*
+* @param	Context is the SHA-256 context
+*
+* @param	Digest is the hash, SHA256_DIGEST_BYTE_SIZE bytes
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+void Sha256Final( Sha256Context *Context, u8 *Digest )
+{
+	u8 *Block = (u8 *)Context->Block;
+	u64 Bits = Context->Length << 3;
+	u32 Used;
+	u32 Index;
+
+	Used = (u32)Context->Length & ( SHA256_BLOCK_BYTE_SIZE - 1 );
+	Block[ Used++ ] = 0x80;
+
+	/*
+	 * The length goes in the last eight bytes, in a block of its own if
+	 * they are taken
+	 */
+	if( Used > SHA256_BLOCK_BYTE_SIZE - 8 ) {
+		Xil_MemSet( Block + Used, 0, SHA256_BLOCK_BYTE_SIZE - Used );
+		Sha256Transform( Context->State, Block );
+		Used = 0;
+	}
+
+	Xil_MemSet( Block + Used, 0, SHA256_BLOCK_BYTE_SIZE - 8 - Used );
+	Context->Block[ 14 ] = __builtin_bswap32( (u32)( Bits >> 32 ) );
+	Context->Block[ 15 ] = __builtin_bswap32( (u32)Bits );
+	Sha256Transform( Context->State, Block );
+
+	for( Index = 0; Index < 8; Index++ ) {
+		Digest[ Index * 4 ]     = (u8)( Context->State[ Index ] >> 24 );
+		Digest[ Index * 4 + 1 ] = (u8)( Context->State[ Index ] >> 16 );
+		Digest[ Index * 4 + 2 ] = (u8)( Context->State[ Index ] >> 8 );
+		Digest[ Index * 4 + 3 ] = (u8)Context->State[ Index ];
+	}
+}
+
+/******************************************************************************/
+/**
+*
+* This function calculates the hash of 'Len' bytes at 'Data' in one call
+*
+* @param	Data is the data
+*
+* @param	Len is the length of the data in bytes
+*
+* @param	Digest is the hash, SHA256_DIGEST_BYTE_SIZE bytes
+*
+* @return	None
+*
+* @note		None
+*
+****************************************************************************/
+void Sha256( const u8 *Data, u32 Len, u8 *Digest )
+{
+	Sha256Context Context;
+
+	Sha256Init( &Context );
+	Sha256Update( &Context, Data, Len );
+	Sha256Final( &Context, Digest );
+}
+#endif
@@ -0,0 +1,71 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file sha256.h
+*
+* This file contains the SHA-256 engine used to hash the authenticated
+* partitions.
+*
+* The hash is incremental, so that the partition mover can feed it each
+* chunk as it lands in DDR, instead of a second pass over the whole image
+* once it is loaded. The message schedule is computed four words at a time
+* with NEON when the file is built with it, which the FSBL CMakeLists.txt
+* does, and in C otherwise.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver	Who	Date		Changes
+* ----- ---- -------- -------------------------------------------------------
+* 21.3  qm	10/14/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef ___SHA256_H___
+#define ___SHA256_H___
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+#define SHA256_BLOCK_BYTE_SIZE	64
+#define SHA256_DIGEST_BYTE_SIZE	32
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32	State[ 8 ];		/* Intermediate hash */
+	u64	Length;			/* Bytes hashed */
+	u32	Block[ SHA256_BLOCK_BYTE_SIZE / 4 ]; /* Partial block */
+} Sha256Context;
+
+/************************** Function Prototypes ******************************/
+
+void Sha256Init( Sha256Context *Context );
+
+void Sha256Update( Sha256Context *Context, const u8 *Data, u32 Len );
+
+void Sha256Final( Sha256Context *Context, u8 *Digest );
+
+void Sha256( const u8 *Data, u32 Len, u8 *Digest );
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* ___SHA256_H___ */
@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+"""Make the boot manifest of FSBL_MANIFEST for a boot image.
+
+Reads a BOOT.BIN made by bootgen and writes the manifest fsbl_manifest.h
+describes: the SHA-256 of each chunk of the plain PS partitions of the
+image, those that are neither encrypted, signed nor compressed, the root
+of each partition over its chunk hashes and the root of the manifest over
+the partitions. The FSBL finds a partition in it by its load address and
+image length, so the manifest made from an image without it stays valid
+once it is added:
+
+    boot_manifest.py BOOT.BIN -o manifest.bin --chunk 0x10000
+
+and then, in the .bif, right after the FSBL, signed for an image with RSA
+authentication so that the chunks are as trusted as the signature:
+
+    [load=0x1FFC0000, checksum=md5] manifest.bin
+    [load=0x1FFC0000, authentication=rsa] manifest.bin
+
+--addr is FSBL_MANIFEST_ADDR of the FSBL build, the last 256 KB of the
+512 MB of DDR of the Arty Z7-20 by default; a partition loaded over the
+manifest is refused. --list prints the chunks of each partition.
+"""
+
+import argparse
+import hashlib
+import struct
+import sys
+
+from boot_pack import (IMAGE_PHDR_OFFSET, IDENT, MAX_PARTITIONS, PART_HEADER,
+                       SOURCE_ADDR_OFFSET, WIDTH_CHECK_OFFSET, WIDTH_DETECT,
+                       HEADER_CHECKSUM, header_checksum, word)
+
+MAGIC = 0x31464D46
+HEADER = struct.Struct("<4I32s")
+ENTRY = struct.Struct("<4I32s")
+DIGEST = 32
+MAX_SIZE = 0x40000
+MAX_ENTRIES = 14
+MIN_SHIFT = 12
+MAX_SHIFT = 24
+
+IMAGE_WORD_LEN = 0
+DATA_WORD_LEN = 1
+LOAD_ADDR = 3
+PARTITION_START = 5
+ATTRIBUTE = 6
+
+ATTR_TYPE = 0xF0
+ATTR_PS = 0x10
+ATTR_RSA = 0x8000
+ATTR_OWNER = 0x30000
+ATTR_COMPRESSED = 0x1000000
+XIP_WINDOW = (0xFC000000, 0xFE000000)
+
+DEFAULT_ADDR = 0x1FFC0000
+DEFAULT_CHUNK = 0x10000
+
+
+def partitions(image):
+    """Return the (number, load address, data) of the plain PS partitions."""
+    if (len(image) < IMAGE_PHDR_OFFSET + 4 or
+            word(image, WIDTH_CHECK_OFFSET) != WIDTH_DETECT or
+            word(image, WIDTH_CHECK_OFFSET + 4) != IDENT):
+        sys.exit("not a Zynq-7000 boot image")
+    fsbl = word(image, SOURCE_ADDR_OFFSET)
+    table = word(image, IMAGE_PHDR_OFFSET)
+    out = []
+    for index in range(MAX_PARTITIONS):
+        fields = PART_HEADER.unpack_from(image, table + index * PART_HEADER.size)
+        if not any(fields[:HEADER_CHECKSUM]):
+            break
+        if fields[HEADER_CHECKSUM] != header_checksum(fields):
+            sys.exit("partition %d: bad header checksum" % index)
+        attr = fields[ATTRIBUTE]
+        start = fields[PARTITION_START] * 4
+        length = fields[IMAGE_WORD_LEN] * 4
+        load = fields[LOAD_ADDR]
+        if (start == fsbl or attr & ATTR_TYPE != ATTR_PS or
+                attr & (ATTR_RSA | ATTR_OWNER | ATTR_COMPRESSED) or
+                fields[DATA_WORD_LEN] != fields[IMAGE_WORD_LEN] or
+                not load or not length or
+                XIP_WINDOW[0] <= load < XIP_WINDOW[1]):
+            continue
+        if start + length > len(image):
+            sys.exit("partition %d beyond the end of the image" % index)
+        out.append((index, load, image[start:start + length]))
+    return out
+
+
+def build(parts, shift, addr):
+    """Return the manifest of the partitions, chunks of 1 << shift bytes."""
+    chunk = 1 << shift
+    entries = []
+    leaves = []
+    for _, load, data in parts:
+        hashes = [hashlib.sha256(data[offset:offset + chunk]).digest()
+                  for offset in range(0, len(data), chunk)]
+        entries.append(ENTRY.pack(load, len(data), len(leaves), len(hashes),
+                                  hashlib.sha256(b"".join(hashes)).digest()))
+        leaves.extend(hashes)
+    body = b"".join(entries)
+    manifest = (HEADER.pack(MAGIC, shift, len(entries), len(leaves),
+                            hashlib.sha256(body).digest()) +
+                body + b"".join(leaves))
+    if len(manifest) > MAX_SIZE:
+        sys.exit("manifest of %d bytes, more than 0x%X; use larger chunks"
+                 % (len(manifest), MAX_SIZE))
+    for index, load, data in parts:
+        if load < addr + len(manifest) and addr < load + len(data):
+            sys.exit("partition %d at 0x%08X overlaps the manifest at 0x%08X"
+                     % (index, load, addr))
+    return manifest
+
+
+def number(text):
+    return int(text, 0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("image", help="BOOT.BIN made by bootgen")
+    parser.add_argument("-o", "--output", help="manifest to write")
+    parser.add_argument("--chunk", type=number, default=DEFAULT_CHUNK,
+                        help="chunk size, default 0x%X" % DEFAULT_CHUNK)
+    parser.add_argument("--addr", type=number, default=DEFAULT_ADDR,
+                        help="load address of the manifest, default 0x%X"
+                        % DEFAULT_ADDR)
+    parser.add_argument("--list", action="store_true",
+                        help="print the partitions and their chunks")
+    args = parser.parse_args()
+
+    shift = args.chunk.bit_length() - 1
+    if (args.chunk & (args.chunk - 1) or
+            not MIN_SHIFT <= shift <= MAX_SHIFT):
+        sys.exit("--chunk must be a power of two from 4 KB to 16 MB")
+
+    with open(args.image, "rb") as f:
+        image = f.read()
+    # a manifest already in the image is not listed in the new one
+    parts = [part for part in partitions(image) if part[1] != args.addr]
+    if not parts:
+        sys.exit("no plain PS partitions")
+    if len(parts) > MAX_ENTRIES:
+        sys.exit("more than %d partitions" % MAX_ENTRIES)
+    manifest = build(parts, shift, args.addr)
+
+    if args.list:
+        for index, load, data in parts:
+            print("partition %2d  load 0x%08X  %8d bytes  %4d chunks"
+                  % (index, load, len(data),
+                     (len(data) + args.chunk - 1) // args.chunk))
+        print("manifest %d bytes" % len(manifest))
+    if args.output:
+        with open(args.output, "wb") as f:
+            f.write(manifest)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,208 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+"""Lay out the partitions of a boot image for the reads of image_mover.c.
+
+Reads a BOOT.BIN made by bootgen and writes the same image with its
+partitions moved, so that each read the FSBL makes of the boot device is
+large, sequential and aligned:
+
+    - the boot header, the header tables and the FSBL stay where they are,
+      in the first bytes the image header cache of image_mover.c reads at
+      once, IMAGE_HEADER_CACHE_SIZE;
+    - the other partitions follow in the order of their partition headers,
+      the order the FSBL loads them in, each at an erase block boundary and
+      so at a page boundary;
+    - a partition that would cross a 16 MB bank of the QSPI flash, which
+      makes QspiAccess() split the read and send a bank select, starts at
+      the next bank instead when it fits in one;
+    - the MD5 checksum of a partition follows its data.
+
+The partition headers get the new offsets and header checksums, the gaps
+are 0xFF, as erased. Encrypted partitions move as they are, images with
+RSA authentication, whose certificates cover the headers, are refused.
+--base gives the offset the image is programmed at in the flash, for the
+banks, and --map lists the layout.
+
+    boot_pack.py BOOT.BIN -o BOOT_packed.BIN
+    boot_pack.py BOOT.BIN --base 0x100000 --erase 0x1000 --map
+"""
+
+import argparse
+import struct
+import sys
+
+WIDTH_DETECT = 0xAA995566
+IDENT = 0x584C4E58
+WIDTH_CHECK_OFFSET = 0x020
+SOURCE_ADDR_OFFSET = 0x030
+IMAGE_HDR_OFFSET = 0x098
+IMAGE_PHDR_OFFSET = 0x09C
+HEADER_CACHE_SIZE = 0x1000
+
+PART_HEADER = struct.Struct("<16I")
+WORD_LEN = (0, 1, 2)
+PARTITION_START = 5
+CHECKSUM_OFFSET = 8
+AC_OFFSET = 10
+HEADER_CHECKSUM = 15
+IHT_AUTH_OFFSET = 0x10
+MAX_PARTITIONS = 14
+MD5_SIZE = 16
+
+PAGE = 0x100
+ERASE = 0x10000
+BANK = 0x1000000
+
+
+def word(image, offset):
+    return struct.unpack_from("<I", image, offset)[0]
+
+
+def header_checksum(fields):
+    return ~sum(fields[:HEADER_CHECKSUM]) & 0xFFFFFFFF
+
+
+def align(value, boundary):
+    return (value + boundary - 1) // boundary * boundary
+
+
+def parse(image):
+    """Return the partition header offset and the partition headers."""
+    if (len(image) < IMAGE_PHDR_OFFSET + 4 or
+            word(image, WIDTH_CHECK_OFFSET) != WIDTH_DETECT or
+            word(image, WIDTH_CHECK_OFFSET + 4) != IDENT):
+        sys.exit("not a Zynq-7000 boot image")
+    iht = word(image, IMAGE_HDR_OFFSET)
+    if iht and word(image, iht + IHT_AUTH_OFFSET):
+        sys.exit("the headers are authenticated, cannot move partitions")
+    table = word(image, IMAGE_PHDR_OFFSET)
+    headers = []
+    for index in range(MAX_PARTITIONS):
+        offset = table + index * PART_HEADER.size
+        fields = list(PART_HEADER.unpack_from(image, offset))
+        if not any(fields[:HEADER_CHECKSUM]):
+            break
+        if fields[HEADER_CHECKSUM] != header_checksum(fields):
+            sys.exit("partition %d: bad header checksum" % index)
+        if fields[AC_OFFSET]:
+            sys.exit("partition %d is authenticated, cannot move it" % index)
+        headers.append(fields)
+    if not headers:
+        sys.exit("no partitions")
+    return table, headers
+
+
+def blocks(image, headers):
+    """Return the (start, length) of the data and checksum of each header."""
+    out = []
+    for fields in headers:
+        data = (fields[PARTITION_START] * 4,
+                max(fields[i] for i in WORD_LEN) * 4)
+        checksum = None
+        if fields[CHECKSUM_OFFSET]:
+            checksum = (fields[CHECKSUM_OFFSET] * 4, MD5_SIZE)
+        for start, length in (data, checksum or (0, 0)):
+            if start + length > len(image):
+                sys.exit("partition beyond the end of the image")
+        out.append((data, checksum))
+    return out
+
+
+def layout(image, table, headers, base, page, erase, bank):
+    """Return the packed image and its map."""
+    fsbl = word(image, SOURCE_ADDR_OFFSET)
+    parts = blocks(image, headers)
+    moved = [start for data, checksum in parts
+             for start, _ in (data, checksum or (0, 0))
+             if start and start != fsbl]
+    fixed = min(moved) if moved else len(image)
+    headers_end = table + (len(headers) + 1) * PART_HEADER.size
+    if headers_end > fixed:
+        sys.exit("the partition headers follow the partitions")
+    for (start, length), _ in parts:
+        if start == fsbl and start + length > fixed:
+            sys.exit("the FSBL follows the partitions")
+
+    out = bytearray(image[:fixed])
+    cursor = fixed
+    entries = []
+    for index, (fields, (data, checksum)) in enumerate(zip(headers, parts)):
+        start, length = data
+        if start != fsbl:
+            cursor = align(cursor, max(page, erase))
+            first, last = base + cursor, base + cursor + length - 1
+            if first // bank != last // bank and length <= bank:
+                cursor = align(base + cursor, bank) - base
+            out += b"\xFF" * (cursor - len(out))
+            out += image[start:start + length]
+            fields[PARTITION_START] = cursor // 4
+            start = cursor
+            cursor += length
+        if checksum and checksum[0] >= fixed:
+            cursor = align(cursor, MD5_SIZE)
+            out += b"\xFF" * (cursor - len(out))
+            out += image[checksum[0]:checksum[0] + MD5_SIZE]
+            fields[CHECKSUM_OFFSET] = cursor // 4
+            cursor += MD5_SIZE
+        fields[HEADER_CHECKSUM] = header_checksum(fields)
+        PART_HEADER.pack_into(out, table + index * PART_HEADER.size, *fields)
+        entries.append((index, start, length, fields))
+    return out, entries, headers_end
+
+
+def report(image, packed, entries, headers_end, base, bank):
+    print("headers end 0x%05X, %s the image header cache of 0x%X"
+          % (headers_end, "within" if headers_end <= HEADER_CACHE_SIZE
+             else "BEYOND", HEADER_CACHE_SIZE))
+    print("%-3s %10s %10s %10s %5s %s" % ("#", "offset", "length",
+                                          "load", "bank", "checksum"))
+    for index, start, length, fields in entries:
+        first, last = base + start, base + start + max(length, 1) - 1
+        banks = "%d" % (first // bank) if first // bank == last // bank \
+            else "%d-%d" % (first // bank, last // bank)
+        print("%-3d 0x%08X 0x%08X 0x%08X %5s %s"
+              % (index, start, length, fields[3], banks,
+                 "0x%08X" % (fields[CHECKSUM_OFFSET] * 4)
+                 if fields[CHECKSUM_OFFSET] else "-"))
+    print("%d bytes, %d before" % (len(packed), len(image)))
+
+
+def number(text):
+    return int(text, 0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("image", help="BOOT.BIN made by bootgen")
+    parser.add_argument("-o", "--output", help="packed boot image to write")
+    parser.add_argument("--base", type=number, default=0,
+                        help="offset of the image in the flash")
+    parser.add_argument("--page", type=number, default=PAGE,
+                        help="page size, default 0x%X" % PAGE)
+    parser.add_argument("--erase", type=number, default=ERASE,
+                        help="erase block size, default 0x%X" % ERASE)
+    parser.add_argument("--bank", type=number, default=BANK,
+                        help="bank size, default 0x%X" % BANK)
+    parser.add_argument("--map", action="store_true",
+                        help="list the partitions of the packed image")
+    args = parser.parse_args()
+
+    for name in ("page", "erase", "bank"):
+        value = getattr(args, name)
+        if value <= 0 or value & (value - 1):
+            sys.exit("--%s must be a power of two" % name)
+
+    with open(args.image, "rb") as f:
+        image = f.read()
+    table, headers = parse(image)
+    packed, entries, headers_end = layout(image, table, headers, args.base,
+                                          args.page, args.erase, args.bank)
+    if args.map:
+        report(image, packed, entries, headers_end, args.base, args.bank)
+    if args.output:
+        with open(args.output, "wb") as f:
+            f.write(packed)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,226 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+"""Pack the register tables of ps7_init.c for the replay of ps7_pack.h.
+
+Reads the EMIT_* tables of ps7_init.c and writes a C file with one packed
+table per table, named after it with a _pack suffix. A packed entry is a
+header word, (op << 24) | count, and its arguments:
+
+    PS7_PACK_WRITE      address, count values for address, address + 4, ...
+    PS7_PACK_MASKWRITE  address, count (mask, value) pairs, likewise
+    PS7_PACK_MASKPOLL   address, mask
+    PS7_PACK_MASKDELAY  timer address, delay in ms
+    PS7_PACK_EXIT
+
+Each table keeps its register accesses in their order. A masked write
+with a full mask and a clear become plain writes, a masked write that
+repeats the one just before it is dropped, and runs of writes to
+consecutive registers share their header and address.
+
+Writes to the same register are only merged with --coalesce: a later
+masked write is folded into the one before it when it touches none of its
+bits, and one that covers all of its bits replaces it. This drops the
+pulses of reset and bypass bits, so the build does not use it; --stats
+lists the candidates.
+
+    ps7_pack.py ps7_init.c -o ps7_init_pack.c
+    ps7_pack.py ps7_init.c --stats
+"""
+
+import argparse
+import re
+import sys
+
+OP_EXIT = 0
+OP_WRITE = 1
+OP_MASKWRITE = 2
+OP_MASKPOLL = 3
+OP_MASKDELAY = 4
+
+OP_NAMES = {
+    OP_EXIT: "PS7_PACK_EXIT",
+    OP_WRITE: "PS7_PACK_WRITE",
+    OP_MASKWRITE: "PS7_PACK_MASKWRITE",
+    OP_MASKPOLL: "PS7_PACK_MASKPOLL",
+    OP_MASKDELAY: "PS7_PACK_MASKDELAY",
+}
+
+MAX_COUNT = 0xFFFFFF
+FULL_MASK = 0xFFFFFFFF
+
+TABLE = re.compile(r"unsigned\s+long\s+(\w+)\s*\[\s*\]\s*=\s*\{(.*?)\};",
+                   re.S)
+EMIT = re.compile(r"EMIT_(\w+)\s*\(([^)]*)\)")
+COMMENT = re.compile(r"/\*.*?\*/|//[^\n]*", re.S)
+
+
+def number(text):
+    """Return the value of a C integer constant."""
+    return int(text.strip().rstrip("uUlL"), 0)
+
+
+def parse(path):
+    """Return [(name, [(kind, args)])] for the tables of the file at path.
+
+    The original size in words is returned with each table too.
+    """
+    with open(path) as f:
+        src = COMMENT.sub("", f.read())
+    tables = []
+    for match in TABLE.finditer(src):
+        ops = []
+        words = 0
+        for kind, args in EMIT.findall(match.group(2)):
+            values = [number(a) for a in args.split(",") if a.strip()]
+            ops.append((kind, values))
+            words += 1 + len(values)
+        if ops:
+            tables.append((match.group(1), ops, words))
+    return tables
+
+
+def normalize(ops):
+    """Turn the EMIT_* entries into (op, address, mask, value) accesses."""
+    accesses = []
+    for kind, args in ops:
+        if kind == "EXIT":
+            break
+        if kind == "CLEAR":
+            accesses.append((OP_WRITE, args[0], FULL_MASK, 0))
+        elif kind == "WRITE":
+            accesses.append((OP_WRITE, args[0], FULL_MASK, args[1]))
+        elif kind == "MASKWRITE":
+            addr, mask, value = args
+            if mask == FULL_MASK:
+                accesses.append((OP_WRITE, addr, FULL_MASK, value))
+            else:
+                accesses.append((OP_MASKWRITE, addr, mask, value & mask))
+        elif kind == "MASKPOLL":
+            accesses.append((OP_MASKPOLL, args[0], args[1], 0))
+        elif kind == "MASKDELAY":
+            accesses.append((OP_MASKDELAY, args[0], args[1], 0))
+        else:
+            sys.exit("unknown entry EMIT_%s" % kind)
+    return accesses
+
+
+def is_write(access):
+    return access[0] in (OP_WRITE, OP_MASKWRITE)
+
+
+def same_register(accesses):
+    """Return the pairs of consecutive writes to the same register."""
+    return [(a, b) for a, b in zip(accesses, accesses[1:])
+            if is_write(a) and is_write(b) and a[1] == b[1]]
+
+
+def drop_repeats(accesses):
+    """Drop the writes that repeat the write just before them."""
+    out = []
+    for access in accesses:
+        if out and is_write(access) and out[-1] == access:
+            continue
+        out.append(access)
+    return out
+
+
+def coalesce(accesses):
+    """Merge the consecutive writes to the same register, see --coalesce."""
+    out = []
+    for access in accesses:
+        prev = out[-1] if out else None
+        if (prev is not None and is_write(prev) and is_write(access) and
+                prev[1] == access[1]):
+            _, addr, mask, value = access
+            if (prev[2] & mask) == 0 or (prev[2] & ~mask) == 0:
+                mask_all = prev[2] | mask
+                value_all = (prev[3] & ~mask) | value
+                op = OP_WRITE if mask_all == FULL_MASK else OP_MASKWRITE
+                out[-1] = (op, addr, mask_all, value_all & mask_all)
+                continue
+        out.append(access)
+    return out
+
+
+def pack(accesses):
+    """Return the packed entries of the accesses, as lists of C words."""
+    entries = []
+    i = 0
+    while i < len(accesses):
+        op, addr, mask, value = accesses[i]
+        if op in (OP_MASKPOLL, OP_MASKDELAY):
+            entries.append(["%s(1)" % OP_NAMES[op], "0x%08XU" % addr,
+                            "0x%08XU" % mask])
+            i += 1
+            continue
+        run = 1
+        while (i + run < len(accesses) and run < MAX_COUNT and
+               accesses[i + run][0] == op and
+               accesses[i + run][1] == addr + 4 * run):
+            run += 1
+        entry = ["%s(%d)" % (OP_NAMES[op], run), "0x%08XU" % addr]
+        for _, _, mask, value in accesses[i:i + run]:
+            if op == OP_MASKWRITE:
+                entry.append("0x%08XU" % mask)
+            entry.append("0x%08XU" % value)
+        entries.append(entry)
+        i += run
+    entries.append(["%s(0)" % OP_NAMES[OP_EXIT]])
+    return entries
+
+
+def size(entries):
+    return sum(len(entry) for entry in entries)
+
+
+def emit(out, source, tables):
+    out.write("/*\n"
+              " * Generated by tools/ps7_pack.py from %s, do not edit.\n"
+              " * See ps7_pack.h for the format.\n"
+              " */\n\n" % source)
+    out.write('#include "ps7_pack.h"\n')
+    for name, entries, original in tables:
+        out.write("\n/* %d words, %d in ps7_init.c */\n"
+                  % (size(entries), original))
+        out.write("u32 %s_pack[] = {\n" % name)
+        for entry in entries:
+            out.write("\t%s,\n" % ", ".join(entry[:2]))
+            for k in range(2, len(entry), 4):
+                out.write("\t\t%s,\n" % ", ".join(entry[k:k + 4]))
+        out.write("};\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("source", help="ps7_init.c")
+    parser.add_argument("-o", "--output", help="packed C file to write")
+    parser.add_argument("--coalesce", action="store_true",
+                        help="merge the writes to the same register")
+    parser.add_argument("--stats", action="store_true",
+                        help="report the sizes and the same register writes")
+    args = parser.parse_args()
+
+    packed = []
+    for name, ops, original in parse(args.source):
+        accesses = drop_repeats(normalize(ops))
+        pairs = same_register(accesses)
+        if args.coalesce:
+            accesses = coalesce(accesses)
+        entries = pack(accesses)
+        packed.append((name, entries, original))
+        if args.stats:
+            print("%-32s %5d -> %5d words, %d same register pairs"
+                  % (name, original, size(entries), len(pairs)))
+            for a, b in pairs:
+                print("    0x%08X mask 0x%08X then mask 0x%08X"
+                      % (a[1], a[2], b[2]))
+
+    if not packed:
+        sys.exit("%s: no EMIT_* tables" % args.source)
+    if args.output:
+        with open(args.output, "w") as out:
+            emit(out, args.source.split("/")[-1], packed)
+
+
+if __name__ == "__main__":
+    main()
@@ -48,6 +48,15 @@
 * 2.5 hk      08/16/19   Add a memory barrier before DMASEV as per specification.
 * 2.6 hk      02/14/20   Correct boundary check for Channel.
 * 2.7 aj      12/07/23   Fixed changes to support system device tree flow
+* 2.10 qm     10/14/26   Skip the cache maintenance of buffers in the DMA
+*                         arena of xil_dmaarena.h.
+*                         Added XDmaPs_GenSgDmaProg() to run a scatter-gather
+*                         list as one DMA program.
+*                         Cache the generated programs per channel and only
+*                         patch SAR and DAR for a transfer of a known shape.
+*                         Added per channel submission queues chained by the
+*                         done ISR.
+*                         Added the burst table of XDmaPs_SetBurst().
 *
 * </pre>
 *
@@ -61,6 +70,9 @@
 #include "xdmaps.h"
 #include "xil_io.h"
 #include "xil_cache.h"
+#include "xil_dmaarena.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
 
 #include "xil_printf.h"
 
@@ -91,6 +103,16 @@ static void XDmaPs_DoneISR_n(XDmaPs *InstPtr, unsigned Channel);
 static void *XDmaPs_BufPool_Allocate(XDmaPs_ProgBuf *Pool);
 static int XDmaPs_BuildDmaProg(unsigned Channel, XDmaPs_Cmd *Cmd,
 			       unsigned CacheLength);
+static int XDmaPs_BuildSegment(unsigned Channel, char *DmaProgStart,
+			       char *DmaProgBuf, XDmaPs_ChanCtrl *ChanCtrl,
+			       XDmaPs_BD *BD, unsigned CacheLength);
+static int XDmaPs_CheckBD(XDmaPs_ChanCtrl *ChanCtrl, XDmaPs_BD *BD);
+static void XDmaPs_SyncBD(XDmaPs_ChanCtrl *ChanCtrl, XDmaPs_BD *BD);
+static int XDmaPs_SgPending(XDmaPs *InstPtr, unsigned Channel,
+			    XDmaPs_Cmd *DmaCmd);
+static void *XDmaPs_ProgCacheGet(XDmaPs *InstPtr, unsigned int Channel,
+				 XDmaPs_Cmd *Cmd);
+static void XDmaPs_StartQueued(XDmaPs *InstPtr, unsigned int Channel);
 
 static void XDmaPs_Print_DmaProgBuf(char *Buf, int Length);
 
@@ -98,6 +120,17 @@ static void XDmaPs_Print_DmaProgBuf(char *Buf, int Length);
 
 /************************** Variable Definitions ****************************/
 
+/*
+ * Burst shapes used until the measured ones of a benchmark are set with
+ * XDmaPs_SetBurstTable(): the widest bursts of the 64-bit DMAC between the
+ * DDR and the low OCM, and 4 beats of 4 bytes, the 32-bit width of the PL
+ * slaves, for anything else.
+ */
+static const XDmaPs_BurstRule XDmaPs_DefaultBurstTable[] = {
+	{0x00000000U, 0x3FFFFFFFU, 0x00000000U, 0x3FFFFFFFU, 8, 16},
+	{0x00000000U, 0xFFFFFFFFU, 0x00000000U, 0xFFFFFFFFU, 4, 4}
+};
+
 /****************************************************************************/
 /**
 *
@@ -168,6 +201,10 @@ int XDmaPs_CfgInitialize(XDmaPs *InstPtr,
 
 	InstPtr->CacheLength = CacheLength;
 
+	InstPtr->BurstTable = XDmaPs_DefaultBurstTable;
+	InstPtr->NumBurstRules = sizeof(XDmaPs_DefaultBurstTable) /
+				 sizeof(XDmaPs_DefaultBurstTable[0]);
+
 	memset(InstPtr->Chans, 0,
 	       sizeof(XDmaPs_ChannelData[XDMAPS_CHANNELS_PER_DEV]));
 
@@ -331,6 +368,8 @@ void XDmaPs_FaultISR(XDmaPs *InstPtr)
 						      DmaCmd,
 						      InstPtr->FaultRef);
 
+			/* carry on with the queue of the channel */
+			XDmaPs_StartQueued(InstPtr, Chan);
 		}
 	}
 
@@ -1088,20 +1127,71 @@ int XDmaPs_ConstructNestedLoop(char *DmaProgStart,
 *****************************************************************************/
 static int XDmaPs_BuildDmaProg(unsigned Channel, XDmaPs_Cmd *Cmd,
 			       unsigned CacheLength)
+{
+	char *DmaProgBuf = (char *)Cmd->GeneratedDmaProg;
+	char *DmaProgStart = DmaProgBuf;
+	int SegmentBytes;
+	int DmaProgBytes;
+
+	SegmentBytes = XDmaPs_BuildSegment(Channel, DmaProgStart, DmaProgBuf,
+					   &Cmd->ChanCtrl, &Cmd->BD,
+					   CacheLength);
+	if (SegmentBytes == 0) {
+		return 0;
+	}
+	DmaProgBuf += SegmentBytes;
+
+	/* Add a memory barrier before DMASSEV as recommended by spec */
+	DmaProgBuf += XDmaPs_Instr_DMAWMB(DmaProgBuf);
+	DmaProgBuf += XDmaPs_Instr_DMASEV(DmaProgBuf, Channel);
+	DmaProgBuf += XDmaPs_Instr_DMAEND(DmaProgBuf);
+
+	DmaProgBytes = DmaProgBuf - DmaProgStart;
+
+	Xil_DCacheFlushRange((u32)DmaProgStart, DmaProgBytes);
+
+	return DmaProgBytes;
+
+}
+
+/****************************************************************************/
+/**
+*
+* Construct the part of a DMA program that moves one block: the DMAMOVs of
+* SAR and DAR, the unaligned head, the burst loops and the tail. The
+* caller adds the DMASEV and the DMAEND.
+*
+* @param	Channel DMA channel number
+* @param	DmaProgStart is the very start address of the DMA program.
+*		This is used to calculate whether the loop is in a cache line.
+* @param	DmaProgBuf is where the instructions are written.
+* @param	ChanCtrl is the channel control of the transfer.
+* @param	BD is the block to be moved.
+* @param	CacheLength is the icache line length, in terms of bytes.
+*		If it's zero, the performance enhancement feature will be
+*		turned off.
+*
+* @returns	The number of bytes written, 0 if the block does not fit in
+*		a 2-level loop. At most XDMAPS_SG_SEG_MAX_PROG_LEN bytes are
+*		written.
+*
+* @note		None.
+*
+*****************************************************************************/
+static int XDmaPs_BuildSegment(unsigned Channel, char *DmaProgStart,
+			       char *DmaProgBuf, XDmaPs_ChanCtrl *ChanCtrl,
+			       XDmaPs_BD *BD, unsigned CacheLength)
 {
 	/*
 	 * unpack arguments
 	 */
-	char *DmaProgBuf = (char *)Cmd->GeneratedDmaProg;
-	unsigned DevChan = Channel;
-	unsigned long DmaLength = Cmd->BD.Length;
-	u32 SrcAddr = Cmd->BD.SrcAddr;
-
-	unsigned SrcInc = Cmd->ChanCtrl.SrcInc;
-	u32 DstAddr = Cmd->BD.DstAddr;
-	unsigned DstInc = Cmd->ChanCtrl.DstInc;
+	char *DmaProgSegStart = DmaProgBuf;
+	unsigned long DmaLength = BD->Length;
+	u32 SrcAddr = BD->SrcAddr;
 
-	char *DmaProgStart = DmaProgBuf;
+	unsigned SrcInc = ChanCtrl->SrcInc;
+	u32 DstAddr = BD->DstAddr;
+	unsigned DstInc = ChanCtrl->DstInc;
 
 	unsigned int BurstBytes;
 	unsigned int LoopCount;
@@ -1109,7 +1199,6 @@ static int XDmaPs_BuildDmaProg(unsigned Channel, XDmaPs_Cmd *Cmd,
 	unsigned int LoopResidue = 0;
 	unsigned int TailBytes;
 	unsigned int TailWords;
-	int DmaProgBytes;
 	u32 CCRValue;
 	unsigned int Unaligned;
 	unsigned int UnalignedCount;
@@ -1119,7 +1208,6 @@ static int XDmaPs_BuildDmaProg(unsigned Channel, XDmaPs_Cmd *Cmd,
 	unsigned int SrcUnaligned = 0;
 	unsigned int DstUnaligned = 0;
 
-	XDmaPs_ChanCtrl *ChanCtrl;
 	XDmaPs_ChanCtrl WordChanCtrl;
 	static XDmaPs_ChanCtrl Mem2MemByteCC;
 
@@ -1135,8 +1223,6 @@ static int XDmaPs_BuildDmaProg(unsigned Channel, XDmaPs_Cmd *Cmd,
 	Mem2MemByteCC.SrcBurstSize = 1;
 	Mem2MemByteCC.SrcInc = 1;
 
-	ChanCtrl = &Cmd->ChanCtrl;
-
 	/* insert DMAMOV for SAR and DAR */
 	DmaProgBuf += XDmaPs_Instr_DMAMOV(DmaProgBuf,
 					  XDMAPS_MOV_SAR,
@@ -1304,17 +1390,7 @@ static int XDmaPs_BuildDmaProg(unsigned Channel, XDmaPs_Cmd *Cmd,
 		}
 	}
 
-	/* Add a memory barrier before DMASSEV as recommended by spec */
-	DmaProgBuf += XDmaPs_Instr_DMAWMB(DmaProgBuf);
-	DmaProgBuf += XDmaPs_Instr_DMASEV(DmaProgBuf, DevChan);
-	DmaProgBuf += XDmaPs_Instr_DMAEND(DmaProgBuf);
-
-	DmaProgBytes = DmaProgBuf - DmaProgStart;
-
-	Xil_DCacheFlushRange((u32)DmaProgStart, DmaProgBytes);
-
-	return DmaProgBytes;
-
+	return DmaProgBuf - DmaProgSegStart;
 }
 
 
@@ -1358,14 +1434,7 @@ int XDmaPs_GenDmaProg(XDmaPs *InstPtr, unsigned int Channel, XDmaPs_Cmd *Cmd)
 	}
 
 
-	/*
-	 * unaligned fixed address is not supported
-	 */
-	if (!ChanCtrl->SrcInc && Cmd->BD.SrcAddr % ChanCtrl->SrcBurstSize) {
-		return XST_FAILURE;
-	}
-
-	if (!ChanCtrl->DstInc && Cmd->BD.DstAddr % ChanCtrl->DstBurstSize) {
+	if (XDmaPs_CheckBD(ChanCtrl, &Cmd->BD) != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
 
@@ -1396,6 +1465,144 @@ int XDmaPs_GenDmaProg(XDmaPs *InstPtr, unsigned int Channel, XDmaPs_Cmd *Cmd)
 }
 
 
+/****************************************************************************/
+/**
+*
+* Generate one DMA program for a scatter-gather list, so that the segments
+* are moved with one XDmaPs_Start() and one done interrupt. Every segment
+* uses the channel control of the command. The program is written to a
+* buffer of the caller, sized with XDMAPS_SG_PROG_LEN(), and is set as the
+* user program of the command. The list must stay valid until the command
+* is done, XDmaPs_Start() does the cache maintenance of every segment.
+*
+* The program signals the done interrupt after the last segment and after
+* every segment flagged with XDMAPS_SG_EVENT. The done handler is called
+* with the DmaStatus of the command set to XST_DEVICE_BUSY for the flagged
+* segments and to 0 once the whole list is moved. Flagged segments that
+* complete before the interrupt is handled share one call.
+*
+* @param	InstPtr is then DMA instance.
+* @param	Channel is the DMA channel number.
+* @param	Cmd is the DMA command. Its BD is not used.
+* @param	SgList is the list of segments.
+* @param	SgLength is the number of segments in SgList.
+* @param	ProgBuf is the buffer the program is written to.
+* @param	ProgBufLen is the size of ProgBuf in bytes.
+*
+* @return	- XST_SUCCESS on success.
+*		- XST_BUFFER_TOO_SMALL if the program does not fit in ProgBuf.
+* 		- XST_FAILURE if a segment cannot be moved with the channel
+*		  control of the command.
+*
+* @note		None.
+*
+*****************************************************************************/
+int XDmaPs_GenSgDmaProg(XDmaPs *InstPtr, unsigned int Channel,
+			XDmaPs_Cmd *Cmd, XDmaPs_SgSeg *SgList,
+			unsigned int SgLength, void *ProgBuf,
+			int ProgBufLen)
+{
+	char *DmaProgStart = (char *)ProgBuf;
+	char *DmaProgBuf = DmaProgStart;
+	XDmaPs_ChanCtrl *ChanCtrl;
+	unsigned int Events = 0;
+	unsigned int Index;
+	int SegmentBytes;
+	int DmaProgBytes;
+
+	Xil_AssertNonvoid(InstPtr != NULL);
+	Xil_AssertNonvoid(Cmd != NULL);
+	Xil_AssertNonvoid(SgList != NULL);
+	Xil_AssertNonvoid(SgLength != 0);
+	Xil_AssertNonvoid(ProgBuf != NULL);
+
+	if (Channel >= XDMAPS_CHANNELS_PER_DEV) {
+		return XST_FAILURE;
+	}
+
+	ChanCtrl = &Cmd->ChanCtrl;
+
+	if (ChanCtrl->SrcBurstSize * ChanCtrl->SrcBurstLen
+	    != ChanCtrl->DstBurstSize * ChanCtrl->DstBurstLen) {
+		return XST_FAILURE;
+	}
+
+	for (Index = 0; Index < SgLength; Index++) {
+		if (XDmaPs_CheckBD(ChanCtrl, &SgList[Index].BD)
+		    != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+	}
+
+	for (Index = 0; Index < SgLength; Index++) {
+		/* room for the worst case segment and the DMAEND */
+		if ((ProgBufLen - (DmaProgBuf - DmaProgStart)) <
+		    (XDMAPS_SG_SEG_MAX_PROG_LEN + 1)) {
+			return XST_BUFFER_TOO_SMALL;
+		}
+
+		SegmentBytes = XDmaPs_BuildSegment(Channel, DmaProgStart,
+						   DmaProgBuf,
+						   ChanCtrl,
+						   &SgList[Index].BD,
+						   InstPtr->CacheLength);
+		if (SegmentBytes == 0) {
+			return XST_FAILURE;
+		}
+		DmaProgBuf += SegmentBytes;
+
+		if ((Index == SgLength - 1) ||
+		    (SgList[Index].Flags & XDMAPS_SG_EVENT)) {
+			/* the segment must be written before the event */
+			DmaProgBuf += XDmaPs_Instr_DMAWMB(DmaProgBuf);
+			DmaProgBuf += XDmaPs_Instr_DMASEV(DmaProgBuf,
+							  Channel);
+			Events++;
+		}
+	}
+	DmaProgBuf += XDmaPs_Instr_DMAEND(DmaProgBuf);
+
+	DmaProgBytes = DmaProgBuf - DmaProgStart;
+	Xil_DCacheFlushRange((u32)DmaProgStart, DmaProgBytes);
+
+	Cmd->UserDmaProg = ProgBuf;
+	Cmd->UserDmaProgLength = DmaProgBytes;
+	Cmd->SgList = SgList;
+	Cmd->SgLength = SgLength;
+	Cmd->SgEvents = Events;
+	Cmd->SgEventsDone = 0;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Checks that a block can be moved with a channel control. An unaligned
+* fixed address is not supported.
+*
+* @param	ChanCtrl is the channel control.
+* @param	BD is the block.
+*
+* @return	XST_SUCCESS if the block can be moved, XST_FAILURE otherwise.
+*
+* @note		None.
+*
+*****************************************************************************/
+static int XDmaPs_CheckBD(XDmaPs_ChanCtrl *ChanCtrl, XDmaPs_BD *BD)
+{
+	if (!ChanCtrl->SrcInc && BD->SrcAddr % ChanCtrl->SrcBurstSize) {
+		return XST_FAILURE;
+	}
+
+	if (!ChanCtrl->DstInc && BD->DstAddr % ChanCtrl->DstBurstSize) {
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+
 /****************************************************************************/
 /**
  * Free the DMA program buffer that is pointed by the GeneratedDmaProg field
@@ -1468,6 +1675,7 @@ int XDmaPs_Start(XDmaPs *InstPtr, unsigned int Channel,
 	int Status;
 	u32 DmaProg = 0;
 	u32 Inten;
+	unsigned int Index;
 
 	Xil_AssertNonvoid(InstPtr != NULL);
 	Xil_AssertNonvoid(Cmd != NULL);
@@ -1480,9 +1688,16 @@ int XDmaPs_Start(XDmaPs *InstPtr, unsigned int Channel,
 	}
 
 	if (!Cmd->UserDmaProg && !Cmd->GeneratedDmaProg) {
-		Status = XDmaPs_GenDmaProg(InstPtr, Channel, Cmd);
-		if (Status) {
-			return XST_FAILURE;
+		if (!HoldDmaProg) {
+			/* a program released when done may come from the cache */
+			Cmd->GeneratedDmaProg =
+				XDmaPs_ProgCacheGet(InstPtr, Channel, Cmd);
+		}
+		if (!Cmd->GeneratedDmaProg) {
+			Status = XDmaPs_GenDmaProg(InstPtr, Channel, Cmd);
+			if (Status) {
+				return XST_FAILURE;
+			}
 		}
 	}
 
@@ -1507,12 +1722,14 @@ int XDmaPs_Start(XDmaPs *InstPtr, unsigned int Channel,
 
 		InstPtr->Chans[Channel].DmaCmdToHw = Cmd;
 
-		if (Cmd->ChanCtrl.SrcInc) {
-			Xil_DCacheFlushRange(Cmd->BD.SrcAddr, Cmd->BD.Length);
-		}
-		if (Cmd->ChanCtrl.DstInc) {
-			Xil_DCacheInvalidateRange(Cmd->BD.DstAddr,
-						  Cmd->BD.Length);
+		if (Cmd->SgList) {
+			Cmd->SgEventsDone = 0;
+			for (Index = 0; Index < Cmd->SgLength; Index++) {
+				XDmaPs_SyncBD(&Cmd->ChanCtrl,
+					      &Cmd->SgList[Index].BD);
+			}
+		} else {
+			XDmaPs_SyncBD(&Cmd->ChanCtrl, &Cmd->BD);
 		}
 
 		Status = XDmaPs_Exec_DMAGO(InstPtr->Config.BaseAddress,
@@ -1525,6 +1742,132 @@ int XDmaPs_Start(XDmaPs *InstPtr, unsigned int Channel,
 	return Status;
 }
 
+/****************************************************************************/
+/**
+*
+* Looks up the program cache of a channel for the shape of a command. On a
+* hit the SAR and DAR immediates of the cached program are patched with the
+* addresses of the command, on a miss the program is generated into the
+* least recently filled entry.
+*
+* @param	InstPtr is then DMA instance.
+* @param	Channel is the DMA channel number.
+* @param	Cmd is the DMA command.
+*
+* @return	The program, also set in the GeneratedDmaProg field of the
+*		command, or NULL if the command cannot be cached.
+*
+* @note		The channel must be idle, since the program it ran last may
+*		be patched.
+*
+*****************************************************************************/
+static void *XDmaPs_ProgCacheGet(XDmaPs *InstPtr, unsigned int Channel,
+				 XDmaPs_Cmd *Cmd)
+{
+	XDmaPs_ChannelData *ChanData;
+	XDmaPs_ChanCtrl *ChanCtrl = &Cmd->ChanCtrl;
+	XDmaPs_ProgCacheEntry *Entry;
+	u32 CCRValue;
+	u32 SrcUnaligned = 0;
+	u32 DstUnaligned = 0;
+	unsigned int Index;
+	int ProgLen;
+
+	if (Channel >= XDMAPS_CHANNELS_PER_DEV) {
+		return NULL;
+	}
+
+	if (ChanCtrl->SrcBurstSize * ChanCtrl->SrcBurstLen
+	    != ChanCtrl->DstBurstSize * ChanCtrl->DstBurstLen) {
+		return NULL;
+	}
+
+	if (XDmaPs_CheckBD(ChanCtrl, &Cmd->BD) != XST_SUCCESS) {
+		return NULL;
+	}
+
+	ChanData = InstPtr->Chans + Channel;
+	CCRValue = XDmaPs_ToCCRValue(ChanCtrl);
+	if (ChanCtrl->SrcInc) {
+		SrcUnaligned = Cmd->BD.SrcAddr % ChanCtrl->SrcBurstSize;
+	}
+	if (ChanCtrl->DstInc) {
+		DstUnaligned = Cmd->BD.DstAddr % ChanCtrl->DstBurstSize;
+	}
+
+	for (Index = 0; Index < XDMAPS_PROG_CACHE_ENTRIES; Index++) {
+		Entry = &ChanData->ProgCache[Index];
+		if ((Entry->Len > 0) && (Entry->CCRValue == CCRValue) &&
+		    (Entry->Length == Cmd->BD.Length) &&
+		    (Entry->SrcUnaligned == SrcUnaligned) &&
+		    (Entry->DstUnaligned == DstUnaligned)) {
+			/* DMAMOV SAR, then DMAMOV DAR, 6 bytes each */
+			XDmaPs_Memcpy4(Entry->Buf + 2,
+				       (char *)&Cmd->BD.SrcAddr);
+			XDmaPs_Memcpy4(Entry->Buf + 8,
+				       (char *)&Cmd->BD.DstAddr);
+			Xil_DCacheFlushRange((u32)Entry->Buf, 12);
+
+			Cmd->GeneratedDmaProg = Entry->Buf;
+			Cmd->GeneratedDmaProgLength = Entry->Len;
+			return Entry->Buf;
+		}
+	}
+
+	Entry = &ChanData->ProgCache[ChanData->ProgCacheNext];
+	ChanData->ProgCacheNext = (ChanData->ProgCacheNext + 1) %
+				  XDMAPS_PROG_CACHE_ENTRIES;
+
+	Entry->Len = 0;
+	Cmd->GeneratedDmaProg = Entry->Buf;
+	ProgLen = XDmaPs_BuildDmaProg(Channel, Cmd, InstPtr->CacheLength);
+	if (ProgLen <= 0) {
+		Cmd->GeneratedDmaProg = NULL;
+		Cmd->GeneratedDmaProgLength = 0;
+		return NULL;
+	}
+
+	Entry->Len = ProgLen;
+	Entry->CCRValue = CCRValue;
+	Entry->Length = Cmd->BD.Length;
+	Entry->SrcUnaligned = SrcUnaligned;
+	Entry->DstUnaligned = DstUnaligned;
+	Cmd->GeneratedDmaProgLength = ProgLen;
+
+#ifdef XDMAPS_DEBUG
+	XDmaPs_Print_DmaProg(Cmd);
+#endif
+
+	return Entry->Buf;
+}
+
+/****************************************************************************/
+/**
+*
+* Does the cache maintenance of a block before it is moved: the source is
+* flushed and the destination invalidated.
+*
+* @param	ChanCtrl is the channel control of the transfer.
+* @param	BD is the block.
+*
+* @return	None.
+*
+* @note		Buffers in the non-cacheable DMA arena are coherent and need
+*		no maintenance.
+*
+*****************************************************************************/
+static void XDmaPs_SyncBD(XDmaPs_ChanCtrl *ChanCtrl, XDmaPs_BD *BD)
+{
+	if ((ChanCtrl->SrcInc) &&
+	    (Xil_DmaArenaContains(BD->SrcAddr, BD->Length) == 0U)) {
+		Xil_DCacheFlushRange(BD->SrcAddr, BD->Length);
+	}
+	if ((ChanCtrl->DstInc) &&
+	    (Xil_DmaArenaContains(BD->DstAddr, BD->Length) == 0U)) {
+		Xil_DCacheInvalidateRange(BD->DstAddr, BD->Length);
+	}
+}
+
 /****************************************************************************/
 /**
 *
@@ -1553,6 +1896,272 @@ int XDmaPs_IsActive(XDmaPs *InstPtr, unsigned int Channel)
 
 
 
+/****************************************************************************/
+/**
+*
+* Set the burst table of an instance, the rules XDmaPs_SetBurst() picks the
+* burst shape of a transfer from. A benchmark measuring the memory regions
+* of the system typically builds it.
+*
+* @param	InstPtr is the DMA instance.
+* @param	Table is the table, kept by reference. NULL restores the
+*		default table.
+* @param	NumRules is the number of rules in Table.
+*
+* @return	None.
+*
+* @note		The rules are matched in order, so the table should end with
+*		a rule covering the whole address space.
+*
+*****************************************************************************/
+void XDmaPs_SetBurstTable(XDmaPs *InstPtr, const XDmaPs_BurstRule *Table,
+			  unsigned int NumRules)
+{
+	Xil_AssertVoid(InstPtr != NULL);
+
+	if ((Table == NULL) || (NumRules == 0)) {
+		InstPtr->BurstTable = XDmaPs_DefaultBurstTable;
+		InstPtr->NumBurstRules = sizeof(XDmaPs_DefaultBurstTable) /
+					 sizeof(XDmaPs_DefaultBurstTable[0]);
+	} else {
+		InstPtr->BurstTable = Table;
+		InstPtr->NumBurstRules = NumRules;
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Set the burst size and length of a channel control from the first rule of
+* the burst table that covers the source and destination addresses. The
+* other fields of the channel control are left alone.
+*
+* @param	InstPtr is the DMA instance.
+* @param	ChanCtrl is the channel control to be set.
+* @param	SrcAddr is the source address of the transfer.
+* @param	DstAddr is the destination address of the transfer.
+*
+* @return	None.
+*
+* @note		Without a matching rule the shape is left unchanged.
+*
+*****************************************************************************/
+void XDmaPs_SetBurst(XDmaPs *InstPtr, XDmaPs_ChanCtrl *ChanCtrl,
+		     u32 SrcAddr, u32 DstAddr)
+{
+	const XDmaPs_BurstRule *Rule;
+	unsigned int Index;
+
+	Xil_AssertVoid(InstPtr != NULL);
+	Xil_AssertVoid(ChanCtrl != NULL);
+
+	for (Index = 0; Index < InstPtr->NumBurstRules; Index++) {
+		Rule = &InstPtr->BurstTable[Index];
+		if ((SrcAddr >= Rule->SrcBase) && (SrcAddr <= Rule->SrcHigh) &&
+		    (DstAddr >= Rule->DstBase) && (DstAddr <= Rule->DstHigh)) {
+			ChanCtrl->SrcBurstSize = Rule->BurstSize;
+			ChanCtrl->SrcBurstLen = Rule->BurstLen;
+			ChanCtrl->DstBurstSize = Rule->BurstSize;
+			ChanCtrl->DstBurstLen = Rule->BurstLen;
+			return;
+		}
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Submit a DMA command to a channel. The command is started at once if the
+* channel is idle, otherwise it is queued and started by the done interrupt
+* of the command ahead of it, so that the channel runs back to back. The
+* done handler of the channel is called for every command. The commands
+* are started without holding their DMA program.
+*
+* @param	InstPtr is then DMA instance.
+* @param	Channel is the DMA channel number.
+* @param	Cmd is the DMA command. It must stay valid until it is done.
+*
+* @return
+*		- XST_SUCCESS if the command is started or queued
+*		- XST_DEVICE_BUSY if the queue of the channel is full
+*		- XST_FAILURE if the command cannot be started
+*
+* @note		A queued command has its DmaStatus set to XST_DEVICE_BUSY.
+*		It may be called from the done handler.
+*
+*****************************************************************************/
+int XDmaPs_Submit(XDmaPs *InstPtr, unsigned int Channel, XDmaPs_Cmd *Cmd)
+{
+	XDmaPs_ChannelData *ChanData;
+	int Status = XST_SUCCESS;
+	u32 Cpsr;
+
+	Xil_AssertNonvoid(InstPtr != NULL);
+	Xil_AssertNonvoid(Cmd != NULL);
+
+	if (Channel >= XDMAPS_CHANNELS_PER_DEV) {
+		return XST_FAILURE;
+	}
+
+	ChanData = InstPtr->Chans + Channel;
+
+	/* the done ISR takes commands from the queue */
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+
+	if ((ChanData->DmaCmdToHw == NULL) && (ChanData->QueueCount == 0)) {
+		Status = XDmaPs_Start(InstPtr, Channel, Cmd, 0);
+	} else if (ChanData->QueueCount == XDMAPS_QUEUE_DEPTH) {
+		Status = XST_DEVICE_BUSY;
+	} else {
+		Cmd->DmaStatus = XST_DEVICE_BUSY;
+		ChanData->Queue[(ChanData->QueueHead + ChanData->QueueCount) %
+				XDMAPS_QUEUE_DEPTH] = Cmd;
+		ChanData->QueueCount++;
+	}
+
+	mtcpsr(Cpsr);
+
+	return Status;
+}
+
+/****************************************************************************/
+/**
+*
+* Submit a DMA command to the least loaded channel of a set, see
+* XDmaPs_Submit().
+*
+* @param	InstPtr is then DMA instance.
+* @param	ChannelMask is the set of channels the command may run on,
+*		built with XDMAPS_CHANNEL_MASK() or XDMAPS_ALL_CHANNELS_MASK.
+* @param	Cmd is the DMA command.
+* @param	ChannelPtr returns the channel chosen, it may be NULL.
+*
+* @return	The status of XDmaPs_Submit(), or XST_FAILURE if the set is
+*		empty.
+*
+* @note		Every channel of the set needs a done handler.
+*
+*****************************************************************************/
+int XDmaPs_SubmitAny(XDmaPs *InstPtr, u32 ChannelMask, XDmaPs_Cmd *Cmd,
+		     unsigned int *ChannelPtr)
+{
+	int Channel;
+
+	Xil_AssertNonvoid(InstPtr != NULL);
+	Xil_AssertNonvoid(Cmd != NULL);
+
+	Channel = XDmaPs_PickChannel(InstPtr, ChannelMask);
+	if (Channel < 0) {
+		return XST_FAILURE;
+	}
+
+	if (ChannelPtr) {
+		*ChannelPtr = (unsigned int)Channel;
+	}
+
+	return XDmaPs_Submit(InstPtr, (unsigned int)Channel, Cmd);
+}
+
+/****************************************************************************/
+/**
+*
+* Get the load of a channel: the commands queued plus the one executed.
+*
+* @param	InstPtr is the DMA instance.
+* @param	Channel is the DMA channel number.
+*
+* @return	The number of commands submitted and not done yet.
+*
+* @note		None.
+*
+*****************************************************************************/
+unsigned int XDmaPs_GetLoad(XDmaPs *InstPtr, unsigned int Channel)
+{
+	XDmaPs_ChannelData *ChanData;
+
+	Xil_AssertNonvoid(InstPtr != NULL);
+
+	if (Channel >= XDMAPS_CHANNELS_PER_DEV) {
+		return 0;
+	}
+
+	ChanData = InstPtr->Chans + Channel;
+
+	return ChanData->QueueCount + (ChanData->DmaCmdToHw != NULL);
+}
+
+/****************************************************************************/
+/**
+*
+* Pick the least loaded channel of a set. Ties go to the lowest channel.
+*
+* @param	InstPtr is the DMA instance.
+* @param	ChannelMask is the set of channels to choose from.
+*
+* @return	The channel number, or -1 if the set is empty.
+*
+* @note		None.
+*
+*****************************************************************************/
+int XDmaPs_PickChannel(XDmaPs *InstPtr, u32 ChannelMask)
+{
+	unsigned int Channel;
+	unsigned int Load;
+	unsigned int BestLoad = 0;
+	int Best = -1;
+
+	Xil_AssertNonvoid(InstPtr != NULL);
+
+	for (Channel = 0; Channel < XDMAPS_CHANNELS_PER_DEV; Channel++) {
+		if (!(ChannelMask & XDMAPS_CHANNEL_MASK(Channel))) {
+			continue;
+		}
+		Load = XDmaPs_GetLoad(InstPtr, Channel);
+		if ((Best < 0) || (Load < BestLoad)) {
+			Best = (int)Channel;
+			BestLoad = Load;
+		}
+	}
+
+	return Best;
+}
+
+/****************************************************************************/
+/**
+*
+* Start the next queued command of an idle channel. A command that fails to
+* start is handed to the done handler with its DmaStatus set to
+* XST_FAILURE, and the next one is tried.
+*
+* @param	InstPtr is the DMA instance.
+* @param	Channel is the DMA channel number.
+*
+* @return	None.
+*
+* @note		It is called with interrupts masked.
+*
+*****************************************************************************/
+static void XDmaPs_StartQueued(XDmaPs *InstPtr, unsigned int Channel)
+{
+	XDmaPs_ChannelData *ChanData = InstPtr->Chans + Channel;
+	XDmaPs_Cmd *Cmd;
+
+	while ((ChanData->DmaCmdToHw == NULL) && (ChanData->QueueCount > 0)) {
+		Cmd = ChanData->Queue[ChanData->QueueHead];
+		ChanData->QueueHead = (ChanData->QueueHead + 1) %
+				      XDMAPS_QUEUE_DEPTH;
+		ChanData->QueueCount--;
+
+		if (XDmaPs_Start(InstPtr, Channel, Cmd, 0) != XST_SUCCESS) {
+			Cmd->DmaStatus = XST_FAILURE;
+			if (ChanData->DoneHandler)
+				ChanData->DoneHandler(Channel, Cmd,
+						      ChanData->DoneRef);
+		}
+	}
+}
+
 /****************************************************************************/
 /**
 *
@@ -1921,6 +2530,16 @@ static void XDmaPs_DoneISR_n(XDmaPs *InstPtr, unsigned Channel)
 
 	DmaCmd = ChanData->DmaCmdToHw;
 	if (DmaCmd) {
+		if (DmaCmd->SgList &&
+		    XDmaPs_SgPending(InstPtr, Channel, DmaCmd)) {
+			/* a flagged segment, the list is still running */
+			DmaCmd->DmaStatus = XST_DEVICE_BUSY;
+			if (ChanData->DoneHandler)
+				ChanData->DoneHandler(Channel, DmaCmd,
+						      ChanData->DoneRef);
+			return;
+		}
+
 		if (!ChanData->HoldDmaProg) {
 			DmaProgBuf = (void *)DmaCmd->GeneratedDmaProg;
 			if (DmaProgBuf)
@@ -1933,6 +2552,9 @@ static void XDmaPs_DoneISR_n(XDmaPs *InstPtr, unsigned Channel)
 		ChanData->DmaCmdToHw = NULL;
 		ChanData->DmaCmdFromHw = DmaCmd;
 
+		/* keep the channel busy before handling the finished command */
+		XDmaPs_StartQueued(InstPtr, Channel);
+
 		if (ChanData->DoneHandler)
 			ChanData->DoneHandler(Channel, DmaCmd,
 					      ChanData->DoneRef);
@@ -1941,6 +2563,36 @@ static void XDmaPs_DoneISR_n(XDmaPs *InstPtr, unsigned Channel)
 }
 
 
+/****************************************************************************/
+/**
+*
+* Counts an event of a scatter-gather program and tells whether more are to
+* come. Events that are signalled before the interrupt is handled merge
+* into one, so the program is also known to be done once the channel has
+* stopped.
+*
+* @param	InstPtr is the DMA instance.
+* @param	Channel is the DMA channel numer.
+* @param	DmaCmd is the command being executed.
+*
+* @return	1 if the program is still running, 0 if it is done.
+*
+* @note		None.
+*
+*****************************************************************************/
+static int XDmaPs_SgPending(XDmaPs *InstPtr, unsigned Channel,
+			    XDmaPs_Cmd *DmaCmd)
+{
+	DmaCmd->SgEventsDone++;
+	if (DmaCmd->SgEventsDone >= DmaCmd->SgEvents) {
+		return 0;
+	}
+
+	return (XDmaPs_ReadReg(InstPtr->Config.BaseAddress,
+			       XDmaPs_CSn_OFFSET(Channel)) &
+		XDMAPS_DS_DMA_STATUS) != XDMAPS_DS_DMA_STATUS_STOPPED;
+}
+
 /****************************************************************************/
 /**
 * Prints the content of the buffer in bytes
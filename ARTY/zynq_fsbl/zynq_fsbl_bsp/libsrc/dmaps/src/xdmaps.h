@@ -62,6 +62,14 @@
 * 2.8	sk     05/18/21 Modify all inline functions declarations from extern inline
 *			to static inline to avoid the linkage conflict for IAR compiler.
 * 2.9   aj     11/07/23 Added support for system device tree
+* 2.10  qm     10/14/26 Added scatter-gather lists run as one DMA program,
+*			see XDmaPs_GenSgDmaProg().
+*			Added a per channel cache of generated programs, see
+*			XDMAPS_PROG_CACHE_ENTRIES.
+*			Added per channel submission queues, see
+*			XDmaPs_Submit().
+*			Added the burst table picking the burst shape per
+*			memory region, see XDmaPs_SetBurst().
 * </pre>
 *
 *****************************************************************************/
@@ -84,6 +92,23 @@ extern "C" {
 
 /************************** Constant Definitions ****************************/
 
+/** @name Scatter-gather segment flags
+ * @{
+ */
+#define XDMAPS_SG_EVENT		0x1U	/**< Call the done handler once the
+					  *  segment is moved. The last
+					  *  segment always does. */
+/* @} */
+
+/**
+ * Worst case program bytes per scatter-gather segment, for an icache line
+ * of up to 32 bytes. A program of N segments needs
+ * XDMAPS_SG_PROG_LEN(N) bytes.
+ */
+#define XDMAPS_SG_SEG_MAX_PROG_LEN	225
+#define XDMAPS_SG_PROG_LEN(NumSegs)	\
+	(((NumSegs) * XDMAPS_SG_SEG_MAX_PROG_LEN) + 1)
+
 /**************************** Type Definitions ******************************/
 
 /**
@@ -133,6 +158,13 @@ typedef struct {
 	unsigned int Length;	/**< Number of bytes for the block */
 } XDmaPs_BD;
 
+/** Scatter-gather segment structure.
+ */
+typedef struct {
+	XDmaPs_BD BD;		/**< Block of the segment */
+	u32 Flags;		/**< XDMAPS_SG_* flags */
+} XDmaPs_SgSeg;
+
 /**
  * A DMA command consisits of a channel control struct, a block descriptor,
  * a user defined program, a pointer pointing to generated DMA program, and
@@ -176,8 +208,32 @@ typedef struct {
 				 */
 	u32 ChanFaultPCAddr;	/**< Channel fault PC address
 				 */
+	XDmaPs_SgSeg *SgList;	/**< Segments of the program built by
+				 *   XDmaPs_GenSgDmaProg(), NULL when
+				 *   the command moves BD only
+				 */
+	unsigned int SgLength;	/**< Number of segments in SgList
+				 */
+	unsigned int SgEvents;	/**< Number of events the program
+				 *   signals
+				 */
+	unsigned int SgEventsDone; /**< Number of events handled
+				    */
 } XDmaPs_Cmd;
 
+/**
+ * A rule of the burst table: the burst shape of the transfers from a source
+ * range to a destination range. See XDmaPs_SetBurst().
+ */
+typedef struct {
+	u32 SrcBase;		/**< First byte of the source range */
+	u32 SrcHigh;		/**< Last byte of the source range */
+	u32 DstBase;		/**< First byte of the destination range */
+	u32 DstHigh;		/**< Last byte of the destination range */
+	unsigned int BurstSize;	/**< Bytes per beat, both sides */
+	unsigned int BurstLen;	/**< Beats per burst, both sides */
+} XDmaPs_BurstRule;
+
 /**
  * It's the done handler a user can set for a channel
  */
@@ -195,6 +251,34 @@ typedef void (*XDmaPsFaultHandler) (unsigned int Channel,
 #define XDMAPS_MAX_CHAN_BUFS	2
 #define XDMAPS_CHAN_BUF_LEN	128
 
+/**
+ * Number of generated programs cached per channel. XDmaPs_Start() keeps
+ * the programs it generates for commands started without HoldDmaProg,
+ * keyed on the shape of the transfer: the channel control register value,
+ * the length and the misalignment of the addresses. A command of a known
+ * shape only has the DMAMOV immediates of SAR and DAR patched.
+ */
+#ifndef XDMAPS_PROG_CACHE_ENTRIES
+#define XDMAPS_PROG_CACHE_ENTRIES	2
+#endif
+
+/**
+ * Number of commands that can wait in the submission queue of a channel,
+ * behind the one being executed. See XDmaPs_Submit().
+ */
+#ifndef XDMAPS_QUEUE_DEPTH
+#define XDMAPS_QUEUE_DEPTH	8
+#endif
+
+/** @name Channel affinity masks
+ * Sets of channels XDmaPs_PickChannel() and XDmaPs_SubmitAny() choose from.
+ * @{
+ */
+#define XDMAPS_CHANNEL_MASK(Channel)	(1U << (Channel))
+#define XDMAPS_ALL_CHANNELS_MASK	\
+	((1U << XDMAPS_CHANNELS_PER_DEV) - 1U)
+/* @} */
+
 /**
  * The XDmaPs_ProgBuf is the struct for a DMA program buffer.
  */
@@ -207,6 +291,22 @@ typedef struct {
 					  *  buffer is allocated or not */
 } XDmaPs_ProgBuf;
 
+/**
+ * The XDmaPs_ProgCacheEntry is the struct for a cached DMA program.
+ */
+typedef struct {
+	char Buf[XDMAPS_CHAN_BUF_LEN];  /**< The program, starting with the
+					  *  DMAMOVs of SAR and DAR */
+	int Len;			/**< The length of the program in
+					  *  bytes, 0 if the entry is free */
+	u32 CCRValue;			/**< Channel control of the transfer */
+	unsigned int Length;		/**< Number of bytes moved */
+	u32 SrcUnaligned;		/**< Source address modulo the source
+					  *  burst size */
+	u32 DstUnaligned;		/**< Destination address modulo the
+					  *  destination burst size */
+} XDmaPs_ProgCacheEntry;
+
 /**
  * The XDmaPs_ChannelData is a struct to book keep individual channel of
  * the DMAC.
@@ -225,6 +325,13 @@ typedef struct {
 	int HoldDmaProg;		/**< A tag indicating whether to hold the
 					  *  DMA program after the DMA is done.
 					  */
+	XDmaPs_ProgCacheEntry ProgCache[XDMAPS_PROG_CACHE_ENTRIES];
+					/**< Programs of recent transfers */
+	unsigned ProgCacheNext;		/**< Entry replaced on the next miss */
+	XDmaPs_Cmd *Queue[XDMAPS_QUEUE_DEPTH]; /**< Commands waiting for the
+						 *  channel */
+	unsigned QueueHead;		/**< Oldest command of the queue */
+	unsigned QueueCount;		/**< Number of commands queued */
 
 } XDmaPs_ChannelData;
 
@@ -243,6 +350,8 @@ typedef struct {
 	/**<
 	 * channel data
 	 */
+	const XDmaPs_BurstRule *BurstTable; /**< Burst shape per region */
+	unsigned int NumBurstRules;	/**< Rules in BurstTable */
 } XDmaPs;
 
 /*
@@ -257,11 +366,24 @@ int XDmaPs_Start(XDmaPs *InstPtr, unsigned int Channel,
 		 int HoldDmaProg);
 
 int XDmaPs_IsActive(XDmaPs *InstPtr, unsigned int Channel);
+int XDmaPs_Submit(XDmaPs *InstPtr, unsigned int Channel, XDmaPs_Cmd *Cmd);
+int XDmaPs_SubmitAny(XDmaPs *InstPtr, u32 ChannelMask, XDmaPs_Cmd *Cmd,
+		     unsigned int *ChannelPtr);
+unsigned int XDmaPs_GetLoad(XDmaPs *InstPtr, unsigned int Channel);
+int XDmaPs_PickChannel(XDmaPs *InstPtr, u32 ChannelMask);
 int XDmaPs_GenDmaProg(XDmaPs *InstPtr, unsigned int Channel,
 		      XDmaPs_Cmd *Cmd);
 int XDmaPs_FreeDmaProg(XDmaPs *InstPtr, unsigned int Channel,
 		       XDmaPs_Cmd *Cmd);
+int XDmaPs_GenSgDmaProg(XDmaPs *InstPtr, unsigned int Channel,
+			XDmaPs_Cmd *Cmd, XDmaPs_SgSeg *SgList,
+			unsigned int SgLength, void *ProgBuf,
+			int ProgBufLen);
 void XDmaPs_Print_DmaProg(XDmaPs_Cmd *Cmd);
+void XDmaPs_SetBurstTable(XDmaPs *InstPtr, const XDmaPs_BurstRule *Table,
+			  unsigned int NumRules);
+void XDmaPs_SetBurst(XDmaPs *InstPtr, XDmaPs_ChanCtrl *ChanCtrl,
+		     u32 SrcAddr, u32 DstAddr);
 
 
 int XDmaPs_ResetManager(XDmaPs *InstPtr);
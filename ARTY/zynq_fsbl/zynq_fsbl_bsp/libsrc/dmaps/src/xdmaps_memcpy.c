@@ -0,0 +1,574 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file xdmaps_memcpy.c
+* @addtogroup dmaps Overview
+* @{
+*
+* This file contains the asynchronous memory copy of the XDmaPs driver.
+* Refer to the header file xdmaps_memcpy.h for more detailed information.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- -----------------------------------------------
+* 2.10  qm     10/14/26 First release
+*       qm     10/14/26 Take the burst shape from the burst table.
+*       qm     10/14/26 Added XDmaPs_MemSetAsync(), a constant fill.
+*       qm     10/14/26 Added the PCAP of the XDcfg driver as a second copy
+*                       engine, XDmaPs_MemCpySetPcap().
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+
+#include "xdmaps_memcpy.h"
+#include "xil_cache.h"
+#include "xil_mem.h"
+#include "xil_dmaarena.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+
+/************************** Constant Definitions ****************************/
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static s32 XDmaPs_MemCpySubmit(XDmaPs_MemCpy *EnginePtr,
+				XDmaPs_MemCpyToken *TokenPtr, UINTPTR SrcAddr,
+				u32 SrcInc, UINTPTR DstAddr, u32 Count);
+static void XDmaPs_MemCpyDone(unsigned int Channel, XDmaPs_Cmd *DmaCmd,
+			      void *CallbackRef);
+#if defined (XDMAPS_MEMCPY_PCAP)
+static u32 XDmaPs_MemCpyStartPcap(XDmaPs_MemCpy *EnginePtr,
+				  XDmaPs_MemCpyToken *TokenPtr,
+				  UINTPTR SrcAddr, UINTPTR DstAddr, u32 Count);
+static void XDmaPs_MemCpyPollPcap(XDmaPs_MemCpy *EnginePtr);
+#endif
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* Initializes a copy engine on a set of channels of a DMA controller and
+* takes over the done handlers of these channels.
+*
+* @param	EnginePtr is a pointer to the copy engine.
+* @param	DmaPtr is a pointer to an initialized XDmaPs instance.
+* @param	ChannelMask is the set of channels used for the copies, built
+*		with XDMAPS_CHANNEL_MASK() or XDMAPS_ALL_CHANNELS_MASK.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM if the set is empty.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 XDmaPs_MemCpyInitialize(XDmaPs_MemCpy *EnginePtr, XDmaPs *DmaPtr,
+			    u32 ChannelMask)
+{
+	u32 Channel;
+
+	Xil_AssertNonvoid(EnginePtr != NULL);
+	Xil_AssertNonvoid(DmaPtr != NULL);
+
+	ChannelMask &= XDMAPS_ALL_CHANNELS_MASK;
+	if (ChannelMask == 0U) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	EnginePtr->DmaPtr = DmaPtr;
+	EnginePtr->ChannelMask = ChannelMask;
+	EnginePtr->Threshold = XDMAPS_MEMCPY_THRESHOLD;
+#if defined (XDMAPS_MEMCPY_PCAP)
+	EnginePtr->DcfgPtr = NULL;
+	EnginePtr->PcapShare = XDMAPS_MEMCPY_PCAP_SHARE;
+	EnginePtr->PcapTokenPtr = NULL;
+#endif
+
+	for (Channel = 0U; Channel < (u32)XDMAPS_CHANNELS_PER_DEV; Channel++) {
+		if ((ChannelMask & XDMAPS_CHANNEL_MASK(Channel)) != 0U) {
+			(void)XDmaPs_SetDoneHandler(DmaPtr, Channel,
+						    XDmaPs_MemCpyDone,
+						    EnginePtr);
+		}
+	}
+
+	return (s32)XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Sets the shortest copy the engine moves with the DMA, shorter copies are
+* done on the CPU.
+*
+* @param	EnginePtr is a pointer to the copy engine.
+* @param	Threshold is the length in bytes.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XDmaPs_MemCpySetThreshold(XDmaPs_MemCpy *EnginePtr, u32 Threshold)
+{
+	Xil_AssertVoid(EnginePtr != NULL);
+
+	EnginePtr->Threshold = Threshold;
+}
+
+#if defined (XDMAPS_MEMCPY_PCAP)
+/****************************************************************************/
+/**
+*
+* Lets the PCAP of the device configuration interface move a share of the
+* copies, in loopback mode. The PL must be configured already, the FSBL
+* or the application being done with the PCAP, and the DMA done
+* interrupt of the XDcfg instance disabled.
+*
+* @param	EnginePtr is a pointer to the copy engine.
+* @param	DcfgPtr is a pointer to an initialized XDcfg instance, or NULL
+*		to stop using the PCAP.
+* @param	Share is the part of each copy given to the PCAP, in
+*		sixteenths, XDMAPS_MEMCPY_PCAP_SHARE by default.
+*
+* @return
+*		- XST_SUCCESS if the PCAP is set.
+*		- XST_INVALID_PARAM if Share is above 16.
+*		- XST_DEVICE_BUSY if the PCAP still moves a copy.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 XDmaPs_MemCpySetPcap(XDmaPs_MemCpy *EnginePtr, XDcfg *DcfgPtr,
+			 u32 Share)
+{
+	Xil_AssertNonvoid(EnginePtr != NULL);
+
+	if (Share > 16U) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	XDmaPs_MemCpyPollPcap(EnginePtr);
+	if (EnginePtr->PcapTokenPtr != NULL) {
+		return (s32)XST_DEVICE_BUSY;
+	}
+
+	EnginePtr->DcfgPtr = DcfgPtr;
+	EnginePtr->PcapShare = Share;
+
+	return (s32)XST_SUCCESS;
+}
+#endif
+
+/****************************************************************************/
+/**
+*
+* Starts a copy and returns without waiting for it. The copy is split in
+* chunks of up to XDMAPS_MEMCPY_CHUNK_LEN bytes, each submitted to the
+* least loaded channel of the engine. With the PCAP set and idle, its
+* share of the copy is moved by the PCAP first.
+*
+* @param	EnginePtr is a pointer to the copy engine.
+* @param	TokenPtr is the completion token of the copy.
+* @param	DstPtr is the destination, which must not overlap the source.
+* @param	SrcPtr is the source.
+* @param	Count is the number of bytes to copy.
+*
+* @return
+*		- XST_SUCCESS if the copy is started or done.
+*		- XST_INVALID_PARAM if the copy needs more than
+*		  XDMAPS_MEMCPY_MAX_CHUNKS chunks.
+*		- XST_DEVICE_BUSY or XST_FAILURE if no chunk could be
+*		  submitted, in which case the token is done with an error.
+*
+* @note		If a later chunk fails to be submitted, the earlier ones
+*		still run and the token ends with XST_FAILURE.
+*
+*****************************************************************************/
+s32 XDmaPs_MemCpyAsync(XDmaPs_MemCpy *EnginePtr,
+		       XDmaPs_MemCpyToken *TokenPtr, void *DstPtr,
+		       const void *SrcPtr, u32 Count)
+{
+	UINTPTR SrcAddr = (UINTPTR)SrcPtr;
+	UINTPTR DstAddr = (UINTPTR)DstPtr;
+#if defined (XDMAPS_MEMCPY_PCAP)
+	u32 PcapLen;
+	s32 Status;
+#endif
+
+	Xil_AssertNonvoid(EnginePtr != NULL);
+	Xil_AssertNonvoid(TokenPtr != NULL);
+
+	TokenPtr->Status = (s32)XST_SUCCESS;
+	TokenPtr->Pending = 0U;
+#if defined (XDMAPS_MEMCPY_PCAP)
+	TokenPtr->EnginePtr = EnginePtr;
+	TokenPtr->PcapLen = 0U;
+#endif
+
+	/* Short or unequally aligned copies are faster on the CPU */
+	if ((Count < EnginePtr->Threshold) ||
+	    (((SrcAddr ^ DstAddr) & (XDMAPS_MEMCPY_BURST_SIZE - 1U)) != 0U)) {
+		Xil_MemCpy(DstPtr, SrcPtr, Count);
+		return (s32)XST_SUCCESS;
+	}
+
+#if defined (XDMAPS_MEMCPY_PCAP)
+	PcapLen = XDmaPs_MemCpyStartPcap(EnginePtr, TokenPtr, SrcAddr, DstAddr,
+					 Count);
+	Status = XDmaPs_MemCpySubmit(EnginePtr, TokenPtr, SrcAddr + PcapLen,
+				     1U, DstAddr + PcapLen, Count - PcapLen);
+
+	/* The token reports the failure of the channels once the PCAP runs */
+	return (PcapLen != 0U) ? (s32)XST_SUCCESS : Status;
+#else
+	return XDmaPs_MemCpySubmit(EnginePtr, TokenPtr, SrcAddr, 1U, DstAddr,
+				   Count);
+#endif
+}
+
+/****************************************************************************/
+/**
+*
+* Starts a fill of memory with a byte and returns without waiting for it.
+* The fill is split in chunks as a copy is, which read their source from
+* the token.
+*
+* @param	EnginePtr is a pointer to the copy engine.
+* @param	TokenPtr is the completion token of the fill.
+* @param	DstPtr is the memory to fill.
+* @param	Value is the byte to fill it with.
+* @param	Count is the number of bytes to fill.
+*
+* @return	As XDmaPs_MemCpyAsync().
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 XDmaPs_MemSetAsync(XDmaPs_MemCpy *EnginePtr,
+		       XDmaPs_MemCpyToken *TokenPtr, void *DstPtr, u8 Value,
+		       u32 Count)
+{
+	UINTPTR FillAddr;
+
+	Xil_AssertNonvoid(EnginePtr != NULL);
+	Xil_AssertNonvoid(TokenPtr != NULL);
+
+	TokenPtr->Status = (s32)XST_SUCCESS;
+	TokenPtr->Pending = 0U;
+#if defined (XDMAPS_MEMCPY_PCAP)
+	TokenPtr->EnginePtr = EnginePtr;
+	TokenPtr->PcapLen = 0U;
+#endif
+
+	if (Count < EnginePtr->Threshold) {
+		Xil_MemSet(DstPtr, Value, Count);
+		return (s32)XST_SUCCESS;
+	}
+
+	/* The DMA reads the pattern from memory, not from the cache */
+	TokenPtr->Fill = (u64)Value * 0x0101010101010101ULL;
+	FillAddr = (UINTPTR)&TokenPtr->Fill;
+	if (Xil_DmaArenaContains((u32)FillAddr, sizeof(TokenPtr->Fill)) ==
+	    0U) {
+		Xil_DCacheFlushRange(FillAddr, sizeof(TokenPtr->Fill));
+	}
+
+	return XDmaPs_MemCpySubmit(EnginePtr, TokenPtr, FillAddr, 0U,
+				   (UINTPTR)DstPtr, Count);
+}
+
+/****************************************************************************/
+/**
+*
+* Tells whether a copy is done.
+*
+* @param	TokenPtr is the completion token of the copy.
+*
+* @return	1 if the copy is done, 0 otherwise.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 XDmaPs_MemCpyIsDone(const XDmaPs_MemCpyToken *TokenPtr)
+{
+	Xil_AssertNonvoid(TokenPtr != NULL);
+
+#if defined (XDMAPS_MEMCPY_PCAP)
+	if (TokenPtr->PcapLen != 0U) {
+		XDmaPs_MemCpyPollPcap(TokenPtr->EnginePtr);
+	}
+#endif
+
+	return (TokenPtr->Pending == 0U) ? 1U : 0U;
+}
+
+/****************************************************************************/
+/**
+*
+* Waits for a copy to be done. The DMA done interrupts must be enabled,
+* the PCAP part of the copy, if any, is polled.
+*
+* @param	TokenPtr is the completion token of the copy.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if a chunk failed.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 XDmaPs_MemCpyWait(const XDmaPs_MemCpyToken *TokenPtr)
+{
+	Xil_AssertNonvoid(TokenPtr != NULL);
+
+	while (TokenPtr->Pending != 0U) {
+#if defined (XDMAPS_MEMCPY_PCAP)
+		if (TokenPtr->PcapLen != 0U) {
+			XDmaPs_MemCpyPollPcap(TokenPtr->EnginePtr);
+		}
+#endif
+	}
+
+	return TokenPtr->Status;
+}
+
+/****************************************************************************/
+/*
+*
+* Submits the chunks of a copy or a fill, of up to XDMAPS_MEMCPY_CHUNK_LEN
+* bytes each, to the least loaded channels of the engine.
+*
+* @param	EnginePtr is a pointer to the copy engine.
+* @param	TokenPtr is the completion token, whose pending count the
+*		chunks are added to.
+* @param	SrcAddr is the source.
+* @param	SrcInc is 1 for a copy, 0 for a fill from a fixed source.
+* @param	DstAddr is the destination.
+* @param	Count is the number of bytes.
+*
+* @return	As XDmaPs_MemCpyAsync().
+*
+*****************************************************************************/
+static s32 XDmaPs_MemCpySubmit(XDmaPs_MemCpy *EnginePtr,
+				XDmaPs_MemCpyToken *TokenPtr, UINTPTR SrcAddr,
+				u32 SrcInc, UINTPTR DstAddr, u32 Count)
+{
+	XDmaPs_MemCpyChunk *ChunkPtr;
+	XDmaPs_ChanCtrl *ChanCtrl;
+	u32 NumChunks;
+	u32 Index;
+	u32 Len;
+	s32 Status = (s32)XST_SUCCESS;
+	u32 Cpsr;
+
+	NumChunks = (Count + (XDMAPS_MEMCPY_CHUNK_LEN - 1U)) /
+		    XDMAPS_MEMCPY_CHUNK_LEN;
+	if (NumChunks > XDMAPS_MEMCPY_MAX_CHUNKS) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	/* The done handlers update the token */
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+
+	TokenPtr->Pending += NumChunks;
+	for (Index = 0U; Index < NumChunks; Index++) {
+		Len = (Count > XDMAPS_MEMCPY_CHUNK_LEN) ?
+		      XDMAPS_MEMCPY_CHUNK_LEN : Count;
+
+		ChunkPtr = &TokenPtr->Chunks[Index];
+		(void)memset(&ChunkPtr->Cmd, 0, sizeof(XDmaPs_Cmd));
+		ChunkPtr->TokenPtr = TokenPtr;
+
+		ChanCtrl = &ChunkPtr->Cmd.ChanCtrl;
+		ChanCtrl->SrcBurstSize = XDMAPS_MEMCPY_BURST_SIZE;
+		ChanCtrl->SrcBurstLen = XDMAPS_MEMCPY_BURST_LEN;
+		ChanCtrl->SrcInc = SrcInc;
+		ChanCtrl->DstBurstSize = XDMAPS_MEMCPY_BURST_SIZE;
+		ChanCtrl->DstBurstLen = XDMAPS_MEMCPY_BURST_LEN;
+		ChanCtrl->DstInc = 1U;
+		XDmaPs_SetBurst(EnginePtr->DmaPtr, ChanCtrl, (u32)SrcAddr,
+				(u32)DstAddr);
+		ChunkPtr->Cmd.BD.SrcAddr = (u32)SrcAddr;
+		ChunkPtr->Cmd.BD.DstAddr = (u32)DstAddr;
+		ChunkPtr->Cmd.BD.Length = Len;
+
+		Status = XDmaPs_SubmitAny(EnginePtr->DmaPtr,
+					  EnginePtr->ChannelMask,
+					  &ChunkPtr->Cmd, NULL);
+		if (Status != (s32)XST_SUCCESS) {
+			/* The chunks not submitted will not complete */
+			TokenPtr->Pending -= NumChunks - Index;
+			TokenPtr->Status = (s32)XST_FAILURE;
+			break;
+		}
+
+		SrcAddr += (SrcInc != 0U) ? Len : 0U;
+		DstAddr += Len;
+		Count -= Len;
+	}
+
+	mtcpsr(Cpsr);
+
+	/* Only report an error when nothing runs */
+	return (Index == 0U) ? Status : (s32)XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Done handler of the channels of a copy engine. It drops the destination
+* lines the CPU may have fetched during the transfer and counts the chunk.
+*
+* @param	Channel is the DMA channel.
+* @param	DmaCmd is the command of the chunk.
+* @param	CallbackRef is the copy engine.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void XDmaPs_MemCpyDone(unsigned int Channel, XDmaPs_Cmd *DmaCmd,
+			      void *CallbackRef)
+{
+	XDmaPs_MemCpyChunk *ChunkPtr = (XDmaPs_MemCpyChunk *)DmaCmd;
+	XDmaPs_MemCpyToken *TokenPtr = ChunkPtr->TokenPtr;
+
+	(void)Channel;
+	(void)CallbackRef;
+
+	if (DmaCmd->DmaStatus != 0) {
+		TokenPtr->Status = (s32)XST_FAILURE;
+	} else if (Xil_DmaArenaContains(DmaCmd->BD.DstAddr,
+					DmaCmd->BD.Length) == 0U) {
+		Xil_DCacheInvalidateRange(DmaCmd->BD.DstAddr,
+					  DmaCmd->BD.Length);
+	}
+
+	TokenPtr->Pending--;
+}
+
+#if defined (XDMAPS_MEMCPY_PCAP)
+/****************************************************************************/
+/*
+*
+* Gives the first part of a copy to the PCAP, when it is set and idle and
+* the copy suits it, by a single loopback DMA command.
+*
+* @param	EnginePtr is a pointer to the copy engine.
+* @param	TokenPtr is the completion token of the copy.
+* @param	SrcAddr is the source.
+* @param	DstAddr is the destination.
+* @param	Count is the number of bytes of the copy.
+*
+* @return	The number of bytes the PCAP moves, 0 if none.
+*
+*****************************************************************************/
+static u32 XDmaPs_MemCpyStartPcap(XDmaPs_MemCpy *EnginePtr,
+				  XDmaPs_MemCpyToken *TokenPtr,
+				  UINTPTR SrcAddr, UINTPTR DstAddr, u32 Count)
+{
+	XDcfg *DcfgPtr = EnginePtr->DcfgPtr;
+	u32 Len;
+	u32 Rest;
+
+	if ((DcfgPtr == NULL) || (((SrcAddr | DstAddr) & 3U) != 0U)) {
+		return 0U;
+	}
+
+	Len = ((Count / 16U) * EnginePtr->PcapShare) &
+	      ~(XDMAPS_MEMCPY_PCAP_ALIGN - 1U);
+	Rest = Count - Len;
+	if ((Len < EnginePtr->Threshold) ||
+	    (Rest > (XDMAPS_MEMCPY_CHUNK_LEN * XDMAPS_MEMCPY_MAX_CHUNKS))) {
+		return 0U;
+	}
+
+	XDmaPs_MemCpyPollPcap(EnginePtr);
+	if (EnginePtr->PcapTokenPtr != NULL) {
+		return 0U;
+	}
+
+	XDcfg_IntrClear(DcfgPtr, XDCFG_IXR_DMA_DONE_MASK |
+			XDCFG_IXR_D_P_DONE_MASK | XDCFG_IXR_ERROR_FLAGS_MASK);
+
+	if (Xil_DmaArenaContains((u32)SrcAddr, Len) == 0U) {
+		Xil_DCacheFlushRange(SrcAddr, Len);
+	}
+	if (Xil_DmaArenaContains((u32)DstAddr, Len) == 0U) {
+		Xil_DCacheInvalidateRange(DstAddr, Len);
+	}
+
+	/* A single command, marked as the last one by the LSBs */
+	if (XDcfg_Transfer(DcfgPtr, (void *)(SrcAddr | 1U), Len >> 2U,
+			   (void *)(DstAddr | 1U), Len >> 2U,
+			   XDCFG_CONCURRENT_NONSEC_READ_WRITE) !=
+	    (u32)XST_SUCCESS) {
+		return 0U;
+	}
+
+	TokenPtr->PcapDstAddr = (u32)DstAddr;
+	TokenPtr->PcapLen = Len;
+	TokenPtr->Pending = 1U;
+	EnginePtr->PcapTokenPtr = TokenPtr;
+
+	return Len;
+}
+
+/****************************************************************************/
+/*
+*
+* Completes the copy the PCAP moves, if its DMA command is done or failed.
+* It drops the destination lines the CPU may have fetched meanwhile and
+* counts the part of the copy.
+*
+* @param	EnginePtr is a pointer to the copy engine.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void XDmaPs_MemCpyPollPcap(XDmaPs_MemCpy *EnginePtr)
+{
+	XDmaPs_MemCpyToken *TokenPtr = EnginePtr->PcapTokenPtr;
+	u32 IntrStatus;
+	u32 Cpsr;
+
+	if (TokenPtr == NULL) {
+		return;
+	}
+
+	IntrStatus = XDcfg_IntrGetStatus(EnginePtr->DcfgPtr);
+	if ((IntrStatus & XDCFG_IXR_ERROR_FLAGS_MASK) != 0U) {
+		TokenPtr->Status = (s32)XST_FAILURE;
+	} else if ((IntrStatus & XDCFG_IXR_DMA_DONE_MASK) == 0U) {
+		return;
+	} else if (Xil_DmaArenaContains(TokenPtr->PcapDstAddr,
+					TokenPtr->PcapLen) == 0U) {
+		Xil_DCacheInvalidateRange(TokenPtr->PcapDstAddr,
+					  TokenPtr->PcapLen);
+	}
+
+	XDcfg_IntrClear(EnginePtr->DcfgPtr, IntrStatus &
+			(XDCFG_IXR_DMA_DONE_MASK | XDCFG_IXR_D_P_DONE_MASK |
+			 XDCFG_IXR_ERROR_FLAGS_MASK));
+	EnginePtr->PcapTokenPtr = NULL;
+
+	/* The done handlers of the channels update the token too */
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	TokenPtr->Pending--;
+	mtcpsr(Cpsr);
+}
+#endif
+/** @} */
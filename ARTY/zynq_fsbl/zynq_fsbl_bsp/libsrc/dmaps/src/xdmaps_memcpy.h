@@ -0,0 +1,188 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file xdmaps_memcpy.h
+* @addtogroup dmaps Overview
+* @{
+* @details
+*
+* This file contains the asynchronous memory copy of the XDmaPs driver. A
+* copy engine owns a set of DMA channels and moves memory to memory copies
+* on them, so that the CPU carries on while a bulk copy is in progress.
+*
+* XDmaPs_MemCpyAsync() starts a copy and returns at once. The caller keeps
+* the completion token of the copy and polls it with XDmaPs_MemCpyIsDone()
+* or waits for it with XDmaPs_MemCpyWait(). Copies larger than
+* XDMAPS_MEMCPY_CHUNK_LEN are split into several DMA commands submitted to
+* the least loaded channels of the engine.
+*
+* Copies that the DMA would not move faster are done on the CPU with
+* Xil_MemCpy() before XDmaPs_MemCpyAsync() returns, and their token is done
+* at once. These are the copies shorter than the threshold of the engine and
+* the copies whose source and destination are not equally aligned on 8
+* bytes, for which the PL330 falls back to single byte transfers.
+*
+* XDmaPs_MemSetAsync() fills memory with a byte the same way, e.g. to clear
+* large DDR buffers. Its chunks read the 8 bytes of the token that hold the
+* byte repeated, from a fixed source address, and write the destination
+* with incrementing bursts, so that the fill costs no CPU time past its
+* submission. Fills shorter than the threshold are done with Xil_MemSet().
+*
+* Where the BSP has the device configuration interface, the PCAP DMA of the
+* XDcfg driver can take part in the copies, set with XDmaPs_MemCpySetPcap()
+* once the PL is configured, since the PCAP is idle from then on. Its
+* loopback mode, XDCFG_CONCURRENT_NONSEC_READ_WRITE as in the FSBL, reads
+* the source and writes the destination, in parallel with the PL330 and
+* on AXI ports of its own. A copy whose source and destination are word
+* aligned then gives its first sixteenths, the share of the PCAP rounded
+* down to XDMAPS_MEMCPY_PCAP_ALIGN bytes, to the PCAP and the rest to the
+* channels, when the PCAP is not moving another copy. Only one copy at a
+* time uses the PCAP, the others run on the channels alone. The engine
+* polls the DMA done status of the PCAP from XDmaPs_MemCpyIsDone(),
+* XDmaPs_MemCpyWait() and the next copy, with no interrupt: the DMA done
+* interrupt of the XDcfg instance must be left disabled, nothing else may
+* use the PCAP while the engine has it, and the copies are polled from the
+* context that starts them. Fills stay on the channels.
+*
+* Source and destination are flushed and invalidated by the DMA driver, and
+* the destination is invalidated again once copied or filled, in case the
+* CPU fetched it speculatively meanwhile. The destination should therefore
+* be cache line aligned and must not be accessed until the copy is done.
+* The byte of a fill is flushed from the token. Buffers in the DMA arena
+* of xil_dmaarena.h need no cache maintenance.
+*
+* The engine sets the done handlers of its channels, which must not be used
+* for anything else. A chunk that faults is reported to the fault handler of
+* the XDmaPs instance only, and its token is never done.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 2.10  qm     10/14/26 First release
+*       qm     10/14/26 Take the burst shape from the burst table.
+*       qm     10/14/26 Added XDmaPs_MemSetAsync(), a constant fill.
+*       qm     10/14/26 Added the PCAP of the XDcfg driver as a second copy
+*                       engine, XDmaPs_MemCpySetPcap().
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef XDMAPS_MEMCPY_H		/* prevent circular inclusions */
+#define XDMAPS_MEMCPY_H		/* by using protection macros */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xdmaps.h"
+#if defined (XPAR_XDEVCFG_0_BASEADDR)
+#include "xdevcfg.h"
+#define XDMAPS_MEMCPY_PCAP	/**< The PCAP can take part in the copies */
+#endif
+
+/************************** Constant Definitions ****************************/
+
+/** Copies shorter than this are done on the CPU by default */
+#ifndef XDMAPS_MEMCPY_THRESHOLD
+#define XDMAPS_MEMCPY_THRESHOLD		4096U
+#endif
+
+/** Bytes moved by one DMA command, well within the 2-level loop limit */
+#define XDMAPS_MEMCPY_CHUNK_LEN		0x200000U
+
+/** DMA commands of one copy, which bounds a copy to 8 MB */
+#define XDMAPS_MEMCPY_MAX_CHUNKS	4U
+
+/**
+ * Widest bursts of the 64-bit PL330 of the Zynq, 16 beats of 8 bytes, used
+ * where the burst table of the instance has no rule for a copy
+ */
+#define XDMAPS_MEMCPY_BURST_SIZE	8U
+#define XDMAPS_MEMCPY_BURST_LEN		16U
+
+/** Sixteenths of a copy given to the PCAP by default, about its share of
+ *  the bandwidth next to the PL330 */
+#ifndef XDMAPS_MEMCPY_PCAP_SHARE
+#define XDMAPS_MEMCPY_PCAP_SHARE	4U
+#endif
+
+/** Granule of the part of a copy moved by the PCAP */
+#define XDMAPS_MEMCPY_PCAP_ALIGN	64U
+
+/**************************** Type Definitions ******************************/
+
+struct XDmaPs_MemCpyTokenStruct;
+struct XDmaPs_MemCpyStruct;
+
+/**
+ * One DMA command of a copy. The command comes first, so that the done
+ * handler finds the chunk from the command it is given.
+ */
+typedef struct {
+	XDmaPs_Cmd Cmd;		/**< DMA command of the chunk */
+	struct XDmaPs_MemCpyTokenStruct *TokenPtr; /**< Copy of the chunk */
+} XDmaPs_MemCpyChunk;
+
+/**
+ * Completion token of a copy. It must stay valid until the copy is done.
+ */
+typedef struct XDmaPs_MemCpyTokenStruct {
+	XDmaPs_MemCpyChunk Chunks[XDMAPS_MEMCPY_MAX_CHUNKS];
+				/**< DMA commands of the copy */
+	volatile u32 Pending;	/**< Chunks not done yet */
+	volatile s32 Status;	/**< XST_SUCCESS, or XST_FAILURE if a
+				  *  chunk failed */
+	u64 Fill;		/**< Source of a fill, its byte 8 times */
+#if defined (XDMAPS_MEMCPY_PCAP)
+	struct XDmaPs_MemCpyStruct *EnginePtr; /**< Engine of the copy */
+	u32 PcapDstAddr;	/**< Destination of the PCAP part */
+	u32 PcapLen;		/**< Bytes of the PCAP part, 0 if none */
+#endif
+} XDmaPs_MemCpyToken;
+
+/**
+ * A copy engine. It refers to an initialized XDmaPs instance.
+ */
+typedef struct XDmaPs_MemCpyStruct {
+	XDmaPs *DmaPtr;		/**< DMA controller instance */
+	u32 ChannelMask;	/**< Channels used for the copies */
+	u32 Threshold;		/**< Shortest copy moved by the DMA */
+#if defined (XDMAPS_MEMCPY_PCAP)
+	XDcfg *DcfgPtr;		/**< PCAP of the copies, NULL if none */
+	u32 PcapShare;		/**< Sixteenths of a copy it moves */
+	XDmaPs_MemCpyToken *PcapTokenPtr; /**< Copy it moves, if any */
+#endif
+} XDmaPs_MemCpy;
+
+/************************** Function Prototypes *****************************/
+
+s32 XDmaPs_MemCpyInitialize(XDmaPs_MemCpy *EnginePtr, XDmaPs *DmaPtr,
+			    u32 ChannelMask);
+void XDmaPs_MemCpySetThreshold(XDmaPs_MemCpy *EnginePtr, u32 Threshold);
+#if defined (XDMAPS_MEMCPY_PCAP)
+s32 XDmaPs_MemCpySetPcap(XDmaPs_MemCpy *EnginePtr, XDcfg *DcfgPtr,
+			 u32 Share);
+#endif
+s32 XDmaPs_MemCpyAsync(XDmaPs_MemCpy *EnginePtr,
+		       XDmaPs_MemCpyToken *TokenPtr, void *DstPtr,
+		       const void *SrcPtr, u32 Count);
+s32 XDmaPs_MemSetAsync(XDmaPs_MemCpy *EnginePtr,
+		       XDmaPs_MemCpyToken *TokenPtr, void *DstPtr, u8 Value,
+		       u32 Count);
+u32 XDmaPs_MemCpyIsDone(const XDmaPs_MemCpyToken *TokenPtr);
+s32 XDmaPs_MemCpyWait(const XDmaPs_MemCpyToken *TokenPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of protection macro */
+/** @} */
@@ -41,6 +41,8 @@
 *                     reported by coverity tool. It fixes CR#1006344.
 * 3.10  mus  07/17/18 Updated file to fix the various coding style issues
 *                     reported by checkpatch. It fixes CR#1006344.
+* 5.6   qm   10/14/26 Placed XScuGic_InterruptHandler in the interrupt hot
+*                     path of xil_hotpath.h.
 *
 * </pre>
 *
@@ -60,6 +62,7 @@
 #include "xil_types.h"
 #include "xil_assert.h"
 #include "xscugic.h"
+#include "xil_hotpath.h"
 
 /************************** Constant Definitions *****************************/
 
@@ -91,6 +94,7 @@
 *
 *
 ******************************************************************************/
+XIL_HOTPATH_TEXT
 void XScuGic_InterruptHandler(XScuGic *InstancePtr)
 {
 
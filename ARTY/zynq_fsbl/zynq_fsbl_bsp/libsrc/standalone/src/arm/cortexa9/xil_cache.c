@@ -101,6 +101,15 @@
 *                     Changes are made to fix the same.
 * 9.1   asa  31/01/24 Fix overflow issues under corner cases for various
 *                     cache maintenance APIs.
+* 9.3   qm   10/14/26 Ranges of XIL_L1_DCACHE_RANGE_THRESHOLD or
+*                     XIL_L2_CACHE_RANGE_THRESHOLD bytes and more are
+*                     maintained by set/way and by the PL310 background way
+*                     operations. The L2 line operations of a range are
+*                     followed by a single L2 cache sync.
+*       qm   10/14/26 The L1 set/way flush of large ranges is only used
+*                     while the other CPU is not running, see
+*                     Xil_DCacheSetSmp(). Large invalidate ranges are
+*                     invalidated line by line again.
 * </pre>
 *
 ******************************************************************************/
@@ -125,6 +134,13 @@
 #define MAX_ADDR 				0xFFFFFFFFU
 #define LAST_CACHELINE_START	0xFFFFFFE0U
 
+/*
+ * Set once the other CPU runs with its data cache on. The set/way operations
+ * only reach the L1 of the calling CPU, the maintenance by MVA is broadcast
+ * to the other one by ACTLR.FW.
+ */
+static u32 Xil_DCacheSmp;
+
 #ifdef __GNUC__
 	extern s32  _stack_end;
 	extern s32  __undef_stack;
@@ -309,7 +325,6 @@ void Xil_DCacheInvalidateLine(u32 adr)
 * 			for a variable present in the same cache line, then we will have to
 *			invalidate the cache after DMA is complete.
 *
-*
 * @param	adr: 32bit start address of the range to be invalidated.
 * @param	len: Length of the range to be invalidated in bytes.
 *
@@ -373,9 +388,9 @@ void Xil_DCacheInvalidateRange(INTPTR adr, u32 len)
 		while (tempadr < endaddr) {
 			/* Invalidate L2 cache line */
 			*L2CCOffset = tempadr;
-			Xil_L2CacheSync();
 			((MAX_ADDR - (u32)tempadr) < cacheline) ? (tempadr = MAX_ADDR) : (tempadr += cacheline) ;
 		}
+		Xil_L2CacheSync();
 #endif
 
 		while (adr < endaddr) {
@@ -457,12 +472,21 @@ void Xil_DCacheFlushLine(u32 adr)
 * 			data cache, the cachelines containing those bytes are invalidated.
 * 			If the cachelines are modified (dirty), they are written to the
 * 			system memory before the lines are invalidated.
+* 			The whole L1 cache is flushed by set/way for ranges of
+* 			XIL_L1_DCACHE_RANGE_THRESHOLD bytes and more, and the whole L2
+* 			cache by way for ranges of XIL_L2_CACHE_RANGE_THRESHOLD bytes
+* 			and more.
 *
 * @param	adr: 32bit start address of the range to be flushed.
 * @param	len: Length of the range to be flushed in bytes.
 *
 * @return	None.
 *
+* @note		Set/way operations only reach the L1 cache of the calling CPU.
+*			Once Xil_DCacheSetSmp() tells that the other CPU runs, L1 is
+*			flushed by MVA whatever the length, so that the lines the
+*			other CPU holds are flushed too.
+*
 ****************************************************************************/
 void Xil_DCacheFlushRange(INTPTR adr, u32 len)
 {
@@ -483,34 +507,65 @@ void Xil_DCacheFlushRange(INTPTR adr, u32 len)
 
 		tempadr = adr;
 
-		while (tempadr < opendadr) {
-			/* Flush L1 Data cache line */
+		if ((len >= XIL_L1_DCACHE_RANGE_THRESHOLD) &&
+		    (Xil_DCacheSmp == 0U)) {
+			/* Flush the whole L1 Data cache by set/way */
+			Xil_L1DCacheFlush();
+		} else {
+			while (tempadr < opendadr) {
+				/* Flush L1 Data cache line */
 #if defined (__GNUC__) || defined (__ICCARM__)
-			asm_cp15_clean_inval_dc_line_mva_poc(tempadr);
+				asm_cp15_clean_inval_dc_line_mva_poc(tempadr);
 #else
-			{ volatile register u32 Reg
-				__asm(XREG_CP15_CLEAN_INVAL_DC_LINE_MVA_POC);
-			  Reg = tempadr; }
+				{ volatile register u32 Reg
+					__asm(XREG_CP15_CLEAN_INVAL_DC_LINE_MVA_POC);
+				  Reg = tempadr; }
 #endif
-			((MAX_ADDR - (u32)tempadr) < cacheline) ? (tempadr = MAX_ADDR) : (tempadr += cacheline);
+				((MAX_ADDR - (u32)tempadr) < cacheline) ? (tempadr = MAX_ADDR) : (tempadr += cacheline);
+			}
+			/* Wait for L1 cache clean and invalidation to complete */
+			dsb();
 		}
-		/* Wait for L1 cache clean and invalidation to complete */
-		dsb();
 
 #ifndef USE_AMP
-		/* Disable Write-back and line fills */
-		Xil_L2WriteDebugCtrl(0x3U);
-		while ((u32)adr < opendadr) {
-			/* Flush L2 cache line */
-			*L2CCOffset = adr;
+		if (len >= XIL_L2_CACHE_RANGE_THRESHOLD) {
+			/* Flush the whole L2 cache by way */
+			Xil_L2CacheFlush();
+		} else {
+			/* Disable Write-back and line fills */
+			Xil_L2WriteDebugCtrl(0x3U);
+			while ((u32)adr < opendadr) {
+				/* Flush L2 cache line */
+				*L2CCOffset = adr;
+				((MAX_ADDR - (u32)adr) < cacheline) ? (adr = MAX_ADDR) : (adr += cacheline);
+			}
 			Xil_L2CacheSync();
-			((MAX_ADDR - (u32)adr) < cacheline) ? (adr = MAX_ADDR) : (adr += cacheline);
+			Xil_L2WriteDebugCtrl(0x0U);
 		}
-		Xil_L2WriteDebugCtrl(0x0U);
 #endif
 	}
 	mtcpsr(currmask);
 }
+
+/****************************************************************************/
+/**
+* @brief	Tell whether the other CPU runs with its data cache on, which
+*			keeps Xil_DCacheFlushRange() from the set/way operations that
+*			would miss its lines.
+*
+* @param	Smp: 1 once the other CPU runs, 0 while only the calling CPU
+*			does.
+*
+* @return	None.
+*
+* @note		Call it with 1 before starting the other CPU.
+*
+****************************************************************************/
+void Xil_DCacheSetSmp(u32 Smp)
+{
+	Xil_DCacheSmp = Smp;
+	dsb();
+}
 /****************************************************************************/
 /**
 * @brief	Store a Data cache line. If the byte specified by the address (adr)
@@ -1406,9 +1461,9 @@ void Xil_L2CacheInvalidateRange(u32 adr, u32 len)
 
 		while (LocalAddr < end) {
 			*L2CCOffset = LocalAddr;
-			Xil_L2CacheSync();
 			((MAX_ADDR - LocalAddr) < cacheline) ? (LocalAddr = MAX_ADDR) : (LocalAddr += cacheline);
 		}
+		Xil_L2CacheSync();
 
 		/* Enable Write-back and line fills */
 		Xil_L2WriteDebugCtrl(0x0U);
@@ -1505,7 +1560,10 @@ void Xil_L2CacheFlushRange(u32 adr, u32 len)
 
 	currmask = mfcpsr();
 	mtcpsr(currmask | IRQ_FIQ_MASK);
-	if (len != 0U) {
+	if (len >= XIL_L2_CACHE_RANGE_THRESHOLD) {
+		/* Flush the whole L2 cache by way */
+		Xil_L2CacheFlush();
+	} else if (len != 0U) {
 		/* Back the starting address up to the start of a cache line
 		 * perform cache operations until adr+len
 		 */
@@ -1517,9 +1575,9 @@ void Xil_L2CacheFlushRange(u32 adr, u32 len)
 
 		while (LocalAddr < end) {
 			*L2CCOffset = LocalAddr;
-			Xil_L2CacheSync();
 			((MAX_ADDR - LocalAddr) < cacheline) ? (LocalAddr = MAX_ADDR) : (LocalAddr += cacheline);
 		}
+		Xil_L2CacheSync();
 
 		/* Enable Write-back and line fills */
 		Xil_L2WriteDebugCtrl(0x0U);
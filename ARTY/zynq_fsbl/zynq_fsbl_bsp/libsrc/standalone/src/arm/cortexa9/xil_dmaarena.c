@@ -0,0 +1,333 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_dmaarena.c
+*
+* This file provides the DMA buffer arena, a non-cacheable region split
+* into pools of fixed size blocks. Refer to xil_dmaarena.h for more details.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+* @note
+*
+* The free stacks are lock-free against the interrupt handlers of the same
+* CPU. They are not meant to be shared with the other CPU.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+#include "xil_assert.h"
+#include "xstatus.h"
+#include "xil_mmu.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xil_dmaarena.h"
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/**************************** Type Definitions *******************************/
+
+/**
+ * The mapped region. Pools are carved out of it from the bottom up.
+ */
+typedef struct {
+	UINTPTR BaseAddr;	/**< First byte of the arena */
+	UINTPTR EndAddr;	/**< Last byte of the arena */
+	UINTPTR NextAddr;	/**< First byte not given to a pool */
+} Xil_DmaArena;
+
+/************************** Constant Definitions *****************************/
+
+#define XIL_DMAARENA_INDEX_MASK	0x0000FFFFU	/**< Top of a pool head */
+#define XIL_DMAARENA_TAG_MASK	0xFFFF0000U	/**< Tag of a pool head */
+#define XIL_DMAARENA_TAG_INC	0x00010000U	/**< Tag step per update */
+#define XIL_DMAARENA_MAX_ADDR	0xFFFFFFFFU
+
+/************************** Variable Definitions *****************************/
+
+static Xil_DmaArena DmaArena;
+
+/************************** Function Prototypes ******************************/
+
+static u32 Xil_DmaPoolSwapHead(Xil_DmaPool *PoolPtr, u32 Old, u32 New);
+
+/*****************************************************************************/
+/**
+* @brief	Maps a region reserved by the linker script as the DMA arena.
+*
+* @param	BaseAddr is the start of the region, on a 1 MB boundary.
+* @param	Size is the size of the region, a multiple of 1 MB.
+* @param	Attrib is the memory attribute of the region, NORM_NONCACHE
+*			for write-combining buffers or DEVICE_MEMORY for
+*			bufferable device memory.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM if the region is not made
+*			of whole MMU sections.
+*
+* @note		Xil_SetTlbAttributes() flushes the whole Data cache for
+*			every section, so the arena is meant to be mapped once at
+*			startup. The pools created before are lost.
+*
+******************************************************************************/
+s32 Xil_DmaArenaInitialize(UINTPTR BaseAddr, u32 Size, u32 Attrib)
+{
+	UINTPTR Addr;
+
+	if ((Size == 0U) ||
+	    ((BaseAddr & (XIL_DMAARENA_SECTION_SIZE - 1U)) != 0U) ||
+	    ((Size & (XIL_DMAARENA_SECTION_SIZE - 1U)) != 0U) ||
+	    ((Size - 1U) > (XIL_DMAARENA_MAX_ADDR - BaseAddr))) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	DmaArena.BaseAddr = 0U;
+	DmaArena.EndAddr = 0U;
+	DmaArena.NextAddr = 0U;
+
+	for (Addr = BaseAddr; (Addr - BaseAddr) < Size;
+	     Addr += XIL_DMAARENA_SECTION_SIZE) {
+		Xil_SetTlbAttributes((INTPTR)Addr, Attrib);
+	}
+
+	DmaArena.BaseAddr = BaseAddr;
+	DmaArena.EndAddr = BaseAddr + (Size - 1U);
+	DmaArena.NextAddr = BaseAddr;
+
+	return (s32)XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Tells whether a buffer lies in the DMA arena, in which case it
+*			needs no cache maintenance.
+*
+* @param	Addr is the start of the buffer.
+* @param	Len is the length of the buffer in bytes.
+*
+* @return	1 if the whole buffer is in the arena, 0 otherwise.
+*
+******************************************************************************/
+u32 Xil_DmaArenaContains(UINTPTR Addr, u32 Len)
+{
+	u32 Status = 0U;
+
+	if ((DmaArena.NextAddr != 0U) && (Addr >= DmaArena.BaseAddr) &&
+	    (Addr <= DmaArena.EndAddr) &&
+	    ((Len == 0U) || ((Len - 1U) <= (DmaArena.EndAddr - Addr)))) {
+		Status = 1U;
+	}
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Returns the bytes of the DMA arena not given to a pool yet.
+*
+* @return	The number of free bytes, 0 if the arena is not mapped.
+*
+******************************************************************************/
+u32 Xil_DmaArenaRemaining(void)
+{
+	if (DmaArena.NextAddr == 0U) {
+		return 0U;
+	}
+
+	return (u32)(DmaArena.EndAddr - DmaArena.NextAddr) + 1U;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Creates a pool of fixed size blocks in the DMA arena. The blocks
+*			are cache line aligned and all free.
+*
+* @param	PoolPtr is the pool to be created.
+* @param	BlockSize is the size of a block in bytes, rounded up to a
+*			multiple of the cache line size.
+* @param	NumBlocks is the number of blocks, up to
+*			XIL_DMAARENA_MAX_BLOCKS.
+*
+* @return
+*		- XST_SUCCESS if the pool was created.
+*		- XST_NOT_ENABLED if the arena is not mapped.
+*		- XST_INVALID_PARAM if a size is zero or out of range.
+*		- XST_BUFFER_TOO_SMALL if the arena has no room left for the
+*		  pool.
+*
+* @note		Pools cannot be deleted.
+*
+******************************************************************************/
+s32 Xil_DmaPoolCreate(Xil_DmaPool *PoolPtr, u32 BlockSize, u32 NumBlocks)
+{
+	u32 Size;
+	u32 Index;
+	UINTPTR BlockAddr;
+
+	Xil_AssertNonvoid(PoolPtr != NULL);
+
+	if (DmaArena.NextAddr == 0U) {
+		return (s32)XST_NOT_ENABLED;
+	}
+	if ((BlockSize == 0U) || (NumBlocks == 0U) ||
+	    (NumBlocks > XIL_DMAARENA_MAX_BLOCKS) ||
+	    (BlockSize > (XIL_DMAARENA_MAX_ADDR - (XIL_DMAARENA_ALIGN - 1U)))) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	Size = (BlockSize + (XIL_DMAARENA_ALIGN - 1U)) &
+	       ~(XIL_DMAARENA_ALIGN - 1U);
+	if (Size > (Xil_DmaArenaRemaining() / NumBlocks)) {
+		return (s32)XST_BUFFER_TOO_SMALL;
+	}
+
+	PoolPtr->BaseAddr = DmaArena.NextAddr;
+	PoolPtr->BlockSize = Size;
+	PoolPtr->NumBlocks = NumBlocks;
+
+	/* Chain the blocks in address order, the first one on top */
+	for (Index = 0U; Index < NumBlocks; Index++) {
+		BlockAddr = PoolPtr->BaseAddr + (Index * Size);
+		*(volatile u32 *)BlockAddr = (Index + 2U <= NumBlocks) ?
+					     (Index + 2U) : 0U;
+	}
+	PoolPtr->Head = 1U;
+
+	DmaArena.NextAddr += Size * NumBlocks;
+
+	return (s32)XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Takes a block from a pool. It may be called from interrupt
+*			handlers.
+*
+* @param	PoolPtr is the pool.
+*
+* @return	The block, or NULL if the pool is empty.
+*
+******************************************************************************/
+void *Xil_DmaPoolAlloc(Xil_DmaPool *PoolPtr)
+{
+	UINTPTR BlockAddr;
+	u32 Head;
+	u32 Next;
+
+	Xil_AssertNonvoid(PoolPtr != NULL);
+
+	do {
+		Head = PoolPtr->Head;
+		if ((Head & XIL_DMAARENA_INDEX_MASK) == 0U) {
+			return NULL;
+		}
+		BlockAddr = PoolPtr->BaseAddr +
+			    (((Head & XIL_DMAARENA_INDEX_MASK) - 1U) *
+			     PoolPtr->BlockSize);
+		/*
+		 * The link is stale if another context took the block in the
+		 * meantime, the tag makes the swap fail then.
+		 */
+		Next = *(volatile u32 *)BlockAddr;
+	} while (Xil_DmaPoolSwapHead(PoolPtr, Head,
+				     ((Head + XIL_DMAARENA_TAG_INC) &
+				      XIL_DMAARENA_TAG_MASK) |
+				     (Next & XIL_DMAARENA_INDEX_MASK)) == 0U);
+
+	return (void *)BlockAddr;
+}
+
+/*****************************************************************************/
+/**
+* @brief	Returns a block to its pool. It may be called from interrupt
+*			handlers.
+*
+* @param	PoolPtr is the pool the block was taken from.
+* @param	BlockPtr is the block.
+*
+* @return	None.
+*
+******************************************************************************/
+void Xil_DmaPoolFree(Xil_DmaPool *PoolPtr, void *BlockPtr)
+{
+	UINTPTR Offset;
+	u32 Index;
+	u32 Head;
+
+	Xil_AssertVoid(PoolPtr != NULL);
+	Xil_AssertVoid(BlockPtr != NULL);
+
+	Offset = (UINTPTR)BlockPtr - PoolPtr->BaseAddr;
+	Index = (u32)(Offset / PoolPtr->BlockSize);
+	Xil_AssertVoid(Index < PoolPtr->NumBlocks);
+	Xil_AssertVoid((Offset % PoolPtr->BlockSize) == 0U);
+
+	do {
+		Head = PoolPtr->Head;
+		*(volatile u32 *)BlockPtr = Head & XIL_DMAARENA_INDEX_MASK;
+	} while (Xil_DmaPoolSwapHead(PoolPtr, Head,
+				     ((Head + XIL_DMAARENA_TAG_INC) &
+				      XIL_DMAARENA_TAG_MASK) |
+				     (Index + 1U)) == 0U);
+}
+
+/*****************************************************************************/
+/**
+*
+* Replaces the head of a pool if it still holds the expected value, with
+* LDREX/STREX. A handler that updates the head in between ends with its own
+* exclusive store, which leaves the monitor open and fails this one. The
+* monitor is cleared when the value does not match, so that no exclusive
+* access is left pending for the interrupted context.
+*
+* @param	PoolPtr is the pool.
+* @param	Old is the expected head.
+* @param	New is the new head.
+*
+* @return	1 if the head was replaced, 0 otherwise.
+*
+******************************************************************************/
+static u32 Xil_DmaPoolSwapHead(Xil_DmaPool *PoolPtr, u32 Old, u32 New)
+{
+	u32 Value;
+	u32 Failed;
+#if defined (__GNUC__)
+	__asm__ __volatile__(
+		"	ldrex	%0, [%2]	\n"
+		"	mov	%1, #1		\n"
+		"	teq	%0, %3		\n"
+		"	bne	1f		\n"
+		"	strex	%1, %4, [%2]	\n"
+		"	b	2f		\n"
+		"1:	clrex			\n"
+		"2:				\n"
+		: "=&r" (Value), "=&r" (Failed)
+		: "r" (&PoolPtr->Head), "r" (Old), "r" (New)
+		: "cc", "memory");
+	(void)Value;
+#else
+	u32 Cpsr;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	Value = PoolPtr->Head;
+	Failed = 1U;
+	if (Value == Old) {
+		PoolPtr->Head = New;
+		Failed = 0U;
+	}
+	mtcpsr(Cpsr);
+#endif
+
+	return (Failed == 0U) ? 1U : 0U;
+}
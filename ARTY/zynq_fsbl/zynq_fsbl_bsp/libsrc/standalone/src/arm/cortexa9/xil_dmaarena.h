@@ -0,0 +1,97 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_dmaarena.h
+*
+* @addtogroup a9_dmaarena_apis Cortex A9 DMA Buffer Arena Functions
+*
+* The DMA arena is a region of memory mapped as normal non-cacheable, or
+* as device memory, so that the buffers placed in it are coherent with the
+* DMA masters and need no cache flush or invalidation around a transfer.
+* Normal non-cacheable memory still merges stores in the store buffer of
+* the CPU, which makes it write-combining.
+*
+* The arena is reserved by the linker script and mapped once with
+* Xil_DmaArenaInitialize(). Since the MMU maps memory in 1 MB sections, the
+* arena must start and end on a 1 MB boundary. It is then split at startup
+* into pools of fixed size, cache line aligned blocks with
+* Xil_DmaPoolCreate(), and blocks are taken from and returned to a pool
+* with Xil_DmaPoolAlloc() and Xil_DmaPoolFree(). Each pool keeps its free
+* blocks in a lock-free stack built on LDREX/STREX, so that blocks can be
+* allocated and freed from both tasks and interrupt handlers without
+* masking interrupts.
+*
+* Xil_DmaArenaContains() tells whether a buffer is in the arena, which
+* drivers use to skip their cache maintenance.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/**
+*@cond nocomments
+*/
+
+#ifndef XIL_DMAARENA_H
+#define XIL_DMAARENA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+#define XIL_DMAARENA_SECTION_SIZE	0x100000U	/* MMU section */
+#define XIL_DMAARENA_ALIGN		32U	/* Cache line */
+#define XIL_DMAARENA_MAX_BLOCKS		0xFFFEU	/* Blocks of a pool */
+
+/**************************** Type Definitions *******************************/
+
+/**
+ * Pool of fixed size blocks. The head of the free stack holds the index of
+ * the top block plus one in its lower half, zero for an empty pool, and a
+ * tag in its upper half that changes on every update so that a block freed
+ * and allocated again between the load and the store of another context
+ * is noticed.
+ */
+typedef struct {
+	UINTPTR BaseAddr;	/* First block */
+	u32 BlockSize;		/* Bytes per block, cache line multiple */
+	u32 NumBlocks;		/* Blocks of the pool */
+	volatile u32 Head;	/* Tag and top of the free stack */
+} Xil_DmaPool;
+
+/**
+*@endcond
+*/
+
+/************************** Function Prototypes ******************************/
+
+s32 Xil_DmaArenaInitialize(UINTPTR BaseAddr, u32 Size, u32 Attrib);
+u32 Xil_DmaArenaContains(UINTPTR Addr, u32 Len);
+u32 Xil_DmaArenaRemaining(void);
+s32 Xil_DmaPoolCreate(Xil_DmaPool *PoolPtr, u32 BlockSize, u32 NumBlocks);
+void *Xil_DmaPoolAlloc(Xil_DmaPool *PoolPtr);
+void Xil_DmaPoolFree(Xil_DmaPool *PoolPtr, void *BlockPtr);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* XIL_DMAARENA_H */
+/**
+* @} End of "addtogroup a9_dmaarena_apis".
+*/
@@ -0,0 +1,159 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_hotpath.h
+*
+* @addtogroup a9_hotpath_apis Cortex A9 Interrupt Hot Path Placement
+*
+* The worst case interrupt latency is set by the L2 misses into DDR on the
+* way from the interrupt entry to the first FIFO access. Functions and data
+* tagged with XIL_HOTPATH_TEXT and XIL_HOTPATH_DATA are kept out of DDR, in
+* one of two ways selected when the BSP is built:
+*
+* - By default they are placed in the on-chip memory. The linker script
+*   links them at their OCM address in the .ocm output section and loads
+*   them into DDR after the rest of the image, and Xil_HotPathInitialize(),
+*   called by the startup code before main(), copies them over. The high
+*   OCM is mapped inner cacheable only, so L1 misses go to the OCM without
+*   going through the L2 cache.
+* - With XIL_HOTPATH_L2 defined they are placed in the .l2_lock output
+*   section in DDR, which Xil_HotPathInitialize() loads into way
+*   XIL_HOTPATH_L2_WAY of the PL310 and locks down. The section must not be
+*   larger than a way, 64 KB on the Zynq.
+*
+* The interrupt handlers of the XScuGic and XUartPs drivers, down to the
+* FIFO accesses, are tagged.
+*
+* Other time critical code and data of the application, inner loops and
+* their tables, are tagged with XIL_FAST_TEXT, XIL_FAST_DATA and
+* XIL_FAST_BSS. They go to the .ocm_fast and .ocm_fast_bss output sections
+* at the start of the low OCM, the first being copied from its load address
+* in DDR and the second cleared by Xil_HotPathInitialize(). The low OCM is
+* mapped cacheable like DDR and the ocm_low arena of the application takes
+* what they leave.
+*
+* The OCM can also be used as one block of 256 KB at 0xFFFC0000, for
+* buffers larger than either part. An application linked with
+* --defsym=_OCM_HIGH=1 has its linker script place the .ocm, .ocm_fast and
+* .ocm_fast_bss sections and the overlay window one after the other from
+* 0xFFFC0000, and the ocm arena takes the rest up to the FSBL records at
+* 0xFFFFF500. Xil_HotPathInitialize() then calls Xil_OcmRemapHigh() before
+* it loads them, which maps the low banks high and gives the first MB of
+* the address space of the CPUs to the DDR. All of it is then mapped inner
+* cacheable only, like the high OCM.
+*
+* Code that does not fit in the OCM all at once is split into overlays.
+* The functions and data of overlay N, below XIL_OVERLAY_MAX, are tagged
+* with XIL_OVERLAY_TEXT(N) and XIL_OVERLAY_DATA(N). The overlays are linked
+* at the same address, the overlay window after the .ocm_fast_bss section,
+* as large as the largest of them, and Xil_OverlayLoad() copies one of them
+* into the window. A function of an overlay may only be called while its
+* overlay is loaded, and no overlay may reference another, which the linker
+* checks. The data of an overlay is reloaded with it.
+*
+* With XIL_HOTPATH_DDR defined all the tags are empty and the tagged code
+* and data stay in .text and .data, to compare the latencies against DDR.
+* Xil_OverlayLoad() then has nothing to copy.
+*
+* Xil_HotPathL2Lock() locks any other range into a way. The L2 way
+* operations, Xil_L2CacheFlush(), Xil_L2CacheInvalidate() and the large
+* ranges of Xil_DCacheFlushRange(), evict locked lines too, after which the
+* way stays empty until it is locked again. Locked data must not be shared
+* with DMA masters.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 9.3   qm   10/14/26 First release
+*       qm   10/14/26 Added the fast sections of the low OCM, the overlays
+*                     and XIL_HOTPATH_DDR.
+*       qm   10/14/26 Added Xil_OcmRemapHigh() and Xil_OcmLowBase().
+* </pre>
+*
+******************************************************************************/
+
+/**
+*@cond nocomments
+*/
+
+#ifndef XIL_HOTPATH_H
+#define XIL_HOTPATH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/***************************** Include Files *********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+/* PL310 way the .l2_lock section is locked into */
+#ifndef XIL_HOTPATH_L2_WAY
+#define XIL_HOTPATH_L2_WAY	7U
+#endif
+
+#define XIL_HOTPATH_L2_NUM_WAYS	8U
+
+/* Overlays of the linker script, and the value of no overlay loaded */
+#define XIL_OVERLAY_MAX		4U
+#define XIL_OVERLAY_NONE	0xFFFFFFFFU
+
+/* The three low OCM banks, at address 0 or below the fourth one */
+#define XIL_OCM_LOW_BASEADDR	0x00000000U
+#define XIL_OCM_HIGH_BASEADDR	0xFFFC0000U
+#define XIL_OCM_LOW_SIZE	0x00030000U
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+#if defined (__GNUC__) && !defined (XIL_HOTPATH_DDR)
+#if defined (XIL_HOTPATH_L2)
+#define XIL_HOTPATH_TEXT	__attribute__((section(".l2_lock_text")))
+#define XIL_HOTPATH_DATA	__attribute__((section(".l2_lock_data")))
+#else
+#define XIL_HOTPATH_TEXT	__attribute__((section(".ocm_text")))
+#define XIL_HOTPATH_DATA	__attribute__((section(".ocm_data")))
+#endif
+#define XIL_FAST_TEXT		__attribute__((section(".ocm_fast_text")))
+#define XIL_FAST_DATA		__attribute__((section(".ocm_fast_data")))
+#define XIL_FAST_BSS		__attribute__((section(".ocm_fast_bss")))
+#define XIL_OVERLAY_TEXT(N)	__attribute__((section(".overlay" #N "_text")))
+#define XIL_OVERLAY_DATA(N)	__attribute__((section(".overlay" #N "_data")))
+#else
+#define XIL_HOTPATH_TEXT
+#define XIL_HOTPATH_DATA
+#define XIL_FAST_TEXT
+#define XIL_FAST_DATA
+#define XIL_FAST_BSS
+#define XIL_OVERLAY_TEXT(N)
+#define XIL_OVERLAY_DATA(N)
+#endif
+
+/**
+*@endcond
+*/
+
+/************************** Function Prototypes ******************************/
+
+void Xil_HotPathInitialize(void);
+s32 Xil_HotPathL2Lock(UINTPTR Addr, u32 Len, u32 Way);
+void Xil_HotPathL2Unlock(u32 Way);
+s32 Xil_OverlayLoad(u32 Id);
+u32 Xil_OverlayCurrent(void);
+void Xil_OcmRemapHigh(void);
+UINTPTR Xil_OcmLowBase(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* XIL_HOTPATH_H */
+/**
+* @} End of "addtogroup a9_hotpath_apis".
+*/
@@ -21,12 +21,14 @@
 * 1.05a hk     08/22/13 Added reset function
 * 3.00  kvn    02/13/15 Modified code for MISRA-C:2012 compliance.
 * 4.00  sd     02/02/24 Added wait for transmission done function
+* 3.14  qm     10/14/26 Added the buffered standard output.
 * </pre>
 *
 *****************************************************************************/
 
 /***************************** Include Files ********************************/
 #include "xuartps_hw.h"
+#include "xpseudo_asm.h"
 
 /************************** Constant Definitions ****************************/
 
@@ -179,8 +181,233 @@ void XUartPs_WaitTransmitDone(u32 BaseAddress)
 
 #ifdef SDT
 #ifdef XPAR_STDIN_IS_UARTPS
+/*
+ * Log ring of the buffered standard output. Head is advanced by outbyte()
+ * and Tail by the drain, both with the interrupts masked, so that output
+ * from any context can be mixed.
+ */
+static struct {
+	u8 *BufferPtr;		/* NULL when the output is not buffered */
+	u32 Mask;		/* Size of the ring minus one */
+	volatile u32 Head;	/* Next byte to be written */
+	volatile u32 Tail;	/* Next byte to be sent */
+	u32 Dropped;		/* Bytes lost on a full ring */
+} XUartPs_StdoutLog;
+
+/*****************************************************************************/
+/*
+*
+* Moves bytes from the log ring into the TX FIFO until either the ring is
+* empty or the FIFO is full. The caller masks the interrupts.
+*
+* @return	The number of bytes left in the log ring.
+*
+******************************************************************************/
+static u32 XUartPs_StdoutPush(void)
+{
+	u32 Tail = XUartPs_StdoutLog.Tail;
+
+	while ((Tail != XUartPs_StdoutLog.Head) &&
+	       (!XUartPs_IsTransmitFull(STDOUT_BASEADDRESS))) {
+		XUartPs_WriteReg(STDOUT_BASEADDRESS, XUARTPS_FIFO_OFFSET,
+				 XUartPs_StdoutLog.BufferPtr[Tail &
+						XUartPs_StdoutLog.Mask]);
+		Tail++;
+	}
+	XUartPs_StdoutLog.Tail = Tail;
+
+	return XUartPs_StdoutLog.Head - Tail;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function attaches a RAM log ring to the standard output. From then on
+* outbyte(), and so xil_printf() and print(), copies the output into the
+* ring and moves into the TX FIFO only what fits without waiting. The rest
+* is sent by XUartPs_StdoutDrain(), called from the idle loop or from an
+* interrupt handler, or by XUartPs_StdoutFlush(). When the ring is full the
+* new output is dropped and counted rather than waited for.
+*
+* A NULL buffer sends what is left in the current ring and returns the
+* standard output to the blocking XUartPs_SendByte().
+*
+* @param	BufferPtr is the storage of the ring, or NULL.
+* @param	Size is the size of the storage in bytes, a power of two.
+*
+* @return	None.
+*
+* @note		The storage must stay valid until the ring is detached.
+*
+******************************************************************************/
+void XUartPs_StdoutSetBuffer(u8 *BufferPtr, u32 Size)
+{
+	Xil_AssertVoid((BufferPtr == NULL) ||
+		       ((Size >= 2U) && ((Size & (Size - 1U)) == 0U)));
+
+	if (XUartPs_StdoutLog.BufferPtr != NULL) {
+		XUartPs_StdoutFlush();
+	}
+
+	XUartPs_StdoutLog.BufferPtr = NULL;
+	XUartPs_StdoutLog.Head = 0U;
+	XUartPs_StdoutLog.Tail = 0U;
+	XUartPs_StdoutLog.Dropped = 0U;
+	if (BufferPtr != NULL) {
+		XUartPs_StdoutLog.Mask = Size - 1U;
+		XUartPs_StdoutLog.BufferPtr = BufferPtr;
+	}
+}
+
+/*****************************************************************************/
+/**
+*
+* This function moves buffered standard output into the TX FIFO, as much as
+* fits, without waiting. It is meant for the idle loop and for interrupt
+* handlers, for instance on the TX FIFO empty interrupt of the standard
+* output UART.
+*
+* @return	The number of bytes still buffered.
+*
+* @note		None.
+*
+******************************************************************************/
+u32 XUartPs_StdoutDrain(void)
+{
+	u32 Cpsr;
+	u32 Left;
+
+	if (XUartPs_StdoutLog.BufferPtr == NULL) {
+		return 0U;
+	}
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	Left = XUartPs_StdoutPush();
+	mtcpsr(Cpsr);
+
+	return Left;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function sends all of the buffered standard output and waits until
+* the transmitter is idle. It polls the device only, so it can be used with
+* the interrupts masked, from an exception handler or before a reset or a
+* handoff.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void XUartPs_StdoutFlush(void)
+{
+	if (XUartPs_StdoutLog.BufferPtr != NULL) {
+		while (XUartPs_StdoutDrain() != 0U) {
+			;
+		}
+	}
+	XUartPs_WaitTransmitDone(STDOUT_BASEADDRESS);
+}
+
+/*****************************************************************************/
+/**
+*
+* This function returns the number of bytes of standard output dropped
+* because the log ring was full.
+*
+* @return	The number of dropped bytes since the ring was attached.
+*
+* @note		None.
+*
+******************************************************************************/
+u32 XUartPs_StdoutDropped(void)
+{
+	return XUartPs_StdoutLog.Dropped;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function adds a block of bytes to the standard output as a whole, so
+* that it is never split by output from another context or cut short by a
+* full log ring. It is meant for binary records mixed into the text output.
+*
+* @param	DataPtr points to the bytes.
+* @param	NumBytes is the number of bytes.
+*
+* @return	NumBytes once the block is buffered or sent, 0 if the log ring
+*		has no room for the whole block. Nothing is dropped in that
+*		case and the caller may retry after XUartPs_StdoutDrain().
+*
+* @note		Without a log ring the block is sent with
+*		XUartPs_SendByte().
+*
+******************************************************************************/
+u32 XUartPs_StdoutWrite(const u8 *DataPtr, u32 NumBytes)
+{
+	u32 Cpsr;
+	u32 Head;
+	u32 Index;
+
+	Xil_AssertNonvoid((DataPtr != NULL) || (NumBytes == 0U));
+
+	if (XUartPs_StdoutLog.BufferPtr == NULL) {
+		for (Index = 0U; Index < NumBytes; Index++) {
+			XUartPs_SendByte(STDOUT_BASEADDRESS, DataPtr[Index]);
+		}
+		return NumBytes;
+	}
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	Head = XUartPs_StdoutLog.Head;
+	if ((XUartPs_StdoutLog.Mask + 1U -
+	     (Head - XUartPs_StdoutLog.Tail)) < NumBytes) {
+		(void)XUartPs_StdoutPush();
+	}
+	if ((XUartPs_StdoutLog.Mask + 1U -
+	     (Head - XUartPs_StdoutLog.Tail)) < NumBytes) {
+		NumBytes = 0U;
+	}
+	for (Index = 0U; Index < NumBytes; Index++) {
+		XUartPs_StdoutLog.BufferPtr[(Head + Index) &
+					    XUartPs_StdoutLog.Mask] =
+			DataPtr[Index];
+	}
+	XUartPs_StdoutLog.Head = Head + NumBytes;
+	(void)XUartPs_StdoutPush();
+	mtcpsr(Cpsr);
+
+	return NumBytes;
+}
+
 void outbyte(char c) {
-         XUartPs_SendByte(STDOUT_BASEADDRESS, c);
+	u32 Cpsr;
+	u32 Head;
+
+	if (XUartPs_StdoutLog.BufferPtr == NULL) {
+		XUartPs_SendByte(STDOUT_BASEADDRESS, c);
+		return;
+	}
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	Head = XUartPs_StdoutLog.Head;
+	if ((Head - XUartPs_StdoutLog.Tail) > XUartPs_StdoutLog.Mask) {
+		(void)XUartPs_StdoutPush();
+	}
+	if ((Head - XUartPs_StdoutLog.Tail) <= XUartPs_StdoutLog.Mask) {
+		XUartPs_StdoutLog.BufferPtr[Head & XUartPs_StdoutLog.Mask] =
+			(u8)c;
+		XUartPs_StdoutLog.Head = Head + 1U;
+	} else {
+		XUartPs_StdoutLog.Dropped++;
+	}
+	(void)XUartPs_StdoutPush();
+	mtcpsr(Cpsr);
 }
 
 char inbyte(void) {
@@ -34,6 +34,8 @@
 *			modem control register.
 * 4.0   sd     02/02/24 Added macros for transmission FIFO empty check
 *                       and transmission active state check
+* 3.14  qm     10/14/26 Added the buffered standard output functions.
+*			Added XUartPs_StdoutWrite().
 *
 * </pre>
 *
@@ -451,6 +453,15 @@ void XUartPs_ResetHw(u32 BaseAddress);
 
 void XUartPs_WaitTransmitDone(u32 BaseAddress);
 
+#if defined (SDT) && defined (XPAR_STDIN_IS_UARTPS)
+/* buffered standard output functions in xuartps_hw.c */
+void XUartPs_StdoutSetBuffer(u8 *BufferPtr, u32 Size);
+u32 XUartPs_StdoutWrite(const u8 *DataPtr, u32 NumBytes);
+u32 XUartPs_StdoutDrain(void);
+void XUartPs_StdoutFlush(void);
+u32 XUartPs_StdoutDropped(void);
+#endif
+
 /************************** Variable Definitions *****************************/
 
 #ifdef __cplusplus
@@ -71,6 +71,14 @@
 * 5.2   ap   12/05/23 Add SDT check to fix bug in disk_initialize.
 *       ap   01/11/24 Fix Doxygen warnings.
 *       sk   07/11/24 Add UFS interface support.
+* 5.3   qm   10/14/26 Split SD reads at the size of the ADMA2 descriptor
+*                     table, for the multi-cluster reads of f_read.
+*       qm   10/14/26 Add the LRU sector cache of FILE_SYSTEM_USE_CACHE.
+*       qm   10/14/26 Lock the drives and the sector cache in the
+*                     re-entrant build.
+*       qm   10/14/26 Add the asynchronous reads of FF_USE_ASYNC.
+*       qm   10/14/26 Add disk_sd_mode() to report the negotiated bus mode.
+*       qm   10/14/26 Drop the cached sectors of a failed write.
 *
 * </pre>
 *
@@ -97,15 +105,37 @@
 #include "sleep.h"
 #include "xil_printf.h"
 #include "xil_util.h"
+#if FF_FS_REENTRANT
+#include "xilffs.h"
+#endif
+#if FF_USE_ASYNC
+#include "xil_cache.h"
+#endif
 
 #ifdef XPAR_XSDPS_NUM_INSTANCES
 #define SD_CD_DELAY		10000U		/**< SD card detection delay */
+#define SD_MAX_READ_BLKS	4096U		/**< Blocks per read, 32 ADMA2
+						  *  descriptors of 64 KB */
 #endif
 
 #define XSDPS_NUM_INSTANCES	2		/**< Number of SD instances */
 
 #define XUFSPSXC_START_INDEX	3	/**< Start index of UFS instances */
 
+/** Index of the state of a drive, the UFS LUNs share the last one */
+#define DISK_INDEX(pdrv)	(((pdrv) < XSDPS_NUM_INSTANCES) ? \
+				 (pdrv) : XSDPS_NUM_INSTANCES)
+
+#ifdef FILE_SYSTEM_USE_CACHE
+#ifndef FILE_SYSTEM_CACHE_SECTORS
+#define FILE_SYSTEM_CACHE_SECTORS	32U	/**< Sectors in the cache */
+#endif
+#ifndef FILE_SYSTEM_CACHE_READ_AHEAD
+#define FILE_SYSTEM_CACHE_READ_AHEAD	4U	/**< Sectors read past a miss */
+#endif
+#define CACHE_SECT_SIZE		512U	/**< Sector size of the cached drives */
+#endif
+
 #ifdef FILE_SYSTEM_INTERFACE_RAM
 #include "xparameters.h"
 
@@ -116,6 +146,17 @@ static char *dataramfs = NULL;
 #define SECTORCNT       (RAMFS_SIZE / SECTORSIZE)
 #endif
 
+#ifdef FILE_SYSTEM_USE_CACHE
+/*
+ * Tag of a cache line
+ */
+typedef struct {
+	LBA_t Sector;	/**< Sector held */
+	DWORD Stamp;	/**< Last use, 0 for a free line */
+	BYTE Pdrv;	/**< Drive of the sector */
+} CacheLine;
+#endif
+
 /*--------------------------------------------------------------------------
 
 	Public Functions
@@ -135,6 +176,66 @@ static DSTATUS Stat[XSDPS_NUM_INSTANCES + 33U] =
 static DSTATUS Stat[XSDPS_NUM_INSTANCES] = {STA_NOINIT, STA_NOINIT};	/* Disk status */
 #endif
 
+#ifdef FILE_SYSTEM_USE_CACHE
+/*
+ * Sector cache of the SD drives, written through. A miss reads
+ * FILE_SYSTEM_CACHE_READ_AHEAD more sectors with the same command.
+ */
+static CacheLine CacheTags[FILE_SYSTEM_CACHE_SECTORS];
+static BYTE CacheData[FILE_SYSTEM_CACHE_SECTORS][CACHE_SECT_SIZE]
+	__attribute__ ((aligned(32)));
+static BYTE CacheStage[(FILE_SYSTEM_CACHE_READ_AHEAD + 1U) * CACHE_SECT_SIZE]
+	__attribute__ ((aligned(32)));
+static DWORD CacheClock;
+static DWORD CacheHits;
+static DWORD CacheMisses;
+
+static DRESULT disk_cache_read(BYTE pdrv, BYTE *buff, LBA_t sector);
+static void disk_cache_update(BYTE pdrv, const BYTE *buff, LBA_t sector,
+			      UINT count);
+static void disk_cache_drop(BYTE pdrv, LBA_t sector, UINT count);
+#endif
+
+#if FF_FS_REENTRANT
+/*
+ * FatFs locks a volume, these lock what volumes share: a drive, which the
+ * partitions of FILE_SYSTEM_MULTI_PARTITION share, and the sector cache,
+ * which the drives share. The last drive lock is the one of the UFS
+ * controller, shared by its LUNs. A drive lock is taken before the cache
+ * lock.
+ */
+static Xilffs_SpinLock DriveLock[XSDPS_NUM_INSTANCES + 1U];
+#ifdef FILE_SYSTEM_USE_CACHE
+static Xilffs_SpinLock CacheLock;
+#endif
+#endif
+
+#if FF_USE_ASYNC
+/*
+ * Asynchronous read of a drive. SD reads are split in commands of up to
+ * SD_MAX_READ_BLKS blocks, the other drives are read at the start.
+ */
+typedef struct {
+	BYTE *Buff;	/**< Data buffer of the read */
+	BYTE *Next;	/**< Data buffer of the next command */
+	LBA_t Sector;	/**< Sector of the next command */
+	UINT Count;	/**< Sectors of the read */
+	UINT Left;	/**< Sectors left after the command in flight */
+	DRESULT Res;	/**< Result of a read done at its start */
+	BYTE Busy;	/**< The read holds the drive */
+} AsyncRead;
+
+static AsyncRead AsyncReads[XSDPS_NUM_INSTANCES + 1U];
+#endif
+
+static int disk_lock(BYTE pdrv);
+static void disk_unlock(BYTE pdrv);
+static DRESULT disk_read_dev(BYTE pdrv, BYTE *buff, LBA_t sector, UINT count);
+#if FF_FS_READONLY == 0
+static DRESULT disk_write_dev(BYTE pdrv, const BYTE *buff, LBA_t sector,
+			      UINT count);
+#endif
+
 #ifdef FILE_SYSTEM_INTERFACE_SD
 #ifdef XPAR_XSDPS_NUM_INSTANCES
 static XSdPs SdInstance[XSDPS_NUM_INSTANCES];
@@ -319,6 +420,11 @@ DSTATUS disk_initialize (
 		return s;
 	}
 
+#ifdef FILE_SYSTEM_USE_CACHE
+	/* The card may have been changed */
+	disk_cache_invalidate(pdrv);
+#endif
+
 #ifdef FILE_SYSTEM_INTERFACE_SD
 	if (pdrv < XSDPS_NUM_INSTANCES) {
 #ifdef XPAR_XSDPS_NUM_INSTANCES
@@ -449,10 +555,7 @@ DRESULT disk_read (
 )
 {
 	DSTATUS s;
-#ifdef FILE_SYSTEM_INTERFACE_SD
-	s32 Status = XST_FAILURE;
-	DWORD LocSector = sector;
-#endif
+	DRESULT Res;
 
 	s = disk_status(pdrv);
 
@@ -463,17 +566,127 @@ DRESULT disk_read (
 		return RES_PARERR;
 	}
 
+	if (disk_lock(pdrv) == 0) {
+		return RES_ERROR;
+	}
+
+#ifdef FILE_SYSTEM_USE_CACHE
+	/* Sector reads of FatFs go through the cache, data runs around it */
+	if ((pdrv < XSDPS_NUM_INSTANCES) && (count == 1U)) {
+		Res = disk_cache_read(pdrv, buff, sector);
+	} else {
+		Res = disk_read_dev(pdrv, buff, sector, count);
+	}
+#else
+	Res = disk_read_dev(pdrv, buff, sector, count);
+#endif
+
+	disk_unlock(pdrv);
+
+	return Res;
+}
+
+/*****************************************************************************/
+/**
+*
+* Takes the lock of a drive in the re-entrant build. Without it, the drive
+* is refused while an asynchronous read holds it.
+*
+* @param	pdrv - Drive number
+*
+* @return	1 if taken, 0 on timeout or if the drive is busy
+*
+******************************************************************************/
+static int disk_lock(BYTE pdrv)
+{
+#if FF_FS_REENTRANT
+	return Xilffs_SpinTake(&DriveLock[DISK_INDEX(pdrv)], FF_FS_TIMEOUT);
+#elif FF_USE_ASYNC
+	return (AsyncReads[DISK_INDEX(pdrv)].Busy == 0U) ? 1 : 0;
+#else
+	(void)pdrv;
+
+	return 1;
+#endif
+}
+
+/*****************************************************************************/
+/**
+*
+* Releases the lock of a drive taken with disk_lock.
+*
+* @param	pdrv - Drive number
+*
+* @return	None
+*
+******************************************************************************/
+static void disk_unlock(BYTE pdrv)
+{
+#if FF_FS_REENTRANT
+	Xilffs_SpinGive(&DriveLock[DISK_INDEX(pdrv)]);
+#else
+	(void)pdrv;
+#endif
+}
+
+/*****************************************************************************/
+/**
+*
+* Reads sectors from the drive, past the sector cache.
+*
+* @param	pdrv - Drive number
+* @param	buff - Pointer to the data buffer to store read data
+* @param	sector - Start sector number
+* @param	count - Sector count
+*
+* @return
+*		RES_OK		Read successful
+*		RES_ERROR	Read not successful
+*
+* @note
+*
+******************************************************************************/
+static DRESULT disk_read_dev (
+	BYTE pdrv,		/* Physical drive nmuber to identify the drive */
+	BYTE *buff,		/* Data buffer to store read data */
+	LBA_t sector,	/* Start sector in LBA */
+	UINT count		/* Number of sectors to read */
+)
+{
+#ifdef FILE_SYSTEM_INTERFACE_SD
+	s32 Status = XST_FAILURE;
+	DWORD LocSector = sector;
+#ifdef XPAR_XSDPS_NUM_INSTANCES
+	UINT BlkCnt;
+#endif
+#endif
+
 #ifdef FILE_SYSTEM_INTERFACE_SD
 	if (pdrv < XSDPS_NUM_INSTANCES) {
 #ifdef XPAR_XSDPS_NUM_INSTANCES
-		/* Convert LBA to byte address if needed */
-		if ((SdInstance[pdrv].HCS) == 0U) {
-			LocSector *= (DWORD)XSDPS_BLK_SIZE_512_MASK;
-		}
+		/*
+		 * Runs of contiguous clusters are read in one go, up to the
+		 * blocks one ADMA2 descriptor table covers per command
+		 */
+		while (count > 0U) {
+			BlkCnt = (count > SD_MAX_READ_BLKS) ? SD_MAX_READ_BLKS : count;
+
+			/* Convert LBA to byte address if needed */
+			if ((SdInstance[pdrv].HCS) == 0U) {
+				Status  = XSdPs_ReadPolled(&SdInstance[pdrv],
+						(u32)LocSector * (u32)XSDPS_BLK_SIZE_512_MASK,
+						BlkCnt, buff);
+			} else {
+				Status  = XSdPs_ReadPolled(&SdInstance[pdrv], (u32)LocSector,
+						BlkCnt, buff);
+			}
+			if (Status != XST_SUCCESS) {
+				return RES_ERROR;
+			}
 
-		Status  = XSdPs_ReadPolled(&SdInstance[pdrv], (u32)LocSector, count, buff);
-		if (Status != XST_SUCCESS) {
-			return RES_ERROR;
+			LocSector += BlkCnt;
+			buff += BlkCnt * XSDPS_BLK_SIZE_512_MASK;
+			count -= BlkCnt;
 		}
 #endif
 	} else {
@@ -499,8 +712,10 @@ DRESULT disk_read (
 #endif
 
 #if !defined(FILE_SYSTEM_INTERFACE_SD) && !defined(FILE_SYSTEM_INTERFACE_RAM)
+	(void)pdrv;
 	(void)buff;
 	(void)sector;
+	(void)count;
 #endif
 
 	return RES_OK;
@@ -734,10 +949,7 @@ DRESULT disk_write (
 )
 {
 	DSTATUS s;
-#ifdef FILE_SYSTEM_INTERFACE_SD
-	s32 Status = XST_FAILURE;
-	DWORD LocSector = sector;
-#endif
+	DRESULT Res;
 
 	s = disk_status(pdrv);
 	if ((s & STA_NOINIT) != 0U) {
@@ -747,6 +959,57 @@ DRESULT disk_write (
 		return RES_PARERR;
 	}
 
+	if (disk_lock(pdrv) == 0) {
+		return RES_ERROR;
+	}
+
+	Res = disk_write_dev(pdrv, buff, sector, count);
+
+#ifdef FILE_SYSTEM_USE_CACHE
+	if (pdrv < XSDPS_NUM_INSTANCES) {
+		if (Res == RES_OK) {
+			disk_cache_update(pdrv, buff, sector, count);
+		} else {
+			/* Part of a failed write may have reached the card */
+			disk_cache_drop(pdrv, sector, count);
+		}
+	}
+#endif
+
+	disk_unlock(pdrv);
+
+	return Res;
+}
+
+/*****************************************************************************/
+/**
+*
+* Writes sectors to the drive.
+*
+* @param	pdrv - Drive number
+* @param	buff - Pointer to the data to be written
+* @param	sector - Sector address
+* @param	count - Sector count
+*
+* @return
+*		RES_OK		Write successful
+*		RES_ERROR	Write not successful
+*
+* @note
+*
+******************************************************************************/
+static DRESULT disk_write_dev (
+	BYTE pdrv,			/* Physical drive nmuber (0..) */
+	const BYTE *buff,	/* Data to be written */
+	LBA_t sector,		/* Sector address (LBA) */
+	UINT count			/* Number of sectors to write (1..128) */
+)
+{
+#ifdef FILE_SYSTEM_INTERFACE_SD
+	s32 Status = XST_FAILURE;
+	DWORD LocSector = sector;
+#endif
+
 #ifdef FILE_SYSTEM_INTERFACE_SD
 	if (pdrv < XSDPS_NUM_INSTANCES) {
 #ifdef XPAR_XSDPS_NUM_INSTANCES
@@ -785,10 +1048,515 @@ DRESULT disk_write (
 #endif
 
 #if !defined(FILE_SYSTEM_INTERFACE_SD) && !defined(FILE_SYSTEM_INTERFACE_RAM)
+	(void)pdrv;
 	(void)buff;
 	(void)sector;
+	(void)count;
+#endif
+
+	return RES_OK;
+}
+#endif
+
+#if FF_USE_ASYNC
+#if defined(FILE_SYSTEM_INTERFACE_SD) && defined(XPAR_XSDPS_NUM_INSTANCES)
+/*****************************************************************************/
+/**
+*
+* Starts the next command of an asynchronous SD read.
+*
+* @param	pdrv - Drive number
+*
+* @return
+*		RES_OK		Command started
+*		RES_ERROR	Command not started
+*
+******************************************************************************/
+static DRESULT disk_read_next(BYTE pdrv)
+{
+	AsyncRead *ReadPtr = &AsyncReads[pdrv];
+	UINT BlkCnt;
+	u32 Arg = (u32)ReadPtr->Sector;
+	s32 Status;
+
+	BlkCnt = (ReadPtr->Left > SD_MAX_READ_BLKS) ?
+		 SD_MAX_READ_BLKS : ReadPtr->Left;
+
+	/* Convert LBA to byte address if needed */
+	if ((SdInstance[pdrv].HCS) == 0U) {
+		Arg *= (u32)XSDPS_BLK_SIZE_512_MASK;
+	}
+
+	Status = XSdPs_StartReadTransfer(&SdInstance[pdrv], Arg, BlkCnt,
+					 ReadPtr->Next);
+	if (Status != XST_SUCCESS) {
+		return RES_ERROR;
+	}
+
+	ReadPtr->Sector += BlkCnt;
+	ReadPtr->Next += BlkCnt * XSDPS_BLK_SIZE_512_MASK;
+	ReadPtr->Left -= BlkCnt;
+
+	return RES_OK;
+}
+#endif
+
+/*****************************************************************************/
+/**
+*
+* Starts an asynchronous read of the drive, past the sector cache, which
+* holds the drive until disk_read_check reports it done. SD reads run on
+* the ADMA2 of the host, the other drives are read before returning.
+*
+* @param	pdrv - Drive number
+* @param	buff - Pointer to the data buffer to store read data
+* @param	sector - Start sector number
+* @param	count - Sector count
+*
+* @return
+*		RES_OK		Read started
+*		RES_NOTRDY	Drive not initialized
+*		RES_ERROR	Read not started, or drive busy
+*
+* @note		The data buffer must not be used until the read is done.
+*
+******************************************************************************/
+DRESULT disk_read_start (
+	BYTE pdrv,		/* Physical drive nmuber to identify the drive */
+	BYTE *buff,		/* Data buffer to store read data */
+	LBA_t sector,	/* Start sector in LBA */
+	UINT count		/* Number of sectors to read */
+)
+{
+	AsyncRead *ReadPtr = &AsyncReads[DISK_INDEX(pdrv)];
+	DSTATUS s;
+
+	s = disk_status(pdrv);
+
+	if ((s & STA_NOINIT) != 0U) {
+		return RES_NOTRDY;
+	}
+	if (count == 0U) {
+		return RES_PARERR;
+	}
+
+	if (disk_lock(pdrv) == 0) {
+		return RES_ERROR;
+	}
+
+	ReadPtr->Buff = buff;
+	ReadPtr->Next = buff;
+	ReadPtr->Sector = sector;
+	ReadPtr->Count = count;
+	ReadPtr->Left = count;
+	ReadPtr->Res = RES_OK;
+	ReadPtr->Busy = 1U;
+
+#if defined(FILE_SYSTEM_INTERFACE_SD) && defined(XPAR_XSDPS_NUM_INSTANCES)
+	if (pdrv < XSDPS_NUM_INSTANCES) {
+		if (disk_read_next(pdrv) != RES_OK) {
+			ReadPtr->Busy = 0U;
+			disk_unlock(pdrv);
+			return RES_ERROR;
+		}
+		return RES_OK;
+	}
 #endif
 
+	/* Read now, disk_read_check reports the result */
+	ReadPtr->Res = disk_read_dev(pdrv, buff, sector, count);
+	ReadPtr->Left = 0U;
+
+	return RES_OK;
+}
+
+/*****************************************************************************/
+/**
+*
+* Checks an asynchronous read of the drive, and starts its next command
+* when one is done.
+*
+* @param	pdrv - Drive number
+*
+* @return
+*		RES_OK		Read done
+*		RES_BUSY	Read in flight
+*		RES_ERROR	Read not successful
+*		RES_PARERR	No read started
+*
+******************************************************************************/
+DRESULT disk_read_check (
+	BYTE pdrv		/* Physical drive nmuber to identify the drive */
+)
+{
+	AsyncRead *ReadPtr = &AsyncReads[DISK_INDEX(pdrv)];
+	DRESULT Res;
+#if defined(FILE_SYSTEM_INTERFACE_SD) && defined(XPAR_XSDPS_NUM_INSTANCES)
+	s32 Status;
+#endif
+
+	if (ReadPtr->Busy == 0U) {
+		return RES_PARERR;
+	}
+	Res = ReadPtr->Res;
+
+#if defined(FILE_SYSTEM_INTERFACE_SD) && defined(XPAR_XSDPS_NUM_INSTANCES)
+	if (pdrv < XSDPS_NUM_INSTANCES) {
+		Status = XSdPs_CheckReadTransfer(&SdInstance[pdrv]);
+		if (Status == XST_DEVICE_BUSY) {
+			return RES_BUSY;
+		}
+		if (Status != XST_SUCCESS) {
+			Res = RES_ERROR;
+		} else if (ReadPtr->Left > 0U) {
+			Res = disk_read_next(pdrv);
+			if (Res == RES_OK) {
+				return RES_BUSY;
+			}
+		} else {
+			/* Drop the lines the CPU may have fetched during the read */
+			Xil_DCacheInvalidateRange((INTPTR)ReadPtr->Buff,
+				ReadPtr->Count * XSDPS_BLK_SIZE_512_MASK);
+		}
+	}
+#endif
+
+	ReadPtr->Busy = 0U;
+	disk_unlock(pdrv);
+
+	return Res;
+}
+#endif
+
+#if defined(FILE_SYSTEM_INTERFACE_SD) && defined(XPAR_XSDPS_NUM_INSTANCES)
+/*****************************************************************************/
+/**
+*
+* Gets the bus mode XSdPs_CardInitialize() negotiated with the card of a
+* drive, the width from SCR and the high speed mode from CMD6, as the host
+* controller is set.
+*
+* @param	pdrv - Drive number
+* @param	width - Pointer to the bus width, 1, 4 or 8 bits
+* @param	clock - Pointer to the SD clock in Hz
+* @param	high_speed - Pointer to 1 in high speed mode, otherwise 0
+*
+* @return
+*		RES_OK		Mode returned
+*		RES_NOTRDY	Drive not initialized
+*		RES_PARERR	Not an SD drive
+*
+* @note		The Zynq-7000 controller has no tap delays to tune, the mode
+*		is all that is negotiated.
+*
+******************************************************************************/
+DRESULT disk_sd_mode(BYTE pdrv, DWORD *width, DWORD *clock, BYTE *high_speed)
+{
+	u8 HostCtrl;
+	u16 ClockCtrl;
+	u32 Divisor;
+
+	if (pdrv >= XSDPS_NUM_INSTANCES) {
+		return RES_PARERR;
+	}
+	if ((disk_status(pdrv) & STA_NOINIT) != 0U) {
+		return RES_NOTRDY;
+	}
+
+	HostCtrl = XSdPs_ReadReg8(BaseAddress[pdrv], XSDPS_HOST_CTRL1_OFFSET);
+	if ((HostCtrl & XSDPS_HC_EXT_BUS_WIDTH) != 0U) {
+		*width = 8U;
+	} else if ((HostCtrl & XSDPS_HC_WIDTH_MASK) != 0U) {
+		*width = 4U;
+	} else {
+		*width = 1U;
+	}
+	*high_speed = ((HostCtrl & XSDPS_HC_SPEED_MASK) != 0U) ? 1U : 0U;
+
+	/*
+	 * The SD clock is the base clock divided by twice the divisor field,
+	 * the upper two bits of which are only there from host version 3
+	 */
+	ClockCtrl = XSdPs_ReadReg16(BaseAddress[pdrv], XSDPS_CLK_CTRL_OFFSET);
+	Divisor = ((u32)ClockCtrl & XSDPS_CC_SDCLK_FREQ_SEL_MASK) >>
+			XSDPS_CC_DIV_SHIFT;
+	Divisor |= (((u32)ClockCtrl & XSDPS_CC_SDCLK_FREQ_SEL_EXT_MASK) >>
+			XSDPS_CC_EXT_DIV_SHIFT) << 8U;
+	if (Divisor == 0U) {
+		*clock = (DWORD)SdInstance[pdrv].Config.InputClockHz;
+	} else {
+		*clock = (DWORD)(SdInstance[pdrv].Config.InputClockHz /
+				(2U * Divisor));
+	}
+
 	return RES_OK;
 }
 #endif
+
+#ifdef FILE_SYSTEM_USE_CACHE
+/*****************************************************************************/
+/**
+*
+* Takes the lock of the cache in the re-entrant build. It is held for one
+* device read at most, so it is waited for without a timeout, which keeps a
+* write from leaving a stale line behind.
+*
+* @return	None
+*
+******************************************************************************/
+static void disk_cache_lock(void)
+{
+#if FF_FS_REENTRANT
+	while (Xilffs_SpinTake(&CacheLock, FF_FS_TIMEOUT) == 0) {
+		;
+	}
+#endif
+}
+
+/*****************************************************************************/
+/**
+*
+* Releases the lock of the cache.
+*
+* @return	None
+*
+******************************************************************************/
+static void disk_cache_unlock(void)
+{
+#if FF_FS_REENTRANT
+	Xilffs_SpinGive(&CacheLock);
+#endif
+}
+
+/*****************************************************************************/
+/**
+*
+* Finds a sector in the cache.
+*
+* @param	pdrv - Drive number
+* @param	sector - Sector number
+*
+* @return	Index of the line, FILE_SYSTEM_CACHE_SECTORS if not cached
+*
+******************************************************************************/
+static UINT disk_cache_find(BYTE pdrv, LBA_t sector)
+{
+	UINT Index;
+
+	for (Index = 0U; Index < FILE_SYSTEM_CACHE_SECTORS; Index++) {
+		if ((CacheTags[Index].Stamp != 0U) &&
+		    (CacheTags[Index].Sector == sector) &&
+		    (CacheTags[Index].Pdrv == pdrv)) {
+			break;
+		}
+	}
+
+	return Index;
+}
+
+/*****************************************************************************/
+/**
+*
+* Stores a sector in the cache, in its line if cached or in the least
+* recently used line otherwise.
+*
+* @param	pdrv - Drive number
+* @param	buff - Data of the sector
+* @param	sector - Sector number
+*
+* @return	None
+*
+******************************************************************************/
+static void disk_cache_fill(BYTE pdrv, const BYTE *buff, LBA_t sector)
+{
+	UINT Index;
+	UINT Victim = 0U;
+
+	Index = disk_cache_find(pdrv, sector);
+	if (Index == FILE_SYSTEM_CACHE_SECTORS) {
+		for (Index = 0U; Index < FILE_SYSTEM_CACHE_SECTORS; Index++) {
+			if (CacheTags[Index].Stamp < CacheTags[Victim].Stamp) {
+				Victim = Index;
+			}
+		}
+		Index = Victim;
+	}
+
+	(void)Xil_SMemCpy(CacheData[Index], CACHE_SECT_SIZE, buff,
+			  CACHE_SECT_SIZE, CACHE_SECT_SIZE);
+	CacheTags[Index].Sector = sector;
+	CacheTags[Index].Pdrv = pdrv;
+	CacheTags[Index].Stamp = ++CacheClock;
+}
+
+/*****************************************************************************/
+/**
+*
+* Reads a sector through the cache. A miss reads the sector and the
+* FILE_SYSTEM_CACHE_READ_AHEAD sectors after it with one command, or the
+* sector alone if that fails at the end of the card.
+*
+* @param	pdrv - Drive number
+* @param	buff - Pointer to the data buffer to store read data
+* @param	sector - Sector number
+*
+* @return
+*		RES_OK		Read successful
+*		RES_ERROR	Read not successful
+*
+******************************************************************************/
+static DRESULT disk_cache_read(BYTE pdrv, BYTE *buff, LBA_t sector)
+{
+	DRESULT Res;
+	UINT Index;
+	UINT Count = FILE_SYSTEM_CACHE_READ_AHEAD + 1U;
+
+	disk_cache_lock();
+
+	Index = disk_cache_find(pdrv, sector);
+	if (Index != FILE_SYSTEM_CACHE_SECTORS) {
+		CacheHits++;
+		CacheTags[Index].Stamp = ++CacheClock;
+		(void)Xil_SMemCpy(buff, CACHE_SECT_SIZE, CacheData[Index],
+			  CACHE_SECT_SIZE, CACHE_SECT_SIZE);
+		disk_cache_unlock();
+		return RES_OK;
+	}
+
+	/* The lock is kept over the read, for the staging buffer */
+	CacheMisses++;
+	Res = disk_read_dev(pdrv, CacheStage, sector, Count);
+	if ((Res != RES_OK) && (Count > 1U)) {
+		Count = 1U;
+		Res = disk_read_dev(pdrv, CacheStage, sector, Count);
+	}
+	if (Res != RES_OK) {
+		disk_cache_unlock();
+		return Res;
+	}
+
+	/* Sectors read ahead first, so that the one asked for is the newest */
+	for (Index = Count - 1U; Index > 0U; Index--) {
+		if (disk_cache_find(pdrv, sector + Index) ==
+		    FILE_SYSTEM_CACHE_SECTORS) {
+			disk_cache_fill(pdrv, &CacheStage[Index * CACHE_SECT_SIZE],
+					sector + Index);
+		}
+	}
+	disk_cache_fill(pdrv, CacheStage, sector);
+
+	(void)Xil_SMemCpy(buff, CACHE_SECT_SIZE, CacheStage,
+			  CACHE_SECT_SIZE, CACHE_SECT_SIZE);
+
+	disk_cache_unlock();
+
+	return RES_OK;
+}
+
+/*****************************************************************************/
+/**
+*
+* Updates the cached sectors of a write, which has reached the drive.
+*
+* @param	pdrv - Drive number
+* @param	buff - Data written
+* @param	sector - Start sector number
+* @param	count - Sector count
+*
+* @return	None
+*
+******************************************************************************/
+static void disk_cache_update(BYTE pdrv, const BYTE *buff, LBA_t sector,
+			      UINT count)
+{
+	UINT Sect;
+	UINT Index;
+
+	disk_cache_lock();
+
+	for (Sect = 0U; Sect < count; Sect++) {
+		Index = disk_cache_find(pdrv, sector + Sect);
+		if (Index != FILE_SYSTEM_CACHE_SECTORS) {
+			(void)Xil_SMemCpy(CacheData[Index], CACHE_SECT_SIZE,
+					  &buff[Sect * CACHE_SECT_SIZE],
+					  CACHE_SECT_SIZE, CACHE_SECT_SIZE);
+		}
+	}
+
+	disk_cache_unlock();
+}
+
+/*****************************************************************************/
+/**
+*
+* Drops the cached sectors of a write that failed, since the drive may
+* hold the old or the new data of each of them.
+*
+* @param	pdrv - Drive number
+* @param	sector - Start sector number
+* @param	count - Sector count
+*
+* @return	None
+*
+******************************************************************************/
+static void disk_cache_drop(BYTE pdrv, LBA_t sector, UINT count)
+{
+	UINT Sect;
+	UINT Index;
+
+	disk_cache_lock();
+
+	for (Sect = 0U; Sect < count; Sect++) {
+		Index = disk_cache_find(pdrv, sector + Sect);
+		if (Index != FILE_SYSTEM_CACHE_SECTORS) {
+			CacheTags[Index].Stamp = 0U;
+		}
+	}
+
+	disk_cache_unlock();
+}
+
+/*****************************************************************************/
+/**
+*
+* Drops the cached sectors of a drive.
+*
+* @param	pdrv - Drive number
+*
+* @return	None
+*
+******************************************************************************/
+void disk_cache_invalidate(BYTE pdrv)
+{
+	UINT Index;
+
+	disk_cache_lock();
+
+	for (Index = 0U; Index < FILE_SYSTEM_CACHE_SECTORS; Index++) {
+		if (CacheTags[Index].Pdrv == pdrv) {
+			CacheTags[Index].Stamp = 0U;
+		}
+	}
+
+	disk_cache_unlock();
+}
+
+/*****************************************************************************/
+/**
+*
+* Gets the hit and miss counts of the sector cache.
+*
+* @param	hits - Pointer to the number of sector reads found in the cache
+* @param	misses - Pointer to the number of sector reads from the drive
+*
+* @return	None
+*
+******************************************************************************/
+void disk_cache_stats(DWORD *hits, DWORD *misses)
+{
+	disk_cache_lock();
+	*hits = CacheHits;
+	*misses = CacheMisses;
+	disk_cache_unlock();
+}
+#endif
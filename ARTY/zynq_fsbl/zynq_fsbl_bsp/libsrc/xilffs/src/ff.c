@@ -492,6 +492,9 @@ typedef struct {	/* Open object identifier with status */
 #if FF_VOLUMES < 1 || FF_VOLUMES > 175
 #error Wrong FF_VOLUMES setting
 #endif
+#if FF_PATH_CACHE < 0 || FF_PATH_CACHE > 255
+#error Wrong FF_PATH_CACHE setting
+#endif
 static FATFS *FatFs[FF_VOLUMES];	/* Pointer to the filesystem objects (logical drives) */
 static WORD Fsid;					/* Filesystem mount ID */
 
@@ -1673,6 +1676,20 @@ static FRESULT put_fat (	/* FR_OK(0):succeeded, !=0:error */
 				fs->wflag = 1;
 				break;
 		}
+#if FF_FREE_BITMAP
+		if (res == FR_OK && clst < fs->bm_built) {	/* Keep the bitmap in step with the FAT */
+			DWORD bit = (DWORD)1 << (clst % 32);
+
+			if (val != 0 && !(fs->bm[clst / 32] & bit)) {
+				fs->bm[clst / 32] |= bit;
+				fs->bm_free--;
+			}
+			if (val == 0 && (fs->bm[clst / 32] & bit)) {
+				fs->bm[clst / 32] &= ~bit;
+				fs->bm_free++;
+			}
+		}
+#endif
 	}
 	return res;
 }
@@ -1682,6 +1699,59 @@ static FRESULT put_fat (	/* FR_OK(0):succeeded, !=0:error */
 
 
 
+#if FF_FREE_BITMAP && !FF_FS_READONLY
+/*-----------------------------------------------------------------------*/
+/* FAT access - Find a free cluster with the free cluster bitmap         */
+/*-----------------------------------------------------------------------*/
+
+static DWORD find_free (	/* 0:No free cluster, 1:Internal error, 0xFFFFFFFF:Disk error, >=2:Free cluster# */
+	FFOBJID *obj,		/* Corresponding object */
+	DWORD scl			/* Cluster to scan from, not included */
+)
+{
+	DWORD ncl, cs;
+	FATFS *fs = obj->fs;
+
+
+	ncl = scl;
+	for (;;) {
+		ncl++;							/* Next cluster */
+		if (ncl >= fs->n_fatent) {		/* Check wrap-around */
+			ncl = 2;
+			if (ncl > scl) {
+				return 0;        /* No free cluster found? */
+			}
+		}
+		if (ncl < fs->bm_built) {		/* In the bitmap? */
+			if (ncl % 32 == 0 && ncl + 32 <= fs->bm_built && fs->bm[ncl / 32] == 0xFFFFFFFF
+			    && (scl < ncl || scl >= ncl + 32)) {
+				ncl += 31;        /* Skip a word of clusters in use */
+				continue;
+			}
+			if (!(fs->bm[ncl / 32] & ((DWORD)1 << (ncl % 32)))) {
+				return ncl;        /* Found a free cluster? */
+			}
+		}
+		else {
+			cs = get_fat(obj, ncl);		/* Get the cluster status */
+			if (cs == 0) {
+				return ncl;        /* Found a free cluster? */
+			}
+			if (cs == 1 || cs == 0xFFFFFFFF) {
+				return cs;        /* Test for error */
+			}
+		}
+		if (ncl == scl) {
+			return 0;        /* No free cluster found? */
+		}
+	}
+}
+
+#endif /* FF_FREE_BITMAP && !FF_FS_READONLY */
+
+
+
+
 #if FF_FS_EXFAT && !FF_FS_READONLY
 /*-----------------------------------------------------------------------*/
 /* exFAT: Accessing FAT and Allocation Bitmap                            */
@@ -2057,6 +2127,12 @@ static DWORD create_chain (	/* 0:No free cluster, 1:Internal error, 0xFFFFFFFF:D
 			}
 		}
 		if (ncl == 0) {	/* The new cluster cannot be contiguous and find another fragment */
+#if FF_FREE_BITMAP
+			ncl = find_free(obj, scl);
+			if (ncl < 2 || ncl == 0xFFFFFFFF) {
+				return ncl;        /* No free cluster or error? */
+			}
+#else
 			ncl = scl;	/* Start cluster */
 			for (;;) {
 				ncl++;							/* Next cluster */
@@ -2077,6 +2153,7 @@ static DWORD create_chain (	/* 0:No free cluster, 1:Internal error, 0xFFFFFFFF:D
 					return 0;        /* No free cluster found? */
 				}
 			}
+#endif
 		}
 		res = put_fat(fs, ncl, 0xFFFFFFFF);		/* Mark the new cluster 'EOC' */
 		if (res == FR_OK && clst != 0) {
@@ -2137,6 +2214,128 @@ static DWORD clmt_clust (	/* <2:Error, >=2:Cluster number */
 #endif	/* FF_USE_FASTSEEK */
 
 
+/*-----------------------------------------------------------------------*/
+/* FAT handling - Get sectors of contiguous clusters                     */
+/*-----------------------------------------------------------------------*/
+
+static UINT contig_sect (	/* Number of sectors from csect to the end of the run, up to cc */
+	FIL *fp,		/* Pointer to the file object, fp->clust is moved to the last cluster read */
+	UINT csect,		/* Sector offset in the current cluster */
+	UINT cc			/* Number of sectors to read */
+)
+{
+	DWORD clst, nclst;
+	UINT n;
+	FATFS *fs = fp->obj.fs;
+
+
+	clst = fp->clust;
+	n = fs->csize - csect;	/* Sectors left in the current cluster */
+	while (n < cc) {
+#if FF_USE_FASTSEEK
+		if (fp->cltbl) {
+			nclst = clmt_clust(fp, fp->fptr + (FSIZE_t)n * SS(fs));	/* Get next cluster# from the CLMT */
+		}
+		else
+#endif
+		{
+			nclst = get_fat(&fp->obj, clst);	/* Get next cluster# from the FAT */
+		}
+		if (nclst != clst + 1) {
+			break;        /* End of the run, end of the chain or error, left to the next pass */
+		}
+		clst = nclst;
+		n += fs->csize;
+	}
+	fp->clust = clst;
+
+	return (n < cc) ? n : cc;
+}
+
+
+
+
+/*-----------------------------------------------------------------------*/
+/* File access - Get the sector of the file pointer                      */
+/*-----------------------------------------------------------------------*/
+
+static FRESULT file_sect (	/* FR_OK, FR_INT_ERR or FR_DISK_ERR */
+	FIL *fp,		/* Pointer to the file object, fptr on a sector boundary */
+	UINT csect,		/* Sector offset in the cluster */
+	LBA_t *sect		/* Pointer to the sector found */
+)
+{
+	DWORD clst;
+	FATFS *fs = fp->obj.fs;
+
+
+	if (csect == 0) {					/* On the cluster boundary? */
+		if (fp->fptr == 0) {			/* On the top of the file? */
+			clst = fp->obj.sclust;		/* Follow cluster chain from the origin */
+		}
+		else {						/* Middle or end of the file */
+#if FF_USE_FASTSEEK
+			if (fp->cltbl) {
+				clst = clmt_clust(fp, fp->fptr);	/* Get cluster# from the CLMT */
+			}
+			else
+#endif
+			{
+				clst = get_fat(&fp->obj, fp->clust);	/* Follow cluster chain on the FAT */
+			}
+		}
+		if (clst < 2) {
+			return FR_INT_ERR;
+		}
+		if (clst == 0xFFFFFFFF) {
+			return FR_DISK_ERR;
+		}
+		fp->clust = clst;				/* Update current cluster */
+	}
+	*sect = clst2sect(fs, fp->clust);	/* Get current sector */
+	if (*sect == 0) {
+		return FR_INT_ERR;
+	}
+	*sect += csect;
+
+	return FR_OK;
+}
+
+
+
+
+/*-----------------------------------------------------------------------*/
+/* File access - Replace a sector read directly with its dirty copy      */
+/*-----------------------------------------------------------------------*/
+
+static void read_patch (
+	FIL *fp,		/* Pointer to the file object */
+	BYTE *rbuff,	/* Data read */
+	LBA_t sect,		/* First sector read */
+	UINT cc			/* Number of sectors read */
+)
+{
+#if !FF_FS_READONLY && FF_FS_MINIMIZE <= 2		/* Replace one of the read sectors with cached data if it contains a dirty sector */
+#if FF_FS_TINY
+	FATFS *fs = fp->obj.fs;
+
+	if (fs->wflag && fs->winsect - sect < cc) {
+		mem_cpy(rbuff + ((fs->winsect - sect) * SS(fs)), fs->win, SS(fs));
+	}
+#else
+	if ((fp->flag & FA_DIRTY) && fp->sect - sect < cc) {
+		mem_cpy(rbuff + ((fp->sect - sect) * SS(fp->obj.fs)), fp->buf, SS(fp->obj.fs));
+	}
+#endif
+#else
+	(void)fp;
+	(void)rbuff;
+	(void)sect;
+	(void)cc;
+#endif
+}
+
+
 
 
 /*-----------------------------------------------------------------------*/
@@ -3116,6 +3315,29 @@ static FRESULT dir_find (	/* FR_OK(0):succeeded, !=0:error */
 
 
 
+#if FF_PATH_CACHE
+/*-----------------------------------------------------------------------*/
+/* Path cache - Flush the entries of a volume                            */
+/*-----------------------------------------------------------------------*/
+
+static void pcache_flush (
+	FATFS *fs				/* Filesystem object */
+)
+{
+	UINT i;
+
+
+	for (i = 0; i < FF_PATH_CACHE; i++) {
+		fs->pcache[i].len = 0;
+	}
+	fs->pc_next = 0;
+}
+
+#endif	/* FF_PATH_CACHE */
+
+
+
+
 #if !FF_FS_READONLY
 /*-----------------------------------------------------------------------*/
 /* Register an object to the directory                                   */
@@ -3224,6 +3446,10 @@ dir_register (	/* FR_OK:succeeded, FR_DENIED:no free entry or too many SFN colli
 
 #endif
 
+#if FF_PATH_CACHE
+	pcache_flush(fs);		/* The new entry may take a cached one's place */
+#endif
+
 	/* Set SFN entry */
 	if (res == FR_OK) {
 		res = move_window(fs, dp->sect);
@@ -3290,6 +3516,9 @@ static FRESULT dir_remove (	/* FR_OK:Succeeded, FR_DISK_ERR:A disk error */
 		fs->wflag = 1;
 	}
 #endif
+#if FF_PATH_CACHE
+	pcache_flush(fs);		/* The removed entry may be cached */
+#endif
 
 	return res;
 }
@@ -3877,6 +4106,118 @@ static FRESULT create_name (	/* FR_OK: successful, FR_INVALID_NAME: could not cr
 
 
 
+#if FF_PATH_CACHE
+/*-----------------------------------------------------------------------*/
+/* Path cache - Hash a path, find, load and add entries                  */
+/*-----------------------------------------------------------------------*/
+
+static DWORD pcache_hash (	/* FNV-1a hash of the path */
+	const TCHAR *path,		/* Path, after the heading separators */
+	DWORD *len				/* Pointer to the length of the path */
+)
+{
+	DWORD hash = 0x811C9DC5, n = 0;
+
+
+	while (!IsTerminator(path[n])) {
+		hash = (hash ^ (DWORD)path[n]) * 0x01000193;
+		n++;
+	}
+	*len = n;
+	return hash;
+}
+
+
+static FF_PCENT *pcache_find (	/* Entry of the path, 0:Not cached */
+	FATFS *fs,				/* Filesystem object */
+	DWORD hash,				/* Hash of the path */
+	DWORD len,				/* Length of the path */
+	DWORD org				/* Start cluster the path is followed from */
+)
+{
+	UINT i;
+
+
+	if (len == 0) {
+		return 0;
+	}
+	for (i = 0; i < FF_PATH_CACHE; i++) {
+		if (fs->pcache[i].len == len && fs->pcache[i].hash == hash && fs->pcache[i].org == org) {
+			return &fs->pcache[i];
+		}
+	}
+	return 0;
+}
+
+
+static FRESULT pcache_load (	/* FR_OK:Entry loaded, FR_NO_FILE:Entry is stale, !=0:Error */
+	DIR *dp,				/* Directory object, sclust at the origin */
+	const TCHAR *path,		/* Path of the entry */
+	const FF_PCENT *pc		/* Cache entry of the path */
+)
+{
+	FRESULT res;
+	FATFS *fs = dp->obj.fs;
+
+
+	do {						/* Get the name of the last segment as follow_path() does */
+		res = create_name(dp, &path);
+		if (res != FR_OK) {
+			return res;
+		}
+	}
+	while (!(dp->fn[NSFLAG] & NS_LAST));
+	dp->obj.sclust = pc->sclust;	/* Go to the entry in its directory */
+	res = dir_sdi(dp, pc->dptr);
+	if (res == FR_OK) {
+		res = move_window(fs, dp->sect);
+	}
+	if (res != FR_OK) {
+		return res;
+	}
+	if (memcmp(dp->dir, pc->sfn, 11)) {
+		return FR_NO_FILE;        /* The entry no longer holds the object */
+	}
+	dp->obj.attr = dp->dir[DIR_Attr] & AM_MASK;
+#if FF_USE_LFN
+	dp->blk_ofs = pc->blk_ofs;
+#endif
+	return FR_OK;
+}
+
+
+static void pcache_add (
+	FATFS *fs,				/* Filesystem object */
+	DWORD hash,				/* Hash of the path */
+	DWORD len,				/* Length of the path */
+	DWORD org,				/* Start cluster the path was followed from */
+	const DIR *dp			/* Directory object pointing the entry found */
+)
+{
+	FF_PCENT *pc;
+
+
+	pc = pcache_find(fs, hash, len, org);
+	if (!pc) {					/* Replace the entries in turn */
+		pc = &fs->pcache[fs->pc_next];
+		fs->pc_next = (BYTE)((fs->pc_next + 1) % FF_PATH_CACHE);
+	}
+	pc->hash = hash;
+	pc->len = len;
+	pc->org = org;
+	pc->sclust = dp->obj.sclust;
+	pc->dptr = dp->dptr;
+#if FF_USE_LFN
+	pc->blk_ofs = dp->blk_ofs;
+#endif
+	memcpy(pc->sfn, dp->dir, 11);
+}
+
+#endif	/* FF_PATH_CACHE */
+
+
+
+
 /*-----------------------------------------------------------------------*/
 /* Follow a file path                                                    */
 /*-----------------------------------------------------------------------*/
@@ -3889,6 +4230,11 @@ static FRESULT follow_path (	/* FR_OK(0): successful, !=0: error code */
 	FRESULT res = FR_DISK_ERR;
 	BYTE ns;
 	FATFS *fs = dp->obj.fs;
+#if FF_PATH_CACHE
+	DWORD hash = 0, len = 0, org;
+	FF_PCENT *pc;
+	BYTE dot = 0;
+#endif
 
 
 #if FF_FS_RPATH != 0
@@ -3928,6 +4274,20 @@ static FRESULT follow_path (	/* FR_OK(0): successful, !=0: error code */
 
 	}
 	else {								/* Follow path */
+#if FF_PATH_CACHE
+		org = dp->obj.sclust;
+		if (fs->fs_type != FS_EXFAT) {	/* Look the path up in the cache */
+			hash = pcache_hash(path, &len);
+			pc = pcache_find(fs, hash, len, org);
+			if (pc) {
+				res = pcache_load(dp, path, pc);
+				if (res == FR_OK) {
+					return res;
+				}
+				dp->obj.sclust = org;		/* Stale entry, follow the path */
+			}
+		}
+#endif
 		for (;;) {
 			res = create_name(dp, &path);	/* Get a segment name of the path */
 			if (res != FR_OK) {
@@ -3935,6 +4295,11 @@ static FRESULT follow_path (	/* FR_OK(0): successful, !=0: error code */
 			}
 			res = dir_find(dp);				/* Find an object with the segment name */
 			ns = dp->fn[NSFLAG];
+#if FF_PATH_CACHE
+			if (ns & NS_DOT) {
+				dot = 1;        /* Dot entries are not cached */
+			}
+#endif
 			if (res != FR_OK) {				/* Failed to find the object */
 				if (res == FR_NO_FILE) {	/* Object is not found */
 					if (FF_FS_RPATH && (ns & NS_DOT)) {	/* If dot entry is not exist, stay there */
@@ -3973,6 +4338,11 @@ static FRESULT follow_path (	/* FR_OK(0): successful, !=0: error code */
 				dp->obj.sclust = ld_clust(fs, fs->win + dp->dptr % SS(fs));	/* Open next directory */
 			}
 		}
+#if FF_PATH_CACHE
+		if (res == FR_OK && !dot && !(dp->fn[NSFLAG] & NS_NONAME) && fs->fs_type != FS_EXFAT) {
+			pcache_add(fs, hash, len, org, dp);	/* Keep the entry found */
+		}
+#endif
 	}
 
 	return res;
@@ -4582,6 +4952,12 @@ static FRESULT mount_volume (	/* FR_OK(0): successful, !=0: an error occurred */
 
 	fs->fs_type = (BYTE)fmt;/* FAT sub-type (the filesystem object gets valid) */
 	fs->id = ++Fsid;		/* Volume mount ID */
+#if FF_PATH_CACHE
+	pcache_flush(fs);		/* Entries of the previous mount are gone */
+#endif
+#if FF_FREE_BITMAP && !FF_FS_READONLY
+	fs->bm_built = 0;		/* The bitmap is built again */
+#endif
 #if FF_USE_LFN == 1
 	fs->lfnbuf = LfnBuf;	/* Static LFN working buffer */
 #if FF_FS_EXFAT
@@ -4698,6 +5074,10 @@ FRESULT f_mount (
 #endif
 #endif
 		fs->fs_type = 0;		/* Invalidate the new filesystem object */
+#if FF_FREE_BITMAP && !FF_FS_READONLY
+		fs->bm = 0;				/* No free cluster bitmap until f_setbitmap() */
+		fs->bm_built = 0;
+#endif
 		FatFs[vol] = fs;		/* Register new fs object */
 	}
 
@@ -4947,7 +5327,6 @@ FRESULT f_read (
 {
 	FRESULT res = FR_DISK_ERR;
 	FATFS *fs;
-	DWORD clst;
 	LBA_t sect;
 	FSIZE_t remain;
 	UINT rcnt, cc, csect;
@@ -4970,53 +5349,19 @@ FRESULT f_read (
 	for ( ; btr > 0; btr -= rcnt, *br += rcnt, rbuff += rcnt, fp->fptr += rcnt) {	/* Repeat until btr bytes read */
 		if (fp->fptr % SS(fs) == 0) {			/* On the sector boundary? */
 			csect = (UINT)(fp->fptr / SS(fs) & (fs->csize - 1));	/* Sector offset in the cluster */
-			if (csect == 0) {					/* On the cluster boundary? */
-				if (fp->fptr == 0) {			/* On the top of the file? */
-					clst = fp->obj.sclust;		/* Follow cluster chain from the origin */
-				}
-				else {						/* Middle or end of the file */
-#if FF_USE_FASTSEEK
-					if (fp->cltbl) {
-						clst = clmt_clust(fp, fp->fptr);	/* Get cluster# from the CLMT */
-					}
-					else
-#endif
-					{
-						clst = get_fat(&fp->obj, fp->clust);	/* Follow cluster chain on the FAT */
-					}
-				}
-				if (clst < 2) {
-					ABORT(fs, FR_INT_ERR);
-				}
-				if (clst == 0xFFFFFFFF) {
-					ABORT(fs, FR_DISK_ERR);
-				}
-				fp->clust = clst;				/* Update current cluster */
-			}
-			sect = clst2sect(fs, fp->clust);	/* Get current sector */
-			if (sect == 0) {
-				ABORT(fs, FR_INT_ERR);
+			res = file_sect(fp, csect, &sect);	/* Get current sector */
+			if (res != FR_OK) {
+				ABORT(fs, res);
 			}
-			sect += csect;
 			cc = btr / SS(fs);					/* When remaining bytes >= sector size, */
 			if (cc > 0) {						/* Read maximum contiguous sectors directly */
-				if (csect + cc > fs->csize) {	/* Clip at cluster boundary */
-					cc = fs->csize - csect;
+				if (csect + cc > fs->csize) {	/* Clip at the end of the contiguous clusters */
+					cc = contig_sect(fp, csect, cc);
 				}
 				if (disk_read(fs->pdrv, rbuff, sect, cc) != RES_OK) {
 					ABORT(fs, FR_DISK_ERR);
 				}
-#if !FF_FS_READONLY && FF_FS_MINIMIZE <= 2		/* Replace one of the read sectors with cached data if it contains a dirty sector */
-#if FF_FS_TINY
-				if (fs->wflag && fs->winsect - sect < cc) {
-					mem_cpy(rbuff + ((fs->winsect - sect) * SS(fs)), fs->win, SS(fs));
-				}
-#else
-				if ((fp->flag & FA_DIRTY) && fp->sect - sect < cc) {
-					mem_cpy(rbuff + ((fp->sect - sect) * SS(fs)), fp->buf, SS(fs));
-				}
-#endif
-#endif
+				read_patch(fp, rbuff, sect, cc);
 				rcnt = SS(fs) * cc;				/* Number of bytes transferred */
 				continue;
 			}
@@ -5065,6 +5410,186 @@ FRESULT f_read (
 
 
 
+#if FF_USE_ASYNC
+/*-----------------------------------------------------------------------*/
+/* Read File Asynchronously                                              */
+/*-----------------------------------------------------------------------*/
+/* The whole sectors of the read are moved by transfers the drive runs in
+/  the background, one per run of contiguous clusters, and f_read_poll()
+/  starts the next run when one ends. The partial sectors at the ends of
+/  the read go through f_read(). The file object and the data buffer must
+/  not be used until the read has ended.
+*/
+
+static FRESULT read_async_start (	/* Starts an asynchronous read */
+	FF_ASYNC *req,	/* Pointer to the read, fp, buff and btr set */
+	UINT btr		/* Number of bytes to read */
+)
+{
+	FRESULT res;
+	FATFS *fs;
+	FSIZE_t remain;
+	FIL *fp = req->fp;
+
+
+	res = validate(&fp->obj, &fs);				/* Check validity of the file object */
+	if (res != FR_OK || (res = (FRESULT)fp->err) != FR_OK) {
+		LEAVE_FF(fs, res);        /* Check validity */
+	}
+	if (!(fp->flag & FA_READ)) {
+		LEAVE_FF(fs, FR_DENIED);        /* Check access mode */
+	}
+	remain = fp->obj.objsize - fp->fptr;
+	if (btr > remain) {
+		btr = (UINT)remain;        /* Truncate btr by remaining bytes */
+	}
+	req->btr = btr;
+
+	LEAVE_FF(fs, FR_OK);
+}
+
+
+static FRESULT read_async_step (	/* Checks the transfer in flight, or starts the next one */
+	FF_ASYNC *req	/* Pointer to the read, on a sector boundary with whole sectors left */
+)
+{
+	FRESULT res;
+	FATFS *fs;
+	DRESULT dr;
+	LBA_t sect;
+	UINT csect, cc, rcnt;
+	FIL *fp = req->fp;
+
+
+	res = validate(&fp->obj, &fs);				/* Check validity of the file object */
+	if (res != FR_OK || (res = (FRESULT)fp->err) != FR_OK) {
+		LEAVE_FF(fs, res);        /* Check validity */
+	}
+	if (req->cc > 0) {						/* Transfer in flight? */
+		dr = disk_read_check(fs->pdrv);
+		if (dr == RES_BUSY) {
+			LEAVE_FF(fs, FR_OK);        /* Not done yet */
+		}
+		cc = req->cc;
+		req->cc = 0;
+		if (dr != RES_OK) {
+			ABORT(fs, FR_DISK_ERR);
+		}
+		read_patch(fp, req->buff, req->sect, cc);
+		rcnt = SS(fs) * cc;					/* Number of bytes transferred */
+		req->btr -= rcnt;
+		req->br += rcnt;
+		req->buff += rcnt;
+		fp->fptr += rcnt;
+		LEAVE_FF(fs, FR_OK);
+	}
+
+	csect = (UINT)(fp->fptr / SS(fs) & (fs->csize - 1));	/* Sector offset in the cluster */
+	res = file_sect(fp, csect, &sect);	/* Get current sector */
+	if (res != FR_OK) {
+		ABORT(fs, res);
+	}
+	cc = req->btr / SS(fs);
+	if (csect + cc > fs->csize) {	/* Clip at the end of the contiguous clusters */
+		cc = contig_sect(fp, csect, cc);
+	}
+	if (disk_read_start(fs->pdrv, req->buff, sect, cc) != RES_OK) {
+		ABORT(fs, FR_DISK_ERR);
+	}
+	req->sect = sect;
+	req->cc = cc;
+
+	LEAVE_FF(fs, FR_OK);
+}
+
+
+FRESULT f_read_async (
+	FIL *fp, 		/* Open file to be read */
+	void *buff,		/* Data buffer to store the read data */
+	UINT btr,		/* Number of bytes to read */
+	FF_ASYNC *req	/* Pointer to the read structure to be used */
+)
+{
+	req->fp = fp;
+	req->buff = (BYTE *)buff;
+	req->btr = 0;
+	req->br = 0;
+	req->cc = 0;
+	req->done = 0;
+	req->res = read_async_start(req, btr);
+	if (req->res != FR_OK) {
+		req->done = 1;
+		return req->res;
+	}
+	(void)f_read_poll(req);		/* Start the first transfer */
+
+	return FR_OK;
+}
+
+
+int f_read_poll (	/* Returns 1 once the read has ended, with its result in req->res */
+	FF_ASYNC *req	/* Pointer to the read */
+)
+{
+	FRESULT res;
+	FIL *fp = req->fp;
+	UINT rcnt, ss = SS(fp->obj.fs);
+
+
+	while (!req->done) {
+		if (req->cc == 0) {
+			if (req->btr == 0) {			/* All read? */
+				req->done = 1;
+				break;
+			}
+			if (fp->fptr % ss != 0 || req->btr < ss) {	/* Partial sector? */
+				rcnt = ss - (UINT)fp->fptr % ss;
+				if (rcnt > req->btr) {
+					rcnt = req->btr;
+				}
+				res = f_read(fp, req->buff, rcnt, &rcnt);
+				req->btr -= rcnt;
+				req->br += rcnt;
+				req->buff += rcnt;
+				if (res != FR_OK || rcnt == 0) {
+					req->res = res;
+					req->done = 1;
+				}
+				continue;
+			}
+		}
+		res = read_async_step(req);
+		if (res != FR_OK) {
+			req->res = res;
+			req->done = 1;
+			break;
+		}
+		if (req->cc > 0) {
+			break;        /* Transfer in flight */
+		}
+	}
+
+	return (int)req->done;
+}
+
+
+FRESULT f_read_wait (
+	FF_ASYNC *req,	/* Pointer to the read */
+	UINT *br		/* Number of bytes read */
+)
+{
+	while (f_read_poll(req) == 0) {
+		;
+	}
+	*br = req->br;
+
+	return req->res;
+}
+#endif
+
+
+
+
 #if !FF_FS_READONLY
 /*-----------------------------------------------------------------------*/
 /* Write File                                                            */
@@ -6129,6 +6654,111 @@ FRESULT f_getfree (
 
 
 
+#if FF_FREE_BITMAP
+/*-----------------------------------------------------------------------*/
+/* Give the Drive a Free Cluster Bitmap                                  */
+/*-----------------------------------------------------------------------*/
+
+FRESULT f_setbitmap (
+	const TCHAR *path,	/* Logical drive number */
+	DWORD *buff,		/* Bitmap of a bit per cluster, 0:Detach the bitmap */
+	UINT nwords			/* Size of the bitmap [words] */
+)
+{
+	FRESULT res = FR_DISK_ERR;
+	FATFS *fs;
+
+
+	res = mount_volume(&path, &fs, 0);
+	if (res == FR_OK) {
+		fs->bm_built = 0;			/* Build the bitmap from the start */
+		fs->bm = 0;
+		if (buff && fs->fs_type != FS_EXFAT) {
+			if (nwords < (fs->n_fatent + 31) / 32) {
+				res = FR_NOT_ENOUGH_CORE;        /* Too small for the volume */
+			}
+			else {
+				fs->bm = buff;
+				fs->bm_size = nwords;
+			}
+		}
+	}
+
+	LEAVE_FF(fs, res);
+}
+
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Read a Part of the FAT into the Free Cluster Bitmap                   */
+/*-----------------------------------------------------------------------*/
+
+FRESULT f_buildbitmap (
+	const TCHAR *path,	/* Logical drive number */
+	UINT nclst,			/* Number of FAT entries to read at most */
+	UINT *done			/* Pointer to a variable to return 1 once the bitmap is complete */
+)
+{
+	FRESULT res = FR_DISK_ERR;
+	FATFS *fs;
+	DWORD clst, stat, bit;
+	FFOBJID obj;
+
+
+	*done = 0;
+	res = mount_volume(&path, &fs, 0);
+	if (res == FR_OK) {
+		if (!fs->bm) {		/* Nothing to build (no bitmap or exFAT) */
+			*done = 1;
+			LEAVE_FF(fs, res);
+		}
+		if (fs->bm_size < (fs->n_fatent + 31) / 32) {
+			LEAVE_FF(fs, FR_NOT_ENOUGH_CORE);        /* Too small for the volume, after a media change */
+		}
+		if (fs->bm_built == 0) {	/* Clusters 0 and 1 are not for data */
+			fs->bm[0] = 3;
+			fs->bm_built = 2;
+			fs->bm_free = 0;
+		}
+		obj.fs = fs;
+		for (clst = fs->bm_built; nclst && clst < fs->n_fatent; nclst--, clst++) {
+			stat = get_fat(&obj, clst);
+			if (stat == 0xFFFFFFFF) {
+				res = FR_DISK_ERR;
+				break;
+			}
+			if (stat == 1) {
+				res = FR_INT_ERR;
+				break;
+			}
+			bit = (DWORD)1 << (clst % 32);
+			if (stat == 0) {
+				fs->bm[clst / 32] &= ~bit;
+				fs->bm_free++;
+			}
+			else {
+				fs->bm[clst / 32] |= bit;
+			}
+		}
+		fs->bm_built = clst;
+		if (res == FR_OK && clst >= fs->n_fatent) {	/* Complete? */
+			if (fs->free_clst != fs->bm_free) {	/* Correct the count of the FSINFO */
+				fs->free_clst = fs->bm_free;
+				fs->fsi_flag |= 1;
+			}
+			*done = 1;
+		}
+	}
+
+	LEAVE_FF(fs, res);
+}
+
+#endif /* FF_FREE_BITMAP */
+
+
+
+
 /*-----------------------------------------------------------------------*/
 /* Truncate File                                                         */
 /*-----------------------------------------------------------------------*/
@@ -39,7 +39,7 @@ void ff_memfree (
 /* Definitions of Mutex                                                   */
 /*------------------------------------------------------------------------*/
 
-#define OS_TYPE	0	/* 0:Win32, 1:uITRON4.0, 2:uC/OS-II, 3:FreeRTOS, 4:CMSIS-RTOS */
+#define OS_TYPE	5	/* 0:Win32, 1:uITRON4.0, 2:uC/OS-II, 3:FreeRTOS, 4:CMSIS-RTOS, 5:Standalone */
 
 
 #if   OS_TYPE == 0	/* Win32 */
@@ -64,6 +64,11 @@ static SemaphoreHandle_t Mutex[FF_VOLUMES + 1];	/* Table of mutex handle */
 #include "cmsis_os.h"
 static osMutexId Mutex[FF_VOLUMES + 1];	/* Table of mutex ID */
 
+#elif OS_TYPE == 5	/* Standalone, one spin lock per volume shared by the CPUs */
+#include "xilffs.h"
+#include "sleep.h"
+static Xilffs_SpinLock Mutex[FF_VOLUMES + 1];	/* Table of spin lock */
+
 #endif
 
 
@@ -106,6 +111,10 @@ int ff_mutex_create (	/* Returns 1:Function succeeded or 0:Could not create the
 	Mutex[vol] = osMutexCreate(osMutex(cmsis_os_mutex));
 	return (int)(Mutex[vol] != NULL);
 
+#elif OS_TYPE == 5	/* Standalone */
+	Xilffs_SpinInit(&Mutex[vol]);
+	return 1;
+
 #endif
 }
 
@@ -138,6 +147,9 @@ void ff_mutex_delete (	/* Returns 1:Function succeeded or 0:Could not delete due
 #elif OS_TYPE == 4	/* CMSIS-RTOS */
 	osMutexDelete(Mutex[vol]);
 
+#elif OS_TYPE == 5	/* Standalone */
+	(void)vol;	/* Nothing to free */
+
 #endif
 }
 
@@ -171,6 +183,9 @@ int ff_mutex_take (	/* Returns 1:Succeeded or 0:Timeout */
 #elif OS_TYPE == 4	/* CMSIS-RTOS */
 	return (int)(osMutexWait(Mutex[vol], FF_FS_TIMEOUT) == osOK);
 
+#elif OS_TYPE == 5	/* Standalone */
+	return Xilffs_SpinTake(&Mutex[vol], FF_FS_TIMEOUT);
+
 #endif
 }
 
@@ -201,7 +216,61 @@ void ff_mutex_give (
 #elif OS_TYPE == 4	/* CMSIS-RTOS */
 	osMutexRelease(Mutex[vol]);
 
+#elif OS_TYPE == 5	/* Standalone */
+	Xilffs_SpinGive(&Mutex[vol]);
+
 #endif
 }
 
+
+
+#if OS_TYPE == 5
+/*------------------------------------------------------------------------*/
+/* Spin Locks of the Standalone Port                                      */
+/*------------------------------------------------------------------------*/
+/* The lock is taken with an exclusive access, so that the CPUs do not
+/  need interrupts or an OS to share it. An uncontended take or give is one
+/  exclusive access and one barrier. diskio.c uses the same locks for the
+/  state its drives share.
+*/
+
+void Xilffs_SpinInit (
+	Xilffs_SpinLock *LockPtr	/* Lock to clear */
+)
+{
+	__atomic_store_n(&LockPtr->Lock, 0U, __ATOMIC_RELEASE);
+}
+
+
+int Xilffs_SpinTake (	/* Returns 1:Succeeded or 0:Timeout */
+	Xilffs_SpinLock *LockPtr,	/* Lock to take */
+	u32 TimeoutMs				/* Longest wait in milliseconds */
+)
+{
+	u32 Expected;
+	u32 Wait = TimeoutMs * 1000U;	/* Microseconds left */
+
+	for (;;) {
+		Expected = 0U;
+		if (__atomic_compare_exchange_n(&LockPtr->Lock, &Expected, 1U, 0,
+				__ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			return 1;
+		}
+		if (Wait == 0U) {
+			return 0;
+		}
+		Wait--;
+		(void)usleep(1);
+	}
+}
+
+
+void Xilffs_SpinGive (
+	Xilffs_SpinLock *LockPtr	/* Lock to release */
+)
+{
+	__atomic_store_n(&LockPtr->Lock, 0U, __ATOMIC_RELEASE);
+}
+#endif
+
 #endif	/* FF_FS_REENTRANT */
@@ -24,7 +24,8 @@ typedef enum {
 	RES_ERROR,		/**< 1: R/W Error */
 	RES_WRPRT,		/**< 2: Write Protected */
 	RES_NOTRDY,		/**< 3: Not Ready */
-	RES_PARERR		/**< 4: Invalid Parameter */
+	RES_PARERR,		/**< 4: Invalid Parameter */
+	RES_BUSY		/**< 5: Asynchronous read in flight */
 } DRESULT;
 
 
@@ -38,6 +39,18 @@ DRESULT disk_read (BYTE pdrv, BYTE* buff, LBA_t sector, UINT count);
 DRESULT disk_write (BYTE pdrv, const BYTE* buff, LBA_t sector, UINT count);
 DRESULT disk_ioctl (BYTE pdrv, BYTE cmd, void* buff);
 
+#if FF_USE_ASYNC
+DRESULT disk_read_start (BYTE pdrv, BYTE* buff, LBA_t sector, UINT count);
+DRESULT disk_read_check (BYTE pdrv);
+#endif
+
+DRESULT disk_sd_mode (BYTE pdrv, DWORD* width, DWORD* clock, BYTE* high_speed);
+
+#ifdef FILE_SYSTEM_USE_CACHE
+void disk_cache_invalidate (BYTE pdrv);
+void disk_cache_stats (DWORD* hits, DWORD* misses);
+#endif
+
 
 /* Disk Status Bits (DSTATUS) */
 
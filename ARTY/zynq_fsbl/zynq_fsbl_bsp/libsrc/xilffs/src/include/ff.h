@@ -130,6 +130,24 @@ extern const char* VolumeStr[FF_VOLUMES];	/* User defined volume ID table */
 
 
 
+#if FF_PATH_CACHE
+/* Path cache entry (FF_PCENT) */
+
+typedef struct {
+	DWORD	hash;			/* Hash of the path */
+	DWORD	len;			/* Length of the path (0:free entry) */
+	DWORD	org;			/* Start cluster the path was followed from */
+	DWORD	sclust;			/* Containing directory start cluster */
+	DWORD	dptr;			/* Offset of the entry in the directory */
+#if FF_USE_LFN
+	DWORD	blk_ofs;		/* Offset of the LFN entry block (0xFFFFFFFF:None) */
+#endif
+	BYTE	sfn[11];		/* SFN of the entry, to check it still holds */
+} FF_PCENT;
+#endif
+
+
+
 /* Filesystem object structure (FATFS) */
 
 typedef struct {
@@ -154,6 +172,12 @@ typedef struct {
 #if !FF_FS_READONLY
 	DWORD	last_clst;		/* Last allocated cluster (Unknown if >= n_fatent) */
 	DWORD	free_clst;		/* Number of free clusters (Unknown if >= n_fatent-2) */
+#if FF_FREE_BITMAP
+	DWORD*	bm;				/* Free cluster bitmap (bit set:In use, 0:None) */
+	DWORD	bm_size;		/* Size of the bitmap [words] */
+	DWORD	bm_built;		/* Clusters below this one are in the bitmap (0:Not started) */
+	DWORD	bm_free;		/* Number of free clusters in the bitmap */
+#endif
 #endif
 #if FF_FS_RPATH
 	DWORD	cdir;			/* Current directory start cluster (0:root) */
@@ -171,6 +195,10 @@ typedef struct {
 	LBA_t	database;		/* Data base sector */
 #if FF_FS_EXFAT
 	LBA_t	bitbase;		/* Allocation bitmap base sector */
+#endif
+#if FF_PATH_CACHE
+	FF_PCENT	pcache[FF_PATH_CACHE];	/* Path cache */
+	BYTE	pc_next;		/* Path cache entry replaced next */
 #endif
 	LBA_t	winsect;		/* Current sector appearing in the win[] */
 #ifdef __ICCARM__
@@ -317,6 +345,23 @@ typedef enum {
 
 
 
+#if FF_USE_ASYNC
+/* Asynchronous read structure (FF_ASYNC) */
+
+typedef struct {
+	FIL*	fp;				/* File being read */
+	BYTE*	buff;			/* Next byte of the data buffer */
+	UINT	btr;			/* Number of bytes left to read */
+	UINT	br;				/* Number of bytes read */
+	LBA_t	sect;			/* First sector of the transfer in flight */
+	UINT	cc;				/* Number of sectors of the transfer in flight (0:None) */
+	FRESULT	res;			/* Result of the read (valid when done) */
+	BYTE	done;			/* The read has ended */
+} FF_ASYNC;
+#endif
+
+
+
 
 /*--------------------------------------------------------------*/
 /* FatFs Module Application Interface                           */
@@ -344,6 +389,10 @@ FRESULT f_chdir (const TCHAR* path);								/* Change current directory */
 FRESULT f_chdrive (const TCHAR* path);								/* Change current drive */
 FRESULT f_getcwd (TCHAR* buff, UINT len);							/* Get current directory */
 FRESULT f_getfree (const TCHAR* path, DWORD* nclst, FATFS** fatfs);	/* Get number of free clusters on the drive */
+#if FF_FREE_BITMAP && !FF_FS_READONLY
+FRESULT f_setbitmap (const TCHAR* path, DWORD* buff, UINT nwords);	/* Give the drive a free cluster bitmap */
+FRESULT f_buildbitmap (const TCHAR* path, UINT nclst, UINT* done);	/* Read a part of the FAT into the bitmap */
+#endif
 FRESULT f_getlabel (const TCHAR* path, TCHAR* label, DWORD* vsn);	/* Get volume label */
 FRESULT f_setlabel (const TCHAR* label);							/* Set volume label */
 FRESULT f_forward (FIL* fp, UINT(*func)(const BYTE*,UINT), UINT btf, UINT* bf);	/* Forward data to the stream */
@@ -359,6 +408,11 @@ TCHAR* f_gets (TCHAR* buff, int len, FIL* fp);						/* Get a string from the fil
 #ifdef XPAR_XUFSPSXC_NUM_INSTANCES
 FRESULT f_ioctl (const TCHAR *path, BYTE Cmd, void *buff);			/* Perform device specific operations */
 #endif
+#if FF_USE_ASYNC
+FRESULT f_read_async (FIL* fp, void* buff, UINT btr, FF_ASYNC* req);	/* Start reading data from the file */
+int f_read_poll (FF_ASYNC* req);									/* Advance an asynchronous read, 1 once it has ended */
+FRESULT f_read_wait (FF_ASYNC* req, UINT* br);						/* Wait for an asynchronous read to end */
+#endif
 
 /* Some API functions are implemented as macro */
 
@@ -68,10 +68,36 @@ extern "C" {
 /* This option switches f_mkfs(). (0:Disable or 1:Enable) */
 
 
-#define FF_USE_FASTSEEK	0
+#ifdef FILE_SYSTEM_USE_FASTSEEK
+#define FF_USE_FASTSEEK	1	/* 1:Enable */
+#else
+#define FF_USE_FASTSEEK	0	/* 0:Disable */
+#endif
 /* This option switches fast seek feature. (0:Disable or 1:Enable) */
 
 
+#ifdef FILE_SYSTEM_USE_ASYNC
+#define FF_USE_ASYNC	1	/* 1:Enable */
+#else
+#define FF_USE_ASYNC	0	/* 0:Disable */
+#endif
+/* This option switches f_read_async(), f_read_poll() and f_read_wait(), which
+/  read the whole sectors of a file with transfers the drive runs in the
+/  background. (0:Disable or 1:Enable) */
+
+
+#ifdef FILE_SYSTEM_USE_PATH_CACHE
+#define FF_PATH_CACHE	FILE_SYSTEM_PATH_CACHE_ENTRIES	/* 1 to 255 */
+#else
+#define FF_PATH_CACHE	0	/* 0:Disable */
+#endif
+/* This option sets the number of entries of the path cache of each volume,
+/  which keeps the directory entries found by the recent path lookups so that
+/  opening the same path again reads only the sector of its entry. The cache
+/  of a volume is flushed when an entry is created or removed on it, and on
+/  mount. It is not used on exFAT volumes. (0:Disable or 1 to 255) */
+
+
 #define FF_USE_EXPAND	0
 /* This option switches f_expand(). (0:Disable or 1:Enable) */
 
@@ -332,6 +358,21 @@ extern "C" {
 */
 
 
+#ifdef FILE_SYSTEM_USE_FREE_BITMAP
+#define FF_FREE_BITMAP	1	/* 1:Enable */
+#else
+#define FF_FREE_BITMAP	0	/* 0:Disable */
+#endif
+/* This option switches f_setbitmap() and f_buildbitmap(), a bitmap of the free
+/  clusters of a FAT volume in a buffer of the application. f_buildbitmap()
+/  reads the FAT a given number of clusters per call, from an idle loop, and
+/  the clusters it has read are then found free from the bitmap, 32 at a time,
+/  instead of from the FAT. Once it is complete, the free cluster count of the
+/  FSINFO is replaced with the one of the bitmap. The bitmap is not used on
+/  exFAT volumes, which have their own. (0:Disable or 1:Enable)
+/  This option has no effect in read-only configuration (FF_FS_READONLY = 1). */
+
+
 #define FF_FS_LOCK		0
 /* The option FF_FS_LOCK switches file lock function to control duplicated file open
 /  and illegal operation to open objects. This option must be 0 when FF_FS_READONLY
@@ -344,8 +385,16 @@ extern "C" {
 /      lock control is independent of re-entrancy. */
 
 
-#define FF_FS_REENTRANT	0
+#ifdef FILE_SYSTEM_REENTRANT
+#define FF_FS_REENTRANT	1	/* 1:Enable */
+#else
+#define FF_FS_REENTRANT	0	/* 0:Disable */
+#endif
+#ifdef FILE_SYSTEM_TIMEOUT
+#define FF_FS_TIMEOUT	FILE_SYSTEM_TIMEOUT
+#else
 #define FF_FS_TIMEOUT	1000
+#endif
 /* The option FF_FS_REENTRANT switches the re-entrancy (thread safe) of the FatFs
 /  module itself. Note that regardless of this option, file access to different
 /  volume is always re-entrant and volume control functions, f_mount(), f_mkfs()
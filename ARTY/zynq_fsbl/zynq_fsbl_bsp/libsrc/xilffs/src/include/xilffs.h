@@ -20,6 +20,7 @@
  * Ver   Who  Date        Changes
  * ----- ---- -------- -------------------------------------------------------
  * 5.2   ht   10/10/23    Added code for versioning of library.
+ * 5.3   qm   10/14/26    Added the spin lock of the re-entrant build.
  *
  *</pre>
  *
@@ -42,6 +43,24 @@ extern "C" {
 #define XILFFS_MAJOR_VERSION	5U
 #define XILFFS_MINOR_VERSION	4U
 
+/**************************** Type Definitions *******************************/
+/**
+ * Spin lock of the re-entrant build, FILE_SYSTEM_REENTRANT. It fills a cache
+ * line, so that CPUs spinning on two locks do not fight over one line. The
+ * exclusive accesses need the lock to be in cacheable memory shared by the
+ * CPUs, which it is when both run with the SMP bit set of the standalone
+ * boot code, and in uncached memory under USE_AMP.
+ */
+typedef struct {
+	volatile u32 Lock;	/**< 0 when free, 1 when held */
+	u32 Pad[7];		/**< Rest of the cache line */
+} __attribute__ ((aligned(32))) Xilffs_SpinLock;
+
+/************************** Function Prototypes ******************************/
+void Xilffs_SpinInit(Xilffs_SpinLock *LockPtr);
+int Xilffs_SpinTake(Xilffs_SpinLock *LockPtr, u32 TimeoutMs);
+void Xilffs_SpinGive(Xilffs_SpinLock *LockPtr);
+
 /****************** Macros (Inline Functions) Definitions *********************/
 
 /*****************************************************************************/
@@ -18,6 +18,16 @@ SET(XILFFS_set_fs_rpath	 0 CACHE STRING "Configures relative path feature (valid
 SET_PROPERTY(CACHE XILFFS_set_fs_rpath PROPERTY STRINGS 0 1 2)
 option(XILFFS_word_access "Enables word access for misaligned memory access platform" ON)
 option(XILFFS_use_chmod "Enables use of CHMOD functionality for changing attributes (valid only with read_only set to false)" OFF)
+option(XILFFS_use_async "Disable(0) or Enable(1) f_read_async(), reads of whole sectors run by the drive in the background" OFF)
+option(XILFFS_use_cache "Disable(0) or Enable(1) the LRU sector cache of the SD drives, written through. Zynq fsbl sets this to true" OFF)
+SET(XILFFS_cache_sectors 32 CACHE STRING "Number of 512 byte sectors in the sector cache")
+SET(XILFFS_cache_read_ahead 4 CACHE STRING "Number of sectors read past a miss of the sector cache")
+option(XILFFS_use_path_cache "Disable(0) or Enable(1) the path cache, the directory entries found by the recent path lookups of each volume" OFF)
+SET(XILFFS_path_cache_entries 16 CACHE STRING "Number of entries of the path cache of each volume (valid values 1 to 255)")
+option(XILFFS_reentrant "Disable(0) or Enable(1) re-entrancy, a spin lock per volume shared by the two CPUs" OFF)
+SET(XILFFS_fs_timeout 1000 CACHE STRING "Milliseconds a re-entrant file function waits for its volume before it fails with FR_TIMEOUT")
+option(XILFFS_use_fastseek "Disable(0) or Enable(1) fast seek, f_lseek() through a cluster link map table. Zynq fsbl sets this to true" OFF)
+option(XILFFS_use_free_bitmap "Disable(0) or Enable(1) the free cluster bitmap, f_setbitmap() and f_buildbitmap()" OFF)
 SET(XILFFS_max_sector_size 4096 CACHE STRING "Maximum Sector size(valid values are 4096, 8192, 16384, 32768)")
 
 SET(XILFFS_ramfs_size 3145728 CACHE STRING "RAM FS size")
@@ -57,6 +67,28 @@ if (${XILFFS_fs_interface})
 	if (${XILFFS_use_trim})
 		set(FILE_SYSTEM_USE_TRIM " ")
 	endif()
+	if (${XILFFS_use_fastseek})
+		set(FILE_SYSTEM_USE_FASTSEEK " ")
+	endif()
+	if (${XILFFS_use_free_bitmap})
+		set(FILE_SYSTEM_USE_FREE_BITMAP " ")
+	endif()
+	if (${XILFFS_use_async})
+		set(FILE_SYSTEM_USE_ASYNC " ")
+	endif()
+	if (${XILFFS_use_cache})
+		set(FILE_SYSTEM_USE_CACHE " ")
+		set(FILE_SYSTEM_CACHE_SECTORS ${XILFFS_cache_sectors})
+		set(FILE_SYSTEM_CACHE_READ_AHEAD ${XILFFS_cache_read_ahead})
+	endif()
+	if (${XILFFS_use_path_cache})
+		set(FILE_SYSTEM_USE_PATH_CACHE " ")
+		set(FILE_SYSTEM_PATH_CACHE_ENTRIES ${XILFFS_path_cache_entries})
+	endif()
+	if (${XILFFS_reentrant})
+		set(FILE_SYSTEM_REENTRANT " ")
+		set(FILE_SYSTEM_TIMEOUT ${XILFFS_fs_timeout})
+	endif()
 	if (${XILFFS_use_chmod})
 		if (${XILFFS_read_only})
 			message("WARNING : Cannot Enable CHMOD in read only mode\n")
@@ -28,7 +28,63 @@ set(USER_UNDEFINED_SYMBOLS
 
 set(USER_INCLUDE_DIRECTORIES
 )
+# Example : Adding "pc_prof.c" builds the PC sampling profiler of pc_prof.h,
+# which needs a BSP built with the standalone option standalone_pc_sample.
 set(USER_COMPILE_SOURCES
+"main.c"
+"usb_to_uart.c"
+"uart_sched.c"
+"uart_frame.c"
+"uart_vchan.c"
+"uart_bond.c"
+"lz4_block.c"
+"uart_bench.c"
+"uart_log.c"
+"mem_bench.c"
+"dma_bench.c"
+"dfx_mgr.c"
+"irq_affinity.c"
+"amp.c"
+"amp_queue.c"
+"amp_mpsc.c"
+"task_pool.c"
+"amp_cpu1_entry.S"
+"coro.c"
+"coro_switch.S"
+"timer_wheel.c"
+"event_loop.c"
+"mem_region.c"
+"bram_mbox.c"
+"pgo.c"
+"region_bench.c"
+"bram_bench.c"
+"l2part_bench.c"
+"ring_bench.c"
+"irq_bench.c"
+"qos_bench.c"
+"wdt_service.c"
+"clk_profile.c"
+"ddr_qos.c"
+"thermal_gov.c"
+"sd_log.c"
+"file_map.c"
+"usb_cdc.c"
+"axi_dma.c"
+"pl_uart.c"
+"uart_bert.c"
+"panic_dump.c"
+"qspi_flash.c"
+"image_slot.c"
+"deferred_part.c"
+"pl_scrub.c"
+"metrics.c"
+"sched_bench.c"
+"pl_hash.c"
+"stack_mark.c"
+"bridge_bench.c"
+"suspend.c"
+"suspend_resume.S"
+"edf_sched.c"
 )
 
 # -----------------------------------------
@@ -60,7 +116,8 @@ set(USER_COMPILE_WARNINGS_INHIBIT_ALL )
 set(USER_COMPILE_OPTIMIZATION_LEVEL -O0)
 
 # Other flags related to optimization
-set(USER_COMPILE_OPTIMIZATION_OTHER_FLAGS )
+# -ffunction-sections lets text_order.ld place the hot functions together
+set(USER_COMPILE_OPTIMIZATION_OTHER_FLAGS -ffunction-sections)
 
 # -----------------------------------------
 
@@ -86,6 +143,15 @@ set(USER_COMPILE_RELAXATION "-Wl,--no-relax")
 set(USER_COMPILE_GARBAGE "")
 # Add any compiler options that are not covered by the above variables, they will be added as extra compiler options
 # To enable profiling -pg [ for gprof ]  or -p [ for prof information ]
+# For profile-guided optimization, refer to pgo.h, build the instrumented
+# image with PGO_GENERATE defined and
+#   -fprofile-generate=<dir> -fprofile-info-section
+#   -fprofile-update=prefer-atomic -fdata-sections
+# then the release one, from the same build directory, at -O2 with
+#   -fprofile-use=<dir> -fprofile-partial-training
+# For the worst case stack depths of tools/stack_usage.py, build with
+#   -fstack-usage
+# and link the stacks with the sizes it gives, refer to the linker options
 set(USER_COMPILE_OTHER_FLAGS )
 
 # -----------------------------------------
@@ -124,6 +190,15 @@ set(USER_LINKER_SCRIPT "${CMAKE_SOURCE_DIR}/lscript.ld")
 
 # Add linker options to be passed, they will be added as extra linker options
 # Example : Adding -s will pass -s to the linker.
+# Example : Adding -Wl,--defsym=_OCM_HIGH=1 links and remaps all the OCM as
+# one block at 0xFFFC0000, refer to xil_hotpath.h.
+# Example : Adding -Wl,--defsym=_QSPI_XIP=0x400000 links the cold code to
+# execute in place from that offset of the QSPI flash, refer to lscript.ld.
+# Example : Adding -Wl,--defsym=_ABORT_STACK_SIZE=0x4000 makes room on the
+# abort stack for the page faults of file_map.h.
+# Example : Adding -Wl,--defsym=_OCM_STACKS=1 puts the IRQ, FIQ, Abort and
+# Undefined mode stacks in the OCM, with a BSP built with XIL_OCM_VECTORS for
+# the vectors, refer to xil_hotpath.h.
 set(USER_LINK_OTHER_FLAGS
 )
 
@@ -0,0 +1,596 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file amp.c
+*
+* Runtime of the two CPUs. Refer to amp.h for how CPU1 is started.
+*
+* The IRQ exception of both cores goes through Amp_IrqHandler(), which
+* dispatches with the XScuGic instance of the CPU it runs on. The CPU
+* interface of the GIC, the software interrupts and the private peripheral
+* interrupts are banked per core, CPU1 sets up its own when it starts.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Added the L2 way partitioning.
+*       qm     10/14/26 Added the parking of CPU1.
+*       qm     10/14/26 Keep the L1 flushes of large ranges by MVA once
+*			CPU1 is started, see Xil_DCacheSetSmp().
+*       qm     10/14/26 Added Amp_InitFromWrapper().
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xil_io.h"
+#include "xil_cache.h"
+#include "xil_cache_l.h"
+#include "xpseudo_asm.h"
+#include "xil_hotpath.h"
+#include "xil_l2lock.h"
+#include "xinterrupt_wrap.h"
+#include "amp.h"
+
+/************************** Constant Definitions ****************************/
+
+#define AMP_CPU1_WAKE_ADDR	0xFFFFFFF0U /* Read by the Boot ROM wait loop */
+#define AMP_EFUSE_STATUS	0xF800D010U
+#define AMP_EFUSE_CPU1_DISABLE	0x80U	/* Single core device */
+#define AMP_START_TIMEOUT	1000000U /* Polls */
+
+/* CPU interface setup of XScuGic_CfgInitialize(), done again by CPU1 */
+#define AMP_GIC_PRIORITY_MASK	0xF0U
+#define AMP_GIC_CPU_ENABLE	0x07U
+
+/*
+ * States of CPU1
+ */
+#define AMP_CPU1_STOPPED	0U	/* In the Boot ROM wait loop */
+#define AMP_CPU1_RUNNING	1U	/* In its main function */
+#define AMP_CPU1_EXITED		2U	/* Returned from its main function */
+#define AMP_CPU1_PARKED		3U	/* In AmpCpu1ParkLoop */
+
+/*
+ * Steps of the parking, in AmpPark
+ */
+#define AMP_PARK_NONE		0U
+#define AMP_PARK_REQUEST	1U	/* Set by CPU0 */
+#define AMP_PARK_DONE		2U	/* Set by CPU1 once its cache is clean */
+
+/**************************** Type Definitions ******************************/
+
+typedef struct {
+	volatile u32 State;	/* AMP_CPU1_* */
+	Amp_Cpu1Main Main;
+	void *Arg;
+} Amp_Cpu1Ctrl;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define sev()	__asm__ __volatile__ ("sev" : : : "memory")
+#define wfe()	__asm__ __volatile__ ("wfe" : : : "memory")
+
+/************************** Function Prototypes *****************************/
+
+extern void AmpCpu1Entry(void);
+extern void AmpCpu1ParkLoop(volatile u32 *ParkPtr);
+void AmpCpu1Start(void);
+static void Amp_IrqHandler(void *CallBackRef);
+static void Amp_NotifyHandler(void *CallBackRef);
+static void AmpCpu1Park(void);
+
+/************************** Variable Definitions ****************************/
+
+static XScuGic *AmpGic[AMP_NUM_CPUS];
+static XScuGic AmpCpu1Gic;
+static XScuGic_VectorTableEntry AmpNotify[AMP_NUM_CPUS];
+static Amp_Cpu1Ctrl AmpCpu1 AMP_SHARED;
+/* Polled by the parked CPU1, out of the DDR */
+static volatile u32 AmpPark XIL_FAST_BSS;
+
+/****************************************************************************/
+/**
+*
+* Sets up the runtime on CPU0: the IRQ dispatch per CPU and the notify
+* software interrupt.
+*
+* @return
+*		- XST_SUCCESS if the runtime is ready.
+*		- XST_FAILURE if the GIC is not initialized yet, the first
+*		  XSetupInterruptSystem() call does it.
+*		- XST_INVALID_PARAM if AMP_L2_WAYS_CPU0 or AMP_L2_WAYS_CPU1
+*		  is not a valid mask of ways.
+*
+* @note		The XScuGic instance of CPU1 is a copy of the one of CPU0
+*		taken here, with no statistics attached.
+*
+*****************************************************************************/
+s32 Amp_Initialize(void)
+{
+	u8 Priority;
+	u8 Trigger;
+	s32 Status;
+
+	AmpGic[0] = XGetScuGicInstance();
+	if (AmpGic[0] == NULL) {
+		return XST_FAILURE;
+	}
+
+	AmpCpu1Gic = *AmpGic[0];
+#if defined (XSCUGIC_STATS)
+	AmpCpu1Gic.StatsPtr = NULL;
+#endif
+	AmpGic[1] = &AmpCpu1Gic;
+
+	/* The shared memory is not cleared by the startup code */
+	AmpCpu1.State = AMP_CPU1_STOPPED;
+
+	Status = XScuGic_Connect(AmpGic[0], AMP_NOTIFY_SGI,
+				 (Xil_InterruptHandler)Amp_NotifyHandler, NULL);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	XScuGic_GetPriorityTriggerType(AmpGic[0], AMP_NOTIFY_SGI, &Priority,
+				       &Trigger);
+	XScuGic_SetPriorityTriggerType(AmpGic[0], AMP_NOTIFY_SGI,
+				       XINTERRUPT_DEFAULT_PRIORITY, Trigger);
+	XScuGic_Enable(AmpGic[0], AMP_NOTIFY_SGI);
+
+	Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT,
+				     (Xil_ExceptionHandler)Amp_IrqHandler,
+				     NULL);
+
+#if defined (AMP_L2_WAYS_CPU0) && defined (AMP_L2_WAYS_CPU1)
+	Status = Amp_SetL2Ways(0U, AMP_L2_WAYS_CPU0);
+	if (Status == XST_SUCCESS) {
+		Status = Amp_SetL2Ways(1U, AMP_L2_WAYS_CPU1);
+	}
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+#endif
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Sets up the runtime on CPU0 if it is not yet, with the GIC of the
+* interrupt wrapper, which is initialized first when no XSetupInterruptSystem()
+* call did it. The benchmarks and the task pool start from here.
+*
+* @return
+*		- XST_SUCCESS if the runtime is ready, Amp_GetGic(0U) gives
+*		  the GIC instance of CPU0.
+*		- The error of XConfigInterruptCntrl() or Amp_Initialize()
+*		  otherwise.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 Amp_InitFromWrapper(void)
+{
+	s32 Status;
+
+	if (AmpGic[0] != NULL) {
+		return XST_SUCCESS;
+	}
+
+	/* Amp_Initialize() takes the GIC set up by the interrupt wrapper */
+	Status = XConfigInterruptCntrl(XPAR_XSCUGIC_0_BASEADDR);
+	if (Status == XST_SUCCESS) {
+		Status = Amp_Initialize();
+	}
+
+	return Status;
+}
+
+/****************************************************************************/
+/**
+*
+* Wakes CPU1 out of the Boot ROM wait loop into a main function, and waits
+* for it to run.
+*
+* @param	Main is the function CPU1 runs, with its interrupts enabled.
+*		CPU1 waits for events when it returns.
+* @param	Arg is its argument.
+*
+* @return
+*		- XST_SUCCESS if CPU1 runs Main.
+*		- XST_DEVICE_BUSY if CPU1 was already started.
+*		- XST_FAILURE if the runtime is not initialized, the device
+*		  has one core or CPU1 does not answer.
+*
+* @note		The wake-up vector is cleared again once CPU1 has left the
+*		Boot ROM wait loop.
+*
+*****************************************************************************/
+s32 Amp_StartCpu1(Amp_Cpu1Main Main, void *Arg)
+{
+	u32 Count;
+
+	if (AmpGic[0] == NULL) {
+		return XST_FAILURE;
+	}
+	if (AmpCpu1.State != AMP_CPU1_STOPPED) {
+		return XST_DEVICE_BUSY;
+	}
+	if ((Xil_In32(AMP_EFUSE_STATUS) & AMP_EFUSE_CPU1_DISABLE) != 0U) {
+		return XST_FAILURE;
+	}
+
+	AmpCpu1.Main = Main;
+	AmpCpu1.Arg = Arg;
+
+	/* The large flushes of CPU0 must reach the lines of CPU1 from now on */
+	Xil_DCacheSetSmp(1U);
+
+	/* The Boot ROM reads the vector with the MMU and the caches off */
+	Xil_Out32(AMP_CPU1_WAKE_ADDR, (u32)(UINTPTR)AmpCpu1Entry);
+	Xil_DCacheFlushRange(AMP_CPU1_WAKE_ADDR, 4U);
+	dsb();
+	sev();
+
+	for (Count = 0U; Count < AMP_START_TIMEOUT; Count++) {
+		if (AmpCpu1.State != AMP_CPU1_STOPPED) {
+			break;
+		}
+	}
+
+	Xil_Out32(AMP_CPU1_WAKE_ADDR, 0U);
+	Xil_DCacheFlushRange(AMP_CPU1_WAKE_ADDR, 4U);
+
+	return (AmpCpu1.State != AMP_CPU1_STOPPED) ? XST_SUCCESS : XST_FAILURE;
+}
+
+/****************************************************************************/
+/**
+*
+* Tells whether CPU1 runs its main function.
+*
+* @return	1 if it does, 0 if it is stopped or has returned.
+*
+*****************************************************************************/
+u32 Amp_Cpu1Running(void)
+{
+	return (AmpCpu1.State == AMP_CPU1_RUNNING) ? 1U : 0U;
+}
+
+/****************************************************************************/
+/**
+*
+* Gives the CPU the caller runs on.
+*
+* @return	0 or 1.
+*
+*****************************************************************************/
+u32 Amp_CpuId(void)
+{
+	return mfcp(XREG_CP15_MULTI_PROC_AFFINITY) & 0x3U;
+}
+
+/****************************************************************************/
+/**
+*
+* Gives the XScuGic instance a CPU dispatches its interrupts with, for
+* XScuGic_EnableStats() on that CPU.
+*
+* @param	Cpu is the CPU, 0 or 1.
+*
+* @return	The instance, or NULL before Amp_Initialize().
+*
+*****************************************************************************/
+XScuGic *Amp_GetGic(u32 Cpu)
+{
+	if (Cpu >= AMP_NUM_CPUS) {
+		return NULL;
+	}
+
+	return AmpGic[Cpu];
+}
+
+/****************************************************************************/
+/**
+*
+* Sets the handler the notify software interrupt calls on a CPU.
+*
+* @param	Cpu is the CPU, 0 or 1.
+* @param	Handler is called from the interrupt, NULL for none.
+* @param	CallBackRef is its argument.
+*
+* @return	None.
+*
+*****************************************************************************/
+void Amp_SetNotifyHandler(u32 Cpu, Xil_InterruptHandler Handler,
+			  void *CallBackRef)
+{
+	if (Cpu >= AMP_NUM_CPUS) {
+		return;
+	}
+
+	AmpNotify[Cpu].Handler = NULL;
+	dmb();
+	AmpNotify[Cpu].CallBackRef = CallBackRef;
+	dmb();
+	AmpNotify[Cpu].Handler = Handler;
+}
+
+/****************************************************************************/
+/**
+*
+* Raises the notify software interrupt on a CPU.
+*
+* @param	Cpu is the CPU, 0 or 1.
+*
+* @return
+*		- XST_SUCCESS if the interrupt was raised.
+*		- XST_FAILURE if the runtime is not initialized.
+*		- XST_INVALID_PARAM if the CPU is not valid.
+*
+* @note		The data written before the call is seen by the handler.
+*
+*****************************************************************************/
+XIL_HOTPATH_TEXT
+s32 Amp_Notify(u32 Cpu)
+{
+	if (Cpu >= AMP_NUM_CPUS) {
+		return XST_INVALID_PARAM;
+	}
+	if (AmpGic[0] == NULL) {
+		return XST_FAILURE;
+	}
+
+	dsb();
+
+	return XScuGic_SoftwareIntr(AmpGic[0], AMP_NOTIFY_SGI,
+				    (u32)1U << Cpu);
+}
+
+/****************************************************************************/
+/**
+*
+* Sets the ways of the L2 the misses of a CPU allocate into, data and
+* instructions alike. The CPU still hits in all the ways.
+*
+* @param	Cpu is the CPU, 0 or 1.
+* @param	WayMask is the mask of its ways, bit n for way n of the 8.
+*		0xFF gives it the whole L2 again.
+*
+* @return
+*		- XST_SUCCESS if the ways are set.
+*		- XST_INVALID_PARAM if the CPU or the mask is not valid.
+*
+* @note		From either CPU, at any time. Lines of the CPU in the ways it
+*		loses stay until they are evicted from there.
+*
+*****************************************************************************/
+s32 Amp_SetL2Ways(u32 Cpu, u32 WayMask)
+{
+	if (Cpu >= AMP_NUM_CPUS) {
+		return XST_INVALID_PARAM;
+	}
+
+	/* The CPUs are masters 0 and 1 of the L2 */
+	return Xil_L2LockSetMaster(XIL_L2_MASTER_CPU0 + Cpu, WayMask,
+				   WayMask);
+}
+
+/****************************************************************************/
+/**
+*
+* Gives the ways of the L2 the data misses of a CPU allocate into.
+*
+* @param	Cpu is the CPU, 0 or 1.
+*
+* @return	The mask of the ways, 0 for an invalid CPU.
+*
+*****************************************************************************/
+u32 Amp_GetL2Ways(u32 Cpu)
+{
+	u32 DataWays;
+	u32 InstrWays;
+
+	if (Cpu >= AMP_NUM_CPUS) {
+		return 0U;
+	}
+
+	Xil_L2LockGetMaster(XIL_L2_MASTER_CPU0 + Cpu, &DataWays, &InstrWays);
+
+	return DataWays;
+}
+
+/****************************************************************************/
+/**
+*
+* Parks CPU1 in a wait loop of the low OCM, from the handler of the notify
+* software interrupt, with its L1 data cache written back and nothing of
+* the loop in DDR.
+*
+* @return
+*		- XST_SUCCESS if CPU1 is parked, or does not run its main
+*		  function.
+*		- XST_DEVICE_BUSY if it is parked already.
+*		- XST_FAILURE if it does not answer, with its interrupts
+*		  masked for too long.
+*
+* @note		From CPU0. CPU1 stays parked, its interrupts masked, until
+*		Amp_UnparkCpu1(), which is called after a failure too.
+*
+*****************************************************************************/
+s32 Amp_ParkCpu1(void)
+{
+	u32 Count;
+
+	if (AmpCpu1.State == AMP_CPU1_PARKED) {
+		return XST_DEVICE_BUSY;
+	}
+	if (AmpCpu1.State != AMP_CPU1_RUNNING) {
+		return XST_SUCCESS;
+	}
+
+	AmpPark = AMP_PARK_REQUEST;
+	if (Amp_Notify(1U) != XST_SUCCESS) {
+		AmpPark = AMP_PARK_NONE;
+		return XST_FAILURE;
+	}
+
+	for (Count = 0U; Count < AMP_START_TIMEOUT; Count++) {
+		if (AmpPark == AMP_PARK_DONE) {
+			return XST_SUCCESS;
+		}
+	}
+
+	/* A CPU1 that parks meanwhile is let go by Amp_UnparkCpu1() */
+	AmpPark = AMP_PARK_NONE;
+	dsb();
+
+	return XST_FAILURE;
+}
+
+/****************************************************************************/
+/**
+*
+* Lets CPU1 return from its parking to what it was running.
+*
+* @param	WasReset is 1 after a system reset, which has taken CPU1 back
+*		to the Boot ROM wait loop for Amp_StartCpu1() to start it
+*		again, 0 otherwise.
+*
+* @return	None.
+*
+*****************************************************************************/
+void Amp_UnparkCpu1(u32 WasReset)
+{
+	if (AmpCpu1.State != AMP_CPU1_PARKED) {
+		return;
+	}
+
+	AmpCpu1.State = (WasReset != 0U) ? AMP_CPU1_STOPPED :
+					   AMP_CPU1_RUNNING;
+	AmpPark = AMP_PARK_NONE;
+	dsb();
+	sev();
+}
+
+/****************************************************************************/
+/**
+*
+* Runs on CPU1, called by AmpCpu1Entry with the MMU and the caches on. Sets
+* up the CPU interface of the GIC and the notify software interrupt of
+* CPU1, then calls the main function with the interrupts enabled.
+*
+* @return	None, CPU1 waits for events if the main function returns.
+*
+*****************************************************************************/
+void AmpCpu1Start(void)
+{
+	XScuGic *GicPtr = &AmpCpu1Gic;
+	u8 Priority;
+	u8 Trigger;
+
+	XScuGic_CPUWriteReg(GicPtr, XSCUGIC_CPU_PRIOR_OFFSET,
+			    AMP_GIC_PRIORITY_MASK);
+	XScuGic_CPUWriteReg(GicPtr, XSCUGIC_CONTROL_OFFSET,
+			    AMP_GIC_CPU_ENABLE);
+
+	/* The software interrupt registers are the ones of CPU1 here */
+	XScuGic_GetPriorityTriggerType(GicPtr, AMP_NOTIFY_SGI, &Priority,
+				       &Trigger);
+	XScuGic_SetPriorityTriggerType(GicPtr, AMP_NOTIFY_SGI,
+				       XINTERRUPT_DEFAULT_PRIORITY, Trigger);
+	XScuGic_DistWriteReg(GicPtr, XSCUGIC_ENABLE_SET_OFFSET,
+			     (u32)1U << AMP_NOTIFY_SGI);
+
+	AmpCpu1.State = AMP_CPU1_RUNNING;
+	dsb();
+
+	Xil_ExceptionEnable();
+	AmpCpu1.Main(AmpCpu1.Arg);
+	Xil_ExceptionDisable();
+
+	AmpCpu1.State = AMP_CPU1_EXITED;
+	dsb();
+	while (1) {
+		wfe();
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* IRQ handler of both CPUs, dispatches with the XScuGic instance of the CPU
+* it runs on.
+*
+* @param	CallBackRef is not used.
+*
+* @return	None.
+*
+*****************************************************************************/
+XIL_HOTPATH_TEXT
+static void Amp_IrqHandler(void *CallBackRef)
+{
+	(void)CallBackRef;
+
+	XScuGic_InterruptHandler(AmpGic[Amp_CpuId()]);
+}
+
+/****************************************************************************/
+/**
+*
+* Handler of the notify software interrupt, calls the notify handler of the
+* CPU it runs on.
+*
+* @param	CallBackRef is not used.
+*
+* @return	None.
+*
+*****************************************************************************/
+XIL_HOTPATH_TEXT
+static void Amp_NotifyHandler(void *CallBackRef)
+{
+	XScuGic_VectorTableEntry *NotifyPtr = &AmpNotify[Amp_CpuId()];
+	Xil_InterruptHandler Handler = NotifyPtr->Handler;
+
+	(void)CallBackRef;
+
+	if ((AmpPark == AMP_PARK_REQUEST) && (Amp_CpuId() == 1U)) {
+		AmpCpu1Park();
+	}
+
+	if (Handler != NULL) {
+		Handler(NotifyPtr->CallBackRef);
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Runs on CPU1 when CPU0 parks it. The state is written before the data
+* cache is cleaned, so that nothing is written to DDR once CPU0 is told;
+* the wait loop reads the OCM only.
+*
+* @return	None, once CPU0 lets CPU1 go.
+*
+*****************************************************************************/
+static void AmpCpu1Park(void)
+{
+	AmpCpu1.State = AMP_CPU1_PARKED;
+	dsb();
+	Xil_L1DCacheFlush();
+
+	AmpPark = AMP_PARK_DONE;
+	dsb();
+	AmpCpu1ParkLoop(&AmpPark);
+}
@@ -0,0 +1,107 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file amp.h
+*
+* Runs CPU1 next to CPU0 in the application.
+*
+* CPU1 sits in the Boot ROM wait loop when the application starts. The
+* runtime wakes it through the wake-up vector at the top of the OCM into
+* amp_cpu1_entry.S, which gives it the stacks of the .cpu1_stack section,
+* the vector table and the MMU table of the application, and joins it to
+* the SCU coherency with the data cache on, so that both cores share all
+* the cacheable memory. CPU1 then calls the main function handed to
+* Amp_StartCpu1() with its interrupts enabled.
+*
+* Both cores run the same image and the same handler table of the GIC. Each
+* CPU has its own XScuGic instance, Amp_GetGic(), so that the statistics of
+* xscugic_stats.c are counted per CPU, and the IRQ of each core dispatches
+* through its own instance. The interrupts of the peripherals are taken by
+* the CPUs the distributor targets them to, see irq_affinity.h.
+*
+* Amp_Notify() raises the AMP_NOTIFY_SGI software interrupt on the other
+* CPU, which calls the notify handler set for that CPU. It is the doorbell
+* of the message queues of amp_queue.h, placed in the .amp_shared section
+* of the linker script.
+*
+* Amp_SetL2Ways() partitions the ways of the shared L2 between the CPUs
+* with the lockdown by master of xil_l2lock.h, so that a core streaming
+* through memory does not evict the working set of the other. With
+* AMP_L2_WAYS_CPU0 and AMP_L2_WAYS_CPU1 defined, Amp_Initialize() sets the
+* two masks; l2part_bench.h measures the effect on the UART path.
+*
+* Amp_ParkCpu1() stops CPU1 in a wait loop of the low OCM, with its data
+* cache written back, so that CPU0 has the DDR to itself, for suspend.h to
+* put it in self-refresh. The notify software interrupt takes CPU1 there
+* and Amp_UnparkCpu1() lets it return to what it was running.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Added Amp_SetL2Ways().
+*       qm     10/14/26 Added Amp_ParkCpu1() and Amp_UnparkCpu1().
+*       qm     10/14/26 Added Amp_InitFromWrapper().
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef AMP_H
+#define AMP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xil_exception.h"
+#include "xscugic.h"
+
+/************************** Constant Definitions ****************************/
+
+#define AMP_NUM_CPUS		2U
+
+/* Software interrupt of Amp_Notify() */
+#ifndef AMP_NOTIFY_SGI
+#define AMP_NOTIFY_SGI		15U
+#endif
+
+/* Places a variable in the memory shared by the CPUs, not cleared at reset */
+#define AMP_SHARED		__attribute__((section(".amp_shared")))
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Main function of CPU1, called with its argument.
+ */
+typedef void (*Amp_Cpu1Main)(void *Arg);
+
+/************************** Function Prototypes *****************************/
+
+s32 Amp_Initialize(void);
+s32 Amp_InitFromWrapper(void);
+s32 Amp_StartCpu1(Amp_Cpu1Main Main, void *Arg);
+u32 Amp_Cpu1Running(void);
+u32 Amp_CpuId(void);
+XScuGic *Amp_GetGic(u32 Cpu);
+void Amp_SetNotifyHandler(u32 Cpu, Xil_InterruptHandler Handler,
+			  void *CallBackRef);
+s32 Amp_Notify(u32 Cpu);
+s32 Amp_SetL2Ways(u32 Cpu, u32 WayMask);
+u32 Amp_GetL2Ways(u32 Cpu);
+s32 Amp_ParkCpu1(void);
+void Amp_UnparkCpu1(u32 WasReset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AMP_H */
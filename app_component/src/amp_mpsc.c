@@ -0,0 +1,357 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file amp_mpsc.c
+*
+* Multiple producer message queue between the CPUs. Refer to amp_mpsc.h for
+* how it is used.
+*
+* A slot holds its sequence word, the length of the message and the
+* payload. The slot of position P is published when its sequence word is
+* P + 1, and is free for P once the tail has passed P - NumSlots: the
+* consumer frees slots in order, so a producer that sees room between the
+* head and the tail has all the slots it claims free. A batch is written,
+* then one dmb, then the sequence words are set, so that the consumer never
+* sees a published slot before its message.
+*
+* The doorbell uses the store, dmb, load order on both sides: the consumer
+* sets Sleeping and then looks for a message, a producer publishes and then
+* looks at Sleeping, so that at least one of them sees the other.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xstatus.h"
+#include "xpseudo_asm.h"
+#include "xil_mem.h"
+#include "xil_hotpath.h"
+#include "amp.h"
+#include "amp_mpsc.h"
+
+/************************** Constant Definitions ****************************/
+
+/**************************** Type Definitions ******************************/
+
+typedef struct {
+	volatile u32 Seq;	/* Position + 1 once published */
+	u32 Length;
+} AmpMpsc_Slot;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/* Slot of a free running position */
+#define AMP_MPSC_SLOT(QueuePtr, Pos) \
+	((AmpMpsc_Slot *)(void *)((QueuePtr)->Slots + \
+				  (((Pos) & (QueuePtr)->Mask) * \
+				   (QueuePtr)->SlotSize)))
+
+/* Payload of a slot */
+#define AMP_MPSC_PAYLOAD(SlotPtr) \
+	((u8 *)(void *)(SlotPtr) + AMP_MPSC_HDR_SIZE)
+
+#define wfi()	__asm__ __volatile__ ("wfi" : : : "memory")
+
+/************************** Function Prototypes *****************************/
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* Sets up an empty queue over its slots.
+*
+* @param	QueuePtr is a pointer to the queue, in AMP_SHARED memory.
+* @param	SlotsPtr is the memory of the slots, NumSlots * SlotSize
+*		bytes, word aligned, in AMP_SHARED memory.
+* @param	NumSlots is the number of slots, a power of two.
+* @param	SlotSize is the size of a slot, a multiple of 8 bytes of at
+*		least 16, best a multiple of 32. A slot holds a message of
+*		SlotSize - 8 bytes.
+* @param	ConsumerCpu is the CPU that receives, 0 or 1.
+*
+* @return
+*		- XST_SUCCESS if the queue is ready.
+*		- XST_INVALID_PARAM if the slots or the CPU are not valid.
+*
+* @note		Call it before any CPU uses the queue.
+*
+*****************************************************************************/
+s32 AmpMpsc_Initialize(AmpMpsc *QueuePtr, void *SlotsPtr, u32 NumSlots,
+		       u32 SlotSize, u32 ConsumerCpu)
+{
+	u32 Pos;
+
+	if ((SlotsPtr == NULL) || (NumSlots == 0U) ||
+	    ((NumSlots & (NumSlots - 1U)) != 0U) ||
+	    (SlotSize < (2U * AMP_MPSC_HDR_SIZE)) ||
+	    ((SlotSize % AMP_MPSC_HDR_SIZE) != 0U) ||
+	    (((UINTPTR)SlotsPtr % 4U) != 0U) ||
+	    (ConsumerCpu >= AMP_NUM_CPUS)) {
+		return XST_INVALID_PARAM;
+	}
+
+	QueuePtr->Slots = (u8 *)SlotsPtr;
+	QueuePtr->Mask = NumSlots - 1U;
+	QueuePtr->SlotSize = SlotSize;
+	QueuePtr->ConsumerCpu = ConsumerCpu;
+	QueuePtr->Head = 0U;
+	QueuePtr->Tail = 0U;
+	QueuePtr->Sleeping = 0U;
+
+	/* No slot is published for its first position */
+	for (Pos = 0U; Pos < NumSlots; Pos++) {
+		AMP_MPSC_SLOT(QueuePtr, Pos)->Seq = Pos - NumSlots + 1U;
+	}
+	dmb();
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Copies a message into the queue. Can be called by any number of
+* producers, on both CPUs and from handlers.
+*
+* @param	QueuePtr is a pointer to the queue.
+* @param	DataPtr is the message.
+* @param	Length is its size, at most the slot size less 8 bytes.
+*
+* @return
+*		- XST_SUCCESS if the message was queued.
+*		- XST_DEVICE_BUSY if the queue is full.
+*		- XST_INVALID_PARAM if the message does not fit a slot.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 AmpMpsc_Send(AmpMpsc *QueuePtr, const void *DataPtr, u32 Length)
+{
+	AmpMpsc_Msg Msg;
+
+	if (Length > (QueuePtr->SlotSize - AMP_MPSC_HDR_SIZE)) {
+		return XST_INVALID_PARAM;
+	}
+
+	Msg.DataPtr = DataPtr;
+	Msg.Length = Length;
+
+	return (AmpMpsc_SendBatch(QueuePtr, &Msg, 1U) == 1U) ?
+	       XST_SUCCESS : XST_DEVICE_BUSY;
+}
+
+/****************************************************************************/
+/**
+*
+* Copies a batch of messages into the queue, as many as there is room for,
+* with one claim of the head and one barrier for the whole batch. The
+* doorbell is raised once, if the consumer sleeps.
+*
+* @param	QueuePtr is a pointer to the queue.
+* @param	MsgPtr is the batch.
+* @param	Count is the number of messages in the batch.
+*
+* @return	The number of messages queued, from the start of the batch.
+*
+* @note		A message longer than the slot payload is cut.
+*
+*****************************************************************************/
+XIL_HOTPATH_TEXT
+u32 AmpMpsc_SendBatch(AmpMpsc *QueuePtr, const AmpMpsc_Msg *MsgPtr,
+		      u32 Count)
+{
+	AmpMpsc_Slot *SlotPtr;
+	u32 MaxLength = QueuePtr->SlotSize - AMP_MPSC_HDR_SIZE;
+	u32 Head;
+	u32 Free;
+	u32 Index;
+	u32 Length;
+
+	do {
+		Head = ldrex(&QueuePtr->Head);
+		Free = QueuePtr->Mask + 1U - (Head - QueuePtr->Tail);
+		if (Count > Free) {
+			Count = Free;
+		}
+		if (Count == 0U) {
+			clrex();
+			return 0U;
+		}
+	} while (strex(&QueuePtr->Head, Head + Count) != 0U);
+
+	/* The slots are written after the consumer freed them */
+	dmb();
+
+	for (Index = 0U; Index < Count; Index++) {
+		SlotPtr = AMP_MPSC_SLOT(QueuePtr, Head + Index);
+		Length = MsgPtr[Index].Length;
+		if (Length > MaxLength) {
+			Length = MaxLength;
+		}
+		SlotPtr->Length = Length;
+		Xil_MemCpy(AMP_MPSC_PAYLOAD(SlotPtr), MsgPtr[Index].DataPtr,
+			   Length);
+	}
+
+	/* The messages are seen before their slots are published */
+	dmb();
+	for (Index = 0U; Index < Count; Index++) {
+		AMP_MPSC_SLOT(QueuePtr, Head + Index)->Seq = Head + Index + 1U;
+	}
+
+	/* Published before Sleeping is looked at */
+	dmb();
+	if (QueuePtr->Sleeping != 0U) {
+		(void)Amp_Notify(QueuePtr->ConsumerCpu);
+	}
+
+	return Count;
+}
+
+/****************************************************************************/
+/**
+*
+* Hands the published messages to a handler in place, oldest first, up to a
+* count, then frees their slots with one write of the tail. Called by the
+* consumer only.
+*
+* @param	QueuePtr is a pointer to the queue.
+* @param	Handler is called for each message, it must not keep the
+*		pointer.
+* @param	CallBackRef is its first argument.
+* @param	MaxCount is the most messages handled.
+*
+* @return	The number of messages handled, 0 if none is published.
+*
+* @note		None.
+*
+*****************************************************************************/
+XIL_HOTPATH_TEXT
+u32 AmpMpsc_ReceiveBatch(AmpMpsc *QueuePtr, AmpMpsc_Handler Handler,
+			 void *CallBackRef, u32 MaxCount)
+{
+	AmpMpsc_Slot *SlotPtr;
+	u32 Tail = QueuePtr->Tail;
+	u32 Count;
+	u32 Index;
+
+	for (Count = 0U; Count < MaxCount; Count++) {
+		if (AMP_MPSC_SLOT(QueuePtr, Tail + Count)->Seq !=
+		    (Tail + Count + 1U)) {
+			break;
+		}
+	}
+	if (Count == 0U) {
+		return 0U;
+	}
+
+	/* The messages are read after their sequence words */
+	dmb();
+
+	for (Index = 0U; Index < Count; Index++) {
+		SlotPtr = AMP_MPSC_SLOT(QueuePtr, Tail + Index);
+		Handler(CallBackRef, AMP_MPSC_PAYLOAD(SlotPtr),
+			SlotPtr->Length);
+	}
+
+	/* The messages are read before the slots are given back */
+	dmb();
+	QueuePtr->Tail = Tail + Count;
+
+	return Count;
+}
+
+/****************************************************************************/
+/**
+*
+* Copies the oldest message out of the queue and frees its slot. Called by
+* the consumer only.
+*
+* @param	QueuePtr is a pointer to the queue.
+* @param	BufferPtr is where the message is copied.
+* @param	Size is the size of the buffer, a longer message is cut.
+*
+* @return	The length of the message, 0 if none is published.
+*
+* @note		An empty message cannot be told from an empty queue here,
+*		AmpMpsc_ReceiveBatch() can.
+*
+*****************************************************************************/
+u32 AmpMpsc_Receive(AmpMpsc *QueuePtr, void *BufferPtr, u32 Size)
+{
+	AmpMpsc_Slot *SlotPtr;
+	u32 Tail = QueuePtr->Tail;
+	u32 Length;
+
+	SlotPtr = AMP_MPSC_SLOT(QueuePtr, Tail);
+	if (SlotPtr->Seq != (Tail + 1U)) {
+		return 0U;
+	}
+	dmb();
+
+	Length = SlotPtr->Length;
+	if (Length > Size) {
+		Length = Size;
+	}
+	Xil_MemCpy(BufferPtr, AMP_MPSC_PAYLOAD(SlotPtr), Length);
+
+	dmb();
+	QueuePtr->Tail = Tail + 1U;
+
+	return Length;
+}
+
+/****************************************************************************/
+/**
+*
+* Sleeps in WFI until a message is published. The IRQ is masked from the
+* last look at the queue to the WFI, so that a doorbell raised in between
+* is still pending when the WFI is reached and ends it at once. Called by
+* the consumer only, on ConsumerCpu.
+*
+* @param	QueuePtr is a pointer to the queue.
+*
+* @return	None.
+*
+* @note		The notify software interrupt must be enabled on the
+*		consumer CPU, see Amp_Initialize(). Other interrupts end the
+*		wait too, it sleeps again if the queue is still empty.
+*
+*****************************************************************************/
+void AmpMpsc_Wait(AmpMpsc *QueuePtr)
+{
+	u32 Cpsr;
+	u32 Tail;
+
+	Cpsr = mfcpsr();
+	while (1) {
+		mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+
+		QueuePtr->Sleeping = 1U;
+		dmb();
+		Tail = QueuePtr->Tail;
+		if (AMP_MPSC_SLOT(QueuePtr, Tail)->Seq == (Tail + 1U)) {
+			break;
+		}
+		wfi();
+
+		QueuePtr->Sleeping = 0U;
+		/* The pending doorbell is taken here */
+		mtcpsr(Cpsr);
+	}
+	QueuePtr->Sleeping = 0U;
+	mtcpsr(Cpsr);
+}
@@ -0,0 +1,103 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file amp_mpsc.h
+*
+* Lock-free multiple producer, single consumer message queue between the
+* CPUs, for the data path of amp.h.
+*
+* The queue is a power-of-two number of fixed size slots in the memory both
+* CPUs see coherently through the SCU. Producers on either CPU, threads or
+* handlers, claim a run of slots by moving the head with LDREX/STREX, fill
+* them and publish each slot with its sequence word. The consumer takes the
+* published slots in order, in place, and frees a whole batch with one write
+* of the tail. The head and the tail each have their own cache line, and a
+* slot should be a whole number of cache lines so that producers filling
+* neighbouring slots do not share one.
+*
+* The consumer may sleep in AmpMpsc_Wait(), with WFI. A producer raises the
+* doorbell, the AMP_NOTIFY_SGI of Amp_Notify(), only when it finds the
+* consumer asleep after publishing, so that a busy consumer takes no
+* interrupt at all.
+*
+* A producer that is stopped between claiming and publishing holds up the
+* consumer at its slot, the other producers are not blocked.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef AMP_MPSC_H
+#define AMP_MPSC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "amp_queue.h"
+
+/************************** Constant Definitions ****************************/
+
+#define AMP_MPSC_HDR_SIZE	8U	/**< Sequence and length of a slot */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * A message of a batch to send.
+ */
+typedef struct {
+	const void *DataPtr;
+	u32 Length;
+} AmpMpsc_Msg;
+
+/**
+ * Called by AmpMpsc_ReceiveBatch() for each message, in place.
+ */
+typedef void (*AmpMpsc_Handler)(void *CallBackRef, const void *DataPtr,
+				u32 Length);
+
+/**
+ * A queue. The head and the tail are free running positions.
+ */
+typedef struct {
+	volatile u32 Head;	/**< Positions claimed by the producers */
+	u8 HeadPad[AMP_QUEUE_LINE - 4U];
+	volatile u32 Tail;	/**< Positions freed by the consumer */
+	volatile u32 Sleeping;	/**< The consumer waits for the doorbell */
+	u8 TailPad[AMP_QUEUE_LINE - 8U];
+	u8 *Slots;
+	u32 Mask;		/**< Number of slots less one */
+	u32 SlotSize;		/**< Bytes of a slot, header included */
+	u32 ConsumerCpu;	/**< CPU the doorbell is raised on */
+} __attribute__((aligned(32))) AmpMpsc;
+
+/************************** Function Prototypes *****************************/
+
+s32 AmpMpsc_Initialize(AmpMpsc *QueuePtr, void *SlotsPtr, u32 NumSlots,
+		       u32 SlotSize, u32 ConsumerCpu);
+s32 AmpMpsc_Send(AmpMpsc *QueuePtr, const void *DataPtr, u32 Length);
+u32 AmpMpsc_SendBatch(AmpMpsc *QueuePtr, const AmpMpsc_Msg *MsgPtr,
+		      u32 Count);
+u32 AmpMpsc_ReceiveBatch(AmpMpsc *QueuePtr, AmpMpsc_Handler Handler,
+			 void *CallBackRef, u32 MaxCount);
+u32 AmpMpsc_Receive(AmpMpsc *QueuePtr, void *BufferPtr, u32 Size);
+void AmpMpsc_Wait(AmpMpsc *QueuePtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AMP_MPSC_H */
@@ -0,0 +1,282 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file amp_queue.c
+*
+* Message queues between the CPUs. Refer to amp_queue.h for the layout.
+*
+* A slot starts with the length of its message, the payload follows. The
+* producer writes the slot, then the head after a dmb; the consumer reads
+* the head, the slot after a dmb, then frees the slot with the tail after
+* another dmb, so that the producer cannot overwrite it while it is read.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xstatus.h"
+#include "xpseudo_asm.h"
+#include "xil_mem.h"
+#include "amp_queue.h"
+
+/************************** Constant Definitions ****************************/
+
+/* Length word at the start of a slot */
+#define AMP_QUEUE_HDR_SIZE	4U
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/* Slot of a free running index */
+#define AMP_QUEUE_SLOT(QueuePtr, Index) \
+	((QueuePtr)->Slots + (((Index) & (QueuePtr)->Mask) * \
+			      (QueuePtr)->SlotSize))
+
+/************************** Function Prototypes *****************************/
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* Sets up an empty queue over its slots.
+*
+* @param	QueuePtr is a pointer to the queue.
+* @param	SlotsPtr is the memory of the slots, NumSlots * SlotSize
+*		bytes, word aligned.
+* @param	NumSlots is the number of slots, a power of two.
+* @param	SlotSize is the size of a slot, a multiple of 4 bytes of at
+*		least 8. A slot holds a message of SlotSize - 4 bytes.
+*
+* @return
+*		- XST_SUCCESS if the queue is ready.
+*		- XST_INVALID_PARAM if the slots are not valid.
+*
+* @note		Call it before either CPU uses the queue.
+*
+*****************************************************************************/
+s32 AmpQueue_Initialize(AmpQueue *QueuePtr, void *SlotsPtr, u32 NumSlots,
+			u32 SlotSize)
+{
+	if ((SlotsPtr == NULL) || (NumSlots == 0U) ||
+	    ((NumSlots & (NumSlots - 1U)) != 0U) ||
+	    (SlotSize < (2U * AMP_QUEUE_HDR_SIZE)) ||
+	    ((SlotSize % AMP_QUEUE_HDR_SIZE) != 0U) ||
+	    (((UINTPTR)SlotsPtr % AMP_QUEUE_HDR_SIZE) != 0U)) {
+		return XST_INVALID_PARAM;
+	}
+
+	QueuePtr->Slots = (u8 *)SlotsPtr;
+	QueuePtr->Mask = NumSlots - 1U;
+	QueuePtr->SlotSize = SlotSize;
+	QueuePtr->Head = 0U;
+	QueuePtr->Tail = 0U;
+	dmb();
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Copies a message into the queue. Called by the producer only.
+*
+* @param	QueuePtr is a pointer to the queue.
+* @param	DataPtr is the message.
+* @param	Length is its size, at most the slot size less 4 bytes.
+*
+* @return
+*		- XST_SUCCESS if the message was queued.
+*		- XST_DEVICE_BUSY if the queue is full.
+*		- XST_INVALID_PARAM if the message does not fit a slot.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 AmpQueue_Send(AmpQueue *QueuePtr, const void *DataPtr, u32 Length)
+{
+	void *SlotPtr;
+
+	if (Length > (QueuePtr->SlotSize - AMP_QUEUE_HDR_SIZE)) {
+		return XST_INVALID_PARAM;
+	}
+
+	SlotPtr = AmpQueue_Reserve(QueuePtr);
+	if (SlotPtr == NULL) {
+		return XST_DEVICE_BUSY;
+	}
+
+	Xil_MemCpy(SlotPtr, DataPtr, Length);
+	AmpQueue_Commit(QueuePtr, Length);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Copies the oldest message out of the queue and frees its slot. Called by
+* the consumer only.
+*
+* @param	QueuePtr is a pointer to the queue.
+* @param	BufferPtr is where the message is copied.
+* @param	Size is the size of the buffer, a longer message is cut.
+*
+* @return	The length of the message, 0 if the queue is empty.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 AmpQueue_Receive(AmpQueue *QueuePtr, void *BufferPtr, u32 Size)
+{
+	const void *SlotPtr;
+	u32 Length;
+
+	SlotPtr = AmpQueue_Peek(QueuePtr, &Length);
+	if (SlotPtr == NULL) {
+		return 0U;
+	}
+
+	if (Length > Size) {
+		Length = Size;
+	}
+	Xil_MemCpy(BufferPtr, SlotPtr, Length);
+	AmpQueue_Release(QueuePtr);
+
+	return Length;
+}
+
+/****************************************************************************/
+/**
+*
+* Gives the payload of the next free slot, for the producer to build a
+* message in place. The message is queued by AmpQueue_Commit().
+*
+* @param	QueuePtr is a pointer to the queue.
+*
+* @return	The payload, SlotSize - 4 bytes, or NULL if the queue is full.
+*
+* @note		None.
+*
+*****************************************************************************/
+void *AmpQueue_Reserve(AmpQueue *QueuePtr)
+{
+	u32 Head = QueuePtr->Head;
+
+	if ((Head - QueuePtr->Tail) > QueuePtr->Mask) {
+		return NULL;
+	}
+
+	/* The consumer is done with the slot before the tail moved */
+	dmb();
+
+	return AMP_QUEUE_SLOT(QueuePtr, Head) + AMP_QUEUE_HDR_SIZE;
+}
+
+/****************************************************************************/
+/**
+*
+* Queues the message built in the slot given by AmpQueue_Reserve().
+*
+* @param	QueuePtr is a pointer to the queue.
+* @param	Length is the size of the message, at most the slot size less
+*		4 bytes.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void AmpQueue_Commit(AmpQueue *QueuePtr, u32 Length)
+{
+	u32 Head = QueuePtr->Head;
+
+	*(u32 *)(void *)AMP_QUEUE_SLOT(QueuePtr, Head) = Length;
+
+	/* The message is seen before the head */
+	dmb();
+	QueuePtr->Head = Head + 1U;
+}
+
+/****************************************************************************/
+/**
+*
+* Gives the oldest message in place. Its slot stays owned by the consumer
+* until AmpQueue_Release().
+*
+* @param	QueuePtr is a pointer to the queue.
+* @param	LengthPtr is where the length of the message is stored.
+*
+* @return	The message, or NULL if the queue is empty.
+*
+* @note		None.
+*
+*****************************************************************************/
+const void *AmpQueue_Peek(AmpQueue *QueuePtr, u32 *LengthPtr)
+{
+	u32 Tail = QueuePtr->Tail;
+	const u8 *SlotPtr;
+
+	if (QueuePtr->Head == Tail) {
+		return NULL;
+	}
+
+	/* The message is read after the head */
+	dmb();
+
+	SlotPtr = AMP_QUEUE_SLOT(QueuePtr, Tail);
+	*LengthPtr = *(const u32 *)(const void *)SlotPtr;
+
+	return SlotPtr + AMP_QUEUE_HDR_SIZE;
+}
+
+/****************************************************************************/
+/**
+*
+* Frees the slot of the message given by AmpQueue_Peek().
+*
+* @param	QueuePtr is a pointer to the queue.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void AmpQueue_Release(AmpQueue *QueuePtr)
+{
+	/* The message is read before the slot is given back */
+	dmb();
+	QueuePtr->Tail = QueuePtr->Tail + 1U;
+}
+
+/****************************************************************************/
+/**
+*
+* Gives the number of messages in the queue. The other side may change it
+* right after, so that it is a lower bound for the consumer and an upper
+* bound for the producer.
+*
+* @param	QueuePtr is a pointer to the queue.
+*
+* @return	The number of messages.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 AmpQueue_Count(const AmpQueue *QueuePtr)
+{
+	return QueuePtr->Head - QueuePtr->Tail;
+}
@@ -0,0 +1,86 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file amp_queue.h
+*
+* Lock-free single producer, single consumer message queues between the two
+* CPUs.
+*
+* A queue is a power-of-two number of fixed size slots, each holding one
+* message of up to the slot size less its length word. The producer CPU
+* owns the head and the consumer CPU the tail, each on its own cache line,
+* and neither ever writes the index of the other. The cores are coherent
+* through the SCU, so a data memory barrier between the message and the
+* index is all the ordering needed.
+*
+* Messages are copied with AmpQueue_Send() and AmpQueue_Receive(), or built
+* and read in place with AmpQueue_Reserve() and AmpQueue_Commit() on the
+* producer side and AmpQueue_Peek() and AmpQueue_Release() on the consumer
+* side. The queue does not notify the consumer, the producer calls
+* Amp_Notify() when the consumer waits for interrupts.
+*
+* The queue and its slots are placed in the memory both CPUs see, with
+* AMP_SHARED.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef AMP_QUEUE_H
+#define AMP_QUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions ****************************/
+
+#define AMP_QUEUE_LINE		32U	/**< Cache line of the Cortex-A9 */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * A queue. The head and the tail are free running, their difference is the
+ * number of messages held.
+ */
+typedef struct {
+	volatile u32 Head;	/**< Slots written, by the producer */
+	u8 HeadPad[AMP_QUEUE_LINE - 4U];
+	volatile u32 Tail;	/**< Slots read, by the consumer */
+	u8 TailPad[AMP_QUEUE_LINE - 4U];
+	u8 *Slots;
+	u32 Mask;		/**< Number of slots less one */
+	u32 SlotSize;		/**< Bytes of a slot, length word included */
+} __attribute__((aligned(32))) AmpQueue;
+
+/************************** Function Prototypes *****************************/
+
+s32 AmpQueue_Initialize(AmpQueue *QueuePtr, void *SlotsPtr, u32 NumSlots,
+			u32 SlotSize);
+s32 AmpQueue_Send(AmpQueue *QueuePtr, const void *DataPtr, u32 Length);
+u32 AmpQueue_Receive(AmpQueue *QueuePtr, void *BufferPtr, u32 Size);
+void *AmpQueue_Reserve(AmpQueue *QueuePtr);
+void AmpQueue_Commit(AmpQueue *QueuePtr, u32 Length);
+const void *AmpQueue_Peek(AmpQueue *QueuePtr, u32 *LengthPtr);
+void AmpQueue_Release(AmpQueue *QueuePtr);
+u32 AmpQueue_Count(const AmpQueue *QueuePtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AMP_QUEUE_H */
@@ -0,0 +1,606 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file async_task.hpp
+*
+* C++20 coroutines on the interrupt driven drivers, for the straight-line
+* code of concurrent jobs in the main loop of a CPU.
+*
+* A job is a coroutine returning async::Task, started with async::Spawn()
+* and run by async::RunQueue::Run(). It waits with co_await on:
+*
+* - Uart::Read() and Uart::Write(), the interrupt mode XUartPs_Recv() and
+*   XUartPs_Send() of a UART. A read completes when its buffer is full, or
+*   with fewer bytes on the receive timeout of the UART.
+* - Dma::Copy(), a memory to memory copy on a channel of the PS DMA,
+*   submitted with XDmaPs_Submit() so that the copies of several jobs run
+*   back to back.
+* - SleepFor(), a timer of the timer wheel of timer_wheel.h.
+* - Yield(), which lets the other ready jobs run first.
+*
+* The completion interrupt of each of them puts the waiting job on the run
+* queue, a list linked through the awaiters themselves, which live in the
+* frame of the job, so that posting never allocates nor fails. The run loop
+* resumes the jobs of the queue in turn on the stack of main() and sleeps
+* in WFI when there are none.
+*
+* The frames of the jobs are blocks of the block pool allocator of
+* xil_blockpool.h, never the heap: a size class for them must be added with
+* Xil_BlockPoolAddClass(), and Spawn() fails when it has no block left. A
+* frame is given back when its job returns.
+*
+* @code
+*	async::Task Echo(async::Uart &Port)
+*	{
+*		u8 Buffer[64];
+*
+*		for (;;) {
+*			u32 Count = co_await Port.Read(Buffer, sizeof(Buffer));
+*			(void)co_await Port.Write(Buffer, Count);
+*		}
+*	}
+*
+*	(void)async::Spawn(Echo(Port));
+*	async::RunQueue::Run();
+* @endcode
+*
+* A Uart or a Dma sets the handler of its UART or DMA channel, which must
+* not be used for anything else, and has one read and one write, or any
+* number of copies, in progress at a time. The interrupts of the devices
+* must be connected and enabled by the application. A copy that faults is
+* reported to the fault handler of the XDmaPs instance only and its job
+* never resumes, as for xdmaps_memcpy.h. The run queue is that of one CPU;
+* these jobs are unrelated to the stackful tasks of coro.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef ASYNC_TASK_HPP
+#define ASYNC_TASK_HPP
+
+#if !defined(__cpp_impl_coroutine)
+#error "async_task.hpp needs C++20 coroutines"
+#endif
+
+/***************************** Include Files ********************************/
+
+#include <coroutine>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xil_assert.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xil_blockpool.h"
+#include "xuartps.h"
+#include "xdmaps.h"
+#include "xdmaps_memcpy.h"
+#include "timer_wheel.h"
+
+namespace async {
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define ASYNC_TASK_WFI()	__asm__ __volatile__ ("wfi" : : : "memory")
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Link of a suspended job on the run queue, with the result of what it
+ * waited for.
+ */
+struct Waiter {
+	Waiter *Next;
+	std::coroutine_handle<> Handle;
+	s32 Result;
+};
+
+/**
+ * The jobs ready to be resumed.
+ */
+class RunQueue {
+public:
+	/** Queues a job to be resumed, from any context of the CPU */
+	static void Post(Waiter *WaiterPtr) noexcept
+	{
+		u32 Cpsr = mfcpsr();
+
+		mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+		WaiterPtr->Next = nullptr;
+		if (Tail == nullptr) {
+			Head = WaiterPtr;
+		} else {
+			Tail->Next = WaiterPtr;
+		}
+		Tail = WaiterPtr;
+		mtcpsr(Cpsr);
+	}
+
+	/**
+	 * Resumes the jobs queued so far, each until it waits again, and
+	 * returns their number. Jobs they queue run on the next call.
+	 */
+	static u32 RunOnce() noexcept
+	{
+		Waiter *WaiterPtr;
+		Waiter *NextPtr;
+		u32 Count = 0U;
+		u32 Cpsr = mfcpsr();
+
+		mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+		WaiterPtr = Head;
+		Head = nullptr;
+		Tail = nullptr;
+		mtcpsr(Cpsr);
+
+		while (WaiterPtr != nullptr) {
+			/* The waiter is in the frame, which may be gone after */
+			NextPtr = WaiterPtr->Next;
+			WaiterPtr->Handle.resume();
+			WaiterPtr = NextPtr;
+			Count++;
+		}
+
+		return Count;
+	}
+
+	/** Runs the jobs forever, in WFI while none is ready */
+	[[noreturn]] static void Run() noexcept
+	{
+		u32 Cpsr;
+
+		for (;;) {
+			if (RunOnce() != 0U) {
+				continue;
+			}
+			/* A masked IRQ still ends the WFI, but only once checked */
+			Cpsr = mfcpsr();
+			mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+			if (Head == nullptr) {
+				ASYNC_TASK_WFI();
+			}
+			mtcpsr(Cpsr);
+		}
+	}
+
+private:
+	static inline Waiter *Head = nullptr;
+	static inline Waiter *Tail = nullptr;
+};
+
+/**
+ * A job, suspended until given to Spawn(). The frame is a block of the
+ * block pool; a Task without one is returned when the pool is empty.
+ */
+class Task {
+public:
+	struct promise_type {
+		Waiter Start;
+
+		Task get_return_object() noexcept
+		{
+			return Task(std::coroutine_handle<promise_type>::
+				    from_promise(*this));
+		}
+
+		static Task get_return_object_on_allocation_failure() noexcept
+		{
+			return Task();
+		}
+
+		std::suspend_always initial_suspend() noexcept
+		{
+			return {};
+		}
+
+		/* The frame goes back to the pool as the job returns */
+		std::suspend_never final_suspend() noexcept
+		{
+			return {};
+		}
+
+		void return_void() noexcept
+		{
+		}
+
+		void unhandled_exception() noexcept
+		{
+			Xil_AssertVoidAlways();
+		}
+
+		static void *operator new(std::size_t Size) noexcept
+		{
+			return Xil_BlockPoolAlloc(static_cast<u32>(Size));
+		}
+
+		static void operator delete(void *Ptr) noexcept
+		{
+			Xil_BlockPoolFree(Ptr);
+		}
+	};
+
+	Task() noexcept = default;
+
+	Task(Task &&Other) noexcept : Handle(Other.Handle)
+	{
+		Other.Handle = nullptr;
+	}
+
+	Task(const Task &) = delete;
+	Task &operator=(const Task &) = delete;
+
+	~Task()
+	{
+		/* A job never spawned */
+		if (Handle) {
+			Handle.destroy();
+		}
+	}
+
+private:
+	explicit Task(std::coroutine_handle<promise_type> FromPromise) noexcept
+		: Handle(FromPromise)
+	{
+	}
+
+	friend s32 Spawn(Task &&Job) noexcept;
+
+	std::coroutine_handle<promise_type> Handle;
+};
+
+/**
+ * Queues a job to run, XST_FAILURE if its frame could not be allocated.
+ */
+inline s32 Spawn(Task &&Job) noexcept
+{
+	std::coroutine_handle<Task::promise_type> Handle = Job.Handle;
+
+	if (!Handle) {
+		return XST_FAILURE;
+	}
+	Job.Handle = nullptr;
+	Handle.promise().Start.Handle = Handle;
+	RunQueue::Post(&Handle.promise().Start);
+
+	return XST_SUCCESS;
+}
+
+/**
+ * co_await Yield() runs the other ready jobs before this one goes on.
+ */
+class YieldAwaiter {
+public:
+	bool await_ready() const noexcept
+	{
+		return false;
+	}
+
+	void await_suspend(std::coroutine_handle<> Handle) noexcept
+	{
+		Wait.Handle = Handle;
+		RunQueue::Post(&Wait);
+	}
+
+	void await_resume() const noexcept
+	{
+	}
+
+private:
+	Waiter Wait = {};
+};
+
+inline YieldAwaiter Yield() noexcept
+{
+	return YieldAwaiter();
+}
+
+/**
+ * co_await SleepFor(Wheel, Us) resumes at least Us microseconds later.
+ */
+class SleepAwaiter {
+public:
+	SleepAwaiter(TimerWheel *WheelPtr, u64 Us) noexcept
+		: WheelPtr(WheelPtr), Us(Us)
+	{
+	}
+
+	bool await_ready() const noexcept
+	{
+		return Us == 0U;
+	}
+
+	void await_suspend(std::coroutine_handle<> Handle) noexcept
+	{
+		Wait.Handle = Handle;
+		TimerWheel_InitTimer(&Timer, &SleepAwaiter::Expired, this);
+		TimerWheel_Start(WheelPtr, &Timer, Us);
+	}
+
+	void await_resume() const noexcept
+	{
+	}
+
+private:
+	static void Expired(void *CallBackRef)
+	{
+		RunQueue::Post(&static_cast<SleepAwaiter *>(CallBackRef)->Wait);
+	}
+
+	TimerWheel *WheelPtr;
+	u64 Us;
+	TimerWheel_Timer Timer = {};
+	Waiter Wait = {};
+};
+
+inline SleepAwaiter SleepFor(TimerWheel *WheelPtr, u64 Us) noexcept
+{
+	return SleepAwaiter(WheelPtr, Us);
+}
+
+/**
+ * A UART in interrupt mode. The instance must be initialized, and its
+ * receive timeout set with XUartPs_SetRecvTimeout() for reads to complete
+ * before their buffer is full.
+ */
+class Uart {
+public:
+	explicit Uart(XUartPs *InstPtr) noexcept : InstPtr(InstPtr)
+	{
+		XUartPs_SetHandler(InstPtr, &Uart::Handler, this);
+	}
+
+	Uart(const Uart &) = delete;
+	Uart &operator=(const Uart &) = delete;
+
+	/** co_await gives the bytes received, NumBytes but on a timeout */
+	class ReadAwaiter {
+	public:
+		ReadAwaiter(Uart *OwnerPtr, u8 *BufferPtr, u32 NumBytes) noexcept
+			: OwnerPtr(OwnerPtr), BufferPtr(BufferPtr),
+			  NumBytes(NumBytes)
+		{
+		}
+
+		bool await_ready() const noexcept
+		{
+			return NumBytes == 0U;
+		}
+
+		bool await_suspend(std::coroutine_handle<> Handle) noexcept
+		{
+			u32 Cpsr = mfcpsr();
+			bool Suspend = true;
+
+			Wait.Handle = Handle;
+			/* No receive event may come in between */
+			mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+			OwnerPtr->RxWaiter = &Wait;
+			OwnerPtr->RxBufferPtr = BufferPtr;
+			Wait.Result = static_cast<s32>(
+				XUartPs_Recv(OwnerPtr->InstPtr, BufferPtr,
+					     NumBytes));
+			if (static_cast<u32>(Wait.Result) == NumBytes) {
+				/* All in the FIFO already */
+				OwnerPtr->RxWaiter = nullptr;
+				Suspend = false;
+			}
+			mtcpsr(Cpsr);
+
+			return Suspend;
+		}
+
+		u32 await_resume() const noexcept
+		{
+			return static_cast<u32>(Wait.Result);
+		}
+
+	private:
+		Uart *OwnerPtr;
+		u8 *BufferPtr;
+		u32 NumBytes;
+		Waiter Wait = {};
+	};
+
+	/** co_await gives the bytes sent, once the TX FIFO has taken them */
+	class WriteAwaiter {
+	public:
+		WriteAwaiter(Uart *OwnerPtr, const u8 *BufferPtr,
+			     u32 NumBytes) noexcept
+			: OwnerPtr(OwnerPtr), BufferPtr(BufferPtr),
+			  NumBytes(NumBytes)
+		{
+		}
+
+		bool await_ready() const noexcept
+		{
+			return NumBytes == 0U;
+		}
+
+		void await_suspend(std::coroutine_handle<> Handle) noexcept
+		{
+			u32 Cpsr = mfcpsr();
+
+			Wait.Handle = Handle;
+			mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+			OwnerPtr->TxWaiter = &Wait;
+			(void)XUartPs_Send(OwnerPtr->InstPtr,
+					   const_cast<u8 *>(BufferPtr), NumBytes);
+			mtcpsr(Cpsr);
+		}
+
+		u32 await_resume() const noexcept
+		{
+			return static_cast<u32>(Wait.Result);
+		}
+
+	private:
+		Uart *OwnerPtr;
+		const u8 *BufferPtr;
+		u32 NumBytes;
+		Waiter Wait = {};
+	};
+
+	ReadAwaiter Read(u8 *BufferPtr, u32 NumBytes) noexcept
+	{
+		return ReadAwaiter(this, BufferPtr, NumBytes);
+	}
+
+	WriteAwaiter Write(const u8 *BufferPtr, u32 NumBytes) noexcept
+	{
+		return WriteAwaiter(this, BufferPtr, NumBytes);
+	}
+
+private:
+	static void Handler(void *CallBackRef, u32 Event, u32 EventData)
+	{
+		Uart *UartPtr = static_cast<Uart *>(CallBackRef);
+		Waiter *WaiterPtr;
+
+		if ((Event == XUARTPS_EVENT_RECV_DATA) ||
+		    (Event == XUARTPS_EVENT_RECV_TOUT)) {
+			WaiterPtr = UartPtr->RxWaiter;
+			if (WaiterPtr == nullptr) {
+				return;
+			}
+			if (Event == XUARTPS_EVENT_RECV_TOUT) {
+				/* Stop filling the buffer handed back */
+				(void)XUartPs_Recv(UartPtr->InstPtr,
+						   UartPtr->RxBufferPtr, 0U);
+			}
+			UartPtr->RxWaiter = nullptr;
+		} else if (Event == XUARTPS_EVENT_SENT_DATA) {
+			WaiterPtr = UartPtr->TxWaiter;
+			if (WaiterPtr == nullptr) {
+				return;
+			}
+			UartPtr->TxWaiter = nullptr;
+		} else {
+			/* Errors leave the transfer running */
+			return;
+		}
+
+		WaiterPtr->Result = static_cast<s32>(EventData);
+		RunQueue::Post(WaiterPtr);
+	}
+
+	XUartPs *InstPtr;
+	Waiter *RxWaiter = nullptr;
+	u8 *RxBufferPtr = nullptr;
+	Waiter *TxWaiter = nullptr;
+};
+
+/**
+ * A channel of the PS DMA. The instance must be initialized and its done
+ * interrupt of the channel connected.
+ */
+class Dma {
+public:
+	Dma(XDmaPs *InstPtr, unsigned int Channel) noexcept
+		: InstPtr(InstPtr), Channel(Channel)
+	{
+		(void)XDmaPs_SetDoneHandler(InstPtr, Channel, &Dma::Done, this);
+	}
+
+	Dma(const Dma &) = delete;
+	Dma &operator=(const Dma &) = delete;
+
+	/**
+	 * co_await gives XST_SUCCESS once copied, or the error of
+	 * XDmaPs_Submit(). The command comes first, for the done handler to
+	 * find the awaiter from it.
+	 */
+	class CopyAwaiter {
+	public:
+		CopyAwaiter(Dma *OwnerPtr, void *DstPtr, const void *SrcPtr,
+			    u32 Count) noexcept
+			: OwnerPtr(OwnerPtr)
+		{
+			XDmaPs_ChanCtrl *ChanCtrl = &Cmd.ChanCtrl;
+
+			(void)std::memset(&Cmd, 0, sizeof(Cmd));
+			ChanCtrl->SrcBurstSize = XDMAPS_MEMCPY_BURST_SIZE;
+			ChanCtrl->SrcBurstLen = XDMAPS_MEMCPY_BURST_LEN;
+			ChanCtrl->SrcInc = 1U;
+			ChanCtrl->DstBurstSize = XDMAPS_MEMCPY_BURST_SIZE;
+			ChanCtrl->DstBurstLen = XDMAPS_MEMCPY_BURST_LEN;
+			ChanCtrl->DstInc = 1U;
+			Cmd.BD.SrcAddr = static_cast<u32>(
+				reinterpret_cast<UINTPTR>(SrcPtr));
+			Cmd.BD.DstAddr = static_cast<u32>(
+				reinterpret_cast<UINTPTR>(DstPtr));
+			Cmd.BD.Length = Count;
+		}
+
+		bool await_ready() const noexcept
+		{
+			return Cmd.BD.Length == 0U;
+		}
+
+		bool await_suspend(std::coroutine_handle<> Handle) noexcept
+		{
+			Wait.Handle = Handle;
+			Wait.Result = XDmaPs_Submit(OwnerPtr->InstPtr,
+						    OwnerPtr->Channel, &Cmd);
+
+			return Wait.Result == XST_SUCCESS;
+		}
+
+		s32 await_resume() const noexcept
+		{
+			return Wait.Result;
+		}
+
+	private:
+		friend class Dma;
+
+		XDmaPs_Cmd Cmd;
+		Dma *OwnerPtr;
+		Waiter Wait = {};
+	};
+
+	CopyAwaiter Copy(void *DstPtr, const void *SrcPtr, u32 Count) noexcept
+	{
+		return CopyAwaiter(this, DstPtr, SrcPtr, Count);
+	}
+
+private:
+	static void Done(unsigned int Channel, XDmaPs_Cmd *DmaCmd,
+			 void *CallbackRef)
+	{
+		CopyAwaiter *AwaiterPtr = reinterpret_cast<CopyAwaiter *>(DmaCmd);
+
+		(void)Channel;
+		(void)CallbackRef;
+
+		/* A command started from the queue is not done yet */
+		if (DmaCmd->DmaStatus == XST_DEVICE_BUSY) {
+			return;
+		}
+		AwaiterPtr->Wait.Result = (DmaCmd->DmaStatus == 0) ?
+					  XST_SUCCESS : XST_FAILURE;
+		RunQueue::Post(&AwaiterPtr->Wait);
+	}
+
+	XDmaPs *InstPtr;
+	unsigned int Channel;
+};
+
+static_assert(std::is_standard_layout_v<Dma::CopyAwaiter>,
+	      "the command must be at the address of the awaiter");
+
+} /* namespace async */
+
+#endif /* ASYNC_TASK_HPP */
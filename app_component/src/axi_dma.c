@@ -0,0 +1,768 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file axi_dma.c
+*
+* Scatter-gather streaming on an AXI DMA. Refer to axi_dma.h for how it is
+* used.
+*
+* The descriptors of a channel are chained in a circle once, at
+* initialization. Head and Tail of a channel are free running descriptor
+* counts, the buffers between them owning their descriptor in that order.
+* A new descriptor is filled with its completion bit clear, since the
+* engine halts on a completed one, and the tail pointer is moved over it:
+* the engine fetches up to the tail pointer and goes idle there, and a new
+* tail pointer starts it again. The rings are changed with the interrupts
+* masked, completions are taken in the interrupt handler of the channel, in
+* order, up to the first descriptor not completed.
+*
+* A slot queued by AxiDma_SendBuf() or AxiDma_RecvBuf() keeps its
+* Xil_DmaBuf next to its buffer, and its completion or its flush hands the
+* buffer back to the CPU through Xil_DmaBufFromDevice() for the bytes the
+* engine wrote, instead of the invalidation of the whole buffer.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Added AxiDma_SendBuf() and AxiDma_RecvBuf()
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xparameters.h"
+
+#ifdef XPAR_XAXIDMA_0_BASEADDR
+
+#include <string.h>
+#include "xstatus.h"
+#include "xil_assert.h"
+#include "xil_io.h"
+#include "xil_cache.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xinterrupt_wrap.h"
+#include "axi_dma.h"
+
+/************************** Constant Definitions ****************************/
+
+/* Channel registers, from the MM2S or the S2MM offset */
+#define AXI_DMA_CR		0x00U	/* DMACR */
+#define AXI_DMA_SR		0x04U	/* DMASR */
+#define AXI_DMA_CURDESC		0x08U
+#define AXI_DMA_CURDESC_MSB	0x0CU
+#define AXI_DMA_TAILDESC	0x10U
+#define AXI_DMA_TAILDESC_MSB	0x14U
+
+#define AXI_DMA_MM2S_OFFSET	0x00U
+#define AXI_DMA_S2MM_OFFSET	0x30U
+
+#define AXI_DMA_CR_RS		0x00000001U	/* Run */
+#define AXI_DMA_CR_RESET	0x00000004U	/* Soft reset, both channels */
+#define AXI_DMA_CR_IOC_IRQ_EN	0x00001000U
+#define AXI_DMA_CR_DLY_IRQ_EN	0x00002000U
+#define AXI_DMA_CR_ERR_IRQ_EN	0x00004000U
+#define AXI_DMA_CR_THRESH_SHIFT	16U		/* IRQThreshold */
+#define AXI_DMA_CR_THRESH_MASK	0x00FF0000U
+#define AXI_DMA_CR_DELAY_SHIFT	24U		/* IRQDelay */
+#define AXI_DMA_CR_DELAY_MASK	0xFF000000U
+
+#define AXI_DMA_SR_HALTED	0x00000001U
+#define AXI_DMA_SR_IOC_IRQ	0x00001000U
+#define AXI_DMA_SR_DLY_IRQ	0x00002000U
+#define AXI_DMA_SR_ERR_IRQ	0x00004000U
+#define AXI_DMA_SR_IRQ_ALL	(AXI_DMA_SR_IOC_IRQ | AXI_DMA_SR_DLY_IRQ | \
+				 AXI_DMA_SR_ERR_IRQ)
+
+#define AXI_DMA_MAX_COUNT	0xFFU	/* IRQThreshold and IRQDelay */
+#define AXI_DMA_DELAY_CYCLES	125U	/* SG clocks per IRQDelay unit */
+
+/* Descriptor */
+#define AXI_DMA_BD_TXSOF	0x08000000U	/* Control, first of a packet */
+#define AXI_DMA_BD_TXEOF	0x04000000U	/* Control, last of a packet */
+#define AXI_DMA_BD_CMPLT	0x80000000U	/* Status */
+#define AXI_DMA_BD_DECERR	0x40000000U
+#define AXI_DMA_BD_SLVERR	0x20000000U
+#define AXI_DMA_BD_INTERR	0x10000000U
+#define AXI_DMA_BD_RXSOF	0x08000000U
+#define AXI_DMA_BD_RXEOF	0x04000000U
+#define AXI_DMA_BD_ERRORS	(AXI_DMA_BD_DECERR | AXI_DMA_BD_SLVERR | \
+				 AXI_DMA_BD_INTERR)
+#define AXI_DMA_BD_ALIGN	64U
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define AxiDma_Read(DmaPtr, ChanPtr, Reg) \
+	Xil_In32((DmaPtr)->BaseAddress + (ChanPtr)->Offset + (Reg))
+#define AxiDma_Write(DmaPtr, ChanPtr, Reg, Data) \
+	Xil_Out32((DmaPtr)->BaseAddress + (ChanPtr)->Offset + (Reg), (Data))
+
+/************************** Function Prototypes *****************************/
+
+static void AxiDma_Chan_Start(AxiDma *DmaPtr, AxiDma_Chan *ChanPtr);
+static s32 AxiDma_Chan_Submit(AxiDma *DmaPtr, AxiDma_Chan *ChanPtr,
+			      u8 *BufferPtr, Xil_DmaBuf *DmaBufPtr,
+			      u32 Control);
+static void AxiDma_Chan_Complete(AxiDma *DmaPtr, AxiDma_Chan *ChanPtr);
+static void AxiDma_Event(AxiDma *DmaPtr, u32 Event, u8 *BufferPtr,
+			 u32 Length);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* Resets the engine, sets up the descriptor rings in the DMA arena and
+* connects the interrupts of both channels. The channels are left halted,
+* AxiDma_Start() runs them.
+*
+* @param	DmaPtr is a pointer to the engine.
+* @param	BaseAddress is the base address of the registers of the
+*		AXI DMA.
+* @param	TxIntrId is the interrupt of MM2S, encoded as the IntrId of a
+*		driver configuration.
+* @param	RxIntrId is the interrupt of S2MM, likewise.
+* @param	IntrParent is the base address of the interrupt controller.
+*
+* @return
+*		- XST_SUCCESS if the engine is ready.
+*		- XST_NOT_ENABLED if the DMA arena is not mapped.
+*		- XST_BUFFER_TOO_SMALL if the arena has no room for the
+*		  descriptors.
+*		- XST_FAILURE if the interrupts could not be connected.
+*
+*****************************************************************************/
+s32 AxiDma_Initialize(AxiDma *DmaPtr, UINTPTR BaseAddress, u32 TxIntrId,
+		      u32 RxIntrId, UINTPTR IntrParent)
+{
+	AxiDma_Chan *ChanPtr;
+	UINTPTR MemAddr;
+	u32 Chan;
+	u32 Slot;
+	s32 Status;
+
+	Xil_AssertNonvoid(DmaPtr != NULL);
+
+	(void)memset(DmaPtr, 0, sizeof(*DmaPtr));
+	DmaPtr->BaseAddress = BaseAddress;
+
+	/* One block, the descriptors rounded up to their 16 words inside it */
+	Status = Xil_DmaPoolCreate(&DmaPtr->Pool, sizeof(AxiDma_Mem) +
+				   AXI_DMA_BD_ALIGN, 1U);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+	MemAddr = (UINTPTR)Xil_DmaPoolAlloc(&DmaPtr->Pool);
+	MemAddr = (MemAddr + AXI_DMA_BD_ALIGN - 1U) &
+		  ~((UINTPTR)AXI_DMA_BD_ALIGN - 1U);
+	DmaPtr->MemPtr = (AxiDma_Mem *)MemAddr;
+	(void)memset(DmaPtr->MemPtr, 0, sizeof(AxiDma_Mem));
+
+	for (Chan = 0U; Chan < AXI_DMA_NUM_CHANS; Chan++) {
+		ChanPtr = &DmaPtr->Chan[Chan];
+		ChanPtr->DmaPtr = DmaPtr;
+		ChanPtr->BdPtr = DmaPtr->MemPtr->Bd[Chan];
+		ChanPtr->Offset = (Chan == AXI_DMA_MM2S) ?
+				  AXI_DMA_MM2S_OFFSET : AXI_DMA_S2MM_OFFSET;
+		/* Interrupt on every completion and on errors */
+		ChanPtr->Control = AXI_DMA_CR_IOC_IRQ_EN |
+				   AXI_DMA_CR_ERR_IRQ_EN |
+				   (1U << AXI_DMA_CR_THRESH_SHIFT);
+		for (Slot = 0U; Slot < AXI_DMA_BDS; Slot++) {
+			ChanPtr->BdPtr[Slot].Next = (u32)(UINTPTR)
+				&ChanPtr->BdPtr[(Slot + 1U) % AXI_DMA_BDS];
+		}
+	}
+
+	AxiDma_Reset(DmaPtr);
+
+	Status = XSetupInterruptSystem(&DmaPtr->Chan[AXI_DMA_MM2S],
+				       &AxiDma_InterruptHandler, TxIntrId,
+				       IntrParent, XINTERRUPT_DEFAULT_PRIORITY);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	return XSetupInterruptSystem(&DmaPtr->Chan[AXI_DMA_S2MM],
+				     &AxiDma_InterruptHandler, RxIntrId,
+				     IntrParent, XINTERRUPT_DEFAULT_PRIORITY);
+}
+
+/****************************************************************************/
+/**
+*
+* Sets the event handler of the engine.
+*
+* @param	DmaPtr is a pointer to the engine.
+* @param	Handler is the handler, called from the interrupt handlers.
+* @param	CallBackRef is passed to the handler.
+*
+* @return	None.
+*
+*****************************************************************************/
+void AxiDma_SetHandler(AxiDma *DmaPtr, AxiDma_Handler Handler,
+		       void *CallBackRef)
+{
+	Xil_AssertVoid(DmaPtr != NULL);
+
+	DmaPtr->Handler = Handler;
+	DmaPtr->CallBackRef = CallBackRef;
+}
+
+/****************************************************************************/
+/**
+*
+* Sets the interrupt coalescing of a channel: it interrupts once Count
+* descriptors have completed, or MaxUs after a completion when fewer have.
+* It may be called while the channel runs.
+*
+* @param	DmaPtr is a pointer to the engine.
+* @param	Chan is AXI_DMA_MM2S or AXI_DMA_S2MM.
+* @param	Count is the number of completions per interrupt, 1 to 255.
+* @param	MaxUs is the longest a completion waits for its interrupt, in
+*		microseconds, 0 for no limit. It is counted in units of
+*		125 cycles of AXI_DMA_SG_CLK_HZ, up to 255 of them, and
+*		rounded up.
+*
+* @return
+*		- XST_SUCCESS if the coalescing is set.
+*		- XST_INVALID_PARAM for a bad channel, count or delay.
+*
+* @note		With Count above 1 and no delay, the last completions of a
+*		burst wait for the next ones.
+*
+*****************************************************************************/
+s32 AxiDma_SetCoalesce(AxiDma *DmaPtr, u32 Chan, u32 Count, u32 MaxUs)
+{
+	AxiDma_Chan *ChanPtr;
+	u64 Units;
+	u32 Control;
+	u32 Cpsr;
+
+	Xil_AssertNonvoid(DmaPtr != NULL);
+
+	Units = (((u64)MaxUs * AXI_DMA_SG_CLK_HZ) +
+		 ((u64)AXI_DMA_DELAY_CYCLES * 1000000U) - 1U) /
+		((u64)AXI_DMA_DELAY_CYCLES * 1000000U);
+	if ((Chan >= AXI_DMA_NUM_CHANS) || (Count == 0U) ||
+	    (Count > AXI_DMA_MAX_COUNT) || (Units > AXI_DMA_MAX_COUNT)) {
+		return XST_INVALID_PARAM;
+	}
+	ChanPtr = &DmaPtr->Chan[Chan];
+
+	Control = ChanPtr->Control & ~(AXI_DMA_CR_THRESH_MASK |
+				       AXI_DMA_CR_DELAY_MASK |
+				       AXI_DMA_CR_DLY_IRQ_EN);
+	Control |= Count << AXI_DMA_CR_THRESH_SHIFT;
+	if (Units != 0U) {
+		Control |= ((u32)Units << AXI_DMA_CR_DELAY_SHIFT) |
+			   AXI_DMA_CR_DLY_IRQ_EN;
+	}
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	ChanPtr->Control = Control;
+	if (ChanPtr->Running != 0U) {
+		AxiDma_Write(DmaPtr, ChanPtr, AXI_DMA_CR,
+			     Control | AXI_DMA_CR_RS);
+	}
+	mtcpsr(Cpsr);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Runs both channels from their oldest queued descriptor. A channel halted
+* by an error must be reset first, with AxiDma_Reset().
+*
+* @param	DmaPtr is a pointer to the engine.
+*
+* @return	None.
+*
+*****************************************************************************/
+void AxiDma_Start(AxiDma *DmaPtr)
+{
+	u32 Cpsr;
+
+	Xil_AssertVoid(DmaPtr != NULL);
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	AxiDma_Chan_Start(DmaPtr, &DmaPtr->Chan[AXI_DMA_MM2S]);
+	AxiDma_Chan_Start(DmaPtr, &DmaPtr->Chan[AXI_DMA_S2MM]);
+	mtcpsr(Cpsr);
+}
+
+/****************************************************************************/
+/**
+*
+* Resets the engine, which halts both channels, and hands the buffers still
+* queued back with AXI_DMA_EVENT_FLUSHED, in the order they were queued.
+* The coalescing of the channels is kept for the next AxiDma_Start().
+*
+* @param	DmaPtr is a pointer to the engine.
+*
+* @return	None.
+*
+* @note		A stream packet cut by the reset is lost in the PL.
+*
+*****************************************************************************/
+void AxiDma_Reset(AxiDma *DmaPtr)
+{
+	AxiDma_Chan *ChanPtr;
+	u32 Chan;
+	u32 Slot;
+	u32 Cpsr;
+
+	Xil_AssertVoid(DmaPtr != NULL);
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+
+	ChanPtr = &DmaPtr->Chan[AXI_DMA_MM2S];
+	AxiDma_Write(DmaPtr, ChanPtr, AXI_DMA_CR, AXI_DMA_CR_RESET);
+	while ((AxiDma_Read(DmaPtr, ChanPtr, AXI_DMA_CR) &
+		AXI_DMA_CR_RESET) != 0U) {
+		;
+	}
+
+	for (Chan = 0U; Chan < AXI_DMA_NUM_CHANS; Chan++) {
+		ChanPtr = &DmaPtr->Chan[Chan];
+		ChanPtr->Running = 0U;
+		while (ChanPtr->Tail != ChanPtr->Head) {
+			Slot = ChanPtr->Tail % AXI_DMA_BDS;
+			ChanPtr->BdPtr[Slot].Status = 0U;
+			ChanPtr->Tail++;
+			if (ChanPtr->DmaBufPtr[Slot] != NULL) {
+				/* It may have written any of it */
+				(void)Xil_DmaBufFromDevice(
+					ChanPtr->DmaBufPtr[Slot], 0U,
+					ChanPtr->DmaBufPtr[Slot]->Size);
+			}
+			AxiDma_Event(DmaPtr, AXI_DMA_EVENT_FLUSHED,
+				     ChanPtr->BufferPtr[Slot], 0U);
+		}
+	}
+
+	mtcpsr(Cpsr);
+}
+
+/****************************************************************************/
+/**
+*
+* Queues a buffer to send as one packet of the stream, from its memory. The
+* buffer is handed back with AXI_DMA_EVENT_SENT.
+*
+* @param	DmaPtr is a pointer to the engine.
+* @param	BufferPtr is the data.
+* @param	Length is the number of bytes, 1 to AXI_DMA_MAX_XFER.
+*
+* @return
+*		- XST_SUCCESS if the buffer is queued.
+*		- XST_INVALID_PARAM for a bad length.
+*		- XST_DEVICE_BUSY if AXI_DMA_BDS buffers are queued.
+*
+*****************************************************************************/
+s32 AxiDma_Send(AxiDma *DmaPtr, u8 *BufferPtr, u32 Length)
+{
+	Xil_AssertNonvoid((DmaPtr != NULL) && (BufferPtr != NULL));
+
+	if ((Length == 0U) || (Length > AXI_DMA_MAX_XFER)) {
+		return XST_INVALID_PARAM;
+	}
+
+	if (Xil_DmaArenaContains((UINTPTR)BufferPtr, Length) == 0U) {
+		Xil_DCacheFlushRange((INTPTR)BufferPtr, Length);
+	}
+
+	return AxiDma_Chan_Submit(DmaPtr, &DmaPtr->Chan[AXI_DMA_MM2S],
+				  BufferPtr, NULL,
+				  Length | AXI_DMA_BD_TXSOF | AXI_DMA_BD_TXEOF);
+}
+
+/****************************************************************************/
+/**
+*
+* Queues a buffer to receive from the stream into. The buffer is handed
+* back with AXI_DMA_EVENT_RECV once a packet ends in it, or with
+* AXI_DMA_EVENT_RECV_PART once it is full and the packet goes on.
+*
+* @param	DmaPtr is a pointer to the engine.
+* @param	BufferPtr is the buffer, aligned to a cache line.
+* @param	Length is its size, 1 to AXI_DMA_MAX_XFER.
+*
+* @return
+*		- XST_SUCCESS if the buffer is queued.
+*		- XST_INVALID_PARAM for a bad length.
+*		- XST_DEVICE_BUSY if AXI_DMA_BDS buffers are queued.
+*
+*****************************************************************************/
+s32 AxiDma_Recv(AxiDma *DmaPtr, u8 *BufferPtr, u32 Length)
+{
+	Xil_AssertNonvoid((DmaPtr != NULL) && (BufferPtr != NULL));
+
+	if ((Length == 0U) || (Length > AXI_DMA_MAX_XFER)) {
+		return XST_INVALID_PARAM;
+	}
+
+	if (Xil_DmaArenaContains((UINTPTR)BufferPtr, Length) == 0U) {
+		/* No dirty line may be evicted over what the engine writes */
+		Xil_DCacheInvalidateRange((INTPTR)BufferPtr, Length);
+	}
+
+	return AxiDma_Chan_Submit(DmaPtr, &DmaPtr->Chan[AXI_DMA_S2MM],
+				  BufferPtr, NULL, Length);
+}
+
+/****************************************************************************/
+/**
+*
+* Queues bytes of a tracked buffer to send as one packet of the stream,
+* like AxiDma_Send(). Only the lines of the buffer the CPU dirtied since it
+* was last handed to a master are cleaned, none if it is still clean.
+*
+* @param	DmaPtr is a pointer to the engine.
+* @param	BufPtr is the buffer, from Xil_DmaBufInit().
+* @param	Offset is the offset of the first byte to send.
+* @param	Length is the number of bytes, 1 to AXI_DMA_MAX_XFER.
+*
+* @return
+*		- XST_SUCCESS if the bytes are queued.
+*		- XST_INVALID_PARAM for bytes not in the buffer or a bad
+*		  length.
+*		- XST_DEVICE_BUSY if AXI_DMA_BDS buffers are queued or a
+*		  master writes into the buffer.
+*
+*****************************************************************************/
+s32 AxiDma_SendBuf(AxiDma *DmaPtr, Xil_DmaBuf *BufPtr, u32 Offset,
+		   u32 Length)
+{
+	s32 Status;
+
+	Xil_AssertNonvoid((DmaPtr != NULL) && (BufPtr != NULL));
+
+	if ((Length == 0U) || (Length > AXI_DMA_MAX_XFER) ||
+	    (Offset > BufPtr->Size) || (Length > (BufPtr->Size - Offset))) {
+		return XST_INVALID_PARAM;
+	}
+
+	Status = Xil_DmaBufToDevice(BufPtr, XIL_DMABUF_TO_DEVICE);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	return AxiDma_Chan_Submit(DmaPtr, &DmaPtr->Chan[AXI_DMA_MM2S],
+				  (u8 *)(BufPtr->Addr + Offset), NULL,
+				  Length | AXI_DMA_BD_TXSOF | AXI_DMA_BD_TXEOF);
+}
+
+/****************************************************************************/
+/**
+*
+* Queues a whole tracked buffer to receive from the stream into, like
+* AxiDma_Recv(). The dirty lines of the buffer are cleaned, and the buffer
+* is the engine's until its event: only the bytes the engine wrote are
+* invalidated then, before the handler is called.
+*
+* @param	DmaPtr is a pointer to the engine.
+* @param	BufPtr is the buffer, from Xil_DmaBufInit(), of at most
+*		AXI_DMA_MAX_XFER bytes.
+*
+* @return
+*		- XST_SUCCESS if the buffer is queued.
+*		- XST_INVALID_PARAM if the buffer is too long.
+*		- XST_DEVICE_BUSY if AXI_DMA_BDS buffers are queued or the
+*		  buffer is queued already.
+*
+*****************************************************************************/
+s32 AxiDma_RecvBuf(AxiDma *DmaPtr, Xil_DmaBuf *BufPtr)
+{
+	AxiDma_Chan *ChanPtr;
+	s32 Status;
+
+	Xil_AssertNonvoid((DmaPtr != NULL) && (BufPtr != NULL));
+
+	if (BufPtr->Size > AXI_DMA_MAX_XFER) {
+		return XST_INVALID_PARAM;
+	}
+
+	ChanPtr = &DmaPtr->Chan[AXI_DMA_S2MM];
+	if ((ChanPtr->Head - ChanPtr->Tail) >= AXI_DMA_BDS) {
+		/* Checked again by the submit, not to clean for nothing */
+		return XST_DEVICE_BUSY;
+	}
+
+	Status = Xil_DmaBufToDevice(BufPtr, XIL_DMABUF_FROM_DEVICE);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	Status = AxiDma_Chan_Submit(DmaPtr, ChanPtr, (u8 *)BufPtr->Addr,
+				    BufPtr, BufPtr->Size);
+	if (Status != XST_SUCCESS) {
+		(void)Xil_DmaBufFromDevice(BufPtr, 0U, 0U);
+	}
+
+	return Status;
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the number of buffers a channel can still queue.
+*
+* @param	DmaPtr is a pointer to the engine.
+* @param	Chan is AXI_DMA_MM2S or AXI_DMA_S2MM.
+*
+* @return	The number of free descriptors of the channel.
+*
+*****************************************************************************/
+u32 AxiDma_Free(const AxiDma *DmaPtr, u32 Chan)
+{
+	const AxiDma_Chan *ChanPtr;
+
+	Xil_AssertNonvoid((DmaPtr != NULL) && (Chan < AXI_DMA_NUM_CHANS));
+
+	ChanPtr = &DmaPtr->Chan[Chan];
+
+	return AXI_DMA_BDS - (ChanPtr->Head - ChanPtr->Tail);
+}
+
+/****************************************************************************/
+/**
+*
+* Takes a consistent snapshot of the counts of the engine.
+*
+* @param	DmaPtr is a pointer to the engine.
+* @param	StatsPtr receives the counts.
+*
+* @return	None.
+*
+*****************************************************************************/
+void AxiDma_GetStats(const AxiDma *DmaPtr, AxiDma_Stats *StatsPtr)
+{
+	u32 Cpsr;
+
+	Xil_AssertVoid((DmaPtr != NULL) && (StatsPtr != NULL));
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	*StatsPtr = DmaPtr->Stats;
+	mtcpsr(Cpsr);
+}
+
+/****************************************************************************/
+/**
+*
+* Interrupt handler of a channel: its completions, then its error if it
+* halted on one.
+*
+* @param	InstancePtr is the AxiDma_Chan of the channel.
+*
+* @return	None.
+*
+*****************************************************************************/
+void AxiDma_InterruptHandler(void *InstancePtr)
+{
+	AxiDma_Chan *ChanPtr = (AxiDma_Chan *)InstancePtr;
+	AxiDma *DmaPtr = (AxiDma *)ChanPtr->DmaPtr;
+	u32 Status;
+
+	Status = AxiDma_Read(DmaPtr, ChanPtr, AXI_DMA_SR);
+	AxiDma_Write(DmaPtr, ChanPtr, AXI_DMA_SR, Status & AXI_DMA_SR_IRQ_ALL);
+	DmaPtr->Stats.Interrupts++;
+
+	AxiDma_Chan_Complete(DmaPtr, ChanPtr);
+
+	if ((Status & AXI_DMA_SR_ERR_IRQ) != 0U) {
+		ChanPtr->Running = 0U;
+		DmaPtr->Stats.Errors++;
+		AxiDma_Event(DmaPtr, AXI_DMA_EVENT_ERROR, NULL, Status);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Runs a halted channel from its oldest queued descriptor, and up to its
+* newest one if any. Called with the interrupts masked.
+*
+* @param	DmaPtr is a pointer to the engine.
+* @param	ChanPtr is the channel.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void AxiDma_Chan_Start(AxiDma *DmaPtr, AxiDma_Chan *ChanPtr)
+{
+	if (ChanPtr->Running != 0U) {
+		return;
+	}
+
+	/* CURDESC is only written while the channel is halted */
+	AxiDma_Write(DmaPtr, ChanPtr, AXI_DMA_CURDESC, (u32)(UINTPTR)
+		     &ChanPtr->BdPtr[ChanPtr->Tail % AXI_DMA_BDS]);
+	AxiDma_Write(DmaPtr, ChanPtr, AXI_DMA_CURDESC_MSB, 0U);
+	AxiDma_Write(DmaPtr, ChanPtr, AXI_DMA_CR,
+		     ChanPtr->Control | AXI_DMA_CR_RS);
+	while ((AxiDma_Read(DmaPtr, ChanPtr, AXI_DMA_SR) &
+		AXI_DMA_SR_HALTED) != 0U) {
+		;
+	}
+	ChanPtr->Running = 1U;
+
+	if (ChanPtr->Head != ChanPtr->Tail) {
+		AxiDma_Write(DmaPtr, ChanPtr, AXI_DMA_TAILDESC_MSB, 0U);
+		AxiDma_Write(DmaPtr, ChanPtr, AXI_DMA_TAILDESC, (u32)(UINTPTR)
+			     &ChanPtr->BdPtr[(ChanPtr->Head - 1U) %
+					     AXI_DMA_BDS]);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Fills the next descriptor of a channel and, if the channel runs, moves
+* its tail pointer over it.
+*
+* @param	DmaPtr is a pointer to the engine.
+* @param	ChanPtr is the channel.
+* @param	BufferPtr is the buffer.
+* @param	Control is the control word of the descriptor, with the
+*		length of the buffer.
+*
+* @return	XST_SUCCESS, or XST_DEVICE_BUSY if the ring is full.
+*
+*****************************************************************************/
+static s32 AxiDma_Chan_Submit(AxiDma *DmaPtr, AxiDma_Chan *ChanPtr,
+			      u8 *BufferPtr, Xil_DmaBuf *DmaBufPtr,
+			      u32 Control)
+{
+	AxiDma_Bd *BdPtr;
+	u32 Slot;
+	u32 Cpsr;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+
+	if ((ChanPtr->Head - ChanPtr->Tail) >= AXI_DMA_BDS) {
+		mtcpsr(Cpsr);
+		return XST_DEVICE_BUSY;
+	}
+
+	Slot = ChanPtr->Head % AXI_DMA_BDS;
+	BdPtr = &ChanPtr->BdPtr[Slot];
+	BdPtr->Buffer = (u32)(UINTPTR)BufferPtr;
+	BdPtr->BufferMsb = 0U;
+	BdPtr->Control = Control;
+	BdPtr->Status = 0U;
+	ChanPtr->BufferPtr[Slot] = BufferPtr;
+	ChanPtr->DmaBufPtr[Slot] = DmaBufPtr;
+	ChanPtr->Head++;
+
+	if (ChanPtr->Running != 0U) {
+		/* The descriptor lands in the arena before the engine looks */
+		dsb();
+		AxiDma_Write(DmaPtr, ChanPtr, AXI_DMA_TAILDESC,
+			     (u32)(UINTPTR)BdPtr);
+	}
+
+	mtcpsr(Cpsr);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Hands the completed buffers of a channel back, in order, up to the first
+* descriptor the engine has not completed.
+*
+* @param	DmaPtr is a pointer to the engine.
+* @param	ChanPtr is the channel.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void AxiDma_Chan_Complete(AxiDma *DmaPtr, AxiDma_Chan *ChanPtr)
+{
+	u32 Slot;
+	u32 Status;
+	u32 Length;
+	u32 Event;
+	u8 *BufferPtr;
+
+	while (ChanPtr->Tail != ChanPtr->Head) {
+		Slot = ChanPtr->Tail % AXI_DMA_BDS;
+		Status = ChanPtr->BdPtr[Slot].Status;
+		if ((Status & AXI_DMA_BD_CMPLT) == 0U) {
+			break;
+		}
+
+		BufferPtr = ChanPtr->BufferPtr[Slot];
+		Length = Status & AXI_DMA_MAX_XFER;
+		if ((Status & AXI_DMA_BD_ERRORS) != 0U) {
+			Length = 0U;
+		}
+		ChanPtr->Tail++;
+
+		if (ChanPtr->Offset == AXI_DMA_S2MM_OFFSET) {
+			if (ChanPtr->DmaBufPtr[Slot] != NULL) {
+				/* On an error it may have written any of it */
+				(void)Xil_DmaBufFromDevice(
+					ChanPtr->DmaBufPtr[Slot], 0U,
+					(Length != 0U) ? Length :
+					ChanPtr->DmaBufPtr[Slot]->Size);
+			} else if ((Length != 0U) && (Xil_DmaArenaContains(
+				(UINTPTR)BufferPtr, Length) == 0U)) {
+				Xil_DCacheInvalidateRange((INTPTR)BufferPtr,
+							  Length);
+			}
+			Event = ((Status & AXI_DMA_BD_RXEOF) != 0U) ?
+				AXI_DMA_EVENT_RECV : AXI_DMA_EVENT_RECV_PART;
+			DmaPtr->Stats.RecvBytes += Length;
+			DmaPtr->Stats.Received++;
+		} else {
+			Event = AXI_DMA_EVENT_SENT;
+			DmaPtr->Stats.SentBytes += Length;
+			DmaPtr->Stats.Sent++;
+		}
+
+		AxiDma_Event(DmaPtr, Event, BufferPtr, Length);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Calls the event handler, if any.
+*
+* @param	DmaPtr is a pointer to the engine.
+* @param	Event is the AXI_DMA_EVENT_* event.
+* @param	BufferPtr is the buffer of the event, or NULL.
+* @param	Length is the length of the event.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void AxiDma_Event(AxiDma *DmaPtr, u32 Event, u8 *BufferPtr,
+			 u32 Length)
+{
+	if (DmaPtr->Handler != NULL) {
+		DmaPtr->Handler(DmaPtr->CallBackRef, Event, BufferPtr, Length);
+	}
+}
+
+#endif /* XPAR_XAXIDMA_0_BASEADDR */
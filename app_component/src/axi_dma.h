@@ -0,0 +1,203 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file axi_dma.h
+*
+* Streaming between the DDR of the PS and the PL through an AXI DMA in
+* scatter-gather mode on an HP port, without the axidma driver.
+*
+* Each direction of the AXI DMA, MM2S from memory to the stream and S2MM
+* from the stream to memory, runs a ring of AXI_DMA_BDS buffer descriptors.
+* AxiDma_Send() and AxiDma_Recv() queue a buffer as one descriptor behind
+* the ones in flight and move the tail pointer of the channel over it, so
+* that the engine goes from one buffer to the next without waiting for the
+* CPU. A sent buffer is one packet of the stream, TLAST on its last beat;
+* a received packet that does not fit its buffer goes on in the next ones,
+* all but the last handed back with AXI_DMA_EVENT_RECV_PART.
+*
+* The buffers are used by the engine as they are, no byte is copied, and
+* are handed back through the event handler, from the interrupt handler of
+* the channel, in the order they were queued. The descriptors are taken
+* from the DMA arena of xil_dmaarena.h, which must be mapped before
+* AxiDma_Initialize(). A buffer in the arena too, from a Xil_DmaPool of the
+* user, needs no cache maintenance and goes from the engine to its user
+* and back as it is; otherwise it is cleaned before the engine reads it and
+* invalidated before the CPU reads what it wrote, so it must be aligned to
+* a cache line and a receive buffer must be a multiple of one. The HP ports
+* do not go through the SCU, so the acp arena of xil_acp.h is no help here.
+*
+* AxiDma_SendBuf() and AxiDma_RecvBuf() take a Xil_DmaBuf of xil_dmabuf.h
+* instead, which keeps the cache state of the buffer: a sent buffer is only
+* cleaned over the lines the CPU wrote since its last transfer, a buffer
+* sent again unchanged not at all, and a received one only invalidated
+* over the bytes the engine wrote. The CPU notes what it writes with
+* Xil_DmaBufCpuWrite(). The event handler gets the address of the buffer.
+*
+* Interrupts are coalesced by the engine: a channel interrupts once
+* IRQThreshold descriptors have completed, or IRQDelay after the last
+* completion when fewer have, refer to AxiDma_SetCoalesce(). By default
+* each completion interrupts.
+*
+* The hardware design must give the AXI DMA its data ports, 64 bits wide,
+* on an HP port in 64-bit mode, its scatter-gather port on an HP or GP
+* slave port, its register port on M_AXI_GP0 and its two interrupts on
+* IRQ_F2P, with the data realignment engine if the buffers are not aligned
+* to the width of the stream. AXI_DMA_LENGTH_WIDTH must match the width of
+* its buffer length register. Without an AXI DMA in the design the file
+* compiles to nothing.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Added AxiDma_SendBuf() and AxiDma_RecvBuf()
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef AXI_DMA_H
+#define AXI_DMA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xil_dmaarena.h"
+#include "xil_dmabuf.h"
+
+/************************** Constant Definitions ****************************/
+
+#ifndef AXI_DMA_LENGTH_WIDTH
+#define AXI_DMA_LENGTH_WIDTH	14U	/**< Bits of the buffer length */
+#endif
+#ifndef AXI_DMA_SG_CLK_HZ
+#define AXI_DMA_SG_CLK_HZ	100000000U /**< m_axi_sg_aclk, fabric_clk */
+#endif
+
+#define AXI_DMA_BDS		32U	/**< Descriptors per direction, 2^n */
+#define AXI_DMA_MAX_XFER	((1U << AXI_DMA_LENGTH_WIDTH) - 1U)
+
+/** @name Channels
+ * @{
+ */
+#define AXI_DMA_MM2S		0U	/**< Memory to stream, send */
+#define AXI_DMA_S2MM		1U	/**< Stream to memory, receive */
+#define AXI_DMA_NUM_CHANS	2U
+/* @} */
+
+/** @name Events of the handler
+ * @{
+ */
+#define AXI_DMA_EVENT_SENT	1U	/**< A send completed */
+#define AXI_DMA_EVENT_RECV	2U	/**< A packet ended in the buffer */
+#define AXI_DMA_EVENT_RECV_PART	3U	/**< The packet goes on in the next */
+#define AXI_DMA_EVENT_ERROR	4U	/**< The channel halted, DMASR in Length */
+#define AXI_DMA_EVENT_FLUSHED	5U	/**< Handed back by AxiDma_Reset() */
+/* @} */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Event handler, called from the interrupt handler of a channel and from
+ * AxiDma_Reset(). BufferPtr is the buffer of a completed descriptor, NULL
+ * for AXI_DMA_EVENT_ERROR.
+ */
+typedef void (*AxiDma_Handler)(void *CallBackRef, u32 Event, u8 *BufferPtr,
+			       u32 Length);
+
+/**
+ * Buffer descriptor, as the engine reads and writes it, on 16 words.
+ */
+typedef struct {
+	volatile u32 Next;	/**< NXTDESC */
+	volatile u32 NextMsb;
+	volatile u32 Buffer;	/**< BUFFER_ADDRESS */
+	volatile u32 BufferMsb;
+	u32 Reserved[2];
+	volatile u32 Control;	/**< Length, SOF and EOF */
+	volatile u32 Status;	/**< Bytes moved, completion and errors */
+	volatile u32 App[5];	/**< User words of the status stream */
+	u32 Pad[3];
+} __attribute__ ((aligned (64))) AxiDma_Bd;
+
+/**
+ * What the engine reads and writes, in the DMA arena.
+ */
+typedef struct {
+	AxiDma_Bd Bd[AXI_DMA_NUM_CHANS][AXI_DMA_BDS];
+} AxiDma_Mem;
+
+/**
+ * One direction of the engine.
+ */
+typedef struct {
+	void *DmaPtr;		/**< The AxiDma */
+	AxiDma_Bd *BdPtr;	/**< AXI_DMA_BDS descriptors */
+	u8 *BufferPtr[AXI_DMA_BDS];
+	Xil_DmaBuf *DmaBufPtr[AXI_DMA_BDS]; /**< Of AxiDma_RecvBuf(), or NULL */
+	u32 Head;		/**< Next descriptor to queue */
+	u32 Tail;		/**< Oldest descriptor not completed */
+	u32 Offset;		/**< Of the registers of the channel */
+	u32 Control;		/**< DMACR but the run bit */
+	u32 Running;
+} AxiDma_Chan;
+
+/**
+ * Counts of the engine.
+ */
+typedef struct {
+	u64 SentBytes;
+	u64 RecvBytes;
+	u32 Sent;		/**< Buffers sent */
+	u32 Received;		/**< Buffers received */
+	u32 Interrupts;		/**< Interrupts of both channels */
+	u32 Errors;		/**< Halts on an error */
+} AxiDma_Stats;
+
+/**
+ * The engine.
+ */
+typedef struct {
+	Xil_DmaPool Pool;	/**< Holds the block of MemPtr */
+	AxiDma_Mem *MemPtr;
+	AxiDma_Chan Chan[AXI_DMA_NUM_CHANS];
+	UINTPTR BaseAddress;
+	AxiDma_Handler Handler;
+	void *CallBackRef;
+	AxiDma_Stats Stats;
+} AxiDma;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+s32 AxiDma_Initialize(AxiDma *DmaPtr, UINTPTR BaseAddress, u32 TxIntrId,
+		      u32 RxIntrId, UINTPTR IntrParent);
+void AxiDma_SetHandler(AxiDma *DmaPtr, AxiDma_Handler Handler,
+		       void *CallBackRef);
+s32 AxiDma_SetCoalesce(AxiDma *DmaPtr, u32 Chan, u32 Count, u32 MaxUs);
+void AxiDma_Start(AxiDma *DmaPtr);
+void AxiDma_Reset(AxiDma *DmaPtr);
+s32 AxiDma_Send(AxiDma *DmaPtr, u8 *BufferPtr, u32 Length);
+s32 AxiDma_Recv(AxiDma *DmaPtr, u8 *BufferPtr, u32 Length);
+s32 AxiDma_SendBuf(AxiDma *DmaPtr, Xil_DmaBuf *BufPtr, u32 Offset,
+		   u32 Length);
+s32 AxiDma_RecvBuf(AxiDma *DmaPtr, Xil_DmaBuf *BufPtr);
+u32 AxiDma_Free(const AxiDma *DmaPtr, u32 Chan);
+void AxiDma_GetStats(const AxiDma *DmaPtr, AxiDma_Stats *StatsPtr);
+void AxiDma_InterruptHandler(void *InstancePtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AXI_DMA_H */
@@ -0,0 +1,460 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file bram_bench.c
+*
+* Single word against burst copies to the AXI BRAM. Refer to bram_bench.h
+* for what is measured.
+*
+* The CPU copies run with the IRQ masked. The DMA copies keep it, their end
+* being the done interrupt of the channel.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xil_cache.h"
+#include "xil_mmu.h"
+#include "xil_printf.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xiltimer.h"
+#include "xtimestamp.h"
+#include "xinterrupt_wrap.h"
+#include "mem_region.h"
+#include "bram_bench.h"
+#include "drvcfg.h"
+
+/************************** Constant Definitions ****************************/
+
+#define BRAM_BENCH_SECTION	0x100000U	/* Bytes of an MMU section */
+#define BRAM_BENCH_LINE		32U		/* Bytes of a cache line */
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static u32 BramBench_Best(BramBench *BenchPtr, u32 Op, u32 Write,
+			  u32 Offset);
+static s32 BramBench_Copy(BramBench *BenchPtr, u32 Op, u32 Write,
+			  u32 Offset);
+static u32 BramBench_MBps(u32 Bytes, u32 Cycles);
+static void BramBench_DoneHandler(unsigned int Channel, XDmaPs_Cmd *DmaCmd,
+				  void *CallbackRef);
+
+/************************** Variable Definitions ****************************/
+
+/* Translation table of the BSP, one word per section */
+extern u32 MMUTable[];
+
+static const u32 BramBench_Attr[BRAM_BENCH_NUM_MAPS] = {
+	STRONG_ORDERED, DEVICE_MEMORY, NORM_NONCACHE
+};
+
+static const char *const BramBench_MapNames[BRAM_BENCH_NUM_MAPS] = {
+	"so", "dev", "nc"
+};
+
+static const char *const BramBench_OpNames[BRAM_BENCH_NUM_OPS] = {
+	"word", "burst", "dma"
+};
+
+/* DDR side of the copies, cacheable */
+static u8 BramBench_Ddr[BRAM_BENCH_BYTES] __attribute__((aligned(32)));
+
+/****************************************************************************/
+/**
+*
+* Sets up the BRAM driver, the DMA controller with its done interrupt on
+* BRAM_BENCH_CHANNEL and its fault interrupt, and the cycle counter.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return
+*		- XST_SUCCESS if the benchmark is ready.
+*		- XST_FAILURE if a device is not found or the interrupts
+*		  could not be connected.
+*		- The error of the failing driver call otherwise.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 BramBench_Initialize(BramBench *BenchPtr)
+{
+	XBram_Config *BramCfgPtr;
+	XBram_Config BramCfg;
+	XDmaPs_Config *CfgPtr;
+	s32 Status;
+
+	BramCfgPtr = XBram_LookupConfigStatic(XPAR_XBRAM_0_BASEADDR);
+	if (BramCfgPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	/* The generated table leaves the memory range of an AXI BRAM out */
+	BramCfg = *BramCfgPtr;
+	BramCfg.MemBaseAddress = XPAR_XBRAM_0_BASEADDR;
+	BramCfg.MemHighAddress = XPAR_XBRAM_0_HIGHADDR;
+	Status = XBram_CfgInitialize(&BenchPtr->Bram, &BramCfg,
+				     BramCfg.CtrlBaseAddress);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	CfgPtr = XDmaPs_LookupConfigStatic(XPAR_XDMAPS_0_BASEADDR);
+	if (CfgPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	Status = XDmaPs_CfgInitialize(&BenchPtr->Dma, CfgPtr,
+				      CfgPtr->BaseAddress);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	/* IntrId[0] is the fault interrupt, IntrId[1 + N] the one of channel N */
+	Status = XSetupInterruptSystem(&BenchPtr->Dma, &XDmaPs_DoneISR_0,
+				       CfgPtr->IntrId[1U + BRAM_BENCH_CHANNEL],
+				       CfgPtr->IntrParent,
+				       XINTERRUPT_DEFAULT_PRIORITY);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	Status = XConnectToInterruptCntrl(CfgPtr->IntrId[0],
+					  &XDmaPs_FaultISR, &BenchPtr->Dma,
+					  CfgPtr->IntrParent);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	XEnableIntrId(CfgPtr->IntrId[0], CfgPtr->IntrParent);
+
+	(void)XDmaPs_SetDoneHandler(&BenchPtr->Dma, BRAM_BENCH_CHANNEL,
+				    BramBench_DoneHandler, BenchPtr);
+	(void)XDmaPs_SetFaultHandler(&BenchPtr->Dma, BramBench_DoneHandler,
+				     BenchPtr);
+
+	XTimestamp_EnableCycles();
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Runs every way of copying with every mapping of the BRAM section.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	ResultsPtr is the array the results are written to.
+* @param	MaxResults is the size of the array, BRAM_BENCH_MAX_RESULTS
+*		for all of them.
+*
+* @return	The number of results written, 0 if the bram0 arena has no
+*		room for the buffer.
+*
+*****************************************************************************/
+u32 BramBench_RunAll(BramBench *BenchPtr, BramBench_Result *ResultsPtr,
+		     u32 MaxResults)
+{
+	MemRegion_Scope Scope;
+	BramBench_Result *ResultPtr;
+	UINTPTR Section;
+	u8 *BramPtr;
+	u32 NumResults = 0U;
+	u32 Offset;
+	u32 Mapping;
+	u32 Map;
+	u32 Op;
+
+	Scope = MemRegion_BeginScope(MEM_REGION_BRAM0);
+	BramPtr = (u8 *)MemRegion_Alloc(MEM_REGION_BRAM0, BRAM_BENCH_BYTES,
+					BRAM_BENCH_LINE);
+	if (BramPtr == NULL) {
+		MemRegion_EndScope(&Scope);
+		return 0U;
+	}
+	Offset = (u32)((UINTPTR)BramPtr - BenchPtr->Bram.Config.MemBaseAddress);
+
+	Section = (UINTPTR)BramPtr & ~(UINTPTR)(BRAM_BENCH_SECTION - 1U);
+	Mapping = MMUTable[Section / BRAM_BENCH_SECTION] &
+		  (BRAM_BENCH_SECTION - 1U);
+
+	for (Map = 0U; Map < BRAM_BENCH_NUM_MAPS; Map++) {
+		Xil_SetTlbAttributes((INTPTR)Section, BramBench_Attr[Map]);
+		for (Op = 0U; Op < BRAM_BENCH_NUM_OPS; Op++) {
+			if (NumResults == MaxResults) {
+				break;
+			}
+			ResultPtr = &ResultsPtr[NumResults];
+			ResultPtr->Map = Map;
+			ResultPtr->Op = Op;
+			ResultPtr->Bytes = BRAM_BENCH_BYTES;
+			ResultPtr->WriteMBps = BramBench_MBps(BRAM_BENCH_BYTES,
+				BramBench_Best(BenchPtr, Op, 1U, Offset));
+			ResultPtr->ReadMBps = BramBench_MBps(BRAM_BENCH_BYTES,
+				BramBench_Best(BenchPtr, Op, 0U, Offset));
+			NumResults++;
+		}
+	}
+
+	Xil_SetTlbAttributes((INTPTR)Section, Mapping);
+	XBram_SetBurstHandler(&BenchPtr->Bram, NULL, NULL, 0U);
+	MemRegion_EndScope(&Scope);
+
+	return NumResults;
+}
+
+/****************************************************************************/
+/**
+*
+* Prints the results, one line each.
+*
+* @param	ResultsPtr is the array of results.
+* @param	NumResults is the number of results in it.
+*
+* @return	None.
+*
+*****************************************************************************/
+void BramBench_Report(const BramBench_Result *ResultsPtr, u32 NumResults)
+{
+	const BramBench_Result *ResultPtr;
+	u32 Index;
+
+	xil_printf("map\tcopy\tbytes\twrite\tread MB/s\r\n");
+
+	for (Index = 0U; Index < NumResults; Index++) {
+		ResultPtr = &ResultsPtr[Index];
+		xil_printf("%s\t%s\t%u\t%u\t%u\r\n",
+			   BramBench_MapNames[ResultPtr->Map],
+			   BramBench_OpNames[ResultPtr->Op],
+			   ResultPtr->Bytes, ResultPtr->WriteMBps,
+			   ResultPtr->ReadMBps);
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Burst handler of the BRAM driver that copies with the PS DMA controller
+* and waits for the end of the copy. The cacheable DDR side is cleaned
+* before and invalidated after.
+*
+* @param	CallBackRef is the benchmark state.
+* @param	DstAddr is the destination.
+* @param	SrcAddr is the source.
+* @param	Bytes is the number of bytes, a multiple of 32 for the cache
+*		maintenance.
+*
+* @return
+*		- XST_SUCCESS if the bytes were copied.
+*		- XST_FAILURE if the channel failed or timed out.
+*
+*****************************************************************************/
+int BramBench_DmaCopy(void *CallBackRef, UINTPTR DstAddr, UINTPTR SrcAddr,
+		      u32 Bytes)
+{
+	BramBench *BenchPtr = (BramBench *)CallBackRef;
+	XDmaPs_Cmd *CmdPtr = &BenchPtr->Cmd;
+	UINTPTR MemBase = BenchPtr->Bram.Config.MemBaseAddress;
+	UINTPTR MemHigh = BenchPtr->Bram.Config.MemHighAddress;
+	UINTPTR DdrAddr;
+	u32 ToBram;
+	XTime Start;
+	XTime Now;
+
+	ToBram = ((DstAddr >= MemBase) && (DstAddr <= MemHigh)) ? 1U : 0U;
+	DdrAddr = (ToBram != 0U) ? SrcAddr : DstAddr;
+
+	(void)memset(CmdPtr, 0, sizeof(XDmaPs_Cmd));
+	CmdPtr->ChanCtrl.SrcInc = 1U;
+	CmdPtr->ChanCtrl.DstInc = 1U;
+	CmdPtr->BD.SrcAddr = (u32)SrcAddr;
+	CmdPtr->BD.DstAddr = (u32)DstAddr;
+	CmdPtr->BD.Length = Bytes;
+	XDmaPs_SetBurst(&BenchPtr->Dma, &CmdPtr->ChanCtrl, (u32)SrcAddr,
+			(u32)DstAddr);
+
+	/* No dirty line may be written back over the copy */
+	Xil_DCacheFlushRange((INTPTR)DdrAddr, Bytes);
+
+	BenchPtr->Done = 0U;
+	XTime_GetTime(&Start);
+	if (XDmaPs_Start(&BenchPtr->Dma, BRAM_BENCH_CHANNEL, CmdPtr,
+			 0) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	do {
+		XTime_GetTime(&Now);
+	} while ((BenchPtr->Done == 0U) &&
+		 ((Now - Start) < (((XTime)BRAM_BENCH_TIMEOUT_US *
+				    COUNTS_PER_SECOND) / 1000000U)));
+
+	if ((BenchPtr->Done == 0U) || (CmdPtr->DmaStatus != 0)) {
+		(void)XDmaPs_ResetChannel(&BenchPtr->Dma, BRAM_BENCH_CHANNEL);
+		return XST_FAILURE;
+	}
+
+	if (ToBram == 0U) {
+		Xil_DCacheInvalidateRange((INTPTR)DdrAddr, Bytes);
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Times one way of copying in one direction, the best of BRAM_BENCH_REPEAT
+* copies.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	Op is one of the BRAM_BENCH_OP_* values.
+* @param	Write is 1 from DDR to the BRAM, 0 the other way.
+* @param	Offset is the buffer in the BRAM, from its base.
+*
+* @return	The cycles of the fastest copy, 0xFFFFFFFF if one failed.
+*
+*****************************************************************************/
+static u32 BramBench_Best(BramBench *BenchPtr, u32 Op, u32 Write,
+			  u32 Offset)
+{
+	u32 Best = 0xFFFFFFFFU;
+	u32 Cpsr;
+	u32 Start;
+	u32 Cycles;
+	u32 Run;
+	s32 Status;
+
+	if (Op == BRAM_BENCH_OP_DMA) {
+		XBram_SetBurstHandler(&BenchPtr->Bram, BramBench_DmaCopy,
+				      BenchPtr, 0U);
+	} else {
+		XBram_SetBurstHandler(&BenchPtr->Bram, NULL, NULL, 0U);
+	}
+
+	for (Run = 0U; Run < BRAM_BENCH_REPEAT; Run++) {
+		Cpsr = mfcpsr();
+		if (Op != BRAM_BENCH_OP_DMA) {
+			mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+		}
+		Start = XTimestamp_Cycles();
+		Status = BramBench_Copy(BenchPtr, Op, Write, Offset);
+		Cycles = XTimestamp_Cycles() - Start;
+		mtcpsr(Cpsr);
+
+		if (Status != XST_SUCCESS) {
+			return 0xFFFFFFFFU;
+		}
+		if (Cycles < Best) {
+			Best = Cycles;
+		}
+	}
+
+	return Best;
+}
+
+/****************************************************************************/
+/**
+*
+* Copies the DDR buffer to the BRAM buffer or back once.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	Op is one of the BRAM_BENCH_OP_* values.
+* @param	Write is 1 from DDR to the BRAM, 0 the other way.
+* @param	Offset is the buffer in the BRAM, from its base.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if the DMA copy failed.
+*
+*****************************************************************************/
+static s32 BramBench_Copy(BramBench *BenchPtr, u32 Op, u32 Write,
+			  u32 Offset)
+{
+	UINTPTR Base = BenchPtr->Bram.Config.MemBaseAddress + Offset;
+	u32 *DdrPtr = (u32 *)BramBench_Ddr;
+	u32 Index;
+
+	if (Op == BRAM_BENCH_OP_WORD) {
+		for (Index = 0U; Index < (BRAM_BENCH_BYTES / 4U); Index++) {
+			if (Write != 0U) {
+				XBram_WriteReg(Base, Index * 4U,
+					       DdrPtr[Index]);
+			} else {
+				DdrPtr[Index] = XBram_ReadReg(Base,
+							      Index * 4U);
+			}
+		}
+		return XST_SUCCESS;
+	}
+
+	/* The burst handler, when set, turns these into DMA copies */
+	if (Write != 0U) {
+		return XBram_BurstWrite(&BenchPtr->Bram, Offset, BramBench_Ddr,
+					BRAM_BENCH_BYTES);
+	}
+	return XBram_BurstRead(&BenchPtr->Bram, Offset, BramBench_Ddr,
+			       BRAM_BENCH_BYTES);
+}
+
+/****************************************************************************/
+/**
+*
+* Converts a copy to a bandwidth.
+*
+* @param	Bytes is the number of bytes copied.
+* @param	Cycles is the duration of the copy.
+*
+* @return	The bandwidth in MB/s, bytes per microsecond.
+*
+*****************************************************************************/
+static u32 BramBench_MBps(u32 Bytes, u32 Cycles)
+{
+	u64 Ns;
+
+	if (Cycles == 0xFFFFFFFFU) {
+		return 0U;
+	}
+	Ns = XTimestamp_CyclesToNs(Cycles);
+
+	return (Ns == 0U) ? 0U : (u32)(((u64)Bytes * 1000U) / Ns);
+}
+
+/****************************************************************************/
+/*
+*
+* Done and fault handler of the benchmark channel.
+*
+* @param	Channel is the DMA channel.
+* @param	DmaCmd is the command done.
+* @param	CallbackRef is the benchmark state.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void BramBench_DoneHandler(unsigned int Channel, XDmaPs_Cmd *DmaCmd,
+				  void *CallbackRef)
+{
+	BramBench *BenchPtr = (BramBench *)CallbackRef;
+
+	(void)Channel;
+	(void)DmaCmd;
+
+	BenchPtr->Done = 1U;
+}
@@ -0,0 +1,115 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file bram_bench.h
+*
+* Write and read bandwidth between DDR and the AXI BRAM of axi_bram_ctrl_0,
+* with the single word accesses of XBram_WriteReg() and XBram_ReadReg()
+* against the burst copies of XBram_BurstWrite() and XBram_BurstRead().
+*
+* Each way of copying is run with the BRAM section mapped strongly ordered,
+* the mapping of the BSP, as device memory and as normal non-cacheable
+* memory, the section being given back its mapping afterwards. The DMA runs
+* go through the burst handler of the driver, BramBench_DmaCopy(), which
+* copies with the PS DMA controller in the burst shape of the XDmaPs burst
+* table; the mapping does not matter to them but their cache maintenance of
+* the DDR buffer is counted. A result is the best of BRAM_BENCH_REPEAT
+* copies of BRAM_BENCH_BYTES bytes from a cacheable DDR buffer, timed with
+* the cycle counter.
+*
+* The bitstream must be loaded, and the users of the bram0 arena must not
+* be running. The benchmark is built into the application when BRAM_BENCH
+* is defined.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef BRAM_BENCH_H
+#define BRAM_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xbram.h"
+#include "xdmaps.h"
+
+/************************** Constant Definitions ****************************/
+
+/** @name Mappings of the BRAM section
+ * @{
+ */
+#define BRAM_BENCH_MAP_SO	0U	/**< Strongly ordered */
+#define BRAM_BENCH_MAP_DEV	1U	/**< Device */
+#define BRAM_BENCH_MAP_NC	2U	/**< Normal, non-cacheable */
+#define BRAM_BENCH_NUM_MAPS	3U
+/* @} */
+
+/** @name Ways of copying
+ * @{
+ */
+#define BRAM_BENCH_OP_WORD	0U	/**< XBram_WriteReg(), XBram_ReadReg() */
+#define BRAM_BENCH_OP_BURST	1U	/**< ldm/stm blocks */
+#define BRAM_BENCH_OP_DMA	2U	/**< PS DMA controller */
+#define BRAM_BENCH_NUM_OPS	3U
+/* @} */
+
+#define BRAM_BENCH_BYTES	16384U	/**< Bytes per copy */
+#define BRAM_BENCH_REPEAT	4U	/**< Copies per result */
+#define BRAM_BENCH_CHANNEL	0U	/**< DMA channel used */
+#define BRAM_BENCH_TIMEOUT_US	10000U	/**< Longest DMA copy */
+
+/** Results of a full suite */
+#define BRAM_BENCH_MAX_RESULTS	(BRAM_BENCH_NUM_MAPS * BRAM_BENCH_NUM_OPS)
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Result of one way of copying with one mapping.
+ */
+typedef struct {
+	u32 Map;		/**< BRAM_BENCH_MAP_* */
+	u32 Op;			/**< BRAM_BENCH_OP_* */
+	u32 Bytes;		/**< Bytes per copy */
+	u32 WriteMBps;		/**< DDR to BRAM, MB/s, 0 if it failed */
+	u32 ReadMBps;		/**< BRAM to DDR, MB/s, 0 if it failed */
+} BramBench_Result;
+
+/**
+ * State of the benchmark.
+ */
+typedef struct {
+	XBram Bram;		/**< axi_bram_ctrl_0 */
+	XDmaPs Dma;		/**< DMA controller */
+	XDmaPs_Cmd Cmd;		/**< DMA copy in flight */
+	volatile u32 Done;	/**< Set by the done and fault handlers */
+} BramBench;
+
+/************************** Function Prototypes *****************************/
+
+s32 BramBench_Initialize(BramBench *BenchPtr);
+u32 BramBench_RunAll(BramBench *BenchPtr, BramBench_Result *ResultsPtr,
+		     u32 MaxResults);
+void BramBench_Report(const BramBench_Result *ResultsPtr, u32 NumResults);
+int BramBench_DmaCopy(void *CallBackRef, UINTPTR DstAddr, UINTPTR SrcAddr,
+		      u32 Bytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BRAM_BENCH_H */
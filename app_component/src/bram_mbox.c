@@ -0,0 +1,471 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file bram_mbox.c
+*
+* PS side of the BRAM mailbox. Refer to bram_mbox.h for the layout.
+*
+* The copies move whole words to and from the BRAM. A source or destination
+* in DDR that is not word aligned goes through a word on the stack, and the
+* last word of a payload is padded with zeros.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Rings in the acp arena with BRAM_MBOX_ACP.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xil_devwindow.h"
+#if defined (BRAM_MBOX_ACP)
+#include "xil_acp.h"
+#endif
+#include "mem_region.h"
+#include "bram_mbox.h"
+
+/************************** Constant Definitions ****************************/
+
+/* Length word at the start of a message */
+#define BRAM_MBOX_HDR_SIZE	4U
+
+/* Arena of the rings and base of their offsets */
+#if defined (BRAM_MBOX_ACP)
+#define BRAM_MBOX_RING_REGION	MEM_REGION_ACP
+#else
+#define BRAM_MBOX_RING_REGION	MEM_REGION_BRAM0
+#define BRAM_MBOX_RING_BASE	((UINTPTR)XPAR_XBRAM_0_BASEADDR)
+#endif
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/* Bytes a message of Length takes in a ring */
+#define BRAM_MBOX_SPAN(Length) \
+	(BRAM_MBOX_HDR_SIZE + (((Length) + 3U) & ~3U))
+
+/************************** Function Prototypes *****************************/
+
+static void BramMbox_CopyTo(volatile u32 *DstPtr, const u8 *SrcPtr,
+			    u32 Length);
+static void BramMbox_CopyFrom(u8 *DstPtr, const volatile u32 *SrcPtr,
+			      u32 Length);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* Places the control block at the start of BRAM1 and the two rings in BRAM0,
+* or in the acp arena with BRAM_MBOX_ACP, and publishes them to the PL.
+*
+* @param	MboxPtr is a pointer to the mailbox.
+* @param	TxSize is the bytes of the PS to PL ring, a power of two of at
+*		least BRAM_MBOX_MIN_RING.
+* @param	RxSize is the bytes of the PL to PS ring, likewise.
+*
+* @return
+*		- XST_SUCCESS if the mailbox is ready.
+*		- XST_INVALID_PARAM if a size is not valid.
+*		- XST_FAILURE if the BRAMs are taken or too small.
+*		- XST_NOT_ENABLED with BRAM_MBOX_ACP if the acp arena is not
+*		  mapped coherent, refer to Xil_AcpInitialize().
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 BramMbox_Initialize(BramMbox *MboxPtr, u32 TxSize, u32 RxSize)
+{
+	volatile BramMbox_Ctrl *CtrlPtr;
+	UINTPTR RingBase;
+
+	if ((TxSize < BRAM_MBOX_MIN_RING) || (RxSize < BRAM_MBOX_MIN_RING) ||
+	    ((TxSize & (TxSize - 1U)) != 0U) ||
+	    ((RxSize & (RxSize - 1U)) != 0U)) {
+		return XST_INVALID_PARAM;
+	}
+
+	CtrlPtr = (volatile BramMbox_Ctrl *)MemRegion_Alloc(MEM_REGION_BRAM1,
+				sizeof(BramMbox_Ctrl), 32U);
+	if ((UINTPTR)CtrlPtr != (UINTPTR)XPAR_XBRAM_1_BASEADDR) {
+		return XST_FAILURE;
+	}
+	MboxPtr->TxRing = (volatile u32 *)MemRegion_Alloc(BRAM_MBOX_RING_REGION,
+				TxSize, 32U);
+	MboxPtr->RxRing = (volatile u32 *)MemRegion_Alloc(BRAM_MBOX_RING_REGION,
+				RxSize, 32U);
+	if ((MboxPtr->TxRing == NULL) || (MboxPtr->RxRing == NULL)) {
+		return XST_FAILURE;
+	}
+#if defined (BRAM_MBOX_ACP)
+	if ((Xil_AcpContains((UINTPTR)MboxPtr->TxRing, TxSize) == 0U) ||
+	    (Xil_AcpContains((UINTPTR)MboxPtr->RxRing, RxSize) == 0U)) {
+		return XST_NOT_ENABLED;
+	}
+	RingBase = (UINTPTR)MboxPtr->TxRing;
+#else
+	RingBase = BRAM_MBOX_RING_BASE;
+#endif
+
+	MboxPtr->CtrlPtr = CtrlPtr;
+	MboxPtr->TxSize = TxSize;
+	MboxPtr->RxSize = RxSize;
+	MboxPtr->TxHead = 0U;
+	MboxPtr->RxTail = 0U;
+	(void)memset(&MboxPtr->Stats, 0, sizeof(MboxPtr->Stats));
+
+	CtrlPtr->Magic = 0U;
+	CtrlPtr->Version = BRAM_MBOX_VERSION;
+	CtrlPtr->TxOffset = (u32)((UINTPTR)MboxPtr->TxRing - RingBase);
+	CtrlPtr->TxSize = TxSize;
+	CtrlPtr->RxOffset = (u32)((UINTPTR)MboxPtr->RxRing - RingBase);
+	CtrlPtr->RxSize = RxSize;
+	CtrlPtr->TxHead = 0U;
+	CtrlPtr->TxTail = 0U;
+	CtrlPtr->RxHead = 0U;
+	CtrlPtr->RxTail = 0U;
+#if defined (BRAM_MBOX_ACP)
+	CtrlPtr->RingAddr = (u32)RingBase;
+#else
+	CtrlPtr->RingAddr = 0U;
+#endif
+
+	/* The PL trusts the block once it sees the magic */
+	Xil_DevWindowSync();
+	CtrlPtr->Magic = BRAM_MBOX_MAGIC;
+	Xil_DevWindowSync();
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Copies a message into the PS to PL ring and rings the doorbell of the PL,
+* its head.
+*
+* @param	MboxPtr is a pointer to the mailbox.
+* @param	DataPtr is the message.
+* @param	Length is its size, with its length word at most half the
+*		ring.
+*
+* @return
+*		- XST_SUCCESS if the message was queued.
+*		- XST_DEVICE_BUSY if the PL has not made room for it yet.
+*		- XST_INVALID_PARAM if the message is too long.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 BramMbox_Send(BramMbox *MboxPtr, const void *DataPtr, u32 Length)
+{
+	u32 Span = BRAM_MBOX_SPAN(Length);
+	u32 Head = MboxPtr->TxHead;
+	u32 Pos = Head & (MboxPtr->TxSize - 1U);
+	u32 Skip = 0U;
+
+	if ((Length > (MboxPtr->TxSize / 2U)) ||
+	    (Span > (MboxPtr->TxSize / 2U))) {
+		return XST_INVALID_PARAM;
+	}
+	if ((MboxPtr->TxSize - Pos) < Span) {
+		Skip = MboxPtr->TxSize - Pos;
+	}
+	if (((Head - MboxPtr->CtrlPtr->TxTail) + Skip + Span) >
+	    MboxPtr->TxSize) {
+		MboxPtr->Stats.Full++;
+		return XST_DEVICE_BUSY;
+	}
+
+	if (Skip != 0U) {
+		MboxPtr->TxRing[Pos / 4U] = BRAM_MBOX_WRAP;
+		Head += Skip;
+		Pos = 0U;
+	}
+	MboxPtr->TxRing[Pos / 4U] = Length;
+	BramMbox_CopyTo(&MboxPtr->TxRing[(Pos / 4U) + 1U],
+			(const u8 *)DataPtr, Length);
+	Head += Span;
+
+	/* The payload in the ring lands before the head in BRAM1 */
+	Xil_DevWindowSync();
+	MboxPtr->CtrlPtr->TxHead = Head;
+	MboxPtr->TxHead = Head;
+	MboxPtr->Stats.Sent++;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Copies the oldest message of the PL to PS ring out and frees it.
+*
+* @param	MboxPtr is a pointer to the mailbox.
+* @param	BufferPtr is where the message is copied.
+* @param	Size is the size of the buffer, a longer message is cut.
+*
+* @return	The length of the message, 0 if there is none.
+*
+* @note		A length word that cannot be right drops all that the PL has
+*		written so far and counts an error.
+*
+*****************************************************************************/
+u32 BramMbox_Receive(BramMbox *MboxPtr, void *BufferPtr, u32 Size)
+{
+	u32 Head = MboxPtr->CtrlPtr->RxHead;
+	u32 Tail = MboxPtr->RxTail;
+	u32 Pos;
+	u32 Length;
+	u32 Copied;
+
+	if (Head == Tail) {
+		return 0U;
+	}
+	/* The message in the ring is read after the head in BRAM1 */
+	Xil_DevWindowSync();
+
+	Pos = Tail & (MboxPtr->RxSize - 1U);
+	Length = MboxPtr->RxRing[Pos / 4U];
+	if (Length == BRAM_MBOX_WRAP) {
+		Tail += MboxPtr->RxSize - Pos;
+		Pos = 0U;
+		Length = MboxPtr->RxRing[0];
+	}
+	if (Tail == Head) {
+		/* Only the end of the ring was published */
+		Copied = 0U;
+	} else if ((Length > (MboxPtr->RxSize / 2U)) ||
+		   (BRAM_MBOX_SPAN(Length) > (Head - Tail))) {
+		MboxPtr->Stats.Errors++;
+		Tail = Head;
+		Copied = 0U;
+	} else {
+		Copied = (Length > Size) ? Size : Length;
+		BramMbox_CopyFrom((u8 *)BufferPtr,
+				  &MboxPtr->RxRing[(Pos / 4U) + 1U], Copied);
+		Tail += BRAM_MBOX_SPAN(Length);
+		MboxPtr->Stats.Received++;
+	}
+
+	/* The message is read before the PL may write over it */
+	Xil_DevWindowSync();
+	MboxPtr->CtrlPtr->RxTail = Tail;
+	MboxPtr->RxTail = Tail;
+
+	return Copied;
+}
+
+/****************************************************************************/
+/**
+*
+* Gives the bytes the PL has written to the PL to PS ring and the PS has
+* not read yet.
+*
+* @param	MboxPtr is a pointer to the mailbox.
+*
+* @return	The bytes pending, length words included, 0 if none.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 BramMbox_Pending(const BramMbox *MboxPtr)
+{
+	return MboxPtr->CtrlPtr->RxHead - MboxPtr->RxTail;
+}
+
+/****************************************************************************/
+/**
+*
+* Gives the room left in the PS to PL ring.
+*
+* @param	MboxPtr is a pointer to the mailbox.
+*
+* @return	The free bytes, of which a message takes its length rounded
+*		up to a word plus 4.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 BramMbox_TxFree(const BramMbox *MboxPtr)
+{
+	return MboxPtr->TxSize - (MboxPtr->TxHead - MboxPtr->CtrlPtr->TxTail);
+}
+
+/****************************************************************************/
+/**
+*
+* Copies the counts of the mailbox.
+*
+* @param	MboxPtr is a pointer to the mailbox.
+* @param	StatsPtr is where they are copied.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void BramMbox_GetStats(const BramMbox *MboxPtr, BramMbox_Stats *StatsPtr)
+{
+	*StatsPtr = MboxPtr->Stats;
+}
+
+/****************************************************************************/
+/**
+*
+* Copies bytes from DDR to the BRAM with word stores, the last word padded.
+*
+* @param	DstPtr is the first word in the BRAM.
+* @param	SrcPtr is the first byte.
+* @param	Length is the number of bytes.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void BramMbox_CopyTo(volatile u32 *DstPtr, const u8 *SrcPtr,
+			    u32 Length)
+{
+	u32 Words = Length / 4U;
+	u32 Word;
+
+	if (((UINTPTR)SrcPtr & 3U) == 0U) {
+		const u32 *Src32 = (const u32 *)SrcPtr;
+		u32 *Dst32 = (u32 *)DstPtr;
+
+		/*
+		 * Eight words in registers, one ldm and one stm. The BRAM is
+		 * not volatile here so that the stores may be combined, the
+		 * caller syncs them.
+		 */
+		while (Words >= 8U) {
+			u32 W0 = Src32[0];
+			u32 W1 = Src32[1];
+			u32 W2 = Src32[2];
+			u32 W3 = Src32[3];
+			u32 W4 = Src32[4];
+			u32 W5 = Src32[5];
+			u32 W6 = Src32[6];
+			u32 W7 = Src32[7];
+
+			Dst32[0] = W0;
+			Dst32[1] = W1;
+			Dst32[2] = W2;
+			Dst32[3] = W3;
+			Dst32[4] = W4;
+			Dst32[5] = W5;
+			Dst32[6] = W6;
+			Dst32[7] = W7;
+			Src32 += 8;
+			Dst32 += 8;
+			Words -= 8U;
+		}
+		while (Words > 0U) {
+			*Dst32 = *Src32;
+			Src32++;
+			Dst32++;
+			Words--;
+		}
+		SrcPtr = (const u8 *)Src32;
+		DstPtr = Dst32;
+	} else {
+		while (Words > 0U) {
+			(void)memcpy(&Word, SrcPtr, sizeof(Word));
+			*DstPtr = Word;
+			SrcPtr += 4;
+			DstPtr++;
+			Words--;
+		}
+	}
+
+	if ((Length & 3U) != 0U) {
+		Word = 0U;
+		(void)memcpy(&Word, SrcPtr, Length & 3U);
+		*DstPtr = Word;
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Copies bytes from the BRAM to DDR with word loads.
+*
+* @param	DstPtr is the first byte.
+* @param	SrcPtr is the first word in the BRAM.
+* @param	Length is the number of bytes.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void BramMbox_CopyFrom(u8 *DstPtr, const volatile u32 *SrcPtr,
+			      u32 Length)
+{
+	u32 Words = Length / 4U;
+	u32 Word;
+
+	if (((UINTPTR)DstPtr & 3U) == 0U) {
+		u32 *Dst32 = (u32 *)DstPtr;
+		const u32 *Src32 = (const u32 *)SrcPtr;
+
+		/* The caller synced the head, the loads may be combined */
+		while (Words >= 8U) {
+			u32 W0 = Src32[0];
+			u32 W1 = Src32[1];
+			u32 W2 = Src32[2];
+			u32 W3 = Src32[3];
+			u32 W4 = Src32[4];
+			u32 W5 = Src32[5];
+			u32 W6 = Src32[6];
+			u32 W7 = Src32[7];
+
+			Dst32[0] = W0;
+			Dst32[1] = W1;
+			Dst32[2] = W2;
+			Dst32[3] = W3;
+			Dst32[4] = W4;
+			Dst32[5] = W5;
+			Dst32[6] = W6;
+			Dst32[7] = W7;
+			Src32 += 8;
+			Dst32 += 8;
+			Words -= 8U;
+		}
+		while (Words > 0U) {
+			*Dst32 = *Src32;
+			Src32++;
+			Dst32++;
+			Words--;
+		}
+		SrcPtr = Src32;
+		DstPtr = (u8 *)Dst32;
+	} else {
+		while (Words > 0U) {
+			Word = *SrcPtr;
+			(void)memcpy(DstPtr, &Word, sizeof(Word));
+			SrcPtr++;
+			DstPtr += 4;
+			Words--;
+		}
+	}
+
+	if ((Length & 3U) != 0U) {
+		Word = *SrcPtr;
+		(void)memcpy(DstPtr, &Word, Length & 3U);
+	}
+}
@@ -0,0 +1,130 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file bram_mbox.h
+*
+* Mailbox between the PS and the PL logic through the two AXI BRAMs, so
+* that UART payloads are passed to and from the fabric without touching DDR.
+*
+* The 8 KB BRAM of axi_bram_ctrl_1 holds the control block at its start:
+* a magic word, the place and size of the two rings in the 128 KB BRAM of
+* axi_bram_ctrl_0, and the head and tail of each ring. The PL logic reads
+* the control block through the other port of the BRAM, waits for the
+* magic, and polls the head of the PS to PL ring as its doorbell; the PS
+* polls the head of the PL to PS ring with BramMbox_Receive().
+*
+* A ring is a power of two number of bytes. The head and tail are free
+* running byte counts, each written by one side only. A message is a length
+* word followed by its payload padded to a word, and never wraps: when it
+* does not fit before the end of the ring, a BRAM_MBOX_WRAP length word
+* sends the reader back to the start. A message takes at most half a ring.
+*
+* The BRAMs are only accessed with aligned words, eight at a time in the
+* middle of a message so that the stores go out as load and store multiples,
+* which the AXI port turns into bursts once the BRAMs are device windows,
+* see xil_devwindow.h. The two BRAMs are separate AXI slaves and their
+* accesses are not ordered against each other, so the payload is synced
+* before the head that publishes it and the reads of a message before the
+* tail that frees it.
+*
+* Built with BRAM_MBOX_ACP defined, the rings are taken from the acp arena
+* of mem_region.h instead, in cacheable DDR, and RingAddr of the control
+* block gives their base for the PL logic to reach them through the ACP
+* with coherent accesses, refer to xil_acp.h. The PS then copies messages
+* at cache speed and neither side maintains the caches; only the doorbells
+* stay in BRAM1. Without it RingAddr is 0 and the offsets are from BRAM0.
+*
+* The mailbox must be the first user of the bram1 arena of mem_region.h,
+* and the bitstream must be loaded. One context sends and one receives.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Rings in the acp arena with BRAM_MBOX_ACP.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef BRAM_MBOX_H
+#define BRAM_MBOX_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions ****************************/
+
+#define BRAM_MBOX_MAGIC		0x584F424DU /**< "MBOX", the block is set up */
+#define BRAM_MBOX_VERSION	2U	/**< RingAddr added */
+#define BRAM_MBOX_WRAP		0xFFFFFFFFU /**< Length word of the ring end */
+#define BRAM_MBOX_MIN_RING	64U	/**< Smallest ring, bytes */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * The control block at the start of BRAM1, shared with the PL logic. The
+ * offsets are from the base of BRAM0, or from RingAddr when it is not 0.
+ */
+typedef struct {
+	u32 Magic;		/**< BRAM_MBOX_MAGIC once the rest is valid */
+	u32 Version;
+	u32 TxOffset;		/**< PS to PL ring */
+	u32 TxSize;
+	u32 RxOffset;		/**< PL to PS ring */
+	u32 RxSize;
+	u32 TxHead;		/**< Bytes written by the PS */
+	u32 TxTail;		/**< Bytes read by the PL */
+	u32 RxHead;		/**< Bytes written by the PL */
+	u32 RxTail;		/**< Bytes read by the PS */
+	u32 RingAddr;		/**< Base of the rings through the ACP, or 0 */
+} BramMbox_Ctrl;
+
+/**
+ * Counts of the mailbox.
+ */
+typedef struct {
+	u32 Sent;		/**< Messages to the PL */
+	u32 Received;		/**< Messages from the PL */
+	u32 Full;		/**< Sends refused for want of room */
+	u32 Errors;		/**< Bad length words from the PL */
+} BramMbox_Stats;
+
+/**
+ * The PS side of the mailbox.
+ */
+typedef struct {
+	volatile BramMbox_Ctrl *CtrlPtr;
+	volatile u32 *TxRing;
+	u32 TxSize;
+	volatile u32 *RxRing;
+	u32 RxSize;
+	u32 TxHead;		/**< Copy of CtrlPtr->TxHead */
+	u32 RxTail;		/**< Copy of CtrlPtr->RxTail */
+	BramMbox_Stats Stats;
+} BramMbox;
+
+/************************** Function Prototypes *****************************/
+
+s32 BramMbox_Initialize(BramMbox *MboxPtr, u32 TxSize, u32 RxSize);
+s32 BramMbox_Send(BramMbox *MboxPtr, const void *DataPtr, u32 Length);
+u32 BramMbox_Receive(BramMbox *MboxPtr, void *BufferPtr, u32 Size);
+u32 BramMbox_Pending(const BramMbox *MboxPtr);
+u32 BramMbox_TxFree(const BramMbox *MboxPtr);
+void BramMbox_GetStats(const BramMbox *MboxPtr, BramMbox_Stats *StatsPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BRAM_MBOX_H */
@@ -0,0 +1,274 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file bridge_bench.c
+*
+* Benchmark mode of the bridge. Refer to bridge_bench.h for how the runs
+* are measured.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "xil_exception.h"
+#include "bridge_bench.h"
+
+/************************** Constant Definitions ****************************/
+
+#define BRIDGE_BENCH_IDLE_COUNTS \
+	((u64)BRIDGE_BENCH_IDLE_US * (COUNTS_PER_SECOND / 1000000U))
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static void BridgeBench_Latency(void *Ref, u32 Dir, u32 LatencyUs);
+static u32 BridgeBench_Bucket(u32 LatencyUs);
+static u32 BridgeBench_BucketHigh(u32 Bucket);
+static s32 BridgeBench_ReadGauge(void *Ref);
+
+/************************** Variable Definitions ****************************/
+
+static const u32 BridgeBenchPerMille[BRIDGE_BENCH_NUM_PCT] = {
+	500U, 990U, 999U, 1000U
+};
+
+static const char *const BridgeBenchNames[BRIDGE_NUM_DIRS]
+					 [BRIDGE_BENCH_NUM_PCT + 1U] = {
+	{ "bench.0.p50_us", "bench.0.p99_us", "bench.0.p999_us",
+	  "bench.0.max_us", "bench.0.samples" },
+	{ "bench.1.p50_us", "bench.1.p99_us", "bench.1.p999_us",
+	  "bench.1.max_us", "bench.1.samples" },
+};
+
+/****************************************************************************/
+/**
+*
+* Puts the bridge in benchmark mode: the UART of the UART side in local
+* loopback, unless BRIDGE_BENCH_EXTERNAL is defined, and the latencies of
+* the descriptors into the histograms.
+*
+* @param	BenchPtr is the benchmark state.
+* @param	BridgePtr is an initialized bridge, started or not.
+*
+* @return	XST_SUCCESS.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 BridgeBench_Initialize(BridgeBench *BenchPtr, Bridge *BridgePtr)
+{
+	(void)memset(BenchPtr, 0, sizeof(*BenchPtr));
+	BenchPtr->BridgePtr = BridgePtr;
+
+#if !defined (BRIDGE_BENCH_EXTERNAL)
+	if (BridgePtr->NumDirs == BRIDGE_NUM_DIRS) {
+		XUartPs_SetOperMode(BridgePtr->Dir[BRIDGE_DIR_UART_TO_HOST].
+				    RxPortPtr, XUARTPS_OPER_MODE_LOCAL_LOOP);
+	}
+#endif
+
+	Bridge_SetLatencyHandler(BridgePtr, BridgeBench_Latency, BenchPtr);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Returns a latency percentile of a direction in the current run.
+*
+* @param	BenchPtr is the benchmark state.
+* @param	Dir is BRIDGE_DIR_HOST_TO_UART or BRIDGE_DIR_UART_TO_HOST.
+* @param	PerMille is the percentile in tenths of a percent, 1 to 1000,
+*		1000 giving the longest latency.
+*
+* @return	The highest latency of the bucket holding the percentile, in
+*		microseconds, or 0 with no latency in the run.
+*
+* @note		The histograms are written from the interrupt handlers, so
+*		they are walked with the interrupts masked.
+*
+*****************************************************************************/
+u32 BridgeBench_Percentile(BridgeBench *BenchPtr, u32 Dir, u32 PerMille)
+{
+	const BridgeBench_Hist *HistPtr;
+	u32 Rank;
+	u32 Seen = 0U;
+	u32 Bucket;
+	u32 Value = 0U;
+
+	if ((Dir >= BRIDGE_NUM_DIRS) || (PerMille == 0U) ||
+	    (PerMille > 1000U)) {
+		return 0U;
+	}
+
+	HistPtr = &BenchPtr->Hist[Dir];
+	Xil_ExceptionDisable();
+	if (HistPtr->Samples != 0U) {
+		Rank = (u32)(((u64)HistPtr->Samples * PerMille + 999U) /
+			     1000U);
+		for (Bucket = 0U; Bucket < BRIDGE_BENCH_BUCKETS; Bucket++) {
+			Seen += HistPtr->Bucket[Bucket];
+			if (Seen >= Rank) {
+				break;
+			}
+		}
+		Value = BridgeBench_BucketHigh(Bucket);
+		if ((PerMille == 1000U) || (Value > HistPtr->MaxUs)) {
+			Value = HistPtr->MaxUs;
+		}
+	}
+	Xil_ExceptionEnable();
+
+	return Value;
+}
+
+/****************************************************************************/
+/**
+*
+* Adds the percentiles and the samples of each direction and the count of
+* runs to a registry, named as in bridge_bench.h.
+*
+* @param	BenchPtr is the benchmark state.
+* @param	RegPtr is a pointer to the registry.
+*
+* @return
+*		- XST_SUCCESS if all the metrics are added.
+*		- The error of the Metrics_Add*() call otherwise, the
+*		  metrics before it being kept.
+*
+*****************************************************************************/
+s32 BridgeBench_Register(BridgeBench *BenchPtr, Metrics *RegPtr)
+{
+	BridgeBench_Gauge *GaugePtr;
+	u32 Dir;
+	u32 Pct;
+	s32 Status;
+
+	for (Dir = 0U; Dir < BRIDGE_NUM_DIRS; Dir++) {
+		for (Pct = 0U; Pct < BRIDGE_BENCH_NUM_PCT; Pct++) {
+			GaugePtr = &BenchPtr->Gauge[Dir][Pct];
+			GaugePtr->BenchPtr = BenchPtr;
+			GaugePtr->Dir = Dir;
+			GaugePtr->PerMille = BridgeBenchPerMille[Pct];
+			Status = Metrics_AddGaugeFn(RegPtr,
+						    BridgeBenchNames[Dir][Pct],
+						    BridgeBench_ReadGauge,
+						    GaugePtr);
+			if (Status != XST_SUCCESS) {
+				return Status;
+			}
+		}
+		Status = Metrics_AddGauge(RegPtr,
+					  BridgeBenchNames[Dir][Pct],
+					  (const s32 *)&BenchPtr->Hist[Dir].
+					  Samples);
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+	}
+
+	return Metrics_AddCounter(RegPtr, "bench.runs", &BenchPtr->Runs);
+}
+
+/*
+ * Latency handler of the bridge, from the interrupt handler of the sending
+ * port. The first latency after an idle gap starts a new run.
+ */
+static void BridgeBench_Latency(void *Ref, u32 Dir, u32 LatencyUs)
+{
+	BridgeBench *BenchPtr = (BridgeBench *)Ref;
+	BridgeBench_Hist *HistPtr;
+	XTime Now;
+
+	if (Dir >= BRIDGE_NUM_DIRS) {
+		return;
+	}
+
+	XTime_GetTime(&Now);
+	if ((BenchPtr->LastStamp == 0U) ||
+	    ((Now - BenchPtr->LastStamp) > BRIDGE_BENCH_IDLE_COUNTS)) {
+		(void)memset(BenchPtr->Hist, 0, sizeof(BenchPtr->Hist));
+		BenchPtr->Runs++;
+	}
+	BenchPtr->LastStamp = Now;
+
+	HistPtr = &BenchPtr->Hist[Dir];
+	HistPtr->Bucket[BridgeBench_Bucket(LatencyUs)]++;
+	HistPtr->Samples++;
+	if (LatencyUs > HistPtr->MaxUs) {
+		HistPtr->MaxUs = LatencyUs;
+	}
+}
+
+/*
+ * Bucket of a latency: the latency itself below BRIDGE_BENCH_SUB_BUCKETS,
+ * then BRIDGE_BENCH_SUB_BUCKETS buckets per power of two.
+ */
+static u32 BridgeBench_Bucket(u32 LatencyUs)
+{
+	u32 Msb;
+
+	if (LatencyUs < BRIDGE_BENCH_SUB_BUCKETS) {
+		return LatencyUs;
+	}
+	if (LatencyUs > BRIDGE_BENCH_MAX_US) {
+		return BRIDGE_BENCH_BUCKETS - 1U;
+	}
+
+	Msb = 31U - (u32)__builtin_clz(LatencyUs);
+
+	return ((Msb - BRIDGE_BENCH_SUB_BITS + 1U) << BRIDGE_BENCH_SUB_BITS) |
+	       ((LatencyUs >> (Msb - BRIDGE_BENCH_SUB_BITS)) &
+		(BRIDGE_BENCH_SUB_BUCKETS - 1U));
+}
+
+/*
+ * Highest latency of a bucket.
+ */
+static u32 BridgeBench_BucketHigh(u32 Bucket)
+{
+	u32 Group = Bucket >> BRIDGE_BENCH_SUB_BITS;
+	u32 Shift;
+
+	if (Group == 0U) {
+		return Bucket;
+	}
+	if (Bucket >= (BRIDGE_BENCH_BUCKETS - 1U)) {
+		return 0xFFFFFFFFU;
+	}
+
+	Shift = Group - 1U;
+
+	return ((BRIDGE_BENCH_SUB_BUCKETS |
+		 (Bucket & (BRIDGE_BENCH_SUB_BUCKETS - 1U))) << Shift) +
+	       (1U << Shift) - 1U;
+}
+
+/*
+ * Gauge of a percentile.
+ */
+static s32 BridgeBench_ReadGauge(void *Ref)
+{
+	const BridgeBench_Gauge *GaugePtr = (const BridgeBench_Gauge *)Ref;
+
+	return (s32)BridgeBench_Percentile(GaugePtr->BenchPtr, GaugePtr->Dir,
+					   GaugePtr->PerMille);
+}
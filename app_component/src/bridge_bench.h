@@ -0,0 +1,127 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file bridge_bench.h
+*
+* Benchmark mode of the bridge, the target side of the end to end
+* measurement of app_component/tools/bridge_load.py.
+*
+* The host tool sends numbered messages into port 0 at the sizes, rates
+* and patterns of a run and measures what comes out: the throughput, the
+* messages lost or corrupted and the latency percentiles as the host sees
+* them, the USB-UART converter and the host drivers included. For the
+* messages to come back, BridgeBench_Initialize() puts the UART of the
+* UART side in local loopback, so that each message crosses both
+* directions of the bridge. With BRIDGE_BENCH_EXTERNAL defined the UART
+* keeps its pins instead, for a second serial port of the host wired to
+* them, which the tool drives as the far end, one direction at a time or
+* both at once. With a single UART the bridge echoes port 0 as it is.
+*
+* On the target, the RX stamps of BRIDGE_RX_STAMP give the latency of each
+* descriptor through the bridge, from its first byte received to the end
+* of its send, which goes to a histogram per direction through
+* Bridge_SetLatencyHandler(). The buckets are log-linear,
+* BRIDGE_BENCH_SUB_BUCKETS per power of two, so that a percentile is read
+* to within 1 / BRIDGE_BENCH_SUB_BUCKETS of its value, up to
+* BRIDGE_BENCH_MAX_US. A run of the tool starts after the bridge has been
+* idle for BRIDGE_BENCH_IDLE_US: the first latency after such a gap clears
+* the histograms, so that they hold the run that follows only.
+*
+* BridgeBench_Register() adds the percentiles as gauges of the registry of
+* metrics.h, "bench.0.p50_us", "bench.0.p99_us", "bench.0.p999_us" and
+* "bench.0.max_us" per direction, with the samples they are of,
+* "bench.0.samples", and the count of runs, "bench.runs". The tool reads
+* them from the capture of the metrics frames and puts them in its report
+* next to its own numbers.
+*
+* The benchmark is built into the application when BRIDGE_BENCH is
+* defined, together with BRIDGE_RX_STAMP and METRICS.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef BRIDGE_BENCH_H
+#define BRIDGE_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xiltimer.h"
+#include "usb_to_uart.h"
+#include "metrics.h"
+
+/************************** Constant Definitions ****************************/
+
+#ifndef BRIDGE_BENCH_IDLE_US
+#define BRIDGE_BENCH_IDLE_US	1000000U /**< Gap that starts a new run */
+#endif
+
+#define BRIDGE_BENCH_SUB_BITS	3U	/**< Log2 of the sub-buckets */
+#define BRIDGE_BENCH_SUB_BUCKETS (1U << BRIDGE_BENCH_SUB_BITS)
+#define BRIDGE_BENCH_MAX_BITS	24U	/**< Latencies below 2^24 us */
+#define BRIDGE_BENCH_MAX_US	((1U << BRIDGE_BENCH_MAX_BITS) - 1U)
+
+/** Buckets of a histogram, the last one taking the latencies above */
+#define BRIDGE_BENCH_BUCKETS	\
+	((BRIDGE_BENCH_MAX_BITS - BRIDGE_BENCH_SUB_BITS + 1U) * \
+	 BRIDGE_BENCH_SUB_BUCKETS)
+
+#define BRIDGE_BENCH_NUM_PCT	4U	/**< p50, p99, p99.9 and max */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Latencies of one direction in the current run.
+ */
+typedef struct {
+	u32 Bucket[BRIDGE_BENCH_BUCKETS];
+	u32 Samples;		/**< Latencies in the buckets */
+	u32 MaxUs;		/**< Longest of them */
+} BridgeBench_Hist;
+
+/**
+ * A percentile exported as a gauge.
+ */
+typedef struct {
+	struct BridgeBench_s *BenchPtr;
+	u32 Dir;
+	u32 PerMille;		/**< 500 for the median, 1000 for the max */
+} BridgeBench_Gauge;
+
+/**
+ * State of the benchmark mode.
+ */
+typedef struct BridgeBench_s {
+	Bridge *BridgePtr;
+	BridgeBench_Hist Hist[BRIDGE_NUM_DIRS];
+	u32 Runs;		/**< Runs seen, idle gaps followed by data */
+	XTime LastStamp;	/**< Time of the last latency, 0 for none */
+	BridgeBench_Gauge Gauge[BRIDGE_NUM_DIRS][BRIDGE_BENCH_NUM_PCT];
+} BridgeBench;
+
+/************************** Function Prototypes *****************************/
+
+s32 BridgeBench_Initialize(BridgeBench *BenchPtr, Bridge *BridgePtr);
+u32 BridgeBench_Percentile(BridgeBench *BenchPtr, u32 Dir, u32 PerMille);
+s32 BridgeBench_Register(BridgeBench *BenchPtr, Metrics *RegPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BRIDGE_BENCH_H */
@@ -0,0 +1,324 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file clk_profile.c
+*
+* Run time CPU clock profiles. Refer to clk_profile.h for how they are used.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xil_io.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xiltimer.h"
+#include "xtimestamp.h"
+#include "xil_misc_psreset_api.h"
+#include "clk_profile.h"
+
+/************************** Constant Definitions ****************************/
+
+#define CLK_PROFILE_SLCR_LOCK_ADDR	(XSLCR_BASEADDR + 0x00000004U)
+#define CLK_PROFILE_SLCR_LOCK_CODE	0x0000767BU
+#define CLK_PROFILE_ARM_CLK_CTRL_ADDR	(XSLCR_BASEADDR + 0x00000120U)
+
+/* Fields of ARM_CLK_CTRL */
+#define CLK_PROFILE_SRCSEL_MASK		0x00000030U
+#define CLK_PROFILE_SRCSEL_DDR_PLL	0x00000020U
+#define CLK_PROFILE_DIVISOR_SHIFT	8U
+#define CLK_PROFILE_DIVISOR_MASK	0x00003F00U
+#define CLK_PROFILE_DIVISOR_MAX		63U
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static void ClkProfile_Notify(ClkProfile *InstancePtr, u32 Event, u32 OldHz,
+			      u32 NewHz);
+
+/************************** Variable Definitions ****************************/
+
+static const char *ClkProfile_Names[CLK_PROFILE_NUM] = {
+	"performance", "balanced", "efficiency"
+};
+
+/* Factor of the divisor of ps7_init.c, per profile */
+static const u32 ClkProfile_Factors[CLK_PROFILE_NUM] = { 1U, 2U, 4U };
+
+/****************************************************************************/
+/**
+*
+* Sets up the service from the clock ps7_init.c left, in the performance
+* profile.
+*
+* @param	InstancePtr is a pointer to the service.
+*
+* @return
+*		- XST_SUCCESS if the service is ready.
+*		- XST_FAILURE if the CPU does not run from the ARM PLL.
+*
+*****************************************************************************/
+s32 ClkProfile_Initialize(ClkProfile *InstancePtr)
+{
+	u32 Ctrl;
+	u32 Divisor;
+
+	Ctrl = Xil_In32(CLK_PROFILE_ARM_CLK_CTRL_ADDR);
+	Divisor = (Ctrl & CLK_PROFILE_DIVISOR_MASK) >> CLK_PROFILE_DIVISOR_SHIFT;
+
+	/* Source 0 and 1 are both the ARM PLL */
+	if (((Ctrl & CLK_PROFILE_SRCSEL_MASK) >= CLK_PROFILE_SRCSEL_DDR_PLL) ||
+	    (Divisor == 0U)) {
+		return XST_FAILURE;
+	}
+
+	InstancePtr->BaseDivisor = Divisor;
+	InstancePtr->BaseHz = XPAR_CPU_CORE_CLOCK_FREQ_HZ;
+	InstancePtr->Profile = CLK_PROFILE_PERFORMANCE;
+	InstancePtr->Switches = 0U;
+	InstancePtr->Head = NULL;
+	InstancePtr->IsReady = 1U;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Adds a user to tell of the switches.
+*
+* @param	InstancePtr is a pointer to the service.
+* @param	NotifierPtr is the notifier, owned by the caller until it is
+*		removed.
+* @param	Handler is called before and after each switch.
+* @param	CallBackRef is passed to the handler.
+*
+* @return	None.
+*
+* @note		Not from a handler of a switch.
+*
+*****************************************************************************/
+void ClkProfile_AddNotifier(ClkProfile *InstancePtr,
+			    ClkProfile_Notifier *NotifierPtr,
+			    ClkProfile_Handler Handler, void *CallBackRef)
+{
+	NotifierPtr->Handler = Handler;
+	NotifierPtr->CallBackRef = CallBackRef;
+	NotifierPtr->Next = InstancePtr->Head;
+	InstancePtr->Head = NotifierPtr;
+}
+
+/****************************************************************************/
+/**
+*
+* Removes a user added with ClkProfile_AddNotifier().
+*
+* @param	InstancePtr is a pointer to the service.
+* @param	NotifierPtr is the notifier.
+*
+* @return	None.
+*
+* @note		Not from a handler of a switch.
+*
+*****************************************************************************/
+void ClkProfile_RemoveNotifier(ClkProfile *InstancePtr,
+			       ClkProfile_Notifier *NotifierPtr)
+{
+	ClkProfile_Notifier **LinkPtr = &InstancePtr->Head;
+
+	while (*LinkPtr != NULL) {
+		if (*LinkPtr == NotifierPtr) {
+			*LinkPtr = NotifierPtr->Next;
+			NotifierPtr->Next = NULL;
+			return;
+		}
+		LinkPtr = &(*LinkPtr)->Next;
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Switches to a profile. The notifiers are called before the divisor of
+* ARM_CLK_CTRL changes and after it, and the time of XTime_GetTime() and
+* the timestamps are scaled for the new clock.
+*
+* @param	InstancePtr is a pointer to the service.
+* @param	Profile is one of CLK_PROFILE_PERFORMANCE,
+*		CLK_PROFILE_BALANCED and CLK_PROFILE_EFFICIENCY.
+*
+* @return
+*		- XST_SUCCESS if the CPU runs in the profile.
+*		- XST_INVALID_PARAM if the profile is unknown or its divisor
+*		does not fit ARM_CLK_CTRL.
+*		- XST_DEVICE_NOT_FOUND if the service is not initialized.
+*
+* @note		From the main loop of CPU0, not from an interrupt handler.
+*
+*****************************************************************************/
+s32 ClkProfile_Set(ClkProfile *InstancePtr, u32 Profile)
+{
+	u32 Divisor;
+	u32 OldHz;
+	u32 NewHz;
+	u32 Ctrl;
+	u32 Cpsr;
+
+	if (InstancePtr->IsReady == 0U) {
+		return XST_DEVICE_NOT_FOUND;
+	}
+	if (Profile >= CLK_PROFILE_NUM) {
+		return XST_INVALID_PARAM;
+	}
+	Divisor = InstancePtr->BaseDivisor * ClkProfile_Factors[Profile];
+	if (Divisor > CLK_PROFILE_DIVISOR_MAX) {
+		return XST_INVALID_PARAM;
+	}
+	if (Profile == InstancePtr->Profile) {
+		return XST_SUCCESS;
+	}
+
+	OldHz = ClkProfile_GetCpuHz(InstancePtr);
+	NewHz = InstancePtr->BaseHz / ClkProfile_Factors[Profile];
+	ClkProfile_Notify(InstancePtr, CLK_PROFILE_PRE_CHANGE, OldHz, NewHz);
+
+	/* No interrupt between the change of the clock and that of the time */
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+
+	Xil_Out32(XSLCR_UNLOCK_ADDR, XSLCR_UNLOCK_CODE);
+	Ctrl = Xil_In32(CLK_PROFILE_ARM_CLK_CTRL_ADDR);
+	Ctrl = (Ctrl & ~CLK_PROFILE_DIVISOR_MASK) |
+	       (Divisor << CLK_PROFILE_DIVISOR_SHIFT);
+	Xil_Out32(CLK_PROFILE_ARM_CLK_CTRL_ADDR, Ctrl);
+	Xil_Out32(CLK_PROFILE_SLCR_LOCK_ADDR, CLK_PROFILE_SLCR_LOCK_CODE);
+	dsb();
+	isb();
+
+	XTime_SetScale(ClkProfile_Factors[Profile]);
+	XTimestamp_SetScale(ClkProfile_Factors[Profile]);
+	InstancePtr->Profile = Profile;
+	InstancePtr->Switches++;
+
+	mtcpsr(Cpsr);
+
+	ClkProfile_Notify(InstancePtr, CLK_PROFILE_POST_CHANGE, OldHz, NewHz);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Switches to a profile by its name, see ClkProfile_GetName().
+*
+* @param	InstancePtr is a pointer to the service.
+* @param	Name is the name of the profile.
+*
+* @return	As ClkProfile_Set(), XST_INVALID_PARAM for an unknown name.
+*
+*****************************************************************************/
+s32 ClkProfile_SetByName(ClkProfile *InstancePtr, const char *Name)
+{
+	u32 Profile;
+
+	for (Profile = 0U; Profile < CLK_PROFILE_NUM; Profile++) {
+		if (strcmp(Name, ClkProfile_Names[Profile]) == 0) {
+			return ClkProfile_Set(InstancePtr, Profile);
+		}
+	}
+
+	return XST_INVALID_PARAM;
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the current profile.
+*
+* @param	InstancePtr is a pointer to the service.
+*
+* @return	The profile.
+*
+*****************************************************************************/
+u32 ClkProfile_GetProfile(const ClkProfile *InstancePtr)
+{
+	return InstancePtr->Profile;
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the current CPU clock.
+*
+* @param	InstancePtr is a pointer to the service.
+*
+* @return	The CPU_6x4x clock in Hz.
+*
+*****************************************************************************/
+u32 ClkProfile_GetCpuHz(const ClkProfile *InstancePtr)
+{
+	return InstancePtr->BaseHz / ClkProfile_Factors[InstancePtr->Profile];
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the name of a profile.
+*
+* @param	Profile is the profile.
+*
+* @return	The name, "unknown" for no profile.
+*
+*****************************************************************************/
+const char *ClkProfile_GetName(u32 Profile)
+{
+	if (Profile >= CLK_PROFILE_NUM) {
+		return "unknown";
+	}
+
+	return ClkProfile_Names[Profile];
+}
+
+/****************************************************************************/
+/*
+*
+* Calls the handlers of the notifiers.
+*
+* @param	InstancePtr is a pointer to the service.
+* @param	Event is CLK_PROFILE_PRE_CHANGE or CLK_PROFILE_POST_CHANGE.
+* @param	OldHz is the CPU clock before the switch.
+* @param	NewHz is the CPU clock after it.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void ClkProfile_Notify(ClkProfile *InstancePtr, u32 Event, u32 OldHz,
+			      u32 NewHz)
+{
+	ClkProfile_Notifier *NotifierPtr;
+
+	for (NotifierPtr = InstancePtr->Head; NotifierPtr != NULL;
+	     NotifierPtr = NotifierPtr->Next) {
+		NotifierPtr->Handler(NotifierPtr->CallBackRef, Event, OldHz,
+				     NewHz);
+	}
+}
@@ -0,0 +1,135 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file clk_profile.h
+*
+* Run time CPU clock profiles: full speed for bursts of work, a divided
+* clock when idle.
+*
+* ps7_init.c sets the ARM PLL and the divisor of ARM_CLK_CTRL once. A
+* profile is a multiple of that divisor, switched by ClkProfile_Set() with
+* the PLL left locked, so that a switch takes a register write instead of a
+* relock of the PLL:
+*
+* - CLK_PROFILE_PERFORMANCE, the divisor of ps7_init.c.
+* - CLK_PROFILE_BALANCED, twice the divisor.
+* - CLK_PROFILE_EFFICIENCY, four times the divisor.
+*
+* The CPU_6x4x, 3x2x, 2x and 1x clocks are all divided by the same factor.
+* The 6:2:1 or 4:2:1 ratio mode of CLK_621_TRUE stays as ps7_init.c set it:
+* the TRM only has it set up before the clocks are enabled. The UART baud
+* rates do not move, the reference clock of the UARTs comes from the IO
+* PLL, and neither do the DDR and the PL clocks.
+*
+* What counts at the CPU clock is told of the factor:
+*
+* - XTime_SetScale() keeps XTime_GetTime() counting COUNTS_PER_SECOND per
+*   second, so that the deadlines and timeouts of the application keep
+*   their length.
+* - XTimestamp_SetScale() converts the timestamps at the new rate.
+* - The timer wheel of timer_wheel.h loads the private timer for it.
+*
+* Other users are told by a ClkProfile_Notifier, called before the switch
+* and after it with the old and the new CPU clock. The watchdog of
+* wdt_service.h and the sample rate of pc_prof.h, both on the private
+* watchdog, run slower by the factor. Both CPUs share the clock; the
+* profiles are switched from CPU0.
+*
+* @code
+*	(void)ClkProfile_Initialize(&Clock);
+*	(void)ClkProfile_Set(&Clock, CLK_PROFILE_EFFICIENCY);	// idle
+*	(void)ClkProfile_Set(&Clock, CLK_PROFILE_PERFORMANCE);	// burst
+* @endcode
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef CLK_PROFILE_H
+#define CLK_PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions ****************************/
+
+/** @name Profiles
+ * @{
+ */
+#define CLK_PROFILE_PERFORMANCE	0U
+#define CLK_PROFILE_BALANCED	1U
+#define CLK_PROFILE_EFFICIENCY	2U
+#define CLK_PROFILE_NUM		3U
+/* @} */
+
+/** @name Events of a notifier
+ * @{
+ */
+#define CLK_PROFILE_PRE_CHANGE	0U	/**< The clock is about to change */
+#define CLK_PROFILE_POST_CHANGE	1U	/**< The clock has changed */
+/* @} */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Called with an event, the CPU clock before the switch and the one after
+ * it, in Hz, from the context of ClkProfile_Set() with the IRQ enabled.
+ */
+typedef void (*ClkProfile_Handler)(void *CallBackRef, u32 Event, u32 OldHz,
+				   u32 NewHz);
+
+/**
+ * A user told of the switches. Owned by the caller.
+ */
+typedef struct ClkProfile_Notifier {
+	struct ClkProfile_Notifier *Next;
+	ClkProfile_Handler Handler;
+	void *CallBackRef;
+} ClkProfile_Notifier;
+
+/**
+ * The service.
+ */
+typedef struct {
+	u32 BaseDivisor;	/**< Divisor of ARM_CLK_CTRL from ps7_init.c */
+	u32 BaseHz;		/**< CPU clock of the performance profile */
+	u32 Profile;		/**< Current profile */
+	u32 Switches;		/**< Switches made */
+	ClkProfile_Notifier *Head;
+	u32 IsReady;
+} ClkProfile;
+
+/************************** Function Prototypes *****************************/
+
+s32 ClkProfile_Initialize(ClkProfile *InstancePtr);
+void ClkProfile_AddNotifier(ClkProfile *InstancePtr,
+			    ClkProfile_Notifier *NotifierPtr,
+			    ClkProfile_Handler Handler, void *CallBackRef);
+void ClkProfile_RemoveNotifier(ClkProfile *InstancePtr,
+			       ClkProfile_Notifier *NotifierPtr);
+s32 ClkProfile_Set(ClkProfile *InstancePtr, u32 Profile);
+s32 ClkProfile_SetByName(ClkProfile *InstancePtr, const char *Name);
+u32 ClkProfile_GetProfile(const ClkProfile *InstancePtr);
+u32 ClkProfile_GetCpuHz(const ClkProfile *InstancePtr);
+const char *ClkProfile_GetName(u32 Profile);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CLK_PROFILE_H */
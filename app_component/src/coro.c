@@ -0,0 +1,361 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file coro.c
+*
+* Cooperative scheduler of stackful tasks. Refer to coro.h for how it is
+* used.
+*
+* Tasks switch to the scheduler and the scheduler to the next task, each
+* through CoroSwitch() of coro_switch.S, so a task only ever runs between
+* two switches of its own. A yield point is taken in a task when the CPU is
+* in system mode, the mode of main(), and the GIC has no interrupt active:
+* a nested handler also runs in system mode, on the stack of the task it
+* interrupted, but with its running priority set.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Trace the task switches with xil_trace.h.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xil_yield.h"
+#include "xil_trace.h"
+#include "xinterrupt_wrap.h"
+#include "amp.h"
+#include "coro.h"
+
+/************************** Constant Definitions ****************************/
+
+#define CORO_NONE		0xFFFFFFFFU	/* No task is running */
+#define CORO_GIC_IDLE		0xFFU		/* Running priority, idle */
+
+/* Words of the frame of CoroSwitch(): d8-d15, r3-r11 and lr */
+#define CORO_FRAME_WORDS	26U
+#define CORO_FRAME_R4		17U
+#define CORO_FRAME_R5		18U
+#define CORO_FRAME_LR		25U
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+void CoroSwitch(UINTPTR *SaveSpPtr, UINTPTR NewSp);
+void CoroStart(void);
+void CoroExit(void);
+static u32 Coro_InTask(void);
+static void Coro_YieldHook(void);
+static u32 Coro_SleepHook(u64 Us);
+
+/************************** Variable Definitions ****************************/
+
+static struct {
+	Coro_Task Task[CORO_MAX_TASKS];
+	u32 NumTasks;
+	u32 Current;		/* Running task, or CORO_NONE */
+	u32 Cpu;		/* CPU Coro_Run() runs on */
+	UINTPTR SchedSp;	/* Stack of Coro_Run() while a task runs */
+} Coro = { .Current = CORO_NONE };
+
+/****************************************************************************/
+/**
+*
+* Creates a task, ready to run from the next turn of the scheduler.
+*
+* @param	Entry is the body of the task.
+* @param	Arg is passed to Entry.
+* @param	StackPtr is the stack of the task.
+* @param	StackSize is its size, at least CORO_MIN_STACK bytes. The
+*		task needs room for its own calls and for the handlers of
+*		nested interrupts.
+* @param	TaskIdPtr is where the id of the task is returned, or NULL.
+*
+* @return
+*		- XST_SUCCESS if the task was created.
+*		- XST_INVALID_PARAM if the stack is too small.
+*		- XST_DEVICE_BUSY if CORO_MAX_TASKS tasks exist.
+*
+* @note		Tasks can be created before Coro_Run() and by other tasks.
+*
+*****************************************************************************/
+s32 Coro_Create(Coro_Entry Entry, void *Arg, void *StackPtr, u32 StackSize,
+		u32 *TaskIdPtr)
+{
+	Coro_Task *TaskPtr;
+	UINTPTR *FramePtr;
+	UINTPTR Top;
+	u32 Index;
+
+	if ((Entry == NULL) || (StackPtr == NULL) ||
+	    (StackSize < CORO_MIN_STACK)) {
+		return XST_INVALID_PARAM;
+	}
+	if (Coro.NumTasks == CORO_MAX_TASKS) {
+		return XST_DEVICE_BUSY;
+	}
+
+	/* The AAPCS wants the stack 8 byte aligned at calls */
+	Top = ((UINTPTR)StackPtr + StackSize) & ~(UINTPTR)7U;
+	FramePtr = (UINTPTR *)(Top - (CORO_FRAME_WORDS * sizeof(UINTPTR)));
+	for (Index = 0U; Index < CORO_FRAME_WORDS; Index++) {
+		FramePtr[Index] = 0U;
+	}
+	FramePtr[CORO_FRAME_R4] = (UINTPTR)Entry;
+	FramePtr[CORO_FRAME_R5] = (UINTPTR)Arg;
+	FramePtr[CORO_FRAME_LR] = (UINTPTR)CoroStart;
+
+	TaskPtr = &Coro.Task[Coro.NumTasks];
+	TaskPtr->Sp = (UINTPTR)FramePtr;
+	TaskPtr->State = CORO_READY;
+	TaskPtr->WakeTime = 0U;
+	TaskPtr->Switches = 0U;
+
+	if (TaskIdPtr != NULL) {
+		*TaskIdPtr = Coro.NumTasks;
+	}
+	Coro.NumTasks++;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Runs the tasks until all of them have returned. The yield points of the
+* BSP switch tasks while it runs.
+*
+* @return	None.
+*
+* @note		Call it from main(), in system mode. Tasks must not call it.
+*
+*****************************************************************************/
+void Coro_Run(void)
+{
+	Coro_Task *TaskPtr;
+	XTime Now;
+	u32 Next = 0U;
+	u32 Done;
+	u32 Index;
+
+	Coro.Cpu = Amp_CpuId();
+	Xil_SetYieldHandler(Coro_YieldHook, Coro_SleepHook);
+
+	do {
+		XTime_GetTime(&Now);
+		Done = 0U;
+
+		/* One turn, each task is looked at once */
+		for (Index = 0U; Index < Coro.NumTasks; Index++) {
+			TaskPtr = &Coro.Task[Next];
+			if ((TaskPtr->State == CORO_SLEEPING) &&
+			    (Now >= TaskPtr->WakeTime)) {
+				TaskPtr->State = CORO_READY;
+			}
+
+			if (TaskPtr->State == CORO_READY) {
+				TaskPtr->Switches++;
+				Coro.Current = Next;
+				XIL_TRACE_EVENT(XIL_TRACE_ID_TASK |
+						XIL_TRACE_BEGIN, Next,
+						(UINTPTR)TaskPtr);
+				CoroSwitch(&Coro.SchedSp, TaskPtr->Sp);
+				XIL_TRACE_EVENT(XIL_TRACE_ID_TASK | XIL_TRACE_END,
+						Next, (UINTPTR)TaskPtr);
+				Coro.Current = CORO_NONE;
+				XTime_GetTime(&Now);
+			} else if (TaskPtr->State == CORO_DONE) {
+				Done++;
+			}
+
+			Next++;
+			if (Next == Coro.NumTasks) {
+				Next = 0U;
+			}
+		}
+	} while (Done < Coro.NumTasks);
+
+	Xil_SetYieldHandler(NULL, NULL);
+}
+
+/****************************************************************************/
+/**
+*
+* Gives the CPU to the other ready tasks, the caller runs again on the next
+* turn of the scheduler.
+*
+* @return	None.
+*
+* @note		Returns at once outside a task.
+*
+*****************************************************************************/
+void Coro_Yield(void)
+{
+	Coro_Task *TaskPtr;
+
+	if (Coro_InTask() == 0U) {
+		return;
+	}
+
+	TaskPtr = &Coro.Task[Coro.Current];
+	CoroSwitch(&TaskPtr->Sp, Coro.SchedSp);
+}
+
+/****************************************************************************/
+/**
+*
+* Sleeps the calling task for a time, the other tasks running meanwhile.
+*
+* @param	Us is the time to sleep, in microseconds.
+*
+* @return	None.
+*
+* @note		Busy waits outside a task, as usleep() does.
+*
+*****************************************************************************/
+void Coro_SleepUs(u64 Us)
+{
+	XTime Start;
+	XTime Now;
+
+	if (Coro_SleepHook(Us) != 0U) {
+		return;
+	}
+
+	XTime_GetTime(&Start);
+	do {
+		XTime_GetTime(&Now);
+	} while ((Now - Start) < ((Us * COUNTS_PER_SECOND) / 1000000U));
+}
+
+/****************************************************************************/
+/**
+*
+* Gives the id of the running task.
+*
+* @return	The id, or 0xFFFFFFFF outside a task.
+*
+*****************************************************************************/
+u32 Coro_Self(void)
+{
+	return (Coro_InTask() != 0U) ? Coro.Current : CORO_NONE;
+}
+
+/****************************************************************************/
+/**
+*
+* Gives the state of a task.
+*
+* @param	TaskId is the id of the task.
+*
+* @return	The task, or NULL if there is no such task.
+*
+*****************************************************************************/
+const Coro_Task *Coro_GetTask(u32 TaskId)
+{
+	return (TaskId < Coro.NumTasks) ? &Coro.Task[TaskId] : NULL;
+}
+
+/****************************************************************************/
+/**
+*
+* Ends the running task. CoroStart() calls it when the entry returns.
+*
+* @return	Does not return.
+*
+*****************************************************************************/
+void CoroExit(void)
+{
+	Coro.Task[Coro.Current].State = CORO_DONE;
+	CoroSwitch(&Coro.Task[Coro.Current].Sp, Coro.SchedSp);
+}
+
+/****************************************************************************/
+/**
+*
+* Tells whether the caller runs in a task, where it may switch.
+*
+* @return	1 in a task, 0 in Coro_Run(), in a handler or on the other
+*		CPU.
+*
+*****************************************************************************/
+static u32 Coro_InTask(void)
+{
+#if defined (XPAR_SCUGIC)
+	XScuGic *GicPtr;
+#endif
+
+	if ((Coro.Current == CORO_NONE) || (Amp_CpuId() != Coro.Cpu) ||
+	    ((mfcpsr() & XREG_CPSR_MODE_BITS) != XREG_CPSR_SYSTEM_MODE)) {
+		return 0U;
+	}
+
+#if defined (XPAR_SCUGIC)
+	GicPtr = XGetScuGicInstance();
+	if ((GicPtr != NULL) &&
+	    ((XScuGic_CPUReadReg(GicPtr, XSCUGIC_RUN_PRIOR_OFFSET) &
+	      XSCUGIC_RUN_PRIORITY_MASK) != CORO_GIC_IDLE)) {
+		return 0U;
+	}
+#endif
+
+	return 1U;
+}
+
+/****************************************************************************/
+/**
+*
+* Yield handler of xil_yield.h.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void Coro_YieldHook(void)
+{
+	Coro_Yield();
+}
+
+/****************************************************************************/
+/**
+*
+* Sleep handler of xil_yield.h. Puts the running task to sleep and runs
+* the others until it is woken.
+*
+* @param	Us is the time to sleep, in microseconds.
+*
+* @return	1 once slept, 0 outside a task.
+*
+*****************************************************************************/
+static u32 Coro_SleepHook(u64 Us)
+{
+	Coro_Task *TaskPtr;
+	XTime Now;
+
+	if (Coro_InTask() == 0U) {
+		return 0U;
+	}
+
+	TaskPtr = &Coro.Task[Coro.Current];
+	XTime_GetTime(&Now);
+	TaskPtr->WakeTime = Now + ((Us * COUNTS_PER_SECOND) / 1000000U);
+	TaskPtr->State = CORO_SLEEPING;
+	CoroSwitch(&TaskPtr->Sp, Coro.SchedSp);
+
+	return 1U;
+}
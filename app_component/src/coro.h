@@ -0,0 +1,97 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file coro.h
+*
+* Cooperative scheduler of stackful tasks for the main loop of a CPU.
+*
+* Tasks are created with Coro_Create(), each on a stack of its own, and are
+* run by Coro_Run() from main() until all of them have returned. A task
+* runs until it gives the CPU back with Coro_Yield() or Coro_SleepUs(), or
+* through one of the yield points of the BSP: Coro_Run() sets the handlers
+* of xil_yield.h, so that XUartPs_WaitTransmitDone(), the devcfg waits and
+* the sleep(), msleep() and usleep() of xiltimer run the other tasks while
+* they wait. A task that sleeps is woken by the scheduler from the global
+* timer, XTime_GetTime(), once its time is up.
+*
+* The scheduler picks the next ready task in turn, and spins on the timer
+* when every task sleeps. A switch saves the callee saved registers,
+* including d8-d15 of the VFP, on the stack of the task.
+*
+* The yield points are only taken in the tasks themselves: called from an
+* interrupt handler, nested or not, from the main loop outside Coro_Run()
+* or from another CPU, they return at once and the sleep falls back to the
+* busy delay.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef CORO_H
+#define CORO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xiltimer.h"
+
+/************************** Constant Definitions ****************************/
+
+#define CORO_MAX_TASKS		16U	/**< Tasks per scheduler */
+#define CORO_MIN_STACK		512U	/**< Smallest stack, in bytes */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Body of a task, the task ends when it returns.
+ */
+typedef void (*Coro_Entry)(void *Arg);
+
+/**
+ * State of a task.
+ */
+typedef enum {
+	CORO_READY = 0,
+	CORO_SLEEPING,
+	CORO_DONE
+} Coro_State;
+
+/**
+ * A task. Sp must stay first, it is saved and loaded by coro_switch.S.
+ */
+typedef struct {
+	UINTPTR Sp;		/**< Saved stack pointer while switched out */
+	Coro_State State;
+	XTime WakeTime;		/**< End of the sleep */
+	u32 Switches;		/**< Times the task was run */
+} Coro_Task;
+
+/************************** Function Prototypes *****************************/
+
+s32 Coro_Create(Coro_Entry Entry, void *Arg, void *StackPtr, u32 StackSize,
+		u32 *TaskIdPtr);
+void Coro_Run(void);
+void Coro_Yield(void);
+void Coro_SleepUs(u64 Us);
+u32 Coro_Self(void);
+const Coro_Task *Coro_GetTask(u32 TaskId);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORO_H */
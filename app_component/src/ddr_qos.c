@@ -0,0 +1,445 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file ddr_qos.c
+*
+* Run time QoS profiles of the DDR controller. Refer to ddr_qos.h for how
+* they are used.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xil_io.h"
+#include "xpseudo_asm.h"
+#include "ddr_qos.h"
+
+/************************** Constant Definitions ****************************/
+
+/* Registers of the DDR controller */
+#define DDR_QOS_HPR_ADDR	(XPAR_PS7_DDRC_0_BASEADDR + 0x008U)
+#define DDR_QOS_LPR_ADDR	(XPAR_PS7_DDRC_0_BASEADDR + 0x00CU)
+#define DDR_QOS_WR_PORT_ADDR	(XPAR_PS7_DDRC_0_BASEADDR + 0x208U)
+#define DDR_QOS_RD_PORT_ADDR	(XPAR_PS7_DDRC_0_BASEADDR + 0x218U)
+
+/* Fields of HPR_reg and LPR_reg */
+#define DDR_QOS_MIN_NC_MASK	0x000007FFU
+#define DDR_QOS_STARVE_SHIFT	11U
+#define DDR_QOS_STARVE_MASK	0x003FF800U
+#define DDR_QOS_RUN_SHIFT	22U
+#define DDR_QOS_RUN_MASK	0x03C00000U
+
+/* Fields of axi_priority_wr_port and axi_priority_rd_port */
+#define DDR_QOS_PRI_MASK	0x000003FFU
+#define DDR_QOS_SET_HPR_MASK	0x00080000U	/* Read ports only */
+
+/* QoS-301 regulators in the GPV of the central interconnect */
+#define DDR_QOS_QOS301_DMAC	0xF8947000U
+#define DDR_QOS_QOS301_IOU	0xF8948000U
+#define DDR_QOS_CNTL_OFFSET	0x10CU
+#define DDR_QOS_MAX_OT_OFFSET	0x110U
+
+/* Fields of qos_cntl and max_ot */
+#define DDR_QOS_EN_AW_OT	0x00000040U
+#define DDR_QOS_EN_AR_OT	0x00000080U
+#define DDR_QOS_AR_OTI_SHIFT	24U
+#define DDR_QOS_AR_OTI_MASK	0x3F000000U
+#define DDR_QOS_AW_OTI_SHIFT	8U
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static void DdrQos_GetQueue(u32 Addr, DdrQos_Queue *QueuePtr);
+static void DdrQos_SetQueue(u32 Addr, const DdrQos_Queue *QueuePtr);
+static u8 DdrQos_GetMaxOt(u32 BaseAddr);
+static void DdrQos_SetMaxOt(u32 BaseAddr, u8 MaxOt);
+
+/************************** Variable Definitions ****************************/
+
+static const char *DdrQos_Names[DDR_QOS_NUM] = {
+	"default", "cpu", "dma"
+};
+
+/* The profiles but the default one, from DDR_QOS_CPU_FIRST on */
+static const DdrQos_Profile DdrQos_Profiles[DDR_QOS_NUM - 1U] = {
+	{
+		/* CPU latency first */
+		.RdPriority = { 0U, DDR_QOS_PRIORITY_LOWEST,
+				DDR_QOS_PRIORITY_LOWEST,
+				DDR_QOS_PRIORITY_LOWEST },
+		.WrPriority = { 0U, DDR_QOS_PRIORITY_LOWEST,
+				DDR_QOS_PRIORITY_LOWEST,
+				DDR_QOS_PRIORITY_LOWEST },
+		.RdHpr = { 1U, 0U, 0U, 0U },
+		.Hpr = { 0x00FU, 0x004U, DDR_QOS_RUN_MAX },
+		.Lpr = { 0x001U, 0x07FU, 4U },
+		.DmacMaxOt = 4U,
+		.IouMaxOt = 0U,
+	},
+	{
+		/* Bulk DMA first */
+		.RdPriority = { DDR_QOS_PRIORITY_LOWEST, 0U, 0U, 0U },
+		.WrPriority = { DDR_QOS_PRIORITY_LOWEST, 0U, 0U, 0U },
+		.RdHpr = { 0U, 1U, 1U, 1U },
+		.Hpr = { 0x00FU, 0x00FU, DDR_QOS_RUN_MAX },
+		.Lpr = { 0x001U, 0x040U, 4U },
+		.DmacMaxOt = 0U,
+		.IouMaxOt = 0U,
+	},
+};
+
+/****************************************************************************/
+/**
+*
+* Sets up the service from the arbitration ps7_init.c left, which becomes
+* the default profile.
+*
+* @param	InstancePtr is a pointer to the service.
+*
+* @return	XST_SUCCESS.
+*
+*****************************************************************************/
+s32 DdrQos_Initialize(DdrQos *InstancePtr)
+{
+	DdrQos_Profile *ProfilePtr = &InstancePtr->Default;
+	u32 Port;
+	u32 Reg;
+
+	(void)memset(InstancePtr, 0, sizeof(*InstancePtr));
+
+	for (Port = 0U; Port < DDR_QOS_NUM_PORTS; Port++) {
+		Reg = Xil_In32(DDR_QOS_RD_PORT_ADDR + (Port * 4U));
+		ProfilePtr->RdPriority[Port] = (u16)(Reg & DDR_QOS_PRI_MASK);
+		ProfilePtr->RdHpr[Port] =
+			((Reg & DDR_QOS_SET_HPR_MASK) != 0U) ? 1U : 0U;
+
+		Reg = Xil_In32(DDR_QOS_WR_PORT_ADDR + (Port * 4U));
+		ProfilePtr->WrPriority[Port] = (u16)(Reg & DDR_QOS_PRI_MASK);
+	}
+
+	DdrQos_GetQueue(DDR_QOS_HPR_ADDR, &ProfilePtr->Hpr);
+	DdrQos_GetQueue(DDR_QOS_LPR_ADDR, &ProfilePtr->Lpr);
+	ProfilePtr->DmacMaxOt = DdrQos_GetMaxOt(DDR_QOS_QOS301_DMAC);
+	ProfilePtr->IouMaxOt = DdrQos_GetMaxOt(DDR_QOS_QOS301_IOU);
+
+	InstancePtr->Profile = DDR_QOS_DEFAULT;
+	InstancePtr->IsReady = 1U;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Switches to a profile.
+*
+* @param	InstancePtr is a pointer to the service.
+* @param	Profile is one of DDR_QOS_DEFAULT, DDR_QOS_CPU_FIRST and
+*		DDR_QOS_DMA_FIRST.
+*
+* @return
+*		- XST_SUCCESS if the profile is applied.
+*		- XST_INVALID_PARAM if the profile is unknown.
+*		- XST_DEVICE_NOT_FOUND if the service is not initialized.
+*
+*****************************************************************************/
+s32 DdrQos_Set(DdrQos *InstancePtr, u32 Profile)
+{
+	DdrQos_Profile Settings;
+	s32 Status;
+
+	Status = DdrQos_GetSettings(InstancePtr, Profile, &Settings);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	Status = DdrQos_Apply(InstancePtr, &Settings);
+	if (Status == XST_SUCCESS) {
+		InstancePtr->Profile = Profile;
+	}
+
+	return Status;
+}
+
+/****************************************************************************/
+/**
+*
+* Switches to a profile by its name, see DdrQos_GetName().
+*
+* @param	InstancePtr is a pointer to the service.
+* @param	Name is the name of the profile.
+*
+* @return	As DdrQos_Set(), XST_INVALID_PARAM for an unknown name.
+*
+*****************************************************************************/
+s32 DdrQos_SetByName(DdrQos *InstancePtr, const char *Name)
+{
+	u32 Profile;
+
+	for (Profile = 0U; Profile < DDR_QOS_NUM; Profile++) {
+		if (strcmp(Name, DdrQos_Names[Profile]) == 0) {
+			return DdrQos_Set(InstancePtr, Profile);
+		}
+	}
+
+	return XST_INVALID_PARAM;
+}
+
+/****************************************************************************/
+/**
+*
+* Applies an arbitration. The current profile becomes DDR_QOS_CUSTOM until
+* the next DdrQos_Set().
+*
+* @param	InstancePtr is a pointer to the service.
+* @param	ProfilePtr is the arbitration, see DdrQos_GetSettings() to
+*		start from a profile.
+*
+* @return
+*		- XST_SUCCESS if the arbitration is applied.
+*		- XST_INVALID_PARAM if a field does not fit its register.
+*		- XST_DEVICE_NOT_FOUND if the service is not initialized.
+*
+* @note		The ports are set one after the other while the
+*		controller runs, the transfers in flight are not disturbed.
+*
+*****************************************************************************/
+s32 DdrQos_Apply(DdrQos *InstancePtr, const DdrQos_Profile *ProfilePtr)
+{
+	u32 Port;
+	u32 Addr;
+	u32 Reg;
+
+	if (InstancePtr->IsReady == 0U) {
+		return XST_DEVICE_NOT_FOUND;
+	}
+
+	for (Port = 0U; Port < DDR_QOS_NUM_PORTS; Port++) {
+		if ((ProfilePtr->RdPriority[Port] > DDR_QOS_PRIORITY_LOWEST) ||
+		    (ProfilePtr->WrPriority[Port] > DDR_QOS_PRIORITY_LOWEST)) {
+			return XST_INVALID_PARAM;
+		}
+	}
+	if ((ProfilePtr->Hpr.MinNonCritical > DDR_QOS_CYCLES_MAX) ||
+	    (ProfilePtr->Hpr.MaxStarve > DDR_QOS_CYCLES_MAX) ||
+	    (ProfilePtr->Hpr.RunLength > DDR_QOS_RUN_MAX) ||
+	    (ProfilePtr->Lpr.MinNonCritical > DDR_QOS_CYCLES_MAX) ||
+	    (ProfilePtr->Lpr.MaxStarve > DDR_QOS_CYCLES_MAX) ||
+	    (ProfilePtr->Lpr.RunLength > DDR_QOS_RUN_MAX) ||
+	    (ProfilePtr->DmacMaxOt > DDR_QOS_OT_MAX) ||
+	    (ProfilePtr->IouMaxOt > DDR_QOS_OT_MAX)) {
+		return XST_INVALID_PARAM;
+	}
+
+	for (Port = 0U; Port < DDR_QOS_NUM_PORTS; Port++) {
+		Addr = DDR_QOS_RD_PORT_ADDR + (Port * 4U);
+		Reg = Xil_In32(Addr) &
+		      ~(DDR_QOS_PRI_MASK | DDR_QOS_SET_HPR_MASK);
+		Reg |= ProfilePtr->RdPriority[Port];
+		if (ProfilePtr->RdHpr[Port] != 0U) {
+			Reg |= DDR_QOS_SET_HPR_MASK;
+		}
+		Xil_Out32(Addr, Reg);
+
+		Addr = DDR_QOS_WR_PORT_ADDR + (Port * 4U);
+		Reg = Xil_In32(Addr) & ~DDR_QOS_PRI_MASK;
+		Xil_Out32(Addr, Reg | ProfilePtr->WrPriority[Port]);
+	}
+
+	DdrQos_SetQueue(DDR_QOS_HPR_ADDR, &ProfilePtr->Hpr);
+	DdrQos_SetQueue(DDR_QOS_LPR_ADDR, &ProfilePtr->Lpr);
+	DdrQos_SetMaxOt(DDR_QOS_QOS301_DMAC, ProfilePtr->DmacMaxOt);
+	DdrQos_SetMaxOt(DDR_QOS_QOS301_IOU, ProfilePtr->IouMaxOt);
+	dsb();
+
+	InstancePtr->Profile = DDR_QOS_CUSTOM;
+	InstancePtr->Switches++;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the arbitration of a profile.
+*
+* @param	InstancePtr is a pointer to the service.
+* @param	Profile is one of DDR_QOS_DEFAULT, DDR_QOS_CPU_FIRST and
+*		DDR_QOS_DMA_FIRST.
+* @param	ProfilePtr is where the arbitration is stored.
+*
+* @return
+*		- XST_SUCCESS if the arbitration is stored.
+*		- XST_INVALID_PARAM if the profile is unknown.
+*		- XST_DEVICE_NOT_FOUND if the service is not initialized.
+*
+*****************************************************************************/
+s32 DdrQos_GetSettings(const DdrQos *InstancePtr, u32 Profile,
+		       DdrQos_Profile *ProfilePtr)
+{
+	if (InstancePtr->IsReady == 0U) {
+		return XST_DEVICE_NOT_FOUND;
+	}
+	if (Profile >= DDR_QOS_NUM) {
+		return XST_INVALID_PARAM;
+	}
+
+	if (Profile == DDR_QOS_DEFAULT) {
+		*ProfilePtr = InstancePtr->Default;
+	} else {
+		*ProfilePtr = DdrQos_Profiles[Profile - 1U];
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the current profile.
+*
+* @param	InstancePtr is a pointer to the service.
+*
+* @return	The profile, DDR_QOS_CUSTOM after DdrQos_Apply().
+*
+*****************************************************************************/
+u32 DdrQos_GetProfile(const DdrQos *InstancePtr)
+{
+	return InstancePtr->Profile;
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the name of a profile.
+*
+* @param	Profile is the profile.
+*
+* @return	The name, "custom" for DDR_QOS_CUSTOM and "unknown" for no
+*		profile.
+*
+*****************************************************************************/
+const char *DdrQos_GetName(u32 Profile)
+{
+	if (Profile == DDR_QOS_CUSTOM) {
+		return "custom";
+	}
+	if (Profile >= DDR_QOS_NUM) {
+		return "unknown";
+	}
+
+	return DdrQos_Names[Profile];
+}
+
+/****************************************************************************/
+/*
+*
+* Reads the service of a read queue.
+*
+* @param	Addr is the address of HPR_reg or LPR_reg.
+* @param	QueuePtr is where the service is stored.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void DdrQos_GetQueue(u32 Addr, DdrQos_Queue *QueuePtr)
+{
+	u32 Reg = Xil_In32(Addr);
+
+	QueuePtr->MinNonCritical = (u16)(Reg & DDR_QOS_MIN_NC_MASK);
+	QueuePtr->MaxStarve = (u16)((Reg & DDR_QOS_STARVE_MASK) >>
+				    DDR_QOS_STARVE_SHIFT);
+	QueuePtr->RunLength = (u8)((Reg & DDR_QOS_RUN_MASK) >>
+				   DDR_QOS_RUN_SHIFT);
+}
+
+/****************************************************************************/
+/*
+*
+* Writes the service of a read queue, the other bits of the register kept.
+*
+* @param	Addr is the address of HPR_reg or LPR_reg.
+* @param	QueuePtr is the service.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void DdrQos_SetQueue(u32 Addr, const DdrQos_Queue *QueuePtr)
+{
+	u32 Reg;
+
+	Reg = Xil_In32(Addr) & ~(DDR_QOS_MIN_NC_MASK | DDR_QOS_STARVE_MASK |
+				 DDR_QOS_RUN_MASK);
+	Reg |= (u32)QueuePtr->MinNonCritical;
+	Reg |= (u32)QueuePtr->MaxStarve << DDR_QOS_STARVE_SHIFT;
+	Reg |= (u32)QueuePtr->RunLength << DDR_QOS_RUN_SHIFT;
+	Xil_Out32(Addr, Reg);
+}
+
+/****************************************************************************/
+/*
+*
+* Reads the limit of outstanding transactions of a QoS-301 regulator.
+*
+* @param	BaseAddr is the base address of the regulator.
+*
+* @return	The limit of the reads, 0 if the limit is not enabled.
+*
+*****************************************************************************/
+static u8 DdrQos_GetMaxOt(u32 BaseAddr)
+{
+	if ((Xil_In32(BaseAddr + DDR_QOS_CNTL_OFFSET) &
+	     (DDR_QOS_EN_AR_OT | DDR_QOS_EN_AW_OT)) == 0U) {
+		return 0U;
+	}
+
+	return (u8)((Xil_In32(BaseAddr + DDR_QOS_MAX_OT_OFFSET) &
+		     DDR_QOS_AR_OTI_MASK) >> DDR_QOS_AR_OTI_SHIFT);
+}
+
+/****************************************************************************/
+/*
+*
+* Limits the outstanding reads and writes of a QoS-301 regulator, without
+* fraction, or lifts the limit.
+*
+* @param	BaseAddr is the base address of the regulator.
+* @param	MaxOt is the limit, 0 for none.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void DdrQos_SetMaxOt(u32 BaseAddr, u8 MaxOt)
+{
+	u32 Cntl = Xil_In32(BaseAddr + DDR_QOS_CNTL_OFFSET) &
+		   ~(DDR_QOS_EN_AR_OT | DDR_QOS_EN_AW_OT);
+
+	if (MaxOt == 0U) {
+		Xil_Out32(BaseAddr + DDR_QOS_CNTL_OFFSET, Cntl);
+		return;
+	}
+
+	Xil_Out32(BaseAddr + DDR_QOS_MAX_OT_OFFSET,
+		  ((u32)MaxOt << DDR_QOS_AR_OTI_SHIFT) |
+		  ((u32)MaxOt << DDR_QOS_AW_OTI_SHIFT));
+	Xil_Out32(BaseAddr + DDR_QOS_CNTL_OFFSET,
+		  Cntl | DDR_QOS_EN_AR_OT | DDR_QOS_EN_AW_OT);
+}
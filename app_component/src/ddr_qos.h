@@ -0,0 +1,150 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file ddr_qos.h
+*
+* Run time quality of service profiles of the DDR controller and of the
+* masters of the central interconnect.
+*
+* ps7_init.c sets the arbitration of the DDR controller once: the four AXI
+* ports at the same, lowest, priority, and the queue of the high priority
+* reads (HPR) unused. A burst of the PS DMA, the PCAP or an HP port then
+* gets as many turns as the CPUs. A profile sets, switched by DdrQos_Set():
+*
+* - the read and write priority of each port, an aging count from 0, the
+*   highest, to DDR_QOS_PRIORITY_LOWEST,
+* - which ports have their reads put in the HPR queue,
+* - the service of the HPR and of the low priority (LPR) read queues: how
+*   long a queue stays non critical, how long it may starve before it turns
+*   critical, and how many of its reads are served in a row then, and
+* - the outstanding transactions of the PS DMA controller and of the IOP
+*   masters, limited by their QoS-301 regulators in the GPV of the central
+*   interconnect, 0 for no limit.
+*
+* The profiles are:
+*
+* - DDR_QOS_DEFAULT, the arbitration ps7_init.c left, as it was read by
+*   DdrQos_Initialize().
+* - DDR_QOS_CPU_FIRST, the CPU port first with its reads in the HPR queue,
+*   the other ports last and the PS DMA limited to a few transactions in
+*   flight, for the latency of the CPUs.
+* - DDR_QOS_DMA_FIRST, the central interconnect and the HP ports first with
+*   their reads in the HPR queue and the CPU port last, for the throughput
+*   of bulk transfers.
+*
+* Any other arbitration may be applied with DdrQos_Apply(). The split of
+* the read CAM between the HPR and the LPR queue can only be set while the
+* controller is in reset, it stays as ps7_init.c set it. The AXI ports of
+* the controller are DDR_QOS_PORT_CPU, the L2 cache of the CPUs and the
+* ACP, DDR_QOS_PORT_IC, the central interconnect with the PS DMA, the PCAP,
+* the IOP masters and the GP slave ports, and DDR_QOS_PORT_HP01 and
+* DDR_QOS_PORT_HP23, the HP ports of the PL two by two.
+*
+* @code
+*	(void)DdrQos_Initialize(&Qos);
+*	(void)DdrQos_Set(&Qos, DDR_QOS_DMA_FIRST);	// bitstream load
+*	(void)DdrQos_Set(&Qos, DDR_QOS_CPU_FIRST);	// control loop
+* @endcode
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef DDR_QOS_H
+#define DDR_QOS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions ****************************/
+
+/** @name Profiles
+ * @{
+ */
+#define DDR_QOS_DEFAULT		0U	/**< As ps7_init.c set it */
+#define DDR_QOS_CPU_FIRST	1U	/**< CPU latency first */
+#define DDR_QOS_DMA_FIRST	2U	/**< Bulk DMA first */
+#define DDR_QOS_NUM		3U
+#define DDR_QOS_CUSTOM		0xFFU	/**< Set by DdrQos_Apply() */
+/* @} */
+
+/** @name AXI ports of the DDR controller
+ * @{
+ */
+#define DDR_QOS_PORT_CPU	0U	/**< L2 cache and ACP */
+#define DDR_QOS_PORT_IC		1U	/**< Central interconnect */
+#define DDR_QOS_PORT_HP01	2U	/**< HP0 and HP1 */
+#define DDR_QOS_PORT_HP23	3U	/**< HP2 and HP3 */
+#define DDR_QOS_NUM_PORTS	4U
+/* @} */
+
+#define DDR_QOS_PRIORITY_LOWEST	0x3FFU	/**< 0 is the highest */
+#define DDR_QOS_CYCLES_MAX	0x7FFU	/**< Of a queue, in 32 clocks */
+#define DDR_QOS_RUN_MAX		0xFU	/**< Reads in a row */
+#define DDR_QOS_OT_MAX		63U	/**< Transactions in flight */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Service of a read queue of the DDR controller.
+ */
+typedef struct {
+	u16 MinNonCritical;	/**< Stays non critical, in 32 clocks */
+	u16 MaxStarve;		/**< Turns critical after, in 32 clocks */
+	u8 RunLength;		/**< Reads served in a row once critical */
+} DdrQos_Queue;
+
+/**
+ * An arbitration of the DDR controller and the central interconnect.
+ */
+typedef struct {
+	u16 RdPriority[DDR_QOS_NUM_PORTS];	/**< Per port */
+	u16 WrPriority[DDR_QOS_NUM_PORTS];	/**< Per port */
+	u8 RdHpr[DDR_QOS_NUM_PORTS];	/**< Reads of the port in the HPR */
+	DdrQos_Queue Hpr;		/**< High priority reads */
+	DdrQos_Queue Lpr;		/**< Low priority reads */
+	u8 DmacMaxOt;		/**< Of the PS DMA, 0 for no limit */
+	u8 IouMaxOt;		/**< Of the IOP masters, 0 for no limit */
+} DdrQos_Profile;
+
+/**
+ * The service.
+ */
+typedef struct {
+	DdrQos_Profile Default;	/**< Read by DdrQos_Initialize() */
+	u32 Profile;		/**< Current profile */
+	u32 Switches;		/**< Profiles applied */
+	u32 IsReady;
+} DdrQos;
+
+/************************** Function Prototypes *****************************/
+
+s32 DdrQos_Initialize(DdrQos *InstancePtr);
+s32 DdrQos_Set(DdrQos *InstancePtr, u32 Profile);
+s32 DdrQos_SetByName(DdrQos *InstancePtr, const char *Name);
+s32 DdrQos_Apply(DdrQos *InstancePtr, const DdrQos_Profile *ProfilePtr);
+s32 DdrQos_GetSettings(const DdrQos *InstancePtr, u32 Profile,
+		       DdrQos_Profile *ProfilePtr);
+u32 DdrQos_GetProfile(const DdrQos *InstancePtr);
+const char *DdrQos_GetName(u32 Profile);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DDR_QOS_H */
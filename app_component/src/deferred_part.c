@@ -0,0 +1,409 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file deferred_part.c
+*
+* Background loading of the deferred partitions. Refer to deferred_part.h
+* for how it is used.
+*
+* The MD5 is the one of RFC 1321, over the copy in DDR as the FSBL takes
+* it. DEFERRED_PART_CHUNK is a multiple of the 64 byte block of MD5, so
+* that each poll but the last hashes whole blocks of what it copied.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "xil_cache.h"
+#include "xil_mem.h"
+#include "deferred_part.h"
+
+/************************** Constant Definitions ****************************/
+
+#define DEFERRED_PART_BLOCK	64U	/* Bytes of an MD5 block */
+
+#define DEFERRED_PART_TABLE_WORDS	((sizeof(DeferredPart_Table) / 4U) - 1U)
+
+#if (DEFERRED_PART_CHUNK % DEFERRED_PART_BLOCK) != 0
+#error "DEFERRED_PART_CHUNK must be a multiple of 64"
+#endif
+
+/************************** Function Prototypes *****************************/
+
+static void DeferredPart_Md5Init(u32 *Md5);
+static void DeferredPart_Md5Blocks(u32 *Md5, const u8 *Data, u32 NumBlocks);
+static void DeferredPart_Md5Final(u32 *Md5, const u8 *Data, u32 Rest,
+				  u32 NumBytes);
+
+/************************** Variable Definitions ****************************/
+
+/* Sines and shifts of RFC 1321 */
+static const u32 DeferredPart_Md5Sine[64] = {
+	0xd76aa478U, 0xe8c7b756U, 0x242070dbU, 0xc1bdceeeU,
+	0xf57c0fafU, 0x4787c62aU, 0xa8304613U, 0xfd469501U,
+	0x698098d8U, 0x8b44f7afU, 0xffff5bb1U, 0x895cd7beU,
+	0x6b901122U, 0xfd987193U, 0xa679438eU, 0x49b40821U,
+	0xf61e2562U, 0xc040b340U, 0x265e5a51U, 0xe9b6c7aaU,
+	0xd62f105dU, 0x02441453U, 0xd8a1e681U, 0xe7d3fbc8U,
+	0x21e1cde6U, 0xc33707d6U, 0xf4d50d87U, 0x455a14edU,
+	0xa9e3e905U, 0xfcefa3f8U, 0x676f02d9U, 0x8d2a4c8aU,
+	0xfffa3942U, 0x8771f681U, 0x6d9d6122U, 0xfde5380cU,
+	0xa4beea44U, 0x4bdecfa9U, 0xf6bb4b60U, 0xbebfbc70U,
+	0x289b7ec6U, 0xeaa127faU, 0xd4ef3085U, 0x04881d05U,
+	0xd9d4d039U, 0xe6db99e5U, 0x1fa27cf8U, 0xc4ac5665U,
+	0xf4292244U, 0x432aff97U, 0xab9423a7U, 0xfc93a039U,
+	0x655b59c3U, 0x8f0ccc92U, 0xffeff47dU, 0x85845dd1U,
+	0x6fa87e4fU, 0xfe2ce6e0U, 0xa3014314U, 0x4e0811a1U,
+	0xf7537e82U, 0xbd3af235U, 0x2ad7d2bbU, 0xeb86d391U
+};
+
+static const u8 DeferredPart_Md5Shift[16] = {
+	7U, 12U, 17U, 22U, 5U, 9U, 14U, 20U,
+	4U, 11U, 16U, 23U, 6U, 10U, 15U, 21U
+};
+
+/****************************************************************************/
+/**
+*
+* Takes the partitions of the handoff table the FSBL left in the high OCM.
+*
+* @param	DefPtr is a pointer to the partitions.
+*
+* @return
+*		- XST_SUCCESS if the table is valid.
+*		- XST_NO_DATA if there is none, the FSBL having loaded every
+*		partition at boot.
+*
+*****************************************************************************/
+s32 DeferredPart_Initialize(DeferredPart *DefPtr)
+{
+	const DeferredPart_Table *TablePtr =
+		(const DeferredPart_Table *)DEFERRED_PART_TABLE_ADDR;
+
+	(void)memset(DefPtr, 0, sizeof(*DefPtr));
+	DefPtr->Current = DEFERRED_PART_NONE;
+
+	if ((TablePtr->Magic != DEFERRED_PART_MAGIC) ||
+	    (TablePtr->Count > DEFERRED_PART_MAX) ||
+	    (TablePtr->Checksum != Xil_MemSum32((const u32 *)TablePtr,
+						DEFERRED_PART_TABLE_WORDS))) {
+		return XST_NO_DATA;
+	}
+
+	DefPtr->Count = TablePtr->Count;
+	(void)memcpy(DefPtr->Entry, TablePtr->Entry,
+		     DefPtr->Count * sizeof(DeferredPart_Entry));
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Finds the partition an address is loaded to.
+*
+* @param	DefPtr is a pointer to the partitions.
+* @param	LoadAddr is an address of the partition.
+*
+* @return	The index of the partition, DEFERRED_PART_NONE if the FSBL
+*		left none there.
+*
+*****************************************************************************/
+u32 DeferredPart_Find(const DeferredPart *DefPtr, u32 LoadAddr)
+{
+	u32 Index;
+
+	for (Index = 0U; Index < DefPtr->Count; Index++) {
+		if ((LoadAddr >= DefPtr->Entry[Index].LoadAddr) &&
+		    ((LoadAddr - DefPtr->Entry[Index].LoadAddr) <
+		     DefPtr->Entry[Index].Length)) {
+			return Index;
+		}
+	}
+
+	return DEFERRED_PART_NONE;
+}
+
+/****************************************************************************/
+/**
+*
+* Tells whether the data at an address is there to be used.
+*
+* @param	DefPtr is a pointer to the partitions.
+* @param	LoadAddr is the address.
+*
+* @return	1 if the FSBL loaded it, or it is in a partition loaded and
+*		checked since, 0 otherwise.
+*
+*****************************************************************************/
+u32 DeferredPart_IsLoaded(const DeferredPart *DefPtr, u32 LoadAddr)
+{
+	u32 Index = DeferredPart_Find(DefPtr, LoadAddr);
+
+	if (Index == DEFERRED_PART_NONE) {
+		return 1U;
+	}
+
+	return (DefPtr->State[Index] == DEFERRED_PART_LOADED) ? 1U : 0U;
+}
+
+/****************************************************************************/
+/**
+*
+* Queues a partition to be loaded by DeferredPart_Poll(). A partition that
+* failed is loaded again.
+*
+* @param	DefPtr is a pointer to the partitions.
+* @param	Index is the partition.
+*
+* @return
+*		- XST_SUCCESS if it is queued or already loaded.
+*		- XST_INVALID_PARAM if there is no such partition.
+*
+*****************************************************************************/
+s32 DeferredPart_Start(DeferredPart *DefPtr, u32 Index)
+{
+	if (Index >= DefPtr->Count) {
+		return XST_INVALID_PARAM;
+	}
+
+	if (DefPtr->State[Index] != DEFERRED_PART_LOADED) {
+		DefPtr->State[Index] = DEFERRED_PART_QUEUED;
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Queues every partition the FSBL left in the boot device, in the order of
+* the boot image.
+*
+* @param	DefPtr is a pointer to the partitions.
+*
+* @return	None.
+*
+*****************************************************************************/
+void DeferredPart_StartAll(DeferredPart *DefPtr)
+{
+	u32 Index;
+
+	for (Index = 0U; Index < DefPtr->Count; Index++) {
+		(void)DeferredPart_Start(DefPtr, Index);
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Copies the next DEFERRED_PART_CHUNK bytes of the first partition queued
+* from the boot device, and checks the partition once it is complete. To
+* be called from the main loop while partitions are queued.
+*
+* The partition is flushed from the data cache once loaded, for the other
+* masters and CPU1; the instruction cache is left to the caller for a
+* partition of code.
+*
+* @param	DefPtr is a pointer to the partitions.
+*
+* @return
+*		- XST_SUCCESS if no partition is queued any more.
+*		- XST_DEVICE_BUSY if one still is.
+*		- XST_FAILURE if a partition just failed its checksum, it is
+*		then DEFERRED_PART_FAILED.
+*
+*****************************************************************************/
+s32 DeferredPart_Poll(DeferredPart *DefPtr)
+{
+	const DeferredPart_Entry *EntryPtr;
+	u8 *DestPtr;
+	u32 NumBytes;
+	u32 Index;
+
+	if (DefPtr->Current == DEFERRED_PART_NONE) {
+		for (Index = 0U; Index < DefPtr->Count; Index++) {
+			if (DefPtr->State[Index] == DEFERRED_PART_QUEUED) {
+				break;
+			}
+		}
+		if (Index == DefPtr->Count) {
+			return XST_SUCCESS;
+		}
+		DefPtr->Current = Index;
+		DefPtr->Done = 0U;
+		DeferredPart_Md5Init(DefPtr->Md5);
+	}
+
+	EntryPtr = &DefPtr->Entry[DefPtr->Current];
+	DestPtr = (u8 *)(UINTPTR)(EntryPtr->LoadAddr + DefPtr->Done);
+	NumBytes = EntryPtr->Length - DefPtr->Done;
+	if (NumBytes > DEFERRED_PART_CHUNK) {
+		NumBytes = DEFERRED_PART_CHUNK;
+	}
+
+	(void)memcpy(DestPtr, (const u8 *)(UINTPTR)(EntryPtr->FlashAddr +
+						    DefPtr->Done), NumBytes);
+	DeferredPart_Md5Blocks(DefPtr->Md5, DestPtr,
+			       NumBytes / DEFERRED_PART_BLOCK);
+	DefPtr->Done += NumBytes;
+	if (DefPtr->Done < EntryPtr->Length) {
+		return XST_DEVICE_BUSY;
+	}
+
+	DeferredPart_Md5Final(DefPtr->Md5, DestPtr + (NumBytes &
+			      ~(DEFERRED_PART_BLOCK - 1U)),
+			      NumBytes & (DEFERRED_PART_BLOCK - 1U),
+			      EntryPtr->Length);
+	Xil_DCacheFlushRange((UINTPTR)EntryPtr->LoadAddr, EntryPtr->Length);
+
+	Index = DefPtr->Current;
+	DefPtr->Current = DEFERRED_PART_NONE;
+	if (((EntryPtr->Flags & DEFERRED_PART_CHECKSUM) != 0U) &&
+	    (memcmp(DefPtr->Md5, EntryPtr->Checksum,
+		    sizeof(DefPtr->Md5)) != 0)) {
+		DefPtr->State[Index] = DEFERRED_PART_FAILED;
+		return XST_FAILURE;
+	}
+	DefPtr->State[Index] = DEFERRED_PART_LOADED;
+
+	for (Index = 0U; Index < DefPtr->Count; Index++) {
+		if (DefPtr->State[Index] == DEFERRED_PART_QUEUED) {
+			return XST_DEVICE_BUSY;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Loads a partition at once, and the partitions queued before it.
+*
+* @param	DefPtr is a pointer to the partitions.
+* @param	Index is the partition.
+*
+* @return
+*		- XST_SUCCESS if it is loaded and checked.
+*		- XST_INVALID_PARAM if there is no such partition.
+*		- XST_FAILURE if it failed its checksum.
+*
+*****************************************************************************/
+s32 DeferredPart_Load(DeferredPart *DefPtr, u32 Index)
+{
+	s32 Status;
+
+	Status = DeferredPart_Start(DefPtr, Index);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	while (DefPtr->State[Index] == DEFERRED_PART_QUEUED) {
+		(void)DeferredPart_Poll(DefPtr);
+	}
+
+	return (DefPtr->State[Index] == DEFERRED_PART_LOADED) ?
+		XST_SUCCESS : XST_FAILURE;
+}
+
+/*
+ * Starts an MD5.
+ */
+static void DeferredPart_Md5Init(u32 *Md5)
+{
+	Md5[0] = 0x67452301U;
+	Md5[1] = 0xefcdab89U;
+	Md5[2] = 0x98badcfeU;
+	Md5[3] = 0x10325476U;
+}
+
+/*
+ * Adds whole 64 byte blocks to an MD5, the Cortex-A9 being little endian
+ * as MD5 is.
+ */
+static void DeferredPart_Md5Blocks(u32 *Md5, const u8 *Data, u32 NumBlocks)
+{
+	u32 Words[16];
+	u32 A;
+	u32 B;
+	u32 C;
+	u32 D;
+	u32 F;
+	u32 G;
+	u32 Step;
+	u32 Shift;
+
+	while (NumBlocks-- != 0U) {
+		(void)memcpy(Words, Data, sizeof(Words));
+		Data += DEFERRED_PART_BLOCK;
+		A = Md5[0];
+		B = Md5[1];
+		C = Md5[2];
+		D = Md5[3];
+
+		for (Step = 0U; Step < 64U; Step++) {
+			if (Step < 16U) {
+				F = D ^ (B & (C ^ D));
+				G = Step;
+			} else if (Step < 32U) {
+				F = C ^ (D & (B ^ C));
+				G = ((5U * Step) + 1U) & 15U;
+			} else if (Step < 48U) {
+				F = B ^ C ^ D;
+				G = ((3U * Step) + 5U) & 15U;
+			} else {
+				F = C ^ (B | ~D);
+				G = (7U * Step) & 15U;
+			}
+			F += A + DeferredPart_Md5Sine[Step] + Words[G];
+			Shift = DeferredPart_Md5Shift[((Step >> 4) << 2) +
+						      (Step & 3U)];
+			A = D;
+			D = C;
+			C = B;
+			B += (F << Shift) | (F >> (32U - Shift));
+		}
+
+		Md5[0] += A;
+		Md5[1] += B;
+		Md5[2] += C;
+		Md5[3] += D;
+	}
+}
+
+/*
+ * Ends an MD5 with the last bytes, fewer than a block, and the padding.
+ */
+static void DeferredPart_Md5Final(u32 *Md5, const u8 *Data, u32 Rest,
+				  u32 NumBytes)
+{
+	u8 Block[2U * DEFERRED_PART_BLOCK];
+	u32 Blocks = (Rest < (DEFERRED_PART_BLOCK - 8U)) ? 1U : 2U;
+	u32 End = Blocks * DEFERRED_PART_BLOCK;
+	u64 Bits = (u64)NumBytes * 8U;
+	u32 Index;
+
+	(void)memset(Block, 0, sizeof(Block));
+	(void)memcpy(Block, Data, Rest);
+	Block[Rest] = 0x80U;
+	for (Index = 0U; Index < 8U; Index++) {
+		Block[End - 8U + Index] = (u8)(Bits >> (8U * Index));
+	}
+
+	DeferredPart_Md5Blocks(Md5, Block, Blocks);
+}
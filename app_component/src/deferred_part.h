@@ -0,0 +1,168 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file deferred_part.h
+*
+* Background loading of the partitions the FSBL built with FSBL_DEFERRED
+* left in the boot device.
+*
+* A plain PS partition with the deferred attribute of the FSBL set, such as
+* a large lookup table the application needs well after it starts, is not
+* loaded at boot: the FSBL lists it in a handoff table in the high OCM
+* instead, with its address in the memory window of the boot device, its
+* load address and length and the MD5 checksum the boot image holds for
+* it, refer to fsbl_deferred.h of the FSBL. The bridge then serves the UART
+* that much earlier after power-on.
+*
+* DeferredPart_Initialize() takes the table, before anything is written
+* to the top of the high OCM. DeferredPart_Start() queues a partition and
+* DeferredPart_Poll(), called from the main loop, copies
+* DEFERRED_PART_CHUNK bytes of the first one queued per call and checks
+* its MD5 once it is complete, the way the FSBL checks the partitions it
+* loads. DeferredPart_Load() loads one at once.
+*
+* The partitions are read through the memory window of the boot device,
+* in the mode the FSBL left it in for its own reads, quad or dual parallel
+* included. The controller must stay in linear mode: the I/O mode of
+* qspi_flash.h takes the window, so QspiFlash_Initialize() comes after
+* the partitions are loaded.
+*
+* Without a valid table, after a boot by an FSBL without FSBL_DEFERRED or
+* from a non-linear boot device, the FSBL loaded every partition at boot,
+* and DeferredPart_IsLoaded() holds for any address.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef DEFERRED_PART_H
+#define DEFERRED_PART_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions ****************************/
+
+/** @name The handoff table of fsbl_deferred.h
+ * @{
+ */
+#define DEFERRED_PART_TABLE_ADDR 0xFFFFF400U	/**< FSBL_DEFERRED_ADDR */
+#define DEFERRED_PART_MAGIC	0x31464446U	/**< "FDF1" */
+#define DEFERRED_PART_MAX	6U		/**< Entries of the table */
+#define DEFERRED_PART_CHECKSUM	0x1U		/**< Entry flag, MD5 given */
+/** @} */
+
+#ifndef DEFERRED_PART_CHUNK
+#define DEFERRED_PART_CHUNK	(64U * 1024U)	/**< Bytes per poll */
+#endif
+
+#define DEFERRED_PART_NONE	0xFFFFFFFFU	/**< No such partition */
+
+/** @name States of a partition
+ * @{
+ */
+#define DEFERRED_PART_LEFT	0U	/**< In the boot device */
+#define DEFERRED_PART_QUEUED	1U	/**< Being loaded */
+#define DEFERRED_PART_LOADED	2U	/**< Loaded and checked */
+#define DEFERRED_PART_FAILED	3U	/**< Its checksum did not match */
+/** @} */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * A partition of the table, FsblDeferredEntry of the FSBL.
+ */
+typedef struct {
+	u32 PartitionNum;	/**< In the boot image */
+	u32 FlashAddr;		/**< In the memory window of the device */
+	u32 LoadAddr;
+	u32 Length;		/**< Bytes */
+	u32 Flags;		/**< DEFERRED_PART_CHECKSUM or 0 */
+	u32 Checksum[4];	/**< MD5 in the boot image */
+} DeferredPart_Entry;
+
+/**
+ * The table in the high OCM, FsblDeferredTable of the FSBL.
+ */
+typedef struct {
+	u32 Magic;		/**< DEFERRED_PART_MAGIC once valid */
+	u32 Count;
+	DeferredPart_Entry Entry[DEFERRED_PART_MAX];
+	u32 Checksum;		/**< Xil_MemSum32 of the words above */
+} DeferredPart_Table;
+
+/**
+ * The partitions and the load in progress.
+ */
+typedef struct {
+	u32 Count;		/**< Partitions left by the FSBL */
+	DeferredPart_Entry Entry[DEFERRED_PART_MAX];
+	u8 State[DEFERRED_PART_MAX];	/**< DEFERRED_PART_LEFT... */
+	u32 Current;		/**< Partition being loaded, or NONE */
+	u32 Done;		/**< Bytes of it copied */
+	u32 Md5[4];		/**< Of the bytes copied */
+} DeferredPart;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/****************************************************************************/
+/**
+*
+* Returns the state of a partition.
+*
+* @param	DefPtr is a pointer to the partitions.
+* @param	Index is the partition, from 0 to DeferredPart_GetCount() - 1.
+*
+* @return	DEFERRED_PART_LEFT, QUEUED, LOADED or FAILED.
+*
+* @note		C-style signature:
+*		u32 DeferredPart_GetState(const DeferredPart *DefPtr, u32 Index)
+*
+*****************************************************************************/
+#define DeferredPart_GetState(DefPtr, Index)	((u32)(DefPtr)->State[(Index)])
+
+/****************************************************************************/
+/**
+*
+* Returns the number of partitions the FSBL left in the boot device.
+*
+* @param	DefPtr is a pointer to the partitions.
+*
+* @return	The number, 0 without a table.
+*
+* @note		C-style signature:
+*		u32 DeferredPart_GetCount(const DeferredPart *DefPtr)
+*
+*****************************************************************************/
+#define DeferredPart_GetCount(DefPtr)	((DefPtr)->Count)
+
+/************************** Function Prototypes *****************************/
+
+s32 DeferredPart_Initialize(DeferredPart *DefPtr);
+u32 DeferredPart_Find(const DeferredPart *DefPtr, u32 LoadAddr);
+u32 DeferredPart_IsLoaded(const DeferredPart *DefPtr, u32 LoadAddr);
+s32 DeferredPart_Start(DeferredPart *DefPtr, u32 Index);
+void DeferredPart_StartAll(DeferredPart *DefPtr);
+s32 DeferredPart_Poll(DeferredPart *DefPtr);
+s32 DeferredPart_Load(DeferredPart *DefPtr, u32 Index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEFERRED_PART_H */
@@ -0,0 +1,539 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file dfx_mgr.c
+*
+* Partial reconfiguration manager. Refer to dfx_mgr.h for how the swaps are
+* run.
+*
+* The PCAP is left to the CPU for partial reconfiguration at
+* initialization, PCAP_PR and PCAP_MODE set in the devcfg control register.
+* PROG_B is never touched, which would clear the whole PL.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xil_io.h"
+#include "xil_cache.h"
+#include "xil_mem.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xinterrupt_wrap.h"
+#include "dfx_mgr.h"
+#include "drvcfg.h"
+
+/************************** Constant Definitions ****************************/
+
+/* Marks the last DMA command of a transfer, on both addresses */
+#define DFX_MGR_LAST_TRANSFER	1U
+
+/* Devcfg interrupts ending a swap */
+#define DFX_MGR_INTR_MASK	(XDCFG_IXR_D_P_DONE_MASK | \
+				 XDCFG_IXR_ERROR_FLAGS_MASK)
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static void DfxMgr_IntrHandler(void *CallBackRef, u32 IntrStatus);
+static void DfxMgr_Finish(DfxMgr *MgrPtr, s32 Status);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* Sets up the device configuration interface for partial reconfiguration
+* and connects its interrupt.
+*
+* @param	MgrPtr is a pointer to the manager.
+*
+* @return
+*		- XST_SUCCESS if the manager is ready.
+*		- XST_FAILURE if the devcfg is not found or its interrupt
+*		  could not be connected.
+*		- The error of the failing driver call otherwise.
+*
+* @note		The PL must have been configured with the static design,
+*		by the FSBL or the debugger.
+*
+*****************************************************************************/
+s32 DfxMgr_Initialize(DfxMgr *MgrPtr)
+{
+	XDcfg_Config *CfgPtr;
+	s32 Status;
+
+	MgrPtr->NumRegions = 0U;
+	MgrPtr->NumBitstreams = 0U;
+	MgrPtr->Busy = 0U;
+	MgrPtr->Lent = 0U;
+	MgrPtr->Status = (s32)XST_SUCCESS;
+
+	CfgPtr = XDcfg_LookupConfigStatic(XPAR_XDEVCFG_0_BASEADDR);
+	if (CfgPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	Status = XDcfg_CfgInitialize(&MgrPtr->Dcfg, CfgPtr,
+				     CfgPtr->BaseAddr);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	XDcfg_IntrDisable(&MgrPtr->Dcfg, 0xFFFFFFFFU);
+	XDcfg_IntrClear(&MgrPtr->Dcfg, 0xFFFFFFFFU);
+	XDcfg_SetHandler(&MgrPtr->Dcfg, (void *)DfxMgr_IntrHandler, MgrPtr);
+
+	Status = XSetupInterruptSystem(&MgrPtr->Dcfg, &XDcfg_InterruptHandler,
+				       CfgPtr->IntrId, CfgPtr->IntrParent,
+				       XINTERRUPT_DEFAULT_PRIORITY);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	/* The CPU drives the PCAP, for partial reconfiguration */
+	XDcfg_SelectPcapInterface(&MgrPtr->Dcfg);
+	XDcfg_EnablePCAP(&MgrPtr->Dcfg);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Registers a reconfigurable region.
+*
+* @param	MgrPtr is a pointer to the manager.
+* @param	Decouple is called to decouple the region around its loads,
+*		NULL if the region needs no decoupling.
+* @param	DecoupleRef is passed to Decouple.
+* @param	RegionIdPtr returns the identifier of the region.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if DFX_MGR_MAX_REGIONS regions
+*		are already registered.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 DfxMgr_AddRegion(DfxMgr *MgrPtr, DfxMgr_DecoupleHandler Decouple,
+		     void *DecoupleRef, u32 *RegionIdPtr)
+{
+	DfxMgr_Region *RegionPtr;
+
+	if (MgrPtr->NumRegions >= DFX_MGR_MAX_REGIONS) {
+		return XST_FAILURE;
+	}
+
+	RegionPtr = &MgrPtr->Region[MgrPtr->NumRegions];
+	RegionPtr->Decouple = Decouple;
+	RegionPtr->DecoupleRef = DecoupleRef;
+	RegionPtr->Loaded = DFX_MGR_NONE;
+	RegionPtr->Stats.Swaps = 0U;
+	RegionPtr->Stats.Hits = 0U;
+	RegionPtr->Stats.Failures = 0U;
+	RegionPtr->Stats.LastUs = 0U;
+	RegionPtr->Stats.MinUs = 0U;
+	RegionPtr->Stats.MaxUs = 0U;
+	RegionPtr->Stats.TotalUs = 0U;
+
+	*RegionIdPtr = MgrPtr->NumRegions;
+	MgrPtr->NumRegions++;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Registers a partial bitstream of a region. The bitstream is copied into
+* the DMA arena when it has room. Otherwise it is used in place, flushed
+* from the data cache, and must not be changed or freed afterwards.
+*
+* @param	MgrPtr is a pointer to the manager.
+* @param	RegionId is the region the bitstream configures.
+* @param	DataPtr is the bitstream, in the .bin format of bootgen,
+*		word aligned.
+* @param	NumBytes is the length of the bitstream, a multiple of 4.
+* @param	BitstreamIdPtr returns the identifier of the bitstream.
+*
+* @return
+*		- XST_SUCCESS if the bitstream is registered.
+*		- XST_INVALID_PARAM if the region or the bitstream is
+*		  invalid.
+*		- XST_FAILURE if DFX_MGR_MAX_BITSTREAMS bitstreams are
+*		  already registered.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 DfxMgr_AddBitstream(DfxMgr *MgrPtr, u32 RegionId, const void *DataPtr,
+			u32 NumBytes, u32 *BitstreamIdPtr)
+{
+	DfxMgr_Bitstream *BitPtr;
+	void *CopyPtr = NULL;
+
+	if ((RegionId >= MgrPtr->NumRegions) || (DataPtr == NULL) ||
+	    (NumBytes == 0U) || ((NumBytes & 3U) != 0U) ||
+	    (((UINTPTR)DataPtr & 3U) != 0U)) {
+		return XST_INVALID_PARAM;
+	}
+	if (MgrPtr->NumBitstreams >= DFX_MGR_MAX_BITSTREAMS) {
+		return XST_FAILURE;
+	}
+
+	BitPtr = &MgrPtr->Bitstream[MgrPtr->NumBitstreams];
+	BitPtr->RegionId = RegionId;
+	BitPtr->WordLen = NumBytes >> 2;
+
+	if (Xil_DmaPoolCreate(&BitPtr->Pool, NumBytes, 1U) == XST_SUCCESS) {
+		CopyPtr = Xil_DmaPoolAlloc(&BitPtr->Pool);
+	}
+
+	if (CopyPtr != NULL) {
+		Xil_MemCpy(CopyPtr, DataPtr, NumBytes);
+		BitPtr->DataPtr = (const u32 *)CopyPtr;
+	} else {
+		Xil_DCacheFlushRange((INTPTR)DataPtr, NumBytes);
+		BitPtr->DataPtr = (const u32 *)DataPtr;
+	}
+
+	*BitstreamIdPtr = MgrPtr->NumBitstreams;
+	MgrPtr->NumBitstreams++;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Starts loading a partial bitstream in its region and returns without
+* waiting for it. The region is decoupled first, and coupled again once
+* the load is done.
+*
+* @param	MgrPtr is a pointer to the manager.
+* @param	BitstreamId is the bitstream to load.
+* @param	DoneHandler is called at the end of the swap, from the devcfg
+*		interrupt, or from this function if the bitstream is already
+*		loaded. May be NULL.
+* @param	CallBackRef is passed to DoneHandler.
+*
+* @return
+*		- XST_SUCCESS if the swap is started or done.
+*		- XST_INVALID_PARAM if the bitstream is not registered.
+*		- XST_DEVICE_BUSY if a swap is running.
+*		- XST_FAILURE if the PCAP could not be started, in which case
+*		  the region keeps its bitstream and is coupled again.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 DfxMgr_SwapRegion(DfxMgr *MgrPtr, u32 BitstreamId,
+		      DfxMgr_DoneHandler DoneHandler, void *CallBackRef)
+{
+	DfxMgr_Bitstream *BitPtr;
+	DfxMgr_Region *RegionPtr;
+	u32 Status;
+	u32 Cpsr;
+
+	if (BitstreamId >= MgrPtr->NumBitstreams) {
+		return XST_INVALID_PARAM;
+	}
+
+	BitPtr = &MgrPtr->Bitstream[BitstreamId];
+	RegionPtr = &MgrPtr->Region[BitPtr->RegionId];
+
+	/* The PCAP may be claimed from an interrupt, e.g. by the scrubber */
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	if ((MgrPtr->Busy != 0U) || (MgrPtr->Lent != 0U)) {
+		mtcpsr(Cpsr);
+		return XST_DEVICE_BUSY;
+	}
+	if (RegionPtr->Loaded != BitstreamId) {
+		MgrPtr->Busy = 1U;
+	}
+	mtcpsr(Cpsr);
+
+	if (RegionPtr->Loaded == BitstreamId) {
+		RegionPtr->Stats.Hits++;
+		if (DoneHandler != NULL) {
+			DoneHandler(CallBackRef, BitPtr->RegionId, BitstreamId,
+				    XST_SUCCESS);
+		}
+		return XST_SUCCESS;
+	}
+
+	MgrPtr->SwapBitstream = BitstreamId;
+	MgrPtr->DoneHandler = DoneHandler;
+	MgrPtr->DoneRef = CallBackRef;
+
+	XTime_GetTime(&MgrPtr->SwapStart);
+
+	if (RegionPtr->Decouple != NULL) {
+		RegionPtr->Decouple(RegionPtr->DecoupleRef, 1U);
+	}
+
+	XDcfg_IntrClear(&MgrPtr->Dcfg, DFX_MGR_INTR_MASK);
+	XDcfg_IntrEnable(&MgrPtr->Dcfg, DFX_MGR_INTR_MASK);
+
+	/* A bitstream is written to the PL, there is no destination */
+	Status = XDcfg_Transfer(&MgrPtr->Dcfg,
+				(void *)((UINTPTR)BitPtr->DataPtr |
+					 DFX_MGR_LAST_TRANSFER),
+				BitPtr->WordLen,
+				(void *)(XDCFG_DMA_INVALID_ADDRESS |
+					 DFX_MGR_LAST_TRANSFER),
+				BitPtr->WordLen, XDCFG_NON_SECURE_PCAP_WRITE);
+	if (Status != XST_SUCCESS) {
+		XDcfg_IntrDisable(&MgrPtr->Dcfg, DFX_MGR_INTR_MASK);
+		if (RegionPtr->Decouple != NULL) {
+			RegionPtr->Decouple(RegionPtr->DecoupleRef, 0U);
+		}
+		MgrPtr->Busy = 0U;
+		return XST_FAILURE;
+	}
+
+	/* Whatever was loaded is being overwritten */
+	RegionPtr->Loaded = DFX_MGR_NONE;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Tells whether a swap is running.
+*
+* @param	MgrPtr is a pointer to the manager.
+*
+* @return	1 if a swap is running, 0 otherwise.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 DfxMgr_IsBusy(const DfxMgr *MgrPtr)
+{
+	return MgrPtr->Busy;
+}
+
+/****************************************************************************/
+/**
+*
+* Claims the PCAP for another user than the swaps, between two swaps.
+*
+* @param	MgrPtr is a pointer to the manager.
+*
+* @return	XST_SUCCESS if the PCAP is claimed, XST_DEVICE_BUSY if a swap
+*		is running or the PCAP is already claimed.
+*
+* @note		The devcfg interrupts of the manager are disabled between
+*		swaps, so the claiming user polls its transfers. It may be
+*		called from an interrupt.
+*
+*****************************************************************************/
+s32 DfxMgr_ClaimPcap(DfxMgr *MgrPtr)
+{
+	s32 Status = XST_DEVICE_BUSY;
+	u32 Cpsr;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	if ((MgrPtr->Busy == 0U) && (MgrPtr->Lent == 0U)) {
+		MgrPtr->Lent = 1U;
+		Status = XST_SUCCESS;
+	}
+	mtcpsr(Cpsr);
+
+	return Status;
+}
+
+/****************************************************************************/
+/**
+*
+* Gives back the PCAP claimed with DfxMgr_ClaimPcap().
+*
+* @param	MgrPtr is a pointer to the manager.
+*
+* @return	None.
+*
+* @note		The transfers of the claiming user must have ended.
+*
+*****************************************************************************/
+void DfxMgr_ReleasePcap(DfxMgr *MgrPtr)
+{
+	MgrPtr->Lent = 0U;
+}
+
+/****************************************************************************/
+/**
+*
+* Waits for the running swap to end.
+*
+* @param	MgrPtr is a pointer to the manager.
+* @param	TimeoutUs is the longest wait in microseconds.
+*
+* @return	The status of the swap, or XST_FAILURE if it is still running
+*		after TimeoutUs.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 DfxMgr_Wait(const DfxMgr *MgrPtr, u32 TimeoutUs)
+{
+	XTime Start;
+	XTime Now;
+
+	XTime_GetTime(&Start);
+	while (MgrPtr->Busy != 0U) {
+		XTime_GetTime(&Now);
+		if ((Now - Start) >= (((XTime)TimeoutUs * COUNTS_PER_SECOND) /
+				      1000000U)) {
+			return XST_FAILURE;
+		}
+	}
+
+	return MgrPtr->Status;
+}
+
+/****************************************************************************/
+/**
+*
+* Gets the swap statistics of a region.
+*
+* @param	MgrPtr is a pointer to the manager.
+* @param	RegionId is the region.
+* @param	StatsPtr returns the statistics.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void DfxMgr_GetStats(const DfxMgr *MgrPtr, u32 RegionId,
+		     DfxMgr_Stats *StatsPtr)
+{
+	*StatsPtr = MgrPtr->Region[RegionId].Stats;
+}
+
+/****************************************************************************/
+/**
+*
+* Decouple handler for a decoupler controlled by a register, such as the
+* control register of a DFX Decoupler or the data register of an AXI GPIO
+* driving its decouple input.
+*
+* @param	CallBackRef is the address of the register.
+* @param	Decouple is written to the register.
+*
+* @return	None.
+*
+* @note		The register is read back, so that the write has reached
+*		the decoupler before the PCAP starts.
+*
+*****************************************************************************/
+void DfxMgr_DecoupleWrite(void *CallBackRef, u32 Decouple)
+{
+	Xil_Out32((UINTPTR)CallBackRef, Decouple);
+	(void)Xil_In32((UINTPTR)CallBackRef);
+}
+
+/****************************************************************************/
+/*
+*
+* Devcfg status handler, ends the running swap on the DMA and PCAP done or
+* on an error.
+*
+* @param	CallBackRef is the manager.
+* @param	IntrStatus is the devcfg interrupt status, already cleared.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void DfxMgr_IntrHandler(void *CallBackRef, u32 IntrStatus)
+{
+	DfxMgr *MgrPtr = (DfxMgr *)CallBackRef;
+
+	if (MgrPtr->Busy == 0U) {
+		return;
+	}
+
+	if ((IntrStatus & XDCFG_IXR_ERROR_FLAGS_MASK) != 0U) {
+		DfxMgr_Finish(MgrPtr, XST_FAILURE);
+	} else if ((IntrStatus & XDCFG_IXR_D_P_DONE_MASK) != 0U) {
+		DfxMgr_Finish(MgrPtr, XST_SUCCESS);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Ends the running swap: couples the region again if it loaded, updates its
+* statistics and calls the done handler.
+*
+* @param	MgrPtr is a pointer to the manager.
+* @param	Status is the status of the load.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void DfxMgr_Finish(DfxMgr *MgrPtr, s32 Status)
+{
+	u32 BitstreamId = MgrPtr->SwapBitstream;
+	u32 RegionId = MgrPtr->Bitstream[BitstreamId].RegionId;
+	DfxMgr_Region *RegionPtr = &MgrPtr->Region[RegionId];
+	DfxMgr_Stats *StatsPtr = &RegionPtr->Stats;
+	XTime Now;
+	u32 Us;
+
+	XDcfg_IntrDisable(&MgrPtr->Dcfg, DFX_MGR_INTR_MASK);
+
+	if (Status == XST_SUCCESS) {
+		/* A region that failed to load stays decoupled */
+		if (RegionPtr->Decouple != NULL) {
+			RegionPtr->Decouple(RegionPtr->DecoupleRef, 0U);
+		}
+		RegionPtr->Loaded = BitstreamId;
+
+		XTime_GetTime(&Now);
+		Us = (u32)(((Now - MgrPtr->SwapStart) * 1000000U) /
+			   COUNTS_PER_SECOND);
+
+		StatsPtr->LastUs = Us;
+		if ((StatsPtr->Swaps == 0U) || (Us < StatsPtr->MinUs)) {
+			StatsPtr->MinUs = Us;
+		}
+		if (Us > StatsPtr->MaxUs) {
+			StatsPtr->MaxUs = Us;
+		}
+		StatsPtr->TotalUs += Us;
+		StatsPtr->Swaps++;
+	} else {
+		StatsPtr->Failures++;
+	}
+
+	MgrPtr->Status = Status;
+	MgrPtr->Busy = 0U;
+
+	/* The handler may start the next swap */
+	if (MgrPtr->DoneHandler != NULL) {
+		MgrPtr->DoneHandler(MgrPtr->DoneRef, RegionId, BitstreamId,
+				    Status);
+	}
+}
@@ -0,0 +1,152 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file dfx_mgr.h
+*
+* Partial reconfiguration of the PL from the application, through the PCAP
+* of the device configuration interface.
+*
+* Reconfigurable regions are registered with the function that decouples
+* them from the static logic, and the partial bitstreams of each region
+* with DfxMgr_AddBitstream(). A partial bitstream is kept in DDR, copied
+* into the DMA arena when it has room and flushed from the data cache in
+* place otherwise, so that a swap needs no cache maintenance and starts the
+* PCAP at once.
+*
+* DfxMgr_SwapRegion() decouples the region and queues the partial bitstream
+* to the PCAP, then returns. The devcfg interrupt of the DMA and PCAP done,
+* or of an error, ends the swap: the region is coupled again on success and
+* the done handler of the swap is called from the interrupt. A region that
+* fails to load stays decoupled. One swap runs at a time, the PCAP being
+* a single resource.
+*
+* Other users of the PCAP, as the configuration scrubber of pl_scrub.h,
+* borrow it between swaps with DfxMgr_ClaimPcap() and give it back with
+* DfxMgr_ReleasePcap(); a swap is refused while the PCAP is lent out.
+*
+* The time of each swap, from the decoupling to the coupling, is kept per
+* region. The PCAP takes about 400 MB/s with unencrypted bitstreams, so a
+* region of up to a few MB swaps within 10 ms.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef DFX_MGR_H
+#define DFX_MGR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xil_dmaarena.h"
+#include "xiltimer.h"
+#include "xdevcfg.h"
+
+/************************** Constant Definitions ****************************/
+
+#define DFX_MGR_MAX_REGIONS	4U	/**< Reconfigurable regions */
+#define DFX_MGR_MAX_BITSTREAMS	16U	/**< Partial bitstreams */
+#define DFX_MGR_NONE		0xFFFFFFFFU /**< No bitstream loaded */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Decouples a region from the static logic when Decouple is 1, and couples
+ * it again when it is 0.
+ */
+typedef void (*DfxMgr_DecoupleHandler)(void *CallBackRef, u32 Decouple);
+
+/**
+ * Called from the devcfg interrupt at the end of a swap, with XST_SUCCESS
+ * or XST_FAILURE.
+ */
+typedef void (*DfxMgr_DoneHandler)(void *CallBackRef, u32 RegionId,
+				   u32 BitstreamId, s32 Status);
+
+/**
+ * Swap statistics of a region.
+ */
+typedef struct {
+	u32 Swaps;		/**< Bitstreams loaded */
+	u32 Hits;		/**< Swaps to the bitstream already loaded */
+	u32 Failures;		/**< Loads that failed */
+	u32 LastUs;		/**< Time of the last load */
+	u32 MinUs;		/**< Fastest load */
+	u32 MaxUs;		/**< Slowest load */
+	u64 TotalUs;		/**< Time of all the loads */
+} DfxMgr_Stats;
+
+/**
+ * A reconfigurable region.
+ */
+typedef struct {
+	DfxMgr_DecoupleHandler Decouple;
+	void *DecoupleRef;
+	u32 Loaded;		/**< Bitstream in the region, or DFX_MGR_NONE */
+	DfxMgr_Stats Stats;
+} DfxMgr_Region;
+
+/**
+ * A partial bitstream held in DDR.
+ */
+typedef struct {
+	u32 RegionId;		/**< Region it configures */
+	const u32 *DataPtr;	/**< Words of the bitstream */
+	u32 WordLen;
+	Xil_DmaPool Pool;	/**< Its block of the arena, if copied */
+} DfxMgr_Bitstream;
+
+/**
+ * The manager.
+ */
+typedef struct {
+	XDcfg Dcfg;		/**< Device configuration interface */
+	DfxMgr_Region Region[DFX_MGR_MAX_REGIONS];
+	u32 NumRegions;
+	DfxMgr_Bitstream Bitstream[DFX_MGR_MAX_BITSTREAMS];
+	u32 NumBitstreams;
+	volatile u32 Busy;	/**< A swap is running */
+	volatile u32 Lent;	/**< The PCAP is claimed by another user */
+	volatile s32 Status;	/**< Status of the last swap */
+	u32 SwapBitstream;	/**< Bitstream of the running swap */
+	XTime SwapStart;
+	DfxMgr_DoneHandler DoneHandler;
+	void *DoneRef;
+} DfxMgr;
+
+/************************** Function Prototypes *****************************/
+
+s32 DfxMgr_Initialize(DfxMgr *MgrPtr);
+s32 DfxMgr_AddRegion(DfxMgr *MgrPtr, DfxMgr_DecoupleHandler Decouple,
+		     void *DecoupleRef, u32 *RegionIdPtr);
+s32 DfxMgr_AddBitstream(DfxMgr *MgrPtr, u32 RegionId, const void *DataPtr,
+			u32 NumBytes, u32 *BitstreamIdPtr);
+s32 DfxMgr_SwapRegion(DfxMgr *MgrPtr, u32 BitstreamId,
+		      DfxMgr_DoneHandler DoneHandler, void *CallBackRef);
+u32 DfxMgr_IsBusy(const DfxMgr *MgrPtr);
+s32 DfxMgr_ClaimPcap(DfxMgr *MgrPtr);
+void DfxMgr_ReleasePcap(DfxMgr *MgrPtr);
+s32 DfxMgr_Wait(const DfxMgr *MgrPtr, u32 TimeoutUs);
+void DfxMgr_GetStats(const DfxMgr *MgrPtr, u32 RegionId,
+		     DfxMgr_Stats *StatsPtr);
+void DfxMgr_DecoupleWrite(void *CallBackRef, u32 Decouple);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DFX_MGR_H */
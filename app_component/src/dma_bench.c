@@ -0,0 +1,482 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file dma_bench.c
+*
+* Benchmark of the PS DMA controller. Refer to dma_bench.h for what is
+* measured.
+*
+* The program of a shape is generated once and held, so that only the
+* transfers are timed, not the program generation.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Took the low OCM where it is mapped.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xil_printf.h"
+#include "xiltimer.h"
+#include "xinterrupt_wrap.h"
+#include "xil_dmaarena.h"
+#include "xil_hotpath.h"
+#include "dma_bench.h"
+#include "drvcfg.h"
+
+/************************** Constant Definitions ****************************/
+
+/* Low OCM left to the benchmark, above the first 64 KB */
+#define DMA_BENCH_OCM_OFFSET	0x10000U
+
+/* Shape of the rule covering the pairs not measured */
+#define DMA_BENCH_DFT_SIZE	4U
+#define DMA_BENCH_DFT_LEN	4U
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static u32 DmaBench_Time(DmaBench *BenchPtr, u32 SrcRegion, u32 DstRegion,
+			 u32 BurstSize, u32 BurstLen, u32 Inc,
+			 u32 Misaligned);
+static void DmaBench_DoneHandler(unsigned int Channel, XDmaPs_Cmd *DmaCmd,
+				 void *CallbackRef);
+
+/************************** Variable Definitions ****************************/
+
+static const char *const DmaBench_RegionNames[DMA_BENCH_NUM_REGIONS] = {
+	"ddr", "ocm", "bram0", "bram1"
+};
+
+static const char *const DmaBench_IncNames[DMA_BENCH_NUM_INCS] = {
+	"both", "dst", "src"
+};
+
+/*
+ * Address ranges of the regions, for the rules of the burst table, the low
+ * OCM moved by DmaBench_Initialize() when it is mapped high
+ */
+static u32 DmaBench_RegionBase[DMA_BENCH_NUM_REGIONS] = {
+	XPAR_PS7_DDR_0_BASEADDRESS, XPAR_PS7_RAM_0_BASEADDRESS,
+	XPAR_XBRAM_0_BASEADDR, XPAR_XBRAM_1_BASEADDR
+};
+
+static u32 DmaBench_RegionHigh[DMA_BENCH_NUM_REGIONS] = {
+	XPAR_PS7_DDR_0_HIGHADDRESS, XPAR_PS7_RAM_0_HIGHADDRESS,
+	XPAR_XBRAM_0_HIGHADDR, XPAR_XBRAM_1_HIGHADDR
+};
+
+static const u32 DmaBench_BurstSizes[DMA_BENCH_NUM_SIZES] = {
+	1U, 2U, 4U, 8U
+};
+
+static const u32 DmaBench_BurstLens[DMA_BENCH_NUM_LENS] = {
+	1U, 2U, 4U, 8U, 16U
+};
+
+/* DDR buffers when the DMA arena is not mapped */
+static u8 DmaBench_DdrStatic[2][DMA_BENCH_BYTES] __attribute__((aligned(32)));
+
+static Xil_DmaPool DmaBench_DdrPool;
+
+/* End of the transfer being timed, set by the done handler */
+static volatile XTime DmaBench_DoneTime;
+
+/****************************************************************************/
+/**
+*
+* Sets up the DMA controller, its done interrupt on DMA_BENCH_CHANNEL and
+* its fault interrupt, and the buffers of every region.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return
+*		- XST_SUCCESS if the benchmark is ready.
+*		- XST_FAILURE if the DMA controller is not found or its
+*		  interrupts could not be connected.
+*		- The error of the failing driver call otherwise.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 DmaBench_Initialize(DmaBench *BenchPtr)
+{
+	XDmaPs_Config *CfgPtr;
+	UINTPTR OcmBase;
+	s32 Status;
+
+	CfgPtr = XDmaPs_LookupConfigStatic(XPAR_XDMAPS_0_BASEADDR);
+	if (CfgPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	Status = XDmaPs_CfgInitialize(&BenchPtr->Dma, CfgPtr,
+				      CfgPtr->BaseAddress);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	/* IntrId[0] is the fault interrupt, IntrId[1 + N] the one of channel N */
+	Status = XSetupInterruptSystem(&BenchPtr->Dma, &XDmaPs_DoneISR_0,
+				       CfgPtr->IntrId[1U + DMA_BENCH_CHANNEL],
+				       CfgPtr->IntrParent,
+				       XINTERRUPT_DEFAULT_PRIORITY);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	Status = XConnectToInterruptCntrl(CfgPtr->IntrId[0],
+					  &XDmaPs_FaultISR, &BenchPtr->Dma,
+					  CfgPtr->IntrParent);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	XEnableIntrId(CfgPtr->IntrId[0], CfgPtr->IntrParent);
+
+	(void)XDmaPs_SetDoneHandler(&BenchPtr->Dma, DMA_BENCH_CHANNEL,
+				    DmaBench_DoneHandler, BenchPtr);
+	(void)XDmaPs_SetFaultHandler(&BenchPtr->Dma, DmaBench_DoneHandler,
+				     BenchPtr);
+
+	/* Non-cacheable DDR buffers spare the transfers their maintenance */
+	BenchPtr->Buf[DMA_BENCH_REGION_DDR][0] = DmaBench_DdrStatic[0];
+	BenchPtr->Buf[DMA_BENCH_REGION_DDR][1] = DmaBench_DdrStatic[1];
+	if (Xil_DmaPoolCreate(&DmaBench_DdrPool, DMA_BENCH_BYTES,
+			      2U) == XST_SUCCESS) {
+		BenchPtr->Buf[DMA_BENCH_REGION_DDR][0] =
+			(u8 *)Xil_DmaPoolAlloc(&DmaBench_DdrPool);
+		BenchPtr->Buf[DMA_BENCH_REGION_DDR][1] =
+			(u8 *)Xil_DmaPoolAlloc(&DmaBench_DdrPool);
+	}
+
+	OcmBase = Xil_OcmLowBase();
+	DmaBench_RegionBase[DMA_BENCH_REGION_OCM] = (u32)OcmBase;
+	DmaBench_RegionHigh[DMA_BENCH_REGION_OCM] =
+		(u32)OcmBase + (XIL_OCM_LOW_SIZE - 1U);
+	BenchPtr->Buf[DMA_BENCH_REGION_OCM][0] =
+		(u8 *)(OcmBase + DMA_BENCH_OCM_OFFSET);
+	BenchPtr->Buf[DMA_BENCH_REGION_OCM][1] =
+		(u8 *)(OcmBase + DMA_BENCH_OCM_OFFSET + DMA_BENCH_BYTES);
+	BenchPtr->Buf[DMA_BENCH_REGION_BRAM0][0] = (u8 *)XPAR_XBRAM_0_BASEADDR;
+	BenchPtr->Buf[DMA_BENCH_REGION_BRAM0][1] =
+		(u8 *)(XPAR_XBRAM_0_BASEADDR + DMA_BENCH_BYTES);
+	BenchPtr->Buf[DMA_BENCH_REGION_BRAM1][0] = (u8 *)XPAR_XBRAM_1_BASEADDR;
+	BenchPtr->Buf[DMA_BENCH_REGION_BRAM1][1] =
+		(u8 *)(XPAR_XBRAM_1_BASEADDR + DMA_BENCH_BYTES);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Times every burst shape between every pair of regions, with the three
+* address increments aligned and, with both incrementing, misaligned.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	ResultsPtr is where the results are stored.
+* @param	MaxResults is the capacity of ResultsPtr.
+*
+* @return	The number of results stored.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 DmaBench_RunAll(DmaBench *BenchPtr, DmaBench_Result *ResultsPtr,
+		    u32 MaxResults)
+{
+	DmaBench_Result *ResultPtr;
+	u32 NumResults;
+	u32 Shape;
+	u32 Pair;
+	u32 Run;
+
+	/* Region pairs, then burst sizes and lengths, then the increments */
+	for (NumResults = 0U; (NumResults < DMA_BENCH_MAX_RESULTS) &&
+	     (NumResults < MaxResults); NumResults++) {
+		Run = NumResults % (DMA_BENCH_NUM_INCS + 1U);
+		Shape = NumResults / (DMA_BENCH_NUM_INCS + 1U);
+		Pair = Shape / (DMA_BENCH_NUM_SIZES * DMA_BENCH_NUM_LENS);
+
+		ResultPtr = &ResultsPtr[NumResults];
+		ResultPtr->SrcRegion = Pair / DMA_BENCH_NUM_REGIONS;
+		ResultPtr->DstRegion = Pair % DMA_BENCH_NUM_REGIONS;
+		ResultPtr->BurstSize = DmaBench_BurstSizes[
+			(Shape / DMA_BENCH_NUM_LENS) % DMA_BENCH_NUM_SIZES];
+		ResultPtr->BurstLen =
+			DmaBench_BurstLens[Shape % DMA_BENCH_NUM_LENS];
+		/* The last run is both incrementing, misaligned */
+		if (Run == DMA_BENCH_NUM_INCS) {
+			ResultPtr->Inc = DMA_BENCH_INC_BOTH;
+			ResultPtr->Misaligned = 1U;
+		} else {
+			ResultPtr->Inc = Run;
+			ResultPtr->Misaligned = 0U;
+		}
+		ResultPtr->MBps = DmaBench_Time(BenchPtr, ResultPtr->SrcRegion,
+						ResultPtr->DstRegion,
+						ResultPtr->BurstSize,
+						ResultPtr->BurstLen,
+						ResultPtr->Inc,
+						ResultPtr->Misaligned);
+	}
+
+	return NumResults;
+}
+
+/****************************************************************************/
+/**
+*
+* Builds a burst table from results: one rule per region pair with the
+* fastest shape with both addresses incrementing and aligned, then a rule
+* covering everything else.
+*
+* @param	ResultsPtr is the results of DmaBench_RunAll().
+* @param	NumResults is the number of results.
+* @param	RulesPtr is where the rules are stored.
+* @param	MaxRules is the capacity of RulesPtr, DMA_BENCH_MAX_RULES for
+*		a full sweep.
+*
+* @return	The number of rules stored.
+*
+* @note		The pairs without a successful result get no rule.
+*
+*****************************************************************************/
+u32 DmaBench_BuildTable(const DmaBench_Result *ResultsPtr, u32 NumResults,
+			XDmaPs_BurstRule *RulesPtr, u32 MaxRules)
+{
+	const DmaBench_Result *BestPtr;
+	const DmaBench_Result *ResultPtr;
+	XDmaPs_BurstRule *RulePtr;
+	u32 NumRules = 0U;
+	u32 SrcRegion;
+	u32 DstRegion;
+	u32 Index;
+
+	for (SrcRegion = 0U; SrcRegion < DMA_BENCH_NUM_REGIONS; SrcRegion++) {
+		for (DstRegion = 0U; DstRegion < DMA_BENCH_NUM_REGIONS;
+		     DstRegion++) {
+			BestPtr = NULL;
+			for (Index = 0U; Index < NumResults; Index++) {
+				ResultPtr = &ResultsPtr[Index];
+				if ((ResultPtr->SrcRegion == SrcRegion) &&
+				    (ResultPtr->DstRegion == DstRegion) &&
+				    (ResultPtr->Inc == DMA_BENCH_INC_BOTH) &&
+				    (ResultPtr->Misaligned == 0U) &&
+				    (ResultPtr->MBps != 0U) &&
+				    ((BestPtr == NULL) ||
+				     (ResultPtr->MBps > BestPtr->MBps))) {
+					BestPtr = ResultPtr;
+				}
+			}
+			if (BestPtr == NULL) {
+				continue;
+			}
+			/* Keep room for the catch-all */
+			if ((NumRules + 1U) >= MaxRules) {
+				break;
+			}
+			RulePtr = &RulesPtr[NumRules];
+			RulePtr->SrcBase = DmaBench_RegionBase[SrcRegion];
+			RulePtr->SrcHigh = DmaBench_RegionHigh[SrcRegion];
+			RulePtr->DstBase = DmaBench_RegionBase[DstRegion];
+			RulePtr->DstHigh = DmaBench_RegionHigh[DstRegion];
+			RulePtr->BurstSize = BestPtr->BurstSize;
+			RulePtr->BurstLen = BestPtr->BurstLen;
+			NumRules++;
+		}
+	}
+
+	if (NumRules < MaxRules) {
+		RulePtr = &RulesPtr[NumRules];
+		RulePtr->SrcBase = 0x00000000U;
+		RulePtr->SrcHigh = 0xFFFFFFFFU;
+		RulePtr->DstBase = 0x00000000U;
+		RulePtr->DstHigh = 0xFFFFFFFFU;
+		RulePtr->BurstSize = DMA_BENCH_DFT_SIZE;
+		RulePtr->BurstLen = DMA_BENCH_DFT_LEN;
+		NumRules++;
+	}
+
+	return NumRules;
+}
+
+/****************************************************************************/
+/**
+*
+* Prints results on the standard output, then the burst table built from
+* them as the initializer of the default table of xdmaps.c.
+*
+* @param	ResultsPtr is the results of DmaBench_RunAll().
+* @param	NumResults is the number of results.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void DmaBench_Report(const DmaBench_Result *ResultsPtr, u32 NumResults)
+{
+	XDmaPs_BurstRule Rules[DMA_BENCH_MAX_RULES];
+	const DmaBench_Result *ResultPtr;
+	const XDmaPs_BurstRule *RulePtr;
+	u32 NumRules;
+	u32 Index;
+
+	xil_printf("src\tdst\tsize\tlen\tinc\talign\tMB/s\r\n");
+
+	for (Index = 0U; Index < NumResults; Index++) {
+		ResultPtr = &ResultsPtr[Index];
+		xil_printf("%s\t%s\t%u\t%u\t%s\t%s\t%u\r\n",
+			   DmaBench_RegionNames[ResultPtr->SrcRegion],
+			   DmaBench_RegionNames[ResultPtr->DstRegion],
+			   ResultPtr->BurstSize, ResultPtr->BurstLen,
+			   DmaBench_IncNames[ResultPtr->Inc],
+			   (ResultPtr->Misaligned != 0U) ? "+1" : "0",
+			   ResultPtr->MBps);
+	}
+
+	NumRules = DmaBench_BuildTable(ResultsPtr, NumResults, Rules,
+				       DMA_BENCH_MAX_RULES);
+
+	xil_printf("static const XDmaPs_BurstRule "
+		   "XDmaPs_DefaultBurstTable[] = {\r\n");
+	for (Index = 0U; Index < NumRules; Index++) {
+		RulePtr = &Rules[Index];
+		xil_printf("\t{0x%08xU, 0x%08xU, 0x%08xU, 0x%08xU, %u, %u}%s\r\n",
+			   RulePtr->SrcBase, RulePtr->SrcHigh,
+			   RulePtr->DstBase, RulePtr->DstHigh,
+			   RulePtr->BurstSize, RulePtr->BurstLen,
+			   ((Index + 1U) < NumRules) ? "," : "");
+	}
+	xil_printf("};\r\n");
+}
+
+/****************************************************************************/
+/*
+*
+* Times one burst shape between two regions. The first transfer warms the
+* caches and the DMA instruction cache and is not counted.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	SrcRegion is the source region.
+* @param	DstRegion is the destination region.
+* @param	BurstSize is the number of bytes per beat.
+* @param	BurstLen is the number of beats per burst.
+* @param	Inc is one of the DMA_BENCH_INC_* values.
+* @param	Misaligned moves the source one byte off.
+*
+* @return	The throughput of the fastest of DMA_BENCH_REPEAT transfers
+*		in MB/s, or 0 if a transfer failed or timed out.
+*
+*****************************************************************************/
+static u32 DmaBench_Time(DmaBench *BenchPtr, u32 SrcRegion, u32 DstRegion,
+			 u32 BurstSize, u32 BurstLen, u32 Inc,
+			 u32 Misaligned)
+{
+	XDmaPs_Cmd *CmdPtr = &BenchPtr->Cmd;
+	XDmaPs_ChanCtrl *ChanCtrl = &CmdPtr->ChanCtrl;
+	/* The same region copies from one buffer to the other */
+	u32 DstBuf = (SrcRegion == DstRegion) ? 1U : 0U;
+	/* One byte less when misaligned, so as to stay in the region */
+	u32 Bytes = DMA_BENCH_BYTES - Misaligned;
+	XTime Best = (XTime)~0ULL;
+	XTime Start;
+	XTime Now;
+	u32 Call;
+
+	(void)memset(CmdPtr, 0, sizeof(XDmaPs_Cmd));
+	ChanCtrl->SrcBurstSize = BurstSize;
+	ChanCtrl->SrcBurstLen = BurstLen;
+	ChanCtrl->SrcInc = (Inc != DMA_BENCH_INC_DST) ? 1U : 0U;
+	ChanCtrl->DstBurstSize = BurstSize;
+	ChanCtrl->DstBurstLen = BurstLen;
+	ChanCtrl->DstInc = (Inc != DMA_BENCH_INC_SRC) ? 1U : 0U;
+	CmdPtr->BD.SrcAddr = (u32)(UINTPTR)BenchPtr->Buf[SrcRegion][0] +
+			     Misaligned;
+	CmdPtr->BD.DstAddr = (u32)(UINTPTR)BenchPtr->Buf[DstRegion][DstBuf];
+	CmdPtr->BD.Length = Bytes;
+
+	if (XDmaPs_GenDmaProg(&BenchPtr->Dma, DMA_BENCH_CHANNEL,
+			      CmdPtr) != XST_SUCCESS) {
+		return 0U;
+	}
+
+	for (Call = 0U; Call <= DMA_BENCH_REPEAT; Call++) {
+		BenchPtr->Done = 0U;
+		XTime_GetTime(&Start);
+		if (XDmaPs_Start(&BenchPtr->Dma, DMA_BENCH_CHANNEL, CmdPtr,
+				 1) != XST_SUCCESS) {
+			Best = 0U;
+			break;
+		}
+
+		do {
+			XTime_GetTime(&Now);
+		} while ((BenchPtr->Done == 0U) &&
+			 ((Now - Start) < (((XTime)DMA_BENCH_TIMEOUT_US *
+					    COUNTS_PER_SECOND) / 1000000U)));
+
+		if ((BenchPtr->Done == 0U) || (CmdPtr->DmaStatus != 0)) {
+			(void)XDmaPs_ResetChannel(&BenchPtr->Dma,
+						  DMA_BENCH_CHANNEL);
+			Best = 0U;
+			break;
+		}
+
+		if ((Call != 0U) && ((DmaBench_DoneTime - Start) < Best)) {
+			Best = DmaBench_DoneTime - Start;
+		}
+	}
+
+	(void)XDmaPs_FreeDmaProg(&BenchPtr->Dma, DMA_BENCH_CHANNEL, CmdPtr);
+
+	if (Best == 0U) {
+		return 0U;
+	}
+
+	return (u32)(((u64)Bytes * COUNTS_PER_SECOND) / (Best * 1000000U));
+}
+
+/****************************************************************************/
+/*
+*
+* Done and fault handler of the benchmark channel: takes the end time of
+* the transfer.
+*
+* @param	Channel is the DMA channel.
+* @param	DmaCmd is the command done.
+* @param	CallbackRef is the benchmark state.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void DmaBench_DoneHandler(unsigned int Channel, XDmaPs_Cmd *DmaCmd,
+				 void *CallbackRef)
+{
+	DmaBench *BenchPtr = (DmaBench *)CallbackRef;
+	XTime Now;
+
+	(void)Channel;
+	(void)DmaCmd;
+
+	XTime_GetTime(&Now);
+	DmaBench_DoneTime = Now;
+	BenchPtr->Done = 1U;
+}
@@ -0,0 +1,135 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file dma_bench.h
+*
+* Throughput of the PS DMA controller between the memory regions of the
+* linker script, and the burst table of the XDmaPs driver built from it.
+*
+* Every source and destination region pair is swept over the burst sizes of
+* 1 to 8 bytes and the burst lengths of 1 to 16 beats. Each shape is run
+* with both addresses incrementing, with the source fixed and with the
+* destination fixed, and, with both incrementing, once more with the source
+* one byte off. A result is the best of DMA_BENCH_REPEAT transfers of
+* DMA_BENCH_BYTES bytes, timed with the global timer from the start of the
+* channel to its done interrupt, so that the cache maintenance of the
+* cacheable regions is counted as it is in a real transfer.
+*
+* The regions are the DDR, in the DMA arena when it is mapped, the low OCM
+* above 64 KB and the two AXI BRAMs. The high OCM is left out, since it
+* holds the interrupt hot path of xil_hotpath.h. With the OCM remapped high
+* the low banks are taken at 0xFFFC0000, see Xil_OcmLowBase().
+*
+* DmaBench_Report() prints the results and the fastest shape of each region
+* pair as the XDmaPs_BurstRule initializer the default burst table of the
+* driver is kept in. DmaBench_BuildTable() builds the same table, for
+* XDmaPs_SetBurstTable() to apply it at run time.
+*
+* The benchmark is built into the application when DMA_BENCH is defined.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Took the low OCM where it is mapped.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef DMA_BENCH_H
+#define DMA_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xdmaps.h"
+
+/************************** Constant Definitions ****************************/
+
+/** @name Regions
+ * @{
+ */
+#define DMA_BENCH_REGION_DDR	0U	/**< DDR */
+#define DMA_BENCH_REGION_OCM	1U	/**< Low OCM */
+#define DMA_BENCH_REGION_BRAM0	2U	/**< AXI BRAM 0, 128 KB */
+#define DMA_BENCH_REGION_BRAM1	3U	/**< AXI BRAM 1, 8 KB */
+#define DMA_BENCH_NUM_REGIONS	4U
+/* @} */
+
+/** @name Address increments
+ * @{
+ */
+#define DMA_BENCH_INC_BOTH	0U	/**< Both addresses increment */
+#define DMA_BENCH_INC_DST	1U	/**< Fixed source */
+#define DMA_BENCH_INC_SRC	2U	/**< Fixed destination */
+#define DMA_BENCH_NUM_INCS	3U
+/* @} */
+
+#define DMA_BENCH_CHANNEL	0U	/**< DMA channel used */
+#define DMA_BENCH_BYTES		4096U	/**< Bytes per transfer, half of
+					  *  the smallest region */
+#define DMA_BENCH_REPEAT	8U	/**< Transfers per result */
+#define DMA_BENCH_TIMEOUT_US	10000U	/**< Longest transfer */
+
+#define DMA_BENCH_NUM_SIZES	4U	/**< Burst sizes, 1 to 8 bytes */
+#define DMA_BENCH_NUM_LENS	5U	/**< Burst lengths, 1 to 16 beats */
+
+/** Results of a full sweep */
+#define DMA_BENCH_MAX_RESULTS	(DMA_BENCH_NUM_REGIONS * \
+				 DMA_BENCH_NUM_REGIONS * \
+				 DMA_BENCH_NUM_SIZES * DMA_BENCH_NUM_LENS * \
+				 (DMA_BENCH_NUM_INCS + 1U))
+
+/** Rules of a burst table, one per region pair and a catch-all */
+#define DMA_BENCH_MAX_RULES	((DMA_BENCH_NUM_REGIONS * \
+				  DMA_BENCH_NUM_REGIONS) + 1U)
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Result of one burst shape between two regions.
+ */
+typedef struct {
+	u32 SrcRegion;		/**< One of the DMA_BENCH_REGION_* values */
+	u32 DstRegion;		/**< Same */
+	u32 BurstSize;		/**< Bytes per beat */
+	u32 BurstLen;		/**< Beats per burst */
+	u32 Inc;		/**< One of the DMA_BENCH_INC_* values */
+	u32 Misaligned;		/**< Source one byte off */
+	u32 MBps;		/**< Throughput in MB/s, 0 if it failed */
+} DmaBench_Result;
+
+/**
+ * State of the benchmark.
+ */
+typedef struct {
+	XDmaPs Dma;		/**< DMA controller */
+	XDmaPs_Cmd Cmd;		/**< Command being timed */
+	volatile u32 Done;	/**< Set by the done and fault handlers */
+	u8 *Buf[DMA_BENCH_NUM_REGIONS][2]; /**< Two buffers per region */
+} DmaBench;
+
+/************************** Function Prototypes *****************************/
+
+s32 DmaBench_Initialize(DmaBench *BenchPtr);
+u32 DmaBench_RunAll(DmaBench *BenchPtr, DmaBench_Result *ResultsPtr,
+		    u32 MaxResults);
+u32 DmaBench_BuildTable(const DmaBench_Result *ResultsPtr, u32 NumResults,
+			XDmaPs_BurstRule *RulesPtr, u32 MaxRules);
+void DmaBench_Report(const DmaBench_Result *ResultsPtr, u32 NumResults);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DMA_BENCH_H */
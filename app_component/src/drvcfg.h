@@ -0,0 +1,152 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file drvcfg.h
+*
+* Generated by tools/drvcfg_gen.py from the configuration tables of the BSP,
+* do not edit. Include it after the headers of the drivers.
+*
+*****************************************************************************/
+
+#ifndef DRVCFG_H
+#define DRVCFG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "xil_types.h"
+
+/* xbram.h */
+#ifdef XBRAM_H
+extern XBram_Config XBram_ConfigTable[];
+
+#define XBRAM_CONFIG_0	(&XBram_ConfigTable[0])
+#define XBRAM_CONFIG_1	(&XBram_ConfigTable[1])
+
+static inline XBram_Config *XBram_LookupConfigStatic(UINTPTR BaseAddress)
+{
+	if (BaseAddress == 0x42000000U) {
+		return XBRAM_CONFIG_0;
+	}
+	if (BaseAddress == 0x43000000U) {
+		return XBRAM_CONFIG_1;
+	}
+	return NULL;
+}
+#endif
+
+/* xdevcfg.h */
+#ifdef XDCFG_H
+extern XDcfg_Config XDcfg_ConfigTable[];
+
+#define XDCFG_CONFIG_0	(&XDcfg_ConfigTable[0])
+
+static inline XDcfg_Config *XDcfg_LookupConfigStatic(UINTPTR BaseAddress)
+{
+	if (BaseAddress == 0xf8007000U) {
+		return XDCFG_CONFIG_0;
+	}
+	return NULL;
+}
+#endif
+
+/* xdmaps.h */
+#ifdef XDMAPS_H
+extern XDmaPs_Config XDmaPs_ConfigTable[];
+
+#define XDMAPS_CONFIG_0	(&XDmaPs_ConfigTable[0])
+
+static inline XDmaPs_Config *XDmaPs_LookupConfigStatic(UINTPTR BaseAddress)
+{
+	if (BaseAddress == 0xf8003000U) {
+		return XDMAPS_CONFIG_0;
+	}
+	return NULL;
+}
+#endif
+
+/* xscugic.h */
+#ifdef XSCUGIC_H
+extern XScuGic_Config XScuGic_ConfigTable[];
+
+#define XSCUGIC_CONFIG_0	(&XScuGic_ConfigTable[0])
+
+static inline XScuGic_Config *XScuGic_LookupConfigStatic(UINTPTR BaseAddress)
+{
+	if (BaseAddress == 0xf8f01000U) {
+		return XSCUGIC_CONFIG_0;
+	}
+	return NULL;
+}
+#endif
+
+/* xscutimer.h */
+#ifdef XSCUTIMER_H
+extern XScuTimer_Config XScuTimer_ConfigTable[];
+
+#define XSCUTIMER_CONFIG_0	(&XScuTimer_ConfigTable[0])
+
+static inline XScuTimer_Config *XScuTimer_LookupConfigStatic(UINTPTR BaseAddress)
+{
+	if (BaseAddress == 0xf8f00600U) {
+		return XSCUTIMER_CONFIG_0;
+	}
+	return NULL;
+}
+#endif
+
+/* xscuwdt.h */
+#ifdef XSCUWDT_H
+extern XScuWdt_Config XScuWdt_ConfigTable[];
+
+#define XSCUWDT_CONFIG_0	(&XScuWdt_ConfigTable[0])
+
+static inline XScuWdt_Config *XScuWdt_LookupConfigStatic(UINTPTR BaseAddress)
+{
+	if (BaseAddress == 0xf8f00620U) {
+		return XSCUWDT_CONFIG_0;
+	}
+	return NULL;
+}
+#endif
+
+/* xuartps.h */
+#ifdef XUARTPS_H
+extern XUartPs_Config XUartPs_ConfigTable[];
+
+#define XUARTPS_CONFIG_0	(&XUartPs_ConfigTable[0])
+
+static inline XUartPs_Config *XUartPs_LookupConfigStatic(UINTPTR BaseAddress)
+{
+	if (BaseAddress == 0xe0000000U) {
+		return XUARTPS_CONFIG_0;
+	}
+	return NULL;
+}
+#endif
+
+/* xadcps.h */
+#ifdef XADCPS_H
+extern XAdcPs_Config XAdcPs_ConfigTable[];
+
+#define XADCPS_CONFIG_0	(&XAdcPs_ConfigTable[0])
+
+static inline XAdcPs_Config *XAdcPs_LookupConfigStatic(UINTPTR BaseAddress)
+{
+	if (BaseAddress == 0xf8007100U) {
+		return XADCPS_CONFIG_0;
+	}
+	return NULL;
+}
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DRVCFG_H */
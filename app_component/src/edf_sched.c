@@ -0,0 +1,431 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file edf_sched.c
+*
+* Earliest deadline first scheduler of the main loop. Refer to edf_sched.h
+* for how it is used.
+*
+* The releases and the budget timer run in the timer interrupt, the steps
+* in the event loop. The state of a job is changed with the IRQ masked on
+* both sides; the tasks are few, so the job to run is looked for over the
+* list of tasks before each step.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xstatus.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "edf_sched.h"
+
+/************************** Constant Definitions ****************************/
+
+#define EDF_SCHED_COUNTS_PER_US	((XTime)COUNTS_PER_SECOND / 1000000U)
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static void EdfSched_Release(void *CallBackRef);
+static void EdfSched_BudgetHandler(void *CallBackRef);
+static void EdfSched_Dispatch(void *CallBackRef);
+static EdfSched_Task *EdfSched_Pick(const EdfSched *SchedPtr);
+static void EdfSched_Done(EdfSched_Task *TaskPtr, XTime End);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* Sets up a scheduler on an event of a loop, with no tasks.
+*
+* @param	SchedPtr is a pointer to the scheduler.
+* @param	LoopPtr is the event loop, initialized with a timer wheel.
+* @param	Event is the event of the loop the steps run from. The
+*		events numbered below it come first.
+*
+* @return
+*		- XST_SUCCESS if the scheduler is ready.
+*		- XST_INVALID_PARAM if the event is out of range.
+*		- XST_FAILURE if the loop has no timer wheel.
+*
+*****************************************************************************/
+s32 EdfSched_Initialize(EdfSched *SchedPtr, EventLoop *LoopPtr, u32 Event)
+{
+	if (Event >= EVENT_LOOP_MAX_EVENTS) {
+		return XST_INVALID_PARAM;
+	}
+	if (LoopPtr->WheelPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	SchedPtr->LoopPtr = LoopPtr;
+	SchedPtr->WheelPtr = LoopPtr->WheelPtr;
+	SchedPtr->Event = Event;
+	SchedPtr->UrgentMask = ((u32)1U << Event) - 1U;
+	SchedPtr->Head = NULL;
+	SchedPtr->Running = NULL;
+	SchedPtr->Started = 0U;
+	SchedPtr->Stats.Dispatches = 0U;
+	SchedPtr->Stats.Yields = 0U;
+	SchedPtr->Stats.BusyCounts = 0U;
+	TimerWheel_InitTimer(&SchedPtr->BudgetTimer, EdfSched_BudgetHandler,
+			     SchedPtr);
+
+	return EventLoop_SetHandler(LoopPtr, Event, EdfSched_Dispatch,
+				    SchedPtr);
+}
+
+/****************************************************************************/
+/**
+*
+* Adds a periodic task. Its first job is released by EdfSched_Start(), or
+* at once if the scheduler is started already.
+*
+* @param	SchedPtr is a pointer to the scheduler.
+* @param	TaskPtr is a pointer to the task, not added yet.
+* @param	Name names the task in the reports.
+* @param	Step runs a step of a job of the task.
+* @param	CallBackRef is the argument of Step.
+* @param	Class is EDF_SCHED_DEADLINE or EDF_SCHED_BACKGROUND.
+* @param	PeriodUs is the time between two releases.
+* @param	DeadlineUs is the deadline of a job from its release, up to
+*		the period, 0 for the period. Ignored in the background.
+* @param	BudgetUs is the CPU time of a job, up to its deadline.
+*		Ignored in the background.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM for a bad class, a zero
+*		period or a deadline or budget out of range.
+*
+*****************************************************************************/
+s32 EdfSched_AddTask(EdfSched *SchedPtr, EdfSched_Task *TaskPtr,
+		     const char *Name, EdfSched_Step Step, void *CallBackRef,
+		     u32 Class, u64 PeriodUs, u64 DeadlineUs, u64 BudgetUs)
+{
+	EdfSched_Task **LinkPtr;
+	XTime Now;
+
+	if (DeadlineUs == 0U) {
+		DeadlineUs = PeriodUs;
+	}
+	if ((Step == NULL) || (PeriodUs == 0U) ||
+	    ((Class != EDF_SCHED_DEADLINE) &&
+	     (Class != EDF_SCHED_BACKGROUND))) {
+		return XST_INVALID_PARAM;
+	}
+	if ((Class == EDF_SCHED_DEADLINE) &&
+	    ((DeadlineUs > PeriodUs) || (BudgetUs == 0U) ||
+	     (BudgetUs > DeadlineUs))) {
+		return XST_INVALID_PARAM;
+	}
+
+	TaskPtr->Next = NULL;
+	TaskPtr->SchedPtr = SchedPtr;
+	TaskPtr->Name = Name;
+	TaskPtr->Step = Step;
+	TaskPtr->CallBackRef = CallBackRef;
+	TaskPtr->Class = Class;
+	TaskPtr->Period = PeriodUs * EDF_SCHED_COUNTS_PER_US;
+	TaskPtr->RelDeadline = DeadlineUs * EDF_SCHED_COUNTS_PER_US;
+	TaskPtr->Budget = BudgetUs * EDF_SCHED_COUNTS_PER_US;
+	TaskPtr->Release = 0U;
+	TaskPtr->Deadline = 0U;
+	TaskPtr->Used = 0U;
+	TaskPtr->Active = 0U;
+	TaskPtr->Exhausted = 0U;
+	TaskPtr->Stats.Releases = 0U;
+	TaskPtr->Stats.Completions = 0U;
+	TaskPtr->Stats.Steps = 0U;
+	TaskPtr->Stats.Overruns = 0U;
+	TaskPtr->Stats.Misses = 0U;
+	TaskPtr->Stats.MaxResponse = 0U;
+	TaskPtr->Stats.MaxUsed = 0U;
+	TimerWheel_InitTimer(&TaskPtr->ReleaseTimer, EdfSched_Release,
+			     TaskPtr);
+
+	/* At the end, the tasks are looked at in the order they were added */
+	LinkPtr = &SchedPtr->Head;
+	while (*LinkPtr != NULL) {
+		LinkPtr = &(*LinkPtr)->Next;
+	}
+	*LinkPtr = TaskPtr;
+
+	if (SchedPtr->Started != 0U) {
+		XTime_GetTime(&Now);
+		TaskPtr->NextRelease = Now;
+		TimerWheel_StartAt(SchedPtr->WheelPtr, &TaskPtr->ReleaseTimer,
+				   Now);
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Releases the first job of each task now, in phase.
+*
+* @param	SchedPtr is a pointer to the scheduler.
+*
+* @return	None.
+*
+*****************************************************************************/
+void EdfSched_Start(EdfSched *SchedPtr)
+{
+	EdfSched_Task *TaskPtr;
+	XTime Now;
+
+	if (SchedPtr->Started != 0U) {
+		return;
+	}
+
+	XTime_GetTime(&Now);
+	for (TaskPtr = SchedPtr->Head; TaskPtr != NULL;
+	     TaskPtr = TaskPtr->Next) {
+		TaskPtr->NextRelease = Now;
+		TimerWheel_StartAt(SchedPtr->WheelPtr, &TaskPtr->ReleaseTimer,
+				   Now);
+	}
+	SchedPtr->Started = 1U;
+}
+
+/****************************************************************************/
+/**
+*
+* Tells a step whether the budget of its job has run out, for a step that
+* loops to return early.
+*
+* @param	SchedPtr is a pointer to the scheduler.
+*
+* @return	1 once the budget timer has fired, 0 otherwise and outside a
+*		step.
+*
+*****************************************************************************/
+u32 EdfSched_Exhausted(const EdfSched *SchedPtr)
+{
+	const EdfSched_Task *TaskPtr = SchedPtr->Running;
+
+	return ((TaskPtr != NULL) && (TaskPtr->Exhausted != 0U)) ? 1U : 0U;
+}
+
+/****************************************************************************/
+/**
+*
+* Gets the counts of the scheduler.
+*
+* @param	SchedPtr is a pointer to the scheduler.
+* @param	StatsPtr is where the counts are copied.
+*
+* @return	None.
+*
+*****************************************************************************/
+void EdfSched_GetStats(const EdfSched *SchedPtr, EdfSched_Stats *StatsPtr)
+{
+	*StatsPtr = SchedPtr->Stats;
+}
+
+/****************************************************************************/
+/**
+*
+* Gets the counts of a task.
+*
+* @param	TaskPtr is a pointer to the task.
+* @param	StatsPtr is where the counts are copied.
+*
+* @return	None.
+*
+*****************************************************************************/
+void EdfSched_GetTaskStats(const EdfSched_Task *TaskPtr,
+			   EdfSched_TaskStats *StatsPtr)
+{
+	u32 Cpsr;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+	*StatsPtr = TaskPtr->Stats;
+	mtcpsr(Cpsr);
+}
+
+/*
+ * Releases a job of a task, from the timer interrupt. A release late by a
+ * period or more, as after a long stop of the loop, starts the phase again
+ * instead of releasing the periods missed one after the other.
+ */
+static void EdfSched_Release(void *CallBackRef)
+{
+	EdfSched_Task *TaskPtr = (EdfSched_Task *)CallBackRef;
+	EdfSched *SchedPtr = TaskPtr->SchedPtr;
+	XTime Now;
+
+	if (TaskPtr->Active != 0U) {
+		/* Unfinished, it goes on under the new deadline */
+		TaskPtr->Stats.Misses++;
+		if (TaskPtr->Exhausted != 0U) {
+			TaskPtr->Stats.Overruns++;
+		}
+	}
+	TaskPtr->Release = TaskPtr->NextRelease;
+	TaskPtr->Deadline = TaskPtr->Release + TaskPtr->RelDeadline;
+	TaskPtr->Used = 0U;
+	TaskPtr->Exhausted = 0U;
+	TaskPtr->Active = 1U;
+	TaskPtr->Stats.Releases++;
+
+	XTime_GetTime(&Now);
+	TaskPtr->NextRelease += TaskPtr->Period;
+	if (TaskPtr->NextRelease <= Now) {
+		TaskPtr->NextRelease = Now + TaskPtr->Period;
+	}
+	TimerWheel_StartAt(SchedPtr->WheelPtr, &TaskPtr->ReleaseTimer,
+			   TaskPtr->NextRelease);
+	EventLoop_Post(SchedPtr->LoopPtr, SchedPtr->Event);
+}
+
+/*
+ * The budget of the job of the running step is used up, from the timer
+ * interrupt. The step may see it with EdfSched_Exhausted().
+ */
+static void EdfSched_BudgetHandler(void *CallBackRef)
+{
+	EdfSched *SchedPtr = (EdfSched *)CallBackRef;
+
+	if (SchedPtr->Running != NULL) {
+		SchedPtr->Running->Exhausted = 1U;
+	}
+}
+
+/*
+ * Runs the steps of the jobs released, the earliest deadline first, until
+ * none is left or an event that comes first is ready.
+ */
+static void EdfSched_Dispatch(void *CallBackRef)
+{
+	EdfSched *SchedPtr = (EdfSched *)CallBackRef;
+	EdfSched_Task *TaskPtr;
+	XTime Start;
+	XTime End;
+	u32 More;
+	u32 Cpsr;
+
+	SchedPtr->Stats.Dispatches++;
+
+	for (;;) {
+		Cpsr = mfcpsr();
+		mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+		TaskPtr = EdfSched_Pick(SchedPtr);
+		if ((TaskPtr != NULL) &&
+		    ((SchedPtr->LoopPtr->Ready & SchedPtr->UrgentMask) != 0U)) {
+			/* Back once the events that come first are handled */
+			SchedPtr->Stats.Yields++;
+			EventLoop_Post(SchedPtr->LoopPtr, SchedPtr->Event);
+			TaskPtr = NULL;
+		}
+		SchedPtr->Running = TaskPtr;
+		mtcpsr(Cpsr);
+
+		if (TaskPtr == NULL) {
+			return;
+		}
+
+		XTime_GetTime(&Start);
+		if ((TaskPtr->Class == EDF_SCHED_DEADLINE) &&
+		    (TaskPtr->Exhausted == 0U)) {
+			TimerWheel_StartAt(SchedPtr->WheelPtr,
+					   &SchedPtr->BudgetTimer,
+					   Start + (TaskPtr->Budget -
+						    TaskPtr->Used));
+		}
+		More = TaskPtr->Step(TaskPtr->CallBackRef);
+		XTime_GetTime(&End);
+		TimerWheel_Cancel(SchedPtr->WheelPtr, &SchedPtr->BudgetTimer);
+
+		Cpsr = mfcpsr();
+		mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+		SchedPtr->Running = NULL;
+		SchedPtr->Stats.BusyCounts += End - Start;
+		TaskPtr->Stats.Steps++;
+		TaskPtr->Used += End - Start;
+		if ((TaskPtr->Class == EDF_SCHED_DEADLINE) &&
+		    (TaskPtr->Used >= TaskPtr->Budget)) {
+			TaskPtr->Exhausted = 1U;
+		}
+		if (More == 0U) {
+			EdfSched_Done(TaskPtr, End);
+		}
+		mtcpsr(Cpsr);
+	}
+}
+
+/*
+ * The job to run next: the released job within its budget with the
+ * earliest deadline, else the background job released first. With the IRQ
+ * masked.
+ */
+static EdfSched_Task *EdfSched_Pick(const EdfSched *SchedPtr)
+{
+	EdfSched_Task *TaskPtr;
+	EdfSched_Task *BestPtr = NULL;
+	EdfSched_Task *BackPtr = NULL;
+
+	for (TaskPtr = SchedPtr->Head; TaskPtr != NULL;
+	     TaskPtr = TaskPtr->Next) {
+		if (TaskPtr->Active == 0U) {
+			continue;
+		}
+		if ((TaskPtr->Class == EDF_SCHED_DEADLINE) &&
+		    (TaskPtr->Exhausted == 0U)) {
+			if ((BestPtr == NULL) ||
+			    (TaskPtr->Deadline < BestPtr->Deadline)) {
+				BestPtr = TaskPtr;
+			}
+		} else if ((BackPtr == NULL) ||
+			   (TaskPtr->Release < BackPtr->Release)) {
+			BackPtr = TaskPtr;
+		}
+	}
+
+	return (BestPtr != NULL) ? BestPtr : BackPtr;
+}
+
+/* Accounts for a job done, with the IRQ masked */
+static void EdfSched_Done(EdfSched_Task *TaskPtr, XTime End)
+{
+	XTime Response = End - TaskPtr->Release;
+
+	TaskPtr->Active = 0U;
+	TaskPtr->Stats.Completions++;
+	if (TaskPtr->Class == EDF_SCHED_DEADLINE) {
+		if (TaskPtr->Exhausted != 0U) {
+			TaskPtr->Stats.Overruns++;
+		}
+		if (End > TaskPtr->Deadline) {
+			TaskPtr->Stats.Misses++;
+		}
+	}
+	if (Response > 0xFFFFFFFFU) {
+		Response = 0xFFFFFFFFU;
+	}
+	if ((u32)Response > TaskPtr->Stats.MaxResponse) {
+		TaskPtr->Stats.MaxResponse = (u32)Response;
+	}
+	if (TaskPtr->Used > TaskPtr->Stats.MaxUsed) {
+		TaskPtr->Stats.MaxUsed = (TaskPtr->Used > 0xFFFFFFFFU) ?
+					 0xFFFFFFFFU : (u32)TaskPtr->Used;
+	}
+}
@@ -0,0 +1,161 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file edf_sched.h
+*
+* Earliest deadline first scheduler of the periodic jobs of the main loop,
+* such as the metrics export and the thermal governor.
+*
+* A task is an EdfSched_Task of the caller, added with EdfSched_AddTask():
+* each period a timer of the timer wheel releases a job of it, due its
+* relative deadline later, and posts the event of the scheduler in the event
+* loop of event_loop.h. The handler of that event runs the step function of
+* the released job with the earliest deadline, again and again until the
+* step says the job is done. A job is made of steps so that it can be
+* stopped between two of them: before each step the scheduler gives the
+* CPU back to the loop when an event numbered below its own is ready, so
+* that the events of the UART path always come first, and goes on with the
+* job on its next dispatch.
+*
+* Each job of an EDF_SCHED_DEADLINE task has a budget, the CPU time it may
+* take. A timer of the wheel, on the SCU private timer, is started for the
+* rest of the budget at each step: a step that loops may poll
+* EdfSched_Exhausted() and return early once it fires. A job that uses up
+* its budget is counted as an overrun and falls to the background class for
+* the rest of its period, run only while no job within its budget is
+* ready, so that it cannot push the other deadlines out. Jobs of an
+* EDF_SCHED_BACKGROUND task have neither budget nor deadline and are run
+* in the order of their release, after the deadline jobs.
+*
+* The steps run with the interrupts enabled, and cannot be preempted: a
+* step is to be short next to the deadlines of the other tasks, their
+* jitter being the longest step. A release that finds the previous job of
+* the task unfinished counts a missed deadline, the job going on under the
+* new deadline, as does a job done past its deadline.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef EDF_SCHED_H
+#define EDF_SCHED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xiltimer.h"
+#include "timer_wheel.h"
+#include "event_loop.h"
+
+/************************** Constant Definitions ****************************/
+
+/** @name Classes
+ * @{
+ */
+#define EDF_SCHED_DEADLINE	0U	/**< Deadline and budget */
+#define EDF_SCHED_BACKGROUND	1U	/**< When nothing else is ready */
+/* @} */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Runs a step of a job, from the event loop.
+ *
+ * @return	Nonzero while the job has steps left, 0 once it is done.
+ */
+typedef u32 (*EdfSched_Step)(void *CallBackRef);
+
+/**
+ * Counts of a task, times in XTime counts.
+ */
+typedef struct {
+	u32 Releases;		/**< Jobs released */
+	u32 Completions;	/**< Jobs done */
+	u32 Steps;		/**< Calls of the step function */
+	u32 Overruns;		/**< Jobs over their budget */
+	u32 Misses;		/**< Jobs past their deadline */
+	u32 MaxResponse;	/**< Longest release to done */
+	u32 MaxUsed;		/**< Most CPU time of a job */
+} EdfSched_TaskStats;
+
+struct EdfSched_s;
+
+/**
+ * A task. Owned by the caller and linked into the scheduler once added.
+ */
+typedef struct EdfSched_Task {
+	struct EdfSched_Task *Next;
+	struct EdfSched_s *SchedPtr;
+	const char *Name;
+	EdfSched_Step Step;
+	void *CallBackRef;
+	u32 Class;		/**< EDF_SCHED_DEADLINE or _BACKGROUND */
+	XTime Period;
+	XTime RelDeadline;	/**< From the release */
+	XTime Budget;		/**< CPU time of a job */
+	TimerWheel_Timer ReleaseTimer;
+	XTime NextRelease;	/**< Deadline of ReleaseTimer */
+	/* The job, set by the release */
+	XTime Release;
+	XTime Deadline;
+	XTime Used;		/**< CPU time of its steps */
+	volatile u32 Active;	/**< Released and not done */
+	volatile u32 Exhausted;	/**< Out of budget */
+	EdfSched_TaskStats Stats;
+} EdfSched_Task;
+
+/**
+ * Counts of the scheduler.
+ */
+typedef struct {
+	u32 Dispatches;		/**< Calls of the event handler */
+	u32 Yields;		/**< Given back to a lower numbered event */
+	u64 BusyCounts;		/**< Time in the steps */
+} EdfSched_Stats;
+
+/**
+ * The scheduler.
+ */
+typedef struct EdfSched_s {
+	EventLoop *LoopPtr;
+	TimerWheel *WheelPtr;	/**< Of the loop */
+	u32 Event;		/**< Of the loop, runs the steps */
+	u32 UrgentMask;		/**< Events that come first */
+	EdfSched_Task *Head;	/**< Tasks added */
+	EdfSched_Task *Running;	/**< Task of the step, NULL between steps */
+	TimerWheel_Timer BudgetTimer;
+	u32 Started;
+	EdfSched_Stats Stats;
+} EdfSched;
+
+/************************** Function Prototypes *****************************/
+
+s32 EdfSched_Initialize(EdfSched *SchedPtr, EventLoop *LoopPtr, u32 Event);
+s32 EdfSched_AddTask(EdfSched *SchedPtr, EdfSched_Task *TaskPtr,
+		     const char *Name, EdfSched_Step Step, void *CallBackRef,
+		     u32 Class, u64 PeriodUs, u64 DeadlineUs, u64 BudgetUs);
+void EdfSched_Start(EdfSched *SchedPtr);
+u32 EdfSched_Exhausted(const EdfSched *SchedPtr);
+void EdfSched_GetStats(const EdfSched *SchedPtr, EdfSched_Stats *StatsPtr);
+void EdfSched_GetTaskStats(const EdfSched_Task *TaskPtr,
+			   EdfSched_TaskStats *StatsPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EDF_SCHED_H */
@@ -0,0 +1,416 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file event_loop.c
+*
+* Event driven main loop. Refer to event_loop.h.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Added EventLoop_Stop().
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "event_loop.h"
+
+/************************** Constant Definitions ****************************/
+
+#define EVENT_LOOP_IRQ_FIQ_MASK	(XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE)
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define wfi()	__asm__ __volatile__ ("wfi" : : : "memory")
+
+/************************** Function Prototypes *****************************/
+
+static void EventLoop_TimerHandler(void *CallBackRef);
+static s32 EventLoop_StartTimer(EventLoop *LoopPtr, u32 Event, u64 Us,
+				u32 Periodic);
+static void EventLoop_PollTimers(EventLoop *LoopPtr);
+static void EventLoop_Dispatch(EventLoop *LoopPtr, u32 Event, XTime Posted);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* Initializes an event loop with no handlers and no timers.
+*
+* @param	LoopPtr is a pointer to the loop.
+* @param	WheelPtr is the timer wheel of the timers, NULL to poll them
+*		and never sleep.
+*
+* @return	XST_SUCCESS.
+*
+*****************************************************************************/
+s32 EventLoop_Initialize(EventLoop *LoopPtr, TimerWheel *WheelPtr)
+{
+	EventLoop_Timer *TimerPtr;
+	u32 Event;
+
+	(void)memset(LoopPtr, 0, sizeof(*LoopPtr));
+	LoopPtr->WheelPtr = WheelPtr;
+
+	for (Event = 0U; Event < EVENT_LOOP_MAX_EVENTS; Event++) {
+		TimerPtr = &LoopPtr->Timer[Event];
+		TimerPtr->LoopPtr = LoopPtr;
+		TimerPtr->Event = Event;
+		TimerWheel_InitTimer(&TimerPtr->Timer, EventLoop_TimerHandler,
+				     TimerPtr);
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Sets the handler of an event.
+*
+* @param	LoopPtr is a pointer to the loop.
+* @param	Event is the event, the lower the sooner it is handled.
+* @param	Handler is called once per dispatch of the event.
+* @param	CallBackRef is the argument of Handler.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM if the event is out of
+*		range.
+*
+*****************************************************************************/
+s32 EventLoop_SetHandler(EventLoop *LoopPtr, u32 Event,
+			 EventLoop_Handler Handler, void *CallBackRef)
+{
+	if (Event >= EVENT_LOOP_MAX_EVENTS) {
+		return XST_INVALID_PARAM;
+	}
+
+	LoopPtr->CallBackRef[Event] = CallBackRef;
+	LoopPtr->Handler[Event] = Handler;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Makes an event ready. The post time of an event already ready is kept.
+*
+* @param	LoopPtr is a pointer to the loop.
+* @param	Event is the event.
+*
+* @return	None.
+*
+* @note		From any context of the CPU of the loop.
+*
+*****************************************************************************/
+void EventLoop_Post(EventLoop *LoopPtr, u32 Event)
+{
+	u32 Cpsr;
+
+	if (Event >= EVENT_LOOP_MAX_EVENTS) {
+		return;
+	}
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | EVENT_LOOP_IRQ_FIQ_MASK);
+	if ((LoopPtr->Ready & (1U << Event)) == 0U) {
+		XTime_GetTime(&LoopPtr->Posted[Event]);
+		LoopPtr->Ready |= 1U << Event;
+	}
+	LoopPtr->EventStats[Event].Posts++;
+	mtcpsr(Cpsr);
+}
+
+/****************************************************************************/
+/**
+*
+* Posts an event every period, from the first period on, until the period
+* is changed or EventLoop_PostAfter() is called for the event. The posts
+* keep to the period however late they are handled.
+*
+* @param	LoopPtr is a pointer to the loop.
+* @param	Event is the event.
+* @param	PeriodUs is the period in microseconds.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM if the event is out of
+*		range or the period is 0.
+*
+*****************************************************************************/
+s32 EventLoop_PostEvery(EventLoop *LoopPtr, u32 Event, u64 PeriodUs)
+{
+	if (PeriodUs == 0U) {
+		return XST_INVALID_PARAM;
+	}
+
+	return EventLoop_StartTimer(LoopPtr, Event, PeriodUs, 1U);
+}
+
+/****************************************************************************/
+/**
+*
+* Posts an event once after a delay, replacing the timer of the event.
+*
+* @param	LoopPtr is a pointer to the loop.
+* @param	Event is the event.
+* @param	Us is the delay in microseconds.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM if the event is out of
+*		range.
+*
+*****************************************************************************/
+s32 EventLoop_PostAfter(EventLoop *LoopPtr, u32 Event, u64 Us)
+{
+	return EventLoop_StartTimer(LoopPtr, Event, Us, 0U);
+}
+
+/****************************************************************************/
+/**
+*
+* Runs the loop: calls the handlers of the ready events, the lowest
+* numbered first, and sleeps in WFI when none is ready.
+*
+* @param	LoopPtr is a pointer to the loop.
+*
+* @return	Once EventLoop_Stop() is called, does not return otherwise.
+*
+* @note		From the main loop of the CPU of the loop, with the
+*		interrupts enabled.
+*
+*****************************************************************************/
+void EventLoop_Run(EventLoop *LoopPtr)
+{
+	XTime Posted[EVENT_LOOP_MAX_EVENTS];
+	XTime Start;
+	XTime End;
+	u32 Ready;
+	u32 Pending;
+	u32 Event;
+	u32 Cpsr;
+
+	while (LoopPtr->Stop == 0U) {
+		if (LoopPtr->WheelPtr == NULL) {
+			EventLoop_PollTimers(LoopPtr);
+		}
+
+		Cpsr = mfcpsr();
+		mtcpsr(Cpsr | EVENT_LOOP_IRQ_FIQ_MASK);
+		Ready = LoopPtr->Ready;
+		if ((Ready == 0U) && (LoopPtr->Stop == 0U) &&
+		    (LoopPtr->WheelPtr != NULL)) {
+			XTime_GetTime(&Start);
+			dsb();
+			wfi();
+			XTime_GetTime(&End);
+			LoopPtr->Stats.Wakes++;
+			LoopPtr->Stats.IdleCounts += End - Start;
+			/* The interrupt that ended the WFI is taken here */
+			mtcpsr(Cpsr);
+			continue;
+		}
+
+		LoopPtr->Ready = 0U;
+		for (Pending = Ready; Pending != 0U; Pending &= Pending - 1U) {
+			Event = (u32)__builtin_ctz(Pending);
+			Posted[Event] = LoopPtr->Posted[Event];
+		}
+		mtcpsr(Cpsr);
+
+		for (Pending = Ready; Pending != 0U; Pending &= Pending - 1U) {
+			Event = (u32)__builtin_ctz(Pending);
+			EventLoop_Dispatch(LoopPtr, Event, Posted[Event]);
+		}
+	}
+
+	LoopPtr->Stop = 0U;
+}
+
+/****************************************************************************/
+/**
+*
+* Makes EventLoop_Run() return, after the handlers of the events ready.
+* The events posted and the timers started stay, for the next run.
+*
+* @param	LoopPtr is a pointer to the loop.
+*
+* @return	None.
+*
+* @note		From a handler of the loop or an interrupt handler of the
+*		CPU of the loop.
+*
+*****************************************************************************/
+void EventLoop_Stop(EventLoop *LoopPtr)
+{
+	LoopPtr->Stop = 1U;
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the counts of the loop.
+*
+* @param	LoopPtr is a pointer to the loop.
+* @param	StatsPtr is where the counts are returned.
+*
+* @return	None.
+*
+*****************************************************************************/
+void EventLoop_GetStats(const EventLoop *LoopPtr, EventLoop_Stats *StatsPtr)
+{
+	*StatsPtr = LoopPtr->Stats;
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the counts of an event.
+*
+* @param	LoopPtr is a pointer to the loop.
+* @param	Event is the event, below EVENT_LOOP_MAX_EVENTS.
+* @param	StatsPtr is where the counts are returned.
+*
+* @return	None.
+*
+*****************************************************************************/
+void EventLoop_GetEventStats(const EventLoop *LoopPtr, u32 Event,
+			     EventLoop_EventStats *StatsPtr)
+{
+	u32 Cpsr;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | EVENT_LOOP_IRQ_FIQ_MASK);
+	*StatsPtr = LoopPtr->EventStats[Event];
+	mtcpsr(Cpsr);
+}
+
+/*
+ * Posts the event of a timer from the timer interrupt and starts the timer
+ * again for the next period.
+ */
+static void EventLoop_TimerHandler(void *CallBackRef)
+{
+	EventLoop_Timer *TimerPtr = (EventLoop_Timer *)CallBackRef;
+	EventLoop *LoopPtr = TimerPtr->LoopPtr;
+
+	EventLoop_Post(LoopPtr, TimerPtr->Event);
+	if (TimerPtr->Period == 0U) {
+		TimerPtr->Armed = 0U;
+		return;
+	}
+
+	TimerPtr->Deadline += TimerPtr->Period;
+	TimerWheel_StartAt(LoopPtr->WheelPtr, &TimerPtr->Timer,
+			   TimerPtr->Deadline);
+}
+
+/*
+ * Starts the timer of an event, once or periodic.
+ */
+static s32 EventLoop_StartTimer(EventLoop *LoopPtr, u32 Event, u64 Us,
+				u32 Periodic)
+{
+	EventLoop_Timer *TimerPtr;
+	XTime Counts;
+	XTime Now;
+	u32 Cpsr;
+
+	if (Event >= EVENT_LOOP_MAX_EVENTS) {
+		return XST_INVALID_PARAM;
+	}
+
+	TimerPtr = &LoopPtr->Timer[Event];
+	Counts = (Us * COUNTS_PER_SECOND) / 1000000U;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | EVENT_LOOP_IRQ_FIQ_MASK);
+	if (LoopPtr->WheelPtr != NULL) {
+		TimerWheel_Cancel(LoopPtr->WheelPtr, &TimerPtr->Timer);
+	}
+	XTime_GetTime(&Now);
+	TimerPtr->Deadline = Now + Counts;
+	TimerPtr->Period = (Periodic != 0U) ? Counts : 0U;
+	TimerPtr->Armed = 1U;
+	if (LoopPtr->WheelPtr != NULL) {
+		TimerWheel_StartAt(LoopPtr->WheelPtr, &TimerPtr->Timer,
+				   TimerPtr->Deadline);
+	}
+	mtcpsr(Cpsr);
+
+	return XST_SUCCESS;
+}
+
+/*
+ * Posts the events whose timers are due, without a timer wheel.
+ */
+static void EventLoop_PollTimers(EventLoop *LoopPtr)
+{
+	EventLoop_Timer *TimerPtr;
+	XTime Now;
+	u32 Event;
+
+	XTime_GetTime(&Now);
+	for (Event = 0U; Event < EVENT_LOOP_MAX_EVENTS; Event++) {
+		TimerPtr = &LoopPtr->Timer[Event];
+		if ((TimerPtr->Armed == 0U) || (Now < TimerPtr->Deadline)) {
+			continue;
+		}
+
+		EventLoop_Post(LoopPtr, Event);
+		if (TimerPtr->Period == 0U) {
+			TimerPtr->Armed = 0U;
+		} else {
+			TimerPtr->Deadline += TimerPtr->Period;
+		}
+	}
+}
+
+/*
+ * Calls the handler of an event and counts the call.
+ */
+static void EventLoop_Dispatch(EventLoop *LoopPtr, u32 Event, XTime Posted)
+{
+	EventLoop_EventStats *StatsPtr = &LoopPtr->EventStats[Event];
+	XTime Start;
+	XTime End;
+	u32 Counts;
+	u32 Cpsr;
+
+	if (LoopPtr->Handler[Event] == NULL) {
+		return;
+	}
+
+	XTime_GetTime(&Start);
+	LoopPtr->Handler[Event](LoopPtr->CallBackRef[Event]);
+	XTime_GetTime(&End);
+
+	/* Posts counts from the interrupts too */
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | EVENT_LOOP_IRQ_FIQ_MASK);
+	StatsPtr->Dispatches++;
+	Counts = (u32)(End - Start);
+	StatsPtr->HandlerCounts += Counts;
+	if (Counts > StatsPtr->HandlerMaxCounts) {
+		StatsPtr->HandlerMaxCounts = Counts;
+	}
+	Counts = (u32)(Start - Posted);
+	StatsPtr->WakeCounts += Counts;
+	if (Counts > StatsPtr->WakeMaxCounts) {
+		StatsPtr->WakeMaxCounts = Counts;
+	}
+	mtcpsr(Cpsr);
+}
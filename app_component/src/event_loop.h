@@ -0,0 +1,145 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file event_loop.h
+*
+* Event driven main loop, sleeping in WFI while there is nothing to do.
+*
+* An event is a number below EVENT_LOOP_MAX_EVENTS with a handler, set with
+* EventLoop_SetHandler(). EventLoop_Post(), from an interrupt handler or
+* from a handler of the loop, makes the event ready; EventLoop_PostEvery()
+* and EventLoop_PostAfter() post it from a timer of the timer wheel.
+* EventLoop_Run() calls the handlers of the events ready, the lowest
+* numbered first, each once however many times it was posted, and sleeps
+* when none is left.
+*
+* The ready events are a bit mask, so that posting is a few instructions
+* with no queue to overflow. The loop masks the IRQ, looks at the mask and,
+* when it is empty, executes WFI with the IRQ still masked: an interrupt
+* raised after the look keeps the WFI from sleeping, or ends it, and is taken
+* once the IRQ is unmasked again, so that no post is ever slept through.
+* While the CPU sleeps it leaves the L2 and the DDR to CPU1 and the masters
+* of the PL, and draws less power.
+*
+* The loop counts the time it sleeps and its number of wakes, and per event
+* the dispatches, the time spent in the handler and the wake latency, from
+* the first post of the event to the call of its handler. All times are in
+* XTime counts.
+*
+* Without a timer wheel the timers are polled by the loop, which then never
+* sleeps.
+*
+* EventLoop_Stop(), from a handler or an interrupt handler, makes
+* EventLoop_Run() return once the handlers of the events ready have been
+* called, for a loop run for a while only, as by a benchmark before the
+* main loop.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Added EventLoop_Stop().
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xiltimer.h"
+#include "timer_wheel.h"
+
+/************************** Constant Definitions ****************************/
+
+#define EVENT_LOOP_MAX_EVENTS	32U	/**< Bits of the ready mask */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Handles an event, from the loop with the interrupts enabled.
+ */
+typedef void (*EventLoop_Handler)(void *CallBackRef);
+
+/**
+ * Counts of an event.
+ */
+typedef struct {
+	u32 Posts;		/**< Calls of EventLoop_Post() */
+	u32 Dispatches;		/**< Calls of the handler */
+	u64 HandlerCounts;	/**< Time in the handler */
+	u32 HandlerMaxCounts;	/**< Longest call */
+	u64 WakeCounts;		/**< Time from post to dispatch */
+	u32 WakeMaxCounts;	/**< Longest of them */
+} EventLoop_EventStats;
+
+/**
+ * Counts of the loop.
+ */
+typedef struct {
+	u32 Wakes;		/**< Times the loop slept and woke up */
+	u64 IdleCounts;		/**< Time asleep in WFI */
+} EventLoop_Stats;
+
+struct EventLoop_s;
+
+/**
+ * The timer of an event.
+ */
+typedef struct {
+	TimerWheel_Timer Timer;
+	struct EventLoop_s *LoopPtr;
+	u32 Event;
+	XTime Deadline;		/**< Of the next post */
+	XTime Period;		/**< 0 for a single post */
+	u32 Armed;
+} EventLoop_Timer;
+
+/**
+ * An event loop.
+ */
+typedef struct EventLoop_s {
+	volatile u32 Ready;	/**< Events posted */
+	volatile u32 Stop;	/**< EventLoop_Run() is to return */
+	XTime Posted[EVENT_LOOP_MAX_EVENTS]; /**< First post of each */
+	EventLoop_Handler Handler[EVENT_LOOP_MAX_EVENTS];
+	void *CallBackRef[EVENT_LOOP_MAX_EVENTS];
+	EventLoop_Timer Timer[EVENT_LOOP_MAX_EVENTS];
+	TimerWheel *WheelPtr;	/**< NULL to poll the timers */
+	EventLoop_EventStats EventStats[EVENT_LOOP_MAX_EVENTS];
+	EventLoop_Stats Stats;
+} EventLoop;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+s32 EventLoop_Initialize(EventLoop *LoopPtr, TimerWheel *WheelPtr);
+s32 EventLoop_SetHandler(EventLoop *LoopPtr, u32 Event,
+			 EventLoop_Handler Handler, void *CallBackRef);
+void EventLoop_Post(EventLoop *LoopPtr, u32 Event);
+s32 EventLoop_PostEvery(EventLoop *LoopPtr, u32 Event, u64 PeriodUs);
+s32 EventLoop_PostAfter(EventLoop *LoopPtr, u32 Event, u64 Us);
+void EventLoop_Run(EventLoop *LoopPtr);
+void EventLoop_Stop(EventLoop *LoopPtr);
+void EventLoop_GetStats(const EventLoop *LoopPtr, EventLoop_Stats *StatsPtr);
+void EventLoop_GetEventStats(const EventLoop *LoopPtr, u32 Event,
+			     EventLoop_EventStats *StatsPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EVENT_LOOP_H */
@@ -0,0 +1,466 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file file_map.c
+*
+* Demand paged file mappings. Refer to file_map.h for how they are used.
+*
+* A page that is not resident has no descriptor and takes a translation
+* fault. A resident page is mapped read-only, normal write-back cacheable
+* as NORM_WB_CACHE and never executed. FileMap_Age() clears its access
+* permission bits, and the permission fault that follows on a read sets
+* them again. The descriptors are written in place, their line flushed and
+* the TLB entry of the page invalidated, the translation table walks
+* being cacheable.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xparameters.h"
+
+#ifdef XPAR_XSDPS_0_BASEADDR
+
+#include "file_map.h"
+
+#if FF_USE_FASTSEEK
+
+#include <string.h>
+#include "xstatus.h"
+#include "xil_cache.h"
+#include "xil_exception.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+
+/************************** Constant Definitions ****************************/
+
+#define FILE_MAP_NONE		0xFFFFFFFFU
+
+/*
+ * Descriptors: S, TEX=b101 C=b0 B=b1 as NORM_WB_CACHE, XN, and AP2=b1
+ * AP=b11 read-only or AP2=b0 AP=b00 no access.
+ */
+#define FILE_MAP_SECT_RO	(0x1DC16U | (FILE_MAP_DOMAIN << 5))
+#define FILE_MAP_SECT_ACCESS	0x8C00U
+#define FILE_MAP_PAGE_RO	0x777U
+#define FILE_MAP_PAGE_ACCESS	0x230U
+#define FILE_MAP_COARSE		(0x1U | (FILE_MAP_DOMAIN << 5))
+
+#define FILE_MAP_TABLE_SIZE	1024U	/* Bytes of a coarse table */
+
+/* DFSR */
+#define FILE_MAP_DFSR_WNR	0x800U	/* Write */
+#define FILE_MAP_FS_TRANSLATION	0x05U	/* Section, + 2 for a page */
+#define FILE_MAP_FS_PERMISSION	0x0DU
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/*
+ * Fault status of a DFSR, FS[4] being bit 10.
+ */
+#define FileMap_FaultStatus(Dfsr)					\
+	(((Dfsr) & 0xFU) | (((Dfsr) >> 6) & 0x10U))
+
+/*
+ * Bytes of the range of a map, whole pages.
+ */
+#define FileMap_Span(MapPtr)						\
+	(((MapPtr)->Size + (MapPtr)->PageSize - 1U) &			\
+	 ~((MapPtr)->PageSize - 1U))
+
+/************************** Function Prototypes *****************************/
+
+static void FileMap_AbortHandler(void *CallBackRef);
+static s32 FileMap_Fault(FileMap *MapPtr, u32 Addr, u32 Status);
+static u32 *FileMap_Descriptor(const FileMap *MapPtr, u32 Page);
+static void FileMap_SetDescriptor(const FileMap *MapPtr, u32 Page,
+				  u32 Descriptor);
+static void FileMap_SetSections(UINTPTR Base, u32 Size, const u32 *Tables);
+
+/************************** Variable Definitions ****************************/
+
+extern u32 MMUTable[];
+
+static FileMap *FileMap_List;
+
+/* Handler of the faults that are not of a map */
+static Xil_ExceptionHandler FileMap_Previous;
+static void *FileMap_PreviousData;
+
+/****************************************************************************/
+/**
+*
+* Maps a file, none of it resident.
+*
+* @param	MapPtr is a pointer to the map.
+* @param	Path is the path of the file, on a mounted volume.
+* @param	Base is the address to map it at, 1 MB aligned, from
+*		FILE_MAP_BASE up. The range must not be mapped.
+* @param	PageSize is FILE_MAP_PAGE_4K or FILE_MAP_PAGE_1M.
+* @param	PageTables are FILE_MAP_TABLE_WORDS(file size) words, aligned
+*		to 1 KB, for 4 KB pages, or NULL for 1 MB pages.
+* @param	FramesPtr is NumFrames pages of DDR, aligned to a page, for
+*		the resident pages.
+* @param	NumFrames is the number of frames, from 1 to
+*		FILE_MAP_MAX_FRAMES.
+*
+* @return
+*		- XST_SUCCESS if the file is mapped at Base.
+*		- XST_INVALID_PARAM if the range or the memory do not suit.
+*		- XST_DEVICE_BUSY if the range is already mapped.
+*		- XST_BUFFER_TOO_SMALL if the file is too fragmented for
+*		FILE_MAP_CLMT_WORDS.
+*		- XST_FAILURE if the file cannot be opened.
+*
+*****************************************************************************/
+s32 FileMap_Open(FileMap *MapPtr, const char *Path, UINTPTR Base,
+		 u32 PageSize, u32 *PageTables, u8 *FramesPtr,
+		 u32 NumFrames)
+{
+	u32 Section;
+	u32 Last;
+	u32 Dacr;
+	u32 Index;
+	FRESULT Result;
+
+	if (((Base & (FILE_MAP_SECTION - 1U)) != 0U) ||
+	    (Base < FILE_MAP_BASE) ||
+	    ((PageSize != FILE_MAP_PAGE_4K) &&
+	     (PageSize != FILE_MAP_PAGE_1M)) ||
+	    (((UINTPTR)FramesPtr & (PageSize - 1U)) != 0U) ||
+	    (NumFrames == 0U) || (NumFrames > FILE_MAP_MAX_FRAMES) ||
+	    ((PageSize == FILE_MAP_PAGE_4K) &&
+	     ((PageTables == NULL) ||
+	      (((UINTPTR)PageTables & (FILE_MAP_TABLE_SIZE - 1U)) != 0U)))) {
+		return XST_INVALID_PARAM;
+	}
+
+	(void)memset(MapPtr, 0, sizeof(*MapPtr));
+	if (f_open(&MapPtr->File, Path, FA_READ) != FR_OK) {
+		return XST_FAILURE;
+	}
+
+	MapPtr->Base = Base;
+	MapPtr->Size = (u32)f_size(&MapPtr->File);
+	MapPtr->PageSize = PageSize;
+	MapPtr->PageShift = (PageSize == FILE_MAP_PAGE_4K) ? 12U : 20U;
+	MapPtr->PageTables = (PageSize == FILE_MAP_PAGE_4K) ? PageTables :
+			     NULL;
+	MapPtr->FramesPtr = FramesPtr;
+	MapPtr->NumFrames = NumFrames;
+	if ((MapPtr->Size == 0U) ||
+	    (FileMap_Span(MapPtr) > (FILE_MAP_BASE + FILE_MAP_BASE_SIZE -
+				     Base))) {
+		(void)f_close(&MapPtr->File);
+		return XST_INVALID_PARAM;
+	}
+
+	/* Found once, to seek without reading the FAT */
+	MapPtr->Clmt[0] = FILE_MAP_CLMT_WORDS;
+	MapPtr->File.cltbl = MapPtr->Clmt;
+	Result = f_lseek(&MapPtr->File, CREATE_LINKMAP);
+	if (Result != FR_OK) {
+		(void)f_close(&MapPtr->File);
+		return (Result == FR_NOT_ENOUGH_CORE) ? XST_BUFFER_TOO_SMALL :
+		       XST_FAILURE;
+	}
+
+	Section = Base / FILE_MAP_SECTION;
+	Last = (Base + FileMap_Span(MapPtr) - 1U) / FILE_MAP_SECTION;
+	for (Index = Section; Index <= Last; Index++) {
+		if (MMUTable[Index] != 0U) {
+			(void)f_close(&MapPtr->File);
+			return XST_DEVICE_BUSY;
+		}
+	}
+
+	for (Index = 0U; Index < NumFrames; Index++) {
+		MapPtr->Page[Index] = FILE_MAP_NONE;
+	}
+
+	/* The domain of the maps checks the access permissions */
+	Dacr = mfcp(XREG_CP15_DOMAIN_ACCESS_CTRL);
+	Dacr &= ~(0x3U << (2U * FILE_MAP_DOMAIN));
+	Dacr |= 0x1U << (2U * FILE_MAP_DOMAIN);
+	mtcp(XREG_CP15_DOMAIN_ACCESS_CTRL, Dacr);
+
+	if (MapPtr->PageTables != NULL) {
+		(void)memset(MapPtr->PageTables, 0,
+			     (Last - Section + 1U) * FILE_MAP_TABLE_SIZE);
+		Xil_DCacheFlushRange((UINTPTR)MapPtr->PageTables,
+				     (Last - Section + 1U) *
+				     FILE_MAP_TABLE_SIZE);
+	}
+
+	if (FileMap_List == NULL) {
+		Xil_GetExceptionRegisterHandler(XIL_EXCEPTION_ID_DATA_ABORT_INT,
+						&FileMap_Previous,
+						&FileMap_PreviousData);
+	}
+	MapPtr->Next = FileMap_List;
+	FileMap_List = MapPtr;
+	Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_DATA_ABORT_INT,
+				     FileMap_AbortHandler, NULL);
+
+	FileMap_SetSections(Base, FileMap_Span(MapPtr), MapPtr->PageTables);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Turns the access off on the resident pages, for the next access to each
+* to mark it used. To be called now and then, from the thread that uses
+* the map.
+*
+* @param	MapPtr is a pointer to the map.
+*
+* @return	None.
+*
+*****************************************************************************/
+void FileMap_Age(FileMap *MapPtr)
+{
+	u32 Access = (MapPtr->PageTables != NULL) ? FILE_MAP_PAGE_ACCESS :
+		     FILE_MAP_SECT_ACCESS;
+	u32 *DescPtr;
+	u32 Frame;
+
+	for (Frame = 0U; Frame < MapPtr->NumFrames; Frame++) {
+		if (MapPtr->Page[Frame] == FILE_MAP_NONE) {
+			continue;
+		}
+		DescPtr = FileMap_Descriptor(MapPtr, MapPtr->Page[Frame]);
+		*DescPtr &= ~Access;
+		Xil_DCacheFlushRange((UINTPTR)DescPtr, sizeof(*DescPtr));
+	}
+
+	mtcp(XREG_CP15_INVAL_UTLB_UNLOCKED, 0U);
+	dsb();
+	isb();
+}
+
+/****************************************************************************/
+/**
+*
+* Unmaps a file and closes it.
+*
+* @param	MapPtr is a pointer to the map.
+*
+* @return
+*		- XST_SUCCESS if the file is closed.
+*		- XST_FAILURE if f_close() failed, the range is unmapped
+*		anyway.
+*
+*****************************************************************************/
+s32 FileMap_Close(FileMap *MapPtr)
+{
+	FileMap **LinkPtr = &FileMap_List;
+
+	while ((*LinkPtr != NULL) && (*LinkPtr != MapPtr)) {
+		LinkPtr = &(*LinkPtr)->Next;
+	}
+	if (*LinkPtr != NULL) {
+		*LinkPtr = MapPtr->Next;
+	}
+
+	FileMap_SetSections(MapPtr->Base, FileMap_Span(MapPtr), NULL);
+
+	if (FileMap_List == NULL) {
+		Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_DATA_ABORT_INT,
+					     FileMap_Previous,
+					     FileMap_PreviousData);
+	}
+
+	return (f_close(&MapPtr->File) == FR_OK) ? XST_SUCCESS : XST_FAILURE;
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the counts of a map.
+*
+* @param	MapPtr is a pointer to the map.
+* @param	StatsPtr is where the counts are returned.
+*
+* @return	None.
+*
+*****************************************************************************/
+void FileMap_GetStats(const FileMap *MapPtr, FileMap_Stats *StatsPtr)
+{
+	*StatsPtr = MapPtr->Stats;
+}
+
+/*
+ * Data abort handler: serves the faults of the maps and passes the others
+ * on. The access runs again once the handler returns.
+ */
+static void FileMap_AbortHandler(void *CallBackRef)
+{
+	FileMap *MapPtr;
+	u32 Dfsr = mfcp(XREG_CP15_DATA_FAULT_STATUS);
+	u32 Dfar = mfcp(XREG_CP15_DATA_FAULT_ADDRESS);
+
+	(void)CallBackRef;
+
+	if ((Dfsr & FILE_MAP_DFSR_WNR) == 0U) {
+		for (MapPtr = FileMap_List; MapPtr != NULL;
+		     MapPtr = MapPtr->Next) {
+			if ((Dfar - MapPtr->Base) < FileMap_Span(MapPtr)) {
+				if (FileMap_Fault(MapPtr, Dfar,
+						  FileMap_FaultStatus(Dfsr)) ==
+				    XST_SUCCESS) {
+					return;
+				}
+				break;
+			}
+		}
+	}
+
+	if (FileMap_Previous != NULL) {
+		FileMap_Previous(FileMap_PreviousData);
+	}
+}
+
+/*
+ * Serves a read fault at an address of a map: puts back the access of a
+ * resident page, or reads the page into the frame used longest ago.
+ */
+static s32 FileMap_Fault(FileMap *MapPtr, u32 Addr, u32 Status)
+{
+	u32 Page = (Addr - MapPtr->Base) >> MapPtr->PageShift;
+	u32 *DescPtr = FileMap_Descriptor(MapPtr, Page);
+	u32 Small = (MapPtr->PageTables != NULL) ? 2U : 0U;
+	u32 RoAttr = (Small != 0U) ? FILE_MAP_PAGE_RO : FILE_MAP_SECT_RO;
+	u32 Offset = Page << MapPtr->PageShift;
+	u32 NumBytes;
+	UINT Read;
+	u32 Frame;
+	u32 Oldest;
+	u8 *FramePtr;
+
+	MapPtr->Clock++;
+
+	if ((Status == (FILE_MAP_FS_PERMISSION + Small)) && (*DescPtr != 0U)) {
+		Frame = ((*DescPtr & ~(MapPtr->PageSize - 1U)) -
+			 (u32)(UINTPTR)MapPtr->FramesPtr) >> MapPtr->PageShift;
+		MapPtr->Used[Frame] = MapPtr->Clock;
+		FileMap_SetDescriptor(MapPtr, Page, *DescPtr | RoAttr);
+		MapPtr->Stats.SoftFaults++;
+		return XST_SUCCESS;
+	}
+
+	if ((Status != (FILE_MAP_FS_TRANSLATION + Small)) || (*DescPtr != 0U)) {
+		return XST_FAILURE;
+	}
+
+	/* A free frame, or the one used longest ago */
+	Oldest = 0U;
+	for (Frame = 0U; Frame < MapPtr->NumFrames; Frame++) {
+		if (MapPtr->Page[Frame] == FILE_MAP_NONE) {
+			Oldest = Frame;
+			break;
+		}
+		if ((MapPtr->Clock - MapPtr->Used[Frame]) >
+		    (MapPtr->Clock - MapPtr->Used[Oldest])) {
+			Oldest = Frame;
+		}
+	}
+	Frame = Oldest;
+	if (MapPtr->Page[Frame] != FILE_MAP_NONE) {
+		FileMap_SetDescriptor(MapPtr, MapPtr->Page[Frame], 0U);
+		MapPtr->Page[Frame] = FILE_MAP_NONE;
+		MapPtr->Stats.Evictions++;
+	}
+
+	FramePtr = MapPtr->FramesPtr + (Frame << MapPtr->PageShift);
+	NumBytes = MapPtr->Size - Offset;
+	if (NumBytes > MapPtr->PageSize) {
+		NumBytes = MapPtr->PageSize;
+	}
+	if ((f_lseek(&MapPtr->File, Offset) != FR_OK) ||
+	    (f_read(&MapPtr->File, FramePtr, NumBytes, &Read) != FR_OK) ||
+	    (Read != NumBytes)) {
+		MapPtr->Stats.Errors++;
+		return XST_FAILURE;
+	}
+	(void)memset(FramePtr + NumBytes, 0, MapPtr->PageSize - NumBytes);
+
+	MapPtr->Page[Frame] = Page;
+	MapPtr->Used[Frame] = MapPtr->Clock;
+	FileMap_SetDescriptor(MapPtr, Page, (u32)(UINTPTR)FramePtr | RoAttr);
+	MapPtr->Stats.Faults++;
+	MapPtr->Stats.BytesRead += NumBytes;
+
+	return XST_SUCCESS;
+}
+
+/*
+ * Returns the descriptor of a page, in a coarse table or the translation
+ * table.
+ */
+static u32 *FileMap_Descriptor(const FileMap *MapPtr, u32 Page)
+{
+	if (MapPtr->PageTables != NULL) {
+		return &MapPtr->PageTables[Page];
+	}
+
+	return &MMUTable[(MapPtr->Base / FILE_MAP_SECTION) + Page];
+}
+
+/*
+ * Writes the descriptor of a page and drops its TLB entry.
+ */
+static void FileMap_SetDescriptor(const FileMap *MapPtr, u32 Page,
+				  u32 Descriptor)
+{
+	u32 *DescPtr = FileMap_Descriptor(MapPtr, Page);
+
+	*DescPtr = Descriptor;
+	Xil_DCacheFlushRange((UINTPTR)DescPtr, sizeof(*DescPtr));
+	mtcp(XREG_CP15_INVAL_UTLB_MVA,
+	     (u32)MapPtr->Base + (Page << MapPtr->PageShift));
+	dsb();
+	isb();
+}
+
+/*
+ * Points the sections of a range at coarse tables, or leaves them to
+ * fault without.
+ */
+static void FileMap_SetSections(UINTPTR Base, u32 Size, const u32 *Tables)
+{
+	u32 Section = Base / FILE_MAP_SECTION;
+	u32 Count = (Size + FILE_MAP_SECTION - 1U) / FILE_MAP_SECTION;
+	u32 Index;
+
+	for (Index = 0U; Index < Count; Index++) {
+		MMUTable[Section + Index] = (Tables != NULL) ?
+			((u32)(UINTPTR)&Tables[Index * 256U] |
+			 FILE_MAP_COARSE) : 0U;
+	}
+	Xil_DCacheFlushRange((UINTPTR)&MMUTable[Section],
+			     Count * sizeof(u32));
+
+	mtcp(XREG_CP15_INVAL_UTLB_UNLOCKED, 0U);
+	dsb();
+	isb();
+}
+
+#endif /* FF_USE_FASTSEEK */
+
+#endif /* XPAR_XSDPS_0_BASEADDR */
@@ -0,0 +1,169 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file file_map.h
+*
+* Demand paged, read-only mappings of files of the SD card, on xilffs.
+*
+* FileMap_Open() maps a file at a virtual range of the translation table
+* that faults, 0xC0000000 to 0xDFFFFFFF being reserved on the Zynq-7000,
+* without reading any of it. The first access to a page of the range takes
+* a data abort, whose handler reads the page from the file into one of the
+* frames of the map, maps it and returns to the access, which runs again.
+* A random read of the file is then a memory access, cached, and costs a
+* read of the card only the first time its page is accessed while it is
+* resident.
+*
+* Pages are 4 KB small pages, through coarse page tables the caller gives
+* for the range, or 1 MB sections, for files read in large runs. The file
+* is opened with a fast seek cluster link map, so that finding the page of
+* a fault reads no FAT.
+*
+* The frames are replaced least recently used first. The Cortex-A9 keeps
+* no access flag, so FileMap_Age(), called now and then, e.g. once a
+* second, turns the access off on the resident pages: the next access to
+* such a page takes a fault that only puts it back and marks it used, and
+* the frame to replace is the one whose page was used longest ago.
+*
+* The pages are mapped in domain FILE_MAP_DOMAIN, set to client, so that
+* their access permissions are checked: a write to the range takes a
+* permission fault that is passed on, as any fault outside the maps, to
+* the data abort handler registered before the first map, e.g. that of
+* panic_dump.h. So is a fault whose page cannot be read.
+*
+* The fault handler runs in abort mode with the interrupts masked and
+* reads the card through xilffs. Hence:
+* - the abort stack must hold xilffs and the SD driver, link with
+*   -Wl,--defsym=_ABORT_STACK_SIZE=0x4000 or so;
+* - the range is not to be accessed from interrupt handlers, nor given to
+*   xilffs, nor accessed by CPU1 or a DMA master, the mapping being that of
+*   CPU0 only;
+* - xilffs must be built with FILE_SYSTEM_USE_FASTSEEK.
+*
+* SD0 and xilffs must be enabled in the BSP, xilffs added to
+* USER_LINK_LIBRARIES and the volume mounted with f_mount(). Without SD0
+* or fast seek the file compiles to nothing.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef FILE_MAP_H
+#define FILE_MAP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "ff.h"
+
+/************************** Constant Definitions ****************************/
+
+#define FILE_MAP_BASE		0xC0000000U	/**< Reserved, faults */
+#define FILE_MAP_BASE_SIZE	0x20000000U
+
+/** @name Page sizes
+ * @{
+ */
+#define FILE_MAP_PAGE_4K	0x1000U		/**< Small pages */
+#define FILE_MAP_PAGE_1M	0x100000U	/**< Sections */
+/** @} */
+
+#ifndef FILE_MAP_MAX_FRAMES
+#define FILE_MAP_MAX_FRAMES	256U		/**< Frames of a map */
+#endif
+
+#ifndef FILE_MAP_CLMT_WORDS
+#define FILE_MAP_CLMT_WORDS	64U		/**< Of the link map */
+#endif
+
+#ifndef FILE_MAP_DOMAIN
+#define FILE_MAP_DOMAIN		1U		/**< Set to client */
+#endif
+
+#define FILE_MAP_SECTION	0x100000U
+
+/**
+ * Words of the coarse page tables of a mapping of Size bytes with 4 KB
+ * pages, 256 per MB, to be aligned to 1 KB.
+ */
+#define FILE_MAP_TABLE_WORDS(Size)					\
+	((((Size) + FILE_MAP_SECTION - 1U) / FILE_MAP_SECTION) * 256U)
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Counts of a map.
+ */
+typedef struct {
+	u32 Faults;		/**< Pages read from the file */
+	u32 SoftFaults;		/**< Resident pages used again after aging */
+	u32 Evictions;		/**< Frames replaced */
+	u32 Errors;		/**< Faults the file could not serve */
+	u64 BytesRead;
+} FileMap_Stats;
+
+/**
+ * A mapped file.
+ */
+typedef struct FileMap_s {
+	FIL File;
+	DWORD Clmt[FILE_MAP_CLMT_WORDS];	/**< Fast seek link map */
+	UINTPTR Base;		/**< Of the range */
+	u32 Size;		/**< Bytes of the file mapped */
+	u32 PageSize;		/**< FILE_MAP_PAGE_4K or FILE_MAP_PAGE_1M */
+	u32 PageShift;
+	u32 *PageTables;	/**< Coarse tables, 4 KB pages only */
+	u8 *FramesPtr;		/**< NumFrames pages */
+	u32 NumFrames;
+	u32 Page[FILE_MAP_MAX_FRAMES];	/**< Held by each frame, or none */
+	u32 Used[FILE_MAP_MAX_FRAMES];	/**< Clock of the last use */
+	u32 Clock;
+	struct FileMap_s *Next;	/**< Other open maps */
+	FileMap_Stats Stats;
+} FileMap;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/****************************************************************************/
+/**
+*
+* Returns the address a file is mapped at.
+*
+* @param	MapPtr is a pointer to the map.
+*
+* @return	The address of the first byte of the file.
+*
+* @note		C-style signature:
+*		void *FileMap_Address(const FileMap *MapPtr)
+*
+*****************************************************************************/
+#define FileMap_Address(MapPtr)	((void *)(MapPtr)->Base)
+
+/************************** Function Prototypes *****************************/
+
+s32 FileMap_Open(FileMap *MapPtr, const char *Path, UINTPTR Base,
+		 u32 PageSize, u32 *PageTables, u8 *FramesPtr,
+		 u32 NumFrames);
+void FileMap_Age(FileMap *MapPtr);
+s32 FileMap_Close(FileMap *MapPtr);
+void FileMap_GetStats(const FileMap *MapPtr, FileMap_Stats *StatsPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FILE_MAP_H */
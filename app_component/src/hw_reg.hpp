@@ -0,0 +1,152 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file hw_reg.hpp
+*
+* Registers and bit fields as C++ types, for drivers whose base address is
+* known at compile time, e.g. from xparameters.h.
+*
+* A register is a type, Reg<Address>, and a field of it another one,
+* Field<Reg, Position, Width>, so that the address and the mask are
+* constants of the type and every access compiles to the load or the store
+* that Xil_In32() and Xil_Out32() would do, with no instance, no pointer
+* to a configuration and no call. A value written to a field is checked
+* against its width at compile time when it is a constant.
+*
+* @code
+*	using Cr = hw::Reg<XPAR_XUARTPS_0_BASEADDR + 0x00U>;
+*	using CrRxEn = hw::Field<Cr, 2U, 1U>;
+*	using CrTxEn = hw::Field<Cr, 4U, 1U>;
+*	CrTxEn::Write(1U);		// Read-modify-write of bit 4
+*	Cr::Write(CrTxEn::Value<1U>() | CrRxEn::Value<1U>());
+* @endcode
+*
+* The header needs C++17 and is used from .cpp files of the application:
+* a .cpp in USER_COMPILE_SOURCES makes the project a C++ one.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef HW_REG_HPP
+#define HW_REG_HPP
+
+#if !defined(__cplusplus) || (__cplusplus < 201703L)
+#error "hw_reg.hpp needs C++17"
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
+namespace hw {
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * A memory mapped register of type T at a constant address.
+ */
+template <UINTPTR Address, typename T = u32>
+struct Reg {
+	using Type = T;
+	static constexpr UINTPTR Addr = Address;
+
+	static_assert((Address % sizeof(T)) == 0U,
+		      "register must be aligned to its size");
+
+	static inline T Read()
+	{
+		return *reinterpret_cast<volatile T *>(Address);
+	}
+
+	static inline void Write(T Value)
+	{
+		*reinterpret_cast<volatile T *>(Address) = Value;
+	}
+
+	/** Read-modify-write: clears Clear, then sets Set */
+	static inline void Modify(T Clear, T Set)
+	{
+		Write((Read() & static_cast<T>(~Clear)) | Set);
+	}
+
+	static inline void SetBits(T Mask)
+	{
+		Modify(static_cast<T>(0), Mask);
+	}
+
+	static inline void ClearBits(T Mask)
+	{
+		Modify(Mask, static_cast<T>(0));
+	}
+};
+
+/**
+ * A field of Width bits at bit Position of the register R.
+ */
+template <typename R, u32 Position, u32 Width>
+struct Field {
+	using Type = typename R::Type;
+	static constexpr u32 Pos = Position;
+	static constexpr u32 Bits = Width;
+
+	static_assert((Width != 0U) && ((Position + Width) <= (sizeof(Type) * 8U)),
+		      "field must lie within its register");
+
+	/** Mask of the field in the register */
+	static constexpr Type Mask =
+		static_cast<Type>(((Width == (sizeof(Type) * 8U)) ?
+				   ~static_cast<Type>(0) :
+				   ((static_cast<Type>(1) << Width) - 1U)) <<
+				  Position);
+
+	/** The field set to V, the other bits 0, checked at compile time */
+	template <Type V>
+	static constexpr Type Value()
+	{
+		static_assert((V & (Mask >> Position)) == V,
+			      "value does not fit the field");
+		return static_cast<Type>(V << Position);
+	}
+
+	/** The field set to V, the other bits 0, V truncated to the width */
+	static constexpr Type Encode(Type V)
+	{
+		return static_cast<Type>((V << Position) & Mask);
+	}
+
+	static constexpr Type Decode(Type RegValue)
+	{
+		return static_cast<Type>((RegValue & Mask) >> Position);
+	}
+
+	static inline Type Read()
+	{
+		return Decode(R::Read());
+	}
+
+	/** Read-modify-write of the field alone */
+	static inline void Write(Type V)
+	{
+		R::Modify(Mask, Encode(V));
+	}
+
+	static inline bool IsSet()
+	{
+		return (R::Read() & Mask) != 0U;
+	}
+};
+
+} /* namespace hw */
+
+#endif /* HW_REG_HPP */
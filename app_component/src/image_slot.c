@@ -0,0 +1,825 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file image_slot.c
+*
+* A/B boot image slots updated with deltas. Refer to image_slot.h for how
+* it is used.
+*
+* The stream is taken through a few states: the delta header, then for each
+* chunk its header and its stored bytes. A chunk is only decoded once all
+* of it arrived, in ImageSlot_OpBuffer, and its operations never run past
+* it, so that no operation is split between two calls. The image is built
+* in ImageSlot_Block, and its first block in ImageSlot_FirstBlock, which is
+* kept until ImageSlot_Finish().
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xparameters.h"
+
+#ifdef XPAR_XQSPIPS_0_BASEADDR
+
+#include <string.h>
+#include "xstatus.h"
+#include "xil_io.h"
+#include "xdevcfg_hw.h"
+#include "uart_frame.h"
+#include "lz4_block.h"
+#include "image_slot.h"
+
+/************************** Constant Definitions ****************************/
+
+#define IMAGE_SLOT_STATE_HEADER		0U
+#define IMAGE_SLOT_STATE_CHUNK_HEADER	1U
+#define IMAGE_SLOT_STATE_CHUNK_DATA	2U
+#define IMAGE_SLOT_STATE_DONE		3U
+#define IMAGE_SLOT_STATE_ERROR		4U
+
+#define IMAGE_SLOT_SOURCE_CHUNK		4096U	/* Bytes read at a time */
+#define IMAGE_SLOT_MULTIBOOT_MASK	0x1FFFU	/* Reboot offset */
+
+/*
+ * Boot header checks of the BootROM and FSBL, fsbl.h
+ */
+#define IMAGE_SLOT_WIDTH_OFFSET		0x020U
+#define IMAGE_SLOT_WIDTH_WORD		0xAA995566U
+#define IMAGE_SLOT_IDENT_OFFSET		0x024U
+#define IMAGE_SLOT_IDENT		0x584C4E58U	/* "XLNX" */
+#define IMAGE_SLOT_CHECKSUM_OFFSET	0x048U
+#define IMAGE_SLOT_CHECKSUM_WORDS	10U
+
+/*
+ * Image index of FSBL_IMAGE_INDEX, fsbl_image_index.h
+ */
+#define IMAGE_SLOT_INDEX_MAGIC		0x58444946U	/* "FIDX" */
+#define IMAGE_SLOT_INDEX_MAX_IMAGES	16U
+
+/**************************** Type Definitions ******************************/
+
+#ifdef IMAGE_SLOT_INDEX_OFFSET
+/*
+ * FsblImageIndex of the FSBL
+ */
+typedef struct {
+	u32 Magic;
+	u32 Count;
+	u32 Offset[IMAGE_SLOT_INDEX_MAX_IMAGES];
+	u32 Checksum;
+} ImageSlot_Index;
+#endif
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define ImageSlot_Target(SlotPtr)					\
+	ImageSlot_Offset(((SlotPtr)->Active == IMAGE_SLOT_A) ?		\
+			 IMAGE_SLOT_B : IMAGE_SLOT_A)
+
+#define ImageSlot_Word(BytePtr)						\
+	((u32)(BytePtr)[0] | ((u32)(BytePtr)[1] << 8) |			\
+	 ((u32)(BytePtr)[2] << 16) | ((u32)(BytePtr)[3] << 24))
+
+/************************** Function Prototypes *****************************/
+
+static s32 ImageSlot_Fail(ImageSlot *SlotPtr, s32 Status);
+static s32 ImageSlot_StartHeader(ImageSlot *SlotPtr);
+static s32 ImageSlot_RunChunk(ImageSlot *SlotPtr);
+static s32 ImageSlot_Emit(ImageSlot *SlotPtr, const u8 *DataPtr, u8 Fill,
+			  u32 NumBytes);
+static s32 ImageSlot_EmitSource(ImageSlot *SlotPtr, u32 Source,
+				const u8 *DiffPtr, u32 NumBytes);
+static s32 ImageSlot_Flush(ImageSlot *SlotPtr);
+static s32 ImageSlot_CheckBootHeader(const u8 *ImagePtr, u32 NumBytes);
+static s32 ImageSlot_Invalidate(ImageSlot *SlotPtr, u32 Offset);
+
+/************************** Variable Definitions ****************************/
+
+static u8 ImageSlot_ChunkBuffer[IMAGE_DELTA_CHUNK_MAX];
+static u8 ImageSlot_OpBuffer[IMAGE_DELTA_CHUNK_MAX];
+static u8 ImageSlot_Block[IMAGE_SLOT_BLOCK_SIZE];
+static u8 ImageSlot_FirstBlock[IMAGE_SLOT_BLOCK_SIZE];
+static u8 ImageSlot_Source[IMAGE_SLOT_SOURCE_CHUNK];
+
+/****************************************************************************/
+/**
+*
+* Initializes the slots, the active one from the multiboot register.
+*
+* @param	SlotPtr is a pointer to the slots.
+* @param	FlashPtr is a pointer to the flash, initialized with
+*		QspiFlash_Initialize().
+*
+* @return
+*		- XST_SUCCESS if the slots are in the flash.
+*		- XST_INVALID_PARAM if they do not fit in it, overlap or are
+*		not aligned to its erase blocks and the multiboot step.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 ImageSlot_Initialize(ImageSlot *SlotPtr, QspiFlash *FlashPtr)
+{
+	u32 Boot;
+
+	(void)memset(SlotPtr, 0, sizeof(*SlotPtr));
+
+	if ((IMAGE_SLOT_B_OFFSET < (IMAGE_SLOT_A_OFFSET + IMAGE_SLOT_SIZE)) ||
+	    ((IMAGE_SLOT_B_OFFSET + IMAGE_SLOT_SIZE) > FlashPtr->Size) ||
+	    ((IMAGE_SLOT_A_OFFSET % FlashPtr->LargeErase) != 0U) ||
+	    ((IMAGE_SLOT_B_OFFSET % FlashPtr->LargeErase) != 0U) ||
+	    ((IMAGE_SLOT_BLOCK_SIZE % FlashPtr->SmallErase) != 0U) ||
+	    ((IMAGE_SLOT_B_OFFSET % IMAGE_SLOT_MULTIBOOT_STEP) != 0U)) {
+		return XST_INVALID_PARAM;
+	}
+
+	SlotPtr->FlashPtr = FlashPtr;
+
+	Boot = (Xil_In32(XPS_DEV_CFG_APB_BASEADDR +
+			 XDCFG_MULTIBOOT_ADDR_OFFSET) &
+		IMAGE_SLOT_MULTIBOOT_MASK) * IMAGE_SLOT_MULTIBOOT_STEP;
+	SlotPtr->Active = ((Boot >= IMAGE_SLOT_B_OFFSET) &&
+			   (Boot < (IMAGE_SLOT_B_OFFSET + IMAGE_SLOT_SIZE))) ?
+			  IMAGE_SLOT_B : IMAGE_SLOT_A;
+
+	ImageSlot_Begin(SlotPtr);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Starts an update of the inactive slot, dropping any not finished.
+*
+* @param	SlotPtr is a pointer to the slots.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void ImageSlot_Begin(ImageSlot *SlotPtr)
+{
+	SlotPtr->State = IMAGE_SLOT_STATE_HEADER;
+	SlotPtr->Error = XST_SUCCESS;
+	SlotPtr->Received = 0U;
+	SlotPtr->PatchLeft = 0U;
+	SlotPtr->Written = 0U;
+	SlotPtr->Pending = 0U;
+	SlotPtr->Crc = 0U;
+	SlotPtr->Validated = 0U;
+	(void)memset(&SlotPtr->Stats, 0, sizeof(SlotPtr->Stats));
+}
+
+/****************************************************************************/
+/**
+*
+* Takes the next bytes of a delta, in pieces of any size. Each chunk is
+* applied once all of it arrived, writing the blocks it completes.
+*
+* @param	SlotPtr is a pointer to the slots.
+* @param	DataPtr is a pointer to the bytes.
+* @param	NumBytes is the number of bytes.
+*
+* @return
+*		- XST_SUCCESS if the bytes were taken.
+*		- XST_INVALID_PARAM if the delta is malformed or too long.
+*		- XST_DATA_LOST if it does not apply to the active slot.
+*		- XST_FAILURE if the flash failed.
+*		Once an error is returned, so is it for the rest of the
+*		update, until ImageSlot_Begin().
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 ImageSlot_Write(ImageSlot *SlotPtr, const u8 *DataPtr, u32 NumBytes)
+{
+	u8 *DstPtr;
+	u32 Size;
+	u32 Count;
+	s32 Status;
+
+	while (NumBytes > 0U) {
+		switch (SlotPtr->State) {
+		case IMAGE_SLOT_STATE_HEADER:
+			DstPtr = (u8 *)&SlotPtr->Header;
+			Size = sizeof(SlotPtr->Header);
+			break;
+		case IMAGE_SLOT_STATE_CHUNK_HEADER:
+			DstPtr = (u8 *)&SlotPtr->Chunk;
+			Size = sizeof(SlotPtr->Chunk);
+			break;
+		case IMAGE_SLOT_STATE_CHUNK_DATA:
+			DstPtr = ImageSlot_ChunkBuffer;
+			Size = SlotPtr->Chunk.Stored & ~IMAGE_DELTA_CHUNK_LZ4;
+			break;
+		case IMAGE_SLOT_STATE_DONE:
+			return ImageSlot_Fail(SlotPtr, XST_INVALID_PARAM);
+		default:
+			return SlotPtr->Error;
+		}
+
+		Count = Size - SlotPtr->Received;
+		if (Count > NumBytes) {
+			Count = NumBytes;
+		}
+		if ((SlotPtr->State != IMAGE_SLOT_STATE_HEADER) &&
+		    (Count > SlotPtr->PatchLeft)) {
+			return ImageSlot_Fail(SlotPtr, XST_INVALID_PARAM);
+		}
+		(void)memcpy(&DstPtr[SlotPtr->Received], DataPtr, Count);
+		SlotPtr->Received += Count;
+		SlotPtr->Stats.PatchBytes += Count;
+		if (SlotPtr->State != IMAGE_SLOT_STATE_HEADER) {
+			SlotPtr->PatchLeft -= Count;
+		}
+		DataPtr += Count;
+		NumBytes -= Count;
+
+		if (SlotPtr->Received < Size) {
+			continue;
+		}
+		SlotPtr->Received = 0U;
+
+		if (SlotPtr->State == IMAGE_SLOT_STATE_HEADER) {
+			Status = ImageSlot_StartHeader(SlotPtr);
+			if (Status != XST_SUCCESS) {
+				return ImageSlot_Fail(SlotPtr, Status);
+			}
+			SlotPtr->State = IMAGE_SLOT_STATE_CHUNK_HEADER;
+		} else if (SlotPtr->State == IMAGE_SLOT_STATE_CHUNK_HEADER) {
+			Size = SlotPtr->Chunk.Stored & ~IMAGE_DELTA_CHUNK_LZ4;
+			if ((Size == 0U) || (Size > IMAGE_DELTA_CHUNK_MAX) ||
+			    (SlotPtr->Chunk.Raw > IMAGE_DELTA_CHUNK_MAX) ||
+			    (Size > SlotPtr->PatchLeft)) {
+				return ImageSlot_Fail(SlotPtr,
+						      XST_INVALID_PARAM);
+			}
+			SlotPtr->State = IMAGE_SLOT_STATE_CHUNK_DATA;
+		} else {
+			Status = ImageSlot_RunChunk(SlotPtr);
+			if (Status != XST_SUCCESS) {
+				return ImageSlot_Fail(SlotPtr, Status);
+			}
+			SlotPtr->Stats.Chunks++;
+			SlotPtr->State = (SlotPtr->PatchLeft == 0U) ?
+					 IMAGE_SLOT_STATE_DONE :
+					 IMAGE_SLOT_STATE_CHUNK_HEADER;
+		}
+	}
+
+	return (SlotPtr->State == IMAGE_SLOT_STATE_ERROR) ? SlotPtr->Error :
+	       XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Ends an update once the whole delta was taken: checks the size and the
+* CRC-32 of the image and its boot header, then writes the rest of the
+* image and its first block, which makes the slot valid.
+*
+* @param	SlotPtr is a pointer to the slots.
+*
+* @return
+*		- XST_SUCCESS if the inactive slot holds the new image.
+*		- XST_INVALID_PARAM if the delta is not complete, or the image
+*		has no valid boot header.
+*		- XST_DATA_LOST if the image is not the one of the delta, or
+*		read back wrong.
+*		- XST_FAILURE if the flash failed.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 ImageSlot_Finish(ImageSlot *SlotPtr)
+{
+	u32 First;
+	s32 Status;
+
+	if (SlotPtr->State == IMAGE_SLOT_STATE_ERROR) {
+		return SlotPtr->Error;
+	}
+	if (SlotPtr->State != IMAGE_SLOT_STATE_DONE) {
+		return XST_INVALID_PARAM;
+	}
+	if ((SlotPtr->Written != SlotPtr->Header.TargetSize) ||
+	    (SlotPtr->Crc != SlotPtr->Header.TargetCrc)) {
+		return ImageSlot_Fail(SlotPtr, XST_DATA_LOST);
+	}
+
+	First = (SlotPtr->Written < IMAGE_SLOT_BLOCK_SIZE) ?
+		SlotPtr->Written : IMAGE_SLOT_BLOCK_SIZE;
+	Status = ImageSlot_CheckBootHeader(ImageSlot_FirstBlock, First);
+	if (Status != XST_SUCCESS) {
+		return ImageSlot_Fail(SlotPtr, Status);
+	}
+
+	Status = ImageSlot_Flush(SlotPtr);
+	if (Status == XST_SUCCESS) {
+		Status = QspiFlash_Update(SlotPtr->FlashPtr,
+					  ImageSlot_Target(SlotPtr),
+					  ImageSlot_FirstBlock, First);
+	}
+	if (Status != XST_SUCCESS) {
+		return ImageSlot_Fail(SlotPtr, Status);
+	}
+	SlotPtr->Stats.Blocks++;
+	SlotPtr->Validated = 1U;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Points the multiboot register at the slot ImageSlot_Finish() validated,
+* so that the next system reset boots the new image.
+*
+* @param	SlotPtr is a pointer to the slots.
+*
+* @return
+*		- XST_SUCCESS if the slot is the one to boot.
+*		- XST_FAILURE if no update was validated, or the image index
+*		could not be written.
+*
+* @note		The running image keeps its slot active until the reset.
+*
+*****************************************************************************/
+s32 ImageSlot_Activate(ImageSlot *SlotPtr)
+{
+	u32 Address = XPS_DEV_CFG_APB_BASEADDR + XDCFG_MULTIBOOT_ADDR_OFFSET;
+#ifdef IMAGE_SLOT_INDEX_OFFSET
+	ImageSlot_Index Index;
+	u32 Word;
+#endif
+
+	if (SlotPtr->Validated == 0U) {
+		return XST_FAILURE;
+	}
+
+#ifdef IMAGE_SLOT_INDEX_OFFSET
+	/*
+	 * Both slots, for the fallback of the FSBL from one to the other
+	 */
+	(void)memset(&Index, 0xFF, sizeof(Index));
+	Index.Magic = IMAGE_SLOT_INDEX_MAGIC;
+	Index.Count = 2U;
+	Index.Offset[0] = IMAGE_SLOT_A_OFFSET;
+	Index.Offset[1] = IMAGE_SLOT_B_OFFSET;
+	Index.Checksum = 0U;
+	for (Word = 0U; Word < ((sizeof(Index) / 4U) - 1U); Word++) {
+		Index.Checksum += ((u32 *)&Index)[Word];
+	}
+	Index.Checksum ^= 0xFFFFFFFFU;
+	if (QspiFlash_Update(SlotPtr->FlashPtr, IMAGE_SLOT_INDEX_OFFSET,
+			     (const u8 *)&Index, sizeof(Index)) !=
+	    XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+#endif
+
+	Xil_Out32(Address, (Xil_In32(Address) & ~IMAGE_SLOT_MULTIBOOT_MASK) |
+		  (ImageSlot_Target(SlotPtr) / IMAGE_SLOT_MULTIBOOT_STEP));
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Makes the active slot the one a power-on reset boots, once its image
+* runs well: with slot B active, the boot header of slot A is invalidated.
+*
+* @param	SlotPtr is a pointer to the slots.
+*
+* @return
+*		- XST_SUCCESS if a power-on reset boots the active slot.
+*		- XST_FAILURE if the flash failed.
+*
+* @note		Slot A stays the fallback until then. Nothing is done with
+*		slot A active, the BootROM takes it first.
+*
+*****************************************************************************/
+s32 ImageSlot_Confirm(ImageSlot *SlotPtr)
+{
+	if (SlotPtr->Active == IMAGE_SLOT_A) {
+		return XST_SUCCESS;
+	}
+
+	return ImageSlot_Invalidate(SlotPtr, IMAGE_SLOT_A_OFFSET);
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the counts of the update.
+*
+* @param	SlotPtr is a pointer to the slots.
+* @param	StatsPtr is a pointer to the copy of the counts.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void ImageSlot_GetStats(const ImageSlot *SlotPtr, ImageSlot_Stats *StatsPtr)
+{
+	*StatsPtr = SlotPtr->Stats;
+}
+
+/****************************************************************************/
+/*
+*
+* Ends the update with an error, kept for the calls after.
+*
+* @param	SlotPtr is a pointer to the slots.
+* @param	Status is the error.
+*
+* @return	Status.
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 ImageSlot_Fail(ImageSlot *SlotPtr, s32 Status)
+{
+	SlotPtr->State = IMAGE_SLOT_STATE_ERROR;
+	SlotPtr->Error = Status;
+	SlotPtr->Validated = 0U;
+
+	return Status;
+}
+
+/****************************************************************************/
+/*
+*
+* Checks the delta header, and that the active slot is the image the delta
+* applies to, then invalidates the boot header of the inactive slot before
+* it is written.
+*
+* @param	SlotPtr is a pointer to the slots.
+*
+* @return	XST_SUCCESS, XST_INVALID_PARAM for a bad header, XST_DATA_LOST
+*		for another source image, or XST_FAILURE if the flash failed.
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 ImageSlot_StartHeader(ImageSlot *SlotPtr)
+{
+	const ImageDelta_Header *HeaderPtr = &SlotPtr->Header;
+	u32 Source = ImageSlot_Offset(SlotPtr->Active);
+	u32 Done;
+	u32 Count;
+	u32 Crc = 0U;
+	s32 Status;
+
+	if ((HeaderPtr->Magic != IMAGE_DELTA_MAGIC) ||
+	    (HeaderPtr->Version != IMAGE_DELTA_VERSION) ||
+	    (UartFrame_Crc32(0U, (const u8 *)HeaderPtr,
+			     sizeof(*HeaderPtr) - 4U) != HeaderPtr->HeaderCrc) ||
+	    (HeaderPtr->SourceSize > IMAGE_SLOT_SIZE) ||
+	    (HeaderPtr->TargetSize > IMAGE_SLOT_SIZE) ||
+	    (HeaderPtr->PatchSize == 0U)) {
+		return XST_INVALID_PARAM;
+	}
+
+	for (Done = 0U; Done < HeaderPtr->SourceSize; Done += Count) {
+		Count = HeaderPtr->SourceSize - Done;
+		if (Count > IMAGE_SLOT_SOURCE_CHUNK) {
+			Count = IMAGE_SLOT_SOURCE_CHUNK;
+		}
+		Status = QspiFlash_Read(SlotPtr->FlashPtr, Source + Done,
+					ImageSlot_Source, Count);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+		Crc = UartFrame_Crc32(Crc, ImageSlot_Source, Count);
+	}
+	if (Crc != HeaderPtr->SourceCrc) {
+		return XST_DATA_LOST;
+	}
+
+	SlotPtr->PatchLeft = HeaderPtr->PatchSize;
+
+	return ImageSlot_Invalidate(SlotPtr, ImageSlot_Target(SlotPtr));
+}
+
+/****************************************************************************/
+/*
+*
+* Decodes the chunk received and runs its operations.
+*
+* @param	SlotPtr is a pointer to the slots.
+*
+* @return	XST_SUCCESS, XST_INVALID_PARAM for a malformed chunk, or the
+*		status of the writes.
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 ImageSlot_RunChunk(ImageSlot *SlotPtr)
+{
+	const u8 *OpPtr = ImageSlot_ChunkBuffer;
+	u32 Raw = SlotPtr->Chunk.Raw;
+	u32 Stored = SlotPtr->Chunk.Stored & ~IMAGE_DELTA_CHUNK_LZ4;
+	u32 Pos = 0U;
+	u32 Word;
+	u32 Op;
+	u32 Length;
+	u32 Arg;
+	s32 Status = XST_SUCCESS;
+
+	if ((SlotPtr->Chunk.Stored & IMAGE_DELTA_CHUNK_LZ4) != 0U) {
+		if (Lz4Block_Decompress(ImageSlot_ChunkBuffer, Stored,
+					ImageSlot_OpBuffer,
+					IMAGE_DELTA_CHUNK_MAX) != (s32)Raw) {
+			return XST_INVALID_PARAM;
+		}
+		OpPtr = ImageSlot_OpBuffer;
+	} else if (Stored != Raw) {
+		return XST_INVALID_PARAM;
+	}
+
+	while ((Pos < Raw) && (Status == XST_SUCCESS)) {
+		if ((Raw - Pos) < 8U) {
+			return XST_INVALID_PARAM;
+		}
+		Word = ImageSlot_Word(&OpPtr[Pos]);
+		Arg = ImageSlot_Word(&OpPtr[Pos + 4U]);
+		Pos += 8U;
+		Op = Word >> IMAGE_DELTA_OP_SHIFT;
+		Length = Word & IMAGE_DELTA_LENGTH_MASK;
+
+		if (((Op == IMAGE_DELTA_OP_ADD) ||
+		     (Op == IMAGE_DELTA_OP_DATA)) && (Length > (Raw - Pos))) {
+			return XST_INVALID_PARAM;
+		}
+
+		switch (Op) {
+		case IMAGE_DELTA_OP_COPY:
+			Status = ImageSlot_EmitSource(SlotPtr, Arg, NULL,
+						      Length);
+			SlotPtr->Stats.CopyBytes += Length;
+			break;
+		case IMAGE_DELTA_OP_ADD:
+			Status = ImageSlot_EmitSource(SlotPtr, Arg,
+						      &OpPtr[Pos], Length);
+			SlotPtr->Stats.AddBytes += Length;
+			Pos += Length;
+			break;
+		case IMAGE_DELTA_OP_DATA:
+			Status = ImageSlot_Emit(SlotPtr, &OpPtr[Pos], 0U,
+						Length);
+			SlotPtr->Stats.DataBytes += Length;
+			Pos += Length;
+			break;
+		default:
+			Status = ImageSlot_Emit(SlotPtr, NULL, (u8)Arg, Length);
+			SlotPtr->Stats.FillBytes += Length;
+			break;
+		}
+	}
+
+	return Status;
+}
+
+/****************************************************************************/
+/*
+*
+* Appends bytes to the image, writing each block it completes.
+*
+* @param	SlotPtr is a pointer to the slots.
+* @param	DataPtr is a pointer to the bytes, or NULL for Fill bytes.
+* @param	Fill is the byte repeated when DataPtr is NULL.
+* @param	NumBytes is the number of bytes.
+*
+* @return	XST_SUCCESS, XST_INVALID_PARAM past the size of the image, or
+*		the status of QspiFlash_Update().
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 ImageSlot_Emit(ImageSlot *SlotPtr, const u8 *DataPtr, u8 Fill,
+			  u32 NumBytes)
+{
+	u8 *BlockPtr;
+	u32 Count;
+	s32 Status;
+
+	if (NumBytes > (SlotPtr->Header.TargetSize - SlotPtr->Written)) {
+		return XST_INVALID_PARAM;
+	}
+
+	while (NumBytes > 0U) {
+		BlockPtr = (SlotPtr->Written < IMAGE_SLOT_BLOCK_SIZE) ?
+			   ImageSlot_FirstBlock : ImageSlot_Block;
+		Count = IMAGE_SLOT_BLOCK_SIZE - SlotPtr->Pending;
+		if (Count > NumBytes) {
+			Count = NumBytes;
+		}
+
+		if (DataPtr != NULL) {
+			(void)memcpy(&BlockPtr[SlotPtr->Pending], DataPtr,
+				     Count);
+			DataPtr += Count;
+		} else {
+			(void)memset(&BlockPtr[SlotPtr->Pending], Fill, Count);
+		}
+		SlotPtr->Crc = UartFrame_Crc32(SlotPtr->Crc,
+					       &BlockPtr[SlotPtr->Pending],
+					       Count);
+		SlotPtr->Pending += Count;
+		SlotPtr->Written += Count;
+		NumBytes -= Count;
+
+		if (SlotPtr->Pending == IMAGE_SLOT_BLOCK_SIZE) {
+			Status = ImageSlot_Flush(SlotPtr);
+			if (Status != XST_SUCCESS) {
+				return Status;
+			}
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Appends bytes of the active slot to the image, plus differences for an
+* ADD operation.
+*
+* @param	SlotPtr is a pointer to the slots.
+* @param	Source is the offset of the bytes in the source image.
+* @param	DiffPtr is a pointer to the differences, added modulo 256, or
+*		NULL to copy.
+* @param	NumBytes is the number of bytes.
+*
+* @return	XST_SUCCESS, XST_INVALID_PARAM past the source image, or the
+*		status of the reads and writes.
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 ImageSlot_EmitSource(ImageSlot *SlotPtr, u32 Source,
+				const u8 *DiffPtr, u32 NumBytes)
+{
+	u32 Base = ImageSlot_Offset(SlotPtr->Active);
+	u32 Count;
+	u32 Index;
+	s32 Status;
+
+	if ((Source > SlotPtr->Header.SourceSize) ||
+	    (NumBytes > (SlotPtr->Header.SourceSize - Source))) {
+		return XST_INVALID_PARAM;
+	}
+
+	while (NumBytes > 0U) {
+		Count = (NumBytes < IMAGE_SLOT_SOURCE_CHUNK) ? NumBytes :
+			IMAGE_SLOT_SOURCE_CHUNK;
+		Status = QspiFlash_Read(SlotPtr->FlashPtr, Base + Source,
+					ImageSlot_Source, Count);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		if (DiffPtr != NULL) {
+			for (Index = 0U; Index < Count; Index++) {
+				ImageSlot_Source[Index] += DiffPtr[Index];
+			}
+			DiffPtr += Count;
+		}
+
+		Status = ImageSlot_Emit(SlotPtr, ImageSlot_Source, 0U, Count);
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+
+		Source += Count;
+		NumBytes -= Count;
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Writes the block being built to the inactive slot, except the first
+* block, kept for ImageSlot_Finish().
+*
+* @param	SlotPtr is a pointer to the slots.
+*
+* @return	XST_SUCCESS, or the status of QspiFlash_Update().
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 ImageSlot_Flush(ImageSlot *SlotPtr)
+{
+	u32 Start = SlotPtr->Written - SlotPtr->Pending;
+	s32 Status;
+
+	if ((Start == 0U) || (SlotPtr->Pending == 0U)) {
+		SlotPtr->Pending = 0U;
+		return XST_SUCCESS;
+	}
+
+	Status = QspiFlash_Update(SlotPtr->FlashPtr,
+				  ImageSlot_Target(SlotPtr) + Start,
+				  ImageSlot_Block, SlotPtr->Pending);
+	SlotPtr->Pending = 0U;
+	SlotPtr->Stats.Blocks++;
+
+	return Status;
+}
+
+/****************************************************************************/
+/*
+*
+* Checks the boot header of an image as the BootROM and FSBL do: the width
+* detection word, the ID and the header checksum.
+*
+* @param	ImagePtr is a pointer to the start of the image.
+* @param	NumBytes is the number of bytes at ImagePtr.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM if the header is not valid.
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 ImageSlot_CheckBootHeader(const u8 *ImagePtr, u32 NumBytes)
+{
+	u32 Sum = 0U;
+	u32 Word;
+
+	if ((NumBytes < (IMAGE_SLOT_CHECKSUM_OFFSET + 4U)) ||
+	    (ImageSlot_Word(&ImagePtr[IMAGE_SLOT_WIDTH_OFFSET]) !=
+	     IMAGE_SLOT_WIDTH_WORD) ||
+	    (ImageSlot_Word(&ImagePtr[IMAGE_SLOT_IDENT_OFFSET]) !=
+	     IMAGE_SLOT_IDENT)) {
+		return XST_INVALID_PARAM;
+	}
+
+	for (Word = 0U; Word < IMAGE_SLOT_CHECKSUM_WORDS; Word++) {
+		Sum += ImageSlot_Word(&ImagePtr[IMAGE_SLOT_WIDTH_OFFSET +
+						(Word * 4U)]);
+	}
+	if ((Sum ^ 0xFFFFFFFFU) !=
+	    ImageSlot_Word(&ImagePtr[IMAGE_SLOT_CHECKSUM_OFFSET])) {
+		return XST_INVALID_PARAM;
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Invalidates the boot header of a slot by programming its width detection
+* word to zero, which needs no erase.
+*
+* @param	SlotPtr is a pointer to the slots.
+* @param	Offset is the flash offset of the slot.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if the flash failed.
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 ImageSlot_Invalidate(ImageSlot *SlotPtr, u32 Offset)
+{
+	static const u8 Zero[4] = {0U, 0U, 0U, 0U};
+
+	if (QspiFlash_Read(SlotPtr->FlashPtr, Offset + IMAGE_SLOT_WIDTH_OFFSET,
+			   ImageSlot_Source, sizeof(Zero)) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	if (memcmp(ImageSlot_Source, Zero, sizeof(Zero)) == 0) {
+		return XST_SUCCESS;
+	}
+
+	if (QspiFlash_Program(SlotPtr->FlashPtr,
+			      Offset + IMAGE_SLOT_WIDTH_OFFSET, Zero,
+			      sizeof(Zero)) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+#endif /* XPAR_XQSPIPS_0_BASEADDR */
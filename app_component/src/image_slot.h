@@ -0,0 +1,229 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file image_slot.h
+*
+* A/B boot image slots in the QSPI flash, updated with block level deltas.
+*
+* The flash holds two slots for BOOT.BIN, A and B, on 32 KB multiboot
+* steps. The application runs from the active slot, the one of the
+* multiboot register, and an update goes to the other. Instead of the whole
+* image, the host sends a delta against the image of the active slot, made
+* by tools/image_delta.py, which costs a fraction of the transfer time of
+* the image on the UART when only part of it changed.
+*
+* A delta is an ImageDelta_Header then chunks, each a chunk header and at most
+* IMAGE_DELTA_CHUNK_MAX bytes of operations, compressed as an LZ4 block of
+* lz4_block.h or stored. The operations of a chunk build the new image in
+* order:
+*
+* - COPY takes bytes of the active slot at an offset, the matches the host
+*   found, at any offset so that code moved by a link is found.
+* - ADD takes bytes of the active slot plus difference bytes that follow,
+*   bsdiff style: code whose addresses moved differs from the old in a few
+*   bytes of each word, and the differences, mostly zero, compress well.
+* - DATA takes the bytes that follow, for new data.
+* - FILL repeats a byte, for the padding of the image.
+*
+* The delta is streamed: ImageSlot_Write() takes its bytes in any pieces,
+* e.g. the payload of each frame of uart_frame.h, and writes the image to
+* the inactive slot 64 KB at a time with QspiFlash_Update(), which leaves
+* alone what an older image there already holds. The delta checks the
+* CRC-32 of the active slot it applies to before anything is written.
+*
+* ImageSlot_Finish() checks the size and CRC-32 of the image and its boot
+* header, the ID and checksum the BootROM and FSBL check. ImageSlot_Activate()
+* then points the multiboot register at the new slot, so that the next
+* system reset boots it, and a failed boot falls back to the other slot
+* through the multiboot fallback of the FSBL.
+*
+* The multiboot register does not survive a power-on reset, after which
+* the BootROM takes the first valid image from offset 0. So that a power
+* cycle keeps the new image:
+*
+* - the boot header of the slot being written is invalidated first, and the
+*   first 64 KB of the image, with the new header, is written last, so that
+*   a slot is valid only once complete;
+* - ImageSlot_Confirm(), called once the new image runs well, invalidates
+*   the header of slot A when B is the one confirmed. Programming the width
+*   detection word to zero needs no erase, and the next update of A writes
+*   a valid header again.
+*
+* With IMAGE_SLOT_INDEX_OFFSET defined, ImageSlot_Activate() also writes
+* the image index of FSBL_IMAGE_INDEX there, listing both slots.
+*
+* The slots and the index must not overlap the panic dump region of the
+* FSBL. Only one update runs at a time, the buffers are those of the file.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef IMAGE_SLOT_H
+#define IMAGE_SLOT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "qspi_flash.h"
+
+/************************** Constant Definitions ****************************/
+
+#ifndef IMAGE_SLOT_A_OFFSET
+#define IMAGE_SLOT_A_OFFSET	0x00000000U	/**< Found by a power-on boot */
+#endif
+
+#ifndef IMAGE_SLOT_B_OFFSET
+#define IMAGE_SLOT_B_OFFSET	0x00800000U
+#endif
+
+#ifndef IMAGE_SLOT_SIZE
+#define IMAGE_SLOT_SIZE		0x007E0000U	/**< Of each, below the panic dump */
+#endif
+
+#define IMAGE_SLOT_BLOCK_SIZE	0x10000U	/**< Written at a time */
+#define IMAGE_SLOT_MULTIBOOT_STEP 0x8000U	/**< Of the multiboot register */
+
+/** @name Slots
+ * @{
+ */
+#define IMAGE_SLOT_A		0U
+#define IMAGE_SLOT_B		1U
+/** @} */
+
+#define IMAGE_DELTA_MAGIC	0x544C4544U	/**< "DELT" */
+#define IMAGE_DELTA_VERSION	1U
+#define IMAGE_DELTA_CHUNK_MAX	0xFFFFU		/**< Bytes of operations */
+#define IMAGE_DELTA_CHUNK_LZ4	0x80000000U	/**< Of ImageDelta_Chunk.Stored */
+
+/** @name Operations, in bits 31:30 of the first of their two words, the
+ * length in 29:0, and what the second word is
+ * @{
+ */
+#define IMAGE_DELTA_OP_COPY	0U	/**< Source offset */
+#define IMAGE_DELTA_OP_ADD	1U	/**< Source offset, differences follow */
+#define IMAGE_DELTA_OP_DATA	2U	/**< 0, bytes follow */
+#define IMAGE_DELTA_OP_FILL	3U	/**< The byte */
+#define IMAGE_DELTA_OP_SHIFT	30U
+#define IMAGE_DELTA_LENGTH_MASK	0x3FFFFFFFU
+/** @} */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Header of a delta.
+ */
+typedef struct {
+	u32 Magic;		/**< IMAGE_DELTA_MAGIC */
+	u16 Version;		/**< IMAGE_DELTA_VERSION */
+	u16 Flags;		/**< 0 */
+	u32 SourceSize;		/**< Bytes of the image it applies to */
+	u32 SourceCrc;		/**< CRC-32 of those */
+	u32 TargetSize;		/**< Bytes of the new image */
+	u32 TargetCrc;		/**< CRC-32 of the new image */
+	u32 PatchSize;		/**< Bytes of the chunks after this header */
+	u32 HeaderCrc;		/**< CRC-32 of the words above */
+} ImageDelta_Header;
+
+/**
+ * Header of a chunk, the stored bytes follow.
+ */
+typedef struct {
+	u32 Stored;		/**< Bytes, IMAGE_DELTA_CHUNK_LZ4 if LZ4 */
+	u32 Raw;		/**< Bytes of operations */
+} ImageDelta_Chunk;
+
+/**
+ * Counts of an update.
+ */
+typedef struct {
+	u32 PatchBytes;		/**< Received */
+	u32 Chunks;
+	u32 CopyBytes;		/**< Of the image from each operation */
+	u32 AddBytes;
+	u32 DataBytes;
+	u32 FillBytes;
+	u32 Blocks;		/**< Written with QspiFlash_Update() */
+} ImageSlot_Stats;
+
+/**
+ * The slots and an update in progress.
+ */
+typedef struct {
+	QspiFlash *FlashPtr;
+	u32 Active;		/**< IMAGE_SLOT_A or IMAGE_SLOT_B */
+	u32 State;		/**< Of the stream, in image_slot.c */
+	s32 Error;		/**< First error of the stream */
+	ImageDelta_Header Header;
+	ImageDelta_Chunk Chunk;
+	u32 Received;		/**< Bytes of the current header or chunk */
+	u32 PatchLeft;		/**< Bytes of chunks not received */
+	u32 Written;		/**< Bytes of the image built */
+	u32 Pending;		/**< Bytes of the image in the block buffer */
+	u32 Crc;		/**< CRC-32 of the image built */
+	u32 Validated;		/**< ImageSlot_Finish() passed */
+	ImageSlot_Stats Stats;
+} ImageSlot;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/****************************************************************************/
+/**
+*
+* Returns the flash offset of a slot.
+*
+* @param	Slot is IMAGE_SLOT_A or IMAGE_SLOT_B.
+*
+* @return	The offset.
+*
+* @note		C-style signature:
+*		u32 ImageSlot_Offset(u32 Slot)
+*
+*****************************************************************************/
+#define ImageSlot_Offset(Slot)						\
+	(((Slot) == IMAGE_SLOT_B) ? IMAGE_SLOT_B_OFFSET : IMAGE_SLOT_A_OFFSET)
+
+/****************************************************************************/
+/**
+*
+* Returns the slot the application runs from.
+*
+* @param	SlotPtr is a pointer to the slots.
+*
+* @return	IMAGE_SLOT_A or IMAGE_SLOT_B.
+*
+* @note		C-style signature:
+*		u32 ImageSlot_GetActive(const ImageSlot *SlotPtr)
+*
+*****************************************************************************/
+#define ImageSlot_GetActive(SlotPtr)	((SlotPtr)->Active)
+
+/************************** Function Prototypes *****************************/
+
+s32 ImageSlot_Initialize(ImageSlot *SlotPtr, QspiFlash *FlashPtr);
+void ImageSlot_Begin(ImageSlot *SlotPtr);
+s32 ImageSlot_Write(ImageSlot *SlotPtr, const u8 *DataPtr, u32 NumBytes);
+s32 ImageSlot_Finish(ImageSlot *SlotPtr);
+s32 ImageSlot_Activate(ImageSlot *SlotPtr);
+s32 ImageSlot_Confirm(ImageSlot *SlotPtr);
+void ImageSlot_GetStats(const ImageSlot *SlotPtr, ImageSlot_Stats *StatsPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IMAGE_SLOT_H */
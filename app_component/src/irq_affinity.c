@@ -0,0 +1,451 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file irq_affinity.c
+*
+* Interrupt affinity manager. Refer to irq_affinity.h for the placement
+* policy.
+*
+* An interrupt is moved by adding the new CPU to its targets in the
+* distributor before the old one is removed, so that a level interrupt
+* asserted meanwhile is never left without a target.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xpseudo_asm.h"
+#include "xinterrupt_wrap.h"
+#include "irq_affinity.h"
+
+/************************** Constant Definitions ****************************/
+
+/* A new placement must lower the busiest CPU load by more than 1/2^N */
+#define IRQ_AFFINITY_HYSTERESIS_SHIFT	3U
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/* GIC interrupt ID of an encoded interrupt ID of the driver configuration */
+#define IRQ_AFFINITY_GIC_ID(IntrId) \
+	((u32)XGet_IntrId(IntrId) + (u32)XGet_IntrOffset(IntrId))
+
+/************************** Function Prototypes *****************************/
+
+static IrqAffinity_Irq *IrqAffinity_Find(IrqAffinity *AffPtr, u32 IntId);
+static void IrqAffinity_Map(IrqAffinity *AffPtr, IrqAffinity_Irq *IrqPtr,
+			    u32 Cpu);
+static u64 IrqAffinity_Cycles(const XScuGic_Stats *StatsPtr, u32 IntId);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* Sets up the manager on the GIC instance of the interrupt wrapper.
+*
+* @param	AffPtr is a pointer to the manager.
+*
+* @return
+*		- XST_SUCCESS if the manager is ready.
+*		- XST_FAILURE if the GIC is not initialized yet, the first
+*		  XSetupInterruptSystem() call does it.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 IrqAffinity_Initialize(IrqAffinity *AffPtr)
+{
+	u32 Cpu;
+
+	AffPtr->GicPtr = XGetScuGicInstance();
+	if (AffPtr->GicPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	for (Cpu = 0U; Cpu < IRQ_AFFINITY_NUM_CPUS; Cpu++) {
+		AffPtr->StatsPtr[Cpu] = NULL;
+	}
+	AffPtr->NumIrqs = 0U;
+	AffPtr->Rebalances = 0U;
+	AffPtr->Moves = 0U;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Puts an interrupt under the manager and maps it to one CPU.
+*
+* @param	AffPtr is a pointer to the manager.
+* @param	IntrId is the interrupt, encoded as the IntrId of the driver
+*		configuration.
+* @param	Cpu is the CPU it is mapped to, 0 or 1.
+* @param	Pinned is 1 for the interrupt to stay on Cpu, 0 for the
+*		rebalance to move it.
+*
+* @return
+*		- XST_SUCCESS if the interrupt was mapped.
+*		- XST_INVALID_PARAM if the CPU or the interrupt is not valid,
+*		  software interrupts being private to each CPU.
+*		- XST_DEVICE_BUSY if it is already managed.
+*		- XST_NO_DATA if the table of interrupts is full.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 IrqAffinity_Add(IrqAffinity *AffPtr, u32 IntrId, u32 Cpu, u32 Pinned)
+{
+	IrqAffinity_Irq *IrqPtr;
+	u32 IntId = IRQ_AFFINITY_GIC_ID(IntrId);
+
+	if ((Cpu >= IRQ_AFFINITY_NUM_CPUS) ||
+	    (IntId < XSCUGIC_SPI_INT_ID_START) ||
+	    (IntId >= XSCUGIC_MAX_NUM_INTR_INPUTS)) {
+		return XST_INVALID_PARAM;
+	}
+	if (IrqAffinity_Find(AffPtr, IntId) != NULL) {
+		return XST_DEVICE_BUSY;
+	}
+	if (AffPtr->NumIrqs == IRQ_AFFINITY_MAX_IRQS) {
+		return XST_NO_DATA;
+	}
+
+	IrqPtr = &AffPtr->Irq[AffPtr->NumIrqs];
+	IrqPtr->IntId = IntId;
+	IrqPtr->Cpu = IRQ_AFFINITY_NUM_CPUS;
+	IrqPtr->Pinned = (Pinned != 0U) ? 1U : 0U;
+	IrqPtr->LastCycles = 0U;
+	IrqPtr->Load = 0U;
+	AffPtr->NumIrqs++;
+
+	IrqAffinity_Map(AffPtr, IrqPtr, Cpu);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Moves a managed interrupt to a CPU, pinned or not.
+*
+* @param	AffPtr is a pointer to the manager.
+* @param	IntrId is the interrupt, encoded as the IntrId of the driver
+*		configuration.
+* @param	Cpu is the CPU it is mapped to, 0 or 1.
+*
+* @return
+*		- XST_SUCCESS if the interrupt was mapped.
+*		- XST_INVALID_PARAM if the CPU is not valid or the interrupt
+*		  is not managed.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 IrqAffinity_SetCpu(IrqAffinity *AffPtr, u32 IntrId, u32 Cpu)
+{
+	IrqAffinity_Irq *IrqPtr;
+
+	IrqPtr = IrqAffinity_Find(AffPtr, IRQ_AFFINITY_GIC_ID(IntrId));
+	if ((IrqPtr == NULL) || (Cpu >= IRQ_AFFINITY_NUM_CPUS)) {
+		return XST_INVALID_PARAM;
+	}
+
+	IrqAffinity_Map(AffPtr, IrqPtr, Cpu);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Gives the statistics block the GIC instance of a CPU updates, which the
+* rebalance reads the load of the interrupts from.
+*
+* @param	AffPtr is a pointer to the manager.
+* @param	Cpu is the CPU, 0 or 1.
+* @param	StatsPtr is the block attached with XScuGic_EnableStats() on
+*		that CPU, or NULL. The block of CPU1 must be in memory both
+*		CPUs see coherently, the OCM or shareable DDR.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void IrqAffinity_SetLoadStats(IrqAffinity *AffPtr, u32 Cpu,
+			      XScuGic_Stats *StatsPtr)
+{
+	if (Cpu < IRQ_AFFINITY_NUM_CPUS) {
+		AffPtr->StatsPtr[Cpu] = StatsPtr;
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Places the interrupts that are not pinned from their load since the last
+* call. The loads are ordered from the heaviest, and each interrupt goes to
+* the CPU with the least load so far, the pinned interrupts counting on
+* their own CPU. The placement is applied only if it lowers the load of the
+* busiest CPU by more than 1/8.
+*
+* @param	AffPtr is a pointer to the manager.
+*
+* @return	The number of interrupts moved, 0 when the statistics of
+*		both CPUs are not set.
+*
+* @note		Call it periodically from the main loop, every second or so.
+*		The first call after the statistics are set only takes the
+*		reference counts, it finds no load.
+*
+*****************************************************************************/
+u32 IrqAffinity_Rebalance(IrqAffinity *AffPtr)
+{
+	u32 Order[IRQ_AFFINITY_MAX_IRQS];
+	u32 NewCpu[IRQ_AFFINITY_MAX_IRQS];
+	u64 OldLoad[IRQ_AFFINITY_NUM_CPUS] = {0U};
+	u64 NewLoad[IRQ_AFFINITY_NUM_CPUS] = {0U};
+	u64 OldMax = 0U;
+	u64 NewMax = 0U;
+	u64 Total;
+	IrqAffinity_Irq *IrqPtr;
+	u32 NumMovable = 0U;
+	u32 Moves = 0U;
+	u32 Index;
+	u32 Slot;
+	u32 Cpu;
+	u32 Best;
+
+	for (Cpu = 0U; Cpu < IRQ_AFFINITY_NUM_CPUS; Cpu++) {
+		if (AffPtr->StatsPtr[Cpu] == NULL) {
+			return 0U;
+		}
+	}
+
+	for (Index = 0U; Index < AffPtr->NumIrqs; Index++) {
+		IrqPtr = &AffPtr->Irq[Index];
+
+		/* The interrupt counts on whichever CPU handled it */
+		Total = 0U;
+		for (Cpu = 0U; Cpu < IRQ_AFFINITY_NUM_CPUS; Cpu++) {
+			Total += IrqAffinity_Cycles(AffPtr->StatsPtr[Cpu],
+						    IrqPtr->IntId);
+		}
+		if (Total < IrqPtr->LastCycles) {
+			IrqPtr->Load = 0U;
+		} else if ((Total - IrqPtr->LastCycles) > 0xFFFFFFFFU) {
+			IrqPtr->Load = 0xFFFFFFFFU;
+		} else {
+			IrqPtr->Load = (u32)(Total - IrqPtr->LastCycles);
+		}
+		IrqPtr->LastCycles = Total;
+
+		OldLoad[IrqPtr->Cpu] += IrqPtr->Load;
+		NewCpu[Index] = IrqPtr->Cpu;
+		if (IrqPtr->Pinned != 0U) {
+			NewLoad[IrqPtr->Cpu] += IrqPtr->Load;
+			continue;
+		}
+
+		/* Insert in the order of decreasing load */
+		Slot = NumMovable;
+		while ((Slot > 0U) &&
+		       (AffPtr->Irq[Order[Slot - 1U]].Load < IrqPtr->Load)) {
+			Order[Slot] = Order[Slot - 1U];
+			Slot--;
+		}
+		Order[Slot] = Index;
+		NumMovable++;
+	}
+
+	for (Slot = 0U; Slot < NumMovable; Slot++) {
+		Best = 0U;
+		for (Cpu = 1U; Cpu < IRQ_AFFINITY_NUM_CPUS; Cpu++) {
+			if (NewLoad[Cpu] < NewLoad[Best]) {
+				Best = Cpu;
+			}
+		}
+		NewCpu[Order[Slot]] = Best;
+		NewLoad[Best] += AffPtr->Irq[Order[Slot]].Load;
+	}
+
+	for (Cpu = 0U; Cpu < IRQ_AFFINITY_NUM_CPUS; Cpu++) {
+		if (OldLoad[Cpu] > OldMax) {
+			OldMax = OldLoad[Cpu];
+		}
+		if (NewLoad[Cpu] > NewMax) {
+			NewMax = NewLoad[Cpu];
+		}
+	}
+	if ((NewMax + (OldMax >> IRQ_AFFINITY_HYSTERESIS_SHIFT)) >= OldMax) {
+		return 0U;
+	}
+
+	for (Index = 0U; Index < AffPtr->NumIrqs; Index++) {
+		if (NewCpu[Index] != AffPtr->Irq[Index].Cpu) {
+			IrqAffinity_Map(AffPtr, &AffPtr->Irq[Index],
+					NewCpu[Index]);
+			Moves++;
+		}
+	}
+	AffPtr->Rebalances++;
+	AffPtr->Moves += Moves;
+
+	return Moves;
+}
+
+/****************************************************************************/
+/**
+*
+* Connects the handler of the wake up software interrupt on the calling CPU
+* and enables it. Software interrupts are private to each CPU, each CPU
+* woken with IrqAffinity_Wake() connects its own handler.
+*
+* @param	AffPtr is a pointer to the manager.
+* @param	Handler is called on each IrqAffinity_Wake() to this CPU.
+* @param	CallBackRef is its argument.
+*
+* @return	XST_SUCCESS, or the error of XScuGic_Connect().
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 IrqAffinity_ConnectWake(IrqAffinity *AffPtr,
+			    Xil_InterruptHandler Handler, void *CallBackRef)
+{
+	s32 Status;
+
+	Status = XScuGic_Connect(AffPtr->GicPtr, IRQ_AFFINITY_WAKE_SGI,
+				 Handler, CallBackRef);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+	XScuGic_Enable(AffPtr->GicPtr, IRQ_AFFINITY_WAKE_SGI);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Raises the wake up software interrupt on a CPU.
+*
+* @param	AffPtr is a pointer to the manager.
+* @param	Cpu is the CPU to wake, 0 or 1.
+*
+* @return
+*		- XST_SUCCESS if the interrupt was raised.
+*		- XST_INVALID_PARAM if the CPU is not valid.
+*
+* @note		Data passed to the other CPU must be written before the
+*		call, the distributor write is ordered after them.
+*
+*****************************************************************************/
+s32 IrqAffinity_Wake(IrqAffinity *AffPtr, u32 Cpu)
+{
+	if (Cpu >= IRQ_AFFINITY_NUM_CPUS) {
+		return XST_INVALID_PARAM;
+	}
+
+	dsb();
+
+	return XScuGic_SoftwareIntr(AffPtr->GicPtr, IRQ_AFFINITY_WAKE_SGI,
+				    (u32)1U << Cpu);
+}
+
+/****************************************************************************/
+/**
+*
+* Finds a managed interrupt.
+*
+* @param	AffPtr is a pointer to the manager.
+* @param	IntId is the GIC interrupt ID.
+*
+* @return	The interrupt, or NULL if it is not managed.
+*
+*****************************************************************************/
+static IrqAffinity_Irq *IrqAffinity_Find(IrqAffinity *AffPtr, u32 IntId)
+{
+	u32 Index;
+
+	for (Index = 0U; Index < AffPtr->NumIrqs; Index++) {
+		if (AffPtr->Irq[Index].IntId == IntId) {
+			return &AffPtr->Irq[Index];
+		}
+	}
+
+	return NULL;
+}
+
+/****************************************************************************/
+/**
+*
+* Maps an interrupt to one CPU, the new target being added before the
+* others are removed.
+*
+* @param	AffPtr is a pointer to the manager.
+* @param	IrqPtr is the interrupt.
+* @param	Cpu is the CPU it is mapped to.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void IrqAffinity_Map(IrqAffinity *AffPtr, IrqAffinity_Irq *IrqPtr,
+			    u32 Cpu)
+{
+	u32 Other;
+
+	XScuGic_InterruptMaptoCpu(AffPtr->GicPtr, (u8)Cpu, IrqPtr->IntId);
+	for (Other = 0U; Other < IRQ_AFFINITY_NUM_CPUS; Other++) {
+		if (Other != Cpu) {
+			XScuGic_InterruptUnmapFromCpu(AffPtr->GicPtr,
+						      (u8)Other,
+						      IrqPtr->IntId);
+		}
+	}
+	IrqPtr->Cpu = Cpu;
+}
+
+/****************************************************************************/
+/**
+*
+* Reads the handler cycles of an interrupt from a statistics block. The
+* interrupts are masked so that the handler of this CPU cannot update the
+* count halfway through. A count of the other CPU may be read torn, the
+* rebalance then sees a short or no load for one period.
+*
+* @param	StatsPtr is the statistics block.
+* @param	IntId is the GIC interrupt ID.
+*
+* @return	The total handler cycles of the interrupt.
+*
+*****************************************************************************/
+static u64 IrqAffinity_Cycles(const XScuGic_Stats *StatsPtr, u32 IntId)
+{
+	u64 Cycles;
+	u32 Cpsr;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	Cycles = *(volatile const u64 *)&StatsPtr->Int[IntId].TotalCycles;
+	mtcpsr(Cpsr);
+
+	return Cycles;
+}
@@ -0,0 +1,101 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file irq_affinity.h
+*
+* Spreads the interrupts of the PS peripherals over the two Cortex-A9 cores.
+*
+* Each interrupt is added with the CPU it starts on, for example UART0 on
+* CPU0, UART1 and the DMA done interrupts on CPU1, and is mapped to that CPU
+* alone in the GIC distributor. A pinned interrupt stays where it was put,
+* the others are moved by IrqAffinity_Rebalance() from the load counters of
+* the XScuGic statistics of both CPUs: each interrupt is weighed by the
+* handler cycles it took since the last rebalance, and the heaviest ones are
+* placed first on the least loaded CPU. The new placement is applied only
+* when it lowers the load of the busiest CPU by more than 1/8, so that
+* interrupts of a steady load do not bounce between the cores.
+*
+* The manager runs on CPU0. CPU1 runs its own image, which connects the
+* handlers of the interrupts it may be given and attaches the statistics
+* block the manager reads, in memory shared by both CPUs.
+* IrqAffinity_Wake() raises a software interrupt on the other CPU, for a
+* handler to pass work on to it.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef IRQ_AFFINITY_H
+#define IRQ_AFFINITY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xscugic.h"
+
+/************************** Constant Definitions ****************************/
+
+#define IRQ_AFFINITY_NUM_CPUS	2U	/**< Cortex-A9 cores */
+#define IRQ_AFFINITY_MAX_IRQS	16U	/**< Interrupts managed */
+
+/* Software interrupt of IrqAffinity_Wake() */
+#ifndef IRQ_AFFINITY_WAKE_SGI
+#define IRQ_AFFINITY_WAKE_SGI	14U
+#endif
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * An interrupt under the manager.
+ */
+typedef struct {
+	u32 IntId;		/**< GIC interrupt ID */
+	u32 Cpu;		/**< CPU it is mapped to */
+	u32 Pinned;		/**< Never moved by a rebalance */
+	u64 LastCycles;		/**< Handler cycles at the last rebalance */
+	u32 Load;		/**< Handler cycles of the last period */
+} IrqAffinity_Irq;
+
+/**
+ * The manager.
+ */
+typedef struct {
+	XScuGic *GicPtr;
+	XScuGic_Stats *StatsPtr[IRQ_AFFINITY_NUM_CPUS]; /**< Load counters */
+	IrqAffinity_Irq Irq[IRQ_AFFINITY_MAX_IRQS];
+	u32 NumIrqs;
+	u32 Rebalances;		/**< Rebalances that moved interrupts */
+	u32 Moves;		/**< Interrupts moved */
+} IrqAffinity;
+
+/************************** Function Prototypes *****************************/
+
+s32 IrqAffinity_Initialize(IrqAffinity *AffPtr);
+s32 IrqAffinity_Add(IrqAffinity *AffPtr, u32 IntrId, u32 Cpu, u32 Pinned);
+s32 IrqAffinity_SetCpu(IrqAffinity *AffPtr, u32 IntrId, u32 Cpu);
+void IrqAffinity_SetLoadStats(IrqAffinity *AffPtr, u32 Cpu,
+			      XScuGic_Stats *StatsPtr);
+u32 IrqAffinity_Rebalance(IrqAffinity *AffPtr);
+s32 IrqAffinity_ConnectWake(IrqAffinity *AffPtr,
+			    Xil_InterruptHandler Handler, void *CallBackRef);
+s32 IrqAffinity_Wake(IrqAffinity *AffPtr, u32 Cpu);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IRQ_AFFINITY_H */
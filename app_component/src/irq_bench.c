@@ -0,0 +1,844 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file irq_bench.c
+*
+* Interrupt latency benchmark. Refer to irq_bench.h for the sources, the
+* configurations and the loads.
+*
+* The handlers of the sources are connected to the GIC for the whole
+* suite; a run only changes the dispatch. In IRQ_BENCH_CFG_FIQ the fast
+* FIQ handler takes the interrupt without the driver: it clears the timer
+* and the UART at their source, and acknowledges the software interrupt,
+* which no line level clears, at the CPU interface.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Set up the AMP runtime with Amp_InitFromWrapper().
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xil_printf.h"
+#include "xil_cache.h"
+#include "xil_exception.h"
+#include "xpseudo_asm.h"
+#include "xinterrupt_wrap.h"
+#include "xtimestamp.h"
+#include "xil_hotpath.h"
+#include "amp.h"
+#include "irq_bench.h"
+#include "drvcfg.h"
+
+/************************** Constant Definitions ****************************/
+
+#define IRQ_BENCH_LINE		32U	/* Line of the L1 and the L2 */
+#define IRQ_BENCH_LOCK_LEN	4096U	/* Bytes locked per way */
+#define IRQ_BENCH_TIMEOUT	2000000U /* Cycles to wait for a handler */
+#define IRQ_BENCH_WIRE_SAMPLES	16U	/* Bytes of the calibration */
+
+/* The private timer counts at half the CPU clock, like the global timer */
+#define IRQ_BENCH_CYCLES_PER_TICK \
+	(XPAR_CPU_CORTEXA9_0_CPU_CLK_FREQ_HZ / COUNTS_PER_SECOND)
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static void IrqBench_Cpu1Main(void *Arg);
+static void IrqBench_PingHandler(void *CallBackRef);
+static void IrqBench_PongHandler(void *CallBackRef);
+static void IrqBench_TimerHandler(void *CallBackRef);
+static void IrqBench_UartHandler(void *CallBackRef);
+static void IrqBench_BlockHandler(void *CallBackRef);
+static void IrqBench_FiqHandler(void);
+static s32 IrqBench_Connect(IrqBench *BenchPtr, u32 IntId,
+			    Xil_InterruptHandler Handler, u8 Priority);
+static s32 IrqBench_Sample(IrqBench *BenchPtr, u32 Load, u32 *CyclesPtr);
+static s32 IrqBench_Calibrate(IrqBench *BenchPtr);
+static s32 IrqBench_Lock(IrqBench *BenchPtr);
+static void IrqBench_Unlock(void);
+static void IrqBench_Restore(IrqBench *BenchPtr);
+
+/************************** Variable Definitions ****************************/
+
+extern u8 _vector_table[];
+extern u8 __irq_stack[];
+
+static const char *IrqBench_SourceNames[IRQ_BENCH_NUM_SOURCES] = {
+	"sgi", "timer", "uart"
+};
+
+static const char *IrqBench_CfgNames[IRQ_BENCH_NUM_CFGS] = {
+	"irq", "l2lock", "fiq", "nested"
+};
+
+static const char *IrqBench_LoadNames[IRQ_BENCH_NUM_LOADS] = {
+	"idle", "blocked"
+};
+
+/* Interrupt of each source on CPU0 */
+static const u32 IrqBench_IntIds[IRQ_BENCH_NUM_SOURCES] = {
+	IRQ_BENCH_PONG_SGI, XPS_SCU_TMR_INT_ID, XPS_UART0_INT_ID
+};
+
+/* The fast FIQ handler takes no argument */
+static IrqBench *IrqBench_ActivePtr;
+
+static u8 IrqBench_Thrash[IRQ_BENCH_THRASH]
+	__attribute__((aligned(IRQ_BENCH_LINE))) XIL_NOINIT;
+
+/****************************************************************************/
+/**
+*
+* Initializes the benchmark: the AMP runtime if it is not yet, the
+* handlers of the sources, the private timer, UART0 in local loopback at
+* IRQ_BENCH_BAUDRATE with the receive trigger at one byte, and CPU1 for the
+* software interrupt round trip.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return
+*		- XST_SUCCESS if the benchmark is ready, CPU1 started or not.
+*		- XST_FAILURE if the timer or UART0 is not found, or the byte
+*		  of the calibration does not come back.
+*		- The error of the failing driver call otherwise.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 IrqBench_Initialize(IrqBench *BenchPtr)
+{
+	XScuTimer_Config *TimerCfgPtr;
+	XUartPs_Config *CfgPtr;
+	u32 Timeout;
+	s32 Status;
+
+	(void)memset(BenchPtr, 0, sizeof(*BenchPtr));
+	BenchPtr->Cpu1Status = XST_FAILURE;
+	IrqBench_ActivePtr = BenchPtr;
+
+	XTimestamp_EnableCycles();
+
+	Status = Amp_InitFromWrapper();
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+	BenchPtr->GicPtr = Amp_GetGic(0U);
+
+	TimerCfgPtr = XScuTimer_LookupConfigStatic(XPAR_XSCUTIMER_0_BASEADDR);
+	CfgPtr = XUartPs_LookupConfigStatic(XPAR_XUARTPS_0_BASEADDR);
+	if ((TimerCfgPtr == NULL) || (CfgPtr == NULL)) {
+		return XST_FAILURE;
+	}
+	BenchPtr->CfgPtr = CfgPtr;
+
+	Status = XScuTimer_CfgInitialize(&BenchPtr->Timer, TimerCfgPtr,
+					 TimerCfgPtr->BaseAddr);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+	XScuTimer_Stop(&BenchPtr->Timer);
+	XScuTimer_SetPrescaler(&BenchPtr->Timer, 0U);
+	XScuTimer_LoadTimer(&BenchPtr->Timer, IRQ_BENCH_TIMER_RELOAD);
+	XScuTimer_EnableAutoReload(&BenchPtr->Timer);
+	XScuTimer_ClearInterruptStatus(&BenchPtr->Timer);
+	XScuTimer_EnableInterrupt(&BenchPtr->Timer);
+
+	Status = XUartPs_CfgInitialize(&BenchPtr->Uart, CfgPtr,
+				       CfgPtr->BaseAddress);
+	if (Status == XST_SUCCESS) {
+		Status = XUartPs_SetBaudRate(&BenchPtr->Uart,
+					     IRQ_BENCH_BAUDRATE);
+	}
+	if (Status != XST_SUCCESS) {
+		IrqBench_Restore(BenchPtr);
+		return Status;
+	}
+	XUartPs_SetOperMode(&BenchPtr->Uart, XUARTPS_OPER_MODE_LOCAL_LOOP);
+	XUartPs_SetFifoThreshold(&BenchPtr->Uart, 1U);
+
+	/* The byte on the line, before its interrupt is enabled */
+	Status = IrqBench_Calibrate(BenchPtr);
+	if (Status != XST_SUCCESS) {
+		IrqBench_Restore(BenchPtr);
+		return Status;
+	}
+	XUartPs_SetInterruptMask(&BenchPtr->Uart, XUARTPS_IXR_RXOVR);
+
+	Status = IrqBench_Connect(BenchPtr, IRQ_BENCH_PONG_SGI,
+				  IrqBench_PongHandler, IRQ_BENCH_PRIORITY);
+	if (Status == XST_SUCCESS) {
+		Status = IrqBench_Connect(BenchPtr, XPS_SCU_TMR_INT_ID,
+					  IrqBench_TimerHandler,
+					  IRQ_BENCH_PRIORITY);
+	}
+	if (Status == XST_SUCCESS) {
+		Status = IrqBench_Connect(BenchPtr, XPS_UART0_INT_ID,
+					  IrqBench_UartHandler,
+					  IRQ_BENCH_PRIORITY);
+	}
+	if (Status == XST_SUCCESS) {
+		Status = IrqBench_Connect(BenchPtr, IRQ_BENCH_BLOCK_SGI,
+					  IrqBench_BlockHandler,
+					  IRQ_BENCH_BLOCK_PRIORITY);
+	}
+	if (Status == XST_SUCCESS) {
+		/* Enabled by CPU1 in its own software interrupt registers */
+		Status = XScuGic_Connect(BenchPtr->GicPtr, IRQ_BENCH_PING_SGI,
+					 IrqBench_PingHandler, BenchPtr);
+	}
+	if (Status != XST_SUCCESS) {
+		IrqBench_Restore(BenchPtr);
+		return Status;
+	}
+
+	(void)memset(IrqBench_Thrash, 0x5A, IRQ_BENCH_THRASH);
+	Xil_ExceptionEnable();
+
+	/* Without CPU1 only the software interrupt source fails */
+	BenchPtr->Cpu1Status = Amp_StartCpu1(IrqBench_Cpu1Main, BenchPtr);
+	if (BenchPtr->Cpu1Status == XST_SUCCESS) {
+		for (Timeout = 0U; BenchPtr->Cpu1Ready == 0U; Timeout++) {
+			if (Timeout == IRQ_BENCH_TIMEOUT) {
+				BenchPtr->Cpu1Status = XST_FAILURE;
+				break;
+			}
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Runs one source, configuration and load: sets up the configuration,
+* takes IRQ_BENCH_SAMPLES samples and undoes it.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	Source is one of the IRQ_BENCH_* sources.
+* @param	Config is one of the IRQ_BENCH_CFG_* configurations.
+* @param	Load is IRQ_BENCH_IDLE or IRQ_BENCH_BLOCKED.
+* @param	ResultPtr is where the result is stored.
+*
+* @return
+*		- XST_SUCCESS if the run completed.
+*		- XST_INVALID_PARAM for an unknown source, configuration or
+*		  load.
+*		- XST_FAILURE if a handler did not run.
+*		- The error of Amp_StartCpu1() for the software interrupt
+*		  source without CPU1, or of Xil_HotPathL2Lock().
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 IrqBench_Run(IrqBench *BenchPtr, u32 Source, u32 Config, u32 Load,
+		 IrqBench_Result *ResultPtr)
+{
+	u32 IntId;
+	u32 Sample;
+	u32 Index;
+	u32 Cycles;
+	u64 Sum = 0U;
+	u8 Priority;
+	u8 Trigger;
+	s32 Status = XST_SUCCESS;
+
+	(void)memset(ResultPtr, 0, sizeof(*ResultPtr));
+	ResultPtr->Source = Source;
+	ResultPtr->Config = Config;
+	ResultPtr->Load = Load;
+	ResultPtr->Status = XST_INVALID_PARAM;
+	if ((Source >= IRQ_BENCH_NUM_SOURCES) ||
+	    (Config >= IRQ_BENCH_NUM_CFGS) || (Load >= IRQ_BENCH_NUM_LOADS)) {
+		return XST_INVALID_PARAM;
+	}
+	if ((Source == IRQ_BENCH_SGI) &&
+	    (BenchPtr->Cpu1Status != XST_SUCCESS)) {
+		ResultPtr->Status = BenchPtr->Cpu1Status;
+		return BenchPtr->Cpu1Status;
+	}
+
+	IntId = IrqBench_IntIds[Source];
+	BenchPtr->Source = Source;
+
+	if (Config == IRQ_BENCH_CFG_L2LOCK) {
+		Status = IrqBench_Lock(BenchPtr);
+	} else if (Config == IRQ_BENCH_CFG_FIQ) {
+		Xil_ExceptionRegisterFiqFast(IrqBench_FiqHandler);
+		XScuGic_SetFiq(BenchPtr->GicPtr, IntId);
+		Xil_ExceptionEnableMask(XIL_EXCEPTION_FIQ);
+	} else if (Config == IRQ_BENCH_CFG_NESTED) {
+		XScuGic_SetNestPriority(BenchPtr->GicPtr,
+					IRQ_BENCH_BLOCK_PRIORITY);
+	} else {
+		/* The driver dispatch as it is */
+	}
+	if (Status != XST_SUCCESS) {
+		ResultPtr->Status = Status;
+		return Status;
+	}
+
+	for (Sample = 0U; Sample < IRQ_BENCH_SAMPLES; Sample++) {
+		Status = IrqBench_Sample(BenchPtr, Load, &Cycles);
+		if (Status != XST_SUCCESS) {
+			break;
+		}
+		Sum += Cycles;
+
+		/* Insertion sort, the samples are few */
+		Index = Sample;
+		while ((Index > 0U) &&
+		       (BenchPtr->Samples[Index - 1U] > Cycles)) {
+			BenchPtr->Samples[Index] =
+				BenchPtr->Samples[Index - 1U];
+			Index--;
+		}
+		BenchPtr->Samples[Index] = Cycles;
+	}
+
+	if (Config == IRQ_BENCH_CFG_L2LOCK) {
+		IrqBench_Unlock();
+	} else if (Config == IRQ_BENCH_CFG_FIQ) {
+		Xil_ExceptionDisableMask(XIL_EXCEPTION_FIQ);
+		XScuGic_ClearFiq(BenchPtr->GicPtr);
+		XScuGic_GetPriorityTriggerType(BenchPtr->GicPtr, IntId,
+					       &Priority, &Trigger);
+		XScuGic_SetPriorityTriggerType(BenchPtr->GicPtr, IntId,
+					       IRQ_BENCH_PRIORITY, Trigger);
+		Xil_ExceptionRegisterFiqFast(NULL);
+	} else if (Config == IRQ_BENCH_CFG_NESTED) {
+		XScuGic_SetNestPriority(BenchPtr->GicPtr, XSCUGIC_NEST_NONE);
+	} else {
+		/* Nothing to undo */
+	}
+
+	if (Status != XST_SUCCESS) {
+		ResultPtr->Status = Status;
+		return Status;
+	}
+
+	ResultPtr->MinCycles = BenchPtr->Samples[0];
+	ResultPtr->AvgCycles = (u32)(Sum / IRQ_BENCH_SAMPLES);
+	ResultPtr->P99Cycles =
+		BenchPtr->Samples[(IRQ_BENCH_SAMPLES * 99U) / 100U];
+	ResultPtr->MaxCycles = BenchPtr->Samples[IRQ_BENCH_SAMPLES - 1U];
+	ResultPtr->Status = XST_SUCCESS;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Runs every source, configuration and load, then disconnects the
+* handlers, stops the timer, gives UART0 its default rate in normal mode
+* and lets CPU1 return.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	ResultsPtr is where the results are stored.
+* @param	MaxResults is the number of results ResultsPtr can hold,
+*		IRQ_BENCH_MAX_RESULTS for the full suite.
+*
+* @return	The number of results stored, including failed runs.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 IrqBench_RunAll(IrqBench *BenchPtr, IrqBench_Result *ResultsPtr,
+		    u32 MaxResults)
+{
+	u32 NumResults = 0U;
+	u32 Source;
+	u32 Config;
+	u32 Load;
+
+	for (Source = 0U; Source < IRQ_BENCH_NUM_SOURCES; Source++) {
+		for (Config = 0U; Config < IRQ_BENCH_NUM_CFGS; Config++) {
+			for (Load = 0U; Load < IRQ_BENCH_NUM_LOADS; Load++) {
+				if (NumResults >= MaxResults) {
+					break;
+				}
+				(void)IrqBench_Run(BenchPtr, Source, Config,
+						   Load,
+						   &ResultsPtr[NumResults]);
+				NumResults++;
+			}
+		}
+	}
+
+	BenchPtr->Quit = 1U;
+	dsb();
+	IrqBench_Restore(BenchPtr);
+
+	return NumResults;
+}
+
+/****************************************************************************/
+/**
+*
+* Prints the results as a table on the standard output.
+*
+* @param	ResultsPtr is the results of IrqBench_RunAll().
+* @param	NumResults is the number of results.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void IrqBench_Report(const IrqBench_Result *ResultsPtr, u32 NumResults)
+{
+	const IrqBench_Result *ResultPtr;
+	u32 Index;
+
+	xil_printf("source\tconfig\tload\tcycles min/avg/p99/max\r\n");
+
+	for (Index = 0U; Index < NumResults; Index++) {
+		ResultPtr = &ResultsPtr[Index];
+
+		if (ResultPtr->Status != XST_SUCCESS) {
+			xil_printf("%s\t%s\t%s\tfailed (%d)\r\n",
+				   IrqBench_SourceNames[ResultPtr->Source],
+				   IrqBench_CfgNames[ResultPtr->Config],
+				   IrqBench_LoadNames[ResultPtr->Load],
+				   ResultPtr->Status);
+			continue;
+		}
+
+		xil_printf("%s\t%s\t%s\t%u/%u/%u/%u\r\n",
+			   IrqBench_SourceNames[ResultPtr->Source],
+			   IrqBench_CfgNames[ResultPtr->Config],
+			   IrqBench_LoadNames[ResultPtr->Load],
+			   ResultPtr->MinCycles, ResultPtr->AvgCycles,
+			   ResultPtr->P99Cycles, ResultPtr->MaxCycles);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Main function of CPU1: enables the ping software interrupt in the
+* registers of CPU1 and takes it until the benchmark quits.
+*
+* @param	Arg is a pointer to the benchmark state.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void IrqBench_Cpu1Main(void *Arg)
+{
+	IrqBench *BenchPtr = (IrqBench *)Arg;
+	XScuGic *GicPtr = Amp_GetGic(1U);
+	u8 Priority;
+	u8 Trigger;
+
+	XScuGic_GetPriorityTriggerType(GicPtr, IRQ_BENCH_PING_SGI, &Priority,
+				       &Trigger);
+	XScuGic_SetPriorityTriggerType(GicPtr, IRQ_BENCH_PING_SGI,
+				       IRQ_BENCH_PRIORITY, Trigger);
+	XScuGic_DistWriteReg(GicPtr, XSCUGIC_ENABLE_SET_OFFSET,
+			     (u32)1U << IRQ_BENCH_PING_SGI);
+	BenchPtr->Cpu1Ready = 1U;
+	dsb();
+
+	while (BenchPtr->Quit == 0U) {
+		;
+	}
+
+	XScuGic_DistWriteReg(GicPtr, XSCUGIC_DISABLE_OFFSET,
+			     (u32)1U << IRQ_BENCH_PING_SGI);
+}
+
+/****************************************************************************/
+/*
+*
+* Handler of the ping on CPU1, raises the pong back on CPU0.
+*
+* @param	CallBackRef is a pointer to the benchmark state.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void IrqBench_PingHandler(void *CallBackRef)
+{
+	IrqBench *BenchPtr = (IrqBench *)CallBackRef;
+
+	(void)XScuGic_SoftwareIntr(BenchPtr->GicPtr, IRQ_BENCH_PONG_SGI, 1U);
+}
+
+/****************************************************************************/
+/*
+*
+* Handler of the pong on CPU0, the end of the round trip.
+*
+* @param	CallBackRef is a pointer to the benchmark state.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void IrqBench_PongHandler(void *CallBackRef)
+{
+	IrqBench *BenchPtr = (IrqBench *)CallBackRef;
+
+	BenchPtr->End = XTimestamp_Cycles();
+	BenchPtr->Done = 1U;
+}
+
+/****************************************************************************/
+/*
+*
+* Handler of the private timer: reads the count since the expiry first,
+* then stops the timer and clears its event.
+*
+* @param	CallBackRef is a pointer to the benchmark state.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void IrqBench_TimerHandler(void *CallBackRef)
+{
+	IrqBench *BenchPtr = (IrqBench *)CallBackRef;
+
+	BenchPtr->TimerTicks = IRQ_BENCH_TIMER_RELOAD -
+			       XScuTimer_GetCounterValue(&BenchPtr->Timer);
+	XScuTimer_Stop(&BenchPtr->Timer);
+	XScuTimer_ClearInterruptStatus(&BenchPtr->Timer);
+	BenchPtr->Done = 1U;
+}
+
+/****************************************************************************/
+/*
+*
+* Handler of UART0: reads the byte first, then clears the trigger.
+*
+* @param	CallBackRef is a pointer to the benchmark state.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void IrqBench_UartHandler(void *CallBackRef)
+{
+	IrqBench *BenchPtr = (IrqBench *)CallBackRef;
+	UINTPTR BaseAddress = BenchPtr->CfgPtr->BaseAddress;
+
+	(void)XUartPs_ReadReg(BaseAddress, XUARTPS_FIFO_OFFSET);
+	BenchPtr->End = XTimestamp_Cycles();
+	XUartPs_WriteReg(BaseAddress, XUARTPS_ISR_OFFSET,
+			 XUartPs_ReadReg(BaseAddress, XUARTPS_ISR_OFFSET));
+	BenchPtr->Done = 1U;
+}
+
+/****************************************************************************/
+/*
+*
+* Handler of the blocking software interrupt, takes the CPU for
+* IRQ_BENCH_BLOCK_CYCLES.
+*
+* @param	CallBackRef is not used.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void IrqBench_BlockHandler(void *CallBackRef)
+{
+	u32 Start = XTimestamp_Cycles();
+
+	(void)CallBackRef;
+
+	while ((XTimestamp_Cycles() - Start) < IRQ_BENCH_BLOCK_CYCLES) {
+		;
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Fast FIQ handler of IRQ_BENCH_CFG_FIQ, runs the handler of the source
+* being measured. The software interrupt is acknowledged at the CPU
+* interface around it, the timer and UART0 are cleared by their handlers.
+*
+* @return	None.
+*
+*****************************************************************************/
+static XIL_FIQ_FAST_HANDLER void IrqBench_FiqHandler(void)
+{
+	IrqBench *BenchPtr = IrqBench_ActivePtr;
+	u32 Ack;
+
+	if (BenchPtr->Source == IRQ_BENCH_SGI) {
+		Ack = XScuGic_CPUReadReg(BenchPtr->GicPtr,
+					 XSCUGIC_INT_ACK_OFFSET);
+		IrqBench_PongHandler(BenchPtr);
+		XScuGic_CPUWriteReg(BenchPtr->GicPtr, XSCUGIC_EOI_OFFSET, Ack);
+	} else if (BenchPtr->Source == IRQ_BENCH_TIMER) {
+		IrqBench_TimerHandler(BenchPtr);
+	} else {
+		IrqBench_UartHandler(BenchPtr);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Connects a handler of CPU0 at a priority and enables its interrupt.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	IntId is the interrupt.
+* @param	Handler is its handler, called with BenchPtr.
+* @param	Priority is its priority.
+*
+* @return	XST_SUCCESS, or the error of XScuGic_Connect().
+*
+*****************************************************************************/
+static s32 IrqBench_Connect(IrqBench *BenchPtr, u32 IntId,
+			    Xil_InterruptHandler Handler, u8 Priority)
+{
+	u8 OldPriority;
+	u8 Trigger;
+	s32 Status;
+
+	Status = XScuGic_Connect(BenchPtr->GicPtr, IntId, Handler, BenchPtr);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+	XScuGic_GetPriorityTriggerType(BenchPtr->GicPtr, IntId, &OldPriority,
+				       &Trigger);
+	XScuGic_SetPriorityTriggerType(BenchPtr->GicPtr, IntId, Priority,
+				       Trigger);
+	XScuGic_Enable(BenchPtr->GicPtr, IntId);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Takes one sample: thrashes the caches, arms the source, raises the
+* blocking interrupt for IRQ_BENCH_BLOCKED and waits for the handler.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	Load is IRQ_BENCH_IDLE or IRQ_BENCH_BLOCKED.
+* @param	CyclesPtr is where the latency is stored.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if the handler did not run in
+*		IRQ_BENCH_TIMEOUT cycles.
+*
+*****************************************************************************/
+static s32 IrqBench_Sample(IrqBench *BenchPtr, u32 Load, u32 *CyclesPtr)
+{
+	UINTPTR BaseAddress = BenchPtr->CfgPtr->BaseAddress;
+	u32 Source = BenchPtr->Source;
+	u32 Offset;
+	u32 Sum = 0U;
+	u32 Start;
+
+	for (Offset = 0U; Offset < IRQ_BENCH_THRASH; Offset += IRQ_BENCH_LINE) {
+		Sum += IrqBench_Thrash[Offset];
+	}
+	BenchPtr->Sink = Sum;
+	Xil_ICacheInvalidate();
+
+	BenchPtr->Done = 0U;
+	dsb();
+
+	Start = XTimestamp_Cycles();
+	if (Source == IRQ_BENCH_SGI) {
+		(void)XScuGic_SoftwareIntr(BenchPtr->GicPtr,
+					   IRQ_BENCH_PING_SGI, 2U);
+	} else if (Source == IRQ_BENCH_TIMER) {
+		XScuTimer_SetCounterReg(BenchPtr->Timer.Config.BaseAddr,
+					IRQ_BENCH_TIMER_DELAY);
+		XScuTimer_Start(&BenchPtr->Timer);
+	} else {
+		XUartPs_WriteReg(BaseAddress, XUARTPS_FIFO_OFFSET, 0x5AU);
+	}
+	if (Load == IRQ_BENCH_BLOCKED) {
+		(void)XScuGic_SoftwareIntr(BenchPtr->GicPtr,
+					   IRQ_BENCH_BLOCK_SGI, 1U);
+	}
+
+	while (BenchPtr->Done == 0U) {
+		if ((XTimestamp_Cycles() - Start) > IRQ_BENCH_TIMEOUT) {
+			XScuTimer_Stop(&BenchPtr->Timer);
+			return XST_FAILURE;
+		}
+	}
+
+	if (Source == IRQ_BENCH_SGI) {
+		*CyclesPtr = BenchPtr->End - Start;
+	} else if (Source == IRQ_BENCH_TIMER) {
+		*CyclesPtr = BenchPtr->TimerTicks * IRQ_BENCH_CYCLES_PER_TICK;
+	} else {
+		*CyclesPtr = BenchPtr->End - Start;
+		*CyclesPtr = (*CyclesPtr > BenchPtr->WireCycles) ?
+			     (*CyclesPtr - BenchPtr->WireCycles) : 0U;
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Measures the time of a byte through the loopback by polling, the fewest
+* cycles from the write to the FIFO to the data in the receive FIFO.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if a byte did not come back in
+*		IRQ_BENCH_TIMEOUT cycles.
+*
+*****************************************************************************/
+static s32 IrqBench_Calibrate(IrqBench *BenchPtr)
+{
+	UINTPTR BaseAddress = BenchPtr->CfgPtr->BaseAddress;
+	u32 Best = 0xFFFFFFFFU;
+	u32 Start;
+	u32 Cycles;
+	u32 Sample;
+
+	for (Sample = 0U; Sample < IRQ_BENCH_WIRE_SAMPLES; Sample++) {
+		Start = XTimestamp_Cycles();
+		XUartPs_WriteReg(BaseAddress, XUARTPS_FIFO_OFFSET, Sample);
+		while (XUartPs_IsReceiveData(BaseAddress) == FALSE) {
+			if ((XTimestamp_Cycles() - Start) > IRQ_BENCH_TIMEOUT) {
+				return XST_FAILURE;
+			}
+		}
+		Cycles = XTimestamp_Cycles() - Start;
+		(void)XUartPs_RecvByte(BaseAddress);
+		if (Cycles < Best) {
+			Best = Cycles;
+		}
+	}
+	BenchPtr->WireCycles = Best;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Locks the path of the interrupts into the ways of the L2: the vectors
+* and the assembly handlers after them, the handlers of this file from the
+* first one, the top of the IRQ stack and the benchmark state.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return	XST_SUCCESS, or the error of Xil_HotPathL2Lock() with no way
+*		left locked.
+*
+*****************************************************************************/
+static s32 IrqBench_Lock(IrqBench *BenchPtr)
+{
+	const UINTPTR Handlers[] = {
+		(UINTPTR)IrqBench_PongHandler, (UINTPTR)IrqBench_TimerHandler,
+		(UINTPTR)IrqBench_UartHandler, (UINTPTR)IrqBench_FiqHandler
+	};
+	UINTPTR Text = Handlers[0];
+	UINTPTR LineMask = ~(UINTPTR)(IRQ_BENCH_LINE - 1U);
+	u32 Index;
+	s32 Status;
+
+	for (Index = 1U; Index < (sizeof(Handlers) / sizeof(Handlers[0]));
+	     Index++) {
+		if (Handlers[Index] < Text) {
+			Text = Handlers[Index];
+		}
+	}
+
+	Status = Xil_HotPathL2Lock((UINTPTR)_vector_table, IRQ_BENCH_LOCK_LEN,
+				   IRQ_BENCH_WAY_VECTORS);
+	if (Status == XST_SUCCESS) {
+		Status = Xil_HotPathL2Lock(Text & LineMask,
+					   IRQ_BENCH_LOCK_LEN,
+					   IRQ_BENCH_WAY_TEXT);
+	}
+	if (Status == XST_SUCCESS) {
+		Status = Xil_HotPathL2Lock((UINTPTR)__irq_stack -
+					   IRQ_BENCH_LOCK_LEN,
+					   IRQ_BENCH_LOCK_LEN,
+					   IRQ_BENCH_WAY_STACK);
+	}
+	if (Status == XST_SUCCESS) {
+		Status = Xil_HotPathL2Lock((UINTPTR)BenchPtr, sizeof(*BenchPtr),
+					   IRQ_BENCH_WAY_STATE);
+	}
+	if (Status != XST_SUCCESS) {
+		IrqBench_Unlock();
+	}
+
+	return Status;
+}
+
+/****************************************************************************/
+/*
+*
+* Unlocks the ways of IrqBench_Lock().
+*
+* @return	None.
+*
+*****************************************************************************/
+static void IrqBench_Unlock(void)
+{
+	Xil_HotPathL2Unlock(IRQ_BENCH_WAY_VECTORS);
+	Xil_HotPathL2Unlock(IRQ_BENCH_WAY_TEXT);
+	Xil_HotPathL2Unlock(IRQ_BENCH_WAY_STACK);
+	Xil_HotPathL2Unlock(IRQ_BENCH_WAY_STATE);
+}
+
+/****************************************************************************/
+/*
+*
+* Disconnects the handlers, stops the private timer and puts UART0 back at
+* the default rate in normal mode.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void IrqBench_Restore(IrqBench *BenchPtr)
+{
+	u32 Index;
+
+	if (BenchPtr->GicPtr != NULL) {
+		for (Index = 0U; Index < IRQ_BENCH_NUM_SOURCES; Index++) {
+			XScuGic_Disable(BenchPtr->GicPtr,
+					IrqBench_IntIds[Index]);
+			XScuGic_Disconnect(BenchPtr->GicPtr,
+					   IrqBench_IntIds[Index]);
+		}
+		XScuGic_Disable(BenchPtr->GicPtr, IRQ_BENCH_BLOCK_SGI);
+		XScuGic_Disconnect(BenchPtr->GicPtr, IRQ_BENCH_BLOCK_SGI);
+		XScuGic_Disconnect(BenchPtr->GicPtr, IRQ_BENCH_PING_SGI);
+	}
+	if (BenchPtr->Timer.IsReady == XIL_COMPONENT_IS_READY) {
+		XScuTimer_Stop(&BenchPtr->Timer);
+		XScuTimer_DisableInterrupt(&BenchPtr->Timer);
+		XScuTimer_ClearInterruptStatus(&BenchPtr->Timer);
+	}
+	if (BenchPtr->CfgPtr != NULL) {
+		(void)XUartPs_CfgInitialize(&BenchPtr->Uart, BenchPtr->CfgPtr,
+					    BenchPtr->CfgPtr->BaseAddress);
+		XUartPs_SetOperMode(&BenchPtr->Uart,
+				    XUARTPS_OPER_MODE_NORMAL);
+	}
+}
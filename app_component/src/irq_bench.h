@@ -0,0 +1,170 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file irq_bench.h
+*
+* Interrupt latency of CPU0, in CPU cycles, from three sources:
+*
+* - sgi: the round trip of a software interrupt, CPU0 raising
+*   IRQ_BENCH_PING_SGI on CPU1, whose handler raises IRQ_BENCH_PONG_SGI
+*   back on CPU0. A sample is from the raise to the handler of CPU0.
+* - timer: the private timer of CPU0 expiring, reloading from
+*   IRQ_BENCH_TIMER_RELOAD. A sample is the count since the expiry read
+*   by the handler, two cycles per count.
+* - uart: a byte through UART0 in local loopback at IRQ_BENCH_BAUDRATE,
+*   with the receive trigger at one byte. A sample is from the send to
+*   the first read of the FIFO by the handler, less the time of the byte
+*   on the line measured by polling beforehand.
+*
+* Each source is measured in four configurations: the driver handler on
+* the IRQ, the same with the vectors, the handlers, the top of the IRQ
+* stack and the benchmark state locked into ways of the L2, the source
+* routed to the FIQ with a fast FIQ handler, and the IRQ with nested
+* dispatch from IRQ_BENCH_BLOCK_PRIORITY. Every configuration runs idle
+* and blocked, the latter raising IRQ_BENCH_BLOCK_SGI on CPU0 right after
+* arming the source, a lower priority interrupt whose handler spins for
+* IRQ_BENCH_BLOCK_CYCLES, so that the source fires while it runs; without
+* nesting or the FIQ the source waits for its end. Before each sample the
+* instruction cache is invalidated and the data caches are thrashed with
+* IRQ_BENCH_THRASH bytes read, so that the samples of the worst case are
+* the ones of a cold path.
+*
+* CPU1 is started with Amp_StartCpu1() for the software interrupt source,
+* with the AMP runtime of amp.h set up if it is not yet. If CPU1 had been
+* started already its interrupts are disabled, and the results of that
+* source are XST_DEVICE_BUSY. The benchmark is built into the application
+* when IRQ_BENCH is defined.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef IRQ_BENCH_H
+#define IRQ_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xscugic.h"
+#include "xscutimer.h"
+#include "xuartps.h"
+
+/************************** Constant Definitions ****************************/
+
+/** @name Sources
+ * @{
+ */
+#define IRQ_BENCH_SGI		0U	/**< SGI round trip via CPU1 */
+#define IRQ_BENCH_TIMER		1U	/**< Private timer of CPU0 */
+#define IRQ_BENCH_UART		2U	/**< UART0 receive trigger */
+#define IRQ_BENCH_NUM_SOURCES	3U
+/* @} */
+
+/** @name Configurations
+ * @{
+ */
+#define IRQ_BENCH_CFG_IRQ	0U	/**< IRQ, driver dispatch */
+#define IRQ_BENCH_CFG_L2LOCK	1U	/**< IRQ, path locked in L2 */
+#define IRQ_BENCH_CFG_FIQ	2U	/**< FIQ, fast handler */
+#define IRQ_BENCH_CFG_NESTED	3U	/**< IRQ, nested dispatch */
+#define IRQ_BENCH_NUM_CFGS	4U
+/* @} */
+
+/** @name Loads
+ * @{
+ */
+#define IRQ_BENCH_IDLE		0U	/**< Nothing else running */
+#define IRQ_BENCH_BLOCKED	1U	/**< A lower priority handler runs */
+#define IRQ_BENCH_NUM_LOADS	2U
+/* @} */
+
+#define IRQ_BENCH_PING_SGI	12U	/**< CPU0 to CPU1 */
+#define IRQ_BENCH_PONG_SGI	13U	/**< CPU1 back to CPU0 */
+#define IRQ_BENCH_BLOCK_SGI	11U	/**< The blocking handler */
+#define IRQ_BENCH_PRIORITY	0x40U	/**< Of the measured sources */
+#define IRQ_BENCH_BLOCK_PRIORITY 0xB0U	/**< Of the blocking handler */
+#define IRQ_BENCH_BLOCK_CYCLES	40000U	/**< Spin of the blocker */
+
+#define IRQ_BENCH_BAUDRATE	921600U	/**< Loopback line rate */
+#define IRQ_BENCH_TIMER_DELAY	2000U	/**< Counts to the expiry */
+#define IRQ_BENCH_TIMER_RELOAD	0xFFFFFFFFU /**< Count after the expiry */
+#define IRQ_BENCH_SAMPLES	128U	/**< Samples per result */
+#define IRQ_BENCH_THRASH	(1024U * 1024U) /**< Bytes read per sample */
+
+/** @name Ways of the L2 locked in IRQ_BENCH_CFG_L2LOCK
+ * @{
+ */
+#define IRQ_BENCH_WAY_VECTORS	3U	/**< Vectors, asm handlers */
+#define IRQ_BENCH_WAY_TEXT	4U	/**< Handlers of the benchmark */
+#define IRQ_BENCH_WAY_STACK	5U	/**< Top of the IRQ stack */
+#define IRQ_BENCH_WAY_STATE	6U	/**< Benchmark state */
+/* @} */
+
+/** Results of a full suite */
+#define IRQ_BENCH_MAX_RESULTS	(IRQ_BENCH_NUM_SOURCES * \
+				 IRQ_BENCH_NUM_CFGS * IRQ_BENCH_NUM_LOADS)
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Result of one source, configuration and load.
+ */
+typedef struct {
+	u32 Source;		/**< One of the IRQ_BENCH_* sources */
+	u32 Config;		/**< One of the IRQ_BENCH_CFG_* values */
+	u32 Load;		/**< IRQ_BENCH_IDLE or IRQ_BENCH_BLOCKED */
+	s32 Status;		/**< XST_SUCCESS, or why the run failed */
+	u32 MinCycles;		/**< Fastest sample */
+	u32 AvgCycles;		/**< Mean of the samples */
+	u32 P99Cycles;		/**< 99th percentile sample */
+	u32 MaxCycles;		/**< Slowest sample */
+} IrqBench_Result;
+
+/**
+ * State of the benchmark, shared by the two CPUs and the handlers.
+ */
+typedef struct {
+	XScuGic *GicPtr;	/**< GIC instance of CPU0 */
+	XScuTimer Timer;	/**< Private timer of CPU0 */
+	XUartPs Uart;		/**< UART0, in local loopback */
+	XUartPs_Config *CfgPtr;
+	volatile u32 Source;	/**< Source being measured */
+	volatile u32 Done;	/**< Set by the handler of the source */
+	volatile u32 End;	/**< Cycles at the handler */
+	volatile u32 TimerTicks; /**< Counts since the timer expiry */
+	volatile u32 Cpu1Ready;	/**< CPU1 takes the ping */
+	volatile u32 Quit;	/**< CPU1 returns when set */
+	volatile u32 Sink;	/**< Keeps the thrashing reads */
+	s32 Cpu1Status;		/**< Of Amp_StartCpu1() */
+	u32 WireCycles;		/**< A byte on the loopback, polled */
+	u32 Samples[IRQ_BENCH_SAMPLES]; /**< Sorted, cycles */
+} IrqBench;
+
+/************************** Function Prototypes *****************************/
+
+s32 IrqBench_Initialize(IrqBench *BenchPtr);
+s32 IrqBench_Run(IrqBench *BenchPtr, u32 Source, u32 Config, u32 Load,
+		 IrqBench_Result *ResultPtr);
+u32 IrqBench_RunAll(IrqBench *BenchPtr, IrqBench_Result *ResultsPtr,
+		    u32 MaxResults);
+void IrqBench_Report(const IrqBench_Result *ResultsPtr, u32 NumResults);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* IRQ_BENCH_H */
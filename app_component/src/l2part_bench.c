@@ -0,0 +1,411 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file l2part_bench.c
+*
+* L2 partitioning benchmark. Refer to l2part_bench.h for what a sample and
+* a run measure.
+*
+* Each run starts from a clean and invalidated data cache, with CPU1 not
+* copying, and takes one warm-up sample that brings the working set into
+* the ways of CPU0 before CPU1 starts.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Set up the AMP runtime with Amp_InitFromWrapper().
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xil_printf.h"
+#include "xil_cache.h"
+#include "xpseudo_asm.h"
+#include "xiltimer.h"
+#include "xinterrupt_wrap.h"
+#include "xil_hotpath.h"
+#include "xil_l2lock.h"
+#include "amp.h"
+#include "l2part_bench.h"
+#include "drvcfg.h"
+
+/************************** Constant Definitions ****************************/
+
+#define L2PART_BENCH_LINE	32U	/* Line of the L1 and the L2 */
+#define L2PART_BENCH_TIMEOUT_US	1000U	/* Longest round trip of a byte */
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define L2PartBench_TicksToNs(Ticks) \
+	((u32)(((u64)(Ticks) * 1000000000U) / (u64)COUNTS_PER_SECOND))
+
+/************************** Function Prototypes *****************************/
+
+static void L2PartBench_Cpu1Main(void *Arg);
+static s32 L2PartBench_Sample(L2PartBench *BenchPtr, u8 Byte, XTime *TicksPtr);
+static void L2PartBench_Restore(L2PartBench *BenchPtr);
+
+/************************** Variable Definitions ****************************/
+
+static const char *L2PartBench_RunNames[L2PART_BENCH_NUM_RUNS] = {
+	"idle", "shared", "partitioned"
+};
+
+static u8 L2PartBench_WorkSet[L2PART_BENCH_WORKSET]
+	__attribute__((aligned(L2PART_BENCH_LINE))) XIL_NOINIT;
+static u8 L2PartBench_Stream[L2PART_BENCH_STREAM]
+	__attribute__((aligned(L2PART_BENCH_LINE))) XIL_NOINIT;
+
+/****************************************************************************/
+/**
+*
+* Initializes the benchmark: UART0 in local loopback at
+* L2PART_BENCH_BAUDRATE, the AMP runtime if it is not yet, and CPU1 in the
+* copy loop of the benchmark, not copying yet.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return
+*		- XST_SUCCESS if the benchmark is ready.
+*		- XST_DEVICE_BUSY if CPU1 was already started.
+*		- XST_FAILURE if UART0 is not found or CPU1 does not start.
+*		- The error of the failing driver call otherwise.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 L2PartBench_Initialize(L2PartBench *BenchPtr)
+{
+	XUartPs_Config *CfgPtr;
+	s32 Status;
+
+	BenchPtr->Streaming = 0U;
+	BenchPtr->Quit = 0U;
+	BenchPtr->Copies = 0U;
+
+	CfgPtr = XUartPs_LookupConfigStatic(XPAR_XUARTPS_0_BASEADDR);
+	if (CfgPtr == NULL) {
+		return XST_FAILURE;
+	}
+	BenchPtr->CfgPtr = CfgPtr;
+
+	Status = XUartPs_CfgInitialize(&BenchPtr->Uart, CfgPtr,
+				       CfgPtr->BaseAddress);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+	Status = XUartPs_SetBaudRate(&BenchPtr->Uart, L2PART_BENCH_BAUDRATE);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+	XUartPs_SetOperMode(&BenchPtr->Uart, XUARTPS_OPER_MODE_LOCAL_LOOP);
+
+	Status = Amp_InitFromWrapper();
+	if (Status != XST_SUCCESS) {
+		L2PartBench_Restore(BenchPtr);
+		return Status;
+	}
+
+	(void)memset(L2PartBench_Stream, 0x5A, L2PART_BENCH_STREAM);
+	(void)memset(L2PartBench_WorkSet, 0xA5, L2PART_BENCH_WORKSET);
+
+	Status = Amp_StartCpu1(L2PartBench_Cpu1Main, BenchPtr);
+	if (Status != XST_SUCCESS) {
+		L2PartBench_Restore(BenchPtr);
+	}
+
+	return Status;
+}
+
+/****************************************************************************/
+/**
+*
+* Runs one configuration: sets the ways of the CPUs, starts the copy of
+* CPU1 unless the run is L2PART_BENCH_IDLE, then takes
+* L2PART_BENCH_SAMPLES samples of the UART path.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	Run is one of the L2PART_BENCH_* runs.
+* @param	ResultPtr is where the result is stored.
+*
+* @return
+*		- XST_SUCCESS if the run completed.
+*		- XST_INVALID_PARAM for an unknown run or ways the L2 does
+*		  not have.
+*		- XST_FAILURE if a byte did not come back, or came back
+*		  corrupted.
+*
+* @note		The ways of the run are left set.
+*
+*****************************************************************************/
+s32 L2PartBench_Run(L2PartBench *BenchPtr, u32 Run,
+		    L2PartBench_Result *ResultPtr)
+{
+	u32 AllWays = (1U << Xil_L2LockNumWays()) - 1U;
+	XTime Start;
+	XTime End;
+	XTime Ticks;
+	u32 Sample;
+	u32 Index;
+	u32 Key;
+	s32 Status;
+
+	(void)memset(ResultPtr, 0, sizeof(*ResultPtr));
+	ResultPtr->Run = Run;
+	ResultPtr->Status = XST_INVALID_PARAM;
+	if (Run >= L2PART_BENCH_NUM_RUNS) {
+		return XST_INVALID_PARAM;
+	}
+
+	if (Run == L2PART_BENCH_PARTITIONED) {
+		Status = Amp_SetL2Ways(0U, L2PART_BENCH_CPU0_WAYS);
+		if (Status == XST_SUCCESS) {
+			Status = Amp_SetL2Ways(1U, L2PART_BENCH_CPU1_WAYS);
+		}
+	} else {
+		Status = Amp_SetL2Ways(0U, AllWays);
+		if (Status == XST_SUCCESS) {
+			Status = Amp_SetL2Ways(1U, AllWays);
+		}
+	}
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	/* The same cache contents at the start of each run */
+	Xil_DCacheFlush();
+	Status = L2PartBench_Sample(BenchPtr, 0U, &Ticks);
+	if (Status != XST_SUCCESS) {
+		ResultPtr->Status = Status;
+		return Status;
+	}
+
+	BenchPtr->Copies = 0U;
+	BenchPtr->Streaming = (Run != L2PART_BENCH_IDLE) ? 1U : 0U;
+	dsb();
+	XTime_GetTime(&Start);
+
+	for (Sample = 0U; Sample < L2PART_BENCH_SAMPLES; Sample++) {
+		Status = L2PartBench_Sample(BenchPtr, (u8)Sample, &Ticks);
+		if (Status != XST_SUCCESS) {
+			break;
+		}
+
+		/* Insertion sort, the samples are few */
+		Key = (u32)Ticks;
+		Index = Sample;
+		while ((Index > 0U) && (BenchPtr->Samples[Index - 1U] > Key)) {
+			BenchPtr->Samples[Index] = BenchPtr->Samples[Index - 1U];
+			Index--;
+		}
+		BenchPtr->Samples[Index] = Key;
+	}
+
+	XTime_GetTime(&End);
+	BenchPtr->Streaming = 0U;
+	dsb();
+
+	if (Status != XST_SUCCESS) {
+		ResultPtr->Status = Status;
+		return Status;
+	}
+
+	ResultPtr->LatMinNs = L2PartBench_TicksToNs(BenchPtr->Samples[0]);
+	ResultPtr->LatP50Ns = L2PartBench_TicksToNs(
+			BenchPtr->Samples[L2PART_BENCH_SAMPLES / 2U]);
+	ResultPtr->LatP99Ns = L2PartBench_TicksToNs(
+			BenchPtr->Samples[(L2PART_BENCH_SAMPLES * 99U) / 100U]);
+	ResultPtr->LatMaxNs = L2PartBench_TicksToNs(
+			BenchPtr->Samples[L2PART_BENCH_SAMPLES - 1U]);
+	if (End > Start) {
+		ResultPtr->StreamMBps = (u32)(((u64)BenchPtr->Copies *
+					       (L2PART_BENCH_STREAM / 2U) *
+					       COUNTS_PER_SECOND) /
+					      ((End - Start) * 1000000U));
+	}
+	ResultPtr->Status = XST_SUCCESS;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Runs every configuration, then gives the CPUs back their ways, UART0 its
+* default rate in normal mode, and lets CPU1 return.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	ResultsPtr is where the results are stored.
+* @param	MaxResults is the number of results ResultsPtr can hold,
+*		L2PART_BENCH_MAX_RESULTS for the full suite.
+*
+* @return	The number of results stored, including failed runs.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 L2PartBench_RunAll(L2PartBench *BenchPtr, L2PartBench_Result *ResultsPtr,
+		       u32 MaxResults)
+{
+	u32 Cpu0Ways = Amp_GetL2Ways(0U);
+	u32 Cpu1Ways = Amp_GetL2Ways(1U);
+	u32 NumResults = 0U;
+	u32 Run;
+
+	for (Run = 0U; Run < L2PART_BENCH_NUM_RUNS; Run++) {
+		if (NumResults >= MaxResults) {
+			break;
+		}
+		(void)L2PartBench_Run(BenchPtr, Run, &ResultsPtr[NumResults]);
+		NumResults++;
+	}
+
+	(void)Amp_SetL2Ways(0U, Cpu0Ways);
+	(void)Amp_SetL2Ways(1U, Cpu1Ways);
+	BenchPtr->Quit = 1U;
+	dsb();
+	L2PartBench_Restore(BenchPtr);
+
+	return NumResults;
+}
+
+/****************************************************************************/
+/**
+*
+* Prints the results as a table on the standard output.
+*
+* @param	ResultsPtr is the results of L2PartBench_RunAll().
+* @param	NumResults is the number of results.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void L2PartBench_Report(const L2PartBench_Result *ResultsPtr, u32 NumResults)
+{
+	const L2PartBench_Result *ResultPtr;
+	u32 Index;
+
+	xil_printf("run\t\tlat min/p50/p99/max ns\tcpu1 MB/s\r\n");
+
+	for (Index = 0U; Index < NumResults; Index++) {
+		ResultPtr = &ResultsPtr[Index];
+
+		if (ResultPtr->Status != XST_SUCCESS) {
+			xil_printf("%s\tfailed (%d)\r\n",
+				   L2PartBench_RunNames[ResultPtr->Run],
+				   ResultPtr->Status);
+			continue;
+		}
+
+		xil_printf("%s\t%u/%u/%u/%u\t%u\r\n",
+			   L2PartBench_RunNames[ResultPtr->Run],
+			   ResultPtr->LatMinNs, ResultPtr->LatP50Ns,
+			   ResultPtr->LatP99Ns, ResultPtr->LatMaxNs,
+			   ResultPtr->StreamMBps);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Main function of CPU1: copies one half of the stream buffer over the
+* other while the benchmark asks for it.
+*
+* @param	Arg is a pointer to the benchmark state.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void L2PartBench_Cpu1Main(void *Arg)
+{
+	L2PartBench *BenchPtr = (L2PartBench *)Arg;
+
+	while (BenchPtr->Quit == 0U) {
+		if (BenchPtr->Streaming == 0U) {
+			continue;
+		}
+		(void)memcpy(&L2PartBench_Stream[L2PART_BENCH_STREAM / 2U],
+			     L2PartBench_Stream, L2PART_BENCH_STREAM / 2U);
+		BenchPtr->Copies++;
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Takes one sample: a byte through the loopback, then a read of each line
+* of the working set.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	Byte is the byte sent.
+* @param	TicksPtr is where the duration of the sample is stored.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if the byte did not come back in
+*		L2PART_BENCH_TIMEOUT_US or came back corrupted.
+*
+*****************************************************************************/
+static s32 L2PartBench_Sample(L2PartBench *BenchPtr, u8 Byte, XTime *TicksPtr)
+{
+	UINTPTR BaseAddress = BenchPtr->CfgPtr->BaseAddress;
+	XTime Start;
+	XTime Now;
+	u32 Offset;
+	u32 Sum = 0U;
+
+	XTime_GetTime(&Start);
+	XUartPs_SendByte(BaseAddress, Byte);
+	while (XUartPs_IsReceiveData(BaseAddress) == FALSE) {
+		XTime_GetTime(&Now);
+		if ((Now - Start) > (((XTime)COUNTS_PER_SECOND / 1000000U) *
+				     L2PART_BENCH_TIMEOUT_US)) {
+			return XST_FAILURE;
+		}
+	}
+	if (XUartPs_RecvByte(BaseAddress) != Byte) {
+		return XST_FAILURE;
+	}
+
+	for (Offset = 0U; Offset < L2PART_BENCH_WORKSET;
+	     Offset += L2PART_BENCH_LINE) {
+		Sum += L2PartBench_WorkSet[Offset];
+	}
+
+	XTime_GetTime(&Now);
+	BenchPtr->Sink = Sum;
+	*TicksPtr = Now - Start;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Puts UART0 back at the default rate in normal mode.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void L2PartBench_Restore(L2PartBench *BenchPtr)
+{
+	(void)XUartPs_CfgInitialize(&BenchPtr->Uart, BenchPtr->CfgPtr,
+				    BenchPtr->CfgPtr->BaseAddress);
+	XUartPs_SetOperMode(&BenchPtr->Uart, XUARTPS_OPER_MODE_NORMAL);
+}
@@ -0,0 +1,118 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file l2part_bench.h
+*
+* Tail latency of the UART path on CPU0 while CPU1 streams through memory,
+* with the L2 shared and with it partitioned by Amp_SetL2Ways().
+*
+* A sample is one byte through UART0 in local loopback, polled, followed
+* by a pass over L2PART_BENCH_WORKSET bytes standing for the descriptors,
+* tables and code the bridge touches per byte. The working set is larger
+* than the 32 KB L1 and smaller than the ways of CPU0, so that each pass
+* hits in the L2 unless something else evicted it. The runs are:
+*
+* - L2PART_BENCH_IDLE, CPU1 idle and the whole L2 shared, the baseline.
+* - L2PART_BENCH_SHARED, CPU1 copying L2PART_BENCH_STREAM bytes over and
+*   over, the whole L2 shared.
+* - L2PART_BENCH_PARTITIONED, the same copy with CPU0 allocating in
+*   L2PART_BENCH_CPU0_WAYS and CPU1 in L2PART_BENCH_CPU1_WAYS.
+*
+* A run reports the distribution of L2PART_BENCH_SAMPLES samples, from the
+* global timer, and the copy bandwidth of CPU1 over the run, the price of
+* the partition to it.
+*
+* L2PartBench_Initialize() starts CPU1 with amp.h, so CPU1 must not have
+* been started before; it waits for events once L2PartBench_RunAll()
+* returns. The ways of the CPUs are given back as they were. The
+* benchmark is built into the application when L2PART_BENCH is defined.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef L2PART_BENCH_H
+#define L2PART_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xuartps.h"
+
+/************************** Constant Definitions ****************************/
+
+/** @name Runs
+ * @{
+ */
+#define L2PART_BENCH_IDLE		0U	/**< CPU1 idle */
+#define L2PART_BENCH_SHARED		1U	/**< CPU1 streams, L2 shared */
+#define L2PART_BENCH_PARTITIONED	2U	/**< CPU1 streams in its ways */
+#define L2PART_BENCH_NUM_RUNS		3U
+/* @} */
+
+#define L2PART_BENCH_BAUDRATE	921600U	/**< Line rate of the loopback */
+#define L2PART_BENCH_SAMPLES	256U	/**< Samples per run */
+#define L2PART_BENCH_WORKSET	(160U * 1024U) /**< Bytes of the path */
+#define L2PART_BENCH_STREAM	(1024U * 1024U) /**< Bytes CPU1 streams */
+#define L2PART_BENCH_CPU0_WAYS	0x3FU	/**< 384 KB for CPU0 */
+#define L2PART_BENCH_CPU1_WAYS	0xC0U	/**< 128 KB for CPU1 */
+
+/** Results of a full suite */
+#define L2PART_BENCH_MAX_RESULTS	L2PART_BENCH_NUM_RUNS
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Result of one run.
+ */
+typedef struct {
+	u32 Run;		/**< One of the L2PART_BENCH_* runs */
+	s32 Status;		/**< XST_SUCCESS, or why the run failed */
+	u32 LatMinNs;		/**< Fastest sample */
+	u32 LatP50Ns;		/**< Median sample */
+	u32 LatP99Ns;		/**< 99th percentile sample */
+	u32 LatMaxNs;		/**< Slowest sample */
+	u32 StreamMBps;		/**< Copy bandwidth of CPU1, 0 when idle */
+} L2PartBench_Result;
+
+/**
+ * State of the benchmark, shared by the two CPUs.
+ */
+typedef struct {
+	XUartPs Uart;		/**< UART0, in local loopback */
+	XUartPs_Config *CfgPtr;
+	volatile u32 Streaming;	/**< CPU1 copies while set */
+	volatile u32 Quit;	/**< CPU1 returns when set */
+	volatile u32 Copies;	/**< Copies of half the stream by CPU1 */
+	volatile u32 Sink;	/**< Keeps the passes over the working set */
+	u32 Samples[L2PART_BENCH_SAMPLES]; /**< Sorted, timer ticks */
+} L2PartBench;
+
+/************************** Function Prototypes *****************************/
+
+s32 L2PartBench_Initialize(L2PartBench *BenchPtr);
+s32 L2PartBench_Run(L2PartBench *BenchPtr, u32 Run,
+		    L2PartBench_Result *ResultPtr);
+u32 L2PartBench_RunAll(L2PartBench *BenchPtr, L2PartBench_Result *ResultsPtr,
+		       u32 MaxResults);
+void L2PartBench_Report(const L2PartBench_Result *ResultsPtr, u32 NumResults);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* L2PART_BENCH_H */
@@ -0,0 +1,484 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file layout_bench.c
+*
+* Driver instance layout benchmark. Refer to layout_bench.h for what a
+* sample and a run measure.
+*
+* The UART0 instance is a static of this file between the two words CPU1
+* writes, tagged with XIL_HOT_INSTANCE like the GIC instance of the
+* interrupt wrapper, so that both are where the BSP puts the driver
+* instances. The refills of the polling loop of CPU0 waiting for the event
+* are counted too, the same in every build.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Set up the AMP runtime with Amp_InitFromWrapper().
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xil_printf.h"
+#include "xil_cache.h"
+#include "xil_exception.h"
+#include "xpseudo_asm.h"
+#include "xpm_counter.h"
+#include "xinterrupt_wrap.h"
+#include "xtimestamp.h"
+#include "xil_hotpath.h"
+#include "amp.h"
+#include "layout_bench.h"
+#include "drvcfg.h"
+
+/************************** Constant Definitions ****************************/
+
+#define LAYOUT_BENCH_LINE	32U	/* Line of the L1 and the L2 */
+#define LAYOUT_BENCH_TIMEOUT	2000000U /* Cycles to wait for the event */
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static void LayoutBench_Cpu1Main(void *Arg);
+static void LayoutBench_Handler(void *CallBackRef, u32 Event, u32 EventData);
+static s32 LayoutBench_Sample(LayoutBench *BenchPtr, u32 Run,
+			      u32 *RefillsPtr, u32 *CyclesPtr);
+static u32 LayoutBench_ReadRefills(const LayoutBench *BenchPtr);
+static void LayoutBench_Restore(LayoutBench *BenchPtr);
+
+/************************** Variable Definitions ****************************/
+
+static const char *LayoutBench_RunNames[LAYOUT_BENCH_NUM_RUNS] = {
+	"warm", "cold", "shared"
+};
+
+/* UART0 between two words of CPU1, as neighbouring data in AMP */
+static struct {
+	volatile u32 Before;
+	XUartPs Uart;
+	volatile u32 After;
+} LayoutBench_Uart0 XIL_HOT_INSTANCE;
+
+static u8 LayoutBench_Thrash[LAYOUT_BENCH_THRASH]
+	__attribute__((aligned(LAYOUT_BENCH_LINE))) XIL_NOINIT;
+
+/****************************************************************************/
+/**
+*
+* Initializes the benchmark: the AMP runtime if it is not yet, UART0 in
+* local loopback at LAYOUT_BENCH_BAUDRATE with the receive trigger at one
+* byte and its driver handler on the GIC, an event counter of the data
+* cache refills, and CPU1 in the write loop of the benchmark, not writing
+* yet.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return
+*		- XST_SUCCESS if the benchmark is ready.
+*		- XST_DEVICE_BUSY if CPU1 was already started.
+*		- XST_FAILURE if UART0 is not found, no event counter is
+*		  free or CPU1 does not start.
+*		- The error of the failing driver call otherwise.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 LayoutBench_Initialize(LayoutBench *BenchPtr)
+{
+	XUartPs_Config *CfgPtr;
+	XUartPs *UartPtr = &LayoutBench_Uart0.Uart;
+	u8 Priority;
+	u8 Trigger;
+	s32 Status;
+
+	(void)memset(BenchPtr, 0, sizeof(*BenchPtr));
+	BenchPtr->UartPtr = UartPtr;
+	BenchPtr->RefillCounter = XPM_NO_COUNTERS_AVAILABLE;
+
+	XTimestamp_EnableCycles();
+
+	Status = Amp_InitFromWrapper();
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+	BenchPtr->GicPtr = Amp_GetGic(0U);
+
+	CfgPtr = XUartPs_LookupConfigStatic(XPAR_XUARTPS_0_BASEADDR);
+	if (CfgPtr == NULL) {
+		return XST_FAILURE;
+	}
+	BenchPtr->CfgPtr = CfgPtr;
+
+	Status = XUartPs_CfgInitialize(UartPtr, CfgPtr, CfgPtr->BaseAddress);
+	if (Status == XST_SUCCESS) {
+		Status = XUartPs_SetBaudRate(UartPtr, LAYOUT_BENCH_BAUDRATE);
+	}
+	if (Status != XST_SUCCESS) {
+		LayoutBench_Restore(BenchPtr);
+		return Status;
+	}
+	XUartPs_SetOperMode(UartPtr, XUARTPS_OPER_MODE_LOCAL_LOOP);
+	XUartPs_SetFifoThreshold(UartPtr, 1U);
+	XUartPs_SetRecvTimeout(UartPtr, 0U);
+	XUartPs_SetHandler(UartPtr, LayoutBench_Handler, BenchPtr);
+
+	Status = XScuGic_Connect(BenchPtr->GicPtr, XPS_UART0_INT_ID,
+				 (Xil_InterruptHandler)XUartPs_InterruptHandler,
+				 UartPtr);
+	if (Status != XST_SUCCESS) {
+		LayoutBench_Restore(BenchPtr);
+		return Status;
+	}
+	XScuGic_GetPriorityTriggerType(BenchPtr->GicPtr, XPS_UART0_INT_ID,
+				       &Priority, &Trigger);
+	XScuGic_SetPriorityTriggerType(BenchPtr->GicPtr, XPS_UART0_INT_ID,
+				       LAYOUT_BENCH_PRIORITY, Trigger);
+	XScuGic_Enable(BenchPtr->GicPtr, XPS_UART0_INT_ID);
+	XUartPs_SetInterruptMask(UartPtr, XUARTPS_IXR_RXOVR);
+
+	BenchPtr->RefillCounter = Xpm_SetUpAnEvent(XPM_EVENT_DATA_CACHEREFILL);
+	if (BenchPtr->RefillCounter == XPM_NO_COUNTERS_AVAILABLE) {
+		LayoutBench_Restore(BenchPtr);
+		return XST_FAILURE;
+	}
+
+	(void)memset(LayoutBench_Thrash, 0x5A, LAYOUT_BENCH_THRASH);
+	Xil_ExceptionEnable();
+
+	Status = Amp_StartCpu1(LayoutBench_Cpu1Main, BenchPtr);
+	if (Status != XST_SUCCESS) {
+		LayoutBench_Restore(BenchPtr);
+	}
+
+	return Status;
+}
+
+/****************************************************************************/
+/**
+*
+* Runs one configuration: starts the writes of CPU1 for
+* LAYOUT_BENCH_SHARED, takes one warm-up sample, then LAYOUT_BENCH_SAMPLES
+* samples of the interrupt path.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	Run is one of the LAYOUT_BENCH_* runs.
+* @param	ResultPtr is where the result is stored.
+*
+* @return
+*		- XST_SUCCESS if the run completed.
+*		- XST_INVALID_PARAM for an unknown run.
+*		- XST_FAILURE if a byte did not come back, or came back
+*		  corrupted.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 LayoutBench_Run(LayoutBench *BenchPtr, u32 Run,
+		    LayoutBench_Result *ResultPtr)
+{
+	u64 RefillSum = 0U;
+	u64 CycleSum = 0U;
+	u32 Refills;
+	u32 Cycles;
+	u32 Sample;
+	s32 Status;
+
+	(void)memset(ResultPtr, 0, sizeof(*ResultPtr));
+	ResultPtr->Run = Run;
+	ResultPtr->Status = XST_INVALID_PARAM;
+	if (Run >= LAYOUT_BENCH_NUM_RUNS) {
+		return XST_INVALID_PARAM;
+	}
+
+	BenchPtr->Sharing = (Run == LAYOUT_BENCH_SHARED) ? 1U : 0U;
+	dsb();
+
+	Status = LayoutBench_Sample(BenchPtr, Run, &Refills, &Cycles);
+	ResultPtr->MinRefills = 0xFFFFFFFFU;
+
+	for (Sample = 0U; (Status == XST_SUCCESS) &&
+	     (Sample < LAYOUT_BENCH_SAMPLES); Sample++) {
+		Status = LayoutBench_Sample(BenchPtr, Run, &Refills, &Cycles);
+		if (Status != XST_SUCCESS) {
+			break;
+		}
+
+		RefillSum += Refills;
+		CycleSum += Cycles;
+		if (Refills < ResultPtr->MinRefills) {
+			ResultPtr->MinRefills = Refills;
+		}
+		if (Refills > ResultPtr->MaxRefills) {
+			ResultPtr->MaxRefills = Refills;
+		}
+		if (Cycles > ResultPtr->MaxCycles) {
+			ResultPtr->MaxCycles = Cycles;
+		}
+	}
+
+	BenchPtr->Sharing = 0U;
+	dsb();
+
+	if (Status != XST_SUCCESS) {
+		ResultPtr->Status = Status;
+		return Status;
+	}
+
+	ResultPtr->AvgRefills = (u32)(RefillSum / LAYOUT_BENCH_SAMPLES);
+	ResultPtr->AvgCycles = (u32)(CycleSum / LAYOUT_BENCH_SAMPLES);
+	ResultPtr->Status = XST_SUCCESS;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Runs every configuration, then gives UART0 back its default rate in
+* normal mode and its interrupt back to the GIC, frees the event counter
+* and lets CPU1 return.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	ResultsPtr is where the results are stored.
+* @param	MaxResults is the number of results ResultsPtr can hold,
+*		LAYOUT_BENCH_MAX_RESULTS for the full suite.
+*
+* @return	The number of results stored, including failed runs.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 LayoutBench_RunAll(LayoutBench *BenchPtr, LayoutBench_Result *ResultsPtr,
+		       u32 MaxResults)
+{
+	u32 NumResults = 0U;
+	u32 Run;
+
+	for (Run = 0U; Run < LAYOUT_BENCH_NUM_RUNS; Run++) {
+		if (NumResults >= MaxResults) {
+			break;
+		}
+		(void)LayoutBench_Run(BenchPtr, Run, &ResultsPtr[NumResults]);
+		NumResults++;
+	}
+
+	BenchPtr->Quit = 1U;
+	dsb();
+	LayoutBench_Restore(BenchPtr);
+
+	return NumResults;
+}
+
+/****************************************************************************/
+/**
+*
+* Prints the results as a table on the standard output, with the layout
+* the BSP was built with.
+*
+* @param	ResultsPtr is the results of LayoutBench_RunAll().
+* @param	NumResults is the number of results.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void LayoutBench_Report(const LayoutBench_Result *ResultsPtr, u32 NumResults)
+{
+	const LayoutBench_Result *ResultPtr;
+	u32 Index;
+
+#if defined (XIL_DRIVER_HOT_LAYOUT)
+	xil_printf("layout hot, XUartPs %u bytes\r\n", (u32)sizeof(XUartPs));
+#else
+	xil_printf("layout plain, XUartPs %u bytes\r\n", (u32)sizeof(XUartPs));
+#endif
+	xil_printf("run\trefills min/avg/max\tcycles avg/max\r\n");
+
+	for (Index = 0U; Index < NumResults; Index++) {
+		ResultPtr = &ResultsPtr[Index];
+
+		if (ResultPtr->Status != XST_SUCCESS) {
+			xil_printf("%s\tfailed (%d)\r\n",
+				   LayoutBench_RunNames[ResultPtr->Run],
+				   ResultPtr->Status);
+			continue;
+		}
+
+		xil_printf("%s\t%u/%u/%u\t\t%u/%u\r\n",
+			   LayoutBench_RunNames[ResultPtr->Run],
+			   ResultPtr->MinRefills, ResultPtr->AvgRefills,
+			   ResultPtr->MaxRefills, ResultPtr->AvgCycles,
+			   ResultPtr->MaxCycles);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Main function of CPU1: writes the words around the UART0 instance while
+* the benchmark asks for it.
+*
+* @param	Arg is a pointer to the benchmark state.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void LayoutBench_Cpu1Main(void *Arg)
+{
+	LayoutBench *BenchPtr = (LayoutBench *)Arg;
+
+	while (BenchPtr->Quit == 0U) {
+		if (BenchPtr->Sharing == 0U) {
+			continue;
+		}
+		LayoutBench_Uart0.Before++;
+		LayoutBench_Uart0.After++;
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Event handler of UART0, called by the driver from its interrupt handler.
+* Stamps the receive event, the end of a sample.
+*
+* @param	CallBackRef is a pointer to the benchmark state.
+* @param	Event is the XUARTPS_EVENT_* event.
+* @param	EventData is not used.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void LayoutBench_Handler(void *CallBackRef, u32 Event, u32 EventData)
+{
+	LayoutBench *BenchPtr = (LayoutBench *)CallBackRef;
+
+	(void)EventData;
+
+	if (Event == XUARTPS_EVENT_RECV_DATA) {
+		BenchPtr->EndRefills = LayoutBench_ReadRefills(BenchPtr);
+		BenchPtr->EndCycles = XTimestamp_Cycles();
+		BenchPtr->Done = 1U;
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Takes one sample: arms the receive of a byte, thrashes the data cache for
+* LAYOUT_BENCH_COLD, writes the byte and waits for the receive event.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	Run is one of the LAYOUT_BENCH_* runs.
+* @param	RefillsPtr is where the refills of the sample are stored.
+* @param	CyclesPtr is where its cycles are stored.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if the event did not come in
+*		LAYOUT_BENCH_TIMEOUT cycles or the byte came back corrupted.
+*
+*****************************************************************************/
+static s32 LayoutBench_Sample(LayoutBench *BenchPtr, u32 Run,
+			      u32 *RefillsPtr, u32 *CyclesPtr)
+{
+	UINTPTR BaseAddress = BenchPtr->CfgPtr->BaseAddress;
+	u32 StartRefills;
+	u32 Start;
+	u32 Offset;
+	u32 Sum = 0U;
+
+	BenchPtr->RxByte = 0U;
+	BenchPtr->Done = 0U;
+	(void)XUartPs_Recv(BenchPtr->UartPtr, &BenchPtr->RxByte, 1U);
+
+	if (Run == LAYOUT_BENCH_COLD) {
+		for (Offset = 0U; Offset < LAYOUT_BENCH_THRASH;
+		     Offset += LAYOUT_BENCH_LINE) {
+			Sum += LayoutBench_Thrash[Offset];
+		}
+		BenchPtr->Sink = Sum;
+	}
+	dsb();
+
+	StartRefills = LayoutBench_ReadRefills(BenchPtr);
+	Start = XTimestamp_Cycles();
+	XUartPs_WriteReg(BaseAddress, XUARTPS_FIFO_OFFSET, 0xA5U);
+
+	while (BenchPtr->Done == 0U) {
+		if ((XTimestamp_Cycles() - Start) > LAYOUT_BENCH_TIMEOUT) {
+			return XST_FAILURE;
+		}
+	}
+	if (BenchPtr->RxByte != 0xA5U) {
+		return XST_FAILURE;
+	}
+
+	*RefillsPtr = BenchPtr->EndRefills - StartRefills;
+	*CyclesPtr = BenchPtr->EndCycles - Start;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Reads the event counter of the data cache refills.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return	The counter value, wrapping at 2^32.
+*
+*****************************************************************************/
+static u32 LayoutBench_ReadRefills(const LayoutBench *BenchPtr)
+{
+	u32 Value = 0U;
+
+	(void)Xpm_GetEventCounter(BenchPtr->RefillCounter, &Value);
+
+	return Value;
+}
+
+/****************************************************************************/
+/*
+*
+* Gives the UART0 interrupt back, puts UART0 back at the default rate in
+* normal mode and frees the event counter.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void LayoutBench_Restore(LayoutBench *BenchPtr)
+{
+	if (BenchPtr->GicPtr != NULL) {
+		XScuGic_Disable(BenchPtr->GicPtr, XPS_UART0_INT_ID);
+		XScuGic_Disconnect(BenchPtr->GicPtr, XPS_UART0_INT_ID);
+	}
+	if (BenchPtr->CfgPtr != NULL) {
+		(void)XUartPs_CfgInitialize(BenchPtr->UartPtr, BenchPtr->CfgPtr,
+					    BenchPtr->CfgPtr->BaseAddress);
+		XUartPs_SetOperMode(BenchPtr->UartPtr,
+				    XUARTPS_OPER_MODE_NORMAL);
+	}
+	if (BenchPtr->RefillCounter != XPM_NO_COUNTERS_AVAILABLE) {
+		(void)Xpm_DisableEvent(BenchPtr->RefillCounter);
+		BenchPtr->RefillCounter = XPM_NO_COUNTERS_AVAILABLE;
+	}
+}
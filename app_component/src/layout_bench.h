@@ -0,0 +1,125 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file layout_bench.h
+*
+* Data cache misses of the interrupt path of CPU0 from the GIC to the
+* XUartPs driver, to compare a BSP built with XIL_DRIVER_HOT_LAYOUT, the
+* hot members of the instances on cache lines of their own and the
+* instances in the OCM, refer to xil_atomic.h and xil_hotpath.h, against
+* one built without.
+*
+* A sample is one byte through UART0 in local loopback at
+* LAYOUT_BENCH_BAUDRATE, received with XUartPs_Recv() and the receive
+* trigger at one byte, so that the interrupt goes through
+* XScuGic_InterruptHandler() and XUartPs_InterruptHandler() down to the
+* receive event of the driver. It counts the L1 data cache refills from the
+* write of the byte to that event, from an event counter of the PMU, and
+* the cycles. The runs are:
+*
+* - LAYOUT_BENCH_WARM, nothing else running, the floor of the path.
+* - LAYOUT_BENCH_COLD, the data cache thrashed with LAYOUT_BENCH_THRASH
+*   bytes read before each sample, twice the L1, so that every line the
+*   path touches is refilled from the L2 or the OCM: the count is the
+*   number of lines of the path.
+* - LAYOUT_BENCH_SHARED, CPU1 writing over and over the words right before
+*   and after the UART0 instance, data of its own neighbouring the
+*   instance as in AMP; without the hot layout they share lines with it.
+*
+* A run reports the refills and the cycles of LAYOUT_BENCH_SAMPLES
+* samples. LayoutBench_Initialize() starts CPU1 with amp.h, so CPU1 must
+* not have been started before. The benchmark is built into the
+* application when LAYOUT_BENCH is defined.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef LAYOUT_BENCH_H
+#define LAYOUT_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xscugic.h"
+#include "xuartps.h"
+
+/************************** Constant Definitions ****************************/
+
+/** @name Runs
+ * @{
+ */
+#define LAYOUT_BENCH_WARM	0U	/**< Warm caches */
+#define LAYOUT_BENCH_COLD	1U	/**< Thrashed data cache */
+#define LAYOUT_BENCH_SHARED	2U	/**< CPU1 writes next to the instance */
+#define LAYOUT_BENCH_NUM_RUNS	3U
+/* @} */
+
+#define LAYOUT_BENCH_BAUDRATE	921600U	/**< Line rate of the loopback */
+#define LAYOUT_BENCH_PRIORITY	0x40U	/**< Of the UART0 interrupt */
+#define LAYOUT_BENCH_SAMPLES	128U	/**< Samples per run */
+#define LAYOUT_BENCH_THRASH	(64U * 1024U) /**< Bytes read per sample */
+
+/** Results of a full suite */
+#define LAYOUT_BENCH_MAX_RESULTS	LAYOUT_BENCH_NUM_RUNS
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Result of one run.
+ */
+typedef struct {
+	u32 Run;		/**< One of the LAYOUT_BENCH_* runs */
+	s32 Status;		/**< XST_SUCCESS, or why the run failed */
+	u32 MinRefills;		/**< Fewest refills of a sample */
+	u32 AvgRefills;		/**< Mean of the samples */
+	u32 MaxRefills;		/**< Most refills of a sample */
+	u32 AvgCycles;		/**< Mean of the samples */
+	u32 MaxCycles;		/**< Slowest sample */
+} LayoutBench_Result;
+
+/**
+ * State of the benchmark, shared by the two CPUs and the handler.
+ */
+typedef struct {
+	XScuGic *GicPtr;	/**< GIC instance of CPU0 */
+	XUartPs *UartPtr;	/**< UART0, in local loopback */
+	XUartPs_Config *CfgPtr;
+	u32 RefillCounter;	/**< PMU event counter of the refills */
+	volatile u32 Done;	/**< Set by the receive event */
+	volatile u32 EndRefills; /**< Counter at the receive event */
+	volatile u32 EndCycles;	/**< Cycles at the receive event */
+	volatile u32 Sharing;	/**< CPU1 writes while set */
+	volatile u32 Quit;	/**< CPU1 returns when set */
+	volatile u32 Sink;	/**< Keeps the thrashing reads */
+	u8 RxByte;		/**< Receive buffer of the samples */
+} LayoutBench;
+
+/************************** Function Prototypes *****************************/
+
+s32 LayoutBench_Initialize(LayoutBench *BenchPtr);
+s32 LayoutBench_Run(LayoutBench *BenchPtr, u32 Run,
+		    LayoutBench_Result *ResultPtr);
+u32 LayoutBench_RunAll(LayoutBench *BenchPtr, LayoutBench_Result *ResultsPtr,
+		       u32 MaxResults);
+void LayoutBench_Report(const LayoutBench_Result *ResultsPtr, u32 NumResults);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LAYOUT_BENCH_H */
@@ -0,0 +1,319 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file lz4_block.c
+*
+* LZ4 blocks. Refer to lz4_block.h.
+*
+* A block is a list of sequences, each a token, literals and a match: the
+* token holds the number of literals in its high nibble and the length of
+* the match minus LZ4_BLOCK_MIN_MATCH in its low nibble, a nibble of 15
+* continuing in bytes of 255 and a last byte below 255. The literals
+* follow, then the offset of the match, u16 little endian. The last
+* sequence has literals only: the last LZ4_BLOCK_LAST_LITERALS bytes are
+* always literals and no match starts in the last LZ4_BLOCK_MF_LIMIT bytes.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "lz4_block.h"
+
+/************************** Constant Definitions ****************************/
+
+#define LZ4_BLOCK_MIN_MATCH	4U
+#define LZ4_BLOCK_LAST_LITERALS	5U
+#define LZ4_BLOCK_MF_LIMIT	12U	/* No match starts in the last bytes */
+#define LZ4_BLOCK_RUN_MASK	15U	/* Nibble continued in bytes */
+#define LZ4_BLOCK_SKIP_TRIGGER	6U	/* Misses before the step grows */
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define Lz4Block_Read32(Ptr) \
+	((u32)(Ptr)[0] | ((u32)(Ptr)[1] << 8U) | ((u32)(Ptr)[2] << 16U) | \
+	 ((u32)(Ptr)[3] << 24U))
+
+#define Lz4Block_Hash(Value) \
+	(((Value) * 2654435761U) >> (32U - LZ4_BLOCK_HASH_LOG))
+
+/************************** Function Prototypes *****************************/
+
+static u32 Lz4Block_PutSequence(u8 *DstPtr, u32 DstSize, u32 Pos,
+				const u8 *LiteralPtr, u32 NumLiterals,
+				u32 Offset, u32 MatchLength);
+static u32 Lz4Block_PutLength(u8 *DstPtr, u32 Pos, u32 Length);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* Compresses a block.
+*
+* @param	SrcPtr is the data.
+* @param	SrcLength is its length, up to LZ4_BLOCK_MAX_INPUT bytes.
+* @param	DstPtr receives the block.
+* @param	DstSize is the size of DstPtr.
+* @param	TablePtr is a table of LZ4_BLOCK_HASH_SIZE entries, scratch of
+*		the call.
+*
+* @return	The length of the block, 0 if it does not fit in DstSize or
+*		SrcLength is 0 or too long.
+*
+* @note		A block longer than the data is a valid result; the caller
+*		decides whether it is worth sending.
+*
+*****************************************************************************/
+u32 Lz4Block_Compress(const u8 *SrcPtr, u32 SrcLength, u8 *DstPtr,
+		      u32 DstSize, u16 *TablePtr)
+{
+	u32 Pos = 0U;
+	u32 Anchor = 0U;
+	u32 In = 0U;
+	u32 Misses = 0U;
+	u32 Hash;
+	u32 Ref;
+	u32 Length;
+	u32 MatchLimit;
+
+	if ((SrcLength == 0U) || (SrcLength > LZ4_BLOCK_MAX_INPUT)) {
+		return 0U;
+	}
+
+	if (SrcLength > LZ4_BLOCK_MF_LIMIT) {
+		(void)memset(TablePtr, 0, LZ4_BLOCK_HASH_SIZE * sizeof(u16));
+		MatchLimit = SrcLength - LZ4_BLOCK_LAST_LITERALS;
+
+		while ((In + LZ4_BLOCK_MF_LIMIT) < SrcLength) {
+			Hash = Lz4Block_Hash(Lz4Block_Read32(&SrcPtr[In]));
+			Ref = TablePtr[Hash];
+			TablePtr[Hash] = (u16)In;
+
+			if ((Ref >= In) ||
+			    (Lz4Block_Read32(&SrcPtr[Ref]) !=
+			     Lz4Block_Read32(&SrcPtr[In]))) {
+				/* Step faster through data that does not match */
+				Misses++;
+				In += 1U + (Misses >> LZ4_BLOCK_SKIP_TRIGGER);
+				continue;
+			}
+			Misses = 0U;
+
+			Length = LZ4_BLOCK_MIN_MATCH;
+			while (((In + Length) < MatchLimit) &&
+			       (SrcPtr[Ref + Length] == SrcPtr[In + Length])) {
+				Length++;
+			}
+
+			Pos = Lz4Block_PutSequence(DstPtr, DstSize, Pos,
+						   &SrcPtr[Anchor], In - Anchor,
+						   In - Ref, Length);
+			if (Pos == 0U) {
+				return 0U;
+			}
+			In += Length;
+			Anchor = In;
+		}
+	}
+
+	return Lz4Block_PutSequence(DstPtr, DstSize, Pos, &SrcPtr[Anchor],
+				    SrcLength - Anchor, 0U, 0U);
+}
+
+/****************************************************************************/
+/**
+*
+* Decompresses a block.
+*
+* @param	SrcPtr is the block.
+* @param	SrcLength is its length.
+* @param	DstPtr receives the data.
+* @param	DstSize is the size of DstPtr.
+*
+* @return	The length of the data, -1 if the block is malformed or the
+*		data does not fit in DstSize.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 Lz4Block_Decompress(const u8 *SrcPtr, u32 SrcLength, u8 *DstPtr,
+			u32 DstSize)
+{
+	u32 In = 0U;
+	u32 Out = 0U;
+	u32 Token;
+	u32 Length;
+	u32 Offset;
+	u32 Byte;
+	u32 Index;
+
+	for (;;) {
+		if (In >= SrcLength) {
+			return -1;
+		}
+		Token = SrcPtr[In];
+		In++;
+
+		Length = Token >> 4U;
+		if (Length == LZ4_BLOCK_RUN_MASK) {
+			do {
+				if (In >= SrcLength) {
+					return -1;
+				}
+				Byte = SrcPtr[In];
+				In++;
+				Length += Byte;
+			} while (Byte == 0xFFU);
+		}
+		if ((Length > (SrcLength - In)) || (Length > (DstSize - Out))) {
+			return -1;
+		}
+		(void)memcpy(&DstPtr[Out], &SrcPtr[In], Length);
+		In += Length;
+		Out += Length;
+
+		/* The last sequence ends the block after its literals */
+		if (In == SrcLength) {
+			break;
+		}
+
+		if ((SrcLength - In) < 2U) {
+			return -1;
+		}
+		Offset = (u32)SrcPtr[In] | ((u32)SrcPtr[In + 1U] << 8U);
+		In += 2U;
+		if ((Offset == 0U) || (Offset > Out)) {
+			return -1;
+		}
+
+		Length = Token & LZ4_BLOCK_RUN_MASK;
+		if (Length == LZ4_BLOCK_RUN_MASK) {
+			do {
+				if (In >= SrcLength) {
+					return -1;
+				}
+				Byte = SrcPtr[In];
+				In++;
+				Length += Byte;
+			} while (Byte == 0xFFU);
+		}
+		Length += LZ4_BLOCK_MIN_MATCH;
+		if (Length > (DstSize - Out)) {
+			return -1;
+		}
+
+		/* A byte at a time: the match may overlap what it writes */
+		for (Index = 0U; Index < Length; Index++) {
+			DstPtr[Out + Index] = DstPtr[Out - Offset + Index];
+		}
+		Out += Length;
+	}
+
+	return (s32)Out;
+}
+
+/****************************************************************************/
+/*
+*
+* Writes one sequence, or the last one when MatchLength is 0.
+*
+* @param	DstPtr is the block.
+* @param	DstSize is its size.
+* @param	Pos is where the sequence goes.
+* @param	LiteralPtr is the first literal.
+* @param	NumLiterals is the number of literals.
+* @param	Offset is the distance of the match.
+* @param	MatchLength is the length of the match, 0 for none.
+*
+* @return	The position after the sequence, 0 if it does not fit.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 Lz4Block_PutSequence(u8 *DstPtr, u32 DstSize, u32 Pos,
+				const u8 *LiteralPtr, u32 NumLiterals,
+				u32 Offset, u32 MatchLength)
+{
+	u32 Token;
+	u32 Worst;
+	u32 MatchCode = 0U;
+
+	/* Token, length bytes, literals, offset and length bytes */
+	Worst = 1U + (NumLiterals / 255U) + 1U + NumLiterals;
+	if (MatchLength != 0U) {
+		MatchCode = MatchLength - LZ4_BLOCK_MIN_MATCH;
+		Worst += 2U + (MatchCode / 255U) + 1U;
+	}
+	if (Worst > (DstSize - Pos)) {
+		return 0U;
+	}
+
+	Token = ((NumLiterals < LZ4_BLOCK_RUN_MASK) ? NumLiterals :
+		 LZ4_BLOCK_RUN_MASK) << 4U;
+	if (MatchLength != 0U) {
+		Token |= (MatchCode < LZ4_BLOCK_RUN_MASK) ? MatchCode :
+			 LZ4_BLOCK_RUN_MASK;
+	}
+	DstPtr[Pos] = (u8)Token;
+	Pos++;
+
+	if (NumLiterals >= LZ4_BLOCK_RUN_MASK) {
+		Pos = Lz4Block_PutLength(DstPtr, Pos,
+					 NumLiterals - LZ4_BLOCK_RUN_MASK);
+	}
+	(void)memcpy(&DstPtr[Pos], LiteralPtr, NumLiterals);
+	Pos += NumLiterals;
+
+	if (MatchLength != 0U) {
+		DstPtr[Pos] = (u8)Offset;
+		DstPtr[Pos + 1U] = (u8)(Offset >> 8U);
+		Pos += 2U;
+		if (MatchCode >= LZ4_BLOCK_RUN_MASK) {
+			Pos = Lz4Block_PutLength(DstPtr, Pos,
+						 MatchCode - LZ4_BLOCK_RUN_MASK);
+		}
+	}
+
+	return Pos;
+}
+
+/****************************************************************************/
+/*
+*
+* Writes the continuation of a length nibble of 15.
+*
+* @param	DstPtr is the block.
+* @param	Pos is where the bytes go.
+* @param	Length is what the nibble did not hold.
+*
+* @return	The position after the bytes.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 Lz4Block_PutLength(u8 *DstPtr, u32 Pos, u32 Length)
+{
+	while (Length >= 0xFFU) {
+		DstPtr[Pos] = 0xFFU;
+		Pos++;
+		Length -= 0xFFU;
+	}
+	DstPtr[Pos] = (u8)Length;
+
+	return Pos + 1U;
+}
@@ -0,0 +1,68 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file lz4_block.h
+*
+* LZ4 block format compressor and decompressor for small blocks, e.g. the
+* payload of a frame on the UART.
+*
+* The blocks are those of the reference LZ4 library, so a host decodes them
+* with LZ4_decompress_safe() and its LZ4_compress_default() output decodes
+* here. Each block stands alone: matches only reach back into the same
+* block, which keeps a lost block from breaking the following ones.
+*
+* The compressor is greedy with a hash table of LZ4_BLOCK_HASH_SIZE entries
+* of u16 that the caller provides, 2 KB, and the blocks are at most
+* LZ4_BLOCK_MAX_INPUT bytes, so both fit in a few KB of OCM. It gives the
+* usual 2 to 5 times on repetitive telemetry and stops as soon as the
+* output would not fit, so that incompressible data costs a bounded pass.
+* The decompressor checks every length and offset against both buffers and
+* never reads or writes outside them, whatever the input.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef LZ4_BLOCK_H
+#define LZ4_BLOCK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions ****************************/
+
+#define LZ4_BLOCK_HASH_LOG	10U	/**< Entries of the table, log 2 */
+#define LZ4_BLOCK_HASH_SIZE	(1U << LZ4_BLOCK_HASH_LOG)
+#define LZ4_BLOCK_MAX_INPUT	0xFFFFU	/**< Positions fit a u16 entry */
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+u32 Lz4Block_Compress(const u8 *SrcPtr, u32 SrcLength, u8 *DstPtr,
+		      u32 DstSize, u16 *TablePtr);
+s32 Lz4Block_Decompress(const u8 *SrcPtr, u32 SrcLength, u8 *DstPtr,
+			u32 DstSize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LZ4_BLOCK_H */
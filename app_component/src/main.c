@@ -0,0 +1,843 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file main.c
+*
+* USB-to-UART bridge application. Brings up the bridge engine and keeps the
+* per-direction throughput, in bytes per second, up to date in
+* BridgeThroughput[] once a second.
+*
+* The bridge runs in its interrupt handlers. What is left to the main loop
+* runs as events of the event loop of event_loop.h, posted by the timers of
+* the timer wheel, so that the CPU sleeps in WFI in between instead of
+* polling, leaving the L2 and the DDR to CPU1.
+*
+* When built with UART_BENCH defined, the driver benchmark of uart_bench.h
+* runs first and its results are printed before the bridge is started. The
+* same goes for the memory primitive benchmark of mem_bench.h with
+* MEM_BENCH defined, for the DMA throughput benchmark of dma_bench.h with
+* DMA_BENCH defined, for the memory region benchmark of region_bench.h
+* with REGION_BENCH defined, for the BRAM copy benchmark of bram_bench.h
+* with BRAM_BENCH defined, for the L2 partitioning benchmark of
+* l2part_bench.h with L2PART_BENCH defined, for the ring buffer benchmark
+* of ring_bench.h with RING_BENCH defined, for the interrupt latency
+* benchmark of irq_bench.h with IRQ_BENCH defined, for the driver
+* instance layout benchmark of layout_bench.h with LAYOUT_BENCH defined,
+* for the DDR QoS benchmark of qos_bench.h with QOS_BENCH defined, for the
+* UART bit error rate test of uart_bert.h with UART_BERT defined and for
+* the scheduler and queue benchmark of sched_bench.h with SCHED_BENCH
+* defined.
+*
+* The bridge gets the timer wheel of timer_wheel.h for its coalescing
+* deadlines. With BRIDGE_COALESCE_US defined, both directions received from
+* a UART coalesce up to BRIDGE_COALESCE_BYTES bytes or that many
+* microseconds, refer to Bridge_SetCoalesce(). With BRIDGE_TX_GAP_BITS
+* defined, the frames sent on the UART side are paced that many bit times
+* apart, refer to Bridge_SetTxGap().
+*
+* With THERMAL_GOV defined, the thermal governor of thermal_gov.h steps the
+* CPU clock profile and the coalescing of the bridge down as the die heats
+* up, polled from the main loop.
+*
+* With PGO_GENERATE defined, for the instrumented build of pgo.h, the
+* profile counters are cleared once the bridge is started and the profile
+* is dumped as Pgo_Poll() is asked to, once a second.
+*
+* With DEFERRED_PART defined, the partitions the FSBL left in the boot
+* device, refer to deferred_part.h, are loaded in the background once the
+* bridge is started, a chunk per dispatch of an event of the lowest
+* priority, which posts itself again while partitions are queued.
+*
+* With METRICS defined, the counters of the bridge, the temperature of the
+* thermal governor and the counts of the exporter itself are registered in
+* the metrics registry of metrics.h and a frame of their changes goes out
+* every METRICS_PERIOD_MS through the DCC log, both UARTs being the
+* bridge's, for tools/metrics_decode.py on the debugger side.
+*
+* With STACK_MARK defined, the stacks of the linker script are painted first
+* thing in main() and their high-water marks of stack_mark.h are read as
+* they grow, as metrics too with METRICS defined.
+*
+* With BRIDGE_BENCH defined, the bridge runs in the benchmark mode of
+* bridge_bench.h for tools/bridge_load.py on the host, the percentiles of
+* the latencies it stamps going out as metrics; it needs BRIDGE_RX_STAMP
+* and METRICS.
+*
+* With SUSPEND defined, the application suspends to RAM, refer to
+* suspend.h, once both directions of the bridge have been idle for
+* SUSPEND_IDLE_S seconds, the bridge UARTs waking it. A system reset
+* resumes it too with an FSBL built with FSBL_RESUME.
+*
+* With EDF_SCHED defined, the periodic jobs, the metrics export and the
+* thermal governor, are tasks of the earliest deadline first scheduler of
+* edf_sched.h instead of events posted every period, each with a budget,
+* and their misses and overruns go out as metrics.
+*
+* The DMA buffer arena reserved by the linker script is mapped non-cacheable
+* before anything else, for the DMA users to take their buffers from, and
+* the acp arena shareable cacheable for the ACP masters of the PL. The
+* region of the block pool allocator is handed over too, the users adding
+* their size classes to it, and the arenas of mem_region.h are set up. The
+* rest of the DDR is then mapped with 16 MB supersections where its
+* mapping allows it, for fewer TLB misses over large working sets.
+*
+* With GIC_FAST_INIT defined, the interrupt controller is initialized with
+* XScuGic_FastInitialize() first: a distributor the FSBL or CPU1 left
+* enabled is kept, and only the interrupts of MainGicDelta are programmed.
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xiltimer.h"
+#include "xil_mmu.h"
+#include "xil_dmaarena.h"
+#include "xil_acp.h"
+#include "xil_blockpool.h"
+#include "mem_region.h"
+#include "usb_to_uart.h"
+#include "event_loop.h"
+#if defined (UART_BENCH)
+#include "uart_bench.h"
+#endif
+#if defined (MEM_BENCH)
+#include "mem_bench.h"
+#endif
+#if defined (DMA_BENCH)
+#include "dma_bench.h"
+#endif
+#if defined (REGION_BENCH)
+#include "region_bench.h"
+#endif
+#if defined (BRAM_BENCH)
+#include "bram_bench.h"
+#endif
+#if defined (L2PART_BENCH)
+#include "l2part_bench.h"
+#endif
+#if defined (RING_BENCH)
+#include "ring_bench.h"
+#endif
+#if defined (IRQ_BENCH)
+#include "irq_bench.h"
+#endif
+#if defined (LAYOUT_BENCH)
+#include "layout_bench.h"
+#endif
+#if defined (QOS_BENCH)
+#include "qos_bench.h"
+#endif
+#if defined (UART_BERT)
+#include "uart_bert.h"
+#endif
+
+#if defined (SCHED_BENCH)
+#include "sched_bench.h"
+#endif
+#if defined (THERMAL_GOV)
+#include "clk_profile.h"
+#include "thermal_gov.h"
+#endif
+#if defined (PGO_GENERATE)
+#include "pgo.h"
+#endif
+#if defined (DEFERRED_PART)
+#include "deferred_part.h"
+#endif
+#if defined (METRICS)
+#include "xcoresightpsdcc.h"
+#include "metrics.h"
+#endif
+#if defined (STACK_MARK)
+#include "stack_mark.h"
+#endif
+#if defined (BRIDGE_BENCH)
+#if !defined (BRIDGE_RX_STAMP) || !defined (METRICS)
+#error "BRIDGE_BENCH needs BRIDGE_RX_STAMP and METRICS"
+#endif
+#include "bridge_bench.h"
+#endif
+#if defined (SUSPEND)
+#include "suspend.h"
+#endif
+#if defined (EDF_SCHED)
+#include "edf_sched.h"
+#endif
+#if defined (GIC_FAST_INIT)
+#include "xscugic.h"
+#include "xinterrupt_wrap.h"
+#endif
+
+/************************** Constant Definitions ****************************/
+
+#define BRIDGE_BAUDRATE		XUARTPS_DFT_BAUDRATE
+
+#if defined (BRIDGE_COALESCE_US) && !defined (BRIDGE_COALESCE_BYTES)
+#define BRIDGE_COALESCE_BYTES	BRIDGE_BD_SIZE
+#endif
+
+/* Events of the main loop, the first ones handled first */
+#define MAIN_EVENT_THERMAL	0U
+#define MAIN_EVENT_SECOND	1U
+#define MAIN_EVENT_METRICS	2U
+#define MAIN_EVENT_DCC_DRAIN	3U
+#define MAIN_EVENT_EDF		4U
+#define MAIN_EVENT_DEFERRED	5U
+#define MAIN_EVENT_SUSPEND	6U
+
+#define MAIN_SECOND_US		1000000U
+#define MAIN_THERMAL_US		10000U	/* Alarms and bursts of the governor */
+#define MAIN_DCC_DRAIN_US	1000U	/* While the DCC log holds bytes */
+
+#if defined (METRICS)
+#if !defined (METRICS_PERIOD_MS)
+#define METRICS_PERIOD_MS	100U
+#endif
+#define METRICS_DCC_WORDS	1024U	/* A few frames of the DCC log */
+#endif
+
+#if defined (EDF_SCHED)
+#define MAIN_THERMAL_BUDGET_US	1000U
+#define MAIN_METRICS_BUDGET_US	2000U
+#endif
+
+#if defined (SUSPEND) && !defined (SUSPEND_IDLE_S)
+#define SUSPEND_IDLE_S		10U
+#endif
+
+/************************** Variable Definitions ****************************/
+
+/* DMA buffer arena, from the linker script */
+extern u8 _dma_arena_start[];
+extern u8 _dma_arena_end[];
+
+/* ACP coherent arena, from the linker script */
+extern u8 _acp_arena_start[];
+extern u8 _acp_arena_end[];
+
+/* Block pool region, from the linker script */
+extern u8 _block_pool_start[];
+extern u8 _block_pool_end[];
+
+static Bridge UsbBridge;
+static TimerWheel BridgeWheel;
+static EventLoop MainLoop;
+static u64 LastBytes[BRIDGE_NUM_DIRS];
+
+#if defined (UART_BENCH)
+static UartBench Bench;
+static UartBench_Result BenchResults[UART_BENCH_MAX_RESULTS];
+#endif
+
+#if defined (MEM_BENCH)
+static MemBench MemoryBench;
+static MemBench_Result MemBenchResults[MEM_BENCH_MAX_RESULTS];
+#endif
+
+#if defined (DMA_BENCH)
+static DmaBench DmaThroughputBench;
+static DmaBench_Result DmaBenchResults[DMA_BENCH_MAX_RESULTS];
+#endif
+
+#if defined (REGION_BENCH)
+static RegionBench MemoryRegionBench;
+static RegionBench_Result RegionBenchResults[REGION_BENCH_MAX_RESULTS];
+#endif
+
+#if defined (BRAM_BENCH)
+static BramBench BramCopyBench;
+static BramBench_Result BramBenchResults[BRAM_BENCH_MAX_RESULTS];
+#endif
+
+#if defined (L2PART_BENCH)
+static L2PartBench L2Bench;
+static L2PartBench_Result L2BenchResults[L2PART_BENCH_MAX_RESULTS];
+#endif
+
+#if defined (RING_BENCH)
+static RingBench LockFreeRingBench;
+static RingBench_Result RingBenchResults[RING_BENCH_MAX_RESULTS];
+#endif
+
+#if defined (IRQ_BENCH)
+static IrqBench IrqLatencyBench;
+static IrqBench_Result IrqBenchResults[IRQ_BENCH_MAX_RESULTS];
+#endif
+
+#if defined (LAYOUT_BENCH)
+static LayoutBench IsrLayoutBench;
+static LayoutBench_Result LayoutBenchResults[LAYOUT_BENCH_MAX_RESULTS];
+#endif
+
+#if defined (QOS_BENCH)
+static QosBench DdrQosBench;
+static QosBench_Result QosBenchResults[QOS_BENCH_MAX_RESULTS];
+#endif
+
+#if defined (UART_BERT)
+static UartBert LinkBert;
+static UartBert_Result BertResults[UART_BERT_MAX_RESULTS];
+#endif
+
+#if defined (SCHED_BENCH)
+static SchedBench SchedPrimBench;
+static SchedBench_Result SchedBenchResults[SCHED_BENCH_MAX_RESULTS];
+#endif
+
+#if defined (THERMAL_GOV)
+static ClkProfile CpuClock;
+static ThermalGov Governor;
+#endif
+
+#if defined (DEFERRED_PART)
+static DeferredPart Deferred;
+#endif
+
+#if defined (BRIDGE_BENCH)
+static BridgeBench LoadBench;
+#endif
+
+#if defined (SUSPEND)
+static Suspend Sleeper;
+static u32 IdleSeconds;
+#endif
+
+#if defined (GIC_FAST_INIT)
+/* The interrupts of CPU0, as XSetupInterruptSystem() sets them up */
+static const XScuGic_Delta MainGicDelta[] = {
+	{ XPS_SCU_TMR_INT_ID, XINTERRUPT_DEFAULT_PRIORITY, 0x3U, 0x1U },
+	{ XPS_UART0_INT_ID, XINTERRUPT_DEFAULT_PRIORITY, 0x1U, 0x1U },
+	{ XPS_UART1_INT_ID, XINTERRUPT_DEFAULT_PRIORITY, 0x1U, 0x1U },
+};
+#endif
+
+#if defined (EDF_SCHED)
+static EdfSched Periodic;
+#if defined (THERMAL_GOV)
+static EdfSched_Task ThermalTask;
+#endif
+#if defined (METRICS)
+static EdfSched_Task MetricsTask;
+#endif
+#endif
+
+#if defined (METRICS)
+static Metrics Registry;
+static Metrics_Stats RegistryStats;
+static u32 MetricsDccRing[METRICS_DCC_WORDS];
+static const char *const MetricsDirNames[BRIDGE_NUM_DIRS][5] = {
+	{ "bridge.0.bytes", "bridge.0.buffers", "bridge.0.rx_stalls",
+	  "bridge.0.rx_errors", "bridge.0.latency_max_us" },
+	{ "bridge.1.bytes", "bridge.1.buffers", "bridge.1.rx_stalls",
+	  "bridge.1.rx_errors", "bridge.1.latency_max_us" },
+};
+#endif
+
+/* Bytes per second forwarded in each direction over the last second */
+volatile u32 BridgeThroughput[BRIDGE_NUM_DIRS];
+
+#if defined (METRICS)
+/*
+ * Sink of the metrics frames, the DCC log taking a frame whole or not at
+ * all.
+ */
+static u32 MetricsDccSink(void *Ref, const u8 *DataPtr, u32 NumBytes)
+{
+	(void)Ref;
+
+	return XCoresightPs_DccLogWrite(DataPtr, NumBytes);
+}
+
+#if defined (THERMAL_GOV)
+/*
+ * Temperature of the last burst of the thermal governor, in mC.
+ */
+static s32 MetricsReadMilliC(void *Ref)
+{
+	ThermalGov_Stats GovStats;
+
+	ThermalGov_GetStats((const ThermalGov *)Ref, &GovStats);
+
+	return GovStats.MilliC;
+}
+#endif
+
+/*
+ * Registers the metrics of the application. The counts of the exporter
+ * are those of the frame before, copied in after each export.
+ */
+static void MetricsRegister(void)
+{
+	Bridge_Stats *StatsPtr;
+	u32 Dir;
+
+	XCoresightPs_DccLogSetBuffer(MetricsDccRing, METRICS_DCC_WORDS);
+	if (Metrics_Initialize(&Registry, MetricsDccSink, NULL,
+			       METRICS_PERIOD_MS) != XST_SUCCESS) {
+		return;
+	}
+
+	for (Dir = 0U; Dir < BRIDGE_NUM_DIRS; Dir++) {
+		StatsPtr = &UsbBridge.Dir[Dir].Stats;
+		(void)Metrics_AddCounter64(&Registry, MetricsDirNames[Dir][0],
+					   &StatsPtr->Bytes);
+		(void)Metrics_AddCounter(&Registry, MetricsDirNames[Dir][1],
+					 &StatsPtr->Buffers);
+		(void)Metrics_AddCounter(&Registry, MetricsDirNames[Dir][2],
+					 &StatsPtr->RxStalls);
+		(void)Metrics_AddCounter(&Registry, MetricsDirNames[Dir][3],
+					 &StatsPtr->RxErrors);
+		(void)Metrics_AddGauge(&Registry, MetricsDirNames[Dir][4],
+				       (const s32 *)&StatsPtr->LatencyMaxUs);
+	}
+
+#if defined (THERMAL_GOV)
+	(void)Metrics_AddGaugeFn(&Registry, "thermal.milli_c",
+				 MetricsReadMilliC, &Governor);
+#endif
+
+	(void)Metrics_AddCounter(&Registry, "loop.wakes",
+				 &MainLoop.Stats.Wakes);
+	(void)Metrics_AddCounter64(&Registry, "loop.idle_counts",
+				   &MainLoop.Stats.IdleCounts);
+	(void)Metrics_AddCounter(&Registry, "metrics.frames",
+				 &RegistryStats.Frames);
+	(void)Metrics_AddCounter(&Registry, "metrics.dropped",
+				 &RegistryStats.Dropped);
+	(void)Metrics_AddCounter64(&Registry, "metrics.busy_counts",
+				   &RegistryStats.BusyCounts);
+#if defined (STACK_MARK)
+	(void)StackMark_Register(&Registry);
+#endif
+#if defined (BRIDGE_BENCH)
+	(void)BridgeBench_Register(&LoadBench, &Registry);
+#endif
+#if defined (EDF_SCHED) && defined (THERMAL_GOV)
+	(void)Metrics_AddCounter(&Registry, "edf.thermal.misses",
+				 &ThermalTask.Stats.Misses);
+	(void)Metrics_AddCounter(&Registry, "edf.thermal.overruns",
+				 &ThermalTask.Stats.Overruns);
+#endif
+#if defined (EDF_SCHED)
+	(void)Metrics_AddCounter(&Registry, "edf.metrics.misses",
+				 &MetricsTask.Stats.Misses);
+	(void)Metrics_AddCounter(&Registry, "edf.metrics.overruns",
+				 &MetricsTask.Stats.Overruns);
+	(void)Metrics_AddCounter64(&Registry, "edf.busy_counts",
+				   &Periodic.Stats.BusyCounts);
+#endif
+#if defined (SUSPEND)
+	(void)Metrics_AddCounter(&Registry, "suspend.wakes",
+				 &Sleeper.Stats.Wakes);
+	(void)Metrics_AddCounter(&Registry, "suspend.resumes",
+				 &Sleeper.Stats.Resumes);
+	(void)Metrics_AddCounter(&Registry, "suspend.refused",
+				 &Sleeper.Stats.Refused);
+#endif
+}
+
+/*
+ * Exports a frame of the metrics, and starts draining it.
+ */
+static void MainMetrics(void *CallBackRef)
+{
+	(void)CallBackRef;
+
+	(void)Metrics_Export(&Registry);
+	Metrics_GetStats(&Registry, &RegistryStats);
+	EventLoop_Post(&MainLoop, MAIN_EVENT_DCC_DRAIN);
+}
+
+#if defined (EDF_SCHED)
+/*
+ * The metrics export as a job of the scheduler, of one step.
+ */
+static u32 MainMetricsStep(void *CallBackRef)
+{
+	MainMetrics(CallBackRef);
+
+	return 0U;
+}
+#endif
+
+/*
+ * Moves the DCC log to the debugger as it reads it, until it is empty.
+ */
+static void MainDccDrain(void *CallBackRef)
+{
+	(void)CallBackRef;
+
+	if (XCoresightPs_DccLogDrain() != 0U) {
+		(void)EventLoop_PostAfter(&MainLoop, MAIN_EVENT_DCC_DRAIN,
+					  MAIN_DCC_DRAIN_US);
+	}
+}
+#endif
+
+/*
+ * Updates the throughput of the last second.
+ */
+static void MainSecond(void *CallBackRef)
+{
+	Bridge_Stats Stats;
+	u32 Dir;
+#if defined (SUSPEND)
+	u32 Bytes = 0U;
+#endif
+
+	(void)CallBackRef;
+
+	for (Dir = 0U; Dir < BRIDGE_NUM_DIRS; Dir++) {
+		Bridge_GetStats(&UsbBridge, Dir, &Stats);
+		BridgeThroughput[Dir] = (u32)(Stats.Bytes - LastBytes[Dir]);
+		LastBytes[Dir] = Stats.Bytes;
+#if defined (SUSPEND)
+		Bytes |= BridgeThroughput[Dir];
+#endif
+	}
+
+#if defined (SUSPEND)
+	IdleSeconds = (Bytes != 0U) ? 0U : (IdleSeconds + 1U);
+	if (IdleSeconds >= SUSPEND_IDLE_S) {
+		EventLoop_Post(&MainLoop, MAIN_EVENT_SUSPEND);
+	}
+#endif
+
+#if defined (PGO_GENERATE)
+	Pgo_Poll();
+#endif
+}
+
+#if defined (THERMAL_GOV)
+/*
+ * Runs the thermal governor.
+ */
+static void MainThermal(void *CallBackRef)
+{
+	ThermalGov_Poll((ThermalGov *)CallBackRef);
+}
+
+#if defined (EDF_SCHED)
+/*
+ * The thermal governor as a job of the scheduler, of one step.
+ */
+static u32 MainThermalStep(void *CallBackRef)
+{
+	MainThermal(CallBackRef);
+
+	return 0U;
+}
+#endif
+#endif
+
+#if defined (SUSPEND)
+/*
+ * Suspends to RAM, after the other events, the idle count restarting
+ * whether it suspended or was refused.
+ */
+static void MainSuspend(void *CallBackRef)
+{
+	IdleSeconds = 0U;
+	(void)Suspend_Enter((Suspend *)CallBackRef);
+}
+#endif
+
+#if defined (DEFERRED_PART)
+/*
+ * Loads a chunk of the deferred partitions, and the next one after the
+ * other events.
+ */
+static void MainDeferred(void *CallBackRef)
+{
+	if (DeferredPart_Poll((DeferredPart *)CallBackRef) != XST_SUCCESS) {
+		EventLoop_Post(&MainLoop, MAIN_EVENT_DEFERRED);
+	}
+}
+#endif
+
+/****************************************************************************/
+/**
+*
+* Main function of the bridge application.
+*
+* @return	XST_FAILURE if the bridge could not be started, does not
+*		return otherwise.
+*
+*****************************************************************************/
+int main(void)
+{
+	TimerWheel *WheelPtr;
+#if defined (BRIDGE_COALESCE_US) || defined (SUSPEND)
+	u32 Dir;
+#endif
+#if defined (GIC_FAST_INIT)
+	XScuGic_Config *GicCfgPtr;
+#endif
+	s32 Status;
+
+#if defined (STACK_MARK)
+	StackMark_Paint();
+#endif
+
+#if defined (GIC_FAST_INIT)
+	/* Before any driver, XSetupInterruptSystem() then finds it ready */
+	GicCfgPtr = XScuGic_LookupConfig(XPAR_XSCUGIC_0_BASEADDR);
+	if (GicCfgPtr != NULL) {
+		(void)XScuGic_FastInitialize(XGetScuGicInstance(), GicCfgPtr,
+					     MainGicDelta,
+					     sizeof(MainGicDelta) /
+					     sizeof(MainGicDelta[0]));
+	}
+#endif
+
+#if defined (DEFERRED_PART)
+	/* The handoff table of the FSBL, before anything uses the OCM */
+	(void)DeferredPart_Initialize(&Deferred);
+#endif
+
+	(void)Xil_DmaArenaInitialize((UINTPTR)_dma_arena_start,
+				     (u32)(_dma_arena_end - _dma_arena_start),
+				     NORM_NONCACHE);
+	(void)Xil_AcpInitialize((UINTPTR)_acp_arena_start,
+				(u32)(_acp_arena_end - _acp_arena_start));
+	(void)Xil_BlockPoolInitialize((UINTPTR)_block_pool_start,
+				      (u32)(_block_pool_end -
+					    _block_pool_start));
+	MemRegion_Initialize();
+	(void)Xil_MmuDdrSupersections();
+
+#if defined (UART_BENCH)
+	if (UartBench_Initialize(&Bench) == XST_SUCCESS) {
+		UartBench_Report(BenchResults,
+				 UartBench_RunAll(&Bench, BenchResults,
+						  UART_BENCH_MAX_RESULTS));
+	}
+#endif
+
+#if defined (MEM_BENCH)
+	if (MemBench_Initialize(&MemoryBench) == XST_SUCCESS) {
+		MemBench_Report(MemBenchResults,
+				MemBench_RunAll(&MemoryBench, MemBenchResults,
+						MEM_BENCH_MAX_RESULTS));
+	}
+#endif
+
+#if defined (DMA_BENCH)
+	if (DmaBench_Initialize(&DmaThroughputBench) == XST_SUCCESS) {
+		DmaBench_Report(DmaBenchResults,
+				DmaBench_RunAll(&DmaThroughputBench,
+						DmaBenchResults,
+						DMA_BENCH_MAX_RESULTS));
+	}
+#endif
+
+#if defined (REGION_BENCH)
+	if (RegionBench_Initialize(&MemoryRegionBench) == XST_SUCCESS) {
+		RegionBench_Report(RegionBenchResults,
+				   RegionBench_RunAll(&MemoryRegionBench,
+						      RegionBenchResults,
+						      REGION_BENCH_MAX_RESULTS));
+	}
+#endif
+
+#if defined (BRAM_BENCH)
+	if (BramBench_Initialize(&BramCopyBench) == XST_SUCCESS) {
+		BramBench_Report(BramBenchResults,
+				 BramBench_RunAll(&BramCopyBench,
+						  BramBenchResults,
+						  BRAM_BENCH_MAX_RESULTS));
+	}
+#endif
+
+#if defined (L2PART_BENCH)
+	if (L2PartBench_Initialize(&L2Bench) == XST_SUCCESS) {
+		L2PartBench_Report(L2BenchResults,
+				   L2PartBench_RunAll(&L2Bench, L2BenchResults,
+						      L2PART_BENCH_MAX_RESULTS));
+	}
+#endif
+
+#if defined (RING_BENCH)
+	if (RingBench_Initialize(&LockFreeRingBench) == XST_SUCCESS) {
+		RingBench_Report(RingBenchResults,
+				 RingBench_RunAll(&LockFreeRingBench,
+						  RingBenchResults,
+						  RING_BENCH_MAX_RESULTS));
+	}
+#endif
+
+#if defined (IRQ_BENCH)
+	if (IrqBench_Initialize(&IrqLatencyBench) == XST_SUCCESS) {
+		IrqBench_Report(IrqBenchResults,
+				IrqBench_RunAll(&IrqLatencyBench,
+						IrqBenchResults,
+						IRQ_BENCH_MAX_RESULTS));
+	}
+#endif
+
+#if defined (LAYOUT_BENCH)
+	if (LayoutBench_Initialize(&IsrLayoutBench) == XST_SUCCESS) {
+		LayoutBench_Report(LayoutBenchResults,
+				   LayoutBench_RunAll(&IsrLayoutBench,
+						      LayoutBenchResults,
+						      LAYOUT_BENCH_MAX_RESULTS));
+	}
+#endif
+
+#if defined (QOS_BENCH)
+	if (QosBench_Initialize(&DdrQosBench) == XST_SUCCESS) {
+		QosBench_Report(QosBenchResults,
+				QosBench_RunAll(&DdrQosBench,
+						QosBenchResults,
+						QOS_BENCH_MAX_RESULTS));
+	}
+#endif
+
+#if defined (UART_BERT)
+	if (UartBert_Initialize(&LinkBert) == XST_SUCCESS) {
+		UartBert_Report(BertResults,
+				UartBert_RunAll(&LinkBert, BertResults,
+						UART_BERT_MAX_RESULTS));
+	}
+#endif
+
+#if defined (SCHED_BENCH)
+	if (SchedBench_Initialize(&SchedPrimBench) == XST_SUCCESS) {
+		SchedBench_Report(SchedBenchResults,
+				  SchedBench_RunAll(&SchedPrimBench,
+						    SchedBenchResults,
+						    SCHED_BENCH_MAX_RESULTS));
+	}
+#endif
+
+	/*
+	 * Without the wheel the bridge runs without deadlines and the main
+	 * loop polls instead of sleeping
+	 */
+	Status = TimerWheel_Initialize(&BridgeWheel);
+	WheelPtr = (Status == XST_SUCCESS) ? &BridgeWheel : NULL;
+	(void)EventLoop_Initialize(&MainLoop, WheelPtr);
+	Status = Bridge_Initialize(&UsbBridge, BRIDGE_BAUDRATE, WheelPtr);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+#if defined (BRIDGE_COALESCE_US)
+	for (Dir = 0U; Dir < BRIDGE_NUM_DIRS; Dir++) {
+		(void)Bridge_SetCoalesce(&UsbBridge, Dir, BRIDGE_COALESCE_BYTES,
+					 BRIDGE_COALESCE_US);
+	}
+#endif
+
+#if defined (BRIDGE_TX_GAP_BITS)
+	(void)Bridge_SetTxGap(&UsbBridge, BRIDGE_DIR_HOST_TO_UART,
+			      BRIDGE_TX_GAP_BITS);
+#endif
+
+#if defined (THERMAL_GOV)
+	/* Without the profiles only the coalescing follows the temperature */
+	Status = ClkProfile_Initialize(&CpuClock);
+	(void)ThermalGov_Initialize(&Governor, (Status == XST_SUCCESS) ?
+				    &CpuClock : NULL, &UsbBridge);
+#endif
+
+#if defined (BRIDGE_BENCH)
+	(void)BridgeBench_Initialize(&LoadBench, &UsbBridge);
+#endif
+
+	Status = Bridge_Start(&UsbBridge);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+#if defined (SUSPEND)
+	/* Once the bridge has hooked up its interrupts, both UARTs wake it */
+	Status = Suspend_Initialize(&Sleeper);
+	for (Dir = 0U; (Status == XST_SUCCESS) && (Dir < BRIDGE_NUM_PORTS);
+	     Dir++) {
+		Status = Suspend_AddUart(&Sleeper, &UsbBridge.Port[Dir].Uart,
+					 1U);
+	}
+	if (Status == XST_SUCCESS) {
+		(void)EventLoop_SetHandler(&MainLoop, MAIN_EVENT_SUSPEND,
+					   MainSuspend, &Sleeper);
+	}
+#endif
+
+#if defined (PGO_GENERATE)
+	/* The profile is of the bridge, not of the boot and benchmarks */
+	Pgo_Reset();
+#endif
+
+#if defined (DEFERRED_PART)
+	DeferredPart_StartAll(&Deferred);
+#endif
+
+#if defined (METRICS)
+	MetricsRegister();
+#endif
+
+	(void)EventLoop_SetHandler(&MainLoop, MAIN_EVENT_SECOND, MainSecond,
+				   NULL);
+	(void)EventLoop_PostEvery(&MainLoop, MAIN_EVENT_SECOND,
+				  MAIN_SECOND_US);
+#if defined (EDF_SCHED)
+	/* Without the wheel the periodic jobs stay events of the loop */
+	Status = EdfSched_Initialize(&Periodic, &MainLoop, MAIN_EVENT_EDF);
+#endif
+#if defined (THERMAL_GOV) && defined (EDF_SCHED)
+	if (Status == XST_SUCCESS) {
+		(void)EdfSched_AddTask(&Periodic, &ThermalTask, "thermal",
+				       MainThermalStep, &Governor,
+				       EDF_SCHED_DEADLINE, MAIN_THERMAL_US, 0U,
+				       MAIN_THERMAL_BUDGET_US);
+	} else
+#endif
+#if defined (THERMAL_GOV)
+	{
+		(void)EventLoop_SetHandler(&MainLoop, MAIN_EVENT_THERMAL,
+					   MainThermal, &Governor);
+		(void)EventLoop_PostEvery(&MainLoop, MAIN_EVENT_THERMAL,
+					  MAIN_THERMAL_US);
+	}
+#endif
+#if defined (METRICS)
+	(void)EventLoop_SetHandler(&MainLoop, MAIN_EVENT_DCC_DRAIN,
+				   MainDccDrain, NULL);
+#endif
+#if defined (METRICS) && defined (EDF_SCHED)
+	if (Status == XST_SUCCESS) {
+		(void)EdfSched_AddTask(&Periodic, &MetricsTask, "metrics",
+				       MainMetricsStep, NULL,
+				       EDF_SCHED_DEADLINE,
+				       (u64)METRICS_PERIOD_MS * 1000U, 0U,
+				       MAIN_METRICS_BUDGET_US);
+	} else
+#endif
+#if defined (METRICS)
+	{
+		(void)EventLoop_SetHandler(&MainLoop, MAIN_EVENT_METRICS,
+					   MainMetrics, NULL);
+		(void)EventLoop_PostEvery(&MainLoop, MAIN_EVENT_METRICS,
+					  (u64)METRICS_PERIOD_MS * 1000U);
+	}
+#endif
+#if defined (EDF_SCHED)
+	EdfSched_Start(&Periodic);
+#endif
+#if defined (DEFERRED_PART)
+	(void)EventLoop_SetHandler(&MainLoop, MAIN_EVENT_DEFERRED,
+				   MainDeferred, &Deferred);
+	EventLoop_Post(&MainLoop, MAIN_EVENT_DEFERRED);
+#endif
+
+	EventLoop_Run(&MainLoop);
+
+	return XST_SUCCESS;
+}
@@ -0,0 +1,372 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file mem_bench.c
+*
+* Benchmark of the xil_mem.h primitives. Refer to mem_bench.h for what is
+* measured.
+*
+* The reference loops are built without loop distribution, so that the
+* compiler does not turn them back into library calls.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xstatus.h"
+#include "xil_printf.h"
+#include "xil_mem.h"
+#include "xpm_counter.h"
+#include "mem_bench.h"
+
+/************************** Constant Definitions ****************************/
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define MEM_BENCH_REF	__attribute__((noinline, \
+				optimize("no-tree-loop-distribute-patterns")))
+
+/************************** Function Prototypes *****************************/
+
+static u32 MemBench_ReadCycles(MemBench *BenchPtr);
+static u32 MemBench_Time(MemBench *BenchPtr, u32 Op, u32 Ref, u32 Bytes,
+			 u32 Misaligned);
+static void MemBench_RefCopy(void *DstPtr, const void *SrcPtr, u32 Count);
+static void MemBench_RefSet(void *DstPtr, u8 Value, u32 Count);
+static s32 MemBench_RefCompare(const void *Buf1Ptr, const void *Buf2Ptr,
+			       u32 Count);
+static u32 MemBench_RefSum(const u32 *SrcPtr, u32 Count);
+
+/************************** Variable Definitions ****************************/
+
+static const char *const MemBench_OpNames[MEM_BENCH_NUM_OPS] = {
+	"copy", "set", "compare", "sum"
+};
+
+static const u32 MemBench_Sizes[MEM_BENCH_NUM_SIZES] = {
+	16U, 64U, 256U, 1024U, 4096U, 16384U
+};
+
+/* One spare word for the misaligned source */
+static u32 MemBench_Src[(MEM_BENCH_MAX_BYTES / 4U) + 1U]
+	__attribute__((aligned(32)));
+static u32 MemBench_Dst[(MEM_BENCH_MAX_BYTES / 4U) + 1U]
+	__attribute__((aligned(32)));
+
+/* Sink of the compare and sum results */
+static volatile u32 MemBench_Sink;
+
+/****************************************************************************/
+/**
+*
+* Sets up the PMU cycle counter and the buffers.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if no PMU counter is free.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 MemBench_Initialize(MemBench *BenchPtr)
+{
+	u32 Index;
+
+	BenchPtr->CycleCounter = Xpm_SetUpAnEvent(XPM_EVENT_CLOCKCYCLES);
+	if (BenchPtr->CycleCounter == XPM_NO_COUNTERS_AVAILABLE) {
+		return XST_FAILURE;
+	}
+
+	for (Index = 0U; Index < ((MEM_BENCH_MAX_BYTES / 4U) + 1U); Index++) {
+		MemBench_Src[Index] = Index * 0x9E3779B9U;
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Times every primitive and its reference at every size, aligned and, for
+* the copy and the compare, misaligned.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	ResultsPtr is where the results are stored.
+* @param	MaxResults is the capacity of ResultsPtr.
+*
+* @return	The number of results stored.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 MemBench_RunAll(MemBench *BenchPtr, MemBench_Result *ResultsPtr,
+		    u32 MaxResults)
+{
+	MemBench_Result *ResultPtr;
+	u32 NumResults = 0U;
+	u32 Op;
+	u32 Size;
+	u32 Misaligned;
+
+	for (Op = 0U; Op < MEM_BENCH_NUM_OPS; Op++) {
+		for (Misaligned = 0U; Misaligned < 2U; Misaligned++) {
+			if ((Misaligned != 0U) && (Op != MEM_BENCH_OP_COPY) &&
+			    (Op != MEM_BENCH_OP_COMPARE)) {
+				continue;
+			}
+			for (Size = 0U; Size < MEM_BENCH_NUM_SIZES; Size++) {
+				if (NumResults == MaxResults) {
+					return NumResults;
+				}
+				ResultPtr = &ResultsPtr[NumResults];
+				ResultPtr->Op = Op;
+				ResultPtr->Bytes = MemBench_Sizes[Size];
+				ResultPtr->Misaligned = Misaligned;
+				ResultPtr->RefCycles =
+					MemBench_Time(BenchPtr, Op, 1U,
+						      ResultPtr->Bytes,
+						      Misaligned);
+				ResultPtr->Cycles =
+					MemBench_Time(BenchPtr, Op, 0U,
+						      ResultPtr->Bytes,
+						      Misaligned);
+				NumResults++;
+			}
+		}
+	}
+
+	return NumResults;
+}
+
+/****************************************************************************/
+/**
+*
+* Prints results on the standard output, with the speedup in tenths.
+*
+* @param	ResultsPtr is the results of MemBench_RunAll().
+* @param	NumResults is the number of results.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void MemBench_Report(const MemBench_Result *ResultsPtr, u32 NumResults)
+{
+	const MemBench_Result *ResultPtr;
+	u32 Speedup10;
+	u32 Index;
+
+	xil_printf("op\tbytes\talign\tref cyc\tcyc\tspeedup\r\n");
+
+	for (Index = 0U; Index < NumResults; Index++) {
+		ResultPtr = &ResultsPtr[Index];
+		Speedup10 = (ResultPtr->Cycles == 0U) ? 0U :
+			    ((ResultPtr->RefCycles * 10U) / ResultPtr->Cycles);
+		xil_printf("%s\t%u\t%s\t%u\t%u\t%u.%u\r\n",
+			   MemBench_OpNames[ResultPtr->Op], ResultPtr->Bytes,
+			   (ResultPtr->Misaligned != 0U) ? "+1" : "0",
+			   ResultPtr->RefCycles, ResultPtr->Cycles,
+			   Speedup10 / 10U, Speedup10 % 10U);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Reads the PMU cycle counter.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return	The counter value, wrapping at 2^32.
+*
+*****************************************************************************/
+static u32 MemBench_ReadCycles(MemBench *BenchPtr)
+{
+	u32 Value = 0U;
+
+	(void)Xpm_GetEventCounter(BenchPtr->CycleCounter, &Value);
+
+	return Value;
+}
+
+/****************************************************************************/
+/*
+*
+* Times one primitive, or its reference, at one size. The first call warms
+* the caches and is not counted.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	Op is one of the MEM_BENCH_OP_* values.
+* @param	Ref selects the reference loop.
+* @param	Bytes is the buffer size.
+* @param	Misaligned misaligns the source by one byte.
+*
+* @return	The fewest cycles of MEM_BENCH_REPEAT calls.
+*
+*****************************************************************************/
+static u32 MemBench_Time(MemBench *BenchPtr, u32 Op, u32 Ref, u32 Bytes,
+			 u32 Misaligned)
+{
+	const u8 *SrcPtr = (const u8 *)MemBench_Src + Misaligned;
+	u8 *DstPtr = (u8 *)MemBench_Dst;
+	u32 Best = 0xFFFFFFFFU;
+	u32 Start;
+	u32 Cycles;
+	u32 Call;
+
+	/* Equal buffers, so that the compare runs to the end */
+	if (Op == MEM_BENCH_OP_COMPARE) {
+		Xil_MemCpy(DstPtr, SrcPtr, Bytes);
+	}
+
+	for (Call = 0U; Call <= MEM_BENCH_REPEAT; Call++) {
+		Start = MemBench_ReadCycles(BenchPtr);
+		switch (Op) {
+		case MEM_BENCH_OP_COPY:
+			if (Ref != 0U) {
+				MemBench_RefCopy(DstPtr, SrcPtr, Bytes);
+			} else {
+				Xil_MemCpy(DstPtr, SrcPtr, Bytes);
+			}
+			break;
+		case MEM_BENCH_OP_SET:
+			if (Ref != 0U) {
+				MemBench_RefSet(DstPtr, 0U, Bytes);
+			} else {
+				Xil_MemSet(DstPtr, 0U, Bytes);
+			}
+			break;
+		case MEM_BENCH_OP_COMPARE:
+			MemBench_Sink = (Ref != 0U) ?
+				(u32)MemBench_RefCompare(DstPtr, SrcPtr,
+							 Bytes) :
+				(u32)Xil_MemCompare(DstPtr, SrcPtr, Bytes);
+			break;
+		default:
+			MemBench_Sink = (Ref != 0U) ?
+				MemBench_RefSum(MemBench_Src, Bytes / 4U) :
+				Xil_MemSum32(MemBench_Src, Bytes / 4U);
+			break;
+		}
+		Cycles = MemBench_ReadCycles(BenchPtr) - Start;
+		if ((Call != 0U) && (Cycles < Best)) {
+			Best = Cycles;
+		}
+	}
+
+	return Best;
+}
+
+/****************************************************************************/
+/*
+*
+* The previous Xil_MemCpy(): words, halfwords, then bytes, whatever the
+* alignment.
+*
+*****************************************************************************/
+MEM_BENCH_REF
+static void MemBench_RefCopy(void *DstPtr, const void *SrcPtr, u32 Count)
+{
+	char *d = (char *)DstPtr;
+	const char *s = SrcPtr;
+
+	while (Count >= sizeof(s32)) {
+		*(s32 *)(void *)d = *(const s32 *)(const void *)s;
+		d += sizeof(s32);
+		s += sizeof(s32);
+		Count -= sizeof(s32);
+	}
+	while (Count >= sizeof(u16)) {
+		*(u16 *)(void *)d = *(const u16 *)(const void *)s;
+		d += sizeof(u16);
+		s += sizeof(u16);
+		Count -= sizeof(u16);
+	}
+	while (Count > 0U) {
+		*d = *s;
+		d += 1U;
+		s += 1U;
+		Count -= 1U;
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* MD5Memset() of the FSBL: a byte loop.
+*
+*****************************************************************************/
+MEM_BENCH_REF
+static void MemBench_RefSet(void *DstPtr, u8 Value, u32 Count)
+{
+	u8 *d = (u8 *)DstPtr;
+
+	while (Count > 0U) {
+		*d = Value;
+		d += 1U;
+		Count -= 1U;
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* The previous Xil_MemCmp(): a byte loop.
+*
+*****************************************************************************/
+MEM_BENCH_REF
+static s32 MemBench_RefCompare(const void *Buf1Ptr, const void *Buf2Ptr,
+			       u32 Count)
+{
+	const u8 *Buf1 = Buf1Ptr;
+	const u8 *Buf2 = Buf2Ptr;
+
+	while (Count != 0U) {
+		if (*Buf1 > *Buf2) {
+			return 1;
+		} else if (*Buf1 < *Buf2) {
+			return -1;
+		} else {
+			Buf1++;
+			Buf2++;
+			Count--;
+		}
+	}
+
+	return 0;
+}
+
+/****************************************************************************/
+/*
+*
+* The sum of HeaderChecksum(): a word loop.
+*
+*****************************************************************************/
+MEM_BENCH_REF
+static u32 MemBench_RefSum(const u32 *SrcPtr, u32 Count)
+{
+	u32 Sum = 0U;
+
+	while (Count > 0U) {
+		Sum += *SrcPtr;
+		SrcPtr++;
+		Count--;
+	}
+
+	return Sum;
+}
@@ -0,0 +1,93 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file mem_bench.h
+*
+* Cycle counts of the memory primitives of xil_mem.h against the byte loops
+* they replace.
+*
+* Each primitive is timed with the PMU cycle counter on cached buffers of
+* MEM_BENCH_NUM_SIZES sizes, with the buffers word aligned and, for the copy
+* and the compare, with the source misaligned by one byte. The compare is
+* run on equal buffers, which is the worst case. The reference versions are
+* the loops of the previous Xil_MemCpy(), Xil_MemCmp(), MD5Memset() and
+* HeaderChecksum(). A result keeps the fastest of MEM_BENCH_REPEAT calls.
+*
+* The benchmark is built into the application when MEM_BENCH is defined.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef MEM_BENCH_H
+#define MEM_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions ****************************/
+
+/** @name Primitives
+ * @{
+ */
+#define MEM_BENCH_OP_COPY	0U	/**< Xil_MemCpy() */
+#define MEM_BENCH_OP_SET	1U	/**< Xil_MemSet() */
+#define MEM_BENCH_OP_COMPARE	2U	/**< Xil_MemCompare() */
+#define MEM_BENCH_OP_SUM	3U	/**< Xil_MemSum32() */
+#define MEM_BENCH_NUM_OPS	4U
+/* @} */
+
+#define MEM_BENCH_MAX_BYTES	16384U	/**< Largest buffer */
+#define MEM_BENCH_NUM_SIZES	6U	/**< Buffer sizes, 16 bytes and up */
+#define MEM_BENCH_REPEAT	8U	/**< Calls per result */
+
+/** Results of a full suite, aligned and misaligned */
+#define MEM_BENCH_MAX_RESULTS	(MEM_BENCH_NUM_OPS * MEM_BENCH_NUM_SIZES * 2U)
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Result of one primitive at one size.
+ */
+typedef struct {
+	u32 Op;			/**< One of the MEM_BENCH_OP_* values */
+	u32 Bytes;		/**< Buffer size */
+	u32 Misaligned;		/**< Source misaligned by one byte */
+	u32 RefCycles;		/**< Cycles of the byte loop */
+	u32 Cycles;		/**< Cycles of the primitive */
+} MemBench_Result;
+
+/**
+ * State of the benchmark.
+ */
+typedef struct {
+	u32 CycleCounter;	/**< PMU counter counting CPU cycles */
+} MemBench;
+
+/************************** Function Prototypes *****************************/
+
+s32 MemBench_Initialize(MemBench *BenchPtr);
+u32 MemBench_RunAll(MemBench *BenchPtr, MemBench_Result *ResultsPtr,
+		    u32 MaxResults);
+void MemBench_Report(const MemBench_Result *ResultsPtr, u32 NumResults);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MEM_BENCH_H */
@@ -0,0 +1,352 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file mem_region.c
+*
+* Arena allocator over the memories of the linker script. Refer to
+* mem_region.h for how it is used.
+*
+* The free pointer of an arena is moved with LDREX/STREX on its descriptor,
+* which lives in cacheable DDR whatever the memory of the arena, so that
+* the exclusive accesses work between the CPUs.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Added the acp arena.
+*       qm     10/14/26 Added MemRegion_CreateHeap().
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "xpseudo_asm.h"
+#include "mem_region.h"
+
+/************************** Constant Definitions ****************************/
+
+/**************************** Type Definitions ******************************/
+
+typedef struct {
+	const char *Name;
+	UINTPTR BaseAddr;
+	UINTPTR EndAddr;	/* First byte after the arena */
+	volatile UINTPTR NextAddr; /* First free byte */
+	volatile u32 HighWater;
+	volatile u32 Failures;
+} MemRegion;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static u32 MemRegion_Swap(volatile UINTPTR *Addr, UINTPTR Old, UINTPTR New);
+
+/************************** Variable Definitions ****************************/
+
+/* Arenas, from the linker script */
+extern u8 _ddr_arena_start[];
+extern u8 _ddr_arena_end[];
+extern u8 _ocm_arena_start[];
+extern u8 _ocm_arena_end[];
+extern u8 _ocm_low_arena_start[];
+extern u8 _ocm_low_arena_end[];
+extern u8 _bram0_arena_start[];
+extern u8 _bram0_arena_end[];
+extern u8 _bram1_arena_start[];
+extern u8 _bram1_arena_end[];
+extern u8 _acp_arena_start[];
+extern u8 _acp_arena_end[];
+
+static MemRegion Region[MEM_REGION_NUM];
+
+/****************************************************************************/
+/**
+*
+* Sets up the arenas from the linker script, all empty.
+*
+* @return	None.
+*
+* @note		Call it once at startup, before the other CPU is started.
+*
+*****************************************************************************/
+void MemRegion_Initialize(void)
+{
+	static const struct {
+		const char *Name;
+		u8 *Start;
+		u8 *End;
+	} Layout[MEM_REGION_NUM] = {
+		{ "ddr", _ddr_arena_start, _ddr_arena_end },
+		{ "ocm", _ocm_arena_start, _ocm_arena_end },
+		{ "ocm_low", _ocm_low_arena_start, _ocm_low_arena_end },
+		{ "bram0", _bram0_arena_start, _bram0_arena_end },
+		{ "bram1", _bram1_arena_start, _bram1_arena_end },
+		{ "acp", _acp_arena_start, _acp_arena_end },
+	};
+	u32 Index;
+
+	for (Index = 0U; Index < (u32)MEM_REGION_NUM; Index++) {
+		Region[Index].Name = Layout[Index].Name;
+		Region[Index].BaseAddr = (UINTPTR)Layout[Index].Start;
+		Region[Index].EndAddr = (UINTPTR)Layout[Index].End;
+		Region[Index].NextAddr = Region[Index].BaseAddr;
+		Region[Index].HighWater = 0U;
+		Region[Index].Failures = 0U;
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Allocates bytes from an arena. It may be called from both CPUs and from
+* interrupt handlers.
+*
+* @param	Id is the arena.
+* @param	Size is the number of bytes.
+* @param	Align is the alignment, a power of two, raised to
+*		MEM_REGION_MIN_ALIGN. Use 32 for buffers of their own cache
+*		lines.
+*
+* @return	The bytes, or NULL if the arena has no room left.
+*
+*****************************************************************************/
+void *MemRegion_Alloc(MemRegion_Id Id, u32 Size, u32 Align)
+{
+	MemRegion *RegionPtr;
+	UINTPTR Next;
+	UINTPTR Addr;
+	u32 Used;
+	u32 HighWater;
+
+	if ((u32)Id >= (u32)MEM_REGION_NUM) {
+		return NULL;
+	}
+	RegionPtr = &Region[Id];
+	if (Align < MEM_REGION_MIN_ALIGN) {
+		Align = MEM_REGION_MIN_ALIGN;
+	}
+	Size = (Size + (MEM_REGION_MIN_ALIGN - 1U)) &
+	       ~(MEM_REGION_MIN_ALIGN - 1U);
+
+	do {
+		Next = RegionPtr->NextAddr;
+		Addr = (Next + (Align - 1U)) & ~(UINTPTR)(Align - 1U);
+		if ((Addr < Next) || (Addr > RegionPtr->EndAddr) ||
+		    (Size > (RegionPtr->EndAddr - Addr))) {
+			RegionPtr->Failures++;
+			return NULL;
+		}
+	} while (MemRegion_Swap(&RegionPtr->NextAddr, Next, Addr + Size) == 0U);
+
+	/* Only ever raised, a lost race leaves it a little low */
+	Used = (u32)((Addr + Size) - RegionPtr->BaseAddr);
+	HighWater = RegionPtr->HighWater;
+	if (Used > HighWater) {
+		RegionPtr->HighWater = Used;
+	}
+
+	return (void *)Addr;
+}
+
+/****************************************************************************/
+/**
+*
+* Finds an arena by name.
+*
+* @param	Name is the name, as "ocm".
+*
+* @return	The MemRegion_Id, or MEM_REGION_NONE.
+*
+*****************************************************************************/
+u32 MemRegion_Find(const char *Name)
+{
+	u32 Index;
+
+	for (Index = 0U; Index < (u32)MEM_REGION_NUM; Index++) {
+		if ((Region[Index].Name != NULL) &&
+		    (strcmp(Region[Index].Name, Name) == 0)) {
+			return Index;
+		}
+	}
+
+	return MEM_REGION_NONE;
+}
+
+/****************************************************************************/
+/**
+*
+* Gives the bytes an arena has left.
+*
+* @param	Id is the arena.
+*
+* @return	The free bytes, before any alignment.
+*
+*****************************************************************************/
+u32 MemRegion_Remaining(MemRegion_Id Id)
+{
+	if ((u32)Id >= (u32)MEM_REGION_NUM) {
+		return 0U;
+	}
+
+	return (u32)(Region[Id].EndAddr - Region[Id].NextAddr);
+}
+
+/****************************************************************************/
+/**
+*
+* Empties an arena, everything allocated from it is given back.
+*
+* @param	Id is the arena.
+*
+* @return	None.
+*
+* @note		No context may still use memory from the arena.
+*
+*****************************************************************************/
+void MemRegion_Reset(MemRegion_Id Id)
+{
+	if ((u32)Id < (u32)MEM_REGION_NUM) {
+		Region[Id].NextAddr = Region[Id].BaseAddr;
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Opens a scope on an arena.
+*
+* @param	Id is the arena.
+*
+* @return	The scope, to be given to MemRegion_EndScope().
+*
+*****************************************************************************/
+MemRegion_Scope MemRegion_BeginScope(MemRegion_Id Id)
+{
+	MemRegion_Scope Scope;
+
+	Scope.Id = Id;
+	Scope.Mark = ((u32)Id < (u32)MEM_REGION_NUM) ?
+		     Region[Id].NextAddr : 0U;
+
+	return Scope;
+}
+
+/****************************************************************************/
+/**
+*
+* Closes a scope, everything allocated from its arena since it was opened
+* is given back.
+*
+* @param	ScopePtr is the scope.
+*
+* @return	None.
+*
+*****************************************************************************/
+void MemRegion_EndScope(MemRegion_Scope *ScopePtr)
+{
+	MemRegion *RegionPtr;
+
+	if ((u32)ScopePtr->Id >= (u32)MEM_REGION_NUM) {
+		return;
+	}
+	RegionPtr = &Region[ScopePtr->Id];
+
+	/* An arena reset within the scope stays reset */
+	if (RegionPtr->NextAddr > ScopePtr->Mark) {
+		RegionPtr->NextAddr = ScopePtr->Mark;
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Gives the use of an arena.
+*
+* @param	Id is the arena.
+* @param	StatsPtr is where the use is returned.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM if there is no such arena.
+*
+*****************************************************************************/
+s32 MemRegion_GetStats(MemRegion_Id Id, MemRegion_Stats *StatsPtr)
+{
+	const MemRegion *RegionPtr;
+
+	if ((u32)Id >= (u32)MEM_REGION_NUM) {
+		return XST_INVALID_PARAM;
+	}
+	RegionPtr = &Region[Id];
+
+	StatsPtr->Name = RegionPtr->Name;
+	StatsPtr->BaseAddr = RegionPtr->BaseAddr;
+	StatsPtr->Size = (u32)(RegionPtr->EndAddr - RegionPtr->BaseAddr);
+	StatsPtr->Used = (u32)(RegionPtr->NextAddr - RegionPtr->BaseAddr);
+	StatsPtr->HighWater = RegionPtr->HighWater;
+	StatsPtr->Failures = RegionPtr->Failures;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Sets up a TLSF heap over bytes taken from an arena.
+*
+* @param	TlsfPtr is the heap.
+* @param	Id is the arena.
+* @param	Size is the bytes of the heap, headers included.
+*
+* @return	XST_SUCCESS, XST_INVALID_PARAM if there is no such arena or
+*		the size is too small for a heap, or XST_FAILURE if it does
+*		not fit in the arena.
+*
+*****************************************************************************/
+s32 MemRegion_CreateHeap(Xil_Tlsf *TlsfPtr, MemRegion_Id Id, u32 Size)
+{
+	void *MemPtr;
+
+	if ((u32)Id >= (u32)MEM_REGION_NUM) {
+		return XST_INVALID_PARAM;
+	}
+
+	MemPtr = MemRegion_Alloc(Id, Size, 32U);
+	if (MemPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	return Xil_TlsfInitialize(TlsfPtr, MemPtr, Size);
+}
+
+/****************************************************************************/
+/**
+*
+* Replaces a free pointer if it still holds the expected value, with
+* LDREX/STREX.
+*
+* @param	Addr is the free pointer.
+* @param	Old is the expected value.
+* @param	New is the new value.
+*
+* @return	1 if it was replaced, 0 otherwise.
+*
+*****************************************************************************/
+static u32 MemRegion_Swap(volatile UINTPTR *Addr, UINTPTR Old, UINTPTR New)
+{
+	if (ldrex(Addr) != Old) {
+		clrex();
+		return 0U;
+	}
+
+	return (strex(Addr, New) == 0U) ? 1U : 0U;
+}
@@ -0,0 +1,143 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file mem_region.h
+*
+* Allocation from a chosen memory of the board.
+*
+* The linker script gives each memory a named arena, the part of it the
+* image does not use:
+*
+* - "ddr", _DDR_ARENA_SIZE bytes of DDR, cacheable.
+* - "ocm", the high OCM after the .ocm hot path section, inner cacheable,
+*   the lowest latency memory of the PS.
+* - "ocm_low", the 192 KB of low OCM at address 0 after the fast sections
+*   and the overlay window of xil_hotpath.h, cacheable.
+*
+*   An image linked with --defsym=_OCM_HIGH=1 has all the OCM remapped
+*   into one block at 0xFFFC0000, refer to xil_hotpath.h: "ocm" is then
+*   what the OCM sections leave of it, about 250 KB in one piece less
+*   the hot path, the fast sections and the overlays, and "ocm_low" is
+*   empty.
+* - "bram0" and "bram1", the PL block RAMs behind axi_bram_ctrl_0 and
+*   axi_bram_ctrl_1. The BSP maps the PL strongly ordered, so they take
+*   aligned accesses only and no memcpy() with odd sizes; they can be
+*   mapped normal non-cacheable with Xil_SetTlbAttributes() for write
+*   combining. The bitstream must be loaded before they are touched.
+* - "acp", _ACP_ARENA_SIZE bytes of DDR in whole 1 MB sections, mapped by
+*   Xil_AcpInitialize(): cacheable, and coherent with the masters of the
+*   PL that go through the ACP, refer to xil_acp.h. A buffer for such a
+*   master taken from it needs no cache maintenance; one for the PL330 or
+*   an HP port still does.
+*
+* MemRegion_Alloc() takes aligned bytes off the bottom of an arena with a
+* bump of its free pointer, lock-free so that both CPUs and the interrupt
+* handlers can allocate. Nothing is freed on its own: MemRegion_Reset()
+* empties an arena, and a scope gives back everything allocated since it
+* was opened, MemRegion_BeginScope() and MemRegion_EndScope(), or for the
+* rest of a block with MEM_REGION_SCOPED(). Scopes nest, each must be
+* closed by the context that opened it and no other context may allocate
+* from the arena while it is open.
+*
+* For blocks of any size that are freed one by one, MemRegion_CreateHeap()
+* sets up a TLSF heap of xil_tlsf.h over a part of an arena, with O(1)
+* allocation and free. Its memory is given back with the arena or scope it
+* was taken from, the heap then must not be used any more.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Added the acp arena.
+*       qm     10/14/26 Added MemRegion_CreateHeap().
+*       qm     10/14/26 Documented the arenas of the OCM remapped high.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef MEM_REGION_H
+#define MEM_REGION_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xil_tlsf.h"
+
+/************************** Constant Definitions ****************************/
+
+#define MEM_REGION_MIN_ALIGN	4U	/**< Alignment of every allocation */
+#define MEM_REGION_NONE		0xFFFFFFFFU /**< No arena of that name */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * The arenas, one per memory.
+ */
+typedef enum {
+	MEM_REGION_DDR = 0,
+	MEM_REGION_OCM,
+	MEM_REGION_OCM_LOW,
+	MEM_REGION_BRAM0,
+	MEM_REGION_BRAM1,
+	MEM_REGION_ACP,
+	MEM_REGION_NUM
+} MemRegion_Id;
+
+/**
+ * Use of an arena.
+ */
+typedef struct {
+	const char *Name;
+	UINTPTR BaseAddr;	/**< First byte of the arena */
+	u32 Size;		/**< Bytes of the arena */
+	u32 Used;		/**< Bytes allocated now */
+	u32 HighWater;		/**< Most bytes allocated */
+	u32 Failures;		/**< Allocations that did not fit */
+} MemRegion_Stats;
+
+/**
+ * An open scope.
+ */
+typedef struct {
+	MemRegion_Id Id;
+	UINTPTR Mark;		/**< Free pointer when it was opened */
+} MemRegion_Scope;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/**
+ * Opens a scope on an arena that is closed when the enclosing block is
+ * left, by any path.
+ */
+#define MEM_REGION_SCOPED(ScopeName, Id) \
+	MemRegion_Scope ScopeName \
+	__attribute__((cleanup(MemRegion_EndScope))) = \
+	MemRegion_BeginScope(Id)
+
+/************************** Function Prototypes *****************************/
+
+void MemRegion_Initialize(void);
+void *MemRegion_Alloc(MemRegion_Id Id, u32 Size, u32 Align);
+u32 MemRegion_Find(const char *Name);
+u32 MemRegion_Remaining(MemRegion_Id Id);
+void MemRegion_Reset(MemRegion_Id Id);
+MemRegion_Scope MemRegion_BeginScope(MemRegion_Id Id);
+void MemRegion_EndScope(MemRegion_Scope *ScopePtr);
+s32 MemRegion_GetStats(MemRegion_Id Id, MemRegion_Stats *StatsPtr);
+s32 MemRegion_CreateHeap(Xil_Tlsf *TlsfPtr, MemRegion_Id Id, u32 Size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MEM_REGION_H */
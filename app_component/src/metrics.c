@@ -0,0 +1,537 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file metrics.c
+*
+* Metrics registry and exporter. Refer to metrics.h for the frames.
+*
+* A frame is built into the payload buffer metric by metric, each reading
+* its value into Pending. The values only become the ones the next frame
+* is relative to, Sent, once the sink takes the frame. A metric that does
+* not fit ends the frame, the metrics after it going in the next one.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "uart_frame.h"
+#include "metrics.h"
+
+/************************** Constant Definitions ****************************/
+
+#define METRICS_HEADER_SIZE	6U	/* Type, sequence, time */
+#define METRICS_VARINT_MAX	10U	/* Bytes of a u64 varint */
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static s32 Metrics_Add(Metrics *RegPtr, const char *Name, u32 Type,
+		       const volatile void *ValuePtr, Metrics_ReadFn ReadFn,
+		       void *Ref);
+static void Metrics_Begin(Metrics *RegPtr, u32 Type);
+static u32 Metrics_PutVarint(Metrics *RegPtr, u64 Value);
+static u32 Metrics_PutEntry(Metrics *RegPtr, Metrics_Entry *EntryPtr,
+			    u32 Index, u32 Key);
+static u32 Metrics_PutNames(Metrics *RegPtr);
+static s32 Metrics_Send(Metrics *RegPtr);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* Initializes an empty registry.
+*
+* @param	RegPtr is a pointer to the registry.
+* @param	SinkFn takes the frames.
+* @param	SinkRef is the first argument of SinkFn.
+* @param	PeriodMs is the time between two frames of Metrics_Poll().
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM without a sink or period.
+*
+*****************************************************************************/
+s32 Metrics_Initialize(Metrics *RegPtr, Metrics_SinkFn SinkFn, void *SinkRef,
+		       u32 PeriodMs)
+{
+	if ((SinkFn == NULL) || (PeriodMs == 0U)) {
+		return XST_INVALID_PARAM;
+	}
+
+	(void)memset(RegPtr, 0, sizeof(*RegPtr));
+	RegPtr->SinkFn = SinkFn;
+	RegPtr->SinkRef = SinkRef;
+	RegPtr->PeriodCounts = ((XTime)PeriodMs * COUNTS_PER_SECOND) / 1000U;
+	XTime_GetTime(&RegPtr->Last);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Registers a 32-bit counter, exported as its increments.
+*
+* @param	RegPtr is a pointer to the registry.
+* @param	Name is the name of the metric, kept by address.
+* @param	ValuePtr is the counter.
+*
+* @return	XST_SUCCESS, or XST_BUFFER_TOO_SMALL if the registry is full.
+*
+*****************************************************************************/
+s32 Metrics_AddCounter(Metrics *RegPtr, const char *Name,
+		       const volatile u32 *ValuePtr)
+{
+	return Metrics_Add(RegPtr, Name, METRICS_COUNTER, ValuePtr, NULL,
+			   NULL);
+}
+
+/****************************************************************************/
+/**
+*
+* Registers a 64-bit counter, exported as its increments.
+*
+* @param	RegPtr is a pointer to the registry.
+* @param	Name is the name of the metric, kept by address.
+* @param	ValuePtr is the counter.
+*
+* @return	XST_SUCCESS, or XST_BUFFER_TOO_SMALL if the registry is full.
+*
+*****************************************************************************/
+s32 Metrics_AddCounter64(Metrics *RegPtr, const char *Name,
+			 const volatile u64 *ValuePtr)
+{
+	return Metrics_Add(RegPtr, Name, METRICS_COUNTER64, ValuePtr, NULL,
+			   NULL);
+}
+
+/****************************************************************************/
+/**
+*
+* Registers a gauge, exported as its value when it changed.
+*
+* @param	RegPtr is a pointer to the registry.
+* @param	Name is the name of the metric, kept by address.
+* @param	ValuePtr is the variable.
+*
+* @return	XST_SUCCESS, or XST_BUFFER_TOO_SMALL if the registry is full.
+*
+*****************************************************************************/
+s32 Metrics_AddGauge(Metrics *RegPtr, const char *Name,
+		     const volatile s32 *ValuePtr)
+{
+	return Metrics_Add(RegPtr, Name, METRICS_GAUGE, ValuePtr, NULL, NULL);
+}
+
+/****************************************************************************/
+/**
+*
+* Registers a gauge read by a function at each frame.
+*
+* @param	RegPtr is a pointer to the registry.
+* @param	Name is the name of the metric, kept by address.
+* @param	ReadFn returns the value.
+* @param	Ref is the argument of ReadFn.
+*
+* @return	XST_SUCCESS, XST_INVALID_PARAM without a function, or
+*		XST_BUFFER_TOO_SMALL if the registry is full.
+*
+*****************************************************************************/
+s32 Metrics_AddGaugeFn(Metrics *RegPtr, const char *Name,
+		       Metrics_ReadFn ReadFn, void *Ref)
+{
+	if (ReadFn == NULL) {
+		return XST_INVALID_PARAM;
+	}
+
+	return Metrics_Add(RegPtr, Name, METRICS_GAUGE_FN, NULL, ReadFn, Ref);
+}
+
+/****************************************************************************/
+/**
+*
+* Clears a histogram and registers it.
+*
+* @param	RegPtr is a pointer to the registry.
+* @param	Name is the name of the metric, kept by address.
+* @param	HistPtr is the histogram.
+* @param	Shift sets the first bucket to the values below 2^Shift.
+*
+* @return	XST_SUCCESS, XST_INVALID_PARAM if Shift is above 31, or
+*		XST_BUFFER_TOO_SMALL if the registry is full.
+*
+*****************************************************************************/
+s32 Metrics_AddHistogram(Metrics *RegPtr, const char *Name,
+			 Metrics_Histogram *HistPtr, u32 Shift)
+{
+	if (Shift > 31U) {
+		return XST_INVALID_PARAM;
+	}
+
+	(void)memset(HistPtr, 0, sizeof(*HistPtr));
+	HistPtr->Shift = Shift;
+
+	return Metrics_Add(RegPtr, Name, METRICS_HISTOGRAM, HistPtr, NULL,
+			   NULL);
+}
+
+/****************************************************************************/
+/**
+*
+* Counts a value in its bucket.
+*
+* @param	HistPtr is the histogram.
+* @param	Value is the value.
+*
+* @return	None.
+*
+*****************************************************************************/
+void Metrics_HistogramAdd(Metrics_Histogram *HistPtr, u32 Value)
+{
+	u32 Bucket = 0U;
+	u32 High = Value >> HistPtr->Shift;
+
+	if (High != 0U) {
+		Bucket = 32U - (u32)__builtin_clz(High);
+		if (Bucket >= METRICS_HIST_BUCKETS) {
+			Bucket = METRICS_HIST_BUCKETS - 1U;
+		}
+	}
+
+	HistPtr->Bucket[Bucket]++;
+}
+
+/****************************************************************************/
+/**
+*
+* Exports a frame once the period since the last one is over. To be called
+* from the main loop.
+*
+* @param	RegPtr is a pointer to the registry.
+*
+* @return	XST_NO_DATA if no frame is due, as Metrics_Export()
+*		otherwise.
+*
+*****************************************************************************/
+s32 Metrics_Poll(Metrics *RegPtr)
+{
+	XTime Now;
+
+	XTime_GetTime(&Now);
+	if ((Now - RegPtr->Last) < RegPtr->PeriodCounts) {
+		return XST_NO_DATA;
+	}
+	RegPtr->Last = Now;
+
+	return Metrics_Export(RegPtr);
+}
+
+/****************************************************************************/
+/**
+*
+* Exports a frame now: a data frame, or a names and a key frame every
+* METRICS_KEY_EVERY frames.
+*
+* @param	RegPtr is a pointer to the registry.
+*
+* @return	XST_SUCCESS if the sink took the frame, XST_DEVICE_BUSY if
+*		it refused it.
+*
+*****************************************************************************/
+s32 Metrics_Export(Metrics *RegPtr)
+{
+	u32 Key = (RegPtr->SinceKey == 0U) ? 1U : 0U;
+	XTime Start;
+	XTime End;
+	u32 Count;
+	u32 Index;
+	s32 Status;
+
+	XTime_GetTime(&Start);
+
+	if (Key != 0U) {
+		Count = Metrics_PutNames(RegPtr);
+		if (Metrics_Send(RegPtr) == XST_SUCCESS) {
+			RegPtr->NameIndex = (RegPtr->NameIndex + Count <
+					     RegPtr->Count) ?
+					    RegPtr->NameIndex + Count : 0U;
+		}
+	}
+
+	Metrics_Begin(RegPtr, (Key != 0U) ? METRICS_FRAME_KEY :
+		      METRICS_FRAME_DATA);
+	for (Count = 0U; Count < RegPtr->Count; Count++) {
+		if (Metrics_PutEntry(RegPtr, &RegPtr->Entry[Count], Count,
+				     Key) == 0U) {
+			break;
+		}
+	}
+
+	Status = Metrics_Send(RegPtr);
+	if (Status == XST_SUCCESS) {
+		for (Index = 0U; Index < Count; Index++) {
+			Metrics_Entry *EntryPtr = &RegPtr->Entry[Index];
+			Metrics_Histogram *HistPtr;
+
+			EntryPtr->Sent = EntryPtr->Pending;
+			if (EntryPtr->Type == METRICS_HISTOGRAM) {
+				HistPtr = (Metrics_Histogram *)
+					  EntryPtr->ValuePtr;
+				(void)memcpy(HistPtr->Sent, HistPtr->Pending,
+					     sizeof(HistPtr->Sent));
+			}
+		}
+		RegPtr->SinceKey = (RegPtr->SinceKey + 1U) % METRICS_KEY_EVERY;
+	}
+
+	XTime_GetTime(&End);
+	RegPtr->Stats.BusyCounts += End - Start;
+
+	return Status;
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the counts of the exporter.
+*
+* @param	RegPtr is a pointer to the registry.
+* @param	StatsPtr is where the counts are returned.
+*
+* @return	None.
+*
+*****************************************************************************/
+void Metrics_GetStats(const Metrics *RegPtr, Metrics_Stats *StatsPtr)
+{
+	*StatsPtr = RegPtr->Stats;
+}
+
+/*
+ * Adds a metric to the registry.
+ */
+static s32 Metrics_Add(Metrics *RegPtr, const char *Name, u32 Type,
+		       const volatile void *ValuePtr, Metrics_ReadFn ReadFn,
+		       void *Ref)
+{
+	Metrics_Entry *EntryPtr;
+
+	if (RegPtr->Count >= METRICS_MAX) {
+		return XST_BUFFER_TOO_SMALL;
+	}
+
+	EntryPtr = &RegPtr->Entry[RegPtr->Count];
+	(void)memset(EntryPtr, 0, sizeof(*EntryPtr));
+	EntryPtr->Name = Name;
+	EntryPtr->Type = Type;
+	EntryPtr->ValuePtr = ValuePtr;
+	EntryPtr->ReadFn = ReadFn;
+	EntryPtr->Ref = Ref;
+	RegPtr->Count++;
+
+	return XST_SUCCESS;
+}
+
+/*
+ * Starts the payload of a frame with its header.
+ */
+static void Metrics_Begin(Metrics *RegPtr, u32 Type)
+{
+	XTime Now;
+	u32 Ms;
+
+	XTime_GetTime(&Now);
+	Ms = (u32)(Now / (COUNTS_PER_SECOND / 1000U));
+
+	RegPtr->Payload[0] = (u8)Type;
+	RegPtr->Payload[1] = (u8)RegPtr->Seq;
+	RegPtr->Payload[2] = (u8)Ms;
+	RegPtr->Payload[3] = (u8)(Ms >> 8);
+	RegPtr->Payload[4] = (u8)(Ms >> 16);
+	RegPtr->Payload[5] = (u8)(Ms >> 24);
+	RegPtr->Length = METRICS_HEADER_SIZE;
+}
+
+/*
+ * Adds a LEB128 varint to the payload. Returns 0 if it does not fit.
+ */
+static u32 Metrics_PutVarint(Metrics *RegPtr, u64 Value)
+{
+	do {
+		if (RegPtr->Length >= METRICS_MAX_PAYLOAD) {
+			return 0U;
+		}
+		RegPtr->Payload[RegPtr->Length] = (u8)(Value & 0x7FU);
+		Value >>= 7;
+		if (Value != 0U) {
+			RegPtr->Payload[RegPtr->Length] |= 0x80U;
+		}
+		RegPtr->Length++;
+	} while (Value != 0U);
+
+	return 1U;
+}
+
+/*
+ * Reads a metric and adds it to the payload, if it changed or in a key
+ * frame. Returns 0 if it does not fit, the payload left as it was.
+ */
+static u32 Metrics_PutEntry(Metrics *RegPtr, Metrics_Entry *EntryPtr,
+			    u32 Index, u32 Key)
+{
+	Metrics_Histogram *HistPtr = NULL;
+	u32 Mark = RegPtr->Length;
+	u32 Mask = 0U;
+	u32 Fits;
+	u32 Bucket;
+	u64 Value = 0U;
+	s64 Gauge;
+	u32 Cpsr;
+
+	switch (EntryPtr->Type) {
+	case METRICS_COUNTER:
+		EntryPtr->Pending = *(const volatile u32 *)EntryPtr->ValuePtr;
+		Value = (Key != 0U) ? EntryPtr->Pending :
+			(u32)(EntryPtr->Pending - EntryPtr->Sent);
+		if ((Key == 0U) && (Value == 0U)) {
+			return 1U;
+		}
+		break;
+	case METRICS_COUNTER64:
+		/* Both words of the same value */
+		Cpsr = mfcpsr();
+		mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+		EntryPtr->Pending = *(const volatile u64 *)EntryPtr->ValuePtr;
+		mtcpsr(Cpsr);
+		Value = (Key != 0U) ? EntryPtr->Pending :
+			(EntryPtr->Pending - EntryPtr->Sent);
+		if ((Key == 0U) && (Value == 0U)) {
+			return 1U;
+		}
+		break;
+	case METRICS_GAUGE:
+	case METRICS_GAUGE_FN:
+		Gauge = (EntryPtr->Type == METRICS_GAUGE) ?
+			(s64)*(const volatile s32 *)EntryPtr->ValuePtr :
+			(s64)EntryPtr->ReadFn(EntryPtr->Ref);
+		EntryPtr->Pending = (u64)Gauge;
+		if ((Key == 0U) && (EntryPtr->Pending == EntryPtr->Sent)) {
+			return 1U;
+		}
+		Value = ((u64)Gauge << 1) ^ (u64)(Gauge >> 63);
+		break;
+	default:
+		HistPtr = (Metrics_Histogram *)EntryPtr->ValuePtr;
+		for (Bucket = 0U; Bucket < METRICS_HIST_BUCKETS; Bucket++) {
+			HistPtr->Pending[Bucket] = HistPtr->Bucket[Bucket];
+			if (HistPtr->Pending[Bucket] !=
+			    ((Key != 0U) ? 0U : HistPtr->Sent[Bucket])) {
+				Mask |= 1U << Bucket;
+			}
+		}
+		if ((Key == 0U) && (Mask == 0U)) {
+			return 1U;
+		}
+		break;
+	}
+
+	Fits = Metrics_PutVarint(RegPtr, Index);
+	if (EntryPtr->Type != METRICS_HISTOGRAM) {
+		Fits &= Metrics_PutVarint(RegPtr, Value);
+	} else {
+		Fits &= Metrics_PutVarint(RegPtr, Mask);
+		for (Bucket = 0U; Bucket < METRICS_HIST_BUCKETS; Bucket++) {
+			if ((Mask & (1U << Bucket)) != 0U) {
+				Fits &= Metrics_PutVarint(RegPtr,
+					(Key != 0U) ? HistPtr->Pending[Bucket] :
+					(u32)(HistPtr->Pending[Bucket] -
+					      HistPtr->Sent[Bucket]));
+			}
+		}
+	}
+
+	if (Fits == 0U) {
+		RegPtr->Length = Mark;
+	}
+
+	return Fits;
+}
+
+/*
+ * Builds a names frame from NameIndex on. Returns the number of names in
+ * it.
+ */
+static u32 Metrics_PutNames(Metrics *RegPtr)
+{
+	Metrics_Entry *EntryPtr;
+	const Metrics_Histogram *HistPtr;
+	u32 Index;
+	u32 Length;
+
+	Metrics_Begin(RegPtr, METRICS_FRAME_NAMES);
+	for (Index = RegPtr->NameIndex; Index < RegPtr->Count; Index++) {
+		EntryPtr = &RegPtr->Entry[Index];
+		Length = (EntryPtr->Name != NULL) ?
+			 (u32)strlen(EntryPtr->Name) : 0U;
+		if (Length > METRICS_NAME_MAX) {
+			Length = METRICS_NAME_MAX;
+		}
+		if ((RegPtr->Length + 4U + Length) > METRICS_MAX_PAYLOAD) {
+			break;
+		}
+
+		HistPtr = (const Metrics_Histogram *)EntryPtr->ValuePtr;
+		RegPtr->Payload[RegPtr->Length++] = (u8)Index;
+		RegPtr->Payload[RegPtr->Length++] = (u8)EntryPtr->Type;
+		RegPtr->Payload[RegPtr->Length++] =
+			(EntryPtr->Type == METRICS_HISTOGRAM) ?
+			(u8)HistPtr->Shift : 0U;
+		RegPtr->Payload[RegPtr->Length++] = (u8)Length;
+		(void)memcpy(&RegPtr->Payload[RegPtr->Length], EntryPtr->Name,
+			     Length);
+		RegPtr->Length += Length;
+	}
+
+	return Index - RegPtr->NameIndex;
+}
+
+/*
+ * Frames the payload and hands it to the sink.
+ */
+static s32 Metrics_Send(Metrics *RegPtr)
+{
+	u32 Length;
+
+	Length = UartFrame_Encode(UART_FRAME_COBS, RegPtr->Payload,
+				  RegPtr->Length, RegPtr->Frame,
+				  sizeof(RegPtr->Frame));
+	if ((Length == 0U) ||
+	    (RegPtr->SinkFn(RegPtr->SinkRef, RegPtr->Frame, Length) !=
+	     Length)) {
+		RegPtr->Stats.Dropped++;
+		return XST_DEVICE_BUSY;
+	}
+
+	RegPtr->Seq++;
+	RegPtr->Stats.Frames++;
+	RegPtr->Stats.Bytes += Length;
+
+	return XST_SUCCESS;
+}
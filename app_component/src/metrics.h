@@ -0,0 +1,201 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file metrics.h
+*
+* Registry of the counters, gauges and histograms of the application, and
+* their export as compact binary frames.
+*
+* A subsystem registers the variables it already keeps, e.g. the fields of
+* its stats structure, by address: the registry reads them when it exports
+* and the subsystem pays nothing on its own paths. A value that has to be
+* computed, such as the temperature of the XADC, is registered as a gauge
+* read through a function. A histogram counts values in power of two
+* buckets, Metrics_HistogramAdd(), e.g. latencies. The registry is a static
+* table of METRICS_MAX entries, nothing is allocated.
+*
+* Metrics_Poll(), from the main loop, exports a frame every period. A
+* frame holds the metrics that changed since the last frame the sink took:
+* the increments of the counters and of the histogram buckets, and the
+* values of the gauges. Every METRICS_KEY_EVERY frames, a key frame holds
+* all the metrics with their absolute values instead, for a receiver that
+* starts late or lost a frame, after a names frame giving the names and
+* types of the metrics. The numbers are LEB128 varints, the gauges
+* zigzag coded, so a counter that moved by a few takes a byte or two.
+*
+* Frame payload, then a CRC-32, COBS stuffed and delimited by 0x00 as in
+* uart_frame.h:
+*
+* - Type, METRICS_FRAME_DATA, METRICS_FRAME_KEY or METRICS_FRAME_NAMES.
+* - Sequence, u8, per frame taken by the sink.
+* - Time, u32 little endian, in ms from the start of the global timer.
+* - DATA and KEY: per metric, its index then its value: a varint for a
+*   counter, a zigzag varint for a gauge, and for a histogram the varint
+*   mask of the buckets that follow then one varint per bucket.
+* - NAMES: per metric, its index, type, histogram shift and name length,
+*   u8 each, then the name.
+*
+* The sink takes a frame whole or not at all, as XCoresightPs_DccLogWrite()
+* of the DCC log or a wrapper of UartVChan_Write() on a channel of its own
+* with room checked first. A frame the sink refuses is dropped and counted,
+* and the changes it held go in the next frame. app_component/tools/
+* metrics_decode.py decodes the frames.
+*
+* The registry and Metrics_Poll() belong to one context, the variables
+* being written from any. A 64-bit counter is read with the interrupts
+* masked. A histogram is updated from one context only.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Raised METRICS_MAX to 48 for the benchmark gauges
+*			of bridge_bench.h.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xiltimer.h"
+
+/************************** Constant Definitions ****************************/
+
+#ifndef METRICS_MAX
+#define METRICS_MAX		48U	/**< Metrics of a registry */
+#endif
+
+#ifndef METRICS_KEY_EVERY
+#define METRICS_KEY_EVERY	16U	/**< Frames per key frame */
+#endif
+
+#ifndef METRICS_MAX_PAYLOAD
+#define METRICS_MAX_PAYLOAD	512U	/**< Bytes of a frame before COBS */
+#endif
+
+#define METRICS_HIST_BUCKETS	16U	/**< Buckets of a histogram */
+#define METRICS_NAME_MAX	31U	/**< Longest name exported */
+
+/** @name Types of metrics
+ * @{
+ */
+#define METRICS_COUNTER		0U	/**< u32, only grows */
+#define METRICS_COUNTER64	1U	/**< u64, only grows */
+#define METRICS_GAUGE		2U	/**< s32 variable */
+#define METRICS_GAUGE_FN	3U	/**< s32 read by a function */
+#define METRICS_HISTOGRAM	4U	/**< Metrics_Histogram */
+/** @} */
+
+/** @name Types of frames
+ * @{
+ */
+#define METRICS_FRAME_DATA	1U	/**< Changes since the last frame */
+#define METRICS_FRAME_KEY	2U	/**< Every metric, absolute */
+#define METRICS_FRAME_NAMES	3U	/**< Names and types */
+/** @} */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Reads the value of a METRICS_GAUGE_FN gauge.
+ */
+typedef s32 (*Metrics_ReadFn)(void *Ref);
+
+/**
+ * Takes a frame whole, returning NumBytes, or not at all, returning 0.
+ */
+typedef u32 (*Metrics_SinkFn)(void *Ref, const u8 *DataPtr, u32 NumBytes);
+
+/**
+ * A histogram. Bucket 0 counts the values below 2^Shift, bucket N those
+ * from 2^(Shift + N - 1), the last one all the values above.
+ */
+typedef struct {
+	u32 Bucket[METRICS_HIST_BUCKETS];
+	u32 Shift;
+	u32 Sent[METRICS_HIST_BUCKETS];	/**< Buckets the sink took */
+	u32 Pending[METRICS_HIST_BUCKETS]; /**< Buckets of the frame */
+} Metrics_Histogram;
+
+/**
+ * One metric.
+ */
+typedef struct {
+	const char *Name;
+	u32 Type;		/**< One of the METRICS_* types */
+	const volatile void *ValuePtr; /**< Variable or Metrics_Histogram */
+	Metrics_ReadFn ReadFn;	/**< METRICS_GAUGE_FN */
+	void *Ref;		/**< Argument of ReadFn */
+	u64 Sent;		/**< Value the sink took */
+	u64 Pending;		/**< Value of the frame being built */
+} Metrics_Entry;
+
+/**
+ * Counts of the exporter.
+ */
+typedef struct {
+	u32 Frames;		/**< Frames the sink took */
+	u32 Dropped;		/**< Frames it refused */
+	u64 Bytes;		/**< Bytes it took */
+	u64 BusyCounts;		/**< Global timer counts spent exporting */
+} Metrics_Stats;
+
+/**
+ * A registry and its exporter.
+ */
+typedef struct {
+	Metrics_Entry Entry[METRICS_MAX];
+	u32 Count;
+	Metrics_SinkFn SinkFn;
+	void *SinkRef;
+	XTime PeriodCounts;	/**< Between two frames */
+	XTime Last;		/**< When the last frame was due */
+	u32 Seq;
+	u32 SinceKey;		/**< Frames since the last key frame */
+	u32 NameIndex;		/**< First metric of the next names frame */
+	Metrics_Stats Stats;
+	u32 Length;		/**< Bytes of Payload */
+	u8 Payload[METRICS_MAX_PAYLOAD];
+	u8 Frame[METRICS_MAX_PAYLOAD + (METRICS_MAX_PAYLOAD / 254U) + 8U];
+} Metrics;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+s32 Metrics_Initialize(Metrics *RegPtr, Metrics_SinkFn SinkFn, void *SinkRef,
+		       u32 PeriodMs);
+s32 Metrics_AddCounter(Metrics *RegPtr, const char *Name,
+		       const volatile u32 *ValuePtr);
+s32 Metrics_AddCounter64(Metrics *RegPtr, const char *Name,
+			 const volatile u64 *ValuePtr);
+s32 Metrics_AddGauge(Metrics *RegPtr, const char *Name,
+		     const volatile s32 *ValuePtr);
+s32 Metrics_AddGaugeFn(Metrics *RegPtr, const char *Name,
+		       Metrics_ReadFn ReadFn, void *Ref);
+s32 Metrics_AddHistogram(Metrics *RegPtr, const char *Name,
+			 Metrics_Histogram *HistPtr, u32 Shift);
+void Metrics_HistogramAdd(Metrics_Histogram *HistPtr, u32 Value);
+s32 Metrics_Poll(Metrics *RegPtr);
+s32 Metrics_Export(Metrics *RegPtr);
+void Metrics_GetStats(const Metrics *RegPtr, Metrics_Stats *StatsPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METRICS_H */
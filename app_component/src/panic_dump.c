@@ -0,0 +1,615 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file panic_dump.c
+*
+* Panic dump to the SD card. Refer to panic_dump.h for how it is used.
+*
+* The image is built in PanicDumpImage, which is not cleared at start so
+* that its bss costs nothing, and only the sectors the dump takes are
+* written. PanicDump_Write() runs once: it is reentered only by a fault
+* taken while it runs, which gives up at once.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xparameters.h"
+
+#ifdef XPAR_XSDPS_0_BASEADDR
+
+#include <string.h>
+#include "xstatus.h"
+#include "xil_assert.h"
+#include "xil_exception.h"
+#include "xil_hotpath.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xiltimer.h"
+#include "diskio.h"
+#include "panic_dump.h"
+
+/************************** Constant Definitions ****************************/
+
+#define PANIC_DUMP_VECTOR_FRAME	24U	/* R0-R3, R12, LR of the vector */
+#define PANIC_DUMP_STACK_LIMIT	0x10000U /* Larger spans are not a stack */
+#define PANIC_DUMP_FILE_CHARS	60U	/* Of the file of an assertion */
+
+/**************************** Type Definitions ******************************/
+
+/*
+ * Block of a failed assertion
+ */
+typedef struct {
+	u32 Line;
+	char File[PANIC_DUMP_FILE_CHARS];
+} PanicDump_Assert;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#if FF_MAX_SS != FF_MIN_SS
+#define PanicDump_SectorSize(FsPtr)	((u32)(FsPtr)->ssize)
+#else
+#define PanicDump_SectorSize(FsPtr)	((u32)FF_MAX_SS)
+#endif
+
+/************************** Function Prototypes *****************************/
+
+static void PanicDump_Regs(PanicDump_Header *HeaderPtr, u32 Reason);
+static u32 PanicDump_StackTop(u32 Mode);
+static u32 PanicDump_Append(u32 Offset, u32 Tag, u32 Address, u32 NumBytes);
+static void PanicDump_Exception(PanicDump *DumpPtr, u32 Reason);
+static void PanicDump_UndefinedHandler(void *CallBackRef);
+static void PanicDump_PrefetchHandler(void *CallBackRef);
+static void PanicDump_DataAbortHandler(void *CallBackRef);
+static void PanicDump_AssertHandler(const char8 *File, s32 Line);
+
+/************************** Variable Definitions ****************************/
+
+/*
+ * Set by the exception vectors of the BSP
+ */
+extern u32 DataAbortAddr;
+extern u32 PrefetchAbortAddr;
+extern u32 UndefinedExceptionAddr;
+
+/*
+ * Tops of the stacks of CPU0, from the linker script
+ */
+extern u8 _stack[];
+extern u8 __irq_stack[];
+extern u8 __supervisor_stack[];
+extern u8 __abort_stack[];
+extern u8 __fiq_stack[];
+extern u8 __undef_stack[];
+
+/* Written by the SD DMA, whole cache lines */
+static u8 PanicDumpImage[PANIC_DUMP_SIZE]
+	__attribute__((aligned(64))) XIL_NOINIT;
+
+static PanicDump_Assert PanicDumpAssert;
+
+/* For the assertion callback, which takes no reference */
+static PanicDump *PanicDumpPtr;
+
+/****************************************************************************/
+/**
+*
+* Opens the dump file, preallocated to PANIC_DUMP_SIZE bytes of contiguous
+* clusters, and installs the dump on the undefined instruction, prefetch
+* abort and data abort exceptions and on failed assertions. A file of the
+* right size is kept with the dump it may hold, any other is replaced by an
+* empty one.
+*
+* @param	DumpPtr is a pointer to the panic dump.
+* @param	Path is the path of the file, on a mounted volume.
+*
+* @return
+*		- XST_SUCCESS if the dump is ready. PanicDump_IsPending()
+*		  then tells whether the file holds a dump.
+*		- XST_FAILURE if the file cannot be created, preallocated or
+*		  read, or FF_USE_EXPAND is not set.
+*
+* @note		The handlers replace those installed before. Register the
+*		blocks with PanicDump_AddBlock().
+*
+*****************************************************************************/
+s32 PanicDump_Open(PanicDump *DumpPtr, const char *Path)
+{
+	PanicDump_Header Header;
+	FATFS *FsPtr;
+	FIL File;
+	FRESULT Res;
+	UINT Read;
+
+	Xil_AssertNonvoid(DumpPtr != NULL);
+	Xil_AssertNonvoid(Path != NULL);
+
+	DumpPtr->Ready = 0U;
+	DumpPtr->Pending = 0U;
+	DumpPtr->Writing = 0U;
+	DumpPtr->NumBlocks = 0U;
+
+#if FF_USE_EXPAND
+	Res = f_open(&File, Path, FA_READ | FA_WRITE | FA_OPEN_ALWAYS);
+	if (Res != FR_OK) {
+		return XST_FAILURE;
+	}
+
+	if (f_size(&File) == (FSIZE_t)PANIC_DUMP_SIZE) {
+		Res = f_read(&File, &Header, sizeof(Header), &Read);
+		if ((Res != FR_OK) || (Read != sizeof(Header))) {
+			(void)f_close(&File);
+			return XST_FAILURE;
+		}
+		DumpPtr->Pending = (Header.Magic == PANIC_DUMP_MAGIC) ? 1U : 0U;
+	} else {
+		/* Replaced by one run of clusters */
+		(void)f_close(&File);
+		Res = f_open(&File, Path, FA_WRITE | FA_CREATE_ALWAYS);
+		if (Res != FR_OK) {
+			return XST_FAILURE;
+		}
+		Res = f_expand(&File, (FSIZE_t)PANIC_DUMP_SIZE, 1U);
+		if (Res != FR_OK) {
+			(void)f_close(&File);
+			return XST_FAILURE;
+		}
+	}
+
+	FsPtr = File.obj.fs;
+	DumpPtr->Drive = FsPtr->pdrv;
+	DumpPtr->SectorSize = PanicDump_SectorSize(FsPtr);
+	DumpPtr->Sector = FsPtr->database +
+			  ((LBA_t)File.obj.sclust - 2U) * FsPtr->csize;
+
+	Res = f_close(&File);
+	if ((Res != FR_OK) || (File.obj.sclust < 2U) ||
+	    ((PANIC_DUMP_SIZE % DumpPtr->SectorSize) != 0U)) {
+		return XST_FAILURE;
+	}
+
+	DumpPtr->Ready = 1U;
+	if (DumpPtr->Pending == 0U) {
+		/* The clusters of a new file hold what was there before */
+		if (PanicDump_Clear(DumpPtr) != XST_SUCCESS) {
+			DumpPtr->Ready = 0U;
+			return XST_FAILURE;
+		}
+	}
+
+	PanicDumpPtr = DumpPtr;
+	Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_UNDEFINED_INT,
+				     PanicDump_UndefinedHandler, DumpPtr);
+	Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_PREFETCH_ABORT_INT,
+				     PanicDump_PrefetchHandler, DumpPtr);
+	Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_DATA_ABORT_INT,
+				     PanicDump_DataAbortHandler, DumpPtr);
+	Xil_AssertSetCallback(PanicDump_AssertHandler);
+
+	return XST_SUCCESS;
+#else
+	(void)Header;
+	(void)FsPtr;
+	(void)File;
+	(void)Res;
+	(void)Read;
+	return XST_FAILURE;
+#endif
+}
+
+/****************************************************************************/
+/**
+*
+* Adds a block of memory to the dumps, such as &Xil_TraceBuf with
+* PANIC_DUMP_BLOCK_TRACE or the counters of a driver with
+* PANIC_DUMP_BLOCK_STATS. The blocks are dumped in the order they are
+* added, after the stacks.
+*
+* @param	DumpPtr is a pointer to the panic dump.
+* @param	Tag is the tag of the block, PANIC_DUMP_BLOCK_* or from
+*		PANIC_DUMP_BLOCK_USER.
+* @param	DataPtr is the memory dumped, word aligned.
+* @param	NumBytes is the number of bytes dumped, a multiple of 4.
+*
+* @return
+*		- XST_SUCCESS if the block is added.
+*		- XST_INVALID_PARAM for unaligned memory or length.
+*		- XST_FAILURE if PANIC_DUMP_MAX_BLOCKS blocks are added.
+*
+* @note		The memory is read at the time of the panic.
+*
+*****************************************************************************/
+s32 PanicDump_AddBlock(PanicDump *DumpPtr, u32 Tag, const void *DataPtr,
+		       u32 NumBytes)
+{
+	Xil_AssertNonvoid(DumpPtr != NULL);
+	Xil_AssertNonvoid(DataPtr != NULL);
+
+	if (((((UINTPTR)DataPtr) | NumBytes) & 0x3U) != 0U) {
+		return XST_INVALID_PARAM;
+	}
+	if (DumpPtr->NumBlocks >= PANIC_DUMP_MAX_BLOCKS) {
+		return XST_FAILURE;
+	}
+
+	DumpPtr->Block[DumpPtr->NumBlocks].Tag = Tag;
+	DumpPtr->Block[DumpPtr->NumBlocks].Address = (u32)(UINTPTR)DataPtr;
+	DumpPtr->Block[DumpPtr->NumBlocks].Length = NumBytes;
+	DumpPtr->NumBlocks++;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Writes a dump to the file, unless it already holds one. The exception
+* and assertion handlers call it; the application calls it for failures of
+* its own, such as a watchdog pre-timeout.
+*
+* @param	DumpPtr is a pointer to the panic dump.
+* @param	Reason is PANIC_DUMP_REASON_* or a code from
+*		PANIC_DUMP_REASON_USER.
+*
+* @return
+*		- XST_SUCCESS if the dump is written.
+*		- XST_DEVICE_BUSY if the file holds a dump, or a dump is
+*		  being written.
+*		- XST_FAILURE if the dump is not ready or the card fails.
+*
+* @note		Call it with the interrupts masked. It does not return to
+*		the failed code: the caller decides what comes next.
+*
+*****************************************************************************/
+s32 PanicDump_Write(PanicDump *DumpPtr, u32 Reason)
+{
+	PanicDump_Header *HeaderPtr = (PanicDump_Header *)PanicDumpImage;
+	const PanicDump_Block *BlockPtr;
+	const u32 *WordPtr;
+	u32 Offset = PANIC_DUMP_BODY_OFFSET;
+	u32 NumSectors;
+	u32 Sum = 0U;
+	u32 Index;
+	u32 Count;
+	u32 Mode;
+	u32 Top;
+	u32 Sp;
+	XTime Time;
+
+	if ((DumpPtr == NULL) || (DumpPtr->Ready == 0U)) {
+		return XST_FAILURE;
+	}
+	if ((DumpPtr->Pending != 0U) || (DumpPtr->Writing != 0U)) {
+		return XST_DEVICE_BUSY;
+	}
+	DumpPtr->Writing = 1U;
+
+	XTime_GetTime(&Time);
+	(void)memset(PanicDumpImage, 0, PANIC_DUMP_BODY_OFFSET);
+	HeaderPtr->Magic = PANIC_DUMP_MAGIC;
+	HeaderPtr->Version = (u16)PANIC_DUMP_VERSION;
+	HeaderPtr->Source = (u16)PANIC_DUMP_SOURCE_APP;
+	HeaderPtr->Reason = Reason;
+	HeaderPtr->Time = Time;
+	PanicDump_Regs(HeaderPtr, Reason);
+
+	/*
+	 * The stack of the exception mode, then that of main(), from the
+	 * stack pointer up, then the blocks of the caller
+	 */
+	Mode = HeaderPtr->Regs[PANIC_DUMP_REG_CPSR] & XREG_CPSR_MODE_BITS;
+	if (Mode != XREG_CPSR_SYSTEM_MODE) {
+		Sp = HeaderPtr->Regs[PANIC_DUMP_REG_SP] & ~0x3U;
+		Top = PanicDump_StackTop(Mode);
+		if ((Top > Sp) && ((Top - Sp) <= PANIC_DUMP_STACK_LIMIT)) {
+			Offset = PanicDump_Append(Offset,
+					PANIC_DUMP_BLOCK_EXC_STACK, Sp,
+					(Top - Sp) > PANIC_DUMP_STACK_BYTES ?
+					PANIC_DUMP_STACK_BYTES : (Top - Sp));
+			HeaderPtr->NumBlocks++;
+		}
+	}
+
+	Sp = HeaderPtr->Regs[PANIC_DUMP_REG_SYS_SP] & ~0x3U;
+	Top = (u32)(UINTPTR)_stack;
+	if ((Top > Sp) && ((Top - Sp) <= PANIC_DUMP_STACK_LIMIT)) {
+		Offset = PanicDump_Append(Offset, PANIC_DUMP_BLOCK_SYS_STACK, Sp,
+				(Top - Sp) > PANIC_DUMP_STACK_BYTES ?
+				PANIC_DUMP_STACK_BYTES : (Top - Sp));
+		HeaderPtr->NumBlocks++;
+	}
+
+	if (Reason == PANIC_DUMP_REASON_ASSERT) {
+		Offset = PanicDump_Append(Offset, PANIC_DUMP_BLOCK_ASSERT,
+				(u32)(UINTPTR)&PanicDumpAssert,
+				sizeof(PanicDumpAssert));
+		HeaderPtr->NumBlocks++;
+	}
+
+	for (Index = 0U; Index < DumpPtr->NumBlocks; Index++) {
+		BlockPtr = &DumpPtr->Block[Index];
+		Count = PanicDump_Append(Offset, BlockPtr->Tag,
+					 BlockPtr->Address, BlockPtr->Length);
+		if (Count == Offset) {
+			break;
+		}
+		Offset = Count;
+		HeaderPtr->NumBlocks++;
+	}
+
+	WordPtr = (const u32 *)&PanicDumpImage[PANIC_DUMP_BODY_OFFSET];
+	for (Index = PANIC_DUMP_BODY_OFFSET; Index < Offset; Index += 4U) {
+		Sum += *WordPtr++;
+	}
+	HeaderPtr->Length = Offset;
+	HeaderPtr->Checksum = Sum;
+
+	/*
+	 * The body, then the first sector, with the header, which makes the
+	 * dump valid
+	 */
+	NumSectors = (Offset + DumpPtr->SectorSize - 1U) / DumpPtr->SectorSize;
+	if ((NumSectors > 1U) &&
+	    (disk_write(DumpPtr->Drive, &PanicDumpImage[DumpPtr->SectorSize],
+			DumpPtr->Sector + 1U, NumSectors - 1U) != RES_OK)) {
+		DumpPtr->Writing = 0U;
+		return XST_FAILURE;
+	}
+	if ((disk_write(DumpPtr->Drive, PanicDumpImage, DumpPtr->Sector,
+			1U) != RES_OK) ||
+	    (disk_ioctl(DumpPtr->Drive, CTRL_SYNC, NULL) != RES_OK)) {
+		DumpPtr->Writing = 0U;
+		return XST_FAILURE;
+	}
+
+	DumpPtr->Pending = 1U;
+	DumpPtr->Writing = 0U;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Empties the file, once its dump was read out, so that the next panic is
+* dumped.
+*
+* @param	DumpPtr is a pointer to the panic dump.
+*
+* @return
+*		- XST_SUCCESS if the file is empty.
+*		- XST_FAILURE if the dump is not open or the card fails.
+*
+* @note		Only the first sector is written.
+*
+*****************************************************************************/
+s32 PanicDump_Clear(PanicDump *DumpPtr)
+{
+	Xil_AssertNonvoid(DumpPtr != NULL);
+
+	if ((DumpPtr->Ready == 0U) || (DumpPtr->Writing != 0U)) {
+		return XST_FAILURE;
+	}
+
+	(void)memset(PanicDumpImage, 0, DumpPtr->SectorSize);
+	if ((disk_write(DumpPtr->Drive, PanicDumpImage, DumpPtr->Sector,
+			1U) != RES_OK) ||
+	    (disk_ioctl(DumpPtr->Drive, CTRL_SYNC, NULL) != RES_OK)) {
+		return XST_FAILURE;
+	}
+
+	DumpPtr->Pending = 0U;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Takes the registers of the dump: the current mode, its saved status,
+* stack pointer and return address, the fault registers, the stack pointer
+* and link register of the system mode, in which main() runs, and, in the
+* abort and undefined modes, the registers the vector saved at the top of
+* the stack of the mode.
+*
+* @param	HeaderPtr is the header that takes the registers.
+* @param	Reason is the reason of the dump.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void PanicDump_Regs(PanicDump_Header *HeaderPtr, u32 Reason)
+{
+	u32 *Regs = HeaderPtr->Regs;
+	const u32 *FramePtr;
+	u32 Mode;
+	u32 Saved;
+	u32 Index;
+
+	Regs[PANIC_DUMP_REG_CPSR] = mfcpsr();
+	Mode = Regs[PANIC_DUMP_REG_CPSR] & XREG_CPSR_MODE_BITS;
+	if ((Mode != XREG_CPSR_SYSTEM_MODE) && (Mode != XREG_CPSR_USER_MODE)) {
+		__asm__ __volatile__("mrs %0, spsr" :
+				     "=r" (Regs[PANIC_DUMP_REG_SPSR]));
+	}
+	__asm__ __volatile__("mov %0, sp" : "=r" (Regs[PANIC_DUMP_REG_SP]));
+	Regs[PANIC_DUMP_REG_LR] = (u32)(UINTPTR)__builtin_return_address(0);
+
+	Regs[PANIC_DUMP_REG_DFSR] = mfcp(XREG_CP15_DATA_FAULT_STATUS);
+	Regs[PANIC_DUMP_REG_DFAR] = mfcp(XREG_CP15_DATA_FAULT_ADDRESS);
+	Regs[PANIC_DUMP_REG_IFSR] = mfcp(XREG_CP15_INST_FAULT_STATUS);
+	Regs[PANIC_DUMP_REG_IFAR] = mfcp(XREG_CP15_INST_FAULT_ADDRESS);
+
+	/* Banked registers of the system mode, through a switch to it */
+	__asm__ __volatile__(
+		"mrs	%2, cpsr\n"
+		"cps	#0x1F\n"
+		"mov	%0, sp\n"
+		"mov	%1, lr\n"
+		"msr	cpsr_c, %2\n"
+		: "=&r" (Regs[PANIC_DUMP_REG_SYS_SP]),
+		  "=&r" (Regs[PANIC_DUMP_REG_SYS_LR]), "=&r" (Saved));
+
+	if (Reason == PANIC_DUMP_REASON_DATA_ABORT) {
+		Regs[PANIC_DUMP_REG_FAULT_PC] = DataAbortAddr;
+	} else if (Reason == PANIC_DUMP_REASON_PREFETCH) {
+		Regs[PANIC_DUMP_REG_FAULT_PC] = PrefetchAbortAddr;
+	} else if (Reason == PANIC_DUMP_REASON_UNDEFINED) {
+		Regs[PANIC_DUMP_REG_FAULT_PC] = UndefinedExceptionAddr;
+	} else {
+		Regs[PANIC_DUMP_REG_FAULT_PC] = 0U;
+	}
+
+	if ((Mode == XREG_CPSR_DATA_ABORT_MODE) ||
+	    (Mode == XREG_CPSR_UNDEFINED_MODE)) {
+		FramePtr = (const u32 *)(UINTPTR)(PanicDump_StackTop(Mode) -
+						  PANIC_DUMP_VECTOR_FRAME);
+		for (Index = 0U; Index < 5U; Index++) {
+			Regs[PANIC_DUMP_REG_R0 + Index] = FramePtr[Index];
+		}
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Returns the top of the stack of a mode of CPU0.
+*
+* @param	Mode is the mode bits of the CPSR.
+*
+* @return	Top of the stack, 0 for an unknown mode.
+*
+*****************************************************************************/
+static u32 PanicDump_StackTop(u32 Mode)
+{
+	switch (Mode) {
+	case XREG_CPSR_IRQ_MODE:
+		return (u32)(UINTPTR)__irq_stack;
+	case XREG_CPSR_FIQ_MODE:
+		return (u32)(UINTPTR)__fiq_stack;
+	case XREG_CPSR_SVC_MODE:
+		return (u32)(UINTPTR)__supervisor_stack;
+	case XREG_CPSR_DATA_ABORT_MODE:
+		return (u32)(UINTPTR)__abort_stack;
+	case XREG_CPSR_UNDEFINED_MODE:
+		return (u32)(UINTPTR)__undef_stack;
+	case XREG_CPSR_SYSTEM_MODE:
+	case XREG_CPSR_USER_MODE:
+		return (u32)(UINTPTR)_stack;
+	default:
+		return 0U;
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Appends a block to the image, if it fits.
+*
+* @param	Offset is the offset of the block in the image.
+* @param	Tag is the tag of the block.
+* @param	Address is the address of its data, word aligned.
+* @param	NumBytes is the number of bytes of data, a multiple of 4.
+*
+* @return	Offset of the next block, Offset if the block does not fit.
+*
+*****************************************************************************/
+static u32 PanicDump_Append(u32 Offset, u32 Tag, u32 Address, u32 NumBytes)
+{
+	PanicDump_Block Block;
+
+	if ((sizeof(Block) + NumBytes) > (PANIC_DUMP_SIZE - Offset)) {
+		return Offset;
+	}
+
+	Block.Tag = Tag;
+	Block.Address = Address;
+	Block.Length = NumBytes;
+	(void)memcpy(&PanicDumpImage[Offset], &Block, sizeof(Block));
+	(void)memcpy(&PanicDumpImage[Offset + sizeof(Block)],
+		     (const void *)(UINTPTR)Address, NumBytes);
+
+	return Offset + sizeof(Block) + NumBytes;
+}
+
+/****************************************************************************/
+/*
+*
+* Dumps an exception and waits for the watchdog, the failed code cannot go
+* on.
+*
+* @param	DumpPtr is a pointer to the panic dump.
+* @param	Reason is the reason of the dump.
+*
+* @return	Does not return.
+*
+*****************************************************************************/
+static void PanicDump_Exception(PanicDump *DumpPtr, u32 Reason)
+{
+	(void)PanicDump_Write(DumpPtr, Reason);
+
+	while (1) {
+		;
+	}
+}
+
+static void PanicDump_UndefinedHandler(void *CallBackRef)
+{
+	PanicDump_Exception((PanicDump *)CallBackRef,
+			    PANIC_DUMP_REASON_UNDEFINED);
+}
+
+static void PanicDump_PrefetchHandler(void *CallBackRef)
+{
+	PanicDump_Exception((PanicDump *)CallBackRef,
+			    PANIC_DUMP_REASON_PREFETCH);
+}
+
+static void PanicDump_DataAbortHandler(void *CallBackRef)
+{
+	PanicDump_Exception((PanicDump *)CallBackRef,
+			    PANIC_DUMP_REASON_DATA_ABORT);
+}
+
+/****************************************************************************/
+/*
+*
+* Assertion callback: dumps the failed assertion with its file and line.
+* Xil_Assert() then spins or returns, as Xil_AssertWait says.
+*
+* @param	File is the file of the assertion.
+* @param	Line is its line.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void PanicDump_AssertHandler(const char8 *File, s32 Line)
+{
+	u32 Mode;
+
+	PanicDumpAssert.Line = (u32)Line;
+	(void)strncpy(PanicDumpAssert.File, File,
+		      sizeof(PanicDumpAssert.File) - 1U);
+	PanicDumpAssert.File[sizeof(PanicDumpAssert.File) - 1U] = '\0';
+
+	/* The interrupts are masked for the write and put back after */
+	Mode = mfcpsr();
+	mtcpsr(Mode | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	(void)PanicDump_Write(PanicDumpPtr, PANIC_DUMP_REASON_ASSERT);
+	mtcpsr(Mode);
+}
+
+#endif /* XPAR_XSDPS_0_BASEADDR */
@@ -0,0 +1,196 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file panic_dump.h
+*
+* Panic dump to the SD card, for the post-mortem of units in the field.
+*
+* On a data abort, a prefetch abort, an undefined instruction or a failed
+* assertion, or when the application calls PanicDump_Write(), the
+* registers of the failing mode, the fault status and address registers,
+* the two stacks in use and the blocks registered with PanicDump_AddBlock(),
+* such as the event trace of xil_trace.h and the counters of the drivers,
+* are written to a file on the SD card, then the CPU waits for the
+* watchdog to reset it.
+*
+* The file system is not used at the time of the panic, its state may be
+* what failed. PanicDump_Open() preallocates the file as one run of
+* contiguous clusters and keeps its first sector; the dump is built in a
+* RAM image and written with disk_write() straight to those sectors, the
+* body in one multiple block write and the first sector, with the
+* header, last, so that a dump with a header is complete. It takes a few
+* milliseconds of card time, well within the watchdog period.
+*
+* Only the first panic is kept: once a dump is in the file, no other is
+* written until PanicDump_Clear() is called, after the dump was read out,
+* so that a unit in a reset loop keeps the dump of the first failure. The
+* file is read on the host and decoded by tools/panic_decode.py.
+*
+* The dump has the layout of the panic dump of the FSBL, see fsbl_panic.h:
+* a PanicDump_Header, padded to PANIC_DUMP_BODY_OFFSET bytes, then the
+* blocks, each a PanicDump_Block and its data padded to a word. Blocks that
+* do not fit in PANIC_DUMP_SIZE bytes are left out.
+*
+* SD0 and xilffs must be enabled in the BSP, read-write with
+* FF_USE_EXPAND set to 1, and the volume mounted with f_mount() before
+* PanicDump_Open(). Without SD0 the file compiles to nothing. The registers
+* and stacks are those of CPU0.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef PANIC_DUMP_H
+#define PANIC_DUMP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "ff.h"
+
+/************************** Constant Definitions ****************************/
+
+#ifndef PANIC_DUMP_SIZE
+#define PANIC_DUMP_SIZE		0x8000U	/**< Bytes of the file and image */
+#endif
+
+#ifndef PANIC_DUMP_STACK_BYTES
+#define PANIC_DUMP_STACK_BYTES	0x1000U	/**< Of each stack, from SP up */
+#endif
+
+#ifndef PANIC_DUMP_MAX_BLOCKS
+#define PANIC_DUMP_MAX_BLOCKS	8U	/**< Blocks of PanicDump_AddBlock() */
+#endif
+
+#define PANIC_DUMP_MAGIC	0x43494E50U	/**< "PNIC" */
+#define PANIC_DUMP_VERSION	1U
+#define PANIC_DUMP_BODY_OFFSET	256U	/**< First block of a dump */
+
+/** @name Source of a dump
+ * @{
+ */
+#define PANIC_DUMP_SOURCE_FSBL	1U
+#define PANIC_DUMP_SOURCE_APP	2U
+/** @} */
+
+/** @name Reasons of the application, or codes of its own from USER
+ * @{
+ */
+#define PANIC_DUMP_REASON_UNDEFINED	1U
+#define PANIC_DUMP_REASON_PREFETCH	2U
+#define PANIC_DUMP_REASON_DATA_ABORT	3U
+#define PANIC_DUMP_REASON_ASSERT	4U
+#define PANIC_DUMP_REASON_USER		0x100U
+/** @} */
+
+/** @name Registers of a dump, by index into PanicDump_Header.Regs
+ * @{
+ */
+#define PANIC_DUMP_REG_CPSR	0U	/**< Mode of the dump */
+#define PANIC_DUMP_REG_SPSR	1U	/**< Mode that failed */
+#define PANIC_DUMP_REG_SP	2U
+#define PANIC_DUMP_REG_LR	3U
+#define PANIC_DUMP_REG_FAULT_PC	4U	/**< Instruction of the exception */
+#define PANIC_DUMP_REG_DFSR	5U
+#define PANIC_DUMP_REG_DFAR	6U
+#define PANIC_DUMP_REG_IFSR	7U
+#define PANIC_DUMP_REG_IFAR	8U
+#define PANIC_DUMP_REG_SYS_SP	9U	/**< System mode, main() */
+#define PANIC_DUMP_REG_SYS_LR	10U
+#define PANIC_DUMP_REG_R0	11U	/**< R0-R3, R12 of the vector */
+#define PANIC_DUMP_NUM_REGS	16U
+/** @} */
+
+/** @name Blocks of a dump
+ * @{
+ */
+#define PANIC_DUMP_BLOCK_EXC_STACK	1U	/**< Stack of the mode */
+#define PANIC_DUMP_BLOCK_SYS_STACK	2U	/**< Stack of main() */
+#define PANIC_DUMP_BLOCK_TIMELINE	3U	/**< FSBL boot timeline */
+#define PANIC_DUMP_BLOCK_TRACE		4U	/**< Xil_TraceBuf */
+#define PANIC_DUMP_BLOCK_STATS		5U	/**< Counters */
+#define PANIC_DUMP_BLOCK_ASSERT		6U	/**< Line and file */
+#define PANIC_DUMP_BLOCK_USER		0x100U	/**< First of the caller */
+/** @} */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Header of a dump.
+ */
+typedef struct {
+	u32 Magic;		/**< PANIC_DUMP_MAGIC */
+	u16 Version;		/**< PANIC_DUMP_VERSION */
+	u16 Source;		/**< PANIC_DUMP_SOURCE_* */
+	u32 Length;		/**< Bytes of the dump with this header */
+	u32 Checksum;		/**< Sum of the words of the blocks */
+	u32 Reason;		/**< PANIC_DUMP_REASON_* */
+	u32 NumBlocks;
+	u64 Time;		/**< Global timer */
+	u32 Regs[PANIC_DUMP_NUM_REGS];
+} PanicDump_Header;
+
+/**
+ * Header of a block of a dump, the data follows.
+ */
+typedef struct {
+	u32 Tag;		/**< PANIC_DUMP_BLOCK_* */
+	u32 Address;		/**< Where the data was */
+	u32 Length;		/**< Bytes of data */
+} PanicDump_Block;
+
+/**
+ * A panic dump file.
+ */
+typedef struct {
+	LBA_t Sector;		/**< First sector of the file */
+	u32 SectorSize;		/**< Bytes */
+	u8 Drive;		/**< Physical drive of the volume */
+	u32 NumBlocks;
+	PanicDump_Block Block[PANIC_DUMP_MAX_BLOCKS];
+	volatile u32 Pending;	/**< A dump is in the file */
+	volatile u32 Writing;	/**< PanicDump_Write() is running */
+	u32 Ready;
+} PanicDump;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/****************************************************************************/
+/**
+*
+* Tells whether the file holds a dump not cleared yet.
+*
+* @param	DumpPtr is a pointer to the panic dump.
+*
+* @return	1 if it does, 0 otherwise.
+*
+*****************************************************************************/
+#define PanicDump_IsPending(DumpPtr)	((DumpPtr)->Pending)
+
+/************************** Function Prototypes *****************************/
+
+s32 PanicDump_Open(PanicDump *DumpPtr, const char *Path);
+s32 PanicDump_AddBlock(PanicDump *DumpPtr, u32 Tag, const void *DataPtr,
+		       u32 NumBytes);
+s32 PanicDump_Write(PanicDump *DumpPtr, u32 Reason);
+s32 PanicDump_Clear(PanicDump *DumpPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PANIC_DUMP_H */
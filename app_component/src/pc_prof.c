@@ -0,0 +1,298 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file pc_prof.c
+*
+* PC sampling profiler. Refer to pc_prof.h for how it is used.
+*
+* The IRQ vector of a BSP built with the standalone option
+* standalone_pc_sample, which defines XIL_PC_SAMPLE in bspconfig.h, writes
+* its LR, the interrupted PC plus 4, to TPIDRPRW before anything else.
+* TPIDRPRW is banked per CPU and the IRQ stays masked until the handler
+* runs in IRQ mode, so the sample handler reads the PC of its own
+* exception, or of the first one of a tail chain.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Require a BSP built with standalone_pc_sample.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xinterrupt_wrap.h"
+#include "xiltimer.h"
+#include "xil_printf.h"
+#include "amp.h"
+#include "pc_prof.h"
+#include "drvcfg.h"
+#include "bspconfig.h"
+
+#ifndef XIL_PC_SAMPLE
+#error "pc_prof.c needs a BSP built with standalone_pc_sample"
+#endif
+
+/************************** Constant Definitions ****************************/
+
+#define PC_PROF_MIN_SHIFT	2U	/* One bin per instruction */
+#define PC_PROF_MAX_SHIFT	16U
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static void PcProf_InterruptHandler(void *CallBackRef);
+
+/************************** Variable Definitions ****************************/
+
+/* Code the histogram covers, from the linker script */
+extern u8 __text_start[];
+extern u8 __text_end[];
+
+/****************************************************************************/
+/**
+*
+* Gives the size of the histogram for a bin size.
+*
+* @param	BinShift is the log2 of the bytes of code per bin, 2 to 16.
+*
+* @return	The number of bins that cover .text.
+*
+*****************************************************************************/
+u32 PcProf_BinsNeeded(u32 BinShift)
+{
+	u32 Size = (u32)(__text_end - __text_start);
+
+	return (Size + ((1U << BinShift) - 1U)) >> BinShift;
+}
+
+/****************************************************************************/
+/**
+*
+* Sets up the profiler of the calling CPU, stopped, and connects the
+* interrupt of its private watchdog.
+*
+* @param	ProfPtr is a pointer to the profiler.
+* @param	Bins is the histogram, NumBins words. The bins are made as
+*		small as the histogram allows, down to one per instruction;
+*		PcProf_BinsNeeded() gives the words for a bin size.
+* @param	NumBins is the number of bins.
+*
+* @return
+*		- XST_SUCCESS if the profiler is ready.
+*		- XST_INVALID_PARAM if the histogram cannot cover .text.
+*		- XST_FAILURE if the watchdog or its interrupt could not be
+*		set up.
+*
+* @note		Call it on the CPU to profile.
+*
+*****************************************************************************/
+s32 PcProf_Initialize(PcProf *ProfPtr, u32 *Bins, u32 NumBins)
+{
+	XScuWdt_Config *CfgPtr;
+	u32 Shift;
+	u32 Index;
+	s32 Status;
+
+	for (Shift = PC_PROF_MIN_SHIFT; Shift <= PC_PROF_MAX_SHIFT; Shift++) {
+		if (PcProf_BinsNeeded(Shift) <= NumBins) {
+			break;
+		}
+	}
+	if ((Bins == NULL) || (Shift > PC_PROF_MAX_SHIFT)) {
+		return XST_INVALID_PARAM;
+	}
+
+	ProfPtr->Bins = Bins;
+	ProfPtr->NumBins = PcProf_BinsNeeded(Shift);
+	ProfPtr->BinShift = Shift;
+	ProfPtr->LowPc = (UINTPTR)__text_start;
+	ProfPtr->HighPc = (UINTPTR)__text_end;
+	ProfPtr->RateHz = 0U;
+	ProfPtr->CpuId = Amp_CpuId();
+	for (Index = 0U; Index < ProfPtr->NumBins; Index++) {
+		Bins[Index] = 0U;
+	}
+	ProfPtr->Samples = 0U;
+	ProfPtr->Outside = 0U;
+
+	CfgPtr = XScuWdt_LookupConfigStatic(XPAR_XSCUWDT_0_BASEADDR);
+	if (CfgPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	Status = XScuWdt_CfgInitialize(&ProfPtr->Wdt, CfgPtr,
+				       CfgPtr->BaseAddr);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	/* The reset mode, a watchdog cannot be turned back into a timer */
+	XScuWdt_Stop(&ProfPtr->Wdt);
+	XScuWdt_SetTimerMode(&ProfPtr->Wdt);
+	XScuWdt_WriteReg(CfgPtr->BaseAddr, XSCUWDT_ISR_OFFSET,
+			 XSCUWDT_ISR_EVENT_FLAG_MASK);
+
+	Status = XSetupInterruptSystem(ProfPtr, &PcProf_InterruptHandler,
+				       CfgPtr->IntrId, CfgPtr->IntrParent,
+				       PC_PROF_PRIORITY);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Starts sampling, the histogram keeps its counts.
+*
+* @param	ProfPtr is a pointer to the profiler.
+* @param	RateHz is the number of samples per second, or 0 for
+*		PC_PROF_DEFAULT_HZ. Avoid multiples of the rates of periodic
+*		work, whose samples would all fall at the same point.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM if the rate is beyond the
+*		peripheral clock.
+*
+* @note		Call it on the CPU of the profiler.
+*
+*****************************************************************************/
+s32 PcProf_Start(PcProf *ProfPtr, u32 RateHz)
+{
+	u32 Control;
+
+	if (RateHz == 0U) {
+		RateHz = PC_PROF_DEFAULT_HZ;
+	}
+	if (RateHz >= COUNTS_PER_SECOND) {
+		return XST_INVALID_PARAM;
+	}
+	ProfPtr->RateHz = RateHz;
+
+	XScuWdt_Stop(&ProfPtr->Wdt);
+	XScuWdt_LoadWdt(&ProfPtr->Wdt, (COUNTS_PER_SECOND / RateHz) - 1U);
+
+	/* Peripheral clock, auto reload, interrupt on each expiry */
+	Control = XScuWdt_GetControlReg(&ProfPtr->Wdt);
+	Control &= ~XSCUWDT_CONTROL_PRESCALER_MASK;
+	Control |= XSCUWDT_CONTROL_AUTO_RELOAD_MASK |
+		   XSCUWDT_CONTROL_IT_ENABLE_MASK;
+	XScuWdt_SetControlReg(&ProfPtr->Wdt, Control);
+	XScuWdt_Start(&ProfPtr->Wdt);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Stops sampling.
+*
+* @param	ProfPtr is a pointer to the profiler.
+*
+* @return	None.
+*
+*****************************************************************************/
+void PcProf_Stop(PcProf *ProfPtr)
+{
+	XScuWdt_Stop(&ProfPtr->Wdt);
+	ProfPtr->RateHz = 0U;
+}
+
+/****************************************************************************/
+/**
+*
+* Clears the histogram.
+*
+* @param	ProfPtr is a pointer to the profiler.
+*
+* @return	None.
+*
+* @note		Samples taken while it runs may survive it.
+*
+*****************************************************************************/
+void PcProf_Reset(PcProf *ProfPtr)
+{
+	u32 Index;
+
+	for (Index = 0U; Index < ProfPtr->NumBins; Index++) {
+		ProfPtr->Bins[Index] = 0U;
+	}
+	ProfPtr->Samples = 0U;
+	ProfPtr->Outside = 0U;
+}
+
+/****************************************************************************/
+/**
+*
+* Prints the histogram for tools/pc_prof_report.py: a header line
+*
+*	PCPROF <cpu> <low pc> <bin shift> <bins> <samples> <outside> <rate>
+*
+* then "<bin> <count>" for each bin with samples, in hexadecimal, and
+* "PCPROF END".
+*
+* @param	ProfPtr is a pointer to the profiler.
+*
+* @return	None.
+*
+* @note		Sampling may go on meanwhile, the totals are taken first.
+*
+*****************************************************************************/
+void PcProf_Dump(const PcProf *ProfPtr)
+{
+	u32 Index;
+
+	xil_printf("PCPROF %x %x %x %x %x %x %x\r\n", ProfPtr->CpuId,
+		   (u32)ProfPtr->LowPc, ProfPtr->BinShift, ProfPtr->NumBins,
+		   ProfPtr->Samples, ProfPtr->Outside, ProfPtr->RateHz);
+	for (Index = 0U; Index < ProfPtr->NumBins; Index++) {
+		if (ProfPtr->Bins[Index] != 0U) {
+			xil_printf("%x %x\r\n", Index, ProfPtr->Bins[Index]);
+		}
+	}
+	xil_printf("PCPROF END\r\n");
+}
+
+/****************************************************************************/
+/**
+*
+* Takes a sample, from the private watchdog interrupt.
+*
+* @param	CallBackRef is the profiler.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void PcProf_InterruptHandler(void *CallBackRef)
+{
+	PcProf *ProfPtr = (PcProf *)CallBackRef;
+	UINTPTR Pc = (UINTPTR)mfcp(USER_PRIV_THREAD_PID) - 4U;
+
+	XScuWdt_WriteReg(ProfPtr->Wdt.Config.BaseAddr, XSCUWDT_ISR_OFFSET,
+			 XSCUWDT_ISR_EVENT_FLAG_MASK);
+
+	ProfPtr->Samples++;
+	if ((Pc >= ProfPtr->LowPc) && (Pc < ProfPtr->HighPc)) {
+		ProfPtr->Bins[(Pc - ProfPtr->LowPc) >> ProfPtr->BinShift]++;
+	} else {
+		ProfPtr->Outside++;
+	}
+}
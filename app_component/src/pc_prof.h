@@ -0,0 +1,92 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file pc_prof.h
+*
+* Statistical PC sampling profiler for the Cortex-A9.
+*
+* The SCU private watchdog of the CPU, in timer mode, interrupts it
+* PcProf_Start() times a second. The handler takes the PC the IRQ
+* interrupted, which the IRQ vector of a BSP built with the standalone
+* option standalone_pc_sample leaves in TPIDRPRW, and counts it in a
+* histogram of the .text section in DDR, one bin per 2^BinShift bytes of
+* code. The private timer stays free for the timer wheel of timer_wheel.h.
+*
+* The sample interrupt has the highest priority so that it also samples the
+* interrupt handlers that run nested; the time of the other handlers is
+* charged to the code they interrupted. Samples outside .text, such as the
+* OCM hot path, are only counted.
+*
+* PcProf_Dump() prints the histogram with xil_printf(), and
+* tools/pc_prof_report.py maps the bins to the functions of the ELF file.
+* tools/text_order.py turns the same output into text_order.ld, for the
+* linker script to place the hot functions together at the start of .text.
+* A sample takes about 1 us, 0.1% of the CPU at the default 1 kHz, so the
+* profiler can stay in production builds. The watchdog is per CPU, so is
+* the profiler.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Added the hot code order of text_order.ld
+*       qm     10/14/26 Needs a BSP built with standalone_pc_sample.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef PC_PROF_H
+#define PC_PROF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xscuwdt.h"
+
+/************************** Constant Definitions ****************************/
+
+#define PC_PROF_DEFAULT_HZ	1000U	/**< Samples per second */
+#define PC_PROF_PRIORITY	0x08U	/**< GIC priority of the samples */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * A profiler, for the CPU it was initialized on.
+ */
+typedef struct {
+	XScuWdt Wdt;		/**< Private watchdog in timer mode */
+	u32 *Bins;		/**< Sample counts of the histogram */
+	u32 NumBins;
+	u32 BinShift;		/**< Bytes of code per bin, log2 */
+	UINTPTR LowPc;		/**< Code of the first bin */
+	UINTPTR HighPc;		/**< First byte after the code of the bins */
+	volatile u32 Samples;	/**< Samples taken */
+	volatile u32 Outside;	/**< Samples outside of the histogram */
+	u32 RateHz;		/**< Samples per second while running */
+	u32 CpuId;
+} PcProf;
+
+/************************** Function Prototypes *****************************/
+
+s32 PcProf_Initialize(PcProf *ProfPtr, u32 *Bins, u32 NumBins);
+u32 PcProf_BinsNeeded(u32 BinShift);
+s32 PcProf_Start(PcProf *ProfPtr, u32 RateHz);
+void PcProf_Stop(PcProf *ProfPtr);
+void PcProf_Reset(PcProf *ProfPtr);
+void PcProf_Dump(const PcProf *ProfPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PC_PROF_H */
@@ -0,0 +1,277 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file pgo.c
+*
+* Profile dump of the instrumented build. Refer to pgo.h for how it is used.
+*
+* Each object file compiled with -fprofile-info-section leaves a pointer to
+* its gcov_info record in .gcov_info. Pgo_Dump() walks them and puts one
+* entry per record in the stream, each field padded to a word:
+*
+*	u32 NameBytes, the .gcda file name of the record, NUL terminated
+*	u32 DataBytes, the .gcda contents from __gcov_info_to_gcda()
+*
+* The TOPN counters of libgcov need scratch memory while a record is
+* converted; it is taken from the top of the stream buffer, downwards, and
+* given back after each record.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#if defined (PGO_GENERATE)
+
+#include <string.h>
+#include <gcov.h>
+#include "xstatus.h"
+#include "xil_printf.h"
+#include "xil_cache.h"
+#include "xil_hotpath.h"
+#include "pgo.h"
+
+/************************** Constant Definitions ****************************/
+
+#define PGO_LINE_WORDS		8U	/* Words per line printed */
+
+/**************************** Type Definitions ******************************/
+
+/*
+ * Where the dump of a record stands.
+ */
+typedef struct {
+	u32 Head;		/* Next byte of the stream */
+	u32 Scratch;		/* Lowest byte given to libgcov */
+	u32 LengthAt;		/* DataBytes of the record being dumped */
+	u32 Overflow;		/* The stream did not fit */
+} PgoCursor;
+
+/************************** Function Prototypes *****************************/
+
+static void Pgo_Put(const void *Bytes, unsigned NumBytes, void *Arg);
+static void Pgo_Name(const char *Name, void *Arg);
+static void *Pgo_Allocate(unsigned NumBytes, void *Arg);
+static void Pgo_Pad(PgoCursor *CursorPtr);
+static void Pgo_Print(void);
+
+/************************** Variable Definitions ****************************/
+
+/* From the linker script */
+extern const struct gcov_info *const __gcov_info_start[];
+extern const struct gcov_info *const __gcov_info_end[];
+extern u8 __gcov_counters_start[];
+extern u8 __gcov_counters_end[];
+
+/* Not cleared at boot, the DDR would take long */
+PgoStream Pgo_Stream __attribute__((aligned(32))) XIL_NOINIT;
+volatile u32 Pgo_Request;
+
+static u32 Pgo_Seconds;
+
+/****************************************************************************/
+/**
+*
+* Clears the counters of the profile and the stream. The counters outside
+* of the range of the linker script, of objects compiled without
+* -fdata-sections, are not cleared.
+*
+* @return	None.
+*
+*****************************************************************************/
+void Pgo_Reset(void)
+{
+	(void)memset(__gcov_counters_start, 0,
+		     (size_t)(__gcov_counters_end - __gcov_counters_start));
+	Pgo_Stream.Magic = 0U;
+	Pgo_Stream.Length = 0U;
+	Pgo_Stream.Dumps = 0U;
+	Pgo_Request = 0U;
+	Pgo_Seconds = 0U;
+}
+
+/****************************************************************************/
+/**
+*
+* Dumps the profile into Pgo_Stream. The counters go on counting while they
+* are dumped, the profile being statistical anyway.
+*
+* @param	Flags is PGO_DUMP_UART to also print the stream, or 0.
+*
+* @return
+*		- XST_SUCCESS if the stream is complete.
+*		- XST_BUFFER_TOO_SMALL if it does not fit in
+*		PGO_STREAM_BYTES, Pgo_Stream.Magic then stays 0.
+*
+*****************************************************************************/
+s32 Pgo_Dump(u32 Flags)
+{
+	const struct gcov_info *const *InfoPtr;
+	PgoCursor Cursor;
+
+	Pgo_Stream.Magic = 0U;
+	Cursor.Head = 0U;
+	Cursor.Overflow = 0U;
+
+	for (InfoPtr = __gcov_info_start; InfoPtr < __gcov_info_end;
+	     InfoPtr++) {
+		Cursor.Scratch = PGO_STREAM_BYTES;
+		__gcov_info_to_gcda(*InfoPtr, Pgo_Name, Pgo_Put, Pgo_Allocate,
+				    &Cursor);
+		if (Cursor.Overflow != 0U) {
+			break;
+		}
+		*(u32 *)&Pgo_Stream.Data[Cursor.LengthAt] = Cursor.Head -
+			Cursor.LengthAt - 4U;
+		Pgo_Pad(&Cursor);
+	}
+
+	Pgo_Stream.Length = Cursor.Head;
+	Pgo_Stream.Dumps++;
+	if (Cursor.Overflow != 0U) {
+		return XST_BUFFER_TOO_SMALL;
+	}
+	Pgo_Stream.Magic = PGO_MAGIC;
+
+	/* For the debugger, which reads the DDR behind the caches */
+	Xil_DCacheFlushRange((UINTPTR)&Pgo_Stream,
+			     sizeof(Pgo_Stream) - PGO_STREAM_BYTES +
+			     Pgo_Stream.Length);
+
+	if ((Flags & PGO_DUMP_UART) != 0U) {
+		Pgo_Print();
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Dumps the profile when asked to. To be called once a second, from a
+* single context.
+*
+* Pgo_Request set over JTAG dumps into Pgo_Stream only, the debugger being
+* there to read it. With PGO_DUMP_AFTER_S defined, the profile is dumped
+* once that many calls after Pgo_Reset() and printed too, for the runs
+* without a debugger.
+*
+* @return	None.
+*
+*****************************************************************************/
+void Pgo_Poll(void)
+{
+	if (Pgo_Request != 0U) {
+		(void)Pgo_Dump(0U);
+		Pgo_Request = 0U;
+	}
+
+#if defined (PGO_DUMP_AFTER_S)
+	Pgo_Seconds++;
+	if (Pgo_Seconds == (u32)PGO_DUMP_AFTER_S) {
+		(void)Pgo_Dump(PGO_DUMP_UART);
+	}
+#endif
+}
+
+/*
+ * Appends to the stream, the dump callback of __gcov_info_to_gcda(). Once
+ * the stream has overflowed, the rest of the dump is dropped.
+ */
+static void Pgo_Put(const void *Bytes, unsigned NumBytes, void *Arg)
+{
+	PgoCursor *CursorPtr = (PgoCursor *)Arg;
+
+	if ((CursorPtr->Overflow != 0U) ||
+	    (NumBytes > (CursorPtr->Scratch - CursorPtr->Head))) {
+		CursorPtr->Overflow = 1U;
+		return;
+	}
+
+	(void)memcpy(&Pgo_Stream.Data[CursorPtr->Head], Bytes, NumBytes);
+	CursorPtr->Head += NumBytes;
+}
+
+/*
+ * Starts the entry of a record with its file name, the file name callback
+ * of __gcov_info_to_gcda(), and leaves room for the length of its data.
+ */
+static void Pgo_Name(const char *Name, void *Arg)
+{
+	PgoCursor *CursorPtr = (PgoCursor *)Arg;
+	u32 NumBytes = 0U;
+
+	if (Name != NULL) {
+		NumBytes = (u32)strlen(Name) + 1U;
+	}
+
+	Pgo_Put(&NumBytes, sizeof(NumBytes), CursorPtr);
+	Pgo_Put(Name, NumBytes, CursorPtr);
+	Pgo_Pad(CursorPtr);
+
+	CursorPtr->LengthAt = CursorPtr->Head;
+	NumBytes = 0U;
+	Pgo_Put(&NumBytes, sizeof(NumBytes), CursorPtr);
+}
+
+/*
+ * Gives libgcov scratch memory from the top of the stream buffer, the
+ * allocation callback of __gcov_info_to_gcda(). libgcov does not check
+ * for NULL: when the stream and the scratch meet, the stream is marked
+ * overflowed and its start given instead.
+ */
+static void *Pgo_Allocate(unsigned NumBytes, void *Arg)
+{
+	PgoCursor *CursorPtr = (PgoCursor *)Arg;
+	u32 Bytes = ((u32)NumBytes + 7U) & ~7U;
+
+	if (Bytes > (CursorPtr->Scratch - CursorPtr->Head)) {
+		CursorPtr->Overflow = 1U;
+		return Pgo_Stream.Data;
+	}
+
+	CursorPtr->Scratch -= Bytes;
+	return &Pgo_Stream.Data[CursorPtr->Scratch];
+}
+
+/*
+ * Pads the stream to a word with zeros.
+ */
+static void Pgo_Pad(PgoCursor *CursorPtr)
+{
+	static const u8 Zeros[3] = {0U};
+
+	Pgo_Put(Zeros, (4U - (CursorPtr->Head & 3U)) & 3U, CursorPtr);
+}
+
+/*
+ * Prints the stream, in words, for tools/pgo_extract.py to take from the
+ * console.
+ */
+static void Pgo_Print(void)
+{
+	const u32 *Words = (const u32 *)Pgo_Stream.Data;
+	u32 NumWords = Pgo_Stream.Length / 4U;
+	u32 Index;
+
+	xil_printf("PGO %x %x\r\n", Pgo_Stream.Length, Pgo_Stream.Dumps);
+	for (Index = 0U; Index < NumWords; Index++) {
+		xil_printf("%08x%s", Words[Index],
+			   (((Index + 1U) % PGO_LINE_WORDS) == 0U) ||
+			   ((Index + 1U) == NumWords) ? "\r\n" : " ");
+	}
+	xil_printf("PGO END\r\n");
+}
+
+#endif /* PGO_GENERATE */
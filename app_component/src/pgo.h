@@ -0,0 +1,105 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file pgo.h
+*
+* Profile-guided optimization of the application, taking the profile from
+* a representative run on the board.
+*
+* The instrumented build is compiled with PGO_GENERATE defined and
+* -fprofile-generate=<dir> -fprofile-info-section
+* -fprofile-update=prefer-atomic -fdata-sections, refer to UserConfig.cmake.
+* The arc counters then sit together in .bss in DDR, between
+* __gcov_counters_start and __gcov_counters_end of the linker script, and
+* the records of libgcov describing them in .gcov_info. Nothing is written
+* at exit, there is no file system to write the .gcda files to: Pgo_Dump()
+* serializes the records and counters with __gcov_info_to_gcda() into the
+* stream that gcov-tool merge-stream turns back into .gcda files.
+*
+* The stream is kept in Pgo_Stream in DDR, for the debugger to read over
+* JTAG, and Pgo_Dump() with PGO_DUMP_UART also prints it with xil_printf().
+* tools/pgo_extract.py takes either and writes the .gcda files, or feeds
+* gcov-tool merge-stream to add up several runs:
+*
+*	xsct% mwr &Pgo_Request 1
+*	xsct% mrd -bin -file pgo.bin &Pgo_Stream <words>
+*	$ pgo_extract.py pgo.bin
+*
+* Pgo_Poll(), called from the main loop once a second, dumps when the
+* debugger sets Pgo_Request, and once PGO_DUMP_AFTER_S seconds after
+* Pgo_Reset() when that is defined. Pgo_Reset() clears the counters, so
+* that the profile holds the steady state of the bridge and not the boot.
+*
+* The release build is then compiled from the same build directory, the
+* .gcda files being named after the objects, with -fprofile-use=<dir>
+* -fprofile-partial-training and the optimization level raised, for the
+* branch layout and the inlining to follow the profile. In the other
+* builds pgo.c compiles to nothing.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef PGO_H
+#define PGO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions ****************************/
+
+#define PGO_MAGIC		0x4F47504FU	/**< "OPGO" */
+
+#ifndef PGO_STREAM_BYTES
+#define PGO_STREAM_BYTES	(512U * 1024U)	/**< Room for the stream */
+#endif
+
+/** @name Flags of Pgo_Dump()
+ * @{
+ */
+#define PGO_DUMP_UART		0x1U	/**< Also print the stream */
+/* @} */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * The stream of the last dump, as JTAG reads it.
+ */
+typedef struct {
+	u32 Magic;		/**< PGO_MAGIC once a dump is complete */
+	u32 Length;		/**< Bytes of the stream in Data */
+	u32 Dumps;		/**< Dumps done since Pgo_Reset() */
+	u8 Data[PGO_STREAM_BYTES]; /**< The gcov-tool merge-stream input */
+} PgoStream;
+
+/************************** Variable Definitions ****************************/
+
+extern PgoStream Pgo_Stream;
+extern volatile u32 Pgo_Request;	/* Set over JTAG to dump */
+
+/************************** Function Prototypes *****************************/
+
+void Pgo_Reset(void);
+s32 Pgo_Dump(u32 Flags);
+void Pgo_Poll(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PGO_H */
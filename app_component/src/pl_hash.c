@@ -0,0 +1,643 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file pl_hash.c
+*
+* Digests on the hashing core of the PL or on the CPU. Refer to pl_hash.h
+* for the messages of the core.
+*
+* On the CPU the CRC-32 is that of uart_frame.c; MD5 and SHA-256 keep the
+* bytes of an unfinished block in the context and hash whole blocks
+* straight from the data of the caller.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "xiltimer.h"
+#include "uart_frame.h"
+#include "pl_hash.h"
+
+/************************** Constant Definitions ****************************/
+
+#define PL_HASH_BLOCK		64U	/* Bytes of a block */
+#define PL_HASH_HDR_SIZE	4U	/* Command word */
+#define PL_HASH_PROBE_WORDS	4U	/* Words of the probe answer */
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define PL_HASH_CMD(Op, Algo, Ctx) \
+	((u32)(Op) | ((u32)(Algo) << 8) | ((u32)(Ctx) << 16))
+
+#define PL_HASH_ROTR(Value, Bits) \
+	(((Value) >> (Bits)) | ((Value) << (32U - (Bits))))
+
+/************************** Function Prototypes *****************************/
+
+static s32 PlHash_Send(PlHash *HashPtr, u32 Length);
+static u32 PlHash_Wait(PlHash *HashPtr, u32 Command, u32 TimeoutUs);
+static void PlHash_Md5Blocks(u32 *Md5, const u8 *Data, u32 NumBlocks);
+static void PlHash_Sha256Blocks(u32 *Sha, const u8 *Data, u32 NumBlocks);
+static void PlHash_CpuBlocks(PlHash_Ctx *CtxPtr, const u8 *Data,
+			     u32 NumBlocks);
+static void PlHash_CpuFinal(PlHash_Ctx *CtxPtr, u8 *DigestPtr);
+
+/************************** Variable Definitions ****************************/
+
+static const u8 PlHash_DigestSizes[PL_HASH_NUM_ALGOS] = { 4U, 16U, 32U };
+
+/* Sines and shifts of RFC 1321 */
+static const u32 PlHash_Md5Sine[64] = {
+	0xd76aa478U, 0xe8c7b756U, 0x242070dbU, 0xc1bdceeeU,
+	0xf57c0fafU, 0x4787c62aU, 0xa8304613U, 0xfd469501U,
+	0x698098d8U, 0x8b44f7afU, 0xffff5bb1U, 0x895cd7beU,
+	0x6b901122U, 0xfd987193U, 0xa679438eU, 0x49b40821U,
+	0xf61e2562U, 0xc040b340U, 0x265e5a51U, 0xe9b6c7aaU,
+	0xd62f105dU, 0x02441453U, 0xd8a1e681U, 0xe7d3fbc8U,
+	0x21e1cde6U, 0xc33707d6U, 0xf4d50d87U, 0x455a14edU,
+	0xa9e3e905U, 0xfcefa3f8U, 0x676f02d9U, 0x8d2a4c8aU,
+	0xfffa3942U, 0x8771f681U, 0x6d9d6122U, 0xfde5380cU,
+	0xa4beea44U, 0x4bdecfa9U, 0xf6bb4b60U, 0xbebfbc70U,
+	0x289b7ec6U, 0xeaa127faU, 0xd4ef3085U, 0x04881d05U,
+	0xd9d4d039U, 0xe6db99e5U, 0x1fa27cf8U, 0xc4ac5665U,
+	0xf4292244U, 0x432aff97U, 0xab9423a7U, 0xfc93a039U,
+	0x655b59c3U, 0x8f0ccc92U, 0xffeff47dU, 0x85845dd1U,
+	0x6fa87e4fU, 0xfe2ce6e0U, 0xa3014314U, 0x4e0811a1U,
+	0xf7537e82U, 0xbd3af235U, 0x2ad7d2bbU, 0xeb86d391U
+};
+
+static const u8 PlHash_Md5Shift[16] = {
+	7U, 12U, 17U, 22U, 5U, 9U, 14U, 20U,
+	4U, 11U, 16U, 23U, 6U, 10U, 15U, 21U
+};
+
+/* Round constants of FIPS 180-4 */
+static const u32 PlHash_Sha256K[64] = {
+	0x428a2f98U, 0x71374491U, 0xb5c0fbcfU, 0xe9b5dba5U,
+	0x3956c25bU, 0x59f111f1U, 0x923f82a4U, 0xab1c5ed5U,
+	0xd807aa98U, 0x12835b01U, 0x243185beU, 0x550c7dc3U,
+	0x72be5d74U, 0x80deb1feU, 0x9bdc06a7U, 0xc19bf174U,
+	0xe49b69c1U, 0xefbe4786U, 0x0fc19dc6U, 0x240ca1ccU,
+	0x2de92c6fU, 0x4a7484aaU, 0x5cb0a9dcU, 0x76f988daU,
+	0x983e5152U, 0xa831c66dU, 0xb00327c8U, 0xbf597fc7U,
+	0xc6e00bf3U, 0xd5a79147U, 0x06ca6351U, 0x14292967U,
+	0x27b70a85U, 0x2e1b2138U, 0x4d2c6dfcU, 0x53380d13U,
+	0x650a7354U, 0x766a0abbU, 0x81c2c92eU, 0x92722c85U,
+	0xa2bfe8a1U, 0xa81a664bU, 0xc24b8b70U, 0xc76c51a3U,
+	0xd192e819U, 0xd6990624U, 0xf40e3585U, 0x106aa070U,
+	0x19a4c116U, 0x1e376c08U, 0x2748774cU, 0x34b0bcb5U,
+	0x391c0cb3U, 0x4ed8aa4aU, 0x5b9cca4fU, 0x682e6ff3U,
+	0x748f82eeU, 0x78a5636fU, 0x84c87814U, 0x8cc70208U,
+	0x90befffaU, 0xa4506cebU, 0xbef9a3f7U, 0xc67178f2U
+};
+
+static const u32 PlHash_Md5Init[4] = {
+	0x67452301U, 0xefcdab89U, 0x98badcfeU, 0x10325476U
+};
+
+static const u32 PlHash_Sha256Init[8] = {
+	0x6a09e667U, 0xbb67ae85U, 0x3c6ef372U, 0xa54ff53aU,
+	0x510e527fU, 0x9b05688cU, 0x1f83d9abU, 0x5be0cd19U
+};
+
+/****************************************************************************/
+/**
+*
+* Sets up the digests and probes the hashing core through a mailbox.
+*
+* @param	HashPtr is a pointer to the core.
+* @param	MboxPtr is the mailbox of the core, initialized, or NULL to
+*		hash on the CPU only.
+*
+* @return	XST_SUCCESS, the core found or not.
+*
+* @note		The bitstream must be loaded before the probe.
+*
+*****************************************************************************/
+s32 PlHash_Initialize(PlHash *HashPtr, BramMbox *MboxPtr)
+{
+	u32 MaxChunk;
+
+	(void)memset(HashPtr, 0, sizeof(*HashPtr));
+
+	if (MboxPtr == NULL) {
+		return XST_SUCCESS;
+	}
+
+	/* A message takes at most half a ring, its length word included */
+	MaxChunk = (MboxPtr->TxSize / 2U) - 4U - PL_HASH_HDR_SIZE;
+	HashPtr->MboxPtr = MboxPtr;
+	HashPtr->Chunk = (MaxChunk < PL_HASH_CHUNK) ? (MaxChunk & ~3U) :
+			 PL_HASH_CHUNK;
+
+	HashPtr->Message[0] = PL_HASH_CMD(PL_HASH_OP_PROBE, 0U, 0U);
+	if ((PlHash_Send(HashPtr, 0U) != XST_SUCCESS) ||
+	    (PlHash_Wait(HashPtr, HashPtr->Message[0],
+			 PL_HASH_PROBE_US) <
+	     (PL_HASH_PROBE_WORDS * 4U)) ||
+	    (HashPtr->Message[1] != PL_HASH_MAGIC)) {
+		HashPtr->MboxPtr = NULL;
+		return XST_SUCCESS;
+	}
+
+	HashPtr->Algos = HashPtr->Message[2] &
+			 (((u32)1U << PL_HASH_NUM_ALGOS) - 1U);
+	HashPtr->NumCtx = (HashPtr->Message[3] < PL_HASH_MAX_CTX) ?
+			  HashPtr->Message[3] : PL_HASH_MAX_CTX;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Tells whether the core has an algorithm.
+*
+* @param	HashPtr is a pointer to the core.
+* @param	Algo is one of the PL_HASH_* algorithms.
+*
+* @return	1 if its digests can run on the core, 0 otherwise.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 PlHash_OnFabric(const PlHash *HashPtr, u32 Algo)
+{
+	if ((HashPtr == NULL) || (HashPtr->MboxPtr == NULL) ||
+	    (HashPtr->NumCtx == 0U) || (Algo >= PL_HASH_NUM_ALGOS)) {
+		return 0U;
+	}
+
+	return (HashPtr->Algos >> Algo) & 1U;
+}
+
+/****************************************************************************/
+/**
+*
+* Gives the size of the digests of an algorithm.
+*
+* @param	Algo is one of the PL_HASH_* algorithms.
+*
+* @return	The bytes of a digest, 0 for an unknown algorithm.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 PlHash_DigestSize(u32 Algo)
+{
+	return (Algo < PL_HASH_NUM_ALGOS) ? PlHash_DigestSizes[Algo] : 0U;
+}
+
+/****************************************************************************/
+/**
+*
+* Starts a digest, on the core when it has the algorithm and a free
+* context, on the CPU otherwise.
+*
+* @param	CtxPtr is a pointer to the digest.
+* @param	HashPtr is a pointer to the core, or NULL for the CPU.
+* @param	Algo is one of the PL_HASH_* algorithms.
+*
+* @return
+*		- XST_SUCCESS if the digest is started.
+*		- XST_INVALID_PARAM for an unknown algorithm.
+*
+* @note		A digest started must be ended by PlHash_Final(), which
+*		frees its context of the core.
+*
+*****************************************************************************/
+s32 PlHash_Init(PlHash_Ctx *CtxPtr, PlHash *HashPtr, u32 Algo)
+{
+	u32 Ctx;
+
+	if (Algo >= PL_HASH_NUM_ALGOS) {
+		return XST_INVALID_PARAM;
+	}
+
+	(void)memset(CtxPtr, 0, sizeof(*CtxPtr));
+	CtxPtr->HashPtr = HashPtr;
+	CtxPtr->Algo = Algo;
+	CtxPtr->Status = XST_SUCCESS;
+
+	if (PlHash_OnFabric(HashPtr, Algo) != 0U) {
+		for (Ctx = 0U; Ctx < HashPtr->NumCtx; Ctx++) {
+			if ((HashPtr->CtxBusy & ((u32)1U << Ctx)) == 0U) {
+				break;
+			}
+		}
+		if (Ctx < HashPtr->NumCtx) {
+			HashPtr->Message[0] = PL_HASH_CMD(PL_HASH_OP_INIT, Algo,
+							  Ctx);
+			if (PlHash_Send(HashPtr, 0U) == XST_SUCCESS) {
+				HashPtr->CtxBusy |= (u32)1U << Ctx;
+				CtxPtr->OnFabric = 1U;
+				CtxPtr->Ctx = Ctx;
+				return XST_SUCCESS;
+			}
+		}
+	}
+
+	if (Algo == PL_HASH_MD5) {
+		(void)memcpy(CtxPtr->State, PlHash_Md5Init,
+			     sizeof(PlHash_Md5Init));
+	} else if (Algo == PL_HASH_SHA256) {
+		(void)memcpy(CtxPtr->State, PlHash_Sha256Init,
+			     sizeof(PlHash_Sha256Init));
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Adds bytes to a digest.
+*
+* @param	CtxPtr is a pointer to the digest.
+* @param	DataPtr is the bytes.
+* @param	Length is their number.
+*
+* @return
+*		- XST_SUCCESS if the bytes are taken.
+*		- XST_FAILURE if the core did not make room for them, the
+*		  digest is lost; PlHash_Final() returns the same.
+*
+* @note		The core may still be reading the bytes on return, from
+*		the mailbox they were copied to.
+*
+*****************************************************************************/
+s32 PlHash_Update(PlHash_Ctx *CtxPtr, const void *DataPtr, u32 Length)
+{
+	PlHash *HashPtr = CtxPtr->HashPtr;
+	const u8 *Data = (const u8 *)DataPtr;
+	u32 Count;
+
+	if (CtxPtr->Status != XST_SUCCESS) {
+		return CtxPtr->Status;
+	}
+	CtxPtr->NumBytes += Length;
+
+	if (CtxPtr->OnFabric != 0U) {
+		HashPtr->Message[0] = PL_HASH_CMD(PL_HASH_OP_UPDATE,
+						  CtxPtr->Algo, CtxPtr->Ctx);
+		while (Length != 0U) {
+			Count = (Length < HashPtr->Chunk) ? Length :
+				HashPtr->Chunk;
+			(void)memcpy(&HashPtr->Message[1], Data, Count);
+			CtxPtr->Status = PlHash_Send(HashPtr, Count);
+			if (CtxPtr->Status != XST_SUCCESS) {
+				break;
+			}
+			Data += Count;
+			Length -= Count;
+		}
+		return CtxPtr->Status;
+	}
+
+	if (CtxPtr->Algo == PL_HASH_CRC32) {
+		CtxPtr->State[0] = UartFrame_Crc32(CtxPtr->State[0], Data,
+						   Length);
+		return XST_SUCCESS;
+	}
+
+	/* Fill the bytes left over, then whole blocks from the data */
+	if (CtxPtr->Rest != 0U) {
+		Count = PL_HASH_BLOCK - CtxPtr->Rest;
+		if (Count > Length) {
+			Count = Length;
+		}
+		(void)memcpy(&CtxPtr->Block[CtxPtr->Rest], Data, Count);
+		CtxPtr->Rest += Count;
+		Data += Count;
+		Length -= Count;
+		if (CtxPtr->Rest < PL_HASH_BLOCK) {
+			return XST_SUCCESS;
+		}
+		PlHash_CpuBlocks(CtxPtr, CtxPtr->Block, 1U);
+		CtxPtr->Rest = 0U;
+	}
+
+	PlHash_CpuBlocks(CtxPtr, Data, Length / PL_HASH_BLOCK);
+	Count = Length % PL_HASH_BLOCK;
+	(void)memcpy(CtxPtr->Block, &Data[Length - Count], Count);
+	CtxPtr->Rest = Count;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Ends a digest and gives it, waiting for the core when it runs there.
+*
+* @param	CtxPtr is a pointer to the digest.
+* @param	DigestPtr is where the digest is written, PlHash_DigestSize()
+*		bytes.
+*
+* @return
+*		- XST_SUCCESS if the digest is written.
+*		- XST_FAILURE if the core lost it or did not answer in time.
+*
+* @note		The context of the core is freed in any case.
+*
+*****************************************************************************/
+s32 PlHash_Final(PlHash_Ctx *CtxPtr, u8 *DigestPtr)
+{
+	PlHash *HashPtr = CtxPtr->HashPtr;
+	u32 Size = PlHash_DigestSizes[CtxPtr->Algo];
+	s32 Status = CtxPtr->Status;
+
+	if (CtxPtr->OnFabric == 0U) {
+		if (Status == XST_SUCCESS) {
+			PlHash_CpuFinal(CtxPtr, DigestPtr);
+			if (HashPtr != NULL) {
+				HashPtr->Stats.CpuDigests++;
+				HashPtr->Stats.CpuBytes += CtxPtr->NumBytes;
+			}
+		}
+		return Status;
+	}
+
+	if (Status == XST_SUCCESS) {
+		HashPtr->Message[0] = PL_HASH_CMD(PL_HASH_OP_FINAL,
+						  CtxPtr->Algo, CtxPtr->Ctx);
+		Status = PlHash_Send(HashPtr, 0U);
+	}
+	if ((Status == XST_SUCCESS) &&
+	    (PlHash_Wait(HashPtr, PL_HASH_CMD(PL_HASH_OP_FINAL, CtxPtr->Algo,
+					      CtxPtr->Ctx),
+			 PL_HASH_TIMEOUT_US) < (PL_HASH_HDR_SIZE + Size))) {
+		Status = XST_FAILURE;
+	}
+
+	HashPtr->CtxBusy &= ~((u32)1U << CtxPtr->Ctx);
+	CtxPtr->OnFabric = 0U;
+	if (Status != XST_SUCCESS) {
+		HashPtr->Stats.Timeouts++;
+		return Status;
+	}
+
+	(void)memcpy(DigestPtr, &HashPtr->Message[1], Size);
+	HashPtr->Stats.FabricDigests++;
+	HashPtr->Stats.FabricBytes += CtxPtr->NumBytes;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Gives the counts of the digests of the core and of the CPU begun with it.
+*
+* @param	HashPtr is a pointer to the core.
+* @param	StatsPtr is where the counts are copied.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void PlHash_GetStats(const PlHash *HashPtr, PlHash_Stats *StatsPtr)
+{
+	*StatsPtr = HashPtr->Stats;
+}
+
+/****************************************************************************/
+/*
+*
+* Sends the message of the core, its command word and Length bytes after
+* it, waiting for room up to PL_HASH_TIMEOUT_US.
+*
+* @param	HashPtr is a pointer to the core.
+* @param	Length is the bytes after the command word.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if there was no room in time.
+*
+*****************************************************************************/
+static s32 PlHash_Send(PlHash *HashPtr, u32 Length)
+{
+	XTime Limit = ((XTime)PL_HASH_TIMEOUT_US * COUNTS_PER_SECOND) /
+		      1000000U;
+	XTime Start;
+	XTime Now;
+
+	XTime_GetTime(&Start);
+	do {
+		if (BramMbox_Send(HashPtr->MboxPtr, HashPtr->Message,
+				  PL_HASH_HDR_SIZE + Length) == XST_SUCCESS) {
+			return XST_SUCCESS;
+		}
+		XTime_GetTime(&Now);
+	} while ((Now - Start) < Limit);
+
+	return XST_FAILURE;
+}
+
+/****************************************************************************/
+/*
+*
+* Waits for the answer to a command into the message of the core. Answers
+* to other commands, late ones to a probe, are dropped.
+*
+* @param	HashPtr is a pointer to the core.
+* @param	Command is the command word of the answer.
+* @param	TimeoutUs is the longest wait.
+*
+* @return	The length of the answer, 0 if it did not come in time.
+*
+*****************************************************************************/
+static u32 PlHash_Wait(PlHash *HashPtr, u32 Command, u32 TimeoutUs)
+{
+	XTime Limit = ((XTime)TimeoutUs * COUNTS_PER_SECOND) / 1000000U;
+	XTime Start;
+	XTime Now;
+	u32 Length;
+
+	XTime_GetTime(&Start);
+	do {
+		Length = BramMbox_Receive(HashPtr->MboxPtr, HashPtr->Message,
+					  sizeof(HashPtr->Message));
+		if ((Length >= PL_HASH_HDR_SIZE) &&
+		    (HashPtr->Message[0] == Command)) {
+			return Length;
+		}
+		XTime_GetTime(&Now);
+	} while ((Now - Start) < Limit);
+
+	return 0U;
+}
+
+/*
+ * Adds whole 64 byte blocks to an MD5, the Cortex-A9 being little endian
+ * as MD5 is.
+ */
+static void PlHash_Md5Blocks(u32 *Md5, const u8 *Data, u32 NumBlocks)
+{
+	u32 Words[16];
+	u32 A;
+	u32 B;
+	u32 C;
+	u32 D;
+	u32 F;
+	u32 G;
+	u32 Step;
+	u32 Shift;
+
+	while (NumBlocks-- != 0U) {
+		(void)memcpy(Words, Data, sizeof(Words));
+		Data += PL_HASH_BLOCK;
+		A = Md5[0];
+		B = Md5[1];
+		C = Md5[2];
+		D = Md5[3];
+
+		for (Step = 0U; Step < 64U; Step++) {
+			if (Step < 16U) {
+				F = D ^ (B & (C ^ D));
+				G = Step;
+			} else if (Step < 32U) {
+				F = C ^ (D & (B ^ C));
+				G = ((5U * Step) + 1U) & 15U;
+			} else if (Step < 48U) {
+				F = B ^ C ^ D;
+				G = ((3U * Step) + 5U) & 15U;
+			} else {
+				F = C ^ (B | ~D);
+				G = (7U * Step) & 15U;
+			}
+			F += A + PlHash_Md5Sine[Step] + Words[G];
+			Shift = PlHash_Md5Shift[((Step >> 4) << 2) +
+						(Step & 3U)];
+			A = D;
+			D = C;
+			C = B;
+			B += (F << Shift) | (F >> (32U - Shift));
+		}
+
+		Md5[0] += A;
+		Md5[1] += B;
+		Md5[2] += C;
+		Md5[3] += D;
+	}
+}
+
+/*
+ * Adds whole 64 byte blocks to a SHA-256, whose words are big endian.
+ */
+static void PlHash_Sha256Blocks(u32 *Sha, const u8 *Data, u32 NumBlocks)
+{
+	u32 W[64];
+	u32 V[8];
+	u32 T1;
+	u32 T2;
+	u32 Step;
+
+	while (NumBlocks-- != 0U) {
+		for (Step = 0U; Step < 16U; Step++) {
+			W[Step] = ((u32)Data[0] << 24) | ((u32)Data[1] << 16) |
+				  ((u32)Data[2] << 8) | (u32)Data[3];
+			Data += 4;
+		}
+		for (Step = 16U; Step < 64U; Step++) {
+			T1 = W[Step - 2U];
+			T2 = W[Step - 15U];
+			W[Step] = (PL_HASH_ROTR(T1, 17U) ^
+				   PL_HASH_ROTR(T1, 19U) ^ (T1 >> 10)) +
+				  W[Step - 7U] +
+				  (PL_HASH_ROTR(T2, 7U) ^
+				   PL_HASH_ROTR(T2, 18U) ^ (T2 >> 3)) +
+				  W[Step - 16U];
+		}
+		(void)memcpy(V, Sha, sizeof(V));
+
+		for (Step = 0U; Step < 64U; Step++) {
+			T1 = V[7] + (PL_HASH_ROTR(V[4], 6U) ^
+				     PL_HASH_ROTR(V[4], 11U) ^
+				     PL_HASH_ROTR(V[4], 25U)) +
+			     (V[6] ^ (V[4] & (V[5] ^ V[6]))) +
+			     PlHash_Sha256K[Step] + W[Step];
+			T2 = (PL_HASH_ROTR(V[0], 2U) ^
+			      PL_HASH_ROTR(V[0], 13U) ^
+			      PL_HASH_ROTR(V[0], 22U)) +
+			     ((V[0] & V[1]) | (V[2] & (V[0] | V[1])));
+			V[7] = V[6];
+			V[6] = V[5];
+			V[5] = V[4];
+			V[4] = V[3] + T1;
+			V[3] = V[2];
+			V[2] = V[1];
+			V[1] = V[0];
+			V[0] = T1 + T2;
+		}
+
+		for (Step = 0U; Step < 8U; Step++) {
+			Sha[Step] += V[Step];
+		}
+	}
+}
+
+/*
+ * Adds whole blocks to the MD5 or the SHA-256 of a digest on the CPU.
+ */
+static void PlHash_CpuBlocks(PlHash_Ctx *CtxPtr, const u8 *Data,
+			     u32 NumBlocks)
+{
+	if (CtxPtr->Algo == PL_HASH_MD5) {
+		PlHash_Md5Blocks(CtxPtr->State, Data, NumBlocks);
+	} else {
+		PlHash_Sha256Blocks(CtxPtr->State, Data, NumBlocks);
+	}
+}
+
+/*
+ * Ends a digest on the CPU: pads the bytes left over with the bit length,
+ * little endian for MD5 and big endian for SHA-256, and writes the state.
+ */
+static void PlHash_CpuFinal(PlHash_Ctx *CtxPtr, u8 *DigestPtr)
+{
+	u8 Block[2U * PL_HASH_BLOCK];
+	u32 Blocks = (CtxPtr->Rest < (PL_HASH_BLOCK - 8U)) ? 1U : 2U;
+	u32 End = Blocks * PL_HASH_BLOCK;
+	u64 Bits = CtxPtr->NumBytes * 8U;
+	u32 Index;
+
+	if (CtxPtr->Algo == PL_HASH_CRC32) {
+		(void)memcpy(DigestPtr, CtxPtr->State, 4U);
+		return;
+	}
+
+	(void)memset(Block, 0, sizeof(Block));
+	(void)memcpy(Block, CtxPtr->Block, CtxPtr->Rest);
+	Block[CtxPtr->Rest] = 0x80U;
+	for (Index = 0U; Index < 8U; Index++) {
+		if (CtxPtr->Algo == PL_HASH_MD5) {
+			Block[End - 8U + Index] = (u8)(Bits >> (8U * Index));
+		} else {
+			Block[End - 1U - Index] = (u8)(Bits >> (8U * Index));
+		}
+	}
+	PlHash_CpuBlocks(CtxPtr, Block, Blocks);
+
+	if (CtxPtr->Algo == PL_HASH_MD5) {
+		(void)memcpy(DigestPtr, CtxPtr->State, 16U);
+		return;
+	}
+	for (Index = 0U; Index < 32U; Index++) {
+		DigestPtr[Index] = (u8)(CtxPtr->State[Index / 4U] >>
+					(24U - (8U * (Index % 4U))));
+	}
+}
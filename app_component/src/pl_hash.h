@@ -0,0 +1,143 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file pl_hash.h
+*
+* CRC-32, MD5 and SHA-256 with one init, update and final interface, run by
+* a hashing core in the PL when the bitstream has one and by the CPU
+* otherwise.
+*
+* The core is fed through the BRAM mailbox of bram_mbox.h. A message to
+* the core starts with a command word, PL_HASH_OP_* in its low byte, the
+* algorithm in the next and the context of the core in the upper half:
+*	- PL_HASH_OP_PROBE: the core answers with the command word,
+*	  PL_HASH_MAGIC, the mask of the algorithms it has, bit per
+*	  PL_HASH_* number, and the number of its contexts.
+*	- PL_HASH_OP_INIT: starts a digest in the context.
+*	- PL_HASH_OP_UPDATE: the bytes after the command word go into it.
+*	- PL_HASH_OP_FINAL: the core answers with the command word and the
+*	  digest, and frees the context.
+* The messages of a context are taken by the core in order; an update is
+* not answered, so that the CPU only waits for the digest. An update is cut
+* into messages of PL_HASH_CHUNK bytes at most, or less when the ring of
+* the mailbox is small. The same messages could go over an AXI DMA stream.
+*
+* PlHash_Initialize() probes the core. PlHash_Init() then puts a digest on
+* the core when the core has the algorithm and a free context, on the CPU
+* otherwise, and the caller does not see the difference: the digests are
+* the same, the CRC-32 that of UartFrame_Crc32() in little endian, MD5 that
+* of RFC 1321, SHA-256 that of FIPS 180-4. Without a mailbox, or when the
+* core does not answer the probe, every digest runs on the CPU.
+*
+* One context of the caller drives the mailbox, it must not be used by
+* anything else.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef PL_HASH_H
+#define PL_HASH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "bram_mbox.h"
+
+/************************** Constant Definitions ****************************/
+
+/** @name Algorithms
+ * @{
+ */
+#define PL_HASH_CRC32		0U
+#define PL_HASH_MD5		1U
+#define PL_HASH_SHA256		2U
+#define PL_HASH_NUM_ALGOS	3U
+/* @} */
+
+/** @name Commands of the core
+ * @{
+ */
+#define PL_HASH_OP_PROBE	1U
+#define PL_HASH_OP_INIT		2U
+#define PL_HASH_OP_UPDATE	3U
+#define PL_HASH_OP_FINAL	4U
+/* @} */
+
+#define PL_HASH_MAGIC		0x48534850U /**< "PHSH", probe answer */
+#define PL_HASH_MAX_DIGEST	32U	/**< Longest digest, bytes */
+#define PL_HASH_CHUNK		1024U	/**< Update message, bytes */
+#define PL_HASH_MAX_CTX		32U	/**< Core contexts used */
+#define PL_HASH_PROBE_US	1000U	/**< Wait for the probe answer */
+#define PL_HASH_TIMEOUT_US	10000U	/**< Wait for room, a digest */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Counts of the digests.
+ */
+typedef struct {
+	u32 FabricDigests;	/**< Digests of the core */
+	u32 CpuDigests;		/**< Digests of the CPU */
+	u64 FabricBytes;	/**< Bytes hashed by the core */
+	u64 CpuBytes;		/**< Bytes hashed by the CPU */
+	u32 Timeouts;		/**< Digests the core did not answer */
+} PlHash_Stats;
+
+/**
+ * The hashing core and its mailbox.
+ */
+typedef struct {
+	BramMbox *MboxPtr;	/**< NULL for the CPU only */
+	u32 Algos;		/**< Algorithms of the core, 0 if none */
+	u32 NumCtx;		/**< Contexts of the core */
+	u32 CtxBusy;		/**< Contexts in use, bit per context */
+	u32 Chunk;		/**< Bytes of an update message */
+	u32 Message[(PL_HASH_CHUNK / 4U) + 1U]; /**< Command and bytes */
+	PlHash_Stats Stats;
+} PlHash;
+
+/**
+ * A digest being computed.
+ */
+typedef struct {
+	PlHash *HashPtr;	/**< Given to PlHash_Init(), or NULL */
+	u32 OnFabric;		/**< The digest runs on the core */
+	u32 Algo;
+	u32 Ctx;		/**< Context of the core */
+	s32 Status;		/**< First error of the updates */
+	u64 NumBytes;
+	u32 State[8];		/**< Of the CPU */
+	u32 Rest;		/**< Bytes in Block */
+	u8 Block[64];		/**< Start of the next block of the CPU */
+} PlHash_Ctx;
+
+/************************** Function Prototypes *****************************/
+
+s32 PlHash_Initialize(PlHash *HashPtr, BramMbox *MboxPtr);
+u32 PlHash_OnFabric(const PlHash *HashPtr, u32 Algo);
+u32 PlHash_DigestSize(u32 Algo);
+s32 PlHash_Init(PlHash_Ctx *CtxPtr, PlHash *HashPtr, u32 Algo);
+s32 PlHash_Update(PlHash_Ctx *CtxPtr, const void *DataPtr, u32 Length);
+s32 PlHash_Final(PlHash_Ctx *CtxPtr, u8 *DigestPtr);
+void PlHash_GetStats(const PlHash *HashPtr, PlHash_Stats *StatsPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PL_HASH_H */
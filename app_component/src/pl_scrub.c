@@ -0,0 +1,664 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file pl_scrub.c
+*
+* Background scrubbing of the PL configuration. Refer to pl_scrub.h for how
+* the groups are checked and repaired.
+*
+* The packets are those of the 7 series configuration logic (UG470): a
+* readback sends the sync word, resets the CRC, selects RCFG and the frame
+* address and reads FDRO type 2, which returns a pad frame before the frames
+* asked for; a repair selects WCFG and writes the frames to FDRI type 2,
+* followed by a pad frame that pushes the last one out of the frame buffer.
+* Both are followed by a DESYNC, whatever the transfer did, so that nothing
+* else is taken as a packet.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "xil_io.h"
+#include "xil_cache.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "uart_frame.h"
+#include "pl_scrub.h"
+
+/************************** Constant Definitions ****************************/
+
+/* Steps */
+#define PL_SCRUB_IDLE		0U
+#define PL_SCRUB_READING	1U
+#define PL_SCRUB_WRITING	2U
+
+/* Marks the last DMA command of a transfer, on both addresses */
+#define PL_SCRUB_LAST_TRANSFER	1U
+
+/* Polls of a DMA that did not end, an error past those */
+#define PL_SCRUB_MAX_POLLS	100U
+
+/* Spins of the CPU on the short command transfers */
+#define PL_SCRUB_CMD_SPINS	100000U
+
+/* Configuration packets */
+#define PL_SCRUB_DUMMY		0xFFFFFFFFU
+#define PL_SCRUB_SYNC		0xAA995566U
+#define PL_SCRUB_NOOP		0x20000000U
+#define PL_SCRUB_WRITE_CMD	0x30008001U	/* Type 1 write CMD, 1 word */
+#define PL_SCRUB_WRITE_FAR	0x30002001U	/* Type 1 write FAR, 1 word */
+#define PL_SCRUB_WRITE_FDRI	0x30004000U	/* Type 1 write FDRI, 0 words */
+#define PL_SCRUB_READ_FDRO	0x28006000U	/* Type 1 read FDRO, 0 words */
+#define PL_SCRUB_TYPE2_WRITE	0x50000000U	/* | word count */
+#define PL_SCRUB_TYPE2_READ	0x48000000U	/* | word count */
+#define PL_SCRUB_CMD_WCFG	0x00000001U
+#define PL_SCRUB_CMD_RCFG	0x00000004U
+#define PL_SCRUB_CMD_RCRC	0x00000007U
+#define PL_SCRUB_CMD_DESYNC	0x0000000DU
+
+/* NOOPs after the read command, flushing the packet pipeline */
+#define PL_SCRUB_FLUSH_NOOPS	32U
+
+/* Words of a group read back or written, with the pad frame */
+#define PL_SCRUB_GROUP_WORDS	((PL_SCRUB_MAX_FRAMES + 1U) * \
+				 PL_SCRUB_FRAME_WORDS)
+
+/* Words of the readback buffer, whole cache lines */
+#define PL_SCRUB_READ_WORDS	((PL_SCRUB_GROUP_WORDS + 7U) & ~7U)
+
+/* Words of the packets before the frames of a repair, and of a DESYNC */
+#define PL_SCRUB_WRITE_HEAD	14U
+#define PL_SCRUB_DESYNC_WORDS	5U
+
+/* Words of masked data through the CRC at a time */
+#define PL_SCRUB_CRC_WORDS	16U
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static void PlScrub_TimerHandler(void *CallBackRef);
+static void PlScrub_StartRead(PlScrub *ScrubPtr);
+static void PlScrub_Compare(PlScrub *ScrubPtr);
+static s32 PlScrub_StartWrite(PlScrub *ScrubPtr, const u32 *WordPtr,
+			      u32 Words);
+static s32 PlScrub_Send(PlScrub *ScrubPtr, const u32 *WordPtr, u32 Words);
+static s32 PlScrub_Poll(PlScrub *ScrubPtr);
+static void PlScrub_EndStep(PlScrub *ScrubPtr, u32 Next);
+static u32 PlScrub_Crc(const u32 *DataPtr, const u32 *MaskPtr, u32 Words);
+
+/************************** Variable Definitions ****************************/
+
+/* Commands of a readback, the frames read back and the repair packets */
+static u32 PlScrub_ReadCmd[16U + PL_SCRUB_FLUSH_NOOPS]
+	__attribute__((aligned(32)));
+static u32 PlScrub_ReadBuf[PL_SCRUB_READ_WORDS] __attribute__((aligned(32)));
+static u32 PlScrub_WriteBuf[PL_SCRUB_WRITE_HEAD + PL_SCRUB_GROUP_WORDS]
+	__attribute__((aligned(32)));
+
+static const u32 PlScrub_Desync[PL_SCRUB_DESYNC_WORDS]
+	__attribute__((aligned(32))) = {
+	PL_SCRUB_NOOP, PL_SCRUB_WRITE_CMD, PL_SCRUB_CMD_DESYNC,
+	PL_SCRUB_NOOP, PL_SCRUB_NOOP
+};
+
+/****************************************************************************/
+/**
+*
+* Checks a golden table and sets up the scrubber, stopped.
+*
+* @param	ScrubPtr is a pointer to the scrubber.
+* @param	MgrPtr is the partial reconfiguration manager, initialized,
+*		whose PCAP the scrubber borrows.
+* @param	WheelPtr is the timer wheel the steps run from.
+* @param	TablePtr is the golden table of tools/scrub_golden.py, word
+*		aligned.
+* @param	NumBytes is the size of the table.
+*
+* @return
+*		- XST_SUCCESS if the table is good.
+*		- XST_FAILURE if it is not a table of this version, is
+*		  truncated or its CRC is wrong.
+*		- XST_INVALID_PARAM if a group is too large or points past
+*		  the table.
+*
+* @note		The table is used in place and must stay.
+*
+*****************************************************************************/
+s32 PlScrub_Initialize(PlScrub *ScrubPtr, DfxMgr *MgrPtr,
+		       TimerWheel *WheelPtr, const void *TablePtr,
+		       u32 NumBytes)
+{
+	const PlScrub_TableHeader *HeaderPtr =
+		(const PlScrub_TableHeader *)TablePtr;
+	const PlScrub_Group *GroupPtr;
+	u32 Index;
+	u32 Words;
+
+	ScrubPtr->Running = 0U;
+	ScrubPtr->State = PL_SCRUB_IDLE;
+	ScrubPtr->NumGroups = 0U;
+
+	if ((NumBytes < sizeof(PlScrub_TableHeader)) ||
+	    (HeaderPtr->Magic != PL_SCRUB_TABLE_MAGIC) ||
+	    (HeaderPtr->Version != PL_SCRUB_TABLE_VERSION) ||
+	    (HeaderPtr->FrameWords != PL_SCRUB_FRAME_WORDS)) {
+		return XST_FAILURE;
+	}
+	if ((HeaderPtr->NumGroups > ((NumBytes - sizeof(PlScrub_TableHeader)) /
+				     sizeof(PlScrub_Group))) ||
+	    (HeaderPtr->NumWords > ((NumBytes - sizeof(PlScrub_TableHeader) -
+				     (HeaderPtr->NumGroups *
+				      sizeof(PlScrub_Group))) / 4U))) {
+		return XST_FAILURE;
+	}
+
+	GroupPtr = (const PlScrub_Group *)(HeaderPtr + 1);
+	if (UartFrame_Crc32(0U, (const u8 *)GroupPtr,
+			    (HeaderPtr->NumGroups * sizeof(PlScrub_Group)) +
+			    (HeaderPtr->NumWords * 4U)) != HeaderPtr->Crc) {
+		return XST_FAILURE;
+	}
+
+	for (Index = 0U; Index < HeaderPtr->NumGroups; Index++) {
+		if ((GroupPtr[Index].Frames == 0U) ||
+		    (GroupPtr[Index].Frames > PL_SCRUB_MAX_FRAMES)) {
+			return XST_INVALID_PARAM;
+		}
+		Words = GroupPtr[Index].Frames * PL_SCRUB_FRAME_WORDS;
+		if (((GroupPtr[Index].DataOffset != PL_SCRUB_NONE) &&
+		     ((GroupPtr[Index].DataOffset > HeaderPtr->NumWords) ||
+		      (Words > (HeaderPtr->NumWords -
+				GroupPtr[Index].DataOffset)))) ||
+		    ((GroupPtr[Index].MaskOffset != PL_SCRUB_NONE) &&
+		     ((GroupPtr[Index].MaskOffset > HeaderPtr->NumWords) ||
+		      (Words > (HeaderPtr->NumWords -
+				GroupPtr[Index].MaskOffset))))) {
+			return XST_INVALID_PARAM;
+		}
+	}
+
+	ScrubPtr->MgrPtr = MgrPtr;
+	ScrubPtr->WheelPtr = WheelPtr;
+	ScrubPtr->GroupPtr = GroupPtr;
+	ScrubPtr->WordPtr = (const u32 *)&GroupPtr[HeaderPtr->NumGroups];
+	ScrubPtr->NumGroups = HeaderPtr->NumGroups;
+	ScrubPtr->Index = 0U;
+	ScrubPtr->Repaired = 0U;
+	ScrubPtr->Polls = 0U;
+	(void)memset(&ScrubPtr->Stats, 0, sizeof(ScrubPtr->Stats));
+
+	TimerWheel_InitTimer(&ScrubPtr->Timer, PlScrub_TimerHandler, ScrubPtr);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Starts scrubbing, the first step PL_SCRUB_PERIOD_US later.
+*
+* @param	ScrubPtr is a pointer to the scrubber.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void PlScrub_Start(PlScrub *ScrubPtr)
+{
+	u32 Cpsr;
+
+	if (ScrubPtr->NumGroups == 0U) {
+		return;
+	}
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	if (ScrubPtr->Running == 0U) {
+		ScrubPtr->Running = 1U;
+		if (ScrubPtr->State == PL_SCRUB_IDLE) {
+			TimerWheel_Start(ScrubPtr->WheelPtr, &ScrubPtr->Timer,
+					 PL_SCRUB_PERIOD_US);
+		}
+	}
+	mtcpsr(Cpsr);
+}
+
+/****************************************************************************/
+/**
+*
+* Stops scrubbing. A step in progress ends on its own and gives the PCAP
+* back.
+*
+* @param	ScrubPtr is a pointer to the scrubber.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void PlScrub_Stop(PlScrub *ScrubPtr)
+{
+	u32 Cpsr;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	ScrubPtr->Running = 0U;
+	if (ScrubPtr->State == PL_SCRUB_IDLE) {
+		TimerWheel_Cancel(ScrubPtr->WheelPtr, &ScrubPtr->Timer);
+	}
+	mtcpsr(Cpsr);
+}
+
+/****************************************************************************/
+/**
+*
+* Gets the counts of the scrubber.
+*
+* @param	ScrubPtr is a pointer to the scrubber.
+* @param	StatsPtr returns the counts.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void PlScrub_GetStats(const PlScrub *ScrubPtr, PlScrub_Stats *StatsPtr)
+{
+	u32 Cpsr;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	*StatsPtr = ScrubPtr->Stats;
+	mtcpsr(Cpsr);
+}
+
+/****************************************************************************/
+/*
+*
+* Timer handler: starts a step, or polls the DMA of the running one.
+*
+* @param	CallBackRef is the scrubber.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void PlScrub_TimerHandler(void *CallBackRef)
+{
+	PlScrub *ScrubPtr = (PlScrub *)CallBackRef;
+	s32 Status;
+
+	if (ScrubPtr->State == PL_SCRUB_IDLE) {
+		if (DfxMgr_ClaimPcap(ScrubPtr->MgrPtr) != XST_SUCCESS) {
+			ScrubPtr->Stats.Skipped++;
+			PlScrub_EndStep(ScrubPtr, 0U);
+			return;
+		}
+		PlScrub_StartRead(ScrubPtr);
+		return;
+	}
+
+	Status = PlScrub_Poll(ScrubPtr);
+	if ((Status == XST_DEVICE_BUSY) &&
+	    (++ScrubPtr->Polls > PL_SCRUB_MAX_POLLS)) {
+		Status = XST_FAILURE;
+	}
+	if (Status == XST_DEVICE_BUSY) {
+		TimerWheel_Start(ScrubPtr->WheelPtr, &ScrubPtr->Timer,
+				 PL_SCRUB_POLL_US);
+		return;
+	}
+
+	/* The packets end with a DESYNC whatever the transfer did */
+	if (PlScrub_Send(ScrubPtr, PlScrub_Desync,
+			 PL_SCRUB_DESYNC_WORDS) != XST_SUCCESS) {
+		Status = XST_FAILURE;
+	}
+	if (Status != XST_SUCCESS) {
+		ScrubPtr->Stats.PcapErrors++;
+		PlScrub_EndStep(ScrubPtr, 1U);
+		return;
+	}
+
+	if (ScrubPtr->State == PL_SCRUB_READING) {
+		PlScrub_Compare(ScrubPtr);
+	} else {
+		/* Read the group again to check the repair */
+		ScrubPtr->Stats.Repairs++;
+		ScrubPtr->Repaired = 1U;
+		PlScrub_EndStep(ScrubPtr, 0U);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Sends the readback command of the current group and starts the DMA of its
+* frames.
+*
+* @param	ScrubPtr is a pointer to the scrubber, the PCAP claimed.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void PlScrub_StartRead(PlScrub *ScrubPtr)
+{
+	const PlScrub_Group *GroupPtr = &ScrubPtr->GroupPtr[ScrubPtr->Index];
+	XDcfg *DcfgPtr = &ScrubPtr->MgrPtr->Dcfg;
+	u32 Words = (GroupPtr->Frames + 1U) * PL_SCRUB_FRAME_WORDS;
+	u32 *CmdPtr = PlScrub_ReadCmd;
+	u32 Index;
+
+	*CmdPtr++ = PL_SCRUB_DUMMY;
+	*CmdPtr++ = PL_SCRUB_SYNC;
+	*CmdPtr++ = PL_SCRUB_NOOP;
+	*CmdPtr++ = PL_SCRUB_WRITE_CMD;
+	*CmdPtr++ = PL_SCRUB_CMD_RCRC;
+	*CmdPtr++ = PL_SCRUB_NOOP;
+	*CmdPtr++ = PL_SCRUB_NOOP;
+	*CmdPtr++ = PL_SCRUB_WRITE_CMD;
+	*CmdPtr++ = PL_SCRUB_CMD_RCFG;
+	*CmdPtr++ = PL_SCRUB_NOOP;
+	*CmdPtr++ = PL_SCRUB_WRITE_FAR;
+	*CmdPtr++ = GroupPtr->Far;
+	*CmdPtr++ = PL_SCRUB_READ_FDRO;
+	*CmdPtr++ = PL_SCRUB_TYPE2_READ | Words;
+	for (Index = 0U; Index < PL_SCRUB_FLUSH_NOOPS; Index++) {
+		*CmdPtr++ = PL_SCRUB_NOOP;
+	}
+
+	/* No line of the buffer may be written back over the frames */
+	Xil_DCacheInvalidateRange((INTPTR)PlScrub_ReadBuf,
+				  sizeof(PlScrub_ReadBuf));
+
+	if (PlScrub_Send(ScrubPtr, PlScrub_ReadCmd,
+			 (u32)(CmdPtr - PlScrub_ReadCmd)) != XST_SUCCESS) {
+		ScrubPtr->Stats.PcapErrors++;
+		(void)PlScrub_Send(ScrubPtr, PlScrub_Desync,
+				   PL_SCRUB_DESYNC_WORDS);
+		PlScrub_EndStep(ScrubPtr, 1U);
+		return;
+	}
+
+	XDcfg_IntrClear(DcfgPtr, XDCFG_IXR_D_P_DONE_MASK |
+			XDCFG_IXR_ERROR_FLAGS_MASK);
+	XDcfg_InitiateDma(DcfgPtr, XDCFG_DMA_INVALID_ADDRESS |
+			  PL_SCRUB_LAST_TRANSFER,
+			  (u32)(UINTPTR)PlScrub_ReadBuf | PL_SCRUB_LAST_TRANSFER,
+			  0U, Words);
+
+	ScrubPtr->State = PL_SCRUB_READING;
+	ScrubPtr->Polls = 0U;
+	TimerWheel_Start(ScrubPtr->WheelPtr, &ScrubPtr->Timer,
+			 PL_SCRUB_POLL_US);
+}
+
+/****************************************************************************/
+/*
+*
+* Compares the frames read back with the golden CRC of the group and starts
+* the repair of a group that differs.
+*
+* @param	ScrubPtr is a pointer to the scrubber, the frames read back.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void PlScrub_Compare(PlScrub *ScrubPtr)
+{
+	const PlScrub_Group *GroupPtr = &ScrubPtr->GroupPtr[ScrubPtr->Index];
+	u32 Words = GroupPtr->Frames * PL_SCRUB_FRAME_WORDS;
+	const u32 *FramePtr = &PlScrub_ReadBuf[PL_SCRUB_FRAME_WORDS];
+	const u32 *MaskPtr = NULL;
+	const u32 *GoldenPtr;
+	u32 *WordPtr;
+	u32 Index;
+
+	Xil_DCacheInvalidateRange((INTPTR)PlScrub_ReadBuf,
+				  sizeof(PlScrub_ReadBuf));
+
+	if (GroupPtr->MaskOffset != PL_SCRUB_NONE) {
+		MaskPtr = &ScrubPtr->WordPtr[GroupPtr->MaskOffset];
+	}
+
+	ScrubPtr->Stats.Groups++;
+	if (PlScrub_Crc(FramePtr, MaskPtr, Words) == GroupPtr->Crc) {
+		PlScrub_EndStep(ScrubPtr, 1U);
+		return;
+	}
+
+	ScrubPtr->Stats.Upsets++;
+	ScrubPtr->Stats.LastUpsetFar = GroupPtr->Far;
+
+	/* A repair that did not hold, or nothing good to write */
+	if ((ScrubPtr->Repaired != 0U) ||
+	    (GroupPtr->DataOffset == PL_SCRUB_NONE) ||
+	    (PlScrub_Crc(&ScrubPtr->WordPtr[GroupPtr->DataOffset], MaskPtr,
+			 Words) != GroupPtr->Crc)) {
+		ScrubPtr->Stats.Unrepaired++;
+		PlScrub_EndStep(ScrubPtr, 1U);
+		return;
+	}
+	GoldenPtr = &ScrubPtr->WordPtr[GroupPtr->DataOffset];
+
+	WordPtr = PlScrub_WriteBuf;
+	*WordPtr++ = PL_SCRUB_DUMMY;
+	*WordPtr++ = PL_SCRUB_SYNC;
+	*WordPtr++ = PL_SCRUB_NOOP;
+	*WordPtr++ = PL_SCRUB_WRITE_CMD;
+	*WordPtr++ = PL_SCRUB_CMD_RCRC;
+	*WordPtr++ = PL_SCRUB_NOOP;
+	*WordPtr++ = PL_SCRUB_NOOP;
+	*WordPtr++ = PL_SCRUB_WRITE_CMD;
+	*WordPtr++ = PL_SCRUB_CMD_WCFG;
+	*WordPtr++ = PL_SCRUB_NOOP;
+	*WordPtr++ = PL_SCRUB_WRITE_FAR;
+	*WordPtr++ = GroupPtr->Far;
+	*WordPtr++ = PL_SCRUB_WRITE_FDRI;
+	*WordPtr++ = PL_SCRUB_TYPE2_WRITE | (Words + PL_SCRUB_FRAME_WORDS);
+
+	/* The bits the design changes keep the values just read back */
+	for (Index = 0U; Index < Words; Index++) {
+		if (MaskPtr == NULL) {
+			*WordPtr++ = GoldenPtr[Index];
+		} else {
+			*WordPtr++ = (GoldenPtr[Index] & ~MaskPtr[Index]) |
+				     (FramePtr[Index] & MaskPtr[Index]);
+		}
+	}
+	for (Index = 0U; Index < PL_SCRUB_FRAME_WORDS; Index++) {
+		*WordPtr++ = 0U;
+	}
+
+	if (PlScrub_StartWrite(ScrubPtr, PlScrub_WriteBuf,
+			       (u32)(WordPtr - PlScrub_WriteBuf)) !=
+	    XST_SUCCESS) {
+		ScrubPtr->Stats.PcapErrors++;
+		PlScrub_EndStep(ScrubPtr, 1U);
+		return;
+	}
+
+	ScrubPtr->State = PL_SCRUB_WRITING;
+	ScrubPtr->Polls = 0U;
+	TimerWheel_Start(ScrubPtr->WheelPtr, &ScrubPtr->Timer,
+			 PL_SCRUB_POLL_US);
+}
+
+/****************************************************************************/
+/*
+*
+* Starts the DMA of packets to the PCAP, without waiting for it.
+*
+* @param	ScrubPtr is a pointer to the scrubber, the PCAP claimed.
+* @param	WordPtr is the packets, in a cache line aligned buffer.
+* @param	Words is the number of words.
+*
+* @return	XST_SUCCESS, or the error of XDcfg_Transfer().
+*
+*****************************************************************************/
+static s32 PlScrub_StartWrite(PlScrub *ScrubPtr, const u32 *WordPtr,
+			      u32 Words)
+{
+	XDcfg *DcfgPtr = &ScrubPtr->MgrPtr->Dcfg;
+
+	Xil_DCacheFlushRange((INTPTR)WordPtr, Words * 4U);
+	XDcfg_IntrClear(DcfgPtr, XDCFG_IXR_D_P_DONE_MASK |
+			XDCFG_IXR_ERROR_FLAGS_MASK);
+
+	return (s32)XDcfg_Transfer(DcfgPtr,
+				   (void *)((UINTPTR)WordPtr |
+					    PL_SCRUB_LAST_TRANSFER), Words,
+				   (void *)(XDCFG_DMA_INVALID_ADDRESS |
+					    PL_SCRUB_LAST_TRANSFER), Words,
+				   XDCFG_NON_SECURE_PCAP_WRITE);
+}
+
+/****************************************************************************/
+/*
+*
+* Sends a few words of packets to the PCAP and waits for them to be taken,
+* a fraction of a microsecond.
+*
+* @param	ScrubPtr is a pointer to the scrubber, the PCAP claimed.
+* @param	WordPtr is the packets, in a cache line aligned buffer.
+* @param	Words is the number of words.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if the transfer failed.
+*
+*****************************************************************************/
+static s32 PlScrub_Send(PlScrub *ScrubPtr, const u32 *WordPtr, u32 Words)
+{
+	u32 Spins;
+	s32 Status;
+
+	if (PlScrub_StartWrite(ScrubPtr, WordPtr, Words) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	for (Spins = 0U; Spins < PL_SCRUB_CMD_SPINS; Spins++) {
+		Status = PlScrub_Poll(ScrubPtr);
+		if (Status != XST_DEVICE_BUSY) {
+			return Status;
+		}
+	}
+
+	return XST_FAILURE;
+}
+
+/****************************************************************************/
+/*
+*
+* Tells whether the DMA of the PCAP ended.
+*
+* @param	ScrubPtr is a pointer to the scrubber.
+*
+* @return
+*		- XST_SUCCESS if it ended.
+*		- XST_DEVICE_BUSY if it is running.
+*		- XST_FAILURE if it failed.
+*
+*****************************************************************************/
+static s32 PlScrub_Poll(PlScrub *ScrubPtr)
+{
+	u32 IntrStatus = XDcfg_IntrGetStatus(&ScrubPtr->MgrPtr->Dcfg);
+
+	if ((IntrStatus & XDCFG_IXR_ERROR_FLAGS_MASK) != 0U) {
+		XDcfg_IntrClear(&ScrubPtr->MgrPtr->Dcfg,
+				XDCFG_IXR_ERROR_FLAGS_MASK);
+		return XST_FAILURE;
+	}
+	if ((IntrStatus & XDCFG_IXR_D_P_DONE_MASK) != 0U) {
+		return XST_SUCCESS;
+	}
+
+	return XST_DEVICE_BUSY;
+}
+
+/****************************************************************************/
+/*
+*
+* Ends a step: gives the PCAP back if claimed, moves to the next group if
+* asked and schedules the next step while running.
+*
+* @param	ScrubPtr is a pointer to the scrubber.
+* @param	Next is 1 to move to the next group, 0 to do the same again.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void PlScrub_EndStep(PlScrub *ScrubPtr, u32 Next)
+{
+	if (ScrubPtr->State != PL_SCRUB_IDLE) {
+		ScrubPtr->State = PL_SCRUB_IDLE;
+		DfxMgr_ReleasePcap(ScrubPtr->MgrPtr);
+	}
+
+	if (Next != 0U) {
+		ScrubPtr->Repaired = 0U;
+		ScrubPtr->Index++;
+		if (ScrubPtr->Index >= ScrubPtr->NumGroups) {
+			ScrubPtr->Index = 0U;
+			ScrubPtr->Stats.Passes++;
+		}
+	}
+
+	if (ScrubPtr->Running != 0U) {
+		TimerWheel_Start(ScrubPtr->WheelPtr, &ScrubPtr->Timer,
+				 PL_SCRUB_PERIOD_US);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Computes the CRC-32 of frames with the bits of a mask cleared.
+*
+* @param	DataPtr is the frames.
+* @param	MaskPtr is the mask, NULL for none.
+* @param	Words is the number of words.
+*
+* @return	The CRC-32, as that of zlib over the words in little endian.
+*
+*****************************************************************************/
+static u32 PlScrub_Crc(const u32 *DataPtr, const u32 *MaskPtr, u32 Words)
+{
+	u32 Block[PL_SCRUB_CRC_WORDS];
+	u32 Crc = 0U;
+	u32 Count;
+	u32 Index;
+
+	if (MaskPtr == NULL) {
+		return UartFrame_Crc32(0U, (const u8 *)DataPtr, Words * 4U);
+	}
+
+	while (Words > 0U) {
+		Count = (Words < PL_SCRUB_CRC_WORDS) ? Words :
+			PL_SCRUB_CRC_WORDS;
+		for (Index = 0U; Index < Count; Index++) {
+			Block[Index] = DataPtr[Index] & ~MaskPtr[Index];
+		}
+		Crc = UartFrame_Crc32(Crc, (const u8 *)Block, Count * 4U);
+		DataPtr += Count;
+		MaskPtr += Count;
+		Words -= Count;
+	}
+
+	return Crc;
+}
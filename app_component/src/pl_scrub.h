@@ -0,0 +1,161 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file pl_scrub.h
+*
+* Background scrubbing of the PL configuration memory against single event
+* upsets, through PCAP readback.
+*
+* The configuration frames of the PL are read back a few at a time, the
+* CRC-32 of each group compared with that of a golden table, and a group
+* that differs is repaired by a partial write of its golden frames. The
+* table is made from the bitstream of the design by tools/scrub_golden.py
+* and loaded anywhere in DDR by the caller; it is checked whole at
+* initialization and the golden frames of a group again before they are
+* written.
+*
+* The configuration bits that the design changes as it runs, those of
+* LUTRAMs, SRLs and block RAMs, read back as anything: the mask of the
+* table, from the .msk file of write_bitstream -mask_file, leaves them out
+* of the CRC, and a repair writes them back with the values just read. A
+* repair of a frame holding memory the design writes in the few
+* microseconds between the readback and the write loses those writes; a
+* design that cannot afford it keeps such frames out of the table.
+*
+* The scrubber runs from a timer of timer_wheel.h, in the timer interrupt:
+*
+* - a step claims the PCAP from the partial reconfiguration manager of
+*   dfx_mgr.h, skipping the step while a swap runs, and starts the readback
+*   DMA of one group of at most PL_SCRUB_MAX_FRAMES frames;
+* - the timer polls the DMA every PL_SCRUB_POLL_US, then the CRC of the
+*   group is compared, the repair DMA started if needed and the PCAP given
+*   back;
+* - the next step is PL_SCRUB_PERIOD_US later.
+*
+* The CPU time of a step, the CPU waits neither for the PCAP nor the DMA,
+* is the CRC of one group, about 10 us with the IRQ masked, which the FIFOs
+* of the UARTs ride through. With the defaults a Z-7020, about 10000 frames,
+* is scrubbed every 2.5 s for about 1% of the CPU and of the PCAP.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef PL_SCRUB_H
+#define PL_SCRUB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "timer_wheel.h"
+#include "dfx_mgr.h"
+
+/************************** Constant Definitions ****************************/
+
+#ifndef PL_SCRUB_MAX_FRAMES
+#define PL_SCRUB_MAX_FRAMES	4U	/**< Frames of a group */
+#endif
+
+#ifndef PL_SCRUB_PERIOD_US
+#define PL_SCRUB_PERIOD_US	1000U	/**< Between two groups */
+#endif
+
+#ifndef PL_SCRUB_POLL_US
+#define PL_SCRUB_POLL_US	10U	/**< Polls of a running DMA */
+#endif
+
+#define PL_SCRUB_FRAME_WORDS	101U	/**< Of a 7 series frame */
+
+#define PL_SCRUB_TABLE_MAGIC	0x42524353U	/**< "SCRB" */
+#define PL_SCRUB_TABLE_VERSION	1U
+#define PL_SCRUB_NONE		0xFFFFFFFFU	/**< No golden data or mask */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Header of a golden table. The groups follow, then the words their
+ * offsets point at.
+ */
+typedef struct {
+	u32 Magic;		/**< PL_SCRUB_TABLE_MAGIC */
+	u16 Version;		/**< PL_SCRUB_TABLE_VERSION */
+	u16 FrameWords;		/**< PL_SCRUB_FRAME_WORDS */
+	u32 NumGroups;
+	u32 NumWords;		/**< Of the golden data and masks */
+	u32 Crc;		/**< CRC-32 of the groups and the words */
+} PlScrub_TableHeader;
+
+/**
+ * A group of frames of consecutive addresses.
+ */
+typedef struct {
+	u32 Far;		/**< Frame address of the first frame */
+	u32 Frames;		/**< 1 to PL_SCRUB_MAX_FRAMES */
+	u32 Crc;		/**< CRC-32 of the frames, masked bits cleared */
+	u32 DataOffset;		/**< Word of the golden frames, or NONE */
+	u32 MaskOffset;		/**< Word of the mask, or NONE */
+} PlScrub_Group;
+
+/**
+ * Counts of the scrubber.
+ */
+typedef struct {
+	u32 Passes;		/**< Of the whole table */
+	u32 Groups;		/**< Read back and compared */
+	u32 Skipped;		/**< Steps skipped for a swap */
+	u32 Upsets;		/**< Groups that differed */
+	u32 Repairs;		/**< Groups written back */
+	u32 Unrepaired;		/**< Differed without golden data, again
+				     after a repair, or bad golden data */
+	u32 PcapErrors;		/**< Transfers that failed */
+	u32 LastUpsetFar;	/**< Group of the last upset */
+} PlScrub_Stats;
+
+/**
+ * The scrubber.
+ */
+typedef struct {
+	DfxMgr *MgrPtr;		/**< Owner of the PCAP */
+	TimerWheel *WheelPtr;
+	TimerWheel_Timer Timer;
+	const PlScrub_Group *GroupPtr;
+	const u32 *WordPtr;	/**< Golden data and masks */
+	u32 NumGroups;
+	u32 Index;		/**< Group being scrubbed */
+	u32 State;		/**< Of the step, in pl_scrub.c */
+	u32 Repaired;		/**< The group was just written back */
+	u32 Polls;		/**< Of the running DMA */
+	u32 Running;
+	PlScrub_Stats Stats;
+} PlScrub;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+s32 PlScrub_Initialize(PlScrub *ScrubPtr, DfxMgr *MgrPtr,
+		       TimerWheel *WheelPtr, const void *TablePtr,
+		       u32 NumBytes);
+void PlScrub_Start(PlScrub *ScrubPtr);
+void PlScrub_Stop(PlScrub *ScrubPtr);
+void PlScrub_GetStats(const PlScrub *ScrubPtr, PlScrub_Stats *StatsPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PL_SCRUB_H */
@@ -0,0 +1,780 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file pl_uart.c
+*
+* AXI UART16550 and AXI UARTLite ports on rings, and the AXI INTC hub
+* sharing their interrupt. Refer to pl_uart.h for how they are used.
+*
+* The rings follow the XUartPs ring buffer mode: the ISR owns Head of the
+* RX ring and Tail of the TX ring, the task the other two, and each side
+* publishes its counter after a dmb so the other never sees it ahead of
+* the data. The UART16550 asks for TX interrupts with ETBEI, which
+* interrupts at once while THR is empty, so PlUart_RingWrite() only has to
+* set it. The UARTLite interrupts only when its TX FIFO becomes empty, so
+* the task primes the FIFO itself when no interrupt is due, TxBusy 0.
+*
+* The hub acknowledges the edge inputs before their ports are serviced,
+* so an edge during the service is kept for the next entry, and the level
+* inputs after, when their core has lowered its line.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "xil_io.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xinterrupt_wrap.h"
+#include "pl_uart.h"
+
+/************************** Constant Definitions ****************************/
+
+#define PL_UART_FIFO_SIZE	16U	/* TX FIFO of both cores */
+
+/* AXI UART16550 registers, after the 4 KB of the bus interface */
+#define PL_UART_16550_RBR	0x1000U	/* Receive buffer, THR and DLL */
+#define PL_UART_16550_IER	0x1004U	/* Interrupt enable and DLM */
+#define PL_UART_16550_FCR	0x1008U	/* FIFO control, IIR when read */
+#define PL_UART_16550_LCR	0x100CU	/* Line control */
+#define PL_UART_16550_MCR	0x1010U	/* Modem control */
+#define PL_UART_16550_LSR	0x1014U	/* Line status */
+#define PL_UART_16550_MSR	0x1018U	/* Modem status */
+
+#define PL_UART_16550_IER_ERBFI	0x01U	/* Data received */
+#define PL_UART_16550_IER_ETBEI	0x02U	/* THR empty */
+#define PL_UART_16550_IER_ELSI	0x04U	/* Line status */
+#define PL_UART_16550_IER_RX	(PL_UART_16550_IER_ERBFI | \
+				 PL_UART_16550_IER_ELSI)
+
+#define PL_UART_16550_FCR_INIT	0x87U	/* FIFOs on and reset, RX at 8 */
+#define PL_UART_16550_LCR_8N1	0x03U
+#define PL_UART_16550_LCR_DLAB	0x80U	/* Divisor latch access */
+
+#define PL_UART_16550_LSR_DR	0x01U	/* Data ready */
+#define PL_UART_16550_LSR_OE	0x02U	/* Overrun */
+#define PL_UART_16550_LSR_PE	0x04U	/* Parity */
+#define PL_UART_16550_LSR_FE	0x08U	/* Framing */
+#define PL_UART_16550_LSR_THRE	0x20U	/* THR and TX FIFO empty */
+#define PL_UART_16550_LSR_ERRORS (PL_UART_16550_LSR_OE | \
+				  PL_UART_16550_LSR_PE | \
+				  PL_UART_16550_LSR_FE)
+
+#define PL_UART_16550_MAX_DIV	0xFFFFU
+
+/* AXI UARTLite registers */
+#define PL_UART_LITE_RX		0x00U	/* RX FIFO */
+#define PL_UART_LITE_TX		0x04U	/* TX FIFO */
+#define PL_UART_LITE_STAT	0x08U	/* Status, errors cleared on read */
+#define PL_UART_LITE_CTRL	0x0CU	/* Control */
+
+#define PL_UART_LITE_STAT_RXVALID 0x01U
+#define PL_UART_LITE_STAT_TXEMPTY 0x04U
+#define PL_UART_LITE_STAT_OVR	0x20U
+#define PL_UART_LITE_STAT_FRAME	0x40U
+#define PL_UART_LITE_STAT_PAR	0x80U
+
+#define PL_UART_LITE_CTRL_RST	0x03U	/* Reset both FIFOs */
+#define PL_UART_LITE_CTRL_INTR	0x10U	/* Interrupt enable */
+
+/* AXI INTC registers */
+#define PL_UART_HUB_ISR		0x00U	/* Status */
+#define PL_UART_HUB_IPR		0x04U	/* Pending, status and enabled */
+#define PL_UART_HUB_IER		0x08U	/* Enable */
+#define PL_UART_HUB_IAR		0x0CU	/* Acknowledge */
+#define PL_UART_HUB_MER		0x1CU	/* Master enable */
+
+#define PL_UART_HUB_MER_ON	0x03U	/* ME and hardware interrupts */
+#define PL_UART_HUB_ALL		0xFFFFFFFFU
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define PlUart_ReadReg(UartPtr, Offset) \
+	Xil_In32((UartPtr)->BaseAddress + (u32)(Offset))
+#define PlUart_WriteReg(UartPtr, Offset, Data) \
+	Xil_Out32((UartPtr)->BaseAddress + (u32)(Offset), (u32)(Data))
+
+#define PlUart_RingUsed(RingPtr)	((RingPtr)->Head - (RingPtr)->Tail)
+#define PlUart_RingSize(RingPtr)	((RingPtr)->Mask + 1U)
+
+/************************** Function Prototypes *****************************/
+
+static void PlUart_CountErrors(PlUart *UartPtr, u32 Errors);
+static void PlUart_Store(PlUart *UartPtr, u8 Data);
+static u32 PlUart_Send(PlUart *UartPtr, u32 TxOffset);
+static void PlUart_Service16550(PlUart *UartPtr);
+static void PlUart_ServiceLite(PlUart *UartPtr);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* Sets up a port on its rings and enables its receive interrupts. The port
+* is quiet until its interrupt is connected, through PlUart_HubAddPort()
+* or by the caller to PlUart_InterruptHandler().
+*
+* @param	UartPtr is the port.
+* @param	Kind is PL_UART_16550 or PL_UART_LITE.
+* @param	BaseAddress is the base address of the core.
+* @param	ClockHz is the clock of the UART16550 divisor, s_axi_aclk
+*		unless the core has an external clock. Not used by a
+*		UARTLite.
+* @param	BaudRate is the baud rate of a UART16550. Not used by a
+*		UARTLite.
+* @param	RxBufPtr is the storage for the RX ring.
+* @param	RxSize is the size of the RX ring in bytes, a power of two.
+* @param	TxBufPtr is the storage for the TX ring.
+* @param	TxSize is the size of the TX ring in bytes, a power of two.
+*
+* @return
+*		- XST_SUCCESS if the port is set up.
+*		- XST_INVALID_PARAM if the kind is unknown, a ring size is not
+*		  a power of two or the baud rate cannot be divided from
+*		  the clock.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 PlUart_Initialize(PlUart *UartPtr, u32 Kind, UINTPTR BaseAddress,
+		      u32 ClockHz, u32 BaudRate, u8 *RxBufPtr, u32 RxSize,
+		      u8 *TxBufPtr, u32 TxSize)
+{
+	u32 Divisor = 0U;
+
+	if (((Kind != PL_UART_16550) && (Kind != PL_UART_LITE)) ||
+	    (RxBufPtr == NULL) || (TxBufPtr == NULL) ||
+	    (RxSize == 0U) || ((RxSize & (RxSize - 1U)) != 0U) ||
+	    (TxSize == 0U) || ((TxSize & (TxSize - 1U)) != 0U)) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	if (Kind == PL_UART_16550) {
+		if ((BaudRate == 0U) || (BaudRate > (0xFFFFFFFFU / 16U))) {
+			return (s32)XST_INVALID_PARAM;
+		}
+		Divisor = (ClockHz + (8U * BaudRate)) / (16U * BaudRate);
+		if ((Divisor == 0U) || (Divisor > PL_UART_16550_MAX_DIV)) {
+			return (s32)XST_INVALID_PARAM;
+		}
+	}
+
+	UartPtr->IsReady = 0U;
+	UartPtr->BaseAddress = BaseAddress;
+	UartPtr->Kind = Kind;
+	UartPtr->RxRing.BufferPtr = RxBufPtr;
+	UartPtr->RxRing.Mask = RxSize - 1U;
+	UartPtr->RxRing.Head = 0U;
+	UartPtr->RxRing.Tail = 0U;
+	UartPtr->TxRing.BufferPtr = TxBufPtr;
+	UartPtr->TxRing.Mask = TxSize - 1U;
+	UartPtr->TxRing.Head = 0U;
+	UartPtr->TxRing.Tail = 0U;
+	UartPtr->RxRingDropped = 0U;
+	UartPtr->TxBusy = 0U;
+	UartPtr->Events = 0U;
+	UartPtr->StatsPtr = NULL;
+
+	if (Kind == PL_UART_16550) {
+		PlUart_WriteReg(UartPtr, PL_UART_16550_IER, 0U);
+		PlUart_WriteReg(UartPtr, PL_UART_16550_LCR,
+				PL_UART_16550_LCR_DLAB | PL_UART_16550_LCR_8N1);
+		PlUart_WriteReg(UartPtr, PL_UART_16550_RBR, Divisor & 0xFFU);
+		PlUart_WriteReg(UartPtr, PL_UART_16550_IER, Divisor >> 8U);
+		PlUart_WriteReg(UartPtr, PL_UART_16550_LCR,
+				PL_UART_16550_LCR_8N1);
+		PlUart_WriteReg(UartPtr, PL_UART_16550_FCR,
+				PL_UART_16550_FCR_INIT);
+		PlUart_WriteReg(UartPtr, PL_UART_16550_MCR, 0U);
+
+		/* Drop whatever status the core held */
+		(void)PlUart_ReadReg(UartPtr, PL_UART_16550_LSR);
+		(void)PlUart_ReadReg(UartPtr, PL_UART_16550_MSR);
+		(void)PlUart_ReadReg(UartPtr, PL_UART_16550_FCR);
+
+		PlUart_WriteReg(UartPtr, PL_UART_16550_IER,
+				PL_UART_16550_IER_RX);
+	} else {
+		PlUart_WriteReg(UartPtr, PL_UART_LITE_CTRL,
+				PL_UART_LITE_CTRL_RST);
+		(void)PlUart_ReadReg(UartPtr, PL_UART_LITE_STAT);
+		PlUart_WriteReg(UartPtr, PL_UART_LITE_CTRL,
+				PL_UART_LITE_CTRL_INTR);
+	}
+
+	UartPtr->IsReady = 1U;
+
+	return (s32)XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Attaches a statistics block to a port and clears it. It is updated by
+* the interrupt handler from then on, like that of XUartPs_EnableStats(),
+* but for the ISR timing fields which stay 0.
+*
+* @param	UartPtr is the port.
+* @param	StatsPtr is the block, owned by the caller.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void PlUart_EnableStats(PlUart *UartPtr, XUartPsStats *StatsPtr)
+{
+	(void)memset((void *)StatsPtr, 0, sizeof(XUartPsStats));
+	UartPtr->StatsPtr = StatsPtr;
+}
+
+/****************************************************************************/
+/**
+*
+* Takes a consistent snapshot of the statistics of a port, the interrupts
+* masked while the block is copied.
+*
+* @param	UartPtr is the port.
+* @param	SnapshotPtr is where the snapshot is stored.
+*
+* @return
+*		- XST_SUCCESS if the snapshot was taken.
+*		- XST_NOT_ENABLED if no statistics block is attached.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 PlUart_GetStats(PlUart *UartPtr, XUartPsStats *SnapshotPtr)
+{
+	u32 Cpsr;
+
+	if (UartPtr->StatsPtr == NULL) {
+		return (s32)XST_NOT_ENABLED;
+	}
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	*SnapshotPtr = *UartPtr->StatsPtr;
+	mtcpsr(Cpsr);
+
+	return (s32)XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Reads received data out of the RX ring of a port.
+*
+* @param	UartPtr is the port.
+* @param	BufferPtr is where the data is stored.
+* @param	NumBytes is the most bytes to read.
+*
+* @return	The number of bytes read, 0 if the ring is empty.
+*
+* @note		Only one task may read from the RX ring.
+*
+*****************************************************************************/
+u32 PlUart_RingRead(PlUart *UartPtr, u8 *BufferPtr, u32 NumBytes)
+{
+	XUartPsRing *RingPtr = &UartPtr->RxRing;
+	u32 Tail = RingPtr->Tail;
+	u32 Count;
+	u32 Index;
+
+	Count = RingPtr->Head - Tail;
+	if (Count > NumBytes) {
+		Count = NumBytes;
+	}
+
+	/* Make sure the data is read after the ISR published Head */
+	dmb();
+
+	for (Index = 0U; Index < Count; Index++) {
+		BufferPtr[Index] = RingPtr->BufferPtr[(Tail + Index) &
+						      RingPtr->Mask];
+	}
+
+	/* The data is read before the ISR may store over it */
+	dmb();
+	RingPtr->Tail = Tail + Count;
+
+	return Count;
+}
+
+/****************************************************************************/
+/**
+*
+* Queues data in the TX ring of a port and makes sure the interrupt handler
+* sends it.
+*
+* @param	UartPtr is the port.
+* @param	BufferPtr is the data to send.
+* @param	NumBytes is the number of bytes to send.
+*
+* @return	The number of bytes queued, less than NumBytes when the ring
+*		is full.
+*
+* @note		Only one task may write to the TX ring.
+*
+*****************************************************************************/
+u32 PlUart_RingWrite(PlUart *UartPtr, const u8 *BufferPtr, u32 NumBytes)
+{
+	XUartPsRing *RingPtr = &UartPtr->TxRing;
+	u32 Head = RingPtr->Head;
+	u32 Count;
+	u32 Index;
+	u32 Cpsr;
+
+	Count = PlUart_RingSize(RingPtr) - (Head - RingPtr->Tail);
+	if (Count > NumBytes) {
+		Count = NumBytes;
+	}
+
+	if (Count == 0U) {
+		return 0U;
+	}
+
+	for (Index = 0U; Index < Count; Index++) {
+		RingPtr->BufferPtr[(Head + Index) & RingPtr->Mask] =
+			BufferPtr[Index];
+	}
+
+	/* Publish the data before the ISR can see the new Head */
+	dmb();
+	RingPtr->Head = Head + Count;
+
+	if ((UartPtr->StatsPtr != NULL) &&
+	    ((Head + Count - RingPtr->Tail) >
+	     UartPtr->StatsPtr->TxRingHighWater)) {
+		UartPtr->StatsPtr->TxRingHighWater =
+			Head + Count - RingPtr->Tail;
+	}
+
+	if (UartPtr->Kind == PL_UART_16550) {
+		PlUart_WriteReg(UartPtr, PL_UART_16550_IER,
+				PL_UART_16550_IER_RX | PL_UART_16550_IER_ETBEI);
+	} else {
+		/* No TX empty interrupt is due, start the FIFO here */
+		Cpsr = mfcpsr();
+		mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+		if (UartPtr->TxBusy == 0U) {
+			UartPtr->TxBusy = (PlUart_Send(UartPtr,
+					   PL_UART_LITE_TX) != 0U) ? 1U : 0U;
+		}
+		mtcpsr(Cpsr);
+	}
+
+	return Count;
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the number of bytes waiting in the RX ring of a port.
+*
+* @param	UartPtr is the port.
+*
+* @return	The number of bytes PlUart_RingRead() can read.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 PlUart_RingRxCount(PlUart *UartPtr)
+{
+	return PlUart_RingUsed(&UartPtr->RxRing);
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the room left in the TX ring of a port.
+*
+* @param	UartPtr is the port.
+*
+* @return	The number of bytes PlUart_RingWrite() can queue.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 PlUart_RingTxFree(PlUart *UartPtr)
+{
+	return PlUart_RingSize(&UartPtr->TxRing) -
+	       PlUart_RingUsed(&UartPtr->TxRing);
+}
+
+/****************************************************************************/
+/**
+*
+* Interrupt handler of a port: drains the RX FIFO into the RX ring, refills
+* the TX FIFO from the TX ring and records PL_UART_EVENT_* in Events. It is
+* called by PlUart_HubInterruptHandler(), or connected directly for a port
+* with an interrupt of its own.
+*
+* @param	UartPtr is the port.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void PlUart_InterruptHandler(PlUart *UartPtr)
+{
+	if (UartPtr->StatsPtr != NULL) {
+		UartPtr->StatsPtr->IsrEntries++;
+	}
+
+	if (UartPtr->Kind == PL_UART_16550) {
+		PlUart_Service16550(UartPtr);
+	} else {
+		PlUart_ServiceLite(UartPtr);
+	}
+
+	if ((UartPtr->StatsPtr != NULL) &&
+	    (PlUart_RingUsed(&UartPtr->RxRing) >
+	     UartPtr->StatsPtr->RxRingHighWater)) {
+		UartPtr->StatsPtr->RxRingHighWater =
+			PlUart_RingUsed(&UartPtr->RxRing);
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Sets up an AXI INTC as the hub of the ports and connects its interrupt.
+* Every input is disabled until a port is added on it.
+*
+* @param	HubPtr is the hub.
+* @param	BaseAddress is the base address of the AXI INTC.
+* @param	IntrId is the interrupt of the AXI INTC output at the GIC.
+* @param	IntrParent is the base address of the GIC.
+*
+* @return	XST_SUCCESS if the interrupt is connected, the status of
+*		XSetupInterruptSystem() otherwise.
+*
+* @note		The hub takes one GIC interrupt however many ports it has.
+*
+*****************************************************************************/
+s32 PlUart_HubInitialize(PlUart_Hub *HubPtr, UINTPTR BaseAddress,
+			 u32 IntrId, UINTPTR IntrParent)
+{
+	u32 Input;
+
+	HubPtr->BaseAddress = BaseAddress;
+	for (Input = 0U; Input < PL_UART_MAX_PORTS; Input++) {
+		HubPtr->Port[Input] = NULL;
+	}
+	HubPtr->EdgeMask = 0U;
+	HubPtr->Interrupts = 0U;
+	HubPtr->Serviced = 0U;
+
+	Xil_Out32(BaseAddress + PL_UART_HUB_IER, 0U);
+	Xil_Out32(BaseAddress + PL_UART_HUB_IAR, PL_UART_HUB_ALL);
+	Xil_Out32(BaseAddress + PL_UART_HUB_MER, PL_UART_HUB_MER_ON);
+
+	return XSetupInterruptSystem(HubPtr, &PlUart_HubInterruptHandler,
+				     IntrId, IntrParent,
+				     XINTERRUPT_DEFAULT_PRIORITY);
+}
+
+/****************************************************************************/
+/**
+*
+* Adds a port on an input of the hub and enables the input.
+*
+* @param	HubPtr is the hub.
+* @param	Input is the input of the AXI INTC the port interrupt is
+*		wired to.
+* @param	UartPtr is the port, set up with PlUart_Initialize().
+*
+* @return
+*		- XST_SUCCESS if the port is added.
+*		- XST_INVALID_PARAM if the input is out of range or the port
+*		  is not set up.
+*		- XST_DEVICE_BUSY if the input already has a port.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 PlUart_HubAddPort(PlUart_Hub *HubPtr, u32 Input, PlUart *UartPtr)
+{
+	u32 Cpsr;
+	u32 Bit;
+
+	if ((Input >= PL_UART_MAX_PORTS) || (UartPtr->IsReady == 0U)) {
+		return (s32)XST_INVALID_PARAM;
+	}
+
+	if (HubPtr->Port[Input] != NULL) {
+		return (s32)XST_DEVICE_BUSY;
+	}
+
+	Bit = 1U << Input;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	HubPtr->Port[Input] = UartPtr;
+	if (UartPtr->Kind == PL_UART_LITE) {
+		HubPtr->EdgeMask |= Bit;
+	}
+	Xil_Out32(HubPtr->BaseAddress + PL_UART_HUB_IAR, Bit);
+	Xil_Out32(HubPtr->BaseAddress + PL_UART_HUB_IER,
+		  Xil_In32(HubPtr->BaseAddress + PL_UART_HUB_IER) | Bit);
+	mtcpsr(Cpsr);
+
+	return (s32)XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Interrupt handler of the hub. The pending register is read once and the
+* ports pending in it serviced, lowest input first.
+*
+* @param	InstancePtr is the hub.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void PlUart_HubInterruptHandler(void *InstancePtr)
+{
+	PlUart_Hub *HubPtr = (PlUart_Hub *)InstancePtr;
+	u32 Pending;
+	u32 Bits;
+	u32 Input;
+
+	HubPtr->Interrupts++;
+
+	Pending = Xil_In32(HubPtr->BaseAddress + PL_UART_HUB_IPR);
+	if ((Pending & HubPtr->EdgeMask) != 0U) {
+		Xil_Out32(HubPtr->BaseAddress + PL_UART_HUB_IAR,
+			  Pending & HubPtr->EdgeMask);
+	}
+
+	Bits = Pending;
+	while (Bits != 0U) {
+		Input = (u32)__builtin_ctz(Bits);
+		Bits &= Bits - 1U;
+		if (HubPtr->Port[Input] != NULL) {
+			PlUart_InterruptHandler(HubPtr->Port[Input]);
+			HubPtr->Serviced++;
+		}
+	}
+
+	if ((Pending & ~HubPtr->EdgeMask) != 0U) {
+		Xil_Out32(HubPtr->BaseAddress + PL_UART_HUB_IAR,
+			  Pending & ~HubPtr->EdgeMask);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Records receive errors of a port.
+*
+* @param	UartPtr is the port.
+* @param	Errors is a mask of the PL_UART_16550_LSR_OE, _PE and _FE
+*		errors seen.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void PlUart_CountErrors(PlUart *UartPtr, u32 Errors)
+{
+	if (Errors == 0U) {
+		return;
+	}
+
+	UartPtr->Events |= PL_UART_EVENT_ERROR;
+	if (UartPtr->StatsPtr != NULL) {
+		if ((Errors & PL_UART_16550_LSR_OE) != 0U) {
+			UartPtr->StatsPtr->OverrunErrors++;
+		}
+		if ((Errors & PL_UART_16550_LSR_PE) != 0U) {
+			UartPtr->StatsPtr->ParityErrors++;
+		}
+		if ((Errors & PL_UART_16550_LSR_FE) != 0U) {
+			UartPtr->StatsPtr->FramingErrors++;
+		}
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Stores a received byte in the RX ring of a port, or drops it when the
+* ring is full.
+*
+* @param	UartPtr is the port.
+* @param	Data is the byte.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void PlUart_Store(PlUart *UartPtr, u8 Data)
+{
+	XUartPsRing *RingPtr = &UartPtr->RxRing;
+	u32 Head = RingPtr->Head;
+
+	if (UartPtr->StatsPtr != NULL) {
+		UartPtr->StatsPtr->BytesIn++;
+	}
+
+	if ((Head - RingPtr->Tail) > RingPtr->Mask) {
+		UartPtr->RxRingDropped++;
+		return;
+	}
+
+	RingPtr->BufferPtr[Head & RingPtr->Mask] = Data;
+
+	/* Publish the data before the task can see the new Head */
+	dmb();
+	RingPtr->Head = Head + 1U;
+	UartPtr->Events |= PL_UART_EVENT_RX;
+}
+
+/****************************************************************************/
+/*
+*
+* Moves up to a TX FIFO of data from the TX ring of a port to the core.
+*
+* @param	UartPtr is the port, its TX FIFO empty.
+* @param	TxOffset is the offset of the TX FIFO of the core.
+*
+* @return	The number of bytes written to the FIFO.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 PlUart_Send(PlUart *UartPtr, u32 TxOffset)
+{
+	XUartPsRing *RingPtr = &UartPtr->TxRing;
+	u32 Tail = RingPtr->Tail;
+	u32 Count;
+	u32 Index;
+
+	Count = RingPtr->Head - Tail;
+	if (Count > PL_UART_FIFO_SIZE) {
+		Count = PL_UART_FIFO_SIZE;
+	}
+
+	/* Make sure the data is read after the task published Head */
+	dmb();
+
+	for (Index = 0U; Index < Count; Index++) {
+		PlUart_WriteReg(UartPtr, TxOffset,
+				RingPtr->BufferPtr[(Tail + Index) &
+						   RingPtr->Mask]);
+	}
+
+	if (Count != 0U) {
+		dmb();
+		RingPtr->Tail = Tail + Count;
+		UartPtr->Events |= PL_UART_EVENT_TX;
+		if (UartPtr->StatsPtr != NULL) {
+			UartPtr->StatsPtr->BytesOut += Count;
+		}
+	}
+
+	return Count;
+}
+
+/****************************************************************************/
+/*
+*
+* Services the FIFOs of a UART16550. Its line status is read before each
+* byte, reading it clears the errors it holds. ETBEI is cleared once the TX
+* ring is empty.
+*
+* @param	UartPtr is the port.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void PlUart_Service16550(PlUart *UartPtr)
+{
+	u32 Lsr;
+
+	Lsr = PlUart_ReadReg(UartPtr, PL_UART_16550_LSR);
+	PlUart_CountErrors(UartPtr, Lsr & PL_UART_16550_LSR_ERRORS);
+	while ((Lsr & PL_UART_16550_LSR_DR) != 0U) {
+		PlUart_Store(UartPtr,
+			     (u8)PlUart_ReadReg(UartPtr, PL_UART_16550_RBR));
+		Lsr = PlUart_ReadReg(UartPtr, PL_UART_16550_LSR);
+		PlUart_CountErrors(UartPtr, Lsr & PL_UART_16550_LSR_ERRORS);
+	}
+
+	if ((Lsr & PL_UART_16550_LSR_THRE) != 0U) {
+		if (PlUart_Send(UartPtr, PL_UART_16550_RBR) == 0U) {
+			PlUart_WriteReg(UartPtr, PL_UART_16550_IER,
+					PL_UART_16550_IER_RX);
+		}
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Services the FIFOs of a UARTLite. Its status is read before each byte,
+* reading it clears the errors it holds.
+*
+* @param	UartPtr is the port.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void PlUart_ServiceLite(PlUart *UartPtr)
+{
+	u32 Stat;
+	u32 Errors;
+
+	do {
+		Stat = PlUart_ReadReg(UartPtr, PL_UART_LITE_STAT);
+		Errors = 0U;
+		if ((Stat & PL_UART_LITE_STAT_OVR) != 0U) {
+			Errors |= PL_UART_16550_LSR_OE;
+		}
+		if ((Stat & PL_UART_LITE_STAT_PAR) != 0U) {
+			Errors |= PL_UART_16550_LSR_PE;
+		}
+		if ((Stat & PL_UART_LITE_STAT_FRAME) != 0U) {
+			Errors |= PL_UART_16550_LSR_FE;
+		}
+		PlUart_CountErrors(UartPtr, Errors);
+		if ((Stat & PL_UART_LITE_STAT_RXVALID) != 0U) {
+			PlUart_Store(UartPtr, (u8)PlUart_ReadReg(UartPtr,
+							PL_UART_LITE_RX));
+		}
+	} while ((Stat & PL_UART_LITE_STAT_RXVALID) != 0U);
+
+	if ((UartPtr->TxBusy != 0U) &&
+	    ((Stat & PL_UART_LITE_STAT_TXEMPTY) != 0U)) {
+		UartPtr->TxBusy = (PlUart_Send(UartPtr,
+				   PL_UART_LITE_TX) != 0U) ? 1U : 0U;
+	}
+}
@@ -0,0 +1,128 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file pl_uart.h
+*
+* Serial ports in the PL, AXI UART16550 and AXI UARTLite cores, behind the
+* same ring buffers as the XUartPs ring buffer mode, without the uartns550
+* and uartlite drivers.
+*
+* A PlUart is one port of either kind. Its interrupt handler moves bytes
+* between the FIFOs of the core and two rings of the caller, XUartPsRing
+* like those of XUartPs, and the task side reads and writes the rings with
+* PlUart_RingRead() and PlUart_RingWrite(), the same calls as XUartPs has.
+* An XUartPsStats block may be attached as well, the ISR timing fields stay
+* 0. It is therefore scheduled by uart_sched.h alongside the PS UARTs,
+* refer to UartSched_AddPlPort().
+*
+* Many ports do not take a GIC interrupt each: their interrupts go to an
+* AXI INTC, the hub, whose output is the one interrupt of the PS serviced
+* by PlUart_HubInterruptHandler(). It reads the pending register of the
+* hub once and services the ports pending in it, so the cost of the
+* interrupt grows with the ports that have work, not the ports there are.
+* A hub takes up to PL_UART_MAX_PORTS ports, one per input.
+*
+* A UART16550 is set up for 8N1 at the baud rate asked, from the clock of
+* its divisor, with its 16 byte FIFOs. A UARTLite has its line settings
+* and baud rate fixed by the hardware design, those asked are not used.
+* The UART16550 interrupt is a level, the UARTLite one an edge, the inputs
+* of the hub must be configured that way in the design.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef PL_UART_H
+#define PL_UART_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xuartps.h"
+
+/************************** Constant Definitions ****************************/
+
+#define PL_UART_MAX_PORTS	32U	/**< Inputs of an AXI INTC */
+
+/** @name Kinds of port
+ * @{
+ */
+#define PL_UART_16550		0U	/**< AXI UART16550 */
+#define PL_UART_LITE		1U	/**< AXI UARTLite */
+/* @} */
+
+/** @name Events recorded by the interrupt handler
+ * @{
+ */
+#define PL_UART_EVENT_RX	0x00000001U	/**< Data received */
+#define PL_UART_EVENT_TX	0x00000002U	/**< TX FIFO refilled or empty */
+#define PL_UART_EVENT_ERROR	0x00000004U	/**< Overrun, parity, framing */
+/* @} */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * One port.
+ */
+typedef struct {
+	UINTPTR BaseAddress;	/**< Of the core */
+	u32 Kind;		/**< PL_UART_16550 or PL_UART_LITE */
+	XUartPsRing RxRing;	/**< Filled by the ISR, drained by the task */
+	XUartPsRing TxRing;	/**< Filled by the task, drained by the ISR */
+	u32 RxRingDropped;	/**< Bytes lost to a full RX ring */
+	u32 TxBusy;		/**< UARTLite: a TX empty interrupt is due */
+	volatile u32 Events;	/**< PL_UART_EVENT_* not yet handled */
+	XUartPsStats *StatsPtr;	/**< Optional statistics, NULL if disabled */
+	u32 IsReady;
+} PlUart;
+
+/**
+ * An AXI INTC gathering the interrupts of the ports.
+ */
+typedef struct {
+	UINTPTR BaseAddress;	/**< Of the AXI INTC */
+	PlUart *Port[PL_UART_MAX_PORTS]; /**< By input, NULL if not used */
+	u32 EdgeMask;		/**< Inputs acknowledged before service */
+	u32 Interrupts;		/**< Entries of the handler */
+	u32 Serviced;		/**< Ports serviced by the handler */
+} PlUart_Hub;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+s32 PlUart_Initialize(PlUart *UartPtr, u32 Kind, UINTPTR BaseAddress,
+		      u32 ClockHz, u32 BaudRate, u8 *RxBufPtr, u32 RxSize,
+		      u8 *TxBufPtr, u32 TxSize);
+void PlUart_EnableStats(PlUart *UartPtr, XUartPsStats *StatsPtr);
+s32 PlUart_GetStats(PlUart *UartPtr, XUartPsStats *SnapshotPtr);
+u32 PlUart_RingRead(PlUart *UartPtr, u8 *BufferPtr, u32 NumBytes);
+u32 PlUart_RingWrite(PlUart *UartPtr, const u8 *BufferPtr, u32 NumBytes);
+u32 PlUart_RingRxCount(PlUart *UartPtr);
+u32 PlUart_RingTxFree(PlUart *UartPtr);
+void PlUart_InterruptHandler(PlUart *UartPtr);
+
+s32 PlUart_HubInitialize(PlUart_Hub *HubPtr, UINTPTR BaseAddress,
+			 u32 IntrId, UINTPTR IntrParent);
+s32 PlUart_HubAddPort(PlUart_Hub *HubPtr, u32 Input, PlUart *UartPtr);
+void PlUart_HubInterruptHandler(void *InstancePtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PL_UART_H */
@@ -0,0 +1,524 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file qos_bench.c
+*
+* Benchmark of the QoS profiles of the DDR controller. Refer to
+* qos_bench.h for what is measured.
+*
+* The program of the copy is generated once and held, so that the done
+* handler restarts it at once.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xil_printf.h"
+#include "xil_cache.h"
+#include "xpseudo_asm.h"
+#include "xiltimer.h"
+#include "xtimestamp.h"
+#include "xinterrupt_wrap.h"
+#include "xil_hotpath.h"
+#include "qos_bench.h"
+#include "drvcfg.h"
+
+/************************** Constant Definitions ****************************/
+
+#define QOS_BENCH_LINE		32U	/* Line of the L1 and the L2 */
+#define QOS_BENCH_WORDS		(QOS_BENCH_LINE / 4U) /* Per line */
+#define QOS_BENCH_LINES		(QOS_BENCH_CHASE_BYTES / QOS_BENCH_LINE)
+#define QOS_BENCH_TIMEOUT	20000000U /* Cycles to wait for a copy */
+#define QOS_BENCH_SEED		0x2545F491U /* Of the chase order */
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static void QosBench_Link(QosBench *BenchPtr);
+static u32 QosBench_Chase(QosBench *BenchPtr);
+static s32 QosBench_StartLoad(QosBench *BenchPtr);
+static s32 QosBench_StopLoad(QosBench *BenchPtr);
+static void QosBench_DoneHandler(unsigned int Channel, XDmaPs_Cmd *DmaCmd,
+				 void *CallbackRef);
+
+/************************** Variable Definitions ****************************/
+
+static const char *QosBench_LoadNames[QOS_BENCH_NUM_LOADS] = {
+	"idle", "dma"
+};
+
+/* One pointer to the next line at the start of each line */
+static u32 QosBench_ChaseBuf[QOS_BENCH_CHASE_BYTES / 4U]
+	__attribute__((aligned(QOS_BENCH_LINE))) XIL_NOINIT;
+
+/* Source and destination of the copy, their content does not matter */
+static u8 QosBench_DmaBuf[2][QOS_BENCH_DMA_BYTES]
+	__attribute__((aligned(QOS_BENCH_LINE))) XIL_NOINIT;
+
+/****************************************************************************/
+/**
+*
+* Sets up the QoS profiles, the DMA controller with its done interrupt on
+* QOS_BENCH_CHANNEL and its fault interrupt, the program of the copy and
+* the chase.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return
+*		- XST_SUCCESS if the benchmark is ready.
+*		- XST_FAILURE if the DMA controller is not found or its
+*		  interrupts could not be connected.
+*		- The error of the failing driver call otherwise.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 QosBench_Initialize(QosBench *BenchPtr)
+{
+	XDmaPs_ChanCtrl *ChanCtrl = &BenchPtr->Cmd.ChanCtrl;
+	XDmaPs_Config *CfgPtr;
+	s32 Status;
+
+	(void)memset(BenchPtr, 0, sizeof(*BenchPtr));
+
+	XTimestamp_EnableCycles();
+
+	Status = DdrQos_Initialize(&BenchPtr->Qos);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	CfgPtr = XDmaPs_LookupConfigStatic(XPAR_XDMAPS_0_BASEADDR);
+	if (CfgPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	Status = XDmaPs_CfgInitialize(&BenchPtr->Dma, CfgPtr,
+				      CfgPtr->BaseAddress);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	/* IntrId[0] is the fault interrupt, IntrId[1 + N] the one of N */
+	Status = XSetupInterruptSystem(&BenchPtr->Dma, &XDmaPs_DoneISR_0,
+				       CfgPtr->IntrId[1U + QOS_BENCH_CHANNEL],
+				       CfgPtr->IntrParent,
+				       XINTERRUPT_DEFAULT_PRIORITY);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	Status = XConnectToInterruptCntrl(CfgPtr->IntrId[0],
+					  &XDmaPs_FaultISR, &BenchPtr->Dma,
+					  CfgPtr->IntrParent);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	XEnableIntrId(CfgPtr->IntrId[0], CfgPtr->IntrParent);
+
+	(void)XDmaPs_SetDoneHandler(&BenchPtr->Dma, QOS_BENCH_CHANNEL,
+				    QosBench_DoneHandler, BenchPtr);
+	(void)XDmaPs_SetFaultHandler(&BenchPtr->Dma, QosBench_DoneHandler,
+				     BenchPtr);
+
+	/* Bursts of 8 beats of 16 bytes, the widest of the controller */
+	ChanCtrl->SrcBurstSize = 16U;
+	ChanCtrl->SrcBurstLen = 8U;
+	ChanCtrl->SrcInc = 1U;
+	ChanCtrl->DstBurstSize = 16U;
+	ChanCtrl->DstBurstLen = 8U;
+	ChanCtrl->DstInc = 1U;
+	BenchPtr->Cmd.BD.SrcAddr = (u32)(UINTPTR)QosBench_DmaBuf[0];
+	BenchPtr->Cmd.BD.DstAddr = (u32)(UINTPTR)QosBench_DmaBuf[1];
+	BenchPtr->Cmd.BD.Length = QOS_BENCH_DMA_BYTES;
+
+	Status = XDmaPs_GenDmaProg(&BenchPtr->Dma, QOS_BENCH_CHANNEL,
+				   &BenchPtr->Cmd);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	/* No line of the copy is to be written back over it later */
+	Xil_DCacheFlushRange((UINTPTR)QosBench_DmaBuf,
+			     sizeof(QosBench_DmaBuf));
+
+	QosBench_Link(BenchPtr);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Measures the latency of the DDR under a profile and a load.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	Profile is one of the DDR_QOS_* profiles.
+* @param	Load is QOS_BENCH_IDLE or QOS_BENCH_DMA.
+* @param	ResultPtr is where the result is stored.
+*
+* @return
+*		- XST_SUCCESS if the result is stored.
+*		- XST_INVALID_PARAM if the profile or the load is unknown.
+*		- XST_FAILURE if a copy failed or did not end.
+*		- The error of DdrQos_Set() or XDmaPs_Start() otherwise.
+*
+* @note		The status is also stored in the result.
+*
+*****************************************************************************/
+s32 QosBench_Run(QosBench *BenchPtr, u32 Profile, u32 Load,
+		 QosBench_Result *ResultPtr)
+{
+	u64 Sum = 0U;
+	XTime Start = 0U;
+	XTime End = 0U;
+	u32 Copies = 0U;
+	u32 Sample;
+	u32 Cycles;
+	u32 Index;
+	s32 Status;
+
+	(void)memset(ResultPtr, 0, sizeof(*ResultPtr));
+	ResultPtr->Profile = Profile;
+	ResultPtr->Load = Load;
+
+	if (Load >= QOS_BENCH_NUM_LOADS) {
+		ResultPtr->Status = XST_INVALID_PARAM;
+		return XST_INVALID_PARAM;
+	}
+
+	Status = DdrQos_Set(&BenchPtr->Qos, Profile);
+	if (Status != XST_SUCCESS) {
+		ResultPtr->Status = Status;
+		return Status;
+	}
+
+	if (Load == QOS_BENCH_DMA) {
+		Status = QosBench_StartLoad(BenchPtr);
+		if (Status != XST_SUCCESS) {
+			ResultPtr->Status = Status;
+			return Status;
+		}
+		Copies = BenchPtr->Copies;
+		XTime_GetTime(&Start);
+	}
+
+	/* The first chain is not counted, it settles the load */
+	(void)QosBench_Chase(BenchPtr);
+
+	for (Sample = 0U; Sample < QOS_BENCH_SAMPLES; Sample++) {
+		Cycles = QosBench_Chase(BenchPtr);
+		Sum += Cycles;
+
+		/* Insertion sort, the samples are few */
+		Index = Sample;
+		while ((Index > 0U) &&
+		       (BenchPtr->Samples[Index - 1U] > Cycles)) {
+			BenchPtr->Samples[Index] =
+				BenchPtr->Samples[Index - 1U];
+			Index--;
+		}
+		BenchPtr->Samples[Index] = Cycles;
+	}
+
+	if (Load == QOS_BENCH_DMA) {
+		XTime_GetTime(&End);
+		Copies = BenchPtr->Copies - Copies;
+		Status = QosBench_StopLoad(BenchPtr);
+		if (Status != XST_SUCCESS) {
+			ResultPtr->Status = Status;
+			return Status;
+		}
+		if (End != Start) {
+			ResultPtr->DmaMBps = (u32)(((u64)Copies *
+						    QOS_BENCH_DMA_BYTES *
+						    COUNTS_PER_SECOND) /
+						   ((End - Start) * 1000000U));
+		}
+	}
+
+	ResultPtr->MinCycles = BenchPtr->Samples[0];
+	ResultPtr->AvgCycles = (u32)(Sum / QOS_BENCH_SAMPLES);
+	ResultPtr->P99Cycles =
+		BenchPtr->Samples[(QOS_BENCH_SAMPLES * 99U) / 100U];
+	ResultPtr->MaxCycles = BenchPtr->Samples[QOS_BENCH_SAMPLES - 1U];
+	ResultPtr->Status = XST_SUCCESS;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Runs every profile idle and under load, then restores DDR_QOS_DEFAULT
+* and releases the program of the copy.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	ResultsPtr is where the results are stored.
+* @param	MaxResults is the number of results ResultsPtr can hold,
+*		QOS_BENCH_MAX_RESULTS for the full suite.
+*
+* @return	The number of results stored, including failed runs.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 QosBench_RunAll(QosBench *BenchPtr, QosBench_Result *ResultsPtr,
+		    u32 MaxResults)
+{
+	u32 NumResults = 0U;
+	u32 Profile;
+	u32 Load;
+
+	for (Profile = 0U; Profile < DDR_QOS_NUM; Profile++) {
+		for (Load = 0U; Load < QOS_BENCH_NUM_LOADS; Load++) {
+			if (NumResults >= MaxResults) {
+				break;
+			}
+			(void)QosBench_Run(BenchPtr, Profile, Load,
+					   &ResultsPtr[NumResults]);
+			NumResults++;
+		}
+	}
+
+	(void)DdrQos_Set(&BenchPtr->Qos, DDR_QOS_DEFAULT);
+	(void)XDmaPs_FreeDmaProg(&BenchPtr->Dma, QOS_BENCH_CHANNEL,
+				 &BenchPtr->Cmd);
+
+	return NumResults;
+}
+
+/****************************************************************************/
+/**
+*
+* Prints the results as a table on the standard output.
+*
+* @param	ResultsPtr is the results of QosBench_RunAll().
+* @param	NumResults is the number of results.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void QosBench_Report(const QosBench_Result *ResultsPtr, u32 NumResults)
+{
+	const QosBench_Result *ResultPtr;
+	u32 Index;
+
+	xil_printf("profile\tload\tcycles/load min/avg/p99/max\tdma MB/s\r\n");
+
+	for (Index = 0U; Index < NumResults; Index++) {
+		ResultPtr = &ResultsPtr[Index];
+
+		if (ResultPtr->Status != XST_SUCCESS) {
+			xil_printf("%s\t%s\tfailed (%d)\r\n",
+				   DdrQos_GetName(ResultPtr->Profile),
+				   (ResultPtr->Load < QOS_BENCH_NUM_LOADS) ?
+				   QosBench_LoadNames[ResultPtr->Load] :
+				   "unknown", ResultPtr->Status);
+			continue;
+		}
+
+		xil_printf("%s\t%s\t%u/%u/%u/%u\t%u\r\n",
+			   DdrQos_GetName(ResultPtr->Profile),
+			   QosBench_LoadNames[ResultPtr->Load],
+			   ResultPtr->MinCycles, ResultPtr->AvgCycles,
+			   ResultPtr->P99Cycles, ResultPtr->MaxCycles,
+			   ResultPtr->DmaMBps);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Links the lines of the chase buffer into one cycle in a random order,
+* drawn by Sattolo's algorithm, so that a chase from any line goes through
+* all of them.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void QosBench_Link(QosBench *BenchPtr)
+{
+	u32 *BufPtr = QosBench_ChaseBuf;
+	u32 Seed = QOS_BENCH_SEED;
+	u32 Line;
+	u32 Other;
+	u32 Next;
+
+	/* The next line of each line, as an index first */
+	for (Line = 0U; Line < QOS_BENCH_LINES; Line++) {
+		BufPtr[Line * QOS_BENCH_WORDS] = Line;
+	}
+
+	for (Line = QOS_BENCH_LINES - 1U; Line > 0U; Line--) {
+		/* Xorshift, good enough to defeat the prefetchers */
+		Seed ^= Seed << 13;
+		Seed ^= Seed >> 17;
+		Seed ^= Seed << 5;
+		Other = Seed % Line;
+
+		Next = BufPtr[Line * QOS_BENCH_WORDS];
+		BufPtr[Line * QOS_BENCH_WORDS] =
+			BufPtr[Other * QOS_BENCH_WORDS];
+		BufPtr[Other * QOS_BENCH_WORDS] = Next;
+	}
+
+	for (Line = 0U; Line < QOS_BENCH_LINES; Line++) {
+		Next = BufPtr[Line * QOS_BENCH_WORDS];
+		BufPtr[Line * QOS_BENCH_WORDS] =
+			(u32)(UINTPTR)&BufPtr[Next * QOS_BENCH_WORDS];
+	}
+
+	BenchPtr->ChasePtr = BufPtr;
+}
+
+/****************************************************************************/
+/*
+*
+* Follows QOS_BENCH_CHAIN pointers of the chase from where the last chain
+* stopped.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return	The mean cycles per load.
+*
+*****************************************************************************/
+static u32 QosBench_Chase(QosBench *BenchPtr)
+{
+	u32 *Ptr = BenchPtr->ChasePtr;
+	u32 Start;
+	u32 Cycles;
+	u32 Load;
+
+	Start = XTimestamp_Cycles();
+	for (Load = 0U; Load < QOS_BENCH_CHAIN; Load++) {
+		Ptr = (u32 *)(UINTPTR)*Ptr;
+	}
+	Cycles = XTimestamp_Cycles() - Start;
+
+	BenchPtr->ChasePtr = Ptr;
+
+	return Cycles / QOS_BENCH_CHAIN;
+}
+
+/****************************************************************************/
+/*
+*
+* Starts the copies, restarted by the done handler until
+* QosBench_StopLoad().
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return	XST_SUCCESS, or the error of XDmaPs_Start().
+*
+*****************************************************************************/
+static s32 QosBench_StartLoad(QosBench *BenchPtr)
+{
+	s32 Status;
+
+	BenchPtr->DmaStatus = 0;
+	BenchPtr->Loading = 1U;
+	BenchPtr->Busy = 1U;
+	dsb();
+
+	Status = XDmaPs_Start(&BenchPtr->Dma, QOS_BENCH_CHANNEL,
+			      &BenchPtr->Cmd, 1);
+	if (Status != XST_SUCCESS) {
+		BenchPtr->Loading = 0U;
+		BenchPtr->Busy = 0U;
+	}
+
+	return Status;
+}
+
+/****************************************************************************/
+/*
+*
+* Lets the copy in flight end without a restart.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if a copy failed or did not end,
+*		the channel being reset then.
+*
+*****************************************************************************/
+static s32 QosBench_StopLoad(QosBench *BenchPtr)
+{
+	u32 Start;
+
+	BenchPtr->Loading = 0U;
+	dsb();
+
+	Start = XTimestamp_Cycles();
+	while (BenchPtr->Busy != 0U) {
+		if ((XTimestamp_Cycles() - Start) > QOS_BENCH_TIMEOUT) {
+			(void)XDmaPs_ResetChannel(&BenchPtr->Dma,
+						  QOS_BENCH_CHANNEL);
+			BenchPtr->Busy = 0U;
+			return XST_FAILURE;
+		}
+	}
+
+	return (BenchPtr->DmaStatus == 0) ? XST_SUCCESS : XST_FAILURE;
+}
+
+/****************************************************************************/
+/*
+*
+* Done and fault handler of the load channel: counts the copy and starts
+* the next one while the load is on.
+*
+* @param	Channel is the DMA channel.
+* @param	DmaCmd is the command done.
+* @param	CallbackRef is the benchmark state.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void QosBench_DoneHandler(unsigned int Channel, XDmaPs_Cmd *DmaCmd,
+				 void *CallbackRef)
+{
+	QosBench *BenchPtr = (QosBench *)CallbackRef;
+
+	(void)Channel;
+
+	if ((DmaCmd != NULL) && (DmaCmd->DmaStatus != 0)) {
+		BenchPtr->DmaStatus = (s32)DmaCmd->DmaStatus;
+		BenchPtr->Loading = 0U;
+		BenchPtr->Busy = 0U;
+		return;
+	}
+
+	BenchPtr->Copies++;
+
+	/* The command is released before the handler, it may start again */
+	if ((BenchPtr->Loading != 0U) &&
+	    (XDmaPs_Start(&BenchPtr->Dma, QOS_BENCH_CHANNEL, &BenchPtr->Cmd,
+			  1) == XST_SUCCESS)) {
+		return;
+	}
+
+	BenchPtr->Busy = 0U;
+}
@@ -0,0 +1,114 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file qos_bench.h
+*
+* Latency of the DDR seen by CPU0 under each QoS profile of ddr_qos.h, idle
+* and under a bulk load of the PS DMA controller.
+*
+* A sample is the mean time of QOS_BENCH_CHAIN dependent loads, in CPU
+* cycles per load, chasing pointers through QOS_BENCH_CHASE_BYTES of
+* cacheable DDR, eight times the L2, with one pointer per cache line in a
+* random single cycle, so that nearly every load misses both caches and
+* the prefetchers have nothing to follow. Under load, channel
+* QOS_BENCH_CHANNEL copies QOS_BENCH_DMA_BYTES from DDR to DDR in bursts of
+* 8 beats of 16 bytes over and over, restarted by its done handler, and the
+* result also gives the throughput of the copies while the samples were
+* taken. The samples include the done interrupts, as a program running
+* next to the DMA would see them.
+*
+* The profile is switched with DdrQos_Set() before each run and
+* QosBench_RunAll() restores DDR_QOS_DEFAULT at the end. The benchmark is
+* built into the application when QOS_BENCH is defined.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef QOS_BENCH_H
+#define QOS_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xdmaps.h"
+#include "ddr_qos.h"
+
+/************************** Constant Definitions ****************************/
+
+/** @name Loads
+ * @{
+ */
+#define QOS_BENCH_IDLE		0U	/**< Nothing else running */
+#define QOS_BENCH_DMA		1U	/**< PS DMA copying DDR to DDR */
+#define QOS_BENCH_NUM_LOADS	2U
+/* @} */
+
+#define QOS_BENCH_CHANNEL	0U	/**< DMA channel of the load */
+#define QOS_BENCH_DMA_BYTES	(256U * 1024U) /**< Per copy */
+#define QOS_BENCH_CHASE_BYTES	(4U * 1024U * 1024U) /**< Chased */
+#define QOS_BENCH_CHAIN		1024U	/**< Loads per sample */
+#define QOS_BENCH_SAMPLES	256U	/**< Samples per result */
+
+/** Results of a full suite */
+#define QOS_BENCH_MAX_RESULTS	(DDR_QOS_NUM * QOS_BENCH_NUM_LOADS)
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Result of one profile and load.
+ */
+typedef struct {
+	u32 Profile;		/**< One of the DDR_QOS_* profiles */
+	u32 Load;		/**< QOS_BENCH_IDLE or QOS_BENCH_DMA */
+	s32 Status;		/**< XST_SUCCESS, or why the run failed */
+	u32 MinCycles;		/**< Fastest sample, per load */
+	u32 AvgCycles;		/**< Mean of the samples, per load */
+	u32 P99Cycles;		/**< 99th percentile sample, per load */
+	u32 MaxCycles;		/**< Slowest sample, per load */
+	u32 DmaMBps;		/**< Of the copies, 0 when idle */
+} QosBench_Result;
+
+/**
+ * State of the benchmark, shared with the done handler.
+ */
+typedef struct {
+	DdrQos Qos;		/**< The profiles */
+	XDmaPs Dma;		/**< The PS DMA controller */
+	XDmaPs_Cmd Cmd;		/**< The copy, its program held */
+	volatile u32 Loading;	/**< The done handler restarts the copy */
+	volatile u32 Busy;	/**< A copy is in flight */
+	volatile u32 Copies;	/**< Copies done */
+	volatile s32 DmaStatus;	/**< Of the last copy that failed */
+	u32 *ChasePtr;		/**< Where the chase goes on */
+	u32 Samples[QOS_BENCH_SAMPLES]; /**< Sorted, cycles per load */
+} QosBench;
+
+/************************** Function Prototypes *****************************/
+
+s32 QosBench_Initialize(QosBench *BenchPtr);
+s32 QosBench_Run(QosBench *BenchPtr, u32 Profile, u32 Load,
+		 QosBench_Result *ResultPtr);
+u32 QosBench_RunAll(QosBench *BenchPtr, QosBench_Result *ResultsPtr,
+		    u32 MaxResults);
+void QosBench_Report(const QosBench_Result *ResultsPtr, u32 NumResults);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* QOS_BENCH_H */
@@ -0,0 +1,1047 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file qspi_flash.c
+*
+* Programming of the QSPI boot flash. Refer to qspi_flash.h for how it is
+* used.
+*
+* Every command goes through QspiFlash_Select(), which turns an offset of
+* the image into the address of a device, selects the device and bank of
+* the address and returns how many bytes of the image follow it before
+* the next device or bank boundary, so that no command crosses one.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Refused when code executes in place from the flash
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xparameters.h"
+
+#ifdef XPAR_XQSPIPS_0_BASEADDR
+
+#include <string.h>
+#include "xstatus.h"
+#include "qspi_flash.h"
+
+/************************** Constant Definitions ****************************/
+
+#define QSPI_FLASH_WRITE_ENABLE_CMD	0x06U
+#define QSPI_FLASH_READ_STATUS_CMD	0x05U
+#define QSPI_FLASH_READ_ID_CMD		0x9FU
+#define QSPI_FLASH_PAGE_PROGRAM_CMD	0x02U
+#define QSPI_FLASH_QUAD_PROGRAM_CMD	0x32U
+#define QSPI_FLASH_FAST_READ_CMD	0x0BU
+#define QSPI_FLASH_QUAD_READ_CMD	0x6BU
+#define QSPI_FLASH_SUBSECTOR_ERASE_CMD	0x20U
+#define QSPI_FLASH_SECTOR_ERASE_CMD	0xD8U
+#define QSPI_FLASH_EXTADD_REG_WR	0xC5U	/* Micron, Macronix, Winbond */
+#define QSPI_FLASH_BANK_REG_WR		0x17U	/* Spansion */
+
+#define QSPI_FLASH_SPANSION_ID		0x01U
+#define QSPI_FLASH_MACRONIX_ID		0xC2U
+
+#define QSPI_FLASH_OVERHEAD		4U	/* Command and address */
+#define QSPI_FLASH_DUMMY		1U	/* Of the fast and quad reads */
+
+/*
+ * Write in progress of the status register. On a dual parallel connection
+ * the controller interleaves the bits of the two devices, the low bits of
+ * their statuses arriving in the second byte, WIP of the lower device in
+ * bit 0 and of the upper one in bit 1.
+ */
+#define QSPI_FLASH_STATUS_WIP		0x01U
+#define QSPI_FLASH_STATUS_WIP_PARALLEL	0x03U
+
+#define QSPI_FLASH_BANK_UNKNOWN		0xFFFFFFFFU
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/*
+ * Bytes of the image of a device size, both devices side by side on a dual
+ * parallel connection.
+ */
+#define QspiFlash_ImageBytes(FlashPtr, Bytes)				\
+	(((FlashPtr)->Connection == XQSPIPS_CONNECTION_MODE_PARALLEL) ?	\
+	 ((Bytes) * 2U) : (Bytes))
+
+/*
+ * Data of the read frame
+ */
+#define QspiFlash_FrameData(FlashPtr)					\
+	(&(FlashPtr)->ReadFrame[QSPI_FLASH_OVERHEAD + QSPI_FLASH_DUMMY])
+
+#define QspiFlash_Progress(FlashPtr)					\
+	do {								\
+		if ((FlashPtr)->WdtOpPtr != NULL) {			\
+			WdtService_Progress((FlashPtr)->WdtOpPtr);	\
+		}							\
+	} while (0)
+
+/************************** Function Prototypes *****************************/
+
+static u32 QspiFlash_DeviceSize(u8 Make, u8 Code);
+static s32 QspiFlash_Command(QspiFlash *FlashPtr, u8 Cmd, u32 Address,
+			     u32 NumBytes);
+static s32 QspiFlash_WriteEnable(QspiFlash *FlashPtr);
+static s32 QspiFlash_Select(QspiFlash *FlashPtr, u32 Offset,
+			    u32 *AddressPtr, u32 *RoomPtr);
+static s32 QspiFlash_ReadFrame(QspiFlash *FlashPtr, u32 Offset,
+			       u32 *CountPtr);
+static s32 QspiFlash_Wait(QspiFlash *FlashPtr, u32 TimeoutMs,
+			  XTime *CountsPtr);
+static s32 QspiFlash_EraseBlock(QspiFlash *FlashPtr, u32 Offset,
+				u32 NumBytes);
+static u32 QspiFlash_BuildPage(const QspiFlash *FlashPtr, u8 *FramePtr,
+			       u32 Offset, const u8 *DataPtr, u32 NumBytes);
+static s32 QspiFlash_Compare(QspiFlash *FlashPtr, u32 Offset,
+			     const u8 *DataPtr, u32 NumBytes,
+			     u32 *ChangedPtr, u32 *NeedsErasePtr);
+
+/************************** Variable Definitions ****************************/
+
+/* Set by a linker script that executes .xip in place from the flash */
+extern u8 __qspi_xip[] __attribute__((weak));
+
+/****************************************************************************/
+/**
+*
+* Initializes the QSPI controller in I/O mode for the connection of the
+* hardware design and identifies the flash.
+*
+* @param	FlashPtr is a pointer to the engine.
+* @param	Options is QSPI_FLASH_QUAD_READ and QSPI_FLASH_QUAD_PROGRAM
+*		ORed, or 0 for 1-bit transfers.
+*
+* @return
+*		- XST_SUCCESS if the flash was identified.
+*		- XST_DEVICE_NOT_FOUND if there is no QSPI controller.
+*		- XST_DEVICE_BUSY if the application executes code in place
+*		from the linear read window, linked with _QSPI_XIP.
+*		- XST_FAILURE if the flash did not answer or its size is not
+*		known.
+*
+* @note		The linear read window of the flash is not usable after this.
+*
+*****************************************************************************/
+s32 QspiFlash_Initialize(QspiFlash *FlashPtr, u32 Options)
+{
+	XQspiPs_Config *ConfigPtr;
+	u8 *FramePtr = FlashPtr->ReadFrame;
+	s32 Status;
+
+	(void)memset(FlashPtr, 0, sizeof(*FlashPtr));
+
+	if ((UINTPTR)__qspi_xip != 0U) {
+		return XST_DEVICE_BUSY;
+	}
+
+	ConfigPtr = XQspiPs_LookupConfig(XPAR_XQSPIPS_0_BASEADDR);
+	if (ConfigPtr == NULL) {
+		return XST_DEVICE_NOT_FOUND;
+	}
+
+	Status = XQspiPs_CfgInitialize(&FlashPtr->Qspi, ConfigPtr,
+				       ConfigPtr->BaseAddress);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	FlashPtr->Connection = ConfigPtr->ConnectionMode;
+
+	XQspiPs_Disable(&FlashPtr->Qspi);
+	(void)XQspiPs_SetOptions(&FlashPtr->Qspi,
+				 XQSPIPS_FORCE_SSELECT_OPTION |
+				 XQSPIPS_HOLD_B_DRIVE_OPTION);
+	(void)XQspiPs_SetClkPrescaler(&FlashPtr->Qspi, QSPI_FLASH_PRESCALER);
+	if (FlashPtr->Connection == XQSPIPS_CONNECTION_MODE_PARALLEL) {
+		XQspiPs_SetLqspiConfigReg(&FlashPtr->Qspi,
+					  XQSPIPS_LQSPI_CR_TWO_MEM_MASK |
+					  XQSPIPS_LQSPI_CR_SEP_BUS_MASK);
+	} else if (FlashPtr->Connection == XQSPIPS_CONNECTION_MODE_STACKED) {
+		XQspiPs_SetLqspiConfigReg(&FlashPtr->Qspi,
+					  XQSPIPS_LQSPI_CR_TWO_MEM_MASK);
+	}
+	(void)XQspiPs_SetSlaveSelect(&FlashPtr->Qspi);
+	XQspiPs_Enable(&FlashPtr->Qspi);
+
+	/*
+	 * Identify the flash, the lower device of a stacked connection
+	 */
+	(void)memset(FramePtr, 0, 4U);
+	FramePtr[0] = QSPI_FLASH_READ_ID_CMD;
+	Status = XQspiPs_PolledTransfer(&FlashPtr->Qspi, FramePtr, FramePtr,
+					4U);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	FlashPtr->Make = FramePtr[1];
+	FlashPtr->DeviceSize = QspiFlash_DeviceSize(FramePtr[1], FramePtr[3]);
+	if (FlashPtr->DeviceSize == 0U) {
+		return XST_FAILURE;
+	}
+
+	FlashPtr->Options = Options;
+	FlashPtr->Size = FlashPtr->DeviceSize;
+	if (FlashPtr->Connection != XQSPIPS_CONNECTION_MODE_SINGLE) {
+		FlashPtr->Size *= 2U;
+	}
+	FlashPtr->PageSize = QspiFlash_ImageBytes(FlashPtr,
+						  QSPI_FLASH_PAGE_SIZE);
+	FlashPtr->LargeErase = QspiFlash_ImageBytes(FlashPtr,
+						    QSPI_FLASH_SECTOR_SIZE);
+
+	/*
+	 * Spansion parts of this size have 4 KB subsectors at one end only,
+	 * they are erased by sectors
+	 */
+	if (FlashPtr->Make == QSPI_FLASH_SPANSION_ID) {
+		FlashPtr->SmallEraseCmd = QSPI_FLASH_SECTOR_ERASE_CMD;
+		FlashPtr->SmallErase = FlashPtr->LargeErase;
+	} else {
+		FlashPtr->SmallEraseCmd = QSPI_FLASH_SUBSECTOR_ERASE_CMD;
+		FlashPtr->SmallErase = QspiFlash_ImageBytes(FlashPtr,
+						QSPI_FLASH_SUBSECTOR_SIZE);
+	}
+
+	FlashPtr->ProgramCmd = QSPI_FLASH_PAGE_PROGRAM_CMD;
+	if (((Options & QSPI_FLASH_QUAD_PROGRAM) != 0U) &&
+	    (FlashPtr->Make != QSPI_FLASH_MACRONIX_ID)) {
+		FlashPtr->ProgramCmd = QSPI_FLASH_QUAD_PROGRAM_CMD;
+	}
+	FlashPtr->ReadCmd = ((Options & QSPI_FLASH_QUAD_READ) != 0U) ?
+			    QSPI_FLASH_QUAD_READ_CMD : QSPI_FLASH_FAST_READ_CMD;
+
+	/*
+	 * The bank registers are not known after the reset, the first
+	 * command past 16 MB sets them
+	 */
+	FlashPtr->Bank = QSPI_FLASH_BANK_UNKNOWN;
+	FlashPtr->Upper = 0U;
+	FlashPtr->Ready = 1U;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Gives an operation of the watchdog service the progress of the engine,
+* reported at each page and erase.
+*
+* @param	FlashPtr is a pointer to the engine.
+* @param	OpPtr is a pointer to an operation begun with
+*		WdtService_Begin(), or NULL for none.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void QspiFlash_SetWdtOp(QspiFlash *FlashPtr, WdtService_Op *OpPtr)
+{
+	FlashPtr->WdtOpPtr = OpPtr;
+}
+
+/****************************************************************************/
+/**
+*
+* Reads the flash.
+*
+* @param	FlashPtr is a pointer to the engine.
+* @param	Offset is the offset of the first byte in the image.
+* @param	BufferPtr is a pointer to the buffer of the bytes.
+* @param	NumBytes is the number of bytes.
+*
+* @return
+*		- XST_SUCCESS if the bytes were read.
+*		- XST_INVALID_PARAM if the range is not in the flash, or is
+*		odd on a dual parallel connection.
+*		- XST_FAILURE if a transfer failed.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 QspiFlash_Read(QspiFlash *FlashPtr, u32 Offset, u8 *BufferPtr,
+		   u32 NumBytes)
+{
+	u32 Count;
+	s32 Status;
+
+	if ((FlashPtr->Ready == 0U) || (Offset > FlashPtr->Size) ||
+	    (NumBytes > (FlashPtr->Size - Offset))) {
+		return XST_INVALID_PARAM;
+	}
+	if ((FlashPtr->Connection == XQSPIPS_CONNECTION_MODE_PARALLEL) &&
+	    (((Offset | NumBytes) & 1U) != 0U)) {
+		return XST_INVALID_PARAM;
+	}
+
+	while (NumBytes > 0U) {
+		Count = NumBytes;
+		Status = QspiFlash_ReadFrame(FlashPtr, Offset, &Count);
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+		(void)memcpy(BufferPtr, QspiFlash_FrameData(FlashPtr), Count);
+
+		Offset += Count;
+		BufferPtr += Count;
+		NumBytes -= Count;
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Erases a range of the flash, with sector erases where the range holds a
+* whole sector and small erases elsewhere, and waits for the erases.
+*
+* @param	FlashPtr is a pointer to the engine.
+* @param	Offset is the offset of the range in the image, a multiple
+*		of the small erase.
+* @param	NumBytes is the size of the range, rounded up to the small
+*		erase.
+*
+* @return
+*		- XST_SUCCESS if the range was erased.
+*		- XST_INVALID_PARAM if the range is not in the flash or is not
+*		aligned.
+*		- XST_FAILURE if a transfer failed or an erase did not end.
+*
+* @note		The small erase is 4 KB of each device, 64 KB on Spansion
+*		parts.
+*
+*****************************************************************************/
+s32 QspiFlash_Erase(QspiFlash *FlashPtr, u32 Offset, u32 NumBytes)
+{
+	u32 Block;
+	s32 Status;
+
+	if ((FlashPtr->Ready == 0U) ||
+	    ((Offset % FlashPtr->SmallErase) != 0U) ||
+	    (Offset > FlashPtr->Size) ||
+	    (NumBytes > (FlashPtr->Size - Offset))) {
+		return XST_INVALID_PARAM;
+	}
+
+	while (NumBytes > 0U) {
+		if (((Offset % FlashPtr->LargeErase) == 0U) &&
+		    (NumBytes >= FlashPtr->LargeErase)) {
+			Block = FlashPtr->LargeErase;
+		} else {
+			Block = FlashPtr->SmallErase;
+		}
+
+		Status = QspiFlash_EraseBlock(FlashPtr, Offset, Block);
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+
+		Offset += Block;
+		NumBytes = (NumBytes > Block) ? (NumBytes - Block) : 0U;
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Programs erased flash, or flash whose bits the data only clears. Pages
+* all of erased bytes are skipped, the frame of each page is built while
+* the flash programs the one before.
+*
+* @param	FlashPtr is a pointer to the engine.
+* @param	Offset is the offset of the first byte in the image.
+* @param	DataPtr is a pointer to the data.
+* @param	NumBytes is the number of bytes.
+*
+* @return
+*		- XST_SUCCESS if the data was programmed.
+*		- XST_INVALID_PARAM if the range is not in the flash, or is
+*		odd on a dual parallel connection.
+*		- XST_FAILURE if a transfer failed or a program did not end.
+*
+* @note		The data is not verified, QspiFlash_Update() does.
+*
+*****************************************************************************/
+s32 QspiFlash_Program(QspiFlash *FlashPtr, u32 Offset, const u8 *DataPtr,
+		      u32 NumBytes)
+{
+	u8 *FramePtr;
+	u32 Frame = 0U;
+	u32 Address;
+	u32 Room;
+	u32 Count;
+	u32 Length;
+	u32 Busy = 0U;
+	XTime Sent = 0U;
+	XTime Counts;
+	s32 Status;
+
+	if ((FlashPtr->Ready == 0U) || (Offset > FlashPtr->Size) ||
+	    (NumBytes > (FlashPtr->Size - Offset))) {
+		return XST_INVALID_PARAM;
+	}
+	if ((FlashPtr->Connection == XQSPIPS_CONNECTION_MODE_PARALLEL) &&
+	    (((Offset | NumBytes) & 1U) != 0U)) {
+		return XST_INVALID_PARAM;
+	}
+
+	while (NumBytes > 0U) {
+		/*
+		 * Up to the end of the page of the image
+		 */
+		Count = FlashPtr->PageSize - (Offset % FlashPtr->PageSize);
+		if (Count > NumBytes) {
+			Count = NumBytes;
+		}
+
+		/*
+		 * Build the frame of this page while the last one programs
+		 */
+		FramePtr = FlashPtr->PageFrame[Frame];
+		Length = QspiFlash_BuildPage(FlashPtr, FramePtr, Offset,
+					     DataPtr, Count);
+
+		if (Busy != 0U) {
+			Status = QspiFlash_Wait(FlashPtr,
+						QSPI_FLASH_PAGE_TIMEOUT_MS,
+						&Counts);
+			if (Status != XST_SUCCESS) {
+				return Status;
+			}
+			XTime_GetTime(&Counts);
+			Counts -= Sent;
+			if (Counts > FlashPtr->Stats.MaxPageCounts) {
+				FlashPtr->Stats.MaxPageCounts = Counts;
+			}
+			Busy = 0U;
+		}
+
+		if (Length == 0U) {
+			FlashPtr->Stats.PagesSkipped++;
+		} else {
+			/*
+			 * Selected only now, a busy flash ignores the bank
+			 * select
+			 */
+			Status = QspiFlash_Select(FlashPtr, Offset, &Address,
+						  &Room);
+			if (Status != XST_SUCCESS) {
+				return Status;
+			}
+
+			Status = QspiFlash_WriteEnable(FlashPtr);
+			if (Status != XST_SUCCESS) {
+				return Status;
+			}
+			Status = XQspiPs_PolledTransfer(&FlashPtr->Qspi,
+							FramePtr, NULL, Length);
+			if (Status != XST_SUCCESS) {
+				return XST_FAILURE;
+			}
+			XTime_GetTime(&Sent);
+			FlashPtr->Stats.Pages++;
+			Busy = 1U;
+			Frame ^= 1U;
+		}
+		QspiFlash_Progress(FlashPtr);
+
+		Offset += Count;
+		DataPtr += Count;
+		NumBytes -= Count;
+	}
+
+	if (Busy != 0U) {
+		Status = QspiFlash_Wait(FlashPtr, QSPI_FLASH_PAGE_TIMEOUT_MS,
+					&Counts);
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+		XTime_GetTime(&Counts);
+		Counts -= Sent;
+		if (Counts > FlashPtr->Stats.MaxPageCounts) {
+			FlashPtr->Stats.MaxPageCounts = Counts;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Writes an image to the flash with the least erases and programs its
+* content needs, then reads it back. Each erase block is compared with
+* the image first: it is left alone if it is the image already, programmed
+* without an erase if the image only clears bits of it, and erased and
+* programmed otherwise.
+*
+* @param	FlashPtr is a pointer to the engine.
+* @param	Offset is the offset of the image in the flash, a multiple of
+*		the small erase.
+* @param	DataPtr is a pointer to the image.
+* @param	NumBytes is the size of the image.
+*
+* @return
+*		- XST_SUCCESS if the flash holds the image.
+*		- XST_INVALID_PARAM if the range is not in the flash or is not
+*		aligned.
+*		- XST_DATA_LOST if the image read back wrong, counted in
+*		VerifyErrors.
+*		- XST_FAILURE if a transfer failed or an erase or program did
+*		not end.
+*
+* @note		The rest of the last erase block past the image is erased
+*		when that block is.
+*
+*****************************************************************************/
+s32 QspiFlash_Update(QspiFlash *FlashPtr, u32 Offset, const u8 *DataPtr,
+		     u32 NumBytes)
+{
+	u32 Block;
+	u32 Count;
+	u32 Changed;
+	u32 NeedsErase;
+	u32 Errors = 0U;
+	u32 Index;
+	u32 Done;
+	u32 Chunk;
+	const u8 *FlashDataPtr = QspiFlash_FrameData(FlashPtr);
+	s32 Status;
+
+	if ((FlashPtr->Ready == 0U) ||
+	    ((Offset % FlashPtr->SmallErase) != 0U) ||
+	    (Offset > FlashPtr->Size) ||
+	    (NumBytes > (FlashPtr->Size - Offset)) ||
+	    ((FlashPtr->Connection == XQSPIPS_CONNECTION_MODE_PARALLEL) &&
+	     ((NumBytes & 1U) != 0U))) {
+		return XST_INVALID_PARAM;
+	}
+
+	for (Done = 0U; Done < NumBytes; Done += Block) {
+		if ((((Offset + Done) % FlashPtr->LargeErase) == 0U) &&
+		    ((NumBytes - Done) >= FlashPtr->LargeErase)) {
+			Block = FlashPtr->LargeErase;
+		} else {
+			Block = FlashPtr->SmallErase;
+		}
+		Count = ((NumBytes - Done) < Block) ? (NumBytes - Done) : Block;
+
+		Status = QspiFlash_Compare(FlashPtr, Offset + Done,
+					   &DataPtr[Done], Count, &Changed,
+					   &NeedsErase);
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+
+		if (Changed == 0U) {
+			FlashPtr->Stats.BlocksKept++;
+			continue;
+		}
+
+		if (NeedsErase != 0U) {
+			Status = QspiFlash_EraseBlock(FlashPtr, Offset + Done,
+						      Block);
+			if (Status != XST_SUCCESS) {
+				return Status;
+			}
+		} else {
+			FlashPtr->Stats.BlocksNoErase++;
+		}
+
+		Status = QspiFlash_Program(FlashPtr, Offset + Done,
+					   &DataPtr[Done], Count);
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+	}
+
+	/*
+	 * Read back, in the read frame
+	 */
+	for (Done = 0U; Done < NumBytes; Done += Chunk) {
+		Chunk = NumBytes - Done;
+		Status = QspiFlash_ReadFrame(FlashPtr, Offset + Done, &Chunk);
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+		for (Index = 0U; Index < Chunk; Index++) {
+			if (FlashDataPtr[Index] != DataPtr[Done + Index]) {
+				Errors++;
+			}
+		}
+		QspiFlash_Progress(FlashPtr);
+	}
+
+	FlashPtr->Stats.VerifyErrors += Errors;
+
+	return (Errors == 0U) ? XST_SUCCESS : XST_DATA_LOST;
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the counts of the engine.
+*
+* @param	FlashPtr is a pointer to the engine.
+* @param	StatsPtr is a pointer to the copy of the counts.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void QspiFlash_GetStats(const QspiFlash *FlashPtr, QspiFlash_Stats *StatsPtr)
+{
+	*StatsPtr = FlashPtr->Stats;
+}
+
+/****************************************************************************/
+/*
+*
+* Returns the size of a device from the capacity code of its ID. Codes
+* from 18h up are those of the makes, not powers of two.
+*
+* @param	Make is the manufacturer ID.
+* @param	Code is the capacity code, the third byte of the ID.
+*
+* @return	The bytes of the device, 0 if the code is not known.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 QspiFlash_DeviceSize(u8 Make, u8 Code)
+{
+	if ((Code >= 0x14U) && (Code <= 0x19U)) {
+		return 1UL << Code;
+	}
+
+	if (Make == QSPI_FLASH_MACRONIX_ID) {
+		if ((Code >= 0x1AU) && (Code <= 0x1BU)) {
+			return 0x4000000UL << (Code - 0x1AU);
+		}
+	} else if ((Code >= 0x20U) && (Code <= 0x21U)) {
+		return 0x4000000UL << (Code - 0x20U);
+	}
+
+	return 0U;
+}
+
+/****************************************************************************/
+/*
+*
+* Sends a command with a 3-byte address in the read frame and receives
+* into it.
+*
+* @param	FlashPtr is a pointer to the engine.
+* @param	Cmd is the command.
+* @param	Address is the address in the bank of the device.
+* @param	NumBytes is the number of bytes of the transfer, with the
+*		command.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if the transfer failed.
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 QspiFlash_Command(QspiFlash *FlashPtr, u8 Cmd, u32 Address,
+			     u32 NumBytes)
+{
+	u8 *FramePtr = FlashPtr->ReadFrame;
+
+	FramePtr[0] = Cmd;
+	FramePtr[1] = (u8)(Address >> 16);
+	FramePtr[2] = (u8)(Address >> 8);
+	FramePtr[3] = (u8)Address;
+
+	if (XQspiPs_PolledTransfer(&FlashPtr->Qspi, FramePtr, FramePtr,
+				   NumBytes) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Sends the write enable command.
+*
+* @param	FlashPtr is a pointer to the engine.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if the transfer failed.
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 QspiFlash_WriteEnable(QspiFlash *FlashPtr)
+{
+	u8 Cmd = QSPI_FLASH_WRITE_ENABLE_CMD;
+
+	if (XQspiPs_PolledTransfer(&FlashPtr->Qspi, &Cmd, NULL, 1U) !=
+	    XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Selects the device and bank of an offset of the image, as QspiAccess()
+* of the FSBL: on a dual stacked connection the upper device past the
+* size of the lower one with U_PAGE, on a dual parallel connection both
+* devices at half the offset.
+*
+* @param	FlashPtr is a pointer to the engine.
+* @param	Offset is the offset in the image.
+* @param	AddressPtr is a pointer to the 3-byte address in the bank.
+* @param	RoomPtr is a pointer to the bytes of the image from Offset to
+*		the end of the bank or device.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if the bank select failed.
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 QspiFlash_Select(QspiFlash *FlashPtr, u32 Offset,
+			    u32 *AddressPtr, u32 *RoomPtr)
+{
+	u32 Address = Offset;
+	u32 Upper = 0U;
+	u32 Bank;
+	u32 Room;
+	u32 ConfigReg;
+	u8 Frame[2];
+
+	if (FlashPtr->Connection == XQSPIPS_CONNECTION_MODE_PARALLEL) {
+		Address = Offset / 2U;
+	} else if ((FlashPtr->Connection == XQSPIPS_CONNECTION_MODE_STACKED) &&
+		   (Offset >= FlashPtr->DeviceSize)) {
+		Address = Offset - FlashPtr->DeviceSize;
+		Upper = 1U;
+	}
+
+	if (Upper != FlashPtr->Upper) {
+		ConfigReg = XQspiPs_GetLqspiConfigReg(&FlashPtr->Qspi);
+		if (Upper != 0U) {
+			ConfigReg |= XQSPIPS_LQSPI_CR_U_PAGE_MASK;
+		} else {
+			ConfigReg &= ~XQSPIPS_LQSPI_CR_U_PAGE_MASK;
+		}
+		XQspiPs_SetLqspiConfigReg(&FlashPtr->Qspi, ConfigReg);
+		(void)XQspiPs_SetSlaveSelect(&FlashPtr->Qspi);
+		FlashPtr->Upper = Upper;
+		FlashPtr->Bank = QSPI_FLASH_BANK_UNKNOWN;
+	}
+
+	Room = FlashPtr->DeviceSize - Address;
+	if (FlashPtr->DeviceSize > QSPI_FLASH_BANK_SIZE) {
+		Bank = Address / QSPI_FLASH_BANK_SIZE;
+		Room = QSPI_FLASH_BANK_SIZE - (Address % QSPI_FLASH_BANK_SIZE);
+
+		if (Bank != FlashPtr->Bank) {
+			Frame[1] = (u8)Bank;
+			if (FlashPtr->Make == QSPI_FLASH_SPANSION_ID) {
+				Frame[0] = QSPI_FLASH_BANK_REG_WR;
+			} else {
+				if (QspiFlash_WriteEnable(FlashPtr) !=
+				    XST_SUCCESS) {
+					return XST_FAILURE;
+				}
+				Frame[0] = QSPI_FLASH_EXTADD_REG_WR;
+			}
+			if (XQspiPs_PolledTransfer(&FlashPtr->Qspi, Frame, NULL,
+						   2U) != XST_SUCCESS) {
+				return XST_FAILURE;
+			}
+			FlashPtr->Bank = Bank;
+			FlashPtr->Stats.BankSelects++;
+		}
+	}
+
+	*AddressPtr = Address % QSPI_FLASH_BANK_SIZE;
+	*RoomPtr = QspiFlash_ImageBytes(FlashPtr, Room);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Reads into the read frame as many bytes from an offset as one command
+* reads, up to a chunk, the end of the bank or device, or those asked for.
+*
+* @param	FlashPtr is a pointer to the engine.
+* @param	Offset is the offset of the first byte in the image.
+* @param	CountPtr is a pointer to the bytes asked for, set to those
+*		read, at QspiFlash_FrameData().
+*
+* @return	XST_SUCCESS, or XST_FAILURE if a transfer failed.
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 QspiFlash_ReadFrame(QspiFlash *FlashPtr, u32 Offset,
+			       u32 *CountPtr)
+{
+	u32 Address;
+	u32 Room;
+	u32 Count = *CountPtr;
+	s32 Status;
+
+	Status = QspiFlash_Select(FlashPtr, Offset, &Address, &Room);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	if (Count > QSPI_FLASH_READ_CHUNK) {
+		Count = QSPI_FLASH_READ_CHUNK;
+	}
+	if (Count > Room) {
+		Count = Room;
+	}
+
+	Status = QspiFlash_Command(FlashPtr, FlashPtr->ReadCmd, Address,
+				   QSPI_FLASH_OVERHEAD + QSPI_FLASH_DUMMY +
+				   Count);
+	*CountPtr = Count;
+
+	return Status;
+}
+
+/****************************************************************************/
+/*
+*
+* Polls the status register until the erase or program in progress ends.
+*
+* @param	FlashPtr is a pointer to the engine.
+* @param	TimeoutMs is the longest time of the operation.
+* @param	CountsPtr is a pointer to the global timer counts it took.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if a transfer failed or the flash
+*		stayed busy.
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 QspiFlash_Wait(QspiFlash *FlashPtr, u32 TimeoutMs,
+			  XTime *CountsPtr)
+{
+	u32 Mask = QSPI_FLASH_STATUS_WIP;
+	XTime Limit = ((XTime)TimeoutMs * COUNTS_PER_SECOND) / 1000U;
+	XTime Start;
+	XTime Now;
+	u8 Frame[3];
+
+	if (FlashPtr->Connection == XQSPIPS_CONNECTION_MODE_PARALLEL) {
+		Mask = QSPI_FLASH_STATUS_WIP_PARALLEL;
+	}
+
+	XTime_GetTime(&Start);
+	do {
+		Frame[0] = QSPI_FLASH_READ_STATUS_CMD;
+		Frame[1] = 0U;
+		Frame[2] = 0U;
+		if (XQspiPs_PolledTransfer(&FlashPtr->Qspi, Frame, Frame,
+					   3U) != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+		XTime_GetTime(&Now);
+		/* The status repeats while selected, the second is fresh */
+		if ((Frame[2] & Mask) == 0U) {
+			*CountsPtr = Now - Start;
+			return XST_SUCCESS;
+		}
+	} while ((Now - Start) < Limit);
+
+	return XST_FAILURE;
+}
+
+/****************************************************************************/
+/*
+*
+* Erases one block with the erase of its size and waits for it.
+*
+* @param	FlashPtr is a pointer to the engine.
+* @param	Offset is the offset of the block in the image.
+* @param	NumBytes is the small or the large erase.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if a transfer failed or the erase
+*		did not end.
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 QspiFlash_EraseBlock(QspiFlash *FlashPtr, u32 Offset,
+				u32 NumBytes)
+{
+	u32 Large = (NumBytes == FlashPtr->LargeErase) ? 1U : 0U;
+	u32 Address;
+	u32 Room;
+	XTime Counts;
+	s32 Status;
+
+	Status = QspiFlash_Select(FlashPtr, Offset, &Address, &Room);
+	if (Status == XST_SUCCESS) {
+		Status = QspiFlash_WriteEnable(FlashPtr);
+	}
+	if (Status == XST_SUCCESS) {
+		Status = QspiFlash_Command(FlashPtr, (Large != 0U) ?
+					   QSPI_FLASH_SECTOR_ERASE_CMD :
+					   FlashPtr->SmallEraseCmd,
+					   Address, QSPI_FLASH_OVERHEAD);
+	}
+	if (Status == XST_SUCCESS) {
+		Status = QspiFlash_Wait(FlashPtr, (Large != 0U) ?
+					QSPI_FLASH_SECTOR_TIMEOUT_MS :
+					QSPI_FLASH_SUBSECTOR_TIMEOUT_MS,
+					&Counts);
+	}
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	if (Large != 0U) {
+		FlashPtr->Stats.SectorErases++;
+	} else {
+		FlashPtr->Stats.SubsectorErases++;
+	}
+	if (Counts > FlashPtr->Stats.MaxEraseCounts) {
+		FlashPtr->Stats.MaxEraseCounts = Counts;
+	}
+	QspiFlash_Progress(FlashPtr);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Builds the program frame of a page, the command and address of the
+* offset and the data.
+*
+* @param	FlashPtr is a pointer to the engine.
+* @param	FramePtr is a pointer to the frame.
+* @param	Offset is the offset of the data in the image.
+* @param	DataPtr is a pointer to the data.
+* @param	NumBytes is the number of bytes, within the page.
+*
+* @return	The bytes of the frame, 0 if the data is all erased bytes and
+*		the page needs no program.
+*
+* @note		The address bytes are those of the device, set from the
+*		offset as QspiFlash_Select() does, without selecting.
+*
+*****************************************************************************/
+static u32 QspiFlash_BuildPage(const QspiFlash *FlashPtr, u8 *FramePtr,
+			       u32 Offset, const u8 *DataPtr, u32 NumBytes)
+{
+	u32 Address = Offset;
+	u32 Index;
+	u32 Erased = 1U;
+
+	for (Index = 0U; Index < NumBytes; Index++) {
+		if (DataPtr[Index] != 0xFFU) {
+			Erased = 0U;
+			break;
+		}
+	}
+	if (Erased != 0U) {
+		return 0U;
+	}
+
+	if (FlashPtr->Connection == XQSPIPS_CONNECTION_MODE_PARALLEL) {
+		Address = Offset / 2U;
+	} else if ((FlashPtr->Connection == XQSPIPS_CONNECTION_MODE_STACKED) &&
+		   (Offset >= FlashPtr->DeviceSize)) {
+		Address = Offset - FlashPtr->DeviceSize;
+	}
+	Address %= QSPI_FLASH_BANK_SIZE;
+
+	FramePtr[0] = FlashPtr->ProgramCmd;
+	FramePtr[1] = (u8)(Address >> 16);
+	FramePtr[2] = (u8)(Address >> 8);
+	FramePtr[3] = (u8)Address;
+	(void)memcpy(&FramePtr[QSPI_FLASH_OVERHEAD], DataPtr, NumBytes);
+
+	return QSPI_FLASH_OVERHEAD + NumBytes;
+}
+
+/****************************************************************************/
+/*
+*
+* Compares a block of the flash with the image.
+*
+* @param	FlashPtr is a pointer to the engine.
+* @param	Offset is the offset of the block in the image.
+* @param	DataPtr is a pointer to the image of the block.
+* @param	NumBytes is the bytes of the image in the block.
+* @param	ChangedPtr is a pointer to 1 if the flash differs from the
+*		image, 0 if not.
+* @param	NeedsErasePtr is a pointer to 1 if the image sets bits the
+*		flash has cleared, 0 if it can be programmed over the flash.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if a read failed.
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 QspiFlash_Compare(QspiFlash *FlashPtr, u32 Offset,
+			     const u8 *DataPtr, u32 NumBytes,
+			     u32 *ChangedPtr, u32 *NeedsErasePtr)
+{
+	const u8 *FlashDataPtr = QspiFlash_FrameData(FlashPtr);
+	u32 Done;
+	u32 Chunk;
+	u32 Index;
+	u8 Flash;
+	s32 Status;
+
+	*ChangedPtr = 0U;
+	*NeedsErasePtr = 0U;
+
+	for (Done = 0U; Done < NumBytes; Done += Chunk) {
+		Chunk = NumBytes - Done;
+		Status = QspiFlash_ReadFrame(FlashPtr, Offset + Done, &Chunk);
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+
+		for (Index = 0U; Index < Chunk; Index++) {
+			Flash = FlashDataPtr[Index];
+			if (Flash != DataPtr[Done + Index]) {
+				*ChangedPtr = 1U;
+				if ((DataPtr[Done + Index] & (u8)~Flash) != 0U) {
+					*NeedsErasePtr = 1U;
+					return XST_SUCCESS;
+				}
+			}
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+#endif /* XPAR_XQSPIPS_0_BASEADDR */
@@ -0,0 +1,167 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file qspi_flash.h
+*
+* Programming of the QSPI boot flash from the application, for field
+* updates of the boot image.
+*
+* QspiFlash_Update() writes an image to the flash in as little flash time
+* as the content allows. The erase and page program times of the NOR flash,
+* not the QSPI bus, set the update time, so the engine saves on those:
+*
+* - The flash is read before anything is written. An erase block whose
+*   content already is the image is left alone, one the image only clears
+*   bits of, erased or not, is programmed without an erase, and only the
+*   others are erased. Pages all of erased bytes are not programmed. An
+*   update with the image the flash holds costs the reads only.
+* - An erase covers 64 KB where the range holds the whole sector, 4 KB
+*   subsectors elsewhere, so that an image unaligned to a sector costs a
+*   few subsector erases at its ends instead of whole sectors.
+* - Page programs are pipelined: the frame of the next page is built,
+*   compared and skipped or not while the flash programs the current one,
+*   and the status is polled only then, so the CPU time of a page hides in
+*   its program time.
+* - With QSPI_FLASH_QUAD_PROGRAM, pages go out with the quad input page
+*   program (32h), four bits per clock, and reads with the quad output read
+*   (6Bh) with QSPI_FLASH_QUAD_READ. The quad enable bit of the flash must
+*   be set, as it is for the quad linear boot. Macronix parts, whose quad
+*   page program has another frame, keep the 1-bit page program.
+* - The image is read back and compared after it is written.
+*
+* The connection of the controller is that of the hardware design, as in
+* QspiAccess() of the FSBL: on a dual stacked connection the lower or upper
+* device is selected from the offset, on a dual parallel connection both
+* devices take each command, at half the offset, and each page and erase
+* block of the image is twice that of a device. Offsets past 16 MB of a
+* device select the bank of the device as SendBankSelect() of the FSBL does.
+*
+* The controller is used in I/O mode: the linear read window of the flash
+* is not usable while the engine is initialized, and the engine is not
+* available to an application that executes code in place from the window.
+* Long operations report their progress to the watchdog service of
+* wdt_service.h when the caller gives them a WdtService_Op with
+* QspiFlash_SetWdtOp().
+*
+* The QSPI controller and its qspips driver must be enabled in the hardware
+* design and the BSP. Without them the file compiles to nothing.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef QSPI_FLASH_H
+#define QSPI_FLASH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xiltimer.h"
+#include "xqspips.h"
+#include "wdt_service.h"
+
+/************************** Constant Definitions ****************************/
+
+#ifndef QSPI_FLASH_PRESCALER
+#define QSPI_FLASH_PRESCALER	XQSPIPS_CLK_PRESCALE_8	/**< QSPI clock */
+#endif
+
+#define QSPI_FLASH_PAGE_SIZE		256U	/**< Of a device */
+#define QSPI_FLASH_SUBSECTOR_SIZE	0x1000U	/**< 4 KB erase */
+#define QSPI_FLASH_SECTOR_SIZE		0x10000U /**< 64 KB erase */
+#define QSPI_FLASH_BANK_SIZE		0x1000000U /**< 3-byte addresses */
+#define QSPI_FLASH_READ_CHUNK		4096U	/**< Bytes per read command */
+
+/** @name Options of QspiFlash_Initialize()
+ * @{
+ */
+#define QSPI_FLASH_QUAD_READ		0x1U	/**< Reads with 6Bh */
+#define QSPI_FLASH_QUAD_PROGRAM		0x2U	/**< Programs with 32h */
+/** @} */
+
+/** @name Longest times of the flash operations, in milliseconds
+ * @{
+ */
+#define QSPI_FLASH_PAGE_TIMEOUT_MS	10U
+#define QSPI_FLASH_SUBSECTOR_TIMEOUT_MS	1000U
+#define QSPI_FLASH_SECTOR_TIMEOUT_MS	5000U
+/** @} */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Counts of the engine.
+ */
+typedef struct {
+	u32 SubsectorErases;	/**< 4 KB erases */
+	u32 SectorErases;	/**< 64 KB erases */
+	u32 BlocksKept;		/**< Erase blocks already the image */
+	u32 BlocksNoErase;	/**< Programmed without an erase */
+	u32 Pages;		/**< Page programs */
+	u32 PagesSkipped;	/**< Pages of erased bytes */
+	u32 BankSelects;
+	u32 VerifyErrors;	/**< Bytes that read back wrong */
+	XTime MaxPageCounts;	/**< Longest page program */
+	XTime MaxEraseCounts;	/**< Longest erase */
+} QspiFlash_Stats;
+
+/**
+ * The flash engine.
+ */
+typedef struct {
+	XQspiPs Qspi;
+	u32 Connection;		/**< XQSPIPS_CONNECTION_MODE_* */
+	u32 Options;		/**< QSPI_FLASH_QUAD_* */
+	u8 Make;		/**< Manufacturer ID */
+	u8 ProgramCmd;		/**< 02h or 32h */
+	u8 ReadCmd;		/**< 0Bh or 6Bh */
+	u8 SmallEraseCmd;	/**< 20h, or D8h without subsectors */
+	u32 DeviceSize;		/**< Bytes of one device */
+	u32 Size;		/**< Bytes of the flash as the image sees it */
+	u32 PageSize;		/**< Of the image, both devices in parallel */
+	u32 SmallErase;		/**< Bytes of the image of a small erase */
+	u32 LargeErase;		/**< Bytes of the image of a sector erase */
+	u32 Bank;		/**< Bank selected in the device */
+	u32 Upper;		/**< Upper device selected, stacked */
+	WdtService_Op *WdtOpPtr;
+	u32 Ready;
+	QspiFlash_Stats Stats;
+	/* Page frames, one sent while the next is built, and a read frame */
+	u8 PageFrame[2][4U + (2U * QSPI_FLASH_PAGE_SIZE)];
+	u8 ReadFrame[5U + QSPI_FLASH_READ_CHUNK];
+} QspiFlash;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+s32 QspiFlash_Initialize(QspiFlash *FlashPtr, u32 Options);
+void QspiFlash_SetWdtOp(QspiFlash *FlashPtr, WdtService_Op *OpPtr);
+s32 QspiFlash_Read(QspiFlash *FlashPtr, u32 Offset, u8 *BufferPtr,
+		   u32 NumBytes);
+s32 QspiFlash_Erase(QspiFlash *FlashPtr, u32 Offset, u32 NumBytes);
+s32 QspiFlash_Program(QspiFlash *FlashPtr, u32 Offset, const u8 *DataPtr,
+		      u32 NumBytes);
+s32 QspiFlash_Update(QspiFlash *FlashPtr, u32 Offset, const u8 *DataPtr,
+		     u32 NumBytes);
+void QspiFlash_GetStats(const QspiFlash *FlashPtr, QspiFlash_Stats *StatsPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* QSPI_FLASH_H */
@@ -0,0 +1,469 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file region_bench.c
+*
+* Memory bandwidth and latency benchmark. Refer to region_bench.h for what
+* is measured.
+*
+* The runs are timed with the PMU cycle counter of XTimestamp_Cycles(). The
+* chase is a single random cycle through the cache lines of the buffer,
+* built with Sattolo's shuffle of the line indexes, so that each step loads
+* a line the previous step could not predict.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xstatus.h"
+#include "xil_mem.h"
+#include "xil_mmu.h"
+#include "xil_printf.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xtimestamp.h"
+#include "region_bench.h"
+
+/************************** Constant Definitions ****************************/
+
+#define REGION_BENCH_SECTION	0x100000U	/* Bytes of an MMU section */
+#define REGION_BENCH_LINE	32U		/* Bytes of a cache line */
+#define REGION_BENCH_MIN_BYTES	1024U
+
+/* Runs of RegionBench_Best() */
+#define REGION_BENCH_OP_READ	0U
+#define REGION_BENCH_OP_WRITE	1U
+#define REGION_BENCH_OP_ZERO	2U
+#define REGION_BENCH_OP_COPY	3U
+#define REGION_BENCH_OP_CHASE	4U
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define REGION_BENCH_LOOP	__attribute__((noinline, \
+				optimize("no-tree-loop-distribute-patterns")))
+
+/************************** Function Prototypes *****************************/
+
+static void RegionBench_Measure(u32 *BufPtr, u32 Bytes,
+				RegionBench_Result *ResultPtr);
+static u32 RegionBench_Best(u32 Op, u32 *BufPtr, u32 Bytes);
+static u32 RegionBench_MBps(u32 Bytes, u32 Cycles);
+static u32 RegionBench_Read(const u32 *SrcPtr, u32 Words);
+static void RegionBench_Write(u32 *DstPtr, u32 Words);
+static void RegionBench_BuildChase(u32 *BufPtr, u32 Lines);
+static u32 RegionBench_Chase(const u32 *BufPtr, u32 Steps);
+
+/************************** Variable Definitions ****************************/
+
+/* Translation table of the BSP, one word per section */
+extern u32 MMUTable[];
+
+static const u32 RegionBench_Attr[REGION_BENCH_NUM_ATTRS] = {
+	NORM_WB_CACHE, NORM_WT_CACHE, NORM_NONCACHE, DEVICE_MEMORY,
+	STRONG_ORDERED
+};
+
+static const char *const RegionBench_AttrNames[REGION_BENCH_NUM_ATTRS] = {
+	"wb", "wt", "nc", "dev", "so"
+};
+
+/* Sink of the read and chase results */
+static volatile u32 RegionBench_Sink;
+
+/****************************************************************************/
+/**
+*
+* Starts the cycle counter and keeps the L2 settings.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return	XST_SUCCESS.
+*
+*****************************************************************************/
+s32 RegionBench_Initialize(RegionBench *BenchPtr)
+{
+	XTimestamp_EnableCycles();
+	Xil_L2ProfileRead(&BenchPtr->Saved);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Runs the benchmark over every memory, mapping and L2 profile.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	ResultsPtr is the array the results are written to.
+* @param	MaxResults is the size of the array, REGION_BENCH_MAX_RESULTS
+*		for all of them.
+*
+* @return	The number of results written.
+*
+* @note		A memory whose arena has no room for a buffer is skipped.
+*
+*****************************************************************************/
+u32 RegionBench_RunAll(RegionBench *BenchPtr, RegionBench_Result *ResultsPtr,
+		       u32 MaxResults)
+{
+	MemRegion_Scope Scope;
+	RegionBench_Result *ResultPtr;
+	UINTPTR Section;
+	u32 *BufPtr;
+	u32 NumResults = 0U;
+	u32 Region;
+	u32 Bytes;
+	u32 Sweep;
+	u32 Mapping;
+	u32 Attr;
+	u32 Profile;
+
+	for (Region = 0U; Region < (u32)MEM_REGION_NUM; Region++) {
+		Scope = MemRegion_BeginScope((MemRegion_Id)Region);
+
+		if (Region == (u32)MEM_REGION_DDR) {
+			Bytes = REGION_BENCH_DDR_BYTES;
+			BufPtr = MemRegion_Alloc(MEM_REGION_DDR, Bytes,
+						 REGION_BENCH_SECTION);
+		} else {
+			Bytes = MemRegion_Remaining((MemRegion_Id)Region);
+			Bytes = (Bytes > (REGION_BENCH_MAX_BYTES +
+					  REGION_BENCH_LINE)) ?
+				REGION_BENCH_MAX_BYTES :
+				((Bytes - REGION_BENCH_LINE) &
+				 ~((2U * REGION_BENCH_LINE) - 1U));
+			BufPtr = (Bytes < REGION_BENCH_MIN_BYTES) ? NULL :
+				 MemRegion_Alloc((MemRegion_Id)Region, Bytes,
+						 REGION_BENCH_LINE);
+		}
+		if (BufPtr == NULL) {
+			MemRegion_EndScope(&Scope);
+			continue;
+		}
+
+		/* Only a section of the buffer alone may be remapped */
+		Section = (UINTPTR)BufPtr & ~(UINTPTR)(REGION_BENCH_SECTION - 1U);
+		Sweep = ((Region != (u32)MEM_REGION_OCM) &&
+			 ((((UINTPTR)BufPtr + Bytes - 1U) &
+			   ~(UINTPTR)(REGION_BENCH_SECTION - 1U)) == Section)) ?
+			1U : 0U;
+		Mapping = MMUTable[Section / REGION_BENCH_SECTION] &
+			  (REGION_BENCH_SECTION - 1U);
+
+		for (Attr = 0U; Attr < ((Sweep != 0U) ?
+					REGION_BENCH_NUM_ATTRS : 1U); Attr++) {
+			if (Sweep != 0U) {
+				Xil_SetTlbAttributes((INTPTR)Section,
+						     RegionBench_Attr[Attr]);
+			}
+			for (Profile = 0U; Profile < XIL_L2_NUM_PROFILES;
+			     Profile++) {
+				if (NumResults == MaxResults) {
+					break;
+				}
+				(void)Xil_L2ProfileApply(
+					Xil_L2ProfileGet(Profile));
+				ResultPtr = &ResultsPtr[NumResults];
+				ResultPtr->Region = Region;
+				ResultPtr->Attr = (Sweep != 0U) ? Attr :
+						  REGION_BENCH_ATTR_AS_MAPPED;
+				ResultPtr->Profile = Profile;
+				RegionBench_Measure(BufPtr, Bytes, ResultPtr);
+				NumResults++;
+			}
+		}
+
+		if (Sweep != 0U) {
+			Xil_SetTlbAttributes((INTPTR)Section, Mapping);
+		}
+		MemRegion_EndScope(&Scope);
+	}
+
+	(void)Xil_L2ProfileApply(&BenchPtr->Saved);
+
+	return NumResults;
+}
+
+/****************************************************************************/
+/**
+*
+* Prints the results, one line each.
+*
+* @param	ResultsPtr is the array of results.
+* @param	NumResults is the number of results in it.
+*
+* @return	None.
+*
+*****************************************************************************/
+void RegionBench_Report(const RegionBench_Result *ResultsPtr, u32 NumResults)
+{
+	const RegionBench_Result *ResultPtr;
+	MemRegion_Stats Stats;
+	u32 Index;
+
+	xil_printf("memory\tmap\tprofile\tbytes\tread\twrite\tzero"
+		   "\tcopy MB/s\tlatency ns\r\n");
+
+	for (Index = 0U; Index < NumResults; Index++) {
+		ResultPtr = &ResultsPtr[Index];
+		if (MemRegion_GetStats((MemRegion_Id)ResultPtr->Region,
+				       &Stats) != XST_SUCCESS) {
+			continue;
+		}
+		xil_printf("%s\t%s\t%s\t%u\t%u\t%u\t%u\t%u\t%u.%03u\r\n",
+			   Stats.Name,
+			   (ResultPtr->Attr < REGION_BENCH_NUM_ATTRS) ?
+			   RegionBench_AttrNames[ResultPtr->Attr] : "as is",
+			   Xil_L2ProfileGet(ResultPtr->Profile)->Name,
+			   ResultPtr->Bytes, ResultPtr->ReadMBps,
+			   ResultPtr->WriteMBps, ResultPtr->ZeroMBps,
+			   ResultPtr->CopyMBps,
+			   ResultPtr->LatencyPs / 1000U,
+			   ResultPtr->LatencyPs % 1000U);
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Measures a buffer with the current mapping and L2 profile.
+*
+* @param	BufPtr is the buffer, cache line aligned.
+* @param	Bytes is its size, a multiple of two cache lines.
+* @param	ResultPtr is where the measurements are written.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void RegionBench_Measure(u32 *BufPtr, u32 Bytes,
+				RegionBench_Result *ResultPtr)
+{
+	u32 Cycles;
+
+	ResultPtr->Bytes = Bytes;
+	ResultPtr->ReadMBps = RegionBench_MBps(Bytes,
+		RegionBench_Best(REGION_BENCH_OP_READ, BufPtr, Bytes));
+	ResultPtr->WriteMBps = RegionBench_MBps(Bytes,
+		RegionBench_Best(REGION_BENCH_OP_WRITE, BufPtr, Bytes));
+	ResultPtr->ZeroMBps = RegionBench_MBps(Bytes,
+		RegionBench_Best(REGION_BENCH_OP_ZERO, BufPtr, Bytes));
+	ResultPtr->CopyMBps = RegionBench_MBps(Bytes / 2U,
+		RegionBench_Best(REGION_BENCH_OP_COPY, BufPtr, Bytes));
+
+	RegionBench_BuildChase(BufPtr, Bytes / REGION_BENCH_LINE);
+	Cycles = RegionBench_Best(REGION_BENCH_OP_CHASE, BufPtr, Bytes);
+	ResultPtr->LatencyPs = (u32)((XTimestamp_CyclesToNs(Cycles) * 1000U) /
+				     REGION_BENCH_CHASE_STEPS);
+}
+
+/****************************************************************************/
+/**
+*
+* Times one operation over a buffer, the best of REGION_BENCH_REPEAT runs.
+*
+* @param	Op is one of the REGION_BENCH_OP_* values.
+* @param	BufPtr is the buffer.
+* @param	Bytes is its size.
+*
+* @return	The cycles of the fastest run.
+*
+*****************************************************************************/
+static u32 RegionBench_Best(u32 Op, u32 *BufPtr, u32 Bytes)
+{
+	u32 Best = 0xFFFFFFFFU;
+	u32 Cpsr;
+	u32 Start;
+	u32 Cycles;
+	u32 Run;
+
+	/* A first pass brings the cacheable lines in */
+	if (Op == REGION_BENCH_OP_CHASE) {
+		RegionBench_Sink = RegionBench_Chase(BufPtr,
+						    Bytes / REGION_BENCH_LINE);
+	}
+
+	for (Run = 0U; Run < REGION_BENCH_REPEAT; Run++) {
+		Cpsr = mfcpsr();
+		mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+		Start = XTimestamp_Cycles();
+
+		switch (Op) {
+		case REGION_BENCH_OP_READ:
+			RegionBench_Sink = RegionBench_Read(BufPtr,
+							    Bytes / 4U);
+			break;
+		case REGION_BENCH_OP_WRITE:
+			RegionBench_Write(BufPtr, Bytes / 4U);
+			break;
+		case REGION_BENCH_OP_ZERO:
+			Xil_MemSet(BufPtr, 0U, Bytes);
+			break;
+		case REGION_BENCH_OP_COPY:
+			Xil_MemCpy((u8 *)BufPtr + (Bytes / 2U), BufPtr,
+				   Bytes / 2U);
+			break;
+		default:
+			RegionBench_Sink = RegionBench_Chase(BufPtr,
+						REGION_BENCH_CHASE_STEPS);
+			break;
+		}
+
+		Cycles = XTimestamp_Cycles() - Start;
+		mtcpsr(Cpsr);
+		if (Cycles < Best) {
+			Best = Cycles;
+		}
+	}
+
+	return Best;
+}
+
+/****************************************************************************/
+/**
+*
+* Converts a run to a bandwidth.
+*
+* @param	Bytes is the number of bytes moved.
+* @param	Cycles is the duration of the run.
+*
+* @return	The bandwidth in MB/s, bytes per microsecond.
+*
+*****************************************************************************/
+static u32 RegionBench_MBps(u32 Bytes, u32 Cycles)
+{
+	u64 Ns = XTimestamp_CyclesToNs(Cycles);
+
+	return (Ns == 0U) ? 0U : (u32)(((u64)Bytes * 1000U) / Ns);
+}
+
+/****************************************************************************/
+/**
+*
+* Reads a buffer a word at a time.
+*
+* @param	SrcPtr is the buffer.
+* @param	Words is its number of words, a multiple of 8.
+*
+* @return	The sum of the words.
+*
+*****************************************************************************/
+REGION_BENCH_LOOP
+static u32 RegionBench_Read(const u32 *SrcPtr, u32 Words)
+{
+	u32 Sum = 0U;
+	u32 Index;
+
+	for (Index = 0U; Index < Words; Index += 8U) {
+		Sum += SrcPtr[Index] + SrcPtr[Index + 1U] +
+		       SrcPtr[Index + 2U] + SrcPtr[Index + 3U] +
+		       SrcPtr[Index + 4U] + SrcPtr[Index + 5U] +
+		       SrcPtr[Index + 6U] + SrcPtr[Index + 7U];
+	}
+
+	return Sum;
+}
+
+/****************************************************************************/
+/**
+*
+* Writes a buffer a word at a time.
+*
+* @param	DstPtr is the buffer.
+* @param	Words is its number of words, a multiple of 8.
+*
+* @return	None.
+*
+*****************************************************************************/
+REGION_BENCH_LOOP
+static void RegionBench_Write(u32 *DstPtr, u32 Words)
+{
+	u32 Index;
+
+	for (Index = 0U; Index < Words; Index += 8U) {
+		DstPtr[Index] = Index;
+		DstPtr[Index + 1U] = Index;
+		DstPtr[Index + 2U] = Index;
+		DstPtr[Index + 3U] = Index;
+		DstPtr[Index + 4U] = Index;
+		DstPtr[Index + 5U] = Index;
+		DstPtr[Index + 6U] = Index;
+		DstPtr[Index + 7U] = Index;
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Links the cache lines of a buffer into a single random cycle, the first
+* word of each line holding the address of the next line.
+*
+* @param	BufPtr is the buffer.
+* @param	Lines is its number of cache lines.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void RegionBench_BuildChase(u32 *BufPtr, u32 Lines)
+{
+	const u32 Stride = REGION_BENCH_LINE / 4U;
+	u32 Seed = 0x12345678U;
+	u32 Index;
+	u32 Other;
+	u32 Next;
+
+	for (Index = 0U; Index < Lines; Index++) {
+		BufPtr[Index * Stride] = Index;
+	}
+
+	/* Sattolo: swap with an earlier line only, one cycle results */
+	for (Index = Lines - 1U; Index > 0U; Index--) {
+		Seed = (Seed * 1664525U) + 1013904223U;
+		Other = (Seed >> 8U) % Index;
+		Next = BufPtr[Index * Stride];
+		BufPtr[Index * Stride] = BufPtr[Other * Stride];
+		BufPtr[Other * Stride] = Next;
+	}
+
+	for (Index = 0U; Index < Lines; Index++) {
+		BufPtr[Index * Stride] =
+			(u32)(UINTPTR)&BufPtr[BufPtr[Index * Stride] * Stride];
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Follows the chase of RegionBench_BuildChase().
+*
+* @param	BufPtr is the buffer.
+* @param	Steps is the number of loads.
+*
+* @return	The last address reached.
+*
+*****************************************************************************/
+REGION_BENCH_LOOP
+static u32 RegionBench_Chase(const u32 *BufPtr, u32 Steps)
+{
+	const u32 *LinePtr = BufPtr;
+	u32 Step;
+
+	for (Step = 0U; Step < Steps; Step++) {
+		LinePtr = (const u32 *)(UINTPTR)*LinePtr;
+	}
+
+	return (u32)(UINTPTR)LinePtr;
+}
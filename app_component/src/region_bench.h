@@ -0,0 +1,120 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file region_bench.h
+*
+* Bandwidth and load-to-use latency of the memories of mem_region.h, for
+* deciding where buffers go.
+*
+* Each memory is measured with a buffer of its arena: REGION_BENCH_DDR_BYTES
+* of DDR, larger than the L2, and all or part of each OCM range and BRAM.
+* The read and write bandwidths are those of word loops over the buffer,
+* the zero bandwidth that of Xil_MemSet() of the buffer to 0, the copy
+* bandwidth that of Xil_MemCpy() from its first half to its second half, and the latency that of a pointer chase through its cache
+* lines in random order, after a first pass over them. A result keeps the
+* best of REGION_BENCH_REPEAT runs, each with the IRQ masked.
+*
+* The memories in 1 MB sections of their own, the DDR buffer, the low OCM
+* and the BRAMs, are swept over the mappings of REGION_BENCH_NUM_ATTRS:
+* normal write-back and write-through cacheable, normal non-cacheable,
+* device and strongly ordered, the cached against uncached comparison
+* included. Their section is given back its mapping afterwards. The high
+* OCM shares its section with the hot path of xil_hotpath.h and is only
+* measured as mapped. Each mapping runs with each L2 profile of
+* xil_l2profile.h, the profile set before the benchmark being applied
+* again at the end. The results are those the profiles are chosen on:
+* "stream" against "off" on the DDR read and copy bandwidth for the
+* prefetch and double linefills, "random" against "stream" on the DDR
+* latency for the data prefetch, and the zero bandwidth of a profile with
+* full line of zero against one without.
+*
+* The BRAMs are only measured with the bitstream loaded, and the users of
+* the arenas must not be running. The benchmark is built into the
+* application when REGION_BENCH is defined.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef REGION_BENCH_H
+#define REGION_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xil_l2profile.h"
+#include "mem_region.h"
+
+/************************** Constant Definitions ****************************/
+
+/** @name Mappings
+ * @{
+ */
+#define REGION_BENCH_ATTR_WB	0U	/**< Normal, write-back */
+#define REGION_BENCH_ATTR_WT	1U	/**< Normal, write-through */
+#define REGION_BENCH_ATTR_NC	2U	/**< Normal, non-cacheable */
+#define REGION_BENCH_ATTR_DEV	3U	/**< Device */
+#define REGION_BENCH_ATTR_SO	4U	/**< Strongly ordered */
+#define REGION_BENCH_NUM_ATTRS	5U
+#define REGION_BENCH_ATTR_AS_MAPPED 0xFFU /**< Mapping left as it is */
+/* @} */
+
+#define REGION_BENCH_DDR_BYTES	0x100000U /**< DDR buffer, one section */
+#define REGION_BENCH_MAX_BYTES	0x20000U /**< Buffer of the other memories */
+#define REGION_BENCH_REPEAT	3U	/**< Runs per result */
+#define REGION_BENCH_CHASE_STEPS 16384U	/**< Loads of a latency run */
+
+/** Results of a full suite */
+#define REGION_BENCH_MAX_RESULTS \
+	(MEM_REGION_NUM * REGION_BENCH_NUM_ATTRS * XIL_L2_NUM_PROFILES)
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Result of one memory with one mapping and L2 profile.
+ */
+typedef struct {
+	u32 Region;		/**< MemRegion_Id */
+	u32 Attr;		/**< REGION_BENCH_ATTR_* */
+	u32 Profile;		/**< XIL_L2_PROFILE_* */
+	u32 Bytes;		/**< Buffer size */
+	u32 ReadMBps;		/**< Read bandwidth, MB/s */
+	u32 WriteMBps;		/**< Write bandwidth, MB/s */
+	u32 ZeroMBps;		/**< Zero fill bandwidth, MB/s */
+	u32 CopyMBps;		/**< Copy bandwidth, MB/s of bytes copied */
+	u32 LatencyPs;		/**< Load-to-use latency, ps */
+} RegionBench_Result;
+
+/**
+ * State of the benchmark.
+ */
+typedef struct {
+	Xil_L2Profile Saved;	/**< L2 settings to restore */
+} RegionBench;
+
+/************************** Function Prototypes *****************************/
+
+s32 RegionBench_Initialize(RegionBench *BenchPtr);
+u32 RegionBench_RunAll(RegionBench *BenchPtr, RegionBench_Result *ResultsPtr,
+		       u32 MaxResults);
+void RegionBench_Report(const RegionBench_Result *ResultsPtr, u32 NumResults);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* REGION_BENCH_H */
@@ -0,0 +1,267 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file ring_bench.c
+*
+* Benchmark of the xil_ring.h rings. Refer to ring_bench.h for what is
+* measured.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xstatus.h"
+#include "xil_printf.h"
+#include "xil_ring.h"
+#include "xtimestamp.h"
+#include "ring_bench.h"
+
+/************************** Constant Definitions ****************************/
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static u32 RingBench_Time(u32 Flags, u32 Op, u32 Batch);
+static u32 RingBench_Move(u32 Op, u32 Batch);
+
+/************************** Variable Definitions ****************************/
+
+static const u32 RingBench_Flags[RING_BENCH_NUM_KINDS] = {
+	XIL_RING_SMP,
+	XIL_RING_LOCAL,
+	XIL_RING_SMP | XIL_RING_MP,
+	XIL_RING_LOCAL | XIL_RING_MP
+};
+
+static const u32 RingBench_Batches[RING_BENCH_NUM_BATCHES] = {
+	1U, 8U, 32U
+};
+
+static const char *const RingBench_OpNames[RING_BENCH_NUM_OPS] = {
+	"copy", "span"
+};
+
+static Xil_Ring RingBench_Ring;
+static u32 RingBench_Store[RING_BENCH_RING_ELEMS]
+	__attribute__((aligned(32)));
+static u32 RingBench_Src[32] __attribute__((aligned(32)));
+static u32 RingBench_Dst[32] __attribute__((aligned(32)));
+
+/* Sink of the elements read in place */
+static volatile u32 RingBench_Sink;
+
+/****************************************************************************/
+/**
+*
+* Starts the cycle counter of the calling CPU.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return	XST_SUCCESS.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 RingBench_Initialize(RingBench *BenchPtr)
+{
+	u32 Index;
+
+	XTimestamp_EnableCycles();
+
+	for (Index = 0U; Index < 32U; Index++) {
+		RingBench_Src[Index] = Index * 0x9E3779B9U;
+	}
+	BenchPtr->Ready = 1U;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Times every kind of ring, way and batch.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	ResultsPtr is where the results are stored.
+* @param	MaxResults is the capacity of ResultsPtr.
+*
+* @return	The number of results stored.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 RingBench_RunAll(RingBench *BenchPtr, RingBench_Result *ResultsPtr,
+		     u32 MaxResults)
+{
+	RingBench_Result *ResultPtr;
+	u32 NumResults = 0U;
+	u32 Kind;
+	u32 Op;
+	u32 Batch;
+	u64 Ns;
+
+	if (BenchPtr->Ready == 0U) {
+		return 0U;
+	}
+
+	for (Kind = 0U; Kind < RING_BENCH_NUM_KINDS; Kind++) {
+		for (Op = 0U; Op < RING_BENCH_NUM_OPS; Op++) {
+			for (Batch = 0U; Batch < RING_BENCH_NUM_BATCHES;
+			     Batch++) {
+				if (NumResults == MaxResults) {
+					return NumResults;
+				}
+				ResultPtr = &ResultsPtr[NumResults];
+				ResultPtr->Flags = RingBench_Flags[Kind];
+				ResultPtr->Op = Op;
+				ResultPtr->Batch = RingBench_Batches[Batch];
+				ResultPtr->Cycles =
+					RingBench_Time(ResultPtr->Flags, Op,
+						       ResultPtr->Batch);
+				Ns = XTimestamp_CyclesToNs(ResultPtr->Cycles);
+				ResultPtr->OpsPerSec = (Ns == 0U) ? 0U :
+					(u32)(((u64)RING_BENCH_ELEMS *
+					       1000000000U) / Ns);
+				NumResults++;
+			}
+		}
+	}
+
+	return NumResults;
+}
+
+/****************************************************************************/
+/**
+*
+* Prints the results, one line per kind of ring, way and batch.
+*
+* @param	ResultsPtr is the results of RingBench_RunAll().
+* @param	NumResults is their number.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void RingBench_Report(const RingBench_Result *ResultsPtr, u32 NumResults)
+{
+	const RingBench_Result *ResultPtr;
+	u32 Index;
+
+	xil_printf("ring\tbarrier\top\tbatch\tcycles\telem/s\r\n");
+
+	for (Index = 0U; Index < NumResults; Index++) {
+		ResultPtr = &ResultsPtr[Index];
+		xil_printf("%s\t%s\t%s\t%u\t%u\t%u\r\n",
+			   ((ResultPtr->Flags & XIL_RING_MP) != 0U) ?
+			   "mpsc" : "spsc",
+			   ((ResultPtr->Flags & XIL_RING_LOCAL) != 0U) ?
+			   "local" : "dmb",
+			   RingBench_OpNames[ResultPtr->Op], ResultPtr->Batch,
+			   ResultPtr->Cycles, ResultPtr->OpsPerSec);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Times one kind of ring, way and batch.
+*
+* @param	Flags is the XIL_RING_* of the ring.
+* @param	Op is the way of moving the elements.
+* @param	Batch is the elements per operation.
+*
+* @return	The fewest cycles of RING_BENCH_REPEAT runs.
+*
+*****************************************************************************/
+static u32 RingBench_Time(u32 Flags, u32 Op, u32 Batch)
+{
+	u32 Best = 0xFFFFFFFFU;
+	u32 Start;
+	u32 Cycles;
+	u32 Run;
+
+	for (Run = 0U; Run < RING_BENCH_REPEAT; Run++) {
+		if (Xil_RingInitialize(&RingBench_Ring, RingBench_Store,
+				       RING_BENCH_RING_ELEMS, sizeof(u32),
+				       Flags) != (s32)XST_SUCCESS) {
+			return 0xFFFFFFFFU;
+		}
+		Start = XTimestamp_Cycles();
+		if (RingBench_Move(Op, Batch) != RING_BENCH_ELEMS) {
+			return 0xFFFFFFFFU;
+		}
+		Cycles = XTimestamp_Cycles() - Start;
+		if (Cycles < Best) {
+			Best = Cycles;
+		}
+	}
+
+	return Best;
+}
+
+/****************************************************************************/
+/*
+*
+* Moves RING_BENCH_ELEMS elements through the ring, a batch written then
+* read at a time. The batches divide the ring, so that a span is never cut
+* at its end.
+*
+* @param	Op is the way of moving the elements.
+* @param	Batch is the elements per operation, up to 32.
+*
+* @return	The number of elements read.
+*
+*****************************************************************************/
+static u32 RingBench_Move(u32 Op, u32 Batch)
+{
+	Xil_Ring *RingPtr = &RingBench_Ring;
+	Xil_RingSpan Span;
+	u32 *ElemPtr;
+	u32 Moved = 0U;
+	u32 Count;
+	u32 Sum = 0U;
+	u32 Index;
+
+	while (Moved < RING_BENCH_ELEMS) {
+		if (Op == RING_BENCH_OP_COPY) {
+			Count = Xil_RingWrite(RingPtr, RingBench_Src, Batch);
+			Count = Xil_RingRead(RingPtr, RingBench_Dst, Count);
+		} else {
+			Count = Xil_RingReserve(RingPtr, Batch, &Span);
+			ElemPtr = (u32 *)Span.Ptr;
+			for (Index = 0U; Index < Count; Index++) {
+				ElemPtr[Index] = RingBench_Src[Index];
+			}
+			Xil_RingCommit(RingPtr, &Span, Count);
+			Count = Xil_RingPeek(RingPtr, Count, &Span);
+			ElemPtr = (u32 *)Span.Ptr;
+			for (Index = 0U; Index < Count; Index++) {
+				Sum += ElemPtr[Index];
+			}
+			Xil_RingConsume(RingPtr, Count);
+		}
+		if (Count == 0U) {
+			break;
+		}
+		Moved += Count;
+	}
+	RingBench_Sink = Sum;
+
+	return Moved;
+}
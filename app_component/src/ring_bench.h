@@ -0,0 +1,97 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file ring_bench.h
+*
+* Operations per second of the lock-free rings of xil_ring.h.
+*
+* Each kind of ring, single or multiple producer with the dmb or the
+* compiler barriers, moves RING_BENCH_ELEMS word elements through a ring of
+* RING_BENCH_RING_ELEMS, one batch written then read at a time, either
+* copied with Xil_RingWrite() and Xil_RingRead() or in place with
+* Xil_RingReserve(), Xil_RingCommit(), Xil_RingPeek() and
+* Xil_RingConsume(). The producer and the consumer are the same CPU, so
+* that what is timed is the cost of the operations, the indices staying in
+* its cache; between the CPUs the lines of the indices move through the
+* SCU on top of it. A result keeps the fastest of RING_BENCH_REPEAT runs,
+* timed with the cycle counter, and gives the elements per second.
+*
+* The benchmark is built into the application when RING_BENCH is defined.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef RING_BENCH_H
+#define RING_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions ****************************/
+
+/** @name Ways of moving the elements
+ * @{
+ */
+#define RING_BENCH_OP_COPY	0U	/**< Xil_RingWrite() and Read() */
+#define RING_BENCH_OP_SPAN	1U	/**< Reserve, Commit, Peek, Consume */
+#define RING_BENCH_NUM_OPS	2U
+/* @} */
+
+#define RING_BENCH_NUM_KINDS	4U	/**< SP and MP, SMP and LOCAL */
+#define RING_BENCH_NUM_BATCHES	3U	/**< 1, 8 and 32 elements */
+#define RING_BENCH_RING_ELEMS	256U	/**< Elements of the ring */
+#define RING_BENCH_ELEMS	4096U	/**< Elements moved per run */
+#define RING_BENCH_REPEAT	8U	/**< Runs per result */
+
+/** Results of a full suite */
+#define RING_BENCH_MAX_RESULTS	(RING_BENCH_NUM_KINDS * \
+				 RING_BENCH_NUM_OPS * RING_BENCH_NUM_BATCHES)
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Result of one kind of ring, way and batch.
+ */
+typedef struct {
+	u32 Flags;		/**< XIL_RING_* of the ring */
+	u32 Op;			/**< One of the RING_BENCH_OP_* values */
+	u32 Batch;		/**< Elements per operation */
+	u32 Cycles;		/**< Of RING_BENCH_ELEMS elements */
+	u32 OpsPerSec;		/**< Elements written and read per second */
+} RingBench_Result;
+
+/**
+ * State of the benchmark.
+ */
+typedef struct {
+	u32 Ready;
+} RingBench;
+
+/************************** Function Prototypes *****************************/
+
+s32 RingBench_Initialize(RingBench *BenchPtr);
+u32 RingBench_RunAll(RingBench *BenchPtr, RingBench_Result *ResultsPtr,
+		     u32 MaxResults);
+void RingBench_Report(const RingBench_Result *ResultsPtr, u32 NumResults);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RING_BENCH_H */
@@ -0,0 +1,829 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file sched_bench.c
+*
+* Scheduler and queue microbenchmark. Refer to sched_bench.h for the tests.
+*
+* CPU1 runs a command loop for the whole suite: it echoes the messages of
+* one of the queue pairs back to CPU0, or takes the lock in a loop, as
+* SchedBench_Cpu1Do() tells it, and acknowledges each command once it has
+* switched to it. A sample brackets a single operation, or round trip, with
+* two reads of the cycle counter, their own cost included.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Set up the AMP runtime with Amp_InitFromWrapper().
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xil_printf.h"
+#include "xil_exception.h"
+#include "xpseudo_asm.h"
+#include "xinterrupt_wrap.h"
+#include "xtimestamp.h"
+#include "amp.h"
+#include "amp_queue.h"
+#include "amp_mpsc.h"
+#include "coro.h"
+#include "sched_bench.h"
+
+/************************** Constant Definitions ****************************/
+
+/* Commands of CPU1 */
+#define SCHED_BENCH_CMD_IDLE	0U
+#define SCHED_BENCH_CMD_SPSC	1U	/* Echo the AmpQueue pair */
+#define SCHED_BENCH_CMD_MPSC	2U	/* Echo the AmpMpsc pair */
+#define SCHED_BENCH_CMD_LOCK	3U	/* Take the lock in a loop */
+#define SCHED_BENCH_CMD_QUIT	4U
+
+#define SCHED_BENCH_WAKE_EVENT	0U	/* Event of the wake test */
+#define SCHED_BENCH_GUARD	4U	/* Periods of the wake guard */
+#define SCHED_BENCH_NEAR_US	10U	/* First start deadline */
+#define SCHED_BENCH_EXPIRE_US	1000U	/* Expire test deadline */
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static void SchedBench_Cpu1Main(void *Arg);
+static s32 SchedBench_Cpu1Do(SchedBench *BenchPtr, u32 Cmd);
+static void SchedBench_Reset(SchedBench *BenchPtr);
+static void SchedBench_Add(SchedBench *BenchPtr, u32 Cycles);
+static void SchedBench_Store(SchedBench *BenchPtr, u32 Test, s32 Status,
+			     SchedBench_Result *ResultPtr);
+static void SchedBench_CoroTask(void *Arg);
+static s32 SchedBench_Coro(SchedBench *BenchPtr);
+static void SchedBench_WakeIsr(void *CallBackRef);
+static void SchedBench_GuardIsr(void *CallBackRef);
+static void SchedBench_WakeHandler(void *CallBackRef);
+static s32 SchedBench_Wake(SchedBench *BenchPtr);
+static s32 SchedBench_PingPong(SchedBench *BenchPtr, u32 Cmd);
+static s32 SchedBench_Lock(SchedBench *BenchPtr, u32 Cmd);
+static void SchedBench_ExpireIsr(void *CallBackRef);
+static s32 SchedBench_Wheel(SchedBench *BenchPtr, u32 Test);
+
+/************************** Variable Definitions ****************************/
+
+static const char *SchedBench_TestNames[SCHED_BENCH_NUM_TESTS] = {
+	"coro", "wake", "spsc", "mpsc", "lock", "lock2", "start", "cancel",
+	"expire"
+};
+
+/* The queue pairs, to CPU1 and back to CPU0 */
+static AmpQueue SchedBench_SpscPing AMP_SHARED;
+static AmpQueue SchedBench_SpscPong AMP_SHARED;
+static AmpMpsc SchedBench_MpscPing AMP_SHARED;
+static AmpMpsc SchedBench_MpscPong AMP_SHARED;
+static u32 SchedBench_PingSlots[SCHED_BENCH_SLOTS * SCHED_BENCH_SLOT_SIZE /
+	sizeof(u32)] AMP_SHARED __attribute__((aligned(32)));
+static u32 SchedBench_PongSlots[SCHED_BENCH_SLOTS * SCHED_BENCH_SLOT_SIZE /
+	sizeof(u32)] AMP_SHARED __attribute__((aligned(32)));
+static u32 SchedBench_MpscPingSlots[SCHED_BENCH_SLOTS *
+	SCHED_BENCH_SLOT_SIZE / sizeof(u32)] AMP_SHARED
+	__attribute__((aligned(32)));
+static u32 SchedBench_MpscPongSlots[SCHED_BENCH_SLOTS *
+	SCHED_BENCH_SLOT_SIZE / sizeof(u32)] AMP_SHARED
+	__attribute__((aligned(32)));
+
+/* Stacks of the two tasks of the switch test */
+static u64 SchedBench_Stack[2U][SCHED_BENCH_STACK / sizeof(u64)];
+
+/****************************************************************************/
+/**
+*
+* Initializes the benchmark: the AMP runtime if it is not yet, the queue
+* pairs, the timer wheel on the private timer, the event loop of the wake
+* test, and CPU1 for the tests between the cores.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return
+*		- XST_SUCCESS if the benchmark is ready, CPU1 started or not
+*		  and the wheel set up or not.
+*		- The error of the failing call otherwise.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 SchedBench_Initialize(SchedBench *BenchPtr)
+{
+	u32 Start;
+	s32 Status;
+
+	(void)memset(BenchPtr, 0, sizeof(*BenchPtr));
+	BenchPtr->Cpu1Status = XST_FAILURE;
+	Xil_TicketLockInit(&BenchPtr->Lock);
+
+	XTimestamp_EnableCycles();
+
+	Status = Amp_InitFromWrapper();
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	Status = AmpQueue_Initialize(&SchedBench_SpscPing,
+				     SchedBench_PingSlots, SCHED_BENCH_SLOTS,
+				     SCHED_BENCH_SLOT_SIZE);
+	if (Status == XST_SUCCESS) {
+		Status = AmpQueue_Initialize(&SchedBench_SpscPong,
+					     SchedBench_PongSlots,
+					     SCHED_BENCH_SLOTS,
+					     SCHED_BENCH_SLOT_SIZE);
+	}
+	if (Status == XST_SUCCESS) {
+		Status = AmpMpsc_Initialize(&SchedBench_MpscPing,
+					    SchedBench_MpscPingSlots,
+					    SCHED_BENCH_SLOTS,
+					    SCHED_BENCH_SLOT_SIZE, 1U);
+	}
+	if (Status == XST_SUCCESS) {
+		Status = AmpMpsc_Initialize(&SchedBench_MpscPong,
+					    SchedBench_MpscPongSlots,
+					    SCHED_BENCH_SLOTS,
+					    SCHED_BENCH_SLOT_SIZE, 0U);
+	}
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	/* Without the wheel only the wake and the wheel tests fail */
+	BenchPtr->WheelStatus = TimerWheel_Initialize(&BenchPtr->Wheel);
+	if (BenchPtr->WheelStatus == XST_SUCCESS) {
+		(void)EventLoop_Initialize(&BenchPtr->Loop, &BenchPtr->Wheel);
+		(void)EventLoop_SetHandler(&BenchPtr->Loop,
+					   SCHED_BENCH_WAKE_EVENT,
+					   SchedBench_WakeHandler, BenchPtr);
+	}
+	Xil_ExceptionEnable();
+
+	/* Without CPU1 only the tests between the cores fail */
+	BenchPtr->Cpu1Cmd = SCHED_BENCH_CMD_IDLE;
+	BenchPtr->Cpu1Ack = SCHED_BENCH_CMD_QUIT;
+	dsb();
+	BenchPtr->Cpu1Status = Amp_StartCpu1(SchedBench_Cpu1Main, BenchPtr);
+	if (BenchPtr->Cpu1Status == XST_SUCCESS) {
+		Start = XTimestamp_Cycles();
+		while (BenchPtr->Cpu1Ack != SCHED_BENCH_CMD_IDLE) {
+			if ((XTimestamp_Cycles() - Start) >
+			    SCHED_BENCH_TIMEOUT) {
+				BenchPtr->Cpu1Status = XST_FAILURE;
+				break;
+			}
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Runs every test once, then sends CPU1 back to wait for events.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	ResultsPtr is where the results are stored.
+* @param	MaxResults is the number of results ResultsPtr can hold,
+*		SCHED_BENCH_MAX_RESULTS for the full suite.
+*
+* @return	The number of results stored.
+*
+* @note		Each test runs to its end or its timeout; a result with a
+*		Status other than XST_SUCCESS has no cycles.
+*
+*****************************************************************************/
+u32 SchedBench_RunAll(SchedBench *BenchPtr, SchedBench_Result *ResultsPtr,
+		      u32 MaxResults)
+{
+	u32 NumResults = 0U;
+	u32 Test;
+	s32 Status;
+
+	for (Test = 0U; Test < SCHED_BENCH_NUM_TESTS; Test++) {
+		if (NumResults >= MaxResults) {
+			break;
+		}
+
+		SchedBench_Reset(BenchPtr);
+		switch (Test) {
+		case SCHED_BENCH_CORO:
+			Status = SchedBench_Coro(BenchPtr);
+			break;
+		case SCHED_BENCH_WAKE:
+			Status = SchedBench_Wake(BenchPtr);
+			break;
+		case SCHED_BENCH_SPSC:
+			Status = SchedBench_PingPong(BenchPtr,
+						     SCHED_BENCH_CMD_SPSC);
+			break;
+		case SCHED_BENCH_MPSC:
+			Status = SchedBench_PingPong(BenchPtr,
+						     SCHED_BENCH_CMD_MPSC);
+			break;
+		case SCHED_BENCH_LOCK:
+			Status = SchedBench_Lock(BenchPtr,
+						 SCHED_BENCH_CMD_IDLE);
+			break;
+		case SCHED_BENCH_LOCK2:
+			Status = SchedBench_Lock(BenchPtr,
+						 SCHED_BENCH_CMD_LOCK);
+			break;
+		default:
+			Status = SchedBench_Wheel(BenchPtr, Test);
+			break;
+		}
+
+		SchedBench_Store(BenchPtr, Test, Status,
+				 &ResultsPtr[NumResults]);
+		NumResults++;
+	}
+
+	BenchPtr->Cpu1Cmd = SCHED_BENCH_CMD_QUIT;
+	dsb();
+
+	return NumResults;
+}
+
+/****************************************************************************/
+/**
+*
+* Prints the results as a table on the standard output.
+*
+* @param	ResultsPtr is the results of SchedBench_RunAll().
+* @param	NumResults is the number of results.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void SchedBench_Report(const SchedBench_Result *ResultsPtr, u32 NumResults)
+{
+	const SchedBench_Result *ResultPtr;
+	u32 Index;
+
+	xil_printf("test\tsamples\tcycles min/avg/max\r\n");
+
+	for (Index = 0U; Index < NumResults; Index++) {
+		ResultPtr = &ResultsPtr[Index];
+
+		if (ResultPtr->Status != XST_SUCCESS) {
+			xil_printf("%s\t-\tfailed (%d)\r\n",
+				   SchedBench_TestNames[ResultPtr->Test],
+				   ResultPtr->Status);
+			continue;
+		}
+
+		xil_printf("%s\t%u\t%u/%u/%u\r\n",
+			   SchedBench_TestNames[ResultPtr->Test],
+			   ResultPtr->Samples, ResultPtr->MinCycles,
+			   ResultPtr->AvgCycles, ResultPtr->MaxCycles);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Main function of CPU1: runs the commands of CPU0 until it quits.
+*
+* @param	Arg is a pointer to the benchmark state.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void SchedBench_Cpu1Main(void *Arg)
+{
+	SchedBench *BenchPtr = (SchedBench *)Arg;
+	u32 Message[SCHED_BENCH_SLOT_SIZE / sizeof(u32)];
+	u32 Length;
+	u32 Cmd;
+
+	do {
+		Cmd = BenchPtr->Cpu1Cmd;
+		if (BenchPtr->Cpu1Ack != Cmd) {
+			BenchPtr->Cpu1Ack = Cmd;
+			dsb();
+		}
+
+		switch (Cmd) {
+		case SCHED_BENCH_CMD_SPSC:
+			Length = AmpQueue_Receive(&SchedBench_SpscPing,
+						  Message, sizeof(Message));
+			if (Length != 0U) {
+				while (AmpQueue_Send(&SchedBench_SpscPong,
+						     Message, Length) !=
+				       XST_SUCCESS) {
+					;
+				}
+			}
+			break;
+		case SCHED_BENCH_CMD_MPSC:
+			Length = AmpMpsc_Receive(&SchedBench_MpscPing,
+						 Message, sizeof(Message));
+			if (Length != 0U) {
+				while (AmpMpsc_Send(&SchedBench_MpscPong,
+						    Message, Length) !=
+				       XST_SUCCESS) {
+					;
+				}
+			}
+			break;
+		case SCHED_BENCH_CMD_LOCK:
+			Xil_TicketLockAcquire(&BenchPtr->Lock);
+			BenchPtr->Counter++;
+			Xil_TicketLockRelease(&BenchPtr->Lock);
+			break;
+		default:
+			break;
+		}
+	} while (Cmd != SCHED_BENCH_CMD_QUIT);
+}
+
+/****************************************************************************/
+/*
+*
+* Gives CPU1 a command and waits for it to switch to it.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	Cmd is one of the SCHED_BENCH_CMD_* commands.
+*
+* @return
+*		- XST_SUCCESS if CPU1 runs the command.
+*		- The error of Amp_StartCpu1() if CPU1 is not running.
+*		- XST_FAILURE if it did not acknowledge in time.
+*
+*****************************************************************************/
+static s32 SchedBench_Cpu1Do(SchedBench *BenchPtr, u32 Cmd)
+{
+	u32 Start;
+
+	if (BenchPtr->Cpu1Status != XST_SUCCESS) {
+		return BenchPtr->Cpu1Status;
+	}
+
+	BenchPtr->Cpu1Cmd = Cmd;
+	dsb();
+
+	Start = XTimestamp_Cycles();
+	while (BenchPtr->Cpu1Ack != Cmd) {
+		if ((XTimestamp_Cycles() - Start) > SCHED_BENCH_TIMEOUT) {
+			return XST_FAILURE;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Clears the samples of the previous test.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void SchedBench_Reset(SchedBench *BenchPtr)
+{
+	BenchPtr->NumSamples = 0U;
+	BenchPtr->MinCycles = 0xFFFFFFFFU;
+	BenchPtr->MaxCycles = 0U;
+	BenchPtr->SumCycles = 0U;
+	BenchPtr->Stamp = 0U;
+	BenchPtr->Expired = 0U;
+}
+
+/****************************************************************************/
+/*
+*
+* Adds a sample to the test, past SCHED_BENCH_SAMPLES it is dropped.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	Cycles is the cycles of the operation.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void SchedBench_Add(SchedBench *BenchPtr, u32 Cycles)
+{
+	if (BenchPtr->NumSamples >= SCHED_BENCH_SAMPLES) {
+		return;
+	}
+
+	BenchPtr->NumSamples++;
+	BenchPtr->SumCycles += Cycles;
+	if (Cycles < BenchPtr->MinCycles) {
+		BenchPtr->MinCycles = Cycles;
+	}
+	if (Cycles > BenchPtr->MaxCycles) {
+		BenchPtr->MaxCycles = Cycles;
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Stores the result of a test from its samples.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	Test is the test.
+* @param	Status is its status, XST_FAILURE if it took no sample.
+* @param	ResultPtr is where the result is stored.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void SchedBench_Store(SchedBench *BenchPtr, u32 Test, s32 Status,
+			     SchedBench_Result *ResultPtr)
+{
+	(void)memset(ResultPtr, 0, sizeof(*ResultPtr));
+	ResultPtr->Test = Test;
+	ResultPtr->Status = Status;
+
+	if ((Status == XST_SUCCESS) && (BenchPtr->NumSamples == 0U)) {
+		ResultPtr->Status = XST_FAILURE;
+	}
+	if (ResultPtr->Status != XST_SUCCESS) {
+		return;
+	}
+
+	ResultPtr->Samples = BenchPtr->NumSamples;
+	ResultPtr->MinCycles = BenchPtr->MinCycles;
+	ResultPtr->AvgCycles = (u32)(BenchPtr->SumCycles /
+				     BenchPtr->NumSamples);
+	ResultPtr->MaxCycles = BenchPtr->MaxCycles;
+}
+
+/****************************************************************************/
+/*
+*
+* Task of the switch test. The task yielding last stamps the cycles, so
+* that each return from Coro_Yield() times the switch from the other task,
+* out of it into the scheduler and into this one.
+*
+* @param	Arg is a pointer to the benchmark state.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void SchedBench_CoroTask(void *Arg)
+{
+	SchedBench *BenchPtr = (SchedBench *)Arg;
+	u32 Index;
+
+	for (Index = 0U; Index < (SCHED_BENCH_SAMPLES / 2U); Index++) {
+		BenchPtr->Stamp = XTimestamp_Cycles();
+		Coro_Yield();
+		SchedBench_Add(BenchPtr, XTimestamp_Cycles() -
+			       BenchPtr->Stamp);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Runs the switch test: two tasks yielding to each other.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return	XST_SUCCESS, or the error of Coro_Create().
+*
+*****************************************************************************/
+static s32 SchedBench_Coro(SchedBench *BenchPtr)
+{
+	u32 Index;
+	s32 Status;
+
+	for (Index = 0U; Index < 2U; Index++) {
+		Status = Coro_Create(SchedBench_CoroTask, BenchPtr,
+				     SchedBench_Stack[Index],
+				     SCHED_BENCH_STACK, NULL);
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+	}
+
+	Coro_Run();
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Timer handler of the wake test, posts the event from the interrupt.
+*
+* @param	CallBackRef is a pointer to the benchmark state.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void SchedBench_WakeIsr(void *CallBackRef)
+{
+	SchedBench *BenchPtr = (SchedBench *)CallBackRef;
+
+	BenchPtr->Stamp = XTimestamp_Cycles();
+	EventLoop_Post(&BenchPtr->Loop, SCHED_BENCH_WAKE_EVENT);
+}
+
+/****************************************************************************/
+/*
+*
+* Timer handler ending the wake test when the wakes stopped coming.
+*
+* @param	CallBackRef is a pointer to the benchmark state.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void SchedBench_GuardIsr(void *CallBackRef)
+{
+	SchedBench *BenchPtr = (SchedBench *)CallBackRef;
+
+	BenchPtr->WakeStatus = XST_FAILURE;
+	EventLoop_Stop(&BenchPtr->Loop);
+}
+
+/****************************************************************************/
+/*
+*
+* Event handler of the wake test: times the wake and starts the timer of
+* the next one, or stops the loop after the last.
+*
+* @param	CallBackRef is a pointer to the benchmark state.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void SchedBench_WakeHandler(void *CallBackRef)
+{
+	SchedBench *BenchPtr = (SchedBench *)CallBackRef;
+
+	SchedBench_Add(BenchPtr, XTimestamp_Cycles() - BenchPtr->Stamp);
+
+	if (BenchPtr->NumSamples >= SCHED_BENCH_SAMPLES) {
+		EventLoop_Stop(&BenchPtr->Loop);
+	} else {
+		TimerWheel_Start(&BenchPtr->Wheel, &BenchPtr->WakeTimer,
+				 SCHED_BENCH_WAKE_US);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Runs the wake test in the event loop, until its samples are taken or the
+* guard timer expires.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return
+*		- XST_SUCCESS if every wake came.
+*		- XST_FAILURE if they stopped coming.
+*		- The error of TimerWheel_Initialize() without the wheel.
+*
+*****************************************************************************/
+static s32 SchedBench_Wake(SchedBench *BenchPtr)
+{
+	if (BenchPtr->WheelStatus != XST_SUCCESS) {
+		return BenchPtr->WheelStatus;
+	}
+
+	BenchPtr->WakeStatus = XST_SUCCESS;
+	TimerWheel_InitTimer(&BenchPtr->WakeTimer, SchedBench_WakeIsr,
+			     BenchPtr);
+	TimerWheel_InitTimer(&BenchPtr->GuardTimer, SchedBench_GuardIsr,
+			     BenchPtr);
+	TimerWheel_Start(&BenchPtr->Wheel, &BenchPtr->GuardTimer,
+			 (u64)SCHED_BENCH_GUARD * SCHED_BENCH_SAMPLES *
+			 SCHED_BENCH_WAKE_US);
+	TimerWheel_Start(&BenchPtr->Wheel, &BenchPtr->WakeTimer,
+			 SCHED_BENCH_WAKE_US);
+
+	EventLoop_Run(&BenchPtr->Loop);
+
+	TimerWheel_Cancel(&BenchPtr->Wheel, &BenchPtr->WakeTimer);
+	TimerWheel_Cancel(&BenchPtr->Wheel, &BenchPtr->GuardTimer);
+
+	return BenchPtr->WakeStatus;
+}
+
+/****************************************************************************/
+/*
+*
+* Runs a ping-pong test: sends a word to CPU1 and waits for it to come back
+* on the other queue of the pair, SCHED_BENCH_SAMPLES times.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	Cmd is SCHED_BENCH_CMD_SPSC or SCHED_BENCH_CMD_MPSC.
+*
+* @return
+*		- XST_SUCCESS if every message came back.
+*		- XST_FAILURE if one did not in time.
+*		- The error of SchedBench_Cpu1Do() otherwise.
+*
+*****************************************************************************/
+static s32 SchedBench_PingPong(SchedBench *BenchPtr, u32 Cmd)
+{
+	u32 Message[SCHED_BENCH_SLOT_SIZE / sizeof(u32)];
+	u32 Index;
+	u32 Start;
+	u32 Length;
+	s32 Status;
+
+	Status = SchedBench_Cpu1Do(BenchPtr, Cmd);
+
+	for (Index = 0U; (Status == XST_SUCCESS) &&
+	     (Index < SCHED_BENCH_SAMPLES); Index++) {
+		Start = XTimestamp_Cycles();
+		if (Cmd == SCHED_BENCH_CMD_SPSC) {
+			Status = AmpQueue_Send(&SchedBench_SpscPing, &Index,
+					       sizeof(Index));
+		} else {
+			Status = AmpMpsc_Send(&SchedBench_MpscPing, &Index,
+					      sizeof(Index));
+		}
+
+		do {
+			if (Cmd == SCHED_BENCH_CMD_SPSC) {
+				Length = AmpQueue_Receive(&SchedBench_SpscPong,
+							  Message,
+							  sizeof(Message));
+			} else {
+				Length = AmpMpsc_Receive(&SchedBench_MpscPong,
+							 Message,
+							 sizeof(Message));
+			}
+			if ((XTimestamp_Cycles() - Start) >
+			    SCHED_BENCH_TIMEOUT) {
+				Status = XST_FAILURE;
+			}
+		} while ((Length == 0U) && (Status == XST_SUCCESS));
+
+		if (Status == XST_SUCCESS) {
+			SchedBench_Add(BenchPtr, XTimestamp_Cycles() - Start);
+		}
+	}
+
+	if (BenchPtr->Cpu1Status == XST_SUCCESS) {
+		(void)SchedBench_Cpu1Do(BenchPtr, SCHED_BENCH_CMD_IDLE);
+	}
+
+	return Status;
+}
+
+/****************************************************************************/
+/*
+*
+* Runs a lock test: takes and releases the lock SCHED_BENCH_SAMPLES times,
+* CPU1 idle or taking it too.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	Cmd is SCHED_BENCH_CMD_IDLE or SCHED_BENCH_CMD_LOCK.
+*
+* @return	XST_SUCCESS, or the error of SchedBench_Cpu1Do() when CPU1
+*		is to take the lock.
+*
+*****************************************************************************/
+static s32 SchedBench_Lock(SchedBench *BenchPtr, u32 Cmd)
+{
+	u32 Index;
+	u32 Start;
+	s32 Status = XST_SUCCESS;
+
+	if (Cmd != SCHED_BENCH_CMD_IDLE) {
+		Status = SchedBench_Cpu1Do(BenchPtr, Cmd);
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+	}
+
+	for (Index = 0U; Index < SCHED_BENCH_SAMPLES; Index++) {
+		Start = XTimestamp_Cycles();
+		Xil_TicketLockAcquire(&BenchPtr->Lock);
+		BenchPtr->Counter++;
+		Xil_TicketLockRelease(&BenchPtr->Lock);
+		SchedBench_Add(BenchPtr, XTimestamp_Cycles() - Start);
+	}
+
+	if (Cmd != SCHED_BENCH_CMD_IDLE) {
+		Status = SchedBench_Cpu1Do(BenchPtr, SCHED_BENCH_CMD_IDLE);
+	}
+
+	return Status;
+}
+
+/****************************************************************************/
+/*
+*
+* Timer handler of the expire test, times the handler before it in the
+* same interrupt.
+*
+* @param	CallBackRef is a pointer to the benchmark state.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void SchedBench_ExpireIsr(void *CallBackRef)
+{
+	SchedBench *BenchPtr = (SchedBench *)CallBackRef;
+	u32 Now = XTimestamp_Cycles();
+
+	if (BenchPtr->Expired != 0U) {
+		SchedBench_Add(BenchPtr, Now - BenchPtr->Stamp);
+	}
+	BenchPtr->Stamp = Now;
+	BenchPtr->Expired++;
+}
+
+/****************************************************************************/
+/*
+*
+* Runs a wheel test on SCHED_BENCH_TIMERS timers. The start test spreads
+* the deadlines from SCHED_BENCH_NEAR_US over every level, the cancel test
+* cancels those timers, and the expire test starts them all for the same
+* tick and waits for their handlers.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	Test is SCHED_BENCH_START, SCHED_BENCH_CANCEL or
+*		SCHED_BENCH_EXPIRE.
+*
+* @return
+*		- XST_SUCCESS if the test completed.
+*		- XST_FAILURE if the timers of the expire test did not all
+*		  expire in time.
+*		- The error of TimerWheel_Initialize() without the wheel.
+*
+*****************************************************************************/
+static s32 SchedBench_Wheel(SchedBench *BenchPtr, u32 Test)
+{
+	TimerWheel_Timer *TimerPtr;
+	XTime Deadline;
+	u32 Index;
+	u32 Start;
+	s32 Status = XST_SUCCESS;
+
+	if (BenchPtr->WheelStatus != XST_SUCCESS) {
+		return BenchPtr->WheelStatus;
+	}
+
+	if (Test != SCHED_BENCH_CANCEL) {
+		for (Index = 0U; Index < SCHED_BENCH_TIMERS; Index++) {
+			TimerWheel_InitTimer(&BenchPtr->Timer[Index],
+					     SchedBench_ExpireIsr, BenchPtr);
+		}
+	}
+	Deadline = XTimestamp_Now() + XTimestamp_FromUs(SCHED_BENCH_EXPIRE_US);
+
+	for (Index = 0U; Index < SCHED_BENCH_TIMERS; Index++) {
+		TimerPtr = &BenchPtr->Timer[Index];
+		Start = XTimestamp_Cycles();
+		if (Test == SCHED_BENCH_START) {
+			TimerWheel_Start(&BenchPtr->Wheel, TimerPtr,
+					 (u64)SCHED_BENCH_NEAR_US <<
+					 (Index % 28U));
+		} else if (Test == SCHED_BENCH_CANCEL) {
+			TimerWheel_Cancel(&BenchPtr->Wheel, TimerPtr);
+		} else {
+			TimerWheel_StartAt(&BenchPtr->Wheel, TimerPtr,
+					   Deadline);
+		}
+		if (Test != SCHED_BENCH_EXPIRE) {
+			SchedBench_Add(BenchPtr, XTimestamp_Cycles() - Start);
+		}
+	}
+
+	if (Test == SCHED_BENCH_EXPIRE) {
+		Start = XTimestamp_Cycles();
+		while (BenchPtr->Expired < SCHED_BENCH_TIMERS) {
+			if ((XTimestamp_Cycles() - Start) >
+			    SCHED_BENCH_TIMEOUT) {
+				Status = XST_FAILURE;
+				break;
+			}
+		}
+		for (Index = 0U; Index < SCHED_BENCH_TIMERS; Index++) {
+			TimerWheel_Cancel(&BenchPtr->Wheel,
+					  &BenchPtr->Timer[Index]);
+		}
+	}
+
+	return Status;
+}
@@ -0,0 +1,139 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file sched_bench.h
+*
+* Costs of the scheduling primitives of the application, in CPU cycles of
+* the PMU cycle counter of CPU0:
+*
+* - coro: a switch between two tasks of coro.h, from the Coro_Yield() of
+*   one to its return in the other, through the scheduler.
+* - wake: the wake of the event loop of event_loop.h, from the post of an
+*   event by the timer interrupt of a timer wheel to the call of its
+*   handler, with the loop asleep in WFI in between.
+* - spsc and mpsc: the round trip of a word message to CPU1 and back,
+*   through a pair of the queues of amp_queue.h and of amp_mpsc.h, both
+*   sides polling.
+* - lock and lock2: a Xil_TicketLock of xil_atomic.h taken and released,
+*   CPU1 idle and CPU1 taking it in a loop.
+* - start, cancel and expire: the TimerWheel_Start() and the
+*   TimerWheel_Cancel() of a timer, the deadlines spread over the levels of
+*   the wheel, and the time between the handlers of SCHED_BENCH_TIMERS
+*   timers expiring in the same interrupt.
+*
+* A result gives the fewest, mean and most cycles of its samples, up to
+* SCHED_BENCH_SAMPLES, each one operation timed on its own.
+*
+* CPU1 is started with Amp_StartCpu1() for the queues and the contended
+* lock, with the AMP runtime of amp.h set up if it is not yet. If CPU1 had
+* been started already, these results are XST_DEVICE_BUSY. The benchmark
+* takes the private timer of CPU0 for its wheel, before the application
+* sets up its own. It is built into the application when SCHED_BENCH is
+* defined.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef SCHED_BENCH_H
+#define SCHED_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xil_atomic.h"
+#include "timer_wheel.h"
+#include "event_loop.h"
+
+/************************** Constant Definitions ****************************/
+
+/** @name Tests
+ * @{
+ */
+#define SCHED_BENCH_CORO	0U	/**< Task switch */
+#define SCHED_BENCH_WAKE	1U	/**< ISR post to event handler */
+#define SCHED_BENCH_SPSC	2U	/**< AmpQueue round trip */
+#define SCHED_BENCH_MPSC	3U	/**< AmpMpsc round trip */
+#define SCHED_BENCH_LOCK	4U	/**< Ticket lock, CPU1 idle */
+#define SCHED_BENCH_LOCK2	5U	/**< Ticket lock, CPU1 taking it */
+#define SCHED_BENCH_START	6U	/**< TimerWheel_Start() */
+#define SCHED_BENCH_CANCEL	7U	/**< TimerWheel_Cancel() */
+#define SCHED_BENCH_EXPIRE	8U	/**< Per timer expired */
+#define SCHED_BENCH_NUM_TESTS	9U
+/* @} */
+
+#define SCHED_BENCH_SAMPLES	256U	/**< Samples per result */
+#define SCHED_BENCH_TIMERS	64U	/**< Timers of the wheel tests */
+#define SCHED_BENCH_WAKE_US	200U	/**< Between two wakes */
+#define SCHED_BENCH_STACK	2048U	/**< Bytes of a task stack */
+#define SCHED_BENCH_SLOTS	16U	/**< Slots of a queue */
+#define SCHED_BENCH_SLOT_SIZE	32U	/**< Bytes of a slot */
+#define SCHED_BENCH_TIMEOUT	100000000U /**< Cycles of a wait */
+
+/** Results of a full suite */
+#define SCHED_BENCH_MAX_RESULTS	SCHED_BENCH_NUM_TESTS
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Result of one test.
+ */
+typedef struct {
+	u32 Test;		/**< One of the SCHED_BENCH_* tests */
+	s32 Status;		/**< XST_SUCCESS, or why the run failed */
+	u32 Samples;		/**< Operations timed */
+	u32 MinCycles;		/**< Fastest operation */
+	u32 AvgCycles;		/**< Mean of the operations */
+	u32 MaxCycles;		/**< Slowest operation */
+} SchedBench_Result;
+
+/**
+ * State of the benchmark, shared by the two CPUs and the handlers.
+ */
+typedef struct {
+	TimerWheel Wheel;	/**< On the private timer of CPU0 */
+	s32 WheelStatus;	/**< Of TimerWheel_Initialize() */
+	EventLoop Loop;
+	TimerWheel_Timer WakeTimer; /**< Posts the event of the wake test */
+	TimerWheel_Timer GuardTimer; /**< Ends it if the wakes stop */
+	s32 WakeStatus;
+	TimerWheel_Timer Timer[SCHED_BENCH_TIMERS];
+	volatile u32 Stamp;	/**< Cycles of the last yield or post */
+	volatile u32 Expired;	/**< Timers of the expire test expired */
+	u32 NumSamples;
+	u32 MinCycles;
+	u32 MaxCycles;
+	u64 SumCycles;
+	Xil_TicketLock Lock;
+	volatile u32 Counter;	/**< Under Lock */
+	volatile u32 Cpu1Cmd;	/**< What CPU1 is to do */
+	volatile u32 Cpu1Ack;	/**< What CPU1 does */
+	s32 Cpu1Status;		/**< Of Amp_StartCpu1() */
+} SchedBench;
+
+/************************** Function Prototypes *****************************/
+
+s32 SchedBench_Initialize(SchedBench *BenchPtr);
+u32 SchedBench_RunAll(SchedBench *BenchPtr, SchedBench_Result *ResultsPtr,
+		      u32 MaxResults);
+void SchedBench_Report(const SchedBench_Result *ResultsPtr, u32 NumResults);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SCHED_BENCH_H */
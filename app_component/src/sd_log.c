@@ -0,0 +1,415 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file sd_log.c
+*
+* Write-behind log file. Refer to sd_log.h for how it is used.
+*
+* Head and Tail are free running byte counts, and Tail is also the file
+* offset of the next byte to be written, the file being created empty. A
+* write never crosses a cluster boundary of the file; the ring being a
+* multiple of the cluster size, it never wraps in the ring either, and
+* goes to the card straight from the ring. Head is changed with the
+* interrupts masked, Tail only by SdLog_Poll(), which must be called from a
+* single context.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xparameters.h"
+
+#ifdef XPAR_XSDPS_0_BASEADDR
+
+#include <string.h>
+#include "xstatus.h"
+#include "xil_assert.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "sd_log.h"
+
+/************************** Constant Definitions ****************************/
+
+#define SD_LOG_COUNTS_PER_MS	((XTime)COUNTS_PER_SECOND / 1000U)
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#if FF_MAX_SS != FF_MIN_SS
+#define SdLog_SectorSize(FsPtr)	((u32)(FsPtr)->ssize)
+#else
+#define SdLog_SectorSize(FsPtr)	((u32)FF_MAX_SS)
+#endif
+
+/************************** Function Prototypes *****************************/
+
+static s32 SdLog_Write(SdLog *LogPtr, u32 NumBytes);
+static s32 SdLog_Sync(SdLog *LogPtr);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* Creates the log file, empty, and preallocates it.
+*
+* @param	LogPtr is a pointer to the log.
+* @param	Path is the path of the file, on a mounted volume. A file
+*		of that name is replaced.
+* @param	BufferPtr is the storage of the ring, aligned to a cache line.
+* @param	Size is the size of the storage in bytes, a power of two of
+*		at least two clusters of the volume.
+* @param	PreallocBytes is the size the file is preallocated to, as one
+*		run of clusters, or 0. Without FF_USE_EXPAND, or without
+*		room for one run, the file is not preallocated.
+* @param	FlushMs is the longest time appended bytes wait before they
+*		are written and synced, plus the time between two calls of
+*		SdLog_Poll().
+*
+* @return
+*		- XST_SUCCESS if the log is open.
+*		- XST_INVALID_PARAM for a ring too small or not a power of
+*		  two, or a zero flush time.
+*		- XST_FAILURE if the file cannot be created or preallocated.
+*
+*****************************************************************************/
+s32 SdLog_Open(SdLog *LogPtr, const char *Path, u8 *BufferPtr, u32 Size,
+	       u32 PreallocBytes, u32 FlushMs)
+{
+	FRESULT Res;
+
+	Xil_AssertNonvoid(LogPtr != NULL);
+	Xil_AssertNonvoid((Path != NULL) && (BufferPtr != NULL));
+
+	if ((FlushMs == 0U) || (Size == 0U) || ((Size & (Size - 1U)) != 0U)) {
+		return XST_INVALID_PARAM;
+	}
+
+	LogPtr->Open = 0U;
+	Res = f_open(&LogPtr->File, Path, FA_WRITE | FA_CREATE_ALWAYS);
+	if (Res != FR_OK) {
+		return XST_FAILURE;
+	}
+
+	LogPtr->ClusterSize = (u32)LogPtr->File.obj.fs->csize *
+			      SdLog_SectorSize(LogPtr->File.obj.fs);
+	if (Size < (2U * LogPtr->ClusterSize)) {
+		(void)f_close(&LogPtr->File);
+		return XST_INVALID_PARAM;
+	}
+
+#if FF_USE_EXPAND
+	if (PreallocBytes != 0U) {
+		PreallocBytes = (PreallocBytes + LogPtr->ClusterSize - 1U) &
+				~(LogPtr->ClusterSize - 1U);
+		Res = f_expand(&LogPtr->File, (FSIZE_t)PreallocBytes, 1U);
+		if ((Res != FR_OK) && (Res != FR_DENIED)) {
+			(void)f_close(&LogPtr->File);
+			return XST_FAILURE;
+		}
+	}
+#else
+	(void)PreallocBytes;
+#endif
+
+	LogPtr->BufferPtr = BufferPtr;
+	LogPtr->Mask = Size - 1U;
+	LogPtr->Head = 0U;
+	LogPtr->Tail = 0U;
+	LogPtr->FlushCounts = (XTime)FlushMs * SD_LOG_COUNTS_PER_MS;
+	LogPtr->WaitStart = 0U;
+	LogPtr->Waiting = 0U;
+	LogPtr->Unsynced = 0U;
+	(void)memset(&LogPtr->Stats, 0, sizeof(LogPtr->Stats));
+	LogPtr->Open = 1U;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Appends bytes to the log, from any context. Only the ring is touched.
+*
+* @param	LogPtr is a pointer to the log.
+* @param	DataPtr points to the bytes.
+* @param	NumBytes is the number of bytes.
+*
+* @return	NumBytes, or 0 if the ring has no room for all of them or the
+*		log is not open. The bytes are then dropped and counted.
+*
+*****************************************************************************/
+u32 SdLog_Append(SdLog *LogPtr, const void *DataPtr, u32 NumBytes)
+{
+	const u8 *SrcPtr = (const u8 *)DataPtr;
+	u32 Cpsr;
+	u32 Head;
+	u32 Offset;
+	u32 First;
+
+	if ((LogPtr->Open == 0U) || (NumBytes == 0U)) {
+		return 0U;
+	}
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	Head = LogPtr->Head;
+	if ((LogPtr->Mask + 1U - (Head - LogPtr->Tail)) < NumBytes) {
+		LogPtr->Stats.Dropped += NumBytes;
+		NumBytes = 0U;
+	} else {
+		Offset = Head & LogPtr->Mask;
+		First = LogPtr->Mask + 1U - Offset;
+		if (First > NumBytes) {
+			First = NumBytes;
+		}
+		(void)memcpy(&LogPtr->BufferPtr[Offset], SrcPtr, First);
+		(void)memcpy(LogPtr->BufferPtr, &SrcPtr[First],
+			     NumBytes - First);
+		LogPtr->Head = Head + NumBytes;
+		LogPtr->Stats.Appended += NumBytes;
+	}
+	mtcpsr(Cpsr);
+
+	return NumBytes;
+}
+
+/****************************************************************************/
+/**
+*
+* Background work of the log: writes the next cluster if the ring holds
+* all of it, otherwise writes what is left and syncs the file once bytes
+* have waited for the flush time. It makes at most one f_write() and one
+* f_sync(), so that a call takes at most one cluster write of the card.
+*
+* @param	LogPtr is a pointer to the log.
+*
+* @return
+*		- XST_SUCCESS if nothing failed.
+*		- XST_FAILURE if a write or the sync failed. The bytes not
+*		  written stay in the ring and are retried.
+*
+*****************************************************************************/
+s32 SdLog_Poll(SdLog *LogPtr)
+{
+	u32 Head;
+	u32 Boundary;
+	XTime Now;
+	s32 Status;
+
+	if (LogPtr->Open == 0U) {
+		return XST_SUCCESS;
+	}
+
+	Head = LogPtr->Head;
+	if ((Head == LogPtr->Tail) && (LogPtr->Unsynced == 0U)) {
+		LogPtr->Waiting = 0U;
+		return XST_SUCCESS;
+	}
+
+	XTime_GetTime(&Now);
+	if (LogPtr->Waiting == 0U) {
+		LogPtr->Waiting = 1U;
+		LogPtr->WaitStart = Now;
+	}
+
+	Boundary = LogPtr->ClusterSize -
+		   (LogPtr->Tail & (LogPtr->ClusterSize - 1U));
+	if ((Head - LogPtr->Tail) >= Boundary) {
+		return SdLog_Write(LogPtr, Boundary);
+	}
+
+	if ((Now - LogPtr->WaitStart) < LogPtr->FlushCounts) {
+		return XST_SUCCESS;
+	}
+
+	if (Head != LogPtr->Tail) {
+		Status = SdLog_Write(LogPtr, Head - LogPtr->Tail);
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+	}
+
+	return SdLog_Sync(LogPtr);
+}
+
+/****************************************************************************/
+/**
+*
+* Writes all of the ring and syncs the file, waiting for the card.
+*
+* @param	LogPtr is a pointer to the log.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if a write or the sync failed.
+*
+* @note		Bytes appended meanwhile may be written too.
+*
+*****************************************************************************/
+s32 SdLog_Flush(SdLog *LogPtr)
+{
+	u32 Head;
+	u32 Boundary;
+	s32 Status;
+
+	if (LogPtr->Open == 0U) {
+		return XST_SUCCESS;
+	}
+
+	Head = LogPtr->Head;
+	while (Head != LogPtr->Tail) {
+		Boundary = LogPtr->ClusterSize -
+			   (LogPtr->Tail & (LogPtr->ClusterSize - 1U));
+		if (Boundary > (Head - LogPtr->Tail)) {
+			Boundary = Head - LogPtr->Tail;
+		}
+		Status = SdLog_Write(LogPtr, Boundary);
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+	}
+
+	return SdLog_Sync(LogPtr);
+}
+
+/****************************************************************************/
+/**
+*
+* Flushes the log, truncates the file after its last byte and closes it.
+*
+* @param	LogPtr is a pointer to the log.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if the file could not be completed.
+*		The log is closed in both cases.
+*
+*****************************************************************************/
+s32 SdLog_Close(SdLog *LogPtr)
+{
+	s32 Status;
+
+	if (LogPtr->Open == 0U) {
+		return XST_SUCCESS;
+	}
+
+	Status = SdLog_Flush(LogPtr);
+	LogPtr->Open = 0U;
+
+	if (f_truncate(&LogPtr->File) != FR_OK) {
+		Status = XST_FAILURE;
+	}
+	if (f_close(&LogPtr->File) != FR_OK) {
+		Status = XST_FAILURE;
+	}
+
+	return Status;
+}
+
+/****************************************************************************/
+/**
+*
+* Copies the counts of the log.
+*
+* @param	LogPtr is a pointer to the log.
+* @param	StatsPtr is where the counts are copied to.
+*
+* @return	None.
+*
+*****************************************************************************/
+void SdLog_GetStats(const SdLog *LogPtr, SdLog_Stats *StatsPtr)
+{
+	*StatsPtr = LogPtr->Stats;
+}
+
+/****************************************************************************/
+/*
+*
+* Writes the next bytes of the ring, within one cluster of the file.
+*
+* @param	LogPtr is a pointer to the log.
+* @param	NumBytes is the number of bytes, up to the next cluster
+*		boundary.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if not all were written.
+*
+*****************************************************************************/
+static s32 SdLog_Write(SdLog *LogPtr, u32 NumBytes)
+{
+	UINT Written = 0U;
+	FRESULT Res;
+	XTime Start;
+	XTime End;
+
+	XTime_GetTime(&Start);
+	Res = f_write(&LogPtr->File,
+		      &LogPtr->BufferPtr[LogPtr->Tail & LogPtr->Mask],
+		      (UINT)NumBytes, &Written);
+	XTime_GetTime(&End);
+
+	LogPtr->Stats.Writes++;
+	if ((End - Start) > LogPtr->Stats.MaxWriteCounts) {
+		LogPtr->Stats.MaxWriteCounts = End - Start;
+	}
+
+	/* The file offset moved by what was written */
+	LogPtr->Tail += (u32)Written;
+	LogPtr->Unsynced += (u32)Written;
+
+	if ((Res != FR_OK) || ((u32)Written != NumBytes)) {
+		LogPtr->Stats.Errors++;
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Syncs the file, so that the directory entry and the FAT cover the bytes
+* written, and restarts the flush time.
+*
+* @param	LogPtr is a pointer to the log.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if the sync failed.
+*
+*****************************************************************************/
+static s32 SdLog_Sync(SdLog *LogPtr)
+{
+	FRESULT Res;
+	XTime Start;
+	XTime End;
+
+	XTime_GetTime(&Start);
+	Res = f_sync(&LogPtr->File);
+	XTime_GetTime(&End);
+
+	LogPtr->Stats.Syncs++;
+	if ((End - Start) > LogPtr->Stats.MaxWriteCounts) {
+		LogPtr->Stats.MaxWriteCounts = End - Start;
+	}
+
+	if (Res != FR_OK) {
+		LogPtr->Stats.Errors++;
+		return XST_FAILURE;
+	}
+
+	LogPtr->Unsynced = 0U;
+	LogPtr->Waiting = (LogPtr->Head != LogPtr->Tail) ? 1U : 0U;
+	LogPtr->WaitStart = End;
+
+	return XST_SUCCESS;
+}
+
+#endif /* XPAR_XSDPS_0_BASEADDR */
@@ -0,0 +1,113 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file sd_log.h
+*
+* Write-behind log file on the SD card, on xilffs.
+*
+* f_write() followed by f_sync() waits for the card, which takes tens of
+* milliseconds now and then while it erases. SdLog_Append() instead copies
+* the bytes into a RAM ring, which costs a copy and nothing else, so a
+* producer, from any context, never waits for the card. SdLog_Poll(),
+* called from the idle loop or a task of coro.h, writes the ring to the
+* file:
+*
+* - a cluster at a time, from a cluster boundary of the file, as soon as
+*   the ring holds one, so that each write is one multi-block write of the
+*   card straight from the ring, and
+* - what is left, followed by f_sync(), once data has waited for
+*   FlushMs, so that no record waits longer than that to reach the card.
+*
+* The file is created empty and preallocated with f_expand() as one run of
+* contiguous clusters, so that the writes do not update the FAT. Its size
+* is the preallocated size until SdLog_Close() truncates it after the last
+* byte. Past the preallocated size the file grows as usual.
+*
+* The ring is a power of two bytes of at least two clusters. Its bytes are
+* written by the SD DMA, so it must be aligned to a cache line and its size
+* a multiple of one. Bytes that do not fit in the ring are dropped, never
+* in part, and counted.
+*
+* SD0 and xilffs must be enabled in the BSP, read-write with
+* FF_USE_EXPAND set to 1 for the preallocation, xilffs added to
+* USER_LINK_LIBRARIES and the volume mounted with f_mount(). Without SD0
+* the file compiles to nothing.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef SD_LOG_H
+#define SD_LOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xiltimer.h"
+#include "ff.h"
+
+/************************** Constant Definitions ****************************/
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Counts of a log.
+ */
+typedef struct {
+	u32 Appended;		/**< Bytes appended */
+	u32 Dropped;		/**< Bytes dropped on a full ring */
+	u32 Writes;		/**< Calls of f_write() */
+	u32 Syncs;		/**< Calls of f_sync() */
+	u32 Errors;		/**< Failed writes and syncs */
+	XTime MaxWriteCounts;	/**< Longest write or sync */
+} SdLog_Stats;
+
+/**
+ * A log file.
+ */
+typedef struct {
+	FIL File;
+	u8 *BufferPtr;		/**< Ring */
+	u32 Mask;		/**< Size of the ring in bytes minus one */
+	volatile u32 Head;	/**< Next byte to be appended */
+	volatile u32 Tail;	/**< Next byte to be written, its file offset */
+	u32 ClusterSize;	/**< Bytes per cluster */
+	XTime FlushCounts;	/**< Longest wait of a byte for the card */
+	XTime WaitStart;	/**< Time unsynced bytes were first seen */
+	u32 Waiting;		/**< Bytes are in the ring or not synced */
+	u32 Unsynced;		/**< Bytes written since the last f_sync() */
+	u32 Open;
+	SdLog_Stats Stats;
+} SdLog;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+s32 SdLog_Open(SdLog *LogPtr, const char *Path, u8 *BufferPtr, u32 Size,
+	       u32 PreallocBytes, u32 FlushMs);
+u32 SdLog_Append(SdLog *LogPtr, const void *DataPtr, u32 NumBytes);
+s32 SdLog_Poll(SdLog *LogPtr);
+s32 SdLog_Flush(SdLog *LogPtr);
+s32 SdLog_Close(SdLog *LogPtr);
+void SdLog_GetStats(const SdLog *LogPtr, SdLog_Stats *StatsPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SD_LOG_H */
@@ -0,0 +1,244 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file stack_mark.c
+*
+* High-water marks of the stacks. Refer to stack_mark.h for how they are
+* painted and read.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xstatus.h"
+#include "stack_mark.h"
+
+/************************** Constant Definitions ****************************/
+
+/**************************** Type Definitions ******************************/
+
+/*
+ * A stack of the linker script, from its bottom up to its top
+ */
+typedef struct {
+	const char *Name;
+	u8 *Bottom;
+	u8 *Top;
+} StackMark_Stack;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static s32 StackMark_ReadUsed(void *Ref);
+
+/************************** Variable Definitions ****************************/
+
+/*
+ * Bottoms and tops of the stacks, from the linker script. With _OCM_STACKS
+ * the exception mode ones are those of the OCM.
+ */
+extern u8 _stack_end[];
+extern u8 _stack[];
+extern u8 _irq_stack_end[];
+extern u8 __irq_stack[];
+extern u8 _supervisor_stack_end[];
+extern u8 __supervisor_stack[];
+extern u8 _abort_stack_end[];
+extern u8 __abort_stack[];
+extern u8 _fiq_stack_end[];
+extern u8 __fiq_stack[];
+extern u8 _undef_stack_end[];
+extern u8 __undef_stack[];
+extern u8 _cpu1_stack_end[];
+extern u8 __cpu1_stack[];
+extern u8 __cpu1_irq_stack[];
+extern u8 __cpu1_fiq_stack[];
+extern u8 __cpu1_exc_stack[];
+
+static const StackMark_Stack Stacks[STACK_MARK_NUM_STACKS] = {
+	[STACK_MARK_MAIN] = { "stack.main", _stack_end, _stack },
+	[STACK_MARK_IRQ] = { "stack.irq", _irq_stack_end, __irq_stack },
+	[STACK_MARK_SVC] = { "stack.svc", _supervisor_stack_end,
+			     __supervisor_stack },
+	[STACK_MARK_ABORT] = { "stack.abort", _abort_stack_end,
+			       __abort_stack },
+	[STACK_MARK_FIQ] = { "stack.fiq", _fiq_stack_end, __fiq_stack },
+	[STACK_MARK_UNDEF] = { "stack.undef", _undef_stack_end,
+			       __undef_stack },
+	[STACK_MARK_CPU1] = { "stack.cpu1", _cpu1_stack_end, __cpu1_stack },
+	[STACK_MARK_CPU1_IRQ] = { "stack.cpu1_irq", __cpu1_stack,
+				  __cpu1_irq_stack },
+	[STACK_MARK_CPU1_FIQ] = { "stack.cpu1_fiq", __cpu1_irq_stack,
+				  __cpu1_fiq_stack },
+	[STACK_MARK_CPU1_EXC] = { "stack.cpu1_exc", __cpu1_fiq_stack,
+				  __cpu1_exc_stack },
+};
+
+/****************************************************************************/
+/**
+*
+* Paints the stacks of the linker script with STACK_MARK_PATTERN, that of
+* main() up to STACK_MARK_MARGIN bytes below the frame of the caller.
+*
+* @return	None.
+*
+* @note		Call it first thing in main(), before the interrupts are
+*		enabled and CPU1 is started: the other stacks are painted
+*		whole.
+*
+*****************************************************************************/
+void StackMark_Paint(void)
+{
+	const StackMark_Stack *StackPtr;
+	u8 *Limit;
+	u32 Index;
+
+	for (Index = 0U; Index < STACK_MARK_NUM_STACKS; Index++) {
+		StackPtr = &Stacks[Index];
+		Limit = StackPtr->Top;
+		if (Index == STACK_MARK_MAIN) {
+			Limit = (u8 *)__builtin_frame_address(0) -
+				STACK_MARK_MARGIN;
+		}
+		if (Limit > StackPtr->Bottom) {
+			StackMark_PaintArea(StackPtr->Bottom,
+					    (u32)(Limit - StackPtr->Bottom));
+		}
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the size and the high-water mark of a stack of the linker script.
+*
+* @param	Stack is one of the STACK_MARK_* stacks.
+* @param	UsagePtr is where to store them.
+*
+* @return
+*		- XST_SUCCESS if the usage is stored.
+*		- XST_INVALID_PARAM if there is no such stack.
+*
+*****************************************************************************/
+s32 StackMark_GetUsage(u32 Stack, StackMark_Usage *UsagePtr)
+{
+	const StackMark_Stack *StackPtr;
+	u32 Size;
+
+	if ((Stack >= STACK_MARK_NUM_STACKS) || (UsagePtr == NULL)) {
+		return XST_INVALID_PARAM;
+	}
+
+	StackPtr = &Stacks[Stack];
+	Size = (u32)(StackPtr->Top - StackPtr->Bottom);
+	UsagePtr->Name = StackPtr->Name;
+	UsagePtr->Size = Size;
+	UsagePtr->Used = StackMark_AreaUsed(StackPtr->Bottom, Size);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Adds a gauge of the high-water mark of each stack of the linker script
+* to a registry, named as in StackMark_Usage, in bytes.
+*
+* @param	RegPtr is a pointer to the registry.
+*
+* @return
+*		- XST_SUCCESS if all the gauges are added.
+*		- The error of Metrics_AddGaugeFn() otherwise, the gauges
+*		  before it being kept.
+*
+*****************************************************************************/
+s32 StackMark_Register(Metrics *RegPtr)
+{
+	u32 Index;
+	s32 Status;
+
+	for (Index = 0U; Index < STACK_MARK_NUM_STACKS; Index++) {
+		Status = Metrics_AddGaugeFn(RegPtr, Stacks[Index].Name,
+					    StackMark_ReadUsed,
+					    (void *)&Stacks[Index]);
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Paints a stack with STACK_MARK_PATTERN.
+*
+* @param	BasePtr is the bottom of the stack, word aligned.
+* @param	NumBytes is its size, a whole number of words.
+*
+* @return	None.
+*
+* @note		The stack must not be in use.
+*
+*****************************************************************************/
+void StackMark_PaintArea(void *BasePtr, u32 NumBytes)
+{
+	volatile u32 *WordPtr = (volatile u32 *)BasePtr;
+	u32 Index;
+
+	for (Index = 0U; Index < (NumBytes / 4U); Index++) {
+		WordPtr[Index] = STACK_MARK_PATTERN;
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the high-water mark of a stack painted by StackMark_PaintArea(),
+* or by StackMark_Paint().
+*
+* @param	BasePtr is the bottom of the stack, word aligned.
+* @param	NumBytes is its size, a whole number of words.
+*
+* @return	Bytes from the top of the stack down to the lowest word that
+*		does not hold the pattern, NumBytes for a stack that was
+*		ever full.
+*
+*****************************************************************************/
+u32 StackMark_AreaUsed(const void *BasePtr, u32 NumBytes)
+{
+	const volatile u32 *WordPtr = (const volatile u32 *)BasePtr;
+	u32 NumWords = NumBytes / 4U;
+	u32 Index = 0U;
+
+	while ((Index < NumWords) && (WordPtr[Index] == STACK_MARK_PATTERN)) {
+		Index++;
+	}
+
+	return (NumWords - Index) * 4U;
+}
+
+/*
+ * Gauge of the high-water mark of a stack of the linker script.
+ */
+static s32 StackMark_ReadUsed(void *Ref)
+{
+	const StackMark_Stack *StackPtr = (const StackMark_Stack *)Ref;
+
+	return (s32)StackMark_AreaUsed(StackPtr->Bottom,
+				       (u32)(StackPtr->Top - StackPtr->Bottom));
+}
@@ -0,0 +1,100 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file stack_mark.h
+*
+* High-water marks of the stacks of the linker script, as measured on the
+* target, to size them from.
+*
+* StackMark_Paint(), first thing in main(), fills the stacks of both CPUs
+* with STACK_MARK_PATTERN: the mode stacks of CPU0 and the .cpu1_stack
+* section whole, CPU1 not being started yet and no exception taken, and
+* the stack of main() up to a little below its frame. The used bytes of a
+* stack are then those from its top down to the lowest word that no longer
+* holds the pattern, StackMark_Used(), a scan up from the bottom of the
+* stack that stops at the first such word. A stack that was ever full
+* reads as full; it may have overflowed.
+*
+* StackMark_Register() adds a gauge of the used bytes of each stack to the
+* registry of metrics.h, "stack.main", "stack.irq" and so on, scanned as
+* each frame is exported. The stacks of the tasks of coro.h, or any other
+* stack the application allocates, are painted and read with
+* StackMark_PaintArea() and StackMark_AreaUsed().
+*
+* The worst case the code can reach is estimated from the frames GCC gives
+* with -fstack-usage and the calls of the image, see
+* app_component/tools/stack_usage.py; the marks show what the boot and
+* the traffic of a test actually used, the two together giving the sizes
+* to link with, refer to UserConfig.cmake.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef STACK_MARK_H
+#define STACK_MARK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "metrics.h"
+
+/************************** Constant Definitions ****************************/
+
+#define STACK_MARK_PATTERN	0x5AC3A55CU /**< Word of an unused stack */
+#define STACK_MARK_MARGIN	256U	/**< Left below the frame of main() */
+
+/** @name Stacks of the linker script
+ * @{
+ */
+#define STACK_MARK_MAIN		0U	/**< System mode, main() */
+#define STACK_MARK_IRQ		1U
+#define STACK_MARK_SVC		2U
+#define STACK_MARK_ABORT	3U
+#define STACK_MARK_FIQ		4U
+#define STACK_MARK_UNDEF	5U
+#define STACK_MARK_CPU1		6U	/**< System mode of CPU1 */
+#define STACK_MARK_CPU1_IRQ	7U
+#define STACK_MARK_CPU1_FIQ	8U
+#define STACK_MARK_CPU1_EXC	9U	/**< Abort, undefined, supervisor */
+#define STACK_MARK_NUM_STACKS	10U
+/** @} */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Use of one stack.
+ */
+typedef struct {
+	const char *Name;	/**< Name of its metric */
+	u32 Size;		/**< Bytes linked */
+	u32 Used;		/**< Bytes of the high-water mark */
+} StackMark_Usage;
+
+/************************** Function Prototypes *****************************/
+
+void StackMark_Paint(void);
+s32 StackMark_GetUsage(u32 Stack, StackMark_Usage *UsagePtr);
+s32 StackMark_Register(Metrics *RegPtr);
+void StackMark_PaintArea(void *BasePtr, u32 NumBytes);
+u32 StackMark_AreaUsed(const void *BasePtr, u32 NumBytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STACK_MARK_H */
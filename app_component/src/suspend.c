@@ -0,0 +1,606 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file suspend.c
+*
+* Suspend to RAM of the application. Refer to suspend.h for how it is used.
+*
+* The CPU side, the save and the resume vector, is suspend_resume.S.
+* SuspendSave() returns twice, like setjmp: 0 when the state is saved and 1
+* on a resume through a reset, with the stack and the callee saved
+* registers as they were at the save and the rest of the DDR as it was
+* written back before the self-refresh. Nothing set after the save is used
+* on the second return.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xil_io.h"
+#include "xil_mem.h"
+#include "xil_cache.h"
+#include "xil_cache_l.h"
+#include "xil_hotpath.h"
+#include "xil_misc_psreset_api.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xl2cc.h"
+#include "xscutimer_hw.h"
+#include "xscuwdt_hw.h"
+#include "xinterrupt_wrap.h"
+#include "amp.h"
+#include "suspend.h"
+
+/************************** Constant Definitions ****************************/
+
+#define SUSPEND_REBOOT_STATUS	(XSLCR_BASEADDR + 0x00000258U)
+#define SUSPEND_SLCR_LOCK_ADDR	(XSLCR_BASEADDR + 0x00000004U)
+#define SUSPEND_SLCR_LOCK_CODE	0x0000767BU
+#define SUSPEND_SLCR_L2C_RAM	(XSLCR_BASEADDR + 0x00000A1CU)
+#define SUSPEND_L2C_RAM_CONFIG	0x00020202U	/* As boot.S */
+
+/* The high OCM bank up to the resume record, after the three low ones */
+#define SUSPEND_OCM_HIGH_ADDR	0xFFFF0000U
+#define SUSPEND_OCM_HIGH_SIZE	(SUSPEND_RESUME_ADDR - SUSPEND_OCM_HIGH_ADDR)
+
+#define SUSPEND_GT_CONTROL	2U	/* Index in SuspendGtRegs */
+#define SUSPEND_UART_CR		0U	/* Indexes in SuspendUartRegs */
+#define SUSPEND_UART_IMR	2U
+
+#define SUSPEND_WDT_DISABLE_1	0x12345678U
+#define SUSPEND_WDT_DISABLE_2	0x87654321U
+
+#define SUSPEND_CONTEXT_WORDS	((u32)sizeof(Suspend_State) / 4U)
+#define SUSPEND_RECORD_WORDS	(((u32)sizeof(Suspend_Record) / 4U) - 1U)
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+extern u32 SuspendSave(u32 *CpuPtr) __attribute__((returns_twice));
+extern void SuspendResume(void);
+extern void SuspendSelfRefresh(void);
+
+static u32 SuspendDmaBusy(const Suspend *SuspendPtr);
+static void SuspendSaveState(Suspend *SuspendPtr);
+static void SuspendRestoreState(Suspend *SuspendPtr);
+static void SuspendMask(Suspend *SuspendPtr);
+static void SuspendUnmask(const Suspend *SuspendPtr);
+static void SuspendSeal(const Suspend *SuspendPtr);
+static void SuspendUnseal(void);
+
+/************************** Variable Definitions ****************************/
+
+/* Of the global timer: counter low and high, control, comparator, reload */
+static const u32 SuspendGtRegs[6] = {
+	0x00U, 0x04U, 0x08U, 0x10U, 0x14U, 0x18U
+};
+
+static const u32 SuspendUartRegs[SUSPEND_UART_REGS] = {
+	XUARTPS_CR_OFFSET, XUARTPS_MR_OFFSET, XUARTPS_IMR_OFFSET,
+	XUARTPS_BAUDGEN_OFFSET, XUARTPS_RXTOUT_OFFSET, XUARTPS_RXWM_OFFSET,
+	XUARTPS_MODEMCR_OFFSET, XUARTPS_BAUDDIV_OFFSET,
+	XUARTPS_FLOWDEL_OFFSET, XUARTPS_TXWM_OFFSET
+};
+
+/****************************************************************************/
+/**
+*
+* Sets up the suspend facility on the GIC of the application, without UARTs,
+* DMA controller or wake sources.
+*
+* @param	SuspendPtr is a pointer to the facility.
+*
+* @return
+*		- XST_SUCCESS if it is ready.
+*		- XST_FAILURE if the GIC is not set up yet.
+*
+*****************************************************************************/
+s32 Suspend_Initialize(Suspend *SuspendPtr)
+{
+	u32 Index;
+
+	SuspendPtr->GicPtr = XGetScuGicInstance();
+	if ((SuspendPtr->GicPtr == NULL) ||
+	    (SuspendPtr->GicPtr->IsReady != XIL_COMPONENT_IS_READY)) {
+		return XST_FAILURE;
+	}
+
+	SuspendPtr->NumUarts = 0U;
+	SuspendPtr->DmaPtr = NULL;
+	for (Index = 0U; Index < (SUSPEND_GIC_NUM_INTR / 32U); Index++) {
+		SuspendPtr->WakeMask[Index] = 0U;
+		SuspendPtr->Masked[Index] = 0U;
+	}
+	SuspendPtr->Stats.Suspends = 0U;
+	SuspendPtr->Stats.Refused = 0U;
+	SuspendPtr->Stats.Wakes = 0U;
+	SuspendPtr->Stats.Resumes = 0U;
+	SuspendPtr->Stats.AsleepCounts = 0U;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Adds a UART of the application, its setup restored on a resume.
+*
+* @param	SuspendPtr is a pointer to the facility.
+* @param	UartPtr is a pointer to the UART, initialized.
+* @param	Wake is nonzero for its interrupt to wake the suspend.
+*
+* @return
+*		- XST_SUCCESS if it is added.
+*		- XST_INVALID_PARAM if the UART is not ready.
+*		- XST_FAILURE if SUSPEND_MAX_UARTS are added already.
+*
+*****************************************************************************/
+s32 Suspend_AddUart(Suspend *SuspendPtr, XUartPs *UartPtr, u32 Wake)
+{
+	u32 IntrId;
+	s32 Status;
+
+	if (UartPtr->IsReady != XIL_COMPONENT_IS_READY) {
+		return XST_INVALID_PARAM;
+	}
+	if (SuspendPtr->NumUarts >= SUSPEND_MAX_UARTS) {
+		return XST_FAILURE;
+	}
+
+	if (Wake != 0U) {
+		IntrId = XGet_IntrId(UartPtr->Config.IntrId) +
+			 XGet_IntrOffset(UartPtr->Config.IntrId);
+		Status = Suspend_AddWake(SuspendPtr, IntrId);
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+	}
+
+	SuspendPtr->Uart[SuspendPtr->NumUarts].UartPtr = UartPtr;
+	SuspendPtr->NumUarts++;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Adds a wake source. The interrupt is targeted to CPU0 while suspended.
+*
+* @param	SuspendPtr is a pointer to the facility.
+* @param	IntId is the GIC interrupt ID.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM for an ID past the GIC.
+*
+*****************************************************************************/
+s32 Suspend_AddWake(Suspend *SuspendPtr, u32 IntId)
+{
+	if (IntId >= SUSPEND_GIC_NUM_INTR) {
+		return XST_INVALID_PARAM;
+	}
+
+	SuspendPtr->WakeMask[IntId / 32U] |= (u32)1U << (IntId % 32U);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Sets the DMA controller a suspend waits for and whose interrupt enables are
+* restored on a resume.
+*
+* @param	SuspendPtr is a pointer to the facility.
+* @param	DmaPtr is a pointer to the controller, or NULL for none.
+*
+* @return	None.
+*
+*****************************************************************************/
+void Suspend_SetDma(Suspend *SuspendPtr, XDmaPs *DmaPtr)
+{
+	SuspendPtr->DmaPtr = DmaPtr;
+}
+
+/****************************************************************************/
+/**
+*
+* Suspends to RAM until a wake interrupt or a system reset.
+*
+* @param	SuspendPtr is a pointer to the facility.
+*
+* @return
+*		- XST_SUCCESS after the wake or the resume. The wake interrupt
+*		  is taken once the call returns.
+*		- XST_DEVICE_BUSY if a DMA channel is busy, or CPU1 is
+*		  parked already.
+*		- XST_FAILURE if CPU1 does not park.
+*
+* @note		Call it on CPU0 in system mode, from the main loop. With no
+*		wake source only a reset ends the suspend.
+*
+*****************************************************************************/
+s32 Suspend_Enter(Suspend *SuspendPtr)
+{
+	XTime Asleep;
+	XTime Awake;
+	u32 Resumed;
+	u32 Cpsr;
+	s32 Status;
+
+	if (SuspendDmaBusy(SuspendPtr) != 0U) {
+		SuspendPtr->Stats.Refused++;
+		return XST_DEVICE_BUSY;
+	}
+
+	Status = Amp_ParkCpu1();
+	if (Status != XST_SUCCESS) {
+		SuspendPtr->Stats.Refused++;
+		return Status;
+	}
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	SuspendPtr->Stats.Suspends++;
+
+	SuspendSaveState(SuspendPtr);
+	SuspendMask(SuspendPtr);
+
+	Resumed = SuspendSave(SuspendPtr->State.Cpu);
+	if (Resumed == 0U) {
+		SuspendSeal(SuspendPtr);
+		XTime_GetTime(&Asleep);
+		SuspendSelfRefresh();
+		XTime_GetTime(&Awake);
+		SuspendUnseal();
+		SuspendPtr->Stats.AsleepCounts += Awake - Asleep;
+		SuspendPtr->Stats.Wakes++;
+	} else {
+		SuspendRestoreState(SuspendPtr);
+		SuspendPtr->Stats.Resumes++;
+	}
+
+	/* Timer mode, so the load restarts the count, then as it was */
+	Xil_Out32(XPAR_XSCUWDT_0_BASEADDR + XSCUWDT_LOAD_OFFSET,
+		  SuspendPtr->State.PrivWdt[0]);
+	Xil_Out32(XPAR_XSCUWDT_0_BASEADDR + XSCUWDT_CONTROL_OFFSET,
+		  SuspendPtr->State.PrivWdt[1]);
+
+	SuspendUnmask(SuspendPtr);
+	Amp_UnparkCpu1(Resumed);
+	mtcpsr(Cpsr);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Gets the counts of the suspends.
+*
+* @param	SuspendPtr is a pointer to the facility.
+* @param	StatsPtr is where the counts are copied.
+*
+* @return	None.
+*
+*****************************************************************************/
+void Suspend_GetStats(const Suspend *SuspendPtr, Suspend_Stats *StatsPtr)
+{
+	*StatsPtr = SuspendPtr->Stats;
+}
+
+/* Nonzero while a channel of the DMA controller has work */
+static u32 SuspendDmaBusy(const Suspend *SuspendPtr)
+{
+	u32 Channel;
+
+	if (SuspendPtr->DmaPtr == NULL) {
+		return 0U;
+	}
+	for (Channel = 0U; Channel < XDMAPS_CHANNELS_PER_DEV; Channel++) {
+		if (XDmaPs_GetLoad(SuspendPtr->DmaPtr, Channel) != 0U) {
+			return 1U;
+		}
+	}
+
+	return 0U;
+}
+
+/* Saves what a reset loses and stops the private watchdog */
+static void SuspendSaveState(Suspend *SuspendPtr)
+{
+	Suspend_State *StatePtr = &SuspendPtr->State;
+	XScuGic *GicPtr = SuspendPtr->GicPtr;
+	UINTPTR Base;
+	u32 Index;
+	u32 Reg;
+
+	StatePtr->GicDist = XScuGic_DistReadReg(GicPtr, XSCUGIC_DIST_EN_OFFSET);
+	for (Index = 0U; Index < (SUSPEND_GIC_NUM_INTR / 32U); Index++) {
+		StatePtr->GicEnable[Index] = XScuGic_DistReadReg(GicPtr,
+			XSCUGIC_ENABLE_SET_OFFSET + (Index * 4U));
+	}
+	for (Index = 0U; Index < (SUSPEND_GIC_NUM_INTR / 4U); Index++) {
+		StatePtr->GicPriority[Index] = XScuGic_DistReadReg(GicPtr,
+			XSCUGIC_PRIORITY_OFFSET + (Index * 4U));
+		StatePtr->GicTarget[Index] = XScuGic_DistReadReg(GicPtr,
+			XSCUGIC_SPI_TARGET_OFFSET + (Index * 4U));
+	}
+	for (Index = 0U; Index < (SUSPEND_GIC_NUM_INTR / 16U); Index++) {
+		StatePtr->GicConfig[Index] = XScuGic_DistReadReg(GicPtr,
+			XSCUGIC_INT_CFG_OFFSET + (Index * 4U));
+	}
+	StatePtr->GicCpu[0] = XScuGic_CPUReadReg(GicPtr,
+						 XSCUGIC_CONTROL_OFFSET);
+	StatePtr->GicCpu[1] = XScuGic_CPUReadReg(GicPtr,
+						 XSCUGIC_CPU_PRIOR_OFFSET);
+	StatePtr->GicCpu[2] = XScuGic_CPUReadReg(GicPtr,
+						 XSCUGIC_BIN_PT_OFFSET);
+
+	for (Index = 0U; Index < 6U; Index++) {
+		StatePtr->GlobalTimer[Index] = Xil_In32(
+			XPAR_GLOBAL_TMR_BASEADDR + SuspendGtRegs[Index]);
+	}
+	StatePtr->PrivTimer[0] = Xil_In32(XPAR_XSCUTIMER_0_BASEADDR +
+					  XSCUTIMER_LOAD_OFFSET);
+	StatePtr->PrivTimer[1] = Xil_In32(XPAR_XSCUTIMER_0_BASEADDR +
+					  XSCUTIMER_COUNTER_OFFSET);
+	StatePtr->PrivTimer[2] = Xil_In32(XPAR_XSCUTIMER_0_BASEADDR +
+					  XSCUTIMER_CONTROL_OFFSET);
+	StatePtr->PrivWdt[0] = Xil_In32(XPAR_XSCUWDT_0_BASEADDR +
+					XSCUWDT_LOAD_OFFSET);
+	StatePtr->PrivWdt[1] = Xil_In32(XPAR_XSCUWDT_0_BASEADDR +
+					XSCUWDT_CONTROL_OFFSET);
+
+	for (Index = 0U; Index < (2U * XIL_L2_NUM_MASTERS); Index++) {
+		StatePtr->L2Lockdown[Index] = Xil_In32(XPS_L2CC_BASEADDR +
+			XPS_L2CC_CACHE_DLCKDWN_0_WAY_OFFSET + (Index * 4U));
+	}
+
+	StatePtr->DmaInten = 0U;
+	if (SuspendPtr->DmaPtr != NULL) {
+		StatePtr->DmaInten = Xil_In32(
+			SuspendPtr->DmaPtr->Config.BaseAddress +
+			XDMAPS_INTEN_OFFSET);
+	}
+
+	for (Index = 0U; Index < SuspendPtr->NumUarts; Index++) {
+		Base = SuspendPtr->Uart[Index].UartPtr->Config.BaseAddress;
+		for (Reg = 0U; Reg < SUSPEND_UART_REGS; Reg++) {
+			SuspendPtr->Uart[Index].Reg[Reg] =
+				XUartPs_ReadReg(Base, SuspendUartRegs[Reg]);
+		}
+	}
+
+	Xil_MemCpy(StatePtr->Ocm, (const void *)Xil_OcmLowBase(),
+		   XIL_OCM_LOW_SIZE);
+	Xil_MemCpy(&StatePtr->Ocm[XIL_OCM_LOW_SIZE],
+		   (const void *)SUSPEND_OCM_HIGH_ADDR, SUSPEND_OCM_HIGH_SIZE);
+
+	/* Only the disable sequence takes the watchdog out of reset mode */
+	Xil_Out32(XPAR_XSCUWDT_0_BASEADDR + XSCUWDT_DISABLE_OFFSET,
+		  SUSPEND_WDT_DISABLE_1);
+	Xil_Out32(XPAR_XSCUWDT_0_BASEADDR + XSCUWDT_DISABLE_OFFSET,
+		  SUSPEND_WDT_DISABLE_2);
+	Xil_Out32(XPAR_XSCUWDT_0_BASEADDR + XSCUWDT_CONTROL_OFFSET, 0U);
+}
+
+/* Gives back after a reset what SuspendSaveState() saved, but the watchdog */
+static void SuspendRestoreState(Suspend *SuspendPtr)
+{
+	Suspend_State *StatePtr = &SuspendPtr->State;
+	XScuGic *GicPtr = SuspendPtr->GicPtr;
+	const u32 *RegPtr;
+	UINTPTR Base;
+	u32 Index;
+	u32 Reg;
+
+	/* The L2 cache as boot.S sets it up, then the OCM sections */
+	Xil_Out32(XSLCR_UNLOCK_ADDR, XSLCR_UNLOCK_CODE);
+	Xil_Out32(SUSPEND_SLCR_L2C_RAM, SUSPEND_L2C_RAM_CONFIG);
+	Xil_Out32(SUSPEND_SLCR_LOCK_ADDR, SUSPEND_SLCR_LOCK_CODE);
+	Xil_L2CacheEnable();
+	Xil_HotPathInitialize();
+
+	Xil_MemCpy((void *)Xil_OcmLowBase(), StatePtr->Ocm, XIL_OCM_LOW_SIZE);
+	Xil_MemCpy((void *)SUSPEND_OCM_HIGH_ADDR,
+		   &StatePtr->Ocm[XIL_OCM_LOW_SIZE], SUSPEND_OCM_HIGH_SIZE);
+	Xil_DCacheFlushRange(Xil_OcmLowBase(), XIL_OCM_LOW_SIZE);
+	Xil_DCacheFlushRange(SUSPEND_OCM_HIGH_ADDR, SUSPEND_OCM_HIGH_SIZE);
+	Xil_ICacheInvalidateRange(Xil_OcmLowBase(), XIL_OCM_LOW_SIZE);
+	Xil_ICacheInvalidateRange(SUSPEND_OCM_HIGH_ADDR,
+				  SUSPEND_OCM_HIGH_SIZE);
+
+	for (Index = 0U; Index < (2U * XIL_L2_NUM_MASTERS); Index++) {
+		Xil_Out32(XPS_L2CC_BASEADDR +
+			  XPS_L2CC_CACHE_DLCKDWN_0_WAY_OFFSET + (Index * 4U),
+			  StatePtr->L2Lockdown[Index]);
+	}
+
+	XScuGic_DistWriteReg(GicPtr, XSCUGIC_DIST_EN_OFFSET, 0U);
+	for (Index = 0U; Index < (SUSPEND_GIC_NUM_INTR / 16U); Index++) {
+		XScuGic_DistWriteReg(GicPtr,
+			XSCUGIC_INT_CFG_OFFSET + (Index * 4U),
+			StatePtr->GicConfig[Index]);
+	}
+	for (Index = 0U; Index < (SUSPEND_GIC_NUM_INTR / 4U); Index++) {
+		XScuGic_DistWriteReg(GicPtr,
+			XSCUGIC_PRIORITY_OFFSET + (Index * 4U),
+			StatePtr->GicPriority[Index]);
+		XScuGic_DistWriteReg(GicPtr,
+			XSCUGIC_SPI_TARGET_OFFSET + (Index * 4U),
+			StatePtr->GicTarget[Index]);
+	}
+	for (Index = 0U; Index < (SUSPEND_GIC_NUM_INTR / 32U); Index++) {
+		XScuGic_DistWriteReg(GicPtr,
+			XSCUGIC_DISABLE_OFFSET + (Index * 4U), 0xFFFFFFFFU);
+		XScuGic_DistWriteReg(GicPtr,
+			XSCUGIC_ENABLE_SET_OFFSET + (Index * 4U),
+			StatePtr->GicEnable[Index] &
+			~SuspendPtr->Masked[Index]);
+	}
+	XScuGic_DistWriteReg(GicPtr, XSCUGIC_DIST_EN_OFFSET,
+			     StatePtr->GicDist);
+	XScuGic_CPUWriteReg(GicPtr, XSCUGIC_BIN_PT_OFFSET, StatePtr->GicCpu[2]);
+	XScuGic_CPUWriteReg(GicPtr, XSCUGIC_CPU_PRIOR_OFFSET,
+			    StatePtr->GicCpu[1]);
+	XScuGic_CPUWriteReg(GicPtr, XSCUGIC_CONTROL_OFFSET,
+			    StatePtr->GicCpu[0]);
+
+	/* The counter restarts where it suspended */
+	Xil_Out32(XPAR_GLOBAL_TMR_BASEADDR + SuspendGtRegs[SUSPEND_GT_CONTROL],
+		  0U);
+	for (Index = 0U; Index < 6U; Index++) {
+		if (Index != SUSPEND_GT_CONTROL) {
+			Xil_Out32(XPAR_GLOBAL_TMR_BASEADDR +
+				  SuspendGtRegs[Index],
+				  StatePtr->GlobalTimer[Index]);
+		}
+	}
+	Xil_Out32(XPAR_GLOBAL_TMR_BASEADDR + SuspendGtRegs[SUSPEND_GT_CONTROL],
+		  StatePtr->GlobalTimer[SUSPEND_GT_CONTROL]);
+
+	Xil_Out32(XPAR_XSCUTIMER_0_BASEADDR + XSCUTIMER_CONTROL_OFFSET, 0U);
+	Xil_Out32(XPAR_XSCUTIMER_0_BASEADDR + XSCUTIMER_LOAD_OFFSET,
+		  StatePtr->PrivTimer[0]);
+	Xil_Out32(XPAR_XSCUTIMER_0_BASEADDR + XSCUTIMER_COUNTER_OFFSET,
+		  StatePtr->PrivTimer[1]);
+	Xil_Out32(XPAR_XSCUTIMER_0_BASEADDR + XSCUTIMER_CONTROL_OFFSET,
+		  StatePtr->PrivTimer[2]);
+
+	/* Disabled while set up, the FIFOs reset, then enabled as they were */
+	for (Index = 0U; Index < SuspendPtr->NumUarts; Index++) {
+		Base = SuspendPtr->Uart[Index].UartPtr->Config.BaseAddress;
+		RegPtr = SuspendPtr->Uart[Index].Reg;
+		XUartPs_WriteReg(Base, XUARTPS_CR_OFFSET,
+				 XUARTPS_CR_TX_DIS | XUARTPS_CR_RX_DIS);
+		for (Reg = 0U; Reg < SUSPEND_UART_REGS; Reg++) {
+			if ((Reg != SUSPEND_UART_CR) &&
+			    (Reg != SUSPEND_UART_IMR)) {
+				XUartPs_WriteReg(Base, SuspendUartRegs[Reg],
+						 RegPtr[Reg]);
+			}
+		}
+		XUartPs_WriteReg(Base, XUARTPS_CR_OFFSET,
+				 XUARTPS_CR_TX_DIS | XUARTPS_CR_RX_DIS |
+				 XUARTPS_CR_TXRST | XUARTPS_CR_RXRST);
+		XUartPs_WriteReg(Base, XUARTPS_ISR_OFFSET, XUARTPS_IXR_MASK);
+		XUartPs_WriteReg(Base, XUARTPS_IDR_OFFSET,
+				 ~RegPtr[SUSPEND_UART_IMR] & XUARTPS_IXR_MASK);
+		XUartPs_WriteReg(Base, XUARTPS_IER_OFFSET,
+				 RegPtr[SUSPEND_UART_IMR]);
+		XUartPs_WriteReg(Base, XUARTPS_CR_OFFSET,
+				 RegPtr[SUSPEND_UART_CR] &
+				 ~(XUARTPS_CR_TXRST | XUARTPS_CR_RXRST));
+	}
+
+	if (SuspendPtr->DmaPtr != NULL) {
+		Xil_Out32(SuspendPtr->DmaPtr->Config.BaseAddress +
+			  XDMAPS_INTEN_OFFSET, StatePtr->DmaInten);
+	}
+}
+
+/*
+ * Disables in the distributor the enabled interrupts that are not wake
+ * sources and targets the wake sources to CPU0, the one in wait for
+ * interrupt.
+ */
+static void SuspendMask(Suspend *SuspendPtr)
+{
+	XScuGic *GicPtr = SuspendPtr->GicPtr;
+	u32 Target;
+	u32 IntId;
+	u32 Index;
+	u32 Shift;
+
+	for (Index = 0U; Index < (SUSPEND_GIC_NUM_INTR / 32U); Index++) {
+		SuspendPtr->Masked[Index] = SuspendPtr->State.GicEnable[Index] &
+					    ~SuspendPtr->WakeMask[Index];
+		XScuGic_DistWriteReg(GicPtr,
+			XSCUGIC_DISABLE_OFFSET + (Index * 4U),
+			SuspendPtr->Masked[Index]);
+	}
+
+	/* The target registers of the SGIs and PPIs are read only */
+	for (IntId = 32U; IntId < SUSPEND_GIC_NUM_INTR; IntId++) {
+		if ((SuspendPtr->WakeMask[IntId / 32U] &
+		     ((u32)1U << (IntId % 32U))) == 0U) {
+			continue;
+		}
+		Shift = (IntId % 4U) * 8U;
+		Target = XScuGic_DistReadReg(GicPtr,
+			XSCUGIC_SPI_TARGET_OFFSET + ((IntId / 4U) * 4U));
+		Target &= ~((u32)0xFFU << Shift);
+		Target |= (u32)0x01U << Shift;
+		XScuGic_DistWriteReg(GicPtr,
+			XSCUGIC_SPI_TARGET_OFFSET + ((IntId / 4U) * 4U),
+			Target);
+	}
+}
+
+/* Undoes SuspendMask() */
+static void SuspendUnmask(const Suspend *SuspendPtr)
+{
+	XScuGic *GicPtr = SuspendPtr->GicPtr;
+	u32 Index;
+
+	for (Index = 8U; Index < (SUSPEND_GIC_NUM_INTR / 4U); Index++) {
+		XScuGic_DistWriteReg(GicPtr,
+			XSCUGIC_SPI_TARGET_OFFSET + (Index * 4U),
+			SuspendPtr->State.GicTarget[Index]);
+	}
+	for (Index = 0U; Index < (SUSPEND_GIC_NUM_INTR / 32U); Index++) {
+		XScuGic_DistWriteReg(GicPtr,
+			XSCUGIC_ENABLE_SET_OFFSET + (Index * 4U),
+			SuspendPtr->Masked[Index]);
+	}
+}
+
+/*
+ * Leaves the resume record and the reboot status flag for the FSBL, and
+ * writes the caches back, the last DDR writes before the self-refresh.
+ */
+static void SuspendSeal(const Suspend *SuspendPtr)
+{
+	Suspend_Record *RecordPtr = (Suspend_Record *)SUSPEND_RESUME_ADDR;
+
+	RecordPtr->Magic = SUSPEND_RESUME_MAGIC;
+	RecordPtr->Vector = (u32)(UINTPTR)SuspendResume;
+	RecordPtr->Context = (u32)(UINTPTR)&SuspendPtr->State;
+	RecordPtr->ContextLen = (u32)sizeof(Suspend_State);
+	RecordPtr->ContextSum = Xil_MemSum32((const u32 *)&SuspendPtr->State,
+					     SUSPEND_CONTEXT_WORDS);
+	RecordPtr->Checksum = Xil_MemSum32((const u32 *)RecordPtr,
+					   SUSPEND_RECORD_WORDS);
+
+	Xil_Out32(SUSPEND_REBOOT_STATUS,
+		  Xil_In32(SUSPEND_REBOOT_STATUS) | SUSPEND_REBOOT_FLAG);
+	Xil_DCacheFlush();
+}
+
+/* Takes the record and the flag back after a wake in place */
+static void SuspendUnseal(void)
+{
+	Suspend_Record *RecordPtr = (Suspend_Record *)SUSPEND_RESUME_ADDR;
+
+	Xil_Out32(SUSPEND_REBOOT_STATUS,
+		  Xil_In32(SUSPEND_REBOOT_STATUS) & ~SUSPEND_REBOOT_FLAG);
+	RecordPtr->Magic = 0U;
+	Xil_DCacheFlushRange((UINTPTR)RecordPtr, sizeof(Suspend_Record));
+}
@@ -0,0 +1,176 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file suspend.h
+*
+* Suspend to RAM of the application, for the units that only idle: the DDR
+* is put in self-refresh and CPU0 waits for an interrupt, and the service
+* goes on where it stopped on the wake, without the FSBL and the driver
+* setup of a cold start.
+*
+* Suspend_Enter() refuses while a channel of the DMA controller is busy,
+* parks CPU1 with Amp_ParkCpu1() and masks in the distributor all the
+* interrupts but the wake sources, the interrupts of the UARTs added with
+* Suspend_AddUart() to wake it and those of Suspend_AddWake(). It saves
+* the state a system reset loses: the distributor and the CPU interface of
+* the GIC, the UARTs, the interrupt enables of the DMA controller, the
+* global timer, the private timer and watchdog, the L2 lockdown, the CPU
+* registers of every mode and the MMU setup, and the whole OCM. It then
+* leaves a resume record at SUSPEND_RESUME_ADDR, out of the FSBL and
+* application linker scripts, and sets SUSPEND_REBOOT_FLAG in the reboot
+* status register, which a system reset keeps. The caches are written back
+* and SuspendSelfRefresh, in the low OCM, puts the DDR in self-refresh and
+* waits for an interrupt.
+*
+* There are two ways out:
+*	- A wake interrupt: the DDR leaves self-refresh, the private
+*	  watchdog, the interrupts and CPU1 are given back and
+*	  Suspend_Enter() returns, the interrupt pending. The rest of the
+*	  state was never lost.
+*	- A system reset, from the reset button or a PL or external reset:
+*	  the FSBL, built with FSBL_RESUME, finds the flag and a valid record
+*	  and a valid sum of the saved state once ps7_init has taken the DDR
+*	  out of self-refresh, clears both and jumps to SuspendResume instead
+*	  of loading the boot image. SuspendResume turns the MMU and the
+*	  caches on again with the saved registers and returns from the save
+*	  of Suspend_Enter() a second time, which loads the OCM sections of
+*	  xil_hotpath.h, copies the saved OCM back and restores the saved
+*	  state before it returns. CPU1 is back in the Boot ROM wait loop, for
+*	  Amp_StartCpu1().
+*
+* The PL is cleared by a system reset and the FSBL does not load its
+* bitstream on a resume; the application loads it again, dfx_mgr.h, before
+* it uses it. Masters of their own, such as the PL, the Ethernet and the
+* USB controllers, must be idle: nothing may reach the DDR while it is in
+* self-refresh. The global timer stands still over a resume through a
+* reset, time restarting where it suspended.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef SUSPEND_H
+#define SUSPEND_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xiltimer.h"
+#include "xil_l2lock.h"
+#include "xscugic.h"
+#include "xuartps.h"
+#include "xdmaps.h"
+
+/************************** Constant Definitions ****************************/
+
+/*
+ * Resume record, below the FSBL records in the high OCM and kept out of the
+ * linker scripts. The FSBL side is fsbl_resume.h
+ */
+#define SUSPEND_RESUME_ADDR	0xFFFFF300U
+#define SUSPEND_RESUME_SIZE	0x100U
+#define SUSPEND_RESUME_MAGIC	0x314D5352U	/* "RSM1" */
+
+/* Bit of the reboot status register free for the application */
+#define SUSPEND_REBOOT_FLAG	0x00008000U
+
+#define SUSPEND_MAX_UARTS	2U
+#define SUSPEND_GIC_NUM_INTR	96U
+#define SUSPEND_CPU_WORDS	51U	/* Layout of suspend_resume.S */
+#define SUSPEND_UART_REGS	10U
+#define SUSPEND_OCM_SIZE	0x40000U /* All four banks */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * The resume record, the checksum is Xil_MemSum32 of the words before it.
+ */
+typedef struct {
+	u32 Magic;		/**< SUSPEND_RESUME_MAGIC */
+	u32 Vector;		/**< SuspendResume */
+	u32 Context;		/**< Address of the saved state, in DDR */
+	u32 ContextLen;		/**< Its bytes, a multiple of 4 */
+	u32 ContextSum;		/**< Xil_MemSum32 of it */
+	u32 Checksum;
+} Suspend_Record;
+
+/**
+ * A UART of the application.
+ */
+typedef struct {
+	XUartPs *UartPtr;
+	u32 Reg[SUSPEND_UART_REGS];
+} Suspend_Uart;
+
+/**
+ * The state a system reset loses, covered by the sum of the record.
+ */
+typedef struct {
+	u32 Cpu[SUSPEND_CPU_WORDS];	/**< Of SuspendSave */
+	u32 GicEnable[SUSPEND_GIC_NUM_INTR / 32U];
+	u32 GicPriority[SUSPEND_GIC_NUM_INTR / 4U];
+	u32 GicTarget[SUSPEND_GIC_NUM_INTR / 4U];
+	u32 GicConfig[SUSPEND_GIC_NUM_INTR / 16U];
+	u32 GicDist;		/**< Distributor enable */
+	u32 GicCpu[3];		/**< Control, priority mask, binary point */
+	u32 GlobalTimer[6];
+	u32 PrivTimer[3];	/**< Load, counter and control */
+	u32 PrivWdt[2];		/**< Load and control */
+	u32 L2Lockdown[2U * XIL_L2_NUM_MASTERS];
+	u32 DmaInten;
+	u8 Ocm[SUSPEND_OCM_SIZE] __attribute__((aligned(32)));
+} Suspend_State;
+
+/**
+ * Counts of the suspends.
+ */
+typedef struct {
+	u32 Suspends;		/**< Calls that suspended */
+	u32 Refused;		/**< Refused, DMA busy or CPU1 not parked */
+	u32 Wakes;		/**< Woken by an interrupt */
+	u32 Resumes;		/**< Woken by a reset, through the FSBL */
+	XTime AsleepCounts;	/**< In self-refresh, over the wakes */
+} Suspend_Stats;
+
+/**
+ * The suspend facility.
+ */
+typedef struct {
+	XScuGic *GicPtr;
+	Suspend_Uart Uart[SUSPEND_MAX_UARTS];
+	u32 NumUarts;
+	XDmaPs *DmaPtr;		/**< NULL for none */
+	u32 WakeMask[SUSPEND_GIC_NUM_INTR / 32U];
+	u32 Masked[SUSPEND_GIC_NUM_INTR / 32U]; /**< Disabled while asleep */
+	Suspend_State State;
+	Suspend_Stats Stats;
+} Suspend;
+
+/************************** Function Prototypes *****************************/
+
+s32 Suspend_Initialize(Suspend *SuspendPtr);
+s32 Suspend_AddUart(Suspend *SuspendPtr, XUartPs *UartPtr, u32 Wake);
+s32 Suspend_AddWake(Suspend *SuspendPtr, u32 IntId);
+void Suspend_SetDma(Suspend *SuspendPtr, XDmaPs *DmaPtr);
+s32 Suspend_Enter(Suspend *SuspendPtr);
+void Suspend_GetStats(const Suspend *SuspendPtr, Suspend_Stats *StatsPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SUSPEND_H */
@@ -0,0 +1,484 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file task_pool.c
+*
+* Work-stealing task pool over the two CPUs. Refer to task_pool.h for how
+* it is used.
+*
+* The deques follow Chase and Lev with the barriers of Le et al. for weak
+* memory: the owner publishes a task with a release store of the bottom,
+* takes one back by moving the bottom first and reading the top after a
+* dmb, and only races a thief for the last task, with the same
+* compare-and-swap of the top a thief uses. A thief copies the task before
+* its compare-and-swap; the owner never writes that slot before the top has
+* moved past it, as a push needs the bottom less than a whole deque above
+* the top it has read.
+*
+* The pending count of a group is decremented with an atomic that is a
+* full barrier, so that the results of a piece are seen before the waiter
+* sees it done.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Set up the AMP runtime with Amp_InitFromWrapper().
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xpseudo_asm.h"
+#include "xinterrupt_wrap.h"
+#include "xil_atomic.h"
+#include "amp.h"
+#include "task_pool.h"
+
+/************************** Constant Definitions ****************************/
+
+#define TASK_POOL_MASK		(TASK_POOL_DEQUE_SIZE - 1U)
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static void TaskPool_Cpu1Main(void *Arg);
+static u32 TaskPool_Push(TaskPool_Deque *DequePtr,
+			 const TaskPool_Task *TaskPtr);
+static u32 TaskPool_Pop(TaskPool_Deque *DequePtr, TaskPool_Task *TaskPtr);
+static u32 TaskPool_Steal(TaskPool_Deque *DequePtr, TaskPool_Task *TaskPtr);
+static u32 TaskPool_Find(TaskPool *PoolPtr, u32 Cpu, TaskPool_Task *TaskPtr);
+static void TaskPool_Queue(TaskPool *PoolPtr, TaskPool_Task *TaskPtr);
+static void TaskPool_Run(TaskPool *PoolPtr, u32 Cpu, TaskPool_Task *TaskPtr);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* Sets up an empty pool and starts CPU1 in its worker loop, with the AMP
+* runtime of amp.h set up if it is not yet.
+*
+* @param	PoolPtr is a pointer to the pool.
+*
+* @return
+*		- XST_SUCCESS if both CPUs take tasks.
+*		- XST_DEVICE_BUSY if CPU1 was already started.
+*		- The error of the AMP runtime otherwise.
+*		The pool runs on CPU0 alone after an error.
+*
+* @note		CPU1 can only be started once, so a pool shut down cannot
+*		be set up again on both CPUs.
+*
+*****************************************************************************/
+s32 TaskPool_Initialize(TaskPool *PoolPtr)
+{
+	s32 Status;
+
+	(void)memset(PoolPtr, 0, sizeof(*PoolPtr));
+	PoolPtr->NumCpus = 1U;
+	dmb();
+
+	Status = Amp_InitFromWrapper();
+	if (Status == XST_SUCCESS) {
+		Status = Amp_StartCpu1(TaskPool_Cpu1Main, PoolPtr);
+	}
+	if (Status == XST_SUCCESS) {
+		PoolPtr->NumCpus = TASK_POOL_NUM_CPUS;
+	}
+
+	return Status;
+}
+
+/****************************************************************************/
+/**
+*
+* Lets the worker of CPU1 return once it has no task left to run.
+*
+* @param	PoolPtr is a pointer to the pool.
+*
+* @return	None.
+*
+* @note		Wait for the groups first, the tasks still queued on CPU0
+*		are not run.
+*
+*****************************************************************************/
+void TaskPool_Shutdown(TaskPool *PoolPtr)
+{
+	PoolPtr->Quit = 1U;
+	dsb();
+	Xil_Sev();
+}
+
+/****************************************************************************/
+/**
+*
+* Sets up an empty group.
+*
+* @param	GroupPtr is a pointer to the group.
+*
+* @return	None.
+*
+*****************************************************************************/
+void TaskPool_GroupInit(TaskPool_Group *GroupPtr)
+{
+	GroupPtr->Pending = 0U;
+	dmb();
+}
+
+/****************************************************************************/
+/**
+*
+* Queues one call of a body on the deque of the calling CPU.
+*
+* @param	PoolPtr is a pointer to the pool.
+* @param	GroupPtr is the group the call is counted into.
+* @param	Fn is the body, called with Arg, 0 and 1.
+* @param	Arg is its argument.
+*
+* @return	None.
+*
+* @note		The body runs at once on the caller if the deque is full.
+*
+*****************************************************************************/
+void TaskPool_Spawn(TaskPool *PoolPtr, TaskPool_Group *GroupPtr,
+		    TaskPool_Fn Fn, void *Arg)
+{
+	TaskPool_Task Task;
+
+	Task.Fn = Fn;
+	Task.Arg = Arg;
+	Task.GroupPtr = GroupPtr;
+	Task.Begin = 0U;
+	Task.End = 1U;
+	Task.Grain = 1U;
+	TaskPool_Queue(PoolPtr, &Task);
+}
+
+/****************************************************************************/
+/**
+*
+* Queues a body over the indices Begin to End, End excluded, to be run in
+* ranges of Grain indices at most.
+*
+* @param	PoolPtr is a pointer to the pool.
+* @param	GroupPtr is the group the ranges are counted into.
+* @param	Begin is the first index.
+* @param	End is the index after the last one.
+* @param	Grain is the largest range a call is given, 0 for 1. A call
+*		should take a few microseconds at least to pay for its task.
+* @param	Fn is the body.
+* @param	Arg is its argument.
+*
+* @return	None.
+*
+* @note		Nothing is queued for an empty range.
+*
+*****************************************************************************/
+void TaskPool_ParallelFor(TaskPool *PoolPtr, TaskPool_Group *GroupPtr,
+			  u32 Begin, u32 End, u32 Grain, TaskPool_Fn Fn,
+			  void *Arg)
+{
+	TaskPool_Task Task;
+
+	if (Begin >= End) {
+		return;
+	}
+
+	Task.Fn = Fn;
+	Task.Arg = Arg;
+	Task.GroupPtr = GroupPtr;
+	Task.Begin = Begin;
+	Task.End = End;
+	Task.Grain = (Grain == 0U) ? 1U : Grain;
+	TaskPool_Queue(PoolPtr, &Task);
+}
+
+/****************************************************************************/
+/**
+*
+* Runs tasks until all the pieces of a group have run, the tasks of the
+* calling CPU first, then tasks stolen from the other one. Sleeps in WFE
+* when there is none.
+*
+* @param	PoolPtr is a pointer to the pool.
+* @param	GroupPtr is the group.
+*
+* @return	None.
+*
+* @note		The tasks run may belong to any group.
+*
+*****************************************************************************/
+void TaskPool_Wait(TaskPool *PoolPtr, TaskPool_Group *GroupPtr)
+{
+	u32 Cpu = Xil_CpuId();
+	TaskPool_Task Task;
+
+	while (Xil_AtomicLoadAcquire(&GroupPtr->Pending) != 0U) {
+		if (TaskPool_Find(PoolPtr, Cpu, &Task) != 0U) {
+			TaskPool_Run(PoolPtr, Cpu, &Task);
+		} else {
+			/* A completion after the load sends its SEV */
+			Xil_Wfe();
+		}
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Gives the counts of the tasks run by each CPU.
+*
+* @param	PoolPtr is a pointer to the pool.
+* @param	StatsPtr is where the counts are stored.
+*
+* @return	None.
+*
+*****************************************************************************/
+void TaskPool_GetStats(const TaskPool *PoolPtr, TaskPool_Stats *StatsPtr)
+{
+	u32 Cpu;
+
+	for (Cpu = 0U; Cpu < TASK_POOL_NUM_CPUS; Cpu++) {
+		StatsPtr->Executed[Cpu] = PoolPtr->Deques[Cpu].Executed;
+		StatsPtr->Stolen[Cpu] = PoolPtr->Deques[Cpu].Stolen;
+		StatsPtr->Inline[Cpu] = PoolPtr->Deques[Cpu].Inline;
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Main function of CPU1: runs and steals tasks until the pool is shut
+* down, sleeping in WFE when there is none.
+*
+* @param	Arg is a pointer to the pool.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void TaskPool_Cpu1Main(void *Arg)
+{
+	TaskPool *PoolPtr = (TaskPool *)Arg;
+	TaskPool_Task Task;
+
+	while (PoolPtr->Quit == 0U) {
+		if (TaskPool_Find(PoolPtr, 1U, &Task) != 0U) {
+			TaskPool_Run(PoolPtr, 1U, &Task);
+		} else {
+			Xil_Wfe();
+		}
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Pushes a task at the bottom of the deque of the calling CPU and wakes
+* the other CPU.
+*
+* @param	DequePtr is the deque, owned by the calling CPU.
+* @param	TaskPtr is the task, copied.
+*
+* @return	1 if the task is queued, 0 if the deque is full.
+*
+*****************************************************************************/
+static u32 TaskPool_Push(TaskPool_Deque *DequePtr,
+			 const TaskPool_Task *TaskPtr)
+{
+	u32 Bottom = DequePtr->Bottom;
+	u32 Top = Xil_AtomicLoadAcquire(&DequePtr->Top);
+
+	if ((Bottom - Top) >= TASK_POOL_DEQUE_SIZE) {
+		return 0U;
+	}
+
+	DequePtr->Tasks[Bottom & TASK_POOL_MASK] = *TaskPtr;
+	Xil_AtomicStoreRelease(&DequePtr->Bottom, Bottom + 1U);
+	dsb();
+	Xil_Sev();
+
+	return 1U;
+}
+
+/****************************************************************************/
+/*
+*
+* Pops the newest task from the bottom of the deque of the calling CPU.
+*
+* @param	DequePtr is the deque, owned by the calling CPU.
+* @param	TaskPtr is where the task is copied.
+*
+* @return	1 if a task was taken, 0 if the deque is empty or the other
+*		CPU stole its last task.
+*
+*****************************************************************************/
+static u32 TaskPool_Pop(TaskPool_Deque *DequePtr, TaskPool_Task *TaskPtr)
+{
+	u32 Bottom = DequePtr->Bottom - 1U;
+	u32 Top;
+	u32 Taken = 1U;
+
+	/* The bottom is moved before the top is read */
+	DequePtr->Bottom = Bottom;
+	dmb();
+	Top = DequePtr->Top;
+
+	if ((s32)(Bottom - Top) < 0) {
+		DequePtr->Bottom = Bottom + 1U;
+		return 0U;
+	}
+
+	*TaskPtr = DequePtr->Tasks[Bottom & TASK_POOL_MASK];
+	if (Bottom != Top) {
+		return 1U;
+	}
+
+	/* The last task, a thief may be taking it too */
+	if (Xil_AtomicCas(&DequePtr->Top, Top, Top + 1U) != Top) {
+		Taken = 0U;
+	}
+	DequePtr->Bottom = Bottom + 1U;
+
+	return Taken;
+}
+
+/****************************************************************************/
+/*
+*
+* Steals the oldest task from the top of the deque of the other CPU.
+*
+* @param	DequePtr is the deque of the other CPU.
+* @param	TaskPtr is where the task is copied.
+*
+* @return	1 if a task was taken, 0 if the deque is empty or the owner
+*		or a stealer took the task first.
+*
+*****************************************************************************/
+static u32 TaskPool_Steal(TaskPool_Deque *DequePtr, TaskPool_Task *TaskPtr)
+{
+	TaskPool_Task Task;
+	u32 Top = Xil_AtomicLoadAcquire(&DequePtr->Top);
+	u32 Bottom;
+
+	/* The top is read before the bottom */
+	dmb();
+	Bottom = Xil_AtomicLoadAcquire(&DequePtr->Bottom);
+	if ((s32)(Bottom - Top) <= 0) {
+		return 0U;
+	}
+
+	Task = DequePtr->Tasks[Top & TASK_POOL_MASK];
+	if (Xil_AtomicCas(&DequePtr->Top, Top, Top + 1U) != Top) {
+		return 0U;
+	}
+	*TaskPtr = Task;
+
+	return 1U;
+}
+
+/****************************************************************************/
+/*
+*
+* Finds a task for a CPU, on its own deque first, then on the other one.
+*
+* @param	PoolPtr is a pointer to the pool.
+* @param	Cpu is the calling CPU.
+* @param	TaskPtr is where the task is copied.
+*
+* @return	1 if a task was found, 0 otherwise.
+*
+*****************************************************************************/
+static u32 TaskPool_Find(TaskPool *PoolPtr, u32 Cpu, TaskPool_Task *TaskPtr)
+{
+	if (TaskPool_Pop(&PoolPtr->Deques[Cpu], TaskPtr) != 0U) {
+		return 1U;
+	}
+	if ((PoolPtr->NumCpus > 1U) &&
+	    (TaskPool_Steal(&PoolPtr->Deques[Cpu ^ 1U], TaskPtr) != 0U)) {
+		PoolPtr->Deques[Cpu].Stolen++;
+		return 1U;
+	}
+
+	return 0U;
+}
+
+/****************************************************************************/
+/*
+*
+* Counts a task into its group and queues it on the deque of the calling
+* CPU, or runs it at once if the deque is full.
+*
+* @param	PoolPtr is a pointer to the pool.
+* @param	TaskPtr is the task.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void TaskPool_Queue(TaskPool *PoolPtr, TaskPool_Task *TaskPtr)
+{
+	u32 Cpu = Xil_CpuId();
+
+	(void)Xil_AtomicAdd(&TaskPtr->GroupPtr->Pending, 1U);
+	if (TaskPool_Push(&PoolPtr->Deques[Cpu], TaskPtr) == 0U) {
+		PoolPtr->Deques[Cpu].Inline++;
+		TaskPool_Run(PoolPtr, Cpu, TaskPtr);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Runs a task: halves its range onto the deque of the CPU while it is
+* larger than its grain, runs the body over what is left, then counts the
+* piece done and wakes a waiter.
+*
+* @param	PoolPtr is a pointer to the pool.
+* @param	Cpu is the calling CPU.
+* @param	TaskPtr is the task, its range is changed.
+*
+* @return	None.
+*
+* @note		A full deque stops the halving, the body then gets the
+*		whole range left.
+*
+*****************************************************************************/
+static void TaskPool_Run(TaskPool *PoolPtr, u32 Cpu, TaskPool_Task *TaskPtr)
+{
+	TaskPool_Deque *DequePtr = &PoolPtr->Deques[Cpu];
+	TaskPool_Group *GroupPtr = TaskPtr->GroupPtr;
+	TaskPool_Task Half;
+
+	while ((TaskPtr->End - TaskPtr->Begin) > TaskPtr->Grain) {
+		Half = *TaskPtr;
+		Half.Begin = TaskPtr->Begin +
+			     ((TaskPtr->End - TaskPtr->Begin) / 2U);
+		(void)Xil_AtomicAdd(&GroupPtr->Pending, 1U);
+		if (TaskPool_Push(DequePtr, &Half) == 0U) {
+			(void)Xil_AtomicSub(&GroupPtr->Pending, 1U);
+			DequePtr->Inline++;
+			break;
+		}
+		TaskPtr->End = Half.Begin;
+	}
+
+	TaskPtr->Fn(TaskPtr->Arg, TaskPtr->Begin, TaskPtr->End);
+	DequePtr->Executed++;
+
+	(void)Xil_AtomicSub(&GroupPtr->Pending, 1U);
+	dsb();
+	Xil_Sev();
+}
@@ -0,0 +1,141 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file task_pool.h
+*
+* Work-stealing task pool over the two CPUs, for the CPU bound stages,
+* hashing, compression and frame parsing, that split into independent
+* pieces.
+*
+* Both CPUs run the one image of amp.h, CPU1 joined to the SCU coherency,
+* so that the tasks, their arguments and the pool are plain shared
+* memory. TaskPool_Initialize() starts CPU1 in the worker loop of the pool.
+* Each CPU owns a Chase-Lev deque of TASK_POOL_DEQUE_SIZE tasks: the owner
+* pushes and pops at the bottom without any atomic operation but on the
+* last task, and the other CPU steals from the top with one
+* compare-and-swap, so that a CPU takes the oldest, and the largest, piece
+* of the work of the other. A CPU with nothing to run or steal sleeps in
+* WFE; every push and every completion is followed by SEV.
+*
+* TaskPool_Spawn() queues one call, TaskPool_ParallelFor() runs a body over
+* a range of indices in pieces of up to a grain, the range being halved
+* on the deque of the CPU that runs it until it is no larger than a grain,
+* so that the other CPU steals halves and only a few steals balance the
+* work. Both count the pieces into a group, and TaskPool_Wait() runs tasks,
+* its own and stolen ones, until the pieces of the group have all run. A
+* task may itself spawn into any group and wait for it.
+*
+* The pool is used from thread level only, the deque of a CPU must not be
+* pushed by its interrupt handlers. A deque that is full runs the task at
+* once on the caller. If CPU1 cannot be started the pool still runs,
+* everything on CPU0.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions ****************************/
+
+#define TASK_POOL_NUM_CPUS	2U	/**< Cortex-A9 cores */
+#define TASK_POOL_DEQUE_SIZE	256U	/**< Per deque, a power of 2 */
+#define TASK_POOL_LINE		32U	/**< Cache line of an index */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Body of a task, called with the indices Begin to End, End excluded.
+ * TaskPool_Spawn() calls it with 0 and 1.
+ */
+typedef void (*TaskPool_Fn)(void *Arg, u32 Begin, u32 End);
+
+/**
+ * Pieces of work to wait for.
+ */
+typedef struct {
+	volatile u32 Pending;	/**< Pieces not yet run */
+} TaskPool_Group;
+
+/**
+ * A task, a range of a body.
+ */
+typedef struct {
+	TaskPool_Fn Fn;
+	void *Arg;
+	TaskPool_Group *GroupPtr;
+	u32 Begin;
+	u32 End;
+	u32 Grain;		/**< Largest range run without a split */
+} TaskPool_Task;
+
+/**
+ * Deque of a CPU. The top is moved by both CPUs, the bottom by the owner
+ * only; both are free running positions, each on its own cache line.
+ */
+typedef struct {
+	volatile u32 Top;
+	u8 TopPad[TASK_POOL_LINE - 4U];
+	volatile u32 Bottom;
+	u32 Executed;		/**< Tasks run by the owner */
+	u32 Stolen;		/**< Of them, taken from the other CPU */
+	u32 Inline;		/**< Of them, run at once on a full deque */
+	u8 BottomPad[TASK_POOL_LINE - 16U];
+	TaskPool_Task Tasks[TASK_POOL_DEQUE_SIZE];
+} __attribute__((aligned(TASK_POOL_LINE))) TaskPool_Deque;
+
+/**
+ * The pool.
+ */
+typedef struct {
+	TaskPool_Deque Deques[TASK_POOL_NUM_CPUS];
+	volatile u32 Quit;	/**< The worker of CPU1 returns when set */
+	u32 NumCpus;		/**< CPUs taking tasks, 1 without CPU1 */
+} TaskPool;
+
+/**
+ * Counts of a pool, per CPU.
+ */
+typedef struct {
+	u32 Executed[TASK_POOL_NUM_CPUS];
+	u32 Stolen[TASK_POOL_NUM_CPUS];
+	u32 Inline[TASK_POOL_NUM_CPUS];
+} TaskPool_Stats;
+
+/************************** Function Prototypes *****************************/
+
+s32 TaskPool_Initialize(TaskPool *PoolPtr);
+void TaskPool_Shutdown(TaskPool *PoolPtr);
+void TaskPool_GroupInit(TaskPool_Group *GroupPtr);
+void TaskPool_Spawn(TaskPool *PoolPtr, TaskPool_Group *GroupPtr,
+		    TaskPool_Fn Fn, void *Arg);
+void TaskPool_ParallelFor(TaskPool *PoolPtr, TaskPool_Group *GroupPtr,
+			  u32 Begin, u32 End, u32 Grain, TaskPool_Fn Fn,
+			  void *Arg);
+void TaskPool_Wait(TaskPool *PoolPtr, TaskPool_Group *GroupPtr);
+void TaskPool_GetStats(const TaskPool *PoolPtr, TaskPool_Stats *StatsPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TASK_POOL_H */
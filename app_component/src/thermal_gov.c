@@ -0,0 +1,560 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file thermal_gov.c
+*
+* Thermal governor. Refer to thermal_gov.h for the levels and how they are
+* switched.
+*
+* The alarm thresholds, the alarm enables and the sequencer are written
+* through the command FIFO, which the stream owns while it runs: they are
+* only changed between two bursts.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xinterrupt_wrap.h"
+#include "thermal_gov.h"
+#include "drvcfg.h"
+
+/************************** Constant Definitions ****************************/
+
+#if (THERMAL_GOV_HOT_C - THERMAL_GOV_HYST_C) <= THERMAL_GOV_WARM_C
+#error "The hot level must be left above the temperature of the warm one"
+#endif
+
+/* Channels of a burst, the temperature first */
+#define THERMAL_GOV_CHANNELS	(XADCPS_SEQ_CH_TEMP | XADCPS_SEQ_CH_VCCINT)
+
+/* Alarm interrupts of the governor */
+#define THERMAL_GOV_ALARMS	(XADCPS_INTX_ALM0_MASK | XADCPS_INTX_OT_MASK)
+
+/* Active high level, as the device tree gives the other PS interrupts */
+#define THERMAL_GOV_TRIGGER	4U
+
+#define THERMAL_GOV_PERIOD_COUNTS \
+	(((XTime)COUNTS_PER_SECOND / 1000U) * THERMAL_GOV_PERIOD_MS)
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static void ThermalGov_IntrHandler(void *CallBackRef);
+static void ThermalGov_StreamHandler(void *CallBackRef,
+				     const XAdcPs_StreamBlock *BlockPtr);
+static void ThermalGov_StartBurst(ThermalGov *GovPtr, XTime Now);
+static void ThermalGov_Evaluate(ThermalGov *GovPtr);
+static void ThermalGov_Step(ThermalGov *GovPtr, u32 Level);
+static void ThermalGov_Arm(ThermalGov *GovPtr);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* Sets up the XADC for the governor, takes the coalescing of the bridge as
+* that of the cool level and connects the XADC interrupt. The governor
+* starts in the cool level, the clock profile left as it is.
+*
+* @param	GovPtr is a pointer to the governor.
+* @param	ClockPtr is the clock profiles to switch, or NULL.
+* @param	BridgePtr is the bridge to coalesce, or NULL.
+*
+* @return
+*		- XST_SUCCESS if the governor runs.
+*		- XST_FAILURE if the XADC is not found or its interrupt could
+*		  not be connected.
+*		- The error of the failing driver call otherwise.
+*
+* @note		Call it after Bridge_SetCoalesce(), if any, for the cool
+*		level to keep it.
+*
+*****************************************************************************/
+s32 ThermalGov_Initialize(ThermalGov *GovPtr, ClkProfile *ClockPtr,
+			  Bridge *BridgePtr)
+{
+	XAdcPs *AdcPtr = &GovPtr->Adc;
+	XAdcPs_Config *CfgPtr;
+	Bridge_Dir *DirPtr;
+	u32 IntrId;
+	u32 Level;
+	u32 Dir;
+	u32 MaxBytes;
+	u32 MaxUs;
+	s32 Status;
+
+	GovPtr->ClockPtr = ClockPtr;
+	GovPtr->BridgePtr = BridgePtr;
+	GovPtr->Level = THERMAL_GOV_LEVEL_COOL;
+	GovPtr->Alarms = 0U;
+	GovPtr->Passes = 0U;
+	GovPtr->Stats.Level = THERMAL_GOV_LEVEL_COOL;
+	GovPtr->Stats.Bursts = 0U;
+	GovPtr->Stats.Alarms = 0U;
+	GovPtr->Stats.Steps = 0U;
+	GovPtr->Stats.MilliC = 0;
+	GovPtr->Stats.MaxMilliC = 0;
+	GovPtr->Stats.VccIntMv = 0U;
+	GovPtr->IsReady = 0U;
+
+	GovPtr->EnterRaw[THERMAL_GOV_LEVEL_COOL] = 0U;
+	GovPtr->LeaveRaw[THERMAL_GOV_LEVEL_COOL] = 0U;
+	GovPtr->EnterRaw[THERMAL_GOV_LEVEL_WARM] =
+		(u16)XAdcPs_TemperatureToRaw((float)THERMAL_GOV_WARM_C);
+	GovPtr->LeaveRaw[THERMAL_GOV_LEVEL_WARM] =
+		(u16)XAdcPs_TemperatureToRaw((float)(THERMAL_GOV_WARM_C -
+						     THERMAL_GOV_HYST_C));
+	GovPtr->EnterRaw[THERMAL_GOV_LEVEL_HOT] =
+		(u16)XAdcPs_TemperatureToRaw((float)THERMAL_GOV_HOT_C);
+	GovPtr->LeaveRaw[THERMAL_GOV_LEVEL_HOT] =
+		(u16)XAdcPs_TemperatureToRaw((float)(THERMAL_GOV_HOT_C -
+						     THERMAL_GOV_HYST_C));
+
+	/* Each level up doubles the threshold and the deadline */
+	for (Dir = 0U; Dir < BRIDGE_NUM_DIRS; Dir++) {
+		MaxBytes = BRIDGE_BD_SIZE;
+		MaxUs = 0U;
+		if (BridgePtr != NULL) {
+			DirPtr = &BridgePtr->Dir[Dir];
+			MaxBytes = DirPtr->FillLength;
+			MaxUs = DirPtr->DeadlineUs;
+		}
+		for (Level = 0U; Level < THERMAL_GOV_NUM_LEVELS; Level++) {
+			GovPtr->Coalesce[Level][Dir].MaxBytes = MaxBytes;
+			GovPtr->Coalesce[Level][Dir].MaxUs = MaxUs;
+			MaxBytes = (MaxBytes * 2U > BRIDGE_BD_SIZE) ?
+				   BRIDGE_BD_SIZE : MaxBytes * 2U;
+			if ((BridgePtr != NULL) && (BridgePtr->WheelPtr != NULL)) {
+				MaxUs = (MaxUs == 0U) ? BRIDGE_LATENCY_US :
+					MaxUs * 2U;
+			}
+		}
+	}
+
+	CfgPtr = XAdcPs_LookupConfigStatic(XPAR_XXADCPS_0_BASEADDR);
+	if (CfgPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	Status = XAdcPs_CfgInitialize(AdcPtr, CfgPtr, CfgPtr->BaseAddress);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	XAdcPs_IntrDisable(AdcPtr, XADCPS_INTX_ALL_MASK);
+	XAdcPs_IntrClear(AdcPtr, XADCPS_INTX_ALL_MASK);
+
+	/* The temperature keeps being converted between bursts, for the alarm */
+	XAdcPs_SetSequencerMode(AdcPtr, XADCPS_SEQ_MODE_SAFE);
+	Status = XAdcPs_SetSeqChEnables(AdcPtr, THERMAL_GOV_CHANNELS);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+	XAdcPs_SetAlarmEnables(AdcPtr, XAdcPs_GetAlarmEnables(AdcPtr) |
+			       XADCPS_CFR1_ALM_TEMP_MASK);
+	XAdcPs_SetSequencerMode(AdcPtr, XADCPS_SEQ_MODE_CONTINPASS);
+
+	Status = XAdcPs_StreamInitialize(&GovPtr->Stream, AdcPtr, GovPtr->Ring,
+					 THERMAL_GOV_SAMPLES);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+	XAdcPs_StreamSetHandler(&GovPtr->Stream, ThermalGov_StreamHandler,
+				GovPtr);
+
+	(void)XGetEncodedIntrId(XPAR_XADCPS_INT_ID, THERMAL_GOV_TRIGGER, XSPI,
+				XINTC_TYPE_IS_SCUGIC, &IntrId);
+	Status = XSetupInterruptSystem(GovPtr, &ThermalGov_IntrHandler, IntrId,
+				       XPAR_XSCUGIC_0_BASEADDR,
+				       XINTERRUPT_DEFAULT_PRIORITY);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	ThermalGov_Arm(GovPtr);
+	XTime_GetTime(&GovPtr->NextBurst);
+	GovPtr->IsReady = 1U;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Sets the coalescing of a direction of the bridge in a level, applied at
+* once if the governor is in that level.
+*
+* @param	GovPtr is a pointer to the governor.
+* @param	Level is the level, THERMAL_GOV_LEVEL_COOL to
+*		THERMAL_GOV_LEVEL_HOT.
+* @param	Dir is BRIDGE_DIR_HOST_TO_UART or BRIDGE_DIR_UART_TO_HOST.
+* @param	MaxBytes is the size threshold, 1 to BRIDGE_BD_SIZE.
+* @param	MaxUs is the deadline in microseconds, or 0.
+*
+* @return
+*		- XST_SUCCESS if the coalescing is set.
+*		- XST_INVALID_PARAM for a bad level, direction or threshold.
+*		- The error of Bridge_SetCoalesce() when applied.
+*
+* @note		From the main loop, as ThermalGov_Poll().
+*
+*****************************************************************************/
+s32 ThermalGov_SetCoalesce(ThermalGov *GovPtr, u32 Level, u32 Dir,
+			   u32 MaxBytes, u32 MaxUs)
+{
+	if ((Level >= THERMAL_GOV_NUM_LEVELS) || (Dir >= BRIDGE_NUM_DIRS) ||
+	    (MaxBytes == 0U) || (MaxBytes > BRIDGE_BD_SIZE)) {
+		return XST_INVALID_PARAM;
+	}
+
+	GovPtr->Coalesce[Level][Dir].MaxBytes = MaxBytes;
+	GovPtr->Coalesce[Level][Dir].MaxUs = MaxUs;
+
+	if ((Level == GovPtr->Level) && (GovPtr->BridgePtr != NULL)) {
+		return Bridge_SetCoalesce(GovPtr->BridgePtr, Dir, MaxBytes,
+					  MaxUs);
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Runs the governor: steps up on an alarm, averages a finished burst and
+* starts the next one when it is due.
+*
+* @param	GovPtr is a pointer to the governor.
+*
+* @return	None.
+*
+* @note		From the main loop of CPU0, not from an interrupt handler.
+*		It returns at once while a burst runs.
+*
+*****************************************************************************/
+void ThermalGov_Poll(ThermalGov *GovPtr)
+{
+	XTime Now;
+	u32 Alarms;
+	u32 Level;
+	u32 Cpsr;
+
+	if (GovPtr->IsReady == 0U) {
+		return;
+	}
+
+	XTime_GetTime(&Now);
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+	Alarms = GovPtr->Alarms;
+	GovPtr->Alarms = 0U;
+	if (Alarms != 0U) {
+		/* The burst would keep the command FIFO from the thresholds */
+		XAdcPs_StreamStop(&GovPtr->Stream);
+	}
+	mtcpsr(Cpsr);
+
+	if (Alarms != 0U) {
+		GovPtr->Stats.Alarms++;
+		Level = GovPtr->Level;
+		if ((Alarms & XADCPS_INTX_OT_MASK) != 0U) {
+			Level = THERMAL_GOV_LEVEL_HOT;
+		} else if (Level < THERMAL_GOV_LEVEL_HOT) {
+			Level++;
+		}
+		ThermalGov_Step(GovPtr, Level);
+
+		/* A burst confirms the level at once */
+		ThermalGov_StartBurst(GovPtr, Now);
+		return;
+	}
+
+	if (GovPtr->Stream.Running != 0U) {
+		return;
+	}
+	if (GovPtr->Passes >= THERMAL_GOV_SAMPLES) {
+		ThermalGov_Evaluate(GovPtr);
+		GovPtr->Passes = 0U;
+	}
+	if (Now >= GovPtr->NextBurst) {
+		ThermalGov_StartBurst(GovPtr, Now);
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the current level.
+*
+* @param	GovPtr is a pointer to the governor.
+*
+* @return	The level.
+*
+*****************************************************************************/
+u32 ThermalGov_GetLevel(const ThermalGov *GovPtr)
+{
+	return GovPtr->Level;
+}
+
+/****************************************************************************/
+/**
+*
+* Copies the statistics of the governor.
+*
+* @param	GovPtr is a pointer to the governor.
+* @param	StatsPtr receives the statistics.
+*
+* @return	None.
+*
+*****************************************************************************/
+void ThermalGov_GetStats(const ThermalGov *GovPtr, ThermalGov_Stats *StatsPtr)
+{
+	*StatsPtr = GovPtr->Stats;
+}
+
+/****************************************************************************/
+/*
+*
+* Interrupt handler of the XADC. Takes the alarms for ThermalGov_Poll(),
+* masking them until they are armed again, and passes the rest to the
+* stream.
+*
+* @param	CallBackRef is a pointer to the governor.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void ThermalGov_IntrHandler(void *CallBackRef)
+{
+	ThermalGov *GovPtr = (ThermalGov *)CallBackRef;
+	XAdcPs *AdcPtr = &GovPtr->Adc;
+	u32 Status;
+
+	Status = XAdcPs_IntrGetStatus(AdcPtr) & XAdcPs_IntrGetEnabled(AdcPtr) &
+		 THERMAL_GOV_ALARMS;
+	if (Status != 0U) {
+		/* The alarms stay set while the temperature is above them */
+		XAdcPs_IntrDisable(AdcPtr, Status);
+		XAdcPs_IntrClear(AdcPtr, Status);
+		GovPtr->Alarms |= Status;
+	}
+
+	XAdcPs_StreamIntrHandler(&GovPtr->Stream);
+}
+
+/****************************************************************************/
+/*
+*
+* Called by the stream for each pass, ends the burst after
+* THERMAL_GOV_SAMPLES of them.
+*
+* @param	CallBackRef is a pointer to the governor.
+* @param	BlockPtr is the pass, read later from the ring.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void ThermalGov_StreamHandler(void *CallBackRef,
+				     const XAdcPs_StreamBlock *BlockPtr)
+{
+	ThermalGov *GovPtr = (ThermalGov *)CallBackRef;
+
+	(void)BlockPtr;
+
+	GovPtr->Passes++;
+	if (GovPtr->Passes >= THERMAL_GOV_SAMPLES) {
+		XAdcPs_StreamStop(&GovPtr->Stream);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Starts a burst, dropping the passes of a burst cut short.
+*
+* @param	GovPtr is a pointer to the governor.
+* @param	Now is the current time.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void ThermalGov_StartBurst(ThermalGov *GovPtr, XTime Now)
+{
+	XAdcPs_StreamBlock Block;
+
+	while (XAdcPs_StreamRead(&GovPtr->Stream, &Block, 1U) != 0U) {
+		;
+	}
+	GovPtr->Passes = 0U;
+	GovPtr->NextBurst = Now + THERMAL_GOV_PERIOD_COUNTS;
+
+	(void)XAdcPs_StreamStart(&GovPtr->Stream, THERMAL_GOV_CHANNELS);
+}
+
+/****************************************************************************/
+/*
+*
+* Averages the passes of a burst and steps to the level of the average.
+*
+* @param	GovPtr is a pointer to the governor.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void ThermalGov_Evaluate(ThermalGov *GovPtr)
+{
+	XAdcPs_StreamBlock Block;
+	u32 TempIndex = 0U;
+	u32 VccIndex = 0U;
+	u32 TempSum = 0U;
+	u32 VccSum = 0U;
+	u32 Count = 0U;
+	u32 Index;
+	u32 Temp;
+	u32 Level;
+
+	for (Index = 0U; Index < GovPtr->Stream.NumChannels; Index++) {
+		if (GovPtr->Stream.Channel[Index] == XADCPS_CH_TEMP) {
+			TempIndex = Index;
+		} else if (GovPtr->Stream.Channel[Index] == XADCPS_CH_VCCINT) {
+			VccIndex = Index;
+		} else {
+			;
+		}
+	}
+
+	while (XAdcPs_StreamRead(&GovPtr->Stream, &Block, 1U) != 0U) {
+		TempSum += Block.Data[TempIndex];
+		VccSum += Block.Data[VccIndex];
+		Count++;
+	}
+	if (Count == 0U) {
+		return;
+	}
+	Temp = TempSum / Count;
+
+	/* 503.975 K and 3 V full scale, over 16 bits */
+	GovPtr->Stats.Bursts++;
+	GovPtr->Stats.MilliC = (s32)(((u64)Temp * 503975U) >> 16U) - 273150;
+	GovPtr->Stats.VccIntMv = ((VccSum / Count) * 3000U) >> 16U;
+	if ((GovPtr->Stats.Bursts == 1U) ||
+	    (GovPtr->Stats.MilliC > GovPtr->Stats.MaxMilliC)) {
+		GovPtr->Stats.MaxMilliC = GovPtr->Stats.MilliC;
+	}
+
+	Level = GovPtr->Level;
+	while (((Level + 1U) < THERMAL_GOV_NUM_LEVELS) &&
+	       (Temp >= GovPtr->EnterRaw[Level + 1U])) {
+		Level++;
+	}
+	while ((Level > THERMAL_GOV_LEVEL_COOL) &&
+	       (Temp < GovPtr->LeaveRaw[Level])) {
+		Level--;
+	}
+
+	if (Level != GovPtr->Level) {
+		ThermalGov_Step(GovPtr, Level);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Switches the clock profile and the coalescing of a level and arms the
+* alarms for it.
+*
+* @param	GovPtr is a pointer to the governor.
+* @param	Level is the level.
+*
+* @return	None.
+*
+* @note		Not while a burst runs.
+*
+*****************************************************************************/
+static void ThermalGov_Step(ThermalGov *GovPtr, u32 Level)
+{
+	Bridge *BridgePtr = GovPtr->BridgePtr;
+	u32 Dir;
+
+	if (Level != GovPtr->Level) {
+		if (GovPtr->ClockPtr != NULL) {
+			(void)ClkProfile_Set(GovPtr->ClockPtr,
+					     CLK_PROFILE_PERFORMANCE + Level);
+		}
+		if (BridgePtr != NULL) {
+			/* The directions received from USB do not coalesce */
+			for (Dir = 0U; Dir < BridgePtr->NumDirs; Dir++) {
+				(void)Bridge_SetCoalesce(BridgePtr, Dir,
+					GovPtr->Coalesce[Level][Dir].MaxBytes,
+					GovPtr->Coalesce[Level][Dir].MaxUs);
+			}
+		}
+		GovPtr->Level = Level;
+		GovPtr->Stats.Level = Level;
+		GovPtr->Stats.Steps++;
+	}
+
+	ThermalGov_Arm(GovPtr);
+}
+
+/****************************************************************************/
+/*
+*
+* Arms the temperature alarm for the next level up, its lower threshold at
+* the temperature that level is left at, and the over temperature alarm
+* below the hot level.
+*
+* @param	GovPtr is a pointer to the governor.
+*
+* @return	None.
+*
+* @note		Not while a burst runs.
+*
+*****************************************************************************/
+static void ThermalGov_Arm(ThermalGov *GovPtr)
+{
+	XAdcPs *AdcPtr = &GovPtr->Adc;
+	u32 Next = GovPtr->Level + 1U;
+	u32 Mask = 0U;
+	u32 Cpsr;
+
+	if (Next < THERMAL_GOV_NUM_LEVELS) {
+		XAdcPs_SetAlarmThreshold(AdcPtr, XADCPS_ATR_TEMP_UPPER,
+					 GovPtr->EnterRaw[Next]);
+		XAdcPs_SetAlarmThreshold(AdcPtr, XADCPS_ATR_TEMP_LOWER,
+					 GovPtr->LeaveRaw[Next]);
+		Mask |= XADCPS_INTX_ALM0_MASK;
+	}
+	if (GovPtr->Level < THERMAL_GOV_LEVEL_HOT) {
+		Mask |= XADCPS_INTX_OT_MASK;
+	}
+
+	/* An alarm of the old thresholds is stale */
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+	XAdcPs_IntrDisable(AdcPtr, THERMAL_GOV_ALARMS);
+	XAdcPs_IntrClear(AdcPtr, THERMAL_GOV_ALARMS);
+	GovPtr->Alarms = 0U;
+	XAdcPs_IntrEnable(AdcPtr, Mask);
+	mtcpsr(Cpsr);
+}
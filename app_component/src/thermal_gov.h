@@ -0,0 +1,161 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file thermal_gov.h
+*
+* Thermal governor: slows the CPU clock and batches the bridge harder as
+* the die heats up, instead of running into the over temperature reset.
+*
+* The governor has three levels, each with the clock profile of the same
+* rank in clk_profile.h and its own coalescing of the bridge:
+*
+* - THERMAL_GOV_LEVEL_COOL, the performance profile and the coalescing the
+*   bridge had when the governor was initialized.
+* - THERMAL_GOV_LEVEL_WARM, from THERMAL_GOV_WARM_C degrees, the balanced
+*   profile and twice the threshold and deadline.
+* - THERMAL_GOV_LEVEL_HOT, from THERMAL_GOV_HOT_C degrees, the efficiency
+*   profile and four times them.
+*
+* The thresholds stop at BRIDGE_BD_SIZE, and a direction without a deadline
+* gets BRIDGE_LATENCY_US in the warm level when the bridge has a timer
+* wheel. Fewer, larger descriptors take fewer interrupts from the slowed
+* CPU. ThermalGov_SetCoalesce() changes them per level.
+*
+* A level is left THERMAL_GOV_HYST_C degrees below the temperature it was
+* entered at, so that the temperature settling on a threshold does not
+* switch the clock back and forth.
+*
+* Every THERMAL_GOV_PERIOD_MS the temperature and VCCINT are sampled in a
+* burst of THERMAL_GOV_SAMPLES passes of the XADC stream, stopped from its
+* handler, and the average decides the level. Between the bursts the
+* sequencer keeps converting the temperature for the alarm of the XADC,
+* armed for the next level up: its interrupt wakes the governor at once on
+* a sudden rise, and the over temperature alarm sends it to the hot level
+* directly. The levels are switched by ThermalGov_Poll(), from the main
+* loop, since ClkProfile_Set() is not for interrupt handlers.
+*
+* @code
+*	(void)ClkProfile_Initialize(&Clock);
+*	(void)ThermalGov_Initialize(&Gov, &Clock, &UsbBridge);
+*	while (1) {
+*		ThermalGov_Poll(&Gov);
+*		...
+*	}
+* @endcode
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef THERMAL_GOV_H
+#define THERMAL_GOV_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xiltimer.h"
+#include "xadcps.h"
+#include "clk_profile.h"
+#include "usb_to_uart.h"
+
+/************************** Constant Definitions ****************************/
+
+/** @name Levels
+ * @{
+ */
+#define THERMAL_GOV_LEVEL_COOL	0U
+#define THERMAL_GOV_LEVEL_WARM	1U
+#define THERMAL_GOV_LEVEL_HOT	2U
+#define THERMAL_GOV_NUM_LEVELS	3U
+/* @} */
+
+/*
+ * The XC7Z020-1 of the Arty Z7 is a commercial grade part, rated to a
+ * junction temperature of 85 degrees.
+ */
+#ifndef THERMAL_GOV_WARM_C
+#define THERMAL_GOV_WARM_C	70	/**< Degrees entering the warm level */
+#endif
+#ifndef THERMAL_GOV_HOT_C
+#define THERMAL_GOV_HOT_C	80	/**< Degrees entering the hot level */
+#endif
+#ifndef THERMAL_GOV_HYST_C
+#define THERMAL_GOV_HYST_C	5	/**< Degrees below to leave a level */
+#endif
+#ifndef THERMAL_GOV_PERIOD_MS
+#define THERMAL_GOV_PERIOD_MS	250U	/**< Time between two bursts */
+#endif
+#define THERMAL_GOV_SAMPLES	8U	/**< Passes averaged per burst */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Coalescing of a direction of the bridge, refer to Bridge_SetCoalesce().
+ */
+typedef struct {
+	u32 MaxBytes;
+	u32 MaxUs;
+} ThermalGov_Coalesce;
+
+/**
+ * Statistics of the governor.
+ */
+typedef struct {
+	u32 Level;		/**< Current level */
+	u32 Bursts;		/**< Bursts averaged */
+	u32 Alarms;		/**< Alarm interrupts handled */
+	u32 Steps;		/**< Level changes */
+	s32 MilliC;		/**< Temperature of the last burst */
+	s32 MaxMilliC;		/**< Hottest burst */
+	u32 VccIntMv;		/**< VCCINT of the last burst */
+} ThermalGov_Stats;
+
+/**
+ * The governor.
+ */
+typedef struct {
+	XAdcPs Adc;
+	XAdcPs_Stream Stream;
+	XAdcPs_StreamBlock Ring[THERMAL_GOV_SAMPLES];
+	ClkProfile *ClockPtr;	/**< Profiles switched, or NULL */
+	Bridge *BridgePtr;	/**< Bridge coalesced, or NULL */
+	ThermalGov_Coalesce Coalesce[THERMAL_GOV_NUM_LEVELS][BRIDGE_NUM_DIRS];
+	u16 EnterRaw[THERMAL_GOV_NUM_LEVELS]; /**< Raw temperature of entry */
+	u16 LeaveRaw[THERMAL_GOV_NUM_LEVELS]; /**< Raw temperature of exit */
+	u32 Level;
+	volatile u32 Alarms;	/**< XADCPS_INTX_* raised, for the poll */
+	volatile u32 Passes;	/**< Passes stored in the burst */
+	XTime NextBurst;
+	ThermalGov_Stats Stats;
+	u32 IsReady;
+} ThermalGov;
+
+/************************** Function Prototypes *****************************/
+
+s32 ThermalGov_Initialize(ThermalGov *GovPtr, ClkProfile *ClockPtr,
+			  Bridge *BridgePtr);
+s32 ThermalGov_SetCoalesce(ThermalGov *GovPtr, u32 Level, u32 Dir,
+			   u32 MaxBytes, u32 MaxUs);
+void ThermalGov_Poll(ThermalGov *GovPtr);
+u32 ThermalGov_GetLevel(const ThermalGov *GovPtr);
+void ThermalGov_GetStats(const ThermalGov *GovPtr, ThermalGov_Stats *StatsPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* THERMAL_GOV_H */
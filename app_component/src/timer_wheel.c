@@ -0,0 +1,554 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file timer_wheel.c
+*
+* Tickless timer wheel. Refer to timer_wheel.h for how it is used.
+*
+* Level L covers 64^(L+1) ticks in slots of 64^L ticks. A timer due within
+* 64^(L+1) ticks of the current tick goes into level L, in the slot of bits
+* 6L and up of its deadline. At a tick that is a multiple of 64^L the slot
+* of that tick in level L is emptied and its timers are inserted again,
+* which puts them in a lower level, until they reach level 0 where a slot
+* holds the timers of a single tick.
+*
+* The wheel does not step over every tick. The next event is found from
+* the occupied slot bitmaps: for level 0 the first occupied slot from the
+* current tick, for the higher levels the first multiple of their slot
+* size whose slot is occupied. The wheel jumps to it when the private
+* timer fires, and the timer is loaded for the event after.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Load the private timer for a divided CPU clock
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xinterrupt_wrap.h"
+#include "timer_wheel.h"
+#include "drvcfg.h"
+
+/************************** Constant Definitions ****************************/
+
+#define TIMER_WHEEL_NEVER	0xFFFFFFFFFFFFFFFFULL
+#define TIMER_WHEEL_SLOT_MASK	(TIMER_WHEEL_SLOTS - 1U)
+/* List of the timers whose handlers are being called */
+#define TIMER_WHEEL_EXPIRING	(TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS)
+/* Farthest deadline the wheel holds, in ticks */
+#define TIMER_WHEEL_MAX_DELTA \
+	((1ULL << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOT_BITS)) - 1U)
+/* Longest load of the private timer, it reloads on the way */
+#define TIMER_WHEEL_MAX_LOAD	0xFFFFFFFFULL
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define TIMER_WHEEL_LEVEL_SHIFT(Level)	((Level) * TIMER_WHEEL_SLOT_BITS)
+
+/************************** Function Prototypes *****************************/
+
+static void TimerWheel_Link(TimerWheel *WheelPtr, TimerWheel_Timer *TimerPtr);
+static void TimerWheel_Unlink(TimerWheel *WheelPtr,
+			      TimerWheel_Timer *TimerPtr);
+static TimerWheel_Timer *TimerWheel_Take(TimerWheel *WheelPtr, u32 Slot);
+static u64 TimerWheel_NextEvent(const TimerWheel *WheelPtr);
+static void TimerWheel_Arm(TimerWheel *WheelPtr, u64 Tick, XTime Now);
+static void TimerWheel_InterruptHandler(void *CallBackRef);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* Sets up the private timer of the calling CPU in one-shot mode and
+* connects its interrupt.
+*
+* @param	WheelPtr is a pointer to the wheel.
+*
+* @return
+*		- XST_SUCCESS if the wheel is ready.
+*		- XST_FAILURE if the timer or its interrupt could not be set
+*		up.
+*
+* @note		Call it on the CPU the wheel is for.
+*
+*****************************************************************************/
+s32 TimerWheel_Initialize(TimerWheel *WheelPtr)
+{
+	XScuTimer_Config *CfgPtr;
+	XTime Now;
+	u32 Index;
+	s32 Status;
+
+	for (Index = 0U; Index <= TIMER_WHEEL_EXPIRING; Index++) {
+		WheelPtr->Slot[Index] = NULL;
+	}
+	for (Index = 0U; Index < TIMER_WHEEL_LEVELS; Index++) {
+		WheelPtr->Occupied[Index] = 0U;
+	}
+	XTime_GetTime(&Now);
+	WheelPtr->Current = Now >> TIMER_WHEEL_SHIFT;
+	WheelPtr->Armed = TIMER_WHEEL_NEVER;
+	WheelPtr->NumPending = 0U;
+	WheelPtr->Expired = 0U;
+
+	CfgPtr = XScuTimer_LookupConfigStatic(XPAR_XSCUTIMER_0_BASEADDR);
+	if (CfgPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	Status = XScuTimer_CfgInitialize(&WheelPtr->Timer, CfgPtr,
+					 CfgPtr->BaseAddr);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	/* Count the peripheral clock, as the global timer does */
+	XScuTimer_Stop(&WheelPtr->Timer);
+	XScuTimer_SetPrescaler(&WheelPtr->Timer, 0U);
+	XScuTimer_DisableAutoReload(&WheelPtr->Timer);
+	XScuTimer_ClearInterruptStatus(&WheelPtr->Timer);
+
+	Status = XSetupInterruptSystem(WheelPtr, &TimerWheel_InterruptHandler,
+				       CfgPtr->IntrId, CfgPtr->IntrParent,
+				       XINTERRUPT_DEFAULT_PRIORITY);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	XScuTimer_EnableInterrupt(&WheelPtr->Timer);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Sets up a timer, not pending.
+*
+* @param	TimerPtr is a pointer to the timer.
+* @param	Handler is called when the timer expires.
+* @param	CallBackRef is passed to Handler.
+*
+* @return	None.
+*
+*****************************************************************************/
+void TimerWheel_InitTimer(TimerWheel_Timer *TimerPtr,
+			  TimerWheel_Handler Handler, void *CallBackRef)
+{
+	TimerPtr->Next = NULL;
+	TimerPtr->Prev = NULL;
+	TimerPtr->Expires = 0U;
+	TimerPtr->Slot = 0U;
+	TimerPtr->Pending = 0U;
+	TimerPtr->Handler = Handler;
+	TimerPtr->CallBackRef = CallBackRef;
+}
+
+/****************************************************************************/
+/**
+*
+* Starts a timer for a deadline. A pending timer is moved to the new
+* deadline.
+*
+* @param	WheelPtr is a pointer to the wheel.
+* @param	TimerPtr is a pointer to the timer.
+* @param	Deadline is the time of XTime_GetTime() the timer expires
+*		at. It expires within a tick after it, or at once from the
+*		interrupt if it is already past.
+*
+* @return	None.
+*
+* @note		Can be called from any context of the CPU of the wheel.
+*
+*****************************************************************************/
+void TimerWheel_StartAt(TimerWheel *WheelPtr, TimerWheel_Timer *TimerPtr,
+			XTime Deadline)
+{
+	XTime Now;
+	u32 Cpsr;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+
+	if (TimerPtr->Pending != 0U) {
+		TimerWheel_Unlink(WheelPtr, TimerPtr);
+	}
+
+	XTime_GetTime(&Now);
+	if (WheelPtr->NumPending == 0U) {
+		/* Nothing to move down, the wheel can start afresh */
+		WheelPtr->Current = Now >> TIMER_WHEEL_SHIFT;
+	}
+
+	/* Never early: rounded up to the next tick */
+	TimerPtr->Expires = (Deadline + ((1ULL << TIMER_WHEEL_SHIFT) - 1U)) >>
+			    TIMER_WHEEL_SHIFT;
+	if (TimerPtr->Expires < WheelPtr->Current) {
+		TimerPtr->Expires = WheelPtr->Current;
+	}
+	TimerWheel_Link(WheelPtr, TimerPtr);
+
+	if (TimerPtr->Expires < WheelPtr->Armed) {
+		TimerWheel_Arm(WheelPtr, TimerPtr->Expires, Now);
+	}
+
+	mtcpsr(Cpsr);
+}
+
+/****************************************************************************/
+/**
+*
+* Starts a timer for a delay from now.
+*
+* @param	WheelPtr is a pointer to the wheel.
+* @param	TimerPtr is a pointer to the timer.
+* @param	Us is the delay, in microseconds.
+*
+* @return	None.
+*
+*****************************************************************************/
+void TimerWheel_Start(TimerWheel *WheelPtr, TimerWheel_Timer *TimerPtr,
+		      u64 Us)
+{
+	XTime Now;
+
+	XTime_GetTime(&Now);
+	TimerWheel_StartAt(WheelPtr, TimerPtr,
+			   Now + ((Us * COUNTS_PER_SECOND) / 1000000U));
+}
+
+/****************************************************************************/
+/**
+*
+* Cancels a timer. Nothing is done if it is not pending.
+*
+* @param	WheelPtr is a pointer to the wheel.
+* @param	TimerPtr is a pointer to the timer.
+*
+* @return	None.
+*
+* @note		The private timer stays loaded, its interrupt then finds
+*		nothing to do and loads it for the next event.
+*
+*****************************************************************************/
+void TimerWheel_Cancel(TimerWheel *WheelPtr, TimerWheel_Timer *TimerPtr)
+{
+	u32 Cpsr;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+	if (TimerPtr->Pending != 0U) {
+		TimerWheel_Unlink(WheelPtr, TimerPtr);
+	}
+	mtcpsr(Cpsr);
+}
+
+/****************************************************************************/
+/**
+*
+* Tells whether a timer is pending.
+*
+* @param	TimerPtr is a pointer to the timer.
+*
+* @return	1 if it is pending, 0 if it expired or was cancelled.
+*
+*****************************************************************************/
+u32 TimerWheel_IsPending(const TimerWheel_Timer *TimerPtr)
+{
+	return TimerPtr->Pending;
+}
+
+/****************************************************************************/
+/**
+*
+* Puts a timer into the slot of its deadline, from the current tick.
+*
+* @param	WheelPtr is a pointer to the wheel.
+* @param	TimerPtr is a pointer to the timer, not pending.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void TimerWheel_Link(TimerWheel *WheelPtr, TimerWheel_Timer *TimerPtr)
+{
+	u64 Expires = TimerPtr->Expires;
+	u64 Delta = Expires - WheelPtr->Current;
+	u32 Level;
+	u32 Index;
+
+	if (Delta > TIMER_WHEEL_MAX_DELTA) {
+		/* Waits in the farthest slot, to be inserted again */
+		Expires = WheelPtr->Current + TIMER_WHEEL_MAX_DELTA;
+		Delta = TIMER_WHEEL_MAX_DELTA;
+	}
+
+	for (Level = 0U; Level < (TIMER_WHEEL_LEVELS - 1U); Level++) {
+		if (Delta < (1ULL << TIMER_WHEEL_LEVEL_SHIFT(Level + 1U))) {
+			break;
+		}
+	}
+
+	Index = (u32)(Expires >> TIMER_WHEEL_LEVEL_SHIFT(Level)) &
+		TIMER_WHEEL_SLOT_MASK;
+	TimerPtr->Slot = (Level * TIMER_WHEEL_SLOTS) + Index;
+
+	TimerPtr->Prev = NULL;
+	TimerPtr->Next = WheelPtr->Slot[TimerPtr->Slot];
+	if (TimerPtr->Next != NULL) {
+		TimerPtr->Next->Prev = TimerPtr;
+	}
+	WheelPtr->Slot[TimerPtr->Slot] = TimerPtr;
+	WheelPtr->Occupied[Level] |= 1ULL << Index;
+
+	TimerPtr->Pending = 1U;
+	WheelPtr->NumPending++;
+}
+
+/****************************************************************************/
+/**
+*
+* Takes a timer out of its slot.
+*
+* @param	WheelPtr is a pointer to the wheel.
+* @param	TimerPtr is a pointer to the timer, pending.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void TimerWheel_Unlink(TimerWheel *WheelPtr, TimerWheel_Timer *TimerPtr)
+{
+	if (TimerPtr->Prev != NULL) {
+		TimerPtr->Prev->Next = TimerPtr->Next;
+	} else {
+		WheelPtr->Slot[TimerPtr->Slot] = TimerPtr->Next;
+		if ((TimerPtr->Next == NULL) &&
+		    (TimerPtr->Slot != TIMER_WHEEL_EXPIRING)) {
+			WheelPtr->Occupied[TimerPtr->Slot /
+					   TIMER_WHEEL_SLOTS] &=
+				~(1ULL << (TimerPtr->Slot & TIMER_WHEEL_SLOT_MASK));
+		}
+	}
+	if (TimerPtr->Next != NULL) {
+		TimerPtr->Next->Prev = TimerPtr->Prev;
+	}
+
+	TimerPtr->Pending = 0U;
+	WheelPtr->NumPending--;
+}
+
+/****************************************************************************/
+/**
+*
+* Empties a slot.
+*
+* @param	WheelPtr is a pointer to the wheel.
+* @param	Slot is the level * 64 + slot.
+*
+* @return	The timers of the slot, linked by Next, all marked not
+*		pending.
+*
+*****************************************************************************/
+static TimerWheel_Timer *TimerWheel_Take(TimerWheel *WheelPtr, u32 Slot)
+{
+	TimerWheel_Timer *ListPtr = WheelPtr->Slot[Slot];
+	TimerWheel_Timer *TimerPtr;
+
+	WheelPtr->Slot[Slot] = NULL;
+	WheelPtr->Occupied[Slot / TIMER_WHEEL_SLOTS] &=
+		~(1ULL << (Slot & TIMER_WHEEL_SLOT_MASK));
+
+	for (TimerPtr = ListPtr; TimerPtr != NULL; TimerPtr = TimerPtr->Next) {
+		TimerPtr->Pending = 0U;
+		WheelPtr->NumPending--;
+	}
+
+	return ListPtr;
+}
+
+/****************************************************************************/
+/**
+*
+* Finds the next tick, from the current one, at which a timer expires or a
+* slot is moved down.
+*
+* @param	WheelPtr is a pointer to the wheel.
+*
+* @return	The tick, or all ones if the wheel is empty.
+*
+*****************************************************************************/
+static u64 TimerWheel_NextEvent(const TimerWheel *WheelPtr)
+{
+	u64 Next = TIMER_WHEEL_NEVER;
+	u64 Base;
+	u64 Map;
+	u64 Tick;
+	u32 Shift;
+	u32 Pos;
+	u32 Level;
+
+	for (Level = 0U; Level < TIMER_WHEEL_LEVELS; Level++) {
+		Map = WheelPtr->Occupied[Level];
+		if (Map == 0U) {
+			continue;
+		}
+
+		/* First slot boundary of the level from the current tick */
+		Shift = TIMER_WHEEL_LEVEL_SHIFT(Level);
+		Base = (WheelPtr->Current + ((1ULL << Shift) - 1U)) >> Shift;
+		Pos = (u32)Base & TIMER_WHEEL_SLOT_MASK;
+
+		/* First occupied slot from there, round the level */
+		if (Pos != 0U) {
+			Map = (Map >> Pos) | (Map << (TIMER_WHEEL_SLOTS - Pos));
+		}
+		Tick = (Base + (u64)__builtin_ctzll(Map)) << Shift;
+		if (Tick < Next) {
+			Next = Tick;
+		}
+	}
+
+	return Next;
+}
+
+/****************************************************************************/
+/**
+*
+* Loads the private timer for a tick.
+*
+* @param	WheelPtr is a pointer to the wheel.
+* @param	Tick is the tick, all ones to stop the timer.
+* @param	Now is the current time.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void TimerWheel_Arm(TimerWheel *WheelPtr, u64 Tick, XTime Now)
+{
+	XTime When;
+	u64 Load;
+	u32 Scale;
+
+	XScuTimer_Stop(&WheelPtr->Timer);
+	XScuTimer_ClearInterruptStatus(&WheelPtr->Timer);
+	WheelPtr->Armed = Tick;
+	if (Tick == TIMER_WHEEL_NEVER) {
+		return;
+	}
+
+	When = Tick << TIMER_WHEEL_SHIFT;
+	Load = (When > Now) ? (When - Now) : 1U;
+	/* The private timer is not scaled like the time, see XTime_SetScale() */
+	Scale = XTime_GetScale();
+	if (Scale > 1U) {
+		Load = (Load + Scale - 1U) / Scale;
+	}
+	if (Load > TIMER_WHEEL_MAX_LOAD) {
+		Load = TIMER_WHEEL_MAX_LOAD;
+	}
+
+	XScuTimer_LoadTimer(&WheelPtr->Timer, (u32)Load);
+	XScuTimer_Start(&WheelPtr->Timer);
+}
+
+/****************************************************************************/
+/**
+*
+* Handler of the private timer interrupt. Moves the wheel up to the current
+* tick, calling the handlers of the timers that expired, and loads the
+* timer for the next event.
+*
+* @param	CallBackRef is a pointer to the wheel.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void TimerWheel_InterruptHandler(void *CallBackRef)
+{
+	TimerWheel *WheelPtr = (TimerWheel *)CallBackRef;
+	TimerWheel_Timer *ListPtr;
+	TimerWheel_Timer *TimerPtr;
+	XTime Now;
+	u64 NowTick;
+	u64 Tick;
+	u32 Level;
+	u32 Slot;
+	u32 Cpsr;
+
+	/* A nested interrupt may start timers too */
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+
+	XScuTimer_ClearInterruptStatus(&WheelPtr->Timer);
+	XTime_GetTime(&Now);
+	NowTick = Now >> TIMER_WHEEL_SHIFT;
+
+	while ((Tick = TimerWheel_NextEvent(WheelPtr)) <= NowTick) {
+		WheelPtr->Current = Tick;
+
+		/* Move down the slots of this tick, from the top level */
+		for (Level = TIMER_WHEEL_LEVELS - 1U; Level > 0U; Level--) {
+			if ((Tick & ((1ULL << TIMER_WHEEL_LEVEL_SHIFT(Level)) -
+				     1U)) != 0U) {
+				continue;
+			}
+			ListPtr = TimerWheel_Take(WheelPtr,
+				(Level * TIMER_WHEEL_SLOTS) +
+				((u32)(Tick >> TIMER_WHEEL_LEVEL_SHIFT(Level)) &
+				 TIMER_WHEEL_SLOT_MASK));
+			while (ListPtr != NULL) {
+				TimerPtr = ListPtr;
+				ListPtr = ListPtr->Next;
+				TimerWheel_Link(WheelPtr, TimerPtr);
+			}
+		}
+
+		/*
+		 * Expire level 0 of this tick, through the expiring list so
+		 * that the handlers may cancel and start any timer. The tick
+		 * is over for them, a timer started again lands in a later
+		 * one.
+		 */
+		Slot = (u32)Tick & TIMER_WHEEL_SLOT_MASK;
+		WheelPtr->Slot[TIMER_WHEEL_EXPIRING] = WheelPtr->Slot[Slot];
+		WheelPtr->Slot[Slot] = NULL;
+		WheelPtr->Occupied[0] &= ~(1ULL << Slot);
+		for (TimerPtr = WheelPtr->Slot[TIMER_WHEEL_EXPIRING];
+		     TimerPtr != NULL; TimerPtr = TimerPtr->Next) {
+			TimerPtr->Slot = TIMER_WHEEL_EXPIRING;
+		}
+		WheelPtr->Current = Tick + 1U;
+
+		while ((TimerPtr = WheelPtr->Slot[TIMER_WHEEL_EXPIRING]) !=
+		       NULL) {
+			TimerWheel_Unlink(WheelPtr, TimerPtr);
+			WheelPtr->Expired++;
+			TimerPtr->Handler(TimerPtr->CallBackRef);
+		}
+	}
+
+	if (WheelPtr->Current <= NowTick) {
+		WheelPtr->Current = NowTick + 1U;
+	}
+
+	XTime_GetTime(&Now);
+	TimerWheel_Arm(WheelPtr, TimerWheel_NextEvent(WheelPtr), Now);
+
+	mtcpsr(Cpsr);
+}
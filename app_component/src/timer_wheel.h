@@ -0,0 +1,110 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file timer_wheel.h
+*
+* Tickless software timers on the SCU private timer.
+*
+* Any number of timers, each a TimerWheel_Timer of the caller, are kept in a
+* hierarchical wheel of TIMER_WHEEL_LEVELS levels of 64 slots. A timer goes
+* into the slot of the level its deadline falls in and is moved down a
+* level when the wheel reaches that slot, so that starting and cancelling a
+* timer are O(1) and each timer is moved at most once per level. A tick of
+* the wheel is 2^TIMER_WHEEL_SHIFT counts of the global timer, 1.5 us, and
+* the wheel reaches about 27 minutes; later deadlines wait in the last slot.
+*
+* There is no periodic tick: the private timer runs in one-shot mode,
+* loaded with the time to the next event of the wheel, a deadline or a move
+* down, and interrupts only then. The private timer and the global timer of
+* XTime_GetTime() both count the peripheral clock, so deadlines are given
+* in XTime counts.
+*
+* The handlers of the timers are called from the timer interrupt, with the
+* IRQ masked; they may start and cancel timers, their own included. The
+* private timer is per CPU, so is the wheel.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xiltimer.h"
+#include "xscutimer.h"
+
+/************************** Constant Definitions ****************************/
+
+#define TIMER_WHEEL_LEVELS	5U	/**< Levels of the wheel */
+#define TIMER_WHEEL_SLOT_BITS	6U	/**< 64 slots per level */
+#define TIMER_WHEEL_SLOTS	(1U << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_SHIFT	9U	/**< XTime counts per tick, log2 */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Called from the timer interrupt when a timer expires.
+ */
+typedef void (*TimerWheel_Handler)(void *CallBackRef);
+
+/**
+ * A timer. Owned by the caller and linked into the wheel while pending.
+ */
+typedef struct TimerWheel_Timer {
+	struct TimerWheel_Timer *Next;
+	struct TimerWheel_Timer *Prev;
+	u64 Expires;		/**< Deadline, in ticks */
+	u32 Slot;		/**< Level * 64 + slot while pending */
+	u32 Pending;
+	TimerWheel_Handler Handler;
+	void *CallBackRef;
+} TimerWheel_Timer;
+
+/**
+ * A wheel.
+ */
+typedef struct {
+	XScuTimer Timer;	/**< Private timer, one-shot */
+	/* The slots, then the timers expiring in the interrupt */
+	TimerWheel_Timer *Slot[(TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS) + 1U];
+	u64 Occupied[TIMER_WHEEL_LEVELS]; /**< Slots holding timers */
+	u64 Current;		/**< Next tick to handle */
+	u64 Armed;		/**< Tick the private timer is loaded for */
+	u32 NumPending;
+	u32 Expired;		/**< Handlers called */
+} TimerWheel;
+
+/************************** Function Prototypes *****************************/
+
+s32 TimerWheel_Initialize(TimerWheel *WheelPtr);
+void TimerWheel_InitTimer(TimerWheel_Timer *TimerPtr,
+			  TimerWheel_Handler Handler, void *CallBackRef);
+void TimerWheel_StartAt(TimerWheel *WheelPtr, TimerWheel_Timer *TimerPtr,
+			XTime Deadline);
+void TimerWheel_Start(TimerWheel *WheelPtr, TimerWheel_Timer *TimerPtr,
+		      u64 Us);
+void TimerWheel_Cancel(TimerWheel *WheelPtr, TimerWheel_Timer *TimerPtr);
+u32 TimerWheel_IsPending(const TimerWheel_Timer *TimerPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TIMER_WHEEL_H */
@@ -0,0 +1,770 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file uart_bench.c
+*
+* Throughput and latency benchmark of the XUartPs driver modes. Refer to
+* uart_bench.h for what is measured and how.
+*
+* Each run starts from a freshly initialized driver instance, so that no
+* setting of an earlier run, such as the RX trigger level left by the DMA
+* mode, changes the numbers of a later one.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Transfer buffers taken from the DMA arena.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "xil_printf.h"
+#include "xiltimer.h"
+#include "xinterrupt_wrap.h"
+#include "xpm_counter.h"
+#include "xil_dmaarena.h"
+#include "xil_hotpath.h"
+#include "uart_bench.h"
+#include "drvcfg.h"
+
+/************************** Constant Definitions ****************************/
+
+#define UART_BENCH_CALIB_ITERS	4096U	/* Idle loop calibration length */
+#define UART_BENCH_SLACK_MS	100U	/* Added to the transfer deadline */
+
+#define UART_BENCH_RX_IXR	(XUARTPS_IXR_RXOVR | XUARTPS_IXR_RXFULL | \
+				 XUARTPS_IXR_TOUT | XUARTPS_IXR_OVER | \
+				 XUARTPS_IXR_FRAMING | XUARTPS_IXR_PARITY)
+
+#if defined (XPAR_XDMAPS_NUM_INSTANCES)
+#define UART_BENCH_DMA_TX_CHANNEL	0U
+#define UART_BENCH_DMA_RX_CHANNEL	1U
+#endif
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/* Timer ticks to nanoseconds */
+#define UartBench_TicksToNs(Ticks) \
+	((u32)(((u64)(Ticks) * 1000000000U) / (u64)COUNTS_PER_SECOND))
+
+/************************** Function Prototypes *****************************/
+
+static s32 UartBench_Setup(UartBench *BenchPtr, u32 BaudRate, u32 Mode);
+static void UartBench_Restore(UartBench *BenchPtr);
+static s32 UartBench_Transfer(UartBench *BenchPtr, u32 NumBytes,
+			      u32 *CyclesPtr, XTime *TicksPtr);
+static void UartBench_Calibrate(UartBench *BenchPtr);
+static u32 UartBench_Wait(UartBench *BenchPtr, XTime Deadline, u32 Limit);
+static u32 UartBench_IsDone(UartBench *BenchPtr);
+static u32 UartBench_ReadCycles(UartBench *BenchPtr);
+static void UartBench_Handler(void *CallBackRef, u32 Event, u32 EventData);
+
+/************************** Variable Definitions ****************************/
+
+extern XUartPs_Config XUartPs_ConfigTable[];
+
+/* The rates of the built-in divisor table of the driver */
+static const u32 UartBench_Rates[UART_BENCH_NUM_RATES] = {
+	1200U, 2400U, 4800U, 9600U, 19200U, 38400U, 57600U, 115200U,
+	230400U, 460800U, 500000U, 576000U, 921600U, 1000000U, 1152000U,
+	1500000U, 2000000U, 2500000U, 3000000U, 3500000U, 4000000U
+};
+
+static const char *UartBench_ModeNames[UART_BENCH_NUM_MODES] = {
+	"polled", "intr", "ring", "dma"
+};
+
+/*
+ * Fallback DMA buffers, cache line aligned as the RX one is invalidated,
+ * used when the DMA arena is not mapped
+ */
+static u8 UartBench_TxStatic[UART_BENCH_MAX_BYTES]
+	__attribute__ ((aligned(32))) XIL_NOINIT;
+static u8 UartBench_RxStatic[UART_BENCH_MAX_BYTES]
+	__attribute__ ((aligned(32))) XIL_NOINIT;
+static Xil_DmaPool UartBench_BufPool;
+static u8 *UartBench_TxBuf = UartBench_TxStatic;
+static u8 *UartBench_RxBuf = UartBench_RxStatic;
+static u8 UartBench_RxRing[UART_BENCH_MAX_BYTES] XIL_NOINIT;
+static u8 UartBench_TxRing[UART_BENCH_MAX_BYTES] XIL_NOINIT;
+
+/****************************************************************************/
+/**
+*
+* Initializes the benchmark: the UART driver, its interrupt, the DMA
+* controller if there is one, and a PMU event counter counting CPU cycles.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return
+*		- XST_SUCCESS if the benchmark is ready.
+*		- XST_FAILURE if no PMU event counter is free.
+*		- The error of the failing driver call otherwise.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 UartBench_Initialize(UartBench *BenchPtr)
+{
+	XUartPs_Config *CfgPtr = &XUartPs_ConfigTable[0];
+	s32 Status;
+#if defined (XPAR_XDMAPS_NUM_INSTANCES)
+	XDmaPs_Config *DmaCfgPtr;
+#endif
+
+	BenchPtr->CfgPtr = CfgPtr;
+	BenchPtr->Mode = UART_BENCH_MODE_POLLED;
+
+	Status = XUartPs_CfgInitialize(&BenchPtr->Uart, CfgPtr,
+				       CfgPtr->BaseAddress);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	Status = XSetupInterruptSystem(&BenchPtr->Uart,
+				       &XUartPs_InterruptHandler,
+				       CfgPtr->IntrId, CfgPtr->IntrParent,
+				       XINTERRUPT_DEFAULT_PRIORITY);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+#if defined (XPAR_XDMAPS_NUM_INSTANCES)
+	DmaCfgPtr = XDmaPs_LookupConfigStatic(XPAR_XDMAPS_0_BASEADDR);
+	if (DmaCfgPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	Status = XDmaPs_CfgInitialize(&BenchPtr->Dma, DmaCfgPtr,
+				      DmaCfgPtr->BaseAddress);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	/* IntrId[0] is the fault interrupt, IntrId[1 + N] the one of channel N */
+	Status = XConnectToInterruptCntrl(DmaCfgPtr->IntrId[0],
+					  &XDmaPs_FaultISR, &BenchPtr->Dma,
+					  DmaCfgPtr->IntrParent);
+	Status |= XConnectToInterruptCntrl(
+			DmaCfgPtr->IntrId[1U + UART_BENCH_DMA_TX_CHANNEL],
+			&XDmaPs_DoneISR_0, &BenchPtr->Dma, DmaCfgPtr->IntrParent);
+	Status |= XConnectToInterruptCntrl(
+			DmaCfgPtr->IntrId[1U + UART_BENCH_DMA_RX_CHANNEL],
+			&XDmaPs_DoneISR_1, &BenchPtr->Dma, DmaCfgPtr->IntrParent);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	XEnableIntrId(DmaCfgPtr->IntrId[0], DmaCfgPtr->IntrParent);
+	XEnableIntrId(DmaCfgPtr->IntrId[1U + UART_BENCH_DMA_TX_CHANNEL],
+		      DmaCfgPtr->IntrParent);
+	XEnableIntrId(DmaCfgPtr->IntrId[1U + UART_BENCH_DMA_RX_CHANNEL],
+		      DmaCfgPtr->IntrParent);
+#endif
+
+	/* Non-cacheable buffers spare the DMA mode its cache maintenance */
+	if ((UartBench_TxBuf == UartBench_TxStatic) &&
+	    (Xil_DmaPoolCreate(&UartBench_BufPool, UART_BENCH_MAX_BYTES,
+			       2U) == XST_SUCCESS)) {
+		UartBench_TxBuf = (u8 *)Xil_DmaPoolAlloc(&UartBench_BufPool);
+		UartBench_RxBuf = (u8 *)Xil_DmaPoolAlloc(&UartBench_BufPool);
+	}
+
+	BenchPtr->CycleCounter = Xpm_SetUpAnEvent(XPM_EVENT_CLOCKCYCLES);
+	if (BenchPtr->CycleCounter == XPM_NO_COUNTERS_AVAILABLE) {
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Runs one mode at one baud rate: a throughput transfer of UART_BENCH_RUN_MS
+* worth of data, then UART_BENCH_LAT_SAMPLES single byte round trips.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	BaudRate is the line rate.
+* @param	Mode is one of the UART_BENCH_MODE_* values.
+* @param	ResultPtr is where the result is stored.
+*
+* @return
+*		- XST_SUCCESS if the run completed.
+*		- XST_NO_FEATURE if the mode is not available in this design.
+*		- XST_UART_BAUD_ERROR if the rate cannot be generated.
+*		- XST_FAILURE if a transfer timed out or the data came back
+*		corrupted.
+*
+* @note		The UART is left in local loopback.
+*
+*****************************************************************************/
+s32 UartBench_Run(UartBench *BenchPtr, u32 BaudRate, u32 Mode,
+		  UartBench_Result *ResultPtr)
+{
+	u32 NumBytes;
+	u32 Cycles;
+	XTime Ticks;
+	u32 Sample;
+	u32 Index;
+	u32 Key;
+	s32 Status;
+
+	(void)memset(ResultPtr, 0, sizeof(UartBench_Result));
+	ResultPtr->BaudRate = BaudRate;
+	ResultPtr->Mode = Mode;
+
+	/* UART_BENCH_RUN_MS of line time at 10 bits per character */
+	NumBytes = (u32)(((u64)BaudRate * UART_BENCH_RUN_MS) / 10000U);
+	if (NumBytes < UART_BENCH_MIN_BYTES) {
+		NumBytes = UART_BENCH_MIN_BYTES;
+	} else if (NumBytes > UART_BENCH_MAX_BYTES) {
+		NumBytes = UART_BENCH_MAX_BYTES;
+	} else {
+		/* Else with dummy entry for MISRA-C Compliance.*/
+		;
+	}
+	ResultPtr->Bytes = NumBytes;
+
+	Status = UartBench_Setup(BenchPtr, BaudRate, Mode);
+	if (Status != XST_SUCCESS) {
+		ResultPtr->Status = Status;
+		return Status;
+	}
+
+	for (Index = 0U; Index < NumBytes; Index++) {
+		UartBench_TxBuf[Index] = (u8)((Index * 7U) + (BaudRate >> 8));
+	}
+
+	Status = UartBench_Transfer(BenchPtr, NumBytes, &Cycles, &Ticks);
+	if ((Status == XST_SUCCESS) &&
+	    (memcmp(UartBench_TxBuf, UartBench_RxBuf, NumBytes) != 0)) {
+		Status = XST_FAILURE;
+	}
+	if (Status != XST_SUCCESS) {
+		ResultPtr->Status = Status;
+		return Status;
+	}
+
+	if (Ticks != 0U) {
+		ResultPtr->BytesPerSec = (u32)(((u64)NumBytes *
+						COUNTS_PER_SECOND) / Ticks);
+	}
+	ResultPtr->CyclesPerByte = Cycles / NumBytes;
+
+	for (Sample = 0U; Sample < UART_BENCH_LAT_SAMPLES; Sample++) {
+		Status = UartBench_Transfer(BenchPtr, 1U, &Cycles, &Ticks);
+		if (Status != XST_SUCCESS) {
+			ResultPtr->Status = Status;
+			return Status;
+		}
+
+		/* Insertion sort, the samples are few */
+		Key = (u32)Ticks;
+		Index = Sample;
+		while ((Index > 0U) && (BenchPtr->Samples[Index - 1U] > Key)) {
+			BenchPtr->Samples[Index] = BenchPtr->Samples[Index - 1U];
+			Index--;
+		}
+		BenchPtr->Samples[Index] = Key;
+	}
+
+	ResultPtr->LatMinNs = UartBench_TicksToNs(BenchPtr->Samples[0]);
+	ResultPtr->LatP50Ns = UartBench_TicksToNs(
+			BenchPtr->Samples[UART_BENCH_LAT_SAMPLES / 2U]);
+	ResultPtr->LatP99Ns = UartBench_TicksToNs(
+			BenchPtr->Samples[(UART_BENCH_LAT_SAMPLES * 99U) / 100U]);
+	ResultPtr->LatMaxNs = UartBench_TicksToNs(
+			BenchPtr->Samples[UART_BENCH_LAT_SAMPLES - 1U]);
+	ResultPtr->Status = XST_SUCCESS;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Runs every mode at every baud rate of the suite, then restores the UART to
+* the default rate in normal mode.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	ResultsPtr is where the results are stored.
+* @param	MaxResults is the number of results ResultsPtr can hold,
+*		UART_BENCH_MAX_RESULTS for the full suite.
+*
+* @return	The number of results stored, including failed runs.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 UartBench_RunAll(UartBench *BenchPtr, UartBench_Result *ResultsPtr,
+		     u32 MaxResults)
+{
+	u32 NumResults = 0U;
+	u32 Rate;
+	u32 Mode;
+
+	for (Rate = 0U; Rate < UART_BENCH_NUM_RATES; Rate++) {
+		for (Mode = 0U; Mode < UART_BENCH_NUM_MODES; Mode++) {
+			if (NumResults >= MaxResults) {
+				break;
+			}
+			(void)UartBench_Run(BenchPtr, UartBench_Rates[Rate], Mode,
+					    &ResultsPtr[NumResults]);
+			NumResults++;
+		}
+	}
+
+	UartBench_Restore(BenchPtr);
+
+	return NumResults;
+}
+
+/****************************************************************************/
+/**
+*
+* Prints the results as a table on the standard output.
+*
+* @param	ResultsPtr is the results of UartBench_RunAll().
+* @param	NumResults is the number of results.
+*
+* @return	None.
+*
+* @note		The standard output must not be the UART under test while a
+*		run is in progress.
+*
+*****************************************************************************/
+void UartBench_Report(const UartBench_Result *ResultsPtr, u32 NumResults)
+{
+	const UartBench_Result *ResultPtr;
+	u32 Index;
+
+	xil_printf("baud\tmode\tbytes/s\tcyc/B\tlat min/p50/p99/max ns\r\n");
+
+	for (Index = 0U; Index < NumResults; Index++) {
+		ResultPtr = &ResultsPtr[Index];
+
+		if (ResultPtr->Status != XST_SUCCESS) {
+			xil_printf("%u\t%s\tfailed (%d)\r\n", ResultPtr->BaudRate,
+				   UartBench_ModeNames[ResultPtr->Mode],
+				   ResultPtr->Status);
+			continue;
+		}
+
+		xil_printf("%u\t%s\t%u\t%u\t%u/%u/%u/%u\r\n",
+			   ResultPtr->BaudRate,
+			   UartBench_ModeNames[ResultPtr->Mode],
+			   ResultPtr->BytesPerSec, ResultPtr->CyclesPerByte,
+			   ResultPtr->LatMinNs, ResultPtr->LatP50Ns,
+			   ResultPtr->LatP99Ns, ResultPtr->LatMaxNs);
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Holds the UART in remote loopback, so that a host connected to it can
+* measure the echo throughput and latency of the line, then restores it to
+* the default rate in normal mode.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	BaudRate is the line rate.
+* @param	Seconds is how long the UART echoes.
+*
+* @return
+*		- XST_SUCCESS once the echo window is over.
+*		- XST_UART_BAUD_ERROR if the rate cannot be generated.
+*
+* @note		The standard output must not be the UART under test.
+*
+*****************************************************************************/
+s32 UartBench_RemoteEcho(UartBench *BenchPtr, u32 BaudRate, u32 Seconds)
+{
+	XTime Start;
+	XTime Now;
+	s32 Status;
+
+	Status = UartBench_Setup(BenchPtr, BaudRate, UART_BENCH_MODE_POLLED);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+	XUartPs_SetOperMode(&BenchPtr->Uart, XUARTPS_OPER_MODE_REMOTE_LOOP);
+
+	XTime_GetTime(&Start);
+	do {
+		XTime_GetTime(&Now);
+	} while ((Now - Start) < ((XTime)Seconds * COUNTS_PER_SECOND));
+
+	UartBench_Restore(BenchPtr);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Reinitializes the driver instance for a run and puts the UART in local
+* loopback.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	BaudRate is the line rate.
+* @param	Mode is one of the UART_BENCH_MODE_* values.
+*
+* @return	XST_SUCCESS, or the error of the failing driver call.
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 UartBench_Setup(UartBench *BenchPtr, u32 BaudRate, u32 Mode)
+{
+	XUartPs *UartPtr = &BenchPtr->Uart;
+	XUartPs_Config *CfgPtr = BenchPtr->CfgPtr;
+	s32 Status;
+
+	if (UartPtr->RingMode != 0U) {
+		XUartPs_DisableRingMode(UartPtr);
+	}
+
+	BenchPtr->Mode = Mode;
+
+	Status = XUartPs_CfgInitialize(UartPtr, CfgPtr, CfgPtr->BaseAddress);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	Status = XUartPs_SetBaudRate(UartPtr, BaudRate);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	XUartPs_SetOperMode(UartPtr, XUARTPS_OPER_MODE_LOCAL_LOOP);
+	XUartPs_SetHandler(UartPtr, UartBench_Handler, BenchPtr);
+
+	/* The UART interrupt goes to the handler of the mode */
+	if (Mode == UART_BENCH_MODE_DMA) {
+#if defined (XPAR_XDMAPS_NUM_INSTANCES)
+		Status = XUartPs_DmaInitialize(&BenchPtr->UartDma, UartPtr,
+					       &BenchPtr->Dma,
+					       UART_BENCH_DMA_TX_CHANNEL,
+					       UART_BENCH_DMA_RX_CHANNEL);
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+		XUartPs_DmaSetHandler(&BenchPtr->UartDma, UartBench_Handler,
+				      BenchPtr);
+		Status = XConnectToInterruptCntrl(CfgPtr->IntrId,
+						  &XUartPs_DmaInterruptHandler,
+						  &BenchPtr->UartDma,
+						  CfgPtr->IntrParent);
+#else
+		Status = XST_NO_FEATURE;
+#endif
+	} else {
+		Status = XConnectToInterruptCntrl(CfgPtr->IntrId,
+						  &XUartPs_InterruptHandler,
+						  UartPtr, CfgPtr->IntrParent);
+	}
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	if (Mode == UART_BENCH_MODE_INTR) {
+		XUartPs_SetInterruptMask(UartPtr, UART_BENCH_RX_IXR);
+	} else if (Mode == UART_BENCH_MODE_RING) {
+		Status = XUartPs_EnableRingMode(UartPtr, UartBench_RxRing,
+						UART_BENCH_MAX_BYTES,
+						UartBench_TxRing,
+						UART_BENCH_MAX_BYTES);
+	} else {
+		/* Else with dummy entry for MISRA-C Compliance.*/
+		;
+	}
+
+	return Status;
+}
+
+/****************************************************************************/
+/*
+*
+* Puts the UART back at the default rate in normal mode with its interrupts
+* disabled.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartBench_Restore(UartBench *BenchPtr)
+{
+	XUartPs *UartPtr = &BenchPtr->Uart;
+
+	if (UartPtr->RingMode != 0U) {
+		XUartPs_DisableRingMode(UartPtr);
+	}
+
+	(void)XUartPs_CfgInitialize(UartPtr, BenchPtr->CfgPtr,
+				    BenchPtr->CfgPtr->BaseAddress);
+	XUartPs_SetOperMode(UartPtr, XUARTPS_OPER_MODE_NORMAL);
+	(void)XConnectToInterruptCntrl(BenchPtr->CfgPtr->IntrId,
+				       &XUartPs_InterruptHandler, UartPtr,
+				       BenchPtr->CfgPtr->IntrParent);
+	BenchPtr->Mode = UART_BENCH_MODE_POLLED;
+}
+
+/****************************************************************************/
+/*
+*
+* Sends NumBytes bytes of UartBench_TxBuf through the loopback into
+* UartBench_RxBuf with the mode being run.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	NumBytes is the length of the transfer.
+* @param	CyclesPtr is where the CPU cycles spent are stored.
+* @param	TicksPtr is where the duration of the transfer is stored.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if the transfer timed out.
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 UartBench_Transfer(UartBench *BenchPtr, u32 NumBytes,
+			      u32 *CyclesPtr, XTime *TicksPtr)
+{
+	XUartPs *UartPtr = &BenchPtr->Uart;
+	u32 Sent = 0U;
+	u32 Received = 0U;
+	u32 Iterations = 0U;
+	u32 StartCycles;
+	u32 Cycles;
+	u32 IdleCycles;
+	XTime Start;
+	XTime End;
+	XTime Deadline;
+
+	if (BenchPtr->Mode != UART_BENCH_MODE_POLLED) {
+		BenchPtr->Expected = NumBytes;
+		BenchPtr->Done = 0U;
+		UartBench_Calibrate(BenchPtr);
+	}
+
+	if (BenchPtr->Mode == UART_BENCH_MODE_INTR) {
+		(void)XUartPs_Recv(UartPtr, UartBench_RxBuf, NumBytes);
+	}
+#if defined (XPAR_XDMAPS_NUM_INSTANCES)
+	if (BenchPtr->Mode == UART_BENCH_MODE_DMA) {
+		(void)XUartPs_DmaRecv(&BenchPtr->UartDma, UartBench_RxBuf,
+				      NumBytes);
+	}
+#endif
+
+	StartCycles = UartBench_ReadCycles(BenchPtr);
+	XTime_GetTime(&Start);
+
+	/* Four times the line time plus some slack */
+	Deadline = Start + (XTime)((((u64)NumBytes * 40U) * COUNTS_PER_SECOND) /
+				   UartPtr->BaudRate) +
+		   (XTime)(((u64)UART_BENCH_SLACK_MS * COUNTS_PER_SECOND) / 1000U);
+
+	switch (BenchPtr->Mode) {
+	case UART_BENCH_MODE_POLLED:
+		do {
+			if (Sent < NumBytes) {
+				Sent += XUartPs_Send(UartPtr,
+						     &UartBench_TxBuf[Sent],
+						     NumBytes - Sent);
+			}
+			Received += XUartPs_Recv(UartPtr,
+						 &UartBench_RxBuf[Received],
+						 NumBytes - Received);
+			XTime_GetTime(&End);
+		} while ((Received < NumBytes) && (End < Deadline));
+		BenchPtr->Done = (Received == NumBytes) ? 1U : 0U;
+		break;
+
+	case UART_BENCH_MODE_INTR:
+		(void)XUartPs_Send(UartPtr, UartBench_TxBuf, NumBytes);
+		Iterations = UartBench_Wait(BenchPtr, Deadline, 0xFFFFFFFFU);
+		break;
+
+	case UART_BENCH_MODE_RING:
+		(void)XUartPs_RingWrite(UartPtr, UartBench_TxBuf, NumBytes);
+		Iterations = UartBench_Wait(BenchPtr, Deadline, 0xFFFFFFFFU);
+		(void)XUartPs_RingRead(UartPtr, UartBench_RxBuf, NumBytes);
+		break;
+
+#if defined (XPAR_XDMAPS_NUM_INSTANCES)
+	case UART_BENCH_MODE_DMA:
+		(void)XUartPs_DmaSend(&BenchPtr->UartDma, UartBench_TxBuf,
+				      NumBytes);
+		Iterations = UartBench_Wait(BenchPtr, Deadline, 0xFFFFFFFFU);
+		break;
+#endif
+
+	default:
+		break;
+	}
+
+	XTime_GetTime(&End);
+	Cycles = UartBench_ReadCycles(BenchPtr) - StartCycles;
+
+	if (UartBench_IsDone(BenchPtr) == 0U) {
+		/* Stop an interrupt driven receive still in progress */
+		if (BenchPtr->Mode == UART_BENCH_MODE_INTR) {
+			(void)XUartPs_Recv(UartPtr, UartBench_RxBuf, 0U);
+		}
+		return XST_FAILURE;
+	}
+
+	/* Leave out the cycles the CPU spent waiting */
+	IdleCycles = (u32)(((u64)Iterations * BenchPtr->CyclesPerIter16) >> 4);
+	*CyclesPtr = (Cycles > IdleCycles) ? (Cycles - IdleCycles) : 0U;
+	*TicksPtr = End - Start;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Measures the cost of one iteration of UartBench_Wait() for the mode being
+* run, with the transfer not started yet so that it never completes.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartBench_Calibrate(UartBench *BenchPtr)
+{
+	u32 StartCycles;
+	u32 Cycles;
+	u32 Iterations;
+	XTime Now;
+
+	XTime_GetTime(&Now);
+
+	StartCycles = UartBench_ReadCycles(BenchPtr);
+	Iterations = UartBench_Wait(BenchPtr, Now + COUNTS_PER_SECOND,
+				    UART_BENCH_CALIB_ITERS);
+	Cycles = UartBench_ReadCycles(BenchPtr) - StartCycles;
+
+	BenchPtr->CyclesPerIter16 = (Iterations != 0U) ?
+				    ((Cycles << 4) / Iterations) : 0U;
+}
+
+/****************************************************************************/
+/*
+*
+* Idle loop of the interrupt driven modes. Waits until the transfer is done,
+* the deadline has passed or Limit iterations have been made.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+* @param	Deadline is the time the transfer must be done by.
+* @param	Limit is the largest number of iterations.
+*
+* @return	The number of iterations made.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 UartBench_Wait(UartBench *BenchPtr, XTime Deadline, u32 Limit)
+{
+	u32 Iterations = 0U;
+	XTime Now;
+
+	while ((UartBench_IsDone(BenchPtr) == 0U) && (Iterations < Limit)) {
+		XTime_GetTime(&Now);
+		if (Now >= Deadline) {
+			break;
+		}
+		Iterations++;
+	}
+
+	return Iterations;
+}
+
+/****************************************************************************/
+/*
+*
+* Checks whether the transfer in progress is done.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return	Non-zero once all expected bytes have been received.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 UartBench_IsDone(UartBench *BenchPtr)
+{
+	if (BenchPtr->Mode == UART_BENCH_MODE_RING) {
+		return (XUartPs_RingRxCount(&BenchPtr->Uart) >=
+			BenchPtr->Expected) ? 1U : 0U;
+	}
+
+	return BenchPtr->Done;
+}
+
+/****************************************************************************/
+/*
+*
+* Reads the PMU event counter counting CPU cycles.
+*
+* @param	BenchPtr is a pointer to the benchmark state.
+*
+* @return	The counter value, wrapping at 2^32.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 UartBench_ReadCycles(UartBench *BenchPtr)
+{
+	u32 Value = 0U;
+
+	(void)Xpm_GetEventCounter(BenchPtr->CycleCounter, &Value);
+
+	return Value;
+}
+
+/****************************************************************************/
+/*
+*
+* Event handler of the interrupt driven and DMA assisted modes. Receives end
+* with a receive data event, or with a timeout event once the last bytes
+* have been picked up from the FIFO.
+*
+* @param	CallBackRef is the benchmark state.
+* @param	Event is the XUARTPS_EVENT_* that occurred.
+* @param	EventData is the number of bytes received so far.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartBench_Handler(void *CallBackRef, u32 Event, u32 EventData)
+{
+	UartBench *BenchPtr = (UartBench *)CallBackRef;
+
+	if (((Event == XUARTPS_EVENT_RECV_DATA) ||
+	     (Event == XUARTPS_EVENT_RECV_TOUT)) &&
+	    (EventData >= BenchPtr->Expected)) {
+		BenchPtr->Done = 1U;
+	}
+}
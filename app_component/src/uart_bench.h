@@ -0,0 +1,137 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file uart_bench.h
+*
+* Throughput and latency benchmark of the XUartPs driver modes.
+*
+* Every run puts the UART in local loopback, so the numbers do not depend on
+* the far end, and moves data with one of the driver modes: polled,
+* interrupt driven, ring buffer or DMA assisted. A run reports
+*
+* - the throughput in bytes per second, from a transfer of
+*   UART_BENCH_RUN_MS worth of data at the line rate,
+* - the CPU cycles per byte spent by the driver, from the PMU cycle event
+*   counter. In the interrupt driven modes the CPU waits in an idle loop
+*   whose cost per iteration is calibrated before the transfer, and the
+*   cycles spent in that loop are not counted. In polled mode the CPU is
+*   busy for the whole transfer.
+* - the distribution of the round trip latency of a single byte, from
+*   UART_BENCH_LAT_SAMPLES samples taken with the global timer.
+*
+* UartBench_RunAll() runs every mode at every rate of the suite and leaves
+* the UART at the default rate in normal mode, so that the results can be
+* printed with UartBench_Report() on the same UART.
+*
+* In remote loopback the UART echoes the received data without the CPU, so
+* that mode can only be measured from the far end. UartBench_RemoteEcho()
+* holds the UART in remote loopback for a host side measurement.
+*
+* The transfer buffers are taken from the DMA arena of xil_dmaarena.h when
+* it is mapped, so that the DMA mode runs without cache maintenance.
+*
+* The benchmark is built into the application when UART_BENCH is defined.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Transfer buffers taken from the DMA arena.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef UART_BENCH_H
+#define UART_BENCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xparameters.h"
+#include "xuartps.h"
+#if defined (XPAR_XDMAPS_NUM_INSTANCES)
+#include "xuartps_dma.h"
+#endif
+
+/************************** Constant Definitions ****************************/
+
+/** @name Driver modes
+ * @{
+ */
+#define UART_BENCH_MODE_POLLED	0U	/**< XUartPs_Send/Recv, polled */
+#define UART_BENCH_MODE_INTR	1U	/**< XUartPs_Send/Recv, interrupts */
+#define UART_BENCH_MODE_RING	2U	/**< Ring buffer mode */
+#define UART_BENCH_MODE_DMA	3U	/**< DMA assisted mode */
+#define UART_BENCH_NUM_MODES	4U
+/* @} */
+
+#define UART_BENCH_MAX_BYTES	4096U	/**< Largest throughput transfer */
+#define UART_BENCH_MIN_BYTES	64U	/**< Smallest throughput transfer */
+#define UART_BENCH_RUN_MS	100U	/**< Line time of a throughput run */
+#define UART_BENCH_LAT_SAMPLES	64U	/**< Round trips per latency run */
+#define UART_BENCH_NUM_RATES	21U	/**< Baud rates of the suite */
+
+/** Results of a full suite */
+#define UART_BENCH_MAX_RESULTS	(UART_BENCH_NUM_RATES * UART_BENCH_NUM_MODES)
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Result of one run.
+ */
+typedef struct {
+	u32 BaudRate;		/**< Line rate */
+	u32 Mode;		/**< One of the UART_BENCH_MODE_* values */
+	s32 Status;		/**< XST_SUCCESS, or why the run failed */
+	u32 Bytes;		/**< Bytes of the throughput transfer */
+	u32 BytesPerSec;	/**< Throughput */
+	u32 CyclesPerByte;	/**< CPU cycles spent per byte */
+	u32 LatMinNs;		/**< Fastest round trip */
+	u32 LatP50Ns;		/**< Median round trip */
+	u32 LatP99Ns;		/**< 99th percentile round trip */
+	u32 LatMaxNs;		/**< Slowest round trip */
+} UartBench_Result;
+
+/**
+ * State of the benchmark.
+ */
+typedef struct {
+	XUartPs Uart;		/**< Driver instance under test */
+	XUartPs_Config *CfgPtr;
+#if defined (XPAR_XDMAPS_NUM_INSTANCES)
+	XDmaPs Dma;		/**< DMA controller for the DMA mode */
+	XUartPs_Dma UartDma;	/**< DMA assisted mode state */
+#endif
+	u32 CycleCounter;	/**< PMU counter counting CPU cycles */
+	u32 Mode;		/**< Mode being run */
+	u32 CyclesPerIter16;	/**< Idle loop cost, 1/16 cycles */
+	u32 Expected;		/**< Bytes the current transfer waits for */
+	volatile u32 Done;	/**< Set by the handler on completion */
+	u32 Samples[UART_BENCH_LAT_SAMPLES]; /**< Round trips, timer ticks */
+} UartBench;
+
+/************************** Function Prototypes *****************************/
+
+s32 UartBench_Initialize(UartBench *BenchPtr);
+s32 UartBench_Run(UartBench *BenchPtr, u32 BaudRate, u32 Mode,
+		  UartBench_Result *ResultPtr);
+u32 UartBench_RunAll(UartBench *BenchPtr, UartBench_Result *ResultsPtr,
+		     u32 MaxResults);
+void UartBench_Report(const UartBench_Result *ResultsPtr, u32 NumResults);
+s32 UartBench_RemoteEcho(UartBench *BenchPtr, u32 BaudRate, u32 Seconds);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UART_BENCH_H */
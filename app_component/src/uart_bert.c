@@ -0,0 +1,568 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file uart_bert.c
+*
+* Bit error rate test of a UART link with a PRBS. Refer to uart_bert.h for
+* what is measured and how.
+*
+* The generator is a Fibonacci LFSR shifted one bit at a time, eight per
+* byte, the first bit of the sequence going out first as the UART sends
+* the least significant bit first. Its register is then the last Order
+* bits of the sequence, which is how the checker locks: it loads the last
+* Order bits it received as the register of its reference generator.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "xil_printf.h"
+#include "xiltimer.h"
+#include "xinterrupt_wrap.h"
+#include "xil_hotpath.h"
+#include "uart_bert.h"
+
+/************************** Constant Definitions ****************************/
+
+#define UART_BERT_CHUNK		64U	/* Bytes generated per ring write */
+#define UART_BERT_QUIET_MS	20U	/* RX idle time that ends a run */
+#define UART_BERT_SEED		0x00000001U
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static s32 UartBert_Setup(UartBert *BertPtr, u32 BaudRate, u32 Flow);
+static void UartBert_Restore(UartBert *BertPtr);
+static void UartBert_PrbsInit(UartBert_Prbs *PrbsPtr, u32 Prbs);
+static u8 UartBert_PrbsByte(UartBert_Prbs *PrbsPtr);
+static void UartBert_Fill(UartBert *BertPtr);
+static u32 UartBert_Drain(UartBert *BertPtr);
+static void UartBert_Check(UartBert *BertPtr, u8 Data);
+
+/************************** Variable Definitions ****************************/
+
+extern XUartPs_Config XUartPs_ConfigTable[];
+
+static const u32 UartBert_Rates[UART_BERT_NUM_RATES] = {
+	115200U, 230400U, 460800U, 921600U, 1000000U, 1500000U, 2000000U,
+	3000000U, 4000000U
+};
+
+static const char *UartBert_FlowNames[UART_BERT_NUM_FLOWS] = {
+	"none", "rtscts"
+};
+
+static u8 UartBert_RxRing[UART_BERT_RING_SIZE] XIL_NOINIT;
+static u8 UartBert_TxRing[UART_BERT_RING_SIZE] XIL_NOINIT;
+
+/****************************************************************************/
+/**
+*
+* Initializes the test: the UART driver and its interrupt.
+*
+* @param	BertPtr is a pointer to the test state.
+*
+* @return	XST_SUCCESS if the test is ready, otherwise the error of the
+*		failing driver call.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 UartBert_Initialize(UartBert *BertPtr)
+{
+	XUartPs_Config *CfgPtr = &XUartPs_ConfigTable[0];
+	s32 Status;
+
+	BertPtr->CfgPtr = CfgPtr;
+	BertPtr->ResultPtr = NULL;
+
+	Status = XUartPs_CfgInitialize(&BertPtr->Uart, CfgPtr,
+				       CfgPtr->BaseAddress);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	return XSetupInterruptSystem(&BertPtr->Uart, &XUartPs_InterruptHandler,
+				     CfgPtr->IntrId, CfgPtr->IntrParent,
+				     XINTERRUPT_DEFAULT_PRIORITY);
+}
+
+/****************************************************************************/
+/**
+*
+* Runs one sequence at one baud rate with one flow control mode. The
+* sequence is sent for DurationMs, then the run goes on until the receiver
+* has been idle for UART_BERT_QUIET_MS, so that the bytes in flight are
+* checked too.
+*
+* @param	BertPtr is a pointer to the test state.
+* @param	BaudRate is the line rate.
+* @param	Prbs is one of the UART_BERT_PRBS* values.
+* @param	Flow is one of the UART_BERT_FLOW_* values.
+* @param	DurationMs is the time the sequence is sent for.
+* @param	ResultPtr is where the result is stored.
+*
+* @return
+*		- XST_SUCCESS if the run completed.
+*		- XST_INVALID_PARAM if the sequence or the flow control mode
+*		  is unknown.
+*		- XST_UART_BAUD_ERROR if the rate cannot be generated.
+*		- XST_FAILURE if the checker never locked, no data came
+*		  back.
+*
+* @note		The UART is left in the mode of the run.
+*
+*****************************************************************************/
+s32 UartBert_Run(UartBert *BertPtr, u32 BaudRate, u32 Prbs, u32 Flow,
+		 u32 DurationMs, UartBert_Result *ResultPtr)
+{
+	XUartPsStats Stats;
+	XTime Duration;
+	XTime Quiet;
+	XTime Start;
+	XTime LastRx;
+	XTime Now;
+	s32 Status;
+
+	(void)memset(ResultPtr, 0, sizeof(UartBert_Result));
+	ResultPtr->BaudRate = BaudRate;
+	ResultPtr->Prbs = Prbs;
+	ResultPtr->Flow = Flow;
+
+	if (((Prbs != UART_BERT_PRBS7) && (Prbs != UART_BERT_PRBS15) &&
+	     (Prbs != UART_BERT_PRBS31)) || (Flow >= UART_BERT_NUM_FLOWS)) {
+		ResultPtr->Status = XST_INVALID_PARAM;
+		return XST_INVALID_PARAM;
+	}
+
+	Status = UartBert_Setup(BertPtr, BaudRate, Flow);
+	if (Status != XST_SUCCESS) {
+		ResultPtr->Status = Status;
+		return Status;
+	}
+
+	UartBert_PrbsInit(&BertPtr->Tx, Prbs);
+	UartBert_PrbsInit(&BertPtr->Rx, Prbs);
+	BertPtr->Locked = 0U;
+	BertPtr->History = 0U;
+	BertPtr->HistoryBits = 0U;
+	BertPtr->WindowBits = 0U;
+	BertPtr->WindowErrors = 0U;
+	BertPtr->ResultPtr = ResultPtr;
+
+	Duration = ((XTime)DurationMs * COUNTS_PER_SECOND) / 1000U;
+	Quiet = ((XTime)UART_BERT_QUIET_MS * COUNTS_PER_SECOND) / 1000U;
+
+	XTime_GetTime(&Start);
+	LastRx = Start;
+	do {
+		XTime_GetTime(&Now);
+		if ((Now - Start) < Duration) {
+			UartBert_Fill(BertPtr);
+		}
+		if (UartBert_Drain(BertPtr) != 0U) {
+			LastRx = Now;
+		}
+	} while (((Now - Start) < Duration) || ((Now - LastRx) < Quiet));
+
+	/* The last window, short of UART_BERT_WINDOW_BITS */
+	if ((BertPtr->Locked != 0U) &&
+	    (BertPtr->WindowErrors <= UART_BERT_LOSS_BITS)) {
+		ResultPtr->BitsChecked += BertPtr->WindowBits;
+		ResultPtr->BitErrors += BertPtr->WindowErrors;
+	}
+
+	if (XUartPs_GetStats(&BertPtr->Uart, &Stats) == XST_SUCCESS) {
+		ResultPtr->Overruns = Stats.OverrunErrors;
+		ResultPtr->FramingErrors = Stats.FramingErrors;
+		ResultPtr->ParityErrors = Stats.ParityErrors;
+	}
+	ResultPtr->RingDropped = BertPtr->Uart.RxRingDropped;
+	BertPtr->ResultPtr = NULL;
+
+	ResultPtr->Status = (ResultPtr->BitsChecked != 0U) ? XST_SUCCESS :
+			    XST_FAILURE;
+
+	return ResultPtr->Status;
+}
+
+/****************************************************************************/
+/**
+*
+* Runs UART_BERT_PRBS at every baud rate of the suite in every flow control
+* mode, then restores the UART to the default rate in normal mode.
+*
+* @param	BertPtr is a pointer to the test state.
+* @param	ResultsPtr is where the results are stored.
+* @param	MaxResults is the number of results ResultsPtr can hold,
+*		UART_BERT_MAX_RESULTS for the full suite.
+*
+* @return	The number of results stored, including failed runs.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 UartBert_RunAll(UartBert *BertPtr, UartBert_Result *ResultsPtr,
+		    u32 MaxResults)
+{
+	u32 NumResults = 0U;
+	u32 Rate;
+	u32 Flow;
+
+	for (Rate = 0U; Rate < UART_BERT_NUM_RATES; Rate++) {
+		for (Flow = 0U; Flow < UART_BERT_NUM_FLOWS; Flow++) {
+			if (NumResults >= MaxResults) {
+				break;
+			}
+			(void)UartBert_Run(BertPtr, UartBert_Rates[Rate],
+					   UART_BERT_PRBS, Flow,
+					   UART_BERT_RUN_MS,
+					   &ResultsPtr[NumResults]);
+			NumResults++;
+		}
+	}
+
+	UartBert_Restore(BertPtr);
+
+	return NumResults;
+}
+
+/****************************************************************************/
+/**
+*
+* Prints the results as a table on the standard output, the bit error rate
+* in errors per 10^9 bits checked.
+*
+* @param	ResultsPtr is the results of UartBert_RunAll().
+* @param	NumResults is the number of results.
+*
+* @return	None.
+*
+* @note		The counts are printed on 32 bits, enough for runs of some
+*		minutes at the highest rate.
+*
+*****************************************************************************/
+void UartBert_Report(const UartBert_Result *ResultsPtr, u32 NumResults)
+{
+	const UartBert_Result *ResultPtr;
+	u32 Index;
+	u32 Ber;
+
+	xil_printf("baud\tprbs\tflow\tbits\terrors\tber/1e9\tlosses\t"
+		   "ovr/frm/par/drop\r\n");
+
+	for (Index = 0U; Index < NumResults; Index++) {
+		ResultPtr = &ResultsPtr[Index];
+
+		if (ResultPtr->Status != XST_SUCCESS) {
+			xil_printf("%u\t%u\t%s\tfailed (%d)\r\n",
+				   ResultPtr->BaudRate, ResultPtr->Prbs,
+				   UartBert_FlowNames[ResultPtr->Flow],
+				   ResultPtr->Status);
+			continue;
+		}
+
+		Ber = (u32)((ResultPtr->BitErrors * 1000000000U) /
+			    ResultPtr->BitsChecked);
+		xil_printf("%u\t%u\t%s\t%u\t%u\t%u\t%u\t%u/%u/%u/%u\r\n",
+			   ResultPtr->BaudRate, ResultPtr->Prbs,
+			   UartBert_FlowNames[ResultPtr->Flow],
+			   (u32)ResultPtr->BitsChecked,
+			   (u32)ResultPtr->BitErrors, Ber,
+			   ResultPtr->SyncLosses, ResultPtr->Overruns,
+			   ResultPtr->FramingErrors, ResultPtr->ParityErrors,
+			   ResultPtr->RingDropped);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Reinitializes the driver instance for a run, in ring buffer mode with the
+* statistics and the flow control of the run, on the link of the test.
+*
+* @param	BertPtr is a pointer to the test state.
+* @param	BaudRate is the line rate.
+* @param	Flow is one of the UART_BERT_FLOW_* values.
+*
+* @return	XST_SUCCESS, or the error of the failing driver call.
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 UartBert_Setup(UartBert *BertPtr, u32 BaudRate, u32 Flow)
+{
+	XUartPs *UartPtr = &BertPtr->Uart;
+	XUartPs_Config *CfgPtr = BertPtr->CfgPtr;
+	s32 Status;
+
+	if (UartPtr->RingMode != 0U) {
+		XUartPs_DisableRingMode(UartPtr);
+	}
+
+	Status = XUartPs_CfgInitialize(UartPtr, CfgPtr, CfgPtr->BaseAddress);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	Status = XUartPs_SetBaudRate(UartPtr, BaudRate);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+#if !defined (UART_BERT_EXTERNAL)
+	XUartPs_SetOperMode(UartPtr, XUARTPS_OPER_MODE_LOCAL_LOOP);
+#endif
+
+	Status = XConnectToInterruptCntrl(CfgPtr->IntrId,
+					  &XUartPs_InterruptHandler, UartPtr,
+					  CfgPtr->IntrParent);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	Status = XUartPs_EnableRingMode(UartPtr, UartBert_RxRing,
+					UART_BERT_RING_SIZE, UartBert_TxRing,
+					UART_BERT_RING_SIZE);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	XUartPs_EnableStats(UartPtr, &BertPtr->Stats);
+
+	if (Flow == UART_BERT_FLOW_RTSCTS) {
+		Status = XUartPs_EnableRingFlowControl(UartPtr,
+				(UART_BERT_RING_SIZE * 3U) / 4U,
+				UART_BERT_RING_SIZE / 4U);
+	}
+
+	return Status;
+}
+
+/****************************************************************************/
+/*
+*
+* Puts the UART back at the default rate in normal mode with its interrupts
+* disabled.
+*
+* @param	BertPtr is a pointer to the test state.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartBert_Restore(UartBert *BertPtr)
+{
+	XUartPs *UartPtr = &BertPtr->Uart;
+
+	if (UartPtr->RingMode != 0U) {
+		XUartPs_DisableRingMode(UartPtr);
+	}
+
+	(void)XUartPs_CfgInitialize(UartPtr, BertPtr->CfgPtr,
+				    BertPtr->CfgPtr->BaseAddress);
+	XUartPs_SetOperMode(UartPtr, XUARTPS_OPER_MODE_NORMAL);
+}
+
+/****************************************************************************/
+/*
+*
+* Sets a generator up for a sequence, from a fixed seed.
+*
+* @param	PrbsPtr is the generator.
+* @param	Prbs is one of the UART_BERT_PRBS* values.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartBert_PrbsInit(UartBert_Prbs *PrbsPtr, u32 Prbs)
+{
+	PrbsPtr->Order = Prbs;
+	PrbsPtr->Mask = (1U << Prbs) - 1U;
+	if (Prbs == UART_BERT_PRBS31) {
+		PrbsPtr->Tap = 28U;
+	} else {
+		PrbsPtr->Tap = Prbs - 1U;
+	}
+	PrbsPtr->State = UART_BERT_SEED;
+}
+
+/****************************************************************************/
+/*
+*
+* Returns the next eight bits of a sequence, the first one in bit 0.
+*
+* @param	PrbsPtr is the generator.
+*
+* @return	The byte.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u8 UartBert_PrbsByte(UartBert_Prbs *PrbsPtr)
+{
+	u32 State = PrbsPtr->State;
+	u32 Byte = 0U;
+	u32 Bit;
+	u32 Index;
+
+	for (Index = 0U; Index < 8U; Index++) {
+		Bit = ((State >> (PrbsPtr->Order - 1U)) ^
+		       (State >> (PrbsPtr->Tap - 1U))) & 1U;
+		State = ((State << 1) | Bit) & PrbsPtr->Mask;
+		Byte |= Bit << Index;
+	}
+	PrbsPtr->State = State;
+
+	return (u8)Byte;
+}
+
+/****************************************************************************/
+/*
+*
+* Tops the TX ring up with the sequence.
+*
+* @param	BertPtr is a pointer to the test state.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartBert_Fill(UartBert *BertPtr)
+{
+	u8 Chunk[UART_BERT_CHUNK];
+	u32 Count;
+	u32 Index;
+
+	Count = XUartPs_RingTxFree(&BertPtr->Uart);
+	while (Count != 0U) {
+		if (Count > UART_BERT_CHUNK) {
+			Count = UART_BERT_CHUNK;
+		}
+		for (Index = 0U; Index < Count; Index++) {
+			Chunk[Index] = UartBert_PrbsByte(&BertPtr->Tx);
+		}
+		BertPtr->ResultPtr->BytesSent +=
+			XUartPs_RingWrite(&BertPtr->Uart, Chunk, Count);
+		Count = XUartPs_RingTxFree(&BertPtr->Uart);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Checks the bytes waiting in the RX ring, in place, and hands their room
+* back to the driver.
+*
+* @param	BertPtr is a pointer to the test state.
+*
+* @return	The number of bytes checked.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 UartBert_Drain(UartBert *BertPtr)
+{
+	XUartPsRingSpan Span;
+	u32 Count;
+	u32 Segment;
+	u32 Index;
+
+	Count = XUartPs_RingPeek(&BertPtr->Uart, &Span);
+	if (Count == 0U) {
+		return 0U;
+	}
+
+	for (Segment = 0U; Segment < 2U; Segment++) {
+		for (Index = 0U; Index < Span.Length[Segment]; Index++) {
+			UartBert_Check(BertPtr, Span.DataPtr[Segment][Index]);
+		}
+	}
+	XUartPs_RingConsume(&BertPtr->Uart, Count);
+
+	return Count;
+}
+
+/****************************************************************************/
+/*
+*
+* Checks one received byte. Unlocked, the byte goes into the history until
+* it holds a register of the sequence, loaded into the reference. Locked,
+* the byte is compared with the reference and the errors go into the
+* window, counted once the window is full unless there are so many of them
+* that the sequence was lost.
+*
+* @param	BertPtr is a pointer to the test state.
+* @param	Data is the byte received.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartBert_Check(UartBert *BertPtr, u8 Data)
+{
+	UartBert_Result *ResultPtr = BertPtr->ResultPtr;
+	u32 Index;
+
+	if (BertPtr->Locked == 0U) {
+		for (Index = 0U; Index < 8U; Index++) {
+			BertPtr->History = (BertPtr->History << 1) |
+					   (((u32)Data >> Index) & 1U);
+		}
+		BertPtr->HistoryBits += 8U;
+		if (BertPtr->HistoryBits < BertPtr->Rx.Order) {
+			return;
+		}
+
+		BertPtr->Rx.State = BertPtr->History & BertPtr->Rx.Mask;
+		if (BertPtr->Rx.State == 0U) {
+			/* A line stuck at 0 is not a sequence, wait for one */
+			BertPtr->HistoryBits = 0U;
+			return;
+		}
+		BertPtr->Locked = 1U;
+		BertPtr->WindowBits = 0U;
+		BertPtr->WindowErrors = 0U;
+		return;
+	}
+
+	BertPtr->WindowErrors += (u32)__builtin_popcount(
+			(u32)UartBert_PrbsByte(&BertPtr->Rx) ^ (u32)Data);
+	BertPtr->WindowBits += 8U;
+	if (BertPtr->WindowBits < UART_BERT_WINDOW_BITS) {
+		return;
+	}
+
+	if (BertPtr->WindowErrors > UART_BERT_LOSS_BITS) {
+		ResultPtr->SyncLosses++;
+		BertPtr->Locked = 0U;
+		BertPtr->HistoryBits = 0U;
+	} else {
+		ResultPtr->BitsChecked += BertPtr->WindowBits;
+		ResultPtr->BitErrors += BertPtr->WindowErrors;
+	}
+	BertPtr->WindowBits = 0U;
+	BertPtr->WindowErrors = 0U;
+}
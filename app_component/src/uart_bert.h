@@ -0,0 +1,156 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file uart_bert.h
+*
+* Bit error rate test of a UART link with a PRBS, to qualify cables and
+* find the highest baud rate a board runs reliably at.
+*
+* A run sends PRBS-7, PRBS-15 or PRBS-31 at line rate for UART_BERT_RUN_MS
+* through the ring buffer mode of the XUartPs driver, the TX ring kept
+* full from the loop, and checks every received byte against a local copy
+* of the generator. The checker locks onto the received sequence from its
+* first bits, so no start of frame is needed, and counts the bits that
+* differ from then on. A window of UART_BERT_WINDOW_BITS bits with more
+* than UART_BERT_LOSS_BITS errors means the sequence was lost, a byte
+* dropped or inserted: the window is not counted, the loss is, and the
+* checker locks again on the following bits. Each byte costs the checker
+* a few tens of cycles.
+*
+* A run reports the bits checked and in error, the losses of lock, and the
+* overrun, framing and parity errors and the bytes dropped for a full RX
+* ring taken from the driver. UartBert_RunAll() runs every rate of the
+* suite without flow control and with the RTS/CTS flow control of the
+* ring buffer mode, and UartBert_Report() prints the bit error rate of
+* each run in errors per 10^9 bits.
+*
+* The link is the local loopback of the UART by default, which tests the
+* UART and the driver only. With UART_BERT_EXTERNAL defined it is the pins,
+* for a loopback plug or cable connecting TX to RX and RTS to CTS, which is
+* what qualifies the cable. Without RTS and CTS routed to the UART the runs
+* with flow control stall and report no data. The results are printed on
+* the standard output once the UART is restored.
+*
+* The test is built into the application when UART_BERT is defined.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef UART_BERT_H
+#define UART_BERT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xuartps.h"
+
+/************************** Constant Definitions ****************************/
+
+#ifndef UART_BERT_RUN_MS
+#define UART_BERT_RUN_MS	1000U	/**< Line time of a run */
+#endif
+#ifndef UART_BERT_PRBS
+#define UART_BERT_PRBS		UART_BERT_PRBS31 /**< Sequence of RunAll */
+#endif
+
+/** @name Sequences
+ * @{
+ */
+#define UART_BERT_PRBS7		7U	/**< x^7 + x^6 + 1 */
+#define UART_BERT_PRBS15	15U	/**< x^15 + x^14 + 1 */
+#define UART_BERT_PRBS31	31U	/**< x^31 + x^28 + 1 */
+/* @} */
+
+/** @name Flow control modes
+ * @{
+ */
+#define UART_BERT_FLOW_NONE	0U	/**< No flow control */
+#define UART_BERT_FLOW_RTSCTS	1U	/**< RTS/CTS of the ring mode */
+#define UART_BERT_NUM_FLOWS	2U
+/* @} */
+
+#define UART_BERT_WINDOW_BITS	64U	/**< Bits of a lock window */
+#define UART_BERT_LOSS_BITS	16U	/**< Errors in a window losing lock */
+#define UART_BERT_RING_SIZE	4096U	/**< Bytes of each ring */
+#define UART_BERT_NUM_RATES	9U	/**< Baud rates of the suite */
+
+/** Results of a full suite */
+#define UART_BERT_MAX_RESULTS	(UART_BERT_NUM_RATES * UART_BERT_NUM_FLOWS)
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Result of one run.
+ */
+typedef struct {
+	u32 BaudRate;		/**< Line rate */
+	u32 Prbs;		/**< One of the UART_BERT_PRBS* values */
+	u32 Flow;		/**< One of the UART_BERT_FLOW_* values */
+	s32 Status;		/**< XST_SUCCESS, or why the run failed */
+	u64 BytesSent;
+	u64 BitsChecked;	/**< Bits compared while locked */
+	u64 BitErrors;		/**< Of those, the ones in error */
+	u32 SyncLosses;		/**< Windows that lost the sequence */
+	u32 Overruns;		/**< RX FIFO overruns */
+	u32 FramingErrors;
+	u32 ParityErrors;
+	u32 RingDropped;	/**< Bytes lost to a full RX ring */
+} UartBert_Result;
+
+/**
+ * PRBS generator, also the reference of the checker. Bit 0 of State is the
+ * last bit of the sequence.
+ */
+typedef struct {
+	u32 State;
+	u32 Mask;		/**< Order bits */
+	u32 Order;		/**< Length of the register */
+	u32 Tap;		/**< Other tap of the polynomial */
+} UartBert_Prbs;
+
+/**
+ * State of the test.
+ */
+typedef struct {
+	XUartPs Uart;		/**< Driver instance under test */
+	XUartPs_Config *CfgPtr;
+	XUartPsStats Stats;	/**< Driver statistics of a run */
+	UartBert_Prbs Tx;	/**< Generator of the sent sequence */
+	UartBert_Prbs Rx;	/**< Reference of the checker */
+	u32 Locked;		/**< Rx follows the received sequence */
+	u32 History;		/**< Last bits received, bit 0 the last */
+	u32 HistoryBits;	/**< Bits in History while unlocked */
+	u32 WindowBits;		/**< Bits checked in the window */
+	u32 WindowErrors;	/**< Errors in the window */
+	UartBert_Result *ResultPtr; /**< Run in progress */
+} UartBert;
+
+/************************** Function Prototypes *****************************/
+
+s32 UartBert_Initialize(UartBert *BertPtr);
+s32 UartBert_Run(UartBert *BertPtr, u32 BaudRate, u32 Prbs, u32 Flow,
+		 u32 DurationMs, UartBert_Result *ResultPtr);
+u32 UartBert_RunAll(UartBert *BertPtr, UartBert_Result *ResultsPtr,
+		    u32 MaxResults);
+void UartBert_Report(const UartBert_Result *ResultsPtr, u32 NumResults);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UART_BERT_H */
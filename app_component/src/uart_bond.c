@@ -0,0 +1,599 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file uart_bond.c
+*
+* Two UARTs bonded into one packet link. Refer to uart_bond.h for the
+* striping and the reordering.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "uart_bond.h"
+
+/************************** Constant Definitions ****************************/
+
+#define UART_BOND_COUNTS_PER_MS	((XTime)COUNTS_PER_SECOND / 1000U)
+
+/*
+ * Distance from the expected sequence number beyond which a packet is taken
+ * as the peer having started again rather than as reordered or lost.
+ */
+#define UART_BOND_RESYNC	1024U
+
+#if ((UART_BOND_WINDOW & (UART_BOND_WINDOW - 1U)) != 0U) || \
+	(UART_BOND_WINDOW > UART_BOND_RESYNC)
+#error "UART_BOND_WINDOW must be a power of two up to UART_BOND_RESYNC"
+#endif
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define UartBond_SlotOf(BondPtr, Seq) \
+	(&(BondPtr)->Slot[(Seq) & (UART_BOND_WINDOW - 1U)])
+
+/************************** Function Prototypes *****************************/
+
+static s32 UartBond_Pick(UartBond *BondPtr, u32 Length, u32 AllowHeld);
+static void UartBond_Receive(UartBond *BondPtr, u32 Index,
+			     UartFrame *FramePtr, XTime Now);
+static void UartBond_Deliver(UartBond *BondPtr, const UartFrame *PacketPtr);
+static void UartBond_DeliverHeld(UartBond *BondPtr, XTime Now);
+static void UartBond_Skip(UartBond *BondPtr, XTime Now);
+static void UartBond_Resync(UartBond *BondPtr, u32 Seq);
+static void UartBond_CheckErrors(UartBond *BondPtr, u32 Index, XTime Now);
+static void UartBond_CopyOut(const UartFrame *FramePtr, u32 NumBytes,
+			     u8 *DataPtr);
+static void UartBond_StripHeader(UartFrame *FramePtr);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* Initializes a bond of two UARTs, with a framing engine on each.
+*
+* @param	BondPtr is a pointer to the bond.
+* @param	Uart0Ptr is the first driver instance, already in ring buffer
+*		mode.
+* @param	Uart1Ptr is the second one. The bond must be the only reader
+*		and writer of the rings of both.
+* @param	Mode is UART_FRAME_COBS or UART_FRAME_SLIP, the same on both
+*		ends of the link.
+* @param	MaxPayload is the largest packet, up to UART_BOND_MAX_PAYLOAD.
+*
+* @return
+*		- XST_SUCCESS if the bond was initialized.
+*		- XST_INVALID_PARAM if the instances are the same or MaxPayload
+*		is out of range.
+*		- The status of UartFrame_Initialize() otherwise.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 UartBond_Initialize(UartBond *BondPtr, XUartPs *Uart0Ptr,
+			XUartPs *Uart1Ptr, u32 Mode, u32 MaxPayload)
+{
+	XUartPs *UartPtr[UART_BOND_LINKS];
+	u32 Index;
+	s32 Status;
+
+	if ((Uart0Ptr == Uart1Ptr) || (MaxPayload == 0U) ||
+	    (MaxPayload > UART_BOND_MAX_PAYLOAD)) {
+		return XST_INVALID_PARAM;
+	}
+
+	(void)memset(BondPtr, 0, sizeof(*BondPtr));
+	UartPtr[0] = Uart0Ptr;
+	UartPtr[1] = Uart1Ptr;
+	for (Index = 0U; Index < UART_BOND_LINKS; Index++) {
+		Status = UartFrame_Initialize(&BondPtr->Link[Index].Engine,
+					      UartPtr[Index], Mode,
+					      UART_BOND_HEADER + MaxPayload);
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+		BondPtr->Link[Index].UartPtr = UartPtr[Index];
+	}
+
+	BondPtr->Mode = Mode;
+	BondPtr->MaxPayload = MaxPayload;
+	BondPtr->ReorderCounts = (XTime)UART_BOND_REORDER_MS *
+				 UART_BOND_COUNTS_PER_MS;
+	BondPtr->HoldOffCounts = (XTime)UART_BOND_HOLDOFF_MS *
+				 UART_BOND_COUNTS_PER_MS;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Sets the handler of the received packets.
+*
+* @param	BondPtr is a pointer to the bond.
+* @param	Handler is called for each packet, NULL to drop them.
+* @param	CallBackRef is passed to the handler.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void UartBond_SetHandler(UartBond *BondPtr, UartBond_Handler Handler,
+			 void *CallBackRef)
+{
+	BondPtr->Handler = Handler;
+	BondPtr->CallBackRef = CallBackRef;
+}
+
+/****************************************************************************/
+/**
+*
+* Sends a packet on the UART of the bond that will have sent it the
+* soonest.
+*
+* @param	BondPtr is a pointer to the bond.
+* @param	DataPtr is the packet.
+* @param	NumBytes is its length, up to the MaxPayload of the bond.
+*
+* @return
+*		- XST_SUCCESS if the packet was queued whole on a UART.
+*		- XST_DEVICE_BUSY if neither UART has room for it now; the
+*		packet may be sent again later.
+*		- XST_INVALID_PARAM if NumBytes is out of range.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 UartBond_Send(UartBond *BondPtr, const u8 *DataPtr, u32 NumBytes)
+{
+	u32 Length;
+	s32 Index;
+
+	if ((NumBytes == 0U) || (NumBytes > BondPtr->MaxPayload)) {
+		return XST_INVALID_PARAM;
+	}
+
+	BondPtr->TxPayload[0] = (u8)BondPtr->TxSeq;
+	BondPtr->TxPayload[1] = (u8)(BondPtr->TxSeq >> 8U);
+	BondPtr->TxPayload[2] = (u8)(BondPtr->TxSeq >> 16U);
+	BondPtr->TxPayload[3] = (u8)(BondPtr->TxSeq >> 24U);
+	(void)memcpy(&BondPtr->TxPayload[UART_BOND_HEADER], DataPtr, NumBytes);
+	Length = UartFrame_Encode(BondPtr->Mode, BondPtr->TxPayload,
+				  UART_BOND_HEADER + NumBytes,
+				  BondPtr->TxFrame, sizeof(BondPtr->TxFrame));
+
+	/* A link held off after an error only takes what the other cannot */
+	Index = UartBond_Pick(BondPtr, Length, 0U);
+	if (Index < 0) {
+		Index = UartBond_Pick(BondPtr, Length, 1U);
+	}
+	if (Index < 0) {
+		BondPtr->Stats.Busy++;
+		return XST_DEVICE_BUSY;
+	}
+
+	(void)XUartPs_RingWrite(BondPtr->Link[Index].UartPtr,
+				BondPtr->TxFrame, Length);
+	BondPtr->TxSeq++;
+	BondPtr->Stats.Link[Index].TxPackets++;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Receives the frames of both UARTs, alternately, and hands the packets to
+* the handler in sequence order.
+*
+* @param	BondPtr is a pointer to the bond.
+*
+* @return	None.
+*
+* @note		Called often enough that the RX rings of the UARTs do not
+*		fill, e.g. from the idle loop.
+*
+*****************************************************************************/
+void UartBond_Poll(UartBond *BondPtr)
+{
+	UartFrame Frame;
+	XTime Now;
+	u32 Index;
+	u32 Received;
+
+	XTime_GetTime(&Now);
+
+	/*
+	 * One frame of each UART in turn, so that the packets of the two
+	 * stripes meet about in order and few wait in the slots.
+	 */
+	do {
+		Received = 0U;
+		for (Index = 0U; Index < UART_BOND_LINKS; Index++) {
+			if (UartFrame_Poll(&BondPtr->Link[Index].Engine,
+					   &Frame) == XST_SUCCESS) {
+				UartBond_Receive(BondPtr, Index, &Frame, Now);
+				UartFrame_Release(&BondPtr->Link[Index].Engine);
+				Received++;
+			}
+		}
+	} while (Received != 0U);
+
+	for (Index = 0U; Index < UART_BOND_LINKS; Index++) {
+		UartBond_CheckErrors(BondPtr, Index, Now);
+	}
+
+	if ((BondPtr->Held != 0U) &&
+	    ((Now - BondPtr->HeldTime) >= BondPtr->ReorderCounts)) {
+		UartBond_Skip(BondPtr, Now);
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the counts of a bond.
+*
+* @param	BondPtr is a pointer to the bond.
+* @param	StatsPtr receives the counts.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void UartBond_GetStats(const UartBond *BondPtr, UartBond_Stats *StatsPtr)
+{
+	*StatsPtr = BondPtr->Stats;
+}
+
+/****************************************************************************/
+/*
+*
+* Picks the UART that will have sent a frame the soonest, comparing the
+* bytes queued with the frame at the rate of each.
+*
+* @param	BondPtr is a pointer to the bond.
+* @param	Length is the length of the encoded frame.
+* @param	AllowHeld is 1 to consider a UART held off after an error.
+*
+* @return	The index of the link, -1 if none has room for the frame.
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 UartBond_Pick(UartBond *BondPtr, u32 Length, u32 AllowHeld)
+{
+	UartBond_Link *LinkPtr;
+	XUartPs *UartPtr;
+	u32 Index;
+	u32 Free;
+	u32 Queued;
+	u32 BestQueued = 0U;
+	u32 BestRate = 1U;
+	s32 Best = -1;
+
+	for (Index = 0U; Index < UART_BOND_LINKS; Index++) {
+		LinkPtr = &BondPtr->Link[Index];
+		UartPtr = LinkPtr->UartPtr;
+		if ((UartPtr->TxBlocked != 0U) ||
+		    ((LinkPtr->HeldOff != 0U) && (AllowHeld == 0U))) {
+			continue;
+		}
+
+		Free = XUartPs_RingTxFree(UartPtr);
+		if (Free < Length) {
+			continue;
+		}
+		Queued = UartPtr->TxRing.Mask + 1U - Free + Length;
+
+		/* Queued / BaudRate below BestQueued / BestRate */
+		if ((Best < 0) ||
+		    (((u64)Queued * BestRate) <
+		     ((u64)BestQueued * UartPtr->BaudRate))) {
+			Best = (s32)Index;
+			BestQueued = Queued;
+			BestRate = UartPtr->BaudRate;
+		}
+	}
+
+	return Best;
+}
+
+/****************************************************************************/
+/*
+*
+* Takes a received frame: hands it over when it is next in sequence, keeps
+* it in its slot when it is ahead, drops it when it is behind.
+*
+* @param	BondPtr is a pointer to the bond.
+* @param	Index is the link it was received on.
+* @param	FramePtr is the frame, in the RX ring of the UART.
+* @param	Now is the current time.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartBond_Receive(UartBond *BondPtr, u32 Index,
+			     UartFrame *FramePtr, XTime Now)
+{
+	UartBond_Slot *SlotPtr;
+	u8 Header[UART_BOND_HEADER];
+	u32 Seq;
+	u32 Ahead;
+
+	if (FramePtr->TotalLength <= UART_BOND_HEADER) {
+		BondPtr->Stats.Link[Index].Errors++;
+		return;
+	}
+	BondPtr->Stats.Link[Index].RxPackets++;
+
+	UartBond_CopyOut(FramePtr, UART_BOND_HEADER, Header);
+	UartBond_StripHeader(FramePtr);
+	Seq = (u32)Header[0] | ((u32)Header[1] << 8U) |
+	      ((u32)Header[2] << 16U) | ((u32)Header[3] << 24U);
+
+	if (BondPtr->RxSynced == 0U) {
+		BondPtr->RxSeq = Seq;
+		BondPtr->RxSynced = 1U;
+	}
+
+	Ahead = Seq - BondPtr->RxSeq;
+	if (((s32)Ahead <= -(s32)UART_BOND_RESYNC) ||
+	    ((s32)Ahead >= (s32)UART_BOND_RESYNC)) {
+		UartBond_Resync(BondPtr, Seq);
+		Ahead = 0U;
+	} else if ((s32)Ahead < 0) {
+		BondPtr->Stats.Late++;
+		return;
+	} else {
+		/* Beyond the window: give up the oldest missing ones */
+		while ((Seq - BondPtr->RxSeq) >= UART_BOND_WINDOW) {
+			UartBond_Skip(BondPtr, Now);
+		}
+		Ahead = Seq - BondPtr->RxSeq;
+	}
+
+	if (Ahead == 0U) {
+		UartBond_Deliver(BondPtr, FramePtr);
+		BondPtr->RxSeq++;
+		UartBond_DeliverHeld(BondPtr, Now);
+		return;
+	}
+
+	SlotPtr = UartBond_SlotOf(BondPtr, Seq);
+	if (SlotPtr->Valid != 0U) {
+		BondPtr->Stats.Late++;
+		return;
+	}
+
+	UartBond_CopyOut(FramePtr, FramePtr->TotalLength, SlotPtr->Data);
+	SlotPtr->Length = FramePtr->TotalLength;
+	SlotPtr->Valid = 1U;
+	if (BondPtr->Held == 0U) {
+		BondPtr->HeldTime = Now;
+	}
+	BondPtr->Held++;
+}
+
+/****************************************************************************/
+/*
+*
+* Hands a packet to the handler.
+*
+* @param	BondPtr is a pointer to the bond.
+* @param	PacketPtr is the packet.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartBond_Deliver(UartBond *BondPtr, const UartFrame *PacketPtr)
+{
+	if (BondPtr->Handler != NULL) {
+		BondPtr->Handler(BondPtr->CallBackRef, PacketPtr);
+	}
+	BondPtr->Stats.Delivered++;
+}
+
+/****************************************************************************/
+/*
+*
+* Hands over the held packets that are now next in sequence.
+*
+* @param	BondPtr is a pointer to the bond.
+* @param	Now is the current time.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartBond_DeliverHeld(UartBond *BondPtr, XTime Now)
+{
+	UartBond_Slot *SlotPtr;
+	UartFrame Packet;
+	u32 Delivered = 0U;
+
+	for (;;) {
+		SlotPtr = UartBond_SlotOf(BondPtr, BondPtr->RxSeq);
+		if (SlotPtr->Valid == 0U) {
+			break;
+		}
+
+		Packet.DataPtr[0] = SlotPtr->Data;
+		Packet.Length[0] = SlotPtr->Length;
+		Packet.DataPtr[1] = NULL;
+		Packet.Length[1] = 0U;
+		Packet.TotalLength = SlotPtr->Length;
+		UartBond_Deliver(BondPtr, &Packet);
+
+		SlotPtr->Valid = 0U;
+		BondPtr->Held--;
+		BondPtr->RxSeq++;
+		BondPtr->Stats.Reordered++;
+		Delivered++;
+	}
+
+	/* The wait of what is left starts again */
+	if ((Delivered != 0U) && (BondPtr->Held != 0U)) {
+		BondPtr->HeldTime = Now;
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Gives up the expected packet, then hands over the held ones behind it.
+*
+* @param	BondPtr is a pointer to the bond.
+* @param	Now is the current time.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartBond_Skip(UartBond *BondPtr, XTime Now)
+{
+	BondPtr->RxSeq++;
+	BondPtr->Stats.Lost++;
+	UartBond_DeliverHeld(BondPtr, Now);
+}
+
+/****************************************************************************/
+/*
+*
+* Follows a peer that started again, dropping the held packets.
+*
+* @param	BondPtr is a pointer to the bond.
+* @param	Seq is the sequence number of its packet.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartBond_Resync(UartBond *BondPtr, u32 Seq)
+{
+	u32 Index;
+
+	for (Index = 0U; Index < UART_BOND_WINDOW; Index++) {
+		BondPtr->Slot[Index].Valid = 0U;
+	}
+	BondPtr->Held = 0U;
+	BondPtr->RxSeq = Seq;
+	BondPtr->Stats.Resyncs++;
+}
+
+/****************************************************************************/
+/*
+*
+* Holds a UART off from the stripes for UART_BOND_HOLDOFF_MS after its
+* engine dropped a bad frame.
+*
+* @param	BondPtr is a pointer to the bond.
+* @param	Index is the link.
+* @param	Now is the current time.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartBond_CheckErrors(UartBond *BondPtr, u32 Index, XTime Now)
+{
+	UartBond_Link *LinkPtr = &BondPtr->Link[Index];
+	const UartFrame_Stats *EngineStats = &LinkPtr->Engine.Stats;
+	u32 Errors;
+
+	Errors = EngineStats->CrcErrors + EngineStats->StuffErrors +
+		 EngineStats->Oversize;
+	if (Errors != LinkPtr->LastErrors) {
+		BondPtr->Stats.Link[Index].Errors += Errors - LinkPtr->LastErrors;
+		LinkPtr->LastErrors = Errors;
+		if (LinkPtr->HeldOff == 0U) {
+			BondPtr->Stats.Link[Index].HoldOffs++;
+		}
+		LinkPtr->HeldOff = 1U;
+		LinkPtr->ErrorTime = Now;
+	} else if ((LinkPtr->HeldOff != 0U) &&
+		   ((Now - LinkPtr->ErrorTime) >= BondPtr->HoldOffCounts)) {
+		LinkPtr->HeldOff = 0U;
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Copies the first bytes of a frame, which may wrap in the RX ring.
+*
+* @param	FramePtr is the frame.
+* @param	NumBytes is the number of bytes, within the frame.
+* @param	DataPtr receives them.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartBond_CopyOut(const UartFrame *FramePtr, u32 NumBytes,
+			     u8 *DataPtr)
+{
+	u32 First = FramePtr->Length[0];
+
+	if (First > NumBytes) {
+		First = NumBytes;
+	}
+	(void)memcpy(DataPtr, FramePtr->DataPtr[0], First);
+	(void)memcpy(&DataPtr[First], FramePtr->DataPtr[1], NumBytes - First);
+}
+
+/****************************************************************************/
+/*
+*
+* Removes the sequence number from the view of a frame, leaving the packet.
+*
+* @param	FramePtr is the frame.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartBond_StripHeader(UartFrame *FramePtr)
+{
+	u32 Skip = UART_BOND_HEADER;
+
+	if (FramePtr->Length[0] <= Skip) {
+		Skip -= FramePtr->Length[0];
+		FramePtr->DataPtr[0] = &FramePtr->DataPtr[1][Skip];
+		FramePtr->Length[0] = FramePtr->Length[1] - Skip;
+		FramePtr->Length[1] = 0U;
+	} else {
+		FramePtr->DataPtr[0] = &FramePtr->DataPtr[0][Skip];
+		FramePtr->Length[0] -= Skip;
+	}
+	FramePtr->TotalLength -= UART_BOND_HEADER;
+}
@@ -0,0 +1,167 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file uart_bond.h
+*
+* Bonding of two UARTs into one packet link, e.g. UART0 and UART1 wired to
+* the same two UARTs of another board, for up to the sum of their rates.
+*
+* Each packet goes as one frame of uart_frame.h on one of the UARTs, with
+* a sequence number, u32 little endian, in front of its bytes. The sender
+* picks, for each packet, the UART that will have sent it the soonest: the
+* one whose TX ring, with the packet, holds the fewest bit times at its
+* rate. A UART whose TX ring has no room for the whole frame, whose CTS is
+* deasserted, or that delivered a bad frame in the last
+* UART_BOND_HOLDOFF_MS is left out while the other one can take the
+* packet, so the stripes follow both the backpressure and the errors of
+* each link. The errors are those of the received direction of the UART,
+* which shares its cable and its clocking with the sent one.
+*
+* The receiver puts the packets back in order. A packet in sequence is
+* handed to the handler straight from the RX ring of its UART; one ahead of
+* the sequence is copied into one of UART_BOND_WINDOW slots until the ones
+* in front of it arrive. A missing packet is given up once a later one has
+* waited UART_BOND_REORDER_MS, or at once when one arrives beyond the
+* window, and counted as lost. A sequence far behind the expected one means
+* that the peer started again, and the receiver follows it.
+*
+* UartBond_Send() and UartBond_Poll() are called from one context, e.g. the
+* idle loop or a task of coro.h, and the handler is called from
+* UartBond_Poll().
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef UART_BOND_H
+#define UART_BOND_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xiltimer.h"
+#include "xuartps.h"
+#include "uart_frame.h"
+
+/************************** Constant Definitions ****************************/
+
+#define UART_BOND_LINKS		2U	/**< UARTs of a bond */
+#define UART_BOND_MAX_PAYLOAD	256U	/**< Largest packet */
+#define UART_BOND_HEADER	4U	/**< Sequence number of a frame */
+
+#ifndef UART_BOND_WINDOW
+#define UART_BOND_WINDOW	16U	/**< Packets held for reordering */
+#endif
+#ifndef UART_BOND_REORDER_MS
+#define UART_BOND_REORDER_MS	20U	/**< Longest wait for a missing one */
+#endif
+#ifndef UART_BOND_HOLDOFF_MS
+#define UART_BOND_HOLDOFF_MS	100U	/**< Link left out after an error */
+#endif
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Packet handler, called from UartBond_Poll() in sequence order. The bytes
+ * are in up to two segments and are only valid during the call.
+ */
+typedef void (*UartBond_Handler)(void *CallBackRef,
+				 const UartFrame *PacketPtr);
+
+/**
+ * Counts of one UART of a bond.
+ */
+typedef struct {
+	u32 TxPackets;
+	u32 RxPackets;
+	u32 Errors;		/**< Bad frames received */
+	u32 HoldOffs;		/**< Times it was left out after an error */
+} UartBond_LinkStats;
+
+/**
+ * Counts of a bond.
+ */
+typedef struct {
+	u32 Delivered;		/**< Packets handed to the handler */
+	u32 Reordered;		/**< Of them, held in a slot first */
+	u32 Lost;		/**< Sequence numbers given up */
+	u32 Late;		/**< Packets behind the sequence, dropped */
+	u32 Resyncs;		/**< The peer started again */
+	u32 Busy;		/**< Sends refused, no UART had room */
+	UartBond_LinkStats Link[UART_BOND_LINKS];
+} UartBond_Stats;
+
+/**
+ * One UART of a bond.
+ */
+typedef struct {
+	XUartPs *UartPtr;	/**< Driver instance in ring mode */
+	UartFrame_Engine Engine;
+	u32 LastErrors;		/**< Bad frames of the engine seen so far */
+	XTime ErrorTime;	/**< When the last one was seen */
+	u32 HeldOff;		/**< Since ErrorTime */
+} UartBond_Link;
+
+/**
+ * A packet held for reordering.
+ */
+typedef struct {
+	u32 Length;
+	u32 Valid;
+	u8 Data[UART_BOND_MAX_PAYLOAD];
+} UartBond_Slot;
+
+/**
+ * A bond.
+ */
+typedef struct {
+	UartBond_Link Link[UART_BOND_LINKS];
+	u32 Mode;		/**< UART_FRAME_COBS or UART_FRAME_SLIP */
+	u32 MaxPayload;		/**< Largest packet */
+	UartBond_Handler Handler;
+	void *CallBackRef;
+	u32 TxSeq;		/**< Sequence number of the next packet sent */
+	u32 RxSeq;		/**< Sequence number expected next */
+	u32 RxSynced;		/**< RxSeq is the one of the peer */
+	u32 Held;		/**< Slots in use */
+	XTime HeldTime;		/**< When the oldest held packet arrived */
+	XTime ReorderCounts;
+	XTime HoldOffCounts;
+	UartBond_Slot Slot[UART_BOND_WINDOW];	/**< By sequence number */
+	UartBond_Stats Stats;
+	u8 TxPayload[UART_BOND_HEADER + UART_BOND_MAX_PAYLOAD];
+	u8 TxFrame[(2U * (UART_BOND_HEADER + UART_BOND_MAX_PAYLOAD +
+			  UART_FRAME_CRC_SIZE)) + 2U];
+} UartBond;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+s32 UartBond_Initialize(UartBond *BondPtr, XUartPs *Uart0Ptr,
+			XUartPs *Uart1Ptr, u32 Mode, u32 MaxPayload);
+void UartBond_SetHandler(UartBond *BondPtr, UartBond_Handler Handler,
+			 void *CallBackRef);
+s32 UartBond_Send(UartBond *BondPtr, const u8 *DataPtr, u32 NumBytes);
+void UartBond_Poll(UartBond *BondPtr);
+void UartBond_GetStats(const UartBond *BondPtr, UartBond_Stats *StatsPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UART_BOND_H */
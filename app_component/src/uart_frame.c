@@ -0,0 +1,625 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file uart_frame.c
+*
+* Incremental COBS/SLIP framing with a streaming CRC-32. Refer to
+* uart_frame.h for a description of the frame format and of the design.
+*
+* The CRC is the IEEE 802.3 CRC-32, computed a byte at a time from a 1 KiB
+* table built on the first initialization. The engine keeps the CRC register
+* without the final inversion, so that running it over the payload and the
+* received CRC leaves the constant residue UART_FRAME_CRC_RESIDUE for a good
+* frame and no separate compare is needed.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xstatus.h"
+#include "uart_frame.h"
+
+/************************** Constant Definitions ****************************/
+
+#define UART_FRAME_CRC_POLY	0xEDB88320U	/* Reflected CRC-32 polynomial */
+#define UART_FRAME_CRC_INIT	0xFFFFFFFFU
+#define UART_FRAME_CRC_RESIDUE	0xDEBB20E3U	/* Register after a good CRC */
+
+#define UART_FRAME_COBS_DELIM	0x00U
+#define UART_FRAME_COBS_MAX_CODE 0xFFU	/* Block of 254 bytes, no zero */
+
+#define UART_FRAME_SLIP_END	0xC0U
+#define UART_FRAME_SLIP_ESC	0xDBU
+#define UART_FRAME_SLIP_ESC_END	0xDCU
+#define UART_FRAME_SLIP_ESC_ESC	0xDDU
+
+/**************************** Type Definitions ******************************/
+
+/* State of UartFrame_Encode() */
+typedef struct {
+	u32 Mode;
+	u8 *OutPtr;
+	u32 Pos;		/* Next byte of OutPtr to be written */
+	u32 CodePos;		/* COBS: where the current code byte goes */
+	u32 Code;		/* COBS: current code byte */
+} UartFrame_Encoder;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define UartFrame_CrcByte(Crc, Data) \
+	(UartFrame_CrcTable[((Crc) ^ (u32)(Data)) & 0xFFU] ^ ((Crc) >> 8))
+
+#define UartFrame_Delimiter(Mode) \
+	(((Mode) == UART_FRAME_COBS) ? UART_FRAME_COBS_DELIM : UART_FRAME_SLIP_END)
+
+/************************** Function Prototypes *****************************/
+
+static void UartFrame_BuildCrcTable(void);
+static u8 *UartFrame_At(UartFrame_Engine *EnginePtr, u32 Offset);
+static void UartFrame_Emit(UartFrame_Engine *EnginePtr, u8 Data);
+static void UartFrame_Decode(UartFrame_Engine *EnginePtr, u8 Data);
+static u32 UartFrame_EndOfFrame(UartFrame_Engine *EnginePtr);
+static void UartFrame_Restart(UartFrame_Engine *EnginePtr);
+static void UartFrame_FillView(UartFrame_Engine *EnginePtr,
+			       UartFrame *FramePtr);
+static void UartFrame_Put(UartFrame_Encoder *EncPtr, u8 Data);
+
+/************************** Variable Definitions ****************************/
+
+static u32 UartFrame_CrcTable[256];
+static u32 UartFrame_CrcTableReady;
+
+/****************************************************************************/
+/**
+*
+* Initializes a framing engine on the RX ring of a driver instance.
+*
+* @param	EnginePtr is a pointer to the engine.
+* @param	UartPtr is the driver instance, already in ring buffer mode.
+* @param	Mode is UART_FRAME_COBS or UART_FRAME_SLIP.
+* @param	MaxPayload is the largest payload accepted, without the CRC.
+*
+* @return
+*		- XST_SUCCESS if the engine was initialized.
+*		- XST_NOT_ENABLED if the instance is not in ring buffer mode.
+*		- XST_INVALID_PARAM if Mode is unknown or if the largest frame
+*		does not fit the RX ring, or its high-water mark when ring
+*		flow control is enabled.
+*
+* @note		The engine must be the only reader of the RX ring.
+*
+*****************************************************************************/
+s32 UartFrame_Initialize(UartFrame_Engine *EnginePtr, XUartPs *UartPtr,
+			 u32 Mode, u32 MaxPayload)
+{
+	u32 Limit;
+
+	if (UartPtr->RingMode == 0U) {
+		return XST_NOT_ENABLED;
+	}
+
+	if ((Mode != UART_FRAME_COBS) && (Mode != UART_FRAME_SLIP)) {
+		return XST_INVALID_PARAM;
+	}
+
+	/*
+	 * A frame is only handed out once it is complete in the ring, so the
+	 * largest frame must fit in what the ring is allowed to hold.
+	 */
+	Limit = UartPtr->RxRing.Mask + 1U;
+	if (UartPtr->RingFlowControl != 0U) {
+		Limit = UartPtr->RxHighWater;
+	}
+	if (UartFrame_MaxEncodedLength(Mode, MaxPayload) > Limit) {
+		return XST_INVALID_PARAM;
+	}
+
+	if (UartFrame_CrcTableReady == 0U) {
+		UartFrame_BuildCrcTable();
+	}
+
+	EnginePtr->UartPtr = UartPtr;
+	EnginePtr->Mode = Mode;
+	EnginePtr->MaxPayload = MaxPayload;
+	EnginePtr->MaxStuffed = UartFrame_MaxEncodedLength(Mode, MaxPayload);
+	EnginePtr->Stats.Frames = 0U;
+	EnginePtr->Stats.CrcErrors = 0U;
+	EnginePtr->Stats.StuffErrors = 0U;
+	EnginePtr->Stats.Oversize = 0U;
+	EnginePtr->Discard = 0U;
+	UartFrame_Restart(EnginePtr);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Examines the bytes received since the last call and returns the next
+* complete frame if there is one. Bad frames are dropped on the way.
+*
+* @param	EnginePtr is a pointer to the engine.
+* @param	FramePtr is where the view of the frame is stored.
+*
+* @return
+*		- XST_SUCCESS if a frame is returned.
+*		- XST_NO_DATA if no frame is complete yet.
+*
+* @note		Until UartFrame_Release() is called the same frame is returned
+*		again.
+*
+*****************************************************************************/
+s32 UartFrame_Poll(UartFrame_Engine *EnginePtr, UartFrame *FramePtr)
+{
+	u8 Delimiter = UartFrame_Delimiter(EnginePtr->Mode);
+	u32 Available;
+	u8 Data;
+
+	if (EnginePtr->IsReady != 0U) {
+		UartFrame_FillView(EnginePtr, FramePtr);
+		return XST_SUCCESS;
+	}
+
+	Available = XUartPs_RingPeek(EnginePtr->UartPtr, &EnginePtr->Span);
+
+	while (EnginePtr->ScanOffset < Available) {
+		Data = *UartFrame_At(EnginePtr, EnginePtr->ScanOffset);
+		EnginePtr->ScanOffset++;
+
+		if (Data != Delimiter) {
+			if (EnginePtr->Discard == 0U) {
+				UartFrame_Decode(EnginePtr, Data);
+			}
+			continue;
+		}
+
+		if ((EnginePtr->Discard == 0U) &&
+		    (UartFrame_EndOfFrame(EnginePtr) != 0U)) {
+			EnginePtr->IsReady = 1U;
+			EnginePtr->Stats.Frames++;
+			UartFrame_FillView(EnginePtr, FramePtr);
+			return XST_SUCCESS;
+		}
+
+		/* Drop the frame and start over behind the delimiter */
+		XUartPs_RingConsume(EnginePtr->UartPtr, EnginePtr->ScanOffset);
+		EnginePtr->Discard = 0U;
+		UartFrame_Restart(EnginePtr);
+		Available = XUartPs_RingPeek(EnginePtr->UartPtr,
+					     &EnginePtr->Span);
+	}
+
+	/* Nothing of a frame being discarded needs to stay in the ring */
+	if ((EnginePtr->Discard != 0U) && (EnginePtr->ScanOffset != 0U)) {
+		XUartPs_RingConsume(EnginePtr->UartPtr, EnginePtr->ScanOffset);
+		UartFrame_Restart(EnginePtr);
+	}
+
+	return XST_NO_DATA;
+}
+
+/****************************************************************************/
+/**
+*
+* Gives the ring space of the frame returned by UartFrame_Poll() back to the
+* driver. The view of the frame must not be used afterwards.
+*
+* @param	EnginePtr is a pointer to the engine.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void UartFrame_Release(UartFrame_Engine *EnginePtr)
+{
+	if (EnginePtr->IsReady == 0U) {
+		return;
+	}
+
+	XUartPs_RingConsume(EnginePtr->UartPtr, EnginePtr->ScanOffset);
+	UartFrame_Restart(EnginePtr);
+}
+
+/****************************************************************************/
+/**
+*
+* Builds the frame of a payload: the payload and its CRC-32, stuffed and
+* delimited. SLIP frames also start with END to flush line noise.
+*
+* @param	Mode is UART_FRAME_COBS or UART_FRAME_SLIP.
+* @param	DataPtr is the payload.
+* @param	NumBytes is the length of the payload.
+* @param	OutPtr is where the frame is stored.
+* @param	OutSize is the size of OutPtr.
+*
+* @return	The length of the frame, 0 if OutSize is smaller than
+*		UartFrame_MaxEncodedLength().
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 UartFrame_Encode(u32 Mode, const u8 *DataPtr, u32 NumBytes, u8 *OutPtr,
+		     u32 OutSize)
+{
+	UartFrame_Encoder Enc;
+	u32 Crc;
+	u32 Index;
+
+	if (OutSize < UartFrame_MaxEncodedLength(Mode, NumBytes)) {
+		return 0U;
+	}
+
+	if (UartFrame_CrcTableReady == 0U) {
+		UartFrame_BuildCrcTable();
+	}
+
+	Enc.Mode = Mode;
+	Enc.OutPtr = OutPtr;
+	Enc.Pos = 0U;
+	if (Mode == UART_FRAME_COBS) {
+		Enc.CodePos = Enc.Pos++;
+		Enc.Code = 1U;
+	} else {
+		OutPtr[Enc.Pos++] = UART_FRAME_SLIP_END;
+	}
+
+	Crc = UART_FRAME_CRC_INIT;
+	for (Index = 0U; Index < NumBytes; Index++) {
+		Crc = UartFrame_CrcByte(Crc, DataPtr[Index]);
+		UartFrame_Put(&Enc, DataPtr[Index]);
+	}
+
+	Crc = ~Crc;
+	for (Index = 0U; Index < UART_FRAME_CRC_SIZE; Index++) {
+		UartFrame_Put(&Enc, (u8)(Crc >> (Index * 8U)));
+	}
+
+	if (Mode == UART_FRAME_COBS) {
+		OutPtr[Enc.CodePos] = (u8)Enc.Code;
+		OutPtr[Enc.Pos++] = UART_FRAME_COBS_DELIM;
+	} else {
+		OutPtr[Enc.Pos++] = UART_FRAME_SLIP_END;
+	}
+
+	return Enc.Pos;
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the longest frame a payload can be encoded to.
+*
+* @param	Mode is UART_FRAME_COBS or UART_FRAME_SLIP.
+* @param	NumBytes is the length of the payload.
+*
+* @return	The worst case length of the frame on the wire.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 UartFrame_MaxEncodedLength(u32 Mode, u32 NumBytes)
+{
+	u32 Length = NumBytes + UART_FRAME_CRC_SIZE;
+
+	if (Mode == UART_FRAME_COBS) {
+		/* One code byte per 254 bytes, plus the delimiter */
+		return Length + (Length / 254U) + 2U;
+	}
+
+	/* Every byte may be escaped, plus the leading and trailing END */
+	return (2U * Length) + 2U;
+}
+
+/****************************************************************************/
+/**
+*
+* Computes the CRC-32 used by the frames, for instance to check a payload
+* assembled from several segments.
+*
+* @param	Crc is 0 to start, or the result of the previous call to
+*		continue.
+* @param	DataPtr is the data.
+* @param	NumBytes is the length of the data.
+*
+* @return	The CRC-32 of all the data so far.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 UartFrame_Crc32(u32 Crc, const u8 *DataPtr, u32 NumBytes)
+{
+	u32 Index;
+
+	if (UartFrame_CrcTableReady == 0U) {
+		UartFrame_BuildCrcTable();
+	}
+
+	Crc = ~Crc;
+	for (Index = 0U; Index < NumBytes; Index++) {
+		Crc = UartFrame_CrcByte(Crc, DataPtr[Index]);
+	}
+
+	return ~Crc;
+}
+
+/****************************************************************************/
+/*
+*
+* Builds the byte-wise CRC-32 table.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartFrame_BuildCrcTable(void)
+{
+	u32 Index;
+	u32 Bit;
+	u32 Crc;
+
+	for (Index = 0U; Index < 256U; Index++) {
+		Crc = Index;
+		for (Bit = 0U; Bit < 8U; Bit++) {
+			if ((Crc & 1U) != 0U) {
+				Crc = (Crc >> 1) ^ UART_FRAME_CRC_POLY;
+			} else {
+				Crc >>= 1;
+			}
+		}
+		UartFrame_CrcTable[Index] = Crc;
+	}
+
+	UartFrame_CrcTableReady = 1U;
+}
+
+/****************************************************************************/
+/*
+*
+* Returns the address in the RX ring of a byte of the frame.
+*
+* @param	EnginePtr is a pointer to the engine.
+* @param	Offset is the offset of the byte from the start of the frame.
+*
+* @return	The address of the byte.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u8 *UartFrame_At(UartFrame_Engine *EnginePtr, u32 Offset)
+{
+	if (Offset < EnginePtr->Span.Length[0]) {
+		return EnginePtr->Span.DataPtr[0] + Offset;
+	}
+
+	return EnginePtr->Span.DataPtr[1] + (Offset - EnginePtr->Span.Length[0]);
+}
+
+/****************************************************************************/
+/*
+*
+* Stores a decoded byte in place and adds it to the CRC. The decoded data
+* always lies behind the byte being examined, so nothing that is still to be
+* examined is overwritten.
+*
+* @param	EnginePtr is a pointer to the engine.
+* @param	Data is the decoded byte.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartFrame_Emit(UartFrame_Engine *EnginePtr, u8 Data)
+{
+	if (EnginePtr->OutOffset >=
+	    (EnginePtr->MaxPayload + UART_FRAME_CRC_SIZE)) {
+		EnginePtr->Stats.Oversize++;
+		EnginePtr->Discard = 1U;
+		return;
+	}
+
+	*UartFrame_At(EnginePtr, EnginePtr->OutOffset) = Data;
+	EnginePtr->OutOffset++;
+	EnginePtr->Crc = UartFrame_CrcByte(EnginePtr->Crc, Data);
+}
+
+/****************************************************************************/
+/*
+*
+* Unstuffs one byte of the frame, which is not a delimiter.
+*
+* @param	EnginePtr is a pointer to the engine.
+* @param	Data is the byte received.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartFrame_Decode(UartFrame_Engine *EnginePtr, u8 Data)
+{
+	if (EnginePtr->ScanOffset > EnginePtr->MaxStuffed) {
+		EnginePtr->Stats.Oversize++;
+		EnginePtr->Discard = 1U;
+		return;
+	}
+
+	if (EnginePtr->Mode == UART_FRAME_COBS) {
+		if (EnginePtr->BlockLeft != 0U) {
+			UartFrame_Emit(EnginePtr, Data);
+			EnginePtr->BlockLeft--;
+		} else {
+			/*
+			 * A code byte. The zero ending the previous block is
+			 * only real once another block follows it.
+			 */
+			if (EnginePtr->PendingZero != 0U) {
+				UartFrame_Emit(EnginePtr, 0U);
+			}
+			EnginePtr->BlockLeft = (u32)Data - 1U;
+			EnginePtr->PendingZero =
+				(Data != UART_FRAME_COBS_MAX_CODE) ? 1U : 0U;
+		}
+	} else {
+		if (EnginePtr->Escaped != 0U) {
+			EnginePtr->Escaped = 0U;
+			if (Data == UART_FRAME_SLIP_ESC_END) {
+				UartFrame_Emit(EnginePtr, UART_FRAME_SLIP_END);
+			} else if (Data == UART_FRAME_SLIP_ESC_ESC) {
+				UartFrame_Emit(EnginePtr, UART_FRAME_SLIP_ESC);
+			} else {
+				EnginePtr->Stats.StuffErrors++;
+				EnginePtr->Discard = 1U;
+			}
+		} else if (Data == UART_FRAME_SLIP_ESC) {
+			EnginePtr->Escaped = 1U;
+		} else {
+			UartFrame_Emit(EnginePtr, Data);
+		}
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Checks the frame once its delimiter has been seen. Delimiters without a
+* frame in between, as SLIP sends in front of every frame, are ignored
+* without being counted.
+*
+* @param	EnginePtr is a pointer to the engine.
+*
+* @return	Non-zero if the frame is good.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 UartFrame_EndOfFrame(UartFrame_Engine *EnginePtr)
+{
+	if (EnginePtr->ScanOffset == 1U) {
+		return 0U;
+	}
+
+	if ((EnginePtr->BlockLeft != 0U) || (EnginePtr->Escaped != 0U) ||
+	    (EnginePtr->OutOffset < UART_FRAME_CRC_SIZE)) {
+		EnginePtr->Stats.StuffErrors++;
+		return 0U;
+	}
+
+	if (EnginePtr->Crc != UART_FRAME_CRC_RESIDUE) {
+		EnginePtr->Stats.CrcErrors++;
+		return 0U;
+	}
+
+	return 1U;
+}
+
+/****************************************************************************/
+/*
+*
+* Starts a new frame at the tail of the RX ring. The discard state is kept.
+*
+* @param	EnginePtr is a pointer to the engine.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartFrame_Restart(UartFrame_Engine *EnginePtr)
+{
+	EnginePtr->ScanOffset = 0U;
+	EnginePtr->OutOffset = 0U;
+	EnginePtr->Crc = UART_FRAME_CRC_INIT;
+	EnginePtr->BlockLeft = 0U;
+	EnginePtr->PendingZero = 0U;
+	EnginePtr->Escaped = 0U;
+	EnginePtr->IsReady = 0U;
+	EnginePtr->Span.Length[0] = 0U;
+	EnginePtr->Span.Length[1] = 0U;
+}
+
+/****************************************************************************/
+/*
+*
+* Describes the payload of the ready frame, which starts at the tail of the
+* RX ring.
+*
+* @param	EnginePtr is a pointer to the engine.
+* @param	FramePtr is where the view is stored.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartFrame_FillView(UartFrame_Engine *EnginePtr,
+			       UartFrame *FramePtr)
+{
+	u32 Length = EnginePtr->OutOffset - UART_FRAME_CRC_SIZE;
+
+	FramePtr->TotalLength = Length;
+	FramePtr->DataPtr[0] = EnginePtr->Span.DataPtr[0];
+	FramePtr->DataPtr[1] = EnginePtr->Span.DataPtr[1];
+	if (Length > EnginePtr->Span.Length[0]) {
+		FramePtr->Length[0] = EnginePtr->Span.Length[0];
+		FramePtr->Length[1] = Length - EnginePtr->Span.Length[0];
+	} else {
+		FramePtr->Length[0] = Length;
+		FramePtr->Length[1] = 0U;
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Stuffs one byte of a frame being encoded.
+*
+* @param	EncPtr is a pointer to the encoder state.
+* @param	Data is the byte to be stuffed.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartFrame_Put(UartFrame_Encoder *EncPtr, u8 Data)
+{
+	if (EncPtr->Mode == UART_FRAME_COBS) {
+		if (Data == 0U) {
+			EncPtr->OutPtr[EncPtr->CodePos] = (u8)EncPtr->Code;
+			EncPtr->CodePos = EncPtr->Pos++;
+			EncPtr->Code = 1U;
+			return;
+		}
+
+		EncPtr->OutPtr[EncPtr->Pos++] = Data;
+		EncPtr->Code++;
+		if (EncPtr->Code == UART_FRAME_COBS_MAX_CODE) {
+			EncPtr->OutPtr[EncPtr->CodePos] = (u8)EncPtr->Code;
+			EncPtr->CodePos = EncPtr->Pos++;
+			EncPtr->Code = 1U;
+		}
+	} else if (Data == UART_FRAME_SLIP_END) {
+		EncPtr->OutPtr[EncPtr->Pos++] = UART_FRAME_SLIP_ESC;
+		EncPtr->OutPtr[EncPtr->Pos++] = UART_FRAME_SLIP_ESC_END;
+	} else if (Data == UART_FRAME_SLIP_ESC) {
+		EncPtr->OutPtr[EncPtr->Pos++] = UART_FRAME_SLIP_ESC;
+		EncPtr->OutPtr[EncPtr->Pos++] = UART_FRAME_SLIP_ESC_ESC;
+	} else {
+		EncPtr->OutPtr[EncPtr->Pos++] = Data;
+	}
+}
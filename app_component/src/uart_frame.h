@@ -0,0 +1,121 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file uart_frame.h
+*
+* Incremental framing engine for the packet protocol carried over a UART
+* link.
+*
+* A packet is sent as its payload followed by the CRC-32 of the payload,
+* least significant byte first, stuffed with COBS or SLIP and terminated by
+* a delimiter byte: 0x00 for COBS and 0xC0 (END) for SLIP.
+*
+* The engine works directly on the RX ring of an XUartPs instance in ring
+* buffer mode, through XUartPs_RingPeek(). Each call of UartFrame_Poll()
+* carries on from the byte where the previous one stopped, so every received
+* byte is examined exactly once. The byte is unstuffed in place, the decoded
+* data never being longer than the stuffed data, and fed to the CRC in the
+* same pass. By the time the delimiter is seen the frame has been decoded and
+* checked, and it is handed out as a view into the ring. The view stays valid
+* until UartFrame_Release() gives the ring space back to the driver.
+*
+* Frames with a bad CRC, a stuffing error or more than the maximum payload
+* are dropped and counted, and the engine resynchronizes on the next
+* delimiter.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef UART_FRAME_H
+#define UART_FRAME_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xuartps.h"
+
+/************************** Constant Definitions ****************************/
+
+/** @name Framing modes
+ * @{
+ */
+#define UART_FRAME_COBS		0U	/**< COBS, 0x00 delimiter */
+#define UART_FRAME_SLIP		1U	/**< SLIP (RFC 1055), END delimiter */
+/* @} */
+
+#define UART_FRAME_CRC_SIZE	4U	/**< CRC-32 trailer of a frame */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * A received frame. The payload is in the RX ring and may wrap around the
+ * end of the ring storage, in which case it continues at DataPtr[1].
+ */
+typedef struct {
+	u8 *DataPtr[2];		/**< Start of each segment */
+	u32 Length[2];		/**< Payload bytes in each segment */
+	u32 TotalLength;	/**< Length[0] + Length[1] */
+} UartFrame;
+
+/**
+ * Error counters of an engine.
+ */
+typedef struct {
+	u32 Frames;		/**< Good frames handed out */
+	u32 CrcErrors;		/**< Frames dropped for a bad CRC */
+	u32 StuffErrors;	/**< Frames dropped for a stuffing error */
+	u32 Oversize;		/**< Frames dropped for being too long */
+} UartFrame_Stats;
+
+/**
+ * The framing engine of one UART. Offsets count bytes from the first byte
+ * of the frame, which is the tail of the RX ring.
+ */
+typedef struct {
+	XUartPs *UartPtr;	/**< Driver instance in ring mode */
+	u32 Mode;		/**< UART_FRAME_COBS or UART_FRAME_SLIP */
+	u32 MaxPayload;		/**< Largest payload accepted */
+	u32 MaxStuffed;		/**< Largest frame on the wire */
+	XUartPsRingSpan Span;	/**< Ring data at the last poll */
+	u32 ScanOffset;		/**< Bytes of the ring examined */
+	u32 OutOffset;		/**< Decoded bytes stored */
+	u32 Crc;		/**< CRC register over the decoded bytes */
+	u32 BlockLeft;		/**< COBS: data bytes left in the block */
+	u32 PendingZero;	/**< COBS: block ends with an implicit 0 */
+	u32 Escaped;		/**< SLIP: the previous byte was ESC */
+	u32 Discard;		/**< Skipping up to the next delimiter */
+	u32 IsReady;		/**< A frame is handed out */
+	UartFrame_Stats Stats;
+} UartFrame_Engine;
+
+/************************** Function Prototypes *****************************/
+
+s32 UartFrame_Initialize(UartFrame_Engine *EnginePtr, XUartPs *UartPtr,
+			 u32 Mode, u32 MaxPayload);
+s32 UartFrame_Poll(UartFrame_Engine *EnginePtr, UartFrame *FramePtr);
+void UartFrame_Release(UartFrame_Engine *EnginePtr);
+u32 UartFrame_Encode(u32 Mode, const u8 *DataPtr, u32 NumBytes, u8 *OutPtr,
+		     u32 OutSize);
+u32 UartFrame_MaxEncodedLength(u32 Mode, u32 NumBytes);
+u32 UartFrame_Crc32(u32 Crc, const u8 *DataPtr, u32 NumBytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UART_FRAME_H */
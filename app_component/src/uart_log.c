@@ -0,0 +1,181 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file uart_log.c
+*
+* Deferred binary logging. Refer to uart_log.h for the record format.
+*
+* Records are stored in a ring of words with the interrupts masked, so
+* UART_LOG() may be used from any context. UartLog_Drain() must be called
+* from a single context, normally the idle loop.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xil_assert.h"
+#include "xil_io.h"
+#include "xpseudo_asm.h"
+#include "xtime_l.h"
+#include "xuartps_hw.h"
+#include "uart_log.h"
+
+/************************** Constant Definitions ****************************/
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define UartLog_Header(Id, NumArgs) \
+	(((Id) << 16) | ((NumArgs) << 8) | UART_LOG_SYNC)
+
+#define UartLog_HeaderArgs(Header)	(((Header) >> 8) & 0xFFU)
+
+/************************** Function Prototypes *****************************/
+
+/************************** Variable Definitions ****************************/
+
+static struct {
+	u32 *BufferPtr;		/* NULL until initialized */
+	u32 Mask;		/* Words in the ring minus one */
+	volatile u32 Head;	/* Next word to be written */
+	volatile u32 Tail;	/* Next word to be sent */
+	u32 Dropped;		/* Records lost on a full ring */
+} UartLog;
+
+/****************************************************************************/
+/**
+*
+* Attaches the record ring. Records logged before are dropped.
+*
+* @param	BufferPtr is the storage of the ring.
+* @param	NumWords is the size of the storage in words, a power of two
+*		of at least UART_LOG_MAX_RECORD / 4.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void UartLog_Initialize(u32 *BufferPtr, u32 NumWords)
+{
+	Xil_AssertVoid(BufferPtr != NULL);
+	Xil_AssertVoid((NumWords >= (UART_LOG_MAX_RECORD / 4U)) &&
+		       ((NumWords & (NumWords - 1U)) == 0U));
+
+	UartLog.BufferPtr = NULL;
+	UartLog.Head = 0U;
+	UartLog.Tail = 0U;
+	UartLog.Dropped = 0U;
+	UartLog.Mask = NumWords - 1U;
+	UartLog.BufferPtr = BufferPtr;
+}
+
+/****************************************************************************/
+/**
+*
+* Stores one record. This is the back end of UART_LOG().
+*
+* @param	FmtId is the address of the format string.
+* @param	ArgsPtr points to the argument words.
+* @param	NumArgs is the number of arguments.
+*
+* @return	None.
+*
+* @note		The record is dropped if the ring is full or not attached.
+*
+*****************************************************************************/
+void UartLog_Write(u32 FmtId, const u32 *ArgsPtr, u32 NumArgs)
+{
+	u32 *BufferPtr = UartLog.BufferPtr;
+	u32 Mask = UartLog.Mask;
+	u32 Cpsr;
+	u32 Head;
+	u32 Index;
+
+	if (BufferPtr == NULL) {
+		return;
+	}
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	Head = UartLog.Head;
+	if ((Mask + 1U - (Head - UartLog.Tail)) < (NumArgs + 2U)) {
+		UartLog.Dropped++;
+	} else {
+		BufferPtr[Head & Mask] = UartLog_Header(FmtId, NumArgs);
+		BufferPtr[(Head + 1U) & Mask] =
+			Xil_In32(GLOBAL_TMR_BASEADDR +
+				 GTIMER_COUNTER_LOWER_OFFSET);
+		for (Index = 0U; Index < NumArgs; Index++) {
+			BufferPtr[(Head + 2U + Index) & Mask] = ArgsPtr[Index];
+		}
+		UartLog.Head = Head + NumArgs + 2U;
+	}
+	mtcpsr(Cpsr);
+}
+
+/****************************************************************************/
+/**
+*
+* Moves whole records to the standard output until the ring is empty or
+* the standard output has no room for the next record.
+*
+* @return	The number of words still in the ring.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 UartLog_Drain(void)
+{
+	u32 Record[UART_LOG_MAX_RECORD / 4U];
+	u32 Tail = UartLog.Tail;
+	u32 Head = UartLog.Head;
+	u32 Length;
+	u32 Index;
+
+	while (Tail != Head) {
+		Record[0] = UartLog.BufferPtr[Tail & UartLog.Mask];
+		Length = UartLog_HeaderArgs(Record[0]) + 2U;
+		for (Index = 1U; Index < Length; Index++) {
+			Record[Index] =
+				UartLog.BufferPtr[(Tail + Index) & UartLog.Mask];
+		}
+
+		/* Little endian, the words go out as they are stored */
+		if (XUartPs_StdoutWrite((const u8 *)Record, Length * 4U) == 0U) {
+			break;
+		}
+		Tail += Length;
+		UartLog.Tail = Tail;
+	}
+
+	return Head - Tail;
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the number of records dropped because the ring was full.
+*
+* @return	The number of dropped records.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 UartLog_Dropped(void)
+{
+	return UartLog.Dropped;
+}
@@ -0,0 +1,107 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file uart_log.h
+*
+* Deferred binary logging over the standard output.
+*
+* xil_printf() formats every argument at runtime, one character at a time,
+* and sends the whole text. UART_LOG() takes the same format string and
+* arguments but formats nothing: the call site stores a record made of the
+* ID of the format string, a time stamp and the raw argument words into a
+* RAM ring, which costs tens of cycles. UartLog_Drain() later moves the
+* records to the standard output, where they are mixed with the text
+* output, and tools/uart_log_decode.py rebuilds the text on the host from
+* the format strings in the ELF file.
+*
+* The format strings are placed in the .uart_log_fmt section, which the
+* linker script keeps in the ELF file at address 0 without loading it, so
+* they take no target memory and the address of a string is its ID. IDs are
+* 16 bits wide, which limits the section to 64 KB of format strings.
+*
+* A record is sent as little endian words:
+*
+* - word 0: ID << 16 | number of arguments << 8 | UART_LOG_SYNC. The sync
+*   byte is not valid 7-bit text, which lets the decoder find the records
+*   in the text output.
+* - word 1: the lower word of the global timer, COUNTS_PER_SECOND ticks
+*   per second.
+* - one word per argument.
+*
+* Each argument is a single word, so %d, %u, %x, %X and %c are supported.
+* The decoder cannot follow pointers, so %s prints the address of the
+* string, and 64-bit arguments are not supported.
+*
+* Records that do not fit in the ring are dropped and counted. The standard
+* output log ring, if attached with XUartPs_StdoutSetBuffer(), must hold at
+* least UART_LOG_MAX_RECORD bytes.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef UART_LOG_H
+#define UART_LOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+
+/************************** Constant Definitions ****************************/
+
+#define UART_LOG_SECTION	".uart_log_fmt"	/**< Format string section */
+#define UART_LOG_SYNC		0xA5U	/**< Lowest byte of a record */
+#define UART_LOG_MAX_ARGS	6U	/**< Arguments of a record */
+
+/** Largest record in bytes */
+#define UART_LOG_MAX_RECORD	((2U + UART_LOG_MAX_ARGS) * 4U)
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/****************************************************************************/
+/**
+*
+* Logs a message in deferred form.
+*
+* @param	Fmt is the format string, a string literal.
+* @param	... are up to UART_LOG_MAX_ARGS word sized arguments.
+*
+*****************************************************************************/
+#define UART_LOG(Fmt, ...) \
+	do { \
+		static const char UartLog_Fmt[] \
+			__attribute__((section(UART_LOG_SECTION))) = Fmt; \
+		const u32 UartLog_Args[] = { 0U, ##__VA_ARGS__ }; \
+		_Static_assert(sizeof(UartLog_Args) <= \
+			       ((UART_LOG_MAX_ARGS + 1U) * sizeof(u32)), \
+			       "too many UART_LOG arguments"); \
+		UartLog_Write((u32)(UINTPTR)UartLog_Fmt, &UartLog_Args[1], \
+			      (u32)(sizeof(UartLog_Args) / sizeof(u32)) - 1U); \
+	} while (0)
+
+/************************** Function Prototypes *****************************/
+
+void UartLog_Initialize(u32 *BufferPtr, u32 NumWords);
+void UartLog_Write(u32 FmtId, const u32 *ArgsPtr, u32 NumArgs);
+u32 UartLog_Drain(void);
+u32 UartLog_Dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UART_LOG_H */
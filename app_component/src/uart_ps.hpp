@@ -0,0 +1,244 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file uart_ps.hpp
+*
+* Polled PS UART as a C++ type over hw_reg.hpp: the base address, the
+* reference clock and the modem signals are template arguments, taken from
+* xparameters.h by the Uart0 and Uart1 aliases.
+*
+* Nothing is looked up at run time. XUartPs_LookupConfig() and the
+* Config.BaseAddress of an instance become constants folded into each
+* access, the divisors of a baud rate given as a template argument are
+* searched by the compiler, and a rate the clock cannot reach within
+* XUARTPS_MAX_BAUD_ERROR_RATE percent does not compile. Code for the modem
+* signals compiles in only when the UART has them.
+*
+* This is the polled mode for bring-up, the FSBL-like early code and small
+* tools; the interrupt, ring buffer and DMA modes stay with the xuartps
+* driver, which can be initialized on the same UART afterwards.
+*
+* @code
+*	hw::Uart0::Initialize<115200U>();
+*	hw::Uart0::Send(Msg, sizeof(Msg));
+* @endcode
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef UART_PS_HPP
+#define UART_PS_HPP
+
+/***************************** Include Files ********************************/
+
+#include "xparameters.h"
+#include "xuartps_hw.h"
+#include "xuartps.h"
+#include "hw_reg.hpp"
+
+namespace hw {
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Divisors of a baud rate: Rate = Clock / (Cd * (Bdiv + 1)).
+ */
+struct UartPsBaud {
+	u32 Cd;
+	u32 Bdiv;
+	u32 Error;		/**< Distance to the rate asked for, in bps */
+};
+
+/**
+ * Divisors closest to Baud, the search of XUartPs_SetBaudRate(), at
+ * compile time. Cd is 0 when no divisor reaches the rate.
+ */
+constexpr UartPsBaud UartPsFindBaud(u32 ClockHz, u32 Baud)
+{
+	UartPsBaud Best = { 0U, 0U, 0xFFFFFFFFU };
+
+	for (u32 Bdiv = 4U; Bdiv < 255U; Bdiv++) {
+		u32 Cd = ((ClockHz / (Bdiv + 1U)) + (Baud / 2U)) / Baud;
+		if ((Cd == 0U) || (Cd > 0xFFFFU)) {
+			continue;
+		}
+		u32 Rate = ClockHz / (Cd * (Bdiv + 1U));
+		u32 Error = (Rate > Baud) ? (Rate - Baud) : (Baud - Rate);
+		if (Error < Best.Error) {
+			Best = { Cd, Bdiv, Error };
+		}
+	}
+
+	return Best;
+}
+
+/**
+ * A PS UART at Base, on a reference clock of ClockHz.
+ */
+template <UINTPTR Base, u32 ClockHz, bool HasModem = false>
+class UartPs {
+public:
+	/** @name Registers
+	 * @{
+	 */
+	using Cr = Reg<Base + XUARTPS_CR_OFFSET>;
+	using Mr = Reg<Base + XUARTPS_MR_OFFSET>;
+	using Ier = Reg<Base + XUARTPS_IER_OFFSET>;
+	using Idr = Reg<Base + XUARTPS_IDR_OFFSET>;
+	using Isr = Reg<Base + XUARTPS_ISR_OFFSET>;
+	using BaudGen = Reg<Base + XUARTPS_BAUDGEN_OFFSET>;
+	using RxTout = Reg<Base + XUARTPS_RXTOUT_OFFSET>;
+	using RxWm = Reg<Base + XUARTPS_RXWM_OFFSET>;
+	using ModemCr = Reg<Base + XUARTPS_MODEMCR_OFFSET>;
+	using ModemSr = Reg<Base + XUARTPS_MODEMSR_OFFSET>;
+	using Sr = Reg<Base + XUARTPS_SR_OFFSET>;
+	using Fifo = Reg<Base + XUARTPS_FIFO_OFFSET>;
+	using BaudDiv = Reg<Base + XUARTPS_BAUDDIV_OFFSET>;
+	using TxWm = Reg<Base + XUARTPS_TXWM_OFFSET>;
+	/* @} */
+
+	/** @name Fields
+	 * @{
+	 */
+	using CrRxRst = Field<Cr, 0U, 1U>;
+	using CrTxRst = Field<Cr, 1U, 1U>;
+	using CrRxEn = Field<Cr, 2U, 1U>;
+	using CrRxDis = Field<Cr, 3U, 1U>;
+	using CrTxEn = Field<Cr, 4U, 1U>;
+	using CrTxDis = Field<Cr, 5U, 1U>;
+	using MrClkSel = Field<Mr, 0U, 1U>;
+	using MrCharLen = Field<Mr, 1U, 2U>;
+	using MrParity = Field<Mr, 3U, 3U>;
+	using MrStop = Field<Mr, 6U, 2U>;
+	using MrChMode = Field<Mr, 8U, 2U>;
+	using SrRxEmpty = Field<Sr, 1U, 1U>;
+	using SrTxEmpty = Field<Sr, 3U, 1U>;
+	using SrTxFull = Field<Sr, 4U, 1U>;
+	using SrTxActive = Field<Sr, 11U, 1U>;
+	using ModemCrDtr = Field<ModemCr, 0U, 1U>;
+	using ModemCrRts = Field<ModemCr, 1U, 1U>;
+	using ModemCrFcm = Field<ModemCr, 5U, 1U>;
+	/* @} */
+
+	/**
+	 * Resets the UART and starts it at Baud, 8 data bits, no parity and
+	 * one stop bit, with the interrupts disabled.
+	 */
+	template <u32 Baud>
+	static void Initialize()
+	{
+		constexpr UartPsBaud Divisors = UartPsFindBaud(ClockHz, Baud);
+
+		static_assert((Baud != 0U) && (Baud <= XUARTPS_MAX_RATE),
+			      "baud rate out of range");
+		static_assert((Divisors.Cd != 0U) &&
+			      ((Divisors.Error * 100U) <=
+			       (Baud * XUARTPS_MAX_BAUD_ERROR_RATE)),
+			      "baud rate not reachable from the UART clock");
+
+		Cr::Write(CrTxDis::Mask | CrRxDis::Mask);
+		Idr::Write(XUARTPS_IXR_MASK);
+		Isr::Write(XUARTPS_IXR_MASK);
+
+		BaudGen::Write(Divisors.Cd);
+		BaudDiv::Write(Divisors.Bdiv);
+		Mr::Write(MrParity::template Value<4U>());
+		RxWm::Write(XUARTPS_RXWM_RESET_VAL);
+		RxTout::Write(0U);
+		if constexpr (HasModem) {
+			ModemCr::Write(ModemCrDtr::Mask | ModemCrRts::Mask);
+		}
+
+		Cr::Write(CrTxRst::Mask | CrRxRst::Mask);
+		while ((Cr::Read() & (CrTxRst::Mask | CrRxRst::Mask)) != 0U) {
+		}
+		Cr::Write(CrTxEn::Mask | CrRxEn::Mask | XUARTPS_CR_STOPBRK);
+	}
+
+	static inline bool IsTxFull()
+	{
+		return SrTxFull::IsSet();
+	}
+
+	static inline bool IsRxEmpty()
+	{
+		return SrRxEmpty::IsSet();
+	}
+
+	/** Waits for room in the TX FIFO and writes a byte */
+	static inline void PutByte(u8 Data)
+	{
+		while (IsTxFull()) {
+		}
+		Fifo::Write(Data);
+	}
+
+	/** Reads a byte if one was received, returns false otherwise */
+	static inline bool GetByte(u8 &Data)
+	{
+		if (IsRxEmpty()) {
+			return false;
+		}
+		Data = static_cast<u8>(Fifo::Read());
+		return true;
+	}
+
+	static void Send(const u8 *DataPtr, u32 NumBytes)
+	{
+		for (u32 Index = 0U; Index < NumBytes; Index++) {
+			PutByte(DataPtr[Index]);
+		}
+	}
+
+	/** Reads what the RX FIFO holds, up to NumBytes, returns the count */
+	static u32 Recv(u8 *DataPtr, u32 NumBytes)
+	{
+		u32 Count = 0U;
+
+		while ((Count < NumBytes) && GetByte(DataPtr[Count])) {
+			Count++;
+		}
+		return Count;
+	}
+
+	/** Waits for the last byte to leave the shift register */
+	static void Drain()
+	{
+		while (!SrTxEmpty::IsSet() || SrTxActive::IsSet()) {
+		}
+	}
+
+	/** Hardware RTS/CTS flow control, on a UART with modem signals */
+	template <bool Modem = HasModem>
+	static void SetFlowControl(bool Enable)
+	{
+		static_assert(Modem, "the UART has no modem signals");
+		ModemCrFcm::Write(Enable ? 1U : 0U);
+	}
+};
+
+/**************************** Type Definitions ******************************/
+
+#ifdef XPAR_XUARTPS_0_BASEADDR
+using Uart0 = UartPs<XPAR_XUARTPS_0_BASEADDR, XPAR_XUARTPS_0_CLOCK_FREQ,
+		     (XPAR_XUARTPS_0_HAS_MODEM != 0)>;
+#endif
+#ifdef XPAR_XUARTPS_1_BASEADDR
+using Uart1 = UartPs<XPAR_XUARTPS_1_BASEADDR, XPAR_XUARTPS_1_CLOCK_FREQ,
+		     (XPAR_XUARTPS_1_HAS_MODEM != 0)>;
+#endif
+
+} /* namespace hw */
+
+#endif /* UART_PS_HPP */
@@ -0,0 +1,500 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file uart_sched.c
+*
+* Multiplexes several UART ports onto a single event loop with deficit round
+* robin fairness. Refer to uart_sched.h for a description of the design.
+*
+* The interrupt handlers only set bits in the Events and TxPending words of a
+* port, the loop clears them with a plain store before it services the port,
+* so anything signalled while the port is being serviced is seen in the next
+* round. The events of a PL port are recorded in its PlUart by the hub
+* handler instead, and taken the same way.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Added the PL UART ports of pl_uart.h.
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xstatus.h"
+#include "uart_sched.h"
+
+/************************** Constant Definitions ****************************/
+
+/* Rounds of credit a port blocked on a full ring may accumulate */
+#define UART_SCHED_MAX_ROUNDS	2U
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define UartSched_Min(A, B)	(((A) < (B)) ? (A) : (B))
+
+/************************** Function Prototypes *****************************/
+
+static s32 UartSched_Insert(UartSched *SchedPtr, UartSched_Port *PortPtr,
+			    u32 Priority, u32 Quantum);
+static u32 UartSched_RxCount(UartSched_Port *PortPtr);
+static u32 UartSched_TxFree(UartSched_Port *PortPtr);
+static u32 UartSched_IsBusy(UartSched_Port *PortPtr);
+static u32 UartSched_ServiceRx(UartSched_Port *PortPtr);
+static u32 UartSched_ServiceTx(UartSched_Port *PortPtr);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* Initializes a scheduler without any port.
+*
+* @param	SchedPtr is a pointer to the scheduler.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void UartSched_Initialize(UartSched *SchedPtr)
+{
+	SchedPtr->NumPorts = 0U;
+}
+
+/****************************************************************************/
+/**
+*
+* Adds a port to the scheduler. The port is kept in priority order, ports of
+* the same priority in the order they were added.
+*
+* @param	SchedPtr is a pointer to the scheduler.
+* @param	PortPtr is the port state, owned by the caller.
+* @param	UartPtr is the driver instance, already in ring buffer mode.
+* @param	Priority is the priority of the port, higher is served first.
+* @param	Quantum is the number of bytes the port may move per round.
+*
+* @return
+*		- XST_SUCCESS if the port was added.
+*		- XST_INVALID_PARAM if Quantum is 0.
+*		- XST_NOT_ENABLED if the instance is not in ring buffer mode.
+*		- XST_FAILURE if the scheduler already has
+*		UART_SCHED_MAX_PORTS ports.
+*
+* @note		The port handlers must be set with UartSched_SetHandlers()
+*		before the first call to UartSched_Run().
+*
+*****************************************************************************/
+s32 UartSched_AddPort(UartSched *SchedPtr, UartSched_Port *PortPtr,
+		      XUartPs *UartPtr, u32 Priority, u32 Quantum)
+{
+	if (UartPtr->RingMode == 0U) {
+		return XST_NOT_ENABLED;
+	}
+
+	PortPtr->UartPtr = UartPtr;
+	PortPtr->PlUartPtr = NULL;
+
+	return UartSched_Insert(SchedPtr, PortPtr, Priority, Quantum);
+}
+
+/****************************************************************************/
+/**
+*
+* Adds a PL port to the scheduler, like UartSched_AddPort() does an XUartPs
+* one.
+*
+* @param	SchedPtr is a pointer to the scheduler.
+* @param	PortPtr is the port state, owned by the caller.
+* @param	PlUartPtr is the PL port, set up with PlUart_Initialize().
+* @param	Priority is the priority of the port, higher is served first.
+* @param	Quantum is the number of bytes the port may move per round.
+*
+* @return
+*		- XST_SUCCESS if the port was added.
+*		- XST_INVALID_PARAM if Quantum is 0.
+*		- XST_NOT_ENABLED if the PL port is not set up.
+*		- XST_FAILURE if the scheduler already has
+*		UART_SCHED_MAX_PORTS ports.
+*
+* @note		The interrupt of the PL port is serviced by its hub, not by
+*		UartSched_InterruptHandler().
+*
+*****************************************************************************/
+s32 UartSched_AddPlPort(UartSched *SchedPtr, UartSched_Port *PortPtr,
+			PlUart *PlUartPtr, u32 Priority, u32 Quantum)
+{
+	if (PlUartPtr->IsReady == 0U) {
+		return XST_NOT_ENABLED;
+	}
+
+	PortPtr->UartPtr = NULL;
+	PortPtr->PlUartPtr = PlUartPtr;
+
+	return UartSched_Insert(SchedPtr, PortPtr, Priority, Quantum);
+}
+
+/****************************************************************************/
+/*
+*
+* Inserts a port in the scheduler, in priority order, ports of the same
+* priority in the order they were added.
+*
+* @param	SchedPtr is a pointer to the scheduler.
+* @param	PortPtr is the port, its UART already set.
+* @param	Priority is the priority of the port, higher is served first.
+* @param	Quantum is the number of bytes the port may move per round.
+*
+* @return	As UartSched_AddPort().
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 UartSched_Insert(UartSched *SchedPtr, UartSched_Port *PortPtr,
+			    u32 Priority, u32 Quantum)
+{
+	u32 Index;
+
+	if (Quantum == 0U) {
+		return XST_INVALID_PARAM;
+	}
+
+	if (SchedPtr->NumPorts >= UART_SCHED_MAX_PORTS) {
+		return XST_FAILURE;
+	}
+
+	PortPtr->Priority = Priority;
+	PortPtr->Quantum = Quantum;
+	PortPtr->Deficit = 0U;
+	PortPtr->Events = 0U;
+	PortPtr->TxPending = 0U;
+	PortPtr->RxHandler = NULL;
+	PortPtr->TxHandler = NULL;
+	PortPtr->CallBackRef = NULL;
+	PortPtr->RxOffset = 0U;
+	PortPtr->RxLength = 0U;
+
+	/* Insert after the last port of the same or a higher priority */
+	Index = SchedPtr->NumPorts;
+	while ((Index > 0U) && (SchedPtr->Port[Index - 1U]->Priority < Priority)) {
+		SchedPtr->Port[Index] = SchedPtr->Port[Index - 1U];
+		Index--;
+	}
+	SchedPtr->Port[Index] = PortPtr;
+	SchedPtr->NumPorts++;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Sets the handlers through which a port exchanges data with the application.
+*
+* @param	PortPtr is a pointer to the port.
+* @param	RxHandler is called with received data, NULL to leave the
+*		received data in the RX ring.
+* @param	TxHandler is called for data to send, NULL if the port does
+*		not send.
+* @param	CallBackRef is passed back to both handlers.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void UartSched_SetHandlers(UartSched_Port *PortPtr,
+			   UartSched_RxHandler RxHandler,
+			   UartSched_TxHandler TxHandler, void *CallBackRef)
+{
+	PortPtr->RxHandler = RxHandler;
+	PortPtr->TxHandler = TxHandler;
+	PortPtr->CallBackRef = CallBackRef;
+}
+
+/****************************************************************************/
+/**
+*
+* Tells the scheduler that the producer of a port has data to send. The TX
+* handler is then called in the following rounds until it returns 0. May be
+* called from an interrupt handler.
+*
+* @param	PortPtr is a pointer to the port.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void UartSched_KickTx(UartSched_Port *PortPtr)
+{
+	PortPtr->TxPending = 1U;
+}
+
+/****************************************************************************/
+/**
+*
+* Interrupt handler of a scheduled port, to be connected instead of
+* XUartPs_InterruptHandler(). The pending interrupt status is recorded for
+* the event loop before the driver handler services the FIFOs.
+*
+* @param	PortPtr is a pointer to the port.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void UartSched_InterruptHandler(UartSched_Port *PortPtr)
+{
+	u32 BaseAddress = PortPtr->UartPtr->Config.BaseAddress;
+	u32 IsrStatus;
+
+	IsrStatus = XUartPs_ReadReg(BaseAddress, XUARTPS_IMR_OFFSET) &
+		    XUartPs_ReadReg(BaseAddress, XUARTPS_ISR_OFFSET);
+	PortPtr->Events |= IsrStatus;
+
+	XUartPs_InterruptHandler(PortPtr->UartPtr);
+}
+
+/****************************************************************************/
+/**
+*
+* Runs one round of the scheduler. Every port with work is credited its
+* quantum and moves up to its credit between its rings and the application,
+* receive first. Ports are visited from the highest priority down. A port
+* without work loses its credit, as deficit round robin requires.
+*
+* @param	SchedPtr is a pointer to the scheduler.
+*
+* @return	The number of bytes moved in this round, 0 when all ports
+*		are idle.
+*
+* @note		Call it from the event loop, it never blocks.
+*
+*****************************************************************************/
+u32 UartSched_Run(UartSched *SchedPtr)
+{
+	UartSched_Port *PortPtr;
+	u32 Moved = 0U;
+	u32 Index;
+
+	for (Index = 0U; Index < SchedPtr->NumPorts; Index++) {
+		PortPtr = SchedPtr->Port[Index];
+
+		if (UartSched_IsBusy(PortPtr) == 0U) {
+			PortPtr->Deficit = 0U;
+			continue;
+		}
+
+		PortPtr->Events = 0U;
+		if (PortPtr->PlUartPtr != NULL) {
+			PortPtr->PlUartPtr->Events = 0U;
+		}
+		PortPtr->Deficit = UartSched_Min(PortPtr->Deficit +
+						 PortPtr->Quantum,
+						 PortPtr->Quantum *
+						 UART_SCHED_MAX_ROUNDS);
+
+		Moved += UartSched_ServiceRx(PortPtr);
+		Moved += UartSched_ServiceTx(PortPtr);
+	}
+
+	return Moved;
+}
+
+/****************************************************************************/
+/*
+*
+* Returns the number of bytes waiting in the RX ring of a port.
+*
+* @param	PortPtr is a pointer to the port.
+*
+* @return	The number of bytes waiting.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 UartSched_RxCount(UartSched_Port *PortPtr)
+{
+	if (PortPtr->PlUartPtr != NULL) {
+		return PlUart_RingRxCount(PortPtr->PlUartPtr);
+	}
+
+	return XUartPs_RingRxCount(PortPtr->UartPtr);
+}
+
+/****************************************************************************/
+/*
+*
+* Returns the room left in the TX ring of a port.
+*
+* @param	PortPtr is a pointer to the port.
+*
+* @return	The number of bytes that can be queued.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 UartSched_TxFree(UartSched_Port *PortPtr)
+{
+	if (PortPtr->PlUartPtr != NULL) {
+		return PlUart_RingTxFree(PortPtr->PlUartPtr);
+	}
+
+	return XUartPs_RingTxFree(PortPtr->UartPtr);
+}
+
+/****************************************************************************/
+/*
+*
+* Checks whether a port has anything for the loop to do.
+*
+* @param	PortPtr is a pointer to the port.
+*
+* @return	Non-zero if the port has work.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 UartSched_IsBusy(UartSched_Port *PortPtr)
+{
+	u32 RxWork;
+	u32 Events = PortPtr->Events;
+
+	if (PortPtr->PlUartPtr != NULL) {
+		Events |= PortPtr->PlUartPtr->Events;
+	}
+
+	RxWork = (PortPtr->RxHandler != NULL) &&
+		 ((PortPtr->RxLength != 0U) ||
+		  (UartSched_RxCount(PortPtr) != 0U));
+
+	return (RxWork != 0U) || (Events != 0U) ||
+	       ((PortPtr->TxHandler != NULL) && (PortPtr->TxPending != 0U));
+}
+
+/****************************************************************************/
+/*
+*
+* Hands received data of a port to its RX handler within the credit of the
+* port. Data the handler does not take stays in RxChunk for a later round.
+*
+* @param	PortPtr is a pointer to the port.
+*
+* @return	The number of bytes consumed by the handler.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 UartSched_ServiceRx(UartSched_Port *PortPtr)
+{
+	u32 Moved = 0U;
+	u32 Count;
+
+	if (PortPtr->RxHandler == NULL) {
+		return 0U;
+	}
+
+	while (PortPtr->Deficit != 0U) {
+		if (PortPtr->RxLength == 0U) {
+			PortPtr->RxOffset = 0U;
+			if (PortPtr->PlUartPtr != NULL) {
+				PortPtr->RxLength = PlUart_RingRead(
+						PortPtr->PlUartPtr,
+						PortPtr->RxChunk,
+						UART_SCHED_CHUNK);
+			} else {
+				PortPtr->RxLength = XUartPs_RingRead(
+						PortPtr->UartPtr,
+						PortPtr->RxChunk,
+						UART_SCHED_CHUNK);
+			}
+			if (PortPtr->RxLength == 0U) {
+				break;
+			}
+		}
+
+		Count = PortPtr->RxHandler(PortPtr->CallBackRef,
+				&PortPtr->RxChunk[PortPtr->RxOffset],
+				UartSched_Min(PortPtr->RxLength,
+					      PortPtr->Deficit));
+		PortPtr->RxOffset += Count;
+		PortPtr->RxLength -= Count;
+		PortPtr->Deficit -= Count;
+		Moved += Count;
+
+		if (Count == 0U) {
+			/* The consumer is full, try again next round */
+			break;
+		}
+	}
+
+	return Moved;
+}
+
+/****************************************************************************/
+/*
+*
+* Moves data from the TX handler of a port into its TX ring within the credit
+* of the port and the room left in the ring.
+*
+* @param	PortPtr is a pointer to the port.
+*
+* @return	The number of bytes queued for sending.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 UartSched_ServiceTx(UartSched_Port *PortPtr)
+{
+	u32 Moved = 0U;
+	u32 Max;
+	u32 Count;
+
+	if ((PortPtr->TxHandler == NULL) || (PortPtr->TxPending == 0U)) {
+		return 0U;
+	}
+
+	/* Cleared first so that a kick during the calls below is not lost */
+	PortPtr->TxPending = 0U;
+
+	while (1) {
+		Max = UartSched_Min(UartSched_Min(PortPtr->Deficit,
+						  UART_SCHED_CHUNK),
+				    UartSched_TxFree(PortPtr));
+		if (Max == 0U) {
+			/* Out of credit or room, the producer is not done */
+			PortPtr->TxPending = 1U;
+			break;
+		}
+
+		Count = PortPtr->TxHandler(PortPtr->CallBackRef,
+					   PortPtr->TxChunk, Max);
+		if (Count == 0U) {
+			break;
+		}
+
+		if (PortPtr->PlUartPtr != NULL) {
+			(void)PlUart_RingWrite(PortPtr->PlUartPtr,
+					       PortPtr->TxChunk, Count);
+		} else {
+			(void)XUartPs_RingWrite(PortPtr->UartPtr,
+						PortPtr->TxChunk, Count);
+		}
+		PortPtr->Deficit -= Count;
+		Moved += Count;
+	}
+
+	return Moved;
+}
@@ -0,0 +1,123 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file uart_sched.h
+*
+* Multiplexes several UART ports onto a single event loop.
+*
+* Every port runs its XUartPs instance in ring buffer mode, so the FIFOs are
+* serviced by the interrupt handler and the loop only moves data between the
+* rings and the application. UartSched_InterruptHandler() is connected to the
+* interrupt of each port instead of XUartPs_InterruptHandler(). It records
+* the interrupt status of the port before calling the driver handler, so the
+* loop only visits ports that have something to do.
+*
+* The loop shares its time between the ports with deficit round robin. Each
+* round a busy port is credited its quantum of bytes and may move that much
+* between its rings and the application, unused credit carrying over while
+* the port stays busy. A chatty port therefore gets its share of the loop but
+* cannot starve the others. Within a round ports are visited from the highest
+* priority down, so a high priority port is served first and sees the lowest
+* latency without getting more than its quantum.
+*
+* A port may also be a PlUart of pl_uart.h, an AXI UART16550 or UARTLite in
+* the PL, added with UartSched_AddPlPort(). Its interrupt is serviced by
+* the hub of pl_uart.h, which records its events in the PlUart, and the
+* loop moves its data through the same rings as for an XUartPs.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Added the PL UART ports of pl_uart.h.
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef UART_SCHED_H
+#define UART_SCHED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xuartps.h"
+#include "pl_uart.h"
+
+/************************** Constant Definitions ****************************/
+
+#ifndef UART_SCHED_MAX_PORTS
+#define UART_SCHED_MAX_PORTS	32U	/**< Ports per scheduler */
+#endif
+#define UART_SCHED_CHUNK	64U	/**< Bytes moved per ring access */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Called with data received on a port. Returns the number of bytes consumed,
+ * the rest is offered again in a later round.
+ */
+typedef u32 (*UartSched_RxHandler)(void *CallBackRef, const u8 *DataPtr,
+				   u32 NumBytes);
+
+/**
+ * Called to get data to send on a port. Fills up to MaxBytes bytes at DataPtr
+ * and returns the number of bytes filled, 0 when it has nothing to send.
+ */
+typedef u32 (*UartSched_TxHandler)(void *CallBackRef, u8 *DataPtr,
+				   u32 MaxBytes);
+
+/**
+ * One port of the scheduler.
+ */
+typedef struct {
+	XUartPs *UartPtr;		/**< Driver instance in ring mode */
+	PlUart *PlUartPtr;		/**< Or PL port, UartPtr NULL */
+	u32 Priority;			/**< Higher is served first */
+	u32 Quantum;			/**< Bytes credited per round */
+	u32 Deficit;			/**< Credit left from earlier rounds */
+	volatile u32 Events;		/**< Interrupt status not yet handled */
+	volatile u32 TxPending;		/**< Producer may have more data */
+	UartSched_RxHandler RxHandler;
+	UartSched_TxHandler TxHandler;
+	void *CallBackRef;		/**< Passed to both handlers */
+	u8 RxChunk[UART_SCHED_CHUNK];	/**< Received, not consumed yet */
+	u32 RxOffset;			/**< First byte left in RxChunk */
+	u32 RxLength;			/**< Bytes left in RxChunk */
+	u8 TxChunk[UART_SCHED_CHUNK];	/**< Staging for the TX ring */
+} UartSched_Port;
+
+/**
+ * The scheduler.
+ */
+typedef struct {
+	UartSched_Port *Port[UART_SCHED_MAX_PORTS]; /**< By priority */
+	u32 NumPorts;
+} UartSched;
+
+/************************** Function Prototypes *****************************/
+
+void UartSched_Initialize(UartSched *SchedPtr);
+s32 UartSched_AddPort(UartSched *SchedPtr, UartSched_Port *PortPtr,
+		      XUartPs *UartPtr, u32 Priority, u32 Quantum);
+void UartSched_SetHandlers(UartSched_Port *PortPtr,
+			   UartSched_RxHandler RxHandler,
+			   UartSched_TxHandler TxHandler, void *CallBackRef);
+void UartSched_KickTx(UartSched_Port *PortPtr);
+void UartSched_InterruptHandler(UartSched_Port *PortPtr);
+u32 UartSched_Run(UartSched *SchedPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UART_SCHED_H */
@@ -0,0 +1,965 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file uart_vchan.c
+*
+* Virtual channels over one framed UART link. Refer to uart_vchan.h for the
+* frame format, the flow control and the scheduling.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "uart_vchan.h"
+
+/************************** Constant Definitions ****************************/
+
+#define UART_VCHAN_TYPE_DATA	0x1U
+#define UART_VCHAN_TYPE_GRANT	0x2U
+#define UART_VCHAN_TYPE_SYNC	0x3U
+#define UART_VCHAN_TYPE_DATA_LZ	0x4U
+
+#define UART_VCHAN_FLAG_LZ	0x01U	/* GRANT: send me DATA_LZ */
+#define UART_VCHAN_LZ_MIN	32U	/* Fewer bytes are sent as they are */
+
+#if (UART_VCHAN_LZ_INPUT > 0xFFFFU)
+#error "UART_VCHAN_LZ_INPUT must fit the u16 length of a DATA_LZ frame"
+#endif
+
+#define UART_VCHAN_COUNTS_PER_MS ((XTime)COUNTS_PER_SECOND / 1000U)
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define UartVChan_RxUsed(ChPtr)	((ChPtr)->RxHead - (ChPtr)->RxTail)
+#define UartVChan_RxFree(ChPtr)	((ChPtr)->RxMask + 1U - UartVChan_RxUsed(ChPtr))
+#define UartVChan_TxUsed(ChPtr)	((ChPtr)->TxHead - (ChPtr)->TxTail)
+
+/************************** Function Prototypes *****************************/
+
+static void UartVChan_Receive(UartVChan *MuxPtr, const UartFrame *FramePtr);
+static void UartVChan_ReceiveLz(UartVChan *MuxPtr, UartVChan_Channel *ChPtr,
+				const UartFrame *FramePtr, const u8 *HeaderPtr);
+static void UartVChan_ReceiveData(UartVChan_Channel *ChPtr,
+				  const UartFrame *ViewPtr, u32 ViewOffset,
+				  u32 NumBytes, u32 Offset);
+static void UartVChan_ReceiveGrant(UartVChan_Channel *ChPtr, u32 Type,
+				   u32 Expected, u32 Window, u32 Flags);
+static u32 UartVChan_BuildGrant(UartVChan *MuxPtr, XTime Now);
+static u32 UartVChan_BuildData(UartVChan *MuxPtr);
+static u32 UartVChan_BuildLz(UartVChan *MuxPtr, UartVChan_Channel *ChPtr,
+			     u32 *NumBytesPtr);
+static void UartVChan_CopyTx(const UartVChan_Channel *ChPtr, u8 *DataPtr,
+			     u32 NumBytes);
+static void UartVChan_CopyOut(const UartFrame *FramePtr, u32 Offset,
+			      u8 *DataPtr, u32 NumBytes);
+static void UartVChan_PutLe32(u8 *DataPtr, u32 Value);
+static u32 UartVChan_GetLe32(const u8 *DataPtr);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* Initializes a multiplexer on a driver instance, with no channel open.
+*
+* @param	MuxPtr is a pointer to the multiplexer.
+* @param	UartPtr is the driver instance, already in ring buffer mode.
+*		The multiplexer must be the only reader and writer of its rings.
+* @param	Mode is UART_FRAME_COBS or UART_FRAME_SLIP, the same on both
+*		ends of the link.
+*
+* @return
+*		- XST_SUCCESS if the multiplexer was initialized.
+*		- The status of UartFrame_Initialize() otherwise.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 UartVChan_Initialize(UartVChan *MuxPtr, XUartPs *UartPtr, u32 Mode)
+{
+	s32 Status;
+
+	Status = UartFrame_Initialize(&MuxPtr->Engine, UartPtr, Mode,
+				      UART_VCHAN_MAX_FRAME);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	(void)memset(MuxPtr->Channel, 0, sizeof(MuxPtr->Channel));
+	MuxPtr->UartPtr = UartPtr;
+	MuxPtr->Mode = Mode;
+	MuxPtr->NumOpen = 0U;
+	MuxPtr->RefreshCounts = (XTime)UART_VCHAN_REFRESH_MS *
+				UART_VCHAN_COUNTS_PER_MS;
+	MuxPtr->BadFrames = 0U;
+	MuxPtr->TxLength = 0U;
+	MuxPtr->TxOffset = 0U;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Opens a channel. Nothing is sent on it until the peer grants credit, and
+* the first grant of the channel goes out at the next UartVChan_Poll().
+*
+* @param	MuxPtr is a pointer to the multiplexer.
+* @param	Channel is the channel, below UART_VCHAN_MAX.
+* @param	Priority orders the channels on TX, higher first. Channels of
+*		the same priority are sent in the order they were opened.
+* @param	Chunk is the most bytes of a DATA frame of the channel, up to
+*		UART_VCHAN_MAX_CHUNK, 0 for that. A small chunk on a bulk
+*		channel shortens the wait of the channels above it.
+* @param	RxBufferPtr is the RX ring of the channel.
+* @param	RxSize is its size, a power of two up to UART_VCHAN_MAX_RING.
+* @param	TxBufferPtr is the TX ring of the channel.
+* @param	TxSize is its size, a power of two.
+*
+* @return
+*		- XST_SUCCESS if the channel was opened.
+*		- XST_DEVICE_BUSY if the channel is already open.
+*		- XST_INVALID_PARAM if an argument is out of range.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 UartVChan_Open(UartVChan *MuxPtr, u32 Channel, u32 Priority, u32 Chunk,
+		   u8 *RxBufferPtr, u32 RxSize, u8 *TxBufferPtr, u32 TxSize)
+{
+	UartVChan_Channel *ChPtr;
+	u32 Index;
+
+	if ((Channel >= UART_VCHAN_MAX) || (Chunk > UART_VCHAN_MAX_CHUNK) ||
+	    (RxBufferPtr == NULL) || (TxBufferPtr == NULL) ||
+	    (RxSize < 4U) || (RxSize > UART_VCHAN_MAX_RING) ||
+	    ((RxSize & (RxSize - 1U)) != 0U) || (TxSize == 0U) ||
+	    ((TxSize & (TxSize - 1U)) != 0U)) {
+		return XST_INVALID_PARAM;
+	}
+
+	ChPtr = &MuxPtr->Channel[Channel];
+	if (ChPtr->Open != 0U) {
+		return XST_DEVICE_BUSY;
+	}
+
+	(void)memset(ChPtr, 0, sizeof(*ChPtr));
+	ChPtr->RxBufferPtr = RxBufferPtr;
+	ChPtr->RxMask = RxSize - 1U;
+	ChPtr->TxBufferPtr = TxBufferPtr;
+	ChPtr->TxMask = TxSize - 1U;
+	ChPtr->Priority = Priority;
+	ChPtr->Chunk = (Chunk == 0U) ? UART_VCHAN_MAX_CHUNK : Chunk;
+	ChPtr->GrantDue = 1U;
+	ChPtr->Open = 1U;
+
+	/* Insert by priority, after the channels of the same priority */
+	Index = MuxPtr->NumOpen;
+	while ((Index > 0U) &&
+	       (MuxPtr->Channel[MuxPtr->Order[Index - 1U]].Priority <
+		Priority)) {
+		MuxPtr->Order[Index] = MuxPtr->Order[Index - 1U];
+		Index--;
+	}
+	MuxPtr->Order[Index] = (u8)Channel;
+	MuxPtr->NumOpen++;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Enables or disables the compression of a channel. When it is enabled, the
+* channel asks the peer for DATA_LZ frames in its next GRANT, and sends
+* them to a peer that asks for them too. DATA_LZ frames are decoded
+* whether it is enabled or not.
+*
+* @param	MuxPtr is a pointer to the multiplexer.
+* @param	Channel is an open channel.
+* @param	Enable is 1 to enable, 0 to disable.
+*
+* @return
+*		- XST_SUCCESS if it was set.
+*		- XST_INVALID_PARAM if the channel is not open.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 UartVChan_SetCompression(UartVChan *MuxPtr, u32 Channel, u32 Enable)
+{
+	UartVChan_Channel *ChPtr;
+
+	if ((Channel >= UART_VCHAN_MAX) ||
+	    (MuxPtr->Channel[Channel].Open == 0U)) {
+		return XST_INVALID_PARAM;
+	}
+	ChPtr = &MuxPtr->Channel[Channel];
+
+	ChPtr->Compress = (Enable != 0U) ? 1U : 0U;
+	ChPtr->GrantDue = 1U;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Queues bytes on a channel. They are sent by UartVChan_Poll() as the peer
+* grants credit.
+*
+* @param	MuxPtr is a pointer to the multiplexer.
+* @param	Channel is an open channel.
+* @param	DataPtr is the data.
+* @param	NumBytes is the number of bytes.
+*
+* @return	The number of bytes queued, fewer than NumBytes when the TX
+*		ring of the channel is full, 0 for a channel not open.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 UartVChan_Write(UartVChan *MuxPtr, u32 Channel, const u8 *DataPtr,
+		    u32 NumBytes)
+{
+	UartVChan_Channel *ChPtr;
+	u32 Free;
+	u32 Index;
+	u32 First;
+
+	if ((Channel >= UART_VCHAN_MAX) ||
+	    (MuxPtr->Channel[Channel].Open == 0U)) {
+		return 0U;
+	}
+	ChPtr = &MuxPtr->Channel[Channel];
+
+	Free = ChPtr->TxMask + 1U - UartVChan_TxUsed(ChPtr);
+	if (NumBytes > Free) {
+		NumBytes = Free;
+	}
+
+	Index = ChPtr->TxHead & ChPtr->TxMask;
+	First = ChPtr->TxMask + 1U - Index;
+	if (First > NumBytes) {
+		First = NumBytes;
+	}
+	(void)memcpy(&ChPtr->TxBufferPtr[Index], DataPtr, First);
+	(void)memcpy(ChPtr->TxBufferPtr, &DataPtr[First], NumBytes - First);
+	ChPtr->TxHead += NumBytes;
+
+	return NumBytes;
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the received bytes of a channel in place, as up to two segments
+* of its RX ring. They stay valid until UartVChan_Consume().
+*
+* @param	MuxPtr is a pointer to the multiplexer.
+* @param	Channel is an open channel.
+* @param	ViewPtr receives the segments.
+*
+* @return	The number of bytes, 0 when there is none or for a channel
+*		not open.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 UartVChan_Peek(UartVChan *MuxPtr, u32 Channel, UartFrame *ViewPtr)
+{
+	UartVChan_Channel *ChPtr;
+	u32 Used;
+	u32 Index;
+	u32 First;
+
+	ViewPtr->Length[0] = 0U;
+	ViewPtr->Length[1] = 0U;
+	ViewPtr->TotalLength = 0U;
+	if ((Channel >= UART_VCHAN_MAX) ||
+	    (MuxPtr->Channel[Channel].Open == 0U)) {
+		return 0U;
+	}
+	ChPtr = &MuxPtr->Channel[Channel];
+
+	Used = UartVChan_RxUsed(ChPtr);
+	Index = ChPtr->RxTail & ChPtr->RxMask;
+	First = ChPtr->RxMask + 1U - Index;
+	if (First > Used) {
+		First = Used;
+	}
+
+	ViewPtr->DataPtr[0] = &ChPtr->RxBufferPtr[Index];
+	ViewPtr->Length[0] = First;
+	ViewPtr->DataPtr[1] = ChPtr->RxBufferPtr;
+	ViewPtr->Length[1] = Used - First;
+	ViewPtr->TotalLength = Used;
+
+	return Used;
+}
+
+/****************************************************************************/
+/**
+*
+* Frees received bytes of a channel, the oldest first. The space is granted
+* to the peer by UartVChan_Poll().
+*
+* @param	MuxPtr is a pointer to the multiplexer.
+* @param	Channel is an open channel.
+* @param	NumBytes is the number of bytes, at most what is received.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void UartVChan_Consume(UartVChan *MuxPtr, u32 Channel, u32 NumBytes)
+{
+	UartVChan_Channel *ChPtr;
+
+	if ((Channel >= UART_VCHAN_MAX) ||
+	    (MuxPtr->Channel[Channel].Open == 0U)) {
+		return;
+	}
+	ChPtr = &MuxPtr->Channel[Channel];
+
+	if (NumBytes > UartVChan_RxUsed(ChPtr)) {
+		NumBytes = UartVChan_RxUsed(ChPtr);
+	}
+	ChPtr->RxTail += NumBytes;
+}
+
+/****************************************************************************/
+/**
+*
+* Copies received bytes of a channel out and frees them.
+*
+* @param	MuxPtr is a pointer to the multiplexer.
+* @param	Channel is an open channel.
+* @param	DataPtr receives the bytes.
+* @param	NumBytes is the size of DataPtr.
+*
+* @return	The number of bytes copied.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 UartVChan_Read(UartVChan *MuxPtr, u32 Channel, u8 *DataPtr,
+		   u32 NumBytes)
+{
+	UartFrame View;
+	u32 First;
+
+	if (UartVChan_Peek(MuxPtr, Channel, &View) < NumBytes) {
+		NumBytes = View.TotalLength;
+	}
+
+	First = (View.Length[0] < NumBytes) ? View.Length[0] : NumBytes;
+	(void)memcpy(DataPtr, View.DataPtr[0], First);
+	(void)memcpy(&DataPtr[First], View.DataPtr[1], NumBytes - First);
+	UartVChan_Consume(MuxPtr, Channel, NumBytes);
+
+	return NumBytes;
+}
+
+/****************************************************************************/
+/**
+*
+* Runs the link: stores the received frames in their channels, then sends
+* grants and data by priority while the TX ring of the UART holds less than
+* UART_VCHAN_TX_BACKLOG bytes.
+*
+* @param	MuxPtr is a pointer to the multiplexer.
+*
+* @return	None.
+*
+* @note		Called often enough that the RX ring of the UART does not
+*		fill, e.g. from the idle loop.
+*
+*****************************************************************************/
+void UartVChan_Poll(UartVChan *MuxPtr)
+{
+	XUartPs *UartPtr = MuxPtr->UartPtr;
+	UartFrame Frame;
+	XTime Now;
+	u32 Length;
+	u32 Written;
+
+	while (UartFrame_Poll(&MuxPtr->Engine, &Frame) == XST_SUCCESS) {
+		UartVChan_Receive(MuxPtr, &Frame);
+		UartFrame_Release(&MuxPtr->Engine);
+	}
+
+	XTime_GetTime(&Now);
+	for (;;) {
+		if (MuxPtr->TxLength != 0U) {
+			Written = XUartPs_RingWrite(UartPtr,
+					&MuxPtr->TxFrame[MuxPtr->TxOffset],
+					MuxPtr->TxLength);
+			MuxPtr->TxOffset += Written;
+			MuxPtr->TxLength -= Written;
+			if (MuxPtr->TxLength != 0U) {
+				break;
+			}
+		}
+
+		/*
+		 * A frame is encoded only when the UART is nearly idle, so that
+		 * what is queued in front of a console byte stays bounded; the
+		 * channels keep the rest in their own rings.
+		 */
+		if ((UartPtr->TxRing.Mask + 1U - XUartPs_RingTxFree(UartPtr)) >=
+		    UART_VCHAN_TX_BACKLOG) {
+			break;
+		}
+
+		Length = UartVChan_BuildGrant(MuxPtr, Now);
+		if (Length == 0U) {
+			Length = UartVChan_BuildData(MuxPtr);
+		}
+		if (Length == 0U) {
+			break;
+		}
+
+		MuxPtr->TxLength = UartFrame_Encode(MuxPtr->Mode,
+						    MuxPtr->TxPayload, Length,
+						    MuxPtr->TxFrame,
+						    sizeof(MuxPtr->TxFrame));
+		MuxPtr->TxOffset = 0U;
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the counts of a channel.
+*
+* @param	MuxPtr is a pointer to the multiplexer.
+* @param	Channel is the channel.
+* @param	StatsPtr receives the counts.
+*
+* @return
+*		- XST_SUCCESS if the counts were returned.
+*		- XST_INVALID_PARAM if the channel is not open.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 UartVChan_GetStats(const UartVChan *MuxPtr, u32 Channel,
+		       UartVChan_Stats *StatsPtr)
+{
+	if ((Channel >= UART_VCHAN_MAX) ||
+	    (MuxPtr->Channel[Channel].Open == 0U)) {
+		return XST_INVALID_PARAM;
+	}
+
+	*StatsPtr = MuxPtr->Channel[Channel].Stats;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Dispatches a received frame to its channel.
+*
+* @param	MuxPtr is a pointer to the multiplexer.
+* @param	FramePtr is the frame, in the RX ring of the UART.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartVChan_Receive(UartVChan *MuxPtr, const UartFrame *FramePtr)
+{
+	UartVChan_Channel *ChPtr;
+	u8 Header[UART_VCHAN_GRANT_SIZE];
+	u32 Type;
+	u32 Channel;
+
+	if (FramePtr->TotalLength < UART_VCHAN_DATA_HEADER) {
+		MuxPtr->BadFrames++;
+		return;
+	}
+
+	UartVChan_CopyOut(FramePtr, 0U, Header, UART_VCHAN_DATA_HEADER);
+	Type = (u32)Header[0] >> 4U;
+	Channel = (u32)Header[0] & 0xFU;
+	if ((Channel >= UART_VCHAN_MAX) ||
+	    (MuxPtr->Channel[Channel].Open == 0U)) {
+		MuxPtr->BadFrames++;
+		return;
+	}
+	ChPtr = &MuxPtr->Channel[Channel];
+
+	if (Type == UART_VCHAN_TYPE_DATA) {
+		UartVChan_ReceiveData(ChPtr, FramePtr, UART_VCHAN_DATA_HEADER,
+				      FramePtr->TotalLength -
+				      UART_VCHAN_DATA_HEADER,
+				      UartVChan_GetLe32(&Header[1]));
+	} else if ((Type == UART_VCHAN_TYPE_DATA_LZ) &&
+		   (FramePtr->TotalLength > UART_VCHAN_LZ_HEADER)) {
+		UartVChan_CopyOut(FramePtr, UART_VCHAN_DATA_HEADER,
+				  &Header[UART_VCHAN_DATA_HEADER], 2U);
+		UartVChan_ReceiveLz(MuxPtr, ChPtr, FramePtr, Header);
+	} else if (((Type == UART_VCHAN_TYPE_GRANT) ||
+		    (Type == UART_VCHAN_TYPE_SYNC)) &&
+		   (FramePtr->TotalLength == UART_VCHAN_GRANT_SIZE)) {
+		UartVChan_CopyOut(FramePtr, UART_VCHAN_DATA_HEADER,
+				  &Header[UART_VCHAN_DATA_HEADER], 3U);
+		UartVChan_ReceiveGrant(ChPtr, Type,
+				       UartVChan_GetLe32(&Header[1]),
+				       (u32)Header[5] | ((u32)Header[6] << 8U),
+				       Header[7]);
+	} else {
+		MuxPtr->BadFrames++;
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Decompresses a DATA_LZ frame and stores its bytes as those of a DATA
+* frame. A block that does not decode is dropped; its bytes are counted as
+* lost when the next frame arrives.
+*
+* @param	MuxPtr is a pointer to the multiplexer.
+* @param	ChPtr is the channel.
+* @param	FramePtr is the frame.
+* @param	HeaderPtr is its header, UART_VCHAN_LZ_HEADER bytes.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartVChan_ReceiveLz(UartVChan *MuxPtr, UartVChan_Channel *ChPtr,
+				const UartFrame *FramePtr, const u8 *HeaderPtr)
+{
+	u32 Packed = FramePtr->TotalLength - UART_VCHAN_LZ_HEADER;
+	u32 NumBytes = (u32)HeaderPtr[5] | ((u32)HeaderPtr[6] << 8U);
+	UartFrame View;
+
+	/* The block must be contiguous for the back references */
+	UartVChan_CopyOut(FramePtr, UART_VCHAN_LZ_HEADER, MuxPtr->LzPacked,
+			  Packed);
+	if ((NumBytes > UART_VCHAN_LZ_INPUT) ||
+	    (Lz4Block_Decompress(MuxPtr->LzPacked, Packed, MuxPtr->LzRaw,
+				 NumBytes) != (s32)NumBytes)) {
+		ChPtr->Stats.LzErrors++;
+		return;
+	}
+
+	View.DataPtr[0] = MuxPtr->LzRaw;
+	View.Length[0] = NumBytes;
+	View.DataPtr[1] = MuxPtr->LzRaw;
+	View.Length[1] = 0U;
+	View.TotalLength = NumBytes;
+	UartVChan_ReceiveData(ChPtr, &View, 0U, NumBytes,
+			      UartVChan_GetLe32(&HeaderPtr[1]));
+}
+
+/****************************************************************************/
+/*
+*
+* Copies the bytes of a DATA frame into the RX ring of its channel, the one
+* copy of a received byte.
+*
+* @param	ChPtr is the channel.
+* @param	ViewPtr is the frame, or the decompressed bytes.
+* @param	ViewOffset is where the bytes start in it.
+* @param	NumBytes is the number of bytes.
+* @param	Offset is the stream offset of the first one.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartVChan_ReceiveData(UartVChan_Channel *ChPtr,
+				  const UartFrame *ViewPtr, u32 ViewOffset,
+				  u32 NumBytes, u32 Offset)
+{
+	u32 Index;
+	u32 First;
+
+	if (ChPtr->RxSynced == 0U) {
+		ChPtr->RxExpected = Offset;
+		ChPtr->RxSynced = 1U;
+		ChPtr->GrantDue = 1U;
+	} else if (Offset != ChPtr->RxExpected) {
+		/*
+		 * The link keeps the order, so a frame ahead of the stream
+		 * follows frames that were lost; one behind cannot be valid.
+		 */
+		if ((s32)(Offset - ChPtr->RxExpected) < 0) {
+			ChPtr->Stats.Overruns++;
+			return;
+		}
+		ChPtr->Stats.LostBytes += Offset - ChPtr->RxExpected;
+		ChPtr->RxExpected = Offset;
+	}
+
+	if (NumBytes > UartVChan_RxFree(ChPtr)) {
+		ChPtr->Stats.Overruns++;
+		return;
+	}
+
+	Index = ChPtr->RxHead & ChPtr->RxMask;
+	First = ChPtr->RxMask + 1U - Index;
+	if (First > NumBytes) {
+		First = NumBytes;
+	}
+	UartVChan_CopyOut(ViewPtr, ViewOffset, &ChPtr->RxBufferPtr[Index],
+			  First);
+	UartVChan_CopyOut(ViewPtr, ViewOffset + First, ChPtr->RxBufferPtr,
+			  NumBytes - First);
+
+	ChPtr->RxHead += NumBytes;
+	ChPtr->RxExpected += NumBytes;
+	ChPtr->Stats.RxBytes += NumBytes;
+	ChPtr->Stats.RxFrames++;
+}
+
+/****************************************************************************/
+/*
+*
+* Takes the credit of a GRANT or a SYNC frame.
+*
+* @param	ChPtr is the channel.
+* @param	Type is UART_VCHAN_TYPE_GRANT or UART_VCHAN_TYPE_SYNC.
+* @param	Expected is the offset the peer expects next.
+* @param	Window is the free space of the peer.
+* @param	Flags are the UART_VCHAN_FLAG_* of the peer.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartVChan_ReceiveGrant(UartVChan_Channel *ChPtr, u32 Type,
+				   u32 Expected, u32 Window, u32 Flags)
+{
+	ChPtr->PeerCompress = Flags & UART_VCHAN_FLAG_LZ;
+
+	if (Type == UART_VCHAN_TYPE_SYNC) {
+		/* The peer takes our offset from the next DATA frame */
+		ChPtr->TxLimit = ChPtr->TxOffset + Window;
+	} else {
+		if (ChPtr->TxSynced == 0U) {
+			ChPtr->TxOffset = Expected;
+		}
+		ChPtr->TxLimit = Expected + Window;
+	}
+	ChPtr->TxSynced = 1U;
+}
+
+/****************************************************************************/
+/*
+*
+* Builds the GRANT or SYNC frame of the first channel that needs one: the
+* first after it was opened or synced, when a quarter of its ring was freed
+* since the last one, or when the last one is UART_VCHAN_REFRESH_MS old.
+*
+* @param	MuxPtr is a pointer to the multiplexer.
+* @param	Now is the current time.
+*
+* @return	The length of the payload in TxPayload, 0 for none.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 UartVChan_BuildGrant(UartVChan *MuxPtr, XTime Now)
+{
+	UartVChan_Channel *ChPtr;
+	u32 Index;
+	u32 Channel;
+	u32 Window;
+	u32 Limit;
+
+	for (Index = 0U; Index < MuxPtr->NumOpen; Index++) {
+		Channel = MuxPtr->Order[Index];
+		ChPtr = &MuxPtr->Channel[Channel];
+		Window = UartVChan_RxFree(ChPtr);
+		Limit = ChPtr->RxExpected + Window;
+
+		if ((ChPtr->GrantDue == 0U) &&
+		    ((Now - ChPtr->GrantTime) < MuxPtr->RefreshCounts) &&
+		    ((ChPtr->RxSynced == 0U) ||
+		     ((Limit - ChPtr->Advertised) <
+		      ((ChPtr->RxMask + 1U) / 4U)))) {
+			continue;
+		}
+
+		MuxPtr->TxPayload[0] = (u8)(((ChPtr->RxSynced != 0U) ?
+					     UART_VCHAN_TYPE_GRANT :
+					     UART_VCHAN_TYPE_SYNC) << 4U) |
+				       (u8)Channel;
+		UartVChan_PutLe32(&MuxPtr->TxPayload[1], ChPtr->RxExpected);
+		MuxPtr->TxPayload[5] = (u8)Window;
+		MuxPtr->TxPayload[6] = (u8)(Window >> 8U);
+		MuxPtr->TxPayload[7] = (ChPtr->Compress != 0U) ?
+				       (u8)UART_VCHAN_FLAG_LZ : 0U;
+
+		ChPtr->Advertised = Limit;
+		ChPtr->GrantTime = Now;
+		ChPtr->GrantDue = 0U;
+		ChPtr->Stats.Grants++;
+
+		return UART_VCHAN_GRANT_SIZE;
+	}
+
+	return 0U;
+}
+
+/****************************************************************************/
+/*
+*
+* Builds the DATA frame of the highest priority channel with data and
+* credit, as long as the chunk of the channel and its credit allow.
+*
+* @param	MuxPtr is a pointer to the multiplexer.
+*
+* @return	The length of the payload in TxPayload, 0 for none.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 UartVChan_BuildData(UartVChan *MuxPtr)
+{
+	UartVChan_Channel *ChPtr;
+	u32 Index;
+	u32 Channel;
+	u32 NumBytes;
+	u32 Credit;
+	u32 Length;
+
+	for (Index = 0U; Index < MuxPtr->NumOpen; Index++) {
+		Channel = MuxPtr->Order[Index];
+		ChPtr = &MuxPtr->Channel[Channel];
+		NumBytes = UartVChan_TxUsed(ChPtr);
+		if (NumBytes == 0U) {
+			continue;
+		}
+
+		Credit = 0U;
+		if ((s32)(ChPtr->TxLimit - ChPtr->TxOffset) > 0) {
+			Credit = ChPtr->TxLimit - ChPtr->TxOffset;
+		}
+		if (Credit == 0U) {
+			if (ChPtr->Stalled == 0U) {
+				ChPtr->Stalled = 1U;
+				ChPtr->Stats.CreditStalls++;
+			}
+			continue;
+		}
+		ChPtr->Stalled = 0U;
+
+		if (NumBytes > Credit) {
+			NumBytes = Credit;
+		}
+
+		Length = 0U;
+		if ((ChPtr->Compress != 0U) && (ChPtr->PeerCompress != 0U)) {
+			Length = UartVChan_BuildLz(MuxPtr, ChPtr, &NumBytes);
+		}
+		if (Length == 0U) {
+			if (NumBytes > ChPtr->Chunk) {
+				NumBytes = ChPtr->Chunk;
+			}
+			MuxPtr->TxPayload[0] = (u8)(UART_VCHAN_TYPE_DATA << 4U) |
+					       (u8)Channel;
+			UartVChan_CopyTx(ChPtr,
+					 &MuxPtr->TxPayload[UART_VCHAN_DATA_HEADER],
+					 NumBytes);
+			Length = UART_VCHAN_DATA_HEADER + NumBytes;
+		}
+		UartVChan_PutLe32(&MuxPtr->TxPayload[1], ChPtr->TxOffset);
+
+		ChPtr->TxTail += NumBytes;
+		ChPtr->TxOffset += NumBytes;
+		ChPtr->Stats.TxBytes += NumBytes;
+		ChPtr->Stats.TxFrames++;
+
+		return Length;
+	}
+
+	return 0U;
+}
+
+/****************************************************************************/
+/*
+*
+* Compresses the next bytes of a channel into a DATA_LZ frame that fits its
+* chunk, taking fewer bytes until the block fits.
+*
+* @param	MuxPtr is a pointer to the multiplexer.
+* @param	ChPtr is the channel.
+* @param	NumBytesPtr holds the bytes that may be sent, and receives
+*		those the frame holds.
+*
+* @return	The length of the payload in TxPayload, 0 when the bytes are
+*		better sent as DATA.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 UartVChan_BuildLz(UartVChan *MuxPtr, UartVChan_Channel *ChPtr,
+			     u32 *NumBytesPtr)
+{
+	u32 NumBytes = *NumBytesPtr;
+	u32 Packed;
+
+	if (NumBytes < UART_VCHAN_LZ_MIN) {
+		return 0U;
+	}
+	if (NumBytes > UART_VCHAN_LZ_INPUT) {
+		NumBytes = UART_VCHAN_LZ_INPUT;
+	}
+	UartVChan_CopyTx(ChPtr, MuxPtr->LzRaw, NumBytes);
+
+	for (;;) {
+		Packed = Lz4Block_Compress(MuxPtr->LzRaw, NumBytes,
+					   &MuxPtr->TxPayload[UART_VCHAN_LZ_HEADER],
+					   ChPtr->Chunk, MuxPtr->LzTable);
+		if ((Packed != 0U) || (NumBytes <= ChPtr->Chunk)) {
+			break;
+		}
+		NumBytes /= 2U;
+	}
+
+	/* Worth it only when it beats DATA, header included */
+	if ((Packed == 0U) || ((Packed + UART_VCHAN_LZ_HEADER) >=
+			       (NumBytes + UART_VCHAN_DATA_HEADER))) {
+		return 0U;
+	}
+
+	MuxPtr->TxPayload[0] = (u8)(UART_VCHAN_TYPE_DATA_LZ << 4U) |
+			       (u8)(ChPtr - MuxPtr->Channel);
+	MuxPtr->TxPayload[5] = (u8)NumBytes;
+	MuxPtr->TxPayload[6] = (u8)(NumBytes >> 8U);
+	ChPtr->Stats.LzFrames++;
+	ChPtr->Stats.LzSaved += (NumBytes + UART_VCHAN_DATA_HEADER) -
+				(Packed + UART_VCHAN_LZ_HEADER);
+	*NumBytesPtr = NumBytes;
+
+	return UART_VCHAN_LZ_HEADER + Packed;
+}
+
+/****************************************************************************/
+/*
+*
+* Copies the oldest bytes of the TX ring of a channel, without freeing them.
+*
+* @param	ChPtr is the channel.
+* @param	DataPtr receives the bytes.
+* @param	NumBytes is the number of bytes, at most those in the ring.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartVChan_CopyTx(const UartVChan_Channel *ChPtr, u8 *DataPtr,
+			     u32 NumBytes)
+{
+	u32 Start = ChPtr->TxTail & ChPtr->TxMask;
+	u32 First = ChPtr->TxMask + 1U - Start;
+
+	if (First > NumBytes) {
+		First = NumBytes;
+	}
+	(void)memcpy(DataPtr, &ChPtr->TxBufferPtr[Start], First);
+	(void)memcpy(&DataPtr[First], ChPtr->TxBufferPtr, NumBytes - First);
+}
+
+/****************************************************************************/
+/*
+*
+* Copies bytes of a frame, which may wrap in the RX ring of the UART.
+*
+* @param	FramePtr is the frame.
+* @param	Offset is the first byte in the payload.
+* @param	DataPtr receives the bytes.
+* @param	NumBytes is the number of bytes, within the payload.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartVChan_CopyOut(const UartFrame *FramePtr, u32 Offset,
+			      u8 *DataPtr, u32 NumBytes)
+{
+	u32 First = 0U;
+
+	if (Offset < FramePtr->Length[0]) {
+		First = FramePtr->Length[0] - Offset;
+		if (First > NumBytes) {
+			First = NumBytes;
+		}
+		(void)memcpy(DataPtr, &FramePtr->DataPtr[0][Offset], First);
+		Offset = 0U;
+	} else {
+		Offset -= FramePtr->Length[0];
+	}
+
+	(void)memcpy(&DataPtr[First], &FramePtr->DataPtr[1][Offset],
+		     NumBytes - First);
+}
+
+/****************************************************************************/
+/*
+*
+* Stores a u32 little endian.
+*
+* @param	DataPtr receives the four bytes.
+* @param	Value is the value.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void UartVChan_PutLe32(u8 *DataPtr, u32 Value)
+{
+	DataPtr[0] = (u8)Value;
+	DataPtr[1] = (u8)(Value >> 8U);
+	DataPtr[2] = (u8)(Value >> 16U);
+	DataPtr[3] = (u8)(Value >> 24U);
+}
+
+/****************************************************************************/
+/*
+*
+* Loads a u32 little endian.
+*
+* @param	DataPtr is the first of the four bytes.
+*
+* @return	The value.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 UartVChan_GetLe32(const u8 *DataPtr)
+{
+	return (u32)DataPtr[0] | ((u32)DataPtr[1] << 8U) |
+	       ((u32)DataPtr[2] << 16U) | ((u32)DataPtr[3] << 24U);
+}
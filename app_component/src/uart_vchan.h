@@ -0,0 +1,200 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file uart_vchan.h
+*
+* Virtual channels multiplexed over the frames of uart_frame.h on one UART,
+* e.g. a console, telemetry and firmware update on the same link.
+*
+* Every frame carries one channel. Byte 0 of the payload holds the frame
+* type in its high nibble and the channel in its low nibble:
+*
+* - DATA, followed by the stream offset of the first byte, u32 little
+*   endian, then the bytes.
+* - DATA_LZ, a DATA frame whose bytes are an LZ4 block of lz4_block.h,
+*   with their length before compression, u16, after the offset.
+* - GRANT, followed by the stream offset the receiver expects next, u32,
+*   the free space of its ring, u16, and flags, u8: the sender may send up
+*   to the sum of the two.
+* - SYNC, a GRANT of a receiver that has not received a byte since it
+*   started: the sender may send the window from where it is, and the
+*   receiver takes the offset of the first DATA frame as its own.
+*
+* The flow control is credit based, per channel. A sender only sends what
+* the receiver granted, so a received DATA frame always fits the ring of
+* its channel: it is copied there straight from the view of the framing
+* engine, the frame is released and the UART ring never waits for a slow
+* channel. The application reads a channel in place, UartVChan_Peek() and
+* UartVChan_Consume(), and the space it frees is granted again once it
+* reaches a quarter of the ring. Grants carry absolute offsets and are
+* repeated every UART_VCHAN_REFRESH_MS while a channel is open, so a lost
+* frame or a peer that starts later or restarts costs the window the lost
+* bytes took and nothing more; the offsets of lost DATA frames are skipped
+* and counted. A sender that starts takes the offset of the first GRANT,
+* a receiver that starts sends SYNC, so either end may restart alone.
+*
+* A channel opened with UartVChan_SetCompression() on both ends sends
+* DATA_LZ frames, each of up to UART_VCHAN_LZ_INPUT bytes compressed into
+* the chunk of the channel, for several times the bytes per frame on
+* repetitive data such as telemetry; a block that does not shrink goes as
+* DATA. The ends agree through a flag of their GRANTs, so a peer without
+* it enabled, or one that restarts, gets DATA frames only. Credit and
+* offsets count the bytes before compression, so compression changes
+* nothing else. The codec state lives in the multiplexer, a few KB that
+* may be placed in OCM.
+*
+* The TX side is scheduled by priority. GRANTs go first, then the DATA
+* frame of the highest priority channel with data and credit, in frames of
+* at most the chunk of the channel. A frame is only encoded once the TX ring
+* of the UART holds less than UART_VCHAN_TX_BACKLOG bytes, so that a console
+* byte waits behind at most that backlog and one bulk chunk, however much
+* firmware is queued.
+*
+* UartVChan_Poll() does the work, from one context, e.g. the idle loop or a
+* task of coro.h, the other calls from the same context.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef UART_VCHAN_H
+#define UART_VCHAN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xiltimer.h"
+#include "xuartps.h"
+#include "uart_frame.h"
+#include "lz4_block.h"
+
+/************************** Constant Definitions ****************************/
+
+#define UART_VCHAN_MAX		8U	/**< Channels per link */
+#define UART_VCHAN_MAX_CHUNK	256U	/**< Most bytes of a DATA frame */
+#define UART_VCHAN_MAX_RING	0x8000U	/**< Largest ring of a channel */
+#define UART_VCHAN_DATA_HEADER	5U	/**< Type and channel, offset */
+#define UART_VCHAN_LZ_HEADER	7U	/**< DATA header, length before LZ4 */
+#define UART_VCHAN_GRANT_SIZE	8U	/**< Type and channel, offset, window,
+					     flags */
+#define UART_VCHAN_MAX_FRAME	(UART_VCHAN_LZ_HEADER + UART_VCHAN_MAX_CHUNK)
+
+#ifndef UART_VCHAN_LZ_INPUT
+#define UART_VCHAN_LZ_INPUT	1024U	/**< Most bytes of a DATA_LZ frame */
+#endif
+
+#ifndef UART_VCHAN_TX_BACKLOG
+#define UART_VCHAN_TX_BACKLOG	64U	/**< TX ring bytes a frame waits for */
+#endif
+#ifndef UART_VCHAN_REFRESH_MS
+#define UART_VCHAN_REFRESH_MS	100U	/**< Grants repeated this often */
+#endif
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Counts of a channel.
+ */
+typedef struct {
+	u64 RxBytes;		/**< Bytes received into the ring */
+	u64 TxBytes;		/**< Bytes sent */
+	u32 RxFrames;
+	u32 TxFrames;
+	u32 Grants;		/**< GRANT frames sent */
+	u32 LostBytes;		/**< Offsets skipped, lost DATA frames */
+	u32 Overruns;		/**< DATA frames dropped beyond the grant */
+	u32 CreditStalls;	/**< Times data waited for credit */
+	u32 LzFrames;		/**< DATA_LZ frames sent */
+	u64 LzSaved;		/**< Bytes they saved on the wire */
+	u32 LzErrors;		/**< DATA_LZ frames received that did not
+				     decode */
+} UartVChan_Stats;
+
+/**
+ * One channel. A ring is a power of two bytes; RX is filled by the mux and
+ * read by the application, TX the reverse.
+ */
+typedef struct {
+	u8 *RxBufferPtr;
+	u32 RxMask;
+	u32 RxHead;		/**< Free running, written by the mux */
+	u32 RxTail;		/**< Free running, read by the application */
+	u32 RxExpected;		/**< Stream offset of the next byte */
+	u32 Advertised;		/**< Last limit granted */
+	XTime GrantTime;	/**< When it was granted */
+	u32 GrantDue;		/**< Grant without waiting for more space */
+	u32 RxSynced;		/**< RxExpected is the offset of the peer */
+	u8 *TxBufferPtr;
+	u32 TxMask;
+	u32 TxHead;
+	u32 TxTail;
+	u32 TxOffset;		/**< Stream offset of the next byte sent */
+	u32 TxLimit;		/**< Offset the peer granted up to */
+	u32 TxSynced;		/**< TxOffset is the one the peer expects */
+	u32 Stalled;		/**< Waiting for credit */
+	u32 Priority;		/**< Higher is sent first */
+	u32 Chunk;		/**< Most bytes per DATA frame */
+	u32 Compress;		/**< Asks for and sends DATA_LZ */
+	u32 PeerCompress;	/**< The peer asked for DATA_LZ */
+	u32 Open;
+	UartVChan_Stats Stats;
+} UartVChan_Channel;
+
+/**
+ * The multiplexer of one UART.
+ */
+typedef struct {
+	UartFrame_Engine Engine;
+	XUartPs *UartPtr;	/**< Driver instance in ring mode */
+	u32 Mode;		/**< UART_FRAME_COBS or UART_FRAME_SLIP */
+	UartVChan_Channel Channel[UART_VCHAN_MAX];
+	u8 Order[UART_VCHAN_MAX]; /**< Open channels, by priority */
+	u32 NumOpen;
+	XTime RefreshCounts;
+	u32 BadFrames;		/**< Unknown type or channel, too short */
+	u32 TxLength;		/**< Bytes of TxFrame not in the TX ring yet */
+	u32 TxOffset;		/**< First of them */
+	u8 TxPayload[UART_VCHAN_MAX_FRAME];
+	u8 TxFrame[(2U * (UART_VCHAN_MAX_FRAME + UART_FRAME_CRC_SIZE)) + 2U];
+	u8 LzRaw[UART_VCHAN_LZ_INPUT];	/**< Bytes before compression */
+	u8 LzPacked[UART_VCHAN_MAX_CHUNK]; /**< A received LZ4 block */
+	u16 LzTable[LZ4_BLOCK_HASH_SIZE];
+} UartVChan;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+s32 UartVChan_Initialize(UartVChan *MuxPtr, XUartPs *UartPtr, u32 Mode);
+s32 UartVChan_Open(UartVChan *MuxPtr, u32 Channel, u32 Priority, u32 Chunk,
+		   u8 *RxBufferPtr, u32 RxSize, u8 *TxBufferPtr, u32 TxSize);
+s32 UartVChan_SetCompression(UartVChan *MuxPtr, u32 Channel, u32 Enable);
+u32 UartVChan_Write(UartVChan *MuxPtr, u32 Channel, const u8 *DataPtr,
+		    u32 NumBytes);
+u32 UartVChan_Peek(UartVChan *MuxPtr, u32 Channel, UartFrame *ViewPtr);
+void UartVChan_Consume(UartVChan *MuxPtr, u32 Channel, u32 NumBytes);
+u32 UartVChan_Read(UartVChan *MuxPtr, u32 Channel, u8 *DataPtr,
+		   u32 NumBytes);
+void UartVChan_Poll(UartVChan *MuxPtr);
+s32 UartVChan_GetStats(const UartVChan *MuxPtr, u32 Channel,
+		       UartVChan_Stats *StatsPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UART_VCHAN_H */
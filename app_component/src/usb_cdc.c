@@ -0,0 +1,1307 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file usb_cdc.c
+*
+* USB CDC-ACM serial port on the ChipIdea device controller. Refer to
+* usb_cdc.h for how it is used.
+*
+* Head and Tail of a queue are free running transfer counts, the transfers
+* between them owning their dTD in that order. A new dTD is linked behind
+* the last one and, when the endpoint may have retired the last one before
+* seeing the link, the tripwire of USBCMD tells whether it is still primed;
+* if not, the endpoint is primed with the new dTD. The queues are changed
+* with the interrupts masked, completions are taken in the interrupt
+* handler, in order, up to the first dTD still active.
+*
+* EP0 is a small state machine: the data stage of a request, if any, then
+* the status stage in the other direction, each one dTD of the EP0 buffer.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xparameters.h"
+
+#ifdef XPAR_XUSBPS_0_BASEADDR
+
+#include <string.h>
+#include "xstatus.h"
+#include "xil_assert.h"
+#include "xil_io.h"
+#include "xil_cache.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "xinterrupt_wrap.h"
+#include "usb_cdc.h"
+
+/************************** Constant Definitions ****************************/
+
+/* Device controller registers */
+#define USB_CDC_CMD		0x140U	/* USBCMD */
+#define USB_CDC_STS		0x144U	/* USBSTS */
+#define USB_CDC_INTR		0x148U	/* USBINTR */
+#define USB_CDC_ADDR		0x154U	/* DEVICEADDR */
+#define USB_CDC_EPLIST		0x158U	/* ENDPOINTLISTADDR */
+#define USB_CDC_PORTSC		0x184U	/* PORTSC1 */
+#define USB_CDC_MODE		0x1A8U	/* USBMODE */
+#define USB_CDC_SETUPSTAT	0x1ACU	/* ENDPTSETUPSTAT */
+#define USB_CDC_PRIME		0x1B0U	/* ENDPTPRIME */
+#define USB_CDC_FLUSH		0x1B4U	/* ENDPTFLUSH */
+#define USB_CDC_EPSTAT		0x1B8U	/* ENDPTSTAT */
+#define USB_CDC_COMPLETE	0x1BCU	/* ENDPTCOMPLETE */
+#define USB_CDC_EPCTRL(Ep)	(0x1C0U + ((u32)(Ep) * 4U)) /* ENDPTCTRLn */
+
+#define USB_CDC_CMD_RS		0x00000001U	/* Run, attached */
+#define USB_CDC_CMD_RST		0x00000002U	/* Controller reset */
+#define USB_CDC_CMD_SUTW	0x00002000U	/* Setup tripwire */
+#define USB_CDC_CMD_ATDTW	0x00004000U	/* Add dTD tripwire */
+#define USB_CDC_CMD_ITC_MASK	0x00FF0000U	/* Interrupt threshold */
+
+#define USB_CDC_STS_UI		0x00000001U	/* Transfer or setup */
+#define USB_CDC_STS_UEI		0x00000002U	/* Transfer error */
+#define USB_CDC_STS_PCI		0x00000004U	/* Port change */
+#define USB_CDC_STS_URI		0x00000040U	/* Bus reset */
+#define USB_CDC_STS_SLI		0x00000100U	/* Suspend */
+#define USB_CDC_STS_ALL		(USB_CDC_STS_UI | USB_CDC_STS_UEI | \
+				 USB_CDC_STS_PCI | USB_CDC_STS_URI | \
+				 USB_CDC_STS_SLI)
+
+#define USB_CDC_ADDR_SHIFT	25U
+#define USB_CDC_ADDR_ADVANCE	0x01000000U	/* Address after status IN */
+
+#define USB_CDC_PORTSC_PR	0x00000100U	/* Port reset in progress */
+#define USB_CDC_PORTSC_PSPD	0x0C000000U	/* Port speed */
+#define USB_CDC_PORTSC_HS	0x08000000U
+
+#define USB_CDC_MODE_DEVICE	0x00000002U	/* CM, device controller */
+#define USB_CDC_MODE_SLOM	0x00000008U	/* Setup lockout off */
+
+#define USB_CDC_EPCTRL_RXS	0x00000001U	/* Stall */
+#define USB_CDC_EPCTRL_RXR	0x00000040U	/* Data toggle reset */
+#define USB_CDC_EPCTRL_RXE	0x00000080U	/* Enable */
+#define USB_CDC_EPCTRL_TXS	0x00010000U
+#define USB_CDC_EPCTRL_TXR	0x00400000U
+#define USB_CDC_EPCTRL_TXE	0x00800000U
+#define USB_CDC_EPCTRL_RX_BULK	0x00000008U	/* RXT, bulk */
+#define USB_CDC_EPCTRL_TX_BULK	0x00080000U	/* TXT, bulk */
+#define USB_CDC_EPCTRL_TX_INTR	0x000C0000U	/* TXT, interrupt */
+
+/* Bit of an endpoint in ENDPTPRIME, ENDPTFLUSH, ENDPTSTAT, ENDPTCOMPLETE */
+#define USB_CDC_OUT_BIT(Ep)	((u32)1U << (Ep))
+#define USB_CDC_IN_BIT(Ep)	((u32)1U << (16U + (Ep)))
+
+/* dQH capabilities */
+#define USB_CDC_QH_PACKET_SHIFT	16U
+#define USB_CDC_QH_IOS		0x00008000U	/* Interrupt on setup */
+#define USB_CDC_QH_ZLT		0x20000000U	/* No zero length termination */
+
+/* dTD */
+#define USB_CDC_DTD_TERMINATE	0x00000001U
+#define USB_CDC_DTD_BYTES_SHIFT	16U
+#define USB_CDC_DTD_BYTES_MASK	0x7FFFU
+#define USB_CDC_DTD_IOC		0x00008000U
+#define USB_CDC_DTD_ACTIVE	0x00000080U
+#define USB_CDC_DTD_HALTED	0x00000040U
+#define USB_CDC_DTD_BUFERR	0x00000020U
+#define USB_CDC_DTD_XACTERR	0x00000008U
+#define USB_CDC_DTD_ERRORS	(USB_CDC_DTD_HALTED | USB_CDC_DTD_BUFERR | \
+				 USB_CDC_DTD_XACTERR)
+#define USB_CDC_DTD_PAGE	0x1000U
+
+/* dQHs */
+#define USB_CDC_QH_EP0_OUT	0U
+#define USB_CDC_QH_EP0_IN	1U
+#define USB_CDC_QH_NOTIFY	3U	/* EP1 IN */
+#define USB_CDC_QH_DATA_OUT	4U	/* EP2 OUT */
+#define USB_CDC_QH_DATA_IN	5U	/* EP2 IN */
+#define USB_CDC_QH_ALIGN	2048U
+
+#define USB_CDC_EP_NOTIFY	1U
+#define USB_CDC_EP_DATA		2U
+#define USB_CDC_EP0_PACKET	64U
+#define USB_CDC_NOTIFY_PACKET	16U
+
+/* EP0 states */
+#define USB_CDC_EP0_IDLE	0U
+#define USB_CDC_EP0_DATA_IN	1U	/* Then status OUT */
+#define USB_CDC_EP0_DATA_OUT	2U	/* Then status IN */
+#define USB_CDC_EP0_STATUS	3U
+
+/* Setup packet */
+#define USB_CDC_REQ_TYPE_MASK	0x60U
+#define USB_CDC_REQ_STANDARD	0x00U
+#define USB_CDC_REQ_CLASS	0x20U
+#define USB_CDC_REQ_RECIPIENT	0x1FU
+#define USB_CDC_REQ_ENDPOINT	0x02U
+
+#define USB_CDC_GET_STATUS		0x00U
+#define USB_CDC_CLEAR_FEATURE		0x01U
+#define USB_CDC_SET_FEATURE		0x03U
+#define USB_CDC_SET_ADDRESS		0x05U
+#define USB_CDC_GET_DESCRIPTOR		0x06U
+#define USB_CDC_GET_CONFIGURATION	0x08U
+#define USB_CDC_SET_CONFIGURATION	0x09U
+#define USB_CDC_GET_INTERFACE		0x0AU
+#define USB_CDC_SET_INTERFACE		0x0BU
+
+#define USB_CDC_SET_LINE_CODING		0x20U
+#define USB_CDC_GET_LINE_CODING		0x21U
+#define USB_CDC_SET_CONTROL_LINE_STATE	0x22U
+#define USB_CDC_SEND_BREAK		0x23U
+
+#define USB_CDC_DESC_DEVICE		0x01U
+#define USB_CDC_DESC_CONFIG		0x02U
+#define USB_CDC_DESC_STRING		0x03U
+#define USB_CDC_DESC_QUALIFIER		0x06U
+#define USB_CDC_DESC_OTHER_SPEED	0x07U
+
+#define USB_CDC_FEATURE_HALT		0x00U
+
+/* Offsets in the configuration descriptor */
+#define USB_CDC_CONFIG_SIZE		67U
+#define USB_CDC_CONFIG_INTERVAL		43U	/* bInterval of EP1 IN */
+#define USB_CDC_CONFIG_IN_PACKET	57U	/* wMaxPacketSize of EP2 IN */
+#define USB_CDC_CONFIG_OUT_PACKET	64U	/* wMaxPacketSize of EP2 OUT */
+
+#define USB_CDC_LINE_CODING_SIZE	7U
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+#define UsbCdc_Read(CdcPtr, Reg) \
+	Xil_In32((CdcPtr)->BaseAddress + (Reg))
+#define UsbCdc_Write(CdcPtr, Reg, Data) \
+	Xil_Out32((CdcPtr)->BaseAddress + (Reg), (Data))
+
+/************************** Function Prototypes *****************************/
+
+static void UsbCdc_Reset(UsbCdc *CdcPtr);
+static void UsbCdc_FillDtd(UsbCdc_Dtd *DtdPtr, const u8 *BufferPtr,
+			   u32 Length);
+static void UsbCdc_Prime(UsbCdc *CdcPtr, u32 Qh, UsbCdc_Dtd *DtdPtr, u32 Bit);
+static s32 UsbCdc_Queue_Submit(UsbCdc *CdcPtr, UsbCdc_Queue *QueuePtr,
+			       u8 *BufferPtr, u32 Length);
+static void UsbCdc_Queue_Restart(UsbCdc *CdcPtr, UsbCdc_Queue *QueuePtr);
+static void UsbCdc_Queue_Complete(UsbCdc *CdcPtr, UsbCdc_Queue *QueuePtr);
+static void UsbCdc_Configure(UsbCdc *CdcPtr, u32 Configuration);
+static void UsbCdc_Setup(UsbCdc *CdcPtr);
+static u32 UsbCdc_Standard(UsbCdc *CdcPtr, const u8 *SetupPtr, u32 *Length);
+static u32 UsbCdc_Class(UsbCdc *CdcPtr, const u8 *SetupPtr, u32 *Length);
+static u32 UsbCdc_Descriptor(UsbCdc *CdcPtr, u32 Type, u32 Index);
+static void UsbCdc_Ep0Send(UsbCdc *CdcPtr, u32 Length, u32 Requested);
+static void UsbCdc_Ep0Recv(UsbCdc *CdcPtr, u32 Length);
+static void UsbCdc_Ep0Complete(UsbCdc *CdcPtr, u32 Complete);
+static void UsbCdc_Event(UsbCdc *CdcPtr, u32 Event, u8 *BufferPtr,
+			 u32 Length);
+
+/************************** Variable Definitions ****************************/
+
+static const u8 UsbCdc_DeviceDesc[18] = {
+	18U, USB_CDC_DESC_DEVICE,
+	0x00U, 0x02U,			/* bcdUSB 2.00 */
+	0x02U, 0x00U, 0x00U,		/* Communications device class */
+	USB_CDC_EP0_PACKET,
+	(u8)USB_CDC_VENDOR_ID, (u8)(USB_CDC_VENDOR_ID >> 8),
+	(u8)USB_CDC_PRODUCT_ID, (u8)(USB_CDC_PRODUCT_ID >> 8),
+	0x00U, 0x01U,			/* bcdDevice 1.00 */
+	1U, 2U, 3U,			/* Strings */
+	1U				/* bNumConfigurations */
+};
+
+static const u8 UsbCdc_QualifierDesc[10] = {
+	10U, USB_CDC_DESC_QUALIFIER,
+	0x00U, 0x02U,
+	0x02U, 0x00U, 0x00U,
+	USB_CDC_EP0_PACKET,
+	1U, 0U
+};
+
+/*
+ * Configuration 1: the communication interface with its ACM functional
+ * descriptors and notification endpoint, then the data interface. The
+ * packet sizes and the interval are those of high speed, patched for full
+ * speed.
+ */
+static const u8 UsbCdc_ConfigDesc[USB_CDC_CONFIG_SIZE] = {
+	9U, USB_CDC_DESC_CONFIG, USB_CDC_CONFIG_SIZE, 0U,
+	2U, 1U, 0U,			/* Interfaces, value, string */
+	0x80U, 50U,			/* Bus powered, 100 mA */
+	/* Interface 0, communication, ACM, AT commands */
+	9U, 0x04U, 0U, 0U, 1U, 0x02U, 0x02U, 0x01U, 0U,
+	5U, 0x24U, 0x00U, 0x10U, 0x01U,	/* Header, CDC 1.10 */
+	5U, 0x24U, 0x01U, 0x00U, 1U,	/* Call management, data on 1 */
+	4U, 0x24U, 0x02U, 0x02U,	/* ACM, line coding and state */
+	5U, 0x24U, 0x06U, 0U, 1U,	/* Union, 0 controls 1 */
+	/* EP1 IN, interrupt, notifications every 16 ms */
+	7U, 0x05U, 0x80U | USB_CDC_EP_NOTIFY, 0x03U,
+	USB_CDC_NOTIFY_PACKET, 0U, 8U,
+	/* Interface 1, data */
+	9U, 0x04U, 1U, 0U, 2U, 0x0AU, 0x00U, 0x00U, 0U,
+	/* EP2 IN and OUT, bulk */
+	7U, 0x05U, 0x80U | USB_CDC_EP_DATA, 0x02U,
+	(u8)USB_CDC_HS_PACKET, (u8)(USB_CDC_HS_PACKET >> 8), 0U,
+	7U, 0x05U, USB_CDC_EP_DATA, 0x02U,
+	(u8)USB_CDC_HS_PACKET, (u8)(USB_CDC_HS_PACKET >> 8), 0U
+};
+
+static const char *const UsbCdc_Strings[] = {
+	NULL,				/* Languages */
+	"Xilinx",
+	"Arty Z7 USB-UART bridge",
+	"0001"
+};
+
+/****************************************************************************/
+/**
+*
+* Initializes the controller in device mode, detached from the bus, and
+* connects its interrupt. The port is 115200 8N1 until the host sets the
+* line coding.
+*
+* @param	CdcPtr is a pointer to the port.
+* @param	BaseAddress is the base address of the controller,
+*		XPAR_XUSBPS_0_BASEADDR.
+* @param	IntrId is the interrupt of the controller, as encoded in
+*		xparameters.h.
+* @param	IntrParent is the base address of its interrupt controller.
+*
+* @return
+*		- XST_SUCCESS if the port is initialized.
+*		- XST_NOT_ENABLED if the DMA arena is not mapped.
+*		- XST_BUFFER_TOO_SMALL if the DMA arena is full.
+*		- XST_FAILURE if the interrupt cannot be connected.
+*
+*****************************************************************************/
+s32 UsbCdc_Initialize(UsbCdc *CdcPtr, UINTPTR BaseAddress, u32 IntrId,
+		      UINTPTR IntrParent)
+{
+	UINTPTR MemAddr;
+	s32 Status;
+
+	Xil_AssertNonvoid(CdcPtr != NULL);
+
+	(void)memset(CdcPtr, 0, sizeof(*CdcPtr));
+	CdcPtr->BaseAddress = BaseAddress;
+
+	/* One block, the dQHs rounded up to their 2 KB inside it */
+	Status = Xil_DmaPoolCreate(&CdcPtr->Pool, sizeof(UsbCdc_Mem) +
+				   USB_CDC_QH_ALIGN, 1U);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+	MemAddr = (UINTPTR)Xil_DmaPoolAlloc(&CdcPtr->Pool);
+	MemAddr = (MemAddr + USB_CDC_QH_ALIGN - 1U) &
+		  ~((UINTPTR)USB_CDC_QH_ALIGN - 1U);
+	CdcPtr->MemPtr = (UsbCdc_Mem *)MemAddr;
+	(void)memset(CdcPtr->MemPtr, 0, sizeof(UsbCdc_Mem));
+
+	CdcPtr->Rx.DtdPtr = CdcPtr->MemPtr->RxDtd;
+	CdcPtr->Rx.Qh = USB_CDC_QH_DATA_OUT;
+	CdcPtr->Rx.Bit = USB_CDC_OUT_BIT(USB_CDC_EP_DATA);
+	CdcPtr->Rx.Event = USB_CDC_EVENT_RECV;
+	CdcPtr->Tx.DtdPtr = CdcPtr->MemPtr->TxDtd;
+	CdcPtr->Tx.Qh = USB_CDC_QH_DATA_IN;
+	CdcPtr->Tx.Bit = USB_CDC_IN_BIT(USB_CDC_EP_DATA);
+	CdcPtr->Tx.Event = USB_CDC_EVENT_SENT;
+
+	/* 115200 baud, 1 stop bit, no parity, 8 data bits */
+	CdcPtr->LineCoding[0] = 0x00U;
+	CdcPtr->LineCoding[1] = 0xC2U;
+	CdcPtr->LineCoding[2] = 0x01U;
+	CdcPtr->LineCoding[6] = 8U;
+	CdcPtr->PacketSize = USB_CDC_HS_PACKET;
+
+	UsbCdc_Write(CdcPtr, USB_CDC_CMD, USB_CDC_CMD_RST);
+	while ((UsbCdc_Read(CdcPtr, USB_CDC_CMD) & USB_CDC_CMD_RST) != 0U) {
+		;
+	}
+
+	UsbCdc_Write(CdcPtr, USB_CDC_MODE, USB_CDC_MODE_DEVICE |
+		     USB_CDC_MODE_SLOM);
+	UsbCdc_Write(CdcPtr, USB_CDC_EPLIST, (u32)MemAddr);
+
+	CdcPtr->MemPtr->Dqh[USB_CDC_QH_EP0_OUT].Caps =
+		(USB_CDC_EP0_PACKET << USB_CDC_QH_PACKET_SHIFT) |
+		USB_CDC_QH_IOS | USB_CDC_QH_ZLT;
+	CdcPtr->MemPtr->Dqh[USB_CDC_QH_EP0_IN].Caps =
+		(USB_CDC_EP0_PACKET << USB_CDC_QH_PACKET_SHIFT) |
+		USB_CDC_QH_ZLT;
+	CdcPtr->MemPtr->Dqh[USB_CDC_QH_EP0_OUT].Next = USB_CDC_DTD_TERMINATE;
+	CdcPtr->MemPtr->Dqh[USB_CDC_QH_EP0_IN].Next = USB_CDC_DTD_TERMINATE;
+
+	/* Interrupt on every completion, not on the microframe threshold */
+	UsbCdc_Write(CdcPtr, USB_CDC_CMD, UsbCdc_Read(CdcPtr, USB_CDC_CMD) &
+		     ~USB_CDC_CMD_ITC_MASK);
+	UsbCdc_Write(CdcPtr, USB_CDC_STS, USB_CDC_STS_ALL);
+	UsbCdc_Write(CdcPtr, USB_CDC_INTR, USB_CDC_STS_ALL);
+
+	return XSetupInterruptSystem(CdcPtr, &UsbCdc_InterruptHandler, IntrId,
+				     IntrParent, XINTERRUPT_DEFAULT_PRIORITY);
+}
+
+/****************************************************************************/
+/**
+*
+* Sets the event handler of the port.
+*
+* @param	CdcPtr is a pointer to the port.
+* @param	Handler is the handler, called from the interrupt handler.
+* @param	CallBackRef is passed to the handler.
+*
+* @return	None.
+*
+*****************************************************************************/
+void UsbCdc_SetHandler(UsbCdc *CdcPtr, UsbCdc_Handler Handler,
+		       void *CallBackRef)
+{
+	Xil_AssertVoid(CdcPtr != NULL);
+
+	CdcPtr->Handler = Handler;
+	CdcPtr->CallBackRef = CallBackRef;
+}
+
+/****************************************************************************/
+/**
+*
+* Attaches the port to the bus, the host then enumerates it. Transfers may
+* be queued before.
+*
+* @param	CdcPtr is a pointer to an initialized port.
+*
+* @return	None.
+*
+*****************************************************************************/
+void UsbCdc_Start(UsbCdc *CdcPtr)
+{
+	Xil_AssertVoid(CdcPtr != NULL);
+
+	UsbCdc_Write(CdcPtr, USB_CDC_CMD, UsbCdc_Read(CdcPtr, USB_CDC_CMD) |
+		     USB_CDC_CMD_RS);
+}
+
+/****************************************************************************/
+/**
+*
+* Detaches the port from the bus and drops the queued transfers, without
+* handing them back.
+*
+* @param	CdcPtr is a pointer to the port.
+*
+* @return	None.
+*
+*****************************************************************************/
+void UsbCdc_Stop(UsbCdc *CdcPtr)
+{
+	u32 Cpsr;
+
+	Xil_AssertVoid(CdcPtr != NULL);
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	UsbCdc_Write(CdcPtr, USB_CDC_CMD, UsbCdc_Read(CdcPtr, USB_CDC_CMD) &
+		     ~USB_CDC_CMD_RS);
+	UsbCdc_Reset(CdcPtr);
+	CdcPtr->Rx.Tail = CdcPtr->Rx.Head;
+	CdcPtr->Tx.Tail = CdcPtr->Tx.Head;
+	mtcpsr(Cpsr);
+}
+
+/****************************************************************************/
+/**
+*
+* Queues a buffer to receive from the host into. The buffer is handed back
+* with USB_CDC_EVENT_RECV once a short packet ends the transfer or it is
+* full, buffers completing in the order they were queued. A completion
+* with zero bytes is a zero length packet of the host, or an error.
+*
+* @param	CdcPtr is a pointer to the port.
+* @param	BufferPtr is the buffer, aligned to a cache line.
+* @param	Length is its size, a multiple of USB_CDC_HS_PACKET of at most
+*		USB_CDC_MAX_XFER.
+*
+* @return
+*		- XST_SUCCESS if the buffer is queued.
+*		- XST_INVALID_PARAM for a bad length.
+*		- XST_DEVICE_BUSY if USB_CDC_XFERS buffers are queued.
+*
+*****************************************************************************/
+s32 UsbCdc_Recv(UsbCdc *CdcPtr, u8 *BufferPtr, u32 Length)
+{
+	Xil_AssertNonvoid((CdcPtr != NULL) && (BufferPtr != NULL));
+
+	if ((Length == 0U) || (Length > USB_CDC_MAX_XFER) ||
+	    ((Length % USB_CDC_HS_PACKET) != 0U)) {
+		return XST_INVALID_PARAM;
+	}
+
+	if (Xil_DmaArenaContains((UINTPTR)BufferPtr, Length) == 0U) {
+		/* No dirty line may be evicted over what the controller writes */
+		Xil_DCacheInvalidateRange((INTPTR)BufferPtr, Length);
+	}
+
+	return UsbCdc_Queue_Submit(CdcPtr, &CdcPtr->Rx, BufferPtr, Length);
+}
+
+/****************************************************************************/
+/**
+*
+* Queues a buffer to send to the host, from its memory. A transfer that is
+* a multiple of the packet size is ended by a zero length packet. The
+* buffer is handed back with USB_CDC_EVENT_SENT.
+*
+* @param	CdcPtr is a pointer to the port.
+* @param	BufferPtr is the data.
+* @param	Length is the number of bytes, 1 to USB_CDC_MAX_XFER.
+*
+* @return
+*		- XST_SUCCESS if the buffer is queued.
+*		- XST_INVALID_PARAM for a bad length.
+*		- XST_DEVICE_BUSY if USB_CDC_XFERS buffers are queued.
+*
+*****************************************************************************/
+s32 UsbCdc_Send(UsbCdc *CdcPtr, u8 *BufferPtr, u32 Length)
+{
+	Xil_AssertNonvoid((CdcPtr != NULL) && (BufferPtr != NULL));
+
+	if ((Length == 0U) || (Length > USB_CDC_MAX_XFER)) {
+		return XST_INVALID_PARAM;
+	}
+
+	if (Xil_DmaArenaContains((UINTPTR)BufferPtr, Length) == 0U) {
+		Xil_DCacheFlushRange((INTPTR)BufferPtr, Length);
+	}
+
+	return UsbCdc_Queue_Submit(CdcPtr, &CdcPtr->Tx, BufferPtr, Length);
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the line rate the host set, in baud.
+*
+* @param	CdcPtr is a pointer to the port.
+*
+* @return	dwDTERate of the line coding.
+*
+*****************************************************************************/
+u32 UsbCdc_GetRate(const UsbCdc *CdcPtr)
+{
+	Xil_AssertNonvoid(CdcPtr != NULL);
+
+	return (u32)CdcPtr->LineCoding[0] | ((u32)CdcPtr->LineCoding[1] << 8) |
+	       ((u32)CdcPtr->LineCoding[2] << 16) |
+	       ((u32)CdcPtr->LineCoding[3] << 24);
+}
+
+/****************************************************************************/
+/**
+*
+* Takes a consistent snapshot of the counts of the port.
+*
+* @param	CdcPtr is a pointer to the port.
+* @param	StatsPtr receives the counts.
+*
+* @return	None.
+*
+*****************************************************************************/
+void UsbCdc_GetStats(const UsbCdc *CdcPtr, UsbCdc_Stats *StatsPtr)
+{
+	u32 Cpsr;
+
+	Xil_AssertVoid((CdcPtr != NULL) && (StatsPtr != NULL));
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+	*StatsPtr = CdcPtr->Stats;
+	mtcpsr(Cpsr);
+}
+
+/****************************************************************************/
+/**
+*
+* Interrupt handler of the controller: bus reset, speed, completions and
+* setup packets, in that order.
+*
+* @param	InstancePtr is the UsbCdc.
+*
+* @return	None.
+*
+*****************************************************************************/
+void UsbCdc_InterruptHandler(void *InstancePtr)
+{
+	UsbCdc *CdcPtr = (UsbCdc *)InstancePtr;
+	u32 Status;
+	u32 Complete;
+
+	Status = UsbCdc_Read(CdcPtr, USB_CDC_STS) &
+		 UsbCdc_Read(CdcPtr, USB_CDC_INTR);
+	UsbCdc_Write(CdcPtr, USB_CDC_STS, Status);
+
+	if ((Status & USB_CDC_STS_URI) != 0U) {
+		CdcPtr->Stats.Resets++;
+		UsbCdc_Reset(CdcPtr);
+		UsbCdc_Event(CdcPtr, USB_CDC_EVENT_RESET, NULL, 0U);
+	}
+
+	if (((Status & USB_CDC_STS_PCI) != 0U) &&
+	    ((UsbCdc_Read(CdcPtr, USB_CDC_PORTSC) &
+	      USB_CDC_PORTSC_PR) == 0U)) {
+		CdcPtr->PacketSize = ((UsbCdc_Read(CdcPtr, USB_CDC_PORTSC) &
+				       USB_CDC_PORTSC_PSPD) ==
+				      USB_CDC_PORTSC_HS) ?
+				     USB_CDC_HS_PACKET : USB_CDC_FS_PACKET;
+	}
+
+	if ((Status & (USB_CDC_STS_UI | USB_CDC_STS_UEI)) == 0U) {
+		return;
+	}
+
+	Complete = UsbCdc_Read(CdcPtr, USB_CDC_COMPLETE);
+	UsbCdc_Write(CdcPtr, USB_CDC_COMPLETE, Complete);
+
+	if ((Complete & CdcPtr->Rx.Bit) != 0U) {
+		UsbCdc_Queue_Complete(CdcPtr, &CdcPtr->Rx);
+	}
+	if ((Complete & CdcPtr->Tx.Bit) != 0U) {
+		UsbCdc_Queue_Complete(CdcPtr, &CdcPtr->Tx);
+	}
+
+	/* A new setup packet cancels what is left of the previous request */
+	if ((UsbCdc_Read(CdcPtr, USB_CDC_SETUPSTAT) & 0x1U) != 0U) {
+		UsbCdc_Setup(CdcPtr);
+	} else if ((Complete & (USB_CDC_OUT_BIT(0U) |
+				USB_CDC_IN_BIT(0U))) != 0U) {
+		UsbCdc_Ep0Complete(CdcPtr, Complete);
+	} else {
+		/* Else with dummy entry for MISRA-C Compliance.*/
+		;
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Cancels all transfers in the controller, after a bus reset or a detach.
+* The queues are kept for UsbCdc_Queue_Restart().
+*
+* @param	CdcPtr is a pointer to the port.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void UsbCdc_Reset(UsbCdc *CdcPtr)
+{
+	UsbCdc_Write(CdcPtr, USB_CDC_SETUPSTAT,
+		     UsbCdc_Read(CdcPtr, USB_CDC_SETUPSTAT));
+	UsbCdc_Write(CdcPtr, USB_CDC_COMPLETE,
+		     UsbCdc_Read(CdcPtr, USB_CDC_COMPLETE));
+	UsbCdc_Write(CdcPtr, USB_CDC_FLUSH, 0xFFFFFFFFU);
+	while (UsbCdc_Read(CdcPtr, USB_CDC_FLUSH) != 0U) {
+		;
+	}
+
+	UsbCdc_Write(CdcPtr, USB_CDC_ADDR, 0U);
+	UsbCdc_Write(CdcPtr, USB_CDC_EPCTRL(USB_CDC_EP_NOTIFY), 0U);
+	UsbCdc_Write(CdcPtr, USB_CDC_EPCTRL(USB_CDC_EP_DATA), 0U);
+	CdcPtr->Configured = 0U;
+	CdcPtr->Ep0State = USB_CDC_EP0_IDLE;
+}
+
+/****************************************************************************/
+/*
+*
+* Fills a dTD for one buffer, active, interrupting on completion and the
+* last of its list.
+*
+* @param	DtdPtr is the dTD.
+* @param	BufferPtr is the buffer.
+* @param	Length is its length, at most USB_CDC_MAX_XFER, which fits the
+*		five pages of a dTD from any start.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void UsbCdc_FillDtd(UsbCdc_Dtd *DtdPtr, const u8 *BufferPtr,
+			   u32 Length)
+{
+	u32 Addr = (u32)(UINTPTR)BufferPtr;
+	u32 Page;
+
+	DtdPtr->Next = USB_CDC_DTD_TERMINATE;
+	DtdPtr->Buffer[0] = Addr;
+	for (Page = 1U; Page < 5U; Page++) {
+		DtdPtr->Buffer[Page] = (Addr & ~(USB_CDC_DTD_PAGE - 1U)) +
+				       (Page * USB_CDC_DTD_PAGE);
+	}
+	DtdPtr->Token = (Length << USB_CDC_DTD_BYTES_SHIFT) |
+			USB_CDC_DTD_IOC | USB_CDC_DTD_ACTIVE;
+}
+
+/****************************************************************************/
+/*
+*
+* Primes an idle endpoint with a list of dTDs.
+*
+* @param	CdcPtr is a pointer to the port.
+* @param	Qh is the index of the dQH.
+* @param	DtdPtr is the first dTD.
+* @param	Bit is the bit of the endpoint in ENDPTPRIME.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void UsbCdc_Prime(UsbCdc *CdcPtr, u32 Qh, UsbCdc_Dtd *DtdPtr, u32 Bit)
+{
+	UsbCdc_Dqh *DqhPtr = &CdcPtr->MemPtr->Dqh[Qh];
+
+	DqhPtr->Next = (u32)(UINTPTR)DtdPtr;
+	DqhPtr->Token &= ~(USB_CDC_DTD_ACTIVE | USB_CDC_DTD_ERRORS);
+	dsb();
+	UsbCdc_Write(CdcPtr, USB_CDC_PRIME, Bit);
+}
+
+/****************************************************************************/
+/*
+*
+* Queues a transfer behind the ones in flight, refer to the file header.
+* It is started by the configuration if the port is not configured yet.
+*
+* @param	CdcPtr is a pointer to the port.
+* @param	QueuePtr is the queue of the endpoint.
+* @param	BufferPtr is the buffer.
+* @param	Length is its length.
+*
+* @return	XST_SUCCESS, or XST_DEVICE_BUSY for a full queue.
+*
+*****************************************************************************/
+static s32 UsbCdc_Queue_Submit(UsbCdc *CdcPtr, UsbCdc_Queue *QueuePtr,
+			       u8 *BufferPtr, u32 Length)
+{
+	UsbCdc_Dtd *DtdPtr;
+	UsbCdc_Dtd *LastPtr;
+	u32 Slot;
+	u32 Primed;
+	u32 Active;
+	u32 Cpsr;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE | XREG_CPSR_FIQ_ENABLE);
+
+	if ((QueuePtr->Head - QueuePtr->Tail) >= USB_CDC_XFERS) {
+		mtcpsr(Cpsr);
+		return XST_DEVICE_BUSY;
+	}
+
+	Slot = QueuePtr->Head % USB_CDC_XFERS;
+	DtdPtr = &QueuePtr->DtdPtr[Slot];
+	QueuePtr->BufferPtr[Slot] = BufferPtr;
+	QueuePtr->Length[Slot] = Length;
+	UsbCdc_FillDtd(DtdPtr, BufferPtr, Length);
+
+	if (QueuePtr->Head != QueuePtr->Tail) {
+		LastPtr = &QueuePtr->DtdPtr[(QueuePtr->Head - 1U) %
+					    USB_CDC_XFERS];
+		LastPtr->Next = (u32)(UINTPTR)DtdPtr;
+	}
+	QueuePtr->Head++;
+
+	if (CdcPtr->Configured == 0U) {
+		mtcpsr(Cpsr);
+		return XST_SUCCESS;
+	}
+
+	if ((QueuePtr->Head - QueuePtr->Tail) == 1U) {
+		UsbCdc_Prime(CdcPtr, QueuePtr->Qh, DtdPtr, QueuePtr->Bit);
+	} else {
+		dsb();
+		Primed = UsbCdc_Read(CdcPtr, USB_CDC_PRIME) & QueuePtr->Bit;
+		if (Primed == 0U) {
+			/*
+			 * ENDPTSTAT is only trusted if the tripwire survived
+			 * its read, no setup or dTD having come in between.
+			 */
+			do {
+				UsbCdc_Write(CdcPtr, USB_CDC_CMD,
+					     UsbCdc_Read(CdcPtr, USB_CDC_CMD) |
+					     USB_CDC_CMD_ATDTW);
+				Active = UsbCdc_Read(CdcPtr, USB_CDC_EPSTAT) &
+					 QueuePtr->Bit;
+			} while ((UsbCdc_Read(CdcPtr, USB_CDC_CMD) &
+				  USB_CDC_CMD_ATDTW) == 0U);
+			UsbCdc_Write(CdcPtr, USB_CDC_CMD,
+				     UsbCdc_Read(CdcPtr, USB_CDC_CMD) &
+				     ~USB_CDC_CMD_ATDTW);
+			if (Active == 0U) {
+				UsbCdc_Prime(CdcPtr, QueuePtr->Qh, DtdPtr,
+					     QueuePtr->Bit);
+			}
+		}
+	}
+
+	mtcpsr(Cpsr);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/*
+*
+* Starts the transfers of a queue again from their beginning, once the
+* endpoint is configured.
+*
+* @param	CdcPtr is a pointer to the port.
+* @param	QueuePtr is the queue of the endpoint.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void UsbCdc_Queue_Restart(UsbCdc *CdcPtr, UsbCdc_Queue *QueuePtr)
+{
+	u32 Index;
+	u32 Slot;
+
+	if (QueuePtr->Head == QueuePtr->Tail) {
+		return;
+	}
+
+	for (Index = QueuePtr->Tail; Index != QueuePtr->Head; Index++) {
+		Slot = Index % USB_CDC_XFERS;
+		UsbCdc_FillDtd(&QueuePtr->DtdPtr[Slot],
+			       QueuePtr->BufferPtr[Slot],
+			       QueuePtr->Length[Slot]);
+		if ((Index + 1U) != QueuePtr->Head) {
+			QueuePtr->DtdPtr[Slot].Next = (u32)(UINTPTR)
+				&QueuePtr->DtdPtr[(Index + 1U) % USB_CDC_XFERS];
+		}
+	}
+
+	UsbCdc_Prime(CdcPtr, QueuePtr->Qh,
+		     &QueuePtr->DtdPtr[QueuePtr->Tail % USB_CDC_XFERS],
+		     QueuePtr->Bit);
+}
+
+/****************************************************************************/
+/*
+*
+* Hands back the completed transfers of a queue, in order.
+*
+* @param	CdcPtr is a pointer to the port.
+* @param	QueuePtr is the queue of the endpoint.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void UsbCdc_Queue_Complete(UsbCdc *CdcPtr, UsbCdc_Queue *QueuePtr)
+{
+	u32 Slot;
+	u32 Token;
+	u32 Length;
+	u8 *BufferPtr;
+
+	while (QueuePtr->Tail != QueuePtr->Head) {
+		Slot = QueuePtr->Tail % USB_CDC_XFERS;
+		Token = QueuePtr->DtdPtr[Slot].Token;
+		if ((Token & USB_CDC_DTD_ACTIVE) != 0U) {
+			break;
+		}
+
+		BufferPtr = QueuePtr->BufferPtr[Slot];
+		Length = QueuePtr->Length[Slot];
+		if ((Token & USB_CDC_DTD_ERRORS) != 0U) {
+			CdcPtr->Stats.Errors++;
+			Length = 0U;
+		} else {
+			Length -= (Token >> USB_CDC_DTD_BYTES_SHIFT) &
+				  USB_CDC_DTD_BYTES_MASK;
+		}
+		QueuePtr->Tail++;
+
+		if (QueuePtr->Event == USB_CDC_EVENT_RECV) {
+			if ((Length != 0U) && (Xil_DmaArenaContains(
+				(UINTPTR)BufferPtr, Length) == 0U)) {
+				Xil_DCacheInvalidateRange((INTPTR)BufferPtr,
+							  Length);
+			}
+			CdcPtr->Stats.RecvBytes += Length;
+		} else {
+			CdcPtr->Stats.SentBytes += Length;
+		}
+
+		UsbCdc_Event(CdcPtr, QueuePtr->Event, BufferPtr, Length);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Sets the configuration: 1 enables the notification and the bulk
+* endpoints, for the speed the port was reset to, and starts the queued
+* transfers; 0 disables them.
+*
+* @param	CdcPtr is a pointer to the port.
+* @param	Configuration is the bConfigurationValue, 0 or 1.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void UsbCdc_Configure(UsbCdc *CdcPtr, u32 Configuration)
+{
+	UsbCdc_Mem *MemPtr = CdcPtr->MemPtr;
+	u32 Bits = USB_CDC_IN_BIT(USB_CDC_EP_NOTIFY) | CdcPtr->Rx.Bit |
+		   CdcPtr->Tx.Bit;
+
+	UsbCdc_Write(CdcPtr, USB_CDC_FLUSH, Bits);
+	while ((UsbCdc_Read(CdcPtr, USB_CDC_FLUSH) & Bits) != 0U) {
+		;
+	}
+	CdcPtr->Configured = 0U;
+
+	if (Configuration == 0U) {
+		UsbCdc_Write(CdcPtr, USB_CDC_EPCTRL(USB_CDC_EP_NOTIFY), 0U);
+		UsbCdc_Write(CdcPtr, USB_CDC_EPCTRL(USB_CDC_EP_DATA), 0U);
+		return;
+	}
+
+	MemPtr->Dqh[USB_CDC_QH_NOTIFY].Caps =
+		(USB_CDC_NOTIFY_PACKET << USB_CDC_QH_PACKET_SHIFT) |
+		USB_CDC_QH_ZLT;
+	MemPtr->Dqh[USB_CDC_QH_NOTIFY].Next = USB_CDC_DTD_TERMINATE;
+	MemPtr->Dqh[USB_CDC_QH_DATA_OUT].Caps =
+		(CdcPtr->PacketSize << USB_CDC_QH_PACKET_SHIFT) |
+		USB_CDC_QH_ZLT;
+	MemPtr->Dqh[USB_CDC_QH_DATA_OUT].Next = USB_CDC_DTD_TERMINATE;
+	MemPtr->Dqh[USB_CDC_QH_DATA_IN].Caps =
+		CdcPtr->PacketSize << USB_CDC_QH_PACKET_SHIFT;
+	MemPtr->Dqh[USB_CDC_QH_DATA_IN].Next = USB_CDC_DTD_TERMINATE;
+	dsb();
+
+	/* The unused OUT of EP1 is typed bulk, never control */
+	UsbCdc_Write(CdcPtr, USB_CDC_EPCTRL(USB_CDC_EP_NOTIFY),
+		     USB_CDC_EPCTRL_TXE | USB_CDC_EPCTRL_TXR |
+		     USB_CDC_EPCTRL_TX_INTR | USB_CDC_EPCTRL_RX_BULK);
+	UsbCdc_Write(CdcPtr, USB_CDC_EPCTRL(USB_CDC_EP_DATA),
+		     USB_CDC_EPCTRL_TXE | USB_CDC_EPCTRL_TXR |
+		     USB_CDC_EPCTRL_TX_BULK | USB_CDC_EPCTRL_RXE |
+		     USB_CDC_EPCTRL_RXR | USB_CDC_EPCTRL_RX_BULK);
+
+	CdcPtr->Configured = 1U;
+	UsbCdc_Queue_Restart(CdcPtr, &CdcPtr->Rx);
+	UsbCdc_Queue_Restart(CdcPtr, &CdcPtr->Tx);
+}
+
+/****************************************************************************/
+/*
+*
+* Takes the setup packet of EP0 and answers the request, or stalls EP0 for
+* a request it does not know.
+*
+* @param	CdcPtr is a pointer to the port.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void UsbCdc_Setup(UsbCdc *CdcPtr)
+{
+	UsbCdc_Dqh *DqhPtr = &CdcPtr->MemPtr->Dqh[USB_CDC_QH_EP0_OUT];
+	u8 Setup[8];
+	u32 Requested;
+	u32 Length = 0U;
+	u32 Handled;
+
+	/* The setup tripwire is cleared if another setup overwrote this one */
+	do {
+		UsbCdc_Write(CdcPtr, USB_CDC_CMD,
+			     UsbCdc_Read(CdcPtr, USB_CDC_CMD) |
+			     USB_CDC_CMD_SUTW);
+		(void)memcpy(Setup, (const void *)DqhPtr->Setup, sizeof(Setup));
+	} while ((UsbCdc_Read(CdcPtr, USB_CDC_CMD) & USB_CDC_CMD_SUTW) == 0U);
+	UsbCdc_Write(CdcPtr, USB_CDC_CMD, UsbCdc_Read(CdcPtr, USB_CDC_CMD) &
+		     ~USB_CDC_CMD_SUTW);
+	UsbCdc_Write(CdcPtr, USB_CDC_SETUPSTAT, 0x1U);
+
+	/* Whatever EP0 still had primed belongs to the previous request */
+	UsbCdc_Write(CdcPtr, USB_CDC_FLUSH, USB_CDC_OUT_BIT(0U) |
+		     USB_CDC_IN_BIT(0U));
+	while ((UsbCdc_Read(CdcPtr, USB_CDC_FLUSH) &
+		(USB_CDC_OUT_BIT(0U) | USB_CDC_IN_BIT(0U))) != 0U) {
+		;
+	}
+
+	CdcPtr->Stats.Setups++;
+	CdcPtr->Ep0State = USB_CDC_EP0_IDLE;
+	Requested = (u32)Setup[6] | ((u32)Setup[7] << 8);
+
+	switch (Setup[0] & USB_CDC_REQ_TYPE_MASK) {
+	case USB_CDC_REQ_STANDARD:
+		Handled = UsbCdc_Standard(CdcPtr, Setup, &Length);
+		break;
+	case USB_CDC_REQ_CLASS:
+		Handled = UsbCdc_Class(CdcPtr, Setup, &Length);
+		break;
+	default:
+		Handled = 0U;
+		break;
+	}
+
+	if (Handled == 0U) {
+		CdcPtr->Stats.Stalls++;
+		UsbCdc_Write(CdcPtr, USB_CDC_EPCTRL(0U),
+			     UsbCdc_Read(CdcPtr, USB_CDC_EPCTRL(0U)) |
+			     USB_CDC_EPCTRL_TXS | USB_CDC_EPCTRL_RXS);
+	} else if (CdcPtr->Ep0State == USB_CDC_EP0_DATA_OUT) {
+		UsbCdc_Ep0Recv(CdcPtr, Length);
+	} else if ((Setup[0] & 0x80U) != 0U) {
+		CdcPtr->Ep0State = USB_CDC_EP0_DATA_IN;
+		UsbCdc_Ep0Send(CdcPtr, Length, Requested);
+	} else {
+		CdcPtr->Ep0State = USB_CDC_EP0_STATUS;
+		UsbCdc_Ep0Send(CdcPtr, 0U, 0U);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Answers a standard request. An IN data stage is left in the EP0 buffer.
+*
+* @param	CdcPtr is a pointer to the port.
+* @param	SetupPtr is the setup packet.
+* @param	Length receives the length of the data stage.
+*
+* @return	1 if the request is handled, 0 to stall it.
+*
+*****************************************************************************/
+static u32 UsbCdc_Standard(UsbCdc *CdcPtr, const u8 *SetupPtr, u32 *Length)
+{
+	u8 *BufferPtr = CdcPtr->MemPtr->Ep0Buffer;
+	u32 Ep = (u32)SetupPtr[4] & 0x0FU;
+	u32 Mask = ((SetupPtr[4] & 0x80U) != 0U) ? USB_CDC_EPCTRL_TXS :
+						   USB_CDC_EPCTRL_RXS;
+	u32 Handled = 1U;
+
+	switch (SetupPtr[1]) {
+	case USB_CDC_GET_STATUS:
+		BufferPtr[0] = 0U;
+		BufferPtr[1] = 0U;
+		if (((SetupPtr[0] & USB_CDC_REQ_RECIPIENT) ==
+		     USB_CDC_REQ_ENDPOINT) && (Ep <= USB_CDC_EP_DATA) &&
+		    ((UsbCdc_Read(CdcPtr, USB_CDC_EPCTRL(Ep)) & Mask) != 0U)) {
+			BufferPtr[0] = 1U;
+		}
+		*Length = 2U;
+		break;
+	case USB_CDC_CLEAR_FEATURE:
+	case USB_CDC_SET_FEATURE:
+		if (((SetupPtr[0] & USB_CDC_REQ_RECIPIENT) ==
+		     USB_CDC_REQ_ENDPOINT) &&
+		    (SetupPtr[2] == USB_CDC_FEATURE_HALT)) {
+			if ((Ep == 0U) || (Ep > USB_CDC_EP_DATA)) {
+				Handled = (Ep == 0U) ? 1U : 0U;
+			} else if (SetupPtr[1] == USB_CDC_SET_FEATURE) {
+				UsbCdc_Write(CdcPtr, USB_CDC_EPCTRL(Ep),
+					     UsbCdc_Read(CdcPtr,
+							 USB_CDC_EPCTRL(Ep)) |
+					     Mask);
+			} else {
+				/* Unstall and reset the data toggle */
+				UsbCdc_Write(CdcPtr, USB_CDC_EPCTRL(Ep),
+					     (UsbCdc_Read(CdcPtr,
+							  USB_CDC_EPCTRL(Ep)) &
+					      ~Mask) |
+					     (Mask << 6));
+			}
+		}
+		break;
+	case USB_CDC_SET_ADDRESS:
+		UsbCdc_Write(CdcPtr, USB_CDC_ADDR,
+			     ((u32)SetupPtr[2] << USB_CDC_ADDR_SHIFT) |
+			     USB_CDC_ADDR_ADVANCE);
+		break;
+	case USB_CDC_GET_DESCRIPTOR:
+		*Length = UsbCdc_Descriptor(CdcPtr, SetupPtr[3], SetupPtr[2]);
+		Handled = (*Length != 0U) ? 1U : 0U;
+		break;
+	case USB_CDC_GET_CONFIGURATION:
+		BufferPtr[0] = (u8)CdcPtr->Configured;
+		*Length = 1U;
+		break;
+	case USB_CDC_SET_CONFIGURATION:
+		if (SetupPtr[2] > 1U) {
+			Handled = 0U;
+		} else {
+			UsbCdc_Configure(CdcPtr, SetupPtr[2]);
+			if (SetupPtr[2] != 0U) {
+				UsbCdc_Event(CdcPtr, USB_CDC_EVENT_CONFIGURED,
+					     NULL, 0U);
+			}
+		}
+		break;
+	case USB_CDC_GET_INTERFACE:
+		BufferPtr[0] = 0U;
+		*Length = 1U;
+		break;
+	case USB_CDC_SET_INTERFACE:
+		Handled = (SetupPtr[2] == 0U) ? 1U : 0U;
+		break;
+	default:
+		Handled = 0U;
+		break;
+	}
+
+	return Handled;
+}
+
+/****************************************************************************/
+/*
+*
+* Answers an ACM request of the communication interface.
+*
+* @param	CdcPtr is a pointer to the port.
+* @param	SetupPtr is the setup packet.
+* @param	Length receives the length of the data stage.
+*
+* @return	1 if the request is handled, 0 to stall it.
+*
+*****************************************************************************/
+static u32 UsbCdc_Class(UsbCdc *CdcPtr, const u8 *SetupPtr, u32 *Length)
+{
+	u32 Handled = 1U;
+
+	switch (SetupPtr[1]) {
+	case USB_CDC_SET_LINE_CODING:
+		CdcPtr->Request = SetupPtr[1];
+		CdcPtr->Ep0State = USB_CDC_EP0_DATA_OUT;
+		*Length = USB_CDC_LINE_CODING_SIZE;
+		break;
+	case USB_CDC_GET_LINE_CODING:
+		(void)memcpy(CdcPtr->MemPtr->Ep0Buffer, CdcPtr->LineCoding,
+			     USB_CDC_LINE_CODING_SIZE);
+		*Length = USB_CDC_LINE_CODING_SIZE;
+		break;
+	case USB_CDC_SET_CONTROL_LINE_STATE:
+		CdcPtr->LineState = (u32)SetupPtr[2] &
+				    (USB_CDC_LINE_DTR | USB_CDC_LINE_RTS);
+		UsbCdc_Event(CdcPtr, USB_CDC_EVENT_LINE_STATE, NULL,
+			     CdcPtr->LineState);
+		break;
+	case USB_CDC_SEND_BREAK:
+		break;
+	default:
+		Handled = 0U;
+		break;
+	}
+
+	return Handled;
+}
+
+/****************************************************************************/
+/*
+*
+* Builds a descriptor in the EP0 buffer.
+*
+* @param	CdcPtr is a pointer to the port.
+* @param	Type is the descriptor type.
+* @param	Index is the descriptor index.
+*
+* @return	The length of the descriptor, 0 if there is none.
+*
+*****************************************************************************/
+static u32 UsbCdc_Descriptor(UsbCdc *CdcPtr, u32 Type, u32 Index)
+{
+	u8 *BufferPtr = CdcPtr->MemPtr->Ep0Buffer;
+	const char *StringPtr;
+	u32 Packet;
+	u32 Length = 0U;
+
+	switch (Type) {
+	case USB_CDC_DESC_DEVICE:
+		Length = sizeof(UsbCdc_DeviceDesc);
+		(void)memcpy(BufferPtr, UsbCdc_DeviceDesc, Length);
+		break;
+	case USB_CDC_DESC_QUALIFIER:
+		Length = sizeof(UsbCdc_QualifierDesc);
+		(void)memcpy(BufferPtr, UsbCdc_QualifierDesc, Length);
+		break;
+	case USB_CDC_DESC_CONFIG:
+	case USB_CDC_DESC_OTHER_SPEED:
+		Length = sizeof(UsbCdc_ConfigDesc);
+		(void)memcpy(BufferPtr, UsbCdc_ConfigDesc, Length);
+		BufferPtr[1] = (u8)Type;
+		Packet = CdcPtr->PacketSize;
+		if (Type == USB_CDC_DESC_OTHER_SPEED) {
+			Packet = (Packet == USB_CDC_HS_PACKET) ?
+				 USB_CDC_FS_PACKET : USB_CDC_HS_PACKET;
+		}
+		if (Packet == USB_CDC_FS_PACKET) {
+			BufferPtr[USB_CDC_CONFIG_INTERVAL] = 16U;
+			BufferPtr[USB_CDC_CONFIG_IN_PACKET] = (u8)Packet;
+			BufferPtr[USB_CDC_CONFIG_IN_PACKET + 1U] = 0U;
+			BufferPtr[USB_CDC_CONFIG_OUT_PACKET] = (u8)Packet;
+			BufferPtr[USB_CDC_CONFIG_OUT_PACKET + 1U] = 0U;
+		}
+		break;
+	case USB_CDC_DESC_STRING:
+		if (Index == 0U) {
+			BufferPtr[2] = 0x09U;	/* English (United States) */
+			BufferPtr[3] = 0x04U;
+			Length = 4U;
+		} else if (Index < (sizeof(UsbCdc_Strings) /
+				    sizeof(UsbCdc_Strings[0]))) {
+			/* UTF-16LE of the ASCII string */
+			Length = 2U;
+			for (StringPtr = UsbCdc_Strings[Index];
+			     (*StringPtr != '\0') &&
+			     (Length < USB_CDC_EP0_BUFFER); StringPtr++) {
+				BufferPtr[Length] = (u8)*StringPtr;
+				BufferPtr[Length + 1U] = 0U;
+				Length += 2U;
+			}
+		} else {
+			/* Else with dummy entry for MISRA-C Compliance.*/
+			;
+		}
+		if (Length != 0U) {
+			BufferPtr[0] = (u8)Length;
+			BufferPtr[1] = USB_CDC_DESC_STRING;
+		}
+		break;
+	default:
+		break;
+	}
+
+	return Length;
+}
+
+/****************************************************************************/
+/*
+*
+* Starts an IN stage of EP0 from the EP0 buffer, followed by a zero length
+* packet if the data ends on a packet boundary short of what the host
+* asked for.
+*
+* @param	CdcPtr is a pointer to the port.
+* @param	Length is the length of the data, 0 for a status stage.
+* @param	Requested is the wLength of the request.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void UsbCdc_Ep0Send(UsbCdc *CdcPtr, u32 Length, u32 Requested)
+{
+	UsbCdc_Dtd *DtdPtr = CdcPtr->MemPtr->Ep0Dtd;
+
+	if (Length > Requested) {
+		Length = Requested;
+	}
+
+	UsbCdc_FillDtd(&DtdPtr[0], CdcPtr->MemPtr->Ep0Buffer, Length);
+	if ((Length != 0U) && (Length < Requested) &&
+	    ((Length % USB_CDC_EP0_PACKET) == 0U)) {
+		UsbCdc_FillDtd(&DtdPtr[1], CdcPtr->MemPtr->Ep0Buffer, 0U);
+		DtdPtr[0].Next = (u32)(UINTPTR)&DtdPtr[1];
+		DtdPtr[0].Token &= ~USB_CDC_DTD_IOC;
+	}
+
+	UsbCdc_Prime(CdcPtr, USB_CDC_QH_EP0_IN, &DtdPtr[0], USB_CDC_IN_BIT(0U));
+}
+
+/****************************************************************************/
+/*
+*
+* Starts an OUT stage of EP0 into the EP0 buffer.
+*
+* @param	CdcPtr is a pointer to the port.
+* @param	Length is the length of the data, 0 for a status stage.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void UsbCdc_Ep0Recv(UsbCdc *CdcPtr, u32 Length)
+{
+	UsbCdc_Dtd *DtdPtr = &CdcPtr->MemPtr->Ep0Dtd[2];
+
+	UsbCdc_FillDtd(DtdPtr, CdcPtr->MemPtr->Ep0Buffer, Length);
+	UsbCdc_Prime(CdcPtr, USB_CDC_QH_EP0_OUT, DtdPtr, USB_CDC_OUT_BIT(0U));
+}
+
+/****************************************************************************/
+/*
+*
+* Moves EP0 on to the status stage once the data stage completed.
+*
+* @param	CdcPtr is a pointer to the port.
+* @param	Complete is the value of ENDPTCOMPLETE.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void UsbCdc_Ep0Complete(UsbCdc *CdcPtr, u32 Complete)
+{
+	u32 Rate;
+
+	switch (CdcPtr->Ep0State) {
+	case USB_CDC_EP0_DATA_IN:
+		if ((Complete & USB_CDC_IN_BIT(0U)) != 0U) {
+			CdcPtr->Ep0State = USB_CDC_EP0_STATUS;
+			UsbCdc_Ep0Recv(CdcPtr, 0U);
+		}
+		break;
+	case USB_CDC_EP0_DATA_OUT:
+		if ((Complete & USB_CDC_OUT_BIT(0U)) == 0U) {
+			break;
+		}
+		if (CdcPtr->Request == USB_CDC_SET_LINE_CODING) {
+			(void)memcpy(CdcPtr->LineCoding,
+				     CdcPtr->MemPtr->Ep0Buffer,
+				     USB_CDC_LINE_CODING_SIZE);
+			Rate = UsbCdc_GetRate(CdcPtr);
+			UsbCdc_Event(CdcPtr, USB_CDC_EVENT_LINE_CODING, NULL,
+				     Rate);
+		}
+		CdcPtr->Ep0State = USB_CDC_EP0_STATUS;
+		UsbCdc_Ep0Send(CdcPtr, 0U, 0U);
+		break;
+	case USB_CDC_EP0_STATUS:
+		CdcPtr->Ep0State = USB_CDC_EP0_IDLE;
+		break;
+	default:
+		break;
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Calls the event handler, if any.
+*
+* @param	CdcPtr is a pointer to the port.
+* @param	Event is the USB_CDC_EVENT_*.
+* @param	BufferPtr is the buffer of a transfer, or NULL.
+* @param	Length is the length, rate or line state of the event.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void UsbCdc_Event(UsbCdc *CdcPtr, u32 Event, u8 *BufferPtr,
+			 u32 Length)
+{
+	if (CdcPtr->Handler != NULL) {
+		CdcPtr->Handler(CdcPtr->CallBackRef, Event, BufferPtr, Length);
+	}
+}
+
+#endif /* XPAR_XUSBPS_0_BASEADDR */
@@ -0,0 +1,209 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file usb_cdc.h
+*
+* USB CDC-ACM serial port on the device mode of the Zynq USB controller, a
+* ChipIdea core, without the usbps driver.
+*
+* The controller moves the data itself: each endpoint has a queue head, the
+* dQH, and runs a linked list of transfer descriptors, the dTDs, each of up
+* to USB_CDC_MAX_XFER bytes of one buffer. UsbCdc_Recv() and UsbCdc_Send()
+* queue a buffer as one dTD chained behind the ones in flight, up to
+* USB_CDC_XFERS per direction, so that the controller goes from one buffer
+* to the next without waiting for the CPU and the host is never held off
+* while a completion is handled. The buffers are used by the controller as
+* they are, no byte is copied, and are handed back through the event
+* handler. A queued receive is refused by NAK until a buffer is queued,
+* which is the flow control towards the host.
+*
+* EP0 answers the standard requests and the ACM requests SET_LINE_CODING,
+* GET_LINE_CODING, SET_CONTROL_LINE_STATE and SEND_BREAK. EP1 IN is the
+* notification endpoint of the communication interface, EP2 the bulk pair
+* of the data interface. High speed uses 512 byte bulk packets, full speed
+* 64 byte ones.
+*
+* The dQHs, the dTDs and the EP0 buffer are taken from the DMA arena of
+* xil_dmaarena.h, so that the CPU and the controller never write the same
+* cache line: a dTD is linked to the next one while the controller may be
+* retiring it. The arena must be mapped before UsbCdc_Initialize(). The
+* transfer buffers need no cache maintenance when they are in the arena
+* too; otherwise they are cleaned before the controller reads them and
+* invalidated before the CPU reads what it wrote, so they must be aligned
+* to a cache line and a receive buffer must be a multiple of one.
+*
+* A bus reset cancels the transfers in the controller but not in the
+* queues: they are started again from their beginning once the host sets
+* the configuration, so a send may be repeated in part after a reset.
+*
+* USB0, its ULPI PHY on the MIO and the reset of the PHY must be set up by
+* the hardware design and the FSBL, and the connector must be a device or
+* OTG one. Without USB0 in the design the file compiles to nothing.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef USB_CDC_H
+#define USB_CDC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xil_dmaarena.h"
+
+/************************** Constant Definitions ****************************/
+
+#ifndef USB_CDC_VENDOR_ID
+#define USB_CDC_VENDOR_ID	0x03FDU	/**< idVendor, Xilinx */
+#endif
+#ifndef USB_CDC_PRODUCT_ID
+#define USB_CDC_PRODUCT_ID	0x0103U	/**< idProduct */
+#endif
+
+#define USB_CDC_XFERS		4U	/**< Transfers in flight per direction */
+#define USB_CDC_MAX_XFER	0x4000U	/**< Bytes of one transfer */
+#define USB_CDC_HS_PACKET	512U	/**< Bulk packet at high speed */
+#define USB_CDC_FS_PACKET	64U	/**< Bulk packet at full speed */
+#define USB_CDC_EP0_BUFFER	128U	/**< Longest EP0 data stage */
+
+/** @name Events of the handler
+ * @{
+ */
+#define USB_CDC_EVENT_RECV	1U	/**< A receive completed, Length bytes */
+#define USB_CDC_EVENT_SENT	2U	/**< A send completed */
+#define USB_CDC_EVENT_CONFIGURED 3U	/**< The host set the configuration */
+#define USB_CDC_EVENT_RESET	4U	/**< Bus reset, not configured */
+#define USB_CDC_EVENT_LINE_CODING 5U	/**< Line coding set, Length is the rate */
+#define USB_CDC_EVENT_LINE_STATE 6U	/**< DTR and RTS in Length */
+/* @} */
+
+#define USB_CDC_LINE_DTR	0x1U	/**< Control line state DTR */
+#define USB_CDC_LINE_RTS	0x2U	/**< Control line state RTS */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * Event handler, called from the interrupt handler of the controller.
+ * BufferPtr is the buffer of a completed transfer, NULL for the other
+ * events.
+ */
+typedef void (*UsbCdc_Handler)(void *CallBackRef, u32 Event, u8 *BufferPtr,
+			       u32 Length);
+
+/**
+ * Endpoint queue head, as the controller reads and writes it.
+ */
+typedef struct {
+	volatile u32 Caps;	/**< Packet size, IOS, ZLT */
+	volatile u32 Current;	/**< dTD being executed */
+	volatile u32 Next;	/**< Overlay: next dTD */
+	volatile u32 Token;	/**< Overlay: status and bytes left */
+	volatile u32 Buffer[5];	/**< Overlay: buffer pages */
+	u32 Reserved;
+	volatile u32 Setup[2];	/**< Last setup packet, EP0 OUT */
+	u32 Pad[4];
+} UsbCdc_Dqh;
+
+/**
+ * Transfer descriptor, one cache line.
+ */
+typedef struct {
+	volatile u32 Next;	/**< Next dTD, or the terminate bit */
+	volatile u32 Token;	/**< Status, IOC and bytes left */
+	volatile u32 Buffer[5];	/**< Buffer pages */
+	u32 Reserved;
+} __attribute__ ((aligned (32))) UsbCdc_Dtd;
+
+/**
+ * What the controller reads and writes, in the DMA arena.
+ */
+typedef struct {
+	UsbCdc_Dqh Dqh[6];	/**< EP0 to EP2, OUT then IN, on 2 KB */
+	UsbCdc_Dtd Ep0Dtd[3];	/**< IN data, IN zero length, OUT */
+	UsbCdc_Dtd RxDtd[USB_CDC_XFERS];
+	UsbCdc_Dtd TxDtd[USB_CDC_XFERS];
+	u8 Ep0Buffer[USB_CDC_EP0_BUFFER];
+} UsbCdc_Mem;
+
+/**
+ * Transfers of one bulk endpoint direction.
+ */
+typedef struct {
+	UsbCdc_Dtd *DtdPtr;	/**< USB_CDC_XFERS dTDs */
+	u8 *BufferPtr[USB_CDC_XFERS];
+	u32 Length[USB_CDC_XFERS];
+	u32 Head;		/**< Next transfer to queue */
+	u32 Tail;		/**< Oldest transfer not completed */
+	u32 Qh;			/**< Index of the dQH */
+	u32 Bit;		/**< Bit of the endpoint in ENDPTPRIME */
+	u32 Event;		/**< Event of a completion */
+} UsbCdc_Queue;
+
+/**
+ * Counts of the port.
+ */
+typedef struct {
+	u64 RecvBytes;
+	u64 SentBytes;
+	u32 Resets;
+	u32 Setups;
+	u32 Stalls;		/**< Requests answered with a stall */
+	u32 Errors;		/**< Transfers completed with an error */
+} UsbCdc_Stats;
+
+/**
+ * The CDC-ACM port.
+ */
+typedef struct {
+	Xil_DmaPool Pool;	/**< Holds the block of MemPtr */
+	UsbCdc_Mem *MemPtr;
+	UsbCdc_Queue Rx;	/**< EP2 OUT */
+	UsbCdc_Queue Tx;	/**< EP2 IN */
+	UINTPTR BaseAddress;
+	UsbCdc_Handler Handler;
+	void *CallBackRef;
+	u32 Ep0State;
+	u8 Request;		/**< Request of the EP0 data stage */
+	u8 LineCoding[7];	/**< dwDTERate, bCharFormat, bParityType, bDataBits */
+	u32 LineState;		/**< USB_CDC_LINE_* */
+	u32 PacketSize;		/**< Bulk packet size at the current speed */
+	u32 Configured;
+	UsbCdc_Stats Stats;
+} UsbCdc;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+s32 UsbCdc_Initialize(UsbCdc *CdcPtr, UINTPTR BaseAddress, u32 IntrId,
+		      UINTPTR IntrParent);
+void UsbCdc_SetHandler(UsbCdc *CdcPtr, UsbCdc_Handler Handler,
+		       void *CallBackRef);
+void UsbCdc_Start(UsbCdc *CdcPtr);
+void UsbCdc_Stop(UsbCdc *CdcPtr);
+s32 UsbCdc_Recv(UsbCdc *CdcPtr, u8 *BufferPtr, u32 Length);
+s32 UsbCdc_Send(UsbCdc *CdcPtr, u8 *BufferPtr, u32 Length);
+u32 UsbCdc_GetRate(const UsbCdc *CdcPtr);
+void UsbCdc_GetStats(const UsbCdc *CdcPtr, UsbCdc_Stats *StatsPtr);
+void UsbCdc_InterruptHandler(void *InstancePtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_CDC_H */
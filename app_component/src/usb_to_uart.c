@@ -0,0 +1,990 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file usb_to_uart.c
+*
+* Zero-copy bridge engine between the host-facing port and the PS UARTs.
+* Refer to usb_to_uart.h for a description of the design.
+*
+* All descriptor hand-over happens in the UART and USB interrupt handlers,
+* which share one priority and are not nested by the GIC, so the
+* per-direction state needs no further locking.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Added the optional RX timestamps and latency
+*			counters.
+*       qm     10/14/26 Added Bridge_SetLatencyHandler().
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xparameters.h"
+#include "xstatus.h"
+#include "xil_exception.h"
+#include "xiltimer.h"
+#include "xinterrupt_wrap.h"
+#include "usb_to_uart.h"
+
+/************************** Constant Definitions ****************************/
+
+/* RX interrupts serviced while a direction is receiving */
+#define BRIDGE_RX_IXR	(XUARTPS_IXR_RXOVR | XUARTPS_IXR_RXFULL | \
+			 XUARTPS_IXR_TOUT | XUARTPS_IXR_OVER | \
+			 XUARTPS_IXR_FRAMING | XUARTPS_IXR_PARITY)
+
+/* RX data interrupts masked while a direction is stalled */
+#define BRIDGE_RX_DATA_IXR	(XUARTPS_IXR_RXOVR | XUARTPS_IXR_RXFULL | \
+				 XUARTPS_IXR_TOUT)
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static s32 Bridge_PortInit(Bridge_Port *PortPtr, XUartPs_Config *CfgPtr,
+			   u32 BaudRate);
+static void Bridge_PortHandler(void *CallBackRef, u32 Event, u32 EventData);
+static void Bridge_SetFillLength(Bridge *BridgePtr, u32 BaudRate);
+static void Bridge_RxTimeout(Bridge *BridgePtr, Bridge_Dir *DirPtr,
+			     u32 Count);
+static void Bridge_DeadlineHandler(void *CallBackRef);
+static void Bridge_GapHandler(void *CallBackRef);
+static void Bridge_RxDone(Bridge *BridgePtr, Bridge_Dir *DirPtr, u32 Count);
+static void Bridge_TxDone(Bridge *BridgePtr, Bridge_Dir *DirPtr);
+static void Bridge_Kick(Bridge *BridgePtr, Bridge_Dir *DirPtr);
+static void Bridge_Latency(Bridge_Dir *DirPtr, u64 Stamp);
+#ifdef BRIDGE_USB_CDC
+static void Bridge_UsbHandler(void *CallBackRef, u32 Event, u8 *BufferPtr,
+			      u32 Length);
+static void Bridge_UsbRxDone(Bridge *BridgePtr, Bridge_Dir *DirPtr,
+			     u32 Count);
+#endif
+
+/************************** Variable Definitions ****************************/
+
+extern XUartPs_Config XUartPs_ConfigTable[];
+
+/*
+ * Descriptor storage. Every descriptor starts on its own cache line so it
+ * can be handed to a DMA engine without maintenance affecting a neighbour.
+ */
+static u8 BridgeStorage[BRIDGE_NUM_DIRS][BRIDGE_BD_PER_DIR][BRIDGE_BD_SIZE]
+	__attribute__ ((aligned (BRIDGE_CACHE_LINE)));
+
+/****************************************************************************/
+/**
+*
+* Initializes the bridge. Port 0 is bound to the first UART of the config
+* table, which is the host-facing USB-UART port on this board, and port 1 to
+* the second one if present. With a single UART the bridge echoes back what
+* the host sends. With BRIDGE_USB_CDC port 0 is the USB CDC-ACM device and
+* port 1 the first UART.
+*
+* @param	BridgePtr is a pointer to the bridge.
+* @param	BaudRate is the line rate for all ports.
+* @param	WheelPtr is the timer wheel of the coalescing deadlines, or
+*		NULL for none.
+*
+* @return	XST_SUCCESS if all ports were initialized, otherwise the
+*		error of the failing driver call.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 Bridge_Initialize(Bridge *BridgePtr, u32 BaudRate, TimerWheel *WheelPtr)
+{
+	u32 Index;
+	u32 Bd;
+	s32 Status;
+#ifdef BRIDGE_USB_CDC
+	BridgePtr->Port[1].BridgePtr = BridgePtr;
+	Status = Bridge_PortInit(&BridgePtr->Port[1], &XUartPs_ConfigTable[0],
+				 BaudRate);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	Status = UsbCdc_Initialize(&BridgePtr->Usb, XPAR_XUSBPS_0_BASEADDR,
+				   XPAR_XUSBPS_0_INTERRUPTS,
+				   XPAR_XUSBPS_0_INTERRUPT_PARENT);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+	UsbCdc_SetHandler(&BridgePtr->Usb, Bridge_UsbHandler, BridgePtr);
+
+	BridgePtr->NumDirs = BRIDGE_NUM_DIRS;
+	BridgePtr->Dir[BRIDGE_DIR_HOST_TO_UART].RxPortPtr = NULL;
+	BridgePtr->Dir[BRIDGE_DIR_HOST_TO_UART].TxPortPtr =
+		&BridgePtr->Port[1].Uart;
+	BridgePtr->Dir[BRIDGE_DIR_UART_TO_HOST].RxPortPtr =
+		&BridgePtr->Port[1].Uart;
+	BridgePtr->Dir[BRIDGE_DIR_UART_TO_HOST].TxPortPtr = NULL;
+	BridgePtr->Port[1].RxDir = BRIDGE_DIR_UART_TO_HOST;
+	BridgePtr->Port[1].TxDir = BRIDGE_DIR_HOST_TO_UART;
+#else
+	u32 NumPorts = XPAR_XUARTPS_NUM_INSTANCES;
+
+	if (NumPorts > BRIDGE_NUM_PORTS) {
+		NumPorts = BRIDGE_NUM_PORTS;
+	}
+
+	for (Index = 0U; Index < NumPorts; Index++) {
+		BridgePtr->Port[Index].BridgePtr = BridgePtr;
+		Status = Bridge_PortInit(&BridgePtr->Port[Index],
+					 &XUartPs_ConfigTable[Index], BaudRate);
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+	}
+
+	if (NumPorts == 1U) {
+		BridgePtr->NumDirs = 1U;
+		BridgePtr->Dir[0].RxPortPtr = &BridgePtr->Port[0].Uart;
+		BridgePtr->Dir[0].TxPortPtr = &BridgePtr->Port[0].Uart;
+		BridgePtr->Port[0].RxDir = 0U;
+		BridgePtr->Port[0].TxDir = 0U;
+	} else {
+		BridgePtr->NumDirs = BRIDGE_NUM_DIRS;
+		BridgePtr->Dir[BRIDGE_DIR_HOST_TO_UART].RxPortPtr =
+			&BridgePtr->Port[0].Uart;
+		BridgePtr->Dir[BRIDGE_DIR_HOST_TO_UART].TxPortPtr =
+			&BridgePtr->Port[1].Uart;
+		BridgePtr->Dir[BRIDGE_DIR_UART_TO_HOST].RxPortPtr =
+			&BridgePtr->Port[1].Uart;
+		BridgePtr->Dir[BRIDGE_DIR_UART_TO_HOST].TxPortPtr =
+			&BridgePtr->Port[0].Uart;
+		BridgePtr->Port[0].RxDir = BRIDGE_DIR_HOST_TO_UART;
+		BridgePtr->Port[0].TxDir = BRIDGE_DIR_UART_TO_HOST;
+		BridgePtr->Port[1].RxDir = BRIDGE_DIR_UART_TO_HOST;
+		BridgePtr->Port[1].TxDir = BRIDGE_DIR_HOST_TO_UART;
+	}
+#endif
+
+	for (Index = 0U; Index < BridgePtr->NumDirs; Index++) {
+		for (Bd = 0U; Bd < BRIDGE_BD_PER_DIR; Bd++) {
+			BridgePtr->Dir[Index].Bd[Bd].DataPtr =
+				BridgeStorage[Index][Bd];
+		}
+		BridgePtr->Dir[Index].BridgePtr = BridgePtr;
+		BridgePtr->Dir[Index].DeadlineUs = 0U;
+		TimerWheel_InitTimer(&BridgePtr->Dir[Index].Deadline,
+				     Bridge_DeadlineHandler,
+				     &BridgePtr->Dir[Index]);
+		BridgePtr->Dir[Index].GapBits = 0U;
+		TimerWheel_InitTimer(&BridgePtr->Dir[Index].Gap,
+				     Bridge_GapHandler, &BridgePtr->Dir[Index]);
+	}
+
+	BridgePtr->WheelPtr = WheelPtr;
+	BridgePtr->LatencyFn = NULL;
+	BridgePtr->LatencyRef = NULL;
+	Bridge_SetFillLength(BridgePtr, BaudRate);
+	BridgePtr->IsStarted = 0U;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Starts forwarding. Every direction begins receiving into its first
+* descriptor, the USB one into all of them, and the USB device is attached.
+*
+* @param	BridgePtr is a pointer to an initialized bridge.
+*
+* @return	XST_SUCCESS.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 Bridge_Start(Bridge *BridgePtr)
+{
+	Bridge_Dir *DirPtr;
+	u32 Index;
+	u32 Bd;
+
+	for (Index = 0U; Index < BridgePtr->NumDirs; Index++) {
+		DirPtr = &BridgePtr->Dir[Index];
+
+		for (Bd = 0U; Bd < BRIDGE_BD_PER_DIR; Bd++) {
+			DirPtr->Bd[Bd].State = BRIDGE_BD_FREE;
+			DirPtr->Bd[Bd].Length = 0U;
+			DirPtr->Bd[Bd].Stamp = 0U;
+		}
+		DirPtr->FillIndex = 0U;
+		DirPtr->DrainIndex = 0U;
+		DirPtr->RxStalled = 0U;
+		DirPtr->TxBusy = 0U;
+
+#ifdef BRIDGE_USB_CDC
+		if (DirPtr->RxPortPtr == NULL) {
+			for (Bd = 0U; Bd < BRIDGE_BD_PER_DIR; Bd++) {
+				DirPtr->Bd[Bd].State = BRIDGE_BD_FILLING;
+				(void)UsbCdc_Recv(&BridgePtr->Usb,
+						  DirPtr->Bd[Bd].DataPtr,
+						  BRIDGE_BD_SIZE);
+			}
+			continue;
+		}
+#endif
+		DirPtr->Bd[0].State = BRIDGE_BD_FILLING;
+		XUartPs_SetInterruptMask(DirPtr->RxPortPtr, BRIDGE_RX_IXR);
+		(void)XUartPs_Recv(DirPtr->RxPortPtr, DirPtr->Bd[0].DataPtr,
+				   DirPtr->FillLength);
+	}
+
+#ifdef BRIDGE_USB_CDC
+	UsbCdc_Start(&BridgePtr->Usb);
+#endif
+	BridgePtr->IsStarted = 1U;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Stops forwarding and disables the interrupts of all ports, detaching the
+* USB device. Data held in the descriptors is dropped.
+*
+* @param	BridgePtr is a pointer to the bridge.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void Bridge_Stop(Bridge *BridgePtr)
+{
+	u32 Index;
+
+	for (Index = 0U; Index < BridgePtr->NumDirs; Index++) {
+		if (BridgePtr->WheelPtr != NULL) {
+			TimerWheel_Cancel(BridgePtr->WheelPtr,
+					  &BridgePtr->Dir[Index].Deadline);
+			TimerWheel_Cancel(BridgePtr->WheelPtr,
+					  &BridgePtr->Dir[Index].Gap);
+		}
+		if (BridgePtr->Dir[Index].RxPortPtr != NULL) {
+			XUartPs_SetInterruptMask(BridgePtr->Dir[Index].RxPortPtr,
+						 0U);
+		}
+		if (BridgePtr->Dir[Index].TxPortPtr != NULL) {
+			XUartPs_SetInterruptMask(BridgePtr->Dir[Index].TxPortPtr,
+						 0U);
+		}
+	}
+#ifdef BRIDGE_USB_CDC
+	UsbCdc_Stop(&BridgePtr->Usb);
+#endif
+
+	BridgePtr->IsStarted = 0U;
+}
+
+/****************************************************************************/
+/**
+*
+* Sets the coalescing of a direction received from a UART. A descriptor is
+* handed over once it holds MaxBytes, or MaxUs after the receiver first
+* went idle on it, whichever comes first. With MaxUs 0 it is handed over on
+* the first RX timeout, as without coalescing. This may be called at any
+* time; a new threshold applies from the next descriptor.
+*
+* @param	BridgePtr is a pointer to the bridge.
+* @param	Dir is BRIDGE_DIR_HOST_TO_UART or BRIDGE_DIR_UART_TO_HOST.
+* @param	MaxBytes is the size threshold, 1 to BRIDGE_BD_SIZE.
+* @param	MaxUs is the deadline in microseconds, or 0.
+*
+* @return
+*		- XST_SUCCESS if the limits are set.
+*		- XST_INVALID_PARAM for a bad direction or threshold.
+*		- XST_NO_FEATURE for a direction received from USB, or a
+*		  deadline without a timer wheel.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 Bridge_SetCoalesce(Bridge *BridgePtr, u32 Dir, u32 MaxBytes, u32 MaxUs)
+{
+	Bridge_Dir *DirPtr;
+
+	if ((Dir >= BridgePtr->NumDirs) || (MaxBytes == 0U) ||
+	    (MaxBytes > BRIDGE_BD_SIZE)) {
+		return XST_INVALID_PARAM;
+	}
+
+	DirPtr = &BridgePtr->Dir[Dir];
+	if ((DirPtr->RxPortPtr == NULL) ||
+	    ((MaxUs != 0U) && (BridgePtr->WheelPtr == NULL))) {
+		return XST_NO_FEATURE;
+	}
+
+	/* The limits are read by the UART and timer interrupt handlers */
+	Xil_ExceptionDisable();
+	DirPtr->FillLength = MaxBytes;
+	DirPtr->DeadlineUs = MaxUs;
+	if ((MaxUs == 0U) && (BridgePtr->WheelPtr != NULL) &&
+	    (TimerWheel_IsPending(&DirPtr->Deadline) != 0U)) {
+		/* Nothing would hand the waiting bytes over any more */
+		TimerWheel_Cancel(BridgePtr->WheelPtr, &DirPtr->Deadline);
+		Bridge_DeadlineHandler(DirPtr);
+	}
+	Xil_ExceptionEnable();
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Sets the pacing of a direction sent on a UART. With GapBits nonzero each
+* descriptor is sent as a frame, and the next one is written into the TX
+* FIFO only once the line has been idle for GapBits bit times at the baud
+* rate of the port, e.g. 39 for the 3.5 characters of 11 bits of Modbus
+* RTU. The descriptors are handed over on the RX timeout as before, so a
+* frame of the receiving side is one descriptor as long as it fits. With
+* GapBits 0 the descriptors are sent back to back. This may be called at
+* any time; a gap running ends at once when pacing is turned off.
+*
+* @param	BridgePtr is a pointer to the bridge.
+* @param	Dir is BRIDGE_DIR_HOST_TO_UART or BRIDGE_DIR_UART_TO_HOST.
+* @param	GapBits is the gap in bit times, or 0.
+*
+* @return
+*		- XST_SUCCESS if the gap is set.
+*		- XST_INVALID_PARAM for a bad direction.
+*		- XST_NO_FEATURE for a direction sent on USB, or without a
+*		  timer wheel.
+*
+* @note		None.
+*
+*****************************************************************************/
+s32 Bridge_SetTxGap(Bridge *BridgePtr, u32 Dir, u32 GapBits)
+{
+	Bridge_Dir *DirPtr;
+
+	if (Dir >= BridgePtr->NumDirs) {
+		return XST_INVALID_PARAM;
+	}
+
+	DirPtr = &BridgePtr->Dir[Dir];
+	if ((DirPtr->TxPortPtr == NULL) || (BridgePtr->WheelPtr == NULL)) {
+		return XST_NO_FEATURE;
+	}
+
+	/* The gap is read by the UART and timer interrupt handlers */
+	Xil_ExceptionDisable();
+	DirPtr->GapBits = GapBits;
+	if ((GapBits == 0U) &&
+	    (TimerWheel_IsPending(&DirPtr->Gap) != 0U)) {
+		/* Nothing would release the next frame any more */
+		TimerWheel_Cancel(BridgePtr->WheelPtr, &DirPtr->Gap);
+		DirPtr->TxBusy = 0U;
+		Bridge_Kick(BridgePtr, DirPtr);
+	}
+	Xil_ExceptionEnable();
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Takes a consistent snapshot of the counters of one direction.
+*
+* @param	BridgePtr is a pointer to the bridge.
+* @param	Dir is BRIDGE_DIR_HOST_TO_UART or BRIDGE_DIR_UART_TO_HOST.
+* @param	StatsPtr receives the counters.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void Bridge_GetStats(Bridge *BridgePtr, u32 Dir, Bridge_Stats *StatsPtr)
+{
+	if (Dir >= BridgePtr->NumDirs) {
+		StatsPtr->Bytes = 0U;
+		StatsPtr->Buffers = 0U;
+		StatsPtr->PartialBuffers = 0U;
+		StatsPtr->RxStalls = 0U;
+		StatsPtr->RxErrors = 0U;
+		StatsPtr->DeadlineBuffers = 0U;
+		StatsPtr->StampedBuffers = 0U;
+		StatsPtr->LatencySumUs = 0U;
+		StatsPtr->LatencyMaxUs = 0U;
+		StatsPtr->PacedFrames = 0U;
+		StatsPtr->GapLateMaxUs = 0U;
+		return;
+	}
+
+	/* The counters are updated from the UART interrupt handlers */
+	Xil_ExceptionDisable();
+	*StatsPtr = BridgePtr->Dir[Dir].Stats;
+	Xil_ExceptionEnable();
+}
+
+/****************************************************************************/
+/**
+*
+* Sets the handler taking the latency of every stamped descriptor, as it is
+* added to the latency counters of its direction. It is called from the
+* interrupt handler of the sending port, so it must be short.
+*
+* @param	BridgePtr is a pointer to the bridge.
+* @param	FuncPtr is the handler, NULL for none.
+* @param	CallBackRef is passed to the handler.
+*
+* @return	None.
+*
+* @note		Latencies are only measured with BRIDGE_RX_STAMP.
+*
+*****************************************************************************/
+void Bridge_SetLatencyHandler(Bridge *BridgePtr, Bridge_LatencyFn FuncPtr,
+			      void *CallBackRef)
+{
+	Xil_ExceptionDisable();
+	BridgePtr->LatencyFn = FuncPtr;
+	BridgePtr->LatencyRef = CallBackRef;
+	Xil_ExceptionEnable();
+}
+
+/****************************************************************************/
+/*
+*
+* Initializes one port and connects its interrupt.
+*
+* @param	PortPtr is a pointer to the port.
+* @param	CfgPtr is the UART configuration.
+* @param	BaudRate is the line rate.
+*
+* @return	XST_SUCCESS or the error of the failing driver call.
+*
+* @note		None.
+*
+*****************************************************************************/
+static s32 Bridge_PortInit(Bridge_Port *PortPtr, XUartPs_Config *CfgPtr,
+			   u32 BaudRate)
+{
+	XUartPs *UartPtr = &PortPtr->Uart;
+	s32 Status;
+
+	Status = XUartPs_CfgInitialize(UartPtr, CfgPtr, CfgPtr->BaseAddress);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	Status = XUartPs_SetBaudRate(UartPtr, BaudRate);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	XUartPs_SetHandler(UartPtr, Bridge_PortHandler, PortPtr);
+#ifdef BRIDGE_RX_STAMP
+	XUartPs_EnableRxStamp(UartPtr);
+#endif
+
+	return XSetupInterruptSystem(UartPtr, &XUartPs_InterruptHandler,
+				     CfgPtr->IntrId, CfgPtr->IntrParent,
+				     XINTERRUPT_DEFAULT_PRIORITY);
+}
+
+/****************************************************************************/
+/*
+*
+* Event handler of a port, called by XUartPs_InterruptHandler().
+*
+* @param	CallBackRef is the Bridge_Port the event belongs to.
+* @param	Event is the XUARTPS_EVENT_* that occurred.
+* @param	EventData is the number of bytes for data events.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void Bridge_PortHandler(void *CallBackRef, u32 Event, u32 EventData)
+{
+	Bridge_Port *PortPtr = (Bridge_Port *)CallBackRef;
+	Bridge *BridgePtr = PortPtr->BridgePtr;
+
+	switch (Event) {
+	case XUARTPS_EVENT_RECV_DATA:
+		Bridge_RxDone(BridgePtr, &BridgePtr->Dir[PortPtr->RxDir],
+			      EventData);
+		break;
+	case XUARTPS_EVENT_RECV_TOUT:
+		Bridge_RxTimeout(BridgePtr, &BridgePtr->Dir[PortPtr->RxDir],
+				 EventData);
+		break;
+	case XUARTPS_EVENT_SENT_DATA:
+		Bridge_TxDone(BridgePtr, &BridgePtr->Dir[PortPtr->TxDir]);
+		break;
+	case XUARTPS_EVENT_RECV_ERROR:
+	case XUARTPS_EVENT_PARE_FRAME_BRKE:
+	case XUARTPS_EVENT_RECV_ORERR:
+		BridgePtr->Dir[PortPtr->RxDir].Stats.RxErrors++;
+		break;
+	default:
+		break;
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Sets the bytes received per descriptor by a UART: a full descriptor is
+* handed over after FillLength character times, keep that below the
+* latency target (10 bits per character). A direction with a coalescing
+* deadline keeps the threshold it was given.
+*
+* @param	BridgePtr is a pointer to the bridge.
+* @param	BaudRate is the line rate of the UARTs.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void Bridge_SetFillLength(Bridge *BridgePtr, u32 BaudRate)
+{
+	u32 FillLength;
+	u32 Index;
+
+	FillLength = (u32)(((u64)BaudRate * BRIDGE_LATENCY_US) /
+			   (10U * 1000000U));
+	if (FillLength == 0U) {
+		FillLength = 1U;
+	} else if (FillLength > BRIDGE_BD_SIZE) {
+		FillLength = BRIDGE_BD_SIZE;
+	} else {
+		/* Else with dummy entry for MISRA-C Compliance.*/
+		;
+	}
+	for (Index = 0U; Index < BRIDGE_NUM_DIRS; Index++) {
+		if (BridgePtr->Dir[Index].DeadlineUs == 0U) {
+			BridgePtr->Dir[Index].FillLength = FillLength;
+		}
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Handles an RX timeout of a direction. Without a deadline the partial
+* descriptor is handed over; with one it keeps receiving, and the deadline
+* is started if it is not running yet.
+*
+* @param	BridgePtr is a pointer to the bridge.
+* @param	DirPtr is the direction the data was received for.
+* @param	Count is the number of bytes in the descriptor.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void Bridge_RxTimeout(Bridge *BridgePtr, Bridge_Dir *DirPtr,
+			     u32 Count)
+{
+	if (DirPtr->DeadlineUs == 0U) {
+		Bridge_RxDone(BridgePtr, DirPtr, Count);
+	} else if ((Count != 0U) &&
+		   (TimerWheel_IsPending(&DirPtr->Deadline) == 0U)) {
+		TimerWheel_Start(BridgePtr->WheelPtr, &DirPtr->Deadline,
+				 DirPtr->DeadlineUs);
+	} else {
+		/* Else with dummy entry for MISRA-C Compliance.*/
+		;
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Hands the partial descriptor of a direction over at its deadline, called
+* from the timer interrupt. Bytes still in the RX FIFO go to the next
+* descriptor.
+*
+* @param	CallBackRef is the Bridge_Dir.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void Bridge_DeadlineHandler(void *CallBackRef)
+{
+	Bridge_Dir *DirPtr = (Bridge_Dir *)CallBackRef;
+	XUartPs *UartPtr = DirPtr->RxPortPtr;
+	u32 Count;
+
+	Count = UartPtr->ReceiveBuffer.RequestedBytes -
+		UartPtr->ReceiveBuffer.RemainingBytes;
+	if ((Count != 0U) &&
+	    (DirPtr->Bd[DirPtr->FillIndex].State == BRIDGE_BD_FILLING)) {
+		DirPtr->Stats.DeadlineBuffers++;
+		Bridge_RxDone(DirPtr->BridgePtr, DirPtr, Count);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Ends the gap after a frame of a paced direction, called from the timer
+* interrupt, and sends the next full descriptor if there is one. Otherwise
+* the next descriptor handed over is sent at once, the line having been
+* idle long enough.
+*
+* @param	CallBackRef is the Bridge_Dir.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void Bridge_GapHandler(void *CallBackRef)
+{
+	Bridge_Dir *DirPtr = (Bridge_Dir *)CallBackRef;
+	XTime Now;
+	u32 LateUs;
+
+	XTime_GetTime(&Now);
+	if (Now > DirPtr->GapDue) {
+		LateUs = (u32)((Now - DirPtr->GapDue) /
+			       (COUNTS_PER_SECOND / 1000000U));
+		if (LateUs > DirPtr->Stats.GapLateMaxUs) {
+			DirPtr->Stats.GapLateMaxUs = LateUs;
+		}
+	}
+
+	DirPtr->TxBusy = 0U;
+	if (DirPtr->Bd[DirPtr->DrainIndex].State == BRIDGE_BD_FULL) {
+		DirPtr->Stats.PacedFrames++;
+	}
+	Bridge_Kick(DirPtr->BridgePtr, DirPtr);
+}
+
+/****************************************************************************/
+/*
+*
+* Hands the descriptor being filled over to the sending port and continues
+* receiving into the other descriptor of the pair.
+*
+* @param	BridgePtr is a pointer to the bridge.
+* @param	DirPtr is the direction the data was received for.
+* @param	Count is the number of bytes in the descriptor.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void Bridge_RxDone(Bridge *BridgePtr, Bridge_Dir *DirPtr, u32 Count)
+{
+	Bridge_Bd *BdPtr = &DirPtr->Bd[DirPtr->FillIndex];
+	Bridge_Bd *NextPtr;
+	u32 Next;
+
+	if ((Count == 0U) || (BdPtr->State != BRIDGE_BD_FILLING)) {
+		return;
+	}
+
+	if (BridgePtr->WheelPtr != NULL) {
+		TimerWheel_Cancel(BridgePtr->WheelPtr, &DirPtr->Deadline);
+	}
+
+	BdPtr->Length = Count;
+	BdPtr->Stamp = XUartPs_GetRxStamp(DirPtr->RxPortPtr);
+	BdPtr->State = BRIDGE_BD_FULL;
+
+	DirPtr->Stats.Bytes += Count;
+	DirPtr->Stats.Buffers++;
+	if (Count < DirPtr->FillLength) {
+		DirPtr->Stats.PartialBuffers++;
+	}
+
+	Next = (DirPtr->FillIndex + 1U) % BRIDGE_BD_PER_DIR;
+	NextPtr = &DirPtr->Bd[Next];
+	if (NextPtr->State == BRIDGE_BD_FREE) {
+		DirPtr->FillIndex = Next;
+		NextPtr->State = BRIDGE_BD_FILLING;
+		(void)XUartPs_Recv(DirPtr->RxPortPtr, NextPtr->DataPtr,
+				   DirPtr->FillLength);
+	} else {
+		/*
+		 * Both descriptors are in use, stop receiving so the driver
+		 * does not write into the full descriptor and let the FIFO
+		 * absorb the data until the sender frees one.
+		 */
+		(void)XUartPs_Recv(DirPtr->RxPortPtr, BdPtr->DataPtr, 0U);
+		XUartPs_WriteReg(DirPtr->RxPortPtr->Config.BaseAddress,
+				 XUARTPS_IDR_OFFSET, BRIDGE_RX_DATA_IXR);
+		DirPtr->RxStalled = 1U;
+		DirPtr->Stats.RxStalls++;
+	}
+
+	if (DirPtr->TxBusy == 0U) {
+		Bridge_Kick(BridgePtr, DirPtr);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Frees the descriptor that was just sent, resumes a stalled receiver, or
+* queues the descriptor on the USB endpoint again, and sends the next full
+* descriptor. A paced direction starts its gap instead, from the TX empty
+* interrupt: the last character is still in the shift register then.
+*
+* @param	BridgePtr is a pointer to the bridge.
+* @param	DirPtr is the direction the data was sent for.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void Bridge_TxDone(Bridge *BridgePtr, Bridge_Dir *DirPtr)
+{
+	u32 Freed = DirPtr->DrainIndex;
+	Bridge_Bd *BdPtr = &DirPtr->Bd[Freed];
+
+	if (BdPtr->State != BRIDGE_BD_DRAINING) {
+		return;
+	}
+
+	if (BdPtr->Stamp != 0U) {
+		Bridge_Latency(DirPtr, BdPtr->Stamp);
+		BdPtr->Stamp = 0U;
+	}
+
+	BdPtr->State = BRIDGE_BD_FREE;
+	DirPtr->DrainIndex = (Freed + 1U) % BRIDGE_BD_PER_DIR;
+	DirPtr->TxBusy = 0U;
+
+#ifdef BRIDGE_USB_CDC
+	if (DirPtr->RxPortPtr == NULL) {
+		/* Behind the descriptors still on the endpoint, in ring order */
+		BdPtr->State = BRIDGE_BD_FILLING;
+		(void)UsbCdc_Recv(&BridgePtr->Usb, BdPtr->DataPtr,
+				  BRIDGE_BD_SIZE);
+	}
+#endif
+	if (DirPtr->RxStalled != 0U) {
+		DirPtr->RxStalled = 0U;
+		DirPtr->FillIndex = Freed;
+		BdPtr->State = BRIDGE_BD_FILLING;
+		(void)XUartPs_Recv(DirPtr->RxPortPtr, BdPtr->DataPtr,
+				   DirPtr->FillLength);
+		XUartPs_WriteReg(DirPtr->RxPortPtr->Config.BaseAddress,
+				 XUARTPS_IER_OFFSET, BRIDGE_RX_DATA_IXR);
+	}
+
+	if ((DirPtr->GapBits != 0U) && (DirPtr->TxPortPtr != NULL)) {
+		/* Busy until the gap ends, so that no receive kicks it */
+		XTime_GetTime(&DirPtr->GapDue);
+		DirPtr->GapDue += ((u64)COUNTS_PER_SECOND *
+				   (BRIDGE_CHAR_BITS + DirPtr->GapBits)) /
+				  DirPtr->TxPortPtr->BaudRate;
+		DirPtr->TxBusy = 1U;
+		TimerWheel_StartAt(BridgePtr->WheelPtr, &DirPtr->Gap,
+				   DirPtr->GapDue);
+		return;
+	}
+
+	Bridge_Kick(BridgePtr, DirPtr);
+}
+
+/****************************************************************************/
+/*
+*
+* Starts sending the next descriptor of a direction if it is full. The
+* descriptor memory is passed to the driver as is, no copy is made.
+*
+* @param	BridgePtr is a pointer to the bridge.
+* @param	DirPtr is the direction.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void Bridge_Kick(Bridge *BridgePtr, Bridge_Dir *DirPtr)
+{
+	Bridge_Bd *BdPtr = &DirPtr->Bd[DirPtr->DrainIndex];
+
+	if (BdPtr->State == BRIDGE_BD_FULL) {
+		BdPtr->State = BRIDGE_BD_DRAINING;
+		DirPtr->TxBusy = 1U;
+#ifdef BRIDGE_USB_CDC
+		if (DirPtr->TxPortPtr == NULL) {
+			(void)UsbCdc_Send(&BridgePtr->Usb, BdPtr->DataPtr,
+					  BdPtr->Length);
+			return;
+		}
+		if (BdPtr->Length == 0U) {
+			/* A zero length packet of the host, nothing to send */
+			Bridge_TxDone(BridgePtr, DirPtr);
+			return;
+		}
+#else
+		(void)BridgePtr;
+#endif
+		(void)XUartPs_Send(DirPtr->TxPortPtr, BdPtr->DataPtr,
+				   BdPtr->Length);
+
+		/*
+		 * The driver only arms TX empty when RX interrupts are enabled
+		 * on the sending port, which is not the case while that port
+		 * is stalled, so arm it here to get XUARTPS_EVENT_SENT_DATA.
+		 */
+		XUartPs_WriteReg(DirPtr->TxPortPtr->Config.BaseAddress,
+				 XUARTPS_IER_OFFSET, XUARTPS_IXR_TXEMPTY);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Adds the latency of a descriptor just sent to the counters of its
+* direction and hands it to the latency handler, from the stamp of its
+* first byte to now.
+*
+* @param	DirPtr is the direction the descriptor was sent for.
+* @param	Stamp is the XTime of the first byte of the descriptor.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void Bridge_Latency(Bridge_Dir *DirPtr, u64 Stamp)
+{
+	Bridge *BridgePtr;
+	XTime Now;
+	u32 LatencyUs;
+
+	XTime_GetTime(&Now);
+	if (Now < Stamp) {
+		return;
+	}
+
+	LatencyUs = (u32)((Now - Stamp) / (COUNTS_PER_SECOND / 1000000U));
+	DirPtr->Stats.StampedBuffers++;
+	DirPtr->Stats.LatencySumUs += LatencyUs;
+	if (LatencyUs > DirPtr->Stats.LatencyMaxUs) {
+		DirPtr->Stats.LatencyMaxUs = LatencyUs;
+	}
+
+	BridgePtr = DirPtr->BridgePtr;
+	if (BridgePtr->LatencyFn != NULL) {
+		BridgePtr->LatencyFn(BridgePtr->LatencyRef,
+				     (u32)(DirPtr - BridgePtr->Dir), LatencyUs);
+	}
+}
+
+#ifdef BRIDGE_USB_CDC
+/****************************************************************************/
+/*
+*
+* Event handler of the USB port, called by UsbCdc_InterruptHandler().
+*
+* @param	CallBackRef is the bridge.
+* @param	Event is the USB_CDC_EVENT_* that occurred.
+* @param	BufferPtr is the descriptor memory of a transfer event.
+* @param	Length is the number of bytes received, or the line rate.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void Bridge_UsbHandler(void *CallBackRef, u32 Event, u8 *BufferPtr,
+			      u32 Length)
+{
+	Bridge *BridgePtr = (Bridge *)CallBackRef;
+
+	(void)BufferPtr;
+
+	switch (Event) {
+	case USB_CDC_EVENT_RECV:
+		Bridge_UsbRxDone(BridgePtr,
+				 &BridgePtr->Dir[BRIDGE_DIR_HOST_TO_UART],
+				 Length);
+		break;
+	case USB_CDC_EVENT_SENT:
+		Bridge_TxDone(BridgePtr,
+			      &BridgePtr->Dir[BRIDGE_DIR_UART_TO_HOST]);
+		break;
+	case USB_CDC_EVENT_LINE_CODING:
+		if ((Length != 0U) &&
+		    (XUartPs_SetBaudRate(&BridgePtr->Port[1].Uart, Length) ==
+		     XST_SUCCESS)) {
+			Bridge_SetFillLength(BridgePtr, Length);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* Hands the oldest descriptor on the bulk OUT endpoint over to the UART.
+* The endpoint completes the descriptors in the order they were queued, so
+* the next one is already receiving. A zero length completion still goes
+* through the ring so that the descriptor order is kept.
+*
+* @param	BridgePtr is a pointer to the bridge.
+* @param	DirPtr is the host to UART direction.
+* @param	Count is the number of bytes in the descriptor.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+static void Bridge_UsbRxDone(Bridge *BridgePtr, Bridge_Dir *DirPtr,
+			     u32 Count)
+{
+	Bridge_Bd *BdPtr = &DirPtr->Bd[DirPtr->FillIndex];
+
+	if (BdPtr->State != BRIDGE_BD_FILLING) {
+		return;
+	}
+
+	BdPtr->Length = Count;
+#ifdef BRIDGE_RX_STAMP
+	/* The endpoint has no FIFO to correct for, it completed just now */
+	XTime_GetTime(&BdPtr->Stamp);
+#endif
+	BdPtr->State = BRIDGE_BD_FULL;
+	DirPtr->FillIndex = (DirPtr->FillIndex + 1U) % BRIDGE_BD_PER_DIR;
+
+	if (Count != 0U) {
+		DirPtr->Stats.Bytes += Count;
+		DirPtr->Stats.Buffers++;
+		if (Count < BRIDGE_BD_SIZE) {
+			DirPtr->Stats.PartialBuffers++;
+		}
+	}
+
+	if (DirPtr->TxBusy == 0U) {
+		Bridge_Kick(BridgePtr, DirPtr);
+	}
+}
+#endif
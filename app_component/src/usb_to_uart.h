@@ -0,0 +1,223 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file usb_to_uart.h
+*
+* Zero-copy bridge engine between the host-facing port and the PS UARTs.
+*
+* On the Arty Z7 the host reaches the PS through the USB-UART converter wired
+* to UART0. The bridge moves data between two ports, port 0 being the
+* host-facing one. Every direction owns a pair of cache line aligned buffer
+* descriptors used ping-pong: the receiving port fills one descriptor while
+* the transmitting port sends the other one straight out of the same memory,
+* so no byte is ever copied between the FIFOs.
+*
+* A descriptor is handed over as soon as it is full or the receiver has been
+* idle for the RX timeout, which bounds the latency of a byte through the
+* bridge to the time needed to fill one descriptor at line rate. The fill
+* length is derived from the baud rate so that this stays below
+* BRIDGE_LATENCY_US. When only one UART is present the bridge runs port 0 in
+* echo mode.
+*
+* With BRIDGE_USB_CDC defined, port 0 is instead the USB CDC-ACM device of
+* usb_cdc.h and port 1 is UART0. The descriptors of the host to UART
+* direction are all queued on the bulk OUT endpoint at once, each a whole
+* number of packets, so that the host can send several of them back to back
+* while the UART drains one; a descriptor goes back to the endpoint as soon
+* as it is sent. The descriptors filled by the UART are sent on the bulk IN
+* endpoint from the same memory. The line rate set by the host is applied
+* to UART0.
+*
+* Each direction received from a UART can coalesce its data instead:
+* Bridge_SetCoalesce() sets its size threshold, the bytes a descriptor is
+* handed over at, and a deadline in microseconds on the timer wheel,
+* started when the receiver first goes idle on a partial descriptor. The
+* descriptor is handed over at the threshold or the deadline, whichever
+* comes first, rather than on the RX timeout, so that bulk transfers go in
+* large descriptors while an interactive byte waits no longer than the
+* deadline plus the RX timeout. Both are changed at runtime, the threshold
+* taking effect from the next descriptor.
+*
+* With BRIDGE_RX_STAMP defined, the UARTs stamp the first byte of each
+* descriptor they receive, refer to XUartPs_EnableRxStamp(), and a
+* descriptor received from USB is stamped when its transfer completes. The
+* stamp goes with the descriptor to the sending port, and once the
+* descriptor has been sent the time from the stamp is added to the latency
+* counters of the direction, whose mean and maximum Bridge_GetStats()
+* gives. The bytes themselves are forwarded as they are. The latency of
+* each descriptor also goes to the handler of Bridge_SetLatencyHandler(),
+* e.g. the histograms of bridge_bench.h.
+*
+* A direction sent on a UART can be paced for the protocols that need a
+* silent interval between frames, such as the 3.5 characters of Modbus RTU:
+* Bridge_SetTxGap() makes each descriptor a frame and keeps the line idle
+* for a number of bit times after it. The TX empty interrupt of the frame
+* starts a timer of the timer wheel for the character still in the shift
+* register plus the gap, and the next frame is only written into the TX
+* FIFO when it expires; no CPU waits for the line meanwhile. The gap is a
+* minimum, late by the interrupt latency at most, and the latest release
+* past its due time goes to the counters.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+*       qm     10/14/26 Added the optional RX timestamps and latency
+*			counters.
+*       qm     10/14/26 Added Bridge_SetLatencyHandler().
+*       qm     10/14/26 Added the paced TX of Bridge_SetTxGap().
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef USB_TO_UART_H
+#define USB_TO_UART_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xparameters.h"
+#include "xuartps.h"
+#include "timer_wheel.h"
+#ifdef BRIDGE_USB_CDC
+#ifndef XPAR_XUSBPS_0_BASEADDR
+#error "BRIDGE_USB_CDC needs USB0 in the hardware design"
+#endif
+#include "usb_cdc.h"
+#endif
+
+/************************** Constant Definitions ****************************/
+
+#define BRIDGE_CACHE_LINE	32U	/**< Cortex-A9 L1 D-cache line */
+#define BRIDGE_LATENCY_US	1000U	/**< Worst case latency target */
+#ifdef BRIDGE_USB_CDC
+#define BRIDGE_BD_SIZE		2048U	/**< Four high speed packets */
+#define BRIDGE_BD_PER_DIR	USB_CDC_XFERS /**< All queued on the endpoint */
+#else
+#define BRIDGE_BD_SIZE		256U	/**< Storage per buffer descriptor */
+#define BRIDGE_BD_PER_DIR	2U	/**< Ping-pong pair */
+#endif
+#define BRIDGE_NUM_PORTS	2U	/**< Host-facing port and UART side */
+#define BRIDGE_NUM_DIRS		2U	/**< Port 0 to port 1 and back */
+#define BRIDGE_CHAR_BITS	10U	/**< Start, 8 data and stop bits */
+
+#define BRIDGE_DIR_HOST_TO_UART	0U	/**< Port 0 to port 1 */
+#define BRIDGE_DIR_UART_TO_HOST	1U	/**< Port 1 to port 0 */
+
+/** @name Buffer descriptor states
+ * @{
+ */
+#define BRIDGE_BD_FREE		0U	/**< Owned by nobody */
+#define BRIDGE_BD_FILLING	1U	/**< Owned by the receiving port */
+#define BRIDGE_BD_FULL		2U	/**< Waiting for the sending port */
+#define BRIDGE_BD_DRAINING	3U	/**< Owned by the sending port */
+/* @} */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * A buffer descriptor, shared between the receiving and the sending port.
+ */
+typedef struct {
+	u8 *DataPtr;		/**< Cache line aligned storage */
+	u32 Length;		/**< Valid bytes once FULL */
+	volatile u32 State;	/**< One of the BRIDGE_BD_* states */
+	u64 Stamp;		/**< XTime of the first byte, 0 if none */
+} Bridge_Bd;
+
+/**
+ * Throughput counters of one direction.
+ */
+typedef struct {
+	u64 Bytes;		/**< Bytes forwarded */
+	u32 Buffers;		/**< Descriptors forwarded */
+	u32 PartialBuffers;	/**< Descriptors handed over on RX timeout */
+	u32 RxStalls;		/**< Times the receiver found no free BD */
+	u32 RxErrors;		/**< Parity, framing and overrun errors */
+	u32 DeadlineBuffers;	/**< Descriptors handed over at the deadline */
+	u32 StampedBuffers;	/**< Descriptors sent with a stamp */
+	u64 LatencySumUs;	/**< From the stamps to the end of the send */
+	u32 LatencyMaxUs;	/**< Longest of them */
+	u32 PacedFrames;	/**< Frames held back for a gap */
+	u32 GapLateMaxUs;	/**< Latest release past the end of a gap */
+} Bridge_Stats;
+
+/**
+ * Takes the latency of a stamped descriptor of direction Dir once it has
+ * been sent, from the interrupt handler of the sending port.
+ */
+typedef void (*Bridge_LatencyFn)(void *Ref, u32 Dir, u32 LatencyUs);
+
+/**
+ * One direction of the bridge.
+ */
+typedef struct {
+	XUartPs *RxPortPtr;	/**< Port the data is received on, NULL for USB */
+	XUartPs *TxPortPtr;	/**< Port the data is sent on, NULL for USB */
+	Bridge_Bd Bd[BRIDGE_BD_PER_DIR];
+	u32 FillIndex;		/**< Descriptor being received into */
+	u32 DrainIndex;		/**< Next descriptor to be sent */
+	volatile u32 RxStalled;	/**< Receiver waits for a free BD */
+	volatile u32 TxBusy;	/**< A descriptor is being sent */
+	u32 FillLength;		/**< Bytes received per descriptor */
+	u32 DeadlineUs;		/**< Latency cap of a partial one, 0 for none */
+	TimerWheel_Timer Deadline;
+	u32 GapBits;		/**< Bit times between frames, 0 for none */
+	XTime GapDue;		/**< When the line has been idle long enough */
+	TimerWheel_Timer Gap;
+	struct Bridge_s *BridgePtr;
+	Bridge_Stats Stats;
+} Bridge_Dir;
+
+/**
+ * A port of the bridge.
+ */
+typedef struct {
+	XUartPs Uart;		/**< Driver instance */
+	struct Bridge_s *BridgePtr;
+	u32 RxDir;		/**< Direction this port receives for */
+	u32 TxDir;		/**< Direction this port sends for */
+} Bridge_Port;
+
+/**
+ * The bridge engine.
+ */
+typedef struct Bridge_s {
+	Bridge_Port Port[BRIDGE_NUM_PORTS];
+	Bridge_Dir Dir[BRIDGE_NUM_DIRS];
+#ifdef BRIDGE_USB_CDC
+	UsbCdc Usb;		/**< Port 0 */
+#endif
+	u32 NumDirs;		/**< 1 in echo mode, 2 otherwise */
+	TimerWheel *WheelPtr;	/**< Deadlines, NULL for none */
+	Bridge_LatencyFn LatencyFn; /**< NULL for none */
+	void *LatencyRef;
+	u32 IsStarted;
+} Bridge;
+
+/************************** Function Prototypes *****************************/
+
+s32 Bridge_Initialize(Bridge *BridgePtr, u32 BaudRate, TimerWheel *WheelPtr);
+s32 Bridge_Start(Bridge *BridgePtr);
+void Bridge_Stop(Bridge *BridgePtr);
+s32 Bridge_SetCoalesce(Bridge *BridgePtr, u32 Dir, u32 MaxBytes, u32 MaxUs);
+s32 Bridge_SetTxGap(Bridge *BridgePtr, u32 Dir, u32 GapBits);
+void Bridge_GetStats(Bridge *BridgePtr, u32 Dir, Bridge_Stats *StatsPtr);
+void Bridge_SetLatencyHandler(Bridge *BridgePtr, Bridge_LatencyFn FuncPtr,
+			      void *CallBackRef);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* USB_TO_UART_H */
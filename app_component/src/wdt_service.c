@@ -0,0 +1,323 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file wdt_service.c
+*
+* Progress based watchdog service. Refer to wdt_service.h for how it is
+* used.
+*
+* The operations are a singly linked list, changed with the IRQ masked and
+* walked by the check, which runs from the timer interrupt. The progress
+* counts are read without a lock; a count lost to two contexts reporting at
+* once does not matter, any change is progress.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xstatus.h"
+#include "xparameters.h"
+#include "xpseudo_asm.h"
+#include "xreg_cortexa9.h"
+#include "wdt_service.h"
+#include "drvcfg.h"
+
+/************************** Constant Definitions ****************************/
+
+#define WDT_SERVICE_COUNTS_PER_MS	((XTime)COUNTS_PER_SECOND / 1000U)
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+static void WdtService_Check(void *CallBackRef);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* Sets up the service on the private watchdog of the calling CPU, stopped.
+*
+* @param	ServicePtr is a pointer to the service.
+* @param	WheelPtr is the timer wheel of the CPU, already initialized.
+* @param	TimeoutMs is the time the watchdog resets the CPU after the
+*		last restart, up to about 12 s on the peripheral clock.
+*
+* @return
+*		- XST_SUCCESS if the service is ready.
+*		- XST_INVALID_PARAM if the timeout does not fit the watchdog.
+*		- XST_FAILURE if the watchdog is not found.
+*
+*****************************************************************************/
+s32 WdtService_Initialize(WdtService *ServicePtr, TimerWheel *WheelPtr,
+			  u32 TimeoutMs)
+{
+	XScuWdt_Config *CfgPtr;
+	XTime Counts;
+	s32 Status;
+
+	Counts = (XTime)TimeoutMs * WDT_SERVICE_COUNTS_PER_MS;
+	if ((TimeoutMs == 0U) || (Counts > 0xFFFFFFFFU)) {
+		return XST_INVALID_PARAM;
+	}
+
+	CfgPtr = XScuWdt_LookupConfigStatic(XPAR_XSCUWDT_0_BASEADDR);
+	if (CfgPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	Status = XScuWdt_CfgInitialize(&ServicePtr->Wdt, CfgPtr,
+				       CfgPtr->BaseAddr);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	/* Out of a reset mode left by a previous run */
+	XScuWdt_SetTimerMode(&ServicePtr->Wdt);
+	XScuWdt_Stop(&ServicePtr->Wdt);
+
+	ServicePtr->WheelPtr = WheelPtr;
+	ServicePtr->LoadValue = (u32)Counts;
+	ServicePtr->PeriodCounts = Counts / WDT_SERVICE_CHECKS;
+	ServicePtr->NextCheck = 0U;
+	ServicePtr->Running = 0U;
+	ServicePtr->Head = NULL;
+	ServicePtr->Stalled = NULL;
+	ServicePtr->Stats.Kicks = 0U;
+	ServicePtr->Stats.Checks = 0U;
+	ServicePtr->Stats.Begun = 0U;
+	ServicePtr->Stats.Stalls = 0U;
+	TimerWheel_InitTimer(&ServicePtr->Timer, WdtService_Check, ServicePtr);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Arms the watchdog in reset mode and starts the checks.
+*
+* @param	ServicePtr is a pointer to the service.
+*
+* @return	None.
+*
+* @note		Call it on the CPU of the service.
+*
+*****************************************************************************/
+void WdtService_Start(WdtService *ServicePtr)
+{
+	u32 Control;
+	XTime Now;
+
+	if (ServicePtr->Running != 0U) {
+		return;
+	}
+
+	/* Peripheral clock, no prescaler, no interrupt */
+	Control = XScuWdt_GetControlReg(&ServicePtr->Wdt);
+	Control &= ~(XSCUWDT_CONTROL_PRESCALER_MASK |
+		     XSCUWDT_CONTROL_AUTO_RELOAD_MASK |
+		     XSCUWDT_CONTROL_IT_ENABLE_MASK);
+	XScuWdt_SetControlReg(&ServicePtr->Wdt, Control);
+	XScuWdt_LoadWdt(&ServicePtr->Wdt, ServicePtr->LoadValue);
+	XScuWdt_SetWdMode(&ServicePtr->Wdt);
+	XScuWdt_Start(&ServicePtr->Wdt);
+	ServicePtr->Running = 1U;
+
+	XTime_GetTime(&Now);
+	ServicePtr->NextCheck = Now + ServicePtr->PeriodCounts;
+	TimerWheel_StartAt(ServicePtr->WheelPtr, &ServicePtr->Timer,
+			   ServicePtr->NextCheck);
+}
+
+/****************************************************************************/
+/**
+*
+* Stops the checks and disarms the watchdog, for a handoff or a debugger
+* session. The operations stay registered.
+*
+* @param	ServicePtr is a pointer to the service.
+*
+* @return	None.
+*
+*****************************************************************************/
+void WdtService_Stop(WdtService *ServicePtr)
+{
+	TimerWheel_Cancel(ServicePtr->WheelPtr, &ServicePtr->Timer);
+
+	/* Only the disable sequence takes the watchdog out of reset mode */
+	XScuWdt_SetTimerMode(&ServicePtr->Wdt);
+	XScuWdt_Stop(&ServicePtr->Wdt);
+	ServicePtr->Running = 0U;
+}
+
+/****************************************************************************/
+/**
+*
+* Adds a long operation. Its stall time runs from now, so the first chunk
+* has as long as the later ones.
+*
+* @param	ServicePtr is a pointer to the service.
+* @param	OpPtr is a pointer to the operation, not in progress.
+* @param	Name names the operation in the report of a stall.
+* @param	StallMs is the longest time the operation may go without
+*		reporting progress. It is checked every quarter of the
+*		watchdog timeout, so the watchdog resets the CPU at most
+*		StallMs plus one and a quarter timeouts after the last
+*		report.
+*
+* @return	XST_SUCCESS, or XST_INVALID_PARAM for a zero stall time.
+*
+*****************************************************************************/
+s32 WdtService_Begin(WdtService *ServicePtr, WdtService_Op *OpPtr,
+		     const char *Name, u32 StallMs)
+{
+	u32 Cpsr;
+
+	if (StallMs == 0U) {
+		return XST_INVALID_PARAM;
+	}
+
+	OpPtr->Name = Name;
+	OpPtr->StallCounts = (XTime)StallMs * WDT_SERVICE_COUNTS_PER_MS;
+	OpPtr->Progress = 0U;
+	OpPtr->Seen = 0U;
+	XTime_GetTime(&OpPtr->LastProgress);
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+	OpPtr->Next = ServicePtr->Head;
+	ServicePtr->Head = OpPtr;
+	ServicePtr->Stats.Begun++;
+	mtcpsr(Cpsr);
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* Removes an operation that has completed or failed.
+*
+* @param	ServicePtr is a pointer to the service.
+* @param	OpPtr is a pointer to the operation. One not in progress is
+*		ignored.
+*
+* @return	None.
+*
+*****************************************************************************/
+void WdtService_End(WdtService *ServicePtr, WdtService_Op *OpPtr)
+{
+	WdtService_Op **LinkPtr;
+	u32 Cpsr;
+
+	Cpsr = mfcpsr();
+	mtcpsr(Cpsr | XREG_CPSR_IRQ_ENABLE);
+	for (LinkPtr = &ServicePtr->Head; *LinkPtr != NULL;
+	     LinkPtr = &(*LinkPtr)->Next) {
+		if (*LinkPtr == OpPtr) {
+			*LinkPtr = OpPtr->Next;
+			OpPtr->Next = NULL;
+			break;
+		}
+	}
+	if (ServicePtr->Stalled == OpPtr) {
+		ServicePtr->Stalled = NULL;
+	}
+	mtcpsr(Cpsr);
+}
+
+/****************************************************************************/
+/**
+*
+* Returns the operation the last check found stalled, for a report before
+* the reset.
+*
+* @param	ServicePtr is a pointer to the service.
+*
+* @return	The first stalled operation, or NULL if all made progress.
+*
+*****************************************************************************/
+const WdtService_Op *WdtService_GetStalled(const WdtService *ServicePtr)
+{
+	return ServicePtr->Stalled;
+}
+
+/****************************************************************************/
+/**
+*
+* Copies the counts of the service.
+*
+* @param	ServicePtr is a pointer to the service.
+* @param	StatsPtr is where the counts are copied to.
+*
+* @return	None.
+*
+*****************************************************************************/
+void WdtService_GetStats(const WdtService *ServicePtr,
+			 WdtService_Stats *StatsPtr)
+{
+	*StatsPtr = ServicePtr->Stats;
+}
+
+/****************************************************************************/
+/*
+*
+* Check of the operations, the handler of the timer. Restarts the watchdog
+* if none has stalled and starts the timer for the next check, on a fixed
+* period so that the checks do not drift.
+*
+* @param	CallBackRef is the service.
+*
+* @return	None.
+*
+*****************************************************************************/
+static void WdtService_Check(void *CallBackRef)
+{
+	WdtService *ServicePtr = (WdtService *)CallBackRef;
+	WdtService_Op *OpPtr;
+	const WdtService_Op *StalledPtr = NULL;
+	u32 Progress;
+	XTime Now;
+
+	XTime_GetTime(&Now);
+	ServicePtr->Stats.Checks++;
+
+	for (OpPtr = ServicePtr->Head; OpPtr != NULL; OpPtr = OpPtr->Next) {
+		Progress = OpPtr->Progress;
+		if (Progress != OpPtr->Seen) {
+			OpPtr->Seen = Progress;
+			OpPtr->LastProgress = Now;
+		} else if (((Now - OpPtr->LastProgress) > OpPtr->StallCounts) &&
+			   (StalledPtr == NULL)) {
+			StalledPtr = OpPtr;
+		}
+	}
+	ServicePtr->Stalled = StalledPtr;
+
+	if (StalledPtr == NULL) {
+		XScuWdt_RestartWdt(&ServicePtr->Wdt);
+		ServicePtr->Stats.Kicks++;
+	} else {
+		ServicePtr->Stats.Stalls++;
+	}
+
+	ServicePtr->NextCheck += ServicePtr->PeriodCounts;
+	TimerWheel_StartAt(ServicePtr->WheelPtr, &ServicePtr->Timer,
+			   ServicePtr->NextCheck);
+}
@@ -0,0 +1,136 @@
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file wdt_service.h
+*
+* Watchdog service that kicks the SCU private watchdog only while the long
+* operations in progress keep making progress.
+*
+* A long operation, such as a partition move, an SD card read or a
+* bitstream load, is a WdtService_Op of the caller. It is added with
+* WdtService_Begin() along with the longest time it may go without
+* progress, reports each chunk it completes with WdtService_Progress(), a
+* single increment that is cheap enough for the inner loops, and is
+* removed with WdtService_End().
+*
+* A timer of the timer wheel of timer_wheel.h runs every quarter of the
+* watchdog timeout. It restarts the watchdog when every operation has
+* reported progress within its stall time, and stops restarting it as soon
+* as one has not, so that a hung transfer resets the CPU one timeout later.
+* The time of an operation is only counted from its last report, so that
+* chunked and pipelined operations of any length are covered without kicks
+* in their loops. With no operation in progress the watchdog is kept
+* alive; an operation begun for the main loop and reported from it once per
+* pass watches the loop too.
+*
+* The watchdog is per CPU and is also the sample timer of pc_prof.h; the
+* two cannot run together.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- ----------------------------------------------
+* 1.00  qm     10/14/26 First release
+* </pre>
+*
+*****************************************************************************/
+
+#ifndef WDT_SERVICE_H
+#define WDT_SERVICE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files ********************************/
+
+#include "xil_types.h"
+#include "xiltimer.h"
+#include "xscuwdt.h"
+#include "timer_wheel.h"
+
+/************************** Constant Definitions ****************************/
+
+#define WDT_SERVICE_CHECKS	4U	/**< Checks per watchdog timeout */
+
+/**************************** Type Definitions ******************************/
+
+/**
+ * A long operation. Owned by the caller and linked into the service while
+ * in progress.
+ */
+typedef struct WdtService_Op {
+	struct WdtService_Op *Next;
+	const char *Name;	/**< For the report of a stall */
+	XTime StallCounts;	/**< Longest time without progress */
+	volatile u32 Progress;	/**< Chunks reported */
+	u32 Seen;		/**< Progress at the last check */
+	XTime LastProgress;	/**< Time of the last change seen */
+} WdtService_Op;
+
+/**
+ * Counts of the service.
+ */
+typedef struct {
+	u32 Kicks;		/**< Watchdog restarts */
+	u32 Checks;		/**< Checks of the operations */
+	u32 Begun;		/**< Operations begun */
+	u32 Stalls;		/**< Checks that found a stalled operation */
+} WdtService_Stats;
+
+/**
+ * The service.
+ */
+typedef struct {
+	XScuWdt Wdt;		/**< Private watchdog, reset mode */
+	TimerWheel *WheelPtr;
+	TimerWheel_Timer Timer;	/**< Check of the operations */
+	XTime PeriodCounts;	/**< Time between checks */
+	XTime NextCheck;	/**< Deadline of the timer */
+	u32 LoadValue;		/**< Watchdog timeout, in counts */
+	u32 Running;
+	WdtService_Op *Head;	/**< Operations in progress */
+	const WdtService_Op *Stalled; /**< First stalled, NULL for none */
+	WdtService_Stats Stats;
+} WdtService;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/****************************************************************************/
+/**
+*
+* Reports progress of an operation, from any context.
+*
+* @param	OpPtr is a pointer to the operation.
+*
+* @return	None.
+*
+* @note		C-style signature:
+*		void WdtService_Progress(WdtService_Op *OpPtr)
+*
+*****************************************************************************/
+#define WdtService_Progress(OpPtr)	((OpPtr)->Progress++)
+
+/************************** Function Prototypes *****************************/
+
+s32 WdtService_Initialize(WdtService *ServicePtr, TimerWheel *WheelPtr,
+			  u32 TimeoutMs);
+void WdtService_Start(WdtService *ServicePtr);
+void WdtService_Stop(WdtService *ServicePtr);
+s32 WdtService_Begin(WdtService *ServicePtr, WdtService_Op *OpPtr,
+		     const char *Name, u32 StallMs);
+void WdtService_End(WdtService *ServicePtr, WdtService_Op *OpPtr);
+const WdtService_Op *WdtService_GetStalled(const WdtService *ServicePtr);
+void WdtService_GetStats(const WdtService *ServicePtr,
+			 WdtService_Stats *StatsPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WDT_SERVICE_H */
@@ -0,0 +1,274 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+"""Check the boot timeline of the FSBL against a baseline.
+
+Resets the board through XSCT, captures the boot timeline of
+fsbl_timeline.h the FSBL writes to the UART with FSBL_TIMELINE_UART, works
+out the time of each stage and compares it with a baseline of the same
+boot mode. A stage is a regression when it takes longer than its baseline
+by more than --pct percent and more than --us microseconds; the exit
+status is then 1, so that the check can run after each build.
+
+The boot mode is that of the jumper of the board, the FSBL records it and
+the capture is refused when it is not the mode given. In QSPI and SD mode
+the board is reset with the system reset and boots from the flash, or is
+power cycled by --power-cmd. In JTAG mode the board is reset and the
+bitstream and the FSBL of the launch configuration of the application,
+_ide/launch.json, are downloaded and run, the FSBL running its own
+ps7_init as in the other modes. Each run is a boot, the time of a stage is
+the median of the runs. --capture reads captures saved before instead of
+the board, --update stores the result as the new baseline.
+
+    boot_regress.py qspi --port /dev/ttyUSB1 --runs 5 --update
+    boot_regress.py qspi --port /dev/ttyUSB1 --runs 5
+    boot_regress.py jtag --capture boot1.bin --capture boot2.bin
+"""
+
+import argparse
+import json
+import os
+import statistics
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+
+MAGIC = 0x314C5446
+HEADER = struct.Struct("<IHHII")
+ENTRY = struct.Struct("<IIQ")
+MAX_ENTRIES = (0x800 - HEADER.size) // ENTRY.size
+STAGE_END = 0x80000000
+
+STAGES = {0x01: "ps7_init", 0x02: "ddr_init_check", 0x03: "pcap_init",
+          0x04: "flash_init", 0x05: "header_read",
+          0x06: "partition_header", 0x07: "partition_move",
+          0x08: "checksum", 0x09: "authentication", 0x0A: "decryption",
+          0x0B: "pcap", 0x0C: "handoff"}
+# Stages timed once per partition, their argument is the partition number
+PER_PARTITION = (0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B)
+FLASH_INIT = 0x04
+MODES = {"jtag": 0x0, "qspi": 0x1, "sd": 0x5}
+
+TOOLS = os.path.dirname(os.path.abspath(__file__))
+WORKSPACE = os.path.dirname(os.path.dirname(TOOLS))
+
+
+def find_record(data):
+    """Return the counts per second and the entries of the last valid
+    record in data, or None."""
+    found = None
+    start = data.find(struct.pack("<I", MAGIC))
+    while start >= 0:
+        if start + HEADER.size <= len(data):
+            magic, count, _, cps, checksum = HEADER.unpack_from(data, start)
+            end = start + HEADER.size + count * ENTRY.size
+            if count <= MAX_ENTRIES and end <= len(data):
+                words = struct.unpack_from("<%dI" % ((end - start) // 4),
+                                           data, start)
+                if (sum(words) - checksum) & 0xFFFFFFFF == checksum:
+                    found = (cps, [ENTRY.unpack_from(data, start +
+                                                     HEADER.size +
+                                                     i * ENTRY.size)
+                                   for i in range(count)])
+        start = data.find(struct.pack("<I", MAGIC), start + 1)
+    return found
+
+
+def stage_times(cps, entries):
+    """Return the boot mode and the microseconds of each stage, keyed by
+    its name and, per partition, its number."""
+    begins = {}
+    times = {}
+    mode = None
+    for stage, arg, stamp in entries:
+        number = stage & ~STAGE_END
+        name = STAGES.get(number, "stage_%02x" % number)
+        if number in PER_PARTITION:
+            name += ".%d" % arg
+        if number == FLASH_INIT:
+            mode = arg
+        if not stage & STAGE_END:
+            begins[name] = stamp
+        elif name in begins:
+            times[name] = (stamp - begins.pop(name)) * 1e6 / cps
+    if entries:
+        stamps = [entry[2] for entry in entries]
+        times["total"] = (max(stamps) - min(stamps)) * 1e6 / cps
+    return mode, times
+
+
+def launch_files(path):
+    """Return the bitstream and the FSBL of the launch configuration."""
+    with open(path) as launch:
+        setup = json.load(launch)["configurations"][0]["targetSetup"]
+
+    def resolve(name):
+        name = name.replace("${workspaceFolder}", WORKSPACE)
+        return os.path.normpath(name.replace("\\", "/"))
+
+    init = setup["zynqInitialization"]["usingFSBL"]
+    bitstream = resolve(setup["bitstreamFile"]) \
+        if setup.get("programDevice") else None
+    return bitstream, resolve(init["fsblFile"])
+
+
+def reset_script(args):
+    """Return the XSCT script that resets the board for the mode."""
+    lines = ["connect -url %s" % args.hw_server,
+             'targets -set -nocase -filter {name =~ "APU*"}']
+    if args.mode != "jtag":
+        lines.append("rst -srst")
+        return lines
+    bitstream, fsbl = launch_files(args.launch)
+    lines += ["rst -system", "after 500"]
+    if bitstream and os.path.exists(bitstream):
+        lines.append("fpga -file {%s}" % bitstream.replace("\\", "/"))
+    lines += ['targets -set -nocase -filter {name =~ "*A9*#0"}',
+              "dow {%s}" % fsbl.replace("\\", "/"), "con"]
+    return lines
+
+
+def reset(args):
+    if args.power_cmd and args.mode != "jtag":
+        subprocess.run(args.power_cmd, shell=True, check=True)
+        return
+    with tempfile.NamedTemporaryFile("w", suffix=".tcl",
+                                     delete=False) as script:
+        script.write("\n".join(reset_script(args) + ["exit", ""]))
+    try:
+        subprocess.run([args.xsct, script.name], check=True,
+                       stdout=subprocess.DEVNULL, timeout=60)
+    finally:
+        os.unlink(script.name)
+
+
+def capture(args, port):
+    """Boot the board once, return the record it writes."""
+    port.reset_input_buffer()
+    reset(args)
+    data = bytearray()
+    deadline = time.monotonic() + args.timeout
+    while time.monotonic() < deadline:
+        data += port.read(port.in_waiting or 1)
+        record = find_record(data)
+        if record:
+            return record
+    sys.exit("no boot timeline on %s within %d s" % (args.port,
+                                                      args.timeout))
+
+
+def records(args):
+    if args.capture:
+        for path in args.capture:
+            with open(path, "rb") as capture_file:
+                record = find_record(capture_file.read())
+            if not record:
+                sys.exit("%s: no boot timeline" % path)
+            yield record
+        return
+    try:
+        import serial
+    except ImportError:
+        sys.exit("capturing from the board needs pyserial")
+    with serial.Serial(args.port, args.baud, timeout=0.1) as port:
+        for _ in range(args.runs):
+            yield capture(args, port)
+
+
+def compare(baseline, times, pct, us):
+    """Print each stage against its baseline, return the regressions."""
+    failed = 0
+    print("%-22s %12s %12s %10s" % ("stage", "baseline us", "now us",
+                                    "delta"))
+    for name in sorted(set(baseline) | set(times)):
+        if name not in times:
+            print("%-22s %12.1f %12s %10s  missing" % (name, baseline[name],
+                                                       "-", "-"))
+            failed += 1
+            continue
+        if name not in baseline:
+            print("%-22s %12s %12.1f %10s  new" % (name, "-", times[name],
+                                                   "-"))
+            continue
+        delta = times[name] - baseline[name]
+        slow = delta > us and delta > baseline[name] * pct / 100.0
+        print("%-22s %12.1f %12.1f %+10.1f%s" % (
+            name, baseline[name], times[name], delta,
+            "  REGRESSION" if slow else ""))
+        failed += slow
+    return failed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("mode", choices=sorted(MODES),
+                        help="boot mode set on the board")
+    parser.add_argument("--port", help="serial port of the FSBL UART")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--capture", action="append", metavar="FILE",
+                        help="saved capture instead of the board, repeated "
+                        "for several runs")
+    parser.add_argument("--runs", type=int, default=3,
+                        help="boots of the board, the median is kept")
+    parser.add_argument("--baseline", help="baseline file, "
+                        "boot_baseline_<mode>.json by default")
+    parser.add_argument("--update", action="store_true",
+                        help="store the result as the baseline")
+    parser.add_argument("--pct", type=float, default=10.0,
+                        help="percent slower than the baseline allowed")
+    parser.add_argument("--us", type=float, default=50.0,
+                        help="microseconds slower than the baseline "
+                        "allowed")
+    parser.add_argument("--timeout", type=int, default=30,
+                        help="seconds to wait for the timeline of a boot")
+    parser.add_argument("--xsct", default="xsct")
+    parser.add_argument("--hw-server", default="tcp:127.0.0.1:3121")
+    parser.add_argument("--launch", default=os.path.join(
+        WORKSPACE, "app_component", "_ide", "launch.json"),
+        help="launch configuration of the JTAG mode")
+    parser.add_argument("--power-cmd",
+                        help="shell command power cycling the board, "
+                        "instead of the system reset in QSPI and SD mode")
+    args = parser.parse_args()
+    if not args.capture and not args.port:
+        parser.error("--port or --capture is needed")
+    baseline_path = args.baseline or "boot_baseline_%s.json" % args.mode
+
+    runs = []
+    for cps, entries in records(args):
+        mode, times = stage_times(cps, entries)
+        if mode is not None and mode != MODES[args.mode]:
+            sys.exit("the board booted in mode %d, not %s" % (mode,
+                                                              args.mode))
+        runs.append(times)
+    times = {name: statistics.median(run[name] for run in runs
+                                     if name in run)
+             for name in set().union(*runs)}
+
+    if args.update:
+        with open(baseline_path, "w") as baseline_file:
+            json.dump({"mode": args.mode, "runs": len(runs),
+                       "stages": times}, baseline_file, indent=2,
+                      sort_keys=True)
+            baseline_file.write("\n")
+        print("%s: %d stages from %d runs" % (baseline_path, len(times),
+                                              len(runs)))
+        return
+
+    try:
+        with open(baseline_path) as baseline_file:
+            baseline = json.load(baseline_file)
+    except FileNotFoundError:
+        sys.exit("%s: no baseline, make one with --update" % baseline_path)
+    if baseline.get("mode") != args.mode:
+        sys.exit("%s: baseline of %s boot" % (baseline_path,
+                                              baseline.get("mode")))
+    failed = compare(baseline["stages"], times, args.pct, args.us)
+    if failed:
+        print("%d stages slower than the baseline" % failed)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,495 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+"""Load the USB-UART bridge end to end and report what it delivers.
+
+The host side of the benchmark mode of bridge_bench.h. Sends numbered
+messages through the bridge at the sizes, rates and patterns given and
+receives them back, then reports per run the messages lost, corrupted,
+duplicated and reordered, the throughput and the latency percentiles, as
+the host sees them: the USB-UART converter, the host drivers and the
+bridge together. One run is made per size, rate and duplex given, each
+after an idle gap so that the target starts a new run too.
+
+A message is COBS framed and delimited by 0x00 as in uart_frame.h: the
+magic 0x4C42, the stream, the sequence number and the host time it was
+sent at in ns, the bytes of a pattern up to --size, then a CRC-32 of it
+all. Without --far-port the target loops the UART side back, the messages
+cross both directions of the bridge and come back on --port, the stream
+"loop". With --far-port, a second serial port wired to the UART side of a
+target built with BRIDGE_BENCH_EXTERNAL, the streams are "h2u" from --port
+to --far-port and "u2h" back, --duplex picking one of them or "full" for
+both at once, both ends timed by the host clock.
+
+The patterns are "stream", messages at --rate per second or back to back
+with rate 0, "burst", --burst messages back to back then waiting until
+they are all back, and "pingpong", one message waiting for the previous.
+A run lasts --duration seconds or --count messages, whichever comes
+first.
+
+With --metrics, the capture of the metrics frames of the target being
+written, as for metrics_decode.py, the latency percentiles the target
+measured with its RX stamps, per direction of the bridge, go in the
+report too. The report is JSON, --json. A message is lost when it does
+not come back intact, the corrupted ones among them counted apart, and a
+run fails when more than --max-loss percent are lost, or its p99
+latency is over --max-p99-us, and the exit status is then 1.
+
+    bridge_load.py --port /dev/ttyUSB1 --size 16,64,256,1024 --json r.json
+    bridge_load.py --port /dev/ttyUSB1 --pattern pingpong --count 2000
+    bridge_load.py --port /dev/ttyUSB1 --far-port /dev/ttyUSB2 \\
+        --duplex h2u,u2h,full --rate 0,500 --metrics dcc.bin
+"""
+
+import argparse
+import datetime
+import json
+import os
+import struct
+import sys
+import threading
+import time
+import zlib
+
+import metrics_decode
+
+MAGIC = 0x4C42
+HEADER = struct.Struct("<HHIQ")
+CRC = struct.Struct("<I")
+MIN_SIZE = HEADER.size + CRC.size
+PATTERN = bytes(range(256)) * 2
+BITS_PER_CHAR = 10                      # 8N1
+IDLE_S = 1.5                            # Over BRIDGE_BENCH_IDLE_US
+METRICS_WAIT_S = 0.5                    # A few METRICS_PERIOD_MS
+PERCENTILES = ((50.0, "p50"), (90.0, "p90"), (99.0, "p99"),
+               (99.9, "p99.9"))
+STREAMS = {"loop": 0, "h2u": 1, "u2h": 2}
+TARGET_DIRS = (("0", "host_to_uart"), ("1", "uart_to_host"))
+
+
+def cobs_encode(data):
+    """Return the COBS block of data, without its delimiter."""
+    out = bytearray([0])
+    code_at = 0
+    for byte in data:
+        if byte:
+            out.append(byte)
+        if not byte or len(out) - code_at == 0xFF:
+            out[code_at] = len(out) - code_at
+            code_at = len(out)
+            out.append(0)
+    out[code_at] = len(out) - code_at
+    return bytes(out)
+
+
+def message(stream, seq, size):
+    """Return the framed message seq of stream, size bytes before COBS."""
+    body = HEADER.pack(MAGIC, stream, seq, time.monotonic_ns())
+    fill = size - MIN_SIZE
+    start = seq & 0xFF
+    while fill > 0:
+        chunk = min(fill, 256)
+        body += PATTERN[start:start + chunk]
+        fill -= chunk
+    body += CRC.pack(zlib.crc32(body))
+    return cobs_encode(body) + b"\x00"
+
+
+def percentile(ordered, pct):
+    """Return the nearest rank percentile of sorted values."""
+    rank = max(1, -(-len(ordered) * pct // 100))
+    return ordered[int(rank) - 1]
+
+
+class Link:
+    """A stream of messages from one port to another."""
+
+    def __init__(self, name, tx, size):
+        self.name = name
+        self.stream = STREAMS[name]
+        self.tx = tx
+        self.size = size
+        self.cond = threading.Condition()
+        self.sent = 0
+        self.wire_sent = 0
+        self.received = set()
+        self.latencies = []
+        self.corrupt = 0
+        self.duplicates = 0
+        self.reordered = 0
+        self.highest = -1
+        self.bytes_received = 0
+        self.wire_received = 0
+        self.first_tx = None
+        self.last_rx = None
+
+    def send(self):
+        frame = message(self.stream, self.sent, self.size)
+        if self.first_tx is None:
+            self.first_tx = time.monotonic_ns()
+        self.tx.write(frame)
+        with self.cond:
+            self.sent += 1
+            self.wire_sent += len(frame)
+
+    def deliver(self, seq, length, wire, now, latency):
+        with self.cond:
+            if seq in self.received:
+                self.duplicates += 1
+                return
+            if seq < self.highest:
+                self.reordered += 1
+            self.highest = max(self.highest, seq)
+            self.received.add(seq)
+            self.latencies.append(latency)
+            self.bytes_received += length
+            self.wire_received += wire
+            self.last_rx = now
+            self.cond.notify_all()
+
+    def fail(self):
+        with self.cond:
+            self.corrupt += 1
+
+    def wait(self, count, timeout):
+        """Wait until count messages are back, or timeout s without one.
+        Returns False on the timeout."""
+        with self.cond:
+            while len(self.received) < count:
+                before = len(self.received)
+                self.cond.wait(timeout)
+                if len(self.received) == before:
+                    return False
+        return True
+
+
+class Reader(threading.Thread):
+    """Receives the messages of the links of a port."""
+
+    def __init__(self, port, links):
+        super().__init__(daemon=True)
+        self.port = port
+        self.links = {link.stream: link for link in links}
+        self.stop = threading.Event()
+        self.stray = 0
+
+    def run(self):
+        pending = bytearray()
+        while not self.stop.is_set():
+            chunk = self.port.read(max(1, self.port.in_waiting))
+            if not chunk:
+                continue
+            now = time.monotonic_ns()
+            pending += chunk
+            while True:
+                end = pending.find(b"\x00")
+                if end < 0:
+                    break
+                encoded = bytes(pending[:end])
+                del pending[:end + 1]
+                if encoded:
+                    self.frame(encoded, now)
+
+    def frame(self, encoded, now):
+        body = metrics_decode.cobs_decode(encoded)
+        if body is None or len(body) < MIN_SIZE:
+            self.bad()
+            return
+        magic, stream, seq, stamp = HEADER.unpack_from(body)
+        link = self.links.get(stream)
+        if magic != MAGIC or link is None:
+            self.bad()
+            return
+        if zlib.crc32(body[:-CRC.size]) != \
+                CRC.unpack_from(body, len(body) - CRC.size)[0] or \
+                len(body) != link.size:
+            link.fail()
+            return
+        link.deliver(seq, len(body), len(encoded) + 1, now,
+                     (now - stamp) / 1000.0)
+
+    def bad(self):
+        """A frame of no link: corrupted beyond its stream, or stray."""
+        if len(self.links) == 1:
+            next(iter(self.links.values())).fail()
+        else:
+            self.stray += 1
+
+
+def drive(link, args, rate):
+    """Send the messages of a run on link."""
+    start = time.monotonic()
+    end = start + args.duration
+    timeout = args.timeout
+    while time.monotonic() < end and \
+            (args.count == 0 or link.sent < args.count):
+        if args.pattern == "pingpong":
+            link.send()
+            link.wait(link.sent, timeout)
+        elif args.pattern == "burst":
+            for _ in range(args.burst):
+                link.send()
+            link.wait(link.sent, timeout)
+        else:
+            if rate:
+                delay = start + link.sent / rate - time.monotonic()
+                if delay > 0:
+                    time.sleep(delay)
+            link.send()
+    link.tx.flush()
+
+
+def link_report(link, baud):
+    """Return the results of a link."""
+    lost = link.sent - len(link.received)
+    result = {"stream": link.name, "sent": link.sent,
+              "received": len(link.received), "lost": lost,
+              "corrupt": link.corrupt, "duplicates": link.duplicates,
+              "reordered": link.reordered,
+              "bytes_sent": link.sent * link.size,
+              "bytes_received": link.bytes_received}
+    seconds = 0.0
+    if link.first_tx is not None and link.last_rx is not None:
+        seconds = (link.last_rx - link.first_tx) / 1e9
+    result["seconds"] = round(seconds, 6)
+    if seconds > 0:
+        result["throughput_bps"] = round(link.bytes_received * 8 /
+                                         seconds)
+        result["messages_per_s"] = round(len(link.received) / seconds, 1)
+        result["line_utilization"] = round(link.wire_received *
+                                           BITS_PER_CHAR / seconds /
+                                           baud, 4)
+    if link.latencies:
+        ordered = sorted(link.latencies)
+        latency = {"min": round(ordered[0], 1)}
+        for pct, name in PERCENTILES:
+            latency[name] = round(percentile(ordered, pct), 1)
+        latency["max"] = round(ordered[-1], 1)
+        latency["mean"] = round(sum(ordered) / len(ordered), 1)
+        result["latency_us"] = latency
+    return result
+
+
+def target_report(path, last_runs):
+    """Return the bench.* metrics of the latest frames of the capture, or
+    None if the target did not start a run since last_runs."""
+    registry = metrics_decode.Registry()
+    seq = None
+    with open(path, "rb") as stream:
+        for frame in metrics_decode.frames(stream):
+            if frame is None or \
+                    len(frame) < metrics_decode.HEADER.size + 4 or \
+                    zlib.crc32(frame[:-4]) != \
+                    struct.unpack_from("<I", frame, len(frame) - 4)[0]:
+                continue
+            kind, number, _ = metrics_decode.HEADER.unpack_from(frame)
+            body = frame[metrics_decode.HEADER.size:-4]
+            if seq is not None and number != (seq + 1) & 0xFF and \
+                    kind == metrics_decode.FRAME_DATA:
+                registry.synced = False
+            seq = number
+            if kind == metrics_decode.FRAME_NAMES:
+                registry.names_frame(body)
+                continue
+            if kind == metrics_decode.FRAME_DATA and not registry.synced:
+                continue
+            try:
+                registry.value_frame(kind == metrics_decode.FRAME_KEY,
+                                     body)
+            except ValueError:
+                registry.synced = False
+                continue
+            registry.synced = True
+    values = {registry.names[index]: value
+              for index, value in registry.values.items()
+              if registry.names.get(index, "").startswith("bench.")}
+    runs = values.get("bench.runs")
+    if runs is None or runs == last_runs:
+        return None
+    report = {"runs": runs}
+    for number, name in TARGET_DIRS:
+        prefix = "bench.%s." % number
+        report[name] = {key[len(prefix):]: value
+                        for key, value in values.items()
+                        if key.startswith(prefix)}
+    return report
+
+
+def run(args, ports, duplex, size, rate, last_runs):
+    """Make one run, return its report."""
+    host, far = ports
+    if duplex == "loop":
+        links = {"loop": Link("loop", host, size)}
+        readers = [Reader(host, [links["loop"]])]
+    else:
+        links = {"h2u": Link("h2u", host, size),
+                 "u2h": Link("u2h", far, size)}
+        readers = [Reader(far, [links["h2u"]]),
+                   Reader(host, [links["u2h"]])]
+        if duplex != "full":
+            links = {duplex: links[duplex]}
+    for port in ports:
+        if port is not None:
+            port.reset_input_buffer()
+    for reader in readers:
+        reader.start()
+    senders = [threading.Thread(target=drive, args=(link, args, rate))
+               for link in links.values()]
+    for sender in senders:
+        sender.start()
+    for sender in senders:
+        sender.join()
+    for link in links.values():
+        link.wait(link.sent, args.drain)
+    for reader in readers:
+        reader.stop.set()
+    for reader in readers:
+        reader.join()
+
+    result = {"duplex": duplex, "pattern": args.pattern, "size": size,
+              "rate": rate,
+              "links": [link_report(link, args.baud)
+                        for link in links.values()],
+              "stray": sum(reader.stray for reader in readers)}
+    if args.metrics:
+        time.sleep(METRICS_WAIT_S)
+        result["target"] = target_report(args.metrics, last_runs)
+    failed = []
+    for link in result["links"]:
+        if link["sent"] and \
+                link["lost"] * 100.0 / link["sent"] > args.max_loss:
+            failed.append("%s lost %d of %d" % (link["stream"],
+                                                link["lost"], link["sent"]))
+        p99 = link.get("latency_us", {}).get("p99")
+        if args.max_p99_us is not None and \
+                (p99 is None or p99 > args.max_p99_us):
+            failed.append("%s p99 %s us" % (link["stream"], p99))
+    result["pass"] = not failed
+    if failed:
+        result["failures"] = failed
+    return result
+
+
+def summary(result, out):
+    for link in result["links"]:
+        latency = link.get("latency_us", {})
+        print("%-5s %-8s %5d B %6s/s %-4s %7d sent %6d lost %4d bad "
+              "%8.0f bit/s p50 %s p99 %s max %s us%s" % (
+                  result["duplex"], result["pattern"], result["size"],
+                  result["rate"] or "max", link["stream"], link["sent"],
+                  link["lost"], link["corrupt"],
+                  link.get("throughput_bps", 0), latency.get("p50"),
+                  latency.get("p99"), latency.get("max"),
+                  "" if result["pass"] else "  FAIL"), file=out)
+    target = result.get("target")
+    if target:
+        for _, name in TARGET_DIRS:
+            if target[name].get("samples"):
+                print("      target %s: p50 %s p99 %s p99.9 %s max %s us "
+                      "over %s" % (
+                          name, target[name].get("p50_us"),
+                          target[name].get("p99_us"),
+                          target[name].get("p999_us"),
+                          target[name].get("max_us"),
+                          target[name].get("samples")), file=out)
+
+
+def numbers(text):
+    return [int(item, 0) for item in text.split(",") if item]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", required=True,
+                        help="serial port of the host side of the bridge, "
+                        "or a pyserial URL")
+    parser.add_argument("--far-port",
+                        help="serial port wired to the UART side")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--size", type=numbers, default=[64],
+                        help="message sizes, comma separated, at least "
+                        "%d bytes" % MIN_SIZE)
+    parser.add_argument("--rate", type=numbers, default=[0],
+                        help="messages per second, comma separated, 0 "
+                        "back to back")
+    parser.add_argument("--pattern", default="stream",
+                        choices=("stream", "burst", "pingpong"))
+    parser.add_argument("--burst", type=int, default=16,
+                        help="messages of a burst")
+    parser.add_argument("--duplex",
+                        help="loop, or with --far-port h2u, u2h or full, "
+                        "comma separated")
+    parser.add_argument("--duration", type=float, default=10.0,
+                        help="seconds of a run")
+    parser.add_argument("--count", type=int, default=0,
+                        help="messages of a run, 0 for --duration only")
+    parser.add_argument("--timeout", type=float, default=1.0,
+                        help="wait for a burst or a pingpong, s")
+    parser.add_argument("--drain", type=float, default=2.0,
+                        help="wait for the last messages of a run, s")
+    parser.add_argument("--metrics",
+                        help="capture of the metrics frames of the target")
+    parser.add_argument("--max-loss", type=float, default=0.0,
+                        help="percent of the messages a run may lose")
+    parser.add_argument("--max-p99-us", type=float,
+                        help="p99 latency a run may reach")
+    parser.add_argument("--json", help="report file, - for stdout")
+    args = parser.parse_args()
+
+    duplexes = (args.duplex or ("full" if args.far_port else "loop")) \
+        .split(",")
+    for duplex in duplexes:
+        if duplex not in ("loop", "h2u", "u2h", "full") or \
+                (duplex == "loop") != (args.far_port is None):
+            parser.error("duplex %s does not go with the ports" % duplex)
+    if min(args.size) < MIN_SIZE:
+        parser.error("messages are at least %d bytes" % MIN_SIZE)
+    if args.metrics and not os.path.exists(args.metrics):
+        parser.error("no capture %s" % args.metrics)
+    try:
+        import serial
+    except ImportError:
+        sys.exit("driving the bridge needs pyserial")
+
+    out = sys.stderr if args.json == "-" else sys.stdout
+    report = {"tool": "bridge_load", "format": 1,
+              "started": datetime.datetime.now().isoformat(
+                  timespec="seconds"),
+              "config": {"port": args.port, "far_port": args.far_port,
+                         "baud": args.baud, "pattern": args.pattern,
+                         "burst": args.burst, "duration": args.duration,
+                         "count": args.count, "max_loss": args.max_loss,
+                         "max_p99_us": args.max_p99_us},
+              "runs": []}
+    host = serial.serial_for_url(args.port, args.baud, timeout=0.01)
+    far = serial.serial_for_url(args.far_port, args.baud, timeout=0.01) \
+        if args.far_port else None
+    last_runs = None
+    try:
+        for duplex in duplexes:
+            for size in args.size:
+                for rate in args.rate:
+                    time.sleep(IDLE_S)
+                    result = run(args, (host, far), duplex, size, rate,
+                                 last_runs)
+                    if result.get("target"):
+                        last_runs = result["target"]["runs"]
+                    report["runs"].append(result)
+                    summary(result, out)
+    finally:
+        host.close()
+        if far is not None:
+            far.close()
+
+    report["pass"] = all(result["pass"] for result in report["runs"])
+    if args.json:
+        text = json.dumps(report, indent=2) + "\n"
+        if args.json == "-":
+            sys.stdout.write(text)
+        else:
+            with open(args.json, "w") as stream:
+                stream.write(text)
+    sys.exit(0 if report["pass"] else 1)
+
+
+if __name__ == "__main__":
+    main()
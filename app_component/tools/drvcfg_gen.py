@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+"""Generate the static driver configuration lookups of drvcfg.h.
+
+Reads the *_g.c configuration tables of the BSP drivers, which lopper
+generates from hw/sdt/system-top.dts and pcw.dtsi, and writes a header
+that gives, for each table:
+
+    XFoo_LookupConfigStatic(BaseAddress)  the entry of a base address, or
+                                          NULL, as a chain of compares on
+                                          constants that the compiler folds
+                                          to the address of the entry
+    XFOO_CONFIG_<n>                       the address of entry n
+
+so that the configuration of a device is found at build time instead of by
+a scan of the table at startup. A section is only compiled when the
+header of its driver is included before drvcfg.h. Unlike the scan of
+some drivers, a base address of 0 matches no device.
+
+With --dts, each base address must also be the first cell of a reg
+property of the device tree files given, which catches tables older than
+the device tree they should come from.
+
+    drvcfg_gen.py ../../ARTY/ps7_cortexa9_0/standalone_ps7_cortexa9_0/bsp \\
+        --dts ../../ARTY/hw/sdt/*.dts* -o ../src/drvcfg.h
+"""
+
+import argparse
+import glob
+import os
+import re
+import sys
+
+TABLE = re.compile(r"#include\s+\"(\w+\.h)\".*?(\w+)\s+(\w+)_ConfigTable\s*\[\s*\]"
+                   r"[^=]*=\s*\{(.*)\}\s*;", re.S)
+GUARD = re.compile(r"#ifndef\s+(\w+_H)\b")
+NUMBER = re.compile(r"0x[0-9a-fA-F]+|\d+")
+REG = re.compile(r"\breg\s*=\s*<\s*(0x[0-9a-fA-F]+|\d+)")
+COMMENT = re.compile(r"/\*.*?\*/|//[^\n]*", re.S)
+
+
+def entries(body):
+    """Return the text of the top level entries of a table initializer."""
+    result = []
+    depth = 0
+    start = None
+    for index, char in enumerate(body):
+        if char == "{":
+            if depth == 0:
+                start = index + 1
+            depth += 1
+        elif char == "}":
+            depth -= 1
+            if depth == 0:
+                result.append(body[start:index])
+    return result
+
+
+def base_address(entry):
+    """Return the base address of an entry, None for the end marker."""
+    fields = [f.strip() for f in entry.split(",")]
+    if not fields or not fields[0].startswith('"'):
+        return None
+    for field in fields[1:]:
+        if NUMBER.fullmatch(field):
+            return int(field, 0)
+    return None
+
+
+def read_tables(bsp):
+    """Return (driver header, guard, prefix, type, bases) per table."""
+    tables = []
+    pattern = os.path.join(bsp, "libsrc", "*", "src", "*_g.c")
+    for path in sorted(glob.glob(pattern)):
+        with open(path) as f:
+            text = COMMENT.sub("", f.read())
+        match = TABLE.search(text)
+        if not match:
+            continue
+        header, ctype, prefix, body = match.groups()
+        bases = [base_address(e) for e in entries(body)]
+        bases = [b for b in bases if b is not None]
+        if not bases:
+            continue
+        candidates = [os.path.join(os.path.dirname(path), header),
+                      os.path.join(bsp, "include", header)]
+        found = [c for c in candidates if os.path.exists(c)]
+        if not found:
+            # A driver without a public header has no lookup to replace
+            continue
+        with open(found[0]) as f:
+            guard = GUARD.search(f.read())
+        if not guard:
+            sys.exit("%s: no include guard" % header)
+        tables.append((header, guard.group(1), prefix, ctype, bases))
+    return tables
+
+
+def read_regs(paths):
+    """Return the first cells of the reg properties of device tree files."""
+    regs = set()
+    for path in paths:
+        with open(path) as f:
+            for value in REG.findall(COMMENT.sub("", f.read())):
+                regs.add(int(value, 0))
+    return regs
+
+
+def emit(tables, out):
+    """Write the header."""
+    out.write("""\
+/******************************************************************************
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/****************************************************************************/
+/**
+*
+* @file drvcfg.h
+*
+* Generated by tools/drvcfg_gen.py from the configuration tables of the BSP,
+* do not edit. Include it after the headers of the drivers.
+*
+*****************************************************************************/
+
+#ifndef DRVCFG_H
+#define DRVCFG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "xil_types.h"
+""")
+    for header, guard, prefix, ctype, bases in tables:
+        upper = prefix.upper()
+        out.write("\n/* %s */\n#ifdef %s\n" % (header, guard))
+        out.write("extern %s %s_ConfigTable[];\n\n" % (ctype, prefix))
+        for index in range(len(bases)):
+            out.write("#define %s_CONFIG_%d\t(&%s_ConfigTable[%d])\n"
+                      % (upper, index, prefix, index))
+        out.write("\nstatic inline %s *%s_LookupConfigStatic(UINTPTR "
+                  "BaseAddress)\n{\n" % (ctype, prefix))
+        for index, base in enumerate(bases):
+            out.write("\tif (BaseAddress == 0x%08xU) {\n\t\treturn "
+                      "%s_CONFIG_%d;\n\t}\n" % (base, upper, index))
+        out.write("\treturn NULL;\n}\n#endif\n")
+    out.write("""
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DRVCFG_H */
+""")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("bsp", help="BSP directory, holding libsrc")
+    parser.add_argument("--dts", nargs="*", default=[],
+                        help="device tree files the tables must match")
+    parser.add_argument("-o", "--output", default="-",
+                        help="header to write, - for standard output")
+    args = parser.parse_args()
+
+    tables = read_tables(args.bsp)
+    if not tables:
+        sys.exit("%s: no configuration tables" % args.bsp)
+
+    if args.dts:
+        regs = read_regs(args.dts)
+        for header, _, prefix, _, bases in tables:
+            for base in bases:
+                if base not in regs:
+                    sys.exit("%s_ConfigTable: 0x%08x is in no reg of the "
+                             "device tree" % (prefix, base))
+
+    if args.output == "-":
+        emit(tables, sys.stdout)
+    else:
+        with open(args.output, "w") as out:
+            emit(tables, out)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,334 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+"""Make and apply the boot image deltas of image_slot.h.
+
+make writes the delta that turns the image of the active slot, the
+BOOT.BIN the unit runs, into a new one, and prints its size and transfer
+time on the UART beside that of the image. Matches of the old image are
+found at any offset through a table of its 16-byte strings on 4-byte
+steps, extended both ways, and sent as COPY. The bytes between two matches
+are sent as ADD when they mostly equal the old ones at the offset of the
+match before, bsdiff style, as FILL for runs of one byte and as DATA
+otherwise. The operations go in chunks compressed as LZ4 blocks, where
+the differences of ADD, mostly zero, take little. The delta is applied
+again before it is written, to check it.
+
+apply builds the new image from the old one and a delta, as the unit does.
+
+    image_delta.py make old/BOOT.BIN new/BOOT.BIN -o update.dlt
+    image_delta.py apply old/BOOT.BIN update.dlt -o check.bin
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+
+MAGIC = 0x544C4544
+VERSION = 1
+HEADER = struct.Struct("<IHHIIIIII")
+CHUNK = struct.Struct("<II")
+OP = struct.Struct("<II")
+CHUNK_MAX = 0xFFFF
+CHUNK_LZ4 = 0x80000000
+COPY, ADD, DATA, FILL = range(4)
+SHIFT = 30
+LENGTH_MASK = (1 << SHIFT) - 1
+
+KEY = 16            # Bytes of the strings of the table
+STEP = 4            # Offsets of the old image in the table
+MIN_COPY = 24       # Shorter matches are not worth an operation
+MIN_FILL = 32
+ADD_EQUAL = 0.5     # Share of equal bytes for ADD
+
+
+def lz4_compress(src):
+    """Return the LZ4 block of src, greedy with a table of 4-byte strings."""
+    out = bytearray()
+
+    def length(value):
+        while value >= 255:
+            out.append(255)
+            value -= 255
+        out.append(value)
+
+    def sequence(literals, offset, match):
+        token = min(len(literals), 15) << 4
+        if match:
+            token |= min(match - 4, 15)
+        out.append(token)
+        if len(literals) >= 15:
+            length(len(literals) - 15)
+        out.extend(literals)
+        if match:
+            out.extend(struct.pack("<H", offset))
+            if match - 4 >= 15:
+                length(match - 19)
+
+    size = len(src)
+    table = {}
+    anchor = pos = 0
+    while pos < size - 12:
+        key = src[pos:pos + 4]
+        cand = table.get(key)
+        table[key] = pos
+        if cand is None or pos - cand > 0xFFFF:
+            pos += 1
+            continue
+        match = 4
+        while pos + match < size - 5 and src[cand + match] == src[pos + match]:
+            match += 1
+        sequence(src[anchor:pos], pos - cand, match)
+        pos += match
+        anchor = pos
+    sequence(src[anchor:], 0, 0)
+    return bytes(out)
+
+
+def lz4_decompress(src, size):
+    """Return the data of an LZ4 block, of size bytes."""
+    out = bytearray()
+    pos = 0
+
+    def length(value):
+        nonlocal pos
+        if value == 15:
+            while True:
+                byte = src[pos]
+                pos += 1
+                value += byte
+                if byte != 255:
+                    break
+        return value
+
+    while pos < len(src):
+        token = src[pos]
+        pos += 1
+        count = length(token >> 4)
+        out.extend(src[pos:pos + count])
+        pos += count
+        if pos >= len(src):
+            break
+        offset, = struct.unpack_from("<H", src, pos)
+        pos += 2
+        match = length(token & 15) + 4
+        if offset == 0 or offset > len(out):
+            sys.exit("bad LZ4 offset")
+        for _ in range(match):
+            out.append(out[-offset])
+    if len(out) != size:
+        sys.exit("LZ4 block of %d bytes, %d expected" % (len(out), size))
+    return bytes(out)
+
+
+def literal_ops(old, new, start, end, delta):
+    """Return the operations of new[start:end], between matches."""
+    ops = []
+    pos = start
+    while pos < end:
+        run = pos
+        while run < end and new[run] == new[pos]:
+            run += 1
+        if run - pos >= MIN_FILL:
+            ops.append((FILL, pos, run - pos, new[pos]))
+            pos = run
+            continue
+        # Up to the next run worth a FILL
+        stop = pos
+        while stop < end:
+            run = stop
+            while run < end and new[run] == new[stop] and run - stop < MIN_FILL:
+                run += 1
+            if run - stop >= MIN_FILL:
+                break
+            stop = run
+        src = pos + delta
+        if delta is not None and 0 <= src and src + stop - pos <= len(old):
+            equal = sum(1 for i in range(stop - pos)
+                        if old[src + i] == new[pos + i])
+            if equal >= ADD_EQUAL * (stop - pos):
+                ops.append((ADD, pos, stop - pos, src))
+                pos = stop
+                continue
+        ops.append((DATA, pos, stop - pos, 0))
+        pos = stop
+    return ops
+
+
+def make_ops(old, new):
+    """Return the operations (op, target offset, length, arg) of a delta."""
+    table = {}
+    for pos in range(0, len(old) - KEY + 1, STEP):
+        table.setdefault(old[pos:pos + KEY], pos)
+
+    ops = []
+    literal = 0
+    delta = None
+    pos = 0
+    while pos + KEY <= len(new):
+        src = None
+        if delta is not None and 0 <= pos + delta <= len(old) - KEY and \
+                old[pos + delta:pos + delta + KEY] == new[pos:pos + KEY]:
+            src = pos + delta
+        else:
+            src = table.get(new[pos:pos + KEY])
+        if src is None:
+            pos += 1
+            continue
+        end = pos + KEY
+        while end < len(new) and src + end - pos < len(old) and \
+                new[end] == old[src + end - pos]:
+            end += 1
+        start = pos
+        while start > literal and src - (pos - start) > 0 and \
+                new[start - 1] == old[src - (pos - start) - 1]:
+            start -= 1
+        if end - start < MIN_COPY:
+            pos += 1
+            continue
+        ops.extend(literal_ops(old, new, literal, start, delta))
+        ops.append((COPY, start, end - start, src - (pos - start)))
+        delta = src - pos
+        literal = pos = end
+    ops.extend(literal_ops(old, new, literal, len(new), delta))
+    return ops
+
+
+def pack(old, new, ops):
+    """Return the chunks of a delta, ops split to fit them."""
+    chunks = []
+    raw = bytearray()
+
+    def close():
+        if raw:
+            packed = lz4_compress(bytes(raw))
+            if len(packed) < len(raw):
+                chunks.append(CHUNK.pack(len(packed) | CHUNK_LZ4, len(raw)) +
+                              packed)
+            else:
+                chunks.append(CHUNK.pack(len(raw), len(raw)) + bytes(raw))
+            raw.clear()
+
+    for op, pos, length, arg in ops:
+        while length > 0:
+            room = CHUNK_MAX - len(raw) - OP.size
+            if room < 64:
+                close()
+                continue
+            count = length if op in (COPY, FILL) else min(length, room)
+            raw.extend(OP.pack((op << SHIFT) | count, arg))
+            if op == ADD:
+                raw.extend((new[pos + i] - old[arg + i]) & 0xFF
+                           for i in range(count))
+            elif op == DATA:
+                raw.extend(new[pos:pos + count])
+            pos += count
+            length -= count
+            if op in (COPY, ADD):
+                arg += count
+    close()
+    return b"".join(chunks)
+
+
+def apply(old, delta):
+    """Return the image a delta builds from old, after its checks."""
+    if len(delta) < HEADER.size:
+        sys.exit("delta truncated")
+    fields = HEADER.unpack_from(delta, 0)
+    magic, version, _, src_size, src_crc, size, crc, patch_size, hcrc = fields
+    if magic != MAGIC or version != VERSION:
+        sys.exit("not a delta of version %d" % VERSION)
+    if zlib.crc32(delta[:HEADER.size - 4]) != hcrc:
+        sys.exit("delta header damaged")
+    if len(old) < src_size or zlib.crc32(old[:src_size]) != src_crc:
+        sys.exit("the delta is not one of this image")
+    if HEADER.size + patch_size != len(delta):
+        sys.exit("delta of %d bytes, %d expected" %
+                 (len(delta), HEADER.size + patch_size))
+    out = bytearray()
+    pos = HEADER.size
+    while pos < len(delta):
+        stored, raw_size = CHUNK.unpack_from(delta, pos)
+        pos += CHUNK.size
+        data = delta[pos:pos + (stored & ~CHUNK_LZ4)]
+        pos += stored & ~CHUNK_LZ4
+        raw = lz4_decompress(data, raw_size) if stored & CHUNK_LZ4 else data
+        at = 0
+        while at < len(raw):
+            word, arg = OP.unpack_from(raw, at)
+            at += OP.size
+            op, length = word >> SHIFT, word & LENGTH_MASK
+            if op == COPY:
+                out.extend(old[arg:arg + length])
+            elif op == ADD:
+                out.extend((old[arg + i] + raw[at + i]) & 0xFF
+                           for i in range(length))
+                at += length
+            elif op == DATA:
+                out.extend(raw[at:at + length])
+                at += length
+            else:
+                out.extend(bytes([arg & 0xFF]) * length)
+    if len(out) != size or zlib.crc32(out) != crc:
+        sys.exit("the delta builds a wrong image")
+    return bytes(out)
+
+
+def make(old, new):
+    """Return the delta from old to new."""
+    ops = make_ops(old, new)
+    body = pack(old, new, ops)
+    head = HEADER.pack(MAGIC, VERSION, 0, len(old), zlib.crc32(old), len(new),
+                       zlib.crc32(new), len(body), 0)
+    head = head[:-4] + struct.pack("<I", zlib.crc32(head[:-4]))
+    counts = {}
+    for op, _, length, _ in ops:
+        counts[op] = counts.get(op, 0) + length
+    return head + body, counts
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = parser.add_subparsers(dest="command", required=True)
+    cmd = sub.add_parser("make", help="delta from OLD to NEW")
+    cmd.add_argument("old")
+    cmd.add_argument("new")
+    cmd.add_argument("-o", "--output", required=True)
+    cmd.add_argument("-b", "--baud", type=int, default=115200,
+                     help="UART rate of the times printed")
+    cmd = sub.add_parser("apply", help="image of OLD and DELTA")
+    cmd.add_argument("old")
+    cmd.add_argument("delta")
+    cmd.add_argument("-o", "--output", required=True)
+    args = parser.parse_args()
+
+    with open(args.old, "rb") as f:
+        old = f.read()
+
+    if args.command == "apply":
+        with open(args.delta, "rb") as f:
+            new = apply(old, f.read())
+        with open(args.output, "wb") as f:
+            f.write(new)
+        return
+
+    with open(args.new, "rb") as f:
+        new = f.read()
+    delta, counts = make(old, new)
+    if apply(old, delta) != new:
+        sys.exit("the delta does not build the new image")
+    with open(args.output, "wb") as f:
+        f.write(delta)
+
+    names = ("copy", "add", "data", "fill")
+    print("image %d bytes, delta %d bytes, %.1f%%" %
+          (len(new), len(delta), 100.0 * len(delta) / max(len(new), 1)))
+    print("  " + ", ".join("%s %d" % (names[op], counts.get(op, 0))
+                           for op in range(4)))
+    seconds = 10.0 / args.baud
+    print("at %d baud: image %.1f s, delta %.1f s" %
+          (args.baud, len(new) * seconds, len(delta) * seconds))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,206 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+"""Decode the metrics frames of metrics.h.
+
+Reads the frames captured from the sink of the registry, e.g. the DCC log
+through the debugger or a UART channel, checks their CRC-32 and keeps the
+absolute value of every metric: a data frame adds its increments to those
+of the last key frame. Until the first names and key frames the metrics
+are unknown and their frames are skipped. Prints a line per frame with the
+metrics it changed, or with --csv a CSV row per frame of all the metrics.
+
+    metrics_decode.py capture.bin
+    xsdb -eval "jtagterminal -socket" | metrics_decode.py - --csv
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+
+FRAME_DATA = 1
+FRAME_KEY = 2
+FRAME_NAMES = 3
+
+COUNTER = 0
+COUNTER64 = 1
+GAUGE = 2
+GAUGE_FN = 3
+HISTOGRAM = 4
+HIST_BUCKETS = 16
+HEADER = struct.Struct("<BBI")
+
+
+def frames(stream):
+    """Yield the COBS decoded frames of stream, delimited by 0x00."""
+    pending = bytearray()
+    while True:
+        chunk = stream.read(4096)
+        if not chunk:
+            break
+        pending += chunk
+        while True:
+            end = pending.find(b"\x00")
+            if end < 0:
+                break
+            encoded, pending = bytes(pending[:end]), pending[end + 1:]
+            if encoded:
+                yield cobs_decode(encoded)
+
+
+def cobs_decode(encoded):
+    """Return the bytes of a COBS block, or None if it is malformed."""
+    out = bytearray()
+    index = 0
+    while index < len(encoded):
+        code = encoded[index]
+        if code == 0 or index + code > len(encoded) + 1:
+            return None
+        out += encoded[index + 1:index + code]
+        index += code
+        if code != 0xFF and index < len(encoded):
+            out.append(0)
+    return bytes(out)
+
+
+def varint(data, offset):
+    """Return the LEB128 value at offset and the offset after it."""
+    value = shift = 0
+    while True:
+        if offset >= len(data):
+            raise ValueError("truncated varint")
+        byte = data[offset]
+        value |= (byte & 0x7F) << shift
+        offset += 1
+        shift += 7
+        if not byte & 0x80:
+            return value, offset
+
+
+def zigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+class Registry:
+    """Names, types and absolute values of the metrics."""
+
+    def __init__(self):
+        self.names = {}
+        self.types = {}
+        self.shifts = {}
+        self.values = {}
+        self.synced = False
+
+    def names_frame(self, body):
+        offset = 0
+        while offset + 4 <= len(body):
+            index, kind, shift, length = body[offset:offset + 4]
+            name = body[offset + 4:offset + 4 + length]
+            self.names[index] = name.decode("ascii", "replace")
+            self.types[index] = kind
+            self.shifts[index] = shift
+            offset += 4 + length
+
+    def value_frame(self, key, body):
+        """Apply a data or key frame, return the indexes it changed."""
+        changed = []
+        offset = 0
+        while offset < len(body):
+            index, offset = varint(body, offset)
+            if index not in self.types:
+                raise ValueError("metric %d has no name yet" % index)
+            kind = self.types[index]
+            if kind == HISTOGRAM:
+                mask, offset = varint(body, offset)
+                buckets = self.values.get(index, [0] * HIST_BUCKETS)
+                if key:
+                    buckets = [0] * HIST_BUCKETS
+                for bucket in range(HIST_BUCKETS):
+                    if mask & (1 << bucket):
+                        count, offset = varint(body, offset)
+                        buckets[bucket] = count if key else \
+                            (buckets[bucket] + count) & 0xFFFFFFFF
+                self.values[index] = buckets
+            else:
+                value, offset = varint(body, offset)
+                if kind in (GAUGE, GAUGE_FN):
+                    self.values[index] = zigzag(value)
+                elif key:
+                    self.values[index] = value
+                else:
+                    width = 0xFFFFFFFF if kind == COUNTER else \
+                        0xFFFFFFFFFFFFFFFF
+                    self.values[index] = \
+                        (self.values.get(index, 0) + value) & width
+            changed.append(index)
+        return changed
+
+    def render(self, index):
+        value = self.values.get(index)
+        if self.types[index] != HISTOGRAM or value is None:
+            return str(value)
+        shift = self.shifts[index]
+        return "{%s}" % " ".join(
+            "<%d:%d" % (1 << (shift + bucket), count) if bucket <
+            HIST_BUCKETS - 1 else ">=%d:%d" % (1 << (shift + bucket - 1),
+                                               count)
+            for bucket, count in enumerate(value) if count)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", help="captured frames, - for stdin")
+    parser.add_argument("--csv", action="store_true",
+                        help="a CSV row of all the metrics per frame")
+    args = parser.parse_args()
+
+    stream = sys.stdin.buffer if args.capture == "-" else \
+        open(args.capture, "rb")
+    registry = Registry()
+    header = None
+    bad = lost = 0
+    seq = None
+    for frame in frames(stream):
+        if frame is None or len(frame) < HEADER.size + 4 or \
+                zlib.crc32(frame[:-4]) != \
+                struct.unpack_from("<I", frame, len(frame) - 4)[0]:
+            bad += 1
+            continue
+        kind, number, ms = HEADER.unpack_from(frame)
+        body = frame[HEADER.size:-4]
+        if seq is not None and number != (seq + 1) & 0xFF:
+            lost += (number - seq - 1) & 0xFF
+            if kind == FRAME_DATA:
+                registry.synced = False
+        seq = number
+        if kind == FRAME_NAMES:
+            registry.names_frame(body)
+            continue
+        if kind == FRAME_DATA and not registry.synced:
+            continue
+        try:
+            changed = registry.value_frame(kind == FRAME_KEY, body)
+        except ValueError as error:
+            print("frame %d: %s" % (number, error), file=sys.stderr)
+            registry.synced = False
+            continue
+        registry.synced = True
+        if args.csv:
+            order = sorted(registry.names)
+            if header != order:
+                header = order
+                print("time_s," + ",".join(registry.names[i]
+                                           for i in order))
+            print("%.3f," % (ms / 1000.0) +
+                  ",".join(registry.render(i) for i in order))
+        else:
+            print("%10.3f %s %s" % (
+                ms / 1000.0, "K" if kind == FRAME_KEY else "D",
+                " ".join("%s=%s" % (registry.names[i], registry.render(i))
+                         for i in changed)))
+    if bad or lost:
+        print("%d bad frames, %d lost" % (bad, lost), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
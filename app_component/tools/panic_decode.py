@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+"""Decode a panic dump of panic_dump.h or of the FSBL, fsbl_panic.h.
+
+Reads the dump file of the application, copied from the SD card, or the
+region of the QSPI flash the FSBL writes to, read back with the flash
+programming tools. Checks the dump and prints its header, the registers
+of the failed mode with the fault status decoded, and each block in
+hexadecimal words with their addresses. With -x, each block is also
+written to a file of its own in the directory given, the event trace as
+trace.bin for trace_export.py.
+
+    panic_decode.py PANIC.BIN
+    panic_decode.py flash_panic.bin -x dump/
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = 0x43494E50
+BODY_OFFSET = 256
+HEADER = struct.Struct("<IHHIIIIQ16I")
+BLOCK = struct.Struct("<III")
+
+SOURCES = {1: "FSBL", 2: "application"}
+REASONS = {1: "undefined instruction", 2: "prefetch abort", 3: "data abort",
+           4: "assertion"}
+FSBL_REASONS = {0xA301: "undefined instruction", 0xA302: "SVC",
+                0xA303: "prefetch abort", 0xA304: "data abort",
+                0xA305: "IRQ", 0xA306: "FIQ"}
+REGS = ["cpsr", "spsr", "sp", "lr", "fault pc", "dfsr", "dfar", "ifsr",
+        "ifar", "sys sp", "sys lr", "r0", "r1", "r2", "r3", "r12"]
+MODES = {0x10: "usr", 0x11: "fiq", 0x12: "irq", 0x13: "svc", 0x17: "abt",
+         0x1B: "und", 0x1F: "sys"}
+BLOCKS = {1: ("exception stack", "exc_stack.bin"),
+          2: ("main stack", "sys_stack.bin"),
+          3: ("boot timeline", "timeline.bin"),
+          4: ("event trace", "trace.bin"),
+          5: ("counters", "stats.bin"),
+          6: ("assertion", "assert.bin")}
+# Short descriptor format fault status, FS[10] and FS[3:0]
+FAULTS = {0x01: "alignment", 0x04: "instruction cache maintenance",
+          0x0C: "translation table walk, 1st level",
+          0x0E: "translation table walk, 2nd level",
+          0x05: "translation, section", 0x07: "translation, page",
+          0x03: "access flag, section", 0x06: "access flag, page",
+          0x09: "domain, section", 0x0B: "domain, page",
+          0x0D: "permission, section", 0x0F: "permission, page",
+          0x08: "synchronous external abort",
+          0x406: "asynchronous external abort",
+          0x02: "debug event"}
+
+
+def fault(status):
+    """Return the text of a DFSR or IFSR value."""
+    code = (status & 0xF) | ((status >> 6) & 0x10) << 6
+    text = FAULTS.get(code, "fault status 0x%03x" % code)
+    if status & (1 << 11):
+        text += ", write"
+    return text
+
+
+def parse(data):
+    """Return (header fields, [(tag, address, data)]) of a dump."""
+    if len(data) < HEADER.size:
+        sys.exit("dump truncated, %d bytes" % len(data))
+    fields = HEADER.unpack_from(data, 0)
+    magic, version, source, length, checksum = fields[:5]
+    if magic == 0xFFFFFFFF:
+        sys.exit("no dump, the region is erased")
+    if magic != MAGIC:
+        sys.exit("not a panic dump, magic 0x%08x" % magic)
+    if version != 1:
+        sys.exit("dump version %d not known" % version)
+    if length > len(data) or length < BODY_OFFSET:
+        sys.exit("dump of %d bytes, %d read" % (length, len(data)))
+    words = struct.unpack_from("<%dI" % ((length - BODY_OFFSET) // 4), data,
+                               BODY_OFFSET)
+    if sum(words) & 0xFFFFFFFF != checksum:
+        print("warning: checksum mismatch, the dump is damaged")
+    blocks = []
+    offset = BODY_OFFSET
+    for _ in range(fields[6]):
+        tag, address, size = BLOCK.unpack_from(data, offset)
+        offset += BLOCK.size
+        blocks.append((tag, address, data[offset:offset + size]))
+        offset += (size + 3) & ~3
+    return fields, blocks
+
+
+def print_header(fields):
+    """Print the header and the registers of a dump."""
+    _, version, source, length, _, reason, num_blocks, time = fields[:8]
+    regs = fields[8:]
+    names = FSBL_REASONS if source == 1 else REASONS
+    if source == 1 and reason not in names:
+        why = "FSBL status 0x%04x" % reason
+    else:
+        why = names.get(reason, "reason 0x%x" % reason)
+    print("%s panic: %s" % (SOURCES.get(source, "unknown"), why))
+    print("time %d, %d bytes, %d blocks" % (time, length, num_blocks))
+    for index, name in enumerate(REGS):
+        value = regs[index]
+        note = ""
+        if name in ("cpsr", "spsr") and value:
+            note = " (%s%s)" % (MODES.get(value & 0x1F, "?"),
+                                ", thumb" if value & 0x20 else "")
+        elif name in ("dfsr", "ifsr") and value:
+            note = " (%s)" % fault(value)
+        print("  %-8s 0x%08x%s" % (name, value, note))
+
+
+def print_block(tag, address, data):
+    """Print a block in hexadecimal words."""
+    name = BLOCKS.get(tag, ("block %d" % tag, None))[0]
+    print("%s at 0x%08x, %d bytes" % (name, address, len(data)))
+    if tag == 6 and len(data) >= 4:
+        line, = struct.unpack_from("<I", data, 0)
+        print("  %s:%d" % (data[4:].split(b"\0")[0].decode("latin-1"), line))
+        return
+    words = struct.unpack_from("<%dI" % (len(data) // 4), data, 0)
+    for index in range(0, len(words), 4):
+        print("  %08x: %s" % (address + index * 4,
+                              " ".join("%08x" % w
+                                       for w in words[index:index + 4])))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dump", help="dump file of the SD card or the flash")
+    parser.add_argument("-x", "--extract", metavar="DIR",
+                        help="write each block to a file in DIR")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as f:
+        data = f.read()
+    fields, blocks = parse(data)
+    print_header(fields)
+    for tag, address, block in blocks:
+        print_block(tag, address, block)
+
+    if args.extract:
+        os.makedirs(args.extract, exist_ok=True)
+        for index, (tag, _, block) in enumerate(blocks):
+            name = BLOCKS.get(tag, (None, "block%d_%x.bin" % (index, tag)))[1]
+            with open(os.path.join(args.extract, name), "wb") as f:
+                f.write(block)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+"""Report the PC samples of pc_prof.h per function.
+
+Reads the standard output captured from the target, finds the histograms
+printed by PcProf_Dump() and maps their bins to the functions of the
+application ELF file. A bin wider than an instruction is charged to the
+function its first byte belongs to. The last histogram of each CPU is
+reported.
+
+    pc_prof_report.py app.elf capture.txt
+    cat /dev/ttyUSB1 | pc_prof_report.py app.elf - --top 20
+"""
+
+import argparse
+import bisect
+import re
+import struct
+import sys
+
+HEADER = re.compile(r"PCPROF ([0-9a-f]+) ([0-9a-f]+) ([0-9a-f]+) ([0-9a-f]+) "
+                    r"([0-9a-f]+) ([0-9a-f]+) ([0-9a-f]+)")
+BIN = re.compile(r"([0-9a-f]+) ([0-9a-f]+)$")
+STT_FUNC = 2
+
+
+def read_functions(path):
+    """Return the (address, size, name) of the functions of an ELF file."""
+    with open(path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF" or elf[4] != 1:
+        sys.exit("%s: not a 32-bit ELF file" % path)
+    order = "<" if elf[5] == 1 else ">"
+    shoff, = struct.unpack_from(order + "I", elf, 0x20)
+    shentsize, shnum = struct.unpack_from(order + "HH", elf, 0x2E)
+    headers = [struct.unpack_from(order + "IIIIIIIIII", elf,
+                                  shoff + i * shentsize)
+               for i in range(shnum)]
+    functions = []
+    for hdr in headers:
+        if hdr[1] != 2:     # SHT_SYMTAB
+            continue
+        strtab = headers[hdr[6]]
+        names = elf[strtab[4]:strtab[4] + strtab[5]]
+        for pos in range(hdr[4], hdr[4] + hdr[5], 16):
+            name, value, size, info = struct.unpack_from(order + "IIIB",
+                                                         elf, pos)
+            if info & 0xF != STT_FUNC or value == 0:
+                continue
+            end = names.index(b"\0", name)
+            functions.append((value & ~1, size,
+                              names[name:end].decode("latin-1")))
+    if not functions:
+        sys.exit("%s: no function symbols" % path)
+    functions.sort()
+    return functions
+
+
+def read_histograms(stream):
+    """Return {cpu: (header fields, {bin: count})} of the last dumps."""
+    histograms = {}
+    current = None
+    for line in stream:
+        line = line.strip()
+        if line == "PCPROF END":
+            if current is not None:
+                histograms[current[0][0]] = current
+            current = None
+            continue
+        match = HEADER.search(line)
+        if match:
+            current = ([int(field, 16) for field in match.groups()], {})
+            continue
+        match = BIN.match(line)
+        if current is not None and match:
+            current[1][int(match.group(1), 16)] = int(match.group(2), 16)
+    if not histograms:
+        sys.exit("no complete PCPROF histogram in the capture")
+    return histograms
+
+
+def function_samples(functions, fields, bins):
+    """Return {function or "<pc>": samples} of one histogram."""
+    low_pc, shift = fields[1], fields[2]
+    starts = [function[0] for function in functions]
+    counts = {}
+    for index, count in bins.items():
+        pc = low_pc + (index << shift)
+        pos = bisect.bisect_right(starts, pc) - 1
+        if pos >= 0 and pc < functions[pos][0] + max(functions[pos][1], 4):
+            key = functions[pos]
+        else:
+            key = "<0x%08x>" % pc
+        counts[key] = counts.get(key, 0) + count
+    return counts
+
+
+def report(functions, fields, bins, top, out):
+    """Print the samples per function of one histogram."""
+    cpu, _, shift, _, samples, outside, rate = fields
+    counts = {}
+    for key, count in function_samples(functions, fields, bins).items():
+        name = key if isinstance(key, str) else key[2]
+        counts[name] = counts.get(name, 0) + count
+
+    total = max(samples, 1)
+    out.write("CPU%d: %d samples at %d Hz, %d outside .text, "
+              "%d byte bins\n" % (cpu, samples, rate, outside, 1 << shift))
+    out.write("%10s %7s  %s\n" % ("samples", "%", "function"))
+    ranked = sorted(counts.items(), key=lambda item: (-item[1], item[0]))
+    for name, count in ranked[:top]:
+        out.write("%10d %6.2f%%  %s\n" % (count, 100.0 * count / total,
+                                          name))
+    if outside:
+        out.write("%10d %6.2f%%  <outside .text>\n" %
+                  (outside, 100.0 * outside / total))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="application ELF file")
+    parser.add_argument("capture", help="captured output, - for stdin")
+    parser.add_argument("--top", type=int, default=40,
+                        help="functions to list")
+    args = parser.parse_args()
+
+    functions = read_functions(args.elf)
+    if args.capture == "-":
+        stream = sys.stdin
+    else:
+        stream = open(args.capture, "r", errors="replace")
+    with stream:
+        histograms = read_histograms(stream)
+    for cpu in sorted(histograms):
+        fields, bins = histograms[cpu]
+        report(functions, fields, bins, args.top, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+"""Extract the .gcda files of a profile dumped by pgo.h.
+
+Reads Pgo_Stream read over JTAG with mrd -bin, or the standard output
+captured from the target with the stream printed by Pgo_Dump(), the last
+complete stream then being taken. Writes each .gcda file of the stream,
+under the name the compiler gave it with -fprofile-generate, replacing the
+file of an earlier run; -p and -s relocate them like GCOV_PREFIX and
+GCOV_PREFIX_STRIP do. With --stream, the stream is written to the
+standard output in the format of gcov-tool merge-stream instead, for the
+counters to be added to those of the earlier runs. -l lists the files.
+
+    pgo_extract.py pgo.bin
+    pgo_extract.py capture.txt -p /tmp/profile -s 3
+    pgo_extract.py pgo.bin --stream | gcov-tool merge-stream
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+MAGIC = 0x4F47504F
+HEADER = struct.Struct("<III")
+GCDA_MAGIC = 0x67636461
+GCFN_MAGIC = 0x6763666E
+BEGIN = re.compile(r"PGO ([0-9a-f]+) ([0-9a-f]+)$")
+WORDS = re.compile(r"[0-9a-f]{8}( [0-9a-f]{8})*$")
+
+
+def read_binary(data):
+    """Return the stream of a Pgo_Stream read over JTAG."""
+    if len(data) < HEADER.size:
+        sys.exit("dump truncated, %d bytes" % len(data))
+    magic, length, dumps = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        sys.exit("no complete dump, magic 0x%08x" % magic)
+    if HEADER.size + length > len(data):
+        sys.exit("stream of %d bytes, %d read" %
+                 (length, len(data) - HEADER.size))
+    sys.stderr.write("dump %d, %d bytes\n" % (dumps, length))
+    return data[HEADER.size:HEADER.size + length]
+
+
+def read_capture(text):
+    """Return the last complete stream printed in a capture."""
+    stream = None
+    current = None
+    for line in text.splitlines():
+        line = line.strip()
+        if line == "PGO END":
+            if current is not None and len(current[2]) == current[0]:
+                stream = current
+            current = None
+            continue
+        match = BEGIN.match(line)
+        if match:
+            current = (int(match.group(1), 16), int(match.group(2), 16),
+                       bytearray())
+            continue
+        if current is not None and WORDS.match(line):
+            for word in line.split():
+                current[2].extend(struct.pack("<I", int(word, 16)))
+    if stream is None:
+        sys.exit("no complete PGO stream in the capture")
+    sys.stderr.write("dump %d, %d bytes\n" % (stream[1], stream[0]))
+    return bytes(stream[2])
+
+
+def parse(stream):
+    """Return the [(file name, .gcda contents)] of a stream."""
+    files = []
+    offset = 0
+    while offset < len(stream):
+        if offset + 4 > len(stream):
+            sys.exit("stream truncated at %d" % offset)
+        name_bytes, = struct.unpack_from("<I", stream, offset)
+        offset += 4
+        name = stream[offset:offset + name_bytes].rstrip(b"\0").decode()
+        offset += (name_bytes + 3) & ~3
+        if offset + 4 > len(stream):
+            sys.exit("stream truncated at %d" % offset)
+        data_bytes, = struct.unpack_from("<I", stream, offset)
+        offset += 4
+        data = stream[offset:offset + data_bytes]
+        offset += (data_bytes + 3) & ~3
+        if len(data) != data_bytes:
+            sys.exit("%s: truncated" % name)
+        if struct.unpack_from("<I", data, 0)[0] != GCDA_MAGIC:
+            sys.exit("%s: not a .gcda file" % name)
+        files.append((name, data))
+    return files
+
+
+def relocate(name, prefix, strip):
+    """Return the file name after GCOV_PREFIX and GCOV_PREFIX_STRIP."""
+    if not prefix:
+        return name
+    parts = name.split("/")
+    if parts and parts[0] == "":
+        parts = parts[1:]
+    return os.path.join(prefix, *parts[strip:])
+
+
+def write_stream(files, out):
+    """Write the files in the input format of gcov-tool merge-stream."""
+    for name, data in files:
+        encoded = name.encode() + b"\0"
+        version, = struct.unpack_from("<I", data, 4)
+        out.write(struct.pack("<III", GCFN_MAGIC, version, len(encoded)))
+        out.write(encoded)
+        out.write(data)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dump", help="JTAG dump or captured output, "
+                        "- for stdin")
+    parser.add_argument("-p", "--prefix", help="directory to write to")
+    parser.add_argument("-s", "--strip", type=int, default=0,
+                        help="leading directories of the names to drop")
+    parser.add_argument("-l", "--list", action="store_true",
+                        help="only list the files")
+    parser.add_argument("--stream", action="store_true",
+                        help="write the gcov-tool merge-stream input")
+    args = parser.parse_args()
+
+    if args.dump == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.dump, "rb") as f:
+            data = f.read()
+    if data[:4] == struct.pack("<I", MAGIC) or b"PGO " not in data:
+        stream = read_binary(data)
+    else:
+        stream = read_capture(data.decode(errors="replace"))
+    files = parse(stream)
+
+    if args.stream:
+        write_stream(files, sys.stdout.buffer)
+        return
+    for name, data in files:
+        path = relocate(name, args.prefix, args.strip)
+        print("%8d  %s" % (len(data), path))
+        if args.list:
+            continue
+        directory = os.path.dirname(path)
+        if directory:
+            os.makedirs(directory, exist_ok=True)
+        with open(path, "wb") as f:
+            f.write(data)
+
+
+if __name__ == "__main__":
+    main()
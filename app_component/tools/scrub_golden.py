@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+"""Make the golden table of the PL configuration scrubber of pl_scrub.h.
+
+The frames of the design and their frame addresses are taken from its
+bitstream, which must give the address of each frame: write it with
+-g DebugBitstream:Yes, where the address of each frame is written to LOUT
+after it, or -g PerFrameCRC:Yes, where it is written to FAR before it. A
+plain bitstream writes all the frames at once from the first address, and
+the addresses of the others, past the pad frames of each row, are not
+known; it is refused.
+
+The .msk file of write_bitstream -mask_file, written with the same options,
+marks the bits that the design changes as it runs. They are left out of the
+CRCs and kept as read back by the repairs. Only the frames of the
+interconnect and logic, block type 0, go in the table, unless --bram adds
+the block RAM content, which then needs the mask.
+
+The frames go in groups of consecutive addresses of one column, of at most
+--frames frames, PL_SCRUB_MAX_FRAMES of the application. With --no-repair
+the golden frames are left out, the table is much smaller and the scrubber
+only counts the upsets.
+
+    scrub_golden.py design.bit -m design.msk -o design.scrb
+    scrub_golden.py design.bit --no-repair -o design.scrb
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+
+MAGIC = 0x42524353
+VERSION = 1
+FRAME_WORDS = 101
+NONE = 0xFFFFFFFF
+HEADER = struct.Struct("<IHHIII")
+GROUP = struct.Struct("<IIIII")
+
+SYNC = b"\xaa\x99\x55\x66"
+REG_FAR = 1
+REG_FDRI = 2
+REG_MFWR = 10
+REG_LOUT = 12
+
+
+def frames_of(path):
+    """Return {frame address: words} of the frames a bitstream writes."""
+    with open(path, "rb") as f:
+        data = f.read()
+    start = data.find(SYNC)
+    if start < 0:
+        sys.exit("%s: no sync word" % path)
+    words = struct.unpack_from(">%dI" % ((len(data) - start) // 4), data, start)
+
+    frames = {}
+    unknown = []    # Frames written without an address yet
+    far = None      # Address written to FAR, for the next frame
+    reg = 0
+    pos = 1
+    while pos < len(words):
+        word = words[pos]
+        pos += 1
+        kind = word >> 29
+        op = (word >> 27) & 3
+        if kind == 1:
+            reg = (word >> 13) & 0x1F
+            count = word & 0x7FF
+        elif kind == 2:
+            count = word & 0x7FFFFFF
+        else:
+            continue
+        if op != 2 or count == 0:
+            pos += count if op == 2 else 0
+            continue
+        values = words[pos:pos + count]
+        pos += count
+        if reg == REG_FAR:
+            far = values[0]
+        elif reg == REG_LOUT and unknown:
+            # Debug bitstream: the address of the frame just written
+            frames[values[0]] = unknown.pop()
+        elif reg == REG_MFWR:
+            sys.exit("%s: compressed bitstreams are not supported" % path)
+        elif reg == REG_FDRI:
+            if count % FRAME_WORDS:
+                sys.exit("%s: FDRI write of %d words" % (path, count))
+            for index in range(0, count, FRAME_WORDS):
+                frame = values[index:index + FRAME_WORDS]
+                if far is not None:
+                    frames[far] = frame
+                    far = None
+                else:
+                    unknown.append(frame)
+
+    # What is left is the pad frames, or a plain bitstream
+    if any(any(frame) for frame in unknown):
+        sys.exit("%s: frames without their address, write the bitstream "
+                 "with DebugBitstream or PerFrameCRC" % path)
+    return frames
+
+
+def groups_of(addresses, size):
+    """Return lists of consecutive addresses of one column."""
+    groups = []
+    for far in sorted(addresses):
+        if groups and len(groups[-1]) < size and far == groups[-1][-1] + 1 \
+                and far >> 7 == groups[-1][0] >> 7:
+            groups[-1].append(far)
+        else:
+            groups.append([far])
+    return groups
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("bitstream")
+    parser.add_argument("-m", "--mask", help=".msk file of the bitstream")
+    parser.add_argument("-o", "--output", required=True)
+    parser.add_argument("-f", "--frames", type=int, default=4,
+                        help="frames of a group, PL_SCRUB_MAX_FRAMES")
+    parser.add_argument("--bram", action="store_true",
+                        help="scrub the block RAM content too")
+    parser.add_argument("--no-repair", action="store_true",
+                        help="leave the golden frames out")
+    parser.add_argument("-p", "--period", type=int, default=1000,
+                        help="PL_SCRUB_PERIOD_US, for the times printed")
+    args = parser.parse_args()
+
+    frames = frames_of(args.bitstream)
+    masks = frames_of(args.mask) if args.mask else {}
+    if args.bram and not masks:
+        sys.exit("the block RAM content needs the mask")
+    types = (0, 1) if args.bram else (0,)
+    addresses = [far for far in frames if (far >> 23) & 7 in types]
+    if not addresses:
+        sys.exit("no frames to scrub")
+
+    table = bytearray()
+    words = []
+    masked = 0
+    for group in groups_of(addresses, args.frames):
+        data = [word for far in group for word in frames[far]]
+        mask = [word for far in group
+                for word in masks.get(far, [0] * FRAME_WORDS)]
+        crc = zlib.crc32(struct.pack("<%dI" % len(data),
+                                     *(d & ~m & 0xFFFFFFFF
+                                       for d, m in zip(data, mask))))
+        data_offset = NONE
+        if not args.no_repair:
+            data_offset = len(words)
+            words.extend(data)
+        mask_offset = NONE
+        if any(mask):
+            mask_offset = len(words)
+            words.extend(mask)
+            masked += len(group)
+        table += GROUP.pack(group[0], len(group), crc, data_offset,
+                            mask_offset)
+    count = len(table) // GROUP.size
+    table += struct.pack("<%dI" % len(words), *words)
+    head = HEADER.pack(MAGIC, VERSION, FRAME_WORDS, count, len(words),
+                       zlib.crc32(table))
+    with open(args.output, "wb") as f:
+        f.write(head + table)
+
+    print("%d frames in %d groups, %d masked, table %d bytes" %
+          (len(addresses), count, masked, len(head) + len(table)))
+    print("a pass every %.2f s at %d us a group" %
+          (count * args.period / 1e6, args.period))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,346 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+"""Estimate the worst case depth of each stack of the application.
+
+Reads the .su files GCC writes next to the objects with -fstack-usage,
+the frame of each function, and the disassembly of the application ELF
+file, its calls, and works out the deepest chain of frames from the entry
+of each stack of lscript.ld: main() through _start for the stack of the
+system mode, the exception handlers of the vector table for the mode
+stacks, AmpCpu1Entry for that of CPU1. The result is set against the
+size linked, with --margin percent of room on top, and the sizes to link
+with are printed as the -Wl,--defsym options of UserConfig.cmake.
+
+A function without a .su frame, from the assembly files or the BSP
+libraries built without -fstack-usage, is given the frame of its
+prologue, the pushes and the stack pointer subtraction before its first
+branch; such frames are marked with ~. A frame GCC reports as dynamic,
+alloca() or a variable length array, makes the result a lower bound, as
+do the indirect calls: the interrupt controller calls the handlers
+connected to it through a table, and those are given with --calls, e.g.
+--calls XScuGic_InterruptHandler=Bridge_UartIntr,TimerWheel_Intr. A
+recursion is reported and its chain counted once. The interrupts do not
+nest, the IRQ stack holding the deepest handler once.
+
+The high-water marks of stack_mark.h give what a run used, to check the
+estimate against.
+
+    stack_usage.py app_component.elf build/
+    stack_usage.py app_component.elf build/ --calls-file isr_calls.txt
+    stack_usage.py app_component.elf build/ --root irq=Bridge_UartIntr
+
+The exit status is 1 when a stack is estimated deeper than linked.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+# Entries of each stack and the symbols of its bottom and top
+STACKS = [
+    ("main", ["_start"], "_stack_end", "_stack", "_STACK_SIZE"),
+    ("irq", ["IRQHandler"], "_irq_stack_end", "__irq_stack",
+     "_IRQ_STACK_SIZE"),
+    ("svc", ["SVCHandler"], "_supervisor_stack_end", "__supervisor_stack",
+     "_SUPERVISOR_STACK_SIZE"),
+    ("abort", ["DataAbortHandler", "PrefetchAbortHandler"],
+     "_abort_stack_end", "__abort_stack", "_ABORT_STACK_SIZE"),
+    ("fiq", ["FIQHandler"], "_fiq_stack_end", "__fiq_stack",
+     "_FIQ_STACK_SIZE"),
+    ("undef", ["Undefined"], "_undef_stack_end", "__undef_stack",
+     "_UNDEF_STACK_SIZE"),
+    ("cpu1", ["AmpCpu1Entry"], "_cpu1_stack_end", "__cpu1_stack",
+     "_CPU1_STACK_SIZE"),
+]
+
+# The vector table calls the handlers registered with the BSP through
+# XExc_VectorTable, the interrupt controller driver being the IRQ one
+DEFAULT_CALLS = {
+    "IRQInterrupt": ["XScuGic_InterruptHandler"],
+}
+
+# A line of a .su file: file:line:column:function, bytes, qualifiers
+SU_LINE = re.compile(r"^(?:.*):\d+:\d+:(.+)\t(\d+)\t(\S+)$")
+FUNCTION = re.compile(r"^[0-9a-f]+ <(.+)>:$")
+INSN = re.compile(r"^\s+[0-9a-f]+:\s+(\S+)\s*(.*)$")
+TARGET = re.compile(r"[0-9a-f]+ <([^+>]+)(\+0x[0-9a-f]+)?>")
+REGISTER_LIST = re.compile(r"\{([^}]*)\}")
+SP_SUB = re.compile(r"^sp, (?:sp, )?#(\d+)")
+CALLS = ("bl", "blx")
+BRANCHES = ("b", "bx", "bl", "blx", "cbz", "cbnz")
+CONDITIONS = ("eq", "ne", "cs", "hs", "cc", "lo", "mi", "pl", "vs", "vc",
+              "hi", "ls", "ge", "lt", "gt", "le", "al")
+
+
+def base(mnemonic):
+    """Return a branch mnemonic without its condition and width."""
+    mnemonic = mnemonic.split(".")[0]
+    for name in ("blx", "bl", "bx", "cbnz", "cbz", "b"):
+        if mnemonic == name or (mnemonic.startswith(name) and
+                                mnemonic[len(name):] in CONDITIONS):
+            return name
+    return mnemonic
+
+
+def read_su(path):
+    """Return the frame of each function of the .su files under path, and
+    the functions whose frame is dynamic."""
+    frames = {}
+    dynamic = set()
+    for folder, _, names in os.walk(path):
+        for name in names:
+            if not name.endswith(".su"):
+                continue
+            with open(os.path.join(folder, name), errors="replace") as f:
+                for line in f:
+                    match = SU_LINE.match(line.rstrip("\n"))
+                    if not match:
+                        continue
+                    function = match.group(1)
+                    # Static functions of several files share a name
+                    frames[function] = max(frames.get(function, 0),
+                                           int(match.group(2)))
+                    if "dynamic" in match.group(3) and \
+                            "bounded" not in match.group(3):
+                        dynamic.add(function)
+    return frames, dynamic
+
+
+def register_count(operands):
+    """Return the registers of a push or a store multiple list."""
+    match = REGISTER_LIST.search(operands)
+    if not match:
+        return 0
+    count = 0
+    for item in match.group(1).split(","):
+        item = item.strip()
+        if "-" in item:
+            first, last = item.split("-")
+            count += int(last[1:]) - int(first[1:]) + 1
+        elif item:
+            count += 1
+    return count
+
+
+def disassemble(objdump, elf):
+    """Return the calls of each function, the frame of its prologue and
+    whether it calls through a register."""
+    listing = subprocess.run([objdump, "-d", "--no-show-raw-insn", elf],
+                             check=True, stdout=subprocess.PIPE,
+                             universal_newlines=True).stdout
+    calls = {}
+    prologue = {}
+    indirect = set()
+    current = None
+    in_prologue = False
+    for line in listing.splitlines():
+        match = FUNCTION.match(line)
+        if match:
+            current = match.group(1)
+            calls.setdefault(current, set())
+            prologue.setdefault(current, 0)
+            in_prologue = True
+            continue
+        if current is None:
+            continue
+        match = INSN.match(line)
+        if not match:
+            continue
+        mnemonic = base(match.group(1))
+        operands = match.group(2)
+        if in_prologue:
+            if mnemonic == "push" or (mnemonic in ("stmdb", "stmfd") and
+                                      operands.startswith("sp!")):
+                prologue[current] += 4 * register_count(operands)
+            elif mnemonic == "vpush":
+                prologue[current] += 8 * register_count(operands)
+            elif mnemonic == "str" and operands.endswith("[sp, #-4]!"):
+                prologue[current] += 4
+            elif mnemonic in ("sub", "subw") and SP_SUB.match(operands):
+                prologue[current] += int(SP_SUB.match(operands).group(1))
+        if mnemonic == "ldr" and operands.startswith("pc,") and \
+                "[sp]" not in operands:
+            indirect.add(current)
+            in_prologue = False
+            continue
+        if mnemonic not in BRANCHES:
+            continue
+        in_prologue = False
+        target = TARGET.search(operands)
+        if target:
+            callee = target.group(1)
+            # A branch to the start of another function is a tail call,
+            # a call of the function itself a recursion
+            if mnemonic in CALLS or (callee != current and
+                                     not target.group(2)):
+                calls[current].add(callee)
+        elif mnemonic in ("blx", "bx") and not operands.startswith("lr"):
+            indirect.add(current)
+    return calls, prologue, indirect
+
+
+def read_symbols(nm, elf):
+    """Return the address of each symbol, the stack bounds included."""
+    listing = subprocess.run([nm, elf], check=True, stdout=subprocess.PIPE,
+                             universal_newlines=True).stdout
+    symbols = {}
+    for line in listing.splitlines():
+        fields = line.split()
+        if len(fields) == 3:
+            symbols[fields[2]] = int(fields[0], 16)
+    return symbols
+
+
+class Graph:
+    """The call graph of the image and the worst depth from a function."""
+
+    def __init__(self, frames, dynamic, calls, prologue, indirect, extra):
+        self.frames = frames
+        self.dynamic = dynamic
+        self.calls = calls
+        self.prologue = prologue
+        self.indirect = indirect
+        self.extra = extra
+        self.depth = {}
+        self.unresolved = set()
+        self.recursive = set()
+        self.estimated = set()
+
+    def frame(self, function):
+        if function in self.frames:
+            return self.frames[function]
+        self.estimated.add(function)
+        return self.prologue.get(function, 0)
+
+    def callees(self, function):
+        callees = set(self.calls.get(function, ())) | \
+            set(self.extra.get(function, ()))
+        if function in self.indirect and function not in self.extra:
+            self.unresolved.add(function)
+        return callees
+
+    def worst(self, function, path=()):
+        """Return the deepest bytes from function and its chain."""
+        if function in self.depth:
+            return self.depth[function]
+        if function in path:
+            self.recursive.add(function)
+            return 0, []
+        best = (0, [])
+        for callee in sorted(self.callees(function)):
+            depth = self.worst(callee, path + (function,))
+            if depth[0] > best[0]:
+                best = depth
+        result = (self.frame(function) + best[0], [function] + best[1])
+        self.depth[function] = result
+        return result
+
+
+def parse_calls(items):
+    """Return the caller=callee,... items as a mapping."""
+    calls = {caller: list(callees) for caller, callees in
+             DEFAULT_CALLS.items()}
+    for item in items:
+        item = item.split("#")[0].strip()
+        if not item:
+            continue
+        if "=" not in item:
+            sys.exit("%s: not caller=callee,..." % item)
+        caller, callees = item.split("=", 1)
+        calls.setdefault(caller.strip(), []).extend(
+            name.strip() for name in callees.split(",") if name.strip())
+    return calls
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="application ELF file")
+    parser.add_argument("build", help="build directory with the .su files")
+    parser.add_argument("--calls", action="append", default=[],
+                        metavar="CALLER=CALLEE,...",
+                        help="targets of the indirect calls of a function")
+    parser.add_argument("--calls-file",
+                        help="file of --calls items, one per line")
+    parser.add_argument("--root", action="append", default=[],
+                        metavar="STACK=FUNCTION",
+                        help="another entry of a stack, e.g. a task of "
+                        "coro.h on its own stack")
+    parser.add_argument("--margin", type=float, default=25.0,
+                        help="percent of room above the estimate")
+    parser.add_argument("--objdump", default="arm-none-eabi-objdump")
+    parser.add_argument("--nm", default="arm-none-eabi-nm")
+    parser.add_argument("-v", "--verbose", action="store_true",
+                        help="print the deepest chain of each stack")
+    args = parser.parse_args()
+
+    items = list(args.calls)
+    if args.calls_file:
+        with open(args.calls_file) as f:
+            items += f.read().splitlines()
+    extra = parse_calls(items)
+
+    frames, dynamic = read_su(args.build)
+    if not frames:
+        sys.exit("%s: no .su files, build with -fstack-usage" % args.build)
+    calls, prologue, indirect = disassemble(args.objdump, args.elf)
+    symbols = read_symbols(args.nm, args.elf)
+    graph = Graph(frames, dynamic, calls, prologue, indirect, extra)
+
+    roots = {name: list(entries) for name, entries, _, _, _ in STACKS}
+    for item in args.root:
+        stack, _, function = item.partition("=")
+        if stack not in roots:
+            sys.exit("%s: no stack %s" % (item, stack))
+        roots[stack].append(function)
+
+    failed = 0
+    options = []
+    print("%-6s %10s %10s %10s  %s" % ("stack", "worst", "linked",
+                                       "suggested", "deepest entry"))
+    for name, _, bottom, top, symbol in STACKS:
+        worst = (0, [])
+        for entry in roots[name]:
+            if entry not in calls:
+                continue
+            depth = graph.worst(entry)
+            if depth[0] > worst[0]:
+                worst = depth
+        if not worst[1]:
+            continue
+        linked = symbols.get(top, 0) - symbols.get(bottom, 0)
+        room = worst[0] * (1.0 + args.margin / 100.0)
+        suggested = (int(room) + 63) // 64 * 64
+        lower = any(function in graph.dynamic or
+                    function in graph.unresolved or
+                    function in graph.recursive
+                    for function in worst[1])
+        over = linked > 0 and worst[0] > linked
+        print("%-6s %9d%s %10s %10d  %s%s" % (
+            name, worst[0], "+" if lower else " ",
+            linked if linked > 0 else "-", suggested, worst[1][0],
+            "  OVERFLOW" if over else ""))
+        if args.verbose:
+            for function in worst[1]:
+                print("         %6d%s %s" % (
+                    graph.frame(function),
+                    "~" if function in graph.estimated else " ", function))
+        failed += over
+        options.append("-Wl,--defsym=%s=0x%x" % (symbol, suggested))
+
+    if graph.unresolved:
+        print("indirect calls not given with --calls: %s" %
+              ", ".join(sorted(graph.unresolved)))
+    if graph.recursive:
+        print("recursion through: %s" % ", ".join(sorted(graph.recursive)))
+    if graph.dynamic & set(graph.depth):
+        print("dynamic frames: %s" %
+              ", ".join(sorted(graph.dynamic & set(graph.depth))))
+    print("USER_LINK_OTHER_FLAGS: %s" % " ".join(options))
+    if failed:
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
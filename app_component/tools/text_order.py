@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+"""Order the hot code of the application from the PC samples of pc_prof.h.
+
+Reads the application ELF file and the standard output captured from the
+target, like pc_prof_report.py, adds up the last histogram of each CPU and
+writes the text_order.ld that lscript.ld includes at the start of .text:
+one input section per line, hottest first, until the functions listed
+hold --coverage of the samples in .text. The rest of the code, cold in
+the steady state the profile was taken in, follows them.
+
+The application is compiled with -ffunction-sections, so that a function
+is an input section of its own. With the link map of the image, -m, each
+function is looked up in the map instead, and functions of the BSP
+libraries, compiled without, bring the .text of their object along. The
+order takes effect at the next link, after lscript.ld is touched, the
+build only tracking the main script.
+
+    text_order.py app.elf capture.txt -o ../src/text_order.ld
+    text_order.py app.elf capture.txt -m app.map --coverage 95
+"""
+
+import argparse
+import os
+import re
+import sys
+
+from pc_prof_report import function_samples, read_functions, read_histograms
+
+# An input section of the link map, its name maybe on a line of its own
+SECTION = re.compile(r" (\.text\S*)(?:\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)"
+                     r"\s+(\S.*))?$")
+PLACEMENT = re.compile(r"\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S.*)$")
+MEMBER = re.compile(r"(.*)\((.*)\)$")
+
+
+def read_map(path):
+    """Return the sorted (address, size, section, file) of .text sections."""
+    sections = []
+    pending = None
+    with open(path, "r", errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if pending is not None:
+                match = PLACEMENT.match(line)
+                if match:
+                    sections.append((int(match.group(1), 16),
+                                     int(match.group(2), 16), pending,
+                                     match.group(3)))
+                pending = None
+                continue
+            match = SECTION.match(line)
+            if not match:
+                continue
+            if match.group(2) is None:
+                pending = match.group(1)
+                continue
+            sections.append((int(match.group(2), 16),
+                             int(match.group(3), 16), match.group(1),
+                             match.group(4)))
+    sections = [section for section in sections if section[1] != 0]
+    if not sections:
+        sys.exit("%s: no .text input sections" % path)
+    sections.sort()
+    return sections
+
+
+def pattern(section, path):
+    """Return the linker script pattern of an input section and its file."""
+    match = MEMBER.match(path)
+    if match:
+        return "*%s:%s(%s)" % (os.path.basename(match.group(1)),
+                               match.group(2), section)
+    return "*%s(%s)" % (os.path.basename(path), section)
+
+
+def order(functions, histograms, sections, coverage):
+    """Return the patterns of the hot code and the share of samples held."""
+    counts = {}
+    for fields, bins in histograms.values():
+        for key, count in function_samples(functions, fields,
+                                           bins).items():
+            if not isinstance(key, str):
+                counts[key] = counts.get(key, 0) + count
+    total = sum(counts.values())
+    if total == 0:
+        sys.exit("no samples in .text")
+
+    patterns = []
+    held = 0
+    ranked = sorted(counts.items(), key=lambda item: (-item[1], item[0]))
+    for (address, _, name), count in ranked:
+        if held >= total * coverage / 100.0:
+            break
+        held += count
+        if sections is None:
+            entry = "*(.text.%s .text.hot.%s)" % (name, name)
+        else:
+            entry = None
+            for start, size, section, path in sections:
+                if start <= address < start + size:
+                    entry = pattern(section, path)
+                    break
+            if entry is None:
+                sys.stderr.write("%s: not in the map\n" % name)
+                continue
+        if entry not in patterns:
+            patterns.append(entry)
+    return patterns, 100.0 * held / total
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="application ELF file")
+    parser.add_argument("capture", help="captured output, - for stdin")
+    parser.add_argument("-m", "--map", help="link map of the application")
+    parser.add_argument("-o", "--output", help="text_order.ld to write")
+    parser.add_argument("--coverage", type=float, default=99.0,
+                        help="percent of the samples to order")
+    args = parser.parse_args()
+
+    functions = read_functions(args.elf)
+    if args.capture == "-":
+        stream = sys.stdin
+    else:
+        stream = open(args.capture, "r", errors="replace")
+    with stream:
+        histograms = read_histograms(stream)
+    sections = read_map(args.map) if args.map else None
+    patterns, held = order(functions, histograms, sections, args.coverage)
+
+    out = open(args.output, "w") if args.output else sys.stdout
+    with out:
+        out.write("/* Hot code from tools/text_order.py, %d sections, "
+                  "%.1f%% of the samples */\n" % (len(patterns), held))
+        for entry in patterns:
+            out.write("   %s\n" % entry)
+
+
+if __name__ == "__main__":
+    main()
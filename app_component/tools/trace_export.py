@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+"""Export the event trace of xil_trace.h for Perfetto.
+
+Reads either the trace buffer read over JTAG, the binary file written by
+XSCT with "mrd -bin -file trace.bin &Xil_TraceBuf <words>", or the standard
+output captured from the target, with the text printed by Xil_TraceDump().
+Writes the JSON trace event format, which ui.perfetto.dev and
+chrome://tracing open, one track per CPU. The times are those of the
+global timer, unwrapped from its lower word, in microseconds from the
+first event.
+
+    trace_export.py trace.bin -o trace.json
+    cat /dev/ttyUSB1 | trace_export.py - -o trace.json
+"""
+
+import argparse
+import json
+import re
+import struct
+import sys
+
+MAGIC = 0x43525458
+HEADER_SIZE = 32
+INDEX_SIZE = 32
+RECORD = struct.Struct("<IHHII")
+
+BEGIN = 0x4000
+END = 0x8000
+PHASE_MASK = 0xC000
+USER = 0x0100
+
+DUMP_HEADER = re.compile(r"XTRC (\d+) (\d+) (\d+)")
+DUMP_CPU = re.compile(r"CPU (\d+) (\d+)$")
+DUMP_RECORD = re.compile(r"([0-9a-f]{8}) ([0-9a-f]{8}) ([0-9a-f]{8}) "
+                         r"([0-9a-f]{8})$")
+
+
+def read_binary(data, cpus):
+    """Return (timer Hz, {cpu: [records]}) of a buffer read over JTAG."""
+    magic, num_records, timer_hz, _ = struct.unpack_from("<IIII", data, 0)
+    if magic != MAGIC:
+        sys.exit("not a started trace buffer, magic 0x%08x" % magic)
+    base = HEADER_SIZE + cpus * INDEX_SIZE
+    if len(data) < base + cpus * num_records * RECORD.size:
+        sys.exit("trace buffer truncated, %d bytes" % len(data))
+    records = {}
+    for cpu in range(cpus):
+        index, = struct.unpack_from("<I", data, HEADER_SIZE + cpu * INDEX_SIZE)
+        ring = base + cpu * num_records * RECORD.size
+        records[cpu] = [RECORD.unpack_from(data, ring + (slot % num_records) *
+                                           RECORD.size)
+                        for slot in range(max(0, index - num_records), index)]
+    return timer_hz, records
+
+
+def read_dump(stream):
+    """Return (timer Hz, {cpu: [records]}) of the last Xil_TraceDump()."""
+    timer_hz = None
+    records = {}
+    current = None
+    result = None
+    for line in stream:
+        line = line.strip()
+        match = DUMP_HEADER.search(line)
+        if match:
+            timer_hz = int(match.group(3))
+            records = {}
+            current = None
+            continue
+        if timer_hz is None:
+            continue
+        if line == "END":
+            result = (timer_hz, records)
+            timer_hz = None
+            continue
+        match = DUMP_CPU.match(line)
+        if match:
+            current = records.setdefault(int(match.group(1)), [])
+            continue
+        match = DUMP_RECORD.match(line)
+        if match and current is not None:
+            time, word, arg0, arg1 = (int(field, 16)
+                                      for field in match.groups())
+            current.append((time, word & 0xFFFF, word >> 16, arg0, arg1))
+    if result is None:
+        sys.exit("no complete XTRC dump in the capture")
+    return result
+
+
+def unwrap(records):
+    """Return the records of each CPU with 64-bit times, on one time base."""
+    firsts = [recs[0][0] for recs in records.values() if recs]
+    if not firsts:
+        sys.exit("the trace is empty")
+    reference = firsts[0]
+    timed = []
+    for recs in records.values():
+        if not recs:
+            continue
+        # Same global timer on both CPUs, so align each on the reference
+        offset = (recs[0][0] - reference + 0x80000000) % (1 << 32) - \
+            0x80000000
+        time = reference + offset
+        last = recs[0][0]
+        for rec in recs:
+            time += (rec[0] - last) % (1 << 32)
+            last = rec[0]
+            timed.append((time,) + tuple(rec[1:]))
+    timed.sort(key=lambda rec: rec[0])
+    return timed
+
+
+def name_of(event, arg0):
+    """Return the name of an event ID without its phase."""
+    if event == 0x0001:
+        return "irq %d" % arg0
+    if event == 0x0002:
+        return "uart 0x%08x" % arg0
+    if event == 0x0003:
+        return "dma done ch%d" % arg0
+    if event == 0x0004:
+        return "pcap"
+    if event == 0x0005:
+        return "task %d" % arg0
+    if event >= USER:
+        return "user %d" % (event - USER)
+    return "event 0x%04x" % event
+
+
+def export(timer_hz, timed):
+    """Return the JSON trace of the timed records."""
+    start = timed[0][0]
+    events = []
+    for time, ident, cpu, arg0, arg1 in timed:
+        phase = ident & PHASE_MASK
+        event = {
+            "name": name_of(ident & ~PHASE_MASK, arg0),
+            "ph": "B" if phase == BEGIN else "E" if phase == END else "i",
+            "ts": (time - start) * 1e6 / timer_hz,
+            "pid": 0,
+            "tid": cpu,
+            "args": {"arg0": "0x%08x" % arg0, "arg1": "0x%08x" % arg1},
+        }
+        if event["ph"] == "i":
+            event["s"] = "t"
+        events.append(event)
+    for cpu in sorted({rec[2] for rec in timed}):
+        events.append({"name": "thread_name", "ph": "M", "pid": 0,
+                       "tid": cpu, "args": {"name": "CPU%d" % cpu}})
+    return {"traceEvents": events, "displayTimeUnit": "ns"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("trace", help="trace.bin from XSCT, or captured "
+                        "output with a dump, - for stdin")
+    parser.add_argument("-o", "--output", default="-",
+                        help="JSON file, - for stdout")
+    parser.add_argument("--cpus", type=int, default=2,
+                        help="XIL_NUM_CPUS of the binary buffer")
+    args = parser.parse_args()
+
+    if args.trace == "-":
+        timer_hz, records = read_dump(sys.stdin)
+    else:
+        with open(args.trace, "rb") as f:
+            data = f.read()
+        if data[:4] == struct.pack("<I", MAGIC):
+            timer_hz, records = read_binary(data, args.cpus)
+        else:
+            text = data.decode("latin-1").splitlines()
+            timer_hz, records = read_dump(text)
+
+    trace = export(timer_hz, unwrap(records))
+    if args.output == "-":
+        json.dump(trace, sys.stdout)
+    else:
+        with open(args.output, "w") as f:
+            json.dump(trace, f)
+
+
+if __name__ == "__main__":
+    main()
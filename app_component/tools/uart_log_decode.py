@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+"""Decode the deferred logging records of uart_log.h.
+
+Reads the standard output captured from the target, passes the text
+through and replaces each binary record with the text xil_printf() would
+have printed, using the format strings in the .uart_log_fmt section of the
+application ELF file. Each decoded line is prefixed with its time stamp in
+seconds.
+
+    uart_log_decode.py app.elf capture.bin
+    cat /dev/ttyUSB1 | uart_log_decode.py app.elf -
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+SECTION = ".uart_log_fmt"
+SYNC = 0xA5
+MAX_ARGS = 6
+# COUNTS_PER_SECOND of the global timer: CPU clock / 2
+DEFAULT_HZ = 666666687 // 2
+
+CONVERSION = re.compile(
+    r"%([-+ 0#]*)(\d*)(?:\.(\d+))?(?:hh|h|ll|l|z)?([diuxXocsp%])")
+
+
+def read_section(path, name):
+    """Return (address, bytes) of section name in the ELF file at path."""
+    with open(path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF":
+        sys.exit("%s: not an ELF file" % path)
+    is64 = elf[4] == 2
+    order = "<" if elf[5] == 1 else ">"
+    if is64:
+        shoff, = struct.unpack_from(order + "Q", elf, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(order + "HHH",
+                                                        elf, 0x3A)
+        shdr = order + "IIQQQQIIQQ"
+    else:
+        shoff, = struct.unpack_from(order + "I", elf, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(order + "HHH",
+                                                        elf, 0x2E)
+        shdr = order + "IIIIIIIIII"
+    headers = [struct.unpack_from(shdr, elf, shoff + i * shentsize)
+               for i in range(shnum)]
+    strtab = headers[shstrndx]
+    names = elf[strtab[4]:strtab[4] + strtab[5]]
+    for hdr in headers:
+        end = names.index(b"\0", hdr[0])
+        if names[hdr[0]:end].decode() == name:
+            return hdr[3], elf[hdr[4]:hdr[4] + hdr[5]]
+    sys.exit("%s: no %s section" % (path, name))
+
+
+def format_record(fmt, args):
+    """Format the argument words like xil_printf() does."""
+    words = iter(args)
+
+    def convert(match):
+        flags, width, precision, conv = match.groups()
+        if conv == "%":
+            return "%"
+        word = next(words, 0)
+        if conv == "s":
+            return "<string@0x%08x>" % word
+        if conv == "p":
+            return "0x%08x" % word
+        if conv == "c":
+            return chr(word & 0xFF)
+        if conv in "di" and word & 0x80000000:
+            word -= 1 << 32
+        spec = "%" + flags + width
+        if precision is not None:
+            spec += "." + precision
+        return (spec + ("d" if conv in "diu" else conv)) % word
+
+    return CONVERSION.sub(convert, fmt)
+
+
+def decode(stream, base, strings, hz, out):
+    """Copy stream to out, decoding the records found in it."""
+    data = stream.read()
+    pos = 0
+    ticks = 0
+    last = None
+    while pos < len(data):
+        byte = data[pos]
+        if byte != SYNC or pos + 8 > len(data):
+            if byte < 0x80:
+                out.write(chr(byte))
+            pos += 1
+            continue
+        header, stamp = struct.unpack_from("<II", data, pos)
+        num_args = (header >> 8) & 0xFF
+        offset = (header >> 16) - base
+        if (num_args > MAX_ARGS or offset < 0 or offset >= len(strings) or
+                (offset > 0 and strings[offset - 1] != 0) or
+                pos + 8 + 4 * num_args > len(data)):
+            pos += 1
+            continue
+        args = struct.unpack_from("<%dI" % num_args, data, pos + 8)
+        pos += 8 + 4 * num_args
+
+        # Time stamps are the lower word of the global timer
+        if last is not None:
+            ticks += (stamp - last) & 0xFFFFFFFF
+        last = stamp
+        end = strings.index(b"\0", offset)
+        fmt = strings[offset:end].decode("latin-1")
+        out.write("[%12.6f] " % (ticks / hz))
+        out.write(format_record(fmt, args))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="application ELF file")
+    parser.add_argument("capture", help="captured output, - for stdin")
+    parser.add_argument("--hz", type=int, default=DEFAULT_HZ,
+                        help="global timer ticks per second")
+    args = parser.parse_args()
+
+    base, strings = read_section(args.elf, SECTION)
+    if args.capture == "-":
+        stream = sys.stdin.buffer
+    else:
+        stream = open(args.capture, "rb")
+    with stream:
+        decode(stream, base, strings, args.hz, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()